@@ -5,7 +5,8 @@ namespace logging {
 enum class SinkType {
   BaseSink,
   CompositeSink,
-  EtwSink
+  EtwSink,
+  RingBufferSink
 };
 }  // namespace logging
 }  // namespace onnxruntime
@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "core/common/common.h"
@@ -14,6 +18,7 @@
 #include "core/session/environment.h"
 #include "core/graph/basic_types.h"
 #include "core/graph/model.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 #ifdef __GNUC__
@@ -22,21 +27,32 @@ namespace onnxruntime {
 
 class ORTInvoker {
  public:
+  static constexpr size_t kDefaultKernelCacheCapacity = 256;
+
+  // kernel_cache_capacity is the number of kernels kept for the following calls, the least recently used one being
+  // released first. 0 disables the cache.
   ORTInvoker(std::shared_ptr<IExecutionProvider> execution_provider,
              const logging::Logger& logger,
-             const IOnnxRuntimeOpSchemaRegistryList& custom_op_registries)
+             const IOnnxRuntimeOpSchemaRegistryList& custom_op_registries,
+             size_t kernel_cache_capacity = kDefaultKernelCacheCapacity)
       : execution_provider_(std::move(execution_provider)),
         logger_(logger),
-        custom_op_registries_(custom_op_registries) {
+        custom_op_registries_(custom_op_registries),
+        kernel_cache_capacity_(kernel_cache_capacity) {
     if (!execution_provider_) {
       ORT_THROW("Execution provider is nullptr");
     }
   }
 
+  ~ORTInvoker();
+
   IExecutionProvider& GetCurrentExecutionProvider() {
     return *execution_provider_;
   }
 
+  // Runs an op on the inputs. The kernel created for the op is cached by op, domain, version, attributes, input types
+  // and number of outputs, so that following calls with the same signature only run the kernel.
+  // The cache holds up to kernel_cache_capacity kernels.
   common::Status Invoke(const std::string& op_name,
                         // optional inputs / outputs?
                         const std::vector<OrtValue>& inputs,
@@ -45,12 +61,34 @@ class ORTInvoker {
                         const std::string& domain = kOnnxDomain,
                         const int version = -1);
 
+  // The number of kernels in the cache.
+  size_t GetKernelCacheSize();
+
  private:
+  // a single node graph with the kernel of its node
+  struct CachedKernel;
+
+  common::Status CreateKernel(const std::string& op_name,
+                              const std::vector<OrtValue>& inputs,
+                              size_t num_outputs,
+                              const NodeAttributes* attributes,
+                              const std::string& domain,
+                              const int version,
+                              std::unique_ptr<CachedKernel>& cached_kernel) const;
+
   std::shared_ptr<IExecutionProvider> execution_provider_;
   const logging::Logger& logger_;
   // custom ops for current execution provider
   // we need the op schema to resolve the output type during invoke
   const IOnnxRuntimeOpSchemaRegistryList& custom_op_registries_;
+
+  const size_t kernel_cache_capacity_;
+  OrtMutex kernel_cache_mutex_;
+  // the kernels by cache key, the most recently used one first. A kernel in use is kept alive by its caller when it's
+  // evicted meanwhile.
+  using KernelCacheList = std::list<std::pair<std::string, std::shared_ptr<const CachedKernel>>>;
+  KernelCacheList kernel_cache_;
+  std::unordered_map<std::string, KernelCacheList::iterator> kernel_cache_index_;
 };
 
 #ifdef __GNUC__
@@ -20,16 +20,24 @@ struct OrtArenaCfg {
                   initial_chunk_size_bytes(-1),
                   max_dead_bytes_per_chunk(-1),
                   initial_growth_chunk_size_bytes(-1),
-                  max_power_of_two_extend_bytes(-1) {}
+                  max_power_of_two_extend_bytes(-1),
+                  thread_cache_bytes(-1),
+                  thread_cache_max_chunk_bytes(-1),
+                  trim_window_ms(-1) {}
   OrtArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes,
               int max_dead_bytes_per_chunk, int initial_growth_chunk_size_bytes,
-              int64_t max_power_of_two_extend_bytes)
+              int64_t max_power_of_two_extend_bytes,
+              int64_t thread_cache_bytes = -1, int thread_cache_max_chunk_bytes = -1,
+              int64_t trim_window_ms = -1)
       : max_mem(max_mem),
         arena_extend_strategy(arena_extend_strategy),
         initial_chunk_size_bytes(initial_chunk_size_bytes),
         max_dead_bytes_per_chunk(max_dead_bytes_per_chunk),
         initial_growth_chunk_size_bytes(initial_growth_chunk_size_bytes),
-        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes) {}
+        max_power_of_two_extend_bytes(max_power_of_two_extend_bytes),
+        thread_cache_bytes(thread_cache_bytes),
+        thread_cache_max_chunk_bytes(thread_cache_max_chunk_bytes),
+        trim_window_ms(trim_window_ms) {}
 
   size_t max_mem;                         // use 0 to allow ORT to choose the default
   int arena_extend_strategy;              // use -1 to allow ORT to choose the default, 0 = kNextPowerOfTwo, 1 = kSameAsRequested
@@ -37,6 +45,9 @@ struct OrtArenaCfg {
   int max_dead_bytes_per_chunk;           // use -1 to allow ORT to choose the default
   int initial_growth_chunk_size_bytes;    // use -1 to allow ORT to choose the default
   int64_t max_power_of_two_extend_bytes;  // use -1 to allow ORT to choose the default
+  int64_t thread_cache_bytes;             // use -1 to allow ORT to choose the default (cache disabled), 0 = disabled
+  int thread_cache_max_chunk_bytes;       // use -1 to allow ORT to choose the default
+  int64_t trim_window_ms;                 // use -1 to allow ORT to choose the default (trimming disabled), 0 = disabled
 };
 
 namespace onnxruntime {
@@ -88,6 +99,17 @@ class IAllocator {
   // By default, the base implementation  just calls Alloc().
   virtual void* Reserve(size_t size) { return Alloc(size); }
 
+  // Whether the allocations are ordered on a stream, e.g. with a stream-ordered CUDA memory pool. An allocation
+  // made by AllocWithStream() may be used on that stream and is returned to the allocator in the order of that
+  // stream when it's freed. Allocations made by Alloc() are usable on any stream.
+  virtual bool IsStreamAware() const { return false; }
+
+  virtual void* AllocWithStream(size_t size, Stream* /*stream*/) { return Alloc(size); }
+
+  // Called when a stream is released, e.g. at the end of a run. The allocations ordered on the stream which are
+  // still alive are no longer ordered on it.
+  virtual void ReleaseStream(Stream* /*stream*/) {}
+
   const OrtMemoryInfo& Info() const { return memory_info_; };
 
   // Each implementation of IAllocator can override and provide their own implementation
@@ -218,6 +218,14 @@ class IExecutionProvider {
     return Status::OK();
   }
 
+  /**
+     Release the graphs instantiated with the annotation id by all the threads, so that it can be captured again.
+     A thread may release its graph when it next runs.
+   */
+  virtual common::Status ReleaseGraph(int /*graph_annotation_id*/) {
+    return Status::OK();
+  }
+
   /**
      Called when session creation is complete
      This provides an opportunity for execution providers to optionally synchronize and
@@ -6,6 +6,7 @@
 #include <string_view>
 
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
@@ -20,6 +21,7 @@ class IKernelTypeStrResolver;
 class KernelRegistry {
  public:
   KernelRegistry() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(KernelRegistry);
 
   // Register a kernel with kernel definition and function to create the kernel.
   Status Register(KernelDefBuilder& kernel_def_builder, const KernelCreateFn& kernel_creator);
@@ -121,5 +123,11 @@ class KernelRegistry {
   // Kernel create function map from op name to kernel creation info.
   // key is opname+domain_name+provider_name
   KernelCreateMap kernel_creator_fn_map_;
+
+  // Kernels found for nodes using a kernel type str resolver, by GetMapKey, since version and argument types of the
+  // node. The registries of the execution providers are shared by their sessions, so the nodes of models with the
+  // same architecture don't search and verify the kernel definitions again.
+  mutable OrtMutex found_kernels_mutex_;
+  mutable InlinedHashMap<std::string, const KernelCreateInfo*> found_kernels_;
 };
 }  // namespace onnxruntime
@@ -129,6 +129,24 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed buffers which were produced by PrePack() in an earlier session and
+  // loaded from a file (see kOrtSessionOptionsConfigPrepackedWeightsFilePath).
+  // Unlike with UseSharedPrePackedBuffers(), PrePack() is NOT called for the input before, so the kernel must also
+  // restore any other state that PrePack() derives from the tensor (e.g. its shape).
+  // @param tensor: The constant initialized tensor the buffers were pre-packed from.
+  // @param prepacked_buffers: The pre-packed buffers in the order PrePack() produced them. As with
+  //                           UseSharedPrePackedBuffers() the deleters are NULL, the buffers are owned by the session.
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param used_serialized_buffers: Boolean flag set by the kernel implementation indicating
+  // that the provided buffers have been used by the kernel. If false, the session calls PrePack() instead.
+  virtual Status UseSerializedPrePackedBuffers(const Tensor& /*tensor*/,
+                                               std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                               int /*input_idx*/,
+                                               /*out*/ bool& used_serialized_buffers) {
+    used_serialized_buffers = false;
+    return Status::OK();
+  }
+
   const OrtDevice GetDevice(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
@@ -138,6 +138,13 @@ class OpKernelContext {
    */
   [[nodiscard]] Status GetTempSpaceCPUAllocator(AllocatorPtr* output) const;
 
+  /**
+   Return the number of bytes the run may still allocate within its memory budget, or the maximum size_t value if
+   it has no budget or must not degrade to chunked execution (see kOrtRunOptionsConfigMemoryBudgetBytes).
+   Kernels with large temporary buffers may use it to run in chunks instead of failing the run.
+   */
+  size_t GetAvailableRunMemory() const;
+
   /**
   Return the device id that current kernel runs on.
   */
@@ -75,6 +75,11 @@ struct OrtValue {
     return type_;
   }
 
+  // Returns true if no other OrtValue instance shares the value.
+  bool IsSoleOwner() const noexcept {
+    return data_.use_count() == 1;
+  }
+
  private:
   std::shared_ptr<void> data_;
   onnxruntime::MLDataType type_{nullptr};
@@ -8,6 +8,10 @@
 #include "core/session/onnxruntime_c_api.h"
 #include "core/framework/config_options.h"
 
+namespace onnxruntime {
+class RunCompletionQueue;
+}  // namespace onnxruntime
+
 /**
  * Configuration information for a Run call.
  */
@@ -27,6 +31,10 @@ struct OrtRunOptions {
   // So it is possible that only some of the nodes are executed.
   bool only_execute_path_to_fetches = false;
 
+  // If set, RunAsync calls using this OrtRunOptions instance queue their completion callback here instead of
+  // calling it on the thread that ran the model. Not owned.
+  onnxruntime::RunCompletionQueue* completion_queue = nullptr;
+
 #ifdef ENABLE_TRAINING
   // Used by onnxruntime::training::TrainingSession. This class is now deprecated.
   // Delete training_mode when TrainingSession is deleted.
@@ -243,6 +243,7 @@ class Node {
 
   /** Gets a modifiable collection of the Node's implicit input definitions. */
   std::vector<NodeArg*>& MutableImplicitInputDefs() noexcept {
+    inference_needed_ = true;
     return definitions_.implicit_input_defs;
   }
 #endif  // !defined(ORT_MINIMAL_BUILD)
@@ -251,15 +252,20 @@ class Node {
   /** Gets a modifiable count of arguments for each of the Node's explicit inputs.
   @todo This should be removed in favor of a method that updates the input args and the count.
         Currently these operations are separate which is not a good setup. */
-  std::vector<int>& MutableInputArgsCount() { return definitions_.input_arg_count; }
+  std::vector<int>& MutableInputArgsCount() {
+    inference_needed_ = true;
+    return definitions_.input_arg_count;
+  }
 
   /** Gets a modifiable collection of the Node's input definitions. */
   std::vector<NodeArg*>& MutableInputDefs() noexcept {
+    inference_needed_ = true;
     return definitions_.input_defs;
   }
 
   /** Gets a modifiable collection of the Node's output definitions. */
   std::vector<NodeArg*>& MutableOutputDefs() noexcept {
+    inference_needed_ = true;
     return definitions_.output_defs;
   }
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -647,6 +653,9 @@ class Node {
   // input/output defs and arg count
   Definitions definitions_;
 
+  // Whether the definitions or attributes may have changed since the last type and shape inference of the node.
+  bool inference_needed_ = true;
+
   // Relationships between this node and others in the graph
   Relationships relationships_;
 
@@ -698,6 +707,12 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   /** Returns the strict_shape_type_inference that was passed into the constructor. */
   bool StrictShapeTypeInference() const { return strict_shape_type_inference_; }
 
+  /** Sets whether Resolve only runs type and shape inference on the nodes of the main graph that were modified,
+  or consume a value whose type or shape changed, since the previous Resolve. Off by default. */
+  void SetIncrementalTypeAndShapeInference(bool incremental) noexcept {
+    incremental_type_and_shape_inference_ = incremental;
+  }
+
 #if !defined(ORT_MINIMAL_BUILD)
   /** Sets the Graph name. */
   void SetName(const std::string& name);
@@ -1144,11 +1159,13 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   @param model_file_path path of the model file.
   @param initializer_size_threshold initializers larger or equal to this threshold (in bytes) are saved
   in the external file. Initializer smaller than this threshold are included in the onnx file.
+  @param compress_initializers compress the initializers saved in the external file.
   @returns GraphProto serialization of the graph.
   */
   ONNX_NAMESPACE::GraphProto ToGraphProtoWithExternalInitializers(const std::filesystem::path& external_file_path,
                                                                   const std::filesystem::path& model_file_path,
-                                                                  size_t initializer_size_threshold) const;
+                                                                  size_t initializer_size_threshold,
+                                                                  bool compress_initializers = false) const;
 
   /** Gets the ISchemaRegistry instances being used with this Graph. */
   IOnnxRuntimeOpSchemaCollectionPtr GetSchemaRegistry() const;
@@ -1349,8 +1366,14 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
     return outer_scope_node_arg_names_;
   }
 
-  common::Status SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder,
-                                 flatbuffers::Offset<onnxruntime::fbs::Graph>& fbs_graph) const;
+  /** Saves the Graph to an ORT format flatbuffer.
+  @param external_data_writer Optional delegate to write the data of large initializers outside of the flatbuffer,
+                              see fbs::utils::ExternalDataWriter. The initializers of subgraphs are not passed to it.
+  */
+  common::Status SaveToOrtFormat(
+      flatbuffers::FlatBufferBuilder& builder, flatbuffers::Offset<onnxruntime::fbs::Graph>& fbs_graph,
+      const std::function<Status(int32_t data_type, gsl::span<const uint8_t> bytes, uint64_t& offset)>&
+          external_data_writer = nullptr) const;
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
@@ -1565,6 +1588,9 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
 
   common::Status VerifyNodeAndOpMatch(const ResolveOptions& options);
 
+  // Whether the type and shape inference of node must run again in an incremental inference.
+  bool TypeAndShapeInferenceNeeded(const Node& node) const;
+
   // Set graph inputs/outputs when resolving a graph..
   common::Status SetGraphInputsOutputs();
 
@@ -1755,6 +1781,9 @@ class Graph {  // NOLINT(clang-analyzer-optin.performance.Padding): preserve exi
   // number of times Resolve has run.
   int num_resolves_ = 0;
 
+  // see SetIncrementalTypeAndShapeInference
+  bool incremental_type_and_shape_inference_ = false;
+
   const logging::Logger& logger_;
 
   // If true, all inconsistencies encountered during shape and type inference
@@ -130,5 +130,9 @@ class NodeArg {
 
   // Flag indicates whether <*this> node arg exists or not.
   bool exists_;
+
+  // Whether the type or shape changed since the last Graph::Resolve. The nodes consuming an unchanged NodeArg can
+  // skip type and shape inference when it is incremental.
+  bool type_changed_ = true;
 };
 }  // namespace onnxruntime
@@ -53,6 +53,11 @@ class RuleBasedGraphTransformer : public GraphTransformer {
   /** Returns the total number of rules that are registered in this transformer. */
   size_t RulesCount() const;
 
+  /** Sets whether the next pass of this transformer on the graph only visits the nodes modified by its previous pass
+      and their neighbors. Only valid if nothing else modified the graph since that pass, which is tracked by
+      GraphTransformerManager. Subgraphs are always visited in full. */
+  void SetApplyIncrementally(bool apply_incrementally) const { apply_incrementally_ = apply_incrementally; }
+
  protected:
   /** Applies the given set of rewrite rules on the Node of this Graph.
       @param[in] graph The Graph.
@@ -75,8 +80,21 @@ class RuleBasedGraphTransformer : public GraphTransformer {
   // Rules that will be evaluated regardless of the op type of the node.
   InlinedVector<std::reference_wrapper<const RewriteRule>> any_op_type_rules_;
 
+  // Applies all registered rules on the node and its subgraphs. If modified_nodes is not null, the node and its
+  // neighbors are added to it if the rules modified them.
+  common::Status ApplyRulesOnNodeAndRecord(Graph& graph, Node& node, bool& modified, int graph_level,
+                                           InlinedHashSet<NodeIndex>* modified_nodes,
+                                           const logging::Logger& logger) const;
+
   // Performs a single top-down traversal of the graph and applies all registered rules.
   common::Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  // State of the incremental application between the passes of the transformer on the main graph.
+  mutable bool apply_incrementally_ = false;
+  // The graph of the previous pass, nullptr if modified_nodes_ is not valid.
+  mutable const Graph* modified_nodes_graph_ = nullptr;
+  // The nodes that the previous pass modified or removed together with their neighbors, and the nodes it added.
+  mutable InlinedHashSet<NodeIndex> modified_nodes_;
 };
 
 }  // namespace onnxruntime
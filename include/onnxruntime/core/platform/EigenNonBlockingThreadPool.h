@@ -39,6 +39,8 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
@@ -53,6 +55,7 @@
 #include "core/platform/ort_mutex.h"
 #include "core/platform/ort_spin_lock.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/threadpool.h"
 
 // ORT thread pool overview
 // ------------------------
@@ -78,6 +81,8 @@
 //
 //   This spin-then-block behavior is configured via a flag provided
 //   when creating the thread pool, and by the constant spin_count.
+//   With ThreadOptions::adaptive_spinning each worker instead spins
+//   for a duration learnt from its recent waits (AdaptiveSpinPolicy).
 //
 // - Although all tasks are simple void()->void functions,
 //   conceptually there are three different kinds:
@@ -339,6 +344,9 @@ class ExtendedThreadPoolInterface : public Eigen::ThreadPoolInterface {
                              unsigned n, std::ptrdiff_t block_size) = 0;
   virtual void StartProfiling() = 0;
   virtual std::string StopProfiling() = 0;
+
+  // Collect the counters of the worker threads, available whether or not profiling is on.
+  virtual void GetStats(ThreadPoolStats& stats) const = 0;
 };
 
 class ThreadPoolParallelSection {
@@ -695,6 +703,40 @@ class RunQueue {
 
 static std::atomic<uint32_t> next_tag{1};
 
+// Adaptive spinning policy of a worker thread.  The worker records how
+// long it waited for each task, i.e. the gaps between the parallel
+// sections it runs, and spins up to twice the exponentially weighted
+// average of those waits.  When the average exceeds the maximum spin the
+// worker blocks right away, so an idle pool stops burning CPU, and it
+// resumes spinning once the waits shorten again.  The samples are capped
+// so that a long idle period is forgotten after a few short waits.
+class AdaptiveSpinPolicy {
+ public:
+  static constexpr uint64_t kMaxSpinNs = 1000 * 1000;
+  static constexpr uint64_t kMinSpinNs = 10 * 1000;
+  static constexpr uint64_t kMaxWaitSampleNs = 4 * kMaxSpinNs;
+
+  // How long to spin for the next task, 0 to block without spinning.
+  uint64_t SpinBudgetNs() const {
+    if (average_wait_ns_ > kMaxSpinNs) {
+      return 0;
+    }
+    return std::min(kMaxSpinNs, 2 * average_wait_ns_ + kMinSpinNs);
+  }
+
+  void RecordWait(uint64_t wait_ns) {
+    wait_ns = std::min(wait_ns, kMaxWaitSampleNs);
+    average_wait_ns_ = average_wait_ns_ - average_wait_ns_ / 8 + wait_ns / 8;
+  }
+
+  uint64_t AverageWaitNs() const {
+    return average_wait_ns_;
+  }
+
+ private:
+  uint64_t average_wait_ns_ = kMaxSpinNs / 4;
+};
+
 template <typename Environment>
 class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInterface {
  private:
@@ -730,6 +772,20 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     return profiler_.Stop();
   }
 
+  void GetStats(ThreadPoolStats& stats) const override {
+    stats.num_threads = num_threads_;
+    for (size_t i = 0; i < worker_data_.size(); ++i) {
+      const WorkerData& td = worker_data_[i];
+      stats.queue_depth += td.queue.Size();
+      stats.num_tasks += td.num_tasks.load(std::memory_order_relaxed);
+      stats.num_steals += td.num_steals.load(std::memory_order_relaxed);
+      stats.spin_time_ns += td.spin_time_ns.load(std::memory_order_relaxed);
+      stats.blocked_time_ns += td.blocked_time_ns.load(std::memory_order_relaxed);
+      stats.num_spin_wakeups += td.num_spin_wakeups.load(std::memory_order_relaxed);
+      stats.num_blocked_wakeups += td.num_blocked_wakeups.load(std::memory_order_relaxed);
+    }
+  }
+
   struct Tag {
     constexpr Tag() : v_(0) {
     }
@@ -773,6 +829,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         env_(env),
         num_threads_(num_threads),
         allow_spinning_(allow_spinning),
+        adaptive_spinning_(allow_spinning && thread_options.adaptive_spinning),
         set_denormal_as_zero_(thread_options.set_denormal_as_zero),
         worker_data_(num_threads),
         all_coprimes_(num_threads),
@@ -1483,6 +1540,27 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       status.store(ThreadStatus::Spinning, std::memory_order_relaxed);
     }
 
+    // Counters of the thread, only updated by the thread itself so that they need no synchronization, read by
+    // GetStats.
+    std::atomic<uint64_t> num_tasks{0};
+    std::atomic<uint64_t> num_steals{0};
+    std::atomic<uint64_t> spin_time_ns{0};
+    std::atomic<uint64_t> blocked_time_ns{0};
+    std::atomic<uint64_t> num_spin_wakeups{0};
+    std::atomic<uint64_t> num_blocked_wakeups{0};
+
+    // Only used by the thread itself, when the pool spins adaptively.
+    AdaptiveSpinPolicy spin_policy;
+
+    static void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    static uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start) {
+      return static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
    private:
     std::atomic<ThreadStatus> status{ThreadStatus::Spinning};
     OrtMutex mutex;
@@ -1492,6 +1570,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   Environment& env_;
   const unsigned num_threads_;
   const bool allow_spinning_;
+  const bool adaptive_spinning_;
   const bool set_denormal_as_zero_;
   Eigen::MaxSizeVector<WorkerData> worker_data_;
   Eigen::MaxSizeVector<Eigen::MaxSizeVector<unsigned>> all_coprimes_;
@@ -1535,6 +1614,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     constexpr int log2_spin = 20;
     const int spin_count = allow_spinning_ ? (1ull << log2_spin) : 0;
     const int steal_count = spin_count / 100;
+    // Interval at which adaptive spinning checks whether its budget is spent.
+    constexpr int spin_clock_interval = 64;
 
     SetDenormalAsZero(set_denormal_as_zero_);
     profiler_.LogThreadId(thread_id);
@@ -1542,23 +1623,36 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     while (!should_exit) {
       Task t = q.PopFront();
       if (!t) {
-        // Spin waiting for work.
-        for (int i = 0; i < spin_count && !done_; i++) {
-          if (((i + 1) % steal_count == 0)) {
-            t = Steal(StealAttemptKind::TRY_ONE);
-          } else {
-            t = q.PopFront();
-          }
-          if (t) break;
+        const auto wait_start = std::chrono::steady_clock::now();
+        const uint64_t spin_budget_ns = adaptive_spinning_ ? td.spin_policy.SpinBudgetNs() : 0;
 
-          if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
-            break;
+        // Spin waiting for work.
+        if (spin_count > 0 && (!adaptive_spinning_ || spin_budget_ns > 0)) {
+          for (int i = 0; i < spin_count && !done_; i++) {
+            if (((i + 1) % steal_count == 0)) {
+              t = Steal(StealAttemptKind::TRY_ONE);
+              if (t) WorkerData::Add(td.num_steals, 1);
+            } else {
+              t = q.PopFront();
+            }
+            if (t) break;
+
+            if (spin_loop_status_.load(std::memory_order_relaxed) == SpinLoopStatus::kIdle) {
+              break;
+            }
+            if (adaptive_spinning_ && (i + 1) % spin_clock_interval == 0 &&
+                WorkerData::NanosecondsSince(wait_start) >= spin_budget_ns) {
+              break;
+            }
+            onnxruntime::concurrency::SpinPause();
           }
-          onnxruntime::concurrency::SpinPause();
+          WorkerData::Add(td.spin_time_ns, WorkerData::NanosecondsSince(wait_start));
+          if (t) WorkerData::Add(td.num_spin_wakeups, 1);
         }
 
         // Attempt to block
         if (!t) {
+          const auto block_start = std::chrono::steady_clock::now();
           td.SetBlocked(  // Pre-block test
               [&]() -> bool {
                 bool should_block = true;
@@ -1614,12 +1708,21 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
               // Post-block update (executed only if we blocked)
               [&]() {
                 blocked_--;
+                WorkerData::Add(td.blocked_time_ns, WorkerData::NanosecondsSince(block_start));
+                WorkerData::Add(td.num_blocked_wakeups, 1);
               });
           // Thread just unblocked.  Unless we picked up work while
           // blocking, or are exiting, then either work was pushed to
           // us, or it was pushed to an overloaded queue
           if (!t) t = q.PopFront();
-          if (!t) t = Steal(StealAttemptKind::TRY_ALL);
+          if (!t) {
+            t = Steal(StealAttemptKind::TRY_ALL);
+            if (t) WorkerData::Add(td.num_steals, 1);
+          }
+        }
+
+        if (adaptive_spinning_ && t) {
+          td.spin_policy.RecordWait(WorkerData::NanosecondsSince(wait_start));
         }
       }
 
@@ -1627,6 +1730,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         td.SetActive();
         t();
         profiler_.LogRun(thread_id);
+        WorkerData::Add(td.num_tasks, 1);
         td.SetSpinning();
       }
     }
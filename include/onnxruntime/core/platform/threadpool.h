@@ -16,6 +16,10 @@ limitations under the License.
 /* Modifications Copyright (c) Microsoft. */
 
 #pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <functional>
@@ -72,6 +76,11 @@ limitations under the License.
 //   API based on the assumption that the caller has divided work to
 //   an appropriate granularity.
 //
+//   ThreadPool::TryParallelForAdaptive needs no cost estimate.  It
+//   distributes contiguous ranges of iterations between threads, lets
+//   idle threads steal work from busy ones, and sizes the blocks it
+//   hands to fn from the measured time per iteration.
+//
 // - When used with the Eigen-based thread pool, the implementation of
 //   all of the loops maps down onto
 //   ThreadPool::ParallelForFixedBlockSizeScheduling.  This method
@@ -136,6 +145,47 @@ class ExtendedThreadPoolInterface;
 class LoopCounter;
 class ThreadPoolParallelSection;
 
+// Options for a ThreadPool that shares the threads of another pool, e.g. a session
+// running on the global thread pools of the environment.
+struct ThreadPoolShareOptions {
+  // Relative share of the shared pool's threads.  When several pools run loops
+  // concurrently on the same shared pool, each loop is limited to a degree of
+  // parallelism in proportion to its pool's weight.
+  int weight = 1;
+
+  // If positive, the maximum degree of parallelism of the pool's loops,
+  // including the thread entering a loop.
+  int max_degree_of_parallelism = 0;
+};
+
+// Counters of a ThreadPool sharing the threads of another pool.  The queueing
+// delay of a loop is the time from entering the loop until a helper thread
+// starts running it.
+struct ThreadPoolShareStats {
+  uint64_t num_loops = 0;
+  uint64_t num_helpers = 0;
+  uint64_t total_queueing_delay_ns = 0;
+  uint64_t max_queueing_delay_ns = 0;
+};
+
+// Counters of the worker threads of a ThreadPool since it was created, but for
+// queue_depth which is the number of tasks queued when read.  The spin time is
+// the time the workers spent spinning for work, the blocked time the time they
+// spent blocked waiting for work, so that along with the number of threads and
+// the elapsed time they tell how busy the pool was.
+struct ThreadPoolStats {
+  uint64_t num_threads = 0;
+  uint64_t queue_depth = 0;
+  uint64_t num_tasks = 0;
+  uint64_t num_steals = 0;
+  uint64_t spin_time_ns = 0;
+  uint64_t blocked_time_ns = 0;
+  // Number of times a worker found work while spinning, and after blocking.
+  // Each wakeup after blocking paid the wake-up latency that spinning avoids.
+  uint64_t num_spin_wakeups = 0;
+  uint64_t num_blocked_wakeups = 0;
+};
+
 class ThreadPool {
  public:
 #ifdef _WIN32
@@ -159,6 +209,11 @@ class ThreadPool {
              bool low_latency_hint,
              bool force_hybrid = false);
 
+  // Constructs a pool that runs its loops on the threads of "shared_pool",
+  // which must outlive it.  Several such pools may share the same pool, with
+  // its threads divided between them according to "share_options".
+  ThreadPool(ThreadPool* shared_pool, const ThreadPoolShareOptions& share_options);
+
   // Waits until all scheduled work has finished and then destroy the
   // set of threads.
   ~ThreadPool();
@@ -213,6 +268,44 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Range of the priorities of the runs using a pool, see RunPriorityScope.
+  static constexpr int kMinRunPriority = -4;
+  static constexpr int kMaxRunPriority = 4;
+
+  // Registers a run with the given priority, clamped to [kMinRunPriority,
+  // kMaxRunPriority], on the pool owning the threads of "tp" for the lifetime
+  // of the object, and makes it the run of the calling thread.  Higher values
+  // are more urgent, and runs without a scope have priority 0.
+  //
+  // While a run is registered, the parallel loops entered by the runs with a
+  // lower priority on the same threads get no helper threads, and the helper
+  // threads already running them stop claiming iterations and leave the rest
+  // to the thread that entered the loop.  The workers are hence given to the
+  // loops of the higher priority runs first.  The executors additionally call
+  // YieldToHigherPriorityRuns between the nodes of a run.
+  //
+  // Has no effect if "tp" is nullptr.  Scopes may be nested on a thread, the
+  // innermost one is the run of the thread.
+  class RunPriorityScope {
+   public:
+    RunPriorityScope(ThreadPool* tp, int priority);
+    ~RunPriorityScope();
+
+   private:
+    friend class ThreadPool;
+
+    ThreadPool* pool_{nullptr};
+    int priority_{0};
+    const RunPriorityScope* previous_{nullptr};
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunPriorityScope);
+  };
+
+  // Blocks the calling thread while a run with a priority higher than the
+  // priority of the run of the thread is registered on the pool of its run.
+  // Returns immediately if the thread has no run, or if all runs of the pool
+  // have the default priority.  Called between the nodes of a run.
+  static void YieldToHigherPriorityRuns();
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -254,6 +347,17 @@ class ThreadPool {
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
 
+  // TryParallelForAdaptive runs the "total" units of work without requiring a
+  // cost estimate, and is intended for loops where the cost of each unit of
+  // work is uneven or unknown (e.g., ragged or sparse inputs).  Each thread
+  // starts with a contiguous range of iterations, and threads that run out of
+  // work steal the back half of the largest range remaining on another thread.
+  // The number of iterations passed to each call of fn adapts to the time
+  // measured per iteration.
+
+  static void TryParallelForAdaptive(ThreadPool* tp, std::ptrdiff_t total,
+                                     const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
   // Directly schedule the 'total' tasks to the underlying threadpool, without
   // cutting them by halves
 
@@ -360,6 +464,15 @@ class ThreadPool {
   // working in combination with the thread initiating the loop.
   static int DegreeOfParallelism(const ThreadPool* tp);
 
+  // Return the counters of a pool sharing the threads of another pool.  All
+  // counters are zero for other pools.
+  ThreadPoolShareStats GetShareStats() const;
+
+  // Return the counters of the worker threads of the pool, of the shared pool
+  // for a pool sharing the threads of another pool.  All counters are zero for
+  // a pool without threads.
+  static ThreadPoolStats GetStats(const ThreadPool* tp);
+
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(ThreadPool);
 
   // StartProfiling and StopProfiling are not to be consumed as public-facing API
@@ -399,6 +512,21 @@ class ThreadPool {
   bool ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
                              const std::ptrdiff_t block_size = 1) const;
 
+  // Returns the pool whose threads run the loops of this pool.
+  ThreadPool* OwningPool() { return shared_pool_ ? shared_pool_ : this; }
+
+  // Returns the priority of the run of the calling thread if it is registered
+  // on the pool owning the threads of this pool, 0 otherwise.
+  int CurrentRunPriority();
+
+  // Returns whether a run with a priority higher than "priority" is
+  // registered on this pool.  Must be called on the owning pool.
+  bool HasHigherPriorityRun(int priority) const;
+
+  // Account the queueing delay of a helper thread joining a loop of a pool sharing
+  // the threads of another pool.
+  void RecordQueueingDelay(uint64_t delay_ns);
+
   // Internal (non-static) parallel loop methods.  Unlike the public static methods,
   // these will not handle the cases of OpenMP builds. or builds without a threadpool.
   void ParallelFor(std::ptrdiff_t total, double cost_per_unit,
@@ -409,6 +537,9 @@ class ThreadPool {
 
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
 
+  void ParallelForAdaptive(std::ptrdiff_t total,
+                           const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
   void Schedule(std::function<void()> fn);
 
   void StartProfiling();
@@ -428,6 +559,29 @@ class ThreadPool {
 
   // Force the thread pool to run in hybrid mode on a normal cpu.
   bool force_hybrid_ = false;
+
+  // If set, the pool whose threads run the loops of this pool.
+  ThreadPool* shared_pool_ = nullptr;
+  ThreadPoolShareOptions share_options_;
+
+  // Sum of the weights of the pools currently running loops on this pool's threads.
+  std::atomic<int64_t> active_share_weight_{0};
+
+  // Number of runs registered by RunPriorityScope on this pool for each
+  // priority from kMinRunPriority, and in total with a priority other than 0,
+  // so that pools used by default priority runs only skip the lookup.
+  std::array<std::atomic<int>, kMaxRunPriority - kMinRunPriority + 1> runs_by_priority_{};
+  std::atomic<int> num_prioritized_runs_{0};
+
+  // Wakes the threads waiting in YieldToHigherPriorityRuns when a run ends.
+  std::mutex run_priority_mutex_;
+  std::condition_variable run_priority_cv_;
+
+  // Counters reported by GetShareStats().
+  std::atomic<uint64_t> share_num_loops_{0};
+  std::atomic<uint64_t> share_num_helpers_{0};
+  std::atomic<uint64_t> share_total_queueing_delay_ns_{0};
+  std::atomic<uint64_t> share_max_queueing_delay_ns_{0};
 };
 
 }  // namespace concurrency
@@ -40,4 +40,6 @@ struct OrtCUDAProviderOptionsV2 {
   int use_tf32 = 1;                                                                                            // use TF32
   int fuse_conv_bias = 0;                                                                                      // Enable CUDNN Frontend kernel fusing, results in JIT compiles
   int sdpa_kernel = 0;                                                                                         // Scaled Dot Product Attention kernel option
+  int use_cuda_mempool = 0;                                                                                    // allocate device memory from a stream-ordered CUDA memory pool instead of the arena
+  size_t cuda_mempool_release_threshold = 0;                                                                   // reserved bytes the CUDA memory pool keeps when synchronizing, 0 keeps all of them
 };
@@ -88,4 +88,6 @@ struct OrtTensorRTProviderOptionsV2 {
 
   const char* trt_engine_cache_prefix{nullptr};  // specify engine cache prefix
   int trt_engine_hw_compatible{0};               // Enable hardware compatibility. Default 0 = false, nonzero = true
+  int trt_profile_growth_enable{0};              // Round the bounds of the profiles built from the input shapes to
+                                                 // powers of two. Default 0 = false, nonzero = true
 };
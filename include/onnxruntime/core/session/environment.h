@@ -13,6 +13,8 @@
 
 struct OrtThreadingOptions;
 namespace onnxruntime {
+class ModelCache;
+
 /** TODO: remove this class
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -88,6 +90,13 @@ class Environment {
    */
   Status CreateAndRegisterAllocatorV2(const std::string& provider_type, const OrtMemoryInfo& mem_info, const std::unordered_map<std::string, std::string>& options, const OrtArenaCfg* arena_cfg = nullptr);
 
+  /**
+   * Returns the cache of the models shared by the sessions using kOrtSessionOptionsConfigUseEnvModelCache.
+   */
+  ModelCache& GetModelCache() const {
+    return *model_cache_;
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
   Status Initialize(std::unique_ptr<logging::LoggingManager> logging_manager,
@@ -99,5 +108,7 @@ class Environment {
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
   bool create_global_thread_pools_{false};
   std::vector<AllocatorPtr> shared_allocators_;
+  // shared_ptr as ModelCache is incomplete here
+  std::shared_ptr<ModelCache> model_cache_;
 };
 }  // namespace onnxruntime
@@ -304,6 +304,9 @@ ORT_RUNTIME_CLASS(Op);
 ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
 ORT_RUNTIME_CLASS(ShapeInferContext);
+ORT_RUNTIME_CLASS(PreparedRun);
+ORT_RUNTIME_CLASS(RunCompletionQueue);
+ORT_RUNTIME_CLASS(OverlappedRunner);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -652,6 +655,22 @@ typedef struct OrtOpenVINOProviderOptions {
   unsigned char enable_dynamic_shapes;     ///< 0 = disabled, nonzero = enabled
 } OrtOpenVINOProviderOptions;
 
+/** \brief Counters of the worker threads of a thread pool
+ *
+ * Filled in by OrtApi::SessionGetIntraOpThreadPoolStats. The counters accumulate from the creation of the pool, except
+ * queue_depth which is read at the time of the call. They are always collected, whether or not profiling is enabled.
+ */
+typedef struct OrtThreadPoolStats {
+  uint64_t num_threads;          ///< Number of worker threads, not counting the threads calling into the pool
+  uint64_t queue_depth;          ///< Number of tasks waiting in the queues of the worker threads
+  uint64_t num_tasks;            ///< Number of tasks run by the worker threads
+  uint64_t num_steals;           ///< Number of tasks a worker thread took from the queue of another
+  uint64_t spin_time_ns;         ///< Time the worker threads spent spinning for work, in nanoseconds
+  uint64_t idle_time_ns;         ///< Time the worker threads spent blocked waiting for work, in nanoseconds
+  uint64_t num_spin_wakeups;     ///< Number of times a worker thread found work while spinning
+  uint64_t num_blocked_wakeups;  ///< Number of times a worker thread woke up from blocking, paying the wake-up latency
+} OrtThreadPoolStats;
+
 struct OrtApi;
 typedef struct OrtApi OrtApi;
 
@@ -2803,6 +2822,14 @@ struct OrtApi {
    *  Use -1 to allow ORT to choose the default 1GB for max_power_of_two_extend_bytes.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_bytes": Size of each per-thread (or per-stream for stream aware arenas) cache of freed chunks
+   *  that serves allocations without taking the arena lock. Freed chunks beyond this size are returned to the arena
+   *  in batches. Use 0 to disable the cache (the default).
+   * "thread_cache_max_chunk_bytes": Largest allocation served by the per-thread cache.
+   *  Only relevant if "thread_cache_bytes" is not 0. Use -1 to allow ORT to choose the default of 256KB.
+   * "trim_window_ms": Length of the window over which the arena tracks the high-water mark of its memory in use.
+   *  When memory is freed the arena periodically returns unused regions to the device, as long as the memory it
+   *  keeps stays above that high-water mark. Use 0 to disable trimming (the default).
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4666,6 +4693,433 @@ struct OrtApi {
                   _In_reads_(num_external_initializer_files) char* const* external_initializer_file_buffer_array,
                   _In_reads_(num_external_initializer_files) const size_t* external_initializer_file_lengths,
                   size_t num_external_initializer_files);
+
+  /** \brief Get a latency percentile of the kernel of a node
+   *
+   * Reads the per-node latency histograms kept when the "session.enable_latency_histograms" session config entry
+   * is "1". Only the nodes of the main graph are tracked. The latency is the upper bound of the histogram bucket
+   * holding the percentile, which is within 25% of the exact value.
+   *
+   * \param[in] session
+   * \param[in] node_name Null terminated string of the node name. Nodes without a name are named
+   *            "<op type>_<node index>", as in profiles.
+   * \param[in] percentile Percentile between 0 and 100, e.g. 99 for the 99th percentile.
+   * \param[out] latency_ns Latency in nanoseconds, 0 if the node has not run yet.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetNodeLatencyPercentile, _In_ const OrtSession* session, _In_ const char* node_name,
+                  _In_ double percentile, _Out_ int64_t* latency_ns);
+
+  /** \brief Get a latency percentile of the kernels of the nodes of an operator type
+   *
+   * Same as OrtApi::SessionGetNodeLatencyPercentile, over all the nodes of the main graph with the operator type.
+   *
+   * \param[in] session
+   * \param[in] op_type Null terminated string of the operator type, e.g. "Conv".
+   * \param[in] percentile Percentile between 0 and 100.
+   * \param[out] latency_ns Latency in nanoseconds, 0 if no such node has run yet.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetOpTypeLatencyPercentile, _In_ const OrtSession* session, _In_ const char* op_type,
+                  _In_ double percentile, _Out_ int64_t* latency_ns);
+
+  /** \brief Export the latency histograms of a session in the Prometheus text format
+   *
+   * Writes the onnxruntime_node_latency_seconds histograms, labeled with node and op_type, and the
+   * onnxruntime_op_type_latency_seconds histograms, labeled with op_type, in the Prometheus text exposition format.
+   * The histograms are cumulative since the session was created.
+   * Requires the "session.enable_latency_histograms" session config entry to be "1".
+   *
+   * \param[in] session
+   * \param[in] allocator Allocator used to allocate the returned string
+   * \param[out] out Null terminated string of the histograms, free with allocator
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetLatencyHistogramsPrometheus, _In_ const OrtSession* session,
+                  _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
+  /** \brief Prepare runs of a session with fixed inputs and outputs
+   *
+   * The names of the inputs and outputs are resolved once, and runs with the ::OrtPreparedRun skip their lookups.
+   * The inputs and outputs must be tensors. The device copies of the inputs and outputs are set up again only when
+   * their devices differ from the previous run.
+   *
+   * \param[in] session
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_len Number of elements in the input_names array
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names array
+   * \param[out] out Newly created ::OrtPreparedRun. Must be freed with OrtApi::ReleasePreparedRun before the session
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _In_ const OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /** \brief Run the model with the inputs and outputs of a prepared run
+   *
+   * Works like OrtApi::Run, with the input and output names of the ::OrtPreparedRun.
+   * An ::OrtPreparedRun must not be used by concurrent calls.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] prepared_run Created with OrtApi::CreatePreparedRun for this session
+   * \param[in] inputs Array of ::OrtValue%s of the input values, in the order of the input names of prepared_run
+   * \param[in] input_len Number of elements in the inputs array
+   * \param[in,out] outputs Array of ::OrtValue%s that the outputs are stored in, in the order of the output names of
+   *   prepared_run. This can also be an array of nullptr values, in this case ::OrtValue objects will be allocated
+   *   and pointers to them will be set into the `outputs` array.
+   * \param[in] outputs_len Number of elements in the outputs array
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _Inout_ OrtPreparedRun* prepared_run,
+                  _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                  _Inout_updates_all_(outputs_len) OrtValue** outputs, size_t outputs_len);
+
+  /** \brief Release an ::OrtPreparedRun
+   *
+   * \since Version 1.20.
+   */
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /** \brief Get the counters of the intra op thread pool of a session
+   *
+   * The pool is the global intra op thread pool of the environment when the session uses the global thread pools.
+   * All counters are zero when the session runs without intra op worker threads. See ::OrtThreadPoolStats.
+   *
+   * \param[in] session
+   * \param[out] stats Filled in with the counters of the pool
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionGetIntraOpThreadPoolStats, _In_ const OrtSession* session, _Out_ OrtThreadPoolStats* stats);
+
+  /** \brief Create an ::OrtRunCompletionQueue
+   *
+   * A completion queue collects the callbacks of the OrtApi::RunAsync calls whose run options were given the queue
+   * with OrtApi::RunOptionsSetCompletionQueue. The callbacks then run on the thread calling
+   * OrtApi::RunCompletionQueueDispatch, e.g. the thread of the caller's event loop, instead of on the intra op
+   * thread that ran the model. One thread can so drive many runs in flight without synchronizing with them.
+   *
+   * \param[out] out Newly created ::OrtRunCompletionQueue. Must be freed with OrtApi::ReleaseRunCompletionQueue
+   *   once the runs using it completed and their callbacks were dispatched.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CreateRunCompletionQueue, _Outptr_ OrtRunCompletionQueue** out);
+
+  /** \brief Release an ::OrtRunCompletionQueue
+   *
+   * \since Version 1.20.
+   */
+  ORT_CLASS_RELEASE(RunCompletionQueue);
+
+  /** \brief Get a file descriptor that is readable while callbacks are pending in the queue
+   *
+   * On Linux this is an eventfd owned by the queue that an event loop can poll with epoll, io_uring, etc., calling
+   * OrtApi::RunCompletionQueueDispatch when it is readable. The fd may be readable with no callback pending, after
+   * a dispatch raced with a completion. On other platforms fd is set to -1, and
+   * OrtApi::RunCompletionQueueDispatch can wait for the completions.
+   *
+   * \param[in] queue
+   * \param[out] fd
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunCompletionQueueGetFd, _In_ const OrtRunCompletionQueue* queue, _Out_ int* fd);
+
+  /** \brief Call the pending RunAsync callbacks of the queue on the calling thread
+   *
+   * \param[in] queue
+   * \param[in] timeout_ms How long to wait for a completion when none is pending. 0 not to wait, a negative value
+   *   to wait indefinitely.
+   * \param[out] num_dispatched Number of callbacks called
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunCompletionQueueDispatch, _Inout_ OrtRunCompletionQueue* queue, int timeout_ms,
+                  _Out_ size_t* num_dispatched);
+
+  /** \brief Set the completion queue of the OrtApi::RunAsync calls using the run options
+   *
+   * \param[in] options
+   * \param[in] queue The queue the callbacks are queued to, or nullptr to call them on the thread that ran the model.
+   *   Must outlive the runs using it.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunOptionsSetCompletionQueue, _Inout_ OrtRunOptions* options, _In_opt_ OrtRunCompletionQueue* queue);
+
+  /** \brief Create a replica of a session that shares its loaded and initialized model
+   *
+   * The clone shares the kernels, initializers, pre-packed weights, execution plan, execution providers and thread
+   * pools of the session, and has its own run state, e.g. for a replica per thread or per tenant. Creating it
+   * doesn't load or initialize the model again. Sessions whose execution providers don't support concurrent runs
+   * or capture graphs can't be cloned.
+   *
+   * \param[in] session The session to clone. Must outlive the clone.
+   * \param[out] out Newly created ::OrtSession. Must be freed with OrtApi::ReleaseSession
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CloneSession, _In_ const OrtSession* session, _Outptr_ OrtSession** out);
+
+  /** \brief Replace the values of initializers of a session, e.g. to roll out new weights without another session
+   *
+   * The values must have the element type and shape of the initializers they replace, and are copied. Only the
+   * kernels using a replaced initializer pre-pack it again. The runs in progress complete with the previous values,
+   * and the runs started during the update wait for it and use the new values, also in the clones of the session
+   * (see OrtApi::CloneSession). Kernels that compute state from a constant initializer when the session is created,
+   * other than by pre-packing it, keep using that state. Shared, sparse and string initializers can't be updated.
+   *
+   * \param[in] session
+   * \param[in] names Names of the initializers of the main graph
+   * \param[in] values New values of the initializers
+   * \param[in] count Number of names and values
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionUpdateInitializers, _Inout_ OrtSession* session, _In_reads_(count) const char* const* names,
+                  _In_reads_(count) const OrtValue* const* values, size_t count);
+
+  /** \brief Run fn in parallel over ranges of [0, total), using the cost of an iteration to decide how many threads to use
+   *
+   * Unlike OrtApi::KernelContext_ParallelFor, fn is called once per range instead of once per iteration, and a
+   * small or cheap loop runs on the calling thread. The ranges don't overlap and together cover [0, total).
+   *
+   * \param[in] context
+   * \param[in] fn Function accepting usr_data and the range [begin, end) of iterations to run
+   * \param[in] total The number of iterations
+   * \param[in] cost_per_unit Estimated number of CPU cycles an iteration takes
+   * \param[in] usr_data User data to be passed back to fn
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(KernelContext_ParallelForRange, _In_ const OrtKernelContext* context,
+                  _In_ void (*fn)(void* usr_data, size_t begin, size_t end), _In_ size_t total,
+                  _In_ double cost_per_unit, _In_ void* usr_data);
+
+  /** \brief Get the number of threads, including the calling thread, that run the loops of a kernel in parallel
+   *
+   * This is e.g. the number of per-thread scratch buffers a kernel needs for OrtApi::KernelContext_ParallelForRange.
+   * It is 1 if the session has no intra-op thread pool.
+   *
+   * \param[in] context
+   * \param[out] out The degree of parallelism
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(KernelContext_GetDegreeOfParallelism, _In_ const OrtKernelContext* context, _Out_ int* out);
+
+  /** \brief Get the contents of a sequence of maps, e.g. the output of a ZipMap node, as three tensors
+   *
+   * This converts a seq(map(string, float)) or seq(map(int64, float)) with a single copy of the keys and the values,
+   * instead of an OrtValue per map and per tensor with OrtApi::GetValue. The keys and values of map i are the
+   * elements offsets[i] to offsets[i + 1] of the keys and values tensors, in ascending order of the keys.
+   *
+   * \param[in] value A sequence of maps
+   * \param[in] allocator Allocator of the output tensors
+   * \param[out] keys 1D tensor with the keys of all the maps, of type string or int64
+   * \param[out] values 1D tensor with the values of all the maps, of type float
+   * \param[out] offsets 1D int64 tensor with the number of maps + 1 offsets of the maps in the keys and values
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(GetSequenceOfMapsAsColumns, _In_ const OrtValue* value, _Inout_ OrtAllocator* allocator,
+                  _Outptr_ OrtValue** keys, _Outptr_ OrtValue** values, _Outptr_ OrtValue** offsets);
+
+  /** \brief Run a model split into consecutive sessions, e.g. one per device, as a pipeline of micro-batches
+   *
+   * The inputs are split along their first (batch) dimension into num_micro_batches micro-batches, without copying.
+   * Each session runs on its own thread and processes the micro-batches in order, so consecutive sessions overlap on
+   * consecutive micro-batches. A session takes each input of its model from the inputs or from the outputs of the
+   * previous sessions of the same micro-batch. The requested outputs are concatenated back along the batch dimension.
+   *
+   * The inputs and the requested outputs must be CPU tensors of a numeric type. Setting the terminate flag of the
+   * run options (see OrtApi::RunOptionsSetTerminate) stops the sessions before their next micro-batch.
+   *
+   * \param[in] sessions The sessions in execution order
+   * \param[in] num_sessions
+   * \param[in] num_micro_batches Number of micro-batches the batch is split into. A smaller batch is split into
+   *   micro-batches of one row
+   * \param[in] run_options If nullptr, default run options are used
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] inputs Array of ::OrtValue%s of the input values
+   * \param[in] input_len Number of elements in the input_names and inputs arrays
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names and outputs array
+   * \param[out] outputs Array of null pointers set to the newly created ::OrtValue%s of the outputs. They must be
+   *   freed with OrtApi::ReleaseValue
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(RunPipeline, _In_reads_(num_sessions) OrtSession* const* sessions, size_t num_sessions,
+                  int64_t num_micro_batches, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** outputs);
+
+  /** \brief Create an ::OrtOverlappedRunner running a stream of requests with host feeds and fetches on a session
+   *
+   * The runner copies the feeds of a request to the device, runs the session and copies the fetches back to the
+   * host on three threads, so that the upload of request N + 1 and the download of request N - 1 overlap the run
+   * of request N. At most num_slots requests are in flight. The device buffers of the feeds of a slot are reused
+   * by its next request if they have the same types and shapes.
+   *
+   * \param[in] session Must outlive the runner
+   * \param[in] device_memory_info Memory the feeds are copied to, one of the allocators of the session
+   * \param[in] num_slots Maximum number of requests in flight
+   * \param[out] out Newly created ::OrtOverlappedRunner. Must be freed with OrtApi::ReleaseOverlappedRunner, which
+   *   completes the requests in flight
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(CreateOverlappedRunner, _In_ OrtSession* session, _In_ const OrtMemoryInfo* device_memory_info,
+                  size_t num_slots, _Outptr_ OrtOverlappedRunner** out);
+
+  /** \brief Release an ::OrtOverlappedRunner
+   *
+   * \since Version 1.20.
+   */
+  ORT_CLASS_RELEASE(OverlappedRunner);
+
+  /** \brief Queue a request with host feeds to an ::OrtOverlappedRunner, blocking while all its slots are in flight
+   *
+   * The callback is called on a thread of the runner with the status of the request and, if it succeeded, the host
+   * fetches. The fetches are owned by the callback and must be freed with OrtApi::ReleaseValue, the array is only
+   * valid during the call. The status must be freed with OrtApi::ReleaseStatus.
+   *
+   * \param[in] runner
+   * \param[in] run_options If nullptr, default run options are used
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] inputs Array of ::OrtValue%s of the host input values, which are referenced until they are uploaded
+   * \param[in] input_len Number of elements in the input_names and inputs arrays
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names array
+   * \param[in] callback Called once the request completed
+   * \param[in] user_data Passed to the callback
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(OverlappedRunnerRunAsync, _Inout_ OrtOverlappedRunner* runner,
+                  _In_opt_ const OrtRunOptions* run_options, _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+
+  /** \brief Wait until the requests queued to an ::OrtOverlappedRunner completed
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(OverlappedRunnerWait, _Inout_ OrtOverlappedRunner* runner);
+
+  /** \brief Cache the present key/value tensors fetched for a token prefix in the prefix key/value cache of a session
+   *
+   * The cache is enabled by the "session.prefix_kv_cache_max_bytes" session option. The values are held as is,
+   * without a copy, and must not be written to while they are cached. An existing entry for the same tokens is
+   * replaced, and values which alone exceed the size of the cache are not cached.
+   *
+   * \param[in] session
+   * \param[in] tokens Token ids of the prefix
+   * \param[in] num_tokens Number of token ids
+   * \param[in] input_names Names of the graph inputs the values are to be bound to, e.g. the past key/value inputs
+   * \param[in] values Present key/value tensors computed for the prefix
+   * \param[in] num_values Number of input names and values
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionInsertCachedPrefix, _Inout_ OrtSession* session,
+                  _In_reads_(num_tokens) const int64_t* tokens, size_t num_tokens,
+                  _In_reads_(num_values) const char* const* input_names,
+                  _In_reads_(num_values) const OrtValue* const* values, size_t num_values);
+
+  /** \brief Bind the cached key/value tensors of the longest cached prefix of tokens as inputs of an IoBinding
+   *
+   * The tensors are bound without a copy and stay valid while they are bound, even if the prefix is evicted from the
+   * cache meanwhile. The caller runs the remaining tokens with a past sequence length of prefix_length.
+   *
+   * \param[in] session
+   * \param[in] binding IoBinding of the session to bind the inputs to
+   * \param[in] tokens Token ids of the request
+   * \param[in] num_tokens Number of token ids
+   * \param[out] prefix_length Number of tokens of the bound prefix, 0 if no prefix of tokens is cached and nothing
+   *                           was bound
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(SessionBindLongestCachedPrefix, _Inout_ OrtSession* session, _Inout_ OrtIoBinding* binding,
+                  _In_reads_(num_tokens) const int64_t* tokens, size_t num_tokens, _Out_ size_t* prefix_length);
+
+  /** \brief Bind a state carried from each run of an ::OrtIoBinding to the next one
+   *
+   * initial_value is bound as the named input, and after each successful OrtApi::RunWithBinding the named output is
+   * bound in its place without a copy, e.g. for the cache of a streaming model run chunk by chunk. From the third run
+   * on, the output is written to the buffer of the input of the previous run, so the state must keep its shape across
+   * the runs. The buffer of initial_value is not written to.
+   *
+   * After a run, the bound output is the state computed by the run. After a failed run, it is unset.
+   *
+   * \param[in] binding_ptr
+   * \param[in] input_name Name of the model input of the state
+   * \param[in] output_name Name of the model output of the state
+   * \param[in] initial_value ::OrtValue of Tensor type, the state of the first run
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.20.
+   */
+  ORT_API2_STATUS(BindState, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* input_name,
+                  _In_ const char* output_name, _In_ const OrtValue* initial_value);
 };
 
 /*
@@ -4778,6 +5232,15 @@ struct OrtCustomOp {
   // Same as GetMayInplace() and ReleaseMayInplace()
   size_t(ORT_API_CALL* GetAliasMap)(_Out_ int** input_index, _Out_ int** output_index);
   void(ORT_API_CALL* ReleaseAliasMap)(_Frees_ptr_opt_ int* input_index, _Frees_ptr_opt_ int* output_index);
+
+  // Pre-pack the constant initializer "tensor" used as input "input_index" of a kernel when the session is
+  // initialized, e.g. into the layout its computation reads fastest. "tensor" is only valid during the call.
+  // The packed data must be allocated from "allocator", which stays valid until the kernel is destroyed.
+  // Set *is_packed to 1 if the kernel keeps the packed data and doesn't read the input in the compute calls anymore,
+  // the session may release the initializer then. The function is not called if it is NULL.
+  OrtStatusPtr(ORT_API_CALL* KernelPrePackWeight)(_In_ void* op_kernel, _In_ const OrtValue* tensor,
+                                                  _In_ int input_index, _Inout_ OrtAllocator* allocator,
+                                                  _Out_ int* is_packed);
 };
 
 /*
@@ -522,6 +522,8 @@ ORT_DEFINE_RELEASE(Status);
 ORT_DEFINE_RELEASE(OpAttr);
 ORT_DEFINE_RELEASE(Op);
 ORT_DEFINE_RELEASE(KernelInfo);
+ORT_DEFINE_RELEASE(PreparedRun);
+ORT_DEFINE_RELEASE(RunCompletionQueue);
 
 #undef ORT_DEFINE_RELEASE
 
@@ -736,6 +738,19 @@ struct CustomOpDomain : detail::Base<OrtCustomOpDomain> {
   void Add(const OrtCustomOp* op);  ///< Wraps CustomOpDomain_Add
 };
 
+/** \brief Wrapper around ::OrtRunCompletionQueue
+ *
+ * Must outlive the runs queueing their callbacks to it.
+ */
+struct RunCompletionQueue : detail::Base<OrtRunCompletionQueue> {
+  explicit RunCompletionQueue(std::nullptr_t) {}                                               ///< Create an empty RunCompletionQueue object, must be assigned a valid one to be used
+  explicit RunCompletionQueue(OrtRunCompletionQueue* p) : Base<OrtRunCompletionQueue>{p} {}  ///< Used for interop with the C API
+  RunCompletionQueue();                                                                        ///< Wraps OrtApi::CreateRunCompletionQueue
+
+  int GetFd() const;                     ///< Wraps OrtApi::RunCompletionQueueGetFd
+  size_t Dispatch(int timeout_ms = 0);  ///< Wraps OrtApi::RunCompletionQueueDispatch
+};
+
 /** \brief RunOptions
  *
  */
@@ -766,6 +781,8 @@ struct RunOptions : detail::Base<OrtRunOptions> {
    * Wraps OrtApi::RunOptionsUnsetTerminate
    */
   RunOptions& UnsetTerminate();
+
+  RunOptions& SetCompletionQueue(RunCompletionQueue& queue);  ///< Wraps OrtApi::RunOptionsSetCompletionQueue
 };
 
 namespace detail {
@@ -994,6 +1011,7 @@ struct ModelMetadata : detail::Base<OrtModelMetadata> {
 };
 
 struct IoBinding;
+struct PreparedRun;
 
 namespace detail {
 
@@ -1041,6 +1059,19 @@ struct ConstSessionImpl : Base<T> {
   TypeInfo GetInputTypeInfo(size_t index) const;                   ///< Wraps OrtApi::SessionGetInputTypeInfo
   TypeInfo GetOutputTypeInfo(size_t index) const;                  ///< Wraps OrtApi::SessionGetOutputTypeInfo
   TypeInfo GetOverridableInitializerTypeInfo(size_t index) const;  ///< Wraps OrtApi::SessionGetOverridableInitializerTypeInfo
+
+  int64_t GetNodeLatencyPercentile(const char* node_name, double percentile) const;  ///< Wraps OrtApi::SessionGetNodeLatencyPercentile
+  int64_t GetOpTypeLatencyPercentile(const char* op_type, double percentile) const;  ///< Wraps OrtApi::SessionGetOpTypeLatencyPercentile
+
+  /** \brief Returns a copy of the latency histograms of the session in the Prometheus text format.
+   *
+   * \param allocator to allocate memory for the copy of the string returned
+   * \return a instance of smart pointer that would deallocate the buffer when out of scope.
+   *  The OrtAllocator instances must be valid at the point of memory release.
+   */
+  AllocatedStringPtr GetLatencyHistogramsPrometheusAllocated(OrtAllocator* allocator) const;  ///< Wraps OrtApi::SessionGetLatencyHistogramsPrometheus
+
+  OrtThreadPoolStats GetIntraOpThreadPoolStats() const;  ///< Wraps OrtApi::SessionGetIntraOpThreadPoolStats
 };
 
 template <typename T>
@@ -1076,6 +1107,21 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Run the model with the inputs and outputs of a prepared run
+   *
+   * Wraps OrtApi::RunPrepared
+   *
+   * \param[in] run_options
+   * \param[in] prepared_run Prepared run of this session
+   * \param[in] input_values Array of Value objects of length input_count, in the order of the input names of prepared_run
+   * \param[in] input_count Number of inputs
+   * \param[in,out] output_values Array of Value objects of length output_count, in the order of the output names of
+   *   prepared_run. Null values are filled with the outputs allocated by onnxruntime.
+   * \param[in] output_count Number of outputs
+   */
+  void Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+
   /** \brief Run the model asynchronously in a thread owned by intra op thread pool
    *
    * Wraps OrtApi::RunAsync
@@ -1105,6 +1151,40 @@ struct SessionImpl : ConstSessionImpl<T> {
    *  The OrtAllocator instances must be valid at the point of memory release.
    */
   AllocatedStringPtr EndProfilingAllocated(OrtAllocator* allocator);  ///< Wraps OrtApi::SessionEndProfiling
+
+  /** \brief Replace the values of initializers of the session
+   *
+   * Wraps OrtApi::SessionUpdateInitializers
+   *
+   * \param[in] names Array of null terminated strings of length count with the names of the initializers
+   * \param[in] values Array of Value objects of length count with the new values of the initializers
+   * \param[in] count Number of initializers
+   */
+  void UpdateInitializers(const char* const* names, const Value* values, size_t count);
+
+  /** \brief Cache the present key/value tensors fetched for a token prefix
+   *
+   * Wraps OrtApi::SessionInsertCachedPrefix
+   *
+   * \param[in] tokens Array of num_tokens token ids of the prefix
+   * \param[in] num_tokens Number of token ids
+   * \param[in] input_names Array of null terminated strings of length count with the names of the inputs to bind
+   * \param[in] values Array of Value objects of length count with the key/value tensors of the prefix
+   * \param[in] count Number of input names and values
+   */
+  void InsertCachedPrefix(const int64_t* tokens, size_t num_tokens, const char* const* input_names,
+                          const Value* values, size_t count);
+
+  /** \brief Bind the cached key/value tensors of the longest cached prefix of tokens
+   *
+   * Wraps OrtApi::SessionBindLongestCachedPrefix
+   *
+   * \param[in] binding IoBinding of the session
+   * \param[in] tokens Array of num_tokens token ids
+   * \param[in] num_tokens Number of token ids
+   * \return Number of tokens of the bound prefix, 0 if nothing was bound
+   */
+  size_t BindLongestCachedPrefix(IoBinding& binding, const int64_t* tokens, size_t num_tokens);
 };
 
 }  // namespace detail
@@ -1123,11 +1203,25 @@ struct Session : detail::SessionImpl<OrtSession> {
   Session(const Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options);  ///< Wraps OrtApi::CreateSessionFromArray
   Session(const Env& env, const void* model_data, size_t model_data_length, const SessionOptions& options,
           OrtPrepackedWeightsContainer* prepacked_weights_container);  ///< Wraps OrtApi::CreateSessionFromArrayWithPrepackedWeightsContainer
+  explicit Session(OrtSession* p) : detail::SessionImpl<OrtSession>{p} {}  ///< Used for interop with the C API
+
+  Session Clone() const;  ///< Wraps OrtApi::CloneSession, the session must outlive the clone
 
   ConstSession GetConst() const { return ConstSession{this->p_}; }
   UnownedSession GetUnowned() const { return UnownedSession{this->p_}; }
 };
 
+/** \brief Wrapper around ::OrtPreparedRun
+ *
+ * Must be released before its session.
+ */
+struct PreparedRun : detail::Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}                                 ///< Create an empty PreparedRun object, must be assigned a valid one to be used
+  explicit PreparedRun(OrtPreparedRun* p) : Base<OrtPreparedRun>{p} {}  ///< Used for interop with the C API
+  PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);  ///< Wraps OrtApi::CreatePreparedRun
+};
+
 namespace detail {
 template <typename T>
 struct MemoryInfoImpl : Base<T> {
@@ -1324,6 +1418,12 @@ struct ConstValueImpl : Base<T> {
   size_t GetCount() const;  // If a non tensor, returns 2 for map and N for sequence, where N is the number of elements
   Value GetValue(int index, OrtAllocator* allocator) const;
 
+  /// <summary>
+  /// Gets the keys, values and offsets of the maps of a sequence of maps as tensors,
+  /// see OrtApi::GetSequenceOfMapsAsColumns.
+  /// </summary>
+  void GetSequenceOfMapsAsColumns(OrtAllocator* allocator, Value& keys, Value& values, Value& offsets) const;
+
   /// <summary>
   /// This API returns a full length of string data contained within either a tensor or a sparse Tensor.
   /// For sparse tensor it returns a full length of stored non-empty strings (values). The API is useful
@@ -1847,6 +1947,7 @@ struct IoBindingImpl : ConstIoBindingImpl<T> {
   void BindInput(const char* name, const Value&);
   void BindOutput(const char* name, const Value&);
   void BindOutput(const char* name, const OrtMemoryInfo*);
+  void BindState(const char* input_name, const char* output_name, const Value& initial_value);
   void ClearBoundInputs();
   void ClearBoundOutputs();
   void SynchronizeInputs();
@@ -2070,6 +2171,12 @@ struct KernelContext {
   OrtAllocator* GetAllocator(const OrtMemoryInfo& memory_info) const;
   OrtKernelContext* GetOrtKernelContext() const { return ctx_; }
   void ParallelFor(void (*fn)(void*, size_t), size_t total, size_t num_batch, void* usr_data) const;
+  // Wraps OrtApi::KernelContext_ParallelForRange
+  void ParallelForRange(void (*fn)(void*, size_t, size_t), size_t total, double cost_per_unit, void* usr_data) const;
+  // Runs fn(begin, end) over the ranges of [0, total), see OrtApi::KernelContext_ParallelForRange
+  template <typename Fn>
+  void ParallelForRange(size_t total, double cost_per_unit, Fn&& fn) const;
+  int GetDegreeOfParallelism() const;  ///< Wraps OrtApi::KernelContext_GetDegreeOfParallelism
 
  private:
   OrtKernelContext* ctx_;
@@ -2244,6 +2351,29 @@ using ShapeInferFn = Ort::Status (*)(Ort::ShapeInferContext&);
 
 #define MAX_CUSTOM_OP_END_VER (1UL << 31) - 1
 
+namespace detail {
+// Exports (input index, output index) pairs in the form of OrtCustomOp::GetMayInplace and OrtCustomOp::GetAliasMap
+inline size_t ExportIndexPairs(const std::vector<std::pair<int, int>>& pairs, int** input_index, int** output_index) {
+  *input_index = nullptr;
+  *output_index = nullptr;
+  if (pairs.empty()) {
+    return 0;
+  }
+  *input_index = new int[pairs.size()];
+  *output_index = new int[pairs.size()];
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    (*input_index)[i] = pairs[i].first;
+    (*output_index)[i] = pairs[i].second;
+  }
+  return pairs.size();
+}
+
+inline void ReleaseIndexPairs(int* input_index, int* output_index) {
+  delete[] input_index;
+  delete[] output_index;
+}
+}  // namespace detail
+
 template <typename TOp, typename TKernel, bool WithStatus = false>
 struct CustomOpBase : OrtCustomOp {
   CustomOpBase() {
@@ -2305,10 +2435,9 @@ struct CustomOpBase : OrtCustomOp {
       return static_cast<const TOp*>(this_)->end_ver_;
     };
 
-    OrtCustomOp::GetMayInplace = nullptr;
-    OrtCustomOp::ReleaseMayInplace = nullptr;
-    OrtCustomOp::GetAliasMap = nullptr;
-    OrtCustomOp::ReleaseAliasMap = nullptr;
+    SetMayInplaceFn<TOp>(0);
+    SetAliasMapFn<TOp>(0);
+    SetPrePackWeightFn<TKernel>(0);
   }
 
   // Default implementation of GetExecutionProviderType that returns nullptr to default to the CPU provider
@@ -2374,6 +2503,63 @@ struct CustomOpBase : OrtCustomOp {
     OrtCustomOp::InferOutputShapeFn = {};
   }
 
+  // Implement "static std::vector<std::pair<int, int>> GetMayInplacePairs()" in TOp to return the
+  // (input index, output index) pairs of OrtCustomOp::GetMayInplace
+  template <typename C>
+  decltype(&C::GetMayInplacePairs) SetMayInplaceFn(decltype(&C::GetMayInplacePairs)) {
+    OrtCustomOp::GetMayInplace = [](int** input_index, int** output_index) {
+      return detail::ExportIndexPairs(C::GetMayInplacePairs(), input_index, output_index);
+    };
+    OrtCustomOp::ReleaseMayInplace = [](int* input_index, int* output_index) {
+      detail::ReleaseIndexPairs(input_index, output_index);
+    };
+    return {};
+  }
+
+  template <typename C>
+  void SetMayInplaceFn(...) {
+    OrtCustomOp::GetMayInplace = nullptr;
+    OrtCustomOp::ReleaseMayInplace = nullptr;
+  }
+
+  // Implement "static std::vector<std::pair<int, int>> GetAliasPairs()" in TOp to return the
+  // (input index, output index) pairs of OrtCustomOp::GetAliasMap
+  template <typename C>
+  decltype(&C::GetAliasPairs) SetAliasMapFn(decltype(&C::GetAliasPairs)) {
+    OrtCustomOp::GetAliasMap = [](int** input_index, int** output_index) {
+      return detail::ExportIndexPairs(C::GetAliasPairs(), input_index, output_index);
+    };
+    OrtCustomOp::ReleaseAliasMap = [](int* input_index, int* output_index) {
+      detail::ReleaseIndexPairs(input_index, output_index);
+    };
+    return {};
+  }
+
+  template <typename C>
+  void SetAliasMapFn(...) {
+    OrtCustomOp::GetAliasMap = nullptr;
+    OrtCustomOp::ReleaseAliasMap = nullptr;
+  }
+
+  // Implement "Ort::Status PrePackWeight(Ort::ConstValue tensor, int input_index, OrtAllocator* allocator,
+  // bool& is_packed)" in TKernel to pre-pack constant inputs, see OrtCustomOp::KernelPrePackWeight
+  template <typename K>
+  decltype(&K::PrePackWeight) SetPrePackWeightFn(decltype(&K::PrePackWeight)) {
+    OrtCustomOp::KernelPrePackWeight = [](void* op_kernel, const OrtValue* tensor, int input_index,
+                                          OrtAllocator* allocator, int* is_packed) -> OrtStatusPtr {
+      bool packed = false;
+      Status status = static_cast<K*>(op_kernel)->PrePackWeight(ConstValue{tensor}, input_index, allocator, packed);
+      *is_packed = packed ? 1 : 0;
+      return status.release();
+    };
+    return {};
+  }
+
+  template <typename K>
+  void SetPrePackWeightFn(...) {
+    OrtCustomOp::KernelPrePackWeight = nullptr;
+  }
+
  protected:
   // Helper function that returns a map of session config entries specified by CustomOpBase::GetSessionConfigKeys.
   void GetSessionConfigs(std::unordered_map<std::string, std::string>& out, ConstSessionOptions options) const;
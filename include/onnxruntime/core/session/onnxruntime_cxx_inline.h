@@ -346,6 +346,11 @@ inline void IoBindingImpl<T>::BindOutput(const char* name, const OrtMemoryInfo*
   ThrowOnError(GetApi().BindOutputToDevice(this->p_, name, mem_info));
 }
 
+template <typename T>
+inline void IoBindingImpl<T>::BindState(const char* input_name, const char* output_name, const Value& initial_value) {
+  ThrowOnError(GetApi().BindState(this->p_, input_name, output_name, initial_value));
+}
+
 template <typename T>
 inline void IoBindingImpl<T>::ClearBoundInputs() {
   GetApi().ClearBoundInputs(this->p_);
@@ -604,11 +609,32 @@ inline RunOptions& RunOptions::SetTerminate() {
   return *this;
 }
 
+inline RunCompletionQueue::RunCompletionQueue() {
+  ThrowOnError(GetApi().CreateRunCompletionQueue(&p_));
+}
+
+inline int RunCompletionQueue::GetFd() const {
+  int fd = -1;
+  ThrowOnError(GetApi().RunCompletionQueueGetFd(p_, &fd));
+  return fd;
+}
+
+inline size_t RunCompletionQueue::Dispatch(int timeout_ms) {
+  size_t num_dispatched = 0;
+  ThrowOnError(GetApi().RunCompletionQueueDispatch(p_, timeout_ms, &num_dispatched));
+  return num_dispatched;
+}
+
 inline RunOptions& RunOptions::UnsetTerminate() {
   ThrowOnError(GetApi().RunOptionsUnsetTerminate(p_));
   return *this;
 }
 
+inline RunOptions& RunOptions::SetCompletionQueue(RunCompletionQueue& queue) {
+  ThrowOnError(GetApi().RunOptionsSetCompletionQueue(p_, queue));
+  return *this;
+}
+
 namespace detail {
 
 template <typename T>
@@ -1011,6 +1037,34 @@ inline ModelMetadata ConstSessionImpl<T>::GetModelMetadata() const {
   return ModelMetadata{out};
 }
 
+template <typename T>
+inline int64_t ConstSessionImpl<T>::GetNodeLatencyPercentile(const char* node_name, double percentile) const {
+  int64_t out;
+  ThrowOnError(GetApi().SessionGetNodeLatencyPercentile(this->p_, node_name, percentile, &out));
+  return out;
+}
+
+template <typename T>
+inline int64_t ConstSessionImpl<T>::GetOpTypeLatencyPercentile(const char* op_type, double percentile) const {
+  int64_t out;
+  ThrowOnError(GetApi().SessionGetOpTypeLatencyPercentile(this->p_, op_type, percentile, &out));
+  return out;
+}
+
+template <typename T>
+inline AllocatedStringPtr ConstSessionImpl<T>::GetLatencyHistogramsPrometheusAllocated(OrtAllocator* allocator) const {
+  char* out = nullptr;
+  ThrowOnError(GetApi().SessionGetLatencyHistogramsPrometheus(this->p_, allocator, &out));
+  return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
+}
+
+template <typename T>
+inline OrtThreadPoolStats ConstSessionImpl<T>::GetIntraOpThreadPoolStats() const {
+  OrtThreadPoolStats stats{};
+  ThrowOnError(GetApi().SessionGetIntraOpThreadPoolStats(this->p_, &stats));
+  return stats;
+}
+
 template <typename T>
 inline TypeInfo ConstSessionImpl<T>::GetInputTypeInfo(size_t index) const {
   OrtTypeInfo* out;
@@ -1057,6 +1111,15 @@ inline void SessionImpl<T>::Run(const RunOptions& run_options, const IoBinding&
   ThrowOnError(GetApi().RunWithBinding(this->p_, run_options, io_binding));
 }
 
+template <typename T>
+inline void SessionImpl<T>::Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values,
+                                size_t input_count, Value* output_values, size_t output_count) {
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunPrepared(this->p_, run_options, prepared_run, ort_input_values, input_count,
+                                    ort_output_values, output_count));
+}
+
 template <typename T>
 inline void SessionImpl<T>::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
                                      const char* const* output_names, Value* output_values, size_t output_count, RunAsyncCallbackFn callback, void* user_data) {
@@ -1074,6 +1137,28 @@ inline AllocatedStringPtr SessionImpl<T>::EndProfilingAllocated(OrtAllocator* al
   return AllocatedStringPtr(out, detail::AllocatedFree(allocator));
 }
 
+template <typename T>
+inline void SessionImpl<T>::UpdateInitializers(const char* const* names, const Value* values, size_t count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  ThrowOnError(GetApi().SessionUpdateInitializers(this->p_, names, reinterpret_cast<const OrtValue* const*>(values),
+                                                  count));
+}
+
+template <typename T>
+inline void SessionImpl<T>::InsertCachedPrefix(const int64_t* tokens, size_t num_tokens,
+                                               const char* const* input_names, const Value* values, size_t count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  ThrowOnError(GetApi().SessionInsertCachedPrefix(this->p_, tokens, num_tokens, input_names,
+                                                  reinterpret_cast<const OrtValue* const*>(values), count));
+}
+
+template <typename T>
+inline size_t SessionImpl<T>::BindLongestCachedPrefix(IoBinding& binding, const int64_t* tokens, size_t num_tokens) {
+  size_t prefix_length = 0;
+  ThrowOnError(GetApi().SessionBindLongestCachedPrefix(this->p_, binding, tokens, num_tokens, &prefix_length));
+  return prefix_length;
+}
+
 }  // namespace detail
 
 inline SessionOptions::SessionOptions() {
@@ -1120,6 +1205,17 @@ inline Session::Session(const Env& env, const void* model_data, size_t model_dat
                                                                             prepacked_weights_container, &this->p_));
 }
 
+inline Session Session::Clone() const {
+  OrtSession* out;
+  ThrowOnError(GetApi().CloneSession(this->p_, &out));
+  return Session{out};
+}
+
+inline PreparedRun::PreparedRun(const Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ThrowOnError(GetApi().CreatePreparedRun(session, input_names, input_count, output_names, output_count, &this->p_));
+}
+
 inline AllocatedStringPtr ModelMetadata::GetProducerNameAllocated(OrtAllocator* allocator) const {
   char* out;
   ThrowOnError(GetApi().ModelMetadataGetProducerName(p_, allocator, &out));
@@ -1328,6 +1424,18 @@ inline Value ConstValueImpl<T>::GetValue(int index, OrtAllocator* allocator) con
   return Value{out};
 }
 
+template <typename T>
+inline void ConstValueImpl<T>::GetSequenceOfMapsAsColumns(OrtAllocator* allocator, Value& keys, Value& values,
+                                                          Value& offsets) const {
+  OrtValue* keys_out;
+  OrtValue* values_out;
+  OrtValue* offsets_out;
+  ThrowOnError(GetApi().GetSequenceOfMapsAsColumns(this->p_, allocator, &keys_out, &values_out, &offsets_out));
+  keys = Value{keys_out};
+  values = Value{values_out};
+  offsets = Value{offsets_out};
+}
+
 template <typename T>
 inline size_t ConstValueImpl<T>::GetStringTensorDataLength() const {
   size_t out;
@@ -1732,6 +1840,25 @@ inline void KernelContext::ParallelFor(void (*fn)(void*, size_t), size_t total,
   ThrowOnError(GetApi().KernelContext_ParallelFor(ctx_, fn, total, num_batch, usr_data));
 }
 
+inline void KernelContext::ParallelForRange(void (*fn)(void*, size_t, size_t), size_t total, double cost_per_unit,
+                                            void* usr_data) const {
+  ThrowOnError(GetApi().KernelContext_ParallelForRange(ctx_, fn, total, cost_per_unit, usr_data));
+}
+
+template <typename Fn>
+inline void KernelContext::ParallelForRange(size_t total, double cost_per_unit, Fn&& fn) const {
+  using FnType = std::remove_reference_t<Fn>;
+  ParallelForRange(
+      [](void* usr_data, size_t begin, size_t end) { (*static_cast<FnType*>(usr_data))(begin, end); },
+      total, cost_per_unit, const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+}
+
+inline int KernelContext::GetDegreeOfParallelism() const {
+  int out = 0;
+  ThrowOnError(GetApi().KernelContext_GetDegreeOfParallelism(ctx_, &out));
+  return out;
+}
+
 inline OpAttr::OpAttr(const char* name, const void* data, int len, OrtOpAttrType type) {
   Ort::ThrowOnError(GetApi().CreateOpAttr(name, data, len, type, &p_));
 }
@@ -867,6 +867,8 @@ struct OrtLiteCustomOp : public OrtCustomOp {
     OrtCustomOp::ReleaseMayInplace = {};
     OrtCustomOp::GetAliasMap = {};
     OrtCustomOp::ReleaseAliasMap = {};
+
+    OrtCustomOp::KernelPrePackWeight = {};
   }
 
   const std::string op_name_;
@@ -1043,6 +1045,9 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
     };
 
     SetShapeInfer<CustomOp>(0);
+    SetMayInplace<CustomOp>(0);
+    SetAliasMap<CustomOp>(0);
+    SetPrePackWeight<CustomOp>(0);
   }
 
   template <typename... Args>
@@ -1080,6 +1085,56 @@ struct OrtLiteCustomStruct : public OrtLiteCustomOp {
   void SetShapeInfer(...) {
     OrtCustomOp::InferOutputShapeFn = {};
   }
+
+  // "static std::vector<std::pair<int, int>> GetMayInplacePairs()" returns the (input index, output index) pairs
+  // of OrtCustomOp::GetMayInplace
+  template <typename C>
+  decltype(&C::GetMayInplacePairs) SetMayInplace(decltype(&C::GetMayInplacePairs)) {
+    OrtCustomOp::GetMayInplace = [](int** input_index, int** output_index) {
+      return Ort::detail::ExportIndexPairs(C::GetMayInplacePairs(), input_index, output_index);
+    };
+    OrtCustomOp::ReleaseMayInplace = [](int* input_index, int* output_index) {
+      Ort::detail::ReleaseIndexPairs(input_index, output_index);
+    };
+    return {};
+  }
+
+  template <typename C>
+  void SetMayInplace(...) {}
+
+  // "static std::vector<std::pair<int, int>> GetAliasPairs()" returns the (input index, output index) pairs
+  // of OrtCustomOp::GetAliasMap
+  template <typename C>
+  decltype(&C::GetAliasPairs) SetAliasMap(decltype(&C::GetAliasPairs)) {
+    OrtCustomOp::GetAliasMap = [](int** input_index, int** output_index) {
+      return Ort::detail::ExportIndexPairs(C::GetAliasPairs(), input_index, output_index);
+    };
+    OrtCustomOp::ReleaseAliasMap = [](int* input_index, int* output_index) {
+      Ort::detail::ReleaseIndexPairs(input_index, output_index);
+    };
+    return {};
+  }
+
+  template <typename C>
+  void SetAliasMap(...) {}
+
+  // "Status PrePackWeight(ConstValue tensor, int input_index, OrtAllocator* allocator, bool& is_packed)"
+  // pre-packs constant inputs, see OrtCustomOp::KernelPrePackWeight
+  template <typename C>
+  decltype(&C::PrePackWeight) SetPrePackWeight(decltype(&C::PrePackWeight)) {
+    OrtCustomOp::KernelPrePackWeight = [](void* op_kernel, const OrtValue* tensor, int input_index,
+                                          OrtAllocator* allocator, int* is_packed) -> OrtStatusPtr {
+      auto kernel = reinterpret_cast<Kernel*>(op_kernel);
+      bool packed = false;
+      Status status = kernel->custom_op_->PrePackWeight(ConstValue{tensor}, input_index, allocator, packed);
+      *is_packed = packed ? 1 : 0;
+      return status.release();
+    };
+    return {};
+  }
+
+  template <typename C>
+  void SetPrePackWeight(...) {}
 };  // struct OrtLiteCustomStruct
 
 /////////////////////////// CreateLiteCustomOp ////////////////////////////
@@ -26,6 +26,40 @@
 // By default, the value for this key is empty (i.e.) no memory arenas are shrunk
 static const char* const kOrtRunOptionsConfigEnableMemoryArenaShrinkage = "memory.enable_memory_arena_shrinkage";
 
+// Set to '1' to have the arenas listed in "memory.enable_memory_arena_shrinkage" only release the memory above their
+// working set, i.e. the high-water mark of memory in use over the arena's trim window (see "trim_window_ms" in
+// OrtApi::CreateArenaCfgV2), instead of every unused region. Keeps the next Run fast while still reclaiming memory.
+// Per default it will be set to '0'.
+static const char* const kOrtRunOptionsConfigMemoryArenaShrinkToWorkingSet = "memory.arena_shrink_to_working_set";
+
+// Set to '1' to fail a Run that allocates memory from the system through a memory arena of the session, i.e. that
+// extends an arena or reserves memory from it. Used to check that the runs of a model do not allocate once it is
+// warmed up, e.g. in tests. Only arena based allocators are checked, and allocations by concurrent runs of the same
+// session or of sessions sharing the arena also fail the run.
+// Per default it will be set to '0'.
+static const char* const kOrtRunOptionsConfigFailOnArenaAllocation = "memory.fail_on_arena_allocation";
+
+// Priority of the run among the concurrent runs using the same intra-op thread pool, an integer in [-4, 4] where
+// higher values are more urgent. While a run with a higher priority is in progress, the parallel loops of the runs
+// with a lower priority get no helper threads and their nodes wait before being executed, so that the pool's workers
+// serve the higher priority run first. Only the nodes executed by the calling thread of a run wait, e.g. not those
+// run on the inter-op threads in parallel execution mode.
+// Per default it will be set to '0'.
+static const char* const kOrtRunOptionsConfigRunPriority = "run.priority";
+
+// Limit in bytes of the memory a run allocates through the allocators of its execution frame, i.e. for the values of
+// the graph and the temporary buffers of the kernels. The allocation that would exceed the budget fails the run,
+// instead of exhausting a memory arena shared with concurrent runs. Kernels that support it, e.g. the CPU Attention
+// contrib op, run in chunks along the batch dimension to fit their temporary buffers in the budget left.
+// Allocations of subgraphs and copies of the feeds to other devices are not accounted.
+// Per default there is no budget.
+static const char* const kOrtRunOptionsConfigMemoryBudgetBytes = "memory.run_budget_bytes";
+
+// Set to '0' to fail a run over its memory budget (see "memory.run_budget_bytes") right away, without degrading
+// kernels that support it to chunked execution.
+// Per default it will be set to '1'.
+static const char* const kOrtRunOptionsConfigMemoryBudgetAllowChunking = "memory.run_budget_allow_chunking";
+
 // Set to '1' to not synchronize execution providers with CPU at the end of session run.
 // Per default it will be set to '0'
 // Taking CUDA EP as an example, it omit triggering cudaStreamSynchronize on the compute stream.
@@ -40,6 +74,11 @@ static const char* const kOrtRunOptionsConfigQnnPerfMode = "qnn.htp_perf_mode";
 // Set HTP performance mode for QNN HTP backend post session run.
 static const char* const kOrtRunOptionsConfigQnnPerfModePostRun = "qnn.htp_perf_mode_post_run";
 
+// Delay in milliseconds before the HTP performance mode post session run is set for QNN HTP backend.
+// The mode is set once no run voted a performance mode from the same thread for that long, so that interactive runs
+// in quick succession stay in e.g. burst mode and the vote is lowered once they stop. Default to "0", set right away.
+static const char* const kOrtRunOptionsConfigQnnPerfModePostRunIdleTimeout = "qnn.htp_perf_mode_post_run_idle_timeout_ms";
+
 // Set RPC control latency for QNN HTP backend
 static const char* const kOrtRunOptionsConfigQnnRpcControlLatency = "qnn.rpc_control_latency";
 
@@ -67,6 +67,86 @@ static const char* const kOrtSessionOptionsEnableQuantQDQCleanup = "session.enab
 // GeluApproximation has side effects which may change the inference results. It is disabled by default due to this.
 static const char* const kOrtSessionOptionsEnableGeluApproximation = "optimization.enable_gelu_approximation";
 
+// Enable or disable fusing chains of float elementwise operators (Add, Mul, Sigmoid, Erf, ...) into a single
+// FusedElementwise node on the CPU execution provider, which computes the chain block by block without writing the
+// intermediate values to memory. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableElementwiseChainFusion = "optimization.enable_elementwise_chain_fusion";
+
+// Enable or disable fusing chains of NCHWc convolutions into a single node on the CPU execution provider, which
+// computes large outputs in bands of rows so that the intermediate outputs stay in the cache. This only applies with
+// the NCHWc layout optimizations of ORT_ENABLE_ALL. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableNchwcConvChainFusion = "optimization.enable_nchwc_conv_chain_fusion";
+
+// Enable or disable removing the ZipMap nodes that produce graph outputs, so that these outputs are the
+// tensor(float) of class probabilities, with the columns in the order of the class labels, instead of a sequence of
+// maps with one map per row. This changes the output types of the model. "0": disable; "1": enable.
+// The default is "0".
+static const char* const kOrtSessionOptionsRemoveZipMap = "optimization.remove_zipmap";
+
+// Enable or disable fusing the attention subgraphs of decoder exports (e.g. Llama, Mistral and Phi), including their
+// rotary embedding, KV cache concatenation and repeated KV heads, into GroupQueryAttention in graph optimization.
+// "0": disable; "1": enable. The default is "0".
+// The fusion assumes the standard position ids and causal mask of right padded inputs, which may not hold for all models.
+static const char* const kOrtSessionOptionsEnableGroupQueryAttentionFusion =
+    "optimization.enable_group_query_attention_fusion";
+
+// Path of a JSON file with the per-channel maximum absolute values of layer normalization outputs, by output name,
+// e.g. {"/layers.0/input_layernorm/output_0": [0.8, 35.2, ...]}, as measured on calibration data.
+// When set, SmoothQuant-style smoothing migrates the activation outliers of those outputs to the weights of the
+// MatMul nodes consuming them in graph optimization: channel j is divided by
+// s_j = max|X_j|^alpha / max|W_j|^(1 - alpha) in the gamma and beta of the normalization and multiplied by s_j in the
+// weights, which keeps the results while making the activations easier to quantize to int8.
+// Default is "", i.e. no smoothing.
+static const char* const kOrtSessionOptionsActivationSmoothingScalesFile =
+    "optimization.activation_smoothing_scales_file";
+
+// The migration strength alpha of the activation smoothing, between 0 and 1. Defaults to "0.5".
+static const char* const kOrtSessionOptionsActivationSmoothingAlpha = "optimization.activation_smoothing_alpha";
+
+// Maximum size in bytes of the outputs of a node folded by constant folding, e.g. "1048576".
+// A node whose outputs are larger than this, and larger than its constant inputs, is not folded, so folding nodes
+// like Expand or Tile doesn't create large initializers. "0" means no limit. The default is "0".
+static const char* const kOrtSessionOptionsConstantFoldingMaxOutputSizeInBytes =
+    "optimization.constant_folding_max_output_size_in_bytes";
+
+// Enable or disable setting the node priorities so that the priority-based execution order has a lower estimated
+// peak of intermediate values than the default order. This requires the priority-based execution order and
+// the layout optimizations (ORT_ENABLE_ALL). "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnableMemoryAwareNodeOrdering =
+    "optimization.enable_memory_aware_node_ordering";
+
+// Memory budget in bytes for the intermediate values of the graph, e.g. "268435456". When set, chains of nodes like
+// MatMul -> Softmax -> MatMul or MatMul -> Gelu -> MatMul whose intermediate values are larger than this are chunked
+// along the rows of the first MatMul input, and large values which are cheap to recompute from small inputs, e.g.
+// expanded attention masks, are recomputed for each of their consumers. Only values with known shapes are changed.
+// This requires the layout optimizations (ORT_ENABLE_ALL). "0" means no budget. The default is "0".
+static const char* const kOrtSessionOptionsIntermediateMemoryBudgetInBytes =
+    "optimization.intermediate_memory_budget_in_bytes";
+
+// Shard the MLP blocks of an unsharded model for tensor-parallel inference over the given number of ranks, e.g. "4",
+// with the rank of this session given by kOrtSessionOptionsTensorParallelRank, e.g. "0" to "3". The weights of
+// MatMul -> activation -> MatMul blocks are split Megatron-style along the columns of the first MatMul and the rows of
+// the second one, and an AllReduce contrib op adds the partial sums of the ranks. This requires the NCCL collective
+// ops of the CUDA or ROCm EP, and an initialized MPI world of the same size. The default is "1", i.e. no sharding.
+static const char* const kOrtSessionOptionsTensorParallelWorldSize = "optimization.tensor_parallel_world_size";
+static const char* const kOrtSessionOptionsTensorParallelRank = "optimization.tensor_parallel_rank";
+
+// Enable or disable running the encoder layers of BERT-like models on the packed tokens of their sequences instead of
+// the padded batch. The padding is removed by RemovePadding before the first attention node, Attention and
+// MultiHeadAttention become PackedAttention and PackedMultiHeadAttention, and the padding of the output of the last
+// layer normalization is restored by RestorePadding, with zeros for the padding tokens. This requires the CUDA EP and
+// a 1-D mask index with the sequence lengths of right padded inputs. "0": disable; "1": enable. The default is "0".
+static const char* const kOrtSessionOptionsEnablePackingMode = "optimization.enable_packing_mode";
+
+// Specifies the ops the Triton fusion fuses for the session, as a JSON string, e.g.
+// {"ops": {"Add": {"versions": [13, 14]}, "ReduceSum": {"versions": [13], "conditions": {"axes": "single"}},
+//          "Softmax": {"versions": [13], "conditions": {"axis": "-1"}}}, "initializer": "scalar", "min_nodes": 2}
+// The fusion only applies in builds with Triton enabled once a Triton op executor is registered from Python, which
+// generates and compiles the Triton kernels of the fused subgraphs and caches the compiled kernels. It fuses the nodes
+// assigned to the CUDA EP, including in inference sessions. The default is the config of the registered executor.
+// Setting it fails the session creation in builds without Triton, or when no Triton op executor is registered.
+static const char* const kOrtSessionOptionsTritonFusionConfig = "optimization.triton_fusion_config";
+
 // This setting controls whether to enable AheadOfTime function inlining.
 // AOT function inlining examines the graph and attempts to inline as many locally defined functions in the model
 // as possible with the help of enabled execution providers.
@@ -88,13 +168,18 @@ static const char* const kOrtSessionOptionsDisableAheadOfTimeFunctionInlining =
 // Taking the example of "Gelu+Cast+:1:0",
 // > "Gelu+Cast+" is the subgraph string, a valid "subgraph string" should be one subgraph representation
 //    output by ORT graph transformations.
-// > "1" is "optimization strategy", valid values: 0 - disabled, 1 - recompute.
+// > "1" is "optimization strategy", valid values: 0 - disabled, 1 - recompute, 2 - recompute with compromise,
+//    3 - offload to host memory (a single node subgraph string, e.g. "Gelu+").
 // > "0" is "number of subgraph to apply" which is used to control how many subgraphs to apply optimization,
 //    to avoid "oversaving" the memory.
 static const char* const kOrtSessionOptionsMemoryOptimizerApplyConfig = "optimization.memory_optimizer_config";
 
 // Specifies the config for detecting subgraphs for memory footprint reduction.
-// The value should be a string contains int separated using commas. The default value is "0:0".
+// The value should be a string contains int separated using colons. The default value is "0:0".
+// > The first int is the probe level, 0 - basic, 1 - advanced.
+// > The second int is 1 to use transformer layers as boundaries of recompute subgraphs, 0 otherwise.
+// > The optional third int is 1 to also detect the activations produced on GPU that can be offloaded to host memory,
+//    0 otherwise, e.g. "1:0:1".
 static const char* const kOrtSessionOptionsMemoryOptimizerProbeConfig = "optimization.enable_memory_probe_recompute_config";
 #endif
 
@@ -107,6 +192,23 @@ static const char* const kOrtSessionOptionsMemoryOptimizerProbeConfig = "optimiz
 // Default is an empty string which means no optimizers are disabled.
 static const char* const kOrtSessionOptionsDisableSpecifiedOptimizers = "optimization.disable_specified_optimizers";
 
+// Enable or disable the incremental application of the rule-based graph transformers.
+// If no other transformer modified the graph since the previous pass of a rule-based transformer, its next pass
+// only visits the nodes changed by that pass and their neighbors, instead of the whole graph. This assumes that the
+// rewrite rules only depend on the neighborhood of the node they are triggered on.
+// "0": disable. The default.
+// "1": enable.
+static const char* const kOrtSessionOptionsIncrementalRuleBasedTransformers =
+    "optimization.incremental_rule_based_transformers";
+
+// Enable or disable incremental type and shape inference when the graph is resolved after its optimization.
+// If enabled, the type and shape inference only runs on the nodes of the main graph that were modified, or that
+// consume a value whose type, shape or initializer data changed, since the previous resolve.
+// "0": disable. The default.
+// "1": enable.
+static const char* const kOrtSessionOptionsIncrementalTypeAndShapeInference =
+    "optimization.incremental_type_and_shape_inference";
+
 // Enable or disable using device allocator for allocating initialized tensor memory. "1": enable; "0": disable. The default is "0".
 // Using device allocators means the memory allocation is made using malloc/new.
 static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "session.use_device_allocator_for_initializers";
@@ -114,9 +216,18 @@ static const char* const kOrtSessionOptionsUseDeviceAllocatorForInitializers = "
 // Configure whether to allow the inter_op/intra_op threads spinning a number of times before blocking
 // "0": thread will block if found no job to run
 // "1": default, thread will spin a number of times before blocking
+// In WebAssembly builds the default is "0" instead, so that the threads of a browser tab block in Atomics.wait.
 static const char* const kOrtSessionOptionsConfigAllowInterOpSpinning = "session.inter_op.allow_spinning";
 static const char* const kOrtSessionOptionsConfigAllowIntraOpSpinning = "session.intra_op.allow_spinning";
 
+// Configure whether the spinning of the intra_op threads adapts to the recent gaps between parallel sections,
+// when spinning is allowed. Each thread spins up to twice its average wait for work, at most 1 ms, and blocks right
+// away while its average wait is longer, so that a pool stops burning CPU between requests of a low-QPS service
+// without session.force_spinning_stop, and keeps spinning through the short gaps of a busy one.
+// "0": default, threads spin a fixed number of times before blocking
+// "1": adaptive spinning
+static const char* const kOrtSessionOptionsConfigIntraOpAdaptiveSpinning = "session.intra_op.adaptive_spinning";
+
 // Key for using model bytes directly for ORT format
 // If a session is created using an input byte array contains the ORT format model data,
 // By default we will copy the model bytes at the time of session creation to ensure the model bytes
@@ -135,6 +246,27 @@ static const char* const kOrtSessionOptionsConfigUseORTModelBytesDirectly = "ses
 static const char* const kOrtSessionOptionsConfigUseORTModelBytesForInitializers =
     "session.use_ort_model_bytes_for_initializers";
 
+/// <summary>
+/// Key for saving the large initializers of the main graph of an ORT format model in an aligned data section after
+/// the flatbuffer, so that they are aligned for SIMD kernels and can be used without a copy when the model is
+/// memory mapped (see `session.map_ort_model_file`). Such models need ORT format version 7 support to load.
+/// Option values:
+/// - "0": initializers are stored in the flatbuffer. [DEFAULT]
+/// - "1": initializers of 64 bytes or more are stored in the data section.
+/// </summary>
+static const char* const kOrtSessionOptionsConfigSaveOrtModelAlignedInitializers =
+    "session.save_ort_model_aligned_initializers";
+
+/// <summary>
+/// Key for memory mapping an ORT format model file instead of reading it into memory.
+/// The initializers then use the mapped memory directly, which stays mapped for the duration of the session.
+/// The file must not be modified while the session exists.
+/// Option values:
+/// - "0": the model file is read into memory. [DEFAULT]
+/// - "1": the model file is memory mapped.
+/// </summary>
+static const char* const kOrtSessionOptionsConfigMapOrtModelFile = "session.map_ort_model_file";
+
 // This should only be specified when exporting an ORT format model for use on a different platform.
 // If the ORT format model will be used on ARM platforms set to "1". For other platforms set to "0"
 // Available since version 1.11.
@@ -166,6 +298,12 @@ static const char* const kOrtSessionOptionsConfigMinimalBuildOptimizations =
 // exclusion, set the value to "".
 static const char* const kOrtSessionOptionsConfigNnapiEpPartitioningStopOps = "ep.nnapi.partitioning_stop_ops";
 
+// Specifies a directory NNAPI caches compiled models in, so that later sessions creating the same NNAPI model skip
+// the compilation. The cache entries are keyed by a hash of the NNAPI model and the compilation settings.
+// The directory must exist and be writable by the application. This is only available on Android API level 29+.
+// If not specified, compiled models are not cached.
+static const char* const kOrtSessionOptionsConfigNnapiEpCompilationCacheDir = "ep.nnapi.compilation_cache_dir";
+
 // Enabling dynamic block-sizing for multithreading.
 // With a positive value, thread pool will split a task of N iterations to blocks of size starting from:
 // N / (num_of_threads * dynamic_block_base)
@@ -183,6 +321,167 @@ static const char* const kOrtSessionOptionsConfigDynamicBlockBase = "session.dyn
 // Applies only to internal thread-pools
 static const char* const kOrtSessionOptionsConfigForceSpinningStop = "session.force_spinning_stop";
 
+// These options enable dynamic batching of concurrent Run() calls.
+// When session.dynamic_batching_window_us is positive, a Run() call waits up to this many microseconds for other
+// concurrent Run() calls with the same inputs and outputs, and with input shapes that only differ in the first
+// (batch) dimension. The inputs of these calls are concatenated along the batch dimension, the model is run once
+// and the outputs are split back along the batch dimension.
+// session.dynamic_batching_max_batch_size, if positive, limits the total batch dimension of a batched run.
+// Only calls with CPU tensor inputs and without pre-allocated outputs are batched, and all the outputs of the model
+// must have the batch dimension as their first dimension, otherwise the calls are run one by one.
+// The run options of the first call of a batch apply to the batched run; calls are only batched with calls that
+// have the same run tag.
+// Default is "0", dynamic batching is disabled.
+static const char* const kOrtSessionOptionsConfigDynamicBatchingWindowUs = "session.dynamic_batching_window_us";
+static const char* const kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize = "session.dynamic_batching_max_batch_size";
+
+// These options control the cache of memory patterns that is used when memory pattern optimization is enabled.
+// session.memory_pattern_shape_buckets is a list of ascending dim boundaries separated by commas, e.g. "64,128,256,512".
+// Input dims are rounded up to the next boundary to look up memory patterns, so inputs whose shapes only differ, e.g.,
+// by a sequence length within the same bucket share a memory pattern, which is planned for the largest inputs of
+// the bucket seen so far. Dims beyond the last boundary are not rounded.
+// session.memory_pattern_cache_max_entries, if positive, limits the number of cached memory patterns, evicting
+// the least recently used ones.
+// Default is unset, memory patterns are looked up by exact input shapes and the cache is not limited.
+static const char* const kOrtSessionOptionsConfigMemoryPatternShapeBuckets = "session.memory_pattern_shape_buckets";
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheMaxEntries = "session.memory_pattern_cache_max_entries";
+
+// Create the kernels of the CPU execution provider concurrently when the session is initialized, using the inter op
+// thread pool if there is one and the intra op thread pool otherwise. This shortens the initialization of large
+// models, e.g. with many MatMul weights that are transposed or quantized when their kernels are created.
+// Kernels of other execution providers are still created one by one.
+// "0": disable. (default)
+// "1": enable.
+static const char* const kOrtSessionOptionsConfigParallelKernelCreation = "session.parallel_kernel_creation";
+
+// Specifies a directory to cache optimized models in.
+// When a session loads an ONNX model from a file or from bytes, it looks up an ORT format model in the directory,
+// keyed by a hash of the model bytes, the ORT version, the session options, the execution providers and their
+// options, and the instruction sets of the CPU. If it is found, the session loads the ORT format model, skipping
+// the graph optimizations. Otherwise the session optimizes the model and saves it to the directory.
+// Note:
+// 1. The optimized model is not cached if it contains nodes compiled by an execution provider;
+// 2. As for any ORT format model, models with more than 2GB of initializers can not be cached;
+// 3. External data of the model is not part of the key, the cache directory must be cleared if it changes.
+// Default is unset, optimized models are not cached.
+static const char* const kOrtSessionOptionsConfigOptimizedModelCacheDir = "session.optimized_model_cache_dir";
+
+// Specifies a file to save the pre-packed weights of the CPU kernels to, for example next to an ORT format model.
+// If the file exists and was written by the same ORT version on a CPU with the same instruction sets and with the
+// same session configuration, the kernels use the pre-packed weights memory-mapped from it instead of calling
+// OpKernel::PrePack() again. Otherwise the weights are pre-packed as usual and the file is (re)written.
+// Note:
+// 1. Only kernels overriding OpKernel::UseSerializedPrePackedBuffers() can use the weights from the file, and only
+//    the weights of the main graph are saved;
+// 2. Weights which are shared by sessions through a PrepackedWeightsContainer are not saved.
+// Default is unset, pre-packed weights are not saved.
+static const char* const kOrtSessionOptionsConfigPrepackedWeightsFilePath = "session.prepacked_weights_file_path";
+
+// Specifies the maximum total size in bytes of the tensors held by the prefix key/value cache of the session.
+// Applications cache the present key/value tensors fetched for a token prefix, e.g. a system prompt shared by many
+// requests, with OrtApi::SessionInsertCachedPrefix, and bind them as the past key/value inputs of later runs with
+// OrtApi::SessionBindLongestCachedPrefix, without copying them and without recomputing the prefix. The least
+// recently used prefixes are evicted once the size is exceeded.
+// Note: the cached tensors are bound as is, so they can not be used as the past of a model which updates its past
+// key/value in place (past_present_share_buffer).
+// The value must be a non-negative integer, otherwise the session fails to initialize.
+// Default is "0", the prefix key/value cache is disabled.
+static const char* const kOrtSessionOptionsConfigPrefixKVCacheMaxBytes = "session.prefix_kv_cache_max_bytes";
+
+// "1": keep per-node latency histograms of the kernels run by the session, a low-overhead alternative to profiling
+// which can stay enabled in production. The histograms are read through the SessionGetNodeLatencyPercentile,
+// SessionGetOpTypeLatencyPercentile and SessionGetLatencyHistogramsPrometheus C APIs.
+// Only the nodes of the main graph are tracked, nodes inside subgraphs count towards their control flow node.
+// The histograms take up to 4.5KB per node, allocated when the nodes first run.
+// "0": latency histograms are disabled. The default.
+static const char* const kOrtSessionOptionsConfigEnableLatencyHistograms = "session.enable_latency_histograms";
+
+// "1": when profiling is enabled, also count the CPU cycles, instructions, cache references and cache misses of each
+// node with the Linux perf_event PMU counters, to tell the compute bound kernels from the memory bound ones. Each node
+// run adds a "<node>_hardware_counters" event to the profile, and the profile ends with a "<op type>_hardware_counters"
+// session event of the totals of each op type.
+// The counters count the user space work of all the threads of the process, including the ones of concurrent runs.
+// Only the nodes of the main graph are tracked, nodes inside subgraphs count towards their control flow node.
+// A warning is logged and the counters are not recorded if they are not available, e.g. on other platforms than
+// Linux or when /proc/sys/kernel/perf_event_paranoid is above 2.
+// "0": hardware counters are not recorded. The default.
+static const char* const kOrtSessionOptionsConfigProfileHardwareCounters = "session.profile_hardware_counters";
+
+// "1": collect the min, max and histogram of the float CPU tensors produced by the nodes of the main graph while the
+// session runs, to calibrate static quantization without rewriting the model to output every activation.
+// The statistics are read through InferenceSession::GetActivationStatistics.
+// "0": activation statistics are not collected. The default.
+static const char* const kOrtSessionOptionsConfigCollectActivationStatistics = "session.collect_activation_statistics";
+
+// Number of bins of the histograms of the activation statistics. Must be even. Defaults to "2048".
+static const char* const kOrtSessionOptionsConfigActivationStatisticsNumBins =
+    "session.activation_statistics_num_bins";
+
+// "1": constant initializers with external data are only registered when the session is created. Each graph loads
+// and pre-packs its external initializers the first time it runs, which keeps the load time and memory of models
+// with rarely executed subgraphs (e.g. the branches of an If node or the body of a Loop) low.
+// Kernels see these initializers as non-constant inputs when they are created. The kernels of the CPU EP share the
+// weights they pre-pack through the pre-packed weights container of the session if it has one.
+// "0": all initializers are loaded when the session is created. The default.
+static const char* const kOrtSessionOptionsConfigLazyExternalInitializers = "session.lazy_external_initializers";
+
+// "1": when the session is initialized, ask the OS to start reading the external data files of the initializers into
+// the page cache, so that the reads overlap with the graph optimization, partitioning and kernel creation.
+// This helps when the model's external data is on slow or network storage.
+// Not used if kOrtSessionOptionsConfigLazyExternalInitializers is enabled.
+// "0": external data is read when the initializers are loaded. The default.
+static const char* const kOrtSessionOptionsConfigPrefetchExternalInitializers =
+    "session.prefetch_external_initializers";
+
+// "1": sessions loading an ONNX model from a file share the parsed model through a process-wide cache of the
+// environment, keyed by the path, size and modification time of the file. The model is parsed once and the data of
+// its initializers is kept in memory once, referenced in place by the graphs and the CPU kernels of all the sessions
+// holding the model, so N sessions of a model (e.g. with different thread settings or EPs) cost one set of weights.
+// The shared data is read-only, an initializer a graph transformer rewrites becomes a new tensor of its session.
+// Note:
+// 1. Only the initializers of the main graph stored in the model file are shared, not external data or the
+//    initializers of subgraphs, and the graph optimizations still run in each session;
+// 2. Not used if SessionOptions::optimized_model_filepath is set.
+// "0": each session parses its model. The default.
+static const char* const kOrtSessionOptionsConfigUseEnvModelCache = "session.use_env_model_cache";
+
+// Element type of the optimizer moments that the training API creates for the parameters on the CPU: "float",
+// "float16" or "bfloat16". 16-bit moments halve the memory of the AdamW optimizer state, the CPU AdamWOptimizer kernel
+// still computes the update in float. Moments loaded from a checkpoint keep their type.
+// Default is "float".
+static const char* const kOrtSessionOptionsConfigOptimizerStateType = "training.optimizer_state_type";
+
+// Allocate all the trainable parameters of the training API module in one contiguous buffer, and their gradients in
+// another, so that all-reduce, checkpointing and optimizer steps can work on one buffer instead of one per parameter.
+// CopyParametersToBuffer then hands out the buffer without copying. All the trainable parameters must be of the same
+// type on the same device.
+// "0": disabled, "1": enabled. Default is "0".
+static const char* const kOrtSessionOptionsConfigUseContiguousParameterBuffer = "training.use_contiguous_parameter_buffer";
+
+// "1": when the execution provider captures graphs (e.g. enable_cuda_graph of the CUDA EP), a Run() that does not set
+// the gpu_graph_id run option gets a graph annotation id assigned from the names and shapes of its inputs, so a
+// graph is captured the first time each distinct set of input shapes is run and replayed afterwards.
+// As with explicit annotation ids, a replay reads and writes the buffers used when capturing, so the inputs and
+// outputs of each set of shapes must be bound to the same buffers (e.g. with IOBinding) in every run.
+// The ids from 2^30 are assigned to the input shapes, so a run setting gpu_graph_id to one of them fails.
+// "0": the graph annotation id is taken from the gpu_graph_id run option only. The default.
+static const char* const kOrtSessionOptionsConfigGraphCapturePerInputShapes = "session.graph_capture_per_input_shapes";
+
+// The maximum number of graphs captured for distinct input shapes when kOrtSessionOptionsConfigGraphCapturePerInputShapes
+// is enabled. When a new set of input shapes is run, the graph of the least recently run shapes is released.
+// "0" means no limit. The default is "8".
+static const char* const kOrtSessionOptionsConfigGraphCaptureMaxGraphs = "session.graph_capture_max_graphs";
+
+// "1": record the kernel invocations of a run and replay them in the following runs with the same input and output
+// names and input shapes, without going through the executor and creating an execution frame for each run. This
+// removes most of the framework overhead per run, which dominates the latency of small models.
+// All the values of the recorded run stay allocated. The inputs are copied into the recording and the outputs are
+// copied out of it. A run with other input shapes records again. Replayed runs are not profiled.
+// Only used if all the nodes run on the CPU EP and produce tensors, and for runs with CPU tensors as inputs and
+// outputs. Concurrent runs go through the executor when another run is using the recording.
+// "0": every run goes through the executor. The default.
+static const char* const kOrtSessionOptionsConfigRecordExecution = "session.record_execution";
+
 // "1": all inconsistencies encountered during shape and type inference
 // will result in failures.
 // "0": in some cases warnings will be logged but processing will continue. The default.
@@ -197,6 +496,38 @@ static const char* const kOrtSessionOptionsConfigStrictAllowReleasedOpsetsOnly =
 // The file saves configuration for partitioning node among logic streams
 static const char* const kNodePartitionConfigFile = "session.node_partition_config_file";
 
+// Maximum number of logic streams, each with its own device stream, the GPU nodes may be spread over, e.g. "4".
+// Independent branches of the graph, such as MoE experts or the towers of a multi-tower model, are then placed on
+// different streams so that their kernels run concurrently. Streams synchronize through events between dependent nodes.
+// Default is "1", i.e. one stream per device. Ignored when kNodePartitionConfigFile is set.
+static const char* const kOrtSessionOptionsMaxGpuStreams = "session.max_gpu_streams";
+
+// Profiles written by the session profiler, separated by ';', e.g. "model_cuda_profile.json;model_cpu_profile.json".
+// When set, the greedy assignment of the graph partitioning is refined with the kernel times they contain: a node
+// assigned to a device is moved to the CPU EP if its CPU kernel, with the copies of its tensors between the CPU and
+// the device, is estimated to be faster. This mostly applies to small shape computations between CPU nodes.
+// The CPU and device nodes run concurrently when the session uses several streams, see kOrtSessionOptionsMaxGpuStreams.
+// Default is "", i.e. the assignment is not refined.
+static const char* const kOrtSessionOptionsPartitionCostProfiles = "session.partition_cost_profiles";
+
+// Number of profiling events the session profiler buffers before it appends them to the profile file, e.g. "10000".
+// The file is written as the events come in instead of all at once by EndProfiling, which bounds the memory of long
+// profiled runs, the events already written no longer counting toward the maximum number of events. The file is
+// the same chrome trace as when all the events are buffered, and can be opened in Perfetto or chrome://tracing.
+// The events stay buffered when an execution provider profiler is active, its device events being merged with the
+// buffered host events at the end.
+// Default is "0", i.e. the events are buffered until EndProfiling.
+static const char* const kOrtSessionOptionsProfilingFlushIntervalEvents = "session.profiling_flush_interval_events";
+
+// Number of encoder results the BeamSearch and WhisperBeamSearch ops of T5 and Whisper models keep, e.g. "4".
+// A run with the same encoder inputs as a kept one, e.g. decoding the same audio again at another temperature or
+// with other decoding parameters, reuses the kept encoder outputs and cross attention keys and values instead of
+// running the encoder subgraph again. The least recently used result is evicted when the cache is full. Only encoder
+// inputs in CPU memory are cached, i.e. the cache applies to the CPU EP.
+// Default is "0", i.e. the encoder runs for every request.
+static const char* const kOrtSessionOptionsGenerationEncoderOutputCacheEntries =
+    "session.generation_encoder_output_cache_entries";
+
 // This Option allows setting affinities for intra op threads.
 // Affinity string follows format:
 // logical_processor_id,logical_processor_id;logical_processor_id,logical_processor_id
@@ -214,6 +545,29 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// This Option confines a session to a single NUMA node, identified by its id starting from 0.
+// When set, the intra op threads are pinned to the logical processors of the node, one thread per physical core
+// unless intra_op_num_threads is set, and the CPU execution provider's arena prefers memory from the node.
+// Note:
+// 1. Can not be combined with session.intra_op_thread_affinities;
+// 2. As with thread affinities, ort does not set affinity on the main thread, which is managed by the calling app;
+// 3. Only applies to per-session thread pools and allocators, i.e. it has no effect on global thread pools or
+//    allocators shared through the environment.
+// Default is "-1", the session is not confined to a NUMA node.
+static const char* const kOrtSessionOptionsConfigIntraOpNumaNode = "session.intra_op_numa_node";
+
+// These Options control how a session shares the global intra op thread pool of the environment with other sessions.
+// They only apply when the session uses the global thread pools (i.e. per session threads are disabled).
+// session.intra_op_shared_pool_weight is the relative share of the global threads the session gets while other sessions
+// run loops concurrently, e.g. a session with weight "2" gets twice the threads of a session with weight "1".
+// session.intra_op_shared_pool_max_threads, if positive, caps the number of threads used by each loop of the session,
+// including the thread calling Run().
+// Setting either option also enables per-session counters of the delay between a loop starting and the global
+// threads joining it, which are logged when the session is destroyed.
+// Default is unset, the session uses the global intra op thread pool directly.
+static const char* const kOrtSessionOptionsConfigIntraOpSharedPoolWeight = "session.intra_op_shared_pool_weight";
+static const char* const kOrtSessionOptionsConfigIntraOpSharedPoolMaxThreads = "session.intra_op_shared_pool_max_threads";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
@@ -250,6 +604,14 @@ static const char* const kOrtSessionOptionsOptimizedModelExternalInitializersFil
 static const char* const kOrtSessionOptionsOptimizedModelExternalInitializersMinSizeInBytes =
     "session.optimized_model_external_initializers_min_size_in_bytes";
 
+// Use this config to compress the initializers saved in the external initializers file. The data is split into
+// blocks that are decompressed in parallel using the intra-op thread pool when the model is loaded.
+// Option values:
+// - "0": initializers are saved uncompressed. [DEFAULT]
+// - "1": initializers are compressed with LZ4, with the bytes of floating point elements shuffled first.
+static const char* const kOrtSessionOptionsOptimizedModelExternalInitializersCompress =
+    "session.optimized_model_external_initializers_compress";
+
 // Enable EP context feature to dump the partitioned graph which includes the EP context into Onnx file.
 // The dumped Onnx model with EP context can be used for future inference to avoid the EP graph partitioning/compile overhead.
 // "0": disable. (default)
@@ -269,12 +631,70 @@ static const char* const kOrtSessionOptionEpContextEmbedMode = "ep.context_embed
 // in case user need to merge/connect multiple EPContext nodes in one model
 static const char* const kOrtSessionOptionEpContextNodeNamePrefix = "ep.context_node_name_prefix";
 
+// Share the EP contexts across the sessions of the process, e.g. the prefill and decode models of an LLM.
+// "0": each session creates its own EP contexts. (default)
+// "1": the sessions share their EP contexts, so the weights held by a context are loaded once. A session created
+//      from an EP context model reuses the graphs another session already loaded from the same context binary.
+//      The sessions sharing their contexts should use the same EP options.
+static const char* const kOrtSessionOptionShareEpContexts = "ep.share_ep_contexts";
+
 // Gemm fastmath mode provides fp32 gemm acceleration with bfloat16 based matmul.
 // Option values:
 // - "0": Gemm FastMath mode is not enabled. [DEFAULT]
 // - "1": Gemm FastMath mode is enabled.
 static const char* const kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 = "mlas.enable_gemm_fastmath_arm64_bfloat16";
 
+// Conv on CPU may run 3x3 stride 1 convolutions with the F(2x2, 3x3) Winograd algorithm, which uses fewer
+// multiplications than im2col + GEMM. The results are not bitwise identical to the default algorithms.
+// Option values:
+// - "0": Winograd convolutions are not enabled. [DEFAULT]
+// - "1": Winograd convolutions are enabled for layers with at least 16 input channels and filters.
+static const char* const kOrtSessionOptionsMlasConvWinograd = "mlas.enable_conv_winograd";
+
+// MatMul on CPU keeps a constant B with at least this fraction of zeros in CSR format when prepacking it, and
+// multiplies with the nonzeros only instead of running the dense GEMM. Pruned weights usually need a sparsity of
+// 0.7 or more for the sparse kernel to be faster.
+// Option values:
+// - "0": B is always packed for the dense GEMM. [DEFAULT]
+// - A fraction in (0, 1], e.g. "0.8".
+static const char* const kOrtSessionOptionsMlasMatMulSparseWeightThreshold = "mlas.matmul_sparse_weight_threshold";
+
+// DynamicQuantizeMatMul on CPU quantizes its float input A per tensor by default, with one scale for all the values.
+// Activations with outlier channels, as in transformers, lose much accuracy that way. When enabled, each row of A
+// (each token of a [batch, sequence, hidden] activation) is quantized symmetrically with its own scale, and the row
+// scales are applied with the scales of B when the QGEMM output is converted to float.
+// Option values:
+// - "0": A is quantized per tensor. [DEFAULT]
+// - "1": A is quantized per row.
+static const char* const kOrtSessionOptionsDynamicQuantizeMatMulPerRow = "mlas.dynamic_quantize_matmul_per_row";
+
+// TunableOp of the default CPU execution provider. When enabled, CPU kernels with several MLAS configurations
+// (e.g. Conv with or without the Winograd algorithm) use the fastest one recorded in the tuning results of the
+// session for the op, shapes and intra-op thread count. When tuning is also enabled, the configurations missing from
+// the tuning results are benchmarked on their first run and the fastest is recorded. The tuning results are
+// retrieved and loaded with the same TuningResults used by the GPU execution providers, and are validated against
+// the instruction set of the CPU. Tuned kernels may not be bitwise identical to the default ones.
+// Option values:
+// - "0": disabled. [DEFAULT]
+// - "1": enabled.
+static const char* const kOrtSessionOptionsCpuTunableOpEnable = "session.cpu_tunable_op_enable";
+static const char* const kOrtSessionOptionsCpuTunableOpTuningEnable = "session.cpu_tunable_op_tuning_enable";
+
+// Maximum duration in milliseconds spent benchmarking each configuration of a CPU TunableOp. Unlimited if not
+// positive. Defaults to "0".
+static const char* const kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs =
+    "session.cpu_tunable_op_max_tuning_duration_ms";
+
+// Path of a json file holding TuningResults, in the format embedded in the model metadata, kept next to the model.
+// The results in the file are loaded when the session is initialized, and TunableOp is enabled for the execution
+// providers whose results pass the validation (e.g. same device model and driver versions). When a session with
+// tuning enabled is destroyed, its results are written back to the file. The results of other execution providers
+// or devices already in the file are kept, so one file serves every deployment target: each one tunes once and the
+// later sessions start with the best kernels.
+// The file is replaced atomically, so it is never truncated. The sessions of a process merge their results in turn,
+// while processes writing to the same file at the same time may lose each other's results: the last writer wins.
+static const char* const kOrtSessionOptionsTuningResultsFilePath = "session.tuning_results_file_path";
+
 // When converting DQ + MatMul -> MatMulNBits, the accuracy level of the MatMulNBits is controlled by this option.
 // Refer to MatMulNBits op schema for more details.
 // If not provided, default is 4.
@@ -113,6 +113,33 @@ JNIEXPORT jlong JNICALL Java_ai_onnxruntime_OnnxTensor_createTensorFromBuffer
     return (jlong) ortValue;
 }
 
+/*
+ * Class:     ai_onnxruntime_OnnxTensor
+ * Method:    createEmptyTensor
+ * Signature: (JJ[JI)J
+ *
+ * Creates a tensor in memory of the allocator without copying anything into it. The Java side writes the data through
+ * the direct ByteBuffer getBuffer returns, so the same tensor can be refilled and fed to every run, or bound as a
+ * preallocated output.
+ */
+JNIEXPORT jlong JNICALL Java_ai_onnxruntime_OnnxTensor_createEmptyTensor
+        (JNIEnv * jniEnv, jclass jobj, jlong apiHandle, jlong allocatorHandle, jlongArray shape, jint onnxTypeJava) {
+    (void) jobj;  // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    OrtAllocator* allocator = (OrtAllocator*) allocatorHandle;
+    ONNXTensorElementDataType onnxType = convertToONNXDataFormat(onnxTypeJava);
+
+    jlong* shapeArr = (*jniEnv)->GetLongArrayElements(jniEnv, shape, NULL);
+    jsize shapeLen = (*jniEnv)->GetArrayLength(jniEnv, shape);
+
+    OrtValue* ortValue = NULL;
+    checkOrtStatus(jniEnv, api, api->CreateTensorAsOrtValue(allocator, (int64_t*)shapeArr, shapeLen, onnxType,
+                                                            &ortValue));
+    (*jniEnv)->ReleaseLongArrayElements(jniEnv, shape, shapeArr, JNI_ABORT);
+
+    return (jlong) ortValue;
+}
+
 /*
  * Class:     ai_onnxruntime_OnnxTensor
  * Method:    createString
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) Microsoft Corporation. All rights reserved.
+ * Licensed under the MIT License.
+ */
+#include <jni.h>
+#include "onnxruntime/core/session/onnxruntime_c_api.h"
+#include "OrtJniUtil.h"
+#include "ai_onnxruntime_OrtSession_IoBinding.h"
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    createIoBinding
+ * Signature: (JJ)J
+ */
+JNIEXPORT jlong JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_createIoBinding
+  (JNIEnv * jniEnv, jclass jclazz, jlong apiHandle, jlong sessionHandle) {
+    (void) jclazz; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    OrtIoBinding* binding = NULL;
+    checkOrtStatus(jniEnv, api, api->CreateIoBinding((OrtSession*) sessionHandle, &binding));
+    return (jlong) binding;
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    bindInput
+ * Signature: (JJLjava/lang/String;J)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_bindInput
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle, jstring name, jlong valueHandle) {
+    (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    const char* nameStr = (*jniEnv)->GetStringUTFChars(jniEnv, name, NULL);
+    checkOrtStatus(jniEnv, api, api->BindInput((OrtIoBinding*) nativeHandle, nameStr, (const OrtValue*) valueHandle));
+    (*jniEnv)->ReleaseStringUTFChars(jniEnv, name, nameStr);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    bindOutput
+ * Signature: (JJLjava/lang/String;J)V
+ *
+ * Binds an output to a preallocated value, e.g. an OnnxTensor created by createEmptyTensor, which every run
+ * writes into instead of allocating a new output.
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_bindOutput
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle, jstring name, jlong valueHandle) {
+    (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    const char* nameStr = (*jniEnv)->GetStringUTFChars(jniEnv, name, NULL);
+    checkOrtStatus(jniEnv, api, api->BindOutput((OrtIoBinding*) nativeHandle, nameStr, (const OrtValue*) valueHandle));
+    (*jniEnv)->ReleaseStringUTFChars(jniEnv, name, nameStr);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    bindOutputToAllocator
+ * Signature: (JJLjava/lang/String;J)V
+ *
+ * Binds an output whose shape is not known ahead of the run to the device of the allocator, which allocates it.
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_bindOutputToAllocator
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle, jstring name, jlong allocatorHandle) {
+    (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    const OrtMemoryInfo* memoryInfo;
+    OrtErrorCode code = checkOrtStatus(jniEnv, api, api->AllocatorGetInfo((OrtAllocator*) allocatorHandle, &memoryInfo));
+    if (code != ORT_OK) {
+      return;
+    }
+    const char* nameStr = (*jniEnv)->GetStringUTFChars(jniEnv, name, NULL);
+    checkOrtStatus(jniEnv, api, api->BindOutputToDevice((OrtIoBinding*) nativeHandle, nameStr, memoryInfo));
+    (*jniEnv)->ReleaseStringUTFChars(jniEnv, name, nameStr);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    run
+ * Signature: (JJJJ)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_run
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong sessionHandle, jlong nativeHandle, jlong runOptionsHandle) {
+    (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    checkOrtStatus(jniEnv, api, api->RunWithBinding((OrtSession*) sessionHandle, (OrtRunOptions*) runOptionsHandle,
+                                                    (const OrtIoBinding*) nativeHandle));
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    getOutputValues
+ * Signature: (JJJ[Z)[Lai/onnxruntime/OnnxValue;
+ *
+ * Returns the outputs of the last run in the order they were bound. The outputs flagged in preallocated were bound to
+ * values the Java side already holds, their slots are left null so that no new object is created for them.
+ */
+JNIEXPORT jobjectArray JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_getOutputValues
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle, jlong allocatorHandle,
+   jbooleanArray preallocatedArr) {
+    (void) jobj; // Required JNI parameter not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    OrtAllocator* allocator = (OrtAllocator*) allocatorHandle;
+
+    OrtValue** outputValues = NULL;
+    size_t numOutputs = 0;
+    OrtErrorCode code = checkOrtStatus(jniEnv, api, api->GetBoundOutputValues((const OrtIoBinding*) nativeHandle,
+                                                                              allocator, &outputValues, &numOutputs));
+    if (code != ORT_OK) {
+      return NULL;
+    }
+
+    jclass onnxValueClazz = (*jniEnv)->FindClass(jniEnv, "ai/onnxruntime/OnnxValue");
+    jobjectArray outputArray = (*jniEnv)->NewObjectArray(jniEnv, safecast_size_t_to_jsize(numOutputs),
+                                                         onnxValueClazz, NULL);
+    jsize numPreallocated = (*jniEnv)->GetArrayLength(jniEnv, preallocatedArr);
+    jboolean* preallocated = (*jniEnv)->GetBooleanArrayElements(jniEnv, preallocatedArr, NULL);
+
+    size_t i = 0;
+    for (; i < numOutputs; i++) {
+      if (i < (size_t) numPreallocated && preallocated[i]) {
+        // The Java side owns the value, this is another reference to it.
+        api->ReleaseValue(outputValues[i]);
+      } else {
+        jobject onnxValue = convertOrtValueToONNXValue(jniEnv, api, allocator, outputValues[i]);
+        if (onnxValue == NULL) {
+          break;  // exception thrown
+        }
+        (*jniEnv)->SetObjectArrayElement(jniEnv, outputArray, safecast_size_t_to_jsize(i), onnxValue);
+      }
+    }
+    if (i < numOutputs) {
+      // Release the values from the one whose conversion failed onwards, the converted ones belong to Java.
+      for (; i < numOutputs; i++) {
+        api->ReleaseValue(outputValues[i]);
+      }
+      outputArray = NULL;
+    }
+
+    (*jniEnv)->ReleaseBooleanArrayElements(jniEnv, preallocatedArr, preallocated, JNI_ABORT);
+    checkOrtStatus(jniEnv, api, api->AllocatorFree(allocator, outputValues));
+    return outputArray;
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    clearBoundInputs
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_clearBoundInputs
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle) {
+    (void) jniEnv; (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    api->ClearBoundInputs((OrtIoBinding*) nativeHandle);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    clearBoundOutputs
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_clearBoundOutputs
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle) {
+    (void) jniEnv; (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    api->ClearBoundOutputs((OrtIoBinding*) nativeHandle);
+}
+
+/*
+ * Class:     ai_onnxruntime_OrtSession_IoBinding
+ * Method:    close
+ * Signature: (JJ)V
+ */
+JNIEXPORT void JNICALL Java_ai_onnxruntime_OrtSession_00024IoBinding_close
+  (JNIEnv * jniEnv, jobject jobj, jlong apiHandle, jlong nativeHandle) {
+    (void) jniEnv; (void) jobj; // Required JNI parameters not needed by functions which don't need to access their host object.
+    const OrtApi* api = (const OrtApi*) apiHandle;
+    api->ReleaseIoBinding((OrtIoBinding*) nativeHandle);
+}
@@ -118,6 +118,10 @@ struct GroupQueryAttentionParameters {
   AttentionQkvFormat past_kv_format;
   int zeros_count;
   int* zero_ptr;
+  bool paged_kv_cache;          // past and present kv are blocks of a paged cache indexed by the block table
+  int kv_cache_block_size;      // number of tokens per block of the paged kv cache
+  int num_kv_cache_blocks;      // number of blocks of the paged kv cache
+  int max_blocks_per_sequence;  // number of entries per sequence in the block table
 };
 
 // Parameters for sparse attention.
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
+
 #include "contrib_ops/cpu/bert/attention_base.h"
 #include "contrib_ops/cpu/bert/attention_helper.h"
 #include "core/common/common.h"
@@ -87,39 +90,55 @@ class AttentionCPUBase : public AttentionBase {
       relative_position_bias_data = relative_position_bias->Data<T>();
     }
 
-    // Compute the attention score.
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
+    // The attention probs and the temporary output take the most memory, so when the run has a memory budget they are
+    // computed for as many batches at a time as fit in what is left of it.
+    const size_t bytes_per_batch = SafeInt<size_t>(num_heads_) * sequence_length *
+                                   (SafeInt<size_t>(total_sequence_length) + v_head_size) * sizeof(T);
+    const size_t batches_in_budget =
+        bytes_per_batch == 0 ? std::numeric_limits<size_t>::max() : context->GetAvailableRunMemory() / bytes_per_batch;
+    const int batch_chunk =
+        static_cast<int>(std::min(std::max<size_t>(batches_in_budget, 1), static_cast<size_t>(batch_size)));
+
+    size_t bytes = SafeInt<size_t>(batch_chunk) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
     auto attention_probs = allocator->Alloc(bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
-    ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
-                             static_cast<T*>(mask_data),
-                             batch_size, sequence_length, kv_sequence_length, past_sequence_length,
-                             qk_head_size == 0 ? v_head_size : qk_head_size, past_data, past_key_data,
-                             present_data, present_key_data, tp, scale, relative_position_bias_data);
-
-    // Compute the attentionScore * Value: out_tmp(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
     auto out_tmp_data =
-        allocator->Alloc(SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * v_head_size * sizeof(T));
+        allocator->Alloc(SafeInt<size_t>(batch_chunk) * num_heads_ * sequence_length * v_head_size * sizeof(T));
     BufferUniquePtr out_tmp_buffer(out_tmp_data, BufferDeleter(std::move(allocator)));
 
-    ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(out_tmp_data), static_cast<T*>(attention_probs),
-                            V, batch_size, sequence_length, kv_sequence_length, past_sequence_length, v_head_size,
-                            v_hidden_size, past_data, past_value_data, present_data, present_value_data, tp);
+    for (int first_batch = 0; first_batch < batch_size; first_batch += batch_chunk) {
+      const int num_batches = std::min(batch_chunk, batch_size - first_batch);
+
+      // Compute the attention score.
+      ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
+                               static_cast<T*>(mask_data),
+                               first_batch, num_batches, sequence_length, kv_sequence_length, past_sequence_length,
+                               qk_head_size == 0 ? v_head_size : qk_head_size, past_data, past_key_data,
+                               present_data, present_key_data, tp, scale, relative_position_bias_data);
+
+      // Compute the attentionScore * Value: out_tmp(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
+      ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(out_tmp_data),
+                              static_cast<T*>(attention_probs), V, batch_size, first_batch, num_batches,
+                              sequence_length, kv_sequence_length, past_sequence_length, v_head_size,
+                              v_hidden_size, past_data, past_value_data, present_data, present_value_data, tp);
+    }
 
     return Status::OK();
   }
 
  private:
-  // Helper function to compute the attention probs. It does 2 things:
+  // Helper function to compute the attention probs of the batches [first_batch, first_batch + num_batches).
+  // It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) +
   //                                1 x mask_data(B, N, S, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
   template <typename T>
-  void ComputeAttentionProbs(T* attention_probs,                   // output buffer with size BxNxSxT
+  void ComputeAttentionProbs(T* attention_probs,                   // output buffer with size num_batchesxNxSxT
                              const T* Q,                           // Q data. Its size is BxNxSxH
                              const T* K,                           // k data. Its size is BxNxLxH
                              T* mask_data,                         // buffer for mask data.
-                             int batch_size,                       // batch size of self-attention
+                             int first_batch,                      // first batch to compute
+                             int num_batches,                      // number of batches to compute
                              int sequence_length,                  // sequence length of self-attention (S)
                              int kv_sequence_length,               // sequence length of cross-attention (L)
                              int past_sequence_length,             // sequence length of past state
@@ -139,7 +158,7 @@ class AttentionCPUBase : public AttentionBase {
     const size_t present_chunk_length = past_chunk_length + kv_input_chunk_length;             // T x H
 
     {
-      const int loop_len = batch_size * num_heads_;
+      const int loop_len = num_batches * num_heads_;
       const float alpha = scale;
 
       TensorOpCost unit_cost;
@@ -148,6 +167,8 @@ class AttentionCPUBase : public AttentionBase {
           static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * head_size * total_sequence_length);
       unit_cost.bytes_loaded = static_cast<double>((sequence_length + total_sequence_length) * head_size * sizeof(T));
       unit_cost.bytes_stored = static_cast<double>(probs_matrix_bytes);
+      // the softmax of the scores
+      unit_cost.compute_cycles += static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * total_sequence_length);
 
       if (mask_data != nullptr) {
         unit_cost.bytes_loaded += static_cast<double>(probs_matrix_bytes);
@@ -167,12 +188,13 @@ class AttentionCPUBase : public AttentionBase {
       }
 
       ThreadPool::TryParallelFor(tp, loop_len, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
-        for (std::ptrdiff_t i = begin; i != end; ++i) {
+        for (std::ptrdiff_t chunk_i = begin; chunk_i != end; ++chunk_i) {
+          const std::ptrdiff_t i = chunk_i + SafeInt<ptrdiff_t>(first_batch) * num_heads_;
           const int batch_index = static_cast<int>(i) / num_heads_;
 
           const ptrdiff_t output_offset = SafeInt<ptrdiff_t>(i) * sequence_length * total_sequence_length;
           const ptrdiff_t mask_offset = SafeInt<ptrdiff_t>(batch_index) * sequence_length * total_sequence_length;
-          T* output = attention_probs + output_offset;
+          T* output = attention_probs + SafeInt<ptrdiff_t>(chunk_i) * sequence_length * total_sequence_length;
 
           // Broadcast mask data: (Bx)SxT -> (BxNx)SxT
           if (mask_data != nullptr) {
@@ -201,30 +223,29 @@ class AttentionCPUBase : public AttentionBase {
               output[j] += relative_position_bias_data[output_offset + j];
             }
           }
+
+          // attention_probs(B, N, S, T) = Softmax(attention_probs)
+          // done per head while its scores are still in cache instead of as another pass over all of them
+          ComputeAttentionSoftmaxInplace(output, sequence_length, total_sequence_length, nullptr);
         }
       });
     }
 
     DUMP_CPU_TENSOR_INIT();
-    DUMP_CPU_TENSOR("Q", Q, batch_size, num_heads_, sequence_length, head_size);
-    DUMP_CPU_TENSOR("QK (scaled)", attention_probs, batch_size, num_heads_, sequence_length, total_sequence_length);
-
-    // attention_probs(B, N, S, T) = Softmax(attention_probs)
-    {
-      const int N = batch_size * num_heads_ * sequence_length;
-      const int D = total_sequence_length;
-      ComputeAttentionSoftmaxInplace(attention_probs, N, D, tp);
-    }
-
-    DUMP_CPU_TENSOR("Softmax(QK)", attention_probs, batch_size, num_heads_, sequence_length, total_sequence_length);
+    DUMP_CPU_TENSOR("Q", Q + q_input_chunk_length * first_batch * num_heads_, num_batches, num_heads_, sequence_length,
+                    head_size);
+    DUMP_CPU_TENSOR("Softmax(QK)", attention_probs, num_batches, num_heads_, sequence_length, total_sequence_length);
   }
 
+  // Computes the output of the batches [first_batch, first_batch + num_batches) from their attention probs.
   template <typename T>
   void ComputeVxAttentionScore(T* output,                 // buffer for the result with size BxSxNxH_v
-                               T* tmp_buffer,             // buffer for temp use with size is BxNxSxH_v
-                               const T* attention_probs,  // Attention probs with size BxNxSxT
+                               T* tmp_buffer,             // buffer for temp use with size is num_batchesxNxSxH_v
+                               const T* attention_probs,  // Attention probs with size num_batchesxNxSxT
                                const T* V,                // V value with size BxNxLxH_v
                                int batch_size,            // batch size
+                               int first_batch,           // first batch to compute
+                               int num_batches,           // number of batches to compute
                                int sequence_length,       // sequence length
                                int kv_sequence_length,    // sequence length of K or V
                                int past_sequence_length,  // sequence length in past state
@@ -269,8 +290,9 @@ class AttentionCPUBase : public AttentionBase {
     unit_cost.bytes_stored += bytes_to_copy_trans_all;
 
     ThreadPool::TryParallelFor(
-        tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
-          for (std::ptrdiff_t i = begin; i != end; ++i) {
+        tp, SafeInt<ptrdiff_t>(num_batches) * num_heads_, unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t chunk_i = begin; chunk_i != end; ++chunk_i) {
+            const std::ptrdiff_t i = chunk_i + SafeInt<ptrdiff_t>(first_batch) * num_heads_;
             const T* v = V + kv_input_chunk_length * i;
             if (nullptr != present) {
               // Concatenate past_V and V: (BxNx)PxH_v, (BxNx)LxH_v -> (BxNx)TxH_v
@@ -279,8 +301,8 @@ class AttentionCPUBase : public AttentionBase {
               v = ConcatStateChunk(past_value, v, present_value, past_chunk_length, present_chunk_length, i);
             }
 
-            T* current_tmp_data = reinterpret_cast<T*>(tmp_buffer) + q_input_chunk_length * i;
-            ptrdiff_t attention_probs_offset = SafeInt<ptrdiff_t>(sequence_length) * total_sequence_length * i;
+            T* current_tmp_data = reinterpret_cast<T*>(tmp_buffer) + q_input_chunk_length * chunk_i;
+            ptrdiff_t attention_probs_offset = SafeInt<ptrdiff_t>(sequence_length) * total_sequence_length * chunk_i;
             math::MatMul<T>(sequence_length, v_head_size, total_sequence_length,
                             attention_probs + attention_probs_offset, v, current_tmp_data, nullptr);
 
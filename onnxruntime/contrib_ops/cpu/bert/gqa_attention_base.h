@@ -6,10 +6,19 @@
 #include "contrib_ops/cpu/bert/attention_base.h"
 #include "contrib_ops/cpu/bert/attention_helper.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
 #include "core/common/common.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/env.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -31,6 +40,10 @@ class GQAAttentionBase {
     rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
 
     local_window_size_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1)) : -1;
+    num_sink_tokens_ = has_local ? static_cast<int>(info.GetAttrOrDefault<int64_t>("num_sink_tokens", -1)) : -1;
+
+    l2_cache_size_ = Env::Default().GetL2CacheSize();
+    disable_flash_ = ParseEnvironmentVariableWithDefault<bool>(attention::kDisableFlashAttention, false);
   }
 
   int num_heads_;     // number of attention heads of Q
@@ -39,6 +52,9 @@ class GQAAttentionBase {
   bool do_rotary_;    // whether or not to use rotary embeddings
   bool rotary_interleaved_;
   int local_window_size_;
+  int num_sink_tokens_;  // the first tokens attended besides the local window, -1 without a ring buffer kv cache
+  bool disable_flash_;
+  int l2_cache_size_;
 
   template <typename T>
   Status ApplyAttention(const T* Q,                                 // Q data with shape BxNxSxH
@@ -50,6 +66,7 @@ class GQAAttentionBase {
                         Tensor* present_key,                        // present K output tensor (if separating present KV)
                         Tensor* present_value,                      // present V output tensor (if separating present KV)
                         const Tensor* seqlens_k,                    // past sequence lengths tensor
+                        const Tensor* block_table,                  // block table of the paged kv-cache (optional)
                         GroupQueryAttentionParameters& parameters,  // attention parameters
                         AllocatorPtr allocator,                     // allocator for temporary tensors
                         OpKernelContext* context) const {
@@ -65,12 +82,30 @@ class GQAAttentionBase {
     if (past_key != nullptr && past_value != nullptr) {
       seqlen_past_kv_cache = static_cast<int>(past_key->Shape().GetDims()[2]);
     }
-    int seqlen_present_kv_cache = static_cast<int>(present_key->Shape().GetDims()[2]);
-
-    // Compute the attention score.
-    size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
-    auto attention_probs = allocator->Alloc(bytes);
-    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+    // The present kv of a paged cache are blocks, each sequence can span up to the capacity of its block table.
+    int seqlen_present_kv_cache = parameters.paged_kv_cache ? parameters.seqlen_present_kv_cache
+                                                            : static_cast<int>(present_key->Shape().GetDims()[2]);
+
+    const size_t probs_bytes =
+        SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * seqlen_present_kv_cache * sizeof(T);
+
+    if (parameters.paged_kv_cache) {
+      // Compute the attention score.
+      auto attention_probs = allocator->Alloc(probs_bytes);
+      BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+      const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+      const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+      ORT_RETURN_IF_ERROR(UpdatePagedKVCache(k, v, seqlens_k->Data<int32_t>(), block_table->Data<int32_t>(),
+                                             *past_key, *past_value, *present_key, *present_value, parameters, tp));
+
+      ComputePagedAttentionProbs<T>(static_cast<T*>(attention_probs), Q, seqlens_k->Data<int32_t>(),
+                                    block_table->Data<int32_t>(), present_key->Data<T>(), seqlen_present_kv_cache,
+                                    parameters, tp);
+      ComputePagedVxAttentionScore<T>(output->MutableData<T>(), static_cast<T*>(attention_probs),
+                                      seqlens_k->Data<int32_t>(), block_table->Data<int32_t>(),
+                                      present_value->Data<T>(), seqlen_present_kv_cache, parameters, tp);
+      return Status::OK();
+    }
 
     const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
     T* present_key_data = present_key != nullptr ? present_key->MutableData<T>() : nullptr;
@@ -80,12 +115,27 @@ class GQAAttentionBase {
     bool past_present_share_buffer = past_key_data == present_key_data && past_value_data == present_value_data;
 
     const T* k = packed_qkv ? Q + num_heads_ * sequence_length * head_size : K;
+    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
+
+    if constexpr (std::is_same_v<T, float>) {
+      if (!disable_flash_ && l2_cache_size_ > 0 && present_key_data != nullptr && present_value_data != nullptr) {
+        ConcatPresentKV(k, v, batch_size, sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size,
+                        seqlens_k->Data<int32_t>(), past_key_data, past_value_data, present_key_data,
+                        present_value_data, past_present_share_buffer, packed_qkv, tp);
+        return ComputeFlashAttention(output->MutableData<T>(), Q, present_key_data, present_value_data,
+                                     seqlens_k->Data<int32_t>(), seqlen_present_kv_cache, parameters, allocator, tp);
+      }
+    }
+
+    // Compute the attention score.
+    auto attention_probs = allocator->Alloc(probs_bytes);
+    BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
+
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, k, seqlens_k->Data<int32_t>(), batch_size,
                              sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size, past_key_data,
                              present_key_data, past_present_share_buffer, packed_qkv, tp);
 
     // Compute the attentionScore * Value: out(B, N, S, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
-    const T* v = packed_qkv ? Q + (num_heads_ + kv_num_heads_) * sequence_length * head_size : V;
     ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(attention_probs), v, seqlens_k->Data<int32_t>(),
                             batch_size, sequence_length, seqlen_past_kv_cache, seqlen_present_kv_cache, head_size,
                             hidden_size, past_value_data, present_value_data, past_present_share_buffer, packed_qkv,
@@ -94,7 +144,417 @@ class GQAAttentionBase {
     return Status::OK();
   }
 
+  // The kv cache is a ring buffer of num_sink_tokens + local_window_size + 1 tokens: the sink tokens stay in
+  // the first slots, and the token at position p >= num_sink_tokens goes to the slot
+  // num_sink_tokens + (p - num_sink_tokens) % (local_window_size + 1), overwriting the one leaving the window.
+  bool IsRingBufferKVCache() const { return num_sink_tokens_ >= 0 && local_window_size_ > 0; }
+
+  int RingBufferKVCacheCapacity() const { return num_sink_tokens_ + local_window_size_ + 1; }
+
+  int RingBufferKVCacheSlot(int position) const {
+    return position < num_sink_tokens_ ? position
+                                       : num_sink_tokens_ + (position - num_sink_tokens_) % (local_window_size_ + 1);
+  }
+
+  // Computes the attention with a ring buffer kv cache (B x N_kv x C x H). The prompt attends to its own keys and
+  // values with the sink and local window mask, then its sink tokens and last window are written to the cache.
+  // A new token attends to all the tokens in the cache, which are the sink tokens and the window, in any order
+  // since the rotary embedding has been applied to the keys.
+  template <typename T>
+  Status ApplyRingBufferAttention(const T* Q,                                       // Q data with shape BxNxSxH
+                                  const T* K,                                       // K data with shape BxN_kvxSxH
+                                  const T* V,                                       // V data with shape BxN_kvxSxH
+                                  const Tensor* past_key,                           // past K input tensor
+                                  const Tensor* past_value,                         // past V input tensor
+                                  Tensor& output,                                   // output tensor
+                                  Tensor& present_key,                              // present K output tensor
+                                  Tensor& present_value,                            // present V output tensor
+                                  const Tensor& seqlens_k,                          // past sequence lengths tensor
+                                  const GroupQueryAttentionParameters& parameters,  // attention parameters
+                                  ThreadPool* tp) const {                           // thread pool
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const bool is_prompt = sequence_length != 1;
+    const int capacity = RingBufferKVCacheCapacity();
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    const int32_t* seqlens = seqlens_k.Data<int32_t>();
+
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+    const size_t cache_chunk_length = static_cast<size_t>(capacity) * head_size;            // C x H
+    const ptrdiff_t q_batch_stride =
+        SafeInt<ptrdiff_t>(parameters.is_packed_qkv ? num_heads_ + 2 * kv_num_heads_ : num_heads_) *
+        kv_input_chunk_length;
+    const ptrdiff_t kv_batch_stride =
+        parameters.is_packed_qkv ? q_batch_stride : SafeInt<ptrdiff_t>(kv_num_heads_) * kv_input_chunk_length;
+    const T* k_input = parameters.is_packed_qkv ? Q + num_heads_ * kv_input_chunk_length : K;
+    const T* v_input = parameters.is_packed_qkv ? Q + (num_heads_ + kv_num_heads_) * kv_input_chunk_length : V;
+
+    const T* past_key_data = past_key != nullptr ? past_key->Data<T>() : nullptr;
+    const T* past_value_data = past_value != nullptr ? past_value->Data<T>() : nullptr;
+    T* present_key_data = present_key.MutableData<T>();
+    T* present_value_data = present_value.MutableData<T>();
+    T* output_data = output.MutableData<T>();
+
+    // Write the new tokens to their slots of the ring buffer.
+    TensorOpCost copy_cost;
+    copy_cost.bytes_loaded = static_cast<double>(2 * cache_chunk_length * sizeof(T));
+    copy_cost.bytes_stored = copy_cost.bytes_loaded;
+    copy_cost.compute_cycles = 0;
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, copy_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / kv_num_heads_);
+        const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+        T* present_keys = present_key_data + i * cache_chunk_length;
+        T* present_values = present_value_data + i * cache_chunk_length;
+        if (is_prompt || past_key_data == nullptr) {
+          std::fill_n(present_keys, cache_chunk_length, T{});
+          std::fill_n(present_values, cache_chunk_length, T{});
+        } else if (present_keys != past_key_data + i * cache_chunk_length) {
+          std::copy_n(past_key_data + i * cache_chunk_length, cache_chunk_length, present_keys);
+          std::copy_n(past_value_data + i * cache_chunk_length, cache_chunk_length, present_values);
+        }
+
+        // The prompt keeps its sink tokens and its last window, a new token is at position seqlens_k.
+        const int total_seqlen = seqlens[batch_index] + 1;
+        const int first_position = is_prompt ? 0 : seqlens[batch_index];
+        const int window_start = std::max(num_sink_tokens_, total_seqlen - (local_window_size_ + 1));
+        const T* new_keys = k_input + kv_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+        const T* new_values = v_input + kv_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+        for (int position = first_position; position < total_seqlen; position++) {
+          if (position >= num_sink_tokens_ && position < window_start) {
+            continue;
+          }
+          const ptrdiff_t token = static_cast<ptrdiff_t>(position - first_position) * head_size;
+          const ptrdiff_t slot = static_cast<ptrdiff_t>(RingBufferKVCacheSlot(position)) * head_size;
+          std::copy_n(new_keys + token, head_size, present_keys + slot);
+          std::copy_n(new_values + token, head_size, present_values + slot);
+        }
+      }
+    });
+
+    TensorOpCost unit_cost;
+    const int kv_length = is_prompt ? sequence_length : capacity;
+    unit_cost.bytes_loaded = static_cast<double>((sequence_length + 2 * kv_length) * head_size * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(kv_input_chunk_length * sizeof(T));
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(4) * sequence_length * kv_length * head_size);
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<T> probs;
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / num_heads_);
+        const int head_index = static_cast<int>(i % num_heads_);
+        const int kv_head_index = head_index / kv_num_heads_factor;
+        const int total_seqlen = seqlens[batch_index] + 1;
+
+        const T* k;
+        const T* v;
+        int kv_seqlen;
+        if (is_prompt) {
+          k = k_input + kv_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+          v = v_input + kv_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+          kv_seqlen = sequence_length;
+        } else {
+          const ptrdiff_t cache_offset = (SafeInt<ptrdiff_t>(batch_index) * kv_num_heads_ + kv_head_index) *
+                                         cache_chunk_length;
+          k = present_key_data + cache_offset;
+          v = present_value_data + cache_offset;
+          kv_seqlen = std::min(total_seqlen, capacity);
+        }
+
+        // probs(S, L) = alpha x Q(S, H) x K'(H, L)
+        probs.resize(static_cast<size_t>(sequence_length) * kv_seqlen);
+        const T* q = Q + q_batch_stride * batch_index + kv_input_chunk_length * head_index;
+        math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length, kv_seqlen, head_size, alpha, q,
+                                    head_size, k, head_size, 0.0f, probs.data(), kv_seqlen, nullptr);
+        if (is_prompt) {
+          ComputeCausalSoftmax(probs.data(), sequence_length, std::min(total_seqlen, kv_seqlen), kv_seqlen);
+        } else {
+          ComputeAttentionSoftmaxInplace(probs.data(), 1, kv_seqlen, nullptr);
+        }
+
+        // out(S, H) of the head in the output B x S x N x H = probs(S, L) x V(L, H)
+        T* out = output_data + (SafeInt<ptrdiff_t>(batch_index) * sequence_length * num_heads_ + head_index) *
+                                   head_size;
+        math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, kv_seqlen, 1.0f,
+                                    probs.data(), kv_seqlen, v, head_size, 0.0f, out, hidden_size, nullptr);
+      }
+    });
+
+    return Status::OK();
+  }
+
+  // Computes the attention with an int8 kv cache (B x N_kv x T x H) quantized per token and kv head, its scales
+  // being B x N_kv x T. The new keys and values are quantized as they are appended to the present kv cache, and the
+  // cache of a kv head is dequantized once by the thread computing all the heads of its group.
+  Status ApplyQuantizedKVAttention(const float* Q,                                   // Q data with shape BxNxSxH
+                                   const float* K,                                   // K data with shape BxN_kvxSxH
+                                   const float* V,                                   // V data with shape BxN_kvxSxH
+                                   const Tensor& past_key,                           // int8 past key
+                                   const Tensor& past_value,                         // int8 past value
+                                   const Tensor& past_key_scale,                     // past key scales
+                                   const Tensor& past_value_scale,                   // past value scales
+                                   Tensor& output,                                   // output tensor
+                                   Tensor& present_key,                              // int8 present key
+                                   Tensor& present_value,                            // int8 present value
+                                   Tensor& present_key_scale,                        // present key scales
+                                   Tensor& present_value_scale,                      // present value scales
+                                   const Tensor& seqlens_k,                          // past sequence lengths tensor
+                                   const GroupQueryAttentionParameters& parameters,  // attention parameters
+                                   ThreadPool* tp) const {                           // thread pool
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const bool is_prompt = sequence_length != 1;
+    const int past_buffer_sequence_length = static_cast<int>(past_key.Shape()[2]);
+    const int present_buffer_sequence_length = static_cast<int>(present_key.Shape()[2]);
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    const int32_t* seqlens = seqlens_k.Data<int32_t>();
+
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;  // S x H
+    const ptrdiff_t q_batch_stride =
+        SafeInt<ptrdiff_t>(parameters.is_packed_qkv ? num_heads_ + 2 * kv_num_heads_ : num_heads_) *
+        kv_input_chunk_length;
+    const ptrdiff_t kv_batch_stride =
+        parameters.is_packed_qkv ? q_batch_stride : SafeInt<ptrdiff_t>(kv_num_heads_) * kv_input_chunk_length;
+    const float* k_input = parameters.is_packed_qkv ? Q + num_heads_ * kv_input_chunk_length : K;
+    const float* v_input = parameters.is_packed_qkv ? Q + (num_heads_ + kv_num_heads_) * kv_input_chunk_length : V;
+
+    const int8_t* past_key_data = past_key.Data<int8_t>();
+    const int8_t* past_value_data = past_value.Data<int8_t>();
+    const float* past_key_scale_data = past_key_scale.Data<float>();
+    const float* past_value_scale_data = past_value_scale.Data<float>();
+    int8_t* present_key_data = present_key.MutableData<int8_t>();
+    int8_t* present_value_data = present_value.MutableData<int8_t>();
+    float* present_key_scale_data = present_key_scale.MutableData<float>();
+    float* present_value_scale_data = present_value_scale.MutableData<float>();
+    float* output_data = output.MutableData<float>();
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buffer_sequence_length * head_size);
+    unit_cost.bytes_stored = static_cast<double>(kv_num_heads_factor * kv_input_chunk_length * sizeof(float));
+    unit_cost.compute_cycles = static_cast<double>(SafeInt<ptrdiff_t>(4) * kv_num_heads_factor * sequence_length *
+                                                   present_buffer_sequence_length * head_size);
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+      std::vector<float> kv_buffer;
+      std::vector<float> probs;
+      for (std::ptrdiff_t i = begin; i != end; ++i) {
+        const int batch_index = static_cast<int>(i / kv_num_heads_);
+        const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+        const int past_seqlen = is_prompt ? 0 : seqlens[batch_index];
+        const int total_seqlen = seqlens[batch_index] + 1;
+
+        // Append the quantized new tokens to the past ones.
+        int8_t* present_keys = present_key_data + i * present_buffer_sequence_length * head_size;
+        int8_t* present_values = present_value_data + i * present_buffer_sequence_length * head_size;
+        float* present_key_scales = present_key_scale_data + i * present_buffer_sequence_length;
+        float* present_value_scales = present_value_scale_data + i * present_buffer_sequence_length;
+        const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
+        if (present_keys != past_key_data + i * past_buffer_sequence_length * head_size) {
+          memcpy(present_keys, past_key_data + i * past_buffer_sequence_length * head_size, past_chunk_length);
+          memcpy(present_values, past_value_data + i * past_buffer_sequence_length * head_size, past_chunk_length);
+        }
+        if (present_key_scales != past_key_scale_data + i * past_buffer_sequence_length) {
+          std::copy_n(past_key_scale_data + i * past_buffer_sequence_length, past_seqlen, present_key_scales);
+          std::copy_n(past_value_scale_data + i * past_buffer_sequence_length, past_seqlen, present_value_scales);
+        }
+        const float* new_keys = k_input + kv_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+        const float* new_values = v_input + kv_batch_stride * batch_index + kv_input_chunk_length * kv_head_index;
+        for (int s = 0; s < sequence_length; s++) {
+          QuantizeKVToken(new_keys + s * head_size, head_size, present_keys + (past_seqlen + s) * head_size,
+                          present_key_scales[past_seqlen + s]);
+          QuantizeKVToken(new_values + s * head_size, head_size, present_values + (past_seqlen + s) * head_size,
+                          present_value_scales[past_seqlen + s]);
+        }
+
+        // probs(G x S, L) = alpha x Q(G x S, H) x K'(H, L) for the G heads of the group, which are adjacent. A prompt
+        // attends to its S new tokens, of which only the first total are valid in a right padded batch: the rows of
+        // the padding tokens still hold S causal probs, as in ApplyAttention.
+        const int kv_seqlen = is_prompt ? sequence_length : total_seqlen;
+        const int group_rows = kv_num_heads_factor * sequence_length;
+        kv_buffer.resize(static_cast<size_t>(kv_seqlen) * head_size);
+        probs.resize(static_cast<size_t>(group_rows) * kv_seqlen);
+        DequantizeKVTokens(present_keys, present_key_scales, kv_seqlen, head_size, kv_buffer.data());
+        const int first_head = kv_head_index * kv_num_heads_factor;
+        const float* q = Q + q_batch_stride * batch_index + kv_input_chunk_length * first_head;
+        math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasTrans, group_rows, kv_seqlen, head_size, alpha, q,
+                                        head_size, kv_buffer.data(), head_size, 0.0f, probs.data(), kv_seqlen,
+                                        nullptr);
+        for (int h = 0; h < kv_num_heads_factor; h++) {
+          ComputeCausalSoftmax(probs.data() + h * sequence_length * kv_seqlen, sequence_length,
+                               std::min(total_seqlen, kv_seqlen), kv_seqlen);
+        }
+
+        // out(S, H) of head n in the output B x S x N x H = probs(S, L) x V(L, H)
+        DequantizeKVTokens(present_values, present_value_scales, kv_seqlen, head_size, kv_buffer.data());
+        for (int h = 0; h < kv_num_heads_factor; h++) {
+          float* out = output_data + (SafeInt<ptrdiff_t>(batch_index) * sequence_length * num_heads_ + first_head + h) *
+                                         head_size;
+          math::GemmEx<float, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size, kv_seqlen,
+                                          1.0f, probs.data() + h * sequence_length * kv_seqlen, kv_seqlen,
+                                          kv_buffer.data(), head_size, 0.0f, out, hidden_size, nullptr);
+        }
+      }
+    });
+
+    return Status::OK();
+  }
+
  private:
+  // Quantizes a key or value of a token and kv head to int8 with the symmetric scale max(abs(x)) / 127.
+  static void QuantizeKVToken(const float* x, int head_size, int8_t* quantized, float& scale) {
+    float max_abs = 0.0f;
+    for (int h = 0; h < head_size; h++) {
+      max_abs = std::max(max_abs, std::abs(x[h]));
+    }
+    scale = max_abs / 127.0f;
+    const float inverse_scale = max_abs > 0.0f ? 127.0f / max_abs : 0.0f;
+    for (int h = 0; h < head_size; h++) {
+      quantized[h] = static_cast<int8_t>(std::clamp(std::nearbyint(x[h] * inverse_scale), -127.0f, 127.0f));
+    }
+  }
+
+  static void DequantizeKVTokens(const int8_t* quantized, const float* scales, int num_tokens, int head_size,
+                                 float* x) {
+    for (int t = 0; t < num_tokens; t++) {
+      for (int h = 0; h < head_size; h++) {
+        x[t * head_size + h] = scales[t] * static_cast<float>(quantized[t * head_size + h]);
+      }
+    }
+  }
+
+  // Helper function to append the new keys and values to the past ones in the present kv cache (B x N_kv x T x H).
+  template <typename T>
+  void ConcatPresentKV(const T* K,                           // new keys
+                       const T* V,                           // new values
+                       int batch_size,                       // batch size of self-attention
+                       int sequence_length,                  // sequence length of self-attention (S)
+                       int past_buffer_sequence_length,      // sequence length of past state
+                       int present_buffer_sequence_length,   // sequence length of present state
+                       int head_size,                        // head size of self-attention
+                       const int32_t* seqlens_k,             // past sequence lengths tensor
+                       const T* past_key,                    // past key only
+                       const T* past_value,                  // past value only
+                       T* present_key,                       // present key only
+                       T* present_value,                     // present value only
+                       bool past_present_share_buffer,       // whether present key and value share the same buffer
+                       bool packed_qkv,                      // whether Q, K, V are packed
+                       ThreadPool* tp) const {               // thread pool
+    const bool is_prompt = sequence_length != 1;
+    const ptrdiff_t packed_batch_stride =
+        packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                   : SafeInt<ptrdiff_t>(kv_num_heads_) * sequence_length * head_size;
+    const size_t kv_input_chunk_length = static_cast<size_t>(sequence_length) * head_size;                     // L x H
+    const size_t past_buff_chunk_length = static_cast<size_t>(past_buffer_sequence_length) * head_size;        // L x H
+    const size_t present_buff_chunk_length = static_cast<size_t>(present_buffer_sequence_length) * head_size;  // T x H
+
+    if (!past_present_share_buffer) {
+      const size_t present_bytes = SafeInt<size_t>(batch_size) * kv_num_heads_ * present_buff_chunk_length * sizeof(T);
+      memset(present_key, 0, present_bytes);
+      memset(present_value, 0, present_bytes);
+    }
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * present_buff_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    unit_cost.compute_cycles = 0;
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                                 for (std::ptrdiff_t i = begin; i != end; ++i) {
+                                   const int batch_index = static_cast<int>(i / kv_num_heads_);
+                                   const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+                                   const int past_seqlen = sequence_length == 1 ? seqlens_k[batch_index]
+                                                                                : past_buffer_sequence_length;
+                                   const size_t past_chunk_length = static_cast<size_t>(past_seqlen) * head_size;
+                                   const ptrdiff_t chunk_offset = packed_batch_stride * batch_index +
+                                                                  kv_input_chunk_length * kv_head_index;
+                                   ConcatStateChunkGQA(past_key, K + chunk_offset, present_key,
+                                                       present_buff_chunk_length, past_buff_chunk_length,
+                                                       past_chunk_length, kv_input_chunk_length, is_prompt,
+                                                       past_present_share_buffer, i);
+                                   ConcatStateChunkGQA(past_value, V + chunk_offset, present_value,
+                                                       present_buff_chunk_length, past_buff_chunk_length,
+                                                       past_chunk_length, kv_input_chunk_length, is_prompt,
+                                                       past_present_share_buffer, i);
+                                 }
+                               });
+  }
+
+  // Helper function to compute the attention with the tiled, online softmax kernel of MLAS, which does not
+  // materialize the attention probs:
+  //  out(B, S, N, H) = Softmax(1/sqrt(H) x Q(B, N, S, H) x K'(B, N_kv, T, H -> B, N_kv, H, T)) x V(B, N_kv, T, H)
+  Status ComputeFlashAttention(float* output,                                    // output with size BxSxNxH
+                               const float* Q,                                   // Q data. Its size is BxNxSxH
+                               const float* present_key,                         // present key with size BxN_kvxTxH
+                               const float* present_value,                       // present value with size BxN_kvxTxH
+                               const int32_t* seqlens_k,                         // past sequence lengths tensor
+                               int present_buffer_sequence_length,               // sequence length of present state
+                               const GroupQueryAttentionParameters& parameters,  // attention parameters
+                               AllocatorPtr allocator,                           // allocator for temporary buffers
+                               ThreadPool* tp) const {                           // thread pool
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+
+    // The prompt has no past, its keys and values are the first S tokens of the present kv cache.
+    std::vector<int32_t> total_seqlens(static_cast<size_t>(batch_size));
+    for (int b = 0; b < batch_size; b++) {
+      total_seqlens[b] = sequence_length == 1 ? seqlens_k[b] + 1 : std::min(seqlens_k[b] + 1, sequence_length);
+    }
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = batch_size;
+    args.num_heads = num_heads_;
+    args.q_sequence_length = sequence_length;
+    args.kv_sequence_length = present_buffer_sequence_length;
+    args.qk_head_size = head_size;
+    args.v_head_size = head_size;
+    args.scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+    // The block sizes keep the slices of Q, K and V and the intermediate results in the L2 cache,
+    // see MultiHeadAttention<T>::Compute for their derivation.
+    args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (2 * head_size));
+    args.kv_block_size = std::max(args.kv_block_size, 1);
+    args.q_block_size = std::min(args.kv_block_size, 2 * head_size);
+    args.kv_block_size = std::min(args.kv_block_size, present_buffer_sequence_length);
+    args.q_block_size = std::min(args.q_block_size, sequence_length);
+
+    args.thread_count = concurrency::ThreadPool::DegreeOfParallelism(tp);
+    args.buffer_size_per_thread = (static_cast<size_t>(args.q_block_size) * 2 +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.kv_block_size) +
+                                   static_cast<size_t>(args.q_block_size) * static_cast<size_t>(args.v_head_size)) *
+                                  sizeof(float);
+    IAllocatorUniquePtr<void> buffer =
+        IAllocator::MakeUniquePtr<void>(allocator, args.buffer_size_per_thread * args.thread_count);
+    args.buffer = reinterpret_cast<float*>(buffer.get());
+
+    args.query = Q;
+    args.key = present_key;
+    args.value = present_value;
+    args.output = output;
+    args.kv_num_heads = kv_num_heads_;
+    args.kv_sequence_stride = present_buffer_sequence_length;
+    if (parameters.is_packed_qkv) {
+      args.query_batch_stride = SafeInt<size_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size;
+    }
+    args.kv_sequence_lengths = total_seqlens.data();
+    // The prompt attends to itself causally, a new token to the whole past.
+    args.is_causal = true;
+    args.local_window_size = local_window_size_;
+
+    MlasFlashAttention(&args, tp);
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
   //  attention_probs(B, N, S, T) = Softmax(attention_probs)
@@ -187,29 +647,249 @@ class GQAAttentionBase {
                                     head_size, k, head_size, 0.0f /*bata*/, output, present_buffer_sequence_length,
                                     nullptr);
 
-        // compute Softmax
-        T* output_softmax = output;
-        for (int seq = 0; seq < sequence_length; seq++) {
-          int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
-          if (local_window_size_ > 0 && seq_causal_length > local_window_size_ + 1) {
-            for (int total_seq_id = 0; total_seq_id < seq_causal_length - local_window_size_ - 1; total_seq_id++) {
-              output_softmax[total_seq_id] = 0.f;
-            }
-            ComputeAttentionSoftmaxInplace(output_softmax + seq_causal_length - local_window_size_ - 1, 1,
-                                           local_window_size_ + 1, nullptr);
-          } else {
-            ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
-          }
+        ComputeCausalSoftmax(output, sequence_length, total_seqlen, present_buffer_sequence_length);
+      }
+    });
+  }
 
-          // set causal [seq_causal_length, total_seqlen) to 0.f
-          for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
-            output_softmax[total_seq_id] = 0.f;
-          }
+  // Helper function to apply the causal (and local window) mask and the softmax to the attention probs
+  // (S x T) of one head.
+  template <typename T>
+  void ComputeCausalSoftmax(T* attention_probs,                         // attention probs with size SxT
+                            int sequence_length,                        // sequence length of self-attention (S)
+                            int total_seqlen,                           // past + new sequence length
+                            int present_buffer_sequence_length) const {  // sequence length of present state (T)
+    T* output_softmax = attention_probs;
+    for (int seq = 0; seq < sequence_length; seq++) {
+      int seq_causal_length = sequence_length == 1 ? total_seqlen : seq + 1;
+      const int window_start = seq_causal_length - local_window_size_ - 1;
+      if (local_window_size_ > 0 && num_sink_tokens_ > 0 && window_start > num_sink_tokens_) {
+        // the sink tokens are attended besides the window, the tokens in between are masked out
+        for (int total_seq_id = num_sink_tokens_; total_seq_id < window_start; total_seq_id++) {
+          output_softmax[total_seq_id] = static_cast<T>(std::numeric_limits<float>::lowest());
+        }
+        ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
+        for (int total_seq_id = num_sink_tokens_; total_seq_id < window_start; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
+        }
+      } else if (local_window_size_ > 0 && num_sink_tokens_ <= 0 && window_start > 0) {
+        for (int total_seq_id = 0; total_seq_id < window_start; total_seq_id++) {
+          output_softmax[total_seq_id] = 0.f;
+        }
+        ComputeAttentionSoftmaxInplace(output_softmax + window_start, 1, local_window_size_ + 1, nullptr);
+      } else {
+        ComputeAttentionSoftmaxInplace(output_softmax, 1, seq_causal_length, nullptr);
+      }
+
+      // set causal [seq_causal_length, total_seqlen) to 0.f
+      for (int total_seq_id = seq_causal_length; total_seq_id < total_seqlen; total_seq_id++) {
+        output_softmax[total_seq_id] = 0.f;
+      }
+
+      output_softmax += present_buffer_sequence_length;
+    }
+  }
+
+  // Returns the address of the given token of a sequence and kv head in a paged kv cache with shape
+  // (num_blocks, N_kv, block_size, H).
+  template <typename T>
+  static T* GetPagedKVCacheToken(T* kv_cache, const int32_t* block_table, int batch_index, int kv_head_index,
+                                 int token_index, const GroupQueryAttentionParameters& parameters) {
+    const int block_size = parameters.kv_cache_block_size;
+    const int32_t block = block_table[static_cast<ptrdiff_t>(batch_index) * parameters.max_blocks_per_sequence +
+                                      token_index / block_size];
+    const ptrdiff_t offset = ((static_cast<ptrdiff_t>(block) * parameters.kv_num_heads + kv_head_index) * block_size +
+                              token_index % block_size) *
+                             parameters.head_size;
+    return kv_cache + offset;
+  }
+
+  // Helper function to append the new keys and values to the paged kv cache.
+  // The present kv cache is expected to share the buffer with the past one, otherwise the past is copied to it first.
+  template <typename T>
+  Status UpdatePagedKVCache(const T* K,                                       // new keys
+                            const T* V,                                       // new values
+                            const int32_t* seqlens_k,                         // past sequence lengths tensor
+                            const int32_t* block_table,                       // block table with size BxM
+                            const Tensor& past_key,                           // paged past key cache
+                            const Tensor& past_value,                         // paged past value cache
+                            Tensor& present_key,                              // paged present key cache
+                            Tensor& present_value,                            // paged present value cache
+                            const GroupQueryAttentionParameters& parameters,  // attention parameters
+                            ThreadPool* tp) const {
+    const int batch_size = parameters.batch_size;
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const bool is_prompt = sequence_length != 1;
 
-          output_softmax += present_buffer_sequence_length;
+    // Check that the blocks the new tokens go to are within the cache before writing any of them.
+    for (int b = 0; b < batch_size; b++) {
+      const int past_seqlen = is_prompt ? 0 : seqlens_k[b];
+      const int new_seqlen = std::max(past_seqlen + sequence_length, seqlens_k[b] + 1);
+      if (past_seqlen < 0 || new_seqlen > parameters.seqlen_present_kv_cache) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "seqlens_k of sequence ", b, " is ", seqlens_k[b],
+                               ", which does not fit into its ", parameters.seqlen_present_kv_cache,
+                               " tokens of the block table.");
+      }
+      const int num_blocks = (new_seqlen + parameters.kv_cache_block_size - 1) / parameters.kv_cache_block_size;
+      for (int i = 0; i < num_blocks; i++) {
+        const int32_t block = block_table[static_cast<ptrdiff_t>(b) * parameters.max_blocks_per_sequence + i];
+        if (block < 0 || block >= parameters.num_kv_cache_blocks) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "block_table entry ", i, " of sequence ", b, " is ",
+                                 block, ", which is not a block of the kv cache with ",
+                                 parameters.num_kv_cache_blocks, " blocks.");
         }
       }
-    });
+    }
+
+    if (present_key.MutableDataRaw() != past_key.DataRaw()) {
+      memcpy(present_key.MutableDataRaw(), past_key.DataRaw(), past_key.SizeInBytes());
+    }
+    if (present_value.MutableDataRaw() != past_value.DataRaw()) {
+      memcpy(present_value.MutableDataRaw(), past_value.DataRaw(), past_value.SizeInBytes());
+    }
+
+    const ptrdiff_t packed_batch_stride =
+        parameters.is_packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                                 : SafeInt<ptrdiff_t>(kv_num_heads_) * sequence_length * head_size;
+    const ptrdiff_t kv_input_chunk_length = static_cast<ptrdiff_t>(sequence_length) * head_size;  // L x H
+    T* present_key_data = present_key.MutableData<T>();
+    T* present_value_data = present_value.MutableData<T>();
+
+    TensorOpCost unit_cost;
+    unit_cost.bytes_loaded = static_cast<double>(2 * kv_input_chunk_length * sizeof(T));
+    unit_cost.bytes_stored = unit_cost.bytes_loaded;
+    unit_cost.compute_cycles = 0;
+
+    ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * kv_num_heads_, unit_cost,
+                               [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+                                 for (std::ptrdiff_t i = begin; i != end; ++i) {
+                                   const int batch_index = static_cast<int>(i / kv_num_heads_);
+                                   const int kv_head_index = static_cast<int>(i % kv_num_heads_);
+                                   const int past_seqlen = is_prompt ? 0 : seqlens_k[batch_index];
+                                   const ptrdiff_t chunk_offset = packed_batch_stride * batch_index +
+                                                                  kv_input_chunk_length * kv_head_index;
+                                   for (int seq = 0; seq < sequence_length; seq++) {
+                                     const int token_index = past_seqlen + seq;
+                                     memcpy(GetPagedKVCacheToken(present_key_data, block_table, batch_index,
+                                                                 kv_head_index, token_index, parameters),
+                                            K + chunk_offset + seq * head_size, head_size * sizeof(T));
+                                     memcpy(GetPagedKVCacheToken(present_value_data, block_table, batch_index,
+                                                                 kv_head_index, token_index, parameters),
+                                            V + chunk_offset + seq * head_size, head_size * sizeof(T));
+                                   }
+                                 }
+                               });
+    return Status::OK();
+  }
+
+  // Helper function to compute the attention probs with the keys of a paged kv cache, one block at a time:
+  //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T)
+  //  attention_probs(B, N, S, T) = Softmax(attention_probs)
+  template <typename T>
+  void ComputePagedAttentionProbs(T* attention_probs,                                // output buffer with size BxNxSxT
+                                  const T* Q,                                        // Q data. Its size is BxNxSxH
+                                  const int32_t* seqlens_k,                          // past sequence lengths tensor
+                                  const int32_t* block_table,                        // block table with size BxM
+                                  const T* present_key,                              // paged present key cache
+                                  int present_buffer_sequence_length,                // capacity of each sequence (T)
+                                  const GroupQueryAttentionParameters& parameters,  // attention parameters
+                                  ThreadPool* tp) const {
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int block_size = parameters.kv_cache_block_size;
+    const ptrdiff_t packed_batch_stride =
+        parameters.is_packed_qkv ? SafeInt<ptrdiff_t>(num_heads_ + 2 * kv_num_heads_) * sequence_length * head_size
+                                 : SafeInt<ptrdiff_t>(num_heads_) * sequence_length * head_size;
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+    const ptrdiff_t q_input_chunk_length = static_cast<ptrdiff_t>(sequence_length) * head_size;  // S x H
+    const float alpha = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(head_size)) : scale_;
+
+    TensorOpCost unit_cost;
+    const ptrdiff_t probs_matrix_bytes =
+        SafeInt<ptrdiff_t>(sequence_length) * present_buffer_sequence_length * sizeof(T);
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * head_size * present_buffer_sequence_length);
+    unit_cost.bytes_loaded =
+        static_cast<double>((sequence_length + present_buffer_sequence_length) * head_size * sizeof(T)) +
+        static_cast<double>(probs_matrix_bytes);
+    unit_cost.bytes_stored = static_cast<double>(2 * probs_matrix_bytes);
+
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(parameters.batch_size) * num_heads_, unit_cost,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i) / num_heads_;
+            const int head_index = static_cast<int>(i) % num_heads_;
+            const int kv_head_index = head_index / kv_num_heads_factor;
+            const int total_seqlen = seqlens_k[batch_index] + 1;
+
+            T* output = attention_probs + SafeInt<ptrdiff_t>(i) * sequence_length * present_buffer_sequence_length;
+            const T* q = Q + packed_batch_stride * batch_index + q_input_chunk_length * head_index;
+
+            // Q*K' of the tokens of each block: (S x H) x (H x block_size)
+            for (int token_index = 0; token_index < total_seqlen; token_index += block_size) {
+              const T* k = GetPagedKVCacheToken(present_key, block_table, batch_index, kv_head_index, token_index,
+                                                parameters);
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasTrans, sequence_length,
+                                          std::min(block_size, total_seqlen - token_index), head_size, alpha, q,
+                                          head_size, k, head_size, 0.0f /*beta*/, output + token_index,
+                                          present_buffer_sequence_length, nullptr);
+            }
+
+            ComputeCausalSoftmax(output, sequence_length, total_seqlen, present_buffer_sequence_length);
+          }
+        });
+  }
+
+  // Helper function to compute attention_probs x V with the values of a paged kv cache, accumulating the product of
+  // each block: out(B, S, N, H_v) = attention_probs(B, N, S, T) x V(B, N, T, H_v)
+  template <typename T>
+  void ComputePagedVxAttentionScore(T* output,                                         // output with size BxSxNxH
+                                    const T* attention_probs,                          // probs with size BxNxSxT
+                                    const int32_t* seqlens_k,                          // past sequence lengths
+                                    const int32_t* block_table,                        // block table with size BxM
+                                    const T* present_value,                            // paged present value cache
+                                    int present_buffer_sequence_length,                // capacity of each sequence
+                                    const GroupQueryAttentionParameters& parameters,  // attention parameters
+                                    ThreadPool* tp) const {
+    const int sequence_length = parameters.sequence_length;
+    const int head_size = parameters.head_size;
+    const int hidden_size = parameters.hidden_size;
+    const int block_size = parameters.kv_cache_block_size;
+    const int kv_num_heads_factor = num_heads_ / kv_num_heads_;
+
+    TensorOpCost unit_cost;
+    unit_cost.compute_cycles =
+        static_cast<double>(SafeInt<ptrdiff_t>(2) * sequence_length * head_size * present_buffer_sequence_length);
+    unit_cost.bytes_loaded = static_cast<double>(SafeInt<ptrdiff_t>(sequence_length + head_size) *
+                                                 present_buffer_sequence_length * sizeof(T));
+    unit_cost.bytes_stored = static_cast<double>(sequence_length * head_size * sizeof(T));
+
+    ThreadPool::TryParallelFor(
+        tp, SafeInt<ptrdiff_t>(parameters.batch_size) * num_heads_, unit_cost,
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (std::ptrdiff_t i = begin; i != end; ++i) {
+            const int batch_index = static_cast<int>(i / num_heads_);
+            const int head_index = static_cast<int>(i % num_heads_);
+            const int kv_head_index = head_index / kv_num_heads_factor;
+            const int total_seqlen = seqlens_k[batch_index] + 1;
+
+            T* output_current = output + (batch_index * sequence_length * num_heads_ + head_index) * head_size;
+            const T* probs = attention_probs + SafeInt<ptrdiff_t>(sequence_length) * present_buffer_sequence_length * i;
+
+            // (S x block_size) x (block_size x H), accumulated over the blocks
+            for (int token_index = 0; token_index < total_seqlen; token_index += block_size) {
+              const T* v = GetPagedKVCacheToken(present_value, block_table, batch_index, kv_head_index, token_index,
+                                                parameters);
+              math::GemmEx<T, ThreadPool>(CblasNoTrans, CblasNoTrans, sequence_length, head_size,
+                                          std::min(block_size, total_seqlen - token_index), 1.f, /*alpha*/
+                                          probs + token_index, present_buffer_sequence_length, v, head_size,
+                                          token_index == 0 ? 0.0f : 1.0f /*beta*/, output_current, hidden_size,
+                                          nullptr);
+            }
+          }
+        });
   }
 
   template <typename T>
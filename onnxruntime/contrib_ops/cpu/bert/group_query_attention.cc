@@ -3,7 +3,6 @@
 
 #include "contrib_ops/cpu/bert/group_query_attention.h"
 #include "contrib_ops/cpu/bert/group_query_attention_helper.h"
-#include "contrib_ops/cpu/bert/rotary_helper.h"
 #include "contrib_ops/cpu/bert/attention_utils.h"
 #include "contrib_ops/cpu/bert/rotary_embedding.h"
 #include "contrib_ops/cpu/bert/rotary_embedding_helper.h"
@@ -30,6 +29,7 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     kCpuExecutionProvider,
     KernelDefBuilder()
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T_CACHE", BuildKernelDefConstraints<float, int8_t>())
         .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()),
     GroupQueryAttention<float>);
 
@@ -48,6 +48,9 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* block_table = context->Input<Tensor>(9);
+  const Tensor* past_key_scale = context->Input<Tensor>(10);
+  const Tensor* past_value_scale = context->Input<Tensor>(11);
 
   GroupQueryAttentionParameters parameters = {};
   constexpr float scale = 1.0f;
@@ -63,7 +66,19 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
                                                                 kv_num_heads_,
                                                                 seqlens_k,
                                                                 total_seqlen,
-                                                                scale));
+                                                                scale,
+                                                                block_table));
+
+  // A ring buffer kv cache keeps the sink tokens and the local window, whatever the total sequence length.
+  const bool ring_buffer_kv_cache = IsRingBufferKVCache();
+  if (ring_buffer_kv_cache) {
+    const int capacity = RingBufferKVCacheCapacity();
+    ORT_RETURN_IF(parameters.paged_kv_cache, "A ring buffer kv cache is not supported with a paged kv cache.");
+    ORT_RETURN_IF(past_key != nullptr && parameters.seqlen_past_kv_cache != capacity,
+                  "past_key and past_value shall hold num_sink_tokens + local_window_size + 1 = ", capacity,
+                  " tokens with a ring buffer kv cache, got ", parameters.seqlen_past_kv_cache);
+    parameters.seqlen_present_kv_cache = capacity;
+  }
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -80,9 +95,35 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
 
   std::vector<int64_t> present_k_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
   std::vector<int64_t> present_v_shape({static_cast<int64_t>(batch_size), static_cast<int64_t>(kv_num_heads_), static_cast<int64_t>(present_kv_seqlen), static_cast<int64_t>(head_size)});
+  if (parameters.paged_kv_cache) {
+    // The paged present kv cache is the past one with the new tokens written to their blocks.
+    present_k_shape.assign(past_key->Shape().GetDims().begin(), past_key->Shape().GetDims().end());
+    present_v_shape.assign(past_value->Shape().GetDims().begin(), past_value->Shape().GetDims().end());
+  }
   Tensor* present_k = context->Output(1, present_k_shape);
   Tensor* present_v = context->Output(2, present_v_shape);
 
+  // An int8 kv cache is quantized per token and kv head, its scales have the shape of the cache without head size.
+  const bool quantized_kv_cache = past_key != nullptr && past_key->IsDataType<int8_t>();
+  Tensor* present_k_scale = nullptr;
+  Tensor* present_v_scale = nullptr;
+  if (quantized_kv_cache) {
+    ORT_RETURN_IF_NOT(past_value->IsDataType<int8_t>(), "past_key and past_value shall both be int8 or neither.");
+    ORT_RETURN_IF(parameters.paged_kv_cache, "An int8 kv cache is not supported with a paged kv cache.");
+    ORT_RETURN_IF(ring_buffer_kv_cache, "An int8 kv cache is not supported with a ring buffer kv cache.");
+    const TensorShape past_scale_shape({batch_size, kv_num_heads_, parameters.seqlen_past_kv_cache});
+    ORT_RETURN_IF_NOT(past_key_scale != nullptr && past_value_scale != nullptr &&
+                          past_key_scale->Shape() == past_scale_shape && past_value_scale->Shape() == past_scale_shape,
+                      "past_key_scale and past_value_scale with shape ", past_scale_shape,
+                      " are required with an int8 kv cache.");
+    const TensorShape present_scale_shape({batch_size, kv_num_heads_, present_kv_seqlen});
+    present_k_scale = context->Output(3, present_scale_shape);
+    present_v_scale = context->Output(4, present_scale_shape);
+    ORT_RETURN_IF_NOT(present_k != nullptr && present_v != nullptr && present_k_scale != nullptr &&
+                          present_v_scale != nullptr,
+                      "present_key, present_value and their scales are required with an int8 kv cache.");
+  }
+
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
 
@@ -91,8 +132,11 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
   OrtValue K;
   OrtValue V;
   if (packed_qkv) {
-    ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
-        allocator, batch_size, num_heads_ + 2 * kv_num_heads_, sequence_length, head_size, query, Q));
+    // with rotary the packed QKV is transposed by the rotary embedding below
+    if (!do_rotary_) {
+      ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
+          allocator, batch_size, num_heads_ + 2 * kv_num_heads_, sequence_length, head_size, query, Q));
+    }
   } else {
     ORT_RETURN_IF_ERROR(MaybeTransposeToBNSH<T>(
         allocator, batch_size, num_heads_, sequence_length, head_size, query, Q));
@@ -113,7 +157,7 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
     rotary_params.max_sequence_length = sequence_length;  // unused
     rotary_params.seq_stride = head_size;
     rotary_params.head_stride = sequence_length * rotary_params.seq_stride;
-    rotary_params.batch_stride = (packed_qkv ? (num_heads_ + 2 * kv_num_heads_) : num_heads_) * rotary_params.head_stride;
+    rotary_params.batch_stride = num_heads_ * rotary_params.head_stride;
     rotary_params.position_ids_format = sequence_length == 1 ? 1 : 0;
     rotary_params.transposed = true;
     auto* tp = context->GetOperatorThreadPool();
@@ -125,61 +169,59 @@ Status GroupQueryAttention<T>::Compute(OpKernelContext* context) const {
     } else {
       pos_ids[0] = static_cast<int64_t>(0);
     }
-    const T* q_input;
-    const T* k_input;
-    T* q_rotary;
-    T* k_rotary;
     if (packed_qkv) {
+      // rotate Q and K, copy V and transpose them all to BNSH in a single pass over the packed QKV
       OrtValue RotaryQKV;
       Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_ + 2 * kv_num_heads_, sequence_length, head_size}), allocator, RotaryQKV);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = q_input + num_heads_ * sequence_length * head_size;
-      q_rotary = RotaryQKV.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = q_rotary + num_heads_ * sequence_length * head_size;
+      ORT_RETURN_IF_ERROR(RunRotaryEmbeddingPackedQKV<T>(tp, rotary_params, kv_num_heads_, query->Data<T>(),
+                                                         pos_ids.data(), cos_cache->Data<T>(),
+                                                         sin_cache->Data<T>(),
+                                                         RotaryQKV.GetMutable<Tensor>()->MutableData<T>(),
+                                                         rotary_interleaved_));
       Q = RotaryQKV;
     } else {
       OrtValue RotaryQ;
       Tensor::InitOrtValue(element_type, TensorShape({batch_size, num_heads_, sequence_length, head_size}), allocator, RotaryQ);
       OrtValue RotaryK;
       Tensor::InitOrtValue(element_type, TensorShape({batch_size, kv_num_heads_, sequence_length, head_size}), allocator, RotaryK);
-      q_input = Q.Get<Tensor>().Data<T>();
-      k_input = K.Get<Tensor>().Data<T>();
-      q_rotary = RotaryQ.GetMutable<Tensor>()->MutableData<T>();
-      k_rotary = RotaryK.GetMutable<Tensor>()->MutableData<T>();
-      Q = RotaryQ;
-      K = RotaryK;
-    }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, q_input,
-                                              pos_ids.data(), cos_cache->Data<T>(),
-                                              sin_cache->Data<T>(), q_rotary, rotary_interleaved_));
+      ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, Q.Get<Tensor>().Data<T>(),
+                                                pos_ids.data(), cos_cache->Data<T>(),
+                                                sin_cache->Data<T>(), RotaryQ.GetMutable<Tensor>()->MutableData<T>(),
+                                                rotary_interleaved_));
 
-    rotary_params.num_heads = kv_num_heads_;
-    rotary_params.hidden_size = parameters.kv_hidden_size;
-    if (!packed_qkv) {
+      rotary_params.num_heads = kv_num_heads_;
+      rotary_params.hidden_size = parameters.kv_hidden_size;
       rotary_params.batch_stride = kv_num_heads_ * rotary_params.head_stride;
-    }
-    ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, k_input,
-                                              pos_ids.data(), cos_cache->Data<T>(),
-                                              sin_cache->Data<T>(), k_rotary, rotary_interleaved_));
-    if (packed_qkv) {
-      const T* v_input = k_input + kv_num_heads_ * sequence_length * head_size;
-      T* v_rotary = k_rotary + kv_num_heads_ * sequence_length * head_size;
-      ORT_RETURN_IF_ERROR(rotary_helper::PackVIntoRotaryQKV<T>(tp,
-                                                               parameters.batch_size,
-                                                               parameters.sequence_length,
-                                                               parameters.num_heads,
-                                                               parameters.kv_num_heads,
-                                                               parameters.head_size,
-                                                               v_input,
-                                                               v_rotary));
+      ORT_RETURN_IF_ERROR(RunRotaryEmbedding<T>(tp, rotary_params, K.Get<Tensor>().Data<T>(),
+                                                pos_ids.data(), cos_cache->Data<T>(),
+                                                sin_cache->Data<T>(), RotaryK.GetMutable<Tensor>()->MutableData<T>(),
+                                                rotary_interleaved_));
+      Q = RotaryQ;
+      K = RotaryK;
     }
   }
 
   ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  if (quantized_kv_cache) {
+    return ApplyQuantizedKVAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
+                                     packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), *past_key, *past_value,
+                                     *past_key_scale, *past_value_scale, *output, *present_k, *present_v,
+                                     *present_k_scale, *present_v_scale, *seqlens_k, parameters,
+                                     context->GetOperatorThreadPool());
+  }
+
+  if (ring_buffer_kv_cache) {
+    ORT_RETURN_IF(present_k == nullptr || present_v == nullptr,
+                  "present_key and present_value are required with a ring buffer kv cache.");
+    return ApplyRingBufferAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
+                                    packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, *output,
+                                    *present_k, *present_v, *seqlens_k, parameters, context->GetOperatorThreadPool());
+  }
+
   // Compute the attention score and apply the score to V
   return ApplyAttention(Q.Get<Tensor>().Data<T>(), packed_qkv ? nullptr : K.Get<Tensor>().Data<T>(),
                         packed_qkv ? nullptr : V.Get<Tensor>().Data<T>(), past_key, past_value, output, present_k, present_v,
-                        seqlens_k, parameters, allocator, context);
+                        seqlens_k, block_table, parameters, allocator, context);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -23,10 +23,15 @@ Status CheckInputs(const Tensor* query,
                    int kv_num_heads,
                    const Tensor* seqlens_k,
                    const Tensor* total_seqlen,
-                   float scale) {
+                   float scale,
+                   const Tensor* block_table = nullptr) {
   // Note: Here S* is seqlen_past_kv_cache, S+ is seqlen_present_kv_cache
   //     past_key                   : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
   //     past_value                 : (B, N_k, S*, H) or (B, N_k, S+, H) or nullptr
+  // paged kv-cache, where P is the number of blocks and S_b the number of tokens per block:
+  //     past_key                   : (P, N_k, S_b, H)
+  //     past_value                 : (P, N_k, S_b, H)
+  //     block_table                : (B, max_blocks_per_sequence)
   // no packing for q/k/v:
   //     query            (Q)       : (B, S, D) or (B, S, (D_q + 2 D_kv))
   //     key              (K)       : (B, S, D_kv) or nullptr
@@ -124,12 +129,18 @@ Status CheckInputs(const Tensor* query,
                              past_value_dims.size());
     }
 
-    if (past_key_dims[0] != batch_size) {
+    if (block_table != nullptr) {
+      if (past_key_dims[0] != past_value_dims[0]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Paged Input 'past_key' and 'past_value' should have same dimension 0 (number of "
+                               "blocks), got ",
+                               past_key_dims[0], " and ", past_value_dims[0]);
+      }
+    } else if (past_key_dims[0] != batch_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'past_key' dimension 0 should be batch_size, got ",
                              past_key_dims[0]);
-    }
-    if (past_value_dims[0] != batch_size) {
+    } else if (past_value_dims[0] != batch_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'past_value' dimension 0 should be batch_size, got ",
                              past_value_dims[0]);
@@ -167,6 +178,27 @@ Status CheckInputs(const Tensor* query,
                            "Input 'past_key' and 'past_value' shall be both present or both absent.");
   }
 
+  // Check block_table tensor (mapping the tokens of each sequence to blocks of the paged kv-cache)
+  int kv_cache_block_size = 0;
+  int num_kv_cache_blocks = 0;
+  int max_blocks_per_sequence = 0;
+  if (block_table != nullptr) {
+    if (past_key == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' shall be present when 'block_table' is present.");
+    }
+    const auto& block_table_dims = block_table->Shape().GetDims();
+    if (block_table_dims.size() != 2 || block_table_dims[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "block_table must be shape (batch_size, max_blocks_per_sequence).");
+    }
+    kv_cache_block_size = past_sequence_length;
+    num_kv_cache_blocks = static_cast<int>(past_key->Shape().GetDims()[0]);
+    max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+    // Each sequence can hold as many tokens as there are entries for it in the block table.
+    past_sequence_length = kv_cache_block_size * max_blocks_per_sequence;
+  }
+
   // Check seqlens_k tensor (holding past seqlen for token gen)
   const auto& seqlens_dim = seqlens_k->Shape().GetDims();
   if (seqlens_dim.size() != 1 && seqlens_dim[0] != batch_size) {
@@ -180,6 +212,11 @@ Status CheckInputs(const Tensor* query,
                            "total_sequence_length tensor must be of one element.");
   }
   int total_sequence_length = *((*total_seqlen).template Data<int32_t>());
+  if (block_table != nullptr && total_sequence_length > past_sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "total_sequence_length ", total_sequence_length,
+                           " exceeds the capacity of the block table of ", past_sequence_length, " tokens.");
+  }
   int present_sequence_length = std::max(total_sequence_length, past_sequence_length);
 
   int rotary_dim = 0;
@@ -238,6 +275,10 @@ Status CheckInputs(const Tensor* query,
     output_parameters->scale = scale;
     output_parameters->qkv_format = qkv_format;
     output_parameters->past_kv_format = past_kv_format;
+    output_parameters->paged_kv_cache = block_table != nullptr;
+    output_parameters->kv_cache_block_size = kv_cache_block_size;
+    output_parameters->num_kv_cache_blocks = num_kv_cache_blocks;
+    output_parameters->max_blocks_per_sequence = max_blocks_per_sequence;
   }
 
   return Status::OK();
@@ -145,21 +145,56 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
   ORT_RETURN_IF_ERROR(MaybeTransposeToBNSHAndAddBias<T>(
       context, allocator, batch_size, num_heads_, kv_sequence_length, v_head_size, value, bias, v_bias_offset, V));
 
+  // The kernel attends to the past and new keys and values in the present state, so the present state is needed
+  // when there is a past. The causal mask of the kernel assumes that the queries are the new keys.
+  const bool has_past = past_key != nullptr || past_value != nullptr;
+  const bool has_present = present_k != nullptr || present_v != nullptr;
+  const bool use_present = present_k != nullptr && present_v != nullptr &&
+                           (past_key == nullptr) == (past_value == nullptr);
   if (std::is_same_v<T, float> &&
       !disable_flash_ &&
-      !is_unidirectional_ &&
+      (!is_unidirectional_ || q_sequence_length == kv_sequence_length) &&
       key_padding_mask == nullptr &&
       extra_add_qk == nullptr &&
-      past_key == nullptr &&
-      past_value == nullptr &&
-      present_k == nullptr &&
-      present_v == nullptr &&
+      ((!has_past && !has_present) || use_present) &&
       l2_cache_size_ > 0) {
+    const float* k = K.Get<Tensor>().Data<float>();
+    const float* v = V.Get<Tensor>().Data<float>();
+    int flash_kv_sequence_length = kv_sequence_length;
+    if (use_present) {
+      // Append the new keys and values to the past ones in the present state (B x N x T x H).
+      const int past_sequence_length = total_kv_sequence_length - kv_sequence_length;
+      const float* past_k = past_key != nullptr ? past_key->Data<float>() : nullptr;
+      const float* past_v = past_value != nullptr ? past_value->Data<float>() : nullptr;
+      float* present_k_data = present_k->MutableData<float>();
+      float* present_v_data = present_v->MutableData<float>();
+      TensorOpCost unit_cost;
+      unit_cost.bytes_loaded = static_cast<double>(SafeInt<size_t>(total_kv_sequence_length) *
+                                                   (qk_head_size + v_head_size) * sizeof(float));
+      unit_cost.bytes_stored = unit_cost.bytes_loaded;
+      unit_cost.compute_cycles = 0;
+      ThreadPool::TryParallelFor(
+          context->GetOperatorThreadPool(), SafeInt<ptrdiff_t>(batch_size) * num_heads_, unit_cost,
+          [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            for (std::ptrdiff_t i = begin; i != end; ++i) {
+              ConcatStateChunk(past_k, k + i * kv_sequence_length * qk_head_size, present_k_data,
+                               static_cast<size_t>(past_sequence_length) * qk_head_size,
+                               static_cast<size_t>(total_kv_sequence_length) * qk_head_size, i);
+              ConcatStateChunk(past_v, v + i * kv_sequence_length * v_head_size, present_v_data,
+                               static_cast<size_t>(past_sequence_length) * v_head_size,
+                               static_cast<size_t>(total_kv_sequence_length) * v_head_size, i);
+            }
+          });
+      k = present_k_data;
+      v = present_v_data;
+      flash_kv_sequence_length = total_kv_sequence_length;
+    }
+
     MlasFlashAttentionThreadedArgs args;
     args.batch_size = batch_size;
     args.num_heads = num_heads_;
     args.q_sequence_length = q_sequence_length;
-    args.kv_sequence_length = kv_sequence_length;
+    args.kv_sequence_length = flash_kv_sequence_length;
     args.qk_head_size = qk_head_size;
     args.v_head_size = v_head_size;
     args.scale = (scale_ == 0.0f) ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
@@ -186,7 +221,7 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
     args.kv_block_size = l2_cache_size_ / (static_cast<int>(sizeof(float)) * 4 * (qk_head_size + v_head_size));
     args.kv_block_size = std::max(args.kv_block_size, 1);  // avoid kv_block_size = 0
     args.q_block_size = std::min(args.kv_block_size, qk_head_size + v_head_size);
-    args.kv_block_size = std::min(args.kv_block_size, kv_sequence_length);  // No point to have kv_block_size > kv_sequence_length
+    args.kv_block_size = std::min(args.kv_block_size, flash_kv_sequence_length);  // No point to have kv_block_size > kv_sequence_length
     args.q_block_size = std::min(args.q_block_size, q_sequence_length);     // No point to have q_block_size > q_sequence_length
 
     auto* tp = context->GetOperatorThreadPool();
@@ -201,9 +236,10 @@ Status MultiHeadAttention<T>::Compute(OpKernelContext* context) const {
     args.buffer = reinterpret_cast<float*>(buffer.get());
 
     args.query = Q.Get<Tensor>().Data<float>();
-    args.key = K.Get<Tensor>().Data<float>();
-    args.value = V.Get<Tensor>().Data<float>();
+    args.key = k;
+    args.value = v;
     args.output = output->MutableData<float>();
+    args.is_causal = is_unidirectional_;
 
     MlasFlashAttention(&args, tp);
     return Status::OK();
@@ -4,6 +4,7 @@
 #include "contrib_ops/cpu/bert/rotary_embedding.h"
 #include "contrib_ops/cpu/bert/rotary_embedding_helper.h"
 
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 
 using onnxruntime::concurrency::ThreadPool;
@@ -74,21 +75,8 @@ Status RunRotaryEmbedding(concurrency::ThreadPool* tp, RotaryParameters paramete
       const T* cos_data = cos_cache + cache_offset;
       const T* sin_data = sin_cache + cache_offset;
 
-      int cache_idx = 0;
-      T sign = 0;
-      int j = 0;
-      for (int i = 0; i < rotary_emb_dim; i++) {
-        if (interleaved) {
-          cache_idx = (i / 2) % half_rotary_emb_dim;
-          sign = (i % 2 == 0) ? static_cast<T>(-1) : static_cast<T>(1);
-          j = (i % 2 == 0) ? i + 1 : i - 1;  // i - sign
-        } else {
-          cache_idx = i % half_rotary_emb_dim;
-          sign = (i < half_rotary_emb_dim) ? static_cast<T>(-1) : static_cast<T>(1);
-          j = (i + half_rotary_emb_dim) % rotary_emb_dim;
-        }
-        output_data[i] = input_data[i] * cos_data[cache_idx] + sign * input_data[j] * sin_data[cache_idx];
-      }
+      MlasRotaryEmbedOneRow(input_data, cos_data, sin_data, static_cast<size_t>(rotary_emb_dim), interleaved,
+                            output_data);
       for (int i = rotary_emb_dim; i < head_size; i++) {
         output_data[i] = input_data[i];
       }
@@ -102,6 +90,56 @@ template Status RunRotaryEmbedding<float>(concurrency::ThreadPool* tp, RotaryPar
                                           const int64_t* position_ids, const float* cos_cache, const float* sin_cache, float* output,
                                           bool interleaved);
 
+template <typename T>
+Status RunRotaryEmbeddingPackedQKV(concurrency::ThreadPool* tp, RotaryParameters parameters, int kv_num_heads,
+                                   const T* packed_qkv, const int64_t* position_ids, const T* cos_cache,
+                                   const T* sin_cache, T* output, bool interleaved) {
+  const int batch_size = parameters.batch_size;
+  const int sequence_length = parameters.sequence_length;
+  const int num_heads = parameters.num_heads;
+  const int head_size = parameters.head_size;
+  const int position_ids_format = parameters.position_ids_format;
+  const int rotary_emb_dim = parameters.rotary_embedding_dim;
+  const int half_rotary_emb_dim = rotary_emb_dim / 2;
+  const int total_num_heads = num_heads + 2 * kv_num_heads;
+
+  // Every head of a token is read from (B, S, N, H) and written to (B, N, S, H), the value heads are only copied.
+  const int loop_len = batch_size * sequence_length * total_num_heads;
+  const double cost = static_cast<double>(head_size);
+  ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t ptr = begin; ptr != end; ++ptr) {
+      const int b = static_cast<int>((ptr / total_num_heads) / sequence_length);
+      const int s = static_cast<int>((ptr / total_num_heads) % sequence_length);
+      const int n = static_cast<int>(ptr % total_num_heads);
+
+      const T* input_data = packed_qkv + ptr * head_size;
+      T* output_data = output + ((static_cast<std::ptrdiff_t>(b) * total_num_heads + n) * sequence_length + s) *
+                                    head_size;
+
+      int copy_begin = 0;
+      if (n < num_heads + kv_num_heads) {
+        const int position_id = (position_ids_format == 0)
+                                    ? static_cast<int>(position_ids[0]) + s
+                                    : static_cast<int>(position_ids[b * sequence_length + s]);
+        const int cache_offset = position_id * half_rotary_emb_dim;
+        MlasRotaryEmbedOneRow(input_data, cos_cache + cache_offset, sin_cache + cache_offset,
+                              static_cast<size_t>(rotary_emb_dim), interleaved, output_data);
+        copy_begin = rotary_emb_dim;
+      }
+      for (int i = copy_begin; i < head_size; i++) {
+        output_data[i] = input_data[i];
+      }
+    }
+  });
+
+  return Status::OK();
+}
+
+template Status RunRotaryEmbeddingPackedQKV<float>(concurrency::ThreadPool* tp, RotaryParameters parameters,
+                                                   int kv_num_heads, const float* packed_qkv,
+                                                   const int64_t* position_ids, const float* cos_cache,
+                                                   const float* sin_cache, float* output, bool interleaved);
+
 template <typename T>
 Status RotaryEmbedding<T>::Compute(OpKernelContext* context) const {
   const Tensor* input = context->Input<Tensor>(0);
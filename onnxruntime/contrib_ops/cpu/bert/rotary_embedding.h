@@ -14,6 +14,15 @@ Status RunRotaryEmbedding(onnxruntime::concurrency::ThreadPool* tp, rotary_embed
                           const int64_t* position_ids, const T* cos_cache, const T* sin_cache, T* output,
                           bool interleaved);
 
+// Applies the rotary embedding to the query and key heads of a packed QKV input of shape
+// (batch_size, sequence_length, (num_heads + 2 * kv_num_heads) * head_size) and transposes them with the value
+// heads to (batch_size, num_heads + 2 * kv_num_heads, sequence_length, head_size), all in one pass.
+template <typename T>
+Status RunRotaryEmbeddingPackedQKV(onnxruntime::concurrency::ThreadPool* tp,
+                                   rotary_embedding_helper::RotaryParameters parameters, int kv_num_heads,
+                                   const T* packed_qkv, const int64_t* position_ids, const T* cos_cache,
+                                   const T* sin_cache, T* output, bool interleaved);
+
 template <typename T>
 class RotaryEmbedding final : public OpKernel {
  public:
@@ -5,45 +5,55 @@
 
 namespace onnxruntime {
 
+common::Status GetFusedActivation(const std::string& activation_type, gsl::span<const float> activation_params,
+                                  MLAS_ACTIVATION& activation) {
+  activation.ActivationKind = MlasIdentityActivation;
+
+  if (activation_type.empty()) {
+    return Status::OK();
+  } else if (activation_type == "Relu") {
+    activation.ActivationKind = MlasReluActivation;
+  } else if (activation_type == "Tanh") {
+    activation.ActivationKind = MlasTanhActivation;
+  } else if (activation_type == "Sigmoid") {
+    activation.ActivationKind = MlasLogisticActivation;
+  } else {
+    // The remaining activation types have additional parameters to be pulled out.
+    size_t activation_params_count;
+    if (activation_type == "LeakyRelu") {
+      activation.ActivationKind = MlasLeakyReluActivation;
+      activation_params_count = 1;
+    } else if (activation_type == "Clip") {
+      activation.ActivationKind = MlasClipActivation;
+      activation_params_count = 2;
+    } else if (activation_type == "HardSigmoid") {
+      activation.ActivationKind = MlasHardSigmoidActivation;
+      activation_params_count = 2;
+    } else {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "unimplemented activation: " + activation_type);
+    }
+
+    if (activation_params.size() < activation_params_count) {
+      return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "activation_params count mismatch");
+    }
+    for (size_t i = 0; i < activation_params_count; i++) {
+      activation.Parameters.Values[i] = activation_params[i];
+    }
+  }
+
+  return Status::OK();
+}
+
 common::Status GetFusedActivationAttr(const OpKernelInfo& info, MLAS_ACTIVATION& activation) {
   // Convert the activation parameters from the node into a MLAS_ACTIVATION.
   activation.ActivationKind = MlasIdentityActivation;
 
   std::string activation_type;
   if (info.GetAttr<std::string>("activation", &activation_type).IsOK()) {
-    if (activation_type == "Relu") {
-      activation.ActivationKind = MlasReluActivation;
-    } else if (activation_type == "Tanh") {
-      activation.ActivationKind = MlasTanhActivation;
-    } else if (activation_type == "Sigmoid") {
-      activation.ActivationKind = MlasLogisticActivation;
-    } else {
-      // The remaining activation types have additional parameters to be pulled out.
-      size_t activation_params_count;
-      if (activation_type == "LeakyRelu") {
-        activation.ActivationKind = MlasLeakyReluActivation;
-        activation_params_count = 1;
-      } else if (activation_type == "Clip") {
-        activation.ActivationKind = MlasClipActivation;
-        activation_params_count = 2;
-      } else if (activation_type == "HardSigmoid") {
-        activation.ActivationKind = MlasHardSigmoidActivation;
-        activation_params_count = 2;
-      } else {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "unimplemented activation: " + activation_type);
-      }
-
-      std::vector<float> activation_params;
-      common::Status status = info.GetAttrs<float>("activation_params", activation_params);
-      if (!status.IsOK()) {
-        return status;
-      } else if (activation_params_count != activation_params.size()) {
-        return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "activation_params count mismatch");
-      }
-      for (size_t i = 0; i < activation_params_count; i++) {
-        activation.Parameters.Values[i] = activation_params[i];
-      }
-    }
+    // The activation parameters are optional for the activation types without parameters.
+    std::vector<float> activation_params;
+    ORT_IGNORE_RETURN_VALUE(info.GetAttrs<float>("activation_params", activation_params));
+    return GetFusedActivation(activation_type, activation_params, activation);
   }
 
   return Status::OK();
@@ -9,6 +9,11 @@
 
 namespace onnxruntime {
 
+// Converts a fused activation, e.g. "LeakyRelu", and its parameters into a MLAS_ACTIVATION. An empty type is the
+// identity. activation_params may hold more values than the activation uses.
+common::Status GetFusedActivation(const std::string& activation_type, gsl::span<const float> activation_params,
+                                  MLAS_ACTIVATION& activation);
+
 common::Status GetFusedActivationAttr(const OpKernelInfo& info, MLAS_ACTIVATION& activation);
 
 }  // namespace onnxruntime
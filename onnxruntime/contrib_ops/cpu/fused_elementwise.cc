@@ -0,0 +1,299 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+enum class ElementwiseOp {
+  Add,
+  Sub,
+  Mul,
+  Div,
+  Abs,
+  Erf,
+  Exp,
+  Neg,
+  Reciprocal,
+  Relu,
+  Sigmoid,
+  Sqrt,
+  Tanh,
+};
+
+bool ParseElementwiseOp(const std::string& op_type, ElementwiseOp& op) {
+  static const std::unordered_map<std::string, ElementwiseOp> ops{
+      {"Add", ElementwiseOp::Add},
+      {"Sub", ElementwiseOp::Sub},
+      {"Mul", ElementwiseOp::Mul},
+      {"Div", ElementwiseOp::Div},
+      {"Abs", ElementwiseOp::Abs},
+      {"Erf", ElementwiseOp::Erf},
+      {"Exp", ElementwiseOp::Exp},
+      {"Neg", ElementwiseOp::Neg},
+      {"Reciprocal", ElementwiseOp::Reciprocal},
+      {"Relu", ElementwiseOp::Relu},
+      {"Sigmoid", ElementwiseOp::Sigmoid},
+      {"Sqrt", ElementwiseOp::Sqrt},
+      {"Tanh", ElementwiseOp::Tanh},
+  };
+
+  auto it = ops.find(op_type);
+  if (it == ops.end()) {
+    return false;
+  }
+
+  op = it->second;
+  return true;
+}
+
+bool IsBinary(ElementwiseOp op) {
+  return op == ElementwiseOp::Add || op == ElementwiseOp::Sub || op == ElementwiseOp::Mul || op == ElementwiseOp::Div;
+}
+
+// Computes an operator on a block of elements. b is unused by unary operators.
+using StepFunction = void (*)(const float* a, const float* b, float* output, size_t count);
+
+struct AddOp {
+  float operator()(float x, float y) const { return x + y; }
+};
+struct SubOp {
+  float operator()(float x, float y) const { return x - y; }
+};
+struct MulOp {
+  float operator()(float x, float y) const { return x * y; }
+};
+struct DivOp {
+  float operator()(float x, float y) const { return x / y; }
+};
+struct AbsOp {
+  float operator()(float x) const { return std::abs(x); }
+};
+struct NegOp {
+  float operator()(float x) const { return -x; }
+};
+struct ReciprocalOp {
+  float operator()(float x) const { return 1.0f / x; }
+};
+struct ReluOp {
+  float operator()(float x) const { return std::max(x, 0.0f); }
+};
+struct SqrtOp {
+  float operator()(float x) const { return std::sqrt(x); }
+};
+
+// a scalar operand is broadcast to all elements of the block. the loops have no branches, so they are vectorized.
+template <typename Op, bool IsAScalar, bool IsBScalar>
+void BinaryStep(const float* a, const float* b, float* output, size_t count) {
+  const Op op;
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = op(IsAScalar ? *a : a[i], IsBScalar ? *b : b[i]);
+  }
+}
+
+template <typename Op>
+void UnaryStep(const float* a, const float* /*b*/, float* output, size_t count) {
+  const Op op;
+  for (size_t i = 0; i < count; ++i) {
+    output[i] = op(a[i]);
+  }
+}
+
+void ErfStep(const float* a, const float* /*b*/, float* output, size_t count) { MlasComputeErf(a, output, count); }
+void ExpStep(const float* a, const float* /*b*/, float* output, size_t count) { MlasComputeExp(a, output, count); }
+void SigmoidStep(const float* a, const float* /*b*/, float* output, size_t count) {
+  MlasComputeLogistic(a, output, count);
+}
+void TanhStep(const float* a, const float* /*b*/, float* output, size_t count) { MlasComputeTanh(a, output, count); }
+
+template <typename Op>
+StepFunction GetBinaryStep(bool is_a_scalar, bool is_b_scalar) {
+  // an operator on two scalars computes a single element, so it doesn't need to broadcast
+  if (is_a_scalar && !is_b_scalar) {
+    return BinaryStep<Op, true, false>;
+  }
+  if (is_b_scalar && !is_a_scalar) {
+    return BinaryStep<Op, false, true>;
+  }
+  return BinaryStep<Op, false, false>;
+}
+
+StepFunction GetStepFunction(ElementwiseOp op, bool is_a_scalar, bool is_b_scalar) {
+  switch (op) {
+    case ElementwiseOp::Add:
+      return GetBinaryStep<AddOp>(is_a_scalar, is_b_scalar);
+    case ElementwiseOp::Sub:
+      return GetBinaryStep<SubOp>(is_a_scalar, is_b_scalar);
+    case ElementwiseOp::Mul:
+      return GetBinaryStep<MulOp>(is_a_scalar, is_b_scalar);
+    case ElementwiseOp::Div:
+      return GetBinaryStep<DivOp>(is_a_scalar, is_b_scalar);
+    case ElementwiseOp::Abs:
+      return UnaryStep<AbsOp>;
+    case ElementwiseOp::Erf:
+      return ErfStep;
+    case ElementwiseOp::Exp:
+      return ExpStep;
+    case ElementwiseOp::Neg:
+      return UnaryStep<NegOp>;
+    case ElementwiseOp::Reciprocal:
+      return UnaryStep<ReciprocalOp>;
+    case ElementwiseOp::Relu:
+      return UnaryStep<ReluOp>;
+    case ElementwiseOp::Sigmoid:
+      return SigmoidStep;
+    case ElementwiseOp::Sqrt:
+      return UnaryStep<SqrtOp>;
+    case ElementwiseOp::Tanh:
+      return TanhStep;
+  }
+
+  ORT_THROW("Unsupported operator in FusedElementwise.");
+}
+}  // namespace
+
+// Computes a chain of elementwise operators block by block, so each block of the inputs is read once and the
+// intermediate values stay in a small buffer in the cache instead of being written to memory.
+class FusedElementwise final : public OpKernel {
+ public:
+  explicit FusedElementwise(const OpKernelInfo& info) : OpKernel(info) {
+    const auto op_types = info.GetAttrsOrDefault<std::string>("ops");
+    const auto op_inputs = info.GetAttrsOrDefault<int64_t>("op_inputs");
+    ORT_ENFORCE(!op_types.empty(), "FusedElementwise requires at least one operator.");
+    ORT_ENFORCE(op_inputs.size() == 2 * op_types.size(), "FusedElementwise requires two op_inputs per operator.");
+
+    num_inputs_ = info.GetInputCount();
+    steps_.reserve(op_types.size());
+    for (size_t i = 0; i < op_types.size(); ++i) {
+      Step step;
+      ORT_ENFORCE(ParseElementwiseOp(op_types[i], step.op), "Unsupported operator in FusedElementwise: ",
+                  op_types[i]);
+      step.a = op_inputs[2 * i];
+      step.b = op_inputs[2 * i + 1];
+
+      // the operators can only read the inputs and the results of the operators before them
+      const auto num_values = static_cast<int64_t>(num_inputs_ + i);
+      ORT_ENFORCE(step.a >= 0 && step.a < num_values, "Invalid input ", step.a, " of operator ", i);
+      if (IsBinary(step.op)) {
+        ORT_ENFORCE(step.b >= 0 && step.b < num_values, "Invalid input ", step.b, " of operator ", i);
+      } else {
+        ORT_ENFORCE(step.b == -1, "Unary operator ", i, " must have -1 as its second input.");
+      }
+
+      steps_.push_back(step);
+    }
+  }
+
+  Status Compute(OpKernelContext* context) const override {
+    const Tensor* first_input = context->Input<Tensor>(0);
+    const TensorShape& shape = first_input->Shape();
+
+    // which values are scalars only depends on the inputs, so the function of each operator is selected once per run
+    // instead of for each block
+    InlinedVector<const float*> input_data;
+    InlinedVector<bool> is_scalar_value;
+    input_data.reserve(num_inputs_);
+    is_scalar_value.reserve(num_inputs_ + steps_.size());
+    for (size_t i = 0; i < num_inputs_; ++i) {
+      const Tensor* input = context->Input<Tensor>(static_cast<int>(i));
+      const bool is_scalar = input->Shape() != shape;
+      ORT_RETURN_IF(is_scalar && input->Shape().Size() != 1, "Input ", i, " of FusedElementwise has shape ",
+                    input->Shape(), " which neither matches the shape ", shape, " nor has a single element.");
+      input_data.push_back(input->Data<float>());
+      is_scalar_value.push_back(is_scalar);
+    }
+
+    InlinedVector<PlannedStep> plan;
+    plan.reserve(steps_.size());
+    for (const Step& step : steps_) {
+      const size_t a = narrow<size_t>(step.a);
+      const size_t b = step.b == -1 ? a : narrow<size_t>(step.b);
+      // the result of an operator on scalars is a scalar
+      const bool is_scalar = is_scalar_value[a] && is_scalar_value[b];
+      plan.push_back({GetStepFunction(step.op, is_scalar_value[a], is_scalar_value[b]), a, b, is_scalar});
+      is_scalar_value.push_back(is_scalar);
+    }
+
+    Tensor* output = context->Output(0, shape);
+    float* output_data = output->MutableData<float>();
+    const auto num_elements = shape.Size();
+    if (num_elements == 0) {
+      return Status::OK();
+    }
+
+    const size_t num_steps = plan.size();
+    TensorOpCost cost{static_cast<double>(num_inputs_ * sizeof(float)), static_cast<double>(sizeof(float)),
+                      static_cast<double>(num_steps * 4)};
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), num_elements, cost,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          // one block for the result of each operator except the last one, which is written to the output
+          std::vector<float> buffer((num_steps - 1) * kBlockSize);
+          InlinedVector<const float*> values(num_inputs_ + num_steps);
+
+          for (std::ptrdiff_t start = first; start < last; start += kBlockSize) {
+            const size_t count = static_cast<size_t>(std::min<std::ptrdiff_t>(kBlockSize, last - start));
+            for (size_t i = 0; i < num_inputs_; ++i) {
+              values[i] = is_scalar_value[i] ? input_data[i] : input_data[i] + start;
+            }
+
+            for (size_t i = 0; i < num_steps; ++i) {
+              const PlannedStep& step = plan[i];
+              const bool is_output = i + 1 == num_steps;
+              float* result = is_output ? output_data + start : buffer.data() + i * kBlockSize;
+              step.function(values[step.a], values[step.b], result, step.is_scalar ? 1 : count);
+              if (is_output && step.is_scalar) {
+                std::fill_n(result + 1, count - 1, *result);
+              }
+
+              values[num_inputs_ + i] = result;
+            }
+          }
+        });
+
+    return Status::OK();
+  }
+
+ private:
+  static constexpr std::ptrdiff_t kBlockSize = 1024;
+
+  struct Step {
+    ElementwiseOp op;
+    // the indices of the values read by the operator. see the schema.
+    int64_t a;
+    int64_t b;
+  };
+
+  // an operator with the function selected for the inputs of a run
+  struct PlannedStep {
+    StepFunction function;
+    size_t a;
+    size_t b;
+    bool is_scalar;
+  };
+
+  size_t num_inputs_;
+  std::vector<Step> steps_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    FusedElementwise,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    FusedElementwise);
+
+}  // namespace contrib
+}  // namespace onnxruntime
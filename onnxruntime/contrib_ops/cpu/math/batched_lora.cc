@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Applies a per batch entry low-rank adapter. Consecutive batch entries using the same adapter form one segment and
+// the segments of each of the two low-rank GEMMs run as a single grouped MLAS GEMM.
+class BatchedLoRA final : public OpKernel {
+ public:
+  explicit BatchedLoRA(const OpKernelInfo& info) : OpKernel(info) {
+    scaling_ = info.GetAttrOrDefault<float>("scaling", 1.0f);
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  float scaling_;
+};
+
+ONNX_OPERATOR_KERNEL_EX(
+    BatchedLoRA,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("I", DataTypeImpl::GetTensorType<int32_t>()),
+    BatchedLoRA);
+
+Status BatchedLoRA::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* lora_a = context->Input<Tensor>(1);
+  const Tensor* lora_b = context->Input<Tensor>(2);
+  const Tensor* adapter_ids = context->Input<Tensor>(3);
+  const Tensor* base = context->Input<Tensor>(4);
+
+  const auto& input_shape = input->Shape();
+  const auto& lora_a_shape = lora_a->Shape();
+  const auto& lora_b_shape = lora_b->Shape();
+  const size_t input_rank = input_shape.NumDimensions();
+  ORT_RETURN_IF_NOT(input_rank >= 2, "input is expected to have at least 2 dimensions, got ", input_rank);
+  ORT_RETURN_IF_NOT(lora_a_shape.NumDimensions() == 3 && lora_b_shape.NumDimensions() == 3,
+                    "lora_A and lora_B are expected to have 3 dimensions");
+
+  const int64_t batch_size = input_shape[0];
+  const int64_t hidden_size = input_shape[input_rank - 1];
+  const int64_t num_adapters = lora_a_shape[0];
+  const int64_t lora_rank = lora_a_shape[2];
+  const int64_t output_size = lora_b_shape[2];
+  ORT_RETURN_IF_NOT(lora_a_shape[1] == hidden_size, "lora_A dimension 1 must be ", hidden_size, ", got ",
+                    lora_a_shape[1]);
+  ORT_RETURN_IF_NOT(lora_b_shape[0] == num_adapters && lora_b_shape[1] == lora_rank,
+                    "lora_B shape ", lora_b_shape, " does not match lora_A shape ", lora_a_shape);
+  ORT_RETURN_IF_NOT(adapter_ids->Shape().Size() == batch_size,
+                    "adapter_ids must have one entry per batch entry, got ", adapter_ids->Shape());
+
+  TensorShapeVector output_dims = input_shape.AsShapeVector();
+  output_dims.back() = output_size;
+  Tensor* output = context->Output(0, output_dims);
+  ORT_RETURN_IF_NOT(base == nullptr || base->Shape() == output->Shape(),
+                    "base shape ", (base != nullptr ? base->Shape() : TensorShape{}), " must be ", output->Shape());
+
+  if (output->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  // the entries without an adapter keep the base, the adapters accumulate into it
+  float* output_data = output->MutableData<float>();
+  const size_t output_count = narrow<size_t>(output->Shape().Size());
+  if (base != nullptr) {
+    std::memcpy(output_data, base->Data<float>(), output_count * sizeof(float));
+  } else {
+    std::fill_n(output_data, output_count, 0.0f);
+  }
+
+  const int32_t* ids = adapter_ids->Data<int32_t>();
+  const size_t rows_per_entry = narrow<size_t>(input_shape.Slice(1, input_rank - 1).Size());
+  const size_t K = narrow<size_t>(hidden_size);
+  const size_t R = narrow<size_t>(lora_rank);
+  const size_t N = narrow<size_t>(output_size);
+  if (rows_per_entry == 0 || R == 0) {
+    return Status::OK();
+  }
+
+  const float* input_data = input->Data<float>();
+  const float* lora_a_data = lora_a->Data<float>();
+  const float* lora_b_data = lora_b->Data<float>();
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+  auto intermediate = IAllocator::MakeUniquePtr<float>(allocator, narrow<size_t>(batch_size) * rows_per_entry * R);
+
+  std::vector<MLAS_SGEMM_GROUP_PARAMS> down_groups;
+  std::vector<MLAS_SGEMM_GROUP_PARAMS> up_groups;
+  for (int64_t begin = 0; begin < batch_size;) {
+    const int32_t id = ids[begin];
+    ORT_RETURN_IF_NOT(id >= -1 && id < num_adapters, "adapter id ", id, " is out of range [-1, ", num_adapters, ")");
+    int64_t end = begin + 1;
+    while (end < batch_size && ids[end] == id) {
+      ++end;
+    }
+
+    if (id >= 0) {
+      const size_t first_row = narrow<size_t>(begin) * rows_per_entry;
+      const size_t rows = narrow<size_t>(end - begin) * rows_per_entry;
+
+      MLAS_SGEMM_GROUP_PARAMS down;
+      down.M = rows;
+      down.N = R;
+      down.K = K;
+      down.Data.A = input_data + first_row * K;
+      down.Data.lda = K;
+      down.Data.B = lora_a_data + static_cast<size_t>(id) * K * R;
+      down.Data.ldb = R;
+      down.Data.C = intermediate.get() + first_row * R;
+      down.Data.ldc = R;
+      down_groups.push_back(down);
+
+      MLAS_SGEMM_GROUP_PARAMS up;
+      up.M = rows;
+      up.N = N;
+      up.K = R;
+      up.Data.A = down.Data.C;
+      up.Data.lda = R;
+      up.Data.B = lora_b_data + static_cast<size_t>(id) * R * N;
+      up.Data.ldb = N;
+      up.Data.C = output_data + first_row * N;
+      up.Data.ldc = N;
+      up.Data.alpha = scaling_;
+      up.Data.beta = 1.0f;
+      up_groups.push_back(up);
+    }
+
+    begin = end;
+  }
+
+  if (!down_groups.empty()) {
+    concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+    MlasGemmGrouped(down_groups.data(), down_groups.size(), thread_pool);
+    MlasGemmGrouped(up_groups.data(), up_groups.size(), thread_pool);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,261 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/moe/moe.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include "contrib_ops/cpu/moe/moe_helper.h"
+#include "core/common/safeint.h"
+#include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    MoE,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    MoE<float>);
+
+template <typename T>
+MoE<T>::MoE(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info) {
+  ORT_ENFORCE(op_kernel_info.GetAttr<int64_t>("k", &k_).IsOK());
+
+  std::string activation_type_str;
+  ORT_ENFORCE(op_kernel_info.GetAttr<std::string>("activation_type", &activation_type_str).IsOK());
+  if (activation_type_str == "relu") {
+    activation_kind_ = MlasEpilogueReluActivation;
+  } else if (activation_type_str == "gelu") {
+    // Same tanh approximation as the CUDA kernel.
+    activation_kind_ = MlasEpilogueFastGeluActivation;
+  } else if (activation_type_str == "silu") {
+    activation_kind_ = MlasEpilogueSiluActivation;
+  } else if (activation_type_str == "identity") {
+    activation_kind_ = MlasEpilogueIdentityActivation;
+  } else {
+    ORT_THROW("Unsupported MoE activation type: ", activation_type_str);
+  }
+
+  normalize_routing_weights_ = op_kernel_info.GetAttrOrDefault<int64_t>("normalize_routing_weights", 0) == 1;
+}
+
+template <typename T>
+Status MoE<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* router_probs = context->Input<Tensor>(1);
+  const Tensor* fc1_experts_weights = context->Input<Tensor>(2);
+  const Tensor* fc1_experts_bias_optional = context->Input<Tensor>(3);
+  const Tensor* fc2_experts_weights = context->Input<Tensor>(4);
+  const Tensor* fc2_experts_bias_optional = context->Input<Tensor>(5);
+  const Tensor* fc3_experts_weights_optional = context->Input<Tensor>(6);
+  const Tensor* fc3_experts_bias_optional = context->Input<Tensor>(7);
+
+  MoEParameters moe_params;
+  MoEQuantType quant_type = MoEQuantType::None;
+  ORT_RETURN_IF_ERROR(moe_helper::CheckInputs(moe_params, quant_type, input, router_probs, fc1_experts_weights,
+                                              fc1_experts_bias_optional, fc2_experts_weights,
+                                              fc2_experts_bias_optional, fc3_experts_weights_optional,
+                                              fc3_experts_bias_optional));
+  if (moe_params.parallel_type != MoEParallelType::None) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "The CPU MoE kernel requires the weights of all ", moe_params.num_experts,
+                           " experts, got ", moe_params.local_num_experts);
+  }
+  if (k_ <= 0 || k_ > moe_params.num_experts) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "k must be in [1, num_experts], got ", k_);
+  }
+
+  Tensor* output = context->Output(0, input->Shape());
+
+  const size_t num_rows = static_cast<size_t>(moe_params.num_rows);
+  const size_t num_experts = static_cast<size_t>(moe_params.num_experts);
+  const size_t hidden_size = static_cast<size_t>(moe_params.hidden_size);
+  const size_t inter_size = static_cast<size_t>(moe_params.inter_size);
+  const size_t k = static_cast<size_t>(k_);
+  const size_t num_expanded_rows = num_rows * k;
+  if (num_rows == 0) {
+    return Status::OK();
+  }
+
+  ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  // Route each row to its top k experts by the softmax of the router logits.
+  std::vector<int64_t> expert_for_expanded_row(num_expanded_rows);
+  std::vector<float> routing_weights(num_expanded_rows);
+  {
+    const float* router_data = router_probs->Data<float>();
+    std::vector<float> softmax(num_experts);
+    std::vector<int64_t> experts(num_experts);
+    for (size_t row = 0; row < num_rows; ++row) {
+      const float* logits = router_data + row * num_experts;
+      const float max_logit = *std::max_element(logits, logits + num_experts);
+      float sum = 0.0f;
+      for (size_t e = 0; e < num_experts; ++e) {
+        softmax[e] = std::exp(logits[e] - max_logit);
+        sum += softmax[e];
+      }
+
+      std::iota(experts.begin(), experts.end(), int64_t{0});
+      std::partial_sort(experts.begin(), experts.begin() + k, experts.end(), [&softmax](int64_t a, int64_t b) {
+        return softmax[a] > softmax[b] || (softmax[a] == softmax[b] && a < b);
+      });
+
+      float selected_sum = 0.0f;
+      for (size_t i = 0; i < k; ++i) {
+        expert_for_expanded_row[row * k + i] = experts[i];
+        routing_weights[row * k + i] = softmax[experts[i]] / sum;
+        selected_sum += routing_weights[row * k + i];
+      }
+      if (normalize_routing_weights_) {
+        for (size_t i = 0; i < k; ++i) {
+          routing_weights[row * k + i] /= selected_sum;
+        }
+      }
+    }
+  }
+
+  // Sort the expanded rows by expert, so that the rows of each expert are contiguous.
+  std::vector<size_t> expert_offsets(num_experts + 1, 0);
+  for (int64_t expert : expert_for_expanded_row) {
+    ++expert_offsets[static_cast<size_t>(expert) + 1];
+  }
+  std::partial_sum(expert_offsets.begin(), expert_offsets.end(), expert_offsets.begin());
+
+  std::vector<size_t> permuted_row_for_expanded_row(num_expanded_rows);
+  std::vector<size_t> source_row_for_permuted_row(num_expanded_rows);
+  {
+    std::vector<size_t> next_permuted_row(expert_offsets.begin(), expert_offsets.end() - 1);
+    for (size_t expanded_row = 0; expanded_row < num_expanded_rows; ++expanded_row) {
+      const size_t permuted_row = next_permuted_row[static_cast<size_t>(expert_for_expanded_row[expanded_row])]++;
+      permuted_row_for_expanded_row[expanded_row] = permuted_row;
+      source_row_for_permuted_row[permuted_row] = expanded_row / k;
+    }
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  const bool has_fc3 = fc3_experts_weights_optional != nullptr;
+  const size_t permuted_input_size = SafeInt<size_t>(num_expanded_rows) * hidden_size;
+  const size_t fc1_output_size = SafeInt<size_t>(num_expanded_rows) * inter_size;
+  const size_t buffer_size =
+      SafeInt<size_t>(permuted_input_size) * 2 + SafeInt<size_t>(fc1_output_size) * (has_fc3 ? 2 : 1);
+  auto buffer = IAllocator::MakeUniquePtr<float>(allocator, buffer_size);
+  float* permuted_input = buffer.get();
+  float* fc2_output = permuted_input + permuted_input_size;
+  float* fc1_output = fc2_output + permuted_input_size;
+  float* fc3_output = has_fc3 ? fc1_output + fc1_output_size : nullptr;
+
+  const float* input_data = input->Data<float>();
+  ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_expanded_rows),
+      {static_cast<double>(hidden_size * sizeof(float)), static_cast<double>(hidden_size * sizeof(float)), 0.0},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t permuted_row = begin; permuted_row < end; ++permuted_row) {
+          const float* source = input_data + source_row_for_permuted_row[permuted_row] * hidden_size;
+          std::copy(source, source + hidden_size, permuted_input + permuted_row * hidden_size);
+        }
+      });
+
+  // Runs the GEMM of one layer for all experts with rows as a single grouped GEMM.
+  // The bias of the expert and the activation are applied by the epilogue of each group.
+  // Like the CUDA kernel, the weights of each expert are column major, that is (N, K) in memory.
+  std::vector<MLAS_SGEMM_GROUP_PARAMS> groups;
+  std::vector<MLAS_GEMM_EPILOGUE_PROCESSOR> epilogues;
+  groups.reserve(num_experts);
+  epilogues.reserve(num_experts);
+  auto run_experts = [&](const float* a, size_t K, const Tensor* weights, const Tensor* bias,
+                         MLAS_EPILOGUE_ACTIVATION_KIND activation_kind, size_t N, float* c) {
+    groups.clear();
+    epilogues.clear();
+    for (size_t e = 0; e < num_experts; ++e) {
+      const size_t rows = expert_offsets[e + 1] - expert_offsets[e];
+      if (rows == 0) {
+        continue;
+      }
+
+      MLAS_GEMM_EPILOGUE epilogue;
+      epilogue.Bias = bias != nullptr ? bias->Data<float>() + e * N : nullptr;
+      epilogue.ActivationKind = activation_kind;
+
+      MLAS_SGEMM_GROUP_PARAMS group;
+      group.TransB = CblasTrans;
+      group.M = rows;
+      group.N = N;
+      group.K = K;
+      group.Data.A = a + expert_offsets[e] * K;
+      group.Data.lda = K;
+      group.Data.B = weights->Data<float>() + e * K * N;
+      group.Data.ldb = K;
+      group.Data.C = c + expert_offsets[e] * N;
+      group.Data.ldc = N;
+      if (epilogue.Bias != nullptr || activation_kind != MlasEpilogueIdentityActivation) {
+        epilogues.emplace_back(epilogue);
+        group.Data.OutputProcessor = &epilogues.back();
+      }
+      groups.push_back(group);
+    }
+    MlasGemmGrouped(groups.data(), groups.size(), thread_pool);
+  };
+
+  run_experts(permuted_input, hidden_size, fc1_experts_weights, fc1_experts_bias_optional, activation_kind_,
+              inter_size, fc1_output);
+
+  if (has_fc3) {
+    run_experts(permuted_input, hidden_size, fc3_experts_weights_optional, fc3_experts_bias_optional,
+                MlasEpilogueIdentityActivation, inter_size, fc3_output);
+    ThreadPool::TryParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(num_expanded_rows),
+        {static_cast<double>(2 * inter_size * sizeof(float)), static_cast<double>(inter_size * sizeof(float)),
+         static_cast<double>(inter_size)},
+        [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+          for (size_t i = static_cast<size_t>(begin) * inter_size; i < static_cast<size_t>(end) * inter_size; ++i) {
+            fc1_output[i] *= fc3_output[i];
+          }
+        });
+  }
+
+  // The bias of the second layer is added with the routing weights below.
+  run_experts(fc1_output, inter_size, fc2_experts_weights, nullptr, MlasEpilogueIdentityActivation, hidden_size,
+              fc2_output);
+
+  // Reduce the outputs of the experts of each row, scaled by the routing weights.
+  const float* fc2_bias = fc2_experts_bias_optional != nullptr ? fc2_experts_bias_optional->Data<float>() : nullptr;
+  float* output_data = output->MutableData<float>();
+  ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_rows),
+      {static_cast<double>(k * hidden_size * sizeof(float)), static_cast<double>(hidden_size * sizeof(float)),
+       static_cast<double>(2 * k * hidden_size)},
+      [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t row = begin; row < end; ++row) {
+          float* y = output_data + row * hidden_size;
+          std::fill_n(y, hidden_size, 0.0f);
+          for (size_t i = 0; i < k; ++i) {
+            const size_t expanded_row = row * k + i;
+            const float weight = routing_weights[expanded_row];
+            const float* x = fc2_output + permuted_row_for_expanded_row[expanded_row] * hidden_size;
+            const float* b = fc2_bias != nullptr
+                                 ? fc2_bias + expert_for_expanded_row[expanded_row] * hidden_size
+                                 : nullptr;
+            for (size_t j = 0; j < hidden_size; ++j) {
+              y[j] += weight * (x[j] + (b != nullptr ? b[j] : 0.0f));
+            }
+          }
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
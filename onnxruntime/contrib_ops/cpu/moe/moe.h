@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Mixture of experts on CPU. The rows routed to each expert are gathered and the expert GEMMs of each layer
+// are run as one grouped MLAS GEMM, with the bias and activation applied in the GEMM epilogue.
+template <typename T>
+class MoE final : public OpKernel {
+ public:
+  explicit MoE(const OpKernelInfo& op_kernel_info);
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int64_t k_;
+  bool normalize_routing_weights_;
+  MLAS_EPILOGUE_ACTIVATION_KIND activation_kind_;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -221,6 +221,253 @@ Status NchwcConv::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+namespace {
+
+// The goal for the size of the input and output of a convolution for a band of rows, which should fit in the L2
+// cache of a core.
+constexpr size_t kConvChainBandBytes = 512 * 1024;
+
+// The rows of an input or output of the chain are stored as planes of rows: the channels of an NCHW tensor, or the
+// channel blocks of an NCHWc tensor, whose rows interleave the channels of the block.
+struct ConvChainMap {
+  int64_t channels;
+  int64_t height;
+  int64_t width;
+
+  int64_t PlaneCount(int64_t nchwc_block_size) const {
+    return channels < nchwc_block_size ? channels : channels / nchwc_block_size;
+  }
+
+  int64_t RowSize(int64_t nchwc_block_size) const {
+    return channels < nchwc_block_size ? width : width * nchwc_block_size;
+  }
+};
+
+}  // namespace
+
+NchwcConvChain::NchwcConvChain(const OpKernelInfo& info) : OpKernel(info) {
+  std::vector<int64_t> kernel_shapes;
+  std::vector<int64_t> dilations;
+  std::vector<int64_t> strides;
+  std::vector<int64_t> pads;
+  std::vector<int64_t> groups;
+  std::vector<std::string> activations;
+  std::vector<float> activation_params;
+  ORT_ENFORCE(info.GetAttrs<int64_t>("kernel_shapes", kernel_shapes).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("dilations", dilations).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("strides", strides).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("pads", pads).IsOK());
+  ORT_ENFORCE(info.GetAttrs<int64_t>("groups", groups).IsOK());
+  ORT_ENFORCE(info.GetAttrs<std::string>("activations", activations).IsOK());
+  ORT_ENFORCE(info.GetAttrs<float>("activation_params", activation_params).IsOK());
+
+  const size_t stage_count = groups.size();
+  ORT_ENFORCE(stage_count >= 1 && kernel_shapes.size() == 2 * stage_count && dilations.size() == 2 * stage_count &&
+                  strides.size() == 2 * stage_count && pads.size() == 4 * stage_count &&
+                  activations.size() == stage_count && activation_params.size() == 2 * stage_count,
+              "invalid ConvChain attributes");
+
+  stages_.resize(stage_count);
+  for (size_t i = 0; i < stage_count; i++) {
+    auto& stage = stages_[i];
+    std::copy_n(kernel_shapes.begin() + 2 * i, 2, stage.kernel_shape.begin());
+    std::copy_n(dilations.begin() + 2 * i, 2, stage.dilations.begin());
+    std::copy_n(strides.begin() + 2 * i, 2, stage.strides.begin());
+    std::copy_n(pads.begin() + 4 * i, 4, stage.pads.begin());
+    stage.group = groups[i];
+    ORT_ENFORCE(GetFusedActivation(activations[i], gsl::make_span(activation_params).subspan(2 * i, 2),
+                                   stage.activation)
+                    .IsOK());
+  }
+}
+
+Status NchwcConvChain::Compute(OpKernelContext* context) const {
+  const size_t stage_count = stages_.size();
+  ORT_RETURN_IF_NOT(static_cast<size_t>(context->InputCount()) == 1 + 2 * stage_count,
+                    "ConvChain expects an input, filter and bias per convolution");
+
+  const auto* X = context->Input<Tensor>(0);
+  const auto& X_shape = X->Shape();
+  ORT_RETURN_IF_NOT(X_shape.NumDimensions() == 4, "ConvChain input must be 4D");
+
+  const int64_t nchwc_block_size = static_cast<int64_t>(MlasNchwcGetBlockSize());
+  ORT_ENFORCE((X_shape[1] < nchwc_block_size) || ((X_shape[1] % nchwc_block_size) == 0));
+
+  // Compute the shape of the input and output of each convolution.
+  const int64_t batch_count = X_shape[0];
+  InlinedVector<ConvChainMap> maps;
+  maps.push_back({X_shape[1], X_shape[2], X_shape[3]});
+  InlinedVector<const float*> filters;
+  InlinedVector<const float*> biases;
+  for (size_t i = 0; i < stage_count; i++) {
+    const auto& stage = stages_[i];
+    const auto& W_shape = context->Input<Tensor>(1 + 2 * i)->Shape();
+    const auto& B_shape = context->Input<Tensor>(2 + 2 * i)->Shape();
+    ORT_RETURN_IF_NOT(W_shape.NumDimensions() == 4 && W_shape[2] == stage.kernel_shape[0] &&
+                          W_shape[3] == stage.kernel_shape[1] && (W_shape[0] % nchwc_block_size) == 0,
+                      "invalid ConvChain filter shape ", W_shape);
+    ORT_RETURN_IF_NOT(B_shape.NumDimensions() == 1 && B_shape[0] == W_shape[0],
+                      "invalid ConvChain bias shape ", B_shape);
+
+    const auto& input_map = maps.back();
+    int64_t output_dims[2];
+    for (size_t dim = 0; dim < 2; dim++) {
+      const int64_t input_size = dim == 0 ? input_map.height : input_map.width;
+      const int64_t dilated_kernel_size = (stage.kernel_shape[dim] - 1) * stage.dilations[dim] + 1;
+      const int64_t padded_input_size = input_size + stage.pads[dim] + stage.pads[dim + 2];
+      ORT_RETURN_IF_NOT(padded_input_size >= dilated_kernel_size, "ConvChain input is smaller than the kernel");
+      output_dims[dim] = (padded_input_size - dilated_kernel_size) / stage.strides[dim] + 1;
+    }
+    maps.push_back({W_shape[0], output_dims[0], output_dims[1]});
+
+    filters.push_back(context->Input<Tensor>(1 + 2 * i)->Data<float>());
+    biases.push_back(context->Input<Tensor>(2 + 2 * i)->Data<float>());
+  }
+
+  const auto& output_map = maps.back();
+  auto* Y = context->Output(0, {batch_count, output_map.channels, output_map.height, output_map.width});
+
+  // Bail out early if one of the dimensions is zero.
+  if (Y->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  // Compute the input rows of each convolution that a band of output rows depends on. The rows of the band are
+  // [first_rows[stage_count], last_rows[stage_count]) and the input rows of convolution i are
+  // [first_rows[i], last_rows[i]), with pad_rows[i] rows of padding above and below.
+  const auto compute_band_rows = [&](int64_t first_row, int64_t last_row, gsl::span<int64_t> first_rows,
+                                     gsl::span<int64_t> last_rows, gsl::span<int64_t> pad_rows) {
+    first_rows[stage_count] = first_row;
+    last_rows[stage_count] = last_row;
+    for (size_t i = stage_count; i-- > 0;) {
+      const auto& stage = stages_[i];
+      const int64_t dilated_kernel_size = (stage.kernel_shape[0] - 1) * stage.dilations[0] + 1;
+      const int64_t first_needed_row = first_rows[i + 1] * stage.strides[0] - stage.pads[0];
+      const int64_t last_needed_row = (last_rows[i + 1] - 1) * stage.strides[0] - stage.pads[0] + dilated_kernel_size;
+      first_rows[i] = std::max<int64_t>(first_needed_row, 0);
+      last_rows[i] = std::min(last_needed_row, maps[i].height);
+      pad_rows[2 * i] = first_rows[i] - first_needed_row;
+      pad_rows[2 * i + 1] = last_needed_row - last_rows[i];
+    }
+  };
+
+  // The size of the largest input or output of a convolution for any band of output rows.
+  const auto band_size = [&](int64_t band_rows) {
+    int64_t max_size = 0;
+    int64_t rows = band_rows;
+    for (size_t i = stage_count; i-- > 0;) {
+      const auto& stage = stages_[i];
+      max_size = std::max(max_size, maps[i + 1].channels * maps[i + 1].width * rows);
+      rows = std::min((rows - 1) * stage.strides[0] + (stage.kernel_shape[0] - 1) * stage.dilations[0] + 1,
+                      maps[i].height);
+    }
+    return std::max(max_size, maps[0].channels * maps[0].width * rows);
+  };
+
+  int64_t band_rows = output_map.height;
+  while (band_rows > 1 && 2 * static_cast<size_t>(band_size(band_rows)) * sizeof(float) > kConvChainBandBytes) {
+    band_rows = (band_rows + 1) / 2;
+  }
+
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+  const auto* x_data = X->Data<float>();
+  auto* y_data = Y->MutableData<float>();
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+
+  // Run the convolutions one after the other if their inputs and outputs fit in the cache, which also lets MLAS
+  // parallelize each of them.
+  if (band_rows == output_map.height) {
+    int64_t max_size = 0;
+    for (size_t i = 1; i < stage_count; i++) {
+      max_size = std::max(max_size, batch_count * maps[i].channels * maps[i].height * maps[i].width);
+    }
+    auto buffer = IAllocator::MakeUniquePtr<float>(alloc, 2 * narrow<size_t>(max_size));
+
+    const float* input = x_data;
+    for (size_t i = 0; i < stage_count; i++) {
+      float* output = (i + 1 == stage_count) ? y_data : buffer.get() + (i % 2) * narrow<size_t>(max_size);
+      const int64_t input_shape[] = {batch_count, maps[i].channels, maps[i].height, maps[i].width};
+      const int64_t output_shape[] = {batch_count, maps[i + 1].channels, maps[i + 1].height, maps[i + 1].width};
+      const auto& stage = stages_[i];
+      MlasNchwcConv(input_shape, stage.kernel_shape.data(), stage.dilations.data(), stage.pads.data(),
+                    stage.strides.data(), output_shape, static_cast<size_t>(stage.group), input, filters[i],
+                    biases[i], output, &stage.activation, true, thread_pool);
+      input = output;
+    }
+
+    return Status::OK();
+  }
+
+  // Use at least a band per thread.
+  const ptrdiff_t degree_of_parallelism = concurrency::ThreadPool::DegreeOfParallelism(thread_pool);
+  const int64_t bands_per_thread = (degree_of_parallelism + batch_count - 1) / batch_count;
+  band_rows = std::min(band_rows, (output_map.height + bands_per_thread - 1) / bands_per_thread);
+
+  const int64_t band_count = (output_map.height + band_rows - 1) / band_rows;
+  const ptrdiff_t total_work = static_cast<ptrdiff_t>(batch_count * band_count);
+  const ptrdiff_t worker_count = std::min(total_work, degree_of_parallelism);
+  const size_t buffer_size = narrow<size_t>(band_size(band_rows));
+
+  auto conv_chain_worker = [&](ptrdiff_t batch) {
+    auto work = concurrency::ThreadPool::PartitionWork(batch, worker_count, total_work);
+
+    // The inputs and outputs of the convolutions alternate between the halves of the buffer.
+    auto buffer = IAllocator::MakeUniquePtr<float>(alloc, 2 * buffer_size);
+    float* buffers[] = {buffer.get(), buffer.get() + buffer_size};
+
+    InlinedVector<int64_t> first_rows(stage_count + 1);
+    InlinedVector<int64_t> last_rows(stage_count + 1);
+    InlinedVector<int64_t> pad_rows(2 * stage_count);
+
+    for (ptrdiff_t work_index = work.start; work_index < work.end; work_index++) {
+      const int64_t batch_index = work_index / band_count;
+      const int64_t first_row = (work_index % band_count) * band_rows;
+      const int64_t last_row = std::min(first_row + band_rows, output_map.height);
+      compute_band_rows(first_row, last_row, first_rows, last_rows, pad_rows);
+
+      // Copy the rows of the input that the band depends on.
+      {
+        const auto& map = maps[0];
+        const int64_t plane_count = map.PlaneCount(nchwc_block_size);
+        const int64_t row_size = map.RowSize(nchwc_block_size);
+        const int64_t rows = last_rows[0] - first_rows[0];
+        const float* input = x_data + (batch_index * plane_count * map.height + first_rows[0]) * row_size;
+        for (int64_t plane = 0; plane < plane_count; plane++) {
+          std::copy_n(input + plane * map.height * row_size, rows * row_size, buffers[0] + plane * rows * row_size);
+        }
+      }
+
+      for (size_t i = 0; i < stage_count; i++) {
+        const auto& stage = stages_[i];
+        const int64_t input_shape[] = {1, maps[i].channels, last_rows[i] - first_rows[i],
+                                       maps[i].width};
+        const int64_t output_shape[] = {1, maps[i + 1].channels, last_rows[i + 1] - first_rows[i + 1],
+                                        maps[i + 1].width};
+        const int64_t pads[] = {pad_rows[2 * i], stage.pads[1], pad_rows[2 * i + 1], stage.pads[3]};
+        MlasNchwcConv(input_shape, stage.kernel_shape.data(), stage.dilations.data(), pads, stage.strides.data(),
+                      output_shape, static_cast<size_t>(stage.group), buffers[i % 2], filters[i], biases[i],
+                      buffers[(i + 1) % 2], &stage.activation, true, nullptr);
+      }
+
+      // Copy the band to the output.
+      const int64_t plane_count = output_map.PlaneCount(nchwc_block_size);
+      const int64_t row_size = output_map.RowSize(nchwc_block_size);
+      const int64_t rows = last_row - first_row;
+      const float* output = buffers[stage_count % 2];
+      float* y_band = y_data + (batch_index * plane_count * output_map.height + first_row) * row_size;
+      for (int64_t plane = 0; plane < plane_count; plane++) {
+        std::copy_n(output + plane * rows * row_size, rows * row_size, y_band + plane * output_map.height * row_size);
+      }
+    }
+  };
+
+  concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, worker_count, conv_chain_worker);
+
+  return Status::OK();
+}
+
 Status NchwcPoolBase::NchwcPool(OpKernelContext* context, MLAS_POOLING_KIND kind) const {
   const auto* X = context->Input<Tensor>(0);
   const auto& X_shape = X->Shape();
@@ -405,6 +652,14 @@ ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     NchwcConv);
 
+ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
+    ConvChain,
+    1,
+    float,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    NchwcConvChain);
+
 ONNX_CPU_OPERATOR_TYPED_NCHWC_KERNEL(
     MaxPool,
     1,
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
@@ -53,6 +55,29 @@ class NchwcConv final : public OpKernel {
   MLAS_ACTIVATION activation_;
 };
 
+// Computes a chain of NCHWc convolutions, where the output of each is the input of the next. A large output is
+// computed in bands of rows, with each band computing the overlapping rows of the intermediate outputs it depends
+// on, so that the intermediate values stay in the cache.
+class NchwcConvChain final : public OpKernel {
+ public:
+  NchwcConvChain(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  struct Stage {
+    std::array<int64_t, 2> kernel_shape;
+    std::array<int64_t, 2> dilations;
+    std::array<int64_t, 2> strides;
+    // The pads in the order of the pads attribute of Conv: top, left, bottom, right.
+    std::array<int64_t, 4> pads;
+    int64_t group;
+    MLAS_ACTIVATION activation;
+  };
+
+  std::vector<Stage> stages_;
+};
+
 class NchwcPoolBase : public PoolBase {
  public:
   NchwcPoolBase(const OpKernelInfo& info) : PoolBase(info) {
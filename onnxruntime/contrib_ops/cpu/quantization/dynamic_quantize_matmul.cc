@@ -7,6 +7,7 @@
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/providers/cpu/quantization/matmul_integer_base.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/math_cpuonly.h"
 #include "core/util/qmath.h"
 
@@ -35,6 +36,27 @@ void ScaleOutput(const Tensor& scale, Tensor& output) {
 
   BroadcastLooper(broadcast_helper, funcs);
 }
+
+// Quantizes each row of K values of data symmetrically to uint8 with the zero point 128, so that the rows share the
+// single zero point of A in the QGEMM while each has its own scale.
+void QuantizeRowsSymmetric(const float* data, size_t num_rows, size_t K, uint8_t* quant_data, float* row_scales,
+                           concurrency::ThreadPool* thread_pool) {
+  constexpr uint8_t zero_point = 128;
+  const TensorOpCost unit_cost{static_cast<double>(K * sizeof(float)), static_cast<double>(K * sizeof(uint8_t)),
+                               static_cast<double>(K) * 3.0};
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(num_rows), unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (auto row = static_cast<size_t>(begin); row < static_cast<size_t>(end); ++row) {
+          const float* row_data = data + row * K;
+          float min, max;
+          MlasFindMinMaxElement(row_data, &min, &max, K);
+          const float abs_max = std::max(std::abs(min), std::abs(max));
+          const float scale = abs_max > 0.0f ? abs_max / 127.0f : 1.0f;
+          MlasQuantizeLinear(row_data, quant_data + row * K, K, scale, zero_point);
+          row_scales[row] = scale;
+        }
+      });
+}
 }  // namespace
 
 class MatMulIntegerToFloatBase : public MatMulIntegerBase {
@@ -54,7 +76,8 @@ class MatMulIntegerToFloatBase : public MatMulIntegerBase {
                        const Tensor* b_tensor,
                        const Tensor* b_scale,
                        const Tensor* b_zp,
-                       const Tensor* bias_tensor) const;
+                       const Tensor* bias_tensor,
+                       const float* a_row_scales = nullptr) const;
 };
 
 Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
@@ -66,7 +89,8 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
                                                const Tensor* b_tensor,
                                                const Tensor* b_scale_tensor,
                                                const Tensor* b_zp_tensor,
-                                               const Tensor* bias_tensor) const {
+                                               const Tensor* bias_tensor,
+                                               const float* a_row_scales) const {
   MatMulComputeHelper helper;
   ORT_RETURN_IF_ERROR(helper.Compute(a_shape,
                                      b_tensor ? b_tensor->Shape() : b_shape_,
@@ -130,12 +154,17 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
   std::vector<MLAS_GEMM_QUANT_DATA_PARAMS> gemm_data_vec(num_gemms);
 
   for (size_t gemm_idx = 0; gemm_idx < num_gemms; gemm_idx++) {
+    // the rows of A are contiguous, so the scales of the rows of a GEMM start at its offset in A divided by K
+    const float* row_scales = a_row_scales != nullptr && gemm_shape.K > 0
+                                  ? a_row_scales + helper.LeftOffsets()[gemm_idx] / gemm_shape.K
+                                  : nullptr;
     gemm_scale_procs.emplace_back(y_data + helper.OutputOffsets()[gemm_idx],
                                   gemm_shape.N,
                                   b_scale_data + helper.RightScaleOffsets()[gemm_idx],
                                   bias_data,
                                   MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-                                  is_b_scale_per_column ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix);
+                                  is_b_scale_per_column ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+                                  row_scales);
     auto& params = gemm_data_vec[gemm_idx];
     params.OutputProcessor = &(gemm_scale_procs[gemm_idx]);
     params.A = a_data + helper.LeftOffsets()[gemm_idx];
@@ -157,7 +186,9 @@ Status MatMulIntegerToFloatBase::ComputeCommon(OpKernelContext* ctx,
 
 class DynamicQuantizeMatMul final : public MatMulIntegerToFloatBase {
  public:
-  DynamicQuantizeMatMul(const OpKernelInfo& info) : MatMulIntegerToFloatBase(info) {}
+  DynamicQuantizeMatMul(const OpKernelInfo& info) : MatMulIntegerToFloatBase(info) {
+    per_row_ = info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsDynamicQuantizeMatMulPerRow, "0") == "1";
+  }
 
   Status Compute(OpKernelContext* context) const override;
 
@@ -171,6 +202,10 @@ class DynamicQuantizeMatMul final : public MatMulIntegerToFloatBase {
 
  protected:
   int GetBIdx() const override { return IN_B; }
+
+ private:
+  // quantize each row (token) of A with its own scale instead of the whole tensor with one
+  bool per_row_{false};
 };
 
 class MatMulIntegerToFloat final : public MatMulIntegerToFloatBase {
@@ -205,20 +240,29 @@ Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
   const Tensor* b_scale_tensor = ctx->Input<Tensor>(IN_B_SCALE);
   const Tensor* b_zp_tensor = ctx->Input<Tensor>(IN_B_ZERO_POINT);
 
-  // calculate quantization parameter of a
   const float* a_data = a->Data<float>();
   int64_t num_of_elements = a->Shape().Size();
 
-  float a_scale;
-  uint8_t a_zero_point;
-  GetQuantizationParameter(a_data, num_of_elements, a_scale, a_zero_point, ctx->GetOperatorThreadPool());
-
   AllocatorPtr allocator;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
   uint8_t* a_data_quant = static_cast<uint8_t*>(allocator->Alloc(SafeInt<size_t>(num_of_elements) * sizeof(uint8_t)));
   BufferUniquePtr a_buffer_quant_holder(a_data_quant, BufferDeleter(std::move(allocator)));
 
-  ParQuantizeLinearStd(a_data, a_data_quant, narrow<size_t>(num_of_elements), a_scale, a_zero_point, ctx->GetOperatorThreadPool());
+  float a_scale = 1.0f;
+  uint8_t a_zero_point = 0;
+  std::vector<float> a_row_scales;
+  const size_t K = a->Shape().NumDimensions() > 0 ? narrow<size_t>(a->Shape()[a->Shape().NumDimensions() - 1]) : 0;
+  if (per_row_ && K > 0) {
+    // the row scales are applied to the int32 output of the QGEMM, with the scales of b
+    a_row_scales.resize(narrow<size_t>(num_of_elements) / K);
+    QuantizeRowsSymmetric(a_data, a_row_scales.size(), K, a_data_quant, a_row_scales.data(),
+                          ctx->GetOperatorThreadPool());
+    a_zero_point = 128;
+  } else {
+    // calculate quantization parameter of a
+    GetQuantizationParameter(a_data, num_of_elements, a_scale, a_zero_point, ctx->GetOperatorThreadPool());
+    ParQuantizeLinearStd(a_data, a_data_quant, narrow<size_t>(num_of_elements), a_scale, a_zero_point, ctx->GetOperatorThreadPool());
+  }
 
   bool is_b_scale_supported = IsBQuantParamSupported(b_scale_tensor->Shape(), b ? b->Shape() : b_shape_);
   ORT_RETURN_IF_ERROR(ComputeCommon(
@@ -231,7 +275,8 @@ Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
       b,
       is_b_scale_supported ? b_scale_tensor : nullptr,
       b_zp_tensor,
-      ctx->Input<Tensor>(IN_BIAS)));
+      ctx->Input<Tensor>(IN_BIAS),
+      a_row_scales.empty() ? nullptr : a_row_scales.data()));
 
   if (!is_b_scale_supported) {
     ScaleOutput(*b_scale_tensor, *ctx->Output<Tensor>(0));
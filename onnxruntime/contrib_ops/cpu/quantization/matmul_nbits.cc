@@ -142,6 +142,10 @@ class MatMulNBits final : public OpKernel {
   size_t packed_b_size_{0};
 
   bool has_zp_input_{false};
+#ifdef MLAS_TARGET_AMD64_IX86
+  // Whether the scales and zero points were packed with B, see PrePack().
+  bool is_scales_packed_{false};
+#endif
 #if defined(ORT_NEURAL_SPEED)
 
   bool is_asym_{false};
@@ -211,7 +215,6 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
   }
 
 #else  // defined(ORT_NEURAL_SPEED)
-  ORT_UNUSED_PARAMETER(prepacked_weights);
   const auto compute_type = static_cast<MLAS_SQNBIT_GEMM_COMPUTE_TYPE>(accuracy_level_);
   if (input_idx == InputIndex::B) {
     if (!MlasIsSQNBitGemmAvailable(nbits_, block_size_, compute_type)) {
@@ -222,11 +225,42 @@ Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ Allocat
       return Status::OK();
     }
     auto qptr = tensor.DataRaw();
+    const float* sptr = nullptr;
+    const void* zptr = nullptr;
+    bool is_complete = true;
+#ifdef MLAS_TARGET_AMD64_IX86
+    // With CompInt8 the scales and zero points are packed into the same buffer as B. Pack them together with B
+    // when they are constant, so that the buffer is complete when it is hashed and shared between sessions.
+    if (compute_type == CompInt8) {
+      const Tensor* scales = nullptr;
+      const Tensor* zero_points = nullptr;
+      is_scales_packed_ = Info().TryGetConstantInput(InputIndex::scales, &scales) &&
+                          (!has_zp_input_ || Info().TryGetConstantInput(InputIndex::zero_points, &zero_points));
+      if (is_scales_packed_) {
+        sptr = scales->Data<float>();
+        zptr = zero_points != nullptr ? zero_points->DataRaw() : nullptr;
+      }
+      is_complete = is_scales_packed_;
+    }
+#endif
     packed_b_ = IAllocator::MakeUniquePtr<void>(alloc, packed_b_size_, true);
-    MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, qptr, packed_b_.get(), nullptr, has_zp_input_, nullptr, nullptr);
+    MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, qptr, packed_b_.get(), sptr, has_zp_input_, zptr, nullptr);
     is_packed = true;
+    if (prepacked_weights != nullptr) {
+      if (is_complete) {
+        prepacked_weights->buffers_.push_back(std::move(packed_b_));
+        prepacked_weights->buffer_sizes_.push_back(packed_b_size_);
+      } else {
+        // The scales are packed into this buffer later, so it can not be shared. Keep it private to this kernel
+        // and do not report B as packed, so that the session does not look for a shared buffer.
+        is_packed = false;
+      }
+    }
   } else if (compute_type == CompInt8) {
 #ifdef MLAS_TARGET_AMD64_IX86
+    if (is_scales_packed_) {
+      return Status::OK();
+    }
     if (input_idx == InputIndex::scales && packed_b_ != nullptr) {
       auto sptr = tensor.Data<float>();
       MlasSQNBitGemmPackQuantBData(N_, K_, nbits_, block_size_, compute_type, nullptr, packed_b_.get(), sptr, has_zp_input_, nullptr, nullptr);
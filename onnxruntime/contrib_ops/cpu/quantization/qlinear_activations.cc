@@ -4,6 +4,8 @@
 #include "qlinear_activations.h"
 #include "qlinear_lookup_table.h"
 
+#include <cmath>
+
 #include "core/common/narrow.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
@@ -97,6 +99,34 @@ Status QLinearSigmoid<T>::Compute(OpKernelContext* context) const {
   });
 }
 
+namespace {
+float Gelu(float v, bool approximate_tanh) {
+  if (approximate_tanh) {
+    constexpr float kAlpha = 0.7978845608028654f;  // sqrt(2 / pi)
+    return 0.5f * v * (1.0f + std::tanh(kAlpha * (v + 0.044715f * v * v * v)));
+  }
+  return 0.5f * v * (1.0f + std::erf(v * 0.7071067811865476f));
+}
+}  // namespace
+
+template <typename T>
+QLinearGelu<T>::QLinearGelu(const OpKernelInfo& info)
+    : QLinearLookupBase<T>(info) {
+  const std::string approximate = info.GetAttrOrDefault<std::string>("approximate", "none");
+  ORT_ENFORCE(approximate == "none" || approximate == "tanh", "Unsupported approximate algorithm: ", approximate);
+  approximate_tanh_ = approximate == "tanh";
+  this->BuildLookupTableIfFixed(info, [this](float v) -> float {
+    return Gelu(v, approximate_tanh_);
+  });
+}
+
+template <typename T>
+Status QLinearGelu<T>::Compute(OpKernelContext* context) const {
+  return this->ComputeBase(context, [this](float v) -> float {
+    return Gelu(v, approximate_tanh_);
+  });
+}
+
 #define REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(op_name, version, data_type, KERNEL_CLASS) \
   ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(                                                         \
       op_name, version, data_type,                                                           \
@@ -108,6 +138,8 @@ REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearLeakyRelu, 1, int8_t, QLinearLe
 REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearLeakyRelu, 1, uint8_t, QLinearLeakyRelu);
 REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearSigmoid, 1, int8_t, QLinearSigmoid);
 REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearSigmoid, 1, uint8_t, QLinearSigmoid);
+REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearGelu, 1, int8_t, QLinearGelu);
+REGISTER_QLINEAR_LOOKUPTABLE_TYPED_KERNEL(QLinearGelu, 1, uint8_t, QLinearGelu);
 
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -86,45 +86,37 @@ Status SkipLayerNorm<T, simplified>::Compute(OpKernelContext* p_ctx) const {
       [&](ptrdiff_t task_idx) {
         auto offset = task_idx * hidden_size;
 
-        const T* p_input = input_data + offset;
-        const T* p_skip = skip_data + (offset % skip_size);
-        T* p_output = output_data + offset;
-        T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
-
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          T value = p_input[h] + p_skip[h];
-
-          if (nullptr != bias_data) {
-            value += bias_data[h];
-          }
-
-          if (nullptr != p_skip_input_bias_add_output_data) {
-            p_skip_input_bias_add_output_data[h] = value;
-          }
+        // the reductions and the normalization are expressed on Eigen arrays so they vectorize
+        ConstEigenVectorArrayMap<T> input_array(input_data + offset, hidden_size);
+        ConstEigenVectorArrayMap<T> skip_array(skip_data + (offset % skip_size), hidden_size);
+        EigenVectorArrayMap<T> output_array(output_data + offset, hidden_size);
+
+        output_array = input_array + skip_array;
+        if (nullptr != bias_data) {
+          output_array += ConstEigenVectorArrayMap<T>(bias_data, hidden_size);
+        }
 
-          p_output[h] = value;
-          mean += value;
-          mean_square += value * value;
+        if (nullptr != skip_input_bias_add_output_data) {
+          EigenVectorArrayMap<T>(skip_input_bias_add_output_data + offset, hidden_size) = output_array;
         }
 
-        mean = mean / hidden_size;
+        T mean = output_array.sum() / hidden_size;
+        T mean_square = output_array.square().sum() / hidden_size;
         if (simplified) {
-          mean_square = sqrt(mean_square / hidden_size + epsilon_);
+          mean_square = sqrt(mean_square + epsilon_);
         } else {
-          mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
+          mean_square = sqrt(mean_square - mean * mean + epsilon_);
         }
 
-        for (int64_t h = 0; h < hidden_size; h++) {
-          if (simplified) {
-            p_output[h] = p_output[h] / mean_square * gamma_data[h];
-          } else if (nullptr == beta_data) {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
-          } else {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
-          }
+        const T inv_std_dev = 1 / mean_square;
+        ConstEigenVectorArrayMap<T> gamma_array(gamma_data, hidden_size);
+        if (simplified) {
+          output_array = output_array * inv_std_dev * gamma_array;
+        } else if (nullptr == beta_data) {
+          output_array = (output_array - mean) * inv_std_dev * gamma_array;
+        } else {
+          output_array = (output_array - mean) * inv_std_dev * gamma_array +
+                         ConstEigenVectorArrayMap<T>(beta_data, hidden_size);
         }
       },
       0);
@@ -0,0 +1,380 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/common/utf8_util.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace subword_tokenizer_details {
+// The words start with the word boundary marker U+2581 of SentencePiece, so that the detokenization only has to
+// concatenate the pieces and replace the markers with spaces.
+constexpr std::string_view kWordBoundary{"\xE2\x96\x81"};
+
+inline bool IsAsciiSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+// Splits the text at ASCII whitespace, each word being prefixed by the word boundary marker.
+void PreTokenize(std::string_view text, std::vector<std::string>& words) {
+  words.clear();
+  size_t i = 0;
+  while (i < text.size()) {
+    while (i < text.size() && IsAsciiSpace(text[i])) {
+      ++i;
+    }
+    const size_t start = i;
+    while (i < text.size() && !IsAsciiSpace(text[i])) {
+      ++i;
+    }
+    if (i > start) {
+      std::string& word = words.emplace_back(kWordBoundary);
+      word.append(text.substr(start, i - start));
+    }
+  }
+}
+
+// Returns the byte length of the UTF-8 character starting at word[i], 0 if it is not valid.
+inline size_t CharLength(std::string_view word, size_t i) {
+  size_t length = 0;
+  if (!utf8_util::utf8_bytes(static_cast<unsigned char>(word[i]), length) || i + length > word.size()) {
+    return 0;
+  }
+  return length;
+}
+}  // namespace subword_tokenizer_details
+
+using namespace subword_tokenizer_details;
+
+// Splits text into the ids of the subword pieces of a BPE or Unigram (SentencePiece) vocabulary.
+class SubwordTokenizer final : public OpKernel {
+ public:
+  explicit SubwordTokenizer(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // Appends the ids of the pieces of a word, returns false when it is not valid UTF-8.
+  bool TokenizeBpe(std::string_view word, std::vector<int64_t>& ids) const;
+  bool TokenizeUnigram(std::string_view word, std::vector<int64_t>& ids) const;
+
+  int32_t FindPiece(std::string_view piece) const {
+    auto it = piece_ids_.find(std::string(piece));
+    return it == piece_ids_.end() ? -1 : it->second;
+  }
+
+  struct Merge {
+    int32_t rank;
+    int32_t merged_id;
+  };
+
+  static uint64_t PairKey(int32_t left, int32_t right) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(left)) << 32) | static_cast<uint32_t>(right);
+  }
+
+  static uint64_t TrieKey(int32_t node, unsigned char byte) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(node)) << 8) | byte;
+  }
+
+  bool unigram_{false};
+  int64_t unk_id_{0};
+  int64_t pad_id_{0};
+  std::unordered_map<std::string, int32_t> piece_ids_;
+
+  // BPE: the merges of adjacent pieces by priority
+  InlinedHashMap<uint64_t, Merge> merges_;
+
+  // Unigram: the trie of the pieces, its edges keyed by the parent node and the byte, the root being the node 0,
+  // and the piece of each node
+  InlinedHashMap<uint64_t, int32_t> trie_edges_;
+  std::vector<int32_t> trie_pieces_;
+  std::vector<float> scores_;
+  float unk_score_{0.0f};
+};
+
+ONNX_CPU_OPERATOR_MS_KERNEL(
+    SubwordTokenizer,
+    1,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>()),
+    contrib::SubwordTokenizer);
+
+SubwordTokenizer::SubwordTokenizer(const OpKernelInfo& info) : OpKernel(info) {
+  const std::string model = info.GetAttrOrDefault<std::string>("model", "bpe");
+  ORT_ENFORCE(model == "bpe" || model == "unigram", "attribute model must be bpe or unigram, got ", model);
+  unigram_ = model == "unigram";
+  unk_id_ = info.GetAttrOrDefault<int64_t>("unk_id", 0);
+  pad_id_ = info.GetAttrOrDefault<int64_t>("pad_id", 0);
+
+  std::vector<std::string> vocab;
+  ORT_ENFORCE(info.GetAttrs("vocab", vocab).IsOK() && !vocab.empty(), "attribute vocab is not set");
+  ORT_ENFORCE(vocab.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()), "vocab is too large");
+  ORT_ENFORCE(unk_id_ >= 0 && unk_id_ < static_cast<int64_t>(vocab.size()), "unk_id is not in the vocab");
+  piece_ids_.reserve(vocab.size());
+  for (size_t id = 0; id < vocab.size(); ++id) {
+    piece_ids_.emplace(vocab[id], static_cast<int32_t>(id));
+  }
+
+  if (unigram_) {
+    ORT_ENFORCE(info.GetAttrs("scores", scores_).IsOK() && scores_.size() == vocab.size(),
+                "attribute scores with a score per piece of the vocab is required by the unigram model");
+    trie_pieces_.push_back(-1);
+    for (size_t id = 0; id < vocab.size(); ++id) {
+      if (static_cast<int64_t>(id) == unk_id_) {
+        continue;
+      }
+      int32_t node = 0;
+      for (unsigned char byte : vocab[id]) {
+        auto [it, inserted] = trie_edges_.emplace(TrieKey(node, byte), static_cast<int32_t>(trie_pieces_.size()));
+        if (inserted) {
+          trie_pieces_.push_back(-1);
+        }
+        node = it->second;
+      }
+      trie_pieces_[node] = static_cast<int32_t>(id);
+    }
+    // An unknown character costs more than any piece, as in SentencePiece.
+    unk_score_ = *std::min_element(scores_.begin(), scores_.end()) - 10.0f;
+  } else {
+    std::vector<std::string> merges;
+    if (info.GetAttrs("merges", merges).IsOK()) {
+      merges_.reserve(merges.size());
+      for (size_t rank = 0; rank < merges.size(); ++rank) {
+        const std::string& merge = merges[rank];
+        const size_t space = merge.find(' ');
+        ORT_ENFORCE(space != std::string::npos && space > 0 && space + 1 < merge.size(),
+                    "merge ", rank, " is expected to be 2 pieces separated by a space, got ", merge);
+        const int32_t left = FindPiece(std::string_view(merge).substr(0, space));
+        const int32_t right = FindPiece(std::string_view(merge).substr(space + 1));
+        const int32_t merged = FindPiece(merge.substr(0, space) + merge.substr(space + 1));
+        ORT_ENFORCE(left >= 0 && right >= 0 && merged >= 0,
+                    "merge ", rank, " has a piece that is not in the vocab: ", merge);
+        // the first merge of a pair has the priority
+        merges_.emplace(PairKey(left, right), Merge{static_cast<int32_t>(rank), merged});
+      }
+    }
+  }
+}
+
+bool SubwordTokenizer::TokenizeBpe(std::string_view word, std::vector<int64_t>& ids) const {
+  // the characters, a character not in the vocab being unknown and never merged
+  InlinedVector<int32_t> symbols;
+  for (size_t i = 0; i < word.size();) {
+    const size_t length = CharLength(word, i);
+    if (length == 0) {
+      return false;
+    }
+    symbols.push_back(FindPiece(word.substr(i, length)));
+    i += length;
+  }
+
+  // merge the pair of adjacent symbols of the lowest rank until none is left
+  while (symbols.size() > 1) {
+    size_t best = symbols.size();
+    Merge best_merge{std::numeric_limits<int32_t>::max(), -1};
+    for (size_t i = 0; i + 1 < symbols.size(); ++i) {
+      if (symbols[i] < 0 || symbols[i + 1] < 0) {
+        continue;
+      }
+      auto it = merges_.find(PairKey(symbols[i], symbols[i + 1]));
+      if (it != merges_.end() && it->second.rank < best_merge.rank) {
+        best = i;
+        best_merge = it->second;
+      }
+    }
+    if (best == symbols.size()) {
+      break;
+    }
+    symbols[best] = best_merge.merged_id;
+    symbols.erase(symbols.begin() + best + 1);
+  }
+
+  for (int32_t symbol : symbols) {
+    ids.push_back(symbol < 0 ? unk_id_ : symbol);
+  }
+  return true;
+}
+
+bool SubwordTokenizer::TokenizeUnigram(std::string_view word, std::vector<int64_t>& ids) const {
+  // Viterbi over the byte positions: the best score of the pieces up to each position, and its last piece
+  const size_t length = word.size();
+  constexpr float kUnreachable = std::numeric_limits<float>::lowest();
+  std::vector<float> best_scores(length + 1, kUnreachable);
+  std::vector<size_t> best_starts(length + 1, 0);
+  std::vector<int64_t> best_pieces(length + 1, -1);
+  best_scores[0] = 0.0f;
+
+  for (size_t start = 0; start < length; ++start) {
+    if (best_scores[start] == kUnreachable) {
+      continue;
+    }
+    const size_t char_length = CharLength(word, start);
+    if (char_length == 0) {
+      return false;
+    }
+
+    bool has_char_piece = false;
+    int32_t node = 0;
+    for (size_t end = start; end < length; ++end) {
+      auto it = trie_edges_.find(TrieKey(node, static_cast<unsigned char>(word[end])));
+      if (it == trie_edges_.end()) {
+        break;
+      }
+      node = it->second;
+      const int32_t piece = trie_pieces_[node];
+      if (piece < 0) {
+        continue;
+      }
+      has_char_piece = has_char_piece || end + 1 == start + char_length;
+      const float score = best_scores[start] + scores_[piece];
+      if (score > best_scores[end + 1]) {
+        best_scores[end + 1] = score;
+        best_starts[end + 1] = start;
+        best_pieces[end + 1] = piece;
+      }
+    }
+
+    if (!has_char_piece) {
+      const float score = best_scores[start] + unk_score_;
+      if (score > best_scores[start + char_length]) {
+        best_scores[start + char_length] = score;
+        best_starts[start + char_length] = start;
+        best_pieces[start + char_length] = unk_id_;
+      }
+    }
+  }
+
+  const size_t first = ids.size();
+  for (size_t end = length; end > 0; end = best_starts[end]) {
+    ids.push_back(best_pieces[end]);
+  }
+  std::reverse(ids.begin() + first, ids.end());
+  return true;
+}
+
+Status SubwordTokenizer::Compute(OpKernelContext* context) const {
+  const Tensor* X = context->Input<Tensor>(0);
+  ORT_RETURN_IF_NOT(X->Shape().NumDimensions() == 1, "Input X is expected to have 1 dimension, got ",
+                    X->Shape().NumDimensions());
+  const auto texts = X->DataAsSpan<std::string>();
+  const size_t batch_size = texts.size();
+
+  // The rows are tokenized in parallel, then written to the output padded to the longest.
+  std::vector<std::vector<int64_t>> rows(batch_size);
+  std::vector<uint8_t> valid_rows(batch_size, 1);
+  concurrency::ThreadPool::TryBatchParallelFor(
+      context->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(batch_size),
+      [&](std::ptrdiff_t row) {
+        std::vector<std::string> words;
+        PreTokenize(texts[row], words);
+        for (const std::string& word : words) {
+          if (!(unigram_ ? TokenizeUnigram(word, rows[row]) : TokenizeBpe(word, rows[row]))) {
+            valid_rows[row] = 0;
+            return;
+          }
+        }
+      },
+      0);
+
+  size_t max_tokens = 0;
+  for (size_t row = 0; row < batch_size; ++row) {
+    ORT_RETURN_IF_NOT(valid_rows[row], "Input X row ", row, " is not valid UTF-8.");
+    max_tokens = std::max(max_tokens, rows[row].size());
+  }
+
+  Tensor* Y = context->Output(0, {narrow<int64_t>(batch_size), narrow<int64_t>(max_tokens)});
+  int64_t* ids = Y->MutableData<int64_t>();
+  std::fill_n(ids, SafeInt<size_t>(batch_size) * max_tokens, pad_id_);
+  for (size_t row = 0; row < batch_size; ++row) {
+    std::copy(rows[row].begin(), rows[row].end(), ids + row * max_tokens);
+  }
+
+  Tensor* lengths = context->Output(1, {narrow<int64_t>(batch_size)});
+  if (lengths != nullptr) {
+    int64_t* lengths_data = lengths->MutableData<int64_t>();
+    for (size_t row = 0; row < batch_size; ++row) {
+      lengths_data[row] = narrow<int64_t>(rows[row].size());
+    }
+  }
+  return Status::OK();
+}
+
+// Joins the pieces of the ids along the last axis into text, the reverse of SubwordTokenizer.
+class SubwordDetokenizer final : public OpKernel {
+ public:
+  explicit SubwordDetokenizer(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  std::vector<std::string> vocab_;
+  InlinedHashSet<int64_t> skip_ids_;
+};
+
+ONNX_CPU_OPERATOR_MS_KERNEL(
+    SubwordDetokenizer,
+    1,
+    KernelDefBuilder()
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<std::string>()),
+    contrib::SubwordDetokenizer);
+
+SubwordDetokenizer::SubwordDetokenizer(const OpKernelInfo& info) : OpKernel(info) {
+  ORT_ENFORCE(info.GetAttrs("vocab", vocab_).IsOK() && !vocab_.empty(), "attribute vocab is not set");
+  // the pieces with the word boundary marker replaced, once for all the runs
+  for (std::string& piece : vocab_) {
+    for (size_t pos = piece.find(kWordBoundary); pos != std::string::npos; pos = piece.find(kWordBoundary, pos)) {
+      piece.replace(pos, kWordBoundary.size(), " ");
+    }
+  }
+  const auto skip_ids = info.GetAttrsOrDefault<int64_t>("skip_ids");
+  skip_ids_.insert(skip_ids.begin(), skip_ids.end());
+}
+
+Status SubwordDetokenizer::Compute(OpKernelContext* context) const {
+  const Tensor* ids = context->Input<Tensor>(0);
+  const auto& ids_shape = ids->Shape();
+  ORT_RETURN_IF_NOT(ids_shape.NumDimensions() == 1 || ids_shape.NumDimensions() == 2,
+                    "Input ids is expected to have 1 or 2 dimensions, got ", ids_shape.NumDimensions());
+  const auto ids_data = ids->DataAsSpan<int64_t>();
+  const int64_t vocab_size = static_cast<int64_t>(vocab_.size());
+  for (int64_t id : ids_data) {
+    ORT_RETURN_IF(id < 0 || id >= vocab_size, "id ", id, " is out of the vocab of ", vocab_size, " pieces");
+  }
+
+  const size_t sequence_length = narrow<size_t>(ids_shape[ids_shape.NumDimensions() - 1]);
+  Tensor* text = context->Output(0, ids_shape.NumDimensions() == 1 ? TensorShape({}) : TensorShape({ids_shape[0]}));
+  auto texts = text->MutableDataAsSpan<std::string>();
+  concurrency::ThreadPool::TryBatchParallelFor(
+      context->GetOperatorThreadPool(), narrow<std::ptrdiff_t>(texts.size()),
+      [&](std::ptrdiff_t row) {
+        std::string& row_text = texts[row];
+        for (int64_t id : ids_data.subspan(row * sequence_length, sequence_length)) {
+          if (skip_ids_.find(id) == skip_ids_.end()) {
+            row_text.append(vocab_[narrow<size_t>(id)]);
+          }
+        }
+        // the marker of the first word is not a space in the text
+        if (!row_text.empty() && row_text.front() == ' ') {
+          row_text.erase(0, 1);
+        }
+      },
+      0);
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
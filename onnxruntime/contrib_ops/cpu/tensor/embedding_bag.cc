@@ -0,0 +1,267 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/utils.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+enum class EmbeddingBagMode {
+  kSum,
+  kMean,
+  kMax,
+};
+
+// The number of rows of a bag ahead of the current one which are prefetched, the rows being scattered across the
+// table.
+constexpr size_t kEmbeddingBagPrefetchDistance = 4;
+constexpr size_t kEmbeddingBagCacheLineBytes = 64;
+// Only the start of long rows is prefetched, the hardware prefetcher follows the rest of the row once it is read.
+constexpr size_t kEmbeddingBagPrefetchMaxBytesPerRow = 256;
+
+// Returns the row of the table as floats, converting it into row_buffer unless the table is float already.
+inline const float* RowAsFloat(const float* row, float /*scale*/, size_t /*dim*/, float* /*row_buffer*/) {
+  return row;
+}
+
+inline const float* RowAsFloat(const MLFloat16* row, float /*scale*/, size_t dim, float* row_buffer) {
+  MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(row), row_buffer, dim);
+  return row_buffer;
+}
+
+inline const float* RowAsFloat(const int8_t* row, float scale, size_t dim, float* row_buffer) {
+  for (size_t d = 0; d < dim; d++) {
+    row_buffer[d] = scale * static_cast<float>(row[d]);
+  }
+  return row_buffer;
+}
+
+inline void StoreRow(const float* values, size_t dim, float* output) {
+  std::copy_n(values, dim, output);
+}
+
+inline void StoreRow(const float* values, size_t dim, MLFloat16* output) {
+  for (size_t d = 0; d < dim; d++) {
+    output[d] = MLFloat16(values[d]);
+  }
+}
+
+template <typename TTable>
+struct EmbeddingBagOutput {
+  using type = float;
+};
+
+template <>
+struct EmbeddingBagOutput<MLFloat16> {
+  using type = MLFloat16;
+};
+
+}  // namespace
+
+// Reduces the rows of the table selected by each bag of indices, reading each selected row once straight from the
+// table instead of gathering all of them first. The bags are reduced in parallel.
+template <typename T>
+class EmbeddingBag final : public OpKernel {
+ public:
+  explicit EmbeddingBag(const OpKernelInfo& info) : OpKernel(info) {
+    const std::string mode = info.GetAttrOrDefault<std::string>("mode", "sum");
+    if (mode == "sum") {
+      mode_ = EmbeddingBagMode::kSum;
+    } else if (mode == "mean") {
+      mode_ = EmbeddingBagMode::kMean;
+    } else if (mode == "max") {
+      mode_ = EmbeddingBagMode::kMax;
+    } else {
+      ORT_THROW("Unsupported mode for EmbeddingBag: ", mode);
+    }
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  template <typename TIndex>
+  Status ComputeImpl(OpKernelContext* context) const;
+
+  EmbeddingBagMode mode_;
+};
+
+#define REGISTER_KERNEL_TYPED(T, TOutput)                                           \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                    \
+      EmbeddingBag,                                                                 \
+      kMSDomain,                                                                    \
+      1,                                                                            \
+      T,                                                                            \
+      kCpuExecutionProvider,                                                        \
+      KernelDefBuilder()                                                            \
+          .TypeConstraint("T1", DataTypeImpl::GetTensorType<T>())                   \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TOutput>())              \
+          .TypeConstraint("Tind", BuildKernelDefConstraints<int32_t, int64_t>()),   \
+      EmbeddingBag<T>);
+
+REGISTER_KERNEL_TYPED(float, float)
+REGISTER_KERNEL_TYPED(MLFloat16, MLFloat16)
+REGISTER_KERNEL_TYPED(int8_t, float)
+
+template <typename T>
+Status EmbeddingBag<T>::Compute(OpKernelContext* context) const {
+  if (context->Input<Tensor>(1)->IsDataType<int32_t>()) {
+    return ComputeImpl<int32_t>(context);
+  }
+  return ComputeImpl<int64_t>(context);
+}
+
+template <typename T>
+template <typename TIndex>
+Status EmbeddingBag<T>::ComputeImpl(OpKernelContext* context) const {
+  using TOutput = typename EmbeddingBagOutput<T>::type;
+
+  const Tensor* table = context->Input<Tensor>(0);
+  const Tensor* indices = context->Input<Tensor>(1);
+  const Tensor* offsets = context->Input<Tensor>(2);
+  const Tensor* per_sample_weights = context->Input<Tensor>(3);
+  const Tensor* scales = context->Input<Tensor>(4);
+
+  const auto& table_shape = table->Shape();
+  const auto& indices_shape = indices->Shape();
+  ORT_RETURN_IF_NOT(table_shape.NumDimensions() == 2, "table is expected to have 2 dimensions, got ",
+                    table_shape.NumDimensions());
+  const int64_t num_embeddings = table_shape[0];
+  const size_t dim = narrow<size_t>(table_shape[1]);
+  const size_t num_indices = narrow<size_t>(indices_shape.Size());
+
+  int64_t batch_size = 0;
+  if (offsets != nullptr) {
+    ORT_RETURN_IF_NOT(indices_shape.NumDimensions() == 1 && offsets->Shape().NumDimensions() == 1,
+                      "indices and offsets are expected to have 1 dimension, got ", indices_shape, " and ",
+                      offsets->Shape());
+    ORT_RETURN_IF_NOT(offsets->IsDataType<TIndex>(), "offsets must have the type of indices");
+    batch_size = offsets->Shape()[0];
+  } else {
+    ORT_RETURN_IF_NOT(indices_shape.NumDimensions() == 2,
+                      "indices is expected to have 2 dimensions without offsets, got ", indices_shape);
+    batch_size = indices_shape[0];
+  }
+
+  ORT_RETURN_IF_NOT(per_sample_weights == nullptr || mode_ == EmbeddingBagMode::kSum,
+                    "per_sample_weights is only supported for the sum mode");
+  ORT_RETURN_IF_NOT(per_sample_weights == nullptr || per_sample_weights->Shape() == indices_shape,
+                    "per_sample_weights shape ", (per_sample_weights ? per_sample_weights->Shape() : TensorShape{}),
+                    " must be the indices shape ", indices_shape);
+  if constexpr (std::is_same_v<T, int8_t>) {
+    ORT_RETURN_IF_NOT(scales != nullptr && scales->Shape().Size() == num_embeddings,
+                      "An int8 table needs one scale per row");
+  }
+
+  Tensor* output = context->Output(0, {batch_size, static_cast<int64_t>(dim)});
+  if (batch_size == 0 || dim == 0) {
+    return Status::OK();
+  }
+
+  // The bag b is indices [bag_begin(b), bag_begin(b + 1)).
+  const TIndex* indices_data = indices->Data<TIndex>();
+  const TIndex* offsets_data = offsets != nullptr ? offsets->Data<TIndex>() : nullptr;
+  const size_t bag_size = offsets != nullptr ? 0 : narrow<size_t>(indices_shape[1]);
+  const auto bag_begin = [&](size_t b) {
+    if (b == static_cast<size_t>(batch_size)) {
+      return num_indices;
+    }
+    return offsets_data != nullptr ? static_cast<size_t>(offsets_data[b]) : b * bag_size;
+  };
+
+  if (offsets_data != nullptr) {
+    for (int64_t b = 0; b < batch_size; b++) {
+      const int64_t end = b + 1 < batch_size ? static_cast<int64_t>(offsets_data[b + 1])
+                                             : static_cast<int64_t>(num_indices);
+      ORT_RETURN_IF_NOT(offsets_data[b] >= 0 && offsets_data[b] <= end,
+                        "offsets must be increasing and within the indices, got ", offsets_data[b], " at ", b);
+    }
+  }
+  for (size_t i = 0; i < num_indices; i++) {
+    const int64_t index = static_cast<int64_t>(indices_data[i]);
+    ORT_RETURN_IF_NOT(index >= -num_embeddings && index < num_embeddings, "indices element out of data bounds, idx=",
+                      index, " must be within the inclusive range [", -num_embeddings, ",", num_embeddings - 1, "]");
+  }
+
+  const T* table_data = table->Data<T>();
+  const float* weights_data = per_sample_weights != nullptr ? per_sample_weights->Data<float>() : nullptr;
+  const float* scales_data = scales != nullptr ? scales->Data<float>() : nullptr;
+  TOutput* output_data = output->MutableData<TOutput>();
+
+  const auto row_index = [&](size_t i) {
+    const int64_t index = static_cast<int64_t>(indices_data[i]);
+    return static_cast<size_t>(index < 0 ? index + num_embeddings : index);
+  };
+  const size_t prefetch_bytes = std::min(dim * sizeof(T), kEmbeddingBagPrefetchMaxBytesPerRow);
+
+  const double average_bag_size = static_cast<double>(num_indices) / static_cast<double>(batch_size);
+  const TensorOpCost unit_cost{average_bag_size * static_cast<double>(dim * sizeof(T)),
+                               static_cast<double>(dim * sizeof(TOutput)),
+                               average_bag_size * static_cast<double>(dim) * 2.0};
+
+  concurrency::ThreadPool::TryParallelFor(
+      context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(batch_size), unit_cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> accumulator(dim);
+        std::vector<float> row_buffer(dim);
+        for (std::ptrdiff_t b = first; b < last; b++) {
+          const size_t begin = bag_begin(static_cast<size_t>(b));
+          const size_t end = bag_begin(static_cast<size_t>(b) + 1);
+          std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+
+          for (size_t i = begin; i < end; i++) {
+            if (i + kEmbeddingBagPrefetchDistance < end) {
+              const auto* next_row = reinterpret_cast<const uint8_t*>(
+                  table_data + row_index(i + kEmbeddingBagPrefetchDistance) * dim);
+              for (size_t offset = 0; offset < prefetch_bytes; offset += kEmbeddingBagCacheLineBytes) {
+                PrefetchForRead(next_row + offset);
+              }
+            }
+
+            const size_t row = row_index(i);
+            const float* values = RowAsFloat(table_data + row * dim, scales_data != nullptr ? scales_data[row] : 1.0f,
+                                             dim, row_buffer.data());
+            if (mode_ == EmbeddingBagMode::kMax) {
+              if (i == begin) {
+                std::copy_n(values, dim, accumulator.data());
+              } else {
+                for (size_t d = 0; d < dim; d++) {
+                  accumulator[d] = std::max(accumulator[d], values[d]);
+                }
+              }
+            } else {
+              const float weight = weights_data != nullptr ? weights_data[i] : 1.0f;
+              for (size_t d = 0; d < dim; d++) {
+                accumulator[d] += weight * values[d];
+              }
+            }
+          }
+
+          if (mode_ == EmbeddingBagMode::kMean && end > begin) {
+            const float scale = 1.0f / static_cast<float>(end - begin);
+            for (size_t d = 0; d < dim; d++) {
+              accumulator[d] *= scale;
+            }
+          }
+
+          StoreRow(accumulator.data(), dim, output_data + static_cast<size_t>(b) * dim);
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -23,6 +23,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/session_options.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/allocator.h"
 #include "core/framework/ort_value.h"
@@ -93,6 +94,14 @@ void BeamSearch::Init(const OpKernelInfo& info) {
   // Make sure the decoder sub-graph attribute is present for all model types.
   ORT_ENFORCE(info.GetAttr<ONNX_NAMESPACE::GraphProto>("decoder", &proto).IsOK());
 
+  if (parameters_->model_type != IGenerationParameters::kModelTypeGpt) {
+    const auto encoder_output_cache_entries = static_cast<size_t>(std::stoull(info.GetConfigOptions().GetConfigOrDefault(
+        kOrtSessionOptionsGenerationEncoderOutputCacheEntries, "0")));
+    if (encoder_output_cache_entries > 0) {
+      encoder_output_cache_ = std::make_unique<EncoderOutputCache>(encoder_output_cache_entries);
+    }
+  }
+
   ORT_IGNORE_RETURN_VALUE(proto);
 }
 
@@ -284,6 +293,7 @@ Status BeamSearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, init_cache_indir_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetEncoderOutputCache(encoder_output_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(*encoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -306,6 +316,7 @@ Status BeamSearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, init_cache_indir_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetEncoderOutputCache(encoder_output_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(*encoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -336,6 +347,7 @@ Status BeamSearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, init_cache_indir_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetEncoderOutputCache(encoder_output_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(*encoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -360,6 +372,7 @@ Status BeamSearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, init_cache_indir_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      impl.SetEncoderOutputCache(encoder_output_cache_.get());
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(*encoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -8,6 +8,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "contrib_ops/cpu/transformers/beam_search_parameters.h"
+#include "contrib_ops/cpu/transformers/encoder_output_cache.h"
 #include "contrib_ops/cpu/transformers/subgraph_gpt.h"
 #include "contrib_ops/cpu/transformers/subgraph_t5_encoder.h"
 #include "contrib_ops/cpu/transformers/subgraph_t5_decoder.h"
@@ -181,6 +182,9 @@ class BeamSearch : public IControlFlowKernel {
 
   bool has_init_decoder_ = false;
 
+  // Relevant only for T5 and Whisper, null when the encoder outputs are not cached.
+  std::unique_ptr<EncoderOutputCache> encoder_output_cache_;
+
   GenerationDeviceHelper::UpdateDecoderCrossQKFunc update_decoder_cross_qk_func_;
 
   GenerationDeviceHelper::FinalizeDecoderCrossQKFunc finalize_decoder_cross_qk_func_;
@@ -6,6 +6,7 @@
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/generation_shared.h"  // for DEBUG_GENERATION
 #include "contrib_ops/cpu/transformers/beam_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/encoder_output_cache.h"
 #include "contrib_ops/cpu/transformers/subgraph_whisper_encoder.h"
 #include "contrib_ops/cpu/transformers/subgraph_whisper_decoder.h"
 
@@ -78,6 +79,11 @@ class BeamSearchWhisper : public BeamSearchBase<T> {
   }
 #endif
 
+  // Reuse the encoder outputs of previous runs with the same encoder inputs. The cache may be null.
+  void SetEncoderOutputCache(EncoderOutputCache* encoder_output_cache) {
+    encoder_output_cache_ = encoder_output_cache;
+  }
+
   // Execute beam search in iterations util stopping criteria is reached.
   Status Execute(const FeedsFetchesManager& encoder_feeds_fetches_manager,
                  const FeedsFetchesManager& decoder_feeds_fetches_manager);
@@ -88,6 +94,8 @@ class BeamSearchWhisper : public BeamSearchBase<T> {
   WhisperEncoderSubgraph& encoder_subgraph_;
   WhisperDecoderSubgraph& decoder_subgraph_;
 
+  EncoderOutputCache* encoder_output_cache_ = nullptr;
+
   // Device specific functions
   GenerationDeviceHelper::AddToFeedsFunc add_to_feeds_func_;
   GenerationDeviceHelper::InitBeamStateFunc<T> init_beam_state_func_;
@@ -178,15 +186,22 @@ Status BeamSearchWhisper<T>::Execute(const FeedsFetchesManager& encoder_feeds_fe
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   const_cast<SessionState&>(this->encoder_session_state_).IncrementGraphExecutionCounter();
 #endif
-  ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(this->encoder_session_state_,
-                                             encoder_feeds_fetches_manager,
-                                             encoder_feeds,
-                                             encoder_fetches,
-                                             {},
-                                             ExecutionMode::ORT_SEQUENTIAL,
-                                             this->context_.GetTerminateFlag(),
-                                             this->context_.Logger(),
-                                             this->ort_stream_));
+  const auto encoder_subgraph_feeds = gsl::make_span(encoder_feeds).first(
+      static_cast<size_t>(this->encoder_subgraph_.num_subgraph_inputs));
+  if (encoder_output_cache_ == nullptr || !encoder_output_cache_->Find(encoder_subgraph_feeds, encoder_fetches)) {
+    ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(this->encoder_session_state_,
+                                               encoder_feeds_fetches_manager,
+                                               encoder_feeds,
+                                               encoder_fetches,
+                                               {},
+                                               ExecutionMode::ORT_SEQUENTIAL,
+                                               this->context_.GetTerminateFlag(),
+                                               this->context_.Logger(),
+                                               this->ort_stream_));
+    if (encoder_output_cache_ != nullptr) {
+      encoder_output_cache_->Add(encoder_subgraph_feeds, encoder_fetches);
+    }
+  }
 
 #ifdef DEBUG_GENERATION
   const IConsoleDumper* dumper = this->GetConsoleDumper();
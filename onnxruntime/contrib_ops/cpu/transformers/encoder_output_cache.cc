@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/transformers/encoder_output_cache.h"
+
+#include <mutex>
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+EncoderOutputCache::EncoderOutputCache(size_t max_entries) : max_entries_(max_entries) {
+  ORT_ENFORCE(max_entries_ > 0, "The encoder output cache needs room for at least one entry.");
+}
+
+bool EncoderOutputCache::MakeKey(gsl::span<const OrtValue> feeds, std::string& key) {
+  key.clear();
+  for (const OrtValue& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return false;
+    }
+    const Tensor& tensor = feed.Get<Tensor>();
+    if (tensor.Location().device.Type() != OrtDevice::CPU || tensor.IsDataTypeString()) {
+      return false;
+    }
+
+    // element type, rank and dims before the data, so that inputs of different shapes never share a key
+    const int32_t element_type = tensor.GetElementType();
+    const auto dims = tensor.Shape().GetDims();
+    const size_t rank = dims.size();
+    key.append(reinterpret_cast<const char*>(&element_type), sizeof(element_type));
+    key.append(reinterpret_cast<const char*>(&rank), sizeof(rank));
+    key.append(reinterpret_cast<const char*>(dims.data()), dims.size_bytes());
+    key.append(static_cast<const char*>(tensor.DataRaw()), tensor.SizeInBytes());
+  }
+  return true;
+}
+
+bool EncoderOutputCache::Find(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches) {
+  std::string key;
+  if (!MakeKey(feeds, key)) {
+    return false;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return false;
+  }
+
+  entries_.splice(entries_.begin(), entries_, it->second);
+  fetches = it->second->second;
+  return true;
+}
+
+void EncoderOutputCache::Add(gsl::span<const OrtValue> feeds, const std::vector<OrtValue>& fetches) {
+  std::string key;
+  if (!MakeKey(feeds, key)) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (index_.find(key) != index_.end()) {
+    return;  // added by a concurrent run with the same inputs
+  }
+
+  if (entries_.size() == max_entries_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, fetches);
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <gsl/gsl>
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace contrib {
+namespace transformers {
+
+// Keeps the encoder subgraph outputs of the last inputs seen by an encoder-decoder generation op, so that decoding
+// the same audio or text again, e.g. Whisper falling back to another temperature, does not run the encoder again.
+// Entries are keyed by the contents of the encoder subgraph inputs, and only inputs in CPU memory are cached.
+// The cached outputs are only read by the decoding, which copies them into the expanded decoder inputs.
+class EncoderOutputCache {
+ public:
+  explicit EncoderOutputCache(size_t max_entries);
+
+  // Gets the encoder outputs for the subgraph inputs in feeds. Returns false when they are not cached.
+  bool Find(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches);
+
+  // Adds the encoder outputs for the subgraph inputs in feeds, evicting the least recently used ones when full.
+  void Add(gsl::span<const OrtValue> feeds, const std::vector<OrtValue>& fetches);
+
+ private:
+  // Returns false when the inputs can't be cached, e.g. when one is in device memory.
+  static bool MakeKey(gsl::span<const OrtValue> feeds, std::string& key);
+
+  using Entry = std::pair<std::string, std::vector<OrtValue>>;
+
+  const size_t max_entries_;
+  OrtMutex mutex_;
+  std::list<Entry> entries_;  // most recently used first
+  std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+};
+
+}  // namespace transformers
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -7,7 +7,9 @@
 #include "core/providers/cpu/math/top_k.h"
 #include "core/providers/cpu/math/softmax_shared.h"
 #include "core/providers/cpu/generator/random.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/safeint.h"
+#include "core/platform/threadpool.h"
 #include <gsl/gsl>
 #include "contrib_ops/cpu/transformers/sequences.h"
 #include "contrib_ops/cpu/transformers/beam_search_scorer.h"
@@ -359,16 +361,16 @@ Status ProcessLogits(const OrtValue& logits,                                 //
 
   // Add beam score to next token scores. Corresponding python code is like:
   //    next_token_scores = next_token_scores + beam_scores[:, None].expand_as(next_token_scores)
-  // TODO(tianleiwu): use thread pool to parallel
-  int offset = 0;
-  int batch_beam_index = 0;
-  for (int i = 0; i < batch_size; i++) {
-    for (int j = 0; j < num_beams; j++, batch_beam_index++) {
-      for (int k = 0; k < vocab_size; k++, offset++) {
-        next_token_scores[offset] += beam_state->beam_scores[batch_beam_index];
-      }
-    }
-  }
+  T* scores = next_token_scores.data();
+  const float* beam_scores = beam_state->beam_scores.data();
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(next_token_scores.size()),
+      TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(T)), 1.0},
+      [scores, beam_scores, vocab_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t offset = first; offset < last; offset++) {
+          scores[offset] += beam_scores[offset / vocab_size];
+        }
+      });
 
 #ifdef DEBUG_GENERATION
   dumper->Print("next_token_scores adding beam_scores", next_token_scores.data(), batch_size, num_beams, vocab_size);
@@ -555,44 +557,66 @@ Status DeviceCopy(gsl::span<T> target, gsl::span<const T> source, Stream* /*stre
   return Status::OK();
 }
 
-// Copy present state to past state for GPT model
+// Reorder the present state in place to the selected beams and use it as past state for GPT model.
+// A beam that continues its own sequence, which is the common case, is left as is instead of being copied to a new
+// past state, and only the blocks of the beams that both move and are the source of another beam are staged.
 template <typename T>
 void PickGptPastState(const std::vector<OrtValue>& last_outputs,
                       std::vector<OrtValue>& next_inputs,
                       gsl::span<const int32_t>& beam_indices,
                       int gpt_subgraph_first_past_input_idx,
                       int gpt_subgraph_first_present_output_idx,
-                      AllocatorPtr allocator) {
+                      AllocatorPtr /*allocator*/) {
+  // For each beam j taking the state of another beam, the staged copy of its source if the source is overwritten.
+  const size_t batch_beam_size = beam_indices.size();
+  InlinedVector<int> staged_slot(batch_beam_size, -1);
+  InlinedVector<size_t> staged_beams;
+  for (size_t j = 0; j < batch_beam_size; j++) {
+    const size_t source = static_cast<size_t>(beam_indices[j]);
+    if (source != j && static_cast<size_t>(beam_indices[source]) != source && staged_slot[source] < 0) {
+      staged_slot[source] = static_cast<int>(staged_beams.size());
+      staged_beams.push_back(source);
+    }
+  }
+
+  std::vector<T> staging;
   int num_present_tensors = static_cast<int>(last_outputs.size()) - gpt_subgraph_first_present_output_idx;
   for (ptrdiff_t i = 0; i < num_present_tensors; ++i) {
-    const OrtValue& present = last_outputs[gpt_subgraph_first_present_output_idx + i];
+    // The present state is not used after this, so it is reordered in place and fed as past state.
+    OrtValue& present = const_cast<OrtValue&>(last_outputs[gpt_subgraph_first_present_output_idx + i]);
 
     // shape is like (2, batch_beam_size, 12, past_seq_len, 64)
     const TensorShape& past_shape = present.Get<Tensor>().Shape();
-    auto block_size_per_beam = past_shape[2] * past_shape[3] * past_shape[4];
-    auto past_key_size = past_shape[1] * past_shape[2] * past_shape[3] * past_shape[4];
+    const size_t block_size_per_beam = onnxruntime::narrow<size_t>(past_shape[2] * past_shape[3] * past_shape[4]);
+    const size_t past_key_size = onnxruntime::narrow<size_t>(past_shape[1]) * block_size_per_beam;
+    T* present_data = present.GetMutable<Tensor>()->MutableData<T>();
+
+    // key and value blocks of the staged beams
+    staging.resize(2 * staged_beams.size() * block_size_per_beam);
+    for (size_t slot = 0; slot < staged_beams.size(); slot++) {
+      const T* key = present_data + staged_beams[slot] * block_size_per_beam;
+      std::copy_n(key, block_size_per_beam, staging.data() + 2 * slot * block_size_per_beam);
+      std::copy_n(key + past_key_size, block_size_per_beam, staging.data() + (2 * slot + 1) * block_size_per_beam);
+    }
 
-    // Create a tensor with same shape.
-    // TODO(tianleiwu): allocate one buffer for all layers
-    OrtValue past;
-    auto past_type = DataTypeImpl::GetType<T>();
-    Tensor::InitOrtValue(past_type, past_shape, allocator, past);
+    for (size_t j = 0; j < batch_beam_size; j++) {
+      const size_t source = static_cast<size_t>(beam_indices[j]);
+      if (source == j) {
+        continue;
+      }
 
-    gsl::span<T> past_span = gsl::make_span<T>(past.GetMutable<Tensor>()->MutableData<T>(), onnxruntime::narrow<size_t>(past_shape.Size()));
-    gsl::span<const T> present_span = gsl::make_span<const T>(present.Get<Tensor>().Data<T>(), onnxruntime::narrow<size_t>(past_shape.Size()));
-    for (size_t j = 0; j < beam_indices.size(); j++) {
-      int32_t beam_index = beam_indices[j];
-      gsl::span<const T> present_key = present_span.subspan(beam_index * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
-      gsl::span<const T> present_value = present_span.subspan(past_key_size + beam_index * SafeInt<size_t>(block_size_per_beam),
-                                                              onnxruntime::narrow<size_t>(block_size_per_beam));
-
-      gsl::span<T> past_key = past_span.subspan(j * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
-      gsl::span<T> past_value = past_span.subspan(past_key_size + j * SafeInt<size_t>(block_size_per_beam), onnxruntime::narrow<size_t>(block_size_per_beam));
-      gsl::copy(present_key, past_key);
-      gsl::copy(present_value, past_value);
+      const T* source_key = present_data + source * block_size_per_beam;
+      const T* source_value = source_key + past_key_size;
+      if (staged_slot[source] >= 0) {
+        source_key = staging.data() + 2 * static_cast<size_t>(staged_slot[source]) * block_size_per_beam;
+        source_value = source_key + block_size_per_beam;
+      }
+      T* past_key = present_data + j * block_size_per_beam;
+      std::copy_n(source_key, block_size_per_beam, past_key);
+      std::copy_n(source_value, block_size_per_beam, past_key + past_key_size);
     }
 
-    next_inputs[gpt_subgraph_first_past_input_idx + i] = past;
+    next_inputs[gpt_subgraph_first_past_input_idx + i] = present;
   }
 }
 
@@ -94,6 +94,11 @@ void GreedySearch::Init(const OpKernelInfo& info) {
     if (info.GetAttr<ONNX_NAMESPACE::GraphProto>("init_decoder", &proto).IsOK()) {
       has_init_decoder_ = true;
     }
+
+    // Check if the draft_decoder sub-graph attribute is present for speculative decoding.
+    if (info.GetAttr<ONNX_NAMESPACE::GraphProto>("draft_decoder", &proto).IsOK()) {
+      has_draft_decoder_ = true;
+    }
   }
 
   // Make sure the decoder sub-graph attribute is present for all model types.
@@ -132,6 +137,12 @@ Status GreedySearch::SetupSubgraphExecutionInfo(const SessionState& session_stat
 
       init_run_gpt_subgraph_ = std::move(res.second);
       init_run_decoder_feeds_fetches_manager_ = init_run_gpt_subgraph_->GetFeedsFetchesManager();
+    } else if (attribute_name == "draft_decoder") {
+      ORT_ENFORCE(draft_gpt_subgraph_ == nullptr, "SetupSubgraphExecutionInfo should only be called once for each subgraph.");
+      // The draft model has its own number of heads and layers, so the parameters are not updated from it.
+      draft_gpt_subgraph_ = std::make_unique<GptSubgraph>(node, attribute_name, subgraph_session_state.GetGraphViewer());
+      ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->Setup(session_state, subgraph_session_state));
+      draft_decoder_feeds_fetches_manager_ = draft_gpt_subgraph_->GetFeedsFetchesManager();
     }
   } else if (parameters_.model_type == IGenerationParameters::kModelTypeT5) {  // encoder-decoder like T5
     ORT_THROW("Not Implemented");
@@ -178,6 +189,12 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
                 "past_present_share_buffer mode must be same for init decoder and decoder subgraphes");
   }
 
+  auto* draft_decoder_session_state = ctx_internal->SubgraphSessionState("draft_decoder");
+  if (has_draft_decoder_) {
+    ORT_ENFORCE(draft_decoder_session_state, "Subgraph SessionState was not found for 'draft_decoder' attribute.");
+    ORT_ENFORCE(draft_decoder_feeds_fetches_manager_, "CreateFeedsFetchesManager must be called prior to execution of graph.");
+  }
+
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   // make a copy since we will update the parameters based on inputs later
@@ -206,6 +223,10 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
+      if (has_draft_decoder_) {
+        impl.InitializeSpeculativeDecoding(*draft_decoder_session_state, *draft_gpt_subgraph_,
+                                           *draft_decoder_feeds_fetches_manager_, parameters.num_speculative_tokens);
+      }
       ORT_RETURN_IF_ERROR(impl.Initialize());
 
       return impl.Execute(init_run_decoder_feeds_fetches_manager_, *decoder_feeds_fetches_manager_);
@@ -227,6 +248,7 @@ Status GreedySearch::Compute(OpKernelContext* ctx) const {
           init_greedy_state_fp16_func_,
           device_copy_func_,
           update_gpt_feeds_fp16_func_};
+      ORT_RETURN_IF(has_draft_decoder_, "Speculative decoding does not support float16 decoder subgraphs");
 #ifdef USE_CUDA
       ORT_RETURN_IF_ERROR(impl.InitializeCuda(reorder_past_state_func_, cuda_device_prop_, cuda_device_arch_));
 #endif
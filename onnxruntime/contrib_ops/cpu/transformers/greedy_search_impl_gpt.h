@@ -3,8 +3,11 @@
 
 #pragma once
 #include <algorithm>
+#include <limits>
+#include <numeric>
 #include <vector>
 
+#include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
 
@@ -79,12 +82,39 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
   }
 #endif
 
+  // Use speculative decoding: the draft decoder proposes up to num_speculative_tokens tokens one at a time, then the
+  // decoder verifies all of them in a single run and keeps the longest prefix that matches its own greedy choices.
+  void InitializeSpeculativeDecoding(const SessionState& draft_decoder_session_state,
+                                     GptSubgraph& draft_gpt_subgraph,
+                                     const FeedsFetchesManager& draft_feeds_fetches_manager,
+                                     int num_speculative_tokens) {
+    draft_decoder_session_state_ = &draft_decoder_session_state;
+    draft_gpt_subgraph_ = &draft_gpt_subgraph;
+    draft_feeds_fetches_manager_ = &draft_feeds_fetches_manager;
+    num_speculative_tokens_ = num_speculative_tokens;
+  }
+
   // Execute beam search in iterations util stopping criteria is reached.
   // In each iteration, GPT subgraph is called, and next token for each sequence is generated.
   Status Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                  const FeedsFetchesManager& feeds_fetches_manager);
 
  private:
+  // Execute greedy search with speculative decoding.
+  Status ExecuteSpeculative(const FeedsFetchesManager& feeds_fetches_manager);
+
+  // Run the decoder or the draft decoder on the tokens at [past_length, past_length + tokens.size()) of the sequence,
+  // and keep the first valid_past_length positions of the present state as the past state for the next run.
+  Status RunSpeculativeStep(const SessionState& session_state,
+                            const FeedsFetchesManager& feeds_fetches_manager,
+                            GptSubgraph& subgraph,
+                            gsl::span<const int32_t> tokens,
+                            int past_length,
+                            int first_position,
+                            gsl::span<const int32_t> prompt_attention_mask,
+                            std::vector<OrtValue>& feeds,
+                            OrtValue& logits);
+
   // Prepare the inputs for first inference of subgraph
   Status CreateInitialFeeds(gsl::span<int32_t>& sequence_lengths,
                             OrtValue& expanded_input_ids,
@@ -101,6 +131,19 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
       gsl::span<const int32_t> next_tokens,
       int past_sequence_length);
 
+  // Evict the rows that met EOS from the subgraph inputs, so that the remaining iterations only run the rows
+  // that are still generating. active_rows maps the rows of the subgraph inputs to the rows of the batch.
+  Status EvictFinishedRows(gsl::span<const bool> eos_meet,
+                           std::vector<int32_t>& active_rows,
+                           std::vector<OrtValue>& feeds,
+                           OrtValue& position_ids,
+                           gsl::span<int32_t> next_positions);
+
+  // Scatter the logits of the active rows to their rows of the batch. Rows that are not active get zero logits.
+  Status ScatterLogits(const OrtValue& active_logits,
+                       gsl::span<const int32_t> active_rows,
+                       OrtValue& batch_logits);
+
   const SessionState* init_run_decoder_session_state_ = nullptr;
   GptSubgraph* init_run_gpt_subgraph_ = nullptr;
   GptSubgraph& gpt_subgraph_;
@@ -116,6 +159,12 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
 
   const void* cuda_device_prop_ = nullptr;
   int cuda_device_arch_ = 0;
+
+  // Speculative decoding
+  const SessionState* draft_decoder_session_state_ = nullptr;
+  GptSubgraph* draft_gpt_subgraph_ = nullptr;
+  const FeedsFetchesManager* draft_feeds_fetches_manager_ = nullptr;
+  int num_speculative_tokens_ = 0;
 };
 
 template <typename T, typename ParametersT>
@@ -187,9 +236,371 @@ Status GreedySearchGpt<T, ParametersT>::UpdateFeeds(
                             false);
 }
 
+namespace gpt_details {
+// Copy the given rows along batch_axis of input to a new tensor.
+inline void SelectRows(const Tensor& input, size_t batch_axis, gsl::span<const size_t> rows,
+                       AllocatorPtr allocator, OrtValue& output) {
+  const TensorShape& input_shape = input.Shape();
+  const size_t outer_count = onnxruntime::narrow<size_t>(input_shape.SizeToDimension(batch_axis));
+  const size_t batch_size = onnxruntime::narrow<size_t>(input_shape[batch_axis]);
+  const size_t row_bytes = onnxruntime::narrow<size_t>(input_shape.SizeFromDimension(batch_axis + 1)) *
+                           input.DataType()->Size();
+
+  TensorShapeVector output_dims = input_shape.AsShapeVector();
+  output_dims[batch_axis] = static_cast<int64_t>(rows.size());
+  Tensor::InitOrtValue(input.DataType(), TensorShape(output_dims), std::move(allocator), output);
+
+  const auto* source = static_cast<const uint8_t*>(input.DataRaw());
+  auto* target = static_cast<uint8_t*>(output.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t i = 0; i < outer_count; ++i) {
+    for (size_t row : rows) {
+      memcpy(target, source + (i * batch_size + row) * row_bytes, row_bytes);
+      target += row_bytes;
+    }
+  }
+}
+
+// Keep the first past_length positions of a present state with shape (2, batch_size, num_heads, seq_len, head_size).
+// present is taken by value so that past can be the same OrtValue.
+inline void TruncatePastState(OrtValue present, int64_t past_length, AllocatorPtr allocator, OrtValue& past) {
+  const Tensor& present_tensor = present.Get<Tensor>();
+  const TensorShape& present_shape = present_tensor.Shape();
+  if (present_shape[3] == past_length) {
+    past = std::move(present);
+    return;
+  }
+
+  TensorShapeVector past_dims = present_shape.AsShapeVector();
+  past_dims[3] = past_length;
+  Tensor::InitOrtValue(present_tensor.DataType(), TensorShape(past_dims), std::move(allocator), past);
+
+  const size_t element_size = present_tensor.DataType()->Size();
+  const size_t present_chunk_bytes = onnxruntime::narrow<size_t>(present_shape.SizeFromDimension(3)) * element_size;
+  const size_t past_chunk_bytes = onnxruntime::narrow<size_t>(past_length * present_shape[4]) * element_size;
+  const size_t num_chunks = onnxruntime::narrow<size_t>(present_shape.SizeToDimension(3));
+  const auto* source = static_cast<const uint8_t*>(present_tensor.DataRaw());
+  auto* target = static_cast<uint8_t*>(past.GetMutable<Tensor>()->MutableDataRaw());
+  for (size_t i = 0; i < num_chunks; ++i) {
+    memcpy(target + i * past_chunk_bytes, source + i * present_chunk_bytes, past_chunk_bytes);
+  }
+}
+
+inline float LogitToFloat(float logit) { return logit; }
+inline float LogitToFloat(MLFloat16 logit) { return logit.ToFloat(); }
+
+// Greedy choice for the given row of logits with shape (1, sequence_length, vocab_size). The EOS token is not
+// chosen while the sequence is shorter than min_length, the same as MinLengthLogitsProcessor.
+template <typename T>
+int32_t GetGreedyToken(const Tensor& logits, int64_t row, int vocab_size, int eos_token_id, bool allow_eos) {
+  const T* row_logits = logits.Data<T>() + row * logits.Shape()[2];
+  int32_t token = -1;
+  float best = std::numeric_limits<float>::lowest();
+  for (int i = 0; i < vocab_size; ++i) {
+    const float logit = LogitToFloat(row_logits[i]);
+    if ((token < 0 || logit > best) && (allow_eos || i != eos_token_id)) {
+      token = i;
+      best = logit;
+    }
+  }
+  return token;
+}
+}  // namespace gpt_details
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::RunSpeculativeStep(const SessionState& session_state,
+                                                           const FeedsFetchesManager& feeds_fetches_manager,
+                                                           GptSubgraph& subgraph,
+                                                           gsl::span<const int32_t> tokens,
+                                                           int past_length,
+                                                           int first_position,
+                                                           gsl::span<const int32_t> prompt_attention_mask,
+                                                           std::vector<OrtValue>& feeds,
+                                                           OrtValue& logits) {
+  // The initial feeds of the prompt are used as is for the first run.
+  if (past_length > 0) {
+    auto int32_type = DataTypeImpl::GetType<int32_t>();
+    const int64_t num_tokens = static_cast<int64_t>(tokens.size());
+    int64_t dims[] = {1, num_tokens};
+    OrtValue input_ids;
+    Tensor::InitOrtValue(int32_type, TensorShape(&dims[0], 2), this->temp_space_allocator_, input_ids);
+    gsl::copy(tokens, input_ids.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>());
+    feeds[0] = input_ids;
+
+    OrtValue position_ids;
+    Tensor::InitOrtValue(int32_type, TensorShape(&dims[0], 2), this->temp_space_allocator_, position_ids);
+    auto positions = position_ids.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+    std::iota(positions.begin(), positions.end(), first_position);
+    feeds[1] = position_ids;
+
+    int64_t mask_dims[] = {1, past_length + num_tokens};
+    OrtValue attention_mask;
+    Tensor::InitOrtValue(int32_type, TensorShape(&mask_dims[0], 2), this->temp_space_allocator_, attention_mask);
+    auto mask = attention_mask.GetMutable<Tensor>()->MutableDataAsSpan<int32_t>();
+    std::fill(mask.begin(), mask.end(), 1);
+    gsl::copy(prompt_attention_mask, mask.first(prompt_attention_mask.size()));
+    feeds[2] = attention_mask;
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(utils::ExecuteSubgraph(session_state,
+                                             feeds_fetches_manager,
+                                             feeds,
+                                             fetches,
+                                             {},
+                                             ExecutionMode::ORT_SEQUENTIAL,
+                                             this->context_.GetTerminateFlag(),
+                                             this->context_.Logger(),
+                                             this->ort_stream_));
+
+  logits = fetches[0];
+  // The present state holds the tokens of this run, some of which may be rolled back by the caller later.
+  const int first_present = subgraph.GetFirstPresentOutputIndex();
+  const int k = subgraph.GetFirstPastInputIndex() - first_present;
+  for (int i = first_present; i < static_cast<int>(fetches.size()); ++i) {
+    feeds[static_cast<size_t>(i) + k] = fetches[i];
+  }
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::ExecuteSpeculative(const FeedsFetchesManager& feeds_fetches_manager) {
+  const ParametersT* parameters = this->parameters_;
+  ORT_RETURN_IF(this->IsCuda(), "Speculative decoding is only supported on CPU");
+  ORT_RETURN_IF(parameters->batch_size != 1, "Speculative decoding only supports batch_size of 1, got ",
+                parameters->batch_size);
+  ORT_RETURN_IF(init_run_gpt_subgraph_ != nullptr, "Speculative decoding does not support the init_decoder subgraph");
+  ORT_RETURN_IF(gpt_subgraph_.past_present_share_buffer_ || draft_gpt_subgraph_->past_present_share_buffer_,
+                "Speculative decoding does not support past_present_share_buffer");
+  ORT_RETURN_IF(draft_gpt_subgraph_->vocab_size != gpt_subgraph_.vocab_size,
+                "The draft_decoder subgraph shall have the same vocabulary size as the decoder subgraph, got ",
+                draft_gpt_subgraph_->vocab_size, " and ", gpt_subgraph_.vocab_size);
+  // Drafts are verified against the greedy choice, which the other logits processors would change.
+  ORT_RETURN_IF(parameters->repetition_penalty != 1.0f || !parameters->vocab_mask.empty() ||
+                    !parameters->prefix_vocab_mask.empty() || !parameters->presence_mask.empty() ||
+                    parameters->no_repeat_ngram_size > 0,
+                "Speculative decoding does not support repetition_penalty, vocab_mask, prefix_vocab_mask, "
+                "presence_mask or no_repeat_ngram_size");
+
+  int64_t sequences_dims[] = {parameters->batch_size, parameters->max_length};
+  TensorShape sequences_shape(&sequences_dims[0], sizeof(sequences_dims) / sizeof(sequences_dims[0]));
+  Tensor* output_sequences = this->context_.Output(0, sequences_shape);
+
+  const OrtValue* input_ids_value = this->context_.GetInputOrtValue(0);
+  const Tensor& input_ids = input_ids_value->Get<Tensor>();
+  const OrtValue* attn_mask_value = this->context_.GetInputOrtValue(6);
+
+  std::vector<int32_t> sequence_lengths_buffer(1);
+  gsl::span<int32_t> sequence_lengths = sequence_lengths_buffer;
+  std::vector<OrtValue> feeds;
+  std::vector<OrtValue> draft_feeds;
+  OrtValue expanded_input_ids;
+  OrtValue draft_expanded_input_ids;
+  IAllocatorUniquePtr<char> buffer;
+  IAllocatorUniquePtr<char> draft_buffer;
+  ORT_RETURN_IF_ERROR(CreateInitialFeeds(sequence_lengths, expanded_input_ids, feeds, buffer));
+  ORT_RETURN_IF_ERROR(draft_gpt_subgraph_->CreateInitialFeeds(input_ids,
+                                                              this->implicit_inputs_,
+                                                              parameters->num_beams,
+                                                              parameters->pad_token_id,
+                                                              sequence_lengths,
+                                                              draft_expanded_input_ids,
+                                                              attn_mask_value,
+                                                              draft_feeds,
+                                                              this->create_inputs_func_,
+                                                              this->add_to_feeds_func_,
+                                                              draft_buffer,
+                                                              this->ort_stream_,
+                                                              parameters->max_length));
+
+  const int prompt_length = parameters->sequence_length;
+  std::vector<int32_t> prompt_attention_mask(static_cast<size_t>(prompt_length));
+  gsl::copy(feeds[2].Get<Tensor>().DataAsSpan<int32_t>(), gsl::make_span(prompt_attention_mask));
+  // Position of the first token after the prompt, tokens after it are at consecutive positions.
+  const int next_position = sequence_lengths[0];
+
+  std::vector<int32_t> sequence;
+  sequence.reserve(static_cast<size_t>(parameters->max_length) + num_speculative_tokens_);
+  auto prompt = expanded_input_ids.Get<Tensor>().DataAsSpan<int32_t>();
+  sequence.assign(prompt.begin(), prompt.end());
+
+  const int vocab_size = parameters->vocab_size;
+  const int eos_token_id = parameters->eos_token_id;
+  auto get_position = [&](int index) { return next_position + index - prompt_length; };
+  auto allow_eos = [&](int index) { return index >= parameters->min_length; };
+
+  // Number of tokens of the sequence that the past state of the decoder and of the draft decoder hold.
+  int past_length = 0;
+  int draft_past_length = 0;
+  OrtValue logits;
+  bool eos_meet = false;
+  while (!eos_meet && static_cast<int>(sequence.size()) < parameters->max_length) {
+    const int current_length = static_cast<int>(sequence.size());
+
+    // The draft decoder proposes tokens one at a time, leaving room for the token that the decoder adds.
+    std::vector<int32_t> draft_tokens;
+    const int num_draft_tokens = past_length == 0 ? 0
+                                                  : std::min(num_speculative_tokens_,
+                                                             parameters->max_length - current_length - 1);
+    if (draft_past_length == 0) {
+      // Prefill the past state of the draft decoder with the prompt.
+      ORT_RETURN_IF_ERROR(RunSpeculativeStep(*draft_decoder_session_state_, *draft_feeds_fetches_manager_,
+                                             *draft_gpt_subgraph_, gsl::make_span(sequence), 0, 0,
+                                             prompt_attention_mask, draft_feeds, logits));
+      draft_past_length = prompt_length;
+    }
+    for (int i = 0; i < num_draft_tokens; ++i) {
+      std::vector<int32_t> pending(sequence.begin() + std::min(draft_past_length, current_length), sequence.end());
+      pending.insert(pending.end(), draft_tokens.begin() + std::max(draft_past_length - current_length, 0),
+                     draft_tokens.end());
+      ORT_RETURN_IF_ERROR(RunSpeculativeStep(*draft_decoder_session_state_, *draft_feeds_fetches_manager_,
+                                             *draft_gpt_subgraph_, pending, draft_past_length,
+                                             get_position(draft_past_length), prompt_attention_mask, draft_feeds,
+                                             logits));
+      draft_past_length += static_cast<int>(pending.size());
+
+      const Tensor& draft_logits = logits.Get<Tensor>();
+      const int index = current_length + i;
+      draft_tokens.push_back(gpt_details::GetGreedyToken<T>(draft_logits, draft_logits.Shape()[1] - 1, vocab_size,
+                                                            eos_token_id, allow_eos(index)));
+      if (draft_tokens.back() == eos_token_id) {
+        break;
+      }
+    }
+
+    // The decoder verifies the draft tokens in one run.
+    std::vector<int32_t> pending(sequence.begin() + past_length, sequence.end());
+    pending.insert(pending.end(), draft_tokens.begin(), draft_tokens.end());
+    ORT_RETURN_IF_ERROR(RunSpeculativeStep(this->decoder_session_state_, feeds_fetches_manager, gpt_subgraph_,
+                                           pending, past_length, get_position(past_length), prompt_attention_mask,
+                                           feeds, logits));
+
+    // Row r of the logits predicts the token at past_length + r + 1.
+    const Tensor& decoder_logits = logits.Get<Tensor>();
+    const int first_row_index = past_length + 1;
+    size_t num_accepted = 0;
+    int32_t next_token = gpt_details::GetGreedyToken<T>(decoder_logits, current_length - first_row_index, vocab_size,
+                                                        eos_token_id, allow_eos(current_length));
+    while (num_accepted < draft_tokens.size() && next_token == draft_tokens[num_accepted]) {
+      ++num_accepted;
+      const int index = current_length + static_cast<int>(num_accepted);
+      next_token = gpt_details::GetGreedyToken<T>(decoder_logits, index - first_row_index, vocab_size, eos_token_id,
+                                                  allow_eos(index));
+    }
+
+    // Append the accepted draft tokens and the token of the decoder after them.
+    std::vector<int32_t> new_tokens(draft_tokens.begin(), draft_tokens.begin() + num_accepted);
+    new_tokens.push_back(next_token);
+    for (int32_t token : new_tokens) {
+      if (token == eos_token_id) {
+        eos_meet = true;
+        sequence.push_back(parameters->pad_token_id);
+        break;
+      }
+      sequence.push_back(token);
+    }
+
+    // Roll back the past state of the rejected draft tokens. The last token is not in any past state yet.
+    const int valid_past_length = current_length + static_cast<int>(num_accepted);
+    past_length = valid_past_length;
+    draft_past_length = std::min(draft_past_length, valid_past_length);
+    for (int i = gpt_subgraph_.GetFirstPastInputIndex(); i < gpt_subgraph_.num_subgraph_inputs; ++i) {
+      gpt_details::TruncatePastState(feeds[i], past_length, this->temp_space_allocator_, feeds[i]);
+    }
+    for (int i = draft_gpt_subgraph_->GetFirstPastInputIndex(); i < draft_gpt_subgraph_->num_subgraph_inputs; ++i) {
+      gpt_details::TruncatePastState(draft_feeds[i], draft_past_length, this->temp_space_allocator_, draft_feeds[i]);
+    }
+  }
+
+  gsl::span<int32_t> output = output_sequences->MutableDataAsSpan<int32_t>();
+  std::fill(output.begin(), output.end(), parameters->pad_token_id);
+  gsl::copy(gsl::make_span(sequence), output.first(sequence.size()));
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::EvictFinishedRows(gsl::span<const bool> eos_meet,
+                                                          std::vector<int32_t>& active_rows,
+                                                          std::vector<OrtValue>& feeds,
+                                                          OrtValue& position_ids,
+                                                          gsl::span<int32_t> next_positions) {
+  std::vector<size_t> kept_rows;
+  kept_rows.reserve(active_rows.size());
+  for (size_t i = 0; i < active_rows.size(); ++i) {
+    if (!eos_meet[active_rows[i]]) {
+      kept_rows.push_back(i);
+    }
+  }
+  if (kept_rows.size() == active_rows.size()) {
+    return Status::OK();
+  }
+  ORT_RETURN_IF(kept_rows.empty(), "No rows left to generate");
+
+  // feeds: input_ids, position_ids, attention_mask, past_0, past_1, ...
+  OrtValue input_ids;
+  gpt_details::SelectRows(feeds[0].Get<Tensor>(), 0, kept_rows, this->temp_space_allocator_, input_ids);
+  feeds[0] = input_ids;
+
+  // Position IDs are kept in next_positions, so that they can be increased in place by UpdateFeeds.
+  for (size_t i = 0; i < kept_rows.size(); ++i) {
+    next_positions[i] = next_positions[kept_rows[i]];
+    active_rows[i] = active_rows[kept_rows[i]];
+  }
+  active_rows.resize(kept_rows.size());
+  int64_t position_dims[] = {static_cast<int64_t>(kept_rows.size()), 1};
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(),
+                       TensorShape(&position_dims[0], 2),
+                       next_positions.data(),
+                       this->temp_space_allocator_->Info(),
+                       position_ids);
+  feeds[1] = position_ids;
+
+  OrtValue attention_mask;
+  gpt_details::SelectRows(feeds[2].Get<Tensor>(), 0, kept_rows, this->temp_space_allocator_, attention_mask);
+  feeds[2] = attention_mask;
+
+  // Past state shape is like (2, batch_size, num_heads, past_seq_len, head_size).
+  // The implicit inputs after them are not per row.
+  for (int i = gpt_subgraph_.GetFirstPastInputIndex(); i < gpt_subgraph_.num_subgraph_inputs; ++i) {
+    OrtValue past;
+    gpt_details::SelectRows(feeds[i].Get<Tensor>(), 1, kept_rows, this->temp_space_allocator_, past);
+    feeds[i] = past;
+  }
+
+  return Status::OK();
+}
+
+template <typename T, typename ParametersT>
+Status GreedySearchGpt<T, ParametersT>::ScatterLogits(const OrtValue& active_logits,
+                                                      gsl::span<const int32_t> active_rows,
+                                                      OrtValue& batch_logits) {
+  // logits shape is (batch_size, sequence_length, vocab_size)
+  const Tensor& logits = active_logits.Get<Tensor>();
+  const TensorShape& logits_shape = logits.Shape();
+  ORT_RETURN_IF_NOT(logits_shape.NumDimensions() == 3 && logits_shape[0] == static_cast<int64_t>(active_rows.size()),
+                    "logits shall have shape (number of active rows, sequence_length, vocab_size)");
+
+  int64_t logits_dims[] = {this->parameters_->BatchBeamSize(), logits_shape[1], logits_shape[2]};
+  Tensor::InitOrtValue(logits.DataType(), TensorShape(&logits_dims[0], 3), this->temp_space_allocator_,
+                       batch_logits);
+  Tensor* batch_logits_tensor = batch_logits.GetMutable<Tensor>();
+  memset(batch_logits_tensor->MutableDataRaw(), 0, batch_logits_tensor->SizeInBytes());
+
+  const size_t row_bytes = onnxruntime::narrow<size_t>(logits_shape.SizeFromDimension(1)) * logits.DataType()->Size();
+  const auto* source = static_cast<const uint8_t*>(logits.DataRaw());
+  auto* target = static_cast<uint8_t*>(batch_logits_tensor->MutableDataRaw());
+  for (size_t i = 0; i < active_rows.size(); ++i) {
+    memcpy(target + static_cast<size_t>(active_rows[i]) * row_bytes, source + i * row_bytes, row_bytes);
+  }
+  return Status::OK();
+}
+
 template <typename T, typename ParametersT>
 Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_run_feeds_fetches_manager,
                                                 const FeedsFetchesManager& feeds_fetches_manager) {
+  if (draft_gpt_subgraph_ != nullptr) {
+    return ExecuteSpeculative(feeds_fetches_manager);
+  }
+
   auto status = Status::OK();
   const ParametersT* parameters = this->parameters_;
 
@@ -268,6 +679,12 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // On CPU, rows that met EOS are evicted from the subgraph inputs so that they stop costing compute.
+  // The state of the search stays indexed by the rows of the batch, active_rows maps the subgraph rows to them.
+  const bool evict_finished_rows = !this->IsCuda() && !gpt_subgraph_.past_present_share_buffer_;
+  std::vector<int32_t> active_rows(static_cast<size_t>(parameters->BatchBeamSize()));
+  std::iota(active_rows.begin(), active_rows.end(), 0);
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -312,7 +729,10 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    OrtValue logits = fetches[0];
+    if (active_rows.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      ORT_RETURN_IF_ERROR(ScatterLogits(fetches[0], active_rows, logits));
+    }
     gsl::span<int32_t> next_tokens;
 
     ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
@@ -361,10 +781,23 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
-      ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
-                                      position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
-                                      current_length - 1));
+      if (evict_finished_rows) {
+        std::vector<int32_t> active_next_tokens(active_rows.size());
+        for (size_t i = 0; i < active_rows.size(); ++i) {
+          active_next_tokens[i] = next_tokens[active_rows[i]];
+        }
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids, increase_position,
+                                        active_next_tokens,
+                                        current_length - 1));
+        ORT_RETURN_IF_ERROR(EvictFinishedRows(eos_meet, active_rows, feeds, position_ids,
+                                              greedy_state.next_positions));
+      } else {
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids, increase_position,
+                                        ReinterpretAsSpan<const int32_t>(next_tokens),
+                                        current_length - 1));
+      }
     }
     if (gpt_subgraph_.past_present_share_buffer_) {
       // clear fetched values before presents[]
@@ -16,6 +16,9 @@ struct GreedySearchParameters : public BeamSearchParameters {
   void ParseFromAttributes(const OpKernelInfo& info) override;
 
   void ParseFromInputs(OpKernelContext* context);
+
+  // Number of tokens proposed by the draft_decoder subgraph in each step of speculative decoding.
+  int num_speculative_tokens = 4;
 };
 
 }  // namespace transformers
@@ -6,6 +6,7 @@
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/common/span_utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/math/softmax_shared.h"
 #include "contrib_ops/cpu/transformers/logits_processor.h"
 #include "contrib_ops/cpu/utils/dump_tensor.h"
@@ -95,29 +96,6 @@ void NoRepeatNGramLogitsProcessor<T>::Process(const ISequences* sequences,
   }
 }
 
-template <typename T>
-VocabMaskLogitsProcessor<T>::VocabMaskLogitsProcessor(const gsl::span<const int32_t>& vocab_mask)
-    : vocab_mask_(vocab_mask) {
-}
-
-template <typename T>
-void VocabMaskLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
-                                          NextTokenScores<T>& next_token_scores) {
-  assert(!vocab_mask_.empty());
-
-  // Process vocabulary mask and set tokens with mask value 0 to -inf.
-  T* p = next_token_scores.scores.data();
-  // next_token_scores shape (batch_size * num_beams, vocab_size)
-  // vocab_mask shape (vocab_size).
-  for (int i = 0; i < next_token_scores.batch_beam_size; i++) {
-    for (int j = 0; j < next_token_scores.vocab_size; j++, p++) {
-      if (vocab_mask_[j] == 0) {
-        *p = std::numeric_limits<T>::lowest();
-      }
-    }
-  }
-}
-
 template <typename T>
 PrefixVocabMaskLogitsProcessor<T>::PrefixVocabMaskLogitsProcessor(const gsl::span<const int32_t>& prefix_vocab_mask,
                                                                   int batch_size)
@@ -150,54 +128,83 @@ void PrefixVocabMaskLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
 }
 
 template <typename T>
-TemperatureLogitsProcessor<T>::TemperatureLogitsProcessor(float temperature) : temperature_(temperature) {
+ElementwiseLogitsProcessor<T>::ElementwiseLogitsProcessor(const gsl::span<const int32_t>& vocab_mask,
+                                                          float temperature,
+                                                          const gsl::span<const int32_t>& presence_mask,
+                                                          float presence_penalty,
+                                                          onnxruntime::concurrency::ThreadPool* thread_pool)
+    : vocab_mask_(vocab_mask),
+      temperature_(temperature),
+      apply_temperature_(temperature != 1.0f),
+      presence_mask_(presence_mask),
+      presence_penalty_(presence_penalty),
+      apply_presence_penalty_(!presence_mask.empty() && presence_penalty != 0.0f),
+      thread_pool_(thread_pool) {
 }
 
 template <typename T>
-void TemperatureLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
+void ElementwiseLogitsProcessor<T>::Process(const ISequences* /*sequences*/,
                                             NextTokenScores<T>& next_token_scores) {
-  if (temperature_ == 1.0f) {
-    return;
-  }
-
-  T* p = next_token_scores.scores.data();
-  for (size_t i = 0; i < next_token_scores.scores.size(); i++) {
-    *p /= temperature_;
-    ++p;
-  }
-}
-
-template <typename T>
-PresencePenaltyLogitsProcessor<T>::PresencePenaltyLogitsProcessor(const gsl::span<const int32_t>& presence_mask,
-                                                                  float presence_penalty)
-    : presence_mask_(presence_mask), presence_penalty_(presence_penalty) {
-}
+  // next_token_scores shape (batch_size * num_beams, vocab_size)
+  // vocab_mask shape (vocab_size), and presence_mask has the same shape as next_token_scores.
+  const std::ptrdiff_t vocab_size = next_token_scores.vocab_size;
+  T* scores = next_token_scores.scores.data();
+  const int32_t* vocab_mask = vocab_mask_.empty() ? nullptr : vocab_mask_.data();
+  const int32_t* presence_mask = apply_presence_penalty_ ? presence_mask_.data() : nullptr;
+
+  // Set tokens with vocabulary mask value 0 to -inf, then apply the temperature and the presence penalty.
+  // [begin, end) is within a row.
+  const auto process = [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    const std::ptrdiff_t row_begin = begin - begin % vocab_size;
+    for (std::ptrdiff_t i = begin; i < end; i++) {
+      T score = scores[i];
+      if (vocab_mask != nullptr && vocab_mask[i - row_begin] == 0) {
+        score = std::numeric_limits<T>::lowest();
+      }
 
-template <typename T>
-void PresencePenaltyLogitsProcessor<T>::Process(const ISequences*,
-                                                NextTokenScores<T>& next_token_scores) {
-  if (presence_penalty_ == 0.0f) {
-    return;
-  }
+      if (apply_temperature_) {
+        score /= temperature_;
+      }
 
-  assert(!presence_mask_.empty());
+      if (presence_mask != nullptr) {
+        score -= presence_mask[i] * presence_penalty_;
+      }
 
-  T* p = next_token_scores.scores.data();
-  for (size_t i = 0; i < next_token_scores.scores.size(); i++) {
-    *p -= presence_mask_[i] * presence_penalty_;
-  }
+      scores[i] = score;
+    }
+  };
+
+  // The blocks of elements run in parallel are split at the ends of the rows, as the vocabulary mask is indexed by the
+  // position in the row.
+  const double cost_per_element = vocab_mask != nullptr ? 2.0 : 1.0;
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool_, static_cast<std::ptrdiff_t>(next_token_scores.scores.size()),
+      TensorOpCost{static_cast<double>(sizeof(T) + (vocab_mask != nullptr ? sizeof(int32_t) : 0) +
+                                       (presence_mask != nullptr ? sizeof(int32_t) : 0)),
+                   static_cast<double>(sizeof(T)), cost_per_element},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        while (first < last) {
+          const std::ptrdiff_t row_end = (first / vocab_size + 1) * vocab_size;
+          const std::ptrdiff_t end = std::min(last, row_end);
+          process(first, end);
+          first = end;
+        }
+      });
 }
 
-void LogitsProcessorList::Init(const BeamSearchParameters& parameters) {
-  LogitsProcessorInitImpl<BeamSearchParameters>(parameters);
+void LogitsProcessorList::Init(const BeamSearchParameters& parameters,
+                               onnxruntime::concurrency::ThreadPool* thread_pool) {
+  LogitsProcessorInitImpl<BeamSearchParameters>(parameters, thread_pool);
 }
 
-void LogitsProcessorList::Init(const GreedySearchParameters& parameters) {
-  LogitsProcessorInitImpl<GreedySearchParameters>(parameters);
+void LogitsProcessorList::Init(const GreedySearchParameters& parameters,
+                               onnxruntime::concurrency::ThreadPool* thread_pool) {
+  LogitsProcessorInitImpl<GreedySearchParameters>(parameters, thread_pool);
 }
 
-void LogitsProcessorList::Init(const SamplingParameters& parameters) {
-  LogitsProcessorInitImpl<SamplingParameters>(parameters);
+void LogitsProcessorList::Init(const SamplingParameters& parameters,
+                               onnxruntime::concurrency::ThreadPool* thread_pool) {
+  LogitsProcessorInitImpl<SamplingParameters>(parameters, thread_pool);
 }
 
 void LogitsProcessorList::Process(const ISequences* sequences,
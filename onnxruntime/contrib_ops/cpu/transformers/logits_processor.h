@@ -90,18 +90,6 @@ class NoRepeatNGramLogitsProcessor : public ILogitsProcessor<T> {
   int ngram_size_;
 };
 
-template <typename T>
-class VocabMaskLogitsProcessor : public ILogitsProcessor<T> {
- public:
-  VocabMaskLogitsProcessor(const gsl::span<const int32_t>& vocab_mask);
-
-  void Process(const ISequences* sequences,
-               NextTokenScores<T>& next_token_scores) override;
-
- private:
-  gsl::span<const int32_t> vocab_mask_;
-};
-
 template <typename T>
 class PrefixVocabMaskLogitsProcessor : public ILogitsProcessor<T> {
  public:
@@ -115,18 +103,6 @@ class PrefixVocabMaskLogitsProcessor : public ILogitsProcessor<T> {
   const int batch_size_;
 };
 
-template <typename T>
-class TemperatureLogitsProcessor : public ILogitsProcessor<T> {
- public:
-  TemperatureLogitsProcessor(float temperature);
-
-  void Process(const ISequences* sequences,
-               NextTokenScores<T>& next_token_scores) override;
-
- private:
-  float temperature_;
-};
-
 // template <typename T>
 // class TopPLogitsProcessor : public ILogitsProcessor<T> {
 //  public:
@@ -142,18 +118,34 @@ class TemperatureLogitsProcessor : public ILogitsProcessor<T> {
 //   onnxruntime::concurrency::ThreadPool* thread_pool_;
 // };
 
+// Applies the processors which change every score, i.e. the vocabulary mask, the temperature and the presence
+// penalty, in a single pass over the scores, which is split across the rows and chunks of the vocabulary run in
+// parallel. The scores are processed in the same order as by separate processors.
 template <typename T>
-class PresencePenaltyLogitsProcessor : public ILogitsProcessor<T> {
+class ElementwiseLogitsProcessor : public ILogitsProcessor<T> {
  public:
-  PresencePenaltyLogitsProcessor(const gsl::span<const int32_t>& presence_mask,
-                                 float presence_penalty);
+  ElementwiseLogitsProcessor(const gsl::span<const int32_t>& vocab_mask,
+                             float temperature,
+                             const gsl::span<const int32_t>& presence_mask,
+                             float presence_penalty,
+                             onnxruntime::concurrency::ThreadPool* thread_pool);
+
+  // Whether any of the processors changes the scores.
+  bool IsEnabled() const {
+    return !vocab_mask_.empty() || apply_temperature_ || apply_presence_penalty_;
+  }
 
   void Process(const ISequences* sequences,
                NextTokenScores<T>& next_token_scores) override;
 
  private:
+  gsl::span<const int32_t> vocab_mask_;
+  float temperature_;
+  bool apply_temperature_;
   gsl::span<const int32_t> presence_mask_;
   float presence_penalty_;
+  bool apply_presence_penalty_;
+  onnxruntime::concurrency::ThreadPool* thread_pool_;
 };
 
 template <typename T>
@@ -296,14 +288,15 @@ class TimestampLogitsProcessor : public ILogitsProcessor<T> {
 class LogitsProcessorList : public ILogitsProcessorList {
  public:
   LogitsProcessorList() = default;
-  void Init(const BeamSearchParameters& parameters);
-  void Init(const GreedySearchParameters& parameters);
-  void Init(const SamplingParameters& parameters);
+  void Init(const BeamSearchParameters& parameters, onnxruntime::concurrency::ThreadPool* thread_pool = nullptr);
+  void Init(const GreedySearchParameters& parameters, onnxruntime::concurrency::ThreadPool* thread_pool = nullptr);
+  void Init(const SamplingParameters& parameters, onnxruntime::concurrency::ThreadPool* thread_pool = nullptr);
   void Process(const ISequences* sequences, gsl::span<float>& next_token_scores, int step);
 
  private:
   template <typename GenerationParametersT>
-  void LogitsProcessorInitImpl(const GenerationParametersT& parameters) {
+  void LogitsProcessorInitImpl(const GenerationParametersT& parameters,
+                               onnxruntime::concurrency::ThreadPool* thread_pool) {
     processor_list_.clear();
 
     if (parameters.repetition_penalty != 1.0f) {  // 1.0 means no penalty
@@ -318,11 +311,6 @@ class LogitsProcessorList : public ILogitsProcessorList {
       processor_list_.push_back(no_repeat_ngram_processor_.get());
     }
 
-    if (!parameters.vocab_mask.empty()) {
-      vocab_mask_processor_ = std::make_unique<VocabMaskLogitsProcessor<float>>(parameters.vocab_mask);
-      processor_list_.push_back(vocab_mask_processor_.get());
-    }
-
     if (!parameters.prefix_vocab_mask.empty()) {
       prefix_vocab_mask_processor_ = std::make_unique<
           PrefixVocabMaskLogitsProcessor<float>>(parameters.prefix_vocab_mask,
@@ -336,16 +324,16 @@ class LogitsProcessorList : public ILogitsProcessorList {
       processor_list_.push_back(min_length_processor_.get());
     }
 
-    if (parameters.temperature > 0) {
-      temperature_processor_ = std::make_unique<TemperatureLogitsProcessor<float>>(parameters.temperature);
-      processor_list_.push_back(temperature_processor_.get());
-    }
-
-    if (!parameters.presence_mask.empty()) {
-      presence_penalty_processor_ = std::make_unique<
-          PresencePenaltyLogitsProcessor<float>>(parameters.presence_mask,
-                                                 parameters.presence_penalty);
-      processor_list_.push_back(presence_penalty_processor_.get());
+    // The vocabulary mask sets scores to the lowest value like the processors above, so it can be applied after them.
+    // It's applied in one pass over the scores with the temperature and the presence penalty.
+    elementwise_processor_ = std::make_unique<ElementwiseLogitsProcessor<float>>(
+        parameters.vocab_mask,
+        parameters.temperature > 0 ? parameters.temperature : 1.0f,
+        parameters.presence_mask,
+        parameters.presence_penalty,
+        thread_pool);
+    if (elementwise_processor_->IsEnabled()) {
+      processor_list_.push_back(elementwise_processor_.get());
     }
 
     // Add timestamp processor for whisper model
@@ -373,11 +361,9 @@ class LogitsProcessorList : public ILogitsProcessorList {
 
   std::unique_ptr<RepetitionPenaltyLogitsProcessor<float>> repetition_penalty_processor_;
   std::unique_ptr<NoRepeatNGramLogitsProcessor<float>> no_repeat_ngram_processor_;
-  std::unique_ptr<VocabMaskLogitsProcessor<float>> vocab_mask_processor_;
   std::unique_ptr<PrefixVocabMaskLogitsProcessor<float>> prefix_vocab_mask_processor_;
   std::unique_ptr<MinLengthLogitsProcessor<float>> min_length_processor_;
-  std::unique_ptr<TemperatureLogitsProcessor<float>> temperature_processor_;
-  std::unique_ptr<PresencePenaltyLogitsProcessor<float>> presence_penalty_processor_;
+  std::unique_ptr<ElementwiseLogitsProcessor<float>> elementwise_processor_;
   std::unique_ptr<TimestampLogitsProcessor<float>> timestamp_processor_;
 };
 
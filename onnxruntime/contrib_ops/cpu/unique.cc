@@ -8,8 +8,7 @@
 #pragma warning(disable : 4996)
 #endif
 #include "unique.h"
-#include "core/common/inlined_containers.h"
-#include "core/providers/cpu/tensor/utils.h"
+#include "core/providers/cpu/tensor/unique.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -29,44 +28,16 @@ Status Unique<float>::Compute(OpKernelContext* ctx) const {
   if (input->Shape().NumDimensions() != 1)
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input tensor to Unique op should be 1D");
 
-  // obtain raw input data
-  const float* input_data = input->Data<float>();
-  const auto num_elements = input->Shape().Size();
-
   // 'idx' output has same output shape as input
   Tensor* output_idx = ctx->Output(1, input->Shape());
-  int64_t* output_idx_data = output_idx->MutableData<int64_t>();
-
-  struct ElementData {
-    int64_t input_pos_;  // original index
-    int64_t output_pos_;
-    int64_t count_;  // number of times encountered
-  };
-
-  // XXX: Refactoring for less memory allocations. unordered_map
-  // used originally for float uniqueness, is this correct?
-  using IndexingMap = InlinedHashMap<float, ElementData>;
-  IndexingMap mapped_indices;
-  mapped_indices.reserve(onnxruntime::narrow<size_t>(num_elements));
 
-  // processing
-  for (int64_t i = 0; i < num_elements; ++i) {
-    float value = input_data[i];
-
-    const auto original_index = i;
-    const auto num_unique = static_cast<int64_t>(mapped_indices.size());
-    auto insert_result = mapped_indices.emplace(value, ElementData{original_index, num_unique, 1});
-    if (insert_result.second) {
-      output_idx_data[i] = num_unique;
-    } else {
-      // Seen before
-      output_idx_data[i] = insert_result.first->second.output_pos_;
-      insert_result.first->second.count_++;
-    }
-  }
+  // unique values in the order of their first occurrence
+  const auto unique_values = unique_op::FindUniqueValues(input->DataAsSpan<float>(), /*sorted*/ false,
+                                                         ctx->GetOperatorThreadPool(),
+                                                         output_idx->MutableDataAsSpan<int64_t>());
 
   // 'uniques' output
-  TensorShape output_shape({static_cast<int64_t>(mapped_indices.size())});
+  TensorShape output_shape({static_cast<int64_t>(unique_values.ordered.size())});
   Tensor* output_uniques = ctx->Output(0, output_shape);
   float* output_uniques_data = output_uniques->MutableData<float>();
 
@@ -74,12 +45,10 @@ Status Unique<float>::Compute(OpKernelContext* ctx) const {
   Tensor* output_counts = ctx->Output(2, output_shape);
   int64_t* output_counts_data = output_counts->MutableData<int64_t>();
 
-  for (const auto& e : mapped_indices) {
-    // 'uniques' data
-    const auto output_pos = e.second.output_pos_;
-    output_uniques_data[output_pos] = e.first;
-    // 'counts' data
-    output_counts_data[output_pos] = e.second.count_;
+  for (size_t i = 0, end = unique_values.ordered.size(); i < end; ++i) {
+    const auto& entry = *unique_values.ordered[i];
+    output_uniques_data[i] = entry.first;
+    output_counts_data[i] = entry.second.count;
   }
 
   return Status::OK();
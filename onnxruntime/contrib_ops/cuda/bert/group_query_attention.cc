@@ -26,6 +26,7 @@ namespace cuda {
       kCudaExecutionProvider,                                            \
       (*KernelDefBuilder::Create())                                      \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())         \
+          .TypeConstraint("T_CACHE", DataTypeImpl::GetTensorType<T>())   \
           .TypeConstraint("M", {DataTypeImpl::GetTensorType<int32_t>()}) \
           .MayInplace(3, 1)                                              \
           .MayInplace(4, 2)                                              \
@@ -48,6 +49,8 @@ GroupQueryAttention<T>::GroupQueryAttention(const OpKernelInfo& info)
   is_past_bsnh_ = false;
   is_unidirectional_ = true;
   local_window_size_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1));
+  ORT_ENFORCE(info.GetAttrOrDefault<int64_t>("num_sink_tokens", -1) < 0 || local_window_size_ <= 0,
+              "A ring buffer kv cache (num_sink_tokens with local_window_size) is only supported on CPU.");
   do_rotary_ = info.GetAttrOrDefault<int64_t>("do_rotary", 0) == 1;
   rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
   scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
@@ -75,6 +78,7 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   const Tensor* total_seqlen = context->Input<Tensor>(6);
   const Tensor* cos_cache = context->Input<Tensor>(7);
   const Tensor* sin_cache = context->Input<Tensor>(8);
+  const Tensor* block_table = context->Input<Tensor>(9);
 
   auto& device_prop = GetDeviceProp();
   GroupQueryAttentionParameters parameters;
@@ -95,7 +99,8 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
                                                                 total_seqlen,
                                                                 is_past_bsnh_,
                                                                 scale_,
-                                                                device_prop.maxThreadsPerBlock));
+                                                                device_prop.maxThreadsPerBlock,
+                                                                block_table));
   parameters.local_window_size = local_window_size_;
   parameters.is_unidirectional = is_unidirectional_;
   parameters.zeros_count = kZerosCount;
@@ -148,6 +153,13 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   auto out_accum_buffer = GetScratchBuffer<void>(0, context->GetComputeStream());          // nullptr
 #endif
 
+  if (parameters.paged_kv_cache && (!use_flash_attention || parameters.kv_cache_block_size % 256 != 0)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Paged kv-cache is only supported by flash attention on CUDA, with a block size that is "
+                           "a multiple of 256. Got block size ",
+                           parameters.kv_cache_block_size);
+  }
+
 #if USE_MEMORY_EFFICIENT_ATTENTION
   int sm = (device_prop.major * 10) + device_prop.minor;
   bool use_memory_efficient_attention =
@@ -218,6 +230,10 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
     present_dims = {
         parameters.batch_size, parameters.kv_num_heads, parameters.seqlen_present_kv_cache, parameters.head_size};
   }
+  if (parameters.paged_kv_cache) {
+    // The paged present kv cache is the past one with the new tokens written to their blocks.
+    present_dims.assign(past_key->Shape().GetDims().begin(), past_key->Shape().GetDims().end());
+  }
   TensorShape present_shape(present_dims);
   Tensor* present_key = context->Output(1, present_shape);
   Tensor* present_value = context->Output(2, present_shape);
@@ -238,6 +254,13 @@ Status GroupQueryAttention<T>::ComputeInternal(OpKernelContext* context) const {
   } else {
     parameters.kv_share_buffer = false;
   }
+  if (parameters.paged_kv_cache) {
+    if (!parameters.kv_share_buffer) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Paged kv-cache requires past and present kv to share the buffer on CUDA.");
+    }
+    data.block_table = const_cast<int*>(block_table->Data<int>());
+  }
   // Flash Buffers
   if (softmax_lse_buffer != nullptr) {
     data.softmax_lse = reinterpret_cast<CudaT*>(softmax_lse_buffer.get());
@@ -24,10 +24,15 @@ Status CheckInputs(const Tensor* query,
                    const Tensor* seqlens_k,
                    const Tensor* total_seqlen,
                    bool is_past_bsnh,
-                   float scale) {
+                   float scale,
+                   const Tensor* block_table = nullptr) {
   // Note: Here S* is past_cache_sequence_length, S- is past_sequence_length, S+ is sequence_length
   //     past_key                   : (B, N_k, S*, H) or (B, N_k, S-, H) or nullptr
   //     past_value                 : (B, N_k, S*, H) or (B, N_k, S-, H) or nullptr
+  // paged kv-cache, where P is the number of blocks and S_b the number of tokens per block:
+  //     past_key                   : (P, N_k, S_b, H)
+  //     past_value                 : (P, N_k, S_b, H)
+  //     block_table                : (B, max_blocks_per_sequence)
   // no packing for q/k/v:
   //     query            (Q)       : (B, S, D) or (B, S, (D_q + 2 D_kv))
   //     key              (K)       : (B, S, D_kv) or nullptr
@@ -124,12 +129,22 @@ Status CheckInputs(const Tensor* query,
                              past_value_dims.size());
     }
 
-    if (past_key_dims[0] != batch_size) {
+    if (block_table != nullptr) {
+      if (is_past_bsnh) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Paged Input 'past_key' and 'past_value' are only supported in BNSH format.");
+      }
+      if (past_key_dims[0] != past_value_dims[0]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Paged Input 'past_key' and 'past_value' should have same dimension 0 (number of "
+                               "blocks), got ",
+                               past_key_dims[0], " and ", past_value_dims[0]);
+      }
+    } else if (past_key_dims[0] != batch_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'past_key' dimension 0 should be batch_size, got ",
                              past_key_dims[0]);
-    }
-    if (past_value_dims[0] != batch_size) {
+    } else if (past_value_dims[0] != batch_size) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Input 'past_value' dimension 0 should be batch_size, got ",
                              past_value_dims[0]);
@@ -188,6 +203,27 @@ Status CheckInputs(const Tensor* query,
                            "Input 'past_key' and 'past_value' shall be both present or both absent.");
   }
 
+  // Check block_table tensor (mapping the tokens of each sequence to blocks of the paged kv-cache)
+  int kv_cache_block_size = 0;
+  int num_kv_cache_blocks = 0;
+  int max_blocks_per_sequence = 0;
+  if (block_table != nullptr) {
+    if (past_key == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'past_key' and 'past_value' shall be present when 'block_table' is present.");
+    }
+    const auto& block_table_dims = block_table->Shape().GetDims();
+    if (block_table_dims.size() != 2 || block_table_dims[0] != batch_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "block_table must be shape (batch_size, max_blocks_per_sequence).");
+    }
+    kv_cache_block_size = past_sequence_length;
+    num_kv_cache_blocks = static_cast<int>(past_key->Shape().GetDims()[0]);
+    max_blocks_per_sequence = static_cast<int>(block_table_dims[1]);
+    // Each sequence can hold as many tokens as there are entries for it in the block table.
+    past_sequence_length = kv_cache_block_size * max_blocks_per_sequence;
+  }
+
   // Check seqlens_k tensor (holding past seqlen for token gen)
   const auto& seqlens_dim = seqlens_k->Shape().GetDims();
   if (seqlens_dim.size() != 1 && seqlens_dim[0] != batch_size) {
@@ -201,6 +237,11 @@ Status CheckInputs(const Tensor* query,
                            "total_sequence_length tensor must be of one element.");
   }
   int total_sequence_length = *((*total_seqlen).template Data<int32_t>());
+  if (block_table != nullptr && total_sequence_length > past_sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "total_sequence_length ", total_sequence_length,
+                           " exceeds the capacity of the block table of ", past_sequence_length, " tokens.");
+  }
   int present_sequence_length = std::max(total_sequence_length, past_sequence_length);
 
   int rotary_dim = 0;
@@ -262,6 +303,10 @@ Status CheckInputs(const Tensor* query,
     output_parameters->scale = scale;
     output_parameters->qkv_format = qkv_format;
     output_parameters->past_kv_format = past_kv_format;
+    output_parameters->paged_kv_cache = block_table != nullptr;
+    output_parameters->kv_cache_block_size = kv_cache_block_size;
+    output_parameters->num_kv_cache_blocks = num_kv_cache_blocks;
+    output_parameters->max_blocks_per_sequence = max_blocks_per_sequence;
   }
 
   return Status::OK();
@@ -281,12 +326,13 @@ Status CheckInputs(const Tensor* query,
                    const Tensor* total_seqlen,
                    bool is_past_bsnh,
                    float scale,
-                   int max_threads_per_block) {
+                   int max_threads_per_block,
+                   const Tensor* block_table = nullptr) {
   if (max_threads_per_block > 0 && num_heads > max_threads_per_block) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "num_heads should be no larger than ", max_threads_per_block);
   }
 
-  return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, is_past_bsnh, scale);
+  return CheckInputs(query, key, value, past_key, past_value, cos_cache, sin_cache, parameters, num_heads, kv_num_heads, seqlens_k, total_seqlen, is_past_bsnh, scale, block_table);
 }
 
 }  // namespace group_query_attention_helper
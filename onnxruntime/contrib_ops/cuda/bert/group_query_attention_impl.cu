@@ -614,6 +614,122 @@ Status LaunchSeqlensToPosIds(contrib::GroupQueryAttentionParameters& parameters,
   return CUDA_CALL(cudaGetLastError());
 }
 
+// Kernel for a decoding step (one new token) with a shared kv buffer. Block (b, n) handles head n of the packed
+// q, k and v heads of batch b: q is rotated into unpacked_q, k is rotated and v copied into the kv-cache at the
+// position past_seqlens_k[b], and total_seqlens_k is past_seqlens_k + 1.
+template <typename T>
+__global__ void FusedDecodeRotaryAppendKV(const T* query,  // B x (N + 2 * N_kv) x H if packed, else B x N x H
+                                          const T* key,    // B x N_kv x H, nullptr if packed
+                                          const T* value,  // B x N_kv x H, nullptr if packed
+                                          const T* cos_cache,  // M x (rotary_dim / 2), nullptr without rotary
+                                          const T* sin_cache,  // M x (rotary_dim / 2), nullptr without rotary
+                                          const int32_t* past_seqlens_k,
+                                          T* unpacked_q,  // B x N x H, nullptr to leave q unchanged
+                                          T* present_key,
+                                          T* present_value,
+                                          int32_t* total_seqlens_k,
+                                          const int num_heads,
+                                          const int kv_num_heads,
+                                          const int head_size,
+                                          const int rotary_dim,
+                                          const int max_seqlen,
+                                          const bool interleaved,
+                                          const bool is_past_kv_bnsh_format) {
+  const int i = threadIdx.x;
+  const int b = blockIdx.x;
+  const int n = blockIdx.y;
+  const int past_seqlen = past_seqlens_k[b];
+  if (n == 0 && i == 0) {
+    total_seqlens_k[b] = past_seqlen + 1;
+  }
+
+  const bool is_q = n < num_heads;
+  const bool is_k = !is_q && n < num_heads + kv_num_heads;
+  if (is_q && unpacked_q == nullptr) {
+    return;
+  }
+
+  const T* input;
+  if (key == nullptr) {  // packed qkv
+    input = query + (b * (num_heads + 2 * kv_num_heads) + n) * head_size;
+  } else if (is_q) {
+    input = query + (b * num_heads + n) * head_size;
+  } else if (is_k) {
+    input = key + (b * kv_num_heads + n - num_heads) * head_size;
+  } else {
+    input = value + (b * kv_num_heads + n - num_heads - kv_num_heads) * head_size;
+  }
+
+  T* output;
+  if (is_q) {
+    output = unpacked_q + (b * num_heads + n) * head_size;
+  } else {
+    const int kv_n = is_k ? n - num_heads : n - num_heads - kv_num_heads;
+    const int out_offset = is_past_kv_bnsh_format
+                               ? INDEX_4D(kv_num_heads, max_seqlen, head_size, b, kv_n, past_seqlen, 0)
+                               : INDEX_4D(max_seqlen, kv_num_heads, head_size, b, past_seqlen, kv_n, 0);
+    output = (is_k ? present_key : present_value) + out_offset;
+  }
+
+  if (cos_cache == nullptr || (!is_q && !is_k) || i >= rotary_dim) {
+    output[i] = input[i];
+    return;
+  }
+
+  // The position of the new token is its past sequence length, same as in RotaryEmbeddingBSNH
+  const int half_rotary_dim = rotary_dim / 2;
+  const T* cos_data = cos_cache + past_seqlen * half_rotary_dim;
+  const T* sin_data = sin_cache + past_seqlen * half_rotary_dim;
+  int cache_idx = 0;
+  float sign = 0.0f;
+  int j = 0;
+  if (interleaved) {
+    cache_idx = (i / 2) % half_rotary_dim;
+    sign = (i % 2 == 0) ? -1.0f : 1.0f;
+    j = (i % 2 == 0) ? i + 1 : i - 1;
+  } else {
+    cache_idx = i % half_rotary_dim;
+    sign = (i < half_rotary_dim) ? -1.0f : 1.0f;
+    j = (i + half_rotary_dim) % rotary_dim;
+  }
+  output[i] = T(static_cast<float>(input[i]) * static_cast<float>(cos_data[cache_idx]) +
+                sign * static_cast<float>(input[j]) * static_cast<float>(sin_data[cache_idx]));
+}
+
+// Replaces the unpacking, rotary embedding, total sequence length and kv-cache append kernels of a decoding step.
+template <typename T>
+Status LaunchFusedDecodeRotaryAppendKV(contrib::GroupQueryAttentionParameters& parameters,
+                                       GroupQueryAttentionData<T>& data,
+                                       T* unpacked_q,
+                                       cudaStream_t stream,
+                                       const int max_threads_per_block) {
+  ORT_ENFORCE(parameters.head_size <= max_threads_per_block, "head_size must be <= max_threads_per_block");
+  assert(parameters.sequence_length == 1 && parameters.kv_share_buffer);
+
+  const bool is_past_kv_bnsh_format = (parameters.past_kv_format == AttentionQkvFormat::Q_K_V_BNSH);
+  const dim3 grid(parameters.batch_size, parameters.num_heads + 2 * parameters.kv_num_heads, 1);
+  const dim3 block(parameters.head_size, 1, 1);
+  FusedDecodeRotaryAppendKV<T><<<grid, block, 0, stream>>>(
+      data.query,
+      parameters.is_packed_qkv ? nullptr : data.key,
+      parameters.is_packed_qkv ? nullptr : data.value,
+      parameters.do_rotary ? data.cos_cache : nullptr,
+      parameters.do_rotary ? data.sin_cache : nullptr,
+      data.seqlens_k,
+      unpacked_q,
+      data.present_key,
+      data.present_value,
+      data.seqlens_k_total,
+      parameters.num_heads,
+      parameters.kv_num_heads,
+      parameters.head_size,
+      parameters.rotary_dim,
+      parameters.seqlen_present_kv_cache,
+      parameters.rotary_interleaved,
+      is_past_kv_bnsh_format);
+  return CUDA_CALL(cudaGetLastError());
+}
+
 ////////// Launch Kernels
 
 #if USE_FLASH_ATTENTION
@@ -675,12 +791,12 @@ Status FlashAttention(
   bool past_bsnh = past_kv_format == AttentionQkvFormat::Q_K_V_BSNH;
   ORT_RETURN_IF_ERROR(onnxruntime::flash::mha_fwd_kvcache(
       device_prop, stream, query, present_key, present_value, key, value, data.output,
-      reinterpret_cast<void*>(data.softmax_lse), seqlens_k, cos_cache, sin_cache, /*block_table*/ nullptr,
+      reinterpret_cast<void*>(data.softmax_lse), seqlens_k, cos_cache, sin_cache, data.block_table,
       batch_size, num_heads, kv_num_heads, head_size, sequence_length,
       parameters.seqlen_present_kv_cache, kv_sequence_length, parameters.rotary_dim,
       scale, is_causal, is_bf16, past_bsnh, parameters.num_splits, reinterpret_cast<void*>(data.softmax_lse_accum),
       reinterpret_cast<void*>(data.out_accum), parameters.local_window_size, parameters.rotary_interleaved,
-      parameters.is_packed_qkv));
+      parameters.is_packed_qkv, parameters.max_blocks_per_sequence, parameters.kv_cache_block_size));
 
   // if (parameters.left_padding && parameters.is_prompt) {
   //   ORT_RETURN_IF_ERROR(LaunchLeftPadLast(parameters, data, stream, device_prop.maxThreadsPerBlock));
@@ -714,86 +830,98 @@ Status EfficientAttention(
   const void* key;
   const void* value;
 
-  if (!parameters.is_packed_qkv) {
-    query = reinterpret_cast<const void*>(data.query);
-    key = reinterpret_cast<const void*>(data.key);
-    value = reinterpret_cast<const void*>(data.value);
-  } else {
-    size_t q_size = static_cast<size_t>(batch_size * sequence_length * num_heads * head_size);
-    size_t k_size = static_cast<size_t>(batch_size * sequence_length * kv_num_heads * head_size);
-    auto q = reinterpret_cast<T*>(data.unpacked_qkv_buffer);
-    auto k = reinterpret_cast<T*>(data.unpacked_qkv_buffer + q_size);
-    auto v = reinterpret_cast<T*>(data.unpacked_qkv_buffer + q_size + k_size);
-
-    Status status = LaunchUnpackQKV<T, LAYOUT_BSNH>(
-        reinterpret_cast<const T*>(data.query), q, k, v, num_heads, kv_num_heads,
-        head_size, sequence_length, batch_size, stream, max_threads_per_block);
-    if (status != Status::OK()) {
-      return status;
-    }
-
-    query = reinterpret_cast<const void*>(q);
-    key = reinterpret_cast<const void*>(k);
-    value = reinterpret_cast<const void*>(v);
-  }
-
-  if (parameters.do_rotary) {
-    size_t q_size = static_cast<size_t>(batch_size * sequence_length * num_heads * head_size);
-    size_t k_size = static_cast<size_t>(batch_size * sequence_length * kv_num_heads * head_size);
-    auto q_buffer = reinterpret_cast<T*>(data.rotary_buffer);
-    auto k_buffer = q_buffer + q_size;
-    auto position_ids_buff = reinterpret_cast<int64_t*>(k_buffer + k_size);
-    ORT_RETURN_IF_ERROR(LaunchSeqlensToPosIds(parameters, data.seqlens_k, position_ids_buff, stream,
-                                              max_threads_per_block));
-    DUMP_TENSOR_INIT();
-    DUMP_TENSOR("position_ids", position_ids_buff, batch_size, sequence_length);
-    // Launch rotary embedding kernel
-    ORT_RETURN_IF_ERROR(LaunchRotaryEmbeddingKernel<T>(stream, q_buffer, reinterpret_cast<const T*>(query),
-                                                       position_ids_buff, data.cos_cache, data.sin_cache,
-                                                       parameters.batch_size, parameters.sequence_length,
-                                                       parameters.num_heads, parameters.head_size,
-                                                       parameters.rotary_dim, parameters.seqlen_present_kv_cache,
-                                                       /*position_ids_format*/ 1, parameters.rotary_interleaved,
-                                                       device_prop.maxThreadsPerBlock, /*transposed*/ false));
-    ORT_RETURN_IF_ERROR(LaunchRotaryEmbeddingKernel<T>(stream, k_buffer, reinterpret_cast<const T*>(key),
-                                                       position_ids_buff, data.cos_cache, data.sin_cache,
-                                                       parameters.batch_size, parameters.sequence_length,
-                                                       parameters.kv_num_heads, parameters.head_size,
-                                                       parameters.rotary_dim, parameters.seqlen_present_kv_cache,
-                                                       /*position_ids_format*/ 1, parameters.rotary_interleaved,
-                                                       device_prop.maxThreadsPerBlock, /*transposed*/ false));
-    query = reinterpret_cast<const void*>(q_buffer);
-    key = reinterpret_cast<const void*>(k_buffer);
-  }
-
-  if (parameters.is_prompt) {
-    // Launch kernel to copy seqlen
-    constexpr int thr_per_blk = 256;
-    int blk_in_grid = (batch_size + thr_per_blk - 1) / thr_per_blk;
-    repeat_seqlen<<<blk_in_grid, thr_per_blk, 0, stream>>>(data.seqlens_k_total, parameters.sequence_length,
-                                                           batch_size);
-  } else {
-    ORT_RETURN_IF_ERROR(LaunchGetSeqlenBuff(parameters, data.seqlens_k, data.seqlens_k_total, true, stream, 256));
-  }
-
-  if (parameters.kv_share_buffer) {
-    // Share buffer case
+  if (!parameters.is_prompt && parameters.kv_share_buffer && sequence_length == 1) {
     if (data.past_key == nullptr || data.past_key != data.present_key) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Past and present kv shall share the same tensor when kv_share_buffer is on.");
     }
-    // Concatenate new kv in place
-    constexpr bool is_new_kv_bnsh_format = false;
-    ORT_RETURN_IF_ERROR(LaunchConcatKVInPlace(
-        parameters, data, key, value, is_new_kv_bnsh_format, stream, max_threads_per_block));
+    // Decoding step: one kernel unpacks the new token, rotates q and k, and appends k and v to the kv-cache
+    T* q_buffer = parameters.do_rotary ? data.rotary_buffer
+                                       : (parameters.is_packed_qkv ? data.unpacked_qkv_buffer : nullptr);
+    ORT_RETURN_IF_ERROR(LaunchFusedDecodeRotaryAppendKV(parameters, data, q_buffer, stream, max_threads_per_block));
+    query = reinterpret_cast<const void*>(q_buffer != nullptr ? q_buffer : data.query);
   } else {
-    // Not share buffer case
-    if (data.past_key != nullptr && data.past_key == data.present_key) {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
-                             "Past and present kv share the same tensor but kv_share_buffer is not on.");
+    if (!parameters.is_packed_qkv) {
+      query = reinterpret_cast<const void*>(data.query);
+      key = reinterpret_cast<const void*>(data.key);
+      value = reinterpret_cast<const void*>(data.value);
+    } else {
+      size_t q_size = static_cast<size_t>(batch_size * sequence_length * num_heads * head_size);
+      size_t k_size = static_cast<size_t>(batch_size * sequence_length * kv_num_heads * head_size);
+      auto q = reinterpret_cast<T*>(data.unpacked_qkv_buffer);
+      auto k = reinterpret_cast<T*>(data.unpacked_qkv_buffer + q_size);
+      auto v = reinterpret_cast<T*>(data.unpacked_qkv_buffer + q_size + k_size);
+
+      Status status = LaunchUnpackQKV<T, LAYOUT_BSNH>(
+          reinterpret_cast<const T*>(data.query), q, k, v, num_heads, kv_num_heads,
+          head_size, sequence_length, batch_size, stream, max_threads_per_block);
+      if (status != Status::OK()) {
+        return status;
+      }
+
+      query = reinterpret_cast<const void*>(q);
+      key = reinterpret_cast<const void*>(k);
+      value = reinterpret_cast<const void*>(v);
+    }
+
+    if (parameters.do_rotary) {
+      size_t q_size = static_cast<size_t>(batch_size * sequence_length * num_heads * head_size);
+      size_t k_size = static_cast<size_t>(batch_size * sequence_length * kv_num_heads * head_size);
+      auto q_buffer = reinterpret_cast<T*>(data.rotary_buffer);
+      auto k_buffer = q_buffer + q_size;
+      auto position_ids_buff = reinterpret_cast<int64_t*>(k_buffer + k_size);
+      ORT_RETURN_IF_ERROR(LaunchSeqlensToPosIds(parameters, data.seqlens_k, position_ids_buff, stream,
+                                                max_threads_per_block));
+      DUMP_TENSOR_INIT();
+      DUMP_TENSOR("position_ids", position_ids_buff, batch_size, sequence_length);
+      // Launch rotary embedding kernel
+      ORT_RETURN_IF_ERROR(LaunchRotaryEmbeddingKernel<T>(stream, q_buffer, reinterpret_cast<const T*>(query),
+                                                         position_ids_buff, data.cos_cache, data.sin_cache,
+                                                         parameters.batch_size, parameters.sequence_length,
+                                                         parameters.num_heads, parameters.head_size,
+                                                         parameters.rotary_dim, parameters.seqlen_present_kv_cache,
+                                                         /*position_ids_format*/ 1, parameters.rotary_interleaved,
+                                                         device_prop.maxThreadsPerBlock, /*transposed*/ false));
+      ORT_RETURN_IF_ERROR(LaunchRotaryEmbeddingKernel<T>(stream, k_buffer, reinterpret_cast<const T*>(key),
+                                                         position_ids_buff, data.cos_cache, data.sin_cache,
+                                                         parameters.batch_size, parameters.sequence_length,
+                                                         parameters.kv_num_heads, parameters.head_size,
+                                                         parameters.rotary_dim, parameters.seqlen_present_kv_cache,
+                                                         /*position_ids_format*/ 1, parameters.rotary_interleaved,
+                                                         device_prop.maxThreadsPerBlock, /*transposed*/ false));
+      query = reinterpret_cast<const void*>(q_buffer);
+      key = reinterpret_cast<const void*>(k_buffer);
+    }
+
+    if (parameters.is_prompt) {
+      // Launch kernel to copy seqlen
+      constexpr int thr_per_blk = 256;
+      int blk_in_grid = (batch_size + thr_per_blk - 1) / thr_per_blk;
+      repeat_seqlen<<<blk_in_grid, thr_per_blk, 0, stream>>>(data.seqlens_k_total, parameters.sequence_length,
+                                                             batch_size);
+    } else {
+      ORT_RETURN_IF_ERROR(LaunchGetSeqlenBuff(parameters, data.seqlens_k, data.seqlens_k_total, true, stream, 256));
+    }
+
+    if (parameters.kv_share_buffer) {
+      // Share buffer case
+      if (data.past_key == nullptr || data.past_key != data.present_key) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Past and present kv shall share the same tensor when kv_share_buffer is on.");
+      }
+      // Concatenate new kv in place
+      constexpr bool is_new_kv_bnsh_format = false;
+      ORT_RETURN_IF_ERROR(LaunchConcatKVInPlace(
+          parameters, data, key, value, is_new_kv_bnsh_format, stream, max_threads_per_block));
+    } else {
+      // Not share buffer case
+      if (data.past_key != nullptr && data.past_key == data.present_key) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Past and present kv share the same tensor but kv_share_buffer is not on.");
+      }
+      // Copy past and concat new KV to present buffer
+      ORT_RETURN_IF_ERROR(LaunchConcatNewToPastKV(parameters, data, key, value, stream, max_threads_per_block));
     }
-    // Copy past and concat new KV to present buffer
-    ORT_RETURN_IF_ERROR(LaunchConcatNewToPastKV(parameters, data, key, value, stream, max_threads_per_block));
   }
 
   // Ungroup if grouped, otherwise use present kv directly
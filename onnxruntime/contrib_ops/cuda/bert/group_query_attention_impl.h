@@ -21,6 +21,8 @@ struct GroupQueryAttentionData {
   const T* past_key = nullptr;
   const T* past_value = nullptr;
   int* seqlens_k = nullptr;
+  // Block table of a paged kv-cache, nullptr when the kv-cache is not paged.
+  int* block_table = nullptr;
   const T* cos_cache = nullptr;
   const T* sin_cache = nullptr;
   // Flash buffers
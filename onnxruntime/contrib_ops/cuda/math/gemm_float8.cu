@@ -180,10 +180,8 @@ Status GemmFloat8::ComputeGemm(
     const void* p_scale_y, void* p_output_y, int M, int N, int K, int lda,
     int ldb, int ldd, bool row_major_compute) const {
   cudaStream_t stream = Stream(ctx);
-  CUDA_RETURN_IF_ERROR(cudaStreamSynchronize(stream));
-
-  cublasLtHandle_t cublasLt;
-  CUBLAS_RETURN_IF_ERROR(cublasLtCreate(&cublasLt));
+  // the per-thread handle of the provider, the matmul below is ordered on the compute stream
+  cublasLtHandle_t cublasLt = CublasLtHandle();
 
   cublasLtMatmulDesc_t operationDesc = nullptr;
   cublasLtMatrixLayout_t Adesc = nullptr, Bdesc = nullptr, Cdesc = nullptr,
@@ -320,9 +318,8 @@ Status GemmFloat8::ComputeGemm(
 
   // See
   // https://docs.nvidia.com/cuda/cublas/index.html?highlight=cublasLtMatmulPreferenceAttributes_t#cublasltmatmulpreferenceattributes-t
-  // The workspace should be allocated once from OpKernelContext assuming
-  // only one cuda function is running at a time (which is not necessarily true
-  // with H100).
+  // The workspace comes from the stream aware allocator of the provider so it is reused across runs
+  // instead of going through cudaMalloc/cudaFree, cudaFree synchronizes the device.
   size_t workspaceSize = static_cast<size_t>(1 << 25);  // suggested fixed value 32Mb
   cublasLtMatmulPreference_t preference = nullptr;
   cublasLtMatmulPreferenceCreate(&preference);
@@ -362,10 +359,8 @@ Status GemmFloat8::ComputeGemm(
       "index.html?highlight=cublasLtMatmulAlgoGetHeuristic#"
       "cublasltmatmulalgogetheuristic. CUDA>=11.8 is required to use float 8 types.");
 
-  void* workspace = nullptr;
-  if (workspaceSize > 0) {
-    CUDA_RETURN_IF_ERROR(cudaMalloc(reinterpret_cast<void**>(&workspace), workspaceSize));
-  }
+  auto workspace_buffer = GetScratchBuffer<void>(workspaceSize, ctx->GetComputeStream());
+  void* workspace = workspace_buffer.get();
   // https://docs.nvidia.com/cuda/cublas/index.html?highlight=cublasLtMatmul#cublasltmatmul
   const void* bias = has_bias ? p_input_c : p_output_y;
   cuda_status = cublasLtMatmul(
@@ -399,17 +394,12 @@ Status GemmFloat8::ComputeGemm(
       ", rowMajorCompute=", (row_major_compute ? 1 : 0),
       ". CUDA>=11.8 is required to use float 8 types.");
 
-  if (workspaceSize > 0) {
-    CUDA_RETURN_IF_ERROR(cudaFree(workspace));
-  }
-
   CUBLAS_RETURN_IF_ERROR(cublasLtMatmulPreferenceDestroy(preference));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Ddesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Cdesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Bdesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatrixLayoutDestroy(Adesc));
   CUBLAS_RETURN_IF_ERROR(cublasLtMatmulDescDestroy(operationDesc));
-  CUBLAS_RETURN_IF_ERROR(cublasLtDestroy(cublasLt));
   return Status::OK();
 }
 
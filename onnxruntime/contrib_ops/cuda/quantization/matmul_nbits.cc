@@ -10,6 +10,9 @@
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "matmul_nbits.cuh"
 #include "dequantize_blockwise.cuh"
+#ifdef USE_ROCM
+#include "core/providers/rocm/tunable/gemm.h"
+#endif
 
 namespace onnxruntime {
 namespace contrib {
@@ -115,6 +118,22 @@ cudaMemcpy(b_data_cpu, b_data, K_ * N_ * sizeof(T), cudaMemcpyDeviceToHost);
 delete[] b_data_cpu;
 #endif
 
+#ifdef USE_ROCM
+  // Use the tunable GEMM so that the fastest of the CK, hipBLASLt and rocBLAS kernels is picked for the shape of the
+  // dequantized weights when tuning is enabled.
+  if (helper.OutputOffsets().size() == 1) {
+    ORT_RETURN_IF_ERROR(onnxruntime::rocm::tunable::blas::column_major::Gemm(
+        GetTuningContext(), ctx->GetComputeStream(), GetRocblasHandle(ctx),
+        onnxruntime::rocm::tunable::blas::BlasOp::Trans,
+        onnxruntime::rocm::tunable::blas::BlasOp::NonTrans,
+        helper.N(), helper.M(), helper.K(),
+        /*alpha=*/1.0f,
+        reinterpret_cast<const CudaT*>(b_data), K_padded,
+        reinterpret_cast<const CudaT*>(a_data), helper.Lda(transa),
+        /*beta=*/0.0f,
+        reinterpret_cast<CudaT*>(Y->MutableData<T>()), helper.Ldc()));
+  }
+#else
   const CudaT alpha = ToCudaType<T>::FromFloat(1.f);
   const CudaT zero = ToCudaType<T>::FromFloat(0.f);
 
@@ -137,6 +156,7 @@ delete[] b_data_cpu;
         GetDeviceProp(),
         UseTF32()));
   }
+#endif
 
   return Status::OK();
 }
@@ -171,6 +171,9 @@ __device__ __forceinline__ void AccumulateEightElements(uint32_t values_quant, f
 constexpr int kColsPerThreadBlock = 8;
 constexpr int kElementsPerThreadPerIteration = 8;
 constexpr int kWarpSize = GPU_WARP_SIZE;
+// Each row of A re-reads the 4 bit weights, half a byte per element. Up to this many rows that is still less memory
+// traffic than dequantizing the weights to T (a write and a read of sizeof(T) bytes per element) followed by a GEMM.
+constexpr int kMaxRowsPerGemv = 4;
 
 // kernel for 4bits quantized gemv, i.e., computing A(1,K) x B(K, N)
 // B(K, N) is quantized blockwise with 4bits and stored as [N, (K + block_size - 1)/block_size, blob]
@@ -285,7 +288,7 @@ bool TryMatMul4Bits(
     int block_size,
     int shared_mem_per_block,
     cudaStream_t stream) {
-  if (n % kColsPerThreadBlock != 0 || k % 8 != 0 || m > 1) {
+  if (n % kColsPerThreadBlock != 0 || k % 8 != 0 || m > kMaxRowsPerGemv) {
     return false;
   }
   dim3 blocks((n + kColsPerThreadBlock - 1) / kColsPerThreadBlock, m);
@@ -141,7 +141,7 @@ __global__ void LogitsProcessKernel(
         }
       }
 
-      // VocabMaskLogitsProcessor
+      // Vocabulary mask, see ElementwiseLogitsProcessor
       if (vocab_mask != nullptr && vocab_mask[word_id] == 0) {
         next_token_scores[index] = cub::FpLimits<T>::Lowest();
         return;
@@ -159,13 +159,13 @@ __global__ void LogitsProcessKernel(
         next_token_scores[index] = cub::FpLimits<T>::Lowest();
       }
 
-      // PresencePenaltyLogitsProcessor
+      // Presence penalty, see ElementwiseLogitsProcessor
       if (presence_mask != nullptr && presence_mask[index] == 1) {
         float score = (float)next_token_scores[index] - presence_penalty;
         next_token_scores[index] = (T)score;
       }
 
-      // TemperatureLogitsProcessor
+      // Temperature, see ElementwiseLogitsProcessor
       if (temperature != 1.0f) {
         float score = (float)(next_token_scores[index]);
         next_token_scores[index] = (T)(score / temperature);
@@ -31,6 +31,7 @@ namespace rocm {
       kRocmExecutionProvider,                                          \
       (*KernelDefBuilder::Create())                                    \
           .TypeConstraint("T", DataTypeImpl::GetTensorType<T>())       \
+          .TypeConstraint("T_CACHE", DataTypeImpl::GetTensorType<T>()) \
           .TypeConstraint("M", DataTypeImpl::GetTensorType<int32_t>()) \
           .MayInplace(3, 1)                                            \
           .MayInplace(4, 2)                                            \
@@ -135,6 +136,8 @@ GroupQueryAttention<T>::GroupQueryAttention(const OpKernelInfo& info)
   is_past_bsnh_ = false;
   is_unidirectional_ = true;
   local_window_size_ = static_cast<int>(info.GetAttrOrDefault<int64_t>("local_window_size", -1));
+  ORT_ENFORCE(info.GetAttrOrDefault<int64_t>("num_sink_tokens", -1) < 0 || local_window_size_ <= 0,
+              "A ring buffer kv cache (num_sink_tokens with local_window_size) is only supported on CPU.");
   do_rotary_ = info.GetAttrOrDefault<int64_t>("do_rotary", 0) == 1;
   rotary_interleaved_ = info.GetAttrOrDefault<int64_t>("rotary_interleaved", 0) == 1;
   scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/hardware_counters.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#endif
+
+namespace onnxruntime {
+
+namespace profiling {
+
+#if defined(__linux__)
+namespace {
+
+constexpr std::array<uint64_t, HardwareCounters::kNumEvents> kEventConfigs{
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES};
+
+// The layout of a group read with PERF_FORMAT_TOTAL_TIME_ENABLED and PERF_FORMAT_TOTAL_TIME_RUNNING.
+struct GroupReadFormat {
+  uint64_t nr;
+  uint64_t time_enabled;
+  uint64_t time_running;
+  uint64_t values[HardwareCounters::kNumEvents];
+};
+
+int PerfEventOpen(perf_event_attr& attr, int tid, int group_fd) {
+  return static_cast<int>(syscall(__NR_perf_event_open, &attr, tid, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+// Returns the ids of the threads of the process.
+std::vector<int> GetThreadIds() {
+  std::vector<int> tids;
+  DIR* dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return tids;
+  }
+  while (const dirent* entry = readdir(dir)) {
+    char* end = nullptr;
+    const long tid = std::strtol(entry->d_name, &end, 10);
+    if (end != entry->d_name && *end == '\0') {
+      tids.push_back(static_cast<int>(tid));
+    }
+  }
+  closedir(dir);
+  return tids;
+}
+
+}  // namespace
+
+bool HardwareCounters::OpenThreadCounters(int tid, ThreadCounters& counters, std::string& error) {
+  counters.tid = tid;
+  counters.fds.fill(-1);
+  for (size_t i = 0; i < kNumEvents; ++i) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = kEventConfigs[i];
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    counters.fds[i] = PerfEventOpen(attr, tid, i == 0 ? -1 : counters.fds[0]);
+    if (counters.fds[i] < 0) {
+      error = std::string("perf_event_open failed for ") + kEventNames[i] + ": " + std::strerror(errno);
+      CloseThreadCounters(counters);
+      return false;
+    }
+  }
+  return true;
+}
+
+void HardwareCounters::CloseThreadCounters(ThreadCounters& counters) {
+  // close the group leader last
+  for (size_t i = kNumEvents; i-- > 0;) {
+    if (counters.fds[i] >= 0) {
+      close(counters.fds[i]);
+      counters.fds[i] = -1;
+    }
+  }
+}
+
+bool HardwareCounters::ReadThreadCounters(const ThreadCounters& counters, Values& values) {
+  GroupReadFormat data;
+  if (read(counters.fds[0], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data.nr != kNumEvents) {
+    return false;
+  }
+  // extrapolate the counts of the time the group was not scheduled
+  const double scale = data.time_running > 0 && data.time_running < data.time_enabled
+                           ? static_cast<double>(data.time_enabled) / static_cast<double>(data.time_running)
+                           : 1.0;
+  for (size_t i = 0; i < kNumEvents; ++i) {
+    values[i] = static_cast<uint64_t>(static_cast<double>(data.values[i]) * scale);
+  }
+  return true;
+}
+
+std::unique_ptr<HardwareCounters> HardwareCounters::Create(std::string& error) {
+  ThreadCounters probe;
+  if (!OpenThreadCounters(0, probe, error)) {
+    error += ", check that the CPU exposes a PMU and that /proc/sys/kernel/perf_event_paranoid is at most 2";
+    return nullptr;
+  }
+  CloseThreadCounters(probe);
+
+  auto counters = std::unique_ptr<HardwareCounters>(new HardwareCounters());
+  counters->RefreshThreads();
+  return counters;
+}
+
+HardwareCounters::~HardwareCounters() {
+  for (auto& thread : threads_) {
+    CloseThreadCounters(thread);
+  }
+}
+
+void HardwareCounters::RefreshThreads() {
+  auto tids = GetThreadIds();
+  std::sort(tids.begin(), tids.end());
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto exited = std::partition(threads_.begin(), threads_.end(), [&tids](const ThreadCounters& thread) {
+    return std::binary_search(tids.begin(), tids.end(), thread.tid);
+  });
+  std::for_each(exited, threads_.end(), CloseThreadCounters);
+  threads_.erase(exited, threads_.end());
+
+  for (const int tid : tids) {
+    const bool counted = std::any_of(threads_.begin(), threads_.end(),
+                                     [tid](const ThreadCounters& thread) { return thread.tid == tid; });
+    ThreadCounters thread;
+    std::string error;
+    // a thread may exit before its counters are opened
+    if (!counted && OpenThreadCounters(tid, thread, error)) {
+      threads_.push_back(thread);
+    }
+  }
+}
+
+HardwareCounters::Values HardwareCounters::Read() const {
+  Values total{};
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& thread : threads_) {
+    Values values;
+    if (ReadThreadCounters(thread, values)) {
+      for (size_t i = 0; i < kNumEvents; ++i) {
+        total[i] += values[i];
+      }
+    }
+  }
+  return total;
+}
+
+#else
+
+std::unique_ptr<HardwareCounters> HardwareCounters::Create(std::string& error) {
+  error = "hardware counters are only supported on Linux";
+  return nullptr;
+}
+
+HardwareCounters::~HardwareCounters() = default;
+
+void HardwareCounters::RefreshThreads() {}
+
+HardwareCounters::Values HardwareCounters::Read() const {
+  return {};
+}
+
+#endif  // defined(__linux__)
+
+HardwareCounters::Values HardwareCounters::Delta(const Values& begin, const Values& end) noexcept {
+  Values delta;
+  for (size_t i = 0; i < kNumEvents; ++i) {
+    delta[i] = end[i] > begin[i] ? end[i] - begin[i] : 0;
+  }
+  return delta;
+}
+
+void HardwareCounters::RecordOpType(const std::string& op_type, const Values& values) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& totals = op_type_totals_[op_type];
+  for (size_t i = 0; i < kNumEvents; ++i) {
+    totals.values[i] += values[i];
+  }
+  ++totals.count;
+}
+
+std::map<std::string, HardwareCounters::OpTypeTotals> HardwareCounters::TakeOpTypeTotals() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return std::exchange(op_type_totals_, {});
+}
+
+std::string HardwareCounters::ToJson(const Values& values) {
+  std::ostringstream ss;
+  ss << "{";
+  for (size_t i = 0; i < kNumEvents; ++i) {
+    ss << (i == 0 ? "" : ", ") << "\"" << kEventNames[i] << "\": " << values[i];
+  }
+  ss << "}";
+  return ss.str();
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
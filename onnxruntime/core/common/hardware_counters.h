@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+namespace profiling {
+
+/**
+ * CPU hardware event counters of all the threads of the process, read with Linux perf events, to tell the
+ * compute bound kernels (high instructions per cycle) from the memory bound ones (many cache misses).
+ *
+ * Only user space events are counted. The counters of a thread are opened by RefreshThreads(), so threads created
+ * afterwards are not counted until the next call. The work of every thread is counted, including the one of other
+ * sessions running concurrently in the process.
+ *
+ * The counters are scaled by the fraction of time they were scheduled on the PMU when it is multiplexed.
+ */
+class HardwareCounters {
+ public:
+  static constexpr size_t kNumEvents = 4;
+  static constexpr std::array<const char*, kNumEvents> kEventNames{"cycles", "instructions", "cache_references",
+                                                                   "cache_misses"};
+
+  using Values = std::array<uint64_t, kNumEvents>;
+
+  // Counter totals of the kernels of an op type.
+  struct OpTypeTotals {
+    Values values{};
+    uint64_t count = 0;
+  };
+
+  // Returns nullptr with the reason in error if the counters cannot be opened, e.g. on other platforms than Linux,
+  // without a PMU or when /proc/sys/kernel/perf_event_paranoid is above 2.
+  static std::unique_ptr<HardwareCounters> Create(std::string& error);
+
+  ~HardwareCounters();
+
+  HardwareCounters(const HardwareCounters&) = delete;
+  HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+  // Opens the counters of the threads created since the last call and closes the ones of the exited threads.
+  void RefreshThreads();
+
+  // Returns the sum of the counters of the threads.
+  Values Read() const;
+
+  // Returns the counters counted since begin, clamped at zero as threads exit.
+  static Values Delta(const Values& begin, const Values& end) noexcept;
+
+  // Adds the counters of a kernel to the totals of its op type.
+  void RecordOpType(const std::string& op_type, const Values& values);
+
+  // Returns the totals by op type and resets them.
+  std::map<std::string, OpTypeTotals> TakeOpTypeTotals();
+
+  // Formats the values as a json object, e.g. {"cycles": 100, "instructions": 200, ...}.
+  static std::string ToJson(const Values& values);
+
+ private:
+  struct ThreadCounters {
+    int tid;
+    // the first one is the group leader
+    std::array<int, kNumEvents> fds;
+  };
+
+  HardwareCounters() = default;
+
+  static bool OpenThreadCounters(int tid, ThreadCounters& counters, std::string& error);
+  static void CloseThreadCounters(ThreadCounters& counters);
+  static bool ReadThreadCounters(const ThreadCounters& counters, Values& values);
+
+  mutable OrtMutex mutex_;
+  std::vector<ThreadCounters> threads_;
+  std::map<std::string, OpTypeTotals> op_type_totals_;
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/latency_histograms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+#include "core/common/common.h"
+
+namespace onnxruntime {
+namespace profiling {
+
+namespace {
+
+std::atomic<size_t> next_thread_index{0};
+
+size_t BitWidth(uint64_t value) noexcept {
+  size_t width = 0;
+  while (value != 0) {
+    value >>= 1;
+    ++width;
+  }
+  return width;
+}
+
+}  // namespace
+
+void LatencyHistograms::Snapshot::Merge(const Snapshot& other) {
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    bucket_counts[i] += other.bucket_counts[i];
+  }
+  count += other.count;
+  sum_ns += other.sum_ns;
+}
+
+uint64_t LatencyHistograms::Snapshot::ValueAtPercentile(double percentile) const {
+  if (count == 0) {
+    return 0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const uint64_t target = std::max<uint64_t>(
+      static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count))), 1);
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    cumulative += bucket_counts[i];
+    if (cumulative >= target) {
+      return BucketUpperBound(i);
+    }
+  }
+  return BucketUpperBound(kNumBuckets - 1);
+}
+
+uint64_t LatencyHistograms::Snapshot::CountAtMost(uint64_t latency_ns) const {
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < kNumBuckets && BucketUpperBound(i) <= latency_ns; ++i) {
+    cumulative += bucket_counts[i];
+  }
+  return cumulative;
+}
+
+LatencyHistograms::Shard::Shard(size_t num_slots)
+    : counters(new std::atomic<uint64_t>[num_slots * kCountersPerSlot]()) {
+}
+
+LatencyHistograms::LatencyHistograms(size_t num_slots) : num_slots_(num_slots) {
+}
+
+LatencyHistograms::~LatencyHistograms() {
+  for (auto& shard : shards_) {
+    delete shard.load(std::memory_order_acquire);
+  }
+}
+
+LatencyHistograms::Shard& LatencyHistograms::GetShard() {
+  thread_local const size_t thread_index = next_thread_index.fetch_add(1, std::memory_order_relaxed);
+  auto& shard_ptr = shards_[thread_index % kMaxShards];
+  Shard* shard = shard_ptr.load(std::memory_order_acquire);
+  if (shard == nullptr) {
+    auto new_shard = std::make_unique<Shard>(num_slots_);
+    if (shard_ptr.compare_exchange_strong(shard, new_shard.get(), std::memory_order_acq_rel)) {
+      shard = new_shard.release();
+    }
+  }
+  return *shard;
+}
+
+void LatencyHistograms::Record(size_t slot, uint64_t latency_ns) {
+  ORT_ENFORCE(slot < num_slots_, "Latency histogram slot ", slot, " is out of range ", num_slots_);
+  auto* counters = GetShard().counters.get() + slot * kCountersPerSlot;
+  counters[BucketIndex(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+  counters[kNumBuckets].fetch_add(latency_ns, std::memory_order_relaxed);
+}
+
+LatencyHistograms::Snapshot LatencyHistograms::GetSnapshot(size_t slot) const {
+  ORT_ENFORCE(slot < num_slots_, "Latency histogram slot ", slot, " is out of range ", num_slots_);
+  Snapshot snapshot;
+  for (const auto& shard_ptr : shards_) {
+    const Shard* shard = shard_ptr.load(std::memory_order_acquire);
+    if (shard == nullptr) {
+      continue;
+    }
+    const auto* counters = shard->counters.get() + slot * kCountersPerSlot;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      const uint64_t bucket_count = counters[i].load(std::memory_order_relaxed);
+      snapshot.bucket_counts[i] += bucket_count;
+      snapshot.count += bucket_count;
+    }
+    snapshot.sum_ns += counters[kNumBuckets].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+size_t LatencyHistograms::BucketIndex(uint64_t latency_ns) noexcept {
+  // the bucket b holds the values in (BucketUpperBound(b - 1), BucketUpperBound(b)], the first one 0 and 1
+  const uint64_t value = latency_ns == 0 ? 0 : latency_ns - 1;
+  if (value < 2 * kSubBucketCount) {
+    return static_cast<size_t>(value);
+  }
+  if (value >= uint64_t{1} << kMaxExponent) {
+    return kNumBuckets - 1;
+  }
+  const size_t shift = BitWidth(value) - (kSubBucketBits + 1);
+  return kSubBucketCount * (shift + 1) + static_cast<size_t>((value >> shift) & (kSubBucketCount - 1));
+}
+
+uint64_t LatencyHistograms::BucketUpperBound(size_t bucket) noexcept {
+  if (bucket >= kNumBuckets - 1) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  const size_t next = bucket + 1;
+  if (next < 2 * kSubBucketCount) {
+    return next;
+  }
+  const size_t shift = next / kSubBucketCount - 1;
+  return uint64_t{kSubBucketCount + next % kSubBucketCount} << shift;
+}
+
+void LatencyHistograms::WritePrometheus(std::ostream& out, const std::string& metric_name,
+                                        const std::string& labels, const Snapshot& snapshot) {
+  const std::string separator = labels.empty() ? "" : ",";
+  const auto old_precision = out.precision(12);
+  for (int exponent = 10; exponent <= kMaxExponent; ++exponent) {
+    const uint64_t bound_ns = uint64_t{1} << exponent;
+    out << metric_name << "_bucket{" << labels << separator << "le=\"" << static_cast<double>(bound_ns) * 1e-9
+        << "\"} " << snapshot.CountAtMost(bound_ns) << "\n";
+  }
+  out << metric_name << "_bucket{" << labels << separator << "le=\"+Inf\"} " << snapshot.count << "\n";
+  const std::string label_set = labels.empty() ? "" : "{" + labels + "}";
+  out << metric_name << "_sum" << label_set << " " << static_cast<double>(snapshot.sum_ns) * 1e-9 << "\n";
+  out << metric_name << "_count" << label_set << " " << snapshot.count << "\n";
+  out.precision(old_precision);
+}
+
+std::string LatencyHistograms::EscapeLabelValue(const std::string& value) {
+  std::string escaped;
+  escaped.reserve(value.size());
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      escaped += '\\';
+      escaped += c;
+    } else if (c == '\n') {
+      escaped += "\\n";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+}  // namespace profiling
+}  // namespace onnxruntime
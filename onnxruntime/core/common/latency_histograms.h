@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace onnxruntime {
+
+namespace profiling {
+
+/**
+ * Latency histograms for a fixed number of slots, e.g. the nodes of a graph, cheap enough to stay
+ * enabled in production, unlike the Profiler which records an event per node per run.
+ *
+ * Latencies are counted in nanoseconds in HDR-style log-linear buckets: values up to 8ns have a bucket each,
+ * larger ones have 4 buckets per power of two, so a percentile read from the buckets is off by at most 25%.
+ * A bucket holds the values above the upper bound of the previous bucket up to its own upper bound, so the
+ * powers of two are exact Prometheus `le` bounds. Values above 2^36ns (about 68s) are counted in the last bucket.
+ *
+ * Recording takes no lock: each thread adds to one of a few shards of relaxed atomic counters, allocated on
+ * first use, and snapshots merge the shards. A shard takes about 1.1KB per slot, so a slot takes at most 4.5KB.
+ */
+class LatencyHistograms {
+ public:
+  static constexpr int kSubBucketBits = 2;
+  static constexpr size_t kSubBucketCount = size_t{1} << kSubBucketBits;
+  static constexpr int kMaxExponent = 36;
+  // the buckets up to 2^kMaxExponent, followed by the bucket of the larger values
+  static constexpr size_t kNumBuckets = (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount + 1;
+  static constexpr size_t kMaxShards = 4;
+
+  // Merged counters of one or more slots.
+  struct Snapshot {
+    std::vector<uint64_t> bucket_counts = std::vector<uint64_t>(kNumBuckets);
+    uint64_t count = 0;
+    uint64_t sum_ns = 0;
+
+    void Merge(const Snapshot& other);
+
+    // Returns the upper bound of the bucket holding the given percentile (0 to 100), or 0 without values.
+    uint64_t ValueAtPercentile(double percentile) const;
+
+    // Returns the number of values of at most the given latency, exact when it is a bucket upper bound, e.g. a
+    // power of two up to 2^kMaxExponent.
+    uint64_t CountAtMost(uint64_t latency_ns) const;
+  };
+
+  explicit LatencyHistograms(size_t num_slots);
+  ~LatencyHistograms();
+
+  LatencyHistograms(const LatencyHistograms&) = delete;
+  LatencyHistograms& operator=(const LatencyHistograms&) = delete;
+
+  size_t NumSlots() const noexcept { return num_slots_; }
+
+  void Record(size_t slot, uint64_t latency_ns);
+
+  Snapshot GetSnapshot(size_t slot) const;
+
+  static size_t BucketIndex(uint64_t latency_ns) noexcept;
+
+  // Largest latency counted in the bucket, UINT64_MAX for the last one.
+  static uint64_t BucketUpperBound(size_t bucket) noexcept;
+
+  // Writes a histogram in the Prometheus text exposition format, with cumulative buckets at the powers of
+  // two from about 1us to 2^kMaxExponent ns. `labels` are written as is, e.g. `node="conv_1"`.
+  // The HELP and TYPE lines of `metric_name` are expected to be written by the caller, once per metric.
+  static void WritePrometheus(std::ostream& out, const std::string& metric_name, const std::string& labels,
+                              const Snapshot& snapshot);
+
+  // Escapes a Prometheus label value.
+  static std::string EscapeLabelValue(const std::string& value);
+
+ private:
+  // per slot, kNumBuckets bucket counters followed by the sum of the latencies
+  static constexpr size_t kCountersPerSlot = kNumBuckets + 1;
+
+  struct Shard {
+    explicit Shard(size_t num_slots);
+    std::unique_ptr<std::atomic<uint64_t>[]> counters;
+  };
+
+  Shard& GetShard();
+
+  const size_t num_slots_;
+  std::array<std::atomic<Shard*>, kMaxShards> shards_{};
+};
+
+}  // namespace profiling
+}  // namespace onnxruntime
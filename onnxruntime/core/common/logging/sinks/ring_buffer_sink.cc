@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/logging/sinks/ring_buffer_sink.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+namespace logging {
+
+namespace {
+std::atomic<uint64_t> next_ring_buffer_sink_id{0};
+}  // namespace
+
+RingBufferSink::RingBufferSink(size_t capacity_per_thread)
+    : ISink(SinkType::RingBufferSink), capacity_per_thread_{capacity_per_thread}, id_{next_ring_buffer_sink_id++} {
+  ORT_ENFORCE(capacity_per_thread_ > 0, "The ring buffer sink needs room for at least one message per thread.");
+}
+
+RingBufferSink::Ring& RingBufferSink::GetThreadRing() {
+  // the ring of the sink the thread logged to last, found without taking rings_mutex_
+  struct CachedRing {
+    uint64_t sink_id;
+    Ring* ring;
+  };
+  thread_local CachedRing cached_ring{UINT64_MAX, nullptr};
+  if (cached_ring.sink_id == id_) {
+    return *cached_ring.ring;
+  }
+
+  std::lock_guard<OrtMutex> guard(rings_mutex_);
+  auto& ring = rings_[std::this_thread::get_id()];
+  if (ring == nullptr) {
+    ring = std::make_unique<Ring>();
+    ring->entries.resize(capacity_per_thread_);
+  }
+  cached_ring = {id_, ring.get()};
+  return *ring;
+}
+
+void RingBufferSink::SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) {
+  Ring& ring = GetThreadRing();
+  std::lock_guard<OrtMutex> guard(ring.mutex);
+  Entry& entry = ring.entries[ring.count % ring.entries.size()];
+  entry.timestamp = timestamp;
+  entry.severity = message.Severity();
+  entry.category = message.Category();
+  entry.logger_id.assign(logger_id);
+  entry.file.assign(message.Location().file_and_path);
+  entry.line = message.Location().line_num;
+  entry.function.assign(message.Location().function);
+  entry.message.assign(message.Message());
+  ++ring.count;
+}
+
+size_t RingBufferSink::Size() const {
+  std::lock_guard<OrtMutex> guard(rings_mutex_);
+  size_t size = 0;
+  for (const auto& [thread_id, ring] : rings_) {
+    std::lock_guard<OrtMutex> ring_guard(ring->mutex);
+    size += static_cast<size_t>(std::min<uint64_t>(ring->count, ring->entries.size()));
+  }
+  return size;
+}
+
+void RingBufferSink::Dump(std::ostream& stream) const {
+  // operator for formatting of timestamp in ISO8601 format including microseconds
+  using timestamp_ns::operator<<;
+
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<OrtMutex> guard(rings_mutex_);
+    for (const auto& [thread_id, ring] : rings_) {
+      std::lock_guard<OrtMutex> ring_guard(ring->mutex);
+      const size_t capacity = ring->entries.size();
+      const uint64_t first = ring->count > capacity ? ring->count - capacity : 0;
+      for (uint64_t i = first; i < ring->count; ++i) {
+        entries.push_back(ring->entries[i % capacity]);
+      }
+    }
+  }
+
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry& a, const Entry& b) { return a.timestamp < b.timestamp; });
+
+  for (const auto& entry : entries) {
+    stream << entry.timestamp << " [" << SEVERITY_PREFIX[static_cast<int>(entry.severity)] << ":" << entry.category
+           << ":" << entry.logger_id << ", " << entry.file.substr(entry.file.find_last_of("/\\") + 1) << ":"
+           << entry.line << " " << entry.function << "] " << entry.message << "\n";
+  }
+}
+
+}  // namespace logging
+}  // namespace onnxruntime
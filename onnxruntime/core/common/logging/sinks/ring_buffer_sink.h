@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <vector>
+
+#include "core/common/logging/capture.h"
+#include "core/common/logging/isink.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace logging {
+/// <summary>
+/// ISink that keeps the last messages of each thread in memory, for high rate verbose tracing that is only looked
+/// at when something goes wrong, e.g. next to a FileSink that only gets the warnings in a CompositeSink.
+/// </summary>
+/// <remarks>
+/// Each thread writes to a ring buffer of its own, so the threads logging at once don't contend, and a message
+/// only takes a copy of its fields: the formatting is deferred until Dump. The buffers of the slots are reused, so a
+/// thread stops allocating once its ring has wrapped around with messages of similar lengths.
+/// </remarks>
+/// <seealso cref="ISink" />
+class RingBufferSink : public ISink {
+ public:
+  /// <summary>
+  /// Initializes a new instance of the <see cref="RingBufferSink" /> class.
+  /// </summary>
+  /// <param name="capacity_per_thread">The number of messages kept for each thread.</param>
+  explicit RingBufferSink(size_t capacity_per_thread);
+
+  /// <summary>
+  /// Writes the messages kept, of all the threads and in timestamp order, formatted like the other sinks.
+  /// </summary>
+  void Dump(std::ostream& stream) const;
+
+  /// <summary>
+  /// The number of messages kept, of all the threads.
+  /// </summary>
+  size_t Size() const;
+
+ private:
+  struct Entry {
+    Timestamp timestamp;
+    Severity severity;
+    const char* category;  // the categories are string literals
+    std::string logger_id;
+    std::string file;
+    int line;
+    std::string function;
+    std::string message;
+  };
+
+  struct Ring {
+    // Only contended by a Dump, the thread owning the ring being the only one writing to it.
+    mutable OrtMutex mutex;
+    std::vector<Entry> entries;
+    uint64_t count = 0;  // the number of messages written, the next being at count % entries.size()
+  };
+
+  void SendImpl(const Timestamp& timestamp, const std::string& logger_id, const Capture& message) override;
+
+  Ring& GetThreadRing();
+
+  const size_t capacity_per_thread_;
+  // Tells the sinks apart in the ring cache of the threads, even when one takes the address of a destroyed one.
+  const uint64_t id_;
+
+  mutable OrtMutex rings_mutex_;
+  std::unordered_map<std::thread::id, std::unique_ptr<Ring>> rings_;
+};
+}  // namespace logging
+}  // namespace onnxruntime
@@ -60,6 +60,7 @@ void Profiler::StartProfiling(const std::basic_string<T>& file_name) {
   profile_stream_.open(file_name, std::ios::out | std::ios::trunc);
 #endif
   profile_stream_file_ = ToUTF8String(file_name);
+  profile_start_written_ = false;
   profiling_start_time_ = std::chrono::high_resolution_clock::now();
   for (const auto& ep_profiler : ep_profilers_) {
     ep_profiler->StartProfiling(profiling_start_time_);
@@ -88,6 +89,9 @@ void Profiler::EndTimeAndRecordEvent(EventCategory category,
     std::lock_guard<OrtMutex> lock(mutex_);
     if (events_.size() < max_num_events_) {
       events_.emplace_back(std::move(event));
+      if (flush_interval_events_ > 0 && events_.size() > flush_interval_events_ && ep_profilers_.empty()) {
+        FlushEvents();
+      }
     } else {
       if (session_logger_ && !max_events_reached) {
         LOGS(*session_logger_, ERROR)
@@ -116,38 +120,14 @@ std::string Profiler::EndProfiling() {
   }
 
   std::lock_guard<OrtMutex> lock(mutex_);
-  profile_stream_ << "[\n";
+  WriteProfileStart();
 
   for (const auto& ep_profiler : ep_profilers_) {
     ep_profiler->EndProfiling(profiling_start_time_, events_);
   }
 
   for (size_t i = 0; i < events_.size(); ++i) {
-    auto& rec = events_[i];
-    profile_stream_ << R"({"cat" : ")" << event_category_names_[rec.cat] << "\",";
-    profile_stream_ << "\"pid\" :" << rec.pid << ",";
-    profile_stream_ << "\"tid\" :" << rec.tid << ",";
-    profile_stream_ << "\"dur\" :" << rec.dur << ",";
-    profile_stream_ << "\"ts\" :" << rec.ts << ",";
-    profile_stream_ << R"("ph" : "X",)";
-    profile_stream_ << R"("name" :")" << rec.name << "\",";
-    profile_stream_ << "\"args\" : {";
-    bool is_first_arg = true;
-    for (std::pair<std::string, std::string> event_arg : rec.args) {
-      if (!is_first_arg) profile_stream_ << ",";
-      if (!event_arg.second.empty() && (event_arg.second[0] == '{' || event_arg.second[0] == '[')) {
-        profile_stream_ << "\"" << event_arg.first << "\" : " << event_arg.second << "";
-      } else {
-        profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
-      }
-      is_first_arg = false;
-    }
-    profile_stream_ << "}";
-    if (i == events_.size() - 1) {
-      profile_stream_ << "}\n";
-    } else {
-      profile_stream_ << "},\n";
-    }
+    WriteEvent(events_[i], i == events_.size() - 1);
   }
   profile_stream_ << "]\n";
 #if !defined(__wasm__)
@@ -157,5 +137,48 @@ std::string Profiler::EndProfiling() {
   return profile_stream_file_;
 }
 
+void Profiler::WriteProfileStart() {
+  if (!profile_start_written_) {
+    profile_stream_ << "[\n";
+    profile_start_written_ = true;
+  }
+}
+
+void Profiler::FlushEvents() {
+  WriteProfileStart();
+  for (size_t i = 0; i + 1 < events_.size(); ++i) {
+    WriteEvent(events_[i], false);
+  }
+  profile_stream_.flush();
+  events_.erase(events_.begin(), events_.end() - 1);
+}
+
+void Profiler::WriteEvent(const EventRecord& rec, bool is_last) {
+  profile_stream_ << R"({"cat" : ")" << event_category_names_[rec.cat] << "\",";
+  profile_stream_ << "\"pid\" :" << rec.pid << ",";
+  profile_stream_ << "\"tid\" :" << rec.tid << ",";
+  profile_stream_ << "\"dur\" :" << rec.dur << ",";
+  profile_stream_ << "\"ts\" :" << rec.ts << ",";
+  profile_stream_ << R"("ph" : "X",)";
+  profile_stream_ << R"("name" :")" << rec.name << "\",";
+  profile_stream_ << "\"args\" : {";
+  bool is_first_arg = true;
+  for (const auto& event_arg : rec.args) {
+    if (!is_first_arg) profile_stream_ << ",";
+    if (!event_arg.second.empty() && (event_arg.second[0] == '{' || event_arg.second[0] == '[')) {
+      profile_stream_ << "\"" << event_arg.first << "\" : " << event_arg.second << "";
+    } else {
+      profile_stream_ << "\"" << event_arg.first << "\" : \"" << event_arg.second << "\"";
+    }
+    is_first_arg = false;
+  }
+  profile_stream_ << "}";
+  if (is_last) {
+    profile_stream_ << "}\n";
+  } else {
+    profile_stream_ << "},\n";
+  }
+}
+
 }  // namespace profiling
 }  // namespace onnxruntime
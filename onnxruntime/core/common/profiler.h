@@ -110,6 +110,16 @@ class Profiler {
     global_max_num_events_.store(new_max_num_events);
   }
 
+  /*
+  Append the events to the profile file once more than num_events are buffered, instead of writing all of them
+  in EndProfiling. 0, the default, buffers the events until EndProfiling.
+  The events stay buffered when profiling to a custom logger or when an EP profiler is added, the EP profilers
+  merging their events with the buffered ones in EndProfiling.
+  */
+  void SetFlushIntervalEvents(size_t num_events) {
+    flush_interval_events_ = num_events;
+  }
+
   void AddEpProfilers(std::unique_ptr<EpProfiler> ep_profiler) {
     if (ep_profiler) {
       ep_profilers_.push_back(std::move(ep_profiler));
@@ -122,6 +132,13 @@ class Profiler {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Profiler);
 
+  // Write the opening of the profile array if not written yet. mutex_ must be held.
+  void WriteProfileStart();
+  // Write the buffered events but the last one, whose separator is only known once the next event comes.
+  // mutex_ must be held.
+  void FlushEvents();
+  void WriteEvent(const EventRecord& rec, bool is_last);
+
   /**
    * The maximum number of profiler records to collect.
    * This value is used to initialize the per-profiler maximum.
@@ -149,6 +166,8 @@ class Profiler {
   Events events_;
   bool max_events_reached{false};
   bool profile_with_logger_{false};
+  bool profile_start_written_{false};
+  size_t flush_interval_events_{0};
   const size_t max_num_events_{global_max_num_events_.load()};
 
 #ifdef ENABLE_STATIC_PROFILER_INSTANCE
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <optional>
 
@@ -369,6 +372,127 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 #pragma warning(pop) /* Padding added in LoopCounterShard, LoopCounter */
 #endif
 
+// Work-stealing ranges distribute loop iterations for ThreadPool::ParallelForAdaptive.  Each worker starts
+// with a contiguous range of the iteration space, held as a packed [begin, end) pair in a single 64-bit word
+// so that the owner and any thieves can update it with one compare-and-swap.  The owner claims chunks from
+// the front of its range.  Once its range is exhausted, it picks the worker with the most iterations left and
+// takes the back half of that worker's range, publishing the stolen iterations in its own slot so that they
+// can in turn be stolen by others.  Compared with LoopCounter, this lets loops with uneven per-iteration cost
+// rebalance themselves: a worker stuck on expensive iterations loses its remaining work to idle workers.
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4324) /* Padding added to WorkStealingSlot for alignment */
+#endif
+
+struct alignas(CACHE_LINE_BYTES) WorkStealingSlot {
+  ::std::atomic<uint64_t> _range{0};
+};
+
+static_assert(sizeof(WorkStealingSlot) == CACHE_LINE_BYTES, "Expected work-stealing slots to match cache-line size");
+
+class WorkStealingRanges {
+ public:
+  // Largest iteration count that can be represented in a packed range.
+  static constexpr uint64_t MAX_ITERATIONS = std::numeric_limits<uint32_t>::max();
+
+  WorkStealingRanges(uint64_t num_iterations,
+                     unsigned num_slots) : _num_slots(num_slots),
+                                           _slots(std::make_unique<WorkStealingSlot[]>(num_slots)) {
+    assert(num_iterations <= MAX_ITERATIONS);
+    for (unsigned slot = 0; slot < _num_slots; slot++) {
+      // Initialize with a relaxed store; synchronization with worker
+      // threads is provided via the thread pool
+      _slots[slot]._range.store(Pack(num_iterations * slot / _num_slots,
+                                     num_iterations * (slot + 1) / _num_slots),
+                                ::std::memory_order_relaxed);
+    }
+  }
+
+  // Claim up to grain iterations from the front of the worker's own range.  Returns false if the
+  // range is empty.
+  bool ClaimIterations(unsigned my_slot,
+                       uint64_t grain,
+                       uint64_t& my_start,
+                       uint64_t& my_end) {
+    auto& range = _slots[my_slot]._range;
+    uint64_t current = range.load(::std::memory_order_acquire);
+    for (;;) {
+      uint64_t begin = Begin(current);
+      uint64_t end = End(current);
+      if (begin >= end) {
+        return false;
+      }
+      uint64_t next = begin + std::min(grain, end - begin);
+      if (range.compare_exchange_weak(current, Pack(next, end),
+                                      ::std::memory_order_acq_rel,
+                                      ::std::memory_order_acquire)) {
+        my_start = begin;
+        my_end = next;
+        return true;
+      }
+    }
+  }
+
+  // Steal the back half of the largest remaining range held by another worker, and publish it in the
+  // worker's own (empty) slot.  Returns false once no other worker has iterations left.
+  bool StealIterations(unsigned my_slot) {
+    for (;;) {
+      unsigned victim = my_slot;
+      uint64_t victim_range = 0;
+      uint64_t most_remaining = 0;
+      for (unsigned slot = 0; slot < _num_slots; slot++) {
+        if (slot == my_slot) {
+          continue;
+        }
+        uint64_t current = _slots[slot]._range.load(::std::memory_order_acquire);
+        uint64_t remaining = End(current) - Begin(current);
+        if (remaining > most_remaining) {
+          victim = slot;
+          victim_range = current;
+          most_remaining = remaining;
+        }
+      }
+      if (most_remaining == 0) {
+        return false;
+      }
+
+      // A single remaining iteration is taken whole.
+      uint64_t begin = Begin(victim_range);
+      uint64_t end = End(victim_range);
+      uint64_t mid = begin + (end - begin) / 2;
+      if (_slots[victim]._range.compare_exchange_strong(victim_range, Pack(begin, mid),
+                                                        ::std::memory_order_acq_rel,
+                                                        ::std::memory_order_acquire)) {
+        // Only the owner makes its own slot non-empty, hence a plain store is sufficient.
+        _slots[my_slot]._range.store(Pack(mid, end), ::std::memory_order_release);
+        return true;
+      }
+      // Lost a race with the victim or another thief, rescan for a victim.
+    }
+  }
+
+ private:
+  static constexpr uint64_t Pack(uint64_t begin, uint64_t end) {
+    return (begin << 32) | end;
+  }
+
+  static constexpr uint64_t Begin(uint64_t range) {
+    return range >> 32;
+  }
+
+  static constexpr uint64_t End(uint64_t range) {
+    return range & MAX_ITERATIONS;
+  }
+
+  const unsigned _num_slots;
+  std::unique_ptr<WorkStealingSlot[]> _slots;
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop) /* Padding added in WorkStealingSlot */
+#endif
+
 ThreadPool::ThreadPool(Env* env,
                        const ThreadOptions& thread_options,
                        const NAME_CHAR_TYPE* name,
@@ -399,6 +523,21 @@ ThreadPool::ThreadPool(Env* env,
   }
 }
 
+ThreadPool::ThreadPool(ThreadPool* shared_pool, const ThreadPoolShareOptions& share_options)
+    : share_options_(share_options) {
+  ORT_ENFORCE(shared_pool != nullptr, "A shared thread pool is required");
+  ORT_ENFORCE(share_options_.weight > 0, "Thread pool share weight must be positive: ", share_options_.weight);
+  // Always share the pool that owns the threads, so that the weights of all sharing pools are
+  // accounted in the same place.
+  if (shared_pool->shared_pool_ != nullptr) {
+    shared_pool = shared_pool->shared_pool_;
+  }
+  shared_pool_ = shared_pool;
+  thread_options_ = shared_pool->thread_options_;
+  force_hybrid_ = shared_pool->force_hybrid_;
+  underlying_threadpool_ = shared_pool->underlying_threadpool_;
+}
+
 ThreadPool::~ThreadPool() = default;
 
 // Base case for parallel loops, running iterations 0..total, divided into blocks
@@ -416,6 +555,8 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
   }
 
   auto d_of_p = DegreeOfParallelism(this);
+  ThreadPool* owner = OwningPool();
+  const int priority = CurrentRunPriority();
   if (thread_options_.dynamic_block_base_ <= 0) {
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
@@ -429,7 +570,9 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
       unsigned my_home_shard = lc.GetHomeShard(idx);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
-      while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
+      // Helper threads leave the remaining shards to the calling thread once a higher priority run needs them.
+      while ((idx == 0 || !owner->HasHigherPriorityRun(priority)) &&
+             lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block_size)) {
         fn(static_cast<std::ptrdiff_t>(my_iter_start),
            static_cast<std::ptrdiff_t>(my_iter_end));
       }
@@ -448,7 +591,8 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
       unsigned my_home_shard = lc.GetHomeShard(idx);
       unsigned my_shard = my_home_shard;
       uint64_t my_iter_start, my_iter_end;
-      while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, b)) {
+      while ((idx == 0 || !owner->HasHigherPriorityRun(priority)) &&
+             lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, b)) {
         fn(static_cast<std::ptrdiff_t>(my_iter_start),
            static_cast<std::ptrdiff_t>(my_iter_end));
         auto todo = left.fetch_sub(static_cast<std::ptrdiff_t>(my_iter_end - my_iter_start), std::memory_order_relaxed);
@@ -471,6 +615,65 @@ void ThreadPool::SimpleParallelFor(std::ptrdiff_t total, const std::function<voi
   });
 }
 
+// Target duration of each chunk claimed by ParallelForAdaptive.  Long enough to amortize the cost of
+// claiming and timing a chunk, short enough that a worker holding on to a claimed chunk does not
+// become a straggler.
+static constexpr double ADAPTIVE_TARGET_CHUNK_NS = 50000.0;
+
+// Minimum number of chunks per worker in ParallelForAdaptive, so that some of each worker's range
+// is always left available to be stolen.
+static constexpr uint64_t ADAPTIVE_MIN_CHUNKS_PER_WORKER = 4;
+
+void ThreadPool::ParallelForAdaptive(std::ptrdiff_t total,
+                                     const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+  if (total <= 0)
+    return;
+
+  if (!ShouldParallelizeLoop(total)) {
+    fn(0, total);
+    return;
+  }
+
+  auto d_of_p = DegreeOfParallelism(this);
+  if (static_cast<uint64_t>(total) > WorkStealingRanges::MAX_ITERATIONS) {
+    // Too many iterations for a packed range, fall back to dynamic scheduling with a fixed block size.
+    ParallelForFixedBlockSizeScheduling(total, total / (static_cast<std::ptrdiff_t>(d_of_p) * TaskGranularityFactor), fn);
+    return;
+  }
+
+  unsigned num_work_items = static_cast<unsigned>(std::min(static_cast<std::ptrdiff_t>(NumThreads() + 1), total));
+  uint64_t max_grain = std::max<uint64_t>(1, static_cast<uint64_t>(total) / (num_work_items * ADAPTIVE_MIN_CHUNKS_PER_WORKER));
+  WorkStealingRanges ranges(total, num_work_items);
+  ThreadPool* owner = OwningPool();
+  const int priority = CurrentRunPriority();
+  std::function<void(unsigned)> run_work = [&](unsigned idx) {
+    // Helper threads leave their ranges to be stolen by the calling thread once a higher priority run needs them.
+    auto keep_working = [&]() { return idx == 0 || !owner->HasHigherPriorityRun(priority); };
+    // Start with single iterations, then size each chunk from the time per iteration measured so
+    // far, so that chunks take roughly ADAPTIVE_TARGET_CHUNK_NS regardless of the cost of the loop body.
+    uint64_t grain = 1;
+    double ns_per_iteration = 0.0;
+    uint64_t my_iter_start, my_iter_end;
+    do {
+      while (keep_working() && ranges.ClaimIterations(idx, grain, my_iter_start, my_iter_end)) {
+        auto chunk_start = std::chrono::steady_clock::now();
+        fn(static_cast<std::ptrdiff_t>(my_iter_start),
+           static_cast<std::ptrdiff_t>(my_iter_end));
+        double chunk_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - chunk_start).count();
+        double sample = chunk_ns / static_cast<double>(my_iter_end - my_iter_start);
+        ns_per_iteration = ns_per_iteration > 0.0 ? (ns_per_iteration + sample) / 2 : sample;
+        grain = ns_per_iteration > 0.0
+                    ? static_cast<uint64_t>(std::min(ADAPTIVE_TARGET_CHUNK_NS / ns_per_iteration, static_cast<double>(max_grain)))
+                    : max_grain;
+        grain = std::max<uint64_t>(grain, 1);
+      }
+    } while (keep_working() && ranges.StealIterations(idx));
+  };
+  // Synchronization with helping threads is handled within RunInParallel, hence we can deallocate
+  // ranges and other state captured by run_work.
+  RunInParallel(run_work, num_work_items, 1);
+}
+
 void ThreadPool::Schedule(std::function<void()> fn) {
   if (underlying_threadpool_) {
     underlying_threadpool_->Schedule(std::move(fn));
@@ -515,8 +718,103 @@ ThreadPool::ParallelSection::~ParallelSection() {
   }
 }
 
+namespace {
+thread_local const ThreadPool::RunPriorityScope* current_run_priority_scope = nullptr;
+}
+
+ThreadPool::RunPriorityScope::RunPriorityScope(ThreadPool* tp, int priority) {
+  if (tp) {
+    pool_ = tp->OwningPool();
+    priority_ = std::clamp(priority, kMinRunPriority, kMaxRunPriority);
+    pool_->runs_by_priority_[priority_ - kMinRunPriority].fetch_add(1, std::memory_order_relaxed);
+    if (priority_ != 0) {
+      pool_->num_prioritized_runs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    previous_ = current_run_priority_scope;
+    current_run_priority_scope = this;
+  }
+}
+
+ThreadPool::RunPriorityScope::~RunPriorityScope() {
+  if (pool_) {
+    current_run_priority_scope = previous_;
+    pool_->runs_by_priority_[priority_ - kMinRunPriority].fetch_sub(1, std::memory_order_relaxed);
+    if (priority_ != 0) {
+      pool_->num_prioritized_runs_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    if (priority_ != 0 || pool_->num_prioritized_runs_.load(std::memory_order_relaxed) > 0) {
+      // Taking the mutex orders the update of the counters with the waiters checking them.
+      std::lock_guard<std::mutex> lock(pool_->run_priority_mutex_);
+      pool_->run_priority_cv_.notify_all();
+    }
+  }
+}
+
+void ThreadPool::YieldToHigherPriorityRuns() {
+  const RunPriorityScope* run = current_run_priority_scope;
+  if (run == nullptr || !run->pool_->HasHigherPriorityRun(run->priority_)) {
+    return;
+  }
+  ThreadPool* pool = run->pool_;
+  std::unique_lock<std::mutex> lock(pool->run_priority_mutex_);
+  pool->run_priority_cv_.wait(lock, [pool, run]() { return !pool->HasHigherPriorityRun(run->priority_); });
+}
+
+int ThreadPool::CurrentRunPriority() {
+  const RunPriorityScope* run = current_run_priority_scope;
+  return run != nullptr && run->pool_ == OwningPool() ? run->priority_ : 0;
+}
+
+bool ThreadPool::HasHigherPriorityRun(int priority) const {
+  // All runs have priority 0 unless one was registered with another priority.
+  if (num_prioritized_runs_.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  for (int p = priority + 1; p <= kMaxRunPriority; ++p) {
+    if (runs_by_priority_[p - kMinRunPriority].load(std::memory_order_relaxed) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
-  if (underlying_threadpool_) {
+  if (n > 1 && OwningPool()->HasHigherPriorityRun(CurrentRunPriority())) {
+    // Leave the helper threads to the loops of the higher priority runs, the loops make progress with any
+    // number of threads.
+    fn(0);
+    return;
+  }
+  if (underlying_threadpool_ && shared_pool_) {
+    // Limit the loop to this pool's share of the threads, in proportion to the weights of the pools
+    // currently running loops on the shared pool.  The loops are written to make progress with any
+    // number of threads, hence claiming fewer threads than requested is safe.
+    const int64_t weight = share_options_.weight;
+    const int64_t active_weight = shared_pool_->active_share_weight_.fetch_add(weight, std::memory_order_relaxed) + weight;
+    auto release_share = gsl::finally([this, weight]() {
+      shared_pool_->active_share_weight_.fetch_sub(weight, std::memory_order_relaxed);
+    });
+    const int64_t num_threads_inc_main = static_cast<int64_t>(underlying_threadpool_->NumThreads()) + 1;
+    n = static_cast<unsigned>(std::min<int64_t>(n, std::max<int64_t>(1, num_threads_inc_main * weight / active_weight)));
+    share_num_loops_.fetch_add(1, std::memory_order_relaxed);
+
+    const auto loop_start = std::chrono::steady_clock::now();
+    std::function<void(unsigned idx)> timed_fn = [this, &fn, loop_start](unsigned idx) {
+      if (idx != 0) {
+        RecordQueueingDelay(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - loop_start).count()));
+      }
+      fn(idx);
+    };
+    if (current_parallel_section.has_value()) {
+      underlying_threadpool_->RunInParallelSection(*current_parallel_section,
+                                                   std::move(timed_fn),
+                                                   n, block_size);
+    } else {
+      underlying_threadpool_->RunInParallel(std::move(timed_fn),
+                                            n, block_size);
+    }
+  } else if (underlying_threadpool_) {
     if (current_parallel_section.has_value()) {
       underlying_threadpool_->RunInParallelSection(*current_parallel_section,
                                                    std::move(fn),
@@ -530,6 +828,32 @@ void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n,
   }
 }
 
+void ThreadPool::RecordQueueingDelay(uint64_t delay_ns) {
+  share_num_helpers_.fetch_add(1, std::memory_order_relaxed);
+  share_total_queueing_delay_ns_.fetch_add(delay_ns, std::memory_order_relaxed);
+  uint64_t max_delay_ns = share_max_queueing_delay_ns_.load(std::memory_order_relaxed);
+  while (delay_ns > max_delay_ns &&
+         !share_max_queueing_delay_ns_.compare_exchange_weak(max_delay_ns, delay_ns, std::memory_order_relaxed)) {
+  }
+}
+
+ThreadPoolStats ThreadPool::GetStats(const ThreadPool* tp) {
+  ThreadPoolStats stats;
+  if (tp && tp->underlying_threadpool_) {
+    tp->underlying_threadpool_->GetStats(stats);
+  }
+  return stats;
+}
+
+ThreadPoolShareStats ThreadPool::GetShareStats() const {
+  ThreadPoolShareStats stats;
+  stats.num_loops = share_num_loops_.load(std::memory_order_relaxed);
+  stats.num_helpers = share_num_helpers_.load(std::memory_order_relaxed);
+  stats.total_queueing_delay_ns = share_total_queueing_delay_ns_.load(std::memory_order_relaxed);
+  stats.max_queueing_delay_ns = share_max_queueing_delay_ns_.load(std::memory_order_relaxed);
+  return stats;
+}
+
 bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
                                        const std::ptrdiff_t block_size) const {
   // Do not parallelize trivial loops, with only a single block of work
@@ -675,9 +999,13 @@ void ThreadPool::DisableSpinning() {
   }
 }
 
-// Return the number of threads created by the pool.
+// Return the number of threads created by the pool.  For a pool sharing the threads of
+// another pool, return the number of those threads that it may use.
 int ThreadPool::NumThreads() const {
   if (underlying_threadpool_) {
+    if (shared_pool_ && share_options_.max_degree_of_parallelism > 0) {
+      return std::min(underlying_threadpool_->NumThreads(), share_options_.max_degree_of_parallelism - 1);
+    }
     return underlying_threadpool_->NumThreads();
   } else {
     return 0;
@@ -703,5 +1031,16 @@ void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t tota
   tp->ParallelFor(total, cost_per_unit, fn);
 }
 
+void ThreadPool::TryParallelForAdaptive(concurrency::ThreadPool* tp, std::ptrdiff_t total,
+                                        const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+  if (tp == nullptr) {
+    if (total > 0) {
+      fn(0, total);
+    }
+    return;
+  }
+  tp->ParallelForAdaptive(total, fn);
+}
+
 }  // namespace concurrency
 }  // namespace onnxruntime
@@ -83,6 +83,11 @@ OrtDevice GetOrtDevice(const DLDevice& device) {
   switch (device.device_type) {
     case DLDeviceType::kDLCPU:
       return OrtDevice();
+    // Page-locked host memory the GPU can access directly, e.g. torch tensors created with pin_memory=True.
+    case DLDeviceType::kDLCUDAHost:
+      return OrtDevice(OrtDevice::CPU, OrtDevice::MemType::CUDA_PINNED, 0);
+    case DLDeviceType::kDLROCMHost:
+      return OrtDevice(OrtDevice::CPU, OrtDevice::MemType::HIP_PINNED, 0);
     case DLDeviceType::kDLCUDA:
     case DLDeviceType::kDLROCM:
       return OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, static_cast<OrtDevice::DeviceId>(device.device_id));
@@ -146,9 +151,20 @@ MLDataType GetOrtValueDataType(const DLDataType& dtype, bool is_bool_tensor) {
 const char* GetOrtDeviceName(const OrtDevice& device) {
   switch (device.Type()) {
     case OrtDevice::CPU:
-      return CPU;
+      switch (device.MemType()) {
+        case OrtDevice::MemType::CUDA_PINNED:
+          return CUDA_PINNED;
+        case OrtDevice::MemType::HIP_PINNED:
+          return HIP_PINNED;
+        default:
+          return CPU;
+      }
     case OrtDevice::GPU:
+#ifdef USE_ROCM
+      return HIP;
+#else
       return CUDA;
+#endif
     default:
       ORT_THROW("Unknown device type: ", device.Type());
   }
@@ -185,7 +201,19 @@ DLDevice GetDlpackDevice(const OrtValue& ort_value, const int64_t& device_id) {
   const auto& location = tensor.Location();
   switch (location.device.Type()) {
     case OrtDevice::CPU:
-      device.device_type = DLDeviceType::kDLCPU;
+      switch (location.device.MemType()) {
+        case OrtDevice::MemType::CUDA_PINNED:
+          device.device_type = DLDeviceType::kDLCUDAHost;
+          device.device_id = 0;
+          break;
+        case OrtDevice::MemType::HIP_PINNED:
+          device.device_type = DLDeviceType::kDLROCMHost;
+          device.device_id = 0;
+          break;
+        default:
+          device.device_type = DLDeviceType::kDLCPU;
+          break;
+      }
       break;
     case OrtDevice::GPU:
 #ifdef USE_ROCM
@@ -246,7 +274,7 @@ OrtValue DlpackToOrtValue(DLManagedTensor* dlpack, bool is_bool_tensor) {
   OrtMemoryInfo info(GetOrtDeviceName(device), OrtDeviceAllocator, device, device.Id());
   std::unique_ptr<Tensor> p_tensor = std::make_unique<Tensor>(
       data_type, TensorShape(dlpack->dl_tensor.shape, static_cast<size_t>(dlpack->dl_tensor.ndim)),
-      dlpack->dl_tensor.data, info);
+      static_cast<char*>(dlpack->dl_tensor.data) + dlpack->dl_tensor.byte_offset, info);
 
   OrtValue ort_value;
   std::function<void(void*)> deleter = [dlpack](void* p) {
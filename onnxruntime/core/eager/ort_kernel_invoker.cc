@@ -2,8 +2,13 @@
 // Licensed under the MIT License.
 
 #include "core/eager/ort_kernel_invoker.h"
+
+#include <algorithm>
+
 #include "core/optimizer/optimizer_execution_frame.h"
 #include "core/common/logging/logging.h"
+#include "core/framework/config_options.h"
+#include "core/framework/kernel_registry.h"
 #include "core/graph/model.h"
 #include "core/framework/op_kernel.h"
 #include "core/session/ort_env.h"
@@ -13,46 +18,91 @@ namespace onnxruntime {
 
 #define ORT_EAGER_ONNX_OPSET_VERSION 14
 
-common::Status ORTInvoker::Invoke(const std::string& op_name,
-                                  // optional inputs / outputs?
-                                  const std::vector<OrtValue>& inputs,
-                                  std::vector<OrtValue>& outputs,
-                                  const NodeAttributes* attributes,
-                                  const std::string& domain,
-                                  const int version) {
+struct ORTInvoker::CachedKernel {
+  std::unique_ptr<Model> model;
+  const Node* node = nullptr;
+  // referenced by info and kernel, so they must outlive them
+  std::function<bool(const std::string&)> is_sparse_initializer = [](const std::string&) { return false; };
+  ConfigOptions config_options;
+  std::unique_ptr<OptimizerExecutionFrame::Info> info;
+  const KernelCreateInfo* kernel_create_info = nullptr;
+  std::unique_ptr<const OpKernel> kernel;
+  std::vector<int> feed_mlvalue_idxs;
+  std::vector<int> fetch_mlvalue_idxs;
+};
+
+ORTInvoker::~ORTInvoker() = default;
+
+namespace {
+// The signature of an invocation: op, domain, version, number of outputs, input element types and attributes.
+std::string GetKernelCacheKey(const std::string& op_name,
+                              const std::vector<OrtValue>& inputs,
+                              size_t num_outputs,
+                              const NodeAttributes* attributes,
+                              const std::string& domain,
+                              const int version) {
+  std::string key = domain + ":" + op_name + ":" + std::to_string(version) + ":" + std::to_string(num_outputs);
+  for (const auto& input : inputs) {
+    key += ":" + std::to_string(input.Get<Tensor>().GetElementType());
+  }
+
+  if (attributes != nullptr) {
+    // NodeAttributes is unordered, so sort the attributes for a stable key
+    std::vector<const ONNX_NAMESPACE::AttributeProto*> sorted_attributes;
+    sorted_attributes.reserve(attributes->size());
+    for (const auto& attribute : *attributes) {
+      sorted_attributes.push_back(&attribute.second);
+    }
+    std::sort(sorted_attributes.begin(), sorted_attributes.end(),
+              [](const auto* lhs, const auto* rhs) { return lhs->name() < rhs->name(); });
+    for (const auto* attribute : sorted_attributes) {
+      key += "|" + attribute->SerializeAsString();
+    }
+  }
+
+  return key;
+}
+}  // namespace
+
+common::Status ORTInvoker::CreateKernel(const std::string& op_name,
+                                        const std::vector<OrtValue>& inputs,
+                                        size_t num_outputs,
+                                        const NodeAttributes* attributes,
+                                        const std::string& domain,
+                                        const int version,
+                                        std::unique_ptr<CachedKernel>& cached_kernel) const {
   std::unordered_map<std::string, int> domain_version_map = {{kOnnxDomain, ORT_EAGER_ONNX_OPSET_VERSION},
                                                              {kMSDomain, 1}};
+  auto entry = std::make_unique<CachedKernel>();
   // create a graph
-  Model model("test",
-              false,
-              ModelMetaData(),
-              ORT_TSTR(""),
-              custom_op_registries_,
-              domain_version_map,
-              {},
-              logger_);
+  entry->model = std::make_unique<Model>("test",
+                                         false,
+                                         ModelMetaData(),
+                                         ORT_TSTR(""),
+                                         custom_op_registries_,
+                                         domain_version_map,
+                                         std::vector<ONNX_NAMESPACE::FunctionProto>{},
+                                         logger_);
 
   std::vector<onnxruntime::NodeArg*> input_args;
   std::vector<onnxruntime::NodeArg*> output_args;
 
   input_args.reserve(inputs.size());
-  output_args.reserve(outputs.size());
+  output_args.reserve(num_outputs);
 
-  Graph& graph = model.MainGraph();
-  std::unordered_map<std::string, OrtValue> initializer_map;
+  Graph& graph = entry->model->MainGraph();
   size_t i = 0;
 
-  for (auto input : inputs) {
+  for (const auto& input : inputs) {
     std::string name = "I" + std::to_string(i++);
     const Tensor& input_tensor = input.Get<Tensor>();
     ONNX_NAMESPACE::TypeProto input_tensor_type;
     input_tensor_type.mutable_tensor_type()->set_elem_type(input_tensor.GetElementType());
     auto& arg = graph.GetOrCreateNodeArg(name, &input_tensor_type);
     input_args.push_back(&arg);
-    initializer_map[name] = input;
   }
 
-  for (i = 0; i < outputs.size(); ++i) {
+  for (i = 0; i < num_outputs; ++i) {
     auto& arg = graph.GetOrCreateNodeArg("O" + std::to_string(i), nullptr);
     output_args.push_back(&arg);
   }
@@ -61,38 +111,87 @@ common::Status ORTInvoker::Invoke(const std::string& op_name,
   ORT_RETURN_IF_ERROR(graph.Resolve());
 
   node.SetExecutionProviderType(execution_provider_->Type());
-  std::vector<const Node*> frame_nodes{&node};
+  entry->node = &node;
+
+  // the inputs are fed to the frame instead of being initializers, so that the kernel does not capture them as
+  // constant inputs and can be reused for other values.
+  entry->info = std::make_unique<OptimizerExecutionFrame::Info>(std::vector<const Node*>{&node},
+                                                                std::unordered_map<std::string, OrtValue>{},
+                                                                graph.ModelPath(), *execution_provider_,
+                                                                entry->is_sparse_initializer);
+  ORT_RETURN_IF_ERROR(entry->info->TryFindKernel(&node, &entry->kernel_create_info));
+  if (!entry->kernel_create_info) {
+    ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
+  }
 
-  OptimizerExecutionFrame::Info info({&node}, initializer_map, graph.ModelPath(), *execution_provider_, [](std::string const&) { return false; });
-  const KernelCreateInfo* kernel_create_info = nullptr;
-  ORT_RETURN_IF_ERROR(info.TryFindKernel(&node, &kernel_create_info));
-  if (!kernel_create_info) {
+  entry->kernel = entry->info->CreateKernel(&node, entry->config_options);
+  if (!entry->kernel) {
     ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
   }
+
+  for (const auto* node_in : node.InputDefs()) {
+    entry->feed_mlvalue_idxs.push_back(entry->info->GetMLValueIndex(node_in->Name()));
+  }
+
+  for (const auto* node_out : node.OutputDefs()) {
+    entry->fetch_mlvalue_idxs.push_back(entry->info->GetMLValueIndex(node_out->Name()));
+  }
+
+  cached_kernel = std::move(entry);
+  return Status::OK();
+}
+
+common::Status ORTInvoker::Invoke(const std::string& op_name,
+                                  // optional inputs / outputs?
+                                  const std::vector<OrtValue>& inputs,
+                                  std::vector<OrtValue>& outputs,
+                                  const NodeAttributes* attributes,
+                                  const std::string& domain,
+                                  const int version) {
+  std::shared_ptr<const CachedKernel> cached_kernel;
+  if (kernel_cache_capacity_ == 0) {
+    std::unique_ptr<CachedKernel> entry;
+    ORT_RETURN_IF_ERROR(CreateKernel(op_name, inputs, outputs.size(), attributes, domain, version, entry));
+    cached_kernel = std::move(entry);
+  } else {
+    const std::string key = GetKernelCacheKey(op_name, inputs, outputs.size(), attributes, domain, version);
+    std::lock_guard<OrtMutex> lock(kernel_cache_mutex_);
+    auto it = kernel_cache_index_.find(key);
+    if (it != kernel_cache_index_.end()) {
+      kernel_cache_.splice(kernel_cache_.begin(), kernel_cache_, it->second);
+    } else {
+      std::unique_ptr<CachedKernel> entry;
+      ORT_RETURN_IF_ERROR(CreateKernel(op_name, inputs, outputs.size(), attributes, domain, version, entry));
+      if (kernel_cache_.size() == kernel_cache_capacity_) {
+        kernel_cache_index_.erase(kernel_cache_.back().first);
+        kernel_cache_.pop_back();
+      }
+      kernel_cache_.emplace_front(key, std::move(entry));
+      kernel_cache_index_.emplace(key, kernel_cache_.begin());
+    }
+    cached_kernel = kernel_cache_.front().second;
+  }
+
   // check whether the inputs are contiguous tensor
-  const auto& may_strided_inputs = kernel_create_info->kernel_def->MayStridedInput();
-  for (i = 0; i < inputs.size(); ++i) {
+  const auto& may_strided_inputs = cached_kernel->kernel_create_info->kernel_def->MayStridedInput();
+  for (size_t i = 0; i < inputs.size(); ++i) {
     const Tensor& input_tensor = inputs[i].Get<Tensor>();
     if (!input_tensor.IsContiguous() && std::find(may_strided_inputs.begin(), may_strided_inputs.end(),
                                                   static_cast<int>(i)) == may_strided_inputs.end())
       ORT_THROW("kernel name:", op_name, "'s ", i, "th input doesn't support non-contiguous tensor.");
   }
 
-  auto kernel = info.CreateKernel(&node);
-  if (!kernel) {
-    ORT_THROW("Could not find kernel name:", op_name, ", domain:", domain, ", version:", version);
-  }
-
-  std::vector<int> fetch_mlvalue_idxs;
-  for (const auto* node_out : node.OutputDefs()) {
-    fetch_mlvalue_idxs.push_back(info.GetMLValueIndex(node_out->Name()));
-  }
-
-  OptimizerExecutionFrame frame(info, fetch_mlvalue_idxs, outputs);
-  OpKernelContext op_kernel_context(&frame, kernel.get(), nullptr, nullptr, logger_);
-  ORT_RETURN_IF_ERROR(kernel->Compute(&op_kernel_context));
+  OptimizerExecutionFrame frame(*cached_kernel->info, cached_kernel->feed_mlvalue_idxs, inputs,
+                                cached_kernel->fetch_mlvalue_idxs, outputs);
+  OpKernelContext op_kernel_context(&frame, cached_kernel->kernel.get(), nullptr, nullptr, logger_);
+  ORT_RETURN_IF_ERROR(cached_kernel->kernel->Compute(&op_kernel_context));
 
   return frame.GetOutputs(outputs);
 }
 
+size_t ORTInvoker::GetKernelCacheSize() {
+  std::lock_guard<OrtMutex> lock(kernel_cache_mutex_);
+  return kernel_cache_.size();
+}
+
 }  // namespace onnxruntime
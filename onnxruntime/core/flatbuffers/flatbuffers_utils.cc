@@ -3,7 +3,13 @@
 
 #include "core/flatbuffers/flatbuffers_utils.h"
 
+#include <array>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
 #include "core/common/common.h"
+#include "core/common/narrow.h"
 #include <gsl/gsl>
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/graph/constants.h"
@@ -316,4 +322,61 @@ bool IsOrtFormatModelBytes(const void* bytes, int num_bytes) {
   return num_bytes > 8 &&  // check buffer is large enough to contain identifier so we don't read random memory
          fbs::InferenceSessionBufferHasIdentifier(bytes);
 }
+
+namespace {
+// the trailer of a model with a data section, stored little endian like the flatbuffer
+struct DataSectionTrailer {
+  uint64_t data_section_offset;
+  uint64_t data_section_size;
+  std::array<char, 8> magic;
+};
+
+static_assert(sizeof(DataSectionTrailer) == 24, "The trailer must not have padding");
+
+constexpr std::array<char, 8> kDataSectionMagic{'O', 'R', 'T', 'D', 'A', 'T', 'A', '1'};
+}  // namespace
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status SaveOrtFormatModelWithDataSection(std::ostream& stream, gsl::span<const uint8_t> flatbuffer,
+                                         gsl::span<const uint8_t> data_section) {
+  const size_t data_section_offset =
+      (flatbuffer.size() + kOrtFormatDataSectionAlignment - 1) / kOrtFormatDataSectionAlignment *
+      kOrtFormatDataSectionAlignment;
+  const std::vector<char> padding(data_section_offset - flatbuffer.size(), 0);
+
+  const DataSectionTrailer trailer{data_section_offset, data_section.size(), kDataSectionMagic};
+  stream.write(reinterpret_cast<const char*>(flatbuffer.data()), flatbuffer.size());
+  stream.write(padding.data(), padding.size());
+  stream.write(reinterpret_cast<const char*>(data_section.data()), data_section.size());
+  stream.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+  ORT_RETURN_IF_NOT(stream, "Failed to write the ORT format model.");
+  return Status::OK();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+Status SplitOrtFormatModelBytes(gsl::span<const uint8_t> model_bytes, gsl::span<const uint8_t>& flatbuffer,
+                                gsl::span<const uint8_t>& data_section) {
+  flatbuffer = model_bytes;
+  data_section = {};
+
+  DataSectionTrailer trailer;
+  if (model_bytes.size() < sizeof(trailer)) {
+    return Status::OK();
+  }
+  std::memcpy(&trailer, model_bytes.data() + model_bytes.size() - sizeof(trailer), sizeof(trailer));
+  if (trailer.magic != kDataSectionMagic) {
+    return Status::OK();
+  }
+
+  const size_t trailer_offset = model_bytes.size() - sizeof(trailer);
+  ORT_RETURN_IF(trailer.data_section_offset % kOrtFormatDataSectionAlignment != 0 ||
+                    trailer.data_section_offset > trailer_offset ||
+                    trailer.data_section_size != trailer_offset - trailer.data_section_offset,
+                "Invalid data section. ", kInvalidOrtFormatModelMessage);
+
+  const auto data_section_offset = narrow<size_t>(trailer.data_section_offset);
+  flatbuffer = model_bytes.first(data_section_offset);
+  data_section = model_bytes.subspan(data_section_offset, narrow<size_t>(trailer.data_section_size));
+  return Status::OK();
+}
 }  // namespace onnxruntime::fbs::utils
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <iosfwd>
 #include <unordered_map>
 
+#include <gsl/gsl>
+
 #include "core/common/flatbuffers.h"
 
 #include "core/common/common.h"
@@ -56,6 +59,27 @@ bool IsOrtFormatModel(const PathString& filename);
 // check if bytes has the flatbuffer ORT identifier
 bool IsOrtFormatModelBytes(const void* bytes, int num_bytes);
 
+// Since version 7 the large initializers of an ORT format model may be stored in a data section after the flatbuffer,
+// with Tensor.external_data_offset being their offset in the data section. The data section starts at a multiple of
+// kOrtFormatDataSectionAlignment bytes and each initializer in it at a multiple of kOrtFormatInitializerAlignment
+// bytes, so a memory mapped model provides initializers aligned for SIMD kernels. A trailer at the end of the model
+// records where the data section is.
+constexpr size_t kOrtFormatDataSectionAlignment = 4096;
+constexpr size_t kOrtFormatInitializerAlignment = 64;
+
+#if !defined(ORT_MINIMAL_BUILD)
+// write the flatbuffer of an ORT format model followed by its data section and the trailer
+onnxruntime::common::Status SaveOrtFormatModelWithDataSection(std::ostream& stream,
+                                                              gsl::span<const uint8_t> flatbuffer,
+                                                              gsl::span<const uint8_t> data_section);
+#endif
+
+// split the bytes of an ORT format model into the flatbuffer and the data section.
+// data_section is empty if the model doesn't have one.
+onnxruntime::common::Status SplitOrtFormatModelBytes(gsl::span<const uint8_t> model_bytes,
+                                                     gsl::span<const uint8_t>& flatbuffer,
+                                                     gsl::span<const uint8_t>& data_section);
+
 }  // namespace utils
 }  // namespace fbs
 }  // namespace onnxruntime
@@ -20,8 +20,13 @@ namespace onnxruntime {
 // Version 4 - update kernel def hashing to not depend on ordering of type constraint types (NOT BACKWARDS COMPATIBLE)
 // Version 5 - deprecate kernel def hashes and add KernelTypeStrResolver info to replace them (NOT BACKWARDS COMPATIBLE)
 // Version 6 - add float 8 types
+// Version 7 - add the data section for aligned initializers
 constexpr const int kOrtModelVersion = 6;
 
+// Models with a data section are saved with this version so that older runtimes reject them, the others keep
+// kOrtModelVersion.
+constexpr const int kOrtModelVersionWithDataSection = 7;
+
 // Check if the given ort model version is supported in this build
 inline bool IsOrtModelVersionSupported(const int ort_model_version) {
   // The ort model versions we will support in this build
@@ -29,6 +34,7 @@ inline bool IsOrtModelVersionSupported(const int ort_model_version) {
   constexpr std::array kSupportedOrtModelVersions{
       kOrtModelVersion - 1,
       kOrtModelVersion,
+      kOrtModelVersionWithDataSection,
   };
 
   const auto it = std::find(kSupportedOrtModelVersions.begin(), kSupportedOrtModelVersions.end(), ort_model_version);
@@ -98,6 +98,25 @@ class TensorSeq {
     Add(std::move(value));
   }
 
+  // Insert a tensor before the tensor at index. index == Size() appends.
+  void Insert(size_t index, OrtValue&& tensor) {
+    ORT_ENFORCE(index <= tensors_.size());
+    ORT_ENFORCE(IsSameDataType(tensor.Get<Tensor>()),
+                "TensorSeq: tensor to be added has a different data type.");
+    tensors_.insert(tensors_.begin() + index, std::move(tensor));
+  }
+
+  void Insert(size_t index, Tensor&& tensor) {
+    OrtValue value;
+    Tensor::InitOrtValue(std::move(tensor), value);
+    Insert(index, std::move(value));
+  }
+
+  void Erase(size_t index) {
+    ORT_ENFORCE(index < tensors_.size());
+    tensors_.erase(tensors_.begin() + index);
+  }
+
   static void InitOrtValue(const TensorSeq& source_tensor_seq, std::shared_ptr<IAllocator> allocator, OrtValue& ort_value) {
     auto target_tensor_seq = std::make_unique<TensorSeq>(source_tensor_seq.DataType());
     target_tensor_seq->Reserve(source_tensor_seq.Size());
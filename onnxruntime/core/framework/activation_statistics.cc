@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/activation_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "core/common/common.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Finds the min and max of the finite values, returns false if there are none.
+bool FindFiniteMinMax(gsl::span<const float> values, float& min, float& max) {
+  MlasFindMinMaxElement(values.data(), &min, &max, values.size());
+  if (std::isfinite(min) && std::isfinite(max)) {
+    return true;
+  }
+
+  // slow path for the rare tensors with NaN or infinite values
+  bool found = false;
+  for (const float value : values) {
+    if (std::isfinite(value)) {
+      min = found ? std::min(min, value) : value;
+      max = found ? std::max(max, value) : value;
+      found = true;
+    }
+  }
+  return found;
+}
+
+}  // namespace
+
+ActivationStatistics::ActivationStatistics(size_t num_slots, size_t num_bins)
+    : num_slots_(num_slots), num_bins_(num_bins), slots_(std::make_unique<Slot[]>(num_slots)) {
+  ORT_ENFORCE(num_bins_ > 0 && num_bins_ % 2 == 0, "The number of histogram bins must be even and positive, got ",
+              num_bins_);
+}
+
+ActivationStatistics::~ActivationStatistics() = default;
+
+void ActivationStatistics::GrowHistogram(Snapshot& statistics, float min, float max) {
+  auto& histogram = statistics.histogram;
+  const size_t half = histogram.size() / 2;
+
+  while (min < statistics.histogram_begin || max > statistics.histogram_end) {
+    const double width = statistics.histogram_end - statistics.histogram_begin;
+    // the current range becomes the lower half of the new one if the values are above it, else the upper half
+    const bool grow_up = min >= statistics.histogram_begin;
+    std::vector<uint64_t> merged(histogram.size());
+    for (size_t i = 0; i < half; ++i) {
+      merged[grow_up ? i : half + i] = histogram[2 * i] + histogram[2 * i + 1];
+    }
+    histogram = std::move(merged);
+    if (grow_up) {
+      statistics.histogram_end += width;
+    } else {
+      statistics.histogram_begin -= width;
+    }
+  }
+}
+
+void ActivationStatistics::Record(size_t slot, gsl::span<const float> values) {
+  ORT_ENFORCE(slot < num_slots_, "Activation statistics slot ", slot, " is out of range ", num_slots_);
+  float min = 0.0f;
+  float max = 0.0f;
+  if (values.empty() || !FindFiniteMinMax(values, min, max)) {
+    return;
+  }
+
+  Slot& s = slots_[slot];
+  std::lock_guard<std::mutex> lock(s.mutex);
+  Snapshot& statistics = s.statistics;
+
+  if (statistics.count == 0) {
+    if (max > min) {
+      statistics.histogram_begin = min;
+      statistics.histogram_end = max;
+    } else {
+      // a single distinct value, center it in a range of its magnitude
+      const double radius = std::max(std::abs(static_cast<double>(min)), 1.0) / 2;
+      statistics.histogram_begin = min - radius;
+      statistics.histogram_end = min + radius;
+    }
+    statistics.histogram.assign(num_bins_, 0);
+    statistics.min = min;
+    statistics.max = max;
+  } else {
+    GrowHistogram(statistics, min, max);
+    statistics.min = std::min(statistics.min, min);
+    statistics.max = std::max(statistics.max, max);
+  }
+
+  const double begin = statistics.histogram_begin;
+  const double bins_per_unit = static_cast<double>(num_bins_) / (statistics.histogram_end - begin);
+  const double last_bin = static_cast<double>(num_bins_ - 1);
+  auto* histogram = statistics.histogram.data();
+  uint64_t count = 0;
+  for (const float value : values) {
+    if (std::isfinite(value)) {
+      // clamping also keeps finite values outside of [min, max] in range, should a NaN have hidden them from MLAS
+      const double bin = std::min(std::max((value - begin) * bins_per_unit, 0.0), last_bin);
+      ++histogram[static_cast<size_t>(bin)];
+      ++count;
+    }
+  }
+  statistics.count += count;
+}
+
+ActivationStatistics::Snapshot ActivationStatistics::GetSnapshot(size_t slot) const {
+  ORT_ENFORCE(slot < num_slots_, "Activation statistics slot ", slot, " is out of range ", num_slots_);
+  const Slot& s = slots_[slot];
+  std::lock_guard<std::mutex> lock(s.mutex);
+  return s.statistics;
+}
+
+}  // namespace onnxruntime
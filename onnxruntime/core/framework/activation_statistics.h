@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gsl/gsl>
+
+namespace onnxruntime {
+
+/**
+ * Running min/max and histogram of the float values of a fixed number of slots, e.g. the OrtValues of a graph,
+ * collected while a session runs to calibrate static quantization without adding outputs to the model.
+ *
+ * The histogram of a slot has a fixed number of bins of equal width. The range they cover is set by the first
+ * recorded values and doubles, by merging pairs of bins, whenever later values fall outside of it, so the
+ * histograms of any number of runs take constant memory. NaN and infinite values are not counted.
+ */
+class ActivationStatistics {
+ public:
+  struct Snapshot {
+    uint64_t count = 0;
+    float min = 0.0f;
+    float max = 0.0f;
+
+    // histogram[i] counts the values in [histogram_begin + i * w, histogram_begin + (i + 1) * w), with
+    // w = (histogram_end - histogram_begin) / histogram.size(). The last bin also counts histogram_end.
+    double histogram_begin = 0.0;
+    double histogram_end = 0.0;
+    std::vector<uint64_t> histogram;
+  };
+
+  // num_bins must be even and positive.
+  ActivationStatistics(size_t num_slots, size_t num_bins);
+  ~ActivationStatistics();
+
+  ActivationStatistics(const ActivationStatistics&) = delete;
+  ActivationStatistics& operator=(const ActivationStatistics&) = delete;
+
+  size_t NumSlots() const noexcept { return num_slots_; }
+  size_t NumBins() const noexcept { return num_bins_; }
+
+  void Record(size_t slot, gsl::span<const float> values);
+
+  Snapshot GetSnapshot(size_t slot) const;
+
+ private:
+  struct Slot {
+    mutable std::mutex mutex;
+    Snapshot statistics;
+  };
+
+  // Doubles the range of the histogram until it holds [min, max].
+  static void GrowHistogram(Snapshot& statistics, float min, float max);
+
+  const size_t num_slots_;
+  const size_t num_bins_;
+  std::unique_ptr<Slot[]> slots_;
+};
+
+}  // namespace onnxruntime
@@ -5,6 +5,8 @@
 #include <list>
 #include <algorithm>
 #include <deque>
+#include <limits>
+#include <queue>
 #include <sstream>
 #include <ctime>
 #include <iomanip>
@@ -98,6 +100,7 @@ std::ostream& operator<<(std::ostream& out, std::pair<const SequentialExecutionP
       auto& elt_plan = plan.allocation_plan[index];
       out << elt_plan.alloc_kind;
       if (elt_plan.alloc_kind == AllocKind::kReuse) out << " " << elt_plan.reused_buffer;
+      if (elt_plan.is_sub_buffer) out << " at offset " << elt_plan.sub_buffer_offset;
       auto& loc = elt_plan.location;
       out << ", " << loc.ToString();
     } else {
@@ -217,6 +220,9 @@ class PlannerImpl {
   // they became free (more recently freed earlier in the list).
   std::list<FreeBufferInfo> freelist_;
 
+  // pinned_host_values_ : the CPU tensors placed in pinned memory by ComputePinnedHostLocation
+  InlinedHashSet<OrtValueIndex> pinned_host_values_;
+
   OrtValueIndex Index(const OrtValueName& name) {
     OrtValueIndex result;
     auto status = ort_value_name_idx_map_.GetIdx(name, result);
@@ -390,7 +396,9 @@ class PlannerImpl {
 #endif
 
               if (!need_skip) {
-                if (SameSize(*p_input_arg, *p_output_arg)) {
+                // a sequence holds its tensors by reference, so reusing it doesn't depend on the tensor sizes
+                if (SameSize(*p_input_arg, *p_output_arg) ||
+                    (IsTensorSequence(*p_input_arg) && IsTensorSequence(*p_output_arg))) {
                   // we can reuse this input since it is its last use and permitted for in-place update
                   *reusable_input = input_arg_index;  // or original; both should be okay
                   return true;
@@ -415,7 +423,8 @@ class PlannerImpl {
     for (auto& pair : may_strided_outputs_map) {
       if (pair.second == output_arg_num && pair.first >= 0 && static_cast<size_t>(pair.first) < input_args.size() &&
           input_args[pair.first]->Exists()) {
-        bool can_strided = true;
+        // sub-byte elements can't be addressed through strides
+        bool can_strided = !HasSubByteElements(*p_output_arg);
         for (auto it = node.OutputNodesBegin(); it != node.OutputNodesEnd(); ++it) {
           const KernelCreateInfo& output_node_ci = GetKernelCreateInfo(kernel_create_info_map_, it->Index());
           if (!output_node_ci.kernel_def) {
@@ -492,6 +501,19 @@ class PlannerImpl {
     return elt_type->Size();
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  /*! \brief Whether the elements of a tensor arg are packed several to a byte, like int4.
+   */
+  static bool HasSubByteElements(const onnxruntime::NodeArg& arg) {
+    const TensorTypeBase* tensor_type_base = utils::GetMLDataType(arg)->AsTensorType();
+    if (tensor_type_base == nullptr) {
+      return false;
+    }
+    const PrimitiveDataTypeBase* elt_type = tensor_type_base->GetElementType()->AsPrimitiveDataType();
+    return elt_type != nullptr && elt_type->HasSubElems();
+  }
+#endif
+
   static bool SameSize(const TensorShapeProto& shape1, const onnxruntime::NodeArg& arg1,
                        const TensorShapeProto& shape2, const onnxruntime::NodeArg& arg2) {
     const auto& ptype1 = arg1.Type();
@@ -547,6 +569,8 @@ class PlannerImpl {
     }
     auto p_required_buffer_shape = context_->GetShape(output_arg);
     if (nullptr == p_required_buffer_shape || p_required_buffer_shape->dim_size() == 0) return false;
+    // a pinned host value must own its buffer so that the buffer is not released before the end of the run
+    if (pinned_host_values_.count(Index(output_arg.Name())) > 0) return false;
     auto& required_memory_info = AllocPlan(output_arg.Name()).location;
 
     for (auto it = freelist_.begin(); it != freelist_.end(); ++it) {
@@ -679,6 +703,10 @@ class PlannerImpl {
     for (auto graph_output : graph_viewer_.GetOutputs()) {
       UseCount(graph_output->Name())++;  // Models caller's usage post-inference; ensures it will not be reused.
     }
+
+    for (auto index : pinned_host_values_) {
+      UseCount(index)++;  // an asynchronous copy may read it until the end of the run; ensures it will not be reused.
+    }
     return Status::OK();
   }
 
@@ -1428,6 +1456,66 @@ class PlannerImpl {
   }
 #endif
 
+  // Places the CPU tensors copied to a device by a MemcpyFromHost node in the pinned memory of the device's EP, so
+  // that the copy is an asynchronous DMA on the device stream instead of a synchronous copy staged by the driver.
+  // As the copy may still read a pinned value after the MemcpyFromHost node has returned, the value is neither
+  // reused nor released before the end of the run.
+  // Only values allocated by their producer in the default CPU memory are placed, i.e. not graph inputs, outputs,
+  // initializers nor outputs aliasing or reusing an input of the producer.
+  void ComputePinnedHostLocation() {
+    if (context_->IsParallelExecutionEnabled() || !IsSingleStream()) {
+      return;
+    }
+
+    const auto& graph_outputs = graph_viewer_.GetOutputs();
+    for (const auto& stream : stream_nodes_) {
+      for (NodeIndex node_index : stream) {
+        const Node& node = *graph_viewer_.GetNode(node_index);
+        if (HasExternalOutputs(node)) {
+          continue;
+        }
+
+        const KernelCreateInfo& ci = GetKernelCreateInfo(kernel_create_info_map_, node_index);
+        const auto alias_map = GetAliasMap(node, ci);
+        const auto& inplace_map = ci.kernel_def->MayInplace();
+        const auto& variadic_alias_offsets = ci.kernel_def->VariadicAlias();
+
+        for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+          const Node& consumer = it->GetNode();
+          const auto* consumer_provider = execution_providers_.Get(consumer);
+          if (consumer.OpType() != "MemcpyFromHost" || consumer_provider == nullptr) {
+            continue;
+          }
+
+          const OrtDevice pinned_device = consumer_provider->GetOrtDeviceByMemType(OrtMemTypeCPUOutput);
+          if (pinned_device.Type() != OrtDevice::CPU || pinned_device.MemType() == OrtDevice::MemType::DEFAULT) {
+            continue;
+          }
+
+          const int output_arg_num = it->GetSrcArgIndex();
+          const NodeArg* output_arg = node.OutputDefs()[output_arg_num];
+          const OrtValueIndex index = Index(output_arg->Name());
+          const OrtDevice& location = AllocPlan(index).location;
+          const auto is_output_arg = [output_arg_num](const std::pair<int, int>& pair) {
+            return pair.second == output_arg_num;
+          };
+
+          if (location.Type() != OrtDevice::CPU || location.MemType() != OrtDevice::MemType::DEFAULT ||
+              IsNonTensor(*output_arg) ||
+              std::find(graph_outputs.begin(), graph_outputs.end(), output_arg) != graph_outputs.end() ||
+              std::any_of(alias_map.begin(), alias_map.end(), is_output_arg) ||
+              std::any_of(inplace_map.begin(), inplace_map.end(), is_output_arg) ||
+              (variadic_alias_offsets.has_value() && output_arg_num >= variadic_alias_offsets->second)) {
+            continue;
+          }
+
+          plan_.SetLocation(static_cast<size_t>(index), pinned_device);
+          pinned_host_values_.insert(index);
+        }
+      }
+    }
+  }
+
   Status ComputeReusePlan() {
     gsl::not_null<const ISequentialPlannerContext*> backup_context = context_;
     SequentialPlannerContext no_mem_reuse_context(ExecutionMode::ORT_PARALLEL, ExecutionOrder::DEFAULT, false);
@@ -1471,6 +1559,222 @@ class PlannerImpl {
     return Status::OK();
   }
 
+#if !defined(ENABLE_TRAINING)
+  // Gets the dims of a non-string tensor whose shape is fully known at planning time
+  bool GetStaticShape(const onnxruntime::NodeArg& arg, TensorShapeVector& dims) const {
+    if (!arg.Exists() || arg.TypeAsProto() == nullptr || !arg.TypeAsProto()->has_tensor_type() ||
+        arg.TypeAsProto()->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+      return false;
+    }
+    const auto* shape = context_->GetShape(arg);
+    if (shape == nullptr) {
+      return false;
+    }
+    dims.clear();
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim)) {
+        return false;
+      }
+      dims.push_back(dim.dim_value());
+    }
+    return true;
+  }
+
+  // Gets the axis a Concat or Split is applied on, if all the dims before it are 1 so that
+  // every part is a contiguous range of the concatenated tensor.
+  static bool GetContiguousAxis(const Node& node, gsl::span<const int64_t> dims, int64_t default_axis,
+                                int64_t& axis) {
+    const auto& attrs = node.GetAttributes();
+    auto attr_it = attrs.find("axis");
+    axis = attr_it != attrs.end() ? attr_it->second.i() : default_axis;
+    const auto rank = static_cast<int64_t>(dims.size());
+    if (axis < -rank || axis >= rank) {
+      return false;
+    }
+    axis = axis < 0 ? axis + rank : axis;
+    return std::all_of(dims.begin(), dims.begin() + axis, [](int64_t dim) { return dim == 1; });
+  }
+
+  // Places the inputs of Concat inside its output and the outputs of Split inside its input, so that the producers
+  // of the Concat inputs write straight into the Concat output and the Split outputs are views of the Split input.
+  // The CPU and CUDA kernels skip copying the parts that are already in place.
+  // Only statically shaped tensors whose parts are contiguous (all dims before the axis are 1) are placed.
+  Status ComputeSubBufferPlan() {
+    if (context_->IsParallelExecutionEnabled() || !context_->GetEnableMemoryReuse() || !IsSingleStream()) {
+      return Status::OK();
+    }
+
+    // stream and step of the node producing each value. -1 for graph inputs and initializers.
+    const size_t num_values = plan_.allocation_plan.size();
+    std::vector<int> value_stream(num_values, -1);
+    std::vector<int> value_step(num_values, -1);
+    for (size_t stream = 0; stream < stream_nodes_.size(); ++stream) {
+      for (size_t step = 0; step < stream_nodes_[stream].size(); ++step) {
+        for (const auto* output : graph_viewer_.GetNode(stream_nodes_[stream][step])->OutputDefs()) {
+          if (output->Exists()) {
+            value_stream[Index(output->Name())] = static_cast<int>(stream);
+            value_step[Index(output->Name())] = static_cast<int>(step);
+          }
+        }
+      }
+    }
+
+    // values reusing the buffer of each value
+    std::vector<InlinedVector<OrtValueIndex>> reusers(num_values);
+    for (OrtValueIndex value = 0; static_cast<size_t>(value) < num_values; ++value) {
+      const auto& value_plan = AllocPlan(value);
+      if ((value_plan.alloc_kind == AllocKind::kReuse || value_plan.alloc_kind == AllocKind::kShare) &&
+          value_plan.reused_buffer != value) {
+        reusers[value_plan.reused_buffer].push_back(value);
+      }
+    }
+
+    auto is_placeable = [&](OrtValueIndex value, size_t stream, size_t offset, const OrtDevice& location) {
+      const auto& value_plan = AllocPlan(value);
+      const bool own_buffer = value_plan.alloc_kind == AllocKind::kAllocate ||
+                              (value_plan.alloc_kind == AllocKind::kReuse && !value_plan.is_sub_buffer &&
+                               !ort_value_info_[value].is_inplace_reuse);
+      return own_buffer && value_stream[value] == static_cast<int>(stream) && value_plan.location == location &&
+             offset % kAllocAlignment == 0;
+    };
+    auto is_only_consumer = [&](const NodeArg& arg, const Node& node) {
+      const auto consumers = graph_viewer_.GetConsumerNodes(arg.Name());
+      return consumers.size() == 1 && consumers[0] == &node;
+    };
+    auto has_plain_producer = [&](const NodeArg& arg) {
+      // control flow nodes hand their outputs over from a subgraph
+      const Node* producer = graph_viewer_.GetProducerNode(arg.Name());
+      return producer != nullptr && !producer->ContainsSubgraph();
+    };
+    auto place = [&](OrtValueIndex value, OrtValueIndex buffer, size_t offset, const TensorShape& buffer_shape) {
+      auto& value_plan = AllocPlan(value);
+      value_plan.alloc_kind = AllocKind::kReuse;
+      value_plan.reused_buffer = buffer;
+      value_plan.is_sub_buffer = true;
+      value_plan.sub_buffer_offset = offset;
+      value_plan.reused_buffer_shape = buffer_shape;
+      Buffer(value) = buffer;
+    };
+    // The values that were planned to reuse `buffer` after `step` get a buffer of their own: the first of them
+    // is allocated, and the others reuse it.
+    auto move_reusers_to_new_buffer = [&](OrtValueIndex buffer, int step) {
+      InlinedVector<OrtValueIndex> moved;
+      for (OrtValueIndex value : reusers[buffer]) {
+        if (value_step[value] > step) {
+          moved.push_back(value);
+        }
+      }
+      if (moved.empty()) {
+        return;
+      }
+      std::sort(moved.begin(), moved.end(), [&](OrtValueIndex a, OrtValueIndex b) {
+        return value_step[a] < value_step[b];
+      });
+      AllocPlan(moved[0]).alloc_kind = AllocKind::kAllocate;
+      AllocPlan(moved[0]).reused_buffer = moved[0];
+      Buffer(moved[0]) = moved[0];
+      ort_value_info_[moved[0]].is_inplace_reuse = false;
+      for (size_t i = 1; i < moved.size(); ++i) {
+        AllocPlan(moved[i]).reused_buffer = moved[0];
+        Buffer(moved[i]) = moved[0];
+        reusers[moved[0]].push_back(moved[i]);
+      }
+      reusers[buffer].erase(std::remove_if(reusers[buffer].begin(), reusers[buffer].end(),
+                                           [&](OrtValueIndex value) { return value_step[value] > step; }),
+                            reusers[buffer].end());
+    };
+
+    TensorShapeVector dims;
+    TensorShapeVector part_dims;
+    for (size_t stream = 0; stream < stream_nodes_.size(); ++stream) {
+      for (size_t step = 0; step < stream_nodes_[stream].size(); ++step) {
+        const Node& node = *graph_viewer_.GetNode(stream_nodes_[stream][step]);
+        const bool is_concat = node.OpType() == "Concat";
+        if ((!is_concat && node.OpType() != "Split") || node.Domain() != kOnnxDomain ||
+            (node.GetExecutionProviderType() != kCpuExecutionProvider &&
+             node.GetExecutionProviderType() != kCudaExecutionProvider)) {
+          continue;
+        }
+
+        // the concatenated tensor: the output of Concat, or the input of Split
+        const NodeArg& whole_arg = is_concat ? *node.OutputDefs()[0] : *node.InputDefs()[0];
+        int64_t axis = 0;
+        if (!GetStaticShape(whole_arg, dims) || !GetContiguousAxis(node, dims, 0, axis)) {
+          continue;
+        }
+        const TensorShape whole_shape(dims);
+        const size_t element_size = GetElementSize(whole_arg.Type());
+
+        OrtValueIndex whole = Index(whole_arg.Name());
+        if (is_concat) {
+          if (AllocPlan(whole).alloc_kind != AllocKind::kAllocate) {
+            continue;
+          }
+        } else {
+          // Split outputs may be written in place by their consumers, so the input must be a buffer of its own,
+          // not read by anyone else.
+          const auto& whole_plan = AllocPlan(whole);
+#ifdef ENABLE_STRIDED_TENSORS
+          // a strided view doesn't cover contiguous ranges of the buffer it views
+          if (whole_plan.is_strided_tensor) {
+            continue;
+          }
+#endif
+          if (whole_plan.alloc_kind == AllocKind::kReuse && !whole_plan.is_sub_buffer) {
+            whole = whole_plan.reused_buffer;
+          }
+          if (AllocPlan(whole).alloc_kind != AllocKind::kAllocate || value_stream[whole] != static_cast<int>(stream) ||
+              !is_only_consumer(whole_arg, node)) {
+            continue;
+          }
+        }
+        const OrtDevice& location = AllocPlan(whole).location;
+
+        const auto& parts = is_concat ? node.InputDefs() : node.OutputDefs();
+        size_t offset = 0;
+        bool placed_any = false;
+        for (size_t i = 0; i < parts.size(); ++i) {
+          const NodeArg& part_arg = *parts[i];
+          if (!GetStaticShape(part_arg, part_dims)) {
+            break;  // the offsets of the later parts are unknown
+          }
+          const size_t part_size = SafeInt<size_t>(TensorShape(part_dims).Size()) * element_size;
+          const OrtValueIndex part = Index(part_arg.Name());
+          const bool is_repeated = std::count(parts.begin(), parts.end(), parts[i]) > 1;
+          if (part_size != 0 && !is_repeated && is_placeable(part, stream, offset, location) &&
+              (!is_concat || (is_only_consumer(part_arg, node) && has_plain_producer(part_arg)))) {
+            if (is_concat) {
+              // the Concat output holds it until the output is released, so the values planned to reuse it
+              // once Concat read it can't
+              if (AllocPlan(part).alloc_kind == AllocKind::kAllocate) {
+                move_reusers_to_new_buffer(part, -1);
+              }
+              place(part, whole, offset, whole_shape);
+            } else {
+              // the values planned to reuse a Split output's buffer get the same part of the input
+              if (AllocPlan(part).alloc_kind == AllocKind::kAllocate) {
+                for (OrtValueIndex reuser : reusers[part]) {
+                  place(reuser, whole, offset, whole_shape);
+                }
+              }
+              place(part, whole, offset, whole_shape);
+              placed_any = true;
+            }
+          }
+          offset += part_size;
+        }
+
+        // the Split input holds the outputs now, so the values planned to reuse it once Split read it can't
+        if (placed_any) {
+          move_reusers_to_new_buffer(whole, static_cast<int>(step));
+        }
+      }
+    }
+
+    return Status::OK();
+  }
+#endif  // !defined(ENABLE_TRAINING)
+
   // Should only be used after ProcessDef()
   Status ComputeSingleStreamReusePlan(size_t stream_index) {
     auto& execution_plan = stream_nodes_[stream_index];
@@ -1548,7 +1852,7 @@ class PlannerImpl {
 #ifdef ENABLE_STRIDED_TENSORS
           if (is_strided_tensor) AllocPlan(current).is_strided_tensor = true;
 #else
-          ORT_ENFORCE(!is_strided_tensor, "Strided tensor is not supported in non-training build for now.");
+          ORT_ENFORCE(!is_strided_tensor, "Strided tensor is not supported in this build.");
 #endif  // ENABLE_STRIDED_TENSORS
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
           InplaceReuse(reused, current);
@@ -1839,7 +2143,8 @@ class PlannerImpl {
     };
     plan_.node_release_list.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
     for (size_t i = 0; i < ortvalue_to_consumers_map.size(); ++i) {
-      if (!ortvalue_to_consumers_map[i].empty()) {
+      // pinned host values are released with the execution frame at the end of the run
+      if (!ortvalue_to_consumers_map[i].empty() && pinned_host_values_.count(static_cast<OrtValueIndex>(i)) == 0) {
         plan_.release_actions.push_back(SequentialExecutionPlan::ReleaseAction{i, 0});
         auto release_action_idx = plan_.release_actions.size() - 1;
         // check whether we can static determine where to release.
@@ -1918,7 +2223,9 @@ class PlannerImpl {
   void
   PartitionIntoStreams(const logging::Logger& logger, const ExecutionProviders& execution_providers,
                        const PathString& partition_config_file) {
-    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
+    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file,
+                                                                 context_->GetMaxCpuStreams(),
+                                                                 context_->GetMaxGpuStreams());
     auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, context_->GetExecutionOrder());
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
     plan_.node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
@@ -2245,6 +2552,12 @@ class PlannerImpl {
     return !utils::HasTensorType(type_proto);
   }
 
+  static bool IsTensorSequence(const onnxruntime::NodeArg& nodearg) {
+    const auto* type_proto = nodearg.TypeAsProto();
+    return type_proto != nullptr && type_proto->value_case() == ONNX_NAMESPACE::TypeProto::kSequenceType &&
+           utils::HasTensorType(type_proto->sequence_type().elem_type());
+  }
+
 #if !defined(DISABLE_OPTIONAL_TYPE)
   static bool IsOptionalType(const onnxruntime::NodeArg& nodearg) {
     const auto* type_proto = nodearg.TypeAsProto();
@@ -2303,9 +2616,17 @@ Status PlannerImpl::CreatePlan(
   ORT_RETURN_IF_ERROR(BuildExecutionPlan(execution_providers_));
 #endif
 
+  // place the CPU tensors copied to devices in pinned memory
+  ComputePinnedHostLocation();
+
   // determine sharing/reuse among ml-values
   ORT_RETURN_IF_ERROR(ComputeReusePlan());
 
+#if !defined(ENABLE_TRAINING)
+  // place the inputs of Concat and the outputs of Split inside the tensor they are copied to or from
+  ORT_RETURN_IF_ERROR(ComputeSubBufferPlan());
+#endif
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Adjust the allocate and lifetime intervals for all ml-values, based on their allocation kind.
   AdjustInplaceLifeIntervals();
@@ -2541,11 +2862,205 @@ void DeviceBasedPartitioner::SaveConfig() const {
   }
 }
 
+/*
+CriticalPathPartitioner spreads the CPU nodes of a graph over up to max_cpu_streams logic streams,
+so that independent branches of the graph run concurrently on the inter-op thread pool, and the GPU
+nodes over up to max_gpu_streams logic streams, each with its own device stream, so that independent
+branches such as MoE experts or the towers of a multi-tower model run concurrently on the device.
+
+Every node is given a cost from the number of elements of its outputs, when statically known,
+and a priority equal to the cost of the longest path from the node to the end of the graph.
+The nodes are list-scheduled in priority order: a ready node goes to the stream of its device
+where it can start earliest, preferring the stream of its last finishing producer to save a barrier,
+and a new stream is only opened when all existing streams of the device are still busy. The streams
+synchronize through the usual barriers and WaitOnEPStep steps. Nodes on other devices get one stream
+per device type, as with DeviceBasedPartitioner.
+
+All streams take their nodes from the same priority order, which is a topological order,
+so the stream holding the critical path is the first one.
+*/
+class CriticalPathPartitioner : public IGraphPartitioner {
+ public:
+  CriticalPathPartitioner(const logging::Logger& logger,
+                          size_t max_cpu_streams,
+                          size_t max_gpu_streams) : IGraphPartitioner(logger, PathString{}),
+                                                    max_cpu_streams_(max_cpu_streams),
+                                                    max_gpu_streams_(max_gpu_streams) {}
+
+  Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                        const ExecutionProviders& execution_providers,
+                        std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                        ExecutionOrder execution_order) override;
+
+  const char* Type() const override { return "CriticalPathPartitioner"; }
+  size_t Streams() const override { return num_streams_; }
+
+ private:
+  size_t MaxStreams(OrtDevice::DeviceType device_type) const {
+    if (device_type == OrtDevice::CPU) {
+      return max_cpu_streams_;
+    }
+    return device_type == OrtDevice::GPU ? max_gpu_streams_ : 1;
+  }
+
+  size_t max_cpu_streams_;
+  size_t max_gpu_streams_;
+  size_t num_streams_ = 0;
+};
+
+Status CriticalPathPartitioner::PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                                               const ExecutionProviders& execution_providers,
+                                               std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                                               ExecutionOrder execution_order) {
+  constexpr size_t kNotInGraph = std::numeric_limits<size_t>::max();
+  const auto& p_graph_nodes = graph_viewer.GetNodesInTopologicalOrder(execution_order);
+  const size_t num_node_indices = SafeInt<size_t>(graph_viewer.MaxNodeIndex()) + 1;
+
+  std::vector<size_t> topo_position(num_node_indices, kNotInGraph);
+  for (size_t i = 0; i < p_graph_nodes.size(); ++i) {
+    topo_position[p_graph_nodes[i]] = i;
+  }
+
+  // compute the cost of each node and the cost of the longest path from it to the end of the graph
+  std::vector<double> cost(num_node_indices, 0.0);
+  std::vector<double> bottom_level(num_node_indices, 0.0);
+  for (auto it = p_graph_nodes.rbegin(); it != p_graph_nodes.rend(); ++it) {
+    const auto* node = graph_viewer.GetNode(*it);
+    double node_cost = 0.0;
+    for (const auto* output : node->OutputDefs()) {
+      const auto* shape = output->Exists() ? output->Shape() : nullptr;
+      if (shape == nullptr) {
+        continue;
+      }
+      double num_elements = 1.0;
+      for (const auto& dim : shape->dim()) {
+        if (!dim.has_dim_value()) {
+          num_elements = 0.0;
+          break;
+        }
+        num_elements *= static_cast<double>(dim.dim_value());
+      }
+      node_cost += num_elements;
+    }
+    cost[*it] = std::max(node_cost, 1.0);
+
+    double successor_level = 0.0;
+    for (auto output_it = node->OutputNodesBegin(); output_it != node->OutputNodesEnd(); ++output_it) {
+      if (topo_position[output_it->Index()] != kNotInGraph) {
+        successor_level = std::max(successor_level, bottom_level[output_it->Index()]);
+      }
+    }
+    bottom_level[*it] = cost[*it] + successor_level;
+  }
+
+  std::vector<size_t> pending_inputs(num_node_indices, 0);
+  for (auto node_index : p_graph_nodes) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    for (auto input_it = node->InputNodesBegin(); input_it != node->InputNodesEnd(); ++input_it) {
+      if (topo_position[input_it->Index()] != kNotInGraph) {
+        ++pending_inputs[node_index];
+      }
+    }
+  }
+
+  auto lower_priority = [&](NodeIndex a, NodeIndex b) {
+    if (bottom_level[a] != bottom_level[b]) {
+      return bottom_level[a] < bottom_level[b];
+    }
+    return topo_position[a] > topo_position[b];
+  };
+  std::priority_queue<NodeIndex, std::vector<NodeIndex>, decltype(lower_priority)> ready_nodes(lower_priority);
+  for (auto node_index : p_graph_nodes) {
+    if (pending_inputs[node_index] == 0) {
+      ready_nodes.push(node_index);
+    }
+  }
+
+  // simulate the execution of the streams with the node costs
+  std::vector<double> finish_time(num_node_indices, 0.0);
+  std::vector<size_t> node_stream(num_node_indices, kNotInGraph);
+  std::vector<double> stream_finish_time;
+  InlinedHashMap<OrtDevice::DeviceType, InlinedVector<size_t>> device_streams;
+  size_t num_scheduled = 0;
+  stream_nodes.clear();
+
+  while (!ready_nodes.empty()) {
+    const NodeIndex node_index = ready_nodes.top();
+    ready_nodes.pop();
+    const auto* node = graph_viewer.GetNode(node_index);
+
+    double ready_time = 0.0;
+    double last_input_finish_time = -1.0;
+    size_t producer_stream = kNotInGraph;
+    for (auto input_it = node->InputNodesBegin(); input_it != node->InputNodesEnd(); ++input_it) {
+      const auto input_index = input_it->Index();
+      if (topo_position[input_index] == kNotInGraph) {
+        continue;
+      }
+      ready_time = std::max(ready_time, finish_time[input_index]);
+      if (finish_time[input_index] > last_input_finish_time) {
+        last_input_finish_time = finish_time[input_index];
+        producer_stream = node_stream[input_index];
+      }
+    }
+
+    const auto* ep = execution_providers.Get(*node);
+    ORT_RETURN_IF(ep == nullptr, "Failed to find the execution provider of node \"", node->Name(), "\"");
+    auto device_type = ep->GetOrtDeviceByMemType(OrtMemType::OrtMemTypeDefault).Type();
+
+    auto& streams = device_streams[device_type];
+    size_t stream = kNotInGraph;
+    double earliest_start_time = std::numeric_limits<double>::max();
+    for (auto candidate : streams) {
+      const double start_time = std::max(stream_finish_time[candidate], ready_time);
+      if (start_time < earliest_start_time || (start_time == earliest_start_time && candidate == producer_stream)) {
+        earliest_start_time = start_time;
+        stream = candidate;
+      }
+    }
+    if (stream == kNotInGraph || (earliest_start_time > ready_time && streams.size() < MaxStreams(device_type))) {
+      stream = stream_nodes.size();
+      stream_nodes.emplace_back();
+      stream_finish_time.push_back(0.0);
+      streams.push_back(stream);
+    }
+
+    finish_time[node_index] = std::max(stream_finish_time[stream], ready_time) + cost[node_index];
+    stream_finish_time[stream] = finish_time[node_index];
+    node_stream[node_index] = stream;
+    stream_nodes[stream].push_back(node_index);
+    ++num_scheduled;
+
+    for (auto output_it = node->OutputNodesBegin(); output_it != node->OutputNodesEnd(); ++output_it) {
+      const auto output_index = output_it->Index();
+      if (topo_position[output_index] != kNotInGraph && --pending_inputs[output_index] == 0) {
+        ready_nodes.push(output_index);
+      }
+    }
+  }
+
+  ORT_RETURN_IF_NOT(num_scheduled == p_graph_nodes.size(), "Failed to schedule all nodes of the graph, scheduled ",
+                    num_scheduled, " of ", p_graph_nodes.size());
+  num_streams_ = stream_nodes.size();
+  const auto cpu_streams = device_streams.find(OrtDevice::CPU);
+  const auto gpu_streams = device_streams.find(OrtDevice::GPU);
+  LOGS(logger_, VERBOSE) << "CriticalPathPartitioner placed " << p_graph_nodes.size() << " nodes in "
+                         << num_streams_ << " streams, "
+                         << (cpu_streams == device_streams.end() ? 0 : cpu_streams->second.size()) << " of them on CPU and "
+                         << (gpu_streams == device_streams.end() ? 0 : gpu_streams->second.size()) << " on GPU";
+  return Status::OK();
+}
+
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
-                                                                             const PathString& config_file) {
-  // use device based partitioner by default
+                                                                             const PathString& config_file,
+                                                                             size_t max_cpu_streams,
+                                                                             size_t max_gpu_streams) {
+  // use device based partitioner by default, or critical path partitioner when several CPU or GPU streams are allowed
   IGraphPartitioner::GraphPartitioningStrategy partitioner_type =
       IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
+  if (config_file.empty() && (max_cpu_streams > 1 || max_gpu_streams > 1)) {
+    partitioner_type = IGraphPartitioner::GraphPartitioningStrategy::CriticalPathPartition;
+  }
   if (!config_file.empty()) {
     std::ifstream f(config_file);
     if (f.is_open()) {
@@ -2566,6 +3081,11 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
   if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition) {
     LOGS(logger, INFO) << "Use DeviceBasedPartition as default";
     return std::make_unique<DeviceBasedPartitioner>(logger, config_file);
+  } else if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::CriticalPathPartition) {
+    LOGS(logger, INFO) << "Use CriticalPathPartition with up to " << max_cpu_streams << " CPU streams and "
+                       << max_gpu_streams << " GPU streams";
+    return std::make_unique<CriticalPathPartitioner>(logger, std::max<size_t>(max_cpu_streams, 1),
+                                                     std::max<size_t>(max_gpu_streams, 1));
   }  // else if other partitioner types ...
   ORT_THROW("Failed to create partitioner");
 }
@@ -46,15 +46,25 @@ class ISequentialPlannerContext {
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // Maximum number of logic streams the CPU nodes may be spread over.
+  // More than one lets independent branches of the graph run concurrently.
+  virtual size_t GetMaxCpuStreams() const { return 1; }
+
+  // Maximum number of logic streams the GPU nodes may be spread over, each of them with its own device stream.
+  virtual size_t GetMaxGpuStreams() const { return 1; }
   virtual ~ISequentialPlannerContext() = default;
 };
 
 class SequentialPlannerContext : public ISequentialPlannerContext {
  public:
-  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse)
+  SequentialPlannerContext(ExecutionMode execution_mode, ExecutionOrder execution_order, bool enable_memory_reuse,
+                           size_t max_cpu_streams = 1, size_t max_gpu_streams = 1)
       : execution_mode_(execution_mode),
         execution_order_(execution_order),
-        enable_memory_reuse_(enable_memory_reuse) {
+        enable_memory_reuse_(enable_memory_reuse),
+        max_cpu_streams_(max_cpu_streams),
+        max_gpu_streams_(max_gpu_streams) {
   }
 
   const ONNX_NAMESPACE::TensorShapeProto* GetShape(const onnxruntime::NodeArg& arg) const override {
@@ -67,10 +77,16 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  size_t GetMaxCpuStreams() const override { return max_cpu_streams_; }
+
+  size_t GetMaxGpuStreams() const override { return max_gpu_streams_; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder execution_order_ = ExecutionOrder::DEFAULT;
   bool enable_memory_reuse_ = true;
+  size_t max_cpu_streams_ = 1;
+  size_t max_gpu_streams_ = 1;
 };
 
 #ifdef ORT_ENABLE_STREAM
@@ -82,16 +98,22 @@ class IGraphPartitioner {
   // DeviceBasedPartitioner is the default, who partitions a graph based off device information.
   // i.e., given a graph which has CPU EP nodes, Cuda EP nodes and TRT EP nodes,
   // it will be partitioned as two sequences, one is for CPU EP nodes, another is for TRT and Cuda nodes.
-  // We will add more optimized partitioner later.
+  // CriticalPathPartitioner spreads the CPU nodes over up to max_cpu_streams streams and the GPU nodes over up to
+  // max_gpu_streams streams, so that independent branches run concurrently, with the longest path through the graph
+  // scheduled first.
   enum GraphPartitioningStrategy {
     DeviceBasedPartition = 0,
+    CriticalPathPartition,
     Unknown,
   };
   virtual ~IGraphPartitioner() = default;
   // create the partition based on the partition type.
   // perform partition based on the user input when provided.
+  // without user input, max_cpu_streams > 1 or max_gpu_streams > 1 selects the CriticalPathPartitioner.
   static std::unique_ptr<IGraphPartitioner> CreateGraphPartitioner(const logging::Logger& logger,
-                                                                   const PathString& config_file);
+                                                                   const PathString& config_file,
+                                                                   size_t max_cpu_streams = 1,
+                                                                   size_t max_gpu_streams = 1);
   virtual Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                                 const ExecutionProviders& execution_providers,
                                 std::vector<InlinedVector<NodeIndex>>& stream_nodes,
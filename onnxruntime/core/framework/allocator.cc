@@ -124,6 +124,11 @@ void* AllocateBufferWithOptions(IAllocator& alloc, size_t size, bool use_reserve
     ORT_UNUSED_PARAMETER(wait_fn);
 #endif  // ORT_ENABLE_STREAM
   }
+#ifdef ORT_ENABLE_STREAM
+  if (stream && alloc.IsStreamAware()) {
+    return alloc.AllocWithStream(size, stream);
+  }
+#endif  // ORT_ENABLE_STREAM
   return alloc.Alloc(size);
 }
 }  // namespace onnxruntime
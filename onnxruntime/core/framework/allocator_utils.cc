@@ -32,6 +32,15 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
     int64_t max_power_of_two_extend_bytes = info.arena_cfg.max_power_of_two_extend_bytes == -1
                                                 ? BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES
                                                 : info.arena_cfg.max_power_of_two_extend_bytes;
+    int64_t thread_cache_bytes = info.arena_cfg.thread_cache_bytes == -1
+                                     ? BFCArena::DEFAULT_THREAD_CACHE_BYTES
+                                     : info.arena_cfg.thread_cache_bytes;
+    int thread_cache_max_chunk_bytes = info.arena_cfg.thread_cache_max_chunk_bytes == -1
+                                           ? BFCArena::DEFAULT_THREAD_CACHE_MAX_CHUNK_BYTES
+                                           : info.arena_cfg.thread_cache_max_chunk_bytes;
+    int64_t trim_window_ms = info.arena_cfg.trim_window_ms == -1
+                                 ? BFCArena::DEFAULT_TRIM_WINDOW_MS
+                                 : info.arena_cfg.trim_window_ms;
     ArenaExtendStrategy arena_extend_str;
     switch (info.arena_cfg.arena_extend_strategy) {
       case static_cast<int>(ArenaExtendStrategy::kSameAsRequested):
@@ -56,7 +65,11 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                              arena_extend_str,
                                              initial_chunk_size_bytes,
                                              max_dead_bytes_per_chunk,
-                                             initial_growth_chunk_size_bytes));
+                                             initial_growth_chunk_size_bytes,
+                                             max_power_of_two_extend_bytes,
+                                             thread_cache_bytes,
+                                             thread_cache_max_chunk_bytes,
+                                             trim_window_ms));
 #else
       ORT_THROW("StreamAwareArena should be transparent to minimal build.");
 #endif
@@ -68,7 +81,10 @@ AllocatorPtr CreateAllocator(const AllocatorCreationInfo& info) {
                                      initial_chunk_size_bytes,
                                      max_dead_bytes_per_chunk,
                                      initial_growth_chunk_size_bytes,
-                                     max_power_of_two_extend_bytes));
+                                     max_power_of_two_extend_bytes,
+                                     thread_cache_bytes,
+                                     thread_cache_max_chunk_bytes,
+                                     trim_window_ms));
     }
   } else {
     return device_allocator;
@@ -3,16 +3,247 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <chrono>
+#include <thread>
 #include <type_traits>
+#include <unordered_map>
 
 namespace onnxruntime {
+
+// Per-thread (or per-stream) size-class cache in front of the bins.
+//
+// Chunks handed out by the cache stay 'in use' from the arena's point of view. A freed chunk is kept in the
+// cache of the thread that freed it (or of the stream it was allocated on) and is only handed back to the same
+// stream, so no cross-stream synchronization is ever needed for a cache hit. When a cache grows beyond its
+// budget the oldest half of its chunks is returned to the bins, taking the arena lock once for the whole batch.
+//
+// Caches are sharded by thread id / stream, and the bookkeeping of which chunks are owned by the cache is
+// sharded by address, so the arena lock is only taken on cache misses and batch flushes.
+class BFCArena::ThreadCache {
+ public:
+  ThreadCache(BFCArena& arena, size_t cache_bytes, size_t max_chunk_bytes)
+      : arena_(arena),
+        cache_bytes_(cache_bytes),
+        max_chunk_bytes_(SizeOfClass(SizeClassForRounded(
+            arena.RoundedBytes(std::max(max_chunk_bytes, size_t{kMinAllocationSize}))))),
+        num_size_classes_(SizeClassForRounded(max_chunk_bytes_) + 1) {}
+
+  // Returns the size class for an allocation of `rounded_bytes`, or -1 if the cache doesn't serve that size.
+  int SizeClassFor(size_t rounded_bytes) const {
+    return rounded_bytes <= max_chunk_bytes_ ? SizeClassForRounded(rounded_bytes) : -1;
+  }
+
+  // Size classes have four steps per power of two above 1KB so that at most 25% of a chunk is padding.
+  static size_t SizeOfClass(int size_class) {
+    if (size_class < 4) {
+      return static_cast<size_t>(size_class + 1) * kMinAllocationSize;
+    }
+
+    const int lg = size_class / 4 + 9;
+    const size_t step = size_t{1} << (lg - 2);
+    return static_cast<size_t>(size_class % 4 + 5) * step;
+  }
+
+  // Returns a cached chunk of `size_class` previously used on `stream`, or nullptr on a miss.
+  void* Pop(int size_class, Stream* stream) {
+    Shard& shard = ShardFor(stream);
+    void* p = nullptr;
+    {
+      std::lock_guard<OrtMutex> lock(shard.mutex);
+      auto* lists = shard.FindLists(stream);
+      if (lists == nullptr || (*lists)[size_class].empty()) {
+        return nullptr;
+      }
+
+      p = (*lists)[size_class].back();
+      (*lists)[size_class].pop_back();
+      shard.cached_bytes -= SizeOfClass(size_class);
+    }
+
+    Track(p, size_class, stream);
+    return p;
+  }
+
+  // Records that `p` was allocated through the cache so that Free() returns it to the cache.
+  void Track(void* p, int size_class, Stream* stream) {
+    OwnerShard& owners = OwnerShardFor(p);
+    std::lock_guard<OrtMutex> lock(owners.mutex);
+    owners.chunks[p] = {size_class, stream};
+  }
+
+  // Returns false if `p` was not allocated through the cache.
+  bool Push(void* p) {
+    CachedChunkInfo info;
+    {
+      OwnerShard& owners = OwnerShardFor(p);
+      std::lock_guard<OrtMutex> lock(owners.mutex);
+      auto it = owners.chunks.find(p);
+      if (it == owners.chunks.end()) {
+        return false;
+      }
+
+      info = it->second;
+      owners.chunks.erase(it);
+    }
+
+    std::vector<void*> to_release;
+    {
+      Shard& shard = ShardFor(info.stream);
+      std::lock_guard<OrtMutex> lock(shard.mutex);
+      shard.GetOrCreateLists(info.stream, num_size_classes_)[info.size_class].push_back(p);
+      shard.cached_bytes += SizeOfClass(info.size_class);
+      if (shard.cached_bytes > cache_bytes_) {
+        // release the oldest half of each list back to the bins
+        for (auto& entry : shard.free_lists) {
+          for (size_t c = 0; c < entry.second.size(); ++c) {
+            auto& list = entry.second[c];
+            const size_t num_to_release = (list.size() + 1) / 2;
+            to_release.insert(to_release.end(), list.begin(), list.begin() + num_to_release);
+            list.erase(list.begin(), list.begin() + num_to_release);
+            shard.cached_bytes -= num_to_release * SizeOfClass(static_cast<int>(c));
+          }
+        }
+      }
+    }
+
+    if (!to_release.empty()) {
+      arena_.DeallocateRawBatch(to_release);
+    }
+
+    return true;
+  }
+
+  // Returns all cached chunks to the bins. Returns the number of chunks released.
+  size_t ReleaseAll() {
+    return ReleaseIf([](Stream*) { return true; });
+  }
+
+#ifdef ORT_ENABLE_STREAM
+  // Returns the chunks cached for `stream` to the bins and stops associating outstanding chunks with it,
+  // as the arena resets the stream of all its chunks when the stream's buffers are released.
+  void ReleaseStream(Stream* stream) {
+    ReleaseIf([stream](Stream* s) { return s == stream; });
+    for (auto& owners : owner_shards_) {
+      std::lock_guard<OrtMutex> lock(owners.mutex);
+      for (auto& entry : owners.chunks) {
+        if (entry.second.stream == stream) {
+          entry.second.stream = nullptr;
+        }
+      }
+    }
+  }
+#endif
+
+ private:
+  static constexpr size_t kNumShards = 32;
+
+  using SizeClassLists = std::vector<std::vector<void*>>;
+
+  struct Shard {
+    OrtMutex mutex;
+    // free chunks keyed by the stream they were allocated on. there is usually a single entry per shard.
+    std::vector<std::pair<Stream*, SizeClassLists>> free_lists;
+    size_t cached_bytes = 0;
+
+    SizeClassLists* FindLists(Stream* stream) {
+      for (auto& entry : free_lists) {
+        if (entry.first == stream) {
+          return &entry.second;
+        }
+      }
+      return nullptr;
+    }
+
+    SizeClassLists& GetOrCreateLists(Stream* stream, int num_size_classes) {
+      auto* lists = FindLists(stream);
+      if (lists == nullptr) {
+        free_lists.emplace_back(stream, SizeClassLists(num_size_classes));
+        lists = &free_lists.back().second;
+      }
+      return *lists;
+    }
+  };
+
+  struct CachedChunkInfo {
+    int size_class = -1;
+    Stream* stream = nullptr;
+  };
+
+  struct OwnerShard {
+    OrtMutex mutex;
+    std::unordered_map<void*, CachedChunkInfo> chunks;
+  };
+
+  static int SizeClassForRounded(size_t rounded_bytes) {
+    if (rounded_bytes <= 4 * kMinAllocationSize) {
+      return static_cast<int>(rounded_bytes / kMinAllocationSize) - 1;
+    }
+
+    int lg = 0;
+    for (size_t v = rounded_bytes - 1; v > 1; v >>= 1) {
+      ++lg;
+    }
+
+    const size_t step = size_t{1} << (lg - 2);
+    const size_t steps = (rounded_bytes + step - 1) / step;
+    return 4 * (lg - 9) + static_cast<int>(steps) - 5;
+  }
+
+  Shard& ShardFor(Stream* stream) {
+    // chunks without a stream are cached per thread, everything else per stream
+    const size_t hash = stream == nullptr ? std::hash<std::thread::id>{}(std::this_thread::get_id())
+                                          : std::hash<Stream*>{}(stream);
+    return shards_[hash % kNumShards];
+  }
+
+  OwnerShard& OwnerShardFor(const void* p) {
+    return owner_shards_[(reinterpret_cast<std::uintptr_t>(p) >> kMinAllocationBits) % kNumShards];
+  }
+
+  template <typename Pred>
+  size_t ReleaseIf(Pred pred) {
+    std::vector<void*> to_release;
+    for (auto& shard : shards_) {
+      std::lock_guard<OrtMutex> lock(shard.mutex);
+      for (auto& entry : shard.free_lists) {
+        if (!pred(entry.first)) {
+          continue;
+        }
+
+        for (size_t c = 0; c < entry.second.size(); ++c) {
+          auto& list = entry.second[c];
+          to_release.insert(to_release.end(), list.begin(), list.end());
+          shard.cached_bytes -= list.size() * SizeOfClass(static_cast<int>(c));
+          list.clear();
+        }
+      }
+    }
+
+    if (!to_release.empty()) {
+      arena_.DeallocateRawBatch(to_release);
+    }
+
+    return to_release.size();
+  }
+
+  BFCArena& arena_;
+  const size_t cache_bytes_;
+  const size_t max_chunk_bytes_;
+  const int num_size_classes_;
+  std::array<Shard, kNumShards> shards_;
+  std::array<OwnerShard, kNumShards> owner_shards_;
+};
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
                    int initial_growth_chunk_size_bytes,
-                   int64_t max_power_of_two_extend_bytes)
+                   int64_t max_power_of_two_extend_bytes,
+                   int64_t thread_cache_bytes,
+                   int thread_cache_max_chunk_bytes,
+                   int64_t trim_window_ms)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -25,14 +256,18 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
       initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
-      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes) {
+      max_power_of_two_extend_bytes_(max_power_of_two_extend_bytes),
+      trim_window_ms_(trim_window_ms) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " max_power_of_two_extend_bytes: " << max_power_of_two_extend_bytes_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy)
+                     << " thread_cache_bytes: " << thread_cache_bytes
+                     << " thread_cache_max_chunk_bytes: " << thread_cache_max_chunk_bytes
+                     << " trim_window_ms: " << trim_window_ms;
 
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
@@ -75,9 +310,17 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_bytes > 0 && thread_cache_max_chunk_bytes > 0) {
+    thread_cache_ = std::make_unique<ThreadCache>(*this, static_cast<size_t>(thread_cache_bytes),
+                                                  static_cast<size_t>(thread_cache_max_chunk_bytes));
+  }
 }
 
 BFCArena::~BFCArena() {
+  // chunks held by the thread cache live in the regions freed below
+  thread_cache_.reset();
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -289,6 +532,7 @@ void* BFCArena::Reserve(size_t size) {
   stats_.max_alloc_size = std::max<size_t>(static_cast<size_t>(stats_.max_alloc_size), size);
   stats_.max_bytes_in_use = std::max<int64_t>(static_cast<int64_t>(stats_.max_bytes_in_use), stats_.bytes_in_use);
   stats_.total_allocated_bytes += size;
+  UpdateWorkingSet();
   return ptr;
 }
 
@@ -322,6 +566,53 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
   // so all memory addresses are nicely byte aligned.
   size_t rounded_bytes = RoundedBytes(num_bytes);
 
+  int size_class = -1;
+  if (thread_cache_ != nullptr) {
+    size_class = thread_cache_->SizeClassFor(rounded_bytes);
+    if (size_class != -1) {
+      void* cached = thread_cache_->Pop(size_class, stream);
+      if (cached != nullptr) {
+        return cached;
+      }
+
+      // allocate the full size class so the chunk can be reused by any request of the class
+      rounded_bytes = ThreadCache::SizeOfClass(size_class);
+      num_bytes = rounded_bytes;
+    }
+  }
+
+  Status status;
+  void* ptr = AllocateFromBins(rounded_bytes, num_bytes, false, stream, enable_cross_stream_reusing, wait_fn, status);
+
+  // chunks held by the thread cache may be all that is missing to satisfy the request
+  if (ptr == nullptr && thread_cache_ != nullptr && thread_cache_->ReleaseAll() > 0) {
+    ptr = AllocateFromBins(rounded_bytes, num_bytes, dump_log_on_failure, stream, enable_cross_stream_reusing,
+                           wait_fn, status);
+  } else if (ptr == nullptr && dump_log_on_failure) {
+    std::lock_guard<OrtMutex> lock(lock_);
+    LOGS_DEFAULT(ERROR) << "BFC Arena ran out of memory trying to allocate " << num_bytes
+                        << ".  Current allocation summary follows.";
+    DumpMemoryLog(rounded_bytes);
+  }
+
+  if (ptr == nullptr) {
+    ORT_THROW(status.ErrorMessage());
+  }
+
+  if (size_class != -1) {
+    thread_cache_->Track(ptr, size_class, stream);
+  }
+
+  return ptr;
+}
+
+void* BFCArena::AllocateFromBins(size_t rounded_bytes,
+                                 size_t num_bytes,
+                                 bool dump_log_on_failure,
+                                 Stream* stream,
+                                 bool enable_cross_stream_reusing,
+                                 WaitNotificationFn wait_fn,
+                                 Status& status) {
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
@@ -348,7 +639,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
                      << ". bin_num:" << bin_num << " (requested) num_bytes: " << num_bytes << " (actual) rounded_bytes:" << rounded_bytes;
 
   // Try to extend
-  auto status = Extend(rounded_bytes);
+  status = Extend(rounded_bytes);
   if (status.IsOK()) {
     chunk = FindChunkPtr(bin_num, rounded_bytes, num_bytes, stream, false);
     if (chunk != nullptr) {
@@ -373,7 +664,7 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
     DumpMemoryLog(rounded_bytes);
   }
 
-  ORT_THROW(status.ErrorMessage());
+  return nullptr;
 }
 
 void BFCArena::GetStats(AllocatorStats* stats) {
@@ -410,6 +701,7 @@ BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* fr
       std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
   stats_.max_alloc_size =
       std::max<int64_t>(stats_.max_alloc_size, static_cast<int64_t>(chunk->size));
+  UpdateWorkingSet();
   return chunk;
 }
 
@@ -496,6 +788,11 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_ != nullptr && thread_cache_->Push(p)) {
+    return;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -506,9 +803,16 @@ void BFCArena::Free(void* p) {
   } else {
     DeallocateRawInternal(p);
   }
+
+  MaybeTrimToWorkingSet();
 }
 
 Status BFCArena::Shrink() {
+  // cached chunks are unused, so give them back to the bins first to let their regions be freed
+  if (thread_cache_ != nullptr) {
+    thread_cache_->ReleaseAll();
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
@@ -525,54 +829,141 @@ Status BFCArena::Shrink() {
 
   size_t i = 0;
   for (void* region_ptr : region_ptrs) {
-    bool deallocate_region = true;
-    ChunkHandle region_begin_chunk = region_manager_.get_handle(region_ptr);
-    ChunkHandle h = region_begin_chunk;
-    while (h != kInvalidChunkHandle) {
-      const Chunk* c = ChunkFromHandle(h);
-      if (c->in_use()) {
-        // at-least one used chunk found in the allocation region -
-        // so we cannot deallocate it
-        deallocate_region = false;
-        break;
-      }
-      h = c->next;
+    if (IsRegionUnused(region_ptr)) {
+      DeallocateRegion(region_ptr, region_sizes[i]);
     }
 
-    if (deallocate_region) {
-      auto shrink_size = region_sizes[i];
-      stats_.num_arena_shrinkages += 1;
-      stats_.total_allocated_bytes -= shrink_size;
+    ++i;
+  }
 
-      LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
-                            << shrink_size << " bytes. "
-                            << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
+  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
+  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
 
-      h = region_begin_chunk;
-      ChunkHandle temp = region_begin_chunk;
-      while (h != kInvalidChunkHandle) {
-        const Chunk* c = ChunkFromHandle(h);
-        temp = c->next;
-        RemoveFreeChunkFromBin(h);
-        DeleteChunk(h);
-        h = temp;
-      }
+  return Status::OK();
+}
 
-      device_allocator_->Free(region_ptr);
-      region_manager_.RemoveAllocationRegion(region_ptr);
-      stats_.num_arena_extensions--;
+bool BFCArena::IsRegionUnused(void* region_ptr) {
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    if (c->in_use()) {
+      // at-least one used chunk found in the allocation region -
+      // so we cannot deallocate it
+      return false;
     }
+    h = c->next;
+  }
 
-    ++i;
+  return true;
+}
+
+void BFCArena::DeallocateRegion(void* region_ptr, size_t region_size) {
+  stats_.num_arena_shrinkages += 1;
+  stats_.total_allocated_bytes -= region_size;
+
+  LOGS_DEFAULT(VERBOSE) << device_allocator_->Info().name << " BFC Arena shrunk by "
+                        << region_size << " bytes. "
+                        << " The total allocated bytes is now " << stats_.total_allocated_bytes;
+
+  ChunkHandle h = region_manager_.get_handle(region_ptr);
+  while (h != kInvalidChunkHandle) {
+    const Chunk* c = ChunkFromHandle(h);
+    ChunkHandle next = c->next;
+    RemoveFreeChunkFromBin(h);
+    DeleteChunk(h);
+    h = next;
   }
 
-  // Will affect how the arena grows if the arena extend strategy is kNextPowerOfTwo
-  // In case the extend strategy is kSameAsRequested, the arena growth is exactly the size of the memory request itself
-  curr_region_allocation_bytes_ = initial_growth_chunk_size_bytes_;
+  device_allocator_->Free(region_ptr);
+  region_manager_.RemoveAllocationRegion(region_ptr);
+  stats_.num_arena_extensions--;
+}
+
+Status BFCArena::TrimToWorkingSet() {
+  // cached chunks are not part of the working set
+  if (thread_cache_ != nullptr) {
+    thread_cache_->ReleaseAll();
+  }
 
+  std::lock_guard<OrtMutex> lock(lock_);
+  TrimToWorkingSetLocked();
   return Status::OK();
 }
 
+void BFCArena::UpdateWorkingSet() {
+  if (trim_window_ms_ <= 0) {
+    return;
+  }
+
+  const int64_t interval_ms = std::max<int64_t>(1, trim_window_ms_ / kNumTrimIntervals);
+  const int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now().time_since_epoch())
+                             .count();
+  const int64_t interval = now_ms / interval_ms;
+
+  if (interval != current_trim_interval_) {
+    // intervals that passed without any activity had nothing more in use than what is in use now
+    const int64_t num_expired = current_trim_interval_ == -1
+                                    ? kNumTrimIntervals
+                                    : std::min<int64_t>(interval - current_trim_interval_, kNumTrimIntervals);
+    for (int64_t i = 1; i <= num_expired; ++i) {
+      interval_peak_bytes_in_use_[static_cast<size_t>((current_trim_interval_ + i) % kNumTrimIntervals)] =
+          stats_.bytes_in_use;
+    }
+    current_trim_interval_ = interval;
+  }
+
+  int64_t& peak = interval_peak_bytes_in_use_[static_cast<size_t>(interval % kNumTrimIntervals)];
+  peak = std::max(peak, stats_.bytes_in_use);
+}
+
+void BFCArena::MaybeTrimToWorkingSet() {
+  if (trim_window_ms_ <= 0) {
+    return;
+  }
+
+  UpdateWorkingSet();
+  if (current_trim_interval_ != last_trimmed_interval_) {
+    last_trimmed_interval_ = current_trim_interval_;
+    TrimToWorkingSetLocked();
+  }
+}
+
+void BFCArena::TrimToWorkingSetLocked() {
+  UpdateWorkingSet();
+
+  int64_t working_set = stats_.bytes_in_use;
+  if (trim_window_ms_ > 0) {
+    for (int64_t peak : interval_peak_bytes_in_use_) {
+      working_set = std::max(working_set, peak);
+    }
+  }
+
+  // reserved chunks are not part of the regions
+  int64_t reserved_bytes = 0;
+  for (const auto& reserved_chunk : reserved_chunks_) {
+    reserved_bytes += static_cast<int64_t>(reserved_chunk.second);
+  }
+
+  std::vector<std::pair<size_t, void*>> unused_regions;
+  for (const auto& region : region_manager_.regions()) {
+    if ((consider_first_allocation_region_for_shrinkage_ || region.id() != 0) && IsRegionUnused(region.ptr())) {
+      unused_regions.emplace_back(region.memory_size(), region.ptr());
+    }
+  }
+
+  // release the largest regions first to reach the working set with as few device frees as possible
+  std::sort(unused_regions.begin(), unused_regions.end(), std::greater<>());
+  for (const auto& region : unused_regions) {
+    if (stats_.total_allocated_bytes - reserved_bytes - static_cast<int64_t>(region.first) < working_set) {
+      continue;
+    }
+
+    DeallocateRegion(region.second, region.first);
+  }
+}
+
 void BFCArena::DeallocateRawInternal(void* ptr) {
   // Find the chunk from the ptr.
   BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
@@ -582,6 +973,15 @@ void BFCArena::DeallocateRawInternal(void* ptr) {
   FreeAndMaybeCoalesce(h);
 }
 
+void BFCArena::DeallocateRawBatch(const std::vector<void*>& ptrs) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (void* ptr : ptrs) {
+    DeallocateRawInternal(ptr);
+  }
+
+  MaybeTrimToWorkingSet();
+}
+
 // Merges h1 and h2 when Chunk(h1)->next is h2 and Chunk(h2)->prev is c1.
 // We merge Chunk(h2) into Chunk(h1).
 void BFCArena::Merge(BFCArena::ChunkHandle h1,
@@ -856,14 +1256,20 @@ StreamAwareArena::StreamAwareArena(std::unique_ptr<IAllocator> resource_allocato
                                    int initial_chunk_size_bytes,
                                    int max_dead_bytes_per_chunk,
                                    int initial_growth_chunk_size_bytes,
-                                   int64_t max_power_of_two_extend_bytes) : BFCArena(std::move(resource_allocator),
-                                                                                     total_memory,
-                                                                                     arena_extend_strategy,
-                                                                                     initial_chunk_size_bytes,
-                                                                                     max_dead_bytes_per_chunk,
-                                                                                     initial_growth_chunk_size_bytes,
-                                                                                     max_power_of_two_extend_bytes),
-                                                                            enable_cross_stream_reusing_(enable_cross_stream_sharing) {
+                                   int64_t max_power_of_two_extend_bytes,
+                                   int64_t thread_cache_bytes,
+                                   int thread_cache_max_chunk_bytes,
+                                   int64_t trim_window_ms) : BFCArena(std::move(resource_allocator),
+                                                                                total_memory,
+                                                                                arena_extend_strategy,
+                                                                                initial_chunk_size_bytes,
+                                                                                max_dead_bytes_per_chunk,
+                                                                                initial_growth_chunk_size_bytes,
+                                                                                max_power_of_two_extend_bytes,
+                                                                                thread_cache_bytes,
+                                                                                thread_cache_max_chunk_bytes,
+                                                                                trim_window_ms),
+                                                                       enable_cross_stream_reusing_(enable_cross_stream_sharing) {
   arena_type_ = ArenaType::StreamAwareArena;
 }
 
@@ -872,6 +1278,11 @@ void* StreamAwareArena::AllocOnStream(size_t size, Stream* current_stream, WaitN
 }
 
 void StreamAwareArena::ReleaseStreamBuffers(Stream* stream) {
+  // chunks cached for the stream must go back to the bins before their stream is reset
+  if (thread_cache_ != nullptr) {
+    thread_cache_->ReleaseStream(stream);
+  }
+
   // since chunks on target stream will be reset to nullptr, trigger coalesce to see whether we can get bigger chunk.
   ResetChunkOnTargetStream(stream, true);
 }
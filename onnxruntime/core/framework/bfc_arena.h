@@ -61,6 +61,9 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const int64_t DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES = 1024 * 1024 * 1024;  // 1GB
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int64_t DEFAULT_THREAD_CACHE_BYTES = 0;  // thread cache disabled
+  static const int DEFAULT_THREAD_CACHE_MAX_CHUNK_BYTES = 256 * 1024;
+  static const int64_t DEFAULT_TRIM_WINDOW_MS = 0;  // trimming disabled
 
   enum ArenaType {
     BaseArena,
@@ -73,7 +76,10 @@ class BFCArena : public IAllocator {
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
            int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+           int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+           int64_t thread_cache_bytes = DEFAULT_THREAD_CACHE_BYTES,
+           int thread_cache_max_chunk_bytes = DEFAULT_THREAD_CACHE_MAX_CHUNK_BYTES,
+           int64_t trim_window_ms = DEFAULT_TRIM_WINDOW_MS);
 
   ~BFCArena() override;
 
@@ -93,8 +99,17 @@ class BFCArena : public IAllocator {
   // and the allocation request.
   Status Shrink();
 
+  // Frees allocation regions in which no chunk is in use, but only while the memory allocated by the arena stays
+  // above its working set: the high-water mark of bytes in use over the last `trim_window_ms`, or the current
+  // bytes in use if no window is configured.
+  // Unlike Shrink() the growth size of the arena is left untouched.
+  // If trim_window_ms is set this is also done automatically, at most once per 1/8th of the window, when memory
+  // is freed.
+  Status TrimToWorkingSet();
+
   void* Reserve(size_t size) override;
 
+  // Stats count chunks held by the thread cache as in use, as they are not available to the bins.
   void GetStats(AllocatorStats* stats) override;
 
   size_t RequestedSize(const void* ptr);
@@ -120,9 +135,41 @@ class BFCArena : public IAllocator {
 #endif
   ArenaType arena_type_;
 
+  // Optional front-end that serves small and medium chunks without taking lock_.
+  // Defined in bfc_arena.cc. nullptr if the thread cache is disabled.
+  class ThreadCache;
+  std::unique_ptr<ThreadCache> thread_cache_;
+
  private:
   void DeallocateRawInternal(void* ptr);
 
+  // Returns the chunks in `ptrs` to the bins, taking lock_ once for the whole batch.
+  void DeallocateRawBatch(const std::vector<void*>& ptrs);
+
+  // Returns true if no chunk of the allocation region starting at `region_ptr` is in use.
+  bool IsRegionUnused(void* region_ptr);
+
+  // Returns the allocation region starting at `region_ptr`, which must be unused, to the device allocator.
+  void DeallocateRegion(void* region_ptr, size_t region_size);
+
+  // Records the current bytes in use in the working set window. Requires lock_.
+  void UpdateWorkingSet();
+
+  // Trims down to the working set if the current trim interval hasn't been trimmed yet. Requires lock_.
+  void MaybeTrimToWorkingSet();
+
+  void TrimToWorkingSetLocked();
+
+  // Searches the bins (extending the arena if needed) for a chunk of `rounded_bytes`.
+  // Returns nullptr and sets `status` on failure.
+  void* AllocateFromBins(size_t rounded_bytes,
+                         size_t num_bytes,
+                         bool dump_log_on_failure,
+                         Stream* stream,
+                         bool enable_cross_stream_reusing,
+                         WaitNotificationFn wait_fn,
+                         Status& status);
+
   // A ChunkHandle is an index into the chunks_ vector in BFCAllocator
   // kInvalidChunkHandle means an invalid chunk
   using ChunkHandle = size_t;
@@ -514,6 +561,14 @@ class BFCArena : public IAllocator {
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  // Working set tracking for TrimToWorkingSet(). The window is split into kNumTrimIntervals intervals and
+  // the peak bytes in use is kept for each, so the working set is the max over all of them.
+  static constexpr int kNumTrimIntervals = 8;
+  const int64_t trim_window_ms_;
+  std::array<int64_t, kNumTrimIntervals> interval_peak_bytes_in_use_{};
+  int64_t current_trim_interval_ = -1;
+  int64_t last_trimmed_interval_ = -1;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef ORT_ENABLE_STREAM
@@ -526,7 +581,10 @@ class StreamAwareArena : public BFCArena {
                    int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
                    int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
                    int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
-                   int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES);
+                   int64_t max_power_of_two_extend_bytes = DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+                   int64_t thread_cache_bytes = DEFAULT_THREAD_CACHE_BYTES,
+                   int thread_cache_max_chunk_bytes = DEFAULT_THREAD_CACHE_MAX_CHUNK_BYTES,
+                   int64_t trim_window_ms = DEFAULT_TRIM_WINDOW_MS);
 
   // If size is 0, then this function returns either NULL,
   // or a unique pointer value that can later be successfully
@@ -6,6 +6,9 @@
 namespace onnxruntime {
 
 TensorShapeVector StridesForTensor(const Tensor& tensor) {
+#ifdef ENABLE_STRIDED_TENSORS
+  return ToShapeVector(tensor.Strides());
+#else
   const auto& shape = tensor.Shape();
   TensorShapeVector strides(shape.NumDimensions());
   int64_t running_size = 1;
@@ -15,6 +18,7 @@ TensorShapeVector StridesForTensor(const Tensor& tensor) {
   }
 
   return strides;
+#endif
 }
 
 namespace {
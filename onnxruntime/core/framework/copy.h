@@ -310,4 +310,31 @@ Status DispatchStridedCopy(concurrency::ThreadPool* thread_pool,
                     : Status::OK();
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+// Produces `dst` as the view of `src` that starts `src_offset` elements into it and has the shape of `dst` with
+// `view_strides`. If the allocation planner made `dst` share the buffer of `src`, only the strides and offset of
+// `dst` are set. Otherwise the view is copied into `dst`, which is how view ops materialize a strided input.
+template <typename EnabledDataTypes>
+Status CreateStridedView(concurrency::ThreadPool* thread_pool, const Tensor& src, std::ptrdiff_t src_offset,
+                         const TensorShapeVector& view_strides, Tensor& dst) {
+  if (dst.DataRaw() == src.DataRaw()) {
+    dst.SetByteOffset(dst.ByteOffset() + src_offset * static_cast<std::ptrdiff_t>(src.DataType()->Size()));
+    dst.SetShapeAndStrides(dst.Shape(), view_strides);
+    return Status::OK();
+  }
+
+  if (dst.Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  // StridedCopy needs at least one dimension
+  if (dst.Shape().NumDimensions() == 0) {
+    return DispatchStridedCopy<EnabledDataTypes>(thread_pool, dst, 0, {1}, TensorShape({1}), src, src_offset, {1});
+  }
+
+  return DispatchStridedCopy<EnabledDataTypes>(thread_pool, dst, 0, StridesForTensor(dst), dst.Shape(), src,
+                                               src_offset, view_strides);
+}
+#endif
+
 }  // namespace onnxruntime
@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/framework/data_transfer_manager.h"
+
+#include <algorithm>
+
+#include "core/common/inlined_containers.h"
 #include "core/framework/tensor.h"
 #include "core/framework/sparse_tensor.h"
 
@@ -129,16 +133,34 @@ common::Status DataTransferManager::CopyTensors(const std::vector<IDataTransfer:
     return first_dt->CopyTensors(src_dst_pairs);
   }
 
-  // there are a mix of devices requiring copies. we don't expect this to happen, so just iterate the pairs
-  // copying one at a time. if this becomes expected we could create a list for each IDataTransfer instance so we
-  // batch as much as possible.
+  // there are a mix of devices requiring copies, e.g. inputs fed from different devices. group the pairs by the
+  // IDataTransfer instance doing them, keeping their order, so that each instance can still batch its copies.
+  InlinedVector<std::pair<const IDataTransfer*, std::vector<IDataTransfer::SrcDstPair>>> batches;
+  batches.emplace_back(first_dt, std::vector<IDataTransfer::SrcDstPair>{});
+  for (const auto& pair : src_dst_pairs) {
+    const OrtDevice& pair_src_device = pair.src.get().Location().device;
+    const OrtDevice& pair_dst_device = pair.dst.get().Location().device;
+    const IDataTransfer* data_transfer = GetDataTransfer(pair_src_device, pair_dst_device);
+    if (data_transfer == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME,
+                             FAIL,
+                             "There's no data transfer registered for copying tensors from ",
+                             pair_src_device.ToString(),
+                             " to ",
+                             pair_dst_device.ToString());
+    }
 
-  // copy the first one as we already did the IDataTransfer lookup
-  ORT_RETURN_IF_ERROR(first_pair.src_stream ? first_dt->CopyTensorAsync(first_pair.src.get(), first_pair.dst.get(), *(first_pair.src_stream))
-                                            : first_dt->CopyTensor(first_pair.src.get(), first_pair.dst.get()));
+    auto batch = std::find_if(batches.begin(), batches.end(),
+                              [data_transfer](const auto& cur_batch) { return cur_batch.first == data_transfer; });
+    if (batch == batches.end()) {
+      batch = batches.emplace(batches.end(), data_transfer, std::vector<IDataTransfer::SrcDstPair>{});
+    }
 
-  for (auto cur_pair = src_dst_pairs.cbegin() + 1, end_pair = src_dst_pairs.cend(); cur_pair != end_pair; ++cur_pair) {
-    ORT_RETURN_IF_ERROR(!cur_pair->src_stream ? CopyTensor(cur_pair->src, cur_pair->dst) : CopyTensorAsync(cur_pair->src, cur_pair->dst, *(cur_pair->src_stream)));
+    batch->second.push_back(pair);
+  }
+
+  for (const auto& batch : batches) {
+    ORT_RETURN_IF_ERROR(batch.first->CopyTensors(batch.second));
   }
 
   return Status::OK();
@@ -40,6 +40,8 @@ class DeviceStreamCollectionImpl {
         if (stream_aware_alloc) {
           stream_aware_alloc->ReleaseStreamBuffers(stream);
         }
+      } else if (it.second->Info().device == stream->GetDevice() && it.second->IsStreamAware()) {
+        it.second->ReleaseStream(stream);
       }
     }
   }
@@ -0,0 +1,171 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/ep_context_package.h"
+
+#include <vector>
+
+#include "core/common/path_string.h"
+#include "core/graph/graph.h"
+
+namespace onnxruntime {
+namespace ep_context {
+
+namespace {
+const ONNX_NAMESPACE::AttributeProto* GetAttribute(const Node& node, const char* name) {
+  const auto& attributes = node.GetAttributes();
+  auto it = attributes.find(name);
+  return it == attributes.end() ? nullptr : &it->second;
+}
+
+std::string_view GetString(const Node& node, const char* name) {
+  const auto* attribute = GetAttribute(node, name);
+  return attribute == nullptr ? std::string_view{} : std::string_view{attribute->s()};
+}
+
+std::vector<std::string> GetStrings(const Node& node, const char* name) {
+  const auto* attribute = GetAttribute(node, name);
+  return attribute == nullptr ? std::vector<std::string>{}
+                              : std::vector<std::string>(attribute->strings().begin(), attribute->strings().end());
+}
+
+// Orders how well a variant matches a request, -1 if it does not match.
+int GetMatchScore(std::string_view variant_value, std::string_view requested_value) {
+  if (variant_value == requested_value) {
+    return 2;
+  }
+  return variant_value.empty() || requested_value.empty() ? 1 : -1;
+}
+}  // namespace
+
+Status GetVariants(const Node& node, InlinedVector<Variant>& variants) {
+  variants.clear();
+  ORT_RETURN_IF_NOT(node.OpType() == kEpContextOp, "Node ", node.Name(), " is not an EPContext node");
+
+  if (GetAttribute(node, kEpCacheContext) != nullptr) {
+    variants.push_back({GetString(node, kHardwareArchitecture), GetString(node, kEpSdkVersion),
+                        GetString(node, kEpCacheContext)});
+  }
+
+  const auto* cache_contexts = GetAttribute(node, kVariantEpCacheContexts);
+  if (cache_contexts == nullptr) {
+    return Status::OK();
+  }
+  const auto* hardware_architectures = GetAttribute(node, kVariantHardwareArchitectures);
+  const auto* ep_sdk_versions = GetAttribute(node, kVariantEpSdkVersions);
+  const int num_variants = cache_contexts->strings_size();
+  ORT_RETURN_IF_NOT(hardware_architectures != nullptr && hardware_architectures->strings_size() == num_variants &&
+                        ep_sdk_versions != nullptr && ep_sdk_versions->strings_size() == num_variants,
+                    "EPContext node ", node.Name(), " has ", num_variants, " ", kVariantEpCacheContexts,
+                    " but not as many ", kVariantHardwareArchitectures, " and ", kVariantEpSdkVersions);
+  for (int i = 0; i < num_variants; ++i) {
+    variants.push_back({hardware_architectures->strings(i), ep_sdk_versions->strings(i),
+                        cache_contexts->strings(i)});
+  }
+
+  return Status::OK();
+}
+
+const Variant* SelectVariant(gsl::span<const Variant> variants, std::string_view hardware_architecture,
+                             std::string_view ep_sdk_version) {
+  const Variant* selected = nullptr;
+  int selected_score = -1;
+  for (const auto& variant : variants) {
+    const int hardware_score = GetMatchScore(variant.hardware_architecture, hardware_architecture);
+    const int sdk_score = GetMatchScore(variant.ep_sdk_version, ep_sdk_version);
+    if (hardware_score < 0 || sdk_score < 0) {
+      continue;
+    }
+    // the hardware architecture matters more than the SDK version
+    const int score = 3 * hardware_score + sdk_score;
+    if (score > selected_score) {
+      selected = &variant;
+      selected_score = score;
+    }
+  }
+
+  return selected;
+}
+
+void AddVariant(Node& node, const std::string& hardware_architecture, const std::string& ep_sdk_version,
+                const std::string& cache_context) {
+  const bool has_first_variant = GetAttribute(node, kEpCacheContext) != nullptr;
+  if (!has_first_variant || (GetString(node, kHardwareArchitecture) == hardware_architecture &&
+                             GetString(node, kEpSdkVersion) == ep_sdk_version)) {
+    node.AddAttribute(kEpCacheContext, cache_context);
+    node.AddAttribute(kHardwareArchitecture, hardware_architecture);
+    node.AddAttribute(kEpSdkVersion, ep_sdk_version);
+    return;
+  }
+
+  auto cache_contexts = GetStrings(node, kVariantEpCacheContexts);
+  auto hardware_architectures = GetStrings(node, kVariantHardwareArchitectures);
+  auto ep_sdk_versions = GetStrings(node, kVariantEpSdkVersions);
+  // drop the malformed lists GetVariants would reject
+  if (hardware_architectures.size() != cache_contexts.size() || ep_sdk_versions.size() != cache_contexts.size()) {
+    cache_contexts.clear();
+    hardware_architectures.clear();
+    ep_sdk_versions.clear();
+  }
+
+  size_t i = 0;
+  while (i < cache_contexts.size() &&
+         (hardware_architectures[i] != hardware_architecture || ep_sdk_versions[i] != ep_sdk_version)) {
+    ++i;
+  }
+  if (i == cache_contexts.size()) {
+    cache_contexts.push_back(cache_context);
+    hardware_architectures.push_back(hardware_architecture);
+    ep_sdk_versions.push_back(ep_sdk_version);
+  } else {
+    cache_contexts[i] = cache_context;
+  }
+
+  node.AddAttribute(kVariantEpCacheContexts, gsl::span<const std::string>(cache_contexts));
+  node.AddAttribute(kVariantHardwareArchitectures, gsl::span<const std::string>(hardware_architectures));
+  node.AddAttribute(kVariantEpSdkVersions, gsl::span<const std::string>(ep_sdk_versions));
+}
+
+Status LoadBlob(const Node& node, const Variant& variant, const std::filesystem::path& model_path, Blob& blob) {
+  blob = Blob{};
+  const auto* embed_mode = GetAttribute(node, kEmbedMode);
+  if (embed_mode == nullptr || embed_mode->i() == 1) {
+    blob.data = gsl::make_span(variant.cache_context.data(), variant.cache_context.size());
+    return Status::OK();
+  }
+
+  // a malformed package is an invalid graph, as for the other attributes of the EPContext node
+  if (variant.cache_context.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ", kEpCacheContext, " of EPContext node ",
+                           node.Name(), " is empty");
+  }
+  const std::filesystem::path relative_path(ToPathString(std::string(variant.cache_context)));
+  if (relative_path.has_root_path()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ", kEpCacheContext,
+                           " should be relative to the model, but it is: ", variant.cache_context);
+  }
+  for (const auto& part : relative_path.lexically_normal()) {
+    if (part == "..") {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ", kEpCacheContext,
+                             " must not point outside the directory of the model: ", variant.cache_context);
+    }
+  }
+
+  const std::filesystem::path blob_path = model_path.parent_path() / relative_path;
+  if (!std::filesystem::is_regular_file(blob_path)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ", kEpCacheContext,
+                           " does not exist or is not accessible: ", variant.cache_context);
+  }
+
+  const auto& env = Env::Default();
+  size_t file_size = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(blob_path.native().c_str(), file_size));
+  ORT_RETURN_IF(file_size == 0, "The EP context file ", variant.cache_context, " is empty");
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(blob_path.native().c_str(), 0, file_size, blob.mapped_memory));
+  blob.data = gsl::make_span(blob.mapped_memory.get(), file_size);
+
+  return Status::OK();
+}
+
+}  // namespace ep_context
+}  // namespace onnxruntime
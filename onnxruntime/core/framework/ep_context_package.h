@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include <gsl/gsl>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+class Node;
+
+/**
+ * Helpers for EPContext nodes packaging the blobs an EP compiled for several devices, so that a precompiled model
+ * can be deployed to a fleet with mixed hardware and SDK versions.
+ *
+ * The ep_cache_context, hardware_architecture and ep_sdk_version attributes of an EPContext node hold its first
+ * variant. The variant_ep_cache_contexts, variant_hardware_architectures and variant_ep_sdk_versions attributes,
+ * of equal length, hold the others. embed_mode applies to all of them.
+ */
+namespace ep_context {
+
+constexpr const char* kEpContextOp = "EPContext";
+constexpr const char* kEmbedMode = "embed_mode";
+constexpr const char* kEpCacheContext = "ep_cache_context";
+constexpr const char* kHardwareArchitecture = "hardware_architecture";
+constexpr const char* kEpSdkVersion = "ep_sdk_version";
+constexpr const char* kVariantEpCacheContexts = "variant_ep_cache_contexts";
+constexpr const char* kVariantHardwareArchitectures = "variant_hardware_architectures";
+constexpr const char* kVariantEpSdkVersions = "variant_ep_sdk_versions";
+
+// A compiled variant of an EPContext node. The values point into the attributes of the node.
+struct Variant {
+  std::string_view hardware_architecture;
+  std::string_view ep_sdk_version;
+  // The blob if embed_mode is 1, otherwise the path of the file holding it, relative to the model.
+  std::string_view cache_context;
+};
+
+// Gets the variants of an EPContext node, the one of its ep_cache_context attribute first.
+Status GetVariants(const Node& node, InlinedVector<Variant>& variants);
+
+/**
+ * Selects the variant compiled for the hardware architecture and SDK version of an EP. An empty value, in the
+ * variant or in the request, matches any value, and exact matches are preferred. Returns nullptr if no variant
+ * matches, the EP then has to compile the original model instead.
+ */
+const Variant* SelectVariant(gsl::span<const Variant> variants, std::string_view hardware_architecture,
+                             std::string_view ep_sdk_version);
+
+/**
+ * Adds a variant to an EPContext node. A variant with the same hardware architecture and SDK version is replaced,
+ * so that a package can be updated with the blob compiled on a new device without recompiling the others.
+ */
+void AddVariant(Node& node, const std::string& hardware_architecture, const std::string& ep_sdk_version,
+                const std::string& cache_context);
+
+// The blob of a variant. It points into the node attributes if embedded, otherwise into mapped_memory.
+struct Blob {
+  gsl::span<const char> data;
+  Env::MappedMemoryPtr mapped_memory;
+};
+
+/**
+ * Gets the blob of a variant of node. A blob stored in a file is memory-mapped rather than read. Its path must be
+ * relative to the directory of model_path and stay inside it.
+ */
+Status LoadBlob(const Node& node, const Variant& variant, const std::filesystem::path& model_path, Blob& blob);
+
+}  // namespace ep_context
+}  // namespace onnxruntime
@@ -58,7 +58,11 @@ Status IExecutionFrame::SetOutputMLValue(int index, const OrtValue& ort_value) {
   }
 
   if (all_values_[ort_value_idx].IsAllocated()) {
-    ORT_RETURN_IF_ERROR(CopyTensor(ort_value.Get<Tensor>(), *all_values_[ort_value_idx].GetMutable<Tensor>()));
+    const Tensor& source = ort_value.Get<Tensor>();
+    Tensor& dest = *all_values_[ort_value_idx].GetMutable<Tensor>();
+    ORT_RETURN_IF_NOT(source.Shape() == dest.Shape(), "Shape mismatch attempting to copy a tensor of shape ",
+                      source.Shape(), " to the preallocated output of shape ", dest.Shape());
+    ORT_RETURN_IF_ERROR(CopyTensor(source, dest));
   } else {
     all_values_[ort_value_idx] = ort_value;
   }
@@ -351,13 +355,17 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
 #ifdef ORT_ENABLE_STREAM
                                const DeviceStreamCollection* device_streams,
 #endif
-                               const SessionState& session_state)
+                               const SessionState& session_state,
+                               RunMemoryBudget* memory_budget)
     : IExecutionFrame(session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(), fetch_mlvalue_idxs),
 #ifdef ORT_ENABLE_STREAM
       device_streams_(device_streams),
 #endif
       session_state_(session_state),
+      memory_budget_(memory_budget),
       mem_patterns_(nullptr) {
+  ORT_THROW_IF_ERROR(session_state.LoadLazyInitializedTensors());
+
   Init(
       feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -548,8 +556,9 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // if the block is not correct, log message then fall back to default behavior.
+          // with bucketed shapes the pattern may have been planned for larger inputs of the same bucket.
+          if (block->size_ == size || (block->size_ > size && session_state_.GetMemoryPatternsAreBucketed())) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
@@ -586,6 +595,10 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
           current_stream->GetDevice().Type(), current_stream->GetDevice().Type());
       void* p_data = stream_aware_alloc->AllocOnStream(buffer_size, current_stream, wait_handle);
       Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
+    } else if (alloc->IsStreamAware()) {
+      size_t buffer_size = Tensor::CalculateTensorStorageSize(element_type, shape);
+      void* p_data = alloc->AllocWithStream(buffer_size, current_stream);
+      Tensor::InitOrtValue(element_type, shape, p_data, std::move(alloc), ort_value);
     } else {
       Tensor::InitOrtValue(element_type, shape, std::move(alloc), ort_value);
     }
@@ -669,6 +682,23 @@ Status ExecutionFrame::AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_v
   return Status::OK();
 }
 
+Status ExecutionFrame::AllocateMLValueTensorInSubBuffer(OrtValue& ort_value, int ort_value_index_reuse,
+                                                        size_t sub_buffer_offset, MLDataType element_type,
+                                                        const OrtDevice& location, const TensorShape& shape) {
+  auto* reuse_tensor = GetMutableMLValue(ort_value_index_reuse).GetMutable<Tensor>();
+
+  // the planner only places statically shaped tensors, so running out of the buffer means the model's shapes are wrong
+  const size_t required_size = Tensor::CalculateTensorStorageSize(element_type, shape);
+  if (sub_buffer_offset + required_size > reuse_tensor->SizeInBytes()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Shape mismatch attempting to place a tensor of shape ", shape,
+                           " at offset ", sub_buffer_offset, " in a buffer of shape ", reuse_tensor->Shape(),
+                           ". Validate the dim_value shapes in the model.");
+  }
+
+  void* buffer = static_cast<char*>(reuse_tensor->MutableDataRaw()) + sub_buffer_offset;
+  return AllocateTensorWithPreAllocateBufferHelper(ort_value, buffer, element_type, location, shape);
+}
+
 static Status AllocateTraditionalMLValue(OrtValue& ort_value, const NonTensorTypeBase& type) {
   auto creator = type.GetCreateFunc();
   ort_value.Init(creator(), &type, type.GetDeleteFunc());
@@ -760,6 +790,15 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
       case AllocKind::kReuse: {
         int reuse_mlvalue_index = per_alloc_plan.reused_buffer;
 
+        if (per_alloc_plan.is_sub_buffer) {
+          ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(reuse_mlvalue_index,
+                                                                         &per_alloc_plan.reused_buffer_shape));
+          ORT_RETURN_IF_ERROR(AllocateMLValueTensorInSubBuffer(ort_value, reuse_mlvalue_index,
+                                                               per_alloc_plan.sub_buffer_offset, ml_data_type,
+                                                               alloc_info, *shape));
+          break;
+        }
+
         ORT_RETURN_IF_ERROR(AllocateReusedOrtValueIfNotAllocatedHelper(reuse_mlvalue_index, shape));
 
         bool is_strided_tensor = false;
@@ -824,7 +863,8 @@ Status ExecutionFrame::AllocateAsPerAllocationPlan(OrtValue& ort_value, int ort_
 }
 
 AllocatorPtr ExecutionFrame::GetAllocatorImpl(const OrtDevice& info) const {
-  return session_state_.GetAllocator(info);
+  AllocatorPtr allocator = session_state_.GetAllocator(info);
+  return memory_budget_ != nullptr ? memory_budget_->Wrap(allocator) : allocator;
 }
 
 // This method is not thread safe!
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -13,6 +14,7 @@
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/run_memory_budget.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/tensor.h"
 #include "core/graph/graph_viewer.h"
@@ -90,6 +92,9 @@ class IExecutionFrame {
 
   AllocatorPtr GetAllocator(const OrtDevice& info) const;
 
+  // Returns the memory budget charged with the allocations of the frame, nullptr if there is none.
+  virtual const RunMemoryBudget* GetRunMemoryBudget() const { return nullptr; }
+
   Status ReleaseMLValue(int ort_value_idx);
 
  protected:
@@ -146,7 +151,9 @@ class ExecutionFrame final : public IExecutionFrame {
 #ifdef ORT_ENABLE_STREAM
                  const DeviceStreamCollection* device_streams,
 #endif
-                 const SessionState& session_state);
+                 const SessionState& session_state,
+                 // optional budget to charge the allocations of the frame to, must outlive the frame
+                 RunMemoryBudget* memory_budget = nullptr);
   ~ExecutionFrame() override;
 
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
@@ -170,6 +177,8 @@ class ExecutionFrame final : public IExecutionFrame {
   // If the retrival is successful, this function returns true and false otherwise.
   bool TryGetInferredShape(int index, TensorShape& shape) const override;
 
+  const RunMemoryBudget* GetRunMemoryBudget() const override { return memory_budget_; }
+
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Return the size of virtual memory allocated in runtime.
   // The memory is usually used for activations in forward and backward passes.
@@ -212,6 +221,11 @@ class ExecutionFrame final : public IExecutionFrame {
   Status AllocateTensorWithPreAllocateBufferHelper(OrtValue& ort_value, void* pBuffer, MLDataType element_type,
                                                    const OrtDevice& location, const TensorShape& shape);
 
+  // Allocates a tensor in the part of another OrtValue's buffer that starts sub_buffer_offset bytes into it
+  Status AllocateMLValueTensorInSubBuffer(OrtValue& ort_value, int ort_value_index_reuse, size_t sub_buffer_offset,
+                                          MLDataType element_type, const OrtDevice& location,
+                                          const TensorShape& shape);
+
   void TraceAllocate(int ort_value_idx, size_t size);
   void TraceFree(int ort_value_idx);
 
@@ -225,13 +239,15 @@ class ExecutionFrame final : public IExecutionFrame {
 
   const SessionState& session_state_;
 
+  RunMemoryBudget* memory_budget_;
+
   // map of index to custom allocator
   InlinedHashMap<int, IExecutor::CustomAllocator> custom_allocators_;
 
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -245,7 +261,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // by i, if the key i exists.
   // inferred_shapes_ is generated together with mem_patterns_.
   // It is never updated after creation
-  const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
+  std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes_;
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Size of virtual memory allocated before any kernel execution.
@@ -0,0 +1,309 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/external_data_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "core/common/common.h"
+#include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace utils {
+
+// The compressed data starts with the uncompressed size (uint64) and the number of blocks (uint32) followed by the
+// stored size of each block (uint32), all little endian. A block that doesn't get smaller is stored uncompressed,
+// which is marked by kUncompressedBlockFlag in its stored size.
+namespace {
+
+constexpr size_t kHeaderSize = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr uint32_t kUncompressedBlockFlag = 0x80000000u;
+
+// LZ4 block format limits
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMatchSearchEnd = 12;
+constexpr size_t kMaxOffset = 65535;
+constexpr int kHashLog = 12;
+
+static_assert(kExternalDataCompressionBlockSize % 16 == 0, "Blocks must hold whole elements of every type");
+
+void WriteLE(uint8_t* p, uint64_t value, size_t num_bytes) {
+  for (size_t i = 0; i < num_bytes; ++i) {
+    p[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+uint64_t ReadLE(const uint8_t* p, size_t num_bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < num_bytes; ++i) {
+    value |= static_cast<uint64_t>(p[i]) << (8 * i);
+  }
+  return value;
+}
+
+uint32_t Read32(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint8_t* WriteLength(uint8_t* op, size_t length) {
+  for (; length >= 255; length -= 255) {
+    *op++ = 255;
+  }
+  *op++ = static_cast<uint8_t>(length);
+  return op;
+}
+
+uint8_t* WriteSequence(uint8_t* op, const uint8_t* literals, size_t num_literals, size_t offset, size_t match_length) {
+  uint8_t* token = op++;
+  *token = static_cast<uint8_t>(std::min<size_t>(num_literals, 15) << 4);
+  if (num_literals >= 15) {
+    op = WriteLength(op, num_literals - 15);
+  }
+  std::memcpy(op, literals, num_literals);
+  op += num_literals;
+
+  if (match_length != 0) {
+    WriteLE(op, offset, 2);
+    op += 2;
+    const size_t length_code = match_length - kMinMatch;
+    *token |= static_cast<uint8_t>(std::min<size_t>(length_code, 15));
+    if (length_code >= 15) {
+      op = WriteLength(op, length_code - 15);
+    }
+  }
+  return op;
+}
+
+size_t CompressBound(size_t size) { return size + size / 255 + 16; }
+
+// greedy LZ4 block compression with a single entry hash table
+size_t CompressBlock(const uint8_t* src, size_t size, uint8_t* dst) {
+  uint8_t* op = dst;
+  size_t anchor = 0;
+  if (size > kMatchSearchEnd) {
+    std::array<uint32_t, 1 << kHashLog> table{};
+    const size_t match_start_limit = size - kMatchSearchEnd;
+    const size_t match_end_limit = size - kLastLiterals;
+    size_t i = 0;
+    while (i < match_start_limit) {
+      const uint32_t sequence = Read32(src + i);
+      const uint32_t hash = (sequence * 2654435761u) >> (32 - kHashLog);
+      const size_t candidate = table[hash];
+      table[hash] = static_cast<uint32_t>(i);
+      if (candidate >= i || i - candidate > kMaxOffset || Read32(src + candidate) != sequence) {
+        ++i;
+        continue;
+      }
+
+      size_t match_length = kMinMatch;
+      while (i + match_length < match_end_limit && src[candidate + match_length] == src[i + match_length]) {
+        ++match_length;
+      }
+      op = WriteSequence(op, src + anchor, i - anchor, i - candidate, match_length);
+      i += match_length;
+      anchor = i;
+    }
+  }
+  op = WriteSequence(op, src + anchor, size - anchor, 0, 0);
+  return narrow<size_t>(op - dst);
+}
+
+bool ReadLength(const uint8_t*& ip, const uint8_t* ip_end, size_t& length) {
+  uint8_t byte;
+  do {
+    if (ip == ip_end) {
+      return false;
+    }
+    byte = *ip++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+// returns false if the block is malformed or doesn't decompress to exactly dst_size bytes
+bool DecompressBlock(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size) {
+  const uint8_t* ip = src;
+  const uint8_t* const ip_end = src + src_size;
+  uint8_t* op = dst;
+  uint8_t* const op_end = dst + dst_size;
+
+  while (ip < ip_end) {
+    const uint8_t token = *ip++;
+    size_t num_literals = token >> 4;
+    if (num_literals == 15 && !ReadLength(ip, ip_end, num_literals)) {
+      return false;
+    }
+    if (num_literals > static_cast<size_t>(ip_end - ip) || num_literals > static_cast<size_t>(op_end - op)) {
+      return false;
+    }
+    std::memcpy(op, ip, num_literals);
+    ip += num_literals;
+    op += num_literals;
+
+    // the last sequence only has literals
+    if (ip == ip_end) {
+      break;
+    }
+
+    if (ip_end - ip < 2) {
+      return false;
+    }
+    const size_t offset = narrow<size_t>(ReadLE(ip, 2));
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+      return false;
+    }
+
+    size_t match_length = token & 15;
+    if (match_length == 15 && !ReadLength(ip, ip_end, match_length)) {
+      return false;
+    }
+    match_length += kMinMatch;
+    if (match_length > static_cast<size_t>(op_end - op)) {
+      return false;
+    }
+
+    // the match may overlap the output it is copied to
+    const uint8_t* match = op - offset;
+    for (size_t i = 0; i < match_length; ++i) {
+      op[i] = match[i];
+    }
+    op += match_length;
+  }
+
+  return op == op_end;
+}
+
+void Shuffle(const uint8_t* src, size_t size, size_t element_size, uint8_t* dst) {
+  const size_t num_elements = size / element_size;
+  for (size_t e = 0; e < num_elements; ++e) {
+    for (size_t b = 0; b < element_size; ++b) {
+      dst[b * num_elements + e] = src[e * element_size + b];
+    }
+  }
+}
+
+void Unshuffle(const uint8_t* src, size_t size, size_t element_size, uint8_t* dst) {
+  const size_t num_elements = size / element_size;
+  for (size_t b = 0; b < element_size; ++b) {
+    for (size_t e = 0; e < num_elements; ++e) {
+      dst[e * element_size + b] = src[b * num_elements + e];
+    }
+  }
+}
+
+}  // namespace
+
+Status CompressExternalData(gsl::span<const uint8_t> data, size_t shuffle_element_size,
+                            std::vector<uint8_t>& compressed) {
+  const bool shuffle = shuffle_element_size > 1;
+  ORT_RETURN_IF(shuffle && (data.size() % shuffle_element_size != 0 ||
+                            kExternalDataCompressionBlockSize % shuffle_element_size != 0),
+                "Data of ", data.size(), " bytes can't be shuffled with an element size of ", shuffle_element_size);
+
+  const size_t num_blocks = (data.size() + kExternalDataCompressionBlockSize - 1) / kExternalDataCompressionBlockSize;
+  const size_t block_table_offset = kHeaderSize;
+  compressed.assign(kHeaderSize + num_blocks * sizeof(uint32_t), 0);
+  WriteLE(compressed.data(), data.size(), sizeof(uint64_t));
+  WriteLE(compressed.data() + sizeof(uint64_t), narrow<uint32_t>(num_blocks), sizeof(uint32_t));
+
+  std::vector<uint8_t> shuffled(shuffle ? std::min(data.size(), kExternalDataCompressionBlockSize) : 0);
+  std::vector<uint8_t> block_buffer(CompressBound(kExternalDataCompressionBlockSize));
+  for (size_t block = 0; block < num_blocks; ++block) {
+    const size_t begin = block * kExternalDataCompressionBlockSize;
+    const size_t size = std::min(kExternalDataCompressionBlockSize, data.size() - begin);
+    const uint8_t* src = data.data() + begin;
+    if (shuffle) {
+      Shuffle(src, size, shuffle_element_size, shuffled.data());
+      src = shuffled.data();
+    }
+
+    const size_t compressed_size = CompressBlock(src, size, block_buffer.data());
+    uint32_t stored_size;
+    if (compressed_size < size) {
+      stored_size = narrow<uint32_t>(compressed_size);
+      compressed.insert(compressed.end(), block_buffer.begin(), block_buffer.begin() + compressed_size);
+    } else {
+      stored_size = narrow<uint32_t>(size) | kUncompressedBlockFlag;
+      compressed.insert(compressed.end(), src, src + size);
+    }
+    WriteLE(compressed.data() + block_table_offset + block * sizeof(uint32_t), stored_size, sizeof(uint32_t));
+  }
+
+  return Status::OK();
+}
+
+Status DecompressExternalData(gsl::span<const uint8_t> compressed, size_t shuffle_element_size,
+                              gsl::span<uint8_t> data, concurrency::ThreadPool* thread_pool) {
+  ORT_RETURN_IF(compressed.size() < kHeaderSize, "Compressed external data is too small: ", compressed.size(),
+                " bytes");
+  const uint64_t data_size = ReadLE(compressed.data(), sizeof(uint64_t));
+  const size_t num_blocks = narrow<size_t>(ReadLE(compressed.data() + sizeof(uint64_t), sizeof(uint32_t)));
+  ORT_RETURN_IF(data_size != data.size(), "Compressed external data has ", data_size,
+                " bytes when decompressed. Expected ", data.size());
+  ORT_RETURN_IF(num_blocks != (data.size() + kExternalDataCompressionBlockSize - 1) / kExternalDataCompressionBlockSize,
+                "Compressed external data has an invalid number of blocks: ", num_blocks);
+
+  const bool shuffle = shuffle_element_size > 1;
+  ORT_RETURN_IF(shuffle && (data.size() % shuffle_element_size != 0 ||
+                            kExternalDataCompressionBlockSize % shuffle_element_size != 0),
+                "Invalid shuffle element size of compressed external data: ", shuffle_element_size);
+
+  // find where each block is before decompressing them in parallel
+  ORT_RETURN_IF((compressed.size() - kHeaderSize) / sizeof(uint32_t) < num_blocks,
+                "Compressed external data is truncated");
+  std::vector<size_t> block_offsets(num_blocks + 1);
+  block_offsets[0] = kHeaderSize + num_blocks * sizeof(uint32_t);
+  for (size_t block = 0; block < num_blocks; ++block) {
+    const uint32_t stored_size = static_cast<uint32_t>(
+        ReadLE(compressed.data() + kHeaderSize + block * sizeof(uint32_t), sizeof(uint32_t)));
+    const size_t size = stored_size & ~kUncompressedBlockFlag;
+    ORT_RETURN_IF(size > compressed.size() - block_offsets[block], "Compressed external data is truncated");
+    block_offsets[block + 1] = block_offsets[block] + size;
+  }
+
+  std::vector<char> block_ok(num_blocks, 0);
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      thread_pool, narrow<std::ptrdiff_t>(num_blocks), [&](std::ptrdiff_t i) {
+        const auto block = narrow<size_t>(i);
+        const size_t begin = block * kExternalDataCompressionBlockSize;
+        const size_t size = std::min(kExternalDataCompressionBlockSize, data.size() - begin);
+        const uint8_t* src = compressed.data() + block_offsets[block];
+        const size_t src_size = block_offsets[block + 1] - block_offsets[block];
+        const bool is_compressed = (ReadLE(compressed.data() + kHeaderSize + block * sizeof(uint32_t),
+                                           sizeof(uint32_t)) &
+                                    kUncompressedBlockFlag) == 0;
+
+        std::vector<uint8_t> shuffled(shuffle ? size : 0);
+        uint8_t* dst = shuffle ? shuffled.data() : data.data() + begin;
+        if (is_compressed) {
+          if (!DecompressBlock(src, src_size, dst, size)) {
+            return;
+          }
+        } else {
+          if (src_size != size) {
+            return;
+          }
+          std::memcpy(dst, src, size);
+        }
+
+        if (shuffle) {
+          Unshuffle(dst, size, shuffle_element_size, data.data() + begin);
+        }
+        block_ok[block] = 1;
+      });
+
+  const auto bad_block = std::find(block_ok.begin(), block_ok.end(), 0);
+  ORT_RETURN_IF(bad_block != block_ok.end(), "Block ", bad_block - block_ok.begin(),
+                " of the compressed external data is malformed");
+  return Status::OK();
+}
+
+}  // namespace utils
+}  // namespace onnxruntime
@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <gsl/gsl>
+
+#include "core/common/status.h"
+
+namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
+namespace utils {
+
+// Compressed external data is split into blocks of kExternalDataCompressionBlockSize uncompressed bytes that are
+// compressed independently with the LZ4 block format, so they can be decompressed in parallel. The block size is a
+// multiple of every element size, so each block holds whole elements.
+constexpr size_t kExternalDataCompressionBlockSize = 256 * 1024;
+
+// Compresses data into compressed. If shuffle_element_size is larger than 1 the bytes of the elements of each block
+// are grouped by their position in the element before compressing, which makes floating point data compress better.
+common::Status CompressExternalData(gsl::span<const uint8_t> data, size_t shuffle_element_size,
+                                    std::vector<uint8_t>& compressed);
+
+// Decompresses the output of CompressExternalData into data, which must have the size of the uncompressed data.
+// The blocks are decompressed in parallel if thread_pool is not null.
+common::Status DecompressExternalData(gsl::span<const uint8_t> compressed, size_t shuffle_element_size,
+                                      gsl::span<uint8_t> data, concurrency::ThreadPool* thread_pool = nullptr);
+
+}  // namespace utils
+}  // namespace onnxruntime
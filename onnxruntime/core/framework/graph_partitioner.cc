@@ -6,12 +6,14 @@
 #include <cassert>
 #include <functional>
 
+#include "core/common/string_utils.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/func_kernel.h"
 #include "core/framework/kernel_lookup.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/kernel_registry.h"
+#include "core/framework/partition_cost_model.h"
 #include "core/graph/function.h"
 #include "core/graph/function_utils.h"
 #include "core/graph/graph_viewer.h"
@@ -980,6 +982,19 @@ Status GraphPartitioner::Partition(Graph& graph, FuncManager& func_mgr,
     ORT_RETURN_IF_ERROR(PartitionOnnxFormatModel(partition_params, mode,
                                                  providers_, kernel_registry_mgr_));
 
+    const std::string cost_profiles = config_options.GetConfigOrDefault(kOrtSessionOptionsPartitionCostProfiles, "");
+    const bool cpu_ep_fallback_disabled =
+        config_options.GetConfigOrDefault(kOrtSessionOptionsDisableCPUEPFallback, "0") == "1";
+    if (!cost_profiles.empty() && !cpu_ep_fallback_disabled && providers_.Get(kCpuExecutionProvider) != nullptr) {
+      std::vector<std::string> profile_files;
+      for (const auto& profile_file : utils::SplitString(cost_profiles, ";")) {
+        profile_files.emplace_back(profile_file);
+      }
+      PartitionCostModel cost_model;
+      ORT_RETURN_IF_ERROR(PartitionCostModel::Load(profile_files, cost_model));
+      ORT_RETURN_IF_ERROR(RefinePlacementByCost(graph, kernel_registry_mgr_, cost_model, logger));
+    }
+
     bool ep_context_enabled = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextEnable, "0") == "1";
     std::string ep_context_path = config_options.GetConfigOrDefault(kOrtSessionOptionEpContextFilePath, "");
     if (ep_context_enabled) {
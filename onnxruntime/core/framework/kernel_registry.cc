@@ -100,6 +100,26 @@ bool MatchKernelDefTypes(const Node& node,
   return true;
 }
 
+// appends what the kernel matching reads from the node, i.e. its since version and argument types, to the map key
+void AppendNodeSignature(const Node& node, std::string& key) {
+  const auto append_args = [&key](gsl::span<const NodeArg* const> args) {
+    for (const NodeArg* arg : args) {
+      key.append(1, ' ');
+      if (arg->Exists() && arg->Type() != nullptr) {
+        key.append(*arg->Type());
+      }
+    }
+  };
+
+  key.append(1, ' ').append(std::to_string(node.SinceVersion()));
+  for (int count : node.InputArgCount()) {
+    key.append(1, ' ').append(std::to_string(count));
+  }
+  append_args(node.InputDefs());
+  key.append(" ->");
+  append_args(node.OutputDefs());
+}
+
 bool MatchKernelDefTypes(const std::unordered_map<std::string, std::vector<MLDataType>>& kernel_type_constraints,
                          const KernelRegistry::TypeConstraintMap& type_constraints) {
   bool match = true;
@@ -186,8 +206,27 @@ Status KernelRegistry::TryFindKernelImpl(const Node& node,
   const auto& node_provider = node.GetExecutionProviderType();
   const auto& expected_provider = (node_provider.empty() ? exec_provider : node_provider);
 
-  auto range = kernel_creator_fn_map_.equal_range(GetMapKey(node.OpType(), node.Domain(), expected_provider));
+  const std::string map_key = GetMapKey(node.OpType(), node.Domain(), expected_provider);
+  auto range = kernel_creator_fn_map_.equal_range(map_key);
   if (out) *out = nullptr;
+  if (range.first == range.second) {
+    return Status(common::ONNXRUNTIME, common::FAIL, "Kernel not found");
+  }
+
+  // the type constraints path is used for nodes created on the fly, so only the resolver path is cached
+  std::string found_kernel_key;
+  if (kernel_type_str_resolver != nullptr) {
+    found_kernel_key = map_key;
+    AppendNodeSignature(node, found_kernel_key);
+    std::lock_guard<OrtMutex> lock(found_kernels_mutex_);
+    auto hit = found_kernels_.find(found_kernel_key);
+    if (hit != found_kernels_.end()) {
+      if (out) {
+        *out = hit->second;
+      }
+      return Status::OK();
+    }
+  }
 
   std::vector<std::string> verify_kernel_def_error_strs;
 
@@ -197,6 +236,10 @@ Status KernelRegistry::TryFindKernelImpl(const Node& node,
       if (out) {
         *out = &i->second;
       }
+      if (kernel_type_str_resolver != nullptr) {
+        std::lock_guard<OrtMutex> lock(found_kernels_mutex_);
+        found_kernels_.emplace(std::move(found_kernel_key), &i->second);
+      }
       return Status::OK();
     }
 
@@ -319,6 +362,10 @@ Status KernelRegistry::Register(KernelCreateInfo&& create_info) {
   // Register the kernel.
   // Ownership of the KernelDef is transferred to kernel_creator_fn_map_.
   kernel_creator_fn_map_.emplace(key, std::move(create_info));
+
+  // a new kernel may match nodes better than the ones found before
+  std::lock_guard<OrtMutex> lock(found_kernels_mutex_);
+  found_kernels_.clear();
   return Status::OK();
 }
 
@@ -99,6 +99,11 @@ Status OpKernelContext::GetTempSpaceAllocator(AllocatorPtr* output) const {
   return Status::OK();
 }
 
+size_t OpKernelContext::GetAvailableRunMemory() const {
+  const RunMemoryBudget* budget = execution_frame_->GetRunMemoryBudget();
+  return budget != nullptr ? budget->GetAvailableBytes() : std::numeric_limits<size_t>::max();
+}
+
 Status OpKernelContext::GetTempSpaceCPUAllocator(AllocatorPtr* output) const {
   // While looking up the allocator from SessionState
   // (which is called via ExecutionFrame), the allocator lookup
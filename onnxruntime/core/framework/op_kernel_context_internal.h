@@ -22,8 +22,9 @@ class OpKernelContextInternal : public OpKernelContext {
                                    const OpKernel& kernel,
                                    const logging::Logger& logger,
                                    const bool& terminate_flag,
-                                   Stream* stream)
-      : OpKernelContext(&frame, &kernel, stream, session_state.GetThreadPool(), logger),
+                                   Stream* stream,
+                                   concurrency::ThreadPool* thread_pool)
+      : OpKernelContext(&frame, &kernel, stream, thread_pool, logger),
         session_state_(session_state),
         terminate_flag_(terminate_flag) {
     const auto& implicit_inputs = kernel.Node().ImplicitInputDefs();
@@ -60,6 +61,17 @@ class OpKernelContextInternal : public OpKernelContext {
   }
 #endif
 
+  // Makes the index-th output share ort_value unless the output is already allocated, e.g. to a buffer provided by
+  // the user. Returns false in that case, and the caller writes the value to the output instead.
+  bool TryShareOutputMLValue(int index, const OrtValue& ort_value) {
+    OrtValue* output = GetOutputMLValue(index);
+    if (output == nullptr || output->IsAllocated()) {
+      return false;
+    }
+    *output = ort_value;
+    return true;
+  }
+
   OrtValue* OutputMLValue(int index, const TensorShape& shape) override {
     return OpKernelContext::OutputMLValue(index, shape);
   }
@@ -0,0 +1,250 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/partition_cost_model.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "nlohmann/json.hpp"
+
+#include "core/framework/data_types.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/framework/utils.h"
+#include "core/graph/graph_viewer.h"
+
+using json = nlohmann::json;
+
+namespace onnxruntime {
+
+namespace {
+constexpr const char* kKernelTimeSuffix = "_kernel_time";
+// each move lowers the estimated cost of the graph, this only bounds the time spent on large graphs
+constexpr int kMaxPlacementPasses = 8;
+
+std::string GetKey(const std::string& name, const std::string& provider_type) {
+  return name + "/" + provider_type;
+}
+
+// Where the values are while the graph is refined. The kernels of the nodes on a device tell which of their inputs
+// and outputs are on the CPU, they are nullptr for nodes on the CPU or without a kernel.
+class Placement {
+ public:
+  Placement(const Graph& graph, const KernelRegistryManager& kernel_registry_mgr)
+      : graph_(graph), kernel_registry_mgr_(kernel_registry_mgr) {}
+
+  static bool IsOnCpu(const Node& node) {
+    return node.GetExecutionProviderType().empty() || utils::ProviderIsCpuBased(node.GetExecutionProviderType());
+  }
+
+  const KernelCreateInfo* GetDeviceKernel(const Node& node) {
+    auto it = device_kernels_.find(node.Index());
+    if (it == device_kernels_.end()) {
+      const KernelCreateInfo* kernel_create_info = nullptr;
+      if (!kernel_registry_mgr_.SearchKernelRegistry(node, &kernel_create_info).IsOK()) {
+        kernel_create_info = nullptr;
+      }
+      it = device_kernels_.emplace(node.Index(), kernel_create_info).first;
+    }
+    return it->second;
+  }
+
+  // Whether the value of arg is on the CPU, i.e. it is a graph input or a CPU output of its producer.
+  bool IsOnCpu(const NodeArg& arg) {
+    const Node* producer = graph_.GetProducerNode(arg.Name());
+    if (producer == nullptr || IsOnCpu(*producer)) {
+      return true;
+    }
+    const auto& outputs = producer->OutputDefs();
+    const size_t index = static_cast<size_t>(std::find(outputs.begin(), outputs.end(), &arg) - outputs.begin());
+    return utils::IsOutputOnCpu(*producer, GetDeviceKernel(*producer), index);
+  }
+
+  // Whether consumer reads arg on the CPU. Assumes the node was not moved if it is on a device.
+  bool IsConsumedOnCpu(const Node& consumer, const NodeArg& arg) {
+    if (IsOnCpu(consumer)) {
+      return true;
+    }
+    const auto& inputs = consumer.InputDefs();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (inputs[i] == &arg && !utils::IsInputOnCpu(consumer, GetDeviceKernel(consumer), i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Estimates the cost of running node on the CPU, or on its device with device_kernel, from its kernel time and the
+  // copies of its inputs and outputs. Nothing if a time is not known.
+  std::optional<double> GetCost(const Node& node, bool on_cpu, const KernelCreateInfo* device_kernel,
+                                std::optional<double> kernel_time) {
+    if (!kernel_time.has_value()) {
+      return std::nullopt;
+    }
+
+    double cost = *kernel_time;
+    const auto& inputs = node.InputDefs();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const NodeArg& input = *inputs[i];
+      // initializers are copied to the device once, when the session is created
+      if (!input.Exists() || graph_.IsInitializedTensor(input.Name())) {
+        continue;
+      }
+      const bool read_on_cpu = on_cpu || utils::IsInputOnCpu(node, device_kernel, i);
+      if (IsOnCpu(input) != read_on_cpu) {
+        const auto transfer_time = PartitionCostModel::GetTransferTime(input);
+        if (!transfer_time.has_value()) {
+          return std::nullopt;
+        }
+        cost += *transfer_time;
+      }
+    }
+
+    const auto& outputs = node.OutputDefs();
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      const NodeArg& output = *outputs[i];
+      if (!output.Exists()) {
+        continue;
+      }
+      const bool written_on_cpu = on_cpu || utils::IsOutputOnCpu(node, device_kernel, i);
+      // the graph outputs are returned on the CPU
+      bool copied = !written_on_cpu && graph_.IsOutput(&output);
+      for (const Node* consumer : graph_.GetConsumerNodes(output.Name())) {
+        copied = copied || IsConsumedOnCpu(*consumer, output) != written_on_cpu;
+      }
+      if (copied) {
+        const auto transfer_time = PartitionCostModel::GetTransferTime(output);
+        if (!transfer_time.has_value()) {
+          return std::nullopt;
+        }
+        cost += *transfer_time;
+      }
+    }
+
+    return cost;
+  }
+
+ private:
+  const Graph& graph_;
+  const KernelRegistryManager& kernel_registry_mgr_;
+  InlinedHashMap<NodeIndex, const KernelCreateInfo*> device_kernels_;
+};
+}  // namespace
+
+Status PartitionCostModel::Load(gsl::span<const std::string> profile_files, PartitionCostModel& model) {
+  Status status;
+  for (const auto& profile_file : profile_files) {
+    std::ifstream stream(profile_file);
+    ORT_RETURN_IF_NOT(stream.is_open(), "Failed to open the profile ", profile_file);
+
+    ORT_TRY {
+      const json events = json::parse(stream);
+      for (const auto& event : events) {
+        const auto& name = event.value("name", std::string{});
+        const auto args = event.find("args");
+        if (event.value("cat", std::string{}) != "Node" || args == event.end() || !args->contains("provider") ||
+            name.size() <= strlen(kKernelTimeSuffix) ||
+            name.compare(name.size() - strlen(kKernelTimeSuffix), std::string::npos, kKernelTimeSuffix) != 0) {
+          continue;
+        }
+        model.AddKernelTime(name.substr(0, name.size() - strlen(kKernelTimeSuffix)),
+                            args->value("op_name", std::string{}), args->value("provider", std::string{}),
+                            event.value("dur", 0.0));
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to parse the profile ", profile_file, ": ",
+                                 ex.what());
+      });
+    }
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  return Status::OK();
+}
+
+void PartitionCostModel::AddKernelTime(const std::string& node_name, const std::string& op_type,
+                                       const std::string& provider_type, double duration_us) {
+  auto& node_time = node_times_[GetKey(node_name, provider_type)];
+  node_time.total_us += duration_us;
+  ++node_time.count;
+
+  auto& op_type_time = op_type_times_[GetKey(op_type, provider_type)];
+  op_type_time.total_us += duration_us;
+  ++op_type_time.count;
+}
+
+std::optional<double> PartitionCostModel::GetKernelTime(const Node& node, const std::string& provider_type) const {
+  auto it = node_times_.find(GetKey(node.Name(), provider_type));
+  if (it == node_times_.end()) {
+    it = op_type_times_.find(GetKey(node.OpType(), provider_type));
+    if (it == op_type_times_.end()) {
+      return std::nullopt;
+    }
+  }
+
+  return it->second.total_us / static_cast<double>(it->second.count);
+}
+
+std::optional<double> PartitionCostModel::GetTransferTime(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  if (type == nullptr || !type->has_tensor_type() || shape == nullptr ||
+      type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED) {
+    return std::nullopt;
+  }
+  const auto* tensor_type = DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type());
+  const int64_t num_elements = utils::GetTensorShapeFromTensorShapeProto(*shape).Size();
+  if (tensor_type == nullptr || num_elements < 0) {
+    return std::nullopt;
+  }
+
+  const double num_bytes = static_cast<double>(num_elements) * static_cast<double>(tensor_type->GetElementType()->Size());
+  return kTransferLatencyUs + num_bytes / kTransferBytesPerUs;
+}
+
+Status RefinePlacementByCost(Graph& graph, const KernelRegistryManager& kernel_registry_mgr,
+                             const PartitionCostModel& cost_model, const logging::Logger& logger) {
+  Placement placement(graph, kernel_registry_mgr);
+  const auto node_order = GraphViewer(graph).GetNodesInTopologicalOrder();
+
+  size_t num_moved = 0;
+  bool moved = true;
+  for (int pass = 0; moved && pass < kMaxPlacementPasses; ++pass) {
+    moved = false;
+    for (NodeIndex node_index : node_order) {
+      Node* node = graph.GetNode(node_index);
+      if (node == nullptr || Placement::IsOnCpu(*node) || node->NodeType() == Node::Type::Fused ||
+          node->ContainsSubgraph() ||
+          !KernelRegistryManager::HasImplementationOf(kernel_registry_mgr, *node, kCpuExecutionProvider)) {
+        continue;
+      }
+
+      const KernelCreateInfo* device_kernel = placement.GetDeviceKernel(*node);
+      const auto device_cost = placement.GetCost(*node, false, device_kernel,
+                                                 cost_model.GetKernelTime(*node, node->GetExecutionProviderType()));
+      const auto cpu_cost = placement.GetCost(*node, true, device_kernel,
+                                              cost_model.GetKernelTime(*node, kCpuExecutionProvider));
+      if (!device_cost.has_value() || !cpu_cost.has_value() || *cpu_cost >= *device_cost) {
+        continue;
+      }
+
+      LOGS(logger, INFO) << "Moving node " << node->Name() << " (" << node->OpType() << ") from "
+                         << node->GetExecutionProviderType() << " to the CPU: estimated " << *cpu_cost
+                         << "us instead of " << *device_cost << "us with the copies of its tensors";
+      node->SetExecutionProviderType(kCpuExecutionProvider);
+      moved = true;
+      ++num_moved;
+    }
+  }
+
+  if (num_moved > 0) {
+    LOGS(logger, INFO) << "Cost based placement moved " << num_moved << " node(s) to the CPU";
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <gsl/gsl>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+
+namespace onnxruntime {
+
+class Graph;
+class KernelRegistryManager;
+class Node;
+class NodeArg;
+namespace logging {
+class Logger;
+}
+
+/**
+@Class PartitionCostModel
+The measured cost of running nodes on each execution provider, and the estimated cost of copying their inputs and
+outputs between the CPU and a device.
+
+The kernel times are read from profiles written by the session profiler, e.g. a profile of the model run with the
+CUDA EP and one of the model run with the CPU EP only. A node without a time of its own gets the average time of
+the nodes with the same op type on that execution provider.
+*/
+class PartitionCostModel {
+ public:
+  // Copying a tensor between the CPU and a device costs a fixed latency plus its size over the bandwidth.
+  static constexpr double kTransferLatencyUs = 10.0;
+  static constexpr double kTransferBytesPerUs = 10000.0;  // 10 GB/s
+
+  // Loads the kernel times of the profiles.
+  static Status Load(gsl::span<const std::string> profile_files, PartitionCostModel& model);
+
+  void AddKernelTime(const std::string& node_name, const std::string& op_type, const std::string& provider_type,
+                     double duration_us);
+
+  // Gets the time of the kernel of node on provider_type, nothing if it was not measured.
+  std::optional<double> GetKernelTime(const Node& node, const std::string& provider_type) const;
+
+  // Gets the time of copying arg between the CPU and a device, nothing if its shape is not known.
+  static std::optional<double> GetTransferTime(const NodeArg& arg);
+
+ private:
+  struct Duration {
+    double total_us{0.0};
+    int64_t count{0};
+  };
+
+  InlinedHashMap<std::string, Duration> node_times_;     // keyed by node name and provider type
+  InlinedHashMap<std::string, Duration> op_type_times_;  // keyed by op type and provider type
+};
+
+/**
+Refines the assignment of the greedy partitioning of a graph with a cost model.
+
+A node the partitioning assigned to a device is moved to the CPU execution provider when its CPU kernel, together
+with copying its inputs and outputs from and to the device nodes around it, is estimated to be faster than its
+device kernel with the copies from and to the CPU nodes around it. Typical cases are small shape computations
+between CPU nodes. Nodes are visited in topological order until no node moves.
+
+Only nodes with kernels are considered; nodes compiled by their execution provider, control flow nodes and nodes
+without the times of both kernels keep their assignment.
+*/
+Status RefinePlacementByCost(Graph& graph, const KernelRegistryManager& kernel_registry_mgr,
+                             const PartitionCostModel& cost_model, const logging::Logger& logger);
+
+}  // namespace onnxruntime
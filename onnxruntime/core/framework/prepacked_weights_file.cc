@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "onnxruntime_config.h"
+#include "core/common/cpuid_info.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+
+namespace {
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', '0', '1'};
+
+// Buffers are aligned within the file, the mapping itself is page aligned.
+constexpr uint64_t kBufferAlignment = 64;
+
+// MurmurHash3 takes the length as an int, so large tensors are hashed in chunks, each seeded with the hash so far.
+constexpr size_t kHashChunkSize = size_t{1} << 24;
+
+uint64_t AlignBufferOffset(uint64_t offset) {
+  return (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+void WriteUInt64(std::ostream& stream, uint64_t value) {
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(std::ostream& stream, const std::string& value) {
+  WriteUInt64(stream, value.size());
+  stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+// Reads the index of the file, checking that nothing is read beyond its end.
+class IndexReader {
+ public:
+  IndexReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+  Status Read(void* value, size_t size) {
+    ORT_RETURN_IF_NOT(size <= size_ - offset_, "Unexpected end of the pre-packed weights file");
+    std::memcpy(value, data_ + offset_, size);
+    offset_ += size;
+    return Status::OK();
+  }
+
+  Status ReadUInt64(uint64_t& value) {
+    return Read(&value, sizeof(value));
+  }
+
+  Status ReadString(std::string& value) {
+    uint64_t size = 0;
+    ORT_RETURN_IF_ERROR(ReadUInt64(size));
+    ORT_RETURN_IF_NOT(size <= size_ - offset_, "Unexpected end of the pre-packed weights file");
+    value.assign(data_ + offset_, static_cast<size_t>(size));
+    offset_ += static_cast<size_t>(size);
+    return Status::OK();
+  }
+
+ private:
+  const char* const data_;
+  const size_t size_;
+  size_t offset_ = 0;
+};
+}  // namespace
+
+std::string PrepackedWeightsFile::GetIdentity(const ConfigOptions& config_options) {
+  std::ostringstream identity;
+  identity << "ort_version:" << ORT_VERSION << '\n';
+
+  // Kernels pick their pre-packed layout based on the instruction sets MLAS dispatches to.
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  identity << "cpu:" << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1() << cpuid_info.HasAVX() << cpuid_info.HasAVX2()
+           << cpuid_info.HasAVX512f() << cpuid_info.HasAVX512Skylake() << cpuid_info.HasAVX512_BF16()
+           << cpuid_info.HasAMX_BF16() << cpuid_info.HasF16C() << cpuid_info.HasArmNeonDot()
+           << cpuid_info.HasArmNeon_I8MM() << cpuid_info.HasArmSVE_I8MM() << cpuid_info.HasArmNeon_BF16() << '\n';
+
+  // Session configuration entries such as kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16 change the layout too.
+  const std::map<std::string, std::string> config_entries(config_options.configurations.begin(),
+                                                          config_options.configurations.end());
+  for (const auto& [config_key, config_value] : config_entries) {
+    if (config_key != kOrtSessionOptionsConfigPrepackedWeightsFilePath) {
+      identity << "config:" << config_key << '=' << config_value << '\n';
+    }
+  }
+  return identity.str();
+}
+
+std::string PrepackedWeightsFile::GetWeightKey(const Node& node, int input_idx, const Tensor& weight) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  const auto* bytes = static_cast<const uint8_t*>(weight.DataRaw());
+  for (size_t remaining = weight.SizeInBytes(); remaining > 0;) {
+    const size_t chunk_size = std::min(remaining, kHashChunkSize);
+    MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), hash[0], &hash);
+    bytes += chunk_size;
+    remaining -= chunk_size;
+  }
+
+  std::ostringstream key;
+  key << node.Domain() << ':' << node.OpType() << ':' << node.Name() << ':' << input_idx << ':'
+      << weight.GetElementType() << ':' << weight.Shape() << ':';
+  for (auto word : hash) {
+    key << std::hex << std::setw(8) << std::setfill('0') << word;
+  }
+  return key.str();
+}
+
+Status PrepackedWeightsFile::Load(const PathString& path) {
+  ORT_RETURN_IF_NOT(weights_.empty(), "Pre-packed weights were already loaded or added");
+
+  const auto& env = Env::Default();
+  size_t file_size = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(path.c_str(), file_size));
+  ORT_RETURN_IF_NOT(file_size >= sizeof(kMagic), "The pre-packed weights file is too small");
+
+  Env::MappedMemoryPtr mapped_memory;
+  ORT_RETURN_IF_ERROR(env.MapFileIntoMemory(path.c_str(), 0, file_size, mapped_memory));
+
+  IndexReader reader(mapped_memory.get(), file_size);
+  char magic[sizeof(kMagic)];
+  ORT_RETURN_IF_ERROR(reader.Read(magic, sizeof(magic)));
+  ORT_RETURN_IF_NOT(std::memcmp(magic, kMagic, sizeof(kMagic)) == 0, "Not a pre-packed weights file");
+
+  std::string identity;
+  ORT_RETURN_IF_ERROR(reader.ReadString(identity));
+  ORT_RETURN_IF_NOT(identity == identity_,
+                    "The pre-packed weights file was written by another ORT version, on a different CPU "
+                    "or with a different session configuration");
+
+  uint64_t num_weights = 0;
+  ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_weights));
+  std::map<std::string, PrePackedWeights> weights;
+  for (uint64_t i = 0; i < num_weights; ++i) {
+    std::string key;
+    uint64_t num_buffers = 0;
+    ORT_RETURN_IF_ERROR(reader.ReadString(key));
+    ORT_RETURN_IF_ERROR(reader.ReadUInt64(num_buffers));
+    ORT_RETURN_IF_NOT(num_buffers > 0, "A pre-packed weight in the pre-packed weights file has no buffers");
+
+    PrePackedWeights weight;
+    for (uint64_t j = 0; j < num_buffers; ++j) {
+      uint64_t offset = 0;
+      uint64_t size = 0;
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(offset));
+      ORT_RETURN_IF_ERROR(reader.ReadUInt64(size));
+      ORT_RETURN_IF_NOT(offset <= file_size && size <= file_size - offset,
+                        "A pre-packed buffer is beyond the end of the pre-packed weights file");
+      // The buffers are owned by the mapping.
+      weight.buffers_.emplace_back(mapped_memory.get() + offset, [](void*) {});
+      weight.buffer_sizes_.push_back(static_cast<size_t>(size));
+    }
+    weights.emplace(std::move(key), std::move(weight));
+  }
+
+  mapped_memory_ = std::move(mapped_memory);
+  weights_ = std::move(weights);
+  return Status::OK();
+}
+
+const PrePackedWeights* PrepackedWeightsFile::GetWeight(const std::string& key) const {
+  auto it = weights_.find(key);
+  return it != weights_.end() ? &it->second : nullptr;
+}
+
+const PrePackedWeights& PrepackedWeightsFile::AddWeight(const std::string& key, PrePackedWeights&& weight) {
+  has_added_weights_ = true;
+  return weights_.try_emplace(key, std::move(weight)).first->second;
+}
+
+Status PrepackedWeightsFile::Save(const PathString& path) const {
+  std::ostringstream index;
+  index.write(kMagic, sizeof(kMagic));
+  WriteString(index, identity_);
+  WriteUInt64(index, weights_.size());
+
+  // The size of the index does not depend on the offsets of the buffers, so it can be computed up front.
+  uint64_t index_size = static_cast<uint64_t>(index.tellp());
+  for (const auto& [key, weight] : weights_) {
+    index_size += 2 * sizeof(uint64_t) + key.size() + weight.buffers_.size() * 2 * sizeof(uint64_t);
+  }
+
+  uint64_t offset = AlignBufferOffset(index_size);
+  for (const auto& [key, weight] : weights_) {
+    WriteString(index, key);
+    WriteUInt64(index, weight.buffers_.size());
+    for (size_t size : weight.buffer_sizes_) {
+      WriteUInt64(index, offset);
+      WriteUInt64(index, size);
+      offset = AlignBufferOffset(offset + size);
+    }
+  }
+  ORT_RETURN_IF_NOT(static_cast<uint64_t>(index.tellp()) == index_size, "Unexpected pre-packed weights index size");
+
+  const std::filesystem::path file_path(path);
+  auto temp_path = file_path;
+  temp_path += ToPathString(".tmp" + std::to_string(Env::Default().GetSelfPid()));
+  {
+    std::ofstream stream(temp_path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    ORT_RETURN_IF_NOT(stream, "Failed to open ", ToUTF8String(temp_path.native()), " for writing");
+
+    const std::string index_bytes = index.str();
+    stream.write(index_bytes.data(), static_cast<std::streamsize>(index_bytes.size()));
+    uint64_t written = index_bytes.size();
+    const std::vector<char> padding(kBufferAlignment, 0);
+    for (const auto& [key, weight] : weights_) {
+      for (size_t i = 0; i < weight.buffers_.size(); ++i) {
+        stream.write(padding.data(), static_cast<std::streamsize>(AlignBufferOffset(written) - written));
+        stream.write(static_cast<const char*>(weight.buffers_[i].get()),
+                     static_cast<std::streamsize>(weight.buffer_sizes_[i]));
+        written = AlignBufferOffset(written) + weight.buffer_sizes_[i];
+      }
+    }
+    stream.flush();
+    if (!stream) {
+      stream.close();
+      std::error_code error_code;
+      std::filesystem::remove(temp_path, error_code);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write ", ToUTF8String(temp_path.native()));
+    }
+  }
+
+  std::error_code error_code;
+  std::filesystem::rename(temp_path, file_path, error_code);
+  if (error_code) {
+    const auto message = error_code.message();
+    std::filesystem::remove(temp_path, error_code);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to rename ", ToUTF8String(temp_path.native()), ": ", message);
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
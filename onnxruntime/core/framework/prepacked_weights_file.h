@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/common/status.h"
+#include "core/framework/config_options.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+class Node;
+class Tensor;
+
+/**
+ * The pre-packed weights of the CPU kernels of a session, saved to a file so that later sessions of the same model
+ * can memory-map them instead of calling OpKernel::PrePack() again.
+ *
+ * Each weight is keyed by the node, the input index and a hash of the constant initialized tensor it was
+ * pre-packed from. The file also records an identity made of the ORT version, the instruction sets of the CPU and
+ * the session configuration, which determine the layout the kernels pre-pack in. A file with a different identity
+ * is not loaded.
+ */
+class PrepackedWeightsFile {
+ public:
+  explicit PrepackedWeightsFile(std::string identity) : identity_(std::move(identity)) {}
+
+  // Returns the identity of the pre-packed weights produced with the given session configuration on this CPU.
+  static std::string GetIdentity(const ConfigOptions& config_options);
+
+  // Returns the key of the pre-packed weight of the input input_idx of node, pre-packed from weight.
+  static std::string GetWeightKey(const Node& node, int input_idx, const Tensor& weight);
+
+  // Memory-maps the file at path. Fails if the file is malformed or has a different identity.
+  Status Load(const PathString& path);
+
+  // Returns the weight with the given key, or nullptr if there is none.
+  const PrePackedWeights* GetWeight(const std::string& key) const;
+
+  // Adds a weight to be saved, taking ownership of its buffers. Returns the stored weight.
+  const PrePackedWeights& AddWeight(const std::string& key, PrePackedWeights&& weight);
+
+  // True if weights were added since the file was loaded, i.e. the file needs to be saved.
+  bool HasAddedWeights() const { return has_added_weights_; }
+
+  // Saves the weights to the file at path. The file is written to a temporary file first and then renamed, so that
+  // other processes never load a partially written file.
+  Status Save(const PathString& path) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFile);
+
+  const std::string identity_;
+  Env::MappedMemoryPtr mapped_memory_;
+  // Weights loaded from the file point into mapped_memory_, added weights own their buffers.
+  std::map<std::string, PrePackedWeights> weights_;
+  bool has_added_weights_ = false;
+};
+
+}  // namespace onnxruntime
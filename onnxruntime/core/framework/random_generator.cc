@@ -4,6 +4,8 @@
 #include "core/framework/random_generator.h"
 #include "core/framework/random_seed.h"
 
+#include <algorithm>
+
 namespace onnxruntime {
 
 RandomGenerator& RandomGenerator::Default() {
@@ -16,4 +18,69 @@ PhiloxGenerator& PhiloxGenerator::Default() {
   return generator;
 }
 
+namespace {
+constexpr uint32_t kPhiloxM0 = 0xD2511F53;
+constexpr uint32_t kPhiloxM1 = 0xCD9E8D57;
+constexpr uint32_t kPhiloxW0 = 0x9E3779B9;
+constexpr uint32_t kPhiloxW1 = 0xBB67AE85;
+constexpr int kPhiloxRounds = 10;
+
+inline void PhiloxRound(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, uint32_t k0, uint32_t k1) {
+  const uint64_t p0 = static_cast<uint64_t>(kPhiloxM0) * c0;
+  const uint64_t p1 = static_cast<uint64_t>(kPhiloxM1) * c2;
+  c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+  c1 = static_cast<uint32_t>(p1);
+  c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+  c3 = static_cast<uint32_t>(p0);
+}
+}  // namespace
+
+PhiloxEngine::Block PhiloxEngine::ComputeBlock(const Block& counter, uint64_t key) {
+  uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  uint32_t k0 = static_cast<uint32_t>(key);
+  uint32_t k1 = static_cast<uint32_t>(key >> 32);
+  for (int round = 0; round < kPhiloxRounds; ++round) {
+    PhiloxRound(c0, c1, c2, c3, k0, k1);
+    k0 += kPhiloxW0;
+    k1 += kPhiloxW1;
+  }
+  return {c0, c1, c2, c3};
+}
+
+void PhiloxEngine::Generate(uint64_t first_block, size_t num_blocks, uint32_t* out) const {
+  // The blocks are computed in batches with the counter words in separate arrays, so that the rounds of a batch
+  // are independent lanes the compiler can vectorize.
+  constexpr size_t kBatchSize = 8;
+  uint32_t c0[kBatchSize], c1[kBatchSize], c2[kBatchSize], c3[kBatchSize];
+
+  for (size_t batch_begin = 0; batch_begin < num_blocks; batch_begin += kBatchSize) {
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      const uint64_t counter = first_block + batch_begin + i;
+      c0[i] = static_cast<uint32_t>(counter);
+      c1[i] = static_cast<uint32_t>(counter >> 32);
+      c2[i] = 0;
+      c3[i] = 0;
+    }
+
+    uint32_t k0 = static_cast<uint32_t>(seed_);
+    uint32_t k1 = static_cast<uint32_t>(seed_ >> 32);
+    for (int round = 0; round < kPhiloxRounds; ++round) {
+      for (size_t i = 0; i < kBatchSize; ++i) {
+        PhiloxRound(c0[i], c1[i], c2[i], c3[i], k0, k1);
+      }
+      k0 += kPhiloxW0;
+      k1 += kPhiloxW1;
+    }
+
+    const size_t batch_size = std::min(kBatchSize, num_blocks - batch_begin);
+    for (size_t i = 0; i < batch_size; ++i) {
+      uint32_t* block = out + (batch_begin + i) * 4;
+      block[0] = c0[i];
+      block[1] = c1[i];
+      block[2] = c2[i];
+      block[3] = c3[i];
+    }
+  }
+}
+
 }  // namespace onnxruntime
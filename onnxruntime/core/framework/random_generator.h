@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <stddef.h>
 #include <stdint.h>
 #include <utility>
 
@@ -84,4 +86,47 @@ class PhiloxGenerator {
   uint64_t offset_;
 };
 
+/**
+ * Philox4x32-10 counter-based random engine.  Block i of the stream of a seed
+ * is 4 x 32 random bits that are a pure function of the seed and i, so any
+ * range of the stream can be generated independently, e.g. by different
+ * threads, with the same result.  Use with the seed and offset pairs of a
+ * PhiloxGenerator to get a new range of the stream for every use.
+ */
+class PhiloxEngine {
+ public:
+  using Block = std::array<uint32_t, 4>;
+
+  explicit PhiloxEngine(uint64_t seed) : seed_(seed) {}
+
+  /**
+   * Computes the block of the 128 bit counter with the 64 bit key.
+   */
+  static Block ComputeBlock(const Block& counter, uint64_t key);
+
+  /**
+   * Generates the blocks [first_block, first_block + num_blocks) of the
+   * stream into out, which has room for 4 * num_blocks values.
+   */
+  void Generate(uint64_t first_block, size_t num_blocks, uint32_t* out) const;
+
+  /**
+   * Converts 32 random bits to a float uniformly distributed in [0, 1).
+   */
+  static float ToUniformFloat(uint32_t bits) {
+    return static_cast<float>(bits >> 8) * 0x1.0p-24f;
+  }
+
+  /**
+   * Converts 64 random bits to a double uniformly distributed in [0, 1).
+   */
+  static double ToUniformDouble(uint32_t low_bits, uint32_t high_bits) {
+    const uint64_t bits = (static_cast<uint64_t>(high_bits) << 32) | low_bits;
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+  }
+
+ private:
+  uint64_t seed_;
+};
+
 }  // namespace onnxruntime
@@ -0,0 +1,212 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/recorded_execution.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+#include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/sequential_executor.h"
+#include "core/framework/session_state.h"
+#include "core/framework/stream_execution_context.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/constants.h"
+
+namespace onnxruntime {
+
+namespace {
+// Copies the CPU tensor in src to the CPU tensor in dst. dst is allocated with alloc if it is not allocated yet.
+Status CopyTensorValue(const OrtValue& src, const AllocatorPtr& alloc, OrtValue& dst) {
+  ORT_RETURN_IF_NOT(src.IsTensor(), "Only tensors are supported by a recorded execution.");
+  const Tensor& src_tensor = src.Get<Tensor>();
+  if (!dst.IsAllocated()) {
+    Tensor::InitOrtValue(src_tensor.DataType(), src_tensor.Shape(), alloc, dst);
+  }
+
+  ORT_RETURN_IF_NOT(dst.IsTensor(), "Only tensors are supported by a recorded execution.");
+  Tensor& dst_tensor = *dst.GetMutable<Tensor>();
+  ORT_RETURN_IF_NOT(dst_tensor.DataType() == src_tensor.DataType() && dst_tensor.Shape() == src_tensor.Shape(),
+                    "Tensor of type ", DataTypeImpl::ToString(dst_tensor.DataType()), " and shape ",
+                    dst_tensor.Shape(), " can't hold a tensor of type ", DataTypeImpl::ToString(src_tensor.DataType()),
+                    " and shape ", src_tensor.Shape());
+  ORT_RETURN_IF_NOT(src_tensor.Location().device.Type() == OrtDevice::CPU &&
+                        dst_tensor.Location().device.Type() == OrtDevice::CPU,
+                    "Only CPU tensors are supported by a recorded execution.");
+
+  if (src_tensor.IsDataTypeString()) {
+    std::copy_n(src_tensor.Data<std::string>(), src_tensor.Shape().Size(), dst_tensor.MutableData<std::string>());
+  } else if (dst_tensor.DataRaw() != src_tensor.DataRaw()) {
+    memcpy(dst_tensor.MutableDataRaw(), src_tensor.DataRaw(), src_tensor.SizeInBytes());
+  }
+
+  return Status::OK();
+}
+}  // namespace
+
+RecordedExecution::RecordedExecution(const SessionState& session_state) : session_state_(session_state) {}
+
+RecordedExecution::~RecordedExecution() = default;
+
+bool RecordedExecution::CanRecord(const SessionState& session_state, std::string& reason) {
+  for (const auto& node : session_state.GetGraphViewer().Nodes()) {
+    if (node.GetExecutionProviderType() != kCpuExecutionProvider) {
+      reason = MakeString("node '", node.Name(), "' is assigned to ", node.GetExecutionProviderType());
+      return false;
+    }
+
+    // the output of a non-tensor (e.g. sequence) value is not replaced when its kernel runs again
+    for (const auto* output : node.OutputDefs()) {
+      if (output->Exists() && (output->TypeAsProto() == nullptr || !utils::HasTensorType(*output->TypeAsProto()))) {
+        reason = MakeString("output '", output->Name(), "' of node '", node.Name(), "' is not a tensor");
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+Status RecordedExecution::Record(const SessionState& session_state,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches,
+                                 const logging::Logger& logger, const bool& terminate_flag,
+                                 std::unique_ptr<RecordedExecution>& recorded_execution) {
+  recorded_execution.reset();
+  std::unique_ptr<RecordedExecution> recording(new RecordedExecution(session_state));
+
+  auto& info = recording->feeds_fetches_info_;
+  info.feed_names.assign(feed_names.begin(), feed_names.end());
+  info.output_names.assign(output_names.begin(), output_names.end());
+  ORT_RETURN_IF_ERROR(info.SetMLValueIdxs(session_state.GetOrtValueNameIdxMap()));
+
+  // the kernels reference the feeds through the execution frame, so they are copied into buffers owned by the
+  // recording which the feeds of the replays are copied into
+  AllocatorPtr cpu_allocator = session_state.GetAllocator(OrtDevice());
+  recording->feeds_.resize(feeds.size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_ERROR(CopyTensorValue(feeds[i], cpu_allocator, recording->feeds_[i]));
+  }
+
+  const auto* execution_plan = session_state.GetExecutionPlan();
+  int32_t valid_streams = 0;
+  for (const auto& stream : execution_plan->execution_plan) {
+    if (stream && stream->steps_.size() > 0)
+      valid_streams++;
+  }
+
+  // the outputs are allocated by the frame, and copied out after each run
+  std::vector<OrtValue> frame_fetches;
+  const std::unordered_map<size_t, IExecutor::CustomAllocator> fetch_allocators;
+  recording->ctx_ = std::make_unique<StreamExecutionContext>(session_state,
+                                                              valid_streams,
+#ifdef ORT_ENABLE_STREAM
+                                                              execution_plan->notification_owners,
+                                                              execution_plan->num_barriers,
+                                                              nullptr,
+#endif
+                                                              info.feeds_mlvalue_idxs,
+                                                              recording->feeds_,
+                                                              info.fetches_mlvalue_idxs,
+                                                              frame_fetches,
+                                                              fetch_allocators,
+                                                              logger,
+                                                              /*single_thread_mode*/ true);
+
+  recording->terminate_flag_ = terminate_flag;
+  recording->ctx_->SetRecordedExecution(recording.get());
+  ORT_RETURN_IF_ERROR(RecordThePlan(*recording->ctx_, terminate_flag));
+  recording->ctx_->SetRecordedExecution(nullptr);
+
+  ORT_RETURN_IF_ERROR(recording->CopyOutputs(fetches));
+  recorded_execution = std::move(recording);
+  return Status::OK();
+}
+
+bool RecordedExecution::CanReplay(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                  gsl::span<const std::string> output_names) const {
+  const auto& info = feeds_fetches_info_;
+  if (!std::equal(feed_names.begin(), feed_names.end(), info.feed_names.begin(), info.feed_names.end()) ||
+      !std::equal(output_names.begin(), output_names.end(), info.output_names.begin(), info.output_names.end()) ||
+      feeds.size() != feeds_.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor()) {
+      return false;
+    }
+    const Tensor& feed = feeds[i].Get<Tensor>();
+    const Tensor& recorded_feed = feeds_[i].Get<Tensor>();
+    if (feed.DataType() != recorded_feed.DataType() || feed.Shape() != recorded_feed.Shape()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status RecordedExecution::Replay(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                 const bool& terminate_flag) {
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_ERROR(CopyTensorValue(feeds[i], nullptr, feeds_[i]));
+  }
+
+  terminate_flag_ = terminate_flag;
+  for (auto& [kernel, kernel_ctx] : kernel_invocations_) {
+    if (terminate_flag) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    }
+
+    Status status;
+    ORT_TRY {
+      status = kernel->Compute(kernel_ctx.get());
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+
+    if (!status.IsOK()) {
+      const auto& node = kernel->Node();
+      return Status(status.Category(), status.Code(),
+                    MakeString("Non-zero status code returned while replaying ", node.OpType(), " node. Name:'",
+                               node.Name(), "' Status Message: ", status.ErrorMessage()));
+    }
+  }
+
+  return CopyOutputs(fetches);
+}
+
+OpKernelContextInternal& RecordedExecution::AddKernelInvocation(const OpKernel& kernel, size_t stream_idx) {
+  auto kernel_ctx = std::make_unique<OpKernelContextInternal>(session_state_,
+                                                              ctx_->GetExecutionFrame(),
+                                                              kernel,
+                                                              ctx_->GetLogger(),
+                                                              terminate_flag_,
+                                                              ctx_->GetDeviceStream(stream_idx),
+                                                              session_state_.GetStreamThreadPool(stream_idx));
+  kernel_invocations_.emplace_back(&kernel, std::move(kernel_ctx));
+  return *kernel_invocations_.back().second;
+}
+
+Status RecordedExecution::CopyOutputs(std::vector<OrtValue>& fetches) const {
+  std::vector<OrtValue> outputs;
+  ORT_RETURN_IF_ERROR(ctx_->GetExecutionFrame().GetOutputs(outputs));
+
+  if (fetches.empty()) {
+    fetches.resize(outputs.size());
+  }
+  ORT_RETURN_IF_NOT(fetches.size() == outputs.size(), "Expected ", outputs.size(), " fetches, got ", fetches.size());
+
+  AllocatorPtr cpu_allocator = session_state_.GetAllocator(OrtDevice());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    ORT_RETURN_IF_ERROR(CopyTensorValue(outputs[i], cpu_allocator, fetches[i]));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/logging/logging.h"
+#include "core/common/status.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/ort_value.h"
+
+namespace onnxruntime {
+
+class OpKernel;
+class OpKernelContextInternal;
+class SessionState;
+class StreamExecutionContext;
+
+// Records the kernel invocations of one run of a session state, and replays them in later runs with inputs of the
+// same types and shapes without going through the execution plan and creating an execution frame.
+//
+// The values of the recorded run, including all intermediate values, stay allocated and each recorded kernel keeps
+// its OpKernelContext, so a replayed kernel reads and writes the same buffers as in the recorded run. The inputs are
+// copied into buffers owned by the recording before a replay and the outputs are copied out after it.
+//
+// Only for session states whose nodes all run on the CPU and produce tensors (see CanRecord). A replay fails if a
+// kernel produces an output with a different shape than in the recorded run, e.g. when the output shape depends on
+// the input data. Not thread-safe: the caller must serialize the use of an instance.
+class RecordedExecution {
+ public:
+  ~RecordedExecution();
+
+  // Whether the runs of session_state can be recorded. If not, reason is set to why.
+  static bool CanRecord(const SessionState& session_state, std::string& reason);
+
+  // Runs session_state with feeds while recording it. fetches receive copies of the outputs. If they are
+  // pre-allocated, the outputs are copied into them.
+  static Status Record(const SessionState& session_state,
+                       gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                       gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches,
+                       const logging::Logger& logger, const bool& terminate_flag,
+                       std::unique_ptr<RecordedExecution>& recorded_execution);
+
+  // Whether a run with these inputs and outputs can be replayed.
+  bool CanReplay(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                 gsl::span<const std::string> output_names) const;
+
+  // Replays the recorded run with feeds. fetches are handled as in Record().
+  Status Replay(gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches, const bool& terminate_flag);
+
+  // Called by ExecuteKernel() while recording. Creates the context of the invocation of kernel, which is kept for
+  // the replays.
+  OpKernelContextInternal& AddKernelInvocation(const OpKernel& kernel, size_t stream_idx);
+
+ private:
+  explicit RecordedExecution(const SessionState& session_state);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RecordedExecution);
+
+  Status CopyOutputs(std::vector<OrtValue>& fetches) const;
+
+  const SessionState& session_state_;
+  FeedsFetchesInfo feeds_fetches_info_;
+  // copies of the feeds of the recorded run. the feeds of a replay are copied into them.
+  std::vector<OrtValue> feeds_;
+  // read by the recorded kernels through their context
+  bool terminate_flag_ = false;
+
+  // the kernel contexts reference the execution frame of ctx_, so they are declared after it to be destroyed first
+  std::unique_ptr<StreamExecutionContext> ctx_;
+  std::vector<std::pair<const OpKernel*, std::unique_ptr<OpKernelContextInternal>>> kernel_invocations_;
+};
+
+}  // namespace onnxruntime
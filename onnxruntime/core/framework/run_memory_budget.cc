@@ -0,0 +1,130 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_memory_budget.h"
+
+#include <algorithm>
+#include <gsl/gsl>
+
+#include "core/common/parse_string.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
+
+namespace onnxruntime {
+
+class RunMemoryBudget::Allocator final : public IAllocator {
+ public:
+  Allocator(AllocatorPtr allocator, std::shared_ptr<Usage> usage)
+      : IAllocator(allocator->Info()), allocator_(std::move(allocator)), usage_(std::move(usage)) {}
+
+  void* Alloc(size_t size) override {
+    return ChargedAlloc(size, [this](size_t bytes) { return allocator_->Alloc(bytes); });
+  }
+
+  void* Reserve(size_t size) override {
+    return ChargedAlloc(size, [this](size_t bytes) { return allocator_->Reserve(bytes); });
+  }
+
+  bool IsStreamAware() const override { return allocator_->IsStreamAware(); }
+
+  void* AllocWithStream(size_t size, Stream* stream) override {
+    return ChargedAlloc(size, [this, stream](size_t bytes) { return allocator_->AllocWithStream(bytes, stream); });
+  }
+
+  void ReleaseStream(Stream* stream) override { allocator_->ReleaseStream(stream); }
+
+  void Free(void* p) override {
+    if (p == nullptr) {
+      return;
+    }
+    size_t size = 0;
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      auto it = sizes_.find(p);
+      if (it != sizes_.end()) {
+        size = it->second;
+        sizes_.erase(it);
+      }
+    }
+    allocator_->Free(p);
+    usage_->used_bytes.fetch_sub(size, std::memory_order_relaxed);
+  }
+
+  void GetStats(AllocatorStats* stats) override { allocator_->GetStats(stats); }
+
+ private:
+  template <typename TAlloc>
+  void* ChargedAlloc(size_t size, TAlloc&& alloc) {
+    // charge first so that concurrent allocations of the run cannot exceed the budget together
+    size_t used = usage_->used_bytes.load(std::memory_order_relaxed);
+    do {
+      if (size > usage_->limit_bytes - std::min(used, usage_->limit_bytes)) {
+        ORT_THROW("Run memory budget of ", usage_->limit_bytes, " bytes exceeded: allocating ", size,
+                  " bytes with ", used, " bytes already in use by the run.");
+      }
+    } while (!usage_->used_bytes.compare_exchange_weak(used, used + size, std::memory_order_relaxed));
+
+    void* p = nullptr;
+    auto uncharge_on_failure = gsl::finally([this, &p, size]() {
+      if (p == nullptr) {
+        usage_->used_bytes.fetch_sub(size, std::memory_order_relaxed);
+      }
+    });
+    p = alloc(size);
+    if (p != nullptr) {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      sizes_[p] = size;
+    }
+    return p;
+  }
+
+  AllocatorPtr allocator_;
+  std::shared_ptr<Usage> usage_;
+
+  OrtMutex mutex_;
+  InlinedHashMap<void*, size_t> sizes_;
+};
+
+RunMemoryBudget::RunMemoryBudget(size_t limit_bytes, bool allow_chunking)
+    : usage_(std::make_shared<Usage>(limit_bytes)), allow_chunking_(allow_chunking) {}
+
+Status RunMemoryBudget::Create(const RunOptions& run_options, std::unique_ptr<RunMemoryBudget>& budget) {
+  budget.reset();
+  const std::string& limit_str =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigMemoryBudgetBytes, "");
+  if (limit_str.empty()) {
+    return Status::OK();
+  }
+
+  size_t limit_bytes = 0;
+  if (!TryParseStringWithClassicLocale<size_t>(limit_str, limit_bytes) || limit_bytes == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid run memory budget: ", limit_str,
+                           ". It must be a positive number of bytes.");
+  }
+
+  const bool allow_chunking =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigMemoryBudgetAllowChunking, "1") == "1";
+  budget = std::make_unique<RunMemoryBudget>(limit_bytes, allow_chunking);
+  return Status::OK();
+}
+
+AllocatorPtr RunMemoryBudget::Wrap(const AllocatorPtr& allocator) {
+  if (!allocator) {
+    return allocator;
+  }
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto& wrapped = allocators_[allocator.get()];
+  if (!wrapped) {
+    wrapped = std::make_shared<Allocator>(allocator, usage_);
+  }
+  return wrapped;
+}
+
+size_t RunMemoryBudget::GetAvailableBytes() const noexcept {
+  if (!allow_chunking_) {
+    return std::numeric_limits<size_t>::max();
+  }
+  const size_t used = GetUsedBytes();
+  return used < usage_->limit_bytes ? usage_->limit_bytes - used : 0;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <memory>
+
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+// Limits the memory a single run allocates through the allocators of its execution frame, i.e. for the values of the
+// graph and the temporary buffers of the kernels, see kOrtRunOptionsConfigMemoryBudgetBytes.
+// An allocation that would exceed the budget throws, failing the node allocating it - and so the run - instead of
+// exhausting an arena shared with the concurrent runs. Kernels with large temporary buffers may check
+// GetAvailableBytes() first and run in chunks that fit.
+class RunMemoryBudget {
+ public:
+  RunMemoryBudget(size_t limit_bytes, bool allow_chunking);
+
+  // Creates the budget configured in run_options. Leaves "budget" empty if the run has none.
+  static Status Create(const RunOptions& run_options, std::unique_ptr<RunMemoryBudget>& budget);
+
+  // Returns an allocator that forwards to "allocator" and charges its allocations to the budget.
+  // Allocations are released from the budget when freed, also after the run, e.g. for its outputs.
+  AllocatorPtr Wrap(const AllocatorPtr& allocator);
+
+  size_t GetLimitBytes() const noexcept { return usage_->limit_bytes; }
+  size_t GetUsedBytes() const noexcept { return usage_->used_bytes.load(std::memory_order_relaxed); }
+
+  // Returns the number of bytes that may still be allocated, or the maximum size_t value if the kernels should not
+  // degrade to chunked execution and rather fail when over budget.
+  size_t GetAvailableBytes() const noexcept;
+
+ private:
+  struct Usage {
+    explicit Usage(size_t limit) : limit_bytes(limit) {}
+    const size_t limit_bytes;
+    std::atomic<size_t> used_bytes{0};
+  };
+
+  class Allocator;
+
+  std::shared_ptr<Usage> usage_;
+  const bool allow_chunking_;
+
+  OrtMutex mutex_;
+  InlinedHashMap<const IAllocator*, AllocatorPtr> allocators_;
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunMemoryBudget);
+};
+
+}  // namespace onnxruntime
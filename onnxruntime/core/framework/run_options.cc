@@ -56,6 +56,12 @@ ORT_API_STATUS_IMPL(OrtApis::RunOptionsUnsetTerminate, _Inout_ OrtRunOptions* op
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetCompletionQueue, _Inout_ OrtRunOptions* options,
+                    _In_opt_ OrtRunCompletionQueue* queue) {
+  options->completion_queue = reinterpret_cast<onnxruntime::RunCompletionQueue*>(queue);
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtApis::AddRunConfigEntry, _Inout_ OrtRunOptions* options,
                     _In_z_ const char* config_key, _In_z_ const char* config_value) {
   return onnxruntime::ToOrtStatus(options->config_options.AddConfigEntry(config_key, config_value));
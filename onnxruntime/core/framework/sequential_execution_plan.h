@@ -8,6 +8,7 @@
 #include "core/framework/alloc_kind.h"
 #include "core/framework/data_types.h"
 #include "core/framework/execution_plan_base.h"
+#include "core/framework/tensor_shape.h"
 #include "core/graph/graph.h"
 
 namespace onnxruntime {
@@ -35,6 +36,13 @@ struct AllocPlanPerValue {
   // reused_buffer is valid only if alloc_kind == kReuse. It indicates
   // which OrtValue's buffer must be reused for this OrtValue.
   OrtValueIndex reused_buffer{0};
+  // is_sub_buffer is valid only if alloc_kind == kReuse. It indicates that this OrtValue is a part of the
+  // reused buffer (like an input of Concat placed in Concat's output, or an output of Split placed in Split's
+  // input) that starts sub_buffer_offset bytes into it. The reused buffer has the static shape
+  // reused_buffer_shape, as it may have to be allocated first (a Concat output is allocated with its first input).
+  bool is_sub_buffer{false};
+  size_t sub_buffer_offset{0};
+  TensorShape reused_buffer_shape;
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   IntervalT life_interval{0, 0};
   IntervalT allocate_interval{0, 0};
@@ -4,6 +4,7 @@
 #include "core/framework/sequential_executor.h"
 
 #include <chrono>
+#include <optional>
 #include <thread>
 #include <vector>
 #include <sstream>
@@ -14,7 +15,9 @@
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
+#include "core/framework/recorded_execution.h"
 #include "core/framework/utils.h"
+#include "core/platform/threadpool.h"
 
 #if defined DEBUG_NODE_INPUTS_OUTPUTS
 #include "core/framework/debug_node_inputs_outputs_utils.h"
@@ -178,6 +181,10 @@ class SessionScope {
   {
     if (session_state_.Profiler().IsEnabled()) {
       session_start_ = session_state.Profiler().Start();
+      if (auto* hardware_counters = session_state_.GetHardwareCounters()) {
+        // count the threads created since the last run, e.g. by thread pools created afterwards
+        hardware_counters->RefreshThreads();
+      }
     }
 
     auto& logger = session_state_.Logger();
@@ -280,7 +287,10 @@ class KernelScope {
       : session_scope_(session_scope),
         session_state_(session_scope_.session_state_),
         kernel_context_(kernel_context),
-        kernel_(kernel)
+        kernel_(kernel),
+        latency_histograms_(session_state_.GetLatencyHistograms()),
+        activation_statistics_(session_state_.GetActivationStatistics()),
+        hardware_counters_(session_state_.Profiler().IsEnabled() ? session_state_.GetHardwareCounters() : nullptr)
 #ifdef CONCURRENCY_VISUALIZER
         ,
         span_(session_scope_.series_, "%s.%d", kernel_.Node().OpType().c_str(), kernel_.Node().Index())
@@ -336,6 +346,10 @@ class KernelScope {
     node_compute_range_.Begin();
 #endif
 
+    if (latency_histograms_ != nullptr) {
+      latency_begin_time_ = std::chrono::steady_clock::now();
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& node = kernel.Node();
       node_name_ = node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
@@ -351,6 +365,9 @@ class KernelScope {
       CalculateTotalInputSizes(&kernel_context, &kernel_,
                                input_activation_sizes_, input_parameter_sizes_,
                                node_name_, input_type_shape_);
+      if (hardware_counters_ != nullptr) {
+        hardware_counters_begin_ = hardware_counters_->Read();
+      }
     }
   }
 
@@ -361,6 +378,23 @@ class KernelScope {
     node_compute_range_.End();
 #endif
 
+    profiling::HardwareCounters::Values hardware_counters_delta{};
+    if (hardware_counters_ != nullptr) {
+      hardware_counters_delta = profiling::HardwareCounters::Delta(hardware_counters_begin_,
+                                                                   hardware_counters_->Read());
+    }
+
+    if (latency_histograms_ != nullptr) {
+      const auto latency = std::chrono::steady_clock::now() - latency_begin_time_;
+      latency_histograms_->Record(
+          kernel_.Node().Index(),
+          static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+    }
+
+    if (activation_statistics_ != nullptr) {
+      RecordActivationStatistics();
+    }
+
     if (session_state_.Profiler().IsEnabled()) {
       auto& profiler = session_state_.Profiler();
       std::string output_type_shape_;
@@ -381,6 +415,18 @@ class KernelScope {
                                          {"thread_scheduling_stats",
                                           concurrency::ThreadPool::StopProfiling(session_state_.GetThreadPool())},
                                      });
+      if (hardware_counters_ != nullptr) {
+        hardware_counters_->RecordOpType(kernel_.Node().OpType(), hardware_counters_delta);
+        profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                       node_name_ + "_hardware_counters",
+                                       kernel_begin_time_,
+                                       {
+                                           {"op_name", kernel_.KernelDef().OpName()},
+                                           {"provider", kernel_.KernelDef().Provider()},
+                                           {"node_index", std::to_string(kernel_.Node().Index())},
+                                           {"counters", profiling::HardwareCounters::ToJson(hardware_counters_delta)},
+                                       });
+      }
       auto sync_time_begin = profiler.Start();
       profiler.EndTimeAndRecordEvent(profiling::NODE_EVENT,
                                      node_name_ + "_fence_after",
@@ -408,6 +454,27 @@ class KernelScope {
   }  //~KernelScope
 
  private:
+  // Records the float outputs on CPU. Outputs on other devices are skipped rather than copied.
+  void RecordActivationStatistics() {
+    const auto& node = kernel_.Node();
+    const auto& node_index_info = session_state_.GetNodeIndexInfo();
+    // NodeIndexInfo has the inputs, implicit inputs and outputs of the node, in that order
+    const int output_offset = node_index_info.GetNodeOffset(node.Index()) +
+                              static_cast<int>(node.InputDefs().size() + node.ImplicitInputDefs().size());
+    for (int i = 0, end = kernel_context_.OutputCount(); i < end; ++i) {
+      const OrtValue* value = kernel_context_.GetOutputMLValue(i);
+      if (value == nullptr || !value->IsTensor()) {
+        continue;
+      }
+      const auto& tensor = value->Get<Tensor>();
+      const int ort_value_idx = node_index_info.GetMLValueIndex(output_offset + i);
+      if (ort_value_idx != NodeIndexInfo::kInvalidEntry && tensor.IsDataType<float>() &&
+          tensor.Location().device.Type() == OrtDevice::CPU) {
+        activation_statistics_->Record(static_cast<size_t>(ort_value_idx), tensor.DataAsSpan<float>());
+      }
+    }
+  }
+
   TimePoint kernel_begin_time_;
   SessionScope& session_scope_;
   const SessionState& session_state_;
@@ -415,6 +482,14 @@ class KernelScope {
   OpKernelContextInternal& kernel_context_;
   const OpKernel& kernel_;
 
+  profiling::LatencyHistograms* latency_histograms_;
+  std::chrono::steady_clock::time_point latency_begin_time_;
+
+  ActivationStatistics* activation_statistics_;
+
+  profiling::HardwareCounters* hardware_counters_;
+  profiling::HardwareCounters::Values hardware_counters_begin_{};
+
   size_t input_activation_sizes_{};
   size_t input_parameter_sizes_{};
   size_t total_output_sizes_{};
@@ -449,12 +524,22 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
     return Status::OK();
   }
   // TODO: set terminate flag from run_option
-  OpKernelContextInternal kernel_ctx(ctx.GetSessionState(),
-                                     ctx.GetExecutionFrame(),
-                                     *p_kernel,
-                                     ctx.GetLogger(),
-                                     terminate_flag,
-                                     ctx.GetDeviceStream(stream_idx));
+  // let the runs with a higher priority use the threads first, between nodes the run holds no intermediate locks
+  concurrency::ThreadPool::YieldToHigherPriorityRuns();
+  // when recording, the kernel context is kept by the recording to replay the kernel
+  std::optional<OpKernelContextInternal> local_kernel_ctx;
+  if (ctx.GetRecordedExecution() == nullptr) {
+    local_kernel_ctx.emplace(ctx.GetSessionState(),
+                             ctx.GetExecutionFrame(),
+                             *p_kernel,
+                             ctx.GetLogger(),
+                             terminate_flag,
+                             ctx.GetDeviceStream(stream_idx),
+                             ctx.GetSessionState().GetStreamThreadPool(stream_idx));
+  }
+  OpKernelContextInternal& kernel_ctx = local_kernel_ctx.has_value()
+                                            ? *local_kernel_ctx
+                                            : ctx.GetRecordedExecution()->AddKernelInvocation(*p_kernel, stream_idx);
   onnxruntime::Status status;
   auto& logger = ctx.GetLogger();
   if (p_kernel->IsAsync()) {
@@ -531,7 +616,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 #endif
                                    const bool& terminate_flag,
                                    const bool only_execute_path_to_fetches,
-                                   bool single_thread_mode) {
+                                   bool single_thread_mode,
+                                   RunMemoryBudget* memory_budget) {
   auto* execution_plan = session_state.GetExecutionPlan();
   VLOGS(logger, 0) << "Number of streams: " << execution_plan->execution_plan.size();
   int32_t valid_streams = 0;
@@ -553,7 +639,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              fetches,
                              fetch_allocators,
                              logger,
-                             single_thread_mode);
+                             single_thread_mode,
+                             memory_budget);
 #else
   StreamExecutionContext ctx(session_state,
                              valid_streams,
@@ -563,7 +650,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
                              fetches,
                              fetch_allocators,
                              logger,
-                             single_thread_mode);
+                             single_thread_mode,
+                             memory_budget);
 #endif
 #ifdef ENABLE_TRAINING
   if (only_execute_path_to_fetches) {
@@ -578,18 +666,26 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
+  // the first stream holds the critical path of the graph, run it on the calling thread
+  // instead of leaving that thread waiting for the inter-op threads.
+  std::optional<size_t> inline_stream;
   for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
     if (execution_plan->execution_plan[i]->steps_.empty()) {
       // execution context is initialized with number of valid streams
       // for invalid stream (0 steps), it doesn't count in number of tasks
       // so don't need to invoke CompleteTask here
       // ctx.CompleteTask();
+    } else if (tp != nullptr && !inline_stream.has_value()) {
+      inline_stream = i;
     } else {
       concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
         RunSince(i, ctx, session_scope, terminate_flag, 0);
       });
     }
   }
+  if (inline_stream.has_value()) {
+    RunSince(*inline_stream, ctx, session_scope, terminate_flag, 0);
+  }
 
   ctx.WaitAll();
   ORT_RETURN_IF_ERROR(ctx.TaskStatus());
@@ -613,6 +709,22 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
   return Status::OK();
 }
 
+onnxruntime::Status RecordThePlan(StreamExecutionContext& ctx, const bool& terminate_flag) {
+  SessionScope session_scope(ctx.GetSessionState(), ctx.GetExecutionFrame());
+
+  // as in single thread mode, the streams are run one after the other and a stream waiting for another one is
+  // resumed by that stream.
+  const auto& execution_plan = ctx.GetSessionState().GetExecutionPlan()->execution_plan;
+  for (size_t i = 0; i < execution_plan.size(); ++i) {
+    if (!execution_plan[i]->steps_.empty()) {
+      RunSince(i, ctx, session_scope, terminate_flag, 0);
+    }
+  }
+
+  ctx.WaitAll();
+  return ctx.TaskStatus();
+}
+
 #ifdef ENABLE_TRAINING
 onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
                                           std::vector<OrtValue>& feeds,
@@ -24,6 +24,7 @@ namespace onnxruntime {
 class StreamExecutionContext;
 class DeviceStreamCollection;
 class SessionScope;
+class RunMemoryBudget;
 
 #ifdef ENABLE_TRAINING
 using OrtValueCache = InlinedHashMap<std::string, OrtValue>;
@@ -46,7 +47,12 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 #endif
                                    const bool& terminate_flag,
                                    const bool only_execute_path_to_fetches,
-                                   bool single_thread_mode);
+                                   bool single_thread_mode,
+                                   // optional budget to charge the allocations of the run to
+                                   RunMemoryBudget* memory_budget = nullptr);
+
+// Runs the execution plan with ctx on the calling thread while its RecordedExecution records the kernel invocations.
+onnxruntime::Status RecordThePlan(StreamExecutionContext& ctx, const bool& terminate_flag);
 
 #ifdef ENABLE_TRAINING
 onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
@@ -3,11 +3,18 @@
 
 #include "core/framework/session_state.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <optional>
 #include <sstream>
+#include <string_view>
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
+#include "core/common/string_utils.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
 #include "core/framework/node_index_info.h"
@@ -87,6 +94,21 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+  const std::string shape_buckets =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternShapeBuckets, "");
+  for (const auto& bucket_str : utils::SplitString(shape_buckets, ",")) {
+    int64_t bucket = 0;
+    ORT_ENFORCE(TryParseStringWithClassicLocale(bucket_str, bucket) && bucket > 0 &&
+                    (mem_pattern_shape_buckets_.empty() || bucket > mem_pattern_shape_buckets_.back()),
+                "Invalid ", kOrtSessionOptionsConfigMemoryPatternShapeBuckets, " '", shape_buckets,
+                "', expected ascending positive integers separated by commas.");
+    mem_pattern_shape_buckets_.push_back(bucket);
+  }
+  const std::string cache_max_entries =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheMaxEntries, "0");
+  ORT_ENFORCE(TryParseStringWithClassicLocale(cache_max_entries, mem_pattern_cache_max_entries_),
+              "Invalid ", kOrtSessionOptionsConfigMemoryPatternCacheMaxEntries, " '", cache_max_entries,
+              "', expected a non-negative integer.");
   if (parent_allocators) {
     allocators_ = parent_allocators;
   } else {
@@ -222,7 +244,8 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1);
-    for (const auto& node : nodes) {
+
+    auto create_kernel = [this, &kernel_registry_manager](const Node& node) {
       // construct and save the kernels
       const KernelCreateInfo& kci = GetNodeKernelCreateInfo(node.Index());
 
@@ -231,7 +254,43 @@ Status SessionState::CreateKernels(const KernelRegistryManager& kernel_registry_
       const IExecutionProvider& exec_provider = *execution_providers_.Get(exec_provider_name);
 
       // assumes vector is already resize()'ed to the number of nodes in the graph
-      ORT_RETURN_IF_ERROR(kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]));
+      return kernel_registry_manager.CreateKernel(node, exec_provider, *this, kci, session_kernels_[node.Index()]);
+    };
+
+    // The kernels of the CPU execution provider only read the session state when they are created, so they can be
+    // created concurrently. Other providers may e.g. register compiled functions, so their kernels are created
+    // on the calling thread.
+    InlinedVector<const Node*> parallel_nodes;
+    const bool parallel_kernel_creation =
+        sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigParallelKernelCreation, "0") == "1";
+    concurrency::ThreadPool* tp = inter_op_thread_pool_ != nullptr ? inter_op_thread_pool_ : thread_pool_;
+    for (const auto& node : nodes) {
+      if (parallel_kernel_creation && concurrency::ThreadPool::DegreeOfParallelism(tp) > 1 &&
+          node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        parallel_nodes.push_back(&node);
+      } else {
+        ORT_RETURN_IF_ERROR(create_kernel(node));
+      }
+    }
+
+    if (!parallel_nodes.empty()) {
+      std::vector<Status> statuses(parallel_nodes.size());
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          tp, static_cast<std::ptrdiff_t>(parallel_nodes.size()), [&](std::ptrdiff_t i) {
+            Status& status = statuses[i];
+            ORT_TRY {
+              status = create_kernel(*parallel_nodes[i]);
+            }
+            ORT_CATCH(const std::exception& ex) {
+              ORT_HANDLE_EXCEPTION([&]() {
+                status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception creating kernel for node '",
+                                         parallel_nodes[i]->Name(), "': ", ex.what());
+              });
+            }
+          });
+      for (const auto& status : statuses) {
+        ORT_RETURN_IF_ERROR(status);
+      }
     }
   }
   node_index_info_.emplace(*graph_viewer_, ort_value_name_idx_map_);
@@ -314,6 +373,302 @@ const std::unordered_map<int, OrtValue>& SessionState::GetConstantInitializedTen
   return constant_initialized_tensors_;
 }
 
+Status SessionState::LoadLazyInitializedTensors() const {
+  if (lazy_initialized_tensors_.empty() || lazy_initialized_tensors_loaded_.load(std::memory_order_acquire)) {
+    return Status::OK();
+  }
+
+  std::lock_guard<OrtMutex> lock(lazy_initialized_tensors_lock_);
+  if (!lazy_initialized_tensors_loaded_.load(std::memory_order_relaxed)) {
+    // the initializers and kernels of this graph are not used by anyone else until they are loaded, as every
+    // execution frame of this graph waits for them here
+    ORT_RETURN_IF_ERROR(const_cast<SessionState*>(this)->LoadLazyInitializedTensorsImpl());
+    lazy_initialized_tensors_loaded_.store(true, std::memory_order_release);
+  }
+
+  return Status::OK();
+}
+
+Status SessionState::LoadLazyInitializedTensorsImpl() {
+  const bool disable_prepacking =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0") == "1";
+  const bool use_device_allocator_for_initializers =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
+
+  // load all the initializers before pre-packing any, so a failure to load them leaves the session state unchanged
+  InlinedVector<OrtValue> values(lazy_initialized_tensors_.size());
+  for (size_t i = 0; i < lazy_initialized_tensors_.size(); ++i) {
+    const auto& [ort_value_idx, tensor_proto] = lazy_initialized_tensors_[i];
+    const OrtDevice& location = p_seq_exec_plan_->GetLocation(ort_value_idx);
+    ORT_RETURN_IF_ERROR(session_state_utils::LoadInitializedTensor(
+        Env::Default(), lazy_initialized_tensors_graph_location_, tensor_proto, GetAllocator(location),
+        GetAllocator(OrtDevice()), data_transfer_mgr_, use_device_allocator_for_initializers, values[i]));
+  }
+
+  // the inputs of the nodes by name, and the names used by subgraphs, so each initializer is looked up once
+  InlinedHashMap<std::string_view, InlinedVector<std::pair<const Node*, int>>> node_inputs;
+  InlinedHashSet<std::string_view> implicit_inputs;
+  for (const auto& node : graph_viewer_->Nodes()) {
+    for (const NodeArg* implicit_input_def : node.ImplicitInputDefs()) {
+      implicit_inputs.insert(implicit_input_def->Name());
+    }
+    int input_idx = 0;
+    for (const NodeArg* input_def : node.InputDefs()) {
+      if (input_def->Exists()) {
+        node_inputs[input_def->Name()].emplace_back(&node, input_idx);
+      }
+      input_idx++;
+    }
+  }
+
+  // serialize the use of the pre-packed weights container with the other sessions sharing it
+  std::unique_lock<OrtMutex> prepacked_weights_container_lock;
+  if (prepacked_weights_container_ != nullptr && !disable_prepacking) {
+    prepacked_weights_container_lock = std::unique_lock<OrtMutex>(prepacked_weights_container_->mutex_);
+  }
+
+  for (size_t i = 0; i < lazy_initialized_tensors_.size(); ++i) {
+    const auto& [ort_value_idx, tensor_proto] = lazy_initialized_tensors_[i];
+    const std::string& name = tensor_proto.name();
+    const Tensor& tensor = values[i].Get<Tensor>();
+
+    // the initializer is released if all the kernels of this graph using it pre-packed it
+    bool keep_initializer = implicit_inputs.count(name) > 0;
+    if (auto inputs = node_inputs.find(name); inputs != node_inputs.end()) {
+      for (const auto& [node, input_idx] : inputs->second) {
+        bool is_packed = false;
+        if (!disable_prepacking) {
+          OpKernel* kernel = GetMutableKernel(node->Index());
+          if (prepacked_weights_container_ != nullptr && node->GetExecutionProviderType() == kCpuExecutionProvider) {
+            ORT_RETURN_IF_ERROR(PrepackUsingPrepackedWeightsContainer(*node, *kernel, input_idx, tensor, is_packed));
+          } else {
+            AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+            ORT_RETURN_IF_ERROR(kernel->PrePack(tensor, input_idx, session_cpu_alloc, is_packed, nullptr));
+          }
+        }
+
+        if (is_packed) {
+          ++number_of_prepacks_counter_;
+        } else {
+          keep_initializer = true;
+        }
+      }
+    }
+
+    if (keep_initializer) {
+      ORT_RETURN_IF_ERROR(AddInitializedTensor(ort_value_idx, values[i], nullptr, true, false));
+    } else {
+      released_initialized_tensors_.insert_or_assign(ort_value_idx, std::make_pair(tensor.DataType(), tensor.Shape()));
+    }
+  }
+
+  return Status::OK();
+}
+
+Status SessionState::UpdateInitializedTensors(gsl::span<const std::string> names, gsl::span<const OrtValue> values) {
+  ORT_RETURN_IF_NOT(names.size() == values.size(), "Got ", values.size(), " values for ", names.size(),
+                    " initializers.");
+  // the lazily loaded initializers would overwrite the updated ones
+  ORT_RETURN_IF_ERROR(LoadLazyInitializedTensors());
+
+  // check and copy all the values before replacing any initializer, so a failure leaves the session state unchanged
+  InlinedVector<int> ort_value_idxs;
+  ort_value_idxs.reserve(names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    const std::string& name = names[i];
+    int ort_value_idx = -1;
+    const bool is_value = ort_value_name_idx_map_.GetIdx(name, ort_value_idx).IsOK();
+    const auto initializer = is_value ? initialized_tensors_.find(ort_value_idx) : initialized_tensors_.end();
+    const auto released = is_value ? released_initialized_tensors_.find(ort_value_idx)
+                                   : released_initialized_tensors_.end();
+    if (initializer == initialized_tensors_.end() && released == released_initialized_tensors_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "'", name, "' is not an initializer of the graph.");
+    }
+    ORT_RETURN_IF(std::find(ort_value_idxs.begin(), ort_value_idxs.end(), ort_value_idx) != ort_value_idxs.end(),
+                  "The initializer '", name, "' is updated more than once.");
+
+#if !defined(DISABLE_SPARSE_TENSORS)
+    ORT_RETURN_IF(IsSparseInitializer(ort_value_idx), "The sparse initializer '", name, "' can't be updated.");
+#endif
+    // a shared initializer is owned by the caller and can be used by other sessions
+    ORT_RETURN_IF(sess_options_.initializers_to_share_map.count(name) > 0,
+                  "The shared initializer '", name, "' can't be updated.");
+
+    ORT_RETURN_IF_NOT(values[i].IsTensor(), "The value of the initializer '", name, "' is not a tensor.");
+    const Tensor& value = values[i].Get<Tensor>();
+    ORT_RETURN_IF(value.IsDataTypeString(), "The string initializer '", name, "' can't be updated.");
+
+    const MLDataType elem_type = initializer != initialized_tensors_.end()
+                                     ? initializer->second.Get<Tensor>().DataType()
+                                     : released->second.first;
+    const TensorShape& shape = initializer != initialized_tensors_.end() ? initializer->second.Get<Tensor>().Shape()
+                                                                         : released->second.second;
+    ORT_RETURN_IF_NOT(value.DataType() == elem_type && value.Shape() == shape,
+                      "The value of the initializer '", name, "' of type ", DataTypeImpl::ToString(elem_type),
+                      " and shape ", shape, " has the type ", DataTypeImpl::ToString(value.DataType()),
+                      " and shape ", value.Shape(), ".");
+    ort_value_idxs.push_back(ort_value_idx);
+  }
+
+  // the execution frames hold the previous values, so the new values are copied into tensors of their own
+  InlinedVector<OrtValue> initializers(names.size());
+  for (size_t i = 0; i < names.size(); ++i) {
+    const Tensor& value = values[i].Get<Tensor>();
+    Tensor::InitOrtValue(value.DataType(), value.Shape(),
+                         GetAllocator(p_seq_exec_plan_->GetLocation(ort_value_idxs[i])), initializers[i]);
+    ORT_RETURN_IF_ERROR(data_transfer_mgr_.CopyTensor(value, *initializers[i].GetMutable<Tensor>()));
+  }
+
+  // the previous state of the initializers, to restore it if pre-packing fails
+  struct PreviousInitializer {
+    std::optional<OrtValue> value;
+    bool constant;
+    std::optional<std::pair<MLDataType, TensorShape>> released;
+  };
+  InlinedVector<PreviousInitializer> previous;
+  previous.reserve(names.size());
+  for (const int ort_value_idx : ort_value_idxs) {
+    PreviousInitializer& p = previous.emplace_back();
+    if (auto it = initialized_tensors_.find(ort_value_idx); it != initialized_tensors_.end()) {
+      p.value = it->second;
+    }
+    p.constant = constant_initialized_tensors_.count(ort_value_idx) > 0;
+    if (auto it = released_initialized_tensors_.find(ort_value_idx); it != released_initialized_tensors_.end()) {
+      p.released = it->second;
+    }
+  }
+
+  // the kernels may read the other constant initializers while pre-packing, so all the maps are updated first
+  for (size_t i = 0; i < names.size(); ++i) {
+    const int ort_value_idx = ort_value_idxs[i];
+    initialized_tensors_.insert_or_assign(ort_value_idx, initializers[i]);
+    if (previous[i].constant || previous[i].released.has_value()) {
+      constant_initialized_tensors_.insert_or_assign(ort_value_idx, initializers[i]);
+      released_initialized_tensors_.erase(ort_value_idx);
+    }
+  }
+
+  const bool disable_prepacking =
+      sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0") == "1";
+
+  // the kernel inputs pre-packed with the new values, by update
+  InlinedVector<InlinedVector<std::pair<OpKernel*, int>>> packed_inputs(names.size());
+  InlinedVector<bool> keep_initializers(names.size(), true);
+  Status status;
+  for (size_t i = 0; i < names.size() && status.IsOK(); ++i) {
+    // an overridable initializer is never pre-packed
+    if (disable_prepacking || !(previous[i].constant || previous[i].released.has_value())) {
+      continue;
+    }
+    keep_initializers[i] = false;
+    status = PrePackUpdatedInitializedTensor(names[i], initializers[i].Get<Tensor>(), keep_initializers[i],
+                                             packed_inputs[i]);
+  }
+
+  if (!status.IsOK()) {
+    // restore the previous values, and pre-pack them again for the kernels that pre-packed the new ones. The
+    // previous value of a released initializer is not held anymore, so its kernels keep the new pre-packed value.
+    InlinedVector<std::string> not_restored;
+    for (size_t i = 0; i < names.size(); ++i) {
+      const int ort_value_idx = ort_value_idxs[i];
+      const PreviousInitializer& p = previous[i];
+      if (!p.value.has_value()) {
+        if (!packed_inputs[i].empty()) {
+          not_restored.push_back(names[i]);
+        }
+        initialized_tensors_.erase(ort_value_idx);
+        constant_initialized_tensors_.erase(ort_value_idx);
+        released_initialized_tensors_.insert_or_assign(ort_value_idx, *p.released);
+        continue;
+      }
+
+      initialized_tensors_.insert_or_assign(ort_value_idx, *p.value);
+      if (p.constant) {
+        constant_initialized_tensors_.insert_or_assign(ort_value_idx, *p.value);
+      }
+      for (const auto& [kernel, input_idx] : packed_inputs[i]) {
+        AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+        bool is_packed = false;
+        if (!kernel->PrePack(p.value->Get<Tensor>(), input_idx, session_cpu_alloc, is_packed, nullptr).IsOK() &&
+            (not_restored.empty() || not_restored.back() != names[i])) {
+          not_restored.push_back(names[i]);
+        }
+      }
+    }
+
+    if (!not_restored.empty()) {
+      std::ostringstream names_stream;
+      for (const auto& name : not_restored) {
+        names_stream << (&name == &not_restored.front() ? "" : ", ") << "'" << name << "'";
+      }
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, status.ErrorMessage(),
+                             " The kernels could not be restored with the previous values of the initializers ",
+                             names_stream.str(), ".");
+    }
+    return status;
+  }
+
+  for (size_t i = 0; i < names.size(); ++i) {
+    if (!keep_initializers[i]) {
+      const Tensor& tensor = initializers[i].Get<Tensor>();
+      released_initialized_tensors_.insert_or_assign(ort_value_idxs[i],
+                                                     std::make_pair(tensor.DataType(), tensor.Shape()));
+      initialized_tensors_.erase(ort_value_idxs[i]);
+      constant_initialized_tensors_.erase(ort_value_idxs[i]);
+    }
+  }
+
+  if (!names.empty()) {
+    ++initialized_tensors_version_;
+  }
+
+  return Status::OK();
+}
+
+Status SessionState::PrePackUpdatedInitializedTensor(const std::string& name, const Tensor& tensor,
+                                                     bool& keep_initializer,
+                                                     InlinedVector<std::pair<OpKernel*, int>>& packed_inputs) {
+  for (const NodeArg* output_def : graph_viewer_->GetOutputs()) {
+    keep_initializer = keep_initializer || output_def->Name() == name;
+  }
+
+  for (const auto& node : graph_viewer_->Nodes()) {
+    for (const NodeArg* implicit_input_def : node.ImplicitInputDefs()) {
+      keep_initializer = keep_initializer || implicit_input_def->Name() == name;
+    }
+
+    int input_idx = 0;
+    for (const NodeArg* input_def : node.InputDefs()) {
+      if (input_def->Exists() && input_def->Name() == name) {
+        // the kernel may have used pre-packed buffers shared with other sessions, it now gets buffers of its own
+        OpKernel* kernel = GetMutableKernel(node.Index());
+        AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+        bool is_packed = false;
+        ORT_RETURN_IF_ERROR(kernel->PrePack(tensor, input_idx, session_cpu_alloc, is_packed, nullptr));
+
+        if (is_packed) {
+          ++number_of_prepacks_counter_;
+          packed_inputs.emplace_back(kernel, input_idx);
+        } else {
+          keep_initializer = true;
+        }
+      }
+      input_idx++;
+    }
+  }
+
+  for (auto& [node_index, subgraph_session_states] : subgraph_session_states_) {
+    for (auto& [attribute_name, subgraph_session_state] : subgraph_session_states) {
+      if (subgraph_session_state->graph_.IsOuterScopeValue(name)) {
+        ORT_RETURN_IF_ERROR(subgraph_session_state->PrePackUpdatedInitializedTensor(name, tensor, keep_initializer,
+                                                                                    packed_inputs));
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 #if !defined(DISABLE_SPARSE_TENSORS)
 bool SessionState::IsSparseInitializer(int ort_value_index) const {
   return sparse_initialized_tensors_.count(ort_value_index) > 0;
@@ -390,10 +745,62 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   ss_1 << op_type;
   ss_1 << "+";
   ss_1 << std::to_string(pre_packed_weights.GetHash());
+  // The buffer sizes depend on the packing format of the kernel (e.g. the MLAS compute type of MatMulNBits),
+  // so buffers packed in different formats never share a key even if their hashes collide.
+  for (size_t buffer_size : pre_packed_weights.buffer_sizes_) {
+    ss_1 << "+" << buffer_size;
+  }
 
   return ss_1.str();
 }
 
+Status SessionState::PrepackUsingPrepackedWeightsContainer(const Node& node, OpKernel& kernel, int input_idx,
+                                                           const Tensor& weight, bool& is_packed) {
+  AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
+  ORT_ENFORCE(allocator_for_caching.get() != nullptr);
+
+  PrePackedWeights weights_to_be_filled_in;
+  // The reason we invoke PrePack() before looking into the container for any pre-packed weight
+  // cached by another instance of the same op_type (for the same constant initializer) is because
+  // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
+  // weight with the pre-packed weight generated by this instance of the same op_type because other static
+  // properties of the node like node attributes could play a role in the pre-packed weights' contents.
+  ORT_RETURN_IF_ERROR(kernel.PrePack(weight, input_idx, allocator_for_caching, is_packed, &weights_to_be_filled_in));
+  if (!is_packed) {
+    return Status::OK();
+  }
+
+  // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
+  ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
+              " doesn't have an implementation that can cache computed pre-packed weights");
+
+  const auto& op_type = node.OpType();
+
+  // Sanity check
+  // TODO: Check if some version of the ONNX IR allows op_type to be empty
+  ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
+
+  // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
+  // that we just got by invoking PrePack() on this kernel.
+  const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
+                                                                                         weights_to_be_filled_in);
+
+  if (prepacked_weights_container_->HasWeight(prepacked_weights_container_key)) {
+    LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: "
+                        << node.InputDefs()[input_idx]->Name() << " used in the node: " << node.Name()
+                        << " which is of op type: " << node.OpType();
+    ++used_shared_pre_packed_weights_counter_;
+  } else if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key,
+                                                        std::move(weights_to_be_filled_in))) {
+    // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
+  }
+
+  return KernelUseSharedPrePackedBuffers(kernel, input_idx,
+                                         prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
+                                         node.Name());
+}
+
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
   auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
@@ -423,59 +830,12 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                 if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
                     node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
 
-                  AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
-                  ORT_ENFORCE(allocator_for_caching.get() != nullptr);
-
-                  PrePackedWeights weights_to_be_filled_in;
-                  // The reason we invoke PrePack() before looking into the container for any pre-packed weight
-                  // cached by another instance of the same op_type (for the same constant initializer) is because
-                  // to truly know if we can use a cached pre-packed weight, we would have to compare the cached pre-packed
-                  // weight with the pre-packed weight generated by this instance of the same op_type because other static
-                  // properties of the node like node attributes could play a role in the pre-packed weights' contents.
-                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, allocator_for_caching,
-                                                      is_packed,
-                                                      &weights_to_be_filled_in));
-
-                  if (is_packed) {
-                    // BUG CHECK: Ensure that the kernel has filled in the pre-packed weight to be cached if the weight was pre-packed
-                    ORT_ENFORCE(weights_to_be_filled_in.buffers_.size() > 0, "The kernel corresponding to the node ", node.Name(),
-                                " doesn't have an implementation that can cache computed pre-packed weights");
-
-                    const auto& op_type = node.OpType();
-
-                    // Sanity check
-                    // TODO: Check if some version of the ONNX IR allows op_type to be empty
-                    ORT_ENFORCE(!op_type.empty(), "The op type of a node cannot be empty");
-
-                    // The key for the pre-packed weights container lookup is the op_type + hash of the prepacked-weight
-                    // that we just got by invoking PrePack() on this kernel.
-
-                    const std::string& prepacked_weights_container_key = GenerateKeyForPrepackedWeightsMap(op_type,
-                                                                                                           weights_to_be_filled_in);
-
-                    bool container_contains_packed_weight = prepacked_weights_container_->HasWeight(prepacked_weights_container_key);
-
-                    if (container_contains_packed_weight) {
-                      LOGS(logger_, INFO) << "Using cached version of pre-packed weight for constant initializer: " << input_name
-                                          << " used in the node: " << node.Name() << " which is of op type: " << node.OpType();
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-
-                      ++used_shared_pre_packed_weights_counter_;
-                    } else {  // container doesn't contain the pre-packed weight - so write into it for sharing across kernel instances
-
-                      if (!prepacked_weights_container_->WriteWeight(prepacked_weights_container_key, std::move(weights_to_be_filled_in))) {
-                        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to write the provided PrePackedWeights instance into the container");
-                      }
-
-                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx,
-                                                                          prepacked_weights_container_->GetWeight(prepacked_weights_container_key),
-                                                                          node.Name()));
-                    }
-                  }
-
+                  ORT_RETURN_IF_ERROR(PrepackUsingPrepackedWeightsContainer(node, *kernel, input_idx,
+                                                                            const_initialized_tensor, is_packed));
+                } else if (prepacked_weights_file_ != nullptr &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  ORT_RETURN_IF_ERROR(PrepackUsingPrepackedWeightsFile(*kernel, input_idx, const_initialized_tensor,
+                                                                       is_packed));
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = GetAllocator(kernel->Info().GetDevice(OrtMemType::OrtMemTypeDefault));
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -489,6 +849,9 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
 
                   if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
                     // release the constant initialized tensor
+                    st->released_initialized_tensors_.insert_or_assign(
+                        ort_value_idx, std::make_pair(const_initialized_tensor.DataType(),
+                                                      const_initialized_tensor.Shape()));
                     st->initialized_tensors_.erase(ort_value_idx);
                     constant_initialized_tensors.erase(ort_value_idx);
                   }
@@ -511,26 +874,174 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
     return Status::OK();
   };
 
+  // Only the weights of the main graph are saved to the pre-packed weights file, as node names are not unique
+  // across subgraphs.
+  const std::string prepacked_weights_file_path =
+      Parent() == nullptr
+          ? sess_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsFilePath, "")
+          : "";
+  if (!prepacked_weights_file_path.empty()) {
+    prepacked_weights_file_ = std::make_unique<PrepackedWeightsFile>(
+        PrepackedWeightsFile::GetIdentity(sess_options_.config_options));
+    std::error_code error_code;
+    if (std::filesystem::exists(ToPathString(prepacked_weights_file_path), error_code)) {
+      auto status = prepacked_weights_file_->Load(ToPathString(prepacked_weights_file_path));
+      if (!status.IsOK()) {
+        LOGS(logger_, WARNING) << "Pre-packing the weights as the pre-packed weights file "
+                               << prepacked_weights_file_path << " can not be used: " << status.ErrorMessage();
+      }
+    }
+  }
+
   bool should_cache_prepacked_weights_for_shared_initializers = (prepacked_weights_container_ != nullptr);
 
   if (should_cache_prepacked_weights_for_shared_initializers) {
     // serialize calls to the method that looks up the container, calls UseCachedPrePackedWeight/PrePack
     // and writes pre-packed weights to the container
     std::lock_guard<onnxruntime::OrtMutex> l(prepacked_weights_container_->mutex_);
-    return prepacked_constant_weights(true);
+    ORT_RETURN_IF_ERROR(prepacked_constant_weights(true));
   } else {
-    return prepacked_constant_weights(false);
+    ORT_RETURN_IF_ERROR(prepacked_constant_weights(false));
+  }
+
+  if (prepacked_weights_file_ != nullptr && prepacked_weights_file_->HasAddedWeights()) {
+    // Failing to save the file only costs the next session the pre-packing, so it does not fail this one.
+    auto status = prepacked_weights_file_->Save(ToPathString(prepacked_weights_file_path));
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to save the pre-packed weights file " << prepacked_weights_file_path << ": "
+                             << status.ErrorMessage();
+    } else {
+      LOGS(logger_, INFO) << "Saved the pre-packed weights file " << prepacked_weights_file_path;
+    }
   }
+
+  return Status::OK();
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
+Status SessionState::PrepackUsingPrepackedWeightsFile(OpKernel& kernel, int input_idx, const Tensor& weight,
+                                                      bool& is_packed) {
+  const Node& node = kernel.Node();
+  const std::string key = PrepackedWeightsFile::GetWeightKey(node, input_idx, weight);
+  AllocatorPtr session_cpu_alloc = GetAllocator(kernel.Info().GetDevice(OrtMemType::OrtMemTypeDefault));
+
+  if (const auto* prepacked_weights = prepacked_weights_file_->GetWeight(key)) {
+    std::vector<BufferUniquePtr> serialized_prepacked_buffers;
+    serialized_prepacked_buffers.reserve(prepacked_weights->buffers_.size());
+    for (const auto& prepacked_buffer : prepacked_weights->buffers_) {
+      // BufferDeleter is nullptr because the buffers are owned by the pre-packed weights file
+      serialized_prepacked_buffers.emplace_back(prepacked_buffer.get(), BufferDeleter(nullptr));
+    }
+
+    bool used_serialized_buffers = false;
+    ORT_RETURN_IF_ERROR(kernel.UseSerializedPrePackedBuffers(weight, serialized_prepacked_buffers, input_idx,
+                                                             used_serialized_buffers));
+    if (used_serialized_buffers) {
+      is_packed = true;
+      ++used_serialized_pre_packed_weights_counter_;
+      return Status::OK();
+    }
+
+    // The kernel can not restore the weight from the file, it is pre-packed as usual.
+    return kernel.PrePack(weight, input_idx, session_cpu_alloc, is_packed, nullptr);
+  }
+
+  // Pre-pack the weight into buffers owned by the file, so that they can be saved after all weights are pre-packed.
+  PrePackedWeights prepacked_weights;
+  ORT_RETURN_IF_ERROR(kernel.PrePack(weight, input_idx, session_cpu_alloc, is_packed, &prepacked_weights));
+  if (is_packed && !prepacked_weights.buffers_.empty()) {
+    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(kernel, input_idx,
+                                                        prepacked_weights_file_->AddWeight(key,
+                                                                                           std::move(prepacked_weights)),
+                                                        node.Name()));
+  }
+  return Status::OK();
+}
+
+namespace {
+// Rounds dim up to the smallest bucket boundary not less than it. Dims beyond the last boundary are not rounded.
+int64_t RoundUpToShapeBucket(int64_t dim, gsl::span<const int64_t> buckets) {
+  auto bucket = std::lower_bound(buckets.begin(), buckets.end(), dim);
+  return bucket == buckets.end() ? dim : *bucket;
+}
+
+// The rank of each input followed by its dims.
+InlinedVector<int64_t> GetInputDims(gsl::span<const OrtValue> tensor_inputs) {
+  InlinedVector<int64_t> input_dims;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    input_dims.push_back(static_cast<int64_t>(dims.size()));
+    input_dims.insert(input_dims.end(), dims.begin(), dims.end());
+  }
+  return input_dims;
+}
+
+// Whether the dims of tensor_inputs match input_dims, which are in the format of GetInputDims(), with
+// match(dim, input_dims_dim) for each dim. Compares in place as this is done by every run using the memory patterns.
+template <typename DimMatch>
+bool InputDimsMatch(gsl::span<const OrtValue> tensor_inputs, gsl::span<const int64_t> input_dims, DimMatch match) {
+  size_t i = 0;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    if (input_dims.size() - i < dims.size() + 1 || input_dims[i] != static_cast<int64_t>(dims.size())) {
+      return false;
+    }
+    ++i;
+    for (auto dim : dims) {
+      if (!match(dim, input_dims[i++])) {
+        return false;
+      }
+    }
+  }
+  return i == input_dims.size();
+}
+}  // namespace
+
+int64_t SessionState::CalculateMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs) const {
   int64_t key = 0;
   for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
+    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= RoundUpToShapeBucket(dim, mem_pattern_shape_buckets_);
   }
   return key;
 }
 
+bool SessionState::CanUseMemoryPatternGroup(const CachedMemoryPatternGroup& cached,
+                                            gsl::span<const OrtValue> tensor_inputs) const {
+  if (mem_pattern_shape_buckets_.empty()) {
+    return InputDimsMatch(tensor_inputs, cached.input_dims, std::equal_to<int64_t>());
+  }
+
+  // The patterns can serve inputs of the same bucket which are not larger than the inputs they were planned for.
+  return InputDimsMatch(tensor_inputs, cached.input_dims, [this](int64_t dim, int64_t cached_dim) {
+    return dim <= cached_dim &&
+           RoundUpToShapeBucket(dim, mem_pattern_shape_buckets_) ==
+               RoundUpToShapeBucket(cached_dim, mem_pattern_shape_buckets_);
+  });
+}
+
+SessionState::CachedMemoryPatternGroup& SessionState::InsertMemoryPatternGroup(
+    int64_t key, gsl::span<const OrtValue> tensor_inputs, MemoryPatternGroup mem_patterns) const {
+  auto it = mem_patterns_.find(key);
+  if (it == mem_patterns_.end()) {
+    mem_patterns_lru_.push_front(key);
+    it = mem_patterns_.emplace(key, CachedMemoryPatternGroup{}).first;
+  } else {
+    mem_patterns_lru_.splice(mem_patterns_lru_.begin(), mem_patterns_lru_, it->second.lru_position);
+  }
+
+  auto& cached = it->second;
+  cached.mem_patterns = std::make_shared<const MemoryPatternGroup>(std::move(mem_patterns));
+  cached.inferred_shapes = nullptr;
+  cached.input_dims = GetInputDims(tensor_inputs);
+  cached.lru_position = mem_patterns_lru_.begin();
+
+  // Execution frames hold on to the patterns they use, so evicted patterns stay valid while in use.
+  while (mem_pattern_cache_max_entries_ > 0 && mem_patterns_lru_.size() > mem_pattern_cache_max_entries_) {
+    mem_patterns_.erase(mem_patterns_lru_.back());
+    mem_patterns_lru_.pop_back();
+  }
+  return cached;
+}
+
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -765,26 +1276,25 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+// The cached MemoryPatternGroup is only replaced if it can not be used for the inputs,
+// e.g. if they are larger than the inputs it was planned for.
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
-    const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>>& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
   int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
   auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  if (it == mem_patterns_.end() || !CanUseMemoryPatternGroup(it->second, tensor_inputs)) {
 #ifdef ENABLE_TRAINING
     MemoryPatternGroup mem_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
     if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+      auto& cached = InsertMemoryPatternGroup(key, tensor_inputs, std::move(mem_patterns));
+      cached.inferred_shapes = std::make_shared<const InlinedHashMap<int, TensorShape>>(std::move(inferred_shapes));
+      out_inferred_shapes = cached.inferred_shapes;
+      return cached.mem_patterns;
     }
 #else
     ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
@@ -792,11 +1302,13 @@ const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
     return nullptr;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+  auto& cached = it->second;
+  mem_patterns_lru_.splice(mem_patterns_lru_.begin(), mem_patterns_lru_, cached.lru_position);
+  // The inferred shapes are only valid for the exact input shapes they were inferred from.
+  if (cached.inferred_shapes && InputDimsMatch(tensor_inputs, cached.input_dims, std::equal_to<int64_t>())) {
+    out_inferred_shapes = cached.inferred_shapes;
   }
-  return &it->second;
+  return cached.mem_patterns;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -850,8 +1362,11 @@ Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> ten
   int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  // Do not update if the existing one can already be used for these inputs
+  auto it = mem_patterns_.find(key);
+  if (it == mem_patterns_.end() || !CanUseMemoryPatternGroup(it->second, tensor_inputs)) {
+    InsertMemoryPatternGroup(key, tensor_inputs, std::move(mem_patterns));
+  }
   return Status::OK();
 }
 
@@ -1376,9 +1891,22 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   SubgraphsKernelCreateInfoMaps subgraphs_kernel_create_info_maps;
   AccumulateAllNestedSubgraphsInfo(*this, "", 0, subgraphs_kernel_create_info_maps);
 
+  // in parallel mode, independent branches of the graph may run on as many CPU streams as there are inter-op threads
+  const size_t max_cpu_streams =
+      session_options.execution_mode == ExecutionMode::ORT_PARALLEL && inter_op_thread_pool_ != nullptr
+          ? static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(inter_op_thread_pool_))
+          : 1;
+  const std::string max_gpu_streams_config =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsMaxGpuStreams, "1");
+  size_t max_gpu_streams = 1;
+  ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(max_gpu_streams_config, max_gpu_streams) && max_gpu_streams > 0,
+                    "Invalid ", kOrtSessionOptionsMaxGpuStreams, " '", max_gpu_streams_config,
+                    "', expected a positive integer.");
   SequentialPlannerContext context(session_options.execution_mode,
                                    session_options.execution_order,
-                                   session_options.enable_mem_reuse);
+                                   session_options.enable_mem_reuse,
+                                   max_cpu_streams,
+                                   max_gpu_streams);
 
 #ifdef _WIN32
 
@@ -1394,6 +1922,12 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
 
 #endif
 
+  // the phases are recorded when profiling, to break the session initialization down
+  TimePoint tp;
+  if (profiler_.IsEnabled()) {
+    tp = profiler_.Start();
+  }
+
   auto status = SequentialPlanner::CreatePlan(parent_node, *graph_viewer_, valid_outer_scope_node_args,
                                               execution_providers_, kernel_create_info_map_,
                                               subgraphs_kernel_create_info_maps,
@@ -1407,6 +1941,62 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               p_seq_exec_plan_);
   ORT_RETURN_IF_ERROR(status);
 
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "allocation_planning", tp);
+  }
+
+  // CPU streams running concurrently share the intra-op threads instead of each using all of them.
+  // Only done for the per-session thread pools, the global ones are already shared between sessions.
+  stream_thread_pools_.clear();
+  if (max_cpu_streams > 1 && session_options.use_per_session_threads &&
+      concurrency::ThreadPool::DegreeOfParallelism(thread_pool_) > 1) {
+    const auto& logic_streams = p_seq_exec_plan_->execution_plan;
+    size_t num_cpu_streams = 0;
+    for (const auto& logic_stream : logic_streams) {
+      if (logic_stream && logic_stream->device_.Type() == OrtDevice::CPU) {
+        ++num_cpu_streams;
+      }
+    }
+    if (num_cpu_streams > 1) {
+      stream_thread_pools_.resize(logic_streams.size());
+      for (size_t i = 0; i < logic_streams.size(); ++i) {
+        if (logic_streams[i] && logic_streams[i]->device_.Type() == OrtDevice::CPU) {
+          stream_thread_pools_[i] = std::make_unique<concurrency::ThreadPool>(thread_pool_,
+                                                                              concurrency::ThreadPoolShareOptions{});
+        }
+      }
+    }
+  }
+
+  // Only the main graph keeps latency histograms, the nodes of subgraphs count towards their control flow node.
+  if (parent_node == nullptr &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableLatencyHistograms, "0") == "1") {
+    latency_histograms_ = std::make_unique<profiling::LatencyHistograms>(graph_viewer_->MaxNodeIndex());
+  }
+
+  if (parent_node == nullptr &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigProfileHardwareCounters, "0") == "1") {
+    std::string error;
+    hardware_counters_ = profiling::HardwareCounters::Create(error);
+    if (!hardware_counters_) {
+      LOGS(logger_, WARNING) << "Hardware counters are not recorded: " << error;
+    }
+  }
+
+  // Like the latency histograms, activation statistics are only collected for the main graph.
+  if (parent_node == nullptr &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigCollectActivationStatistics, "0") ==
+          "1") {
+    const std::string num_bins_config =
+        session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigActivationStatisticsNumBins, "2048");
+    size_t num_bins = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(num_bins_config, num_bins) && num_bins > 0 && num_bins % 2 == 0,
+                      "Invalid ", kOrtSessionOptionsConfigActivationStatisticsNumBins, " '", num_bins_config,
+                      "', expected an even positive integer.");
+    activation_statistics_ = std::make_unique<ActivationStatistics>(
+        static_cast<size_t>(ort_value_name_idx_map_.MaxIdx() + 1), num_bins);
+  }
+
   // Record the allocation plan
 
   // Uncomment the below to dump the allocation plan to std::cout
@@ -1473,6 +2063,19 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   }
 #endif
 
+  session_state_utils::SaveLazyTensorFunction save_lazy_tensor_func = nullptr;
+  if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazyExternalInitializers, "0") == "1") {
+    lazy_initialized_tensors_graph_location_ = graph_location;
+    save_lazy_tensor_func = [this](int idx, const ONNX_NAMESPACE::TensorProto& tensor_proto) -> Status {
+      lazy_initialized_tensors_.emplace_back(idx, tensor_proto);
+      return Status::OK();
+    };
+  }
+
+  if (profiler_.IsEnabled()) {
+    tp = profiler_.Start();
+  }
+
   ORT_RETURN_IF_ERROR(
       session_state_utils::SaveInitializedTensors(
           Env::Default(), graph_location, *graph_viewer_,
@@ -1486,8 +2089,12 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
             }
             return Status::OK();
           },
-          logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func,
-          name_to_buffered_tensor_));
+          save_lazy_tensor_func, logger_, data_transfer_mgr_, *p_seq_exec_plan_, session_options, memory_profile_func,
+          name_to_buffered_tensor_, GetThreadPool()));
+
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "initializer_loading", tp);
+  }
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   // Record Weight allocation info on device
@@ -1501,11 +2108,27 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CleanInitializedTensorsFromGraph();
   }
 
+  if (profiler_.IsEnabled()) {
+    tp = profiler_.Start();
+  }
+
   ORT_RETURN_IF_ERROR(CreateKernels(kernel_registry_manager));
 
+  if (profiler_.IsEnabled()) {
+    profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "kernel_creation", tp);
+  }
+
   if (!disable_prepacking) {
+    if (profiler_.IsEnabled()) {
+      tp = profiler_.Start();
+    }
+
     ORT_RETURN_IF_ERROR(PrepackConstantInitializedTensors(constant_initializers_use_count,
                                                           session_options.initializers_to_share_map));
+
+    if (profiler_.IsEnabled()) {
+      profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "prepacking", tp);
+    }
   }
 
   ORT_RETURN_IF_ERROR(
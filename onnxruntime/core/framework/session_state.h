@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <list>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -15,8 +17,11 @@
 
 #include "core/common/common.h"
 #include "core/common/inlined_containers.h"
+#include "core/common/hardware_counters.h"
+#include "core/common/latency_histograms.h"
 #include "core/common/logging/logging.h"
 #include "core/common/profiler.h"
+#include "core/framework/activation_statistics.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/callback.h"
 #include "core/framework/data_transfer_manager.h"
@@ -25,6 +30,7 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
@@ -162,6 +168,28 @@ class SessionState {
    */
   const std::unordered_map<int, OrtValue>& GetConstantInitializedTensors() const;
 
+  /**
+   * Loads the initializers whose loading was deferred by the kOrtSessionOptionsConfigLazyExternalInitializers config
+   * and pre-packs them for the kernels of this graph. Only the first call loads them.
+   * The execution frame calls this before it reads the initialized tensors, so it must be called before any kernel
+   * of this graph is run.
+   */
+  Status LoadLazyInitializedTensors() const;
+
+  /**
+   * Replaces the values of initializers of this graph with copies of tensors of the same element type and shape,
+   * and pre-packs them again for the kernels of this graph and of its subgraphs that pre-packed them.
+   * All the values are checked and copied before any initializer is replaced. If pre-packing a new value fails, the
+   * previous values are restored and pre-packed again; the kernels that pre-packed the new value of an initializer
+   * whose previous value was released can't be restored, which the returned status reports.
+   * The execution frames created before the update keep the previous values. The kernels are updated in place, so
+   * the caller must make sure this graph doesn't run during the update.
+   */
+  Status UpdateInitializedTensors(gsl::span<const std::string> names, gsl::span<const OrtValue> values);
+
+  /** Number of calls to UpdateInitializedTensors that replaced initializers, e.g. to invalidate copies of them. */
+  size_t GetInitializedTensorsVersion() const noexcept { return initialized_tensors_version_; }
+
 #if !defined(DISABLE_SPARSE_TENSORS)
   bool IsSparseInitializer(int ort_value_index) const;
 #endif
@@ -215,16 +243,16 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  The returned pattern and inferred shapes are shared with the cache, so they
+  remain valid if the cache entry is replaced or evicted while they are in use.
+  If memory pattern shape buckets are configured, the pattern may have been planned
+  for larger input shapes of the same bucket, in which case its blocks may be larger
+  than the tensors allocated from them and no inferred shapes are returned.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
-      const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
+      std::shared_ptr<const InlinedHashMap<int, TensorShape>>& inferred_shapes) const;
 
   /**
   Set generated memory pattern with a given input shapes.
@@ -234,6 +262,12 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Whether memory patterns are shared by input shapes rounded up to the same bucket boundaries,
+  i.e. whether a block of a memory pattern may be larger than the tensor allocated from it.
+  */
+  bool GetMemoryPatternsAreBucketed() const { return !mem_pattern_shape_buckets_.empty(); }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -288,9 +322,26 @@ class SessionState {
   /// Return SessionState for the given Node index and attribute name if found.
   const SessionState* GetSubgraphSessionState(NodeIndex index, const std::string& attribute_name) const;
 
+  // Get the latency histograms of the nodes, indexed by NodeIndex. nullptr if they are disabled.
+  profiling::LatencyHistograms* GetLatencyHistograms() const noexcept { return latency_histograms_.get(); }
+
+  // Get the hardware counters of the nodes. nullptr if they are not recorded.
+  profiling::HardwareCounters* GetHardwareCounters() const noexcept { return hardware_counters_.get(); }
+
+  // Get the activation statistics of the OrtValues, indexed by OrtValue index. nullptr if they are not collected.
+  ActivationStatistics* GetActivationStatistics() const noexcept { return activation_statistics_.get(); }
+
   concurrency::ThreadPool* GetThreadPool() const noexcept { return thread_pool_; }
   concurrency::ThreadPool* GetInterOpThreadPool() const noexcept { return inter_op_thread_pool_; }
 
+  // Get the intra-op thread pool for the kernels of a logic stream.
+  // When several CPU streams run concurrently each gets its share of the threads of GetThreadPool().
+  concurrency::ThreadPool* GetStreamThreadPool(size_t stream_idx) const noexcept {
+    return stream_idx < stream_thread_pools_.size() && stream_thread_pools_[stream_idx]
+               ? stream_thread_pools_[stream_idx].get()
+               : thread_pool_;
+  }
+
   const FuncManager& GetFuncMgr() const noexcept { return fused_funcs_mgr_; }
   FuncManager& GetMutableFuncMgr() noexcept { return fused_funcs_mgr_; }
 
@@ -329,6 +380,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedSerializedPrePackedWeightCounter() const {
+    return used_serialized_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -380,6 +435,24 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  // Pre-packs a constant initialized tensor using prepacked_weights_file_: the kernel uses the pre-packed buffers
+  // loaded from the file if it can, otherwise the tensor is pre-packed and the buffers are added to the file.
+  Status PrepackUsingPrepackedWeightsFile(OpKernel& kernel, int input_idx, const Tensor& weight, bool& is_packed);
+
+  // Pre-packs a constant initialized tensor of a CPU node and shares the pre-packed buffers through
+  // prepacked_weights_container_, using the buffers of an identical weight cached by another kernel if there is one.
+  // The caller holds the mutex of the container.
+  Status PrepackUsingPrepackedWeightsContainer(const Node& node, OpKernel& kernel, int input_idx, const Tensor& weight,
+                                               bool& is_packed);
+
+  Status LoadLazyInitializedTensorsImpl();
+
+  // Pre-packs an updated initializer for the kernels of this graph using it, and for those of the subgraphs using it
+  // from the outer scope. keep_initializer is set if a kernel didn't pre-pack it or a subgraph uses it. The kernel
+  // inputs that pre-packed it are added to packed_inputs.
+  Status PrePackUpdatedInitializedTensor(const std::string& name, const Tensor& tensor, bool& keep_initializer,
+                                         InlinedVector<std::pair<OpKernel*, int>>& packed_inputs);
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -413,6 +486,10 @@ class SessionState {
   // fused_funcs_mgr_ must live longer than the session_kernels_, becaues a kernel could be created from this manager
   FuncManager fused_funcs_mgr_;
 
+  // The pre-packed weights saved to or loaded from kOrtSessionOptionsConfigPrepackedWeightsFilePath.
+  // It must live longer than the session_kernels_, which use its buffers.
+  std::unique_ptr<PrepackedWeightsFile> prepacked_weights_file_;
+
   // cache of the constructed kernels to avoid spending construction time per executor
   std::vector<std::unique_ptr<OpKernel>> session_kernels_;
   Graph& graph_;
@@ -473,6 +550,18 @@ class SessionState {
   InlinedHashSet<int> sparse_initialized_tensors_;
 #endif
 
+  // initializers that are loaded by LoadLazyInitializedTensors, keyed by ort_value_index, and the location of the
+  // model their external data is relative to
+  std::vector<std::pair<int, ONNX_NAMESPACE::TensorProto>> lazy_initialized_tensors_;
+  std::basic_string<PATH_CHAR_TYPE> lazy_initialized_tensors_graph_location_;
+  mutable OrtMutex lazy_initialized_tensors_lock_;
+  mutable std::atomic<bool> lazy_initialized_tensors_loaded_{false};
+
+  // element type and shape of the constant initializers released once all the kernels using them pre-packed them,
+  // keyed by ort_value_index, so UpdateInitializedTensors can check the values replacing them
+  InlinedHashMap<int, std::pair<MLDataType, TensorShape>> released_initialized_tensors_;
+  size_t initialized_tensors_version_ = 0;
+
   // This data structure is for uninitializing string tensors and
   // munmap memory region and close file descriptor
   InlinedHashMap<int, OrtCallback> deleter_for_initialized_tensors_;
@@ -489,18 +578,39 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
+  struct CachedMemoryPatternGroup {
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+    // Shapes of all the activations, if they could be inferred from the input shapes (training only).
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+    // Dims of all the inputs the patterns were planned for.
+    InlinedVector<int64_t> input_dims;
+    // Position of the key in mem_patterns_lru_.
+    std::list<int64_t>::iterator lru_position;
+  };
+
+  int64_t CalculateMemoryPatternsKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  // Whether a cached memory pattern can be used for the given inputs.
+  bool CanUseMemoryPatternGroup(const CachedMemoryPatternGroup& cached,
+                                gsl::span<const OrtValue> tensor_inputs) const;
+
+  // Inserts or replaces a cache entry and evicts the least recently used entries beyond the cache limit.
+  // Must be called with mem_patterns_lock_ held.
+  CachedMemoryPatternGroup& InsertMemoryPatternGroup(int64_t key, gsl::span<const OrtValue> tensor_inputs,
+                                                     MemoryPatternGroup mem_patterns) const;
+
+  // Ascending input dim boundaries that are used instead of the input dims to look up memory patterns,
+  // from the kOrtSessionOptionsConfigMemoryPatternShapeBuckets config. Empty if shapes are not bucketed.
+  InlinedVector<int64_t> mem_pattern_shape_buckets_;
+  // Maximum number of cached memory patterns, 0 if unlimited.
+  size_t mem_pattern_cache_max_entries_ = 0;
+
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  // cache for the generated mem_patterns. key is calculated based on (bucketed) input shapes.
+  mutable NodeHashMap<int64_t, CachedMemoryPatternGroup> mem_patterns_;
+  // keys of mem_patterns_, most recently used first.
+  mutable std::list<int64_t> mem_patterns_lru_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -510,6 +620,12 @@ class SessionState {
   // either threadpool could be nullptr
   concurrency::ThreadPool* const thread_pool_{};
   concurrency::ThreadPool* const inter_op_thread_pool_{};
+  std::unique_ptr<profiling::LatencyHistograms> latency_histograms_;
+  std::unique_ptr<profiling::HardwareCounters> hardware_counters_;
+  std::unique_ptr<ActivationStatistics> activation_statistics_;
+
+  // pools sharing thread_pool_ between concurrent CPU streams, indexed by stream. empty if not needed.
+  std::vector<std::unique_ptr<concurrency::ThreadPool>> stream_thread_pools_;
 
   const DataTransferManager& data_transfer_mgr_;
 
@@ -553,6 +669,9 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight loaded from the pre-packed weights file was used
+  size_t used_serialized_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -1,11 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <core/common/status.h>
 
@@ -35,6 +38,70 @@
 namespace onnxruntime {
 namespace session_state_utils {
 
+namespace {
+// Collects the copies of initializers from CPU to other devices and issues them as batches through
+// DataTransferManager::CopyTensors, so that a data transfer can pipeline them (e.g. upload through pinned staging
+// buffers) instead of synchronizing after every tensor. The CPU source of a pending copy, including any mapped
+// external data, is kept alive until its batch is flushed. The pending bytes are bounded, so that the CPU copies of
+// initializers that are not mapped from a file are released regularly.
+class InitializerCopyBatch {
+ public:
+  explicit InitializerCopyBatch(const DataTransferManager& data_transfer_mgr)
+      : data_transfer_mgr_(data_transfer_mgr) {}
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(InitializerCopyBatch);
+
+  Status Add(std::unique_ptr<Tensor> src, std::optional<ScopedOrtCallbackInvoker> src_deleter, Tensor& dst) {
+    pending_bytes_ += src->SizeInBytes();
+    copies_.push_back({src.get(), &dst});
+    srcs_.push_back(std::move(src));
+    if (src_deleter.has_value()) {
+      src_deleters_.push_back(std::move(*src_deleter));
+    }
+
+    if (pending_bytes_ >= kMaxPendingBytes) {
+      return Flush();
+    }
+    return Status::OK();
+  }
+
+  Status Flush() {
+    if (copies_.empty()) {
+      return Status::OK();
+    }
+
+    std::vector<IDataTransfer::SrcDstPair> src_dst_pairs;
+    src_dst_pairs.reserve(copies_.size());
+    for (const auto& copy : copies_) {
+      src_dst_pairs.push_back({*copy.first, *copy.second, nullptr});
+    }
+
+    Status copy_status = data_transfer_mgr_.CopyTensors(src_dst_pairs);
+    if (!copy_status.IsOK() && copy_status.ErrorMessage().empty()) {
+      // The windows execution provider does not return any error message today for CopyTensor since it is
+      // not implemented yet. That's the reason we're adding our own error message so that we can debug better.
+      copy_status = Status(copy_status.Category(), copy_status.Code(),
+                           "Failed to copy initializers to " + copies_.front().second->Location().ToString());
+    }
+
+    copies_.clear();
+    src_deleters_.clear();
+    srcs_.clear();
+    pending_bytes_ = 0;
+    return copy_status;
+  }
+
+ private:
+  static constexpr size_t kMaxPendingBytes = size_t{256} * 1024 * 1024;
+
+  const DataTransferManager& data_transfer_mgr_;
+  std::vector<std::pair<const Tensor*, Tensor*>> copies_;
+  std::vector<std::unique_ptr<Tensor>> srcs_;
+  std::vector<ScopedOrtCallbackInvoker> src_deleters_;
+  size_t pending_bytes_ = 0;
+};
+}  // namespace
+
 // The following method will allocate memory directly using the device allocator.
 // It can handle arena-based allocators and non-arena based allocators.
 static common::Status AllocateBufferUsingDeviceAllocatorFromShapeAndType(const TensorShape& tensor_shape, const DataTypeImpl* type,
@@ -72,14 +139,15 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
                                                         const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                                         const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                                         Tensor& tensor, OrtCallback& ext_data_deleter,
-                                                        Tensor* buffered_tensor = nullptr) {
+                                                        Tensor* buffered_tensor = nullptr,
+                                                        concurrency::ThreadPool* thread_pool = nullptr) {
   ORT_ENFORCE(utils::HasExternalData(tensor_proto));
 
   void* ext_data_buf = nullptr;
   SafeInt<size_t> ext_data_len = 0;
   ORT_RETURN_IF_ERROR(utils::GetExtDataFromTensorProto(env, proto_path.c_str(), tensor_proto,
                                                        ext_data_buf, ext_data_len, ext_data_deleter,
-                                                       buffered_tensor));
+                                                       buffered_tensor, thread_pool));
 
   // NB: creating a do-nothing allocator per tensor is wasteful; can perhaps be
   // avoided if the Tensor class implements the do-nothing behavior when given a
@@ -95,12 +163,15 @@ static inline common::Status ExtDataTensorProtoToTensor(const Env& env,
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
 // should release the buffer when tensor_proto is released.
+// If copy_batch is not null, the copy of a non-CPU tensor is added to it and completes when the batch is flushed.
 static common::Status DeserializeTensorProto(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& proto_path,
                                              const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer* m,
                                              const AllocatorPtr& alloc, const AllocatorPtr& default_cpu_alloc,
                                              OrtValue& ort_value, const DataTransferManager& data_transfer_mgr,
                                              bool use_device_allocator_for_initializers = false,
-                                             Tensor* buffered_tensor = nullptr) {
+                                             Tensor* buffered_tensor = nullptr,
+                                             InitializerCopyBatch* copy_batch = nullptr,
+                                             concurrency::ThreadPool* thread_pool = nullptr) {
   if (bool(alloc) == (m != nullptr)) {
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                   "DeserializeTensorProto() takes either pre-allocated buffer or an allocator!");
@@ -113,7 +184,11 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
   TensorShape tensor_shape = utils::GetTensorShapeFromTensorProto(tensor_proto);
   const DataTypeImpl* const type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type())->GetElementType();
   std::unique_ptr<Tensor> p_tensor;
-  if (m != nullptr) {
+  if (m == nullptr && alloc->Info().device.Type() == OrtDevice::CPU && utils::HasExternalData(tensor_proto)) {
+    // The external data is mapped read-only and referenced in place. Don't allocate a buffer for the tensor first:
+    // memory taken from an arena would not be returned to the system when the tensor is replaced.
+    p_tensor = std::make_unique<Tensor>();
+  } else if (m != nullptr) {
     p_tensor = std::make_unique<Tensor>(type, tensor_shape, m->GetBuffer(), m->GetAllocInfo());
     if (m->GetLen() < p_tensor->SizeInBytes()) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Internal error. The preallocated buffer is too small. Requires ",
@@ -132,7 +207,8 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
     }
   }
 
-  if (p_tensor->Location().device.Type() == OrtDevice::CPU) {
+  const OrtDevice& device = m != nullptr ? m->GetAllocInfo().device : alloc->Info().device;
+  if (device.Type() == OrtDevice::CPU) {
     // deserialize directly to CPU tensor
     if (utils::HasExternalData(tensor_proto)) {
       // NB: The file containing external data for the tensor is mmap'd. If the tensor will be used on CPU we can
@@ -140,7 +216,7 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
       // TensorProtoToTensor it would copy the data, causing unnecessary overhead
       OrtCallback ext_data_deleter;
       ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_tensor,
-                                                     ext_data_deleter, buffered_tensor));
+                                                     ext_data_deleter, buffered_tensor, thread_pool));
 
       ExtDataValueDeleter deleter{ext_data_deleter, p_tensor.get()};
 
@@ -156,7 +232,10 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
 
     // deserialize to CPU first for non-CPU allocator, then copy
     std::unique_ptr<Tensor> p_deserialize_tensor;
-    if (use_device_allocator_for_initializers) {
+    if (utils::HasExternalData(tensor_proto)) {
+      // the mapped external data is used directly as the source of the copy
+      p_deserialize_tensor = std::make_unique<Tensor>();
+    } else if (use_device_allocator_for_initializers) {
       void* tensor_buffer = nullptr;
       ORT_RETURN_IF_ERROR(AllocateBufferUsingDeviceAllocatorFromShapeAndType(tensor_shape, type, default_cpu_alloc, tensor_buffer));
       p_deserialize_tensor = std::make_unique<Tensor>(type, tensor_shape, tensor_buffer, default_cpu_alloc);
@@ -171,13 +250,21 @@ static common::Status DeserializeTensorProto(const Env& env, const std::basic_st
     std::optional<ScopedOrtCallbackInvoker> scoped_ort_callback_invoker;
     if (utils::HasExternalData(tensor_proto)) {
       ORT_RETURN_IF_ERROR(ExtDataTensorProtoToTensor(env, proto_path, tensor_proto, *p_deserialize_tensor,
-                                                     ext_data_deleter, buffered_tensor));
+                                                     ext_data_deleter, buffered_tensor, thread_pool));
       scoped_ort_callback_invoker = ScopedOrtCallbackInvoker(ext_data_deleter);
     } else {
       ORT_RETURN_IF_ERROR(utils::TensorProtoToTensor(env, proto_path.c_str(), tensor_proto, *p_deserialize_tensor));
     }
     // TODO!! Need a temp buffer allocator for non-escape buffers that maybe too big for stack allocation.
 
+    if (copy_batch != nullptr) {
+      ORT_RETURN_IF_ERROR(copy_batch->Add(std::move(p_deserialize_tensor), std::move(scoped_ort_callback_invoker),
+                                          *p_tensor));
+      auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+      ort_value.Init(p_tensor.release(), ml_tensor, ml_tensor->GetDeleteFunc());
+      return common::Status::OK();
+    }
+
     Status copy_status = data_transfer_mgr.CopyTensor(*p_deserialize_tensor, *p_tensor);
     if (!copy_status.IsOK()) {
       if (copy_status.ErrorMessage().empty()) {
@@ -201,11 +288,13 @@ common::Status SaveInitializedTensors(
     const std::vector<OrtValueIndex>& initializer_allocation_order,
     ITensorAllocator& planner,
     const SaveTensorFunction& save_tensor_func,
+    const SaveLazyTensorFunction& save_lazy_tensor_func,
     const logging::Logger& logger, const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors) {
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    concurrency::ThreadPool* thread_pool) {
   LOGS(logger, INFO) << "Saving initialized tensors.";
   ORT_ENFORCE(ort_value_name_idx_map.MaxIdx() > -1, "OrtValue indexes should have been populated.");
 
@@ -255,16 +344,46 @@ common::Status SaveInitializedTensors(
     id_to_initialized_tensor[ort_value_index] = entry.second;
   }
 
+  // constant initializers with external data are loaded lazily, unless they are shared, have to be allocated in a
+  // specific order or provide a graph output
+  InlinedHashSet<int> lazy_initializer_ids;
+  if (save_lazy_tensor_func) {
+    const auto& graph_outputs = graph.GetOutputs();
+    for (const auto& entry : id_to_initialized_tensor) {
+      const ONNX_NAMESPACE::TensorProto& tensor_proto = *entry.second;
+      const std::string& name = tensor_proto.name();
+      if (!utils::HasExternalData(tensor_proto) ||
+          tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_STRING ||
+          !graph.IsConstantInitializer(name, /* check_outer_scope */ false) ||
+#if !defined(DISABLE_SPARSE_TENSORS)
+          graph.GetGraph().IsSparseInitializer(name) ||
+#endif
+          user_supplied_initializer_ids.count(entry.first) > 0 ||
+          buffered_tensors.count(name) > 0 ||
+          std::find(initializer_allocation_order.begin(), initializer_allocation_order.end(), entry.first) !=
+              initializer_allocation_order.end() ||
+          std::any_of(graph_outputs.begin(), graph_outputs.end(),
+                      [&name](const NodeArg* output) { return output->Name() == name; })) {
+        continue;
+      }
+      lazy_initializer_ids.insert(entry.first);
+    }
+  }
+
+  // External data (i.e mmap) of an initializer on CPU is referenced in place, so no memory is planned for it.
+  // When data is external and on GPU, need to copy first to cpu memory, then to gpu memory.
+  auto is_mapped_in_place = [&exec_plan](int ort_value_index, const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+    return utils::HasExternalData(tensor_proto) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU;
+  };
+
   // tensors requiring a specific allocation order are traced first, to ensure they are allocated in order
-  // NB1: vector with init allocation order may contain a subset of all tensors (or none at all)
-  // NB2: only skip tracing and planning memory when data is external (i.e mmap) and on CPU.
-  //    when data is external and on GPU, need to copy first to cpu memory, then to gpu memory.
+  // NB: vector with init allocation order may contain a subset of all tensors (or none at all)
   auto initialized_tensors_to_allocate = id_to_initialized_tensor;
   for (int ort_value_index : initializer_allocation_order) {
     const auto entry = initialized_tensors_to_allocate.find(ort_value_index);
     ORT_ENFORCE(entry != initialized_tensors_to_allocate.end(),
                 "OrtValue index: ", ort_value_index, " from initializer_allocation_order not found among initialized tensors");
-    if (!(utils::HasExternalData(*entry->second) && exec_plan.GetLocation(ort_value_index).Type() == OrtDevice::CPU)) {
+    if (!is_mapped_in_place(ort_value_index, *entry->second)) {
       // can not trace string tensor
       ORT_ENFORCE(entry->second->data_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING, "Can not trace string tensor");
       ORT_RETURN_IF_ERROR(planner.Trace(entry->first, entry->second));
@@ -281,6 +400,9 @@ common::Status SaveInitializedTensors(
       // do not trace string tensor
       continue;
     }
+    if (is_mapped_in_place(entry.first, *entry.second) || lazy_initializer_ids.count(entry.first) > 0) {
+      continue;
+    }
     ORT_RETURN_IF_ERROR(planner.Trace(entry.first, entry.second));
   }
   // 2. allocate weight buffer on different locations
@@ -300,6 +422,9 @@ common::Status SaveInitializedTensors(
 
   OrtCallback deleter{nullptr, nullptr};
 
+  // the copies to other devices are batched. the device tensors are only read once the batch has been flushed below.
+  InitializerCopyBatch copy_batch(data_transfer_mgr);
+
   // 3. create weight tensors based on weights buffer
   for (const auto& entry : id_to_initialized_tensor) {
     int ort_value_index = entry.first;
@@ -310,6 +435,12 @@ common::Status SaveInitializedTensors(
       continue;
     }
 
+    if (lazy_initializer_ids.count(ort_value_index) > 0) {
+      VLOGS(logger, 1) << "Deferring the loading of weight with name : " << name << " with index: " << ort_value_index;
+      ORT_RETURN_IF_ERROR(save_lazy_tensor_func(ort_value_index, *entry.second));
+      continue;
+    }
+
     OrtValue ort_value;
 
     if (user_supplied_initializer_ids.find(entry.first) != user_supplied_initializer_ids.end()) {
@@ -320,8 +451,12 @@ common::Status SaveInitializedTensors(
 
       std::optional<MemBuffer> m;
       AllocatorPtr alloc;
-      // TODO: if the tensor need be copied, does it have enough room?
-      ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
+      if (is_mapped_in_place(ort_value_index, tensor_proto)) {
+        alloc = planner.GetAllocator(exec_plan.GetLocation(ort_value_index));
+      } else {
+        // TODO: if the tensor need be copied, does it have enough room?
+        ORT_RETURN_IF_ERROR(planner.GetPreallocatedBuffer(ort_value_index, name, m, alloc));
+      }
       bool use_device_allocator_for_initializers =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsUseDeviceAllocatorForInitializers, "0") == "1";
 
@@ -334,7 +469,7 @@ common::Status SaveInitializedTensors(
 
       Status st = DeserializeTensorProto(env, graph_loc, tensor_proto, (m.has_value()) ? &*m : nullptr, alloc,
                                          default_cpu_alloc, ort_value, data_transfer_mgr,
-                                         use_device_allocator_for_initializers, p_tensor);
+                                         use_device_allocator_for_initializers, p_tensor, &copy_batch, thread_pool);
       if (!st.IsOK()) {
         std::ostringstream oss;
         oss << "Deserialize tensor " << name << " failed." << st.ErrorMessage();
@@ -357,10 +492,21 @@ common::Status SaveInitializedTensors(
 #endif
   }
 
+  ORT_RETURN_IF_ERROR(copy_batch.Flush());
+
   LOGS(logger, INFO) << "Done saving initialized tensors";
   return common::Status::OK();
 }
 
+common::Status LoadInitializedTensor(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
+                                     const ONNX_NAMESPACE::TensorProto& tensor_proto, const AllocatorPtr& alloc,
+                                     const AllocatorPtr& default_cpu_alloc,
+                                     const DataTransferManager& data_transfer_mgr,
+                                     bool use_device_allocator_for_initializers, OrtValue& ort_value) {
+  return DeserializeTensorProto(env, graph_loc, tensor_proto, nullptr, alloc, default_cpu_alloc, ort_value,
+                                data_transfer_mgr, use_device_allocator_for_initializers);
+}
+
 template <typename T>  // T is container of const NodeArg* or NodeArg*
 static bool IsArgNameInInputsOutputs(const std::string& name,
                                      const T& graph_args) {
@@ -13,6 +13,7 @@
 #include "core/framework/tensor_allocator.h"
 #include "core/framework/session_options.h"
 #include "core/framework/sequential_execution_plan.h"
+#include "core/graph/onnx_protobuf.h"
 #include "core/platform/path_lib.h"
 
 namespace onnxruntime {
@@ -32,23 +33,40 @@ namespace logging {
 class Logger;
 }
 
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace session_state_utils {
 using SaveTensorFunction = std::function<Status(const std::string& name, int idx, const OrtValue& value,
                                                 const OrtCallback& d, bool constant, bool sparse)>;
+using SaveLazyTensorFunction = std::function<Status(int idx, const ONNX_NAMESPACE::TensorProto& tensor_proto)>;
 using MemoryProfileFunction = std::function<void(ITensorAllocator& planner)>;
 
+// If save_lazy_tensor_func is set, constant initializers with external data are passed to it instead of being loaded,
+// so they can be loaded with LoadInitializedTensor when the graph first runs.
+// Compressed external data is decompressed using thread_pool if it is not null.
 common::Status SaveInitializedTensors(
     const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
     const GraphViewer& graph, const AllocatorPtr& default_cpu_memory_info,
     const OrtValueNameIdxMap& ort_value_name_idx_map, const std::vector<OrtValueIndex>& initializer_allocation_order,
     ITensorAllocator& planner,
     const SaveTensorFunction& save_tensor_func,
+    const SaveLazyTensorFunction& save_lazy_tensor_func,
     const logging::Logger& logger,
     const DataTransferManager& data_transfer_mgr,
     const ExecutionPlanBase& exec_plan,
     const SessionOptions& session_options,
     const MemoryProfileFunction& memory_profile_func,
-    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors);
+    std::unordered_map<std::string, std::unique_ptr<Tensor>>& buffered_tensors,
+    concurrency::ThreadPool* thread_pool = nullptr);
+
+// Loads an initializer into a tensor allocated by alloc, copying it from CPU memory if alloc is not a CPU allocator.
+common::Status LoadInitializedTensor(const Env& env, const std::basic_string<PATH_CHAR_TYPE>& graph_loc,
+                                     const ONNX_NAMESPACE::TensorProto& tensor_proto, const AllocatorPtr& alloc,
+                                     const AllocatorPtr& default_cpu_alloc,
+                                     const DataTransferManager& data_transfer_mgr,
+                                     bool use_device_allocator_for_initializers, OrtValue& ort_value);
 
 common::Status SaveInputOutputNamesToNodeMapping(const GraphViewer& graph,
                                                  SessionState& session_state,
@@ -20,7 +20,8 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                const std::unordered_map<size_t, IExecutor::CustomAllocator>&
                                                    fetch_allocators,
                                                const logging::Logger& sess_logger,
-                                               bool single_thread_mode)
+                                               bool single_thread_mode,
+                                               RunMemoryBudget* memory_budget)
     : session_state_(&sess_state),
       frame_(feed_mlvalue_idxs,
              feeds,
@@ -28,7 +29,8 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
              fetches,
              fetch_allocators,
              device_stream_map,
-             sess_state),
+             sess_state,
+             memory_budget),
       logger_(&sess_logger),
       single_thread_mode_(single_thread_mode),
       device_stream_map_(device_stream_map),
@@ -88,14 +90,16 @@ StreamExecutionContext::StreamExecutionContext(const SessionState& sess_state,
                                                const std::unordered_map<size_t, IExecutor::CustomAllocator>&
                                                    fetch_allocators,
                                                const logging::Logger& sess_logger,
-                                               bool single_thread_mode)
+                                               bool single_thread_mode,
+                                               RunMemoryBudget* memory_budget)
     : session_state_(&sess_state),
       frame_(feed_mlvalue_idxs,
              feeds,
              fetch_mlvalue_idxs,
              fetches,
              fetch_allocators,
-             sess_state),
+             sess_state,
+             memory_budget),
       logger_(&sess_logger),
       single_thread_mode_(single_thread_mode) {
 #ifdef _WIN32
@@ -164,6 +168,9 @@ void StreamExecutionContext ::SetStatus(Status& status) {
 StreamExecutionContext::~StreamExecutionContext() {}
 
 void StreamExecutionContext::RecycleNodeInputs(onnxruntime::NodeIndex node_index) {
+  if (recorded_execution_ != nullptr) {
+    return;
+  }
   auto* execution_plan = session_state_->GetExecutionPlan();
   for (auto idx : execution_plan->node_release_list[node_index]) {
     if (--release_plan_[idx] == 0) {
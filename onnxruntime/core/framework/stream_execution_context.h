@@ -16,6 +16,7 @@
 
 namespace onnxruntime {
 class SessionState;
+class RecordedExecution;
 
 class SessionScope;
 typedef InlinedHashMap<std::string, OrtValue> OrtValueCache;
@@ -70,7 +71,8 @@ class StreamExecutionContext {
                          std::vector<OrtValue>& fetches,
                          const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
                          const logging::Logger& sess_logger,
-                         bool single_thread_mode);
+                         bool single_thread_mode,
+                         RunMemoryBudget* memory_budget = nullptr);
 
   const SessionState& GetSessionState() const;
 
@@ -114,8 +116,18 @@ class StreamExecutionContext {
   void SetStatus(Status& status);
 
   // Release the OrtValues after a step, based on the execution plan.
+  // Nothing is released while recording, so that the recorded kernels can be replayed on the same buffers.
   void RecycleNodeInputs(onnxruntime::NodeIndex node_index);
 
+  // The recording of the kernel invocations of this execution, if it is recorded.
+  void SetRecordedExecution(RecordedExecution* recorded_execution) {
+    recorded_execution_ = recorded_execution;
+  }
+
+  RecordedExecution* GetRecordedExecution() const {
+    return recorded_execution_;
+  }
+
 #ifdef ENABLE_TRAINING
   void SetOrtValueCache(OrtValueCachePtr cache) {
     cache_ = std::move(cache);
@@ -171,6 +183,8 @@ class StreamExecutionContext {
 #endif
   const bool single_thread_mode_;
 
+  RecordedExecution* recorded_execution_{nullptr};
+
 #ifdef ORT_ENABLE_STREAM
   InlinedVector<std::unique_ptr<synchronize::Notification>> notifications_;
   // if it is nullptr, means current session doesn't have any EP using stream feature
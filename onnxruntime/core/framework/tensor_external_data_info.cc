@@ -40,6 +40,16 @@ Status ExternalDataInfo::Create(const RepeatedPtrField<StringStringEntryProto>&
         return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "parsing ", stringmap.value(), " failed");
     } else if (stringmap.key() == "checksum" && !stringmap.value().empty()) {
       out->checksum_ = stringmap.value();
+    } else if (stringmap.key() == "compression" && !stringmap.value().empty()) {
+      if (stringmap.value() != "lz4") {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unsupported external data compression: ", stringmap.value());
+      }
+      out->compression_ = Compression::kLz4;
+    } else if (stringmap.key() == "shuffle" && !stringmap.value().empty()) {
+      char* end;
+      out->shuffle_element_size_ = static_cast<size_t>(OrtStrToPtrDiff(stringmap.value().c_str(), &end));
+      if (end != stringmap.value().c_str() + stringmap.value().length())
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "parsing ", stringmap.value(), " failed");
     } else {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "model format error!");
     }
@@ -47,6 +57,9 @@ Status ExternalDataInfo::Create(const RepeatedPtrField<StringStringEntryProto>&
   if (out->rel_path_.empty()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "model format error! Missing 'location'");
   }
+  if (out->compression_ != Compression::kNone && out->length_ == 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "model format error! Compressed external data needs a 'length'");
+  }
   return Status::OK();
 }
 }  // namespace onnxruntime
\ No newline at end of file
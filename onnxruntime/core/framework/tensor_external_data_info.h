@@ -23,6 +23,17 @@ class ExternalDataInfo {
 
   const std::string& GetChecksum() const { return checksum_; }
 
+  enum class Compression {
+    kNone,
+    // blocks in the LZ4 block format written by utils::CompressExternalData. 'length' is the compressed size.
+    kLz4,
+  };
+
+  Compression GetCompression() const { return compression_; }
+
+  // size of the elements whose bytes were shuffled before compressing, 0 if they were not shuffled
+  size_t GetShuffleElementSize() const { return shuffle_element_size_; }
+
   // If the value of 'offset' or 'length' field is larger the max value of ssize_t, this function will treat it as a
   // wrong value and return FAIL.
   static common::Status Create(
@@ -36,5 +47,7 @@ class ExternalDataInfo {
   // 0 means the whole file
   size_t length_ = 0;
   std::string checksum_;
+  Compression compression_ = Compression::kNone;
+  size_t shuffle_element_size_ = 0;
 };
 }  // namespace onnxruntime
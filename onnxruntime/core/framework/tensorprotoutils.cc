@@ -6,6 +6,7 @@
 #include <memory>
 #include <algorithm>
 #include <limits>
+#include <map>
 #include <string>
 #include <filesystem>
 #if defined(__wasm__)
@@ -18,6 +19,7 @@
 #include "core/common/span_utils.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/framework/endian_utils.h"
+#include "core/framework/external_data_compression.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
 #include "core/framework/ort_value_pattern_planner.h"
@@ -165,18 +167,20 @@ Status UnpackTensorWithRawData(const void* raw_data, size_t raw_data_len, size_t
 DEFINE_INT4_UNPACK_TENSOR_WITH_RAW_DATA_IMPL(Int4x2)
 DEFINE_INT4_UNPACK_TENSOR_WITH_RAW_DATA_IMPL(UInt4x2)
 
+// tensor_byte_size is the size of the tensor data. The size of the data stored in the external file differs from it if
+// the data is compressed, in which case it is the 'length' of external_data_info.
 static Status GetExternalDataInfo(const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                   const std::filesystem::path& tensor_proto_dir,
                                   std::basic_string<ORTCHAR_T>& external_file_path,
                                   onnxruntime::FileOffsetType& file_offset,
-                                  SafeInt<size_t>& tensor_byte_size) {
+                                  SafeInt<size_t>& tensor_byte_size,
+                                  std::unique_ptr<onnxruntime::ExternalDataInfo>& external_data_info) {
   ORT_RETURN_IF_NOT(onnxruntime::utils::HasExternalData(tensor_proto),
                     "Tensor does not have external data to read from.");
 
   ORT_RETURN_IF(!onnxruntime::utils::HasDataType(tensor_proto) || onnxruntime::utils::HasString(tensor_proto),
                 "External data type cannot be UNDEFINED or STRING.");
 
-  std::unique_ptr<onnxruntime::ExternalDataInfo> external_data_info;
   ORT_RETURN_IF_ERROR(onnxruntime::ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
 
   const auto& location = external_data_info->GetRelPath();
@@ -186,7 +190,8 @@ static Status GetExternalDataInfo(const ONNX_NAMESPACE::TensorProto& tensor_prot
 
   ORT_RETURN_IF_ERROR(onnxruntime::utils::GetSizeInBytesFromTensorProto<0>(tensor_proto, &tensor_byte_size));
   const size_t external_data_length = external_data_info->GetLength();
-  ORT_RETURN_IF_NOT(external_data_length == 0 || external_data_length == tensor_byte_size,
+  ORT_RETURN_IF_NOT(external_data_length == 0 || external_data_length == tensor_byte_size ||
+                        external_data_info->GetCompression() != ExternalDataInfo::Compression::kNone,
                     "TensorProto: ", tensor_proto.name(),
                     " external data size mismatch. Computed size: ", *&tensor_byte_size,
                     ", external_data.length: ", external_data_length);
@@ -196,6 +201,11 @@ static Status GetExternalDataInfo(const ONNX_NAMESPACE::TensorProto& tensor_prot
   return Status::OK();
 }
 
+static size_t GetStoredByteSize(const ExternalDataInfo& external_data_info, size_t tensor_byte_size) {
+  return external_data_info.GetCompression() == ExternalDataInfo::Compression::kNone ? tensor_byte_size
+                                                                                     : external_data_info.GetLength();
+}
+
 // Read external data for tensor in unint8_t* form and return Status::OK() if the data is read successfully.
 // Uses the tensor_proto_dir to construct the full path for external data. If tensor_proto_dir == nullptr
 // then uses the current directory instead.
@@ -206,10 +216,19 @@ Status ReadExternalDataForTensor(const ONNX_NAMESPACE::TensorProto& tensor_proto
   std::basic_string<ORTCHAR_T> external_file_path;
   onnxruntime::FileOffsetType file_offset;
   SafeInt<size_t> tensor_byte_size;
-  ORT_RETURN_IF_ERROR(
-      GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_file_path, file_offset, tensor_byte_size));
+  std::unique_ptr<onnxruntime::ExternalDataInfo> external_data_info;
+  ORT_RETURN_IF_ERROR(GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_file_path, file_offset,
+                                          tensor_byte_size, external_data_info));
 
   unpacked_tensor.resize(tensor_byte_size);
+  if (external_data_info->GetCompression() != ExternalDataInfo::Compression::kNone) {
+    std::vector<uint8_t> compressed(external_data_info->GetLength());
+    ORT_RETURN_IF_ERROR(onnxruntime::Env::Default().ReadFileIntoBuffer(
+        external_file_path.c_str(), file_offset, compressed.size(),
+        gsl::make_span(reinterpret_cast<char*>(compressed.data()), compressed.size())));
+    return DecompressExternalData(compressed, external_data_info->GetShuffleElementSize(), unpacked_tensor);
+  }
+
   ORT_RETURN_IF_ERROR(onnxruntime::Env::Default().ReadFileIntoBuffer(
       external_file_path.c_str(),
       file_offset,
@@ -985,10 +1004,56 @@ static Status GetFileContent(const Env& env, const std::filesystem::path& file_p
 }
 #endif
 
+Status PrefetchExternalData(const Env& env, const std::filesystem::path& model_path,
+                            gsl::span<const ONNX_NAMESPACE::TensorProto* const> tensor_protos) {
+  std::basic_string<ORTCHAR_T> tensor_proto_dir;
+  if (!model_path.empty()) {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(model_path, tensor_proto_dir));
+  }
+
+  std::map<std::basic_string<ORTCHAR_T>, std::vector<std::pair<FileOffsetType, size_t>>> file_ranges;
+  for (const ONNX_NAMESPACE::TensorProto* tensor_proto : tensor_protos) {
+    if (!utils::HasExternalData(*tensor_proto) || utils::HasString(*tensor_proto)) {
+      continue;
+    }
+
+    std::basic_string<ORTCHAR_T> external_data_file_path;
+    FileOffsetType file_offset;
+    SafeInt<size_t> raw_data_safe_len = 0;
+    std::unique_ptr<ExternalDataInfo> external_data_info;
+    ORT_RETURN_IF_ERROR(GetExternalDataInfo(*tensor_proto, tensor_proto_dir, external_data_file_path, file_offset,
+                                            raw_data_safe_len, external_data_info));
+    if (external_data_file_path != onnxruntime::utils::kTensorProtoMemoryAddressTag) {
+      file_ranges[external_data_file_path].emplace_back(file_offset,
+                                                        GetStoredByteSize(*external_data_info, raw_data_safe_len));
+    }
+  }
+
+  for (auto& [file_path, ranges] : file_ranges) {
+    std::sort(ranges.begin(), ranges.end());
+    FileOffsetType begin = ranges[0].first;
+    FileOffsetType end = begin + static_cast<FileOffsetType>(ranges[0].second);
+    for (size_t i = 1; i <= ranges.size(); ++i) {
+      if (i < ranges.size() && ranges[i].first <= end) {
+        end = std::max(end, ranges[i].first + static_cast<FileOffsetType>(ranges[i].second));
+        continue;
+      }
+
+      ORT_RETURN_IF_ERROR(env.PrefetchFile(file_path.c_str(), begin, narrow<size_t>(end - begin)));
+      if (i < ranges.size()) {
+        begin = ranges[i].first;
+        end = begin + static_cast<FileOffsetType>(ranges[i].second);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                  const ONNX_NAMESPACE::TensorProto& tensor_proto, void*& ext_data_buf,
                                  SafeInt<size_t>& ext_data_len, OrtCallback& ext_data_deleter,
-                                 Tensor* buffered_tensor) {
+                                 Tensor* buffered_tensor, concurrency::ThreadPool* thread_pool) {
   ORT_ENFORCE(utils::HasExternalData(tensor_proto));
   std::basic_string<ORTCHAR_T> tensor_proto_dir;
   if (!model_path.empty()) {
@@ -996,9 +1061,12 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
   }
   std::basic_string<ORTCHAR_T> external_data_file_path;
   FileOffsetType file_offset;
-  SafeInt<size_t> raw_data_safe_len = 0;
-  ORT_RETURN_IF_ERROR(
-      GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_data_file_path, file_offset, raw_data_safe_len));
+  SafeInt<size_t> tensor_byte_size = 0;
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  ORT_RETURN_IF_ERROR(GetExternalDataInfo(tensor_proto, tensor_proto_dir, external_data_file_path, file_offset,
+                                          tensor_byte_size, external_data_info));
+  // the stored data is read first and decompressed into a new buffer at the end if it is compressed
+  SafeInt<size_t> raw_data_safe_len = GetStoredByteSize(*external_data_info, tensor_byte_size);
 
   if (external_data_file_path == onnxruntime::utils::kTensorProtoMemoryAddressTag) {
     // the value in location is the memory address of the data
@@ -1092,6 +1160,21 @@ Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& mo
 #endif
   }
 
+  if (external_data_info->GetCompression() != ExternalDataInfo::Compression::kNone) {
+    // the stored data is only needed until it is decompressed
+    ScopedOrtCallbackInvoker stored_data_deleter(ext_data_deleter);
+    ext_data_deleter = OrtCallback{nullptr, nullptr};
+    auto buffer = std::make_unique<char[]>(tensor_byte_size);
+    ORT_RETURN_IF_ERROR(DecompressExternalData(
+        gsl::make_span(static_cast<const uint8_t*>(ext_data_buf), static_cast<size_t>(raw_data_safe_len)),
+        external_data_info->GetShuffleElementSize(),
+        gsl::make_span(reinterpret_cast<uint8_t*>(buffer.get()), static_cast<size_t>(tensor_byte_size)),
+        thread_pool));
+    ext_data_deleter = OrtCallback{DeleteCharArray, buffer.get()};
+    ext_data_buf = buffer.release();
+    ext_data_len = tensor_byte_size;
+  }
+
   return Status::OK();
 }
 
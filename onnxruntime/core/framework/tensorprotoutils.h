@@ -21,6 +21,10 @@
 #include "core/platform/env.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
 namespace utils {
 /**
  * This function is used to convert the endianess of Tensor data.
@@ -153,11 +157,19 @@ constexpr const ORTCHAR_T* kTensorProtoMemoryAddressTag = ORT_TSTR("*/_ORT_MEM_A
 // buffered_tensor is not null, buffered_tensor holds the real buffer pointed
 // by tensor_proto. buffered_tensor must be the owner of the buffer and deleter
 // should release the buffer when tensor_proto is released.
+// Compressed external data is decompressed into a new buffer, in parallel if thread_pool is not null.
 common::Status GetExtDataFromTensorProto(const Env& env, const std::filesystem::path& model_path,
                                          const ONNX_NAMESPACE::TensorProto& tensor_proto,
                                          void*& ext_data_buf, SafeInt<size_t>& ext_data_len,
                                          OrtCallback& ext_data_deleter,
-                                         Tensor* buffered_tensor = nullptr);
+                                         Tensor* buffered_tensor = nullptr,
+                                         concurrency::ThreadPool* thread_pool = nullptr);
+
+// Hints the OS to start reading the external data of the given tensor protos into the page cache, so that it is
+// read while other work is done. The ranges of each external data file are coalesced. Tensor protos without external
+// data in a file are ignored.
+common::Status PrefetchExternalData(const Env& env, const std::filesystem::path& model_path,
+                                    gsl::span<const ONNX_NAMESPACE::TensorProto* const> tensor_protos);
 
 // Convert the AttributeProto from a Constant node into a TensorProto that can be used as an initializer
 // If AttributeProto contains a TensorProto, this tensor proto is converted as is including the case when the
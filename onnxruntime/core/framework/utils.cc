@@ -20,6 +20,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/framework/TensorSeq.h"
+#include "core/framework/run_memory_budget.h"
 #include "core/framework/run_options.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #ifdef ENABLE_TRAINING
@@ -624,7 +625,8 @@ ExecuteGraphImpl(const SessionState& session_state,
                  DeviceStreamCollection* device_stream_collection,
 #endif
                  const bool only_execute_path_to_fetches = false,
-                 Stream* parent_stream = nullptr) {
+                 Stream* parent_stream = nullptr,
+                 RunMemoryBudget* memory_budget = nullptr) {
   const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
   const auto& device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
 #ifdef ORT_ENABLE_STREAM
@@ -656,7 +658,8 @@ ExecuteGraphImpl(const SessionState& session_state,
                                   terminate_flag,
                                   only_execute_path_to_fetches,
                                   // single thread mode
-                                  single_thread_mode));
+                                  single_thread_mode,
+                                  memory_budget));
     ORT_RETURN_IF_ERROR(status);
   } else {
     auto feeds_to_use = feeds;
@@ -704,7 +707,8 @@ ExecuteGraphImpl(const SessionState& session_state,
 #endif
                                   terminate_flag,
                                   only_execute_path_to_fetches,
-                                  single_thread_mode));
+                                  single_thread_mode,
+                                  memory_budget));
     ORT_RETURN_IF_ERROR(status);
     InlinedVector<Stream*> fetches_streams;
     fetches_streams.reserve(feeds_fetches_info.fetches_mlvalue_idxs.size());
@@ -742,7 +746,8 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
                             bool only_execute_path_to_fetches,
-                            Stream* parent_stream) {
+                            Stream* parent_stream,
+                            RunMemoryBudget* memory_budget) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
@@ -753,13 +758,15 @@ common::Status ExecuteGraph(const SessionState& session_state,
                                  execution_mode, terminate_flag, logger,
                                  device_stream_collection,
                                  only_execute_path_to_fetches,
-                                 parent_stream);
+                                 parent_stream,
+                                 memory_budget);
   return retval;
 #else
   return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
                           execution_mode, terminate_flag, logger,
                           only_execute_path_to_fetches,
-                          parent_stream);
+                          parent_stream,
+                          memory_budget);
 #endif
 }
 
@@ -771,6 +778,8 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
                             const logging::Logger& logger) {
+  std::unique_ptr<RunMemoryBudget> memory_budget;
+  ORT_RETURN_IF_ERROR(RunMemoryBudget::Create(run_options, memory_budget));
   return ExecuteGraph(session_state,
                       feeds_fetches_manager,
                       feeds, fetches,
@@ -780,7 +789,36 @@ common::Status ExecuteGraph(const SessionState& session_state,
 #ifdef ORT_ENABLE_STREAM
                       device_stream_collection_holder,
 #endif
-                      run_options.only_execute_path_to_fetches);
+                      run_options.only_execute_path_to_fetches,
+                      nullptr,
+                      memory_budget.get());
+}
+
+common::Status ExecuteGraphWithFinalizedCopyInfo(const SessionState& session_state,
+                                                 const FeedsFetchesManager& feeds_fetches_manager,
+                                                 gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                                 ExecutionMode execution_mode, const RunOptions& run_options,
+#ifdef ORT_ENABLE_STREAM
+                                                 DeviceStreamCollectionHolder& device_stream_collection_holder,
+#endif
+                                                 const logging::Logger& logger) {
+  std::unique_ptr<RunMemoryBudget> memory_budget;
+  ORT_RETURN_IF_ERROR(RunMemoryBudget::Create(run_options, memory_budget));
+#ifdef ORT_ENABLE_STREAM
+  DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+                          execution_mode, run_options.terminate, logger,
+                          device_stream_collection,
+                          run_options.only_execute_path_to_fetches,
+                          nullptr,
+                          memory_budget.get());
+#else
+  return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
+                          execution_mode, run_options.terminate, logger,
+                          run_options.only_execute_path_to_fetches,
+                          nullptr,
+                          memory_budget.get());
+#endif
 }
 
 #ifdef ENABLE_TRAINING
@@ -906,21 +944,39 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                bool sync_subgraph_fetches) {
 #ifdef ORT_ENABLE_STREAM
   DeviceStreamCollectionHolder device_stream_collection_holder(&session_state);
+  return ExecuteSubgraph(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                         execution_mode, terminate_flag, logger, device_stream_collection_holder, parent_stream,
+                         sync_subgraph_fetches);
+#else
+  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
+                                 execution_mode, terminate_flag, logger, false, parent_stream);
+  if (retval.IsOK() && sync_subgraph_fetches && parent_stream) {
+    parent_stream->Flush();
+  }
+  return retval;
+#endif
+}
+
+#ifdef ORT_ENABLE_STREAM
+common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                               gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
+                               DeviceStreamCollectionHolder& device_stream_collection_holder,
+                               Stream* parent_stream,
+                               bool sync_subgraph_fetches) {
   DeviceStreamCollection* device_stream_collection = device_stream_collection_holder.p_.get();
 
   auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
                                  execution_mode, terminate_flag, logger, device_stream_collection, false, parent_stream);
   if (device_stream_collection)
     ORT_CHECK_AND_SET_RETVAL(device_stream_collection->CleanUp(false));
-#else
-  auto retval = ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, fetch_allocators,
-                                 execution_mode, terminate_flag, logger, false, parent_stream);
-#endif
   if (retval.IsOK() && sync_subgraph_fetches && parent_stream) {
     parent_stream->Flush();
   }
   return retval;
 }
+#endif
 
 int32_t ONNXTensorElementDataTypeToProtoTensorType(ONNXTensorElementDataType onnx_enum) {
   switch (onnx_enum) {
@@ -23,6 +23,7 @@ class IExecutionProvider;
 class Node;
 class Tensor;
 struct KernelCreateInfo;
+class RunMemoryBudget;
 #ifdef ENABLE_TRAINING
 struct PartialGraphExecutionState;
 typedef InlinedHashMap<std::string, OrtValue> OrtValueCache;
@@ -88,7 +89,9 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
                             DeviceStreamCollectionHolder& device_stream_collection_holder,
 #endif
                             bool only_execute_path_to_fetches = false,
-                            Stream* parent_stream = nullptr);
+                            Stream* parent_stream = nullptr,
+                            // optional budget to charge the allocations of the run to
+                            RunMemoryBudget* memory_budget = nullptr);
 
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
@@ -98,6 +101,17 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
 #endif
                             const logging::Logger& logger);
 
+// Execute the main graph with a feeds_fetches_manager that was initialized with InitializeFeedFetchCopyInfo and
+// finalized for the devices of feeds and fetches.
+common::Status ExecuteGraphWithFinalizedCopyInfo(const SessionState& session_state,
+                                                 const FeedsFetchesManager& feeds_fetches_manager,
+                                                 gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                                 ExecutionMode execution_mode, const RunOptions& run_options,
+#ifdef ORT_ENABLE_STREAM
+                                                 DeviceStreamCollectionHolder& device_stream_collection_holder,
+#endif
+                                                 const logging::Logger& logger);
+
 #ifdef ENABLE_TRAINING
 common::Status ExecutePartialGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                                    std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches,
@@ -120,6 +134,19 @@ common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFet
                                subgraph fetches, i.e. the loop condition*/
                                bool sync_subgraph_fetches = false);
 
+#ifdef ORT_ENABLE_STREAM
+// Execute a subgraph using the device streams held by device_stream_collection_holder. Control flow kernels that run
+// their subgraph repeatedly (Loop, Scan) hold the device streams for all the iterations instead of acquiring them from
+// the session state in each iteration. The buffers of the streams are released after each execution.
+common::Status ExecuteSubgraph(const SessionState& session_state, const FeedsFetchesManager& feeds_fetches_manager,
+                               gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                               const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
+                               ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
+                               DeviceStreamCollectionHolder& device_stream_collection_holder,
+                               Stream* parent_stream,
+                               bool sync_subgraph_fetches = false);
+#endif
+
 bool IsInputOnCpu(const Node& node, const KernelCreateInfo* p_kci, size_t index);
 bool IsOutputOnCpu(const Node& node, const KernelCreateInfo* p_kci, size_t index);
 
@@ -277,11 +277,15 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
   }
 
   if (ctx.getNumOutputs() > 1) {  // has present output
-    // copy the type from query to present key
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 1);
+    // copy the type from past key, or from query without past, to present key
+    const size_t kv_type_input_index = past_key_index >= 0 && hasInput(ctx, past_key_index)
+                                           ? static_cast<size_t>(past_key_index)
+                                           : 0;
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, kv_type_input_index, 1);
 
-    // copy the type from query to present value
-    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 2);
+    // copy the type from past value, or from query without past, to present value
+    ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(
+        ctx, kv_type_input_index == 0 ? 0 : kv_type_input_index + 1, 2);
 
     if (past_key_index >= 0 && hasInputShape(ctx, past_key_index)) {
       auto& past_shape = getInputShape(ctx, past_key_index);
@@ -318,8 +322,27 @@ void BaseGroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceConte
 
 void GroupQueryAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
   // TODO(aciddelgado): propagate output shapes depending if kv-share buffer is on or not
-  constexpr int use_max_past_present_buffer = -1;
+  // A paged kv-cache (input 9, block_table) is always updated in place, so present has the shape of past,
+  // and so does a ring buffer kv cache.
+  const bool ring_buffer_kv_cache =
+      getAttribute(ctx, "num_sink_tokens", -1) >= 0 && getAttribute(ctx, "local_window_size", -1) > 0;
+  const int use_max_past_present_buffer = ctx.hasInput(9) || ring_buffer_kv_cache ? 1 : -1;
   BaseGroupQueryAttentionTypeAndShapeInference(ctx, past_key_index, use_max_past_present_buffer);
+
+  // The scales of an int8 kv cache have the shape of the kv cache without the head size.
+  for (size_t output_index = 3; output_index < 5 && output_index < ctx.getNumOutputs(); output_index++) {
+    updateOutputElemType(ctx, output_index, ONNX_NAMESPACE::TensorProto::FLOAT);
+    const auto* present_type = ctx.getOutputType(output_index - 2);
+    if (present_type != nullptr && present_type->tensor_type().has_shape() &&
+        present_type->tensor_type().shape().dim_size() == 4) {
+      const auto& present_shape = present_type->tensor_type().shape();
+      ONNX_NAMESPACE::TensorShapeProto scale_shape;
+      for (int i = 0; i < 3; i++) {
+        *scale_shape.add_dim() = present_shape.dim(i);
+      }
+      updateOutputShape(ctx, output_index, scale_shape);
+    }
+  }
 }
 
 void SparseAttentionTypeAndShapeInference(ONNX_NAMESPACE::InferenceContext& ctx, int past_key_index) {
@@ -1067,6 +1090,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
               "left_window_size for local attention (like Mistral). Default value is -1 meaning unused.",
               AttributeProto::INT,
               static_cast<int64_t>(-1))
+        .Attr("num_sink_tokens",
+              "Number of first tokens (attention sinks, like StreamingLLM) attended besides the local window. "
+              "When set (>= 0) with local_window_size, past and present kv are a ring buffer of "
+              "num_sink_tokens + local_window_size + 1 tokens, so their size is bounded for any total sequence "
+              "length. Only supported on CPU. Default value is -1 meaning unused.",
+              AttributeProto::INT,
+              static_cast<int64_t>(-1))
         .Attr("do_rotary",
               "Whether to use rotary position embedding. Default value is 0.",
               AttributeProto::INT,
@@ -1094,13 +1124,13 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "past_key",
                "past state key with support for format BNSH. When past_key uses same tensor as present_key"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(4,
                "past_value",
                "past state value with support for format BNSH. When past_value uses same tensor as present_value"
                "(k-v cache), it is of length max_sequence_length... otherwise of length past_sequence_length.",
-               "T",
+               "T_CACHE",
                OpSchema::Optional)
         .Input(5,
                "seqlens_k",
@@ -1121,6 +1151,27 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                "2D tensor with shape (max_sequence_length, head_size / 2).",
                "T",
                OpSchema::Optional)
+        .Input(9,
+               "block_table",
+               "2D tensor with shape (batch_size, max_blocks_per_sequence) mapping the tokens of each sequence to "
+               "blocks of a paged kv-cache. When given, past_key and past_value are pools of blocks with shape "
+               "(num_blocks, kv_num_heads, block_size, head_size), token t of sequence b is in block "
+               "block_table[b][t / block_size], and present_key and present_value have the shape of the past ones.",
+               "M",
+               OpSchema::Optional)
+        .Input(10,
+               "past_key_scale",
+               "Scales of an int8 past_key with shape (batch_size, kv_num_heads, past_sequence_length), one per token "
+               "and kv head: the key of token t is past_key[b][n][t] * past_key_scale[b][n][t]. Required when "
+               "past_key is int8.",
+               "T_SCALE",
+               OpSchema::Optional)
+        .Input(11,
+               "past_value_scale",
+               "Scales of an int8 past_value with shape (batch_size, kv_num_heads, past_sequence_length). Required "
+               "when past_value is int8.",
+               "T_SCALE",
+               OpSchema::Optional)
         .Output(0,
                 "output",
                 "3D output tensor with shape (batch_size, sequence_length, hidden_size)",
@@ -1130,14 +1181,30 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
                 "present state key with support for format BNSH. When past_key uses same tensor as present_key"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
         .Output(2,
                 "present_value",
                 "present state value with support for format BNSH. When past_value uses same tensor as present_value"
                 "(k-v buffer), it is of length max_sequence_length... otherwise of length past_sequence_length +"
                 "kv_sequence_length.",
-                "T")
+                "T_CACHE")
+        .Output(3,
+                "present_key_scale",
+                "Scales of an int8 present_key with shape (batch_size, kv_num_heads, present_sequence_length). The new "
+                "keys are quantized as they are appended, with a symmetric scale of max(abs(key)) / 127 per token and "
+                "kv head. Required when past_key is int8.",
+                "T_SCALE",
+                OpSchema::Optional)
+        .Output(4,
+                "present_value_scale",
+                "Scales of an int8 present_value with shape (batch_size, kv_num_heads, present_sequence_length). "
+                "Required when past_value is int8.",
+                "T_SCALE",
+                OpSchema::Optional)
         .TypeConstraint("T", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)"}, "Constrain input and output to float tensors.")
+        .TypeConstraint("T_CACHE", {"tensor(float16)", "tensor(bfloat16)", "tensor(float)", "tensor(int8)"},
+                        "Constrain the kv cache to the type of the query, or to int8 for a quantized kv cache.")
+        .TypeConstraint("T_SCALE", {"tensor(float)"}, "Constrain the scales of a quantized kv cache to float tensors.")
         .TypeConstraint("M", {"tensor(int32)"}, "Constrain mask to int tensor.")
         .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
           GroupQueryAttentionTypeAndShapeInference(ctx, 3);
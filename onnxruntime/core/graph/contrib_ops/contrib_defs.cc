@@ -631,6 +631,29 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           return true;
         }));
 
+constexpr const char* FusedElementwise_ver1_doc = R"DOC(
+Computes a chain of elementwise operators in a single pass over the data.
+
+The values are numbered starting with the inputs, followed by the result of each operator in `ops`. Operator `i`
+reads the values `op_inputs[2 * i]` and `op_inputs[2 * i + 1]`, which refer to inputs or results of earlier operators,
+and the second of which is -1 for a unary operator. The result of the last operator is the output.
+
+Every input either has the shape of the output, which is the shape of the first input, or contains a single element
+that is broadcast. Supported operators: Add, Sub, Mul, Div, Abs, Erf, Exp, Neg, Reciprocal, Relu, Sigmoid, Sqrt and
+Tanh.)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    FusedElementwise, 1,
+    OpSchema()
+        .SetDoc(FusedElementwise_ver1_doc)
+        .Attr("ops", "The op types of the operators in the order of their evaluation.", AttributeProto::STRINGS)
+        .Attr("op_inputs", "The indices of the two values read by each operator.", AttributeProto::INTS)
+        .Input(0, "X", "The inputs of the operators. The first input has the shape of the output.", "T",
+               OpSchema::Variadic)
+        .Output(0, "Y", "The result of the last operator.", "T")
+        .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
+
 // Used to be ONNX 1.7 Inverse(12)
 // Comment out docs not to increase the binary size
 //
@@ -1321,6 +1344,14 @@ ONNX_MS_OPERATOR_SET_SCHEMA(GreedySearch, 1,
                                       "This is relevant only for the GPT2 model. If this attribute is missing, the `decoder` subgraph will be used for all decoding runs",
                                       AttributeProto::GRAPH, OPTIONAL_VALUE)
                                 .Attr("decoder", "Decoder subgraph to execute in a loop.", AttributeProto::GRAPH)
+                                .Attr("draft_decoder",
+                                      "A smaller decoder subgraph with the same inputs, outputs and vocabulary as `decoder`, used for speculative decoding. "
+                                      "In each step it proposes `num_speculative_tokens` tokens, which the `decoder` subgraph verifies in a single run. "
+                                      "Only supported for GPT2 models with batch_size 1 on CPU",
+                                      AttributeProto::GRAPH, OPTIONAL_VALUE)
+                                .Attr("num_speculative_tokens",
+                                      "Number of tokens proposed by the `draft_decoder` subgraph in each step of speculative decoding",
+                                      AttributeProto::INT, static_cast<int64_t>(4))
                                 .Attr("vocab_size",
                                       "Size of the vocabulary. "
                                       "If not provided, it will be inferred from the decoder subgraph's output shape",
@@ -1407,6 +1438,100 @@ ONNX_MS_OPERATOR_SET_SCHEMA(MoE, 1,
                                 .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain input and output types to float or float16 tensors.")
                                 .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
 
+constexpr const char* BatchedLoRA_ver1_doc = R"DOC(
+      Applies a different low-rank adapter (LoRA) to each entry of a batch: for the rows of batch entry b,
+      output = base + scaling * (input x lora_A[adapter_ids[b]]) x lora_B[adapter_ids[b]].
+      Entries with adapter id -1 get the base (or zeros) only. The adapters of all the entries are
+      run as one grouped GEMM, so one batch can serve requests for many adapters of the same base model.
+      )DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(BatchedLoRA, 1,
+                            OpSchema()
+                                .SetDoc(BatchedLoRA_ver1_doc)
+                                .Attr("scaling", "Scale of the adapter outputs, usually alpha / rank", AttributeProto::FLOAT, 1.0f)
+                                .Input(0, "input", "N-D input tensor with shape (batch_size, ..., hidden_size)", "T")
+                                .Input(1, "lora_A", "3D input tensor with shape (num_adapters, hidden_size, rank)", "T")
+                                .Input(2, "lora_B", "3D input tensor with shape (num_adapters, rank, output_size)", "T")
+                                .Input(3, "adapter_ids", "1D input tensor with shape (batch_size), the adapter of each batch entry or -1 for none", "I")
+                                .Input(4, "base", "Optional output of the base projection with shape (batch_size, ..., output_size) the adapters are added to", "T", OpSchema::Optional)
+                                .Output(0, "output", "N-D output tensor with shape (batch_size, ..., output_size)", "T")
+                                .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+                                .TypeConstraint("I", {"tensor(int32)"}, "Constrain adapter ids to int32 tensors.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  propagateElemTypeFromInputToOutput(ctx, 0, 0);
+                                  if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 2)) {
+                                    return;
+                                  }
+                                  const auto& lora_b_shape = getInputShape(ctx, 2);
+                                  if (lora_b_shape.dim_size() != 3) {
+                                    fail_shape_inference("lora_B is expected to have 3 dimensions, got ", lora_b_shape.dim_size());
+                                  }
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape = getInputShape(ctx, 0);
+                                  if (output_shape.dim_size() < 2) {
+                                    fail_shape_inference("input is expected to have at least 2 dimensions, got ", output_shape.dim_size());
+                                  }
+                                  *output_shape.mutable_dim(output_shape.dim_size() - 1) = lora_b_shape.dim(2);
+                                  updateOutputShape(ctx, 0, output_shape);
+                                }));
+
+constexpr const char* EmbeddingBag_ver1_doc = R"DOC(
+      Reduces the rows of an embedding table selected by each bag of indices, without materializing the gathered
+      rows, e.g. for the sparse features of recommendation models. The bags are either the rows of a 2D indices
+      tensor, or the ranges of a 1D indices tensor that start at each of the offsets. An empty bag gives zeros.
+      Indices may be negative, counting from the end of the table like in Gather.
+      An int8 table is dequantized with one scale per row. A float16 table gives a float16 output, the others a
+      float output, and the reduction is done in float.
+      )DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(EmbeddingBag, 1,
+                            OpSchema()
+                                .SetDoc(EmbeddingBag_ver1_doc)
+                                .Attr("mode", "Reduction of the rows of each bag: sum, mean or max", AttributeProto::STRING, std::string("sum"))
+                                .Input(0, "table", "2D input tensor with shape (num_embeddings, embedding_dim)", "T1")
+                                .Input(1, "indices", "The rows of the table, a 2D tensor with shape (batch_size, bag_size), or a 1D tensor with shape (num_indices) when offsets is given", "Tind")
+                                .Input(2, "offsets", "Optional 1D input tensor with shape (batch_size), the start of each bag in the 1D indices, in increasing order", "Tind", OpSchema::Optional)
+                                .Input(3, "per_sample_weights", "Optional weights of the rows with the shape of indices, for the sum mode only", "tensor(float)", OpSchema::Optional)
+                                .Input(4, "scales", "1D input tensor with shape (num_embeddings), the dequantization scales of the rows of an int8 table", "tensor(float)", OpSchema::Optional)
+                                .Output(0, "output", "2D output tensor with shape (batch_size, embedding_dim)", "T")
+                                .TypeConstraint("T1", {"tensor(float)", "tensor(float16)", "tensor(int8)"}, "Constrain the table to float, float16 or int8 tensors.")
+                                .TypeConstraint("T", {"tensor(float)", "tensor(float16)"}, "Constrain the output to float or float16 tensors.")
+                                .TypeConstraint("Tind", {"tensor(int32)", "tensor(int64)"}, "Constrain indices and offsets to integer tensors.")
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  const auto* table_type = ctx.getInputType(0);
+                                  if (table_type == nullptr || !table_type->has_tensor_type()) {
+                                    fail_type_inference("table is expected to be a tensor");
+                                  }
+                                  updateOutputElemType(ctx, 0,
+                                                       table_type->tensor_type().elem_type() == ONNX_NAMESPACE::TensorProto::FLOAT16
+                                                           ? ONNX_NAMESPACE::TensorProto::FLOAT16
+                                                           : ONNX_NAMESPACE::TensorProto::FLOAT);
+                                  if (!hasInputShape(ctx, 0) || !hasInputShape(ctx, 1)) {
+                                    return;
+                                  }
+                                  const auto& table_shape = getInputShape(ctx, 0);
+                                  const auto& indices_shape = getInputShape(ctx, 1);
+                                  if (table_shape.dim_size() != 2) {
+                                    fail_shape_inference("table is expected to have 2 dimensions, got ", table_shape.dim_size());
+                                  }
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape;
+                                  if (ctx.hasInput(2)) {
+                                    if (indices_shape.dim_size() != 1) {
+                                      fail_shape_inference("indices is expected to have 1 dimension with offsets, got ", indices_shape.dim_size());
+                                    }
+                                    if (!hasInputShape(ctx, 2)) {
+                                      return;
+                                    }
+                                    *output_shape.add_dim() = getInputShape(ctx, 2).dim(0);
+                                  } else {
+                                    if (indices_shape.dim_size() != 2) {
+                                      fail_shape_inference("indices is expected to have 2 dimensions without offsets, got ", indices_shape.dim_size());
+                                    }
+                                    *output_shape.add_dim() = indices_shape.dim(0);
+                                  }
+                                  *output_shape.add_dim() = table_shape.dim(1);
+                                  updateOutputShape(ctx, 0, output_shape);
+                                }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QMoE, 1,
     OpSchema()
@@ -1933,6 +2058,83 @@ ONNX_MS_OPERATOR_SET_SCHEMA(Tokenizer, 1,
                                   updateOutputShape(ctx, 0, output_shape);
                                 }));
 
+constexpr const char* SubwordTokenizer_ver1_doc = R"DOC(
+  SubwordTokenizer splits each string of the 1D input X into the ids of the pieces of a subword vocabulary, for
+  text in, text out pipelines that run in one session. The strings are split at whitespace, each word starting with
+  the word boundary marker U+2581 of SentencePiece, then the words are split into pieces with either:
+  - the BPE model, merging the adjacent pieces by the priority of the merges, a character not in the vocab giving
+    unk_id;
+  - the Unigram model, choosing the pieces of the word with the highest sum of scores, an unknown character
+    giving unk_id.
+  The output Y has the shape [N, D], D being the largest number of ids of a string, the others padded with pad_id.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(SubwordTokenizer, 1,
+                            OpSchema()
+                                .Input(0, "X", "1D tensor of the strings to tokenize", "T")
+                                .Output(0, "Y", "2D tensor of the ids of the pieces of each string", "tensor(int64)")
+                                .Output(1, "lengths", "1D tensor of the number of ids of each string", "tensor(int64)", OpSchema::Optional)
+                                .TypeConstraint("T", {"tensor(string)"}, "Input is a string tensor")
+                                .Attr("model", "The subword model, bpe or unigram", AttributeProto::STRING, std::string("bpe"))
+                                .Attr("vocab", "The pieces of the vocabulary, a piece id being its index", AttributeProto::STRINGS)
+                                .Attr("merges", "BPE only: the merges of 2 pieces, separated by a space, in priority order", AttributeProto::STRINGS, OPTIONAL_VALUE)
+                                .Attr("scores", "Unigram only: the log probability of each piece of the vocabulary", AttributeProto::FLOATS, OPTIONAL_VALUE)
+                                .Attr("unk_id", "The id of the unknown piece", AttributeProto::INT, static_cast<int64_t>(0))
+                                .Attr("pad_id", "The id padding the rows of Y", AttributeProto::INT, static_cast<int64_t>(0))
+                                .SetDoc(SubwordTokenizer_ver1_doc)
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::INT64);
+                                  if (ctx.getNumOutputs() > 1) {
+                                    updateOutputElemType(ctx, 1, ONNX_NAMESPACE::TensorProto::INT64);
+                                  }
+                                  if (!hasInputShape(ctx, 0)) {
+                                    return;
+                                  }
+                                  auto& input_shape = getInputShape(ctx, 0);
+                                  if (input_shape.dim_size() != 1) {
+                                    fail_shape_inference("Input X is expected to have 1 dimension, got ", input_shape.dim_size());
+                                  }
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape;
+                                  *output_shape.add_dim() = input_shape.dim(0);
+                                  output_shape.add_dim();
+                                  updateOutputShape(ctx, 0, output_shape);
+                                  if (ctx.getNumOutputs() > 1) {
+                                    ONNX_NAMESPACE::TensorShapeProto lengths_shape;
+                                    *lengths_shape.add_dim() = input_shape.dim(0);
+                                    updateOutputShape(ctx, 1, lengths_shape);
+                                  }
+                                }));
+
+constexpr const char* SubwordDetokenizer_ver1_doc = R"DOC(
+  SubwordDetokenizer joins the pieces of the ids along the last axis of the input into a string, the reverse of
+  SubwordTokenizer: the word boundary markers U+2581 of the pieces become spaces, the one of the first word being
+  dropped. An input of shape [L] gives a scalar string, an input of shape [N, L] gives N strings.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(SubwordDetokenizer, 1,
+                            OpSchema()
+                                .Input(0, "ids", "1D or 2D tensor of the ids of the pieces", "tensor(int64)")
+                                .Output(0, "text", "The strings, with the shape of ids without its last dimension", "T")
+                                .TypeConstraint("T", {"tensor(string)"}, "Output is a string tensor")
+                                .Attr("vocab", "The pieces of the vocabulary, a piece id being its index", AttributeProto::STRINGS)
+                                .Attr("skip_ids", "The ids left out of the strings, e.g. padding or end of sequence", AttributeProto::INTS, OPTIONAL_VALUE)
+                                .SetDoc(SubwordDetokenizer_ver1_doc)
+                                .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+                                  updateOutputElemType(ctx, 0, ONNX_NAMESPACE::TensorProto::STRING);
+                                  if (!hasInputShape(ctx, 0)) {
+                                    return;
+                                  }
+                                  auto& input_shape = getInputShape(ctx, 0);
+                                  if (input_shape.dim_size() < 1 || input_shape.dim_size() > 2) {
+                                    fail_shape_inference("Input ids is expected to have 1 or 2 dimensions, got ", input_shape.dim_size());
+                                  }
+                                  ONNX_NAMESPACE::TensorShapeProto output_shape;
+                                  if (input_shape.dim_size() == 2) {
+                                    *output_shape.add_dim() = input_shape.dim(0);
+                                  }
+                                  updateOutputShape(ctx, 0, output_shape);
+                                }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(MatMulInteger16, 1,
                             OpSchema()
                                 .SetDoc(R"DOC(
@@ -3320,6 +3522,22 @@ void RegisterContribSchemas() {
           AttributeProto::STRING,
           OPTIONAL_VALUE)
       .Attr("notes", "(Optional) Some notes for the model", AttributeProto::STRING, OPTIONAL_VALUE)
+      .Attr(
+          "variant_ep_cache_contexts",
+          "(Optional) Contexts compiled for other devices in addition to ep_cache_context, following embed_mode. "
+          "The EP loads the one matching its hardware architecture and SDK version.",
+          AttributeProto::STRINGS,
+          OPTIONAL_VALUE)
+      .Attr(
+          "variant_hardware_architectures",
+          "(Optional) Hardware architecture of each of variant_ep_cache_contexts.",
+          AttributeProto::STRINGS,
+          OPTIONAL_VALUE)
+      .Attr(
+          "variant_ep_sdk_versions",
+          "(Optional) SDK version of each of variant_ep_cache_contexts.",
+          AttributeProto::STRINGS,
+          OPTIONAL_VALUE)
       .AllowUncheckedAttributes()
       .Input(
           0,
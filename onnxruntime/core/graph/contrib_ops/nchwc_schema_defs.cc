@@ -169,6 +169,77 @@ void RegisterNchwcSchemas() {
         ONNX_NAMESPACE::convPoolShapeInference(ctx, true, false, 0, 1);
       });
 
+  ONNX_CONTRIB_OPERATOR_SCHEMA(ConvChain)
+      .SetDomain(kMSNchwcDomain)
+      .SinceVersion(1)
+      .SetDoc(R"DOC(For internal use.)DOC")
+      .Attr("kernel_shapes", "", AttributeProto::INTS)
+      .Attr("dilations", "", AttributeProto::INTS)
+      .Attr("strides", "", AttributeProto::INTS)
+      .Attr("pads", "", AttributeProto::INTS)
+      .Attr("groups", "", AttributeProto::INTS)
+      .Attr("activations", "", AttributeProto::STRINGS)
+      .Attr("activation_params", "", AttributeProto::FLOATS)
+      .Input(0, "X", "", "T")
+      .Input(1, "WB", "", "T", OpSchema::Variadic)
+      .Output(0, "Y", "", "T")
+      .TypeConstraint("T", {"tensor(float)"}, "Constrain input and output types to float tensors")
+      .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+        ONNX_NAMESPACE::propagateElemTypeFromInputToOutput(ctx, 0, 0);
+        if (!hasNInputShapes(ctx, 1)) {
+          return;
+        }
+
+        std::vector<int64_t> kernel_shapes, dilations, strides, pads;
+        if (!getRepeatedAttribute(ctx, "kernel_shapes", kernel_shapes) ||
+            !getRepeatedAttribute(ctx, "dilations", dilations) ||
+            !getRepeatedAttribute(ctx, "strides", strides) ||
+            !getRepeatedAttribute(ctx, "pads", pads)) {
+          return;
+        }
+
+        const size_t stage_count = kernel_shapes.size() / 2;
+        if (ctx.getNumInputs() != 1 + 2 * stage_count || dilations.size() != 2 * stage_count ||
+            strides.size() != 2 * stage_count || pads.size() != 4 * stage_count) {
+          fail_shape_inference("invalid ConvChain attributes");
+        }
+
+        const auto& input_shape = ctx.getInputType(0)->tensor_type().shape();
+        if (input_shape.dim_size() != 4) {
+          fail_shape_inference("tensor rank must be 4");
+        }
+
+        auto* output_shape = ctx.getOutputType(0)->mutable_tensor_type()->mutable_shape();
+        *output_shape->add_dim() = input_shape.dim(0);
+
+        // The channels are the output channels of the filter of the last convolution.
+        auto* output_channel_dim = output_shape->add_dim();
+        if (hasInputShape(ctx, 2 * stage_count - 1)) {
+          const auto& W_shape = getInputShape(ctx, 2 * stage_count - 1);
+          if (W_shape.dim_size() > 0) {
+            *output_channel_dim = W_shape.dim(0);
+          }
+        }
+
+        for (int dim = 0; dim < 2; dim++) {
+          auto* output_dim = output_shape->add_dim();
+          if (!input_shape.dim(2 + dim).has_dim_value()) {
+            continue;
+          }
+
+          int64_t size = input_shape.dim(2 + dim).dim_value();
+          for (size_t i = 0; i < stage_count; i++) {
+            const int64_t dilated_kernel_size = (kernel_shapes[2 * i + dim] - 1) * dilations[2 * i + dim] + 1;
+            const int64_t padded_size = size + pads[4 * i + dim] + pads[4 * i + dim + 2];
+            if (padded_size < dilated_kernel_size || strides[2 * i + dim] <= 0) {
+              fail_shape_inference("ConvChain input is smaller than the kernel");
+            }
+            size = (padded_size - dilated_kernel_size) / strides[2 * i + dim] + 1;
+          }
+          output_dim->set_dim_value(size);
+        }
+      });
+
   ONNX_CONTRIB_OPERATOR_SCHEMA(MaxPool)
       .FillUsing(NchwcPoolOpSchemaGenerator)
       .Attr("storage_order", "", AttributeProto::INT, static_cast<int64_t>(0));
@@ -600,6 +600,35 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
         .TypeConstraint("T", {"tensor(uint8)", "tensor(int8)"}, "Constrain input and output types to 8 bit tensors.")
         .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
 
+const char* QLinearGeluDoc_ver1 = R"DOC(
+QLinearGelu takes quantized input data (Tensor), and quantize parameter for output, and produces one output data
+(Tensor<T>) where the function `f(x) = quantize(Gelu(dequantize(x)))`, is applied to the data tensor elementwise.
+Where the function `Gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2)))`, or its tanh approximation when `approximate` is
+"tanh".)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    QLinearGelu, 1,
+    OpSchema()
+        .SetDoc(QLinearGeluDoc_ver1)
+        .Attr("approximate", "Gelu approximation algorithm: \"none\" or \"tanh\".", AttributeProto::STRING,
+              std::string("none"))
+        .Input(0, "X", "Input tensor", "T")
+        .Input(1, "X_scale", "Input X's scale. It's a scalar, which means a per-tensor/layer quantization.",
+               "tensor(float)")
+        .Input(2, "X_zero_point",
+               "Input X's zero point. Default value is 0 if it's not specified. It's a scalar, which means a "
+               "per-tensor/layer quantization.",
+               "T", OpSchema::Optional)
+        .Input(3, "Y_scale", "Output Y's scale. It's a scalar, which means a per-tensor/layer quantization.",
+               "tensor(float)")
+        .Input(4, "Y_zero_point",
+               "Output Y's zero point. Default value is 0 if it's not specified. It's a scalar, which means a "
+               "per-tensor/layer quantization.",
+               "T", OpSchema::Optional)
+        .Output(0, "Y", "Output tensor", "T")
+        .TypeConstraint("T", {"tensor(uint8)", "tensor(int8)"}, "Constrain input and output types to 8 bit tensors.")
+        .TypeAndShapeInferenceFunction(ONNX_NAMESPACE::propagateShapeAndTypeFromFirstInput));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QLinearSoftmax, 1,
     OpSchema()
@@ -17,6 +17,7 @@
 #include "core/common/narrow.h"
 #include "core/flatbuffers/flatbuffers_utils.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
+#include "core/framework/external_data_compression.h"
 #include "core/framework/tensor_shape.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
@@ -289,7 +290,33 @@ bool NodeArg::HasTensorOrScalarShape() const {
 }
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+// Whether the shapes have the same dimensions. Unlike the comparison of dimensions in tensorprotoutils.h, two unknown
+// dimensions or dimensions with the same empty dim_param are equal.
+static bool ShapeProtosEqual(const TensorShapeProto& lhs, const TensorShapeProto& rhs) {
+  if (lhs.dim_size() != rhs.dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < lhs.dim_size(); ++i) {
+    const auto& l = lhs.dim(i);
+    const auto& r = rhs.dim(i);
+    if (l.value_case() != r.value_case() || l.denotation() != r.denotation() ||
+        (l.has_dim_value() && l.dim_value() != r.dim_value()) ||
+        (l.has_dim_param() && l.dim_param() != r.dim_param())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 void NodeArg::SetShape(const TensorShapeProto& shape) {
+  // setting the inferred shape again is common, and doesn't require the consumers to be inferred again
+  const TensorShapeProto* current_shape = Shape();
+  if (current_shape == nullptr || !ShapeProtosEqual(*current_shape, shape)) {
+    type_changed_ = true;
+  }
+
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -321,6 +348,10 @@ void NodeArg::SetShape(const TensorShapeProto& shape) {
 }
 
 void NodeArg::ClearShape() {
+  if (Shape() != nullptr) {
+    type_changed_ = true;
+  }
+
   const auto type_case = node_arg_info_.type().value_case();
   switch (type_case) {
     case TypeProto::kTensorType:
@@ -384,6 +415,8 @@ common::Status NodeArg::OverrideTypesHelper(const ONNX_NAMESPACE::TypeProto& inp
 
 common::Status NodeArg::UpdateTypeAndShape(const ONNX_NAMESPACE::TypeProto& input_type, bool strict,
                                            bool override_types, const logging::Logger& logger) {
+  type_changed_ = true;
+
   if (!utils::HasType(node_arg_info_)) {
     SetType(input_type);
     return Status::OK();
@@ -506,6 +539,7 @@ void NodeArg::SetType(DataType p_type) {
   }
 
   type_ = p_type;
+  type_changed_ = true;
   *(node_arg_info_.mutable_type()) = DataTypeUtils::ToTypeProto(p_type);
 }
 
@@ -515,6 +549,7 @@ void NodeArg::SetType(DataType p_type) {
 
 void NodeArg::SetType(const TypeProto& type_proto) {
   type_ = DataTypeUtils::ToType(type_proto);
+  type_changed_ = true;
   *(node_arg_info_.mutable_type()) = type_proto;
 }
 
@@ -920,6 +955,7 @@ void Node::Init(std::string_view name,
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 Node::Definitions& Node::MutableDefinitions() noexcept {
   // someone fetching these is going to change something
+  inference_needed_ = true;
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
   return definitions_;
@@ -949,6 +985,7 @@ void Node::CreateSubgraph(const std::string& attr_name) {
 
 void Node::AddAttributeProto(AttributeProto value) {
   utils::SetNodeAttribute(std::move(value), attributes_);
+  inference_needed_ = true;
   if (graph_) {
     graph_->SetGraphResolveNeeded();
     graph_->SetGraphProtoSyncNeeded();
@@ -997,6 +1034,7 @@ void Node::AddAttribute(std::string attr_name, GraphProto value) {
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 bool Node::ClearAttribute(const std::string& attr_name) {
+  inference_needed_ = true;
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
   return attributes_.erase(attr_name) > 0;
@@ -1005,6 +1043,7 @@ bool Node::ClearAttribute(const std::string& attr_name) {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
 
 int Node::PruneRemovableAttributes(gsl::span<const std::string> removable_attributes) {
+  inference_needed_ = true;
   graph_->SetGraphResolveNeeded();
   graph_->SetGraphProtoSyncNeeded();
   int n_removed = 0;
@@ -3077,10 +3116,21 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     lsc.output_names.insert(std::string(input));
   }
 
+  // overriding the types may change the outputs of an unmodified node, so all nodes are inferred in that case
+  const bool incremental_inference = incremental_type_and_shape_inference_ && !IsSubgraph() &&
+                                     !options.override_types;
+
   for (auto node_index : nodes_in_topological_order_) {
     // Node verification.
     auto& node = *GetNode(node_index);
 
+    if (incremental_inference && !TypeAndShapeInferenceNeeded(node)) {
+      for (const auto& output : node.OutputDefs()) {
+        lsc.output_names.insert(output->Name());
+      }
+      continue;
+    }
+
     const auto& node_name = node.Name();
 
     if (!node.Op()) {
@@ -3167,6 +3217,7 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
     }
 
     NO_CHANGE_ON_SYNC_FLAG(ORT_RETURN_IF_ERROR(InferAndVerifyTypeMatch(node, *p_op, options)));
+    node.inference_needed_ = false;
 
     // Accumulate output names of the iterated Node
     for (const auto& output : node.OutputDefs()) {
@@ -3186,6 +3237,17 @@ Status Graph::VerifyNodeAndOpMatch(const ResolveOptions& options) {
   return Status::OK();
 }
 
+bool Graph::TypeAndShapeInferenceNeeded(const Node& node) const {
+  // the inference of a node with subgraphs depends on the subgraphs, which are always inferred
+  if (node.inference_needed_ || node.Op() == nullptr || node.ContainsSubgraph()) {
+    return true;
+  }
+
+  auto changed = [](const NodeArg* node_arg) { return node_arg->Exists() && node_arg->type_changed_; };
+  return std::any_of(node.InputDefs().begin(), node.InputDefs().end(), changed) ||
+         std::any_of(node.OutputDefs().begin(), node.OutputDefs().end(), changed);
+}
+
 Status Graph::VerifyInputAndInitializerNames() {
   std::unordered_set<std::string_view>& inputs_and_initializers = resolve_context_.inputs_and_initializers;
 
@@ -3216,7 +3278,8 @@ Status Graph::InitInputsInitializersOutputs() {
   // same applies to the implicit input defs as they are built from any subgraphs within this graph.
   for (auto& node : Nodes()) {
     node.MutableRelationships().Clear();
-    node.MutableDefinitions().implicit_input_defs.clear();
+    // not via MutableDefinitions, as rebuilding the implicit inputs doesn't require the node to be inferred again
+    node.definitions_.implicit_input_defs.clear();
   }
 
   // add the subgraph pointers to the resolve context.
@@ -3304,6 +3367,11 @@ Status Graph::Resolve(const ResolveOptions& options) {
             graph.CleanUnusedInitializersAndNodeArgs(options.initializer_names_to_preserve);
             graph.GraphResolveNeeded(false);
 
+            // the types and shapes are now consistent with the nodes
+            for (auto& node_arg : graph.node_args_) {
+              node_arg.second->type_changed_ = false;
+            }
+
             // if we are resolving immediately after loading from a GraphProto, we don't need to
             // do a proto sync
             if (options.no_proto_sync_required) {
@@ -3357,6 +3425,10 @@ void Graph::AddInitializedTensor(const TensorProto& tensor) {
   *(tensor_added) = tensor;
   name_to_initial_tensor_.emplace(tensor.name(), tensor_added);
   SetGraphResolveNeeded();
+  // the inference of the consumers may depend on the value of the initializer
+  if (auto* node_arg = GetNodeArg(tensor.name()); node_arg != nullptr) {
+    node_arg->type_changed_ = true;
+  }
   if (!is_loaded_from_model_file_ && GetNodeArg(tensor.name()) == nullptr) {
     // make sure there is a NodeArg for the initializer as SetGraphInputsOutputs may add it to the graph inputs.
     // the shape will be set to the correct value in TypeCheckInputsAndInitializers as we don't yet know whether there
@@ -3448,6 +3520,9 @@ void Graph::RemoveInitializedTensor(const std::string& tensor_name) {
     sparse_tensor_names_.erase(tensor_name);
 #endif
     SetGraphResolveNeeded();
+    if (auto* node_arg = GetNodeArg(tensor_name); node_arg != nullptr) {
+      node_arg->type_changed_ = true;
+    }
   } else {
 #if !defined(DISABLE_SPARSE_TENSORS)
     ORT_ENFORCE(sparse_tensor_names_.count(tensor_name) == 0,
@@ -3505,6 +3580,10 @@ Status Graph::ReplaceInitializedTensorImpl(ONNX_NAMESPACE::TensorProto new_initi
 
   **existing_entry = std::move(new_initializer);
 
+  if (auto* node_arg = GetNodeArg((*existing_entry)->name()); node_arg != nullptr) {
+    node_arg->type_changed_ = true;
+  }
+
   return Status::OK();
 }
 
@@ -3530,6 +3609,9 @@ Status Graph::InjectExternalInitializersFromFilesInMemory(
     if (tensor_proto->data_location() == TensorProto_DataLocation_EXTERNAL) {
       std::unique_ptr<onnxruntime::ExternalDataInfo> external_data_info;
       ORT_RETURN_IF_ERROR(onnxruntime::ExternalDataInfo::Create(tensor_proto->external_data(), external_data_info));
+      ORT_RETURN_IF(external_data_info->GetCompression() != ExternalDataInfo::Compression::kNone,
+                    "External initializer: ", tensor_name,
+                    " is compressed, which is not supported for external initializer files in memory.");
 
       const auto& external_file = external_data_info->GetRelPath();
       onnxruntime::FileOffsetType file_offset = external_data_info->GetOffset();
@@ -3736,7 +3818,8 @@ SaveInputsOutputsToOrtFormat(flatbuffers::FlatBufferBuilder& builder, const std:
 }
 
 common::Status Graph::SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder,
-                                      flatbuffers::Offset<fbs::Graph>& fbs_graph) const {
+                                      flatbuffers::Offset<fbs::Graph>& fbs_graph,
+                                      const fbs::utils::ExternalDataWriter& external_data_writer) const {
   if constexpr (endian::native != endian::little) {
     auto& tens = GetAllInitializedTensors();
     for (auto& [name, tensor_p] : tens) {
@@ -3765,7 +3848,7 @@ common::Status Graph::SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder,
     if (sparse_tensor_names_.find(pair.first) == sparse_end) {
       flatbuffers::Offset<fbs::Tensor> fbs_tensor;
       ORT_RETURN_IF_ERROR(
-          fbs::utils::SaveInitializerOrtFormat(builder, *pair.second, model_path, fbs_tensor));
+          fbs::utils::SaveInitializerOrtFormat(builder, *pair.second, model_path, fbs_tensor, external_data_writer));
       initializers_data.push_back(fbs_tensor);
     }
 #if !defined(DISABLE_SPARSE_TENSORS)
@@ -4021,7 +4104,8 @@ ONNX_NAMESPACE::GraphProto Graph::ToGraphProto() const {
 
 ONNX_NAMESPACE::GraphProto Graph::ToGraphProtoWithExternalInitializers(const std::filesystem::path& external_file_path,
                                                                        const std::filesystem::path& model_file_path,
-                                                                       size_t initializer_size_threshold) const {
+                                                                       size_t initializer_size_threshold,
+                                                                       bool compress_initializers) const {
   GraphProto result;
   ToGraphProtoInternal(result);
   ORT_ENFORCE(external_file_path.is_relative());
@@ -4059,7 +4143,29 @@ ONNX_NAMESPACE::GraphProto Graph::ToGraphProtoWithExternalInitializers(const std
         continue;
       }
 
-      for (size_t index = 0; index != tensor_bytes_size; ++index) {
+      // the bytes of floating point elements are shuffled, which lets them compress better
+      size_t shuffle_element_size = 0;
+      if (compress_initializers) {
+        switch (initializer.data_type()) {
+          case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+          case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+            shuffle_element_size = 2;
+            break;
+          case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+            shuffle_element_size = 4;
+            break;
+          case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+            shuffle_element_size = 8;
+            break;
+          default:
+            break;
+        }
+        std::vector<uint8_t> compressed;
+        ORT_THROW_IF_ERROR(utils::CompressExternalData(raw_data, shuffle_element_size, compressed));
+        raw_data = std::move(compressed);
+      }
+
+      for (size_t index = 0; index != raw_data.size(); ++index) {
         external_stream << raw_data[index];
       }
 
@@ -4072,7 +4178,17 @@ ONNX_NAMESPACE::GraphProto Graph::ToGraphProtoWithExternalInitializers(const std
       offset->set_value(std::to_string(external_offset));
       ONNX_NAMESPACE::StringStringEntryProto* length = output_proto->add_external_data();
       length->set_key("length");
-      length->set_value(std::to_string(tensor_bytes_size));
+      length->set_value(std::to_string(raw_data.size()));
+      if (compress_initializers) {
+        ONNX_NAMESPACE::StringStringEntryProto* compression = output_proto->add_external_data();
+        compression->set_key("compression");
+        compression->set_value("lz4");
+        if (shuffle_element_size > 1) {
+          ONNX_NAMESPACE::StringStringEntryProto* shuffle = output_proto->add_external_data();
+          shuffle->set_key("shuffle");
+          shuffle->set_value(std::to_string(shuffle_element_size));
+        }
+      }
 
       output_proto->set_name(initializer.name());
       output_proto->set_data_type(initializer.data_type());
@@ -4081,7 +4197,7 @@ ONNX_NAMESPACE::GraphProto Graph::ToGraphProtoWithExternalInitializers(const std
       }
       output_proto->set_doc_string(initializer.doc_string());
 
-      external_offset += tensor_bytes_size;
+      external_offset += raw_data.size();
 #if !defined(DISABLE_SPARSE_TENSORS)
     }
 #endif
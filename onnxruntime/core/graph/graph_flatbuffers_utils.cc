@@ -198,8 +198,7 @@ Status SaveAttributeOrtFormat(flatbuffers::FlatBufferBuilder& builder,
 /**
  * @brief Calculates how much memory will be required for putting contents of the given tensor into a plain array.
  *
- * complex64/complex128 tensors are not supported. The size is calculated from the dimensions and the data type,
- * to accommodate fbs::Tensors with external data.
+ * The size is calculated from the dimensions and the data type, to accommodate fbs::Tensors with external data.
  *
  * @param tensor flatbuffer representation of a tensor.
  * @return size_t size in bytes of the tensor's data.
@@ -252,6 +251,12 @@ size_t GetSizeInBytesFromFbsTensor(const fbs::Tensor& tensor) {
     case fbs::TensorDataType::BFLOAT16:
       byte_size_of_one_element = sizeof(BFloat16);
       break;
+    case fbs::TensorDataType::COMPLEX64:
+      byte_size_of_one_element = 2 * sizeof(float);
+      break;
+    case fbs::TensorDataType::COMPLEX128:
+      byte_size_of_one_element = 2 * sizeof(double);
+      break;
 #if !defined(DISABLE_FLOAT8_TYPES)
     case fbs::TensorDataType::FLOAT8E4M3FN:
       byte_size_of_one_element = sizeof(uint8_t);
@@ -274,6 +279,27 @@ size_t GetSizeInBytesFromFbsTensor(const fbs::Tensor& tensor) {
   return num_elements * byte_size_of_one_element;
 }
 
+// point the initializer to data that stays valid for the duration of the session instead of copying it
+static void SetInitializerDataAddress(TensorProto& initializer, const void* data, size_t num_bytes) {
+  initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
+
+  static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
+  // we reinterpret_cast this back to void* in tensorprotoutils.cc:GetExtDataFromTensorProto.
+  // use intptr_t as OFFSET_TYPE is signed. in theory you could get a weird looking value if the address uses the
+  // high bit, but that should be unlikely in a scenario where we care about memory usage enough to use this path.
+  auto offset = narrow<ExternalDataInfo::OFFSET_TYPE>(reinterpret_cast<intptr_t>(data));
+
+  ONNX_NAMESPACE::StringStringEntryProto* entry = initializer.mutable_external_data()->Add();
+  entry->set_key("location");
+  entry->set_value(ToUTF8String(onnxruntime::utils::kTensorProtoMemoryAddressTag));
+  entry = initializer.mutable_external_data()->Add();
+  entry->set_key("offset");
+  entry->set_value(std::to_string(offset));
+  entry = initializer.mutable_external_data()->Add();
+  entry->set_key("length");
+  entry->set_value(std::to_string(num_bytes));
+}
+
 Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& initializer,
                                 const OrtFormatLoadOptions& load_options,
                                 const ExternalDataReader& external_data_reader) {
@@ -300,24 +326,7 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& init
     const auto* fbs_raw_data = fbs_tensor.raw_data();
     if (fbs_raw_data) {
       if (load_options.can_use_flatbuffer_for_initializers && fbs_raw_data->size() > 127) {
-        initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
-
-        static_assert(sizeof(void*) <= sizeof(ExternalDataInfo::OFFSET_TYPE));
-        const void* data_offset = fbs_raw_data->Data();
-        // we reinterpret_cast this back to void* in tensorprotoutils.cc:GetExtDataFromTensorProto.
-        // use intptr_t as OFFSET_TYPE is signed. in theory you could get a weird looking value if the address uses the
-        // high bit, but that should be unlikely in a scenario where we care about memory usage enough to use this path.
-        auto offset = narrow<ExternalDataInfo::OFFSET_TYPE>(reinterpret_cast<intptr_t>(data_offset));
-
-        ONNX_NAMESPACE::StringStringEntryProto* entry = initializer.mutable_external_data()->Add();
-        entry->set_key("location");
-        entry->set_value(ToUTF8String(onnxruntime::utils::kTensorProtoMemoryAddressTag));
-        entry = initializer.mutable_external_data()->Add();
-        entry->set_key("offset");
-        entry->set_value(std::to_string(offset));
-        entry = initializer.mutable_external_data()->Add();
-        entry->set_key("length");
-        entry->set_value(std::to_string(fbs_raw_data->size()));
+        SetInitializerDataAddress(initializer, fbs_raw_data->Data(), fbs_raw_data->size());
       } else {
         // fbs_raw_data is uint8_t vector, so the size is byte size
         initializer.set_raw_data(fbs_raw_data->Data(), fbs_raw_data->size());
@@ -328,6 +337,23 @@ Status LoadInitializerOrtFormat(const fbs::Tensor& fbs_tensor, TensorProto& init
       // no external data. should have had raw data.
       ORT_RETURN_IF(external_data_offset < 0, "Missing raw data for initializer. Invalid ORT format model.");
 
+      // the data is in the data section of the model
+      if (!external_data_reader && !load_options.data_section.empty()) {
+        const auto& data_section = load_options.data_section;
+        auto num_bytes = GetSizeInBytesFromFbsTensor(fbs_tensor);
+        ORT_RETURN_IF(static_cast<uint64_t>(external_data_offset) > data_section.size() ||
+                          num_bytes > data_section.size() - static_cast<size_t>(external_data_offset),
+                      "Initializer data is outside of the data section. Invalid ORT format model.");
+
+        const uint8_t* data = data_section.data() + external_data_offset;
+        if (load_options.can_use_flatbuffer_for_initializers) {
+          SetInitializerDataAddress(initializer, data, num_bytes);
+        } else {
+          initializer.set_raw_data(data, num_bytes);
+        }
+        return Status::OK();
+      }
+
       // external data but no reader
       ORT_RETURN_IF(!external_data_reader, "Tensor has external data but a data reader was not provided.");
 
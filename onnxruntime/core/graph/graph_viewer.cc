@@ -71,6 +71,11 @@ GraphViewer::GraphViewer(const Graph& graph, const IndexedSubGraph* filter_info)
   // for non-CPU devices or for training case where some gradient graphs use only shape/size of tensors from forward.
   InlinedHashSet<NodeIndex> shape_size_nodes;
   InlinedHashMap<NodeIndex, InlinedVector<NodeIndex>> shape_size_parents;
+
+  // For the memory efficient order only, the nodes with a single input node that are prioritized to run early
+  // (negative priority) are also moved right after their parents. Otherwise the ones not contributing to the forward
+  // outputs, e.g. the copies offloading activations to host memory, are deferred to the backward pass.
+  InlinedHashMap<NodeIndex, InlinedVector<NodeIndex>> high_priority_parents;
 #endif
   for (auto& node : graph_->Nodes()) {
     // This is a leaf node (without any output node)
@@ -92,6 +97,10 @@ GraphViewer::GraphViewer(const Graph& graph, const IndexedSubGraph* filter_info)
       }
     }
 
+    if (node.Priority() < 0 && node.GetInputEdgesCount() == 1 && shape_size_nodes.count(node.Index()) == 0) {
+      high_priority_parents[node.InputNodesBegin()->Index()].push_back(node.Index());
+    }
+
     if (node.OpType() == "YieldOp") {
       yield_node = &node;
     }
@@ -139,6 +148,10 @@ GraphViewer::GraphViewer(const Graph& graph, const IndexedSubGraph* filter_info)
     std::vector<NodeIndex> node_orders;
     const size_t num_of_nodes = NumberOfNodes();
     node_orders.reserve(num_of_nodes);
+    for (const auto& [parent, children] : high_priority_parents) {
+      auto& following_nodes = shape_size_parents[parent];
+      following_nodes.insert(following_nodes.end(), children.begin(), children.end());
+    }
     graph_->MemoryEfficientTopologicalSort(
         yield_node,
         shape_size_parents,
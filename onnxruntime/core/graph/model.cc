@@ -383,12 +383,14 @@ ModelProto Model::ToProto() const {
 
 ModelProto Model::ToGraphProtoWithExternalInitializers(const std::filesystem::path& external_file_name,
                                                        const std::filesystem::path& file_path,
-                                                       size_t initializer_size_threshold) const {
+                                                       size_t initializer_size_threshold,
+                                                       bool compress_initializers) const {
   ModelProto result(model_proto_);
   const auto& graph = *graph_;
   *(result.mutable_graph()) = graph.ToGraphProtoWithExternalInitializers(external_file_name,
                                                                          file_path,
-                                                                         initializer_size_threshold);
+                                                                         initializer_size_threshold,
+                                                                         compress_initializers);
   return result;
 }
 
@@ -605,14 +607,15 @@ template <typename T>
 static Status SaveModelWithExternalInitializers(Model& model,
                                                 const T& file_path,
                                                 const std::filesystem::path& external_file_name,
-                                                size_t initializer_size_threshold) {
+                                                size_t initializer_size_threshold,
+                                                bool compress_initializers) {
   int fd = 0;
   Status status = Env::Default().FileOpenWr(file_path, fd);
   ORT_RETURN_IF_ERROR(status);
 
   ORT_TRY {
     status = Model::SaveWithExternalInitializers(model, fd, file_path, external_file_name,
-                                                 initializer_size_threshold);
+                                                 initializer_size_threshold, compress_initializers);
   }
   ORT_CATCH(const std::exception& ex) {
     ORT_HANDLE_EXCEPTION([&]() {
@@ -642,8 +645,10 @@ Status Model::Load(const PathString& file_path, std::shared_ptr<Model>& p_model,
 
 Status Model::SaveWithExternalInitializers(Model& model, const std::filesystem::path& file_path,
                                            const std::filesystem::path& external_file_name,
-                                           size_t initializer_size_threshold) {
-  return SaveModelWithExternalInitializers(model, file_path, external_file_name, initializer_size_threshold);
+                                           size_t initializer_size_threshold,
+                                           bool compress_initializers) {
+  return SaveModelWithExternalInitializers(model, file_path, external_file_name, initializer_size_threshold,
+                                           compress_initializers);
 }
 
 Status Model::LoadFromBytes(int count, void* p_bytes, /*out*/ ONNX_NAMESPACE::ModelProto& model_proto) {
@@ -759,7 +764,8 @@ Status Model::SaveWithExternalInitializers(Model& model,
                                            int fd,
                                            const std::filesystem::path& file_path,
                                            const std::filesystem::path& external_file_name,
-                                           size_t initializer_size_threshold) {
+                                           size_t initializer_size_threshold,
+                                           bool compress_initializers) {
   if (fd < 0) {
     return Status(ONNXRUNTIME, INVALID_ARGUMENT, "<fd> is less than 0.");
   }
@@ -767,7 +773,7 @@ Status Model::SaveWithExternalInitializers(Model& model,
   ORT_RETURN_IF_ERROR(model.MainGraph().Resolve());
 
   auto model_proto = model.ToGraphProtoWithExternalInitializers(external_file_name, file_path,
-                                                                initializer_size_threshold);
+                                                                initializer_size_threshold, compress_initializers);
   google::protobuf::io::FileOutputStream output(fd);
   const bool result = model_proto.SerializeToZeroCopyStream(&output) && output.Flush();
   if (result) {
@@ -776,8 +782,10 @@ Status Model::SaveWithExternalInitializers(Model& model,
   return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf serialization failed.");
 }
 
-common::Status Model::SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder,
-                                      flatbuffers::Offset<fbs::Model>& fbs_model) const {
+common::Status Model::SaveToOrtFormat(
+    flatbuffers::FlatBufferBuilder& builder, flatbuffers::Offset<fbs::Model>& fbs_model,
+    const std::function<Status(int32_t data_type, gsl::span<const uint8_t> bytes, uint64_t& offset)>&
+        external_data_writer) const {
   auto producer_name = fbs::utils::SaveStringToOrtFormat(
       builder, model_proto_.has_producer_name(), model_proto_.producer_name());
   auto producer_version = fbs::utils::SaveStringToOrtFormat(
@@ -815,7 +823,7 @@ common::Status Model::SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder,
   }
 
   flatbuffers::Offset<fbs::Graph> fbs_graph;
-  ORT_RETURN_IF_ERROR(graph_->SaveToOrtFormat(builder, fbs_graph));
+  ORT_RETURN_IF_ERROR(graph_->SaveToOrtFormat(builder, fbs_graph, external_data_writer));
 
   fbs::ModelBuilder mb(builder);
   mb.add_ir_version(IrVersion());
@@ -187,9 +187,11 @@ class Model {
   // Get model's serialization proto data.
   // Save initializer larger than the given threshold (in bytes) into an external binary file
   // with the given name. This function is useful to avoid hitting the size limit of protobuf files.
+  // If compress_initializers is true the initializers are stored compressed in the external file.
   ONNX_NAMESPACE::ModelProto ToGraphProtoWithExternalInitializers(const std::filesystem::path& external_file_name,
                                                                   const std::filesystem::path& file_path,
-                                                                  size_t initializer_size_threshold) const;
+                                                                  size_t initializer_size_threshold,
+                                                                  bool compress_initializers = false) const;
 
   static common::Status Save(Model& model, const PathString& file_path);
 
@@ -199,13 +201,15 @@ class Model {
   static common::Status SaveWithExternalInitializers(Model& model,
                                                      const std::filesystem::path& file_path,
                                                      const std::filesystem::path& external_file_path,
-                                                     size_t initializer_size_threshold);
+                                                     size_t initializer_size_threshold,
+                                                     bool compress_initializers = false);
 
   static common::Status SaveWithExternalInitializers(Model& model,
                                                      int fd,
                                                      const std::filesystem::path& file_path,
                                                      const std::filesystem::path& external_file_path,
-                                                     size_t initializer_size_threshold);
+                                                     size_t initializer_size_threshold,
+                                                     bool compress_initializers = false);
 
   static common::Status Load(std::istream& model_istream, ONNX_NAMESPACE::ModelProto* p_model_proto);
 
@@ -276,8 +280,12 @@ class Model {
                              const logging::Logger& logger,
                              const ModelOptions& options = {});
 
-  common::Status SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder,
-                                 flatbuffers::Offset<onnxruntime::fbs::Model>& model) const;
+  // external_data_writer optionally writes the data of large initializers of the main graph outside of the
+  // flatbuffer, see Graph::SaveToOrtFormat
+  common::Status SaveToOrtFormat(
+      flatbuffers::FlatBufferBuilder& builder, flatbuffers::Offset<onnxruntime::fbs::Model>& model,
+      const std::function<Status(int32_t data_type, gsl::span<const uint8_t> bytes, uint64_t& offset)>&
+          external_data_writer = nullptr) const;
 
   /// <summary>
   /// Frees local function definitions in the model, excluding those in the `retained` set.
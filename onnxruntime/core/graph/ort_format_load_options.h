@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include <cstdint>
+
+#include <gsl/gsl>
+
 namespace onnxruntime {
 
 /// Options to configure how an ORT format model is loaded.
@@ -13,6 +17,10 @@ struct OrtFormatLoadOptions {
 
   /// If true, do not load any saved runtime optimizations.
   bool ignore_saved_runtime_optimizations{false};
+
+  /// The data section of the model holding the data of initializers with an external data offset.
+  /// can_use_flatbuffer_for_initializers also applies to it.
+  gsl::span<const uint8_t> data_section{};
 };
 
 }  // namespace onnxruntime
@@ -21,6 +21,8 @@ Abstract:
 #include <cstdlib>
 #include <cstdint>
 
+#include "mlas_gemm_postprocessor.h"
+
 //
 // Define the calling convention for Windows targets.
 //
@@ -193,6 +195,50 @@ MlasActivation(
     size_t ldc
     );
 
+//
+// GEMM epilogue routines.
+//
+// The epilogue is applied to each tile of the output matrix as soon as the
+// tile is complete, while it is still resident in the cache:
+//
+//     C := Activation(Scale * C + Bias) + Residual
+//
+
+enum MLAS_EPILOGUE_ACTIVATION_KIND {
+    MlasEpilogueIdentityActivation,
+    MlasEpilogueReluActivation,
+    MlasEpilogueGeluActivation,
+    MlasEpilogueFastGeluActivation,
+    MlasEpilogueSiluActivation,
+};
+
+struct MLAS_GEMM_EPILOGUE {
+    float Scale = 1.0f;                  /**< Supplies the output scale */
+    const float* Bias = nullptr;         /**< Supplies the optional per column bias vector */
+    MLAS_EPILOGUE_ACTIVATION_KIND ActivationKind = MlasEpilogueIdentityActivation;
+    const float* Residual = nullptr;     /**< Supplies the optional matrix added after the activation */
+    size_t ldr = 0;                      /**< Supplies the first dimension of the residual matrix */
+};
+
+class MLAS_GEMM_EPILOGUE_PROCESSOR : public MLAS_GEMM_POSTPROCESSOR<float>
+{
+   public:
+    explicit MLAS_GEMM_EPILOGUE_PROCESSOR(const MLAS_GEMM_EPILOGUE& Epilogue) : Epilogue_(Epilogue) {}
+
+    void
+    Process(
+        float* C,
+        size_t StartM,
+        size_t StartN,
+        size_t CountM,
+        size_t CountN,
+        size_t ldc
+        ) const override;
+
+   private:
+    MLAS_GEMM_EPILOGUE Epilogue_;
+};
+
 //
 // Matrix/matrix multiply routines.
 // C := alpha * op(A) * op(B) + beta * C
@@ -212,6 +258,7 @@ struct MLAS_SGEMM_DATA_PARAMS {
     float alpha = 1.0f;       /**< Supplies the scalar alpha multiplier (see SGEMM definition) */
     float beta = 0.0f;        /**< Supplies the scalar beta multiplier (see SGEMM definition) */
     bool BIsPacked = false;   /**< Whether B is pre-packed */
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor = nullptr; /**< Optional processor applied to each completed tile of matrix C */
 };
 
 /**
@@ -241,6 +288,40 @@ MlasGemmBatch(
     MLAS_THREADPOOL* ThreadPool
     );
 
+/**
+ * @brief Supply the shape and data of one group of a grouped single precision
+ *        gemm. Each group may have a different shape.
+ */
+struct MLAS_SGEMM_GROUP_PARAMS {
+    CBLAS_TRANSPOSE TransA = CblasNoTrans; /**< Supplies the transpose operation for matrix A */
+    CBLAS_TRANSPOSE TransB = CblasNoTrans; /**< Supplies the transpose operation for matrix B */
+    size_t M = 0;                          /**< Supplies the number of rows of matrix A and matrix C */
+    size_t N = 0;                          /**< Supplies the number of columns of matrix B and matrix C */
+    size_t K = 0;                          /**< Supplies the number of columns of matrix A and rows of matrix B */
+    MLAS_SGEMM_DATA_PARAMS Data;           /**< Supplies the matrices data parameters */
+};
+
+/**
+ * @brief  Grouped single precision matrix/matrix multiply operation (SGEMM)
+ *
+ *         Computes a set of independent multiplications with per group shapes,
+ *         e.g. the expert GEMMs of a mixture of experts layer. The groups are
+ *         partitioned in proportion to their complexity and scheduled on the
+ *         thread pool as a single job.
+ *
+ * @param Groups     Supplies the array of groups
+ * @param GroupCount Supplies the number of groups
+ * @param ThreadPool Supplies the thread pool object to use, else nullptr if the
+                     base library threading support should be used.
+ */
+void
+MLASCALL
+MlasGemmGrouped(
+    const MLAS_SGEMM_GROUP_PARAMS* Groups,
+    size_t GroupCount,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 /**
  * @brief  Single precision matrix/matrix multiply operation (SGEMM)
  *
@@ -518,6 +599,13 @@ public:
     virtual ~MLAS_QGEMM_OUTPUT_PROCESSOR() {}
 };
 
+//
+// Dequantizes the int32 output of QGEMM to float: Output = C * Scale + Bias.
+// Scale has one value (PerMatrix) or one per column (PerColumn). If RowScale
+// is not null, row m is also multiplied by RowScale[m], e.g. the scales of an
+// A quantized per row.
+//
+
 class MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR : public MLAS_QGEMM_OUTPUT_PROCESSOR {
 public:
     MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR(
@@ -526,13 +614,15 @@ public:
         const float* Scale,
         const float* Bias,
         MLAS_QGEMM_OUTPUT_MODE Mode = MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix) :
+        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+        const float* RowScale = nullptr) :
             Output_(Output),
             LeadingDimensionOutput_(LeadingDimensionOutput),
             Scale_(Scale),
             Bias_(Bias),
             OutputMode_(Mode),
-            QuantGran_(QuantGran)
+            QuantGran_(QuantGran),
+            RowScale_(RowScale)
     {
     }
 
@@ -566,6 +656,51 @@ private:
     const float* Bias_;
     MLAS_QGEMM_OUTPUT_MODE OutputMode_;
     MLAS_QUANTIZATION_GRANULARITY QuantGran_;
+    const float* RowScale_;
+};
+
+//
+// Dequantizes the output like MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR, then
+// applies the epilogue to the dequantized tile. The epilogue scale and bias
+// are applied after the dequantization scale and bias.
+//
+
+class MLAS_QGEMM_EPILOGUE_OUTPUT_PROCESSOR : public MLAS_QGEMM_OUTPUT_PROCESSOR {
+public:
+    MLAS_QGEMM_EPILOGUE_OUTPUT_PROCESSOR(
+        float* Output,
+        size_t LeadingDimensionOutput,
+        const float* Scale,
+        const float* Bias,
+        const MLAS_GEMM_EPILOGUE& Epilogue,
+        MLAS_QGEMM_OUTPUT_MODE Mode = MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
+        MLAS_QUANTIZATION_GRANULARITY QuantGran = MLAS_QUANTIZATION_GRANULARITY::PerMatrix) :
+            Output_(Output),
+            LeadingDimensionOutput_(LeadingDimensionOutput),
+            ScaleBiasProcessor_(Output, LeadingDimensionOutput, Scale, Bias, Mode, QuantGran),
+            EpilogueProcessor_(Epilogue)
+    {
+    }
+
+    void
+    Process(
+        const int32_t* C,
+        size_t StartM,
+        size_t StartN,
+        size_t CountM,
+        size_t CountN,
+        size_t ldc
+        ) const override
+    {
+        ScaleBiasProcessor_.Process(C, StartM, StartN, CountM, CountN, ldc);
+        EpilogueProcessor_.Process(Output_, StartM, StartN, CountM, CountN, LeadingDimensionOutput_);
+    }
+
+private:
+    float* Output_;
+    size_t LeadingDimensionOutput_;
+    MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR ScaleBiasProcessor_;
+    MLAS_GEMM_EPILOGUE_PROCESSOR EpilogueProcessor_;
 };
 
 /**
@@ -754,6 +889,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -786,6 +922,10 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileRowsPerBand;
+            size_t BandCount;
+        } Winograd;
     } u;
 };
 
@@ -805,7 +945,8 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
-                MLAS_THREADPOOL* ThreadPool);
+                MLAS_THREADPOOL* ThreadPool,
+                bool AllowWinograd = false);
 
 void
 MLASCALL
@@ -997,6 +1138,14 @@ MlasComputeExp(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
 void
 MLASCALL
 MlasComputeLogistic(
@@ -1024,6 +1173,17 @@ MlasComputeTanh(
     size_t N
     );
 
+void
+MLASCALL
+MlasRotaryEmbedOneRow(
+    const float* Input,
+    const float* CosData,
+    const float* SinData,
+    size_t RotaryEmbeddingDim,
+    bool Interleaved,
+    float* Output
+    );
+
 //
 // Half-precision floating-point routines.
 //
@@ -1845,6 +2005,23 @@ struct MlasFlashAttentionThreadedArgs {
     const float* key;
     const float* value;
     float* output;
+    //
+    // The fields below are optional, their defaults describe plain non-causal attention over Q, K and V in BNSH
+    // layout without padding.
+    //
+    // Number of heads of K and V, each shared by num_heads / kv_num_heads query heads. 0 means num_heads.
+    int kv_num_heads = 0;
+    // Number of rows of each head of K and V, e.g. the capacity of a kv cache. 0 means kv_sequence_length.
+    int kv_sequence_stride = 0;
+    // Number of elements between the batches of Q, e.g. for packed QKV. 0 means num_heads * q_sequence_length * qk_head_size.
+    size_t query_batch_stride = 0;
+    // Number of valid rows of K and V of each batch, at most kv_sequence_length. nullptr means kv_sequence_length.
+    const int32_t* kv_sequence_lengths = nullptr;
+    // If is_causal, query row i of a batch with T valid keys attends to keys [0, min(P + i, T - 1)] with
+    // P = max(T - q_sequence_length, 0), i.e. the queries follow the past keys. If local_window_size is also
+    // positive, only to the last local_window_size + 1 of those keys.
+    bool is_causal = false;
+    int local_window_size = -1;
 };
 
 /**
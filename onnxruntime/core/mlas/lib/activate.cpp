@@ -10,7 +10,8 @@ Module Name:
 
 Abstract:
 
-    This module implements the fused activation and bias addition routines.
+    This module implements the fused activation and bias addition routines
+    and the GEMM epilogue.
 
 --*/
 
@@ -519,3 +520,246 @@ Return Value:
         }
     }
 }
+
+//
+// Number of columns of a row of the output tile processed at a time by the
+// GEMM epilogue, bounding the temporary buffer used by the activations.
+//
+
+constexpr size_t MLAS_GEMM_EPILOGUE_BLOCK_SIZE = 256;
+
+MLAS_FORCEINLINE
+void
+MlasGemmEpilogueScaleBias(
+    float* Buffer,
+    const float* Bias,
+    float Scale,
+    size_t N
+    )
+{
+    const MLAS_FLOAT32X4 ScaleBroadcast = MlasBroadcastFloat32x4(Scale);
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 BiasVector = (Bias != nullptr) ? MlasLoadFloat32x4(Bias) : ZeroFloat32x4;
+        MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Buffer), ScaleBroadcast, BiasVector);
+        MlasStoreFloat32x4(Buffer, Vector);
+
+        Buffer += 4;
+        Bias = (Bias != nullptr) ? Bias + 4 : nullptr;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Buffer = *Buffer * Scale + ((Bias != nullptr) ? *Bias++ : 0.0f);
+
+        Buffer += 1;
+        N -= 1;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasGemmEpilogueRelu(
+    float* Buffer,
+    size_t N
+    )
+{
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Buffer, MlasMaximumFloat32x4(MlasLoadFloat32x4(Buffer), ZeroFloat32x4));
+
+        Buffer += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Buffer = std::max(*Buffer, 0.0f);
+
+        Buffer += 1;
+        N -= 1;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasGemmEpilogueGate(
+    float* Buffer,
+    const float* Gate,
+    float GateScale,
+    float GateBias,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes Buffer := Buffer * (GateScale * Gate + GateBias),
+    which completes the GELU and SiLU activations from the error, hyperbolic
+    tangent or logistic function computed into the gate buffer.
+
+--*/
+{
+    const MLAS_FLOAT32X4 GateScaleBroadcast = MlasBroadcastFloat32x4(GateScale);
+    const MLAS_FLOAT32X4 GateBiasBroadcast = MlasBroadcastFloat32x4(GateBias);
+
+    while (N >= 4) {
+
+        MLAS_FLOAT32X4 GateVector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(Gate), GateScaleBroadcast, GateBiasBroadcast);
+        MlasStoreFloat32x4(Buffer, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Buffer), GateVector));
+
+        Buffer += 4;
+        Gate += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Buffer = *Buffer * (*Gate++ * GateScale + GateBias);
+
+        Buffer += 1;
+        N -= 1;
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasGemmEpilogueAdd(
+    float* Buffer,
+    const float* Input,
+    size_t N
+    )
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Buffer, MlasAddFloat32x4(MlasLoadFloat32x4(Buffer), MlasLoadFloat32x4(Input)));
+
+        Buffer += 4;
+        Input += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Buffer += *Input++;
+
+        Buffer += 1;
+        N -= 1;
+    }
+}
+
+void
+MLAS_GEMM_EPILOGUE_PROCESSOR::Process(
+    float* C,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    ) const
+/*++
+
+Routine Description:
+
+    This routine applies the epilogue to a tile of the output matrix:
+
+        C := Activation(Scale * C + Bias) + Residual
+
+Arguments:
+
+    C - Supplies the address of the output matrix.
+
+    StartM - Supplies the first row of the tile.
+
+    StartN - Supplies the first column of the tile.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    ldc - Supplies the first dimension of the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    float Gate[MLAS_GEMM_EPILOGUE_BLOCK_SIZE];
+
+    const bool ScaleOrBias = (Epilogue_.Scale != 1.0f || Epilogue_.Bias != nullptr);
+
+    for (size_t m = StartM; m < StartM + CountM; m++) {
+
+        for (size_t n = StartN; n < StartN + CountN; n += MLAS_GEMM_EPILOGUE_BLOCK_SIZE) {
+
+            const size_t CountBlock = std::min(StartN + CountN - n, MLAS_GEMM_EPILOGUE_BLOCK_SIZE);
+
+            float* c = C + m * ldc + n;
+
+            if (ScaleOrBias) {
+                MlasGemmEpilogueScaleBias(c, (Epilogue_.Bias != nullptr) ? Epilogue_.Bias + n : nullptr,
+                    Epilogue_.Scale, CountBlock);
+            }
+
+            switch (Epilogue_.ActivationKind) {
+
+                case MlasEpilogueIdentityActivation:
+                {
+                    break;
+                }
+
+                case MlasEpilogueReluActivation:
+                {
+                    MlasGemmEpilogueRelu(c, CountBlock);
+                    break;
+                }
+
+                case MlasEpilogueGeluActivation:
+                {
+                    // x * 0.5 * (1 + erf(x / sqrt(2)))
+                    for (size_t i = 0; i < CountBlock; i++) {
+                        Gate[i] = c[i] * 0.70710678118654752f;
+                    }
+                    MlasComputeErf(Gate, Gate, CountBlock);
+                    MlasGemmEpilogueGate(c, Gate, 0.5f, 0.5f, CountBlock);
+                    break;
+                }
+
+                case MlasEpilogueFastGeluActivation:
+                {
+                    // x * 0.5 * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+                    for (size_t i = 0; i < CountBlock; i++) {
+                        Gate[i] = c[i] * (0.79788456080286536f + 0.03567740813636141f * c[i] * c[i]);
+                    }
+                    MlasComputeTanh(Gate, Gate, CountBlock);
+                    MlasGemmEpilogueGate(c, Gate, 0.5f, 0.5f, CountBlock);
+                    break;
+                }
+
+                case MlasEpilogueSiluActivation:
+                {
+                    // x * sigmoid(x)
+                    MlasComputeLogistic(c, Gate, CountBlock);
+                    MlasGemmEpilogueGate(c, Gate, 1.0f, 0.0f, CountBlock);
+                    break;
+                }
+
+                default:
+                {
+                    MLAS_THROW_EX(std::runtime_error, "bad mlas epilogue activation kind");
+                    break;
+                }
+            }
+
+            if (Epilogue_.Residual != nullptr) {
+                MlasGemmEpilogueAdd(c, Epilogue_.Residual + m * Epilogue_.ldr + n, CountBlock);
+            }
+        }
+    }
+}
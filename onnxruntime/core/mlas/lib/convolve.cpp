@@ -23,6 +23,22 @@ Abstract:
 #define MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD \
     (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK)
 
+//
+// Define the F(2x2, 3x3) Winograd convolution parameters: each 4x4 input tile
+// produces a 2x2 output tile, the transformed tiles have 16 elements and the
+// transformed tiles are multiplied in blocks of tiles.
+//
+
+#define MLAS_CONV_WINOGRAD_TILE_ELEMENTS            16
+#define MLAS_CONV_WINOGRAD_TILE_BLOCK               32
+
+//
+// Define the minimum number of input channels and filters for the Winograd
+// convolution, below which the tile transforms dominate the savings.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS         16
+
 //
 // Define the parameters to execute segments of a convolution operation on
 // worker threads.
@@ -42,6 +58,21 @@ struct MLAS_CONV_WORK_BLOCK {
     ptrdiff_t TargetThreadCount;
 };
 
+//
+// Define the parameters to execute bands of tile rows of a Winograd
+// convolution operation on worker threads.
+//
+
+struct MLAS_CONV_WINOGRAD_WORK_BLOCK {
+    const MLAS_CONV_PARAMETERS* Parameters;
+    const float* Input;
+    const float* TransformedFilter;
+    const float* Bias;
+    float* WorkingBuffer;
+    float* Output;
+    ptrdiff_t TargetThreadCount;
+};
+
 void
 MlasConvIm2Col(
     const MLAS_CONV_PARAMETERS* Parameters,
@@ -819,6 +850,356 @@ Return Value:
     return true;
 }
 
+void
+MlasConvWinogradTransformFilter(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Filter,
+    float* TransformedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the 3x3 filters of all groups to the 4x4 Winograd
+    domain (G * g * G^T). The transformed filters of a group are stored as 16
+    matrices of FilterCount rows and InputChannels columns.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Filter - Supplies the filter tensor.
+
+    TransformedFilter - Supplies the buffer to receive the transformed filters.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t TransformStride = FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                float t[4][3];
+
+                for (size_t j = 0; j < 3; j++) {
+
+                    const float g0 = Filter[j];
+                    const float g1 = Filter[3 + j];
+                    const float g2 = Filter[6 + j];
+
+                    t[0][j] = g0;
+                    t[1][j] = 0.5f * (g0 + g1 + g2);
+                    t[2][j] = 0.5f * (g0 - g1 + g2);
+                    t[3][j] = g2;
+                }
+
+                float* u = TransformedFilter + f * InputChannels + c;
+
+                for (size_t i = 0; i < 4; i++) {
+                    u[(i * 4 + 0) * TransformStride] = t[i][0];
+                    u[(i * 4 + 1) * TransformStride] = 0.5f * (t[i][0] + t[i][1] + t[i][2]);
+                    u[(i * 4 + 2) * TransformStride] = 0.5f * (t[i][0] - t[i][1] + t[i][2]);
+                    u[(i * 4 + 3) * TransformStride] = t[i][2];
+                }
+
+                Filter += 9;
+            }
+        }
+
+        TransformedFilter += MLAS_CONV_WINOGRAD_TILE_ELEMENTS * TransformStride;
+    }
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute bands of tile rows
+    of a Winograd convolution operation. Each block of tiles is transformed to
+    the Winograd domain (B^T * d * B), multiplied with the transformed filters
+    by 16 GEMMs and transformed back to the output (A^T * m * A).
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_CONV_WINOGRAD_WORK_BLOCK* WorkBlock = (MLAS_CONV_WINOGRAD_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const ptrdiff_t PaddingTop = ptrdiff_t(Parameters->Padding[0]);
+    const ptrdiff_t PaddingLeft = ptrdiff_t(Parameters->Padding[1]);
+    const float Beta = Parameters->Beta;
+
+    const size_t TileRows = (OutputHeight + 1) / 2;
+    const size_t TileColumns = (OutputWidth + 1) / 2;
+    const size_t TileRowsPerBand = Parameters->u.Winograd.TileRowsPerBand;
+    const size_t BandCount = Parameters->u.Winograd.BandCount;
+
+    const size_t InputStride = InputChannels * MLAS_CONV_WINOGRAD_TILE_BLOCK;
+    const size_t OutputStride = FilterCount * MLAS_CONV_WINOGRAD_TILE_BLOCK;
+    const size_t FilterStride = FilterCount * InputChannels;
+
+    float* TransformedInput = WorkBlock->WorkingBuffer +
+        Index * MLAS_CONV_WINOGRAD_TILE_ELEMENTS * (InputStride + OutputStride);
+    float* TransformedOutput = TransformedInput + MLAS_CONV_WINOGRAD_TILE_ELEMENTS * InputStride;
+
+    //
+    // Compute the range of bands to use for this thread.
+    //
+
+    size_t WorkIndex;
+    size_t WorkRemaining;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount,
+        Parameters->BatchCount * GroupCount * BandCount, &WorkIndex, &WorkRemaining);
+
+    for (; WorkRemaining > 0; WorkIndex++, WorkRemaining--) {
+
+        const size_t band = WorkIndex % BandCount;
+        const size_t bg = WorkIndex / BandCount;
+        const size_t group = bg % GroupCount;
+
+        const float* input = WorkBlock->Input + bg * InputChannels * InputSize;
+        const float* filter = WorkBlock->TransformedFilter +
+            group * MLAS_CONV_WINOGRAD_TILE_ELEMENTS * FilterStride;
+        float* output = WorkBlock->Output + bg * FilterCount * OutputSize;
+
+        const size_t TileRowStart = band * TileRowsPerBand;
+        const size_t TileRowEnd = std::min(TileRowStart + TileRowsPerBand, TileRows);
+        const size_t TileEnd = TileRowEnd * TileColumns;
+
+        for (size_t TileStart = TileRowStart * TileColumns; TileStart < TileEnd;
+             TileStart += MLAS_CONV_WINOGRAD_TILE_BLOCK) {
+
+            const size_t TileCount = std::min(TileEnd - TileStart, size_t(MLAS_CONV_WINOGRAD_TILE_BLOCK));
+
+            //
+            // Transform the input tiles of all channels.
+            //
+
+            for (size_t n = 0; n < TileCount; n++) {
+
+                const size_t tile = TileStart + n;
+                const ptrdiff_t ih = ptrdiff_t(tile / TileColumns * 2) - PaddingTop;
+                const ptrdiff_t iw = ptrdiff_t(tile % TileColumns * 2) - PaddingLeft;
+                const bool IsInterior = ih >= 0 && iw >= 0 &&
+                    size_t(ih) + 4 <= InputHeight && size_t(iw) + 4 <= InputWidth;
+
+                const float* channel_input = input;
+
+                for (size_t c = 0; c < InputChannels; c++) {
+
+                    float d[4][4];
+
+                    if (IsInterior) {
+                        const float* row = channel_input + size_t(ih) * InputWidth + size_t(iw);
+                        for (size_t i = 0; i < 4; i++, row += InputWidth) {
+                            for (size_t j = 0; j < 4; j++) {
+                                d[i][j] = row[j];
+                            }
+                        }
+                    } else {
+                        for (size_t i = 0; i < 4; i++) {
+                            const size_t y = size_t(ih + ptrdiff_t(i));
+                            for (size_t j = 0; j < 4; j++) {
+                                const size_t x = size_t(iw + ptrdiff_t(j));
+                                d[i][j] = (y < InputHeight && x < InputWidth) ? channel_input[y * InputWidth + x] : 0.0f;
+                            }
+                        }
+                    }
+
+                    float t[4][4];
+
+                    for (size_t j = 0; j < 4; j++) {
+                        t[0][j] = d[0][j] - d[2][j];
+                        t[1][j] = d[1][j] + d[2][j];
+                        t[2][j] = d[2][j] - d[1][j];
+                        t[3][j] = d[1][j] - d[3][j];
+                    }
+
+                    float* v = TransformedInput + c * MLAS_CONV_WINOGRAD_TILE_BLOCK + n;
+
+                    for (size_t i = 0; i < 4; i++) {
+                        v[(i * 4 + 0) * InputStride] = t[i][0] - t[i][2];
+                        v[(i * 4 + 1) * InputStride] = t[i][1] + t[i][2];
+                        v[(i * 4 + 2) * InputStride] = t[i][2] - t[i][1];
+                        v[(i * 4 + 3) * InputStride] = t[i][1] - t[i][3];
+                    }
+
+                    channel_input += InputSize;
+                }
+            }
+
+            //
+            // Multiply each element of the transformed tiles with the
+            // transformed filters.
+            //
+
+            for (size_t x = 0; x < MLAS_CONV_WINOGRAD_TILE_ELEMENTS; x++) {
+                MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, TileCount, InputChannels,
+                                   1.0f, filter + x * FilterStride, InputChannels,
+                                   TransformedInput + x * InputStride, MLAS_CONV_WINOGRAD_TILE_BLOCK,
+                                   0.0f, TransformedOutput + x * OutputStride, MLAS_CONV_WINOGRAD_TILE_BLOCK);
+            }
+
+            //
+            // Transform the products back to the output tiles of all filters.
+            //
+
+            for (size_t n = 0; n < TileCount; n++) {
+
+                const size_t tile = TileStart + n;
+                const size_t oh = tile / TileColumns * 2;
+                const size_t ow = tile % TileColumns * 2;
+                const size_t RowCount = std::min(OutputHeight - oh, size_t(2));
+                const bool HasSecondColumn = ow + 1 < OutputWidth;
+
+                for (size_t f = 0; f < FilterCount; f++) {
+
+                    const float* m = TransformedOutput + f * MLAS_CONV_WINOGRAD_TILE_BLOCK + n;
+
+                    float t[2][4];
+
+                    for (size_t j = 0; j < 4; j++) {
+
+                        const float m0 = m[(0 + j) * OutputStride];
+                        const float m1 = m[(4 + j) * OutputStride];
+                        const float m2 = m[(8 + j) * OutputStride];
+                        const float m3 = m[(12 + j) * OutputStride];
+
+                        t[0][j] = m0 + m1 + m2;
+                        t[1][j] = m1 - m2 - m3;
+                    }
+
+                    float* y = output + f * OutputSize + oh * OutputWidth + ow;
+
+                    for (size_t i = 0; i < RowCount; i++, y += OutputWidth) {
+
+                        const float y0 = t[i][0] + t[i][1] + t[i][2];
+                        const float y1 = t[i][1] - t[i][2] - t[i][3];
+
+                        y[0] = (Beta == 0.0f) ? y0 : y0 + Beta * y[0];
+
+                        if (HasSecondColumn) {
+                            y[1] = (Beta == 0.0f) ? y1 : y1 + Beta * y[1];
+                        }
+                    }
+                }
+            }
+        }
+
+        //
+        // Apply the activation with optional bias to the output rows of the
+        // band.
+        //
+
+        const float* bias = WorkBlock->Bias;
+
+        if (bias != nullptr) {
+            bias += group * FilterCount;
+        }
+
+        const size_t OutputRowStart = TileRowStart * 2;
+        const size_t OutputRowEnd = std::min(TileRowEnd * 2, OutputHeight);
+
+        MlasActivation(Parameters->Activation, output + OutputRowStart * OutputWidth, bias,
+            FilterCount, (OutputRowEnd - OutputRowStart) * OutputWidth, OutputSize);
+    }
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements a 3x3 stride 1 convolution operation with the
+    F(2x2, 3x3) Winograd algorithm, which uses 16 instead of 36 multiplications
+    per 2x2 output tile and input channel.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasConvWinogradTransformFilter(Parameters, Filter, WorkingBuffer);
+
+    MLAS_CONV_WINOGRAD_WORK_BLOCK WorkBlock;
+
+    WorkBlock.Parameters = Parameters;
+    WorkBlock.Input = Input;
+    WorkBlock.TransformedFilter = WorkingBuffer;
+    WorkBlock.Bias = Bias;
+    WorkBlock.WorkingBuffer = WorkingBuffer + Parameters->GroupCount * MLAS_CONV_WINOGRAD_TILE_ELEMENTS *
+        Parameters->FilterCount * Parameters->InputChannels;
+    WorkBlock.Output = Output;
+    WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock, Parameters->ThreadCount, ThreadPool);
+}
+
 void
 MLASCALL
 MlasConv(
@@ -903,6 +1284,13 @@ Return Value:
         return;
     }
 
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+
+        return;
+    }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
     if (Algorithm == MlasConvAlgorithmDepthwise) {
@@ -976,6 +1364,16 @@ Return Value:
                     break;
                 }
 
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // The Winograd convolution is dispatched above for all
+                    // batches and groups.
+                    //
+
+                    break;
+                }
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
                 case MlasConvAlgorithmDepthwise:
@@ -1041,7 +1439,8 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
-    MLAS_THREADPOOL* ThreadPool
+    MLAS_THREADPOOL* ThreadPool,
+    bool AllowWinograd
     )
 /*++
 
@@ -1088,6 +1487,10 @@ Arguments:
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
+    AllowWinograd - Supplies true if 3x3 stride 1 convolutions may use the
+        Winograd algorithm, whose results are not bitwise identical to the
+        other algorithms.
+
 Return Value:
 
     None.
@@ -1211,6 +1614,54 @@ Return Value:
         }
     }
 
+    if (AllowWinograd && Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+
+        //
+        // Split the 2x2 output tiles into bands of tile rows that fill a block
+        // of tiles, unless there are too few bands to use all threads.
+        //
+
+        const size_t TileRows = (Parameters->OutputShape[0] + 1) / 2;
+        const size_t TileColumns = (Parameters->OutputShape[1] + 1) / 2;
+        const ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        size_t TileRowsPerBand = std::max(size_t(MLAS_CONV_WINOGRAD_TILE_BLOCK) / TileColumns, size_t(1));
+
+        if (BatchCount * GroupCount * ((TileRows + TileRowsPerBand - 1) / TileRowsPerBand) <
+            size_t(MaximumThreadCount)) {
+            TileRowsPerBand = 1;
+        }
+
+        const size_t BandCount = (TileRows + TileRowsPerBand - 1) / TileRowsPerBand;
+        const size_t WorkCount = BatchCount * GroupCount * BandCount;
+
+        ptrdiff_t TargetThreadCount = MaximumThreadCount;
+
+        if (size_t(TargetThreadCount) >= WorkCount) {
+            TargetThreadCount = ptrdiff_t(WorkCount);
+        }
+
+        Parameters->ThreadCount = TargetThreadCount;
+
+        Parameters->Algorithm = MlasConvAlgorithmWinograd;
+        Parameters->u.Winograd.TileRowsPerBand = TileRowsPerBand;
+        Parameters->u.Winograd.BandCount = BandCount;
+
+        //
+        // The working buffer stores the transformed filters of all groups
+        // followed by the transformed tiles of each thread.
+        //
+
+        *WorkingBufferSize = MLAS_CONV_WINOGRAD_TILE_ELEMENTS *
+            (GroupCount * FilterCount * InputChannels +
+             size_t(TargetThreadCount) * (InputChannels + FilterCount) * MLAS_CONV_WINOGRAD_TILE_BLOCK);
+
+        return;
+    }
+
     if (FilterCount > OutputSize) {
 
         //
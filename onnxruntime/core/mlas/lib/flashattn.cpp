@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <numeric>
 
 #include "mlasi.h"
@@ -24,6 +25,14 @@ MlasFlashAttentionThreaded(
     const float* key = args->key;
     const float* value = args->value;
     float* output = args->output;
+    ptrdiff_t kv_num_heads = args->kv_num_heads > 0 ? static_cast<ptrdiff_t>(args->kv_num_heads) : num_heads;
+    ptrdiff_t heads_per_kv_head = num_heads / kv_num_heads;
+    ptrdiff_t kv_sequence_stride =
+        args->kv_sequence_stride > 0 ? static_cast<ptrdiff_t>(args->kv_sequence_stride) : kv_sequence_length;
+    ptrdiff_t query_batch_stride = args->query_batch_stride > 0 ? static_cast<ptrdiff_t>(args->query_batch_stride)
+                                                                : num_heads * q_sequence_length * qk_head_size;
+    const bool is_causal = args->is_causal;
+    ptrdiff_t local_window_size = is_causal ? static_cast<ptrdiff_t>(args->local_window_size) : -1;
 
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
     auto&& mlas_platform = GetMlasPlatform();
@@ -61,7 +70,28 @@ MlasFlashAttentionThreaded(
         float* temp_output = intermediate + q_block_size * kv_block_size;
         float negmax = 0;
 
-        for (ptrdiff_t ir = 0; ir < kv_sequence_length; ir += kv_block_size) {
+        ptrdiff_t total_kv_length = kv_sequence_length;
+        if (args->kv_sequence_lengths != nullptr) {
+            total_kv_length = std::min(static_cast<ptrdiff_t>(args->kv_sequence_lengths[batch_idx]), kv_sequence_length);
+        }
+        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
+
+        // The keys attended by any row of the block are [kv_begin, kv_end), blocks outside of them are skipped.
+        ptrdiff_t past_length = std::max(total_kv_length - q_sequence_length, ptrdiff_t{0});
+        ptrdiff_t kv_begin = 0;
+        ptrdiff_t kv_end = total_kv_length;
+        if (is_causal) {
+            kv_end = std::min(past_length + q_idx + row_size_q_valid, total_kv_length);
+            if (local_window_size > 0) {
+                kv_begin = std::max(std::min(past_length + q_idx, total_kv_length - 1) - local_window_size, ptrdiff_t{0});
+            }
+        }
+
+        ptrdiff_t kv_h = batch_idx * kv_num_heads + head_idx / heads_per_kv_head;
+        const float* inputQ = query + batch_idx * query_batch_stride + (head_idx * q_sequence_length + q_idx) * qk_head_size;
+        bool is_first_block = true;
+
+        for (ptrdiff_t ir = kv_begin; ir < kv_end; ir += kv_block_size) {
             /*
                 S = Q[batch_idx, head_idx, q_idx:q_idx+q_block_size, :] * (K[batch_idx, head_idx, ir:ir+kv_block_size, :]).T
                 old_m = m
@@ -71,13 +101,11 @@ MlasFlashAttentionThreaded(
                 l = exp(diff) * l + rowsum(S)
                 O = diag(exp(diff)) * O + S * V[batch_idx, head_idx, ir:ir+kv_block_size, :]
             */
-            ptrdiff_t h = batch_idx * num_heads + head_idx;
-            const float* inputQ = query + (h * q_sequence_length + q_idx) * qk_head_size;
-            const float* inputK = key + (h * kv_sequence_length + ir) * qk_head_size;
-            const float* inputV = value + (h * kv_sequence_length + ir) * v_head_size;
+            const float* inputK = key + (kv_h * kv_sequence_stride + ir) * qk_head_size;
+            const float* inputV = value + (kv_h * kv_sequence_stride + ir) * v_head_size;
 
-            size_t row_size_q_capped = static_cast<size_t>(std::min(q_block_size, q_sequence_length - q_idx));
-            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_sequence_length - ir));
+            size_t row_size_q_capped = static_cast<size_t>(row_size_q_valid);
+            size_t row_size_kv_capped = static_cast<size_t>(std::min(kv_block_size, kv_end - ir));
 
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
                      CBLAS_TRANSPOSE::CblasTrans,
@@ -95,11 +123,31 @@ MlasFlashAttentionThreaded(
 
             for (ptrdiff_t irow = 0; irow < static_cast<ptrdiff_t>(row_size_q_capped); ++irow) {
                 float* p = intermediate + irow * row_size_kv_capped;
+                size_t row_size_kv_valid = row_size_kv_capped;
+
+                if (is_causal) {
+                    // Zero the probabilities of the keys which this row does not attend to.
+                    ptrdiff_t row_last = std::min(past_length + q_idx + irow, total_kv_length - 1);
+                    ptrdiff_t row_begin = local_window_size > 0 ? std::max(row_last - local_window_size, ptrdiff_t{0}) : 0;
+                    ptrdiff_t valid_begin = std::clamp(row_begin - ir, ptrdiff_t{0}, static_cast<ptrdiff_t>(row_size_kv_capped));
+                    ptrdiff_t valid_end = std::clamp(row_last + 1 - ir, valid_begin, static_cast<ptrdiff_t>(row_size_kv_capped));
+                    std::fill(p, p + valid_begin, 0.0f);
+                    std::fill(p + valid_end, p + row_size_kv_capped, 0.0f);
+                    if (valid_begin == valid_end) {
+                        // The row attends to no key of this block, which leaves its running max and sum as they are.
+                        if (is_first_block) {
+                            l[irow] = 0.0f;
+                        }
+                        continue;
+                    }
+                    p += valid_begin;
+                    row_size_kv_valid = static_cast<size_t>(valid_end - valid_begin);
+                }
 
 #if defined(MLAS_TARGET_AMD64) || defined(MLAS_TARGET_LARCH64)
-                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = mlas_platform.ReduceMaximumF32Kernel(p, row_size_kv_valid);
 #else
-                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_capped);
+                float rowmax = MlasReduceMaximumF32Kernel(p, row_size_kv_valid);
 #endif
                 float m_diff = m[irow];
                 m[irow] = std::max(m[irow], rowmax);  // new m
@@ -107,13 +155,13 @@ MlasFlashAttentionThreaded(
                 m_diff -= m[irow];  // old - new (less than 0)
 
 #if defined(MLAS_TARGET_AMD64)
-                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+                float rowsum = mlas_platform.ComputeSumExpF32Kernel(p, p, row_size_kv_valid, &negmax);
 #else
-                float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_capped, &negmax);
+                float rowsum = MlasComputeSumExpF32Kernel(p, p, row_size_kv_valid, &negmax);
 #endif
 
-                // Note: for ir == 0, there is actually no need to calculate exp_diff
-                if (ir != 0) {
+                // Note: for the first block, there is actually no need to calculate exp_diff
+                if (!is_first_block) {
                     float exp_diff = std::exp(m_diff);
                     l[irow] = exp_diff * l[irow] + rowsum;
 
@@ -122,7 +170,7 @@ MlasFlashAttentionThreaded(
                     }
                 } else {
                     l[irow] = rowsum;
-                    // When ir == 0, there is no need to scale the old result because it is zero.
+                    // For the first block, there is no need to scale the old result because it is zero.
                 }
             }
             MlasSgemmOperation(CBLAS_TRANSPOSE::CblasNoTrans,
@@ -135,15 +183,21 @@ MlasFlashAttentionThreaded(
                      row_size_kv_capped,
                      inputV,
                      static_cast<size_t>(v_head_size),
-                     ir == 0 ? 0.0f : 1.0f,
+                     is_first_block ? 0.0f : 1.0f,
                      temp_output,
                      static_cast<size_t>(v_head_size));
+            is_first_block = false;
         }
 
         float* output_row = output + ((batch_idx * q_sequence_length + q_idx) * num_heads + head_idx) * v_head_size;
-        ptrdiff_t row_size_q_valid = std::min(q_block_size, q_sequence_length - q_idx);
         // TODO: leverage advanced instruction sets
         for (ptrdiff_t irow = 0; irow < row_size_q_valid; ++irow) {
+            // A batch without valid keys and values has a zero output.
+            if (is_first_block) {
+                std::fill_n(output_row, v_head_size, 0.0f);
+                output_row += num_heads * v_head_size;
+                continue;
+            }
             for (ptrdiff_t icol = 0; icol < v_head_size; ++icol) {
                 output_row[icol] = temp_output[irow * v_head_size + icol] / l[irow];
             }
@@ -0,0 +1,254 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    log.cpp
+
+Abstract:
+
+    This module implements routines to compute the natural logarithm.
+
+    This implementation uses the same polynomial coefficients and algorithm as
+    found in Cephes logf(). Our usage requires building platform specific
+    versions of the algorithm to target different instruction sets. The
+    implementation below targets the base instruction set (typically SSE2).
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Bundles the constants for use by kernels written in assembly.
+//
+
+MLAS_INTERNAL_DATA const struct {
+    float MinimumNormal;
+    float DenormalScale;
+    float DenormalExponent;
+    float ExponentScale;
+    float ExponentBias;
+    float SqrtHalf;
+    float One;
+    float MinusHalf;
+    float Ln2High;
+    float Ln2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_6;
+    float poly_7;
+    float poly_8;
+    int32_t ExponentMask;
+    int32_t MantissaMask;
+    int32_t MantissaHalf;
+} MlasLogConstants = {
+    0x1.0p-126f,
+    0x1.0p+23f,
+    23.0f,
+    0x1.0p-23f,
+    126.0f,
+    0.707106781186547524f,
+    1.0f,
+    -0.5f,
+    0.693359375f,
+    -2.12194440e-4f,
+    7.0376836292e-2f,
+    -1.1514610310e-1f,
+    1.1676998740e-1f,
+    -1.2420140846e-1f,
+    1.4249322787e-1f,
+    -1.6668057665e-1f,
+    2.0000714765e-1f,
+    -2.4999993993e-1f,
+    3.3333331174e-1f,
+    int32_t(0x7F800000),
+    int32_t(0x007FFFFF),
+    int32_t(0x3F000000),
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeLogVector(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm for the supplied vector.
+
+    The input is split into "(2 ^ e) * m" with m in [sqrt(0.5), sqrt(2)) and
+    the logarithm of m is approximated by a polynomial of (m - 1). The exponent
+    is extracted without integer shifts, which not all targets support, by
+    converting the masked exponent bits to floating point.
+
+Arguments:
+
+    Vector - Supplies the values to operate on.
+
+Return Value:
+
+    Returns the natural logarithm of the input. Zero returns negative infinity,
+    negative values return NaN and NaN or positive infinity return the input.
+
+--*/
+{
+    const MLAS_FLOAT32X4 Input = Vector;
+    const MLAS_FLOAT32X4 ZeroFloat32x4 = MlasZeroFloat32x4();
+
+    //
+    // Scale denormal values into the normal range and account for the scale
+    // in the exponent.
+    //
+
+    const auto Denormal = MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.MinimumNormal), Vector);
+    Vector = MlasBlendFloat32x4(Vector, MlasMultiplyFloat32x4(Vector, MlasBroadcastFloat32x4(MlasLogConstants.DenormalScale)), Denormal);
+
+    const auto Bits = MlasReinterpretAsInt32x4(Vector);
+    auto e = MlasCastToFloat32x4(MlasAndInt32x4(Bits, MlasBroadcastInt32x4(MlasLogConstants.ExponentMask)));
+    e = MlasMultiplyAddFloat32x4(e, MlasLogConstants.ExponentScale, MlasBroadcastFloat32x4(-MlasLogConstants.ExponentBias));
+    e = MlasSubtractFloat32x4(e, MlasAndFloat32x4(Denormal, MlasBroadcastFloat32x4(MlasLogConstants.DenormalExponent)));
+
+    //
+    // Reduce the mantissa from [0.5, 1) to [sqrt(0.5), sqrt(2)) and subtract
+    // one.
+    //
+
+    auto m = MlasReinterpretAsFloat32x4(MlasOrInt32x4(MlasAndInt32x4(Bits, MlasBroadcastInt32x4(MlasLogConstants.MantissaMask)),
+        MlasBroadcastInt32x4(MlasLogConstants.MantissaHalf)));
+    const auto Small = MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(MlasLogConstants.SqrtHalf), m);
+    const auto One = MlasBroadcastFloat32x4(MlasLogConstants.One);
+    e = MlasSubtractFloat32x4(e, MlasAndFloat32x4(Small, One));
+    m = MlasAddFloat32x4(MlasSubtractFloat32x4(m, One), MlasAndFloat32x4(Small, m));
+
+    const auto z = MlasMultiplyFloat32x4(m, m);
+
+    auto p = MlasBroadcastFloat32x4(MlasLogConstants.poly_0);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_1);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_2);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_3);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_4);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_5);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_6);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_7);
+    p = MlasMultiplyAddFloat32x4(p, m, MlasLogConstants.poly_8);
+    p = MlasMultiplyFloat32x4(MlasMultiplyFloat32x4(p, m), z);
+
+    p = MlasMultiplyAddFloat32x4(e, MlasLogConstants.Ln2Low, p);
+    p = MlasMultiplyAddFloat32x4(z, MlasLogConstants.MinusHalf, p);
+    auto Result = MlasMultiplyAddFloat32x4(e, MlasLogConstants.Ln2High, MlasAddFloat32x4(m, p));
+
+    //
+    // Fix up the special values. NaN inputs pass through the blends as the
+    // comparisons are false.
+    //
+
+    const auto Infinity = MlasBroadcastFloat32x4(std::numeric_limits<float>::infinity());
+    const auto Special = MlasBlendFloat32x4(
+        MlasBlendFloat32x4(Input, MlasBroadcastFloat32x4(std::numeric_limits<float>::quiet_NaN()),
+                           MlasGreaterThanFloat32x4(ZeroFloat32x4, Input)),
+        MlasSubtractFloat32x4(ZeroFloat32x4, Infinity),
+        MlasGreaterThanFloat32x4(MlasBroadcastFloat32x4(std::numeric_limits<float>::denorm_min()),
+                                 MlasAndNotFloat32x4(MlasBroadcastFloat32x4(-0.0f), Input)));
+    const auto Finite = MlasGreaterThanFloat32x4(Infinity, Input);
+    Result = MlasBlendFloat32x4(Special, Result, MlasAndFloat32x4(MlasGreaterThanFloat32x4(Input, ZeroFloat32x4), Finite));
+
+    return Result;
+}
+
+void
+MLASCALL
+MlasComputeLogF32Kernel(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for the natural logarithm.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N > 0) {
+
+        MLAS_FLOAT32X4 Vector;
+
+        if (N >= 4) {
+            Vector = MlasLoadFloat32x4(Input);
+        } else {
+            Vector = MlasBroadcastFloat32x4(Input);
+        }
+
+        Vector = MlasComputeLogVector(Vector);
+
+        if (N >= 4) {
+
+            MlasStoreFloat32x4(Output, Vector);
+
+            Input += 4;
+            Output += 4;
+            N -= 4;
+
+        } else {
+
+            MlasStoreLaneFloat32x4<0>(Output, Vector);
+
+            Input += 1;
+            Output += 1;
+            N -= 1;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasComputeLog(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the natural logarithm.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasComputeLogF32Kernel(Input, Output, N);
+}
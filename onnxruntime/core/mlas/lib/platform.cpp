@@ -59,6 +59,10 @@ MLASCPUIDInfo::MLASCPUIDInfo()
 #define HWCAP_ASIMDDP (1 << 20)
 #endif
 
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+
 #ifndef HWCAP2_I8MM
 #define HWCAP2_I8MM (1 << 13)
 #endif
@@ -80,6 +84,7 @@ MLASCPUIDInfo::MLASCPUIDInfo()
     has_fp16_ = has_arm_neon_dot_;
 
     has_arm_neon_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_I8MM) != 0);
+    has_arm_sve_ = ((getauxval(AT_HWCAP) & HWCAP_SVE) != 0);
     has_arm_sve_i8mm_ = ((getauxval(AT_HWCAP2) & HWCAP2_SVEI8MM) != 0);
 
     has_arm_neon_bf16_ = ((getauxval(AT_HWCAP2) & HWCAP2_BF16) != 0);
@@ -479,6 +484,7 @@ Return Value:
                     if (MlasInitAMX()) {
                         this->GemmU8U8Dispatch = &MlasGemmU8S8DispatchAmx;
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
+                        this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchAmx;
                     }
                 }
 #endif // __APPLE__
@@ -545,6 +551,16 @@ Return Value:
         this->GemmU8S8Dispatch = &MlasGemmU8X8DispatchUmmla;
         this->GemmS8S8Dispatch = &MlasGemmS8S8DispatchSmmla;
     }
+
+#if defined(MLAS_USE_ARM_SVE)
+    //
+    // Check if the processor supports SVE instructions. The SVE kernels are
+    // opt-in, see onnxruntime_USE_ARM_SVE.
+    //
+    if (HasDotProductInstructions && MLAS_CPUIDINFO::GetCPUIDInfo().HasArmSVE()) {
+        this->SQNBitGemmDispatch = &MlasSQNBitGemmDispatchSve;
+    }
+#endif
 #endif
 
 #endif // MLAS_TARGET_ARM64
@@ -149,9 +149,18 @@ Return Value:
         Scale += StartN;
     }
 
+    const float* RowScale = RowScale_;
+    const bool HasRowScale = RowScale != nullptr;
+
+    if (HasRowScale) {
+        RowScale += StartM;
+    }
+
     MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale_);
+    MLAS_FLOAT32X4 RowScaleVector = MlasBroadcastFloat32x4(1.0f);
 #if !defined(MLAS_SSE2_INTRINSICS)
     float ScaleValue = MlasExtractLaneFloat32x4<0>(ScaleVector);
+    float RowScaleValue = 1.0f;
 #endif
 
     C += StartM * ldc + StartN;
@@ -165,6 +174,25 @@ Return Value:
         const float* bias = Bias;
         const float* scale = Scale;
 
+        //
+        // A per matrix scale is combined with the row scale once per row, a
+        // per column scale is multiplied by it as it is loaded.
+        //
+
+        if (HasRowScale) {
+            RowScaleVector = MlasBroadcastFloat32x4(RowScale);
+            if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerMatrix) {
+                ScaleVector = MlasBroadcastFloat32x4(*Scale_ * *RowScale);
+            }
+#if !defined(MLAS_SSE2_INTRINSICS)
+            RowScaleValue = *RowScale;
+            if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerMatrix) {
+                ScaleValue = *Scale_ * RowScaleValue;
+            }
+#endif
+            RowScale++;
+        }
+
         size_t n = CountN;
 
         while (n >= 4) {
@@ -173,6 +201,9 @@ Return Value:
 
             if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerColumn) {
                 ScaleVector = MlasLoadFloat32x4(scale);
+                if (HasRowScale) {
+                    ScaleVector = MlasMultiplyFloat32x4(ScaleVector, RowScaleVector);
+                }
                 scale += 4;
             }
 
@@ -201,6 +232,9 @@ Return Value:
 
             if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerColumn) {
                 ScaleVector = _mm_load_ss(&scale[offset]);
+                if (HasRowScale) {
+                    ScaleVector = _mm_mul_ss(ScaleVector, RowScaleVector);
+                }
             }
 
             if (Mode == MLAS_QGEMM_OUTPUT_MODE::AccumulateMode) {
@@ -216,7 +250,7 @@ Return Value:
             _mm_store_ss(&c_out[offset], FloatVector);
 #else
             if (QuantGran == MLAS_QUANTIZATION_GRANULARITY::PerColumn) {
-                ScaleValue = scale[offset];
+                ScaleValue = scale[offset] * RowScaleValue;
             }
 
             float result = float(c[offset]) * ScaleValue;
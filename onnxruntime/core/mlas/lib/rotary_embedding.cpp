@@ -0,0 +1,132 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    rotary_embedding.cpp
+
+Abstract:
+
+    This module implements the rotary position embedding of one row of a
+    query or key head.
+
+    The implementation below uses the portable vector intrinsics so that it
+    targets the base instruction set of all platforms (SSE2, NEON, ...).
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasRotaryEmbedOneRow(
+    const float* Input,
+    const float* CosData,
+    const float* SinData,
+    size_t RotaryEmbeddingDim,
+    bool Interleaved,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the rotary position embedding to the first
+    RotaryEmbeddingDim elements of a row.
+
+    The row is a sequence of pairs (x, y) that are rotated by the angle of
+    their index in the cos/sin caches:
+
+        x' = x * cos - y * sin
+        y' = y * cos + x * sin
+
+    The pairs are adjacent elements if Interleaved is true, else the first
+    half of the row holds the x and the second half the y.
+
+    N.B. This implementation supports in place updates of the output buffer.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    CosData - Supplies RotaryEmbeddingDim / 2 cosine values.
+
+    SinData - Supplies RotaryEmbeddingDim / 2 sine values.
+
+    RotaryEmbeddingDim - Supplies the number of elements to rotate, which
+        must be even.
+
+    Interleaved - Supplies true if the pairs are adjacent elements.
+
+    Output - Supplies the output row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t HalfDim = RotaryEmbeddingDim / 2;
+    size_t i = 0;
+
+    if (Interleaved) {
+
+        //
+        // Deinterleave eight elements into four x and four y values, rotate
+        // them and interleave the results back.
+        //
+
+        for (; i + 4 <= HalfDim; i += 4) {
+
+            MLAS_FLOAT32X4 a = MlasLoadFloat32x4(Input + 2 * i);
+            MLAS_FLOAT32X4 b = MlasLoadFloat32x4(Input + 2 * i + 4);
+            MLAS_FLOAT32X4 Low = MlasInterleaveLowFloat32x4(a, b);
+            MLAS_FLOAT32X4 High = MlasInterleaveHighFloat32x4(a, b);
+            MLAS_FLOAT32X4 x = MlasInterleaveLowFloat32x4(Low, High);
+            MLAS_FLOAT32X4 y = MlasInterleaveHighFloat32x4(Low, High);
+
+            MLAS_FLOAT32X4 CosVector = MlasLoadFloat32x4(CosData + i);
+            MLAS_FLOAT32X4 SinVector = MlasLoadFloat32x4(SinData + i);
+            MLAS_FLOAT32X4 RotatedX = MlasSubtractFloat32x4(MlasMultiplyFloat32x4(x, CosVector), MlasMultiplyFloat32x4(y, SinVector));
+            MLAS_FLOAT32X4 RotatedY = MlasMultiplyAddFloat32x4(x, SinVector, MlasMultiplyFloat32x4(y, CosVector));
+
+            MlasStoreFloat32x4(Output + 2 * i, MlasInterleaveLowFloat32x4(RotatedX, RotatedY));
+            MlasStoreFloat32x4(Output + 2 * i + 4, MlasInterleaveHighFloat32x4(RotatedX, RotatedY));
+        }
+
+        for (; i < HalfDim; i++) {
+
+            const float x = Input[2 * i];
+            const float y = Input[2 * i + 1];
+            Output[2 * i] = x * CosData[i] - y * SinData[i];
+            Output[2 * i + 1] = y * CosData[i] + x * SinData[i];
+        }
+
+    } else {
+
+        for (; i + 4 <= HalfDim; i += 4) {
+
+            MLAS_FLOAT32X4 x = MlasLoadFloat32x4(Input + i);
+            MLAS_FLOAT32X4 y = MlasLoadFloat32x4(Input + HalfDim + i);
+
+            MLAS_FLOAT32X4 CosVector = MlasLoadFloat32x4(CosData + i);
+            MLAS_FLOAT32X4 SinVector = MlasLoadFloat32x4(SinData + i);
+            MLAS_FLOAT32X4 RotatedX = MlasSubtractFloat32x4(MlasMultiplyFloat32x4(x, CosVector), MlasMultiplyFloat32x4(y, SinVector));
+            MLAS_FLOAT32X4 RotatedY = MlasMultiplyAddFloat32x4(x, SinVector, MlasMultiplyFloat32x4(y, CosVector));
+
+            MlasStoreFloat32x4(Output + i, RotatedX);
+            MlasStoreFloat32x4(Output + HalfDim + i, RotatedY);
+        }
+
+        for (; i < HalfDim; i++) {
+
+            const float x = Input[i];
+            const float y = Input[HalfDim + i];
+            Output[i] = x * CosData[i] - y * SinData[i];
+            Output[HalfDim + i] = y * CosData[i] + x * SinData[i];
+        }
+    }
+}
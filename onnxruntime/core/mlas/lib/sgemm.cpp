@@ -1003,6 +1003,50 @@ Return Value:
 
 #endif
 
+MLAS_FORCEINLINE
+void
+MlasSgemmProcessOutput(
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor,
+    float* OutputBase,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine applies the output processor, if any, to a completed tile of
+    the output matrix. The processor is passed the full output matrix and the
+    position of the tile within it.
+
+Arguments:
+
+    OutputProcessor - Supplies the optional output processor.
+
+    OutputBase - Supplies the address of the full output matrix.
+
+    C - Supplies the address of the tile of the output matrix.
+
+    CountM - Supplies the number of rows of the tile.
+
+    CountN - Supplies the number of columns of the tile.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (OutputProcessor != nullptr) {
+        const size_t Offset = size_t(C - OutputBase);
+        OutputProcessor->Process(OutputBase, Offset / ldc, Offset % ldc, CountM, CountN, ldc);
+    }
+}
+
 MLAS_FORCEINLINE
 float*
 MlasSgemmKernelLoop(
@@ -1015,7 +1059,9 @@ MlasSgemmKernelLoop(
     size_t lda,
     size_t ldc,
     float alpha,
-    bool ZeroMode
+    bool ZeroMode,
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor = nullptr,
+    float* OutputBase = nullptr
     )
 /*++
 
@@ -1051,6 +1097,12 @@ Arguments:
     ZeroMode - Supplies true if the output matrix must be zero initialized,
         else false if the output matrix is accumulated into.
 
+    OutputProcessor - Supplies the optional output processor applied to the
+        rows produced by each kernel call, while they are in the cache. Only
+        supplied for the last slice along the K dimension.
+
+    OutputBase - Supplies the address of the full output matrix.
+
 Return Value:
 
     Returns the next address of matrix C.
@@ -1071,6 +1123,8 @@ Return Value:
         }
 #endif
 
+        MlasSgemmProcessOutput(OutputProcessor, OutputBase, C, RowsHandled, CountN, ldc);
+
         C += ldc * RowsHandled;
         A += lda * RowsHandled;
         CountM -= RowsHandled;
@@ -1093,7 +1147,9 @@ MlasSgemmOperation(
     size_t ldb,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor,
+    float* OutputBase
     )
 /*++
 
@@ -1131,6 +1187,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    OutputProcessor - Supplies the optional output processor applied to each
+        completed tile of matrix C.
+
+    OutputBase - Supplies the address of the full output matrix that matrix C
+        is a part of, as passed to the output processor.
+
 Return Value:
 
     None.
@@ -1147,6 +1209,7 @@ Return Value:
 
     if (K == 0) {
         MlasSgemmMultiplyBeta(C, M, N, ldc, beta);
+        MlasSgemmProcessOutput(OutputProcessor, OutputBase, C, M, N, ldc);
         return;
     }
 
@@ -1170,6 +1233,7 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(A, B, C, K, N, ldb, beta);
+            MlasSgemmProcessOutput(OutputProcessor, OutputBase, C, M, N, ldc);
             return;
         }
 
@@ -1177,6 +1241,7 @@ Return Value:
 
         if (TransB == CblasNoTrans) {
             MlasGemvFloatKernel(A, B, C, K, N, ldb, (beta == 0.0f));
+            MlasSgemmProcessOutput(OutputProcessor, OutputBase, C, M, N, ldc);
             return;
         }
 
@@ -1205,6 +1270,7 @@ Return Value:
 
         if (SgemmKernelM1Routine != nullptr) {
             SgemmKernelM1Routine(B, A, C, K, M, lda, beta);
+            MlasSgemmProcessOutput(OutputProcessor, OutputBase, C, M, N, ldc);
             return;
         }
 
@@ -1267,6 +1333,9 @@ Return Value:
 
             CountK = std::min(K - k, StrideK);
 
+            const MLAS_GEMM_POSTPROCESSOR<float>* SliceOutputProcessor =
+                (k + CountK == K) ? OutputProcessor : nullptr;
+
             //
             // Copy or transpose a panel of matrix B to a local packed buffer.
             //
@@ -1285,7 +1354,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, PanelB, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceOutputProcessor, OutputBase);
 
             } else {
 
@@ -1309,7 +1379,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, PanelB, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceOutputProcessor, OutputBase);
                 }
             }
 
@@ -1332,7 +1403,9 @@ MlasSgemmPackedOperation(
     size_t AlignedN,
     float beta,
     float* C,
-    size_t ldc
+    size_t ldc,
+    const MLAS_GEMM_POSTPROCESSOR<float>* OutputProcessor,
+    float* OutputBase
     )
 /*++
 
@@ -1372,6 +1445,12 @@ Arguments:
 
     ldc - Supplies the first dimension of matrix C.
 
+    OutputProcessor - Supplies the optional output processor applied to each
+        completed tile of matrix C.
+
+    OutputBase - Supplies the address of the full output matrix that matrix C
+        is a part of, as passed to the output processor.
+
 Return Value:
 
     None.
@@ -1411,6 +1490,9 @@ Return Value:
 
             CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
 
+            const MLAS_GEMM_POSTPROCESSOR<float>* SliceOutputProcessor =
+                (k + CountK == K) ? OutputProcessor : nullptr;
+
             //
             // Step through each slice of matrix A along the M dimension.
             //
@@ -1420,7 +1502,8 @@ Return Value:
 
             if (TransA == CblasNoTrans) {
 
-                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode);
+                MlasSgemmKernelLoop(A + k, pb, c, CountK, M, CountN, lda, ldc, alpha, ZeroMode,
+                    SliceOutputProcessor, OutputBase);
 
             } else {
 
@@ -1444,7 +1527,8 @@ Return Value:
                     // Step through the rows of the local buffer.
                     //
 
-                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode);
+                    c = MlasSgemmKernelLoop(PanelA, pb, c, CountK, RowsTransposed, CountN, CountK, ldc, alpha, ZeroMode,
+                        SliceOutputProcessor, OutputBase);
                 }
             }
 
@@ -1540,7 +1624,8 @@ Return Value:
 
         MlasSgemmPackedOperation(TransA, RangeCountM, RangeStartN, RangeCountN,
             K, DataParams->alpha, A, lda, DataParams->B,
-            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc);
+            BlockedN * MLAS_SGEMM_STRIDEN_THREAD_ALIGN, DataParams->beta, C, ldc,
+            DataParams->OutputProcessor, DataParams->C);
 
     } else {
 
@@ -1549,9 +1634,117 @@ Return Value:
         const float* B = (const float*)DataParams->B + RangeStartN * ((TransB == CblasNoTrans) ? 1 : ldb);
 
         MlasSgemmOperation(TransA, TransB, RangeCountM, RangeCountN, K,
-            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc);
+            DataParams->alpha, A, lda, B, ldb, DataParams->beta, C, ldc,
+            DataParams->OutputProcessor, DataParams->C);
     }
 }
+MLAS_FORCEINLINE
+ptrdiff_t
+MlasSgemmTargetThreadCount(
+    double Complexity,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of target threads given the complexity
+    of the SGEMM operation. Small requests should run using the single
+    threaded path.
+
+Arguments:
+
+    Complexity - Supplies the total number of multiply-adds of the operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns the number of target threads.
+
+--*/
+{
+    ptrdiff_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
+        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
+    }
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    return TargetThreadCount;
+}
+
+MLAS_FORCEINLINE
+ptrdiff_t
+MlasSgemmPartitionThreads(
+    size_t M,
+    size_t N,
+    ptrdiff_t ThreadCount,
+    ptrdiff_t* ThreadCountM,
+    ptrdiff_t* ThreadCountN
+    )
+/*++
+
+Routine Description:
+
+    This routine segments one SGEMM operation across the supplied number of
+    threads.
+
+    N.B. Currently, the operation is segmented as a 1D partition, which
+    works okay for operations involving skinny matrices.
+
+Arguments:
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    ThreadCount - Supplies the number of threads to use.
+
+    ThreadCountM - Receives the thread partition on the M dimension.
+
+    ThreadCountN - Receives the thread partition on the N dimension.
+
+Return Value:
+
+    Returns the number of threads used, which is less than ThreadCount if the
+    operation is too small to be segmented further.
+
+--*/
+{
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(ThreadCount) > BlockedN) {
+            ThreadCount = ptrdiff_t(BlockedN);
+        }
+
+        *ThreadCountM = 1;
+        *ThreadCountN = ThreadCount;
+
+    } else {
+
+        if (size_t(ThreadCount) > M) {
+            ThreadCount = ptrdiff_t(M);
+        }
+
+        *ThreadCountM = ThreadCount;
+        *ThreadCountN = 1;
+    }
+
+    return ThreadCount;
+}
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // Chance of arithmetic overflow could be reduced
@@ -1578,52 +1771,17 @@ MlasGemmBatch(
 
     const double Complexity = double(M) * double(N) * double(K);
 
-    ptrdiff_t TargetThreadCount;
-
-    if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * GetMlasPlatform().MaximumThreadCount)) {
-        TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
-    } else {
-        TargetThreadCount = GetMlasPlatform().MaximumThreadCount;
-    }
-
-    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
-
-    if (TargetThreadCount >= MaximumThreadCount) {
-        TargetThreadCount = MaximumThreadCount;
-    }
+    const ptrdiff_t TargetThreadCount = MlasSgemmTargetThreadCount(Complexity, ThreadPool);
 
     //
     // Segment the operation across multiple threads.
     //
-    // N.B. Currently, the operation is segmented as a 1D partition, which
-    // works okay for operations involving skinny matrices.
-    //
 
     ptrdiff_t ThreadsPerGemm = (TargetThreadCount + BatchSize - 1) / BatchSize;
     ptrdiff_t ThreadCountM;
     ptrdiff_t ThreadCountN;
 
-    if (N > M) {
-
-        const size_t BlockedN = (N + MLAS_SGEMM_STRIDEN_THREAD_ALIGN - 1) /
-            MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
-
-        if (size_t(ThreadsPerGemm) > BlockedN) {
-            ThreadsPerGemm = ptrdiff_t(BlockedN);
-        }
-
-        ThreadCountM = 1;
-        ThreadCountN = ThreadsPerGemm;
-
-    } else {
-
-        if (size_t(ThreadsPerGemm) > M) {
-            ThreadsPerGemm = ptrdiff_t(M);
-        }
-
-        ThreadCountM = ThreadsPerGemm;
-        ThreadCountN = 1;
-    }
+    ThreadsPerGemm = MlasSgemmPartitionThreads(M, N, ThreadsPerGemm, &ThreadCountM, &ThreadCountN);
 
     MlasTrySimpleParallel(ThreadPool,
         ThreadsPerGemm * static_cast<ptrdiff_t>(BatchSize),
@@ -1635,6 +1793,83 @@ MlasGemmBatch(
             TransA, TransB, M, N, K, &(Data[GemmIdx]), ThreadIdx);
     });
 }
+
+void
+MLASCALL
+MlasGemmGrouped(
+    const MLAS_SGEMM_GROUP_PARAMS* Groups,
+    size_t GroupCount,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    //
+    // Compute the number of target threads given the total complexity of the
+    // groups.
+    //
+
+    double TotalComplexity = 0.0;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        TotalComplexity += double(Groups[g].M) * double(Groups[g].N) * double(Groups[g].K);
+    }
+
+    const ptrdiff_t TargetThreadCount = MlasSgemmTargetThreadCount(TotalComplexity, ThreadPool);
+
+    //
+    // Distribute the threads across the groups in proportion to their
+    // complexity. Every group with a non-empty output gets at least a thread,
+    // so groups with K equal to zero still apply their beta multiplier.
+    //
+
+    const double ThreadsPerComplexity =
+        (TotalComplexity > 0.0) ? double(TargetThreadCount) / TotalComplexity : 0.0;
+
+    auto GroupThreadCount = [ThreadsPerComplexity](const MLAS_SGEMM_GROUP_PARAMS& Group,
+        ptrdiff_t* ThreadCountM, ptrdiff_t* ThreadCountN) -> ptrdiff_t
+    {
+        if (Group.M == 0 || Group.N == 0) {
+            return 0;
+        }
+
+        const double Complexity = double(Group.M) * double(Group.N) * double(Group.K);
+        const ptrdiff_t ThreadCount = std::max(ptrdiff_t(std::ceil(Complexity * ThreadsPerComplexity)), ptrdiff_t(1));
+
+        return MlasSgemmPartitionThreads(Group.M, Group.N, ThreadCount, ThreadCountM, ThreadCountN);
+    };
+
+    ptrdiff_t TotalThreadCount = 0;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+        ptrdiff_t ThreadCountM;
+        ptrdiff_t ThreadCountN;
+        TotalThreadCount += GroupThreadCount(Groups[g], &ThreadCountM, &ThreadCountN);
+    }
+
+    //
+    // Schedule the segments of all groups as a single job. Each thread index
+    // is mapped to its group by walking the groups in order.
+    //
+
+    MlasTrySimpleParallel(ThreadPool, TotalThreadCount, [&](ptrdiff_t tid) {
+
+        for (size_t g = 0; g < GroupCount; g++) {
+
+            const MLAS_SGEMM_GROUP_PARAMS& Group = Groups[g];
+
+            ptrdiff_t ThreadCountM;
+            ptrdiff_t ThreadCountN;
+            const ptrdiff_t ThreadCount = GroupThreadCount(Group, &ThreadCountM, &ThreadCountN);
+
+            if (tid < ThreadCount) {
+                MlasSgemmThreaded(ThreadCountM, ThreadCountN, Group.TransA, Group.TransB,
+                    Group.M, Group.N, Group.K, &Group.Data, tid);
+                return;
+            }
+
+            tid -= ThreadCount;
+        }
+    });
+}
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(pop)
 #endif
@@ -0,0 +1,494 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the quantized n-bit integer matrix
+    multiplication kernels for x64 amx.
+
+    The CompInt8 kernel multiplies the int8 blocks of A with the 4-bit
+    blocks of B with TDPBSUD, so that each tile instruction computes the
+    block products of 16 rows and 16 columns. B is packed in tiles of 16
+    columns, laid out so that the nibbles of a block unpack into the VNNI
+    layout of an AMX tile with two AVX512 bitwise operations per 64 bytes.
+    The scales are laid out in the same tiles of 16 columns as the block
+    sums. CompFp32 uses the avx512vnni implementation.
+
+    The module is compiled with the flags of the AVX512 VNNI kernels and
+    -mamx-tile -mamx-int8, like qgemm_kernel_amx.cpp.
+
+--*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_avx_common.h"
+#include "amx_common.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+
+namespace
+{
+
+constexpr size_t BlkBitWidth = 4;
+
+constexpr size_t TILE_M = 16;
+constexpr size_t TILE_N = 16;
+constexpr size_t TILE_K = 64;
+
+// Size of a B tile, TILE_K / 4 rows of TILE_N * 4 int8 values.
+constexpr size_t BTileSize = TILE_K * TILE_N;
+
+// Each iteration of the kernel computes two C tiles, i.e. 32 columns.
+constexpr size_t StrideN = 2 * TILE_N;
+
+MLAS_FORCEINLINE
+void
+SQ4BitGemmAmxThreadInit()
+{
+    //
+    // Use the same 16 rows by 64 bytes configuration as the QGEMM kernels, so
+    // that the tiles need not be reconfigured when the kernels are interleaved.
+    //
+
+    static thread_local struct tileconfig_t tc = {0};
+    if (tc.palette_id == 0) {
+        tc.palette_id = 1;
+        for (int t = 0; t < 8; t++) {
+            tc.rows[t] = 16;
+            tc.colb[t] = 64;
+        }
+    }
+
+    struct tileconfig_t current_tc = {0};
+    tile_storeconfig(&current_tc);
+    if (std::memcmp(&current_tc, &tc, sizeof(tc)) != 0) {
+        tile_loadconfig(&tc);
+    }
+}
+
+size_t
+SQ4BitGemmPackQuantBDataSizeAmx(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    if (ComputeType != CompInt8) {
+        return SQ4BitGemmPackQuantBDataSize(N, K, BlkLen, ComputeType);
+    }
+
+    // Same layout as PackedQuantBDataStruct, except for the scales, which are padded to tiles of 16 columns.
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t PackedQuantBDataSize = N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen) + 31;
+    const size_t BlkSumSize =
+        MlasDivRoundup(N, TILE_N) * BlockCountK * TILE_N * sizeof(float) + MlasQNBitQuantBBlkSumAlignment() - 1;
+    const size_t ScaleSize = MlasDivRoundup(N, TILE_N) * BlockCountK * TILE_N * sizeof(float);
+    return PackedQuantBDataSize + BlkSumSize + ScaleSize;
+}
+
+//
+// Packs B in tiles of 16 columns, block by block. The block k_blk of a tile
+// with c columns (only the last tile has fewer than 16) is c * BlkLen / 2
+// bytes at offset k_blk * c * BlkLen / 2 of the tile. Row r of the VNNI layout
+// holds the values k = 4 * r + q of each column n at byte n * 4 + q. The rows
+// 2 * j and 2 * j + 1 are stored as the low and high nibbles of the 4 * c
+// bytes at offset j * 4 * c of the block:
+//
+// src (column n): | v0 v1 | v2 v3 | ... | v(BlkLen-2) v(BlkLen-1) |
+//   =>
+// dst (row pair j, column n): | v(8j) v(8j+4) | v(8j+1) v(8j+5) | v(8j+2) v(8j+6) | v(8j+3) v(8j+7) |
+//
+void
+PackQuantBAmx(
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool,
+    size_t N,
+    size_t BlockCountK,
+    size_t BlkLen
+)
+{
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t Iterations = N * BlockCountK;  // one iteration per block
+
+    MlasTrySimpleParallel(ThreadPool, Iterations, [&](ptrdiff_t tid) {
+        const size_t n = tid / BlockCountK;
+        const size_t k_blk = tid % BlockCountK;
+
+        const size_t TileStartN = n / TILE_N * TILE_N;
+        const size_t TileCountN = std::min(N - TileStartN, TILE_N);
+
+        const std::byte* QuantBData = QuantBDataBegin + (n * BlockCountK + k_blk) * BlkDataSize;
+        std::byte* PackedQuantBData = PackedQuantBDataBegin + TileStartN * BlockCountK * BlkDataSize +
+                                      k_blk * TileCountN * BlkDataSize + (n - TileStartN) * 4;
+
+        auto get_value = [&](size_t k) {
+            const std::byte b = QuantBData[k / 2];
+            return (k % 2 == 0) ? (b & std::byte{0x0F}) : (b >> 4);
+        };
+
+        for (size_t j = 0; j < BlkLen / 8; ++j) {
+            for (size_t q = 0; q < 4; ++q) {
+                PackedQuantBData[j * 4 * TileCountN + q] = get_value(8 * j + q) | (get_value(8 * j + 4 + q) << 4);
+            }
+        }
+    });
+}
+
+//
+// Computes the block sums and copies the scales of B into the layout of the
+// block sums, a width 16 row major matrix. The padding columns of the last
+// tile are zero, the kernel loads the scales of whole tiles.
+//
+void
+ComputePackBlkSumAmx(
+    size_t N,
+    size_t BlockCountK,
+    const float* QuantBScaleBegin,
+    const std::byte* QuantBZPBegin,
+    float* PackedQuantBScaleBegin,
+    float* BlockSumBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    if (QuantBScaleBegin) {
+        const size_t PaddedCountN = MlasDivRoundup(N, TILE_N) * TILE_N;
+        std::fill(PackedQuantBScaleBegin + (PaddedCountN - TILE_N) * BlockCountK,
+                  PackedQuantBScaleBegin + PaddedCountN * BlockCountK, 0.0f);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, N * BlockCountK, [&](ptrdiff_t tid) {
+        const size_t n = tid / BlockCountK;
+        const size_t k_blk = tid % BlockCountK;
+
+        const size_t dst_offset = ((n / TILE_N) * BlockCountK + k_blk) * TILE_N + n % TILE_N;
+        if (QuantBScaleBegin) {
+            PackedQuantBScaleBegin[dst_offset] = QuantBScaleBegin[n * BlockCountK + k_blk];
+        }
+
+        if (BlockSumBegin) {
+            uint8_t zp = 8;
+            if (QuantBZPBegin) {
+                const size_t ZPCountK = MlasDivRoundup(BlockCountK, 2);
+                const std::byte QuantBZP = QuantBZPBegin[ZPCountK * n + k_blk / 2];
+                zp = (uint8_t)((k_blk % 2 == 0) ? (QuantBZP & std::byte{0x0F}) : (QuantBZP >> 4));
+            }
+            BlockSumBegin[dst_offset] = -PackedQuantBScaleBegin[dst_offset] * zp;
+        }
+    });
+}
+
+void
+SQ4BitGemmPackQuantBDataAndBlkSumAmx(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    const float* QuantBScaleBegin,
+    bool has_zp_input,
+    const std::byte* QuantBZPBegin,
+    PackedQuantBDataStruct& packed_quant_b,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    assert(BlkLen >= 16 && BlkLen % 16 == 0);
+    assert(ComputeType == CompInt8);
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+
+    if (QuantBDataBegin) {
+        PackQuantBAmx(QuantBDataBegin, packed_quant_b.PackedQuantBData, ThreadPool, N, BlockCountK, BlkLen);
+    }
+
+    // The block sums are computed from the packed scales, which may have been packed by an earlier call.
+    const bool compute_blk_sum = (QuantBScaleBegin && !has_zp_input) || QuantBZPBegin;
+    if (QuantBScaleBegin || compute_blk_sum) {
+        ComputePackBlkSumAmx(
+            N, BlockCountK, QuantBScaleBegin, QuantBZPBegin, packed_quant_b.PackedQuantBScale,
+            compute_blk_sum ? packed_quant_b.QuantBBlkSum : nullptr, ThreadPool
+        );
+    }
+}
+
+//
+// Unpacks the block of a B tile with CountN columns into BlkLen / 64 tiles
+// (rounded up) of 16 rows by 64 bytes. The rows beyond BlkLen / 4 and the
+// bytes of the missing columns are left untouched, the caller zeroes them.
+//
+MLAS_FORCEINLINE
+void
+UnpackBTileAmx(const std::byte* QuantBData, size_t CountN, size_t BlkLen, uint8_t* BTile)
+{
+    const __mmask64 mask = (CountN == TILE_N) ? ~__mmask64{0} : ((__mmask64{1} << (4 * CountN)) - 1);
+    const __m512i low_mask = _mm512_set1_epi8(0x0F);
+
+    for (size_t j = 0; j < BlkLen / 8; ++j) {
+        const __m512i bv = _mm512_maskz_loadu_epi8(mask, QuantBData + j * 4 * CountN);
+        const __m512i lo = _mm512_and_si512(bv, low_mask);
+        const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(bv, 4), low_mask);
+
+        // row 2 * j is at (2 * j / 16) * BTileSize + (2 * j % 16) * TILE_K
+        uint8_t* row = BTile + (j / 8) * BTileSize + (j % 8) * 2 * TILE_K;
+        _mm512_store_si512(row, lo);
+        _mm512_store_si512(row + TILE_K, hi);
+    }
+}
+
+MLAS_FORCEINLINE
+__mmask16
+TailMask(size_t CountN)
+{
+    return (CountN >= TILE_N) ? __mmask16(0xFFFF) : __mmask16((1u << CountN) - 1);
+}
+
+void
+SQ4BitGemmKernel_CompInt8_amx(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    const float* Bias,
+    size_t ldc
+)
+{
+    const size_t lda = BlockCountK * BlkLen;
+    const size_t ldb = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t SubBlkCountK = MlasDivRoundup(BlkLen, TILE_K);
+
+    //
+    // The A tiles always load 16 rows, the rows of the last partial tile are
+    // copied to a zero padded buffer. The loads of a block shorter than 64
+    // read into the next block, or past the end of a row of the padded
+    // buffer, which is harmless since the B rows they are multiplied with
+    // are zero.
+    //
+
+    const size_t CountRemainingM = CountM % TILE_M;
+    const size_t ldaPadded = lda + TILE_K;
+
+    const size_t BTilesSize = UpAlignSize(2 * SubBlkCountK * BTileSize);
+    const size_t CTilesSize = UpAlignSize(TILE_M * StrideN * sizeof(int32_t));
+    const size_t AccSize = UpAlignSize(CountM * StrideN * sizeof(float));
+    const size_t APaddedSize = (CountRemainingM > 0) ? UpAlignSize(TILE_M * ldaPadded) : 0;
+
+    MlasThreadedBufAlloc(BTilesSize + CTilesSize + AccSize + APaddedSize);
+    uint8_t* BTiles = ThreadedBufHolder.get();
+    int32_t* CTiles = reinterpret_cast<int32_t*>(BTiles + BTilesSize);
+    float* Acc = reinterpret_cast<float*>(BTiles + BTilesSize + CTilesSize);
+    int8_t* APadded = reinterpret_cast<int8_t*>(BTiles + BTilesSize + CTilesSize + AccSize);
+
+    std::memset(BTiles, 0, BTilesSize);
+    if (CountRemainingM > 0) {
+        std::memset(APadded, 0, APaddedSize);
+        for (size_t m = 0; m < CountRemainingM; ++m) {
+            std::memcpy(APadded + m * ldaPadded, QuantA + (CountM - CountRemainingM + m) * lda, lda);
+        }
+    }
+
+    SQ4BitGemmAmxThreadInit();
+
+    for (size_t n = 0; n < CountN; n += StrideN) {
+        const size_t CountTileN0 = std::min(CountN - n, TILE_N);
+        const size_t CountTileN1 = (CountN - n > TILE_N) ? std::min(CountN - n - TILE_N, TILE_N) : 0;
+
+        std::fill_n(Acc, CountM * StrideN, 0.0f);
+
+        const std::byte* b_tile0 = QuantBData + n * ldb;
+        const std::byte* b_tile1 = QuantBData + (n + TILE_N) * ldb;
+        const float* b_scale0 = QuantBScale + n * BlockCountK;
+        const float* b_scale1 = QuantBScale + (n + TILE_N) * BlockCountK;
+
+        for (size_t k_blk = 0; k_blk < BlockCountK; ++k_blk) {
+            // The columns of the last tile beyond CountN are zero and so are their scales.
+            UnpackBTileAmx(b_tile0 + k_blk * CountTileN0 * BlkLen / 2, CountTileN0, BlkLen, BTiles);
+            const __m512 scale_b0 = _mm512_loadu_ps(b_scale0 + k_blk * TILE_N);
+            __m512 scale_b1 = _mm512_setzero_ps();
+            if (CountTileN1 > 0) {
+                UnpackBTileAmx(
+                    b_tile1 + k_blk * CountTileN1 * BlkLen / 2, CountTileN1, BlkLen, BTiles + SubBlkCountK * BTileSize
+                );
+                scale_b1 = _mm512_loadu_ps(b_scale1 + k_blk * TILE_N);
+            }
+
+            for (size_t m = 0; m < CountM; m += TILE_M) {
+                const bool is_padded = m + TILE_M > CountM;
+                const int8_t* a_blk = is_padded ? APadded + k_blk * BlkLen
+                                                : reinterpret_cast<const int8_t*>(QuantA) + m * lda + k_blk * BlkLen;
+                const int a_stride = static_cast<int>(is_padded ? ldaPadded : lda);
+
+                tile_zero(TMM4);
+                tile_zero(TMM5);
+                for (size_t k_sub = 0; k_sub < SubBlkCountK; ++k_sub) {
+                    tile_loadd(TMM0, a_blk + k_sub * TILE_K, a_stride);
+                    tile_loadd(TMM2, BTiles + k_sub * BTileSize, TILE_K);
+                    tile_dpbsud(TMM4, TMM0, TMM2);
+                    if (CountTileN1 > 0) {
+                        tile_loadd(TMM3, BTiles + (SubBlkCountK + k_sub) * BTileSize, TILE_K);
+                        tile_dpbsud(TMM5, TMM0, TMM3);
+                    }
+                }
+                tile_stored(TMM4, CTiles, StrideN * sizeof(int32_t));
+                if (CountTileN1 > 0) {
+                    tile_stored(TMM5, CTiles + TILE_N, StrideN * sizeof(int32_t));
+                }
+
+                const size_t RowCount = std::min(CountM - m, TILE_M);
+                for (size_t r = 0; r < RowCount; ++r) {
+                    const __m512 scale_a = _mm512_set1_ps(QuantAScale[(m + r) * BlockCountK + k_blk]);
+                    const int32_t* c_row = CTiles + r * StrideN;
+                    float* acc_row = Acc + (m + r) * StrideN;
+
+                    __m512 acc0 = _mm512_load_ps(acc_row);
+                    acc0 = _mm512_fmadd_ps(
+                        _mm512_cvtepi32_ps(_mm512_load_si512(c_row)), _mm512_mul_ps(scale_a, scale_b0), acc0
+                    );
+                    _mm512_store_ps(acc_row, acc0);
+
+                    if (CountTileN1 > 0) {
+                        __m512 acc1 = _mm512_load_ps(acc_row + TILE_N);
+                        acc1 = _mm512_fmadd_ps(
+                            _mm512_cvtepi32_ps(_mm512_load_si512(c_row + TILE_N)), _mm512_mul_ps(scale_a, scale_b1), acc1
+                        );
+                        _mm512_store_ps(acc_row + TILE_N, acc1);
+                    }
+                }
+            }
+        }
+
+        const __mmask16 mask0 = TailMask(CountTileN0);
+        const __mmask16 mask1 = TailMask(CountTileN1);
+        const __m512 bias0 = (Bias != nullptr) ? _mm512_maskz_loadu_ps(mask0, Bias + n) : _mm512_setzero_ps();
+        const __m512 bias1 = (Bias != nullptr && CountTileN1 > 0) ? _mm512_maskz_loadu_ps(mask1, Bias + n + TILE_N)
+                                                                  : _mm512_setzero_ps();
+        for (size_t m = 0; m < CountM; ++m) {
+            const float* acc_row = Acc + m * StrideN;
+            float* c_row = C + m * ldc + n;
+            _mm512_mask_storeu_ps(c_row, mask0, _mm512_add_ps(_mm512_load_ps(acc_row), bias0));
+            if (CountTileN1 > 0) {
+                _mm512_mask_storeu_ps(c_row + TILE_N, mask1, _mm512_add_ps(_mm512_load_ps(acc_row + TILE_N), bias1));
+            }
+        }
+    }
+}
+
+size_t
+SQ4BitGemmKernel_BlkSum_CompInt8_amx(
+    const size_t BlkLen,
+    const std::byte* QuantA,
+    const float* QuantAScale,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* /*QuantBZeroPoint*/,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    const float* Bias,
+    size_t ldc,
+    const float* ABlockSum,
+    const float* QuantBBlkSum
+)
+{
+    SQ4BitGemmKernel_CompInt8_amx(
+        BlkLen, QuantA, QuantAScale, QuantBData, QuantBScale, C, CountM, CountN, BlockCountK, Bias, ldc
+    );
+
+    float* c_blk = C;
+    const float* b_blk_sum = QuantBBlkSum;
+
+    size_t RowsRemaining = CountM;
+    const float* a_blksum_row = ABlockSum;
+    while (RowsRemaining > 0) {
+        auto RowsHandled = GetMlasPlatform().GemmFloatKernel(
+            a_blksum_row, b_blk_sum, c_blk, BlockCountK, RowsRemaining, CountN, BlockCountK, ldc, 1.f, false
+        );
+
+        c_blk += ldc * RowsHandled;
+        a_blksum_row += BlockCountK * RowsHandled;
+        RowsRemaining -= RowsHandled;
+    }
+    return CountM;
+}
+
+//
+// The CompFp32 kernels are those of avx512vnni. They are called through its
+// dispatch at run time, since the dispatch structures are initialized in an
+// unspecified order.
+//
+
+void
+SQ4BitGemmM1Kernel_CompFp32_amx(
+    size_t BlkLen,
+    const float* A,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockStrideQuantB,
+    const float* Bias
+)
+{
+    MlasSQNBitGemmDispatchAvx512vnni.SQ4BitGemmM1Kernel_CompFp32(
+        BlkLen, A, QuantBData, QuantBScale, QuantBZeroPoint, C, CountN, CountK, BlockStrideQuantB, Bias
+    );
+}
+
+}  // namespace
+
+void MLASCALL
+QuantizeARow_CompInt8_avx512(
+    size_t BlkLen,
+    const float* A,
+    size_t CountK,
+    std::byte* QuantA,
+    float* QuantAScale,
+    float* AScaledBlkSum  // scale_k * Sum_blklen(a_i)
+);
+
+//
+// Kernel dispatch structure definition.
+//
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchAmx = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d;
+
+    d.SQ4BitGemmPackQuantBDataSize = SQ4BitGemmPackQuantBDataSizeAmx;
+    d.SQ4BitGemmPackQuantBData = SQ4BitGemmPackQuantBData;
+    d.SQ4BitGemmPackQuantBDataAndBlkSum = SQ4BitGemmPackQuantBDataAndBlkSumAmx;
+
+    d.SQ4BitGemmPerGemmWorkspaceSize = SQ4BitGemmPerGemmWorkspaceSize;
+    d.SQ4BitGemmPerGemmWorkspaceAlignment = SQ4BitGemmPerGemmWorkspaceAlignment;
+
+    d.SQ4BitGemmM1Kernel_CompFp32 = SQ4BitGemmM1Kernel_CompFp32_amx;
+    d.Q4BitBlkDequantBForSgemm_CompFp32 = Q4BitBlkDequantBForSgemm_CompFp32_avx2;
+
+    d.SQ4BitGemmKernel_BlkSum_CompInt8 = SQ4BitGemmKernel_BlkSum_CompInt8_amx;
+    d.QuantizeARowComputeBlkSum_CompInt8 = QuantizeARow_CompInt8_avx512;
+
+    return d;
+}();
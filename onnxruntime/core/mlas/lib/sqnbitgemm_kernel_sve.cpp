@@ -0,0 +1,435 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sqnbitgemm_kernel_sve.cpp
+
+Abstract:
+
+    This module implements the float/quantized n-bit integer matrix
+    multiplication kernels for ARM SVE.
+
+    The CompInt8 kernel is vector length agnostic. B is packed so that byte i
+    of a block holds the values i and i + BlkLen / 2, i.e. the low and high
+    nibbles of the block data are contiguous halves of the block. Blocks that
+    fit in a vector are unpacked into a single vector with SPLICE, longer
+    blocks are processed in vector length chunks of each half.
+
+    CompFp32 uses the ARM NEON implementation.
+
+    The dispatch is only selected in builds with MLAS_USE_ARM_SVE defined
+    (onnxruntime_USE_ARM_SVE), which must compile this module with +sve.
+
+--*/
+
+#include <arm_neon.h>
+#include <arm_sve.h>
+
+#include <cassert>
+
+#include "sqnbitgemm.h"
+#include "sqnbitgemm_kernel_neon.h"
+#include "sqnbitgemm_q8_block.h"
+
+namespace sqnbitgemm_sve
+{
+
+namespace
+{
+
+constexpr size_t BlkBitWidth = 4;
+
+//
+// Quantized B data packing function implementation.
+//
+
+size_t
+SQ4BitGemmPackQuantBDataSize(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(ComputeType);  // same size regardless of ComputeType
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t PackedQuantBDataSize = N * BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    return PackedQuantBDataSize;
+}
+
+void
+SQ4BitGemmPackQuantBData(
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType,
+    const std::byte* QuantBDataBegin,
+    std::byte* PackedQuantBDataBegin,
+    MLAS_THREADPOOL* ThreadPool
+)
+{
+    assert(BlkLen >= 16 && BlkLen % 16 == 0);
+
+    const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t Iterations = N * BlockCountK;  // one iteration per block
+
+    // The CompFp32 kernels are the ARM NEON ones, which expect sub-blocks of 16.
+    const size_t SubBlkLen = (ComputeType == CompInt8) ? BlkLen : 16;
+
+    const size_t SubBlkDataSize = SubBlkLen / 2;
+    const size_t SubBlkBytePairCount = SubBlkLen / 4;
+
+    //
+    // Pack SubBlkLen 4-bit values (SubBlkLen / 2 bytes) at a time like this:
+    //
+    // src: | v0 v1 | v2 v3 | ... | v(SubBlkLen-2) v(SubBlkLen-1) |
+    //   =>
+    // dst: | v0 v(SubBlkLen/2) | v1 v(SubBlkLen/2+1) | ... | v(SubBlkLen/2-1) v(SubBlkLen-1) |
+    //
+
+    MlasTrySimpleParallel(
+        ThreadPool, Iterations,
+        [&](ptrdiff_t tid) {
+            const size_t n = tid / BlockCountK;
+            const size_t k_blk = tid % BlockCountK;
+
+            const size_t data_offset = n * BlockCountK * BlkDataSize + k_blk * BlkDataSize;
+            const std::byte* QuantBData = QuantBDataBegin + data_offset;
+            std::byte* PackedQuantBData = PackedQuantBDataBegin + data_offset;
+
+            for (size_t kk = 0; kk < BlkLen; kk += SubBlkLen) {
+                for (size_t byte_pair_idx = 0; byte_pair_idx < SubBlkBytePairCount; ++byte_pair_idx) {
+                    const std::byte src0 = QuantBData[byte_pair_idx];
+                    const std::byte src1 = QuantBData[byte_pair_idx + SubBlkDataSize / 2];
+
+                    std::byte& dst0 = PackedQuantBData[2 * byte_pair_idx];
+                    std::byte& dst1 = PackedQuantBData[2 * byte_pair_idx + 1];
+
+                    dst0 = (src0 & std::byte{0x0F}) | ((src1 & std::byte{0x0F}) << 4);
+                    dst1 = (src0 >> 4) | ((src1 >> 4) << 4);
+                }
+
+                QuantBData += SubBlkDataSize;
+                PackedQuantBData += SubBlkDataSize;
+            }
+        }
+    );
+}
+
+//
+// Workspace size calculation function implementation.
+//
+
+size_t
+SQ4BitGemmPerGemmWorkspaceSize(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(N);
+
+    switch (ComputeType) {
+        case CompInt8: {
+            // workspace buffer is used for block quantization of A to int8
+            const size_t BlockCountK = MlasDivRoundup(K, BlkLen);
+            const size_t PerGemmWorkspaceSize = M * BlockCountK * Q8BlkSize(BlkLen);
+            return PerGemmWorkspaceSize;
+        }
+        default: {
+            return 0;
+        }
+    }
+}
+
+size_t
+SQ4BitGemmPerGemmWorkspaceAlignment(
+    size_t BlkLen,
+    MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType
+)
+{
+    MLAS_UNREFERENCED_PARAMETER(BlkLen);
+
+    switch (ComputeType) {
+        case CompInt8: {
+            return Q8BlkAlignment();
+        }
+        default: {
+            return 1;
+        }
+    }
+}
+
+//
+// CompInt8 kernel implementation.
+//
+
+template <bool HasZeroPoint>
+MLAS_FORCEINLINE int8_t
+LoadZeroPoint(const std::byte* QuantBZeroPointColPtr, size_t k_blk_idx)
+{
+    if constexpr (HasZeroPoint) {
+        const std::byte zp_packed = QuantBZeroPointColPtr[k_blk_idx / 2];
+        return ((k_blk_idx & 1) == 0) ? std::to_integer<int8_t>(zp_packed & std::byte{0x0F})
+                                      : std::to_integer<int8_t>(zp_packed >> 4);
+    } else {
+        MLAS_UNREFERENCED_PARAMETER(QuantBZeroPointColPtr);
+        MLAS_UNREFERENCED_PARAMETER(k_blk_idx);
+        return 8;
+    }
+}
+
+// Unpacks a block of at most svcntb() values into a single vector and subtracts the zero point.
+MLAS_FORCEINLINE svint8_t
+LoadBBlk(svbool_t HalfBlkPred, const std::byte* QuantBDataPtr, int8_t bzp)
+{
+    const svbool_t all = svptrue_b8();
+    const svuint8_t bv_packed = svld1_u8(HalfBlkPred, reinterpret_cast<const uint8_t*>(QuantBDataPtr));
+    const svuint8_t bv = svsplice_u8(HalfBlkPred, svand_n_u8_x(all, bv_packed, 0x0F), svlsr_n_u8_x(all, bv_packed, 4));
+    return svsub_n_s8_x(all, svreinterpret_s8_u8(bv), bzp);
+}
+
+// Unpacks a vector length chunk of a block into the values of its low and high halves and subtracts the zero point.
+MLAS_FORCEINLINE void
+LoadBBlkChunk(svbool_t Pred, const std::byte* QuantBDataPtr, int8_t bzp, svint8_t& bv_lo, svint8_t& bv_hi)
+{
+    const svbool_t all = svptrue_b8();
+    const svuint8_t bv_packed = svld1_u8(Pred, reinterpret_cast<const uint8_t*>(QuantBDataPtr));
+    bv_lo = svsub_n_s8_x(all, svreinterpret_s8_u8(svand_n_u8_x(all, bv_packed, 0x0F)), bzp);
+    bv_hi = svsub_n_s8_x(all, svreinterpret_s8_u8(svlsr_n_u8_x(all, bv_packed, 4)), bzp);
+}
+
+//
+// Computes one row and NumCols (1 or 4) columns of output. The A values of
+// the inactive lanes are loaded as zero, so that the B values of those lanes
+// do not contribute to the dot products.
+//
+template <size_t NumCols, bool HasZeroPoint>
+MLAS_FORCEINLINE void
+SQ4BitGemm_CompInt8_Compute1xNumCols(
+    size_t BlkLen,
+    const std::byte* QuantARowPtr,
+    const std::byte* QuantBDataColPtr,
+    const float* QuantBScaleColPtr,
+    const std::byte* QuantBZeroPointColPtr,
+    const float* BiasPtr,
+    float* SumPtr,
+    size_t BlockCountK,
+    size_t StrideQuantBData,
+    size_t StrideQuantBScale,
+    size_t StrideQuantBZeroPoint
+)
+{
+    static_assert(NumCols == 1 || NumCols == 4, "NumCols must be 1 or 4.");
+
+    const svbool_t all = svptrue_b8();
+    const size_t BlkDataSize = MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t VectorLength = svcntb();
+
+    const std::byte* QuantAPtr = QuantARowPtr;
+    const std::byte* QuantBDataPtr = QuantBDataColPtr;
+
+    svfloat32_t acc0 = svdup_n_f32(0.0f);
+    svfloat32_t acc1 = svdup_n_f32(0.0f);
+    svfloat32_t acc2 = svdup_n_f32(0.0f);
+    svfloat32_t acc3 = svdup_n_f32(0.0f);
+
+    for (size_t k_blk_idx = 0; k_blk_idx < BlockCountK; ++k_blk_idx) {
+        const int8_t* QuantADataPtr = Q8BlkData(QuantAPtr);
+
+        int8_t bzp[NumCols];
+        for (size_t i = 0; i < NumCols; ++i) {
+            bzp[i] = LoadZeroPoint<HasZeroPoint>(QuantBZeroPointColPtr + i * StrideQuantBZeroPoint, k_blk_idx);
+        }
+
+        svint32_t dot0 = svdup_n_s32(0);
+        svint32_t dot1 = svdup_n_s32(0);
+        svint32_t dot2 = svdup_n_s32(0);
+        svint32_t dot3 = svdup_n_s32(0);
+
+        if (BlkLen <= VectorLength) {
+            const svbool_t HalfBlkPred = svwhilelt_b8(uint64_t{0}, uint64_t{BlkDataSize});
+            const svint8_t av = svld1_s8(svwhilelt_b8(uint64_t{0}, uint64_t{BlkLen}), QuantADataPtr);
+
+            dot0 = svdot_s32(dot0, av, LoadBBlk(HalfBlkPred, QuantBDataPtr, bzp[0]));
+            if constexpr (NumCols == 4) {
+                dot1 = svdot_s32(dot1, av, LoadBBlk(HalfBlkPred, QuantBDataPtr + StrideQuantBData, bzp[1]));
+                dot2 = svdot_s32(dot2, av, LoadBBlk(HalfBlkPred, QuantBDataPtr + 2 * StrideQuantBData, bzp[2]));
+                dot3 = svdot_s32(dot3, av, LoadBBlk(HalfBlkPred, QuantBDataPtr + 3 * StrideQuantBData, bzp[3]));
+            }
+        } else {
+            for (size_t i = 0; i < BlkDataSize; i += VectorLength) {
+                const svbool_t Pred = svwhilelt_b8(uint64_t{i}, uint64_t{BlkDataSize});
+                const svint8_t av_lo = svld1_s8(Pred, QuantADataPtr + i);
+                const svint8_t av_hi = svld1_s8(Pred, QuantADataPtr + BlkDataSize + i);
+
+                svint8_t bv_lo, bv_hi;
+                LoadBBlkChunk(Pred, QuantBDataPtr + i, bzp[0], bv_lo, bv_hi);
+                dot0 = svdot_s32(svdot_s32(dot0, av_lo, bv_lo), av_hi, bv_hi);
+                if constexpr (NumCols == 4) {
+                    LoadBBlkChunk(Pred, QuantBDataPtr + StrideQuantBData + i, bzp[1], bv_lo, bv_hi);
+                    dot1 = svdot_s32(svdot_s32(dot1, av_lo, bv_lo), av_hi, bv_hi);
+                    LoadBBlkChunk(Pred, QuantBDataPtr + 2 * StrideQuantBData + i, bzp[2], bv_lo, bv_hi);
+                    dot2 = svdot_s32(svdot_s32(dot2, av_lo, bv_lo), av_hi, bv_hi);
+                    LoadBBlkChunk(Pred, QuantBDataPtr + 3 * StrideQuantBData + i, bzp[3], bv_lo, bv_hi);
+                    dot3 = svdot_s32(svdot_s32(dot3, av_lo, bv_lo), av_hi, bv_hi);
+                }
+            }
+        }
+
+        // multiply by the combined scale and update the accumulators
+        const float a_scale = Q8BlkScale(QuantAPtr);
+        acc0 = svmla_n_f32_x(all, acc0, svcvt_f32_s32_x(all, dot0), a_scale * QuantBScaleColPtr[k_blk_idx]);
+        if constexpr (NumCols == 4) {
+            acc1 = svmla_n_f32_x(
+                all, acc1, svcvt_f32_s32_x(all, dot1), a_scale * QuantBScaleColPtr[StrideQuantBScale + k_blk_idx]
+            );
+            acc2 = svmla_n_f32_x(
+                all, acc2, svcvt_f32_s32_x(all, dot2), a_scale * QuantBScaleColPtr[2 * StrideQuantBScale + k_blk_idx]
+            );
+            acc3 = svmla_n_f32_x(
+                all, acc3, svcvt_f32_s32_x(all, dot3), a_scale * QuantBScaleColPtr[3 * StrideQuantBScale + k_blk_idx]
+            );
+        }
+
+        QuantAPtr += Q8BlkSize(BlkLen);
+        QuantBDataPtr += BlkDataSize;
+    }
+
+    SumPtr[0] = svaddv_f32(all, acc0);
+    if constexpr (NumCols == 4) {
+        SumPtr[1] = svaddv_f32(all, acc1);
+        SumPtr[2] = svaddv_f32(all, acc2);
+        SumPtr[3] = svaddv_f32(all, acc3);
+    }
+
+    if (BiasPtr != nullptr) {
+        for (size_t i = 0; i < NumCols; ++i) {
+            SumPtr[i] += BiasPtr[i];
+        }
+    }
+}
+
+template <bool HasZeroPoint>
+void
+SQ4BitGemmKernel_CompInt8_Impl(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    const size_t StrideQuantA = BlockCountK * Q8BlkSize(BlkLen);
+
+    const size_t StrideQuantBData = BlockCountK * MlasQNBitBlkDataSizeInBytes(BlkBitWidth, BlkLen);
+    const size_t StrideQuantBScale = BlockCountK;
+    const size_t StrideQuantBZeroPoint = MlasQNBitZeroPointsForBlksSizeInBytes<BlkBitWidth>(BlockCountK);
+
+    for (size_t m = 0; m < CountM; ++m) {
+        const std::byte* QuantARowPtr = QuantA + m * StrideQuantA;
+        float* SumRowPtr = C + m * ldc;
+
+        size_t n = 0;
+        for (; n + 4 <= CountN; n += 4) {
+            SQ4BitGemm_CompInt8_Compute1xNumCols<4, HasZeroPoint>(
+                BlkLen,
+                QuantARowPtr,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * StrideQuantBScale,
+                HasZeroPoint ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr,
+                Bias != nullptr ? Bias + n : nullptr,
+                SumRowPtr + n,
+                BlockCountK,
+                StrideQuantBData,
+                StrideQuantBScale,
+                StrideQuantBZeroPoint
+            );
+        }
+
+        for (; n < CountN; ++n) {
+            SQ4BitGemm_CompInt8_Compute1xNumCols<1, HasZeroPoint>(
+                BlkLen,
+                QuantARowPtr,
+                QuantBData + n * StrideQuantBData,
+                QuantBScale + n * StrideQuantBScale,
+                HasZeroPoint ? QuantBZeroPoint + n * StrideQuantBZeroPoint : nullptr,
+                Bias != nullptr ? Bias + n : nullptr,
+                SumRowPtr + n,
+                BlockCountK,
+                StrideQuantBData,
+                StrideQuantBScale,
+                StrideQuantBZeroPoint
+            );
+        }
+    }
+}
+
+size_t
+SQ4BitGemmKernel_CompInt8(
+    size_t BlkLen,
+    const std::byte* QuantA,
+    const std::byte* QuantBData,
+    const float* QuantBScale,
+    const std::byte* QuantBZeroPoint,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t /*CountK*/,
+    size_t BlockCountK,
+    size_t ldc,
+    const float* Bias
+)
+{
+    if (QuantBZeroPoint != nullptr) {
+        SQ4BitGemmKernel_CompInt8_Impl<true>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    } else {
+        SQ4BitGemmKernel_CompInt8_Impl<false>(
+            BlkLen, QuantA, QuantBData, QuantBScale, QuantBZeroPoint, C, CountM, CountN, BlockCountK, ldc, Bias
+        );
+    }
+
+    return CountM;
+}
+
+}  // namespace
+
+}  // namespace sqnbitgemm_sve
+
+//
+// Kernel dispatch structure definition.
+//
+
+const MLAS_SQNBIT_GEMM_DISPATCH MlasSQNBitGemmDispatchSve = []() {
+    MLAS_SQNBIT_GEMM_DISPATCH d;
+
+    d.SQ4BitGemmPackQuantBDataSize = sqnbitgemm_sve::SQ4BitGemmPackQuantBDataSize;
+    d.SQ4BitGemmPackQuantBData = sqnbitgemm_sve::SQ4BitGemmPackQuantBData;
+
+    d.SQ4BitGemmPerGemmWorkspaceSize = sqnbitgemm_sve::SQ4BitGemmPerGemmWorkspaceSize;
+    d.SQ4BitGemmPerGemmWorkspaceAlignment = sqnbitgemm_sve::SQ4BitGemmPerGemmWorkspaceAlignment;
+
+    d.SQ4BitGemmM1Kernel_CompFp32 = sqnbitgemm_neon::SQ4BitGemmM1Kernel_CompFp32;
+    d.Q4BitBlkDequantBForSgemm_CompFp32 = sqnbitgemm_neon::Q4BitBlkDequantBForSgemm_CompFp32;
+
+    d.SQ4BitGemmKernel_CompInt8 = sqnbitgemm_sve::SQ4BitGemmKernel_CompInt8;
+    d.QuantizeARow_CompInt8 = sqnbitgemm_neon::QuantizeARow_CompInt8;
+
+    return d;
+}();
@@ -0,0 +1,195 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/activation_smoothing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+
+#include "nlohmann/json.hpp"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using json = nlohmann::json;
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr const char* kSmoothedSuffix = "_smoothed";
+
+// smoothing factors are kept in a sane range so that tiny maxima cannot blow up the weights
+constexpr float kMinSmoothingFactor = 1e-5f;
+constexpr float kMaxSmoothingFactor = 1e5f;
+
+bool IsSmoothed(const NodeArg& arg) {
+  return arg.Name().find(kSmoothedSuffix) != std::string::npos;
+}
+
+const ONNX_NAMESPACE::TensorProto* GetFloatInitializer(const Graph& graph, const NodeArg& arg, size_t rank) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  return tensor_proto != nullptr && tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_FLOAT &&
+                 static_cast<size_t>(tensor_proto->dims_size()) == rank
+             ? tensor_proto
+             : nullptr;
+}
+
+bool IsLayerNorm(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "LayerNormalization", {1, 17}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "SimplifiedLayerNormalization", {1});
+}
+
+// Normalizes over the last axis only, so that gamma and beta have one value per channel of the output.
+bool NormalizesLastAxis(const Node& node) {
+  const auto* axis_attr = graph_utils::GetNodeAttribute(node, "axis");
+  if (axis_attr == nullptr || axis_attr->i() == -1) {
+    return true;
+  }
+  const auto* input_shape = node.InputDefs()[0]->Shape();
+  return input_shape != nullptr && axis_attr->i() == input_shape->dim_size() - 1;
+}
+
+NodeArg& AddSmoothedInitializer(Graph& graph, const ONNX_NAMESPACE::TensorProto& src_proto,
+                                const std::function<void(gsl::span<float>)>& update) {
+  Initializer initializer(src_proto, graph.ModelPath());
+  update(gsl::make_span(initializer.data<float>(), initializer.size()));
+  ONNX_NAMESPACE::TensorProto dst_proto;
+  initializer.ToProto(dst_proto);
+  dst_proto.set_name(graph.GenerateNodeArgName(src_proto.name() + kSmoothedSuffix));
+  return graph_utils::AddInitializer(graph, dst_proto);
+}
+
+}  // namespace
+
+Status ActivationSmoothing::LoadActivationAbsMax(const std::string& file_path,
+                                                 InlinedHashMap<std::string, std::vector<float>>& activation_abs_max) {
+  std::ifstream stream(file_path);
+  ORT_RETURN_IF_NOT(stream.is_open(), "Failed to open the activation scales ", file_path);
+
+  Status status;
+  ORT_TRY {
+    const json scales = json::parse(stream);
+    ORT_RETURN_IF_NOT(scales.is_object(), "The activation scales ", file_path,
+                      " must be a JSON object of arrays by tensor name");
+    for (const auto& [name, values] : scales.items()) {
+      activation_abs_max[name] = values.get<std::vector<float>>();
+    }
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to parse the activation scales ", file_path,
+                               ": ", ex.what());
+    });
+  }
+  return status;
+}
+
+Status ActivationSmoothing::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                      const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr)
+      continue;  // node was removed
+
+    Node& norm_node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(norm_node, modified, graph_level, logger));
+
+    if (!IsLayerNorm(norm_node) || !graph_utils::IsSupportedProvider(norm_node, GetCompatibleExecutionProviders()) ||
+        !NormalizesLastAxis(norm_node) || graph.NodeProducesGraphOutput(norm_node)) {
+      continue;
+    }
+
+    auto& norm_inputs = norm_node.MutableInputDefs();
+    const auto abs_max_it = activation_abs_max_.find(norm_node.OutputDefs()[0]->Name());
+    if (abs_max_it == activation_abs_max_.end() || norm_inputs.size() < 2 || IsSmoothed(*norm_inputs[1])) {
+      continue;
+    }
+
+    const auto& activation_abs_max = abs_max_it->second;
+    const size_t num_channels = activation_abs_max.size();
+    const auto* gamma = GetFloatInitializer(graph, *norm_inputs[1], 1);
+    const bool has_beta = norm_inputs.size() > 2 && norm_inputs[2]->Exists();
+    const auto* beta = has_beta ? GetFloatInitializer(graph, *norm_inputs[2], 1) : nullptr;
+    if (gamma == nullptr || static_cast<size_t>(gamma->dims(0)) != num_channels ||
+        (has_beta && (beta == nullptr || static_cast<size_t>(beta->dims(0)) != num_channels))) {
+      continue;
+    }
+
+    // every consumer must be able to absorb the smoothing factors in its weights
+    InlinedVector<Node*> matmul_nodes;
+    bool all_consumers_supported = norm_node.GetOutputEdgesCount() > 0;
+    for (auto it = norm_node.OutputEdgesBegin(), end = norm_node.OutputEdgesEnd(); it != end; ++it) {
+      const Node& consumer = it->GetNode();
+      const auto* weights = consumer.InputDefs().size() == 2 ? GetFloatInitializer(graph, *consumer.InputDefs()[1], 2)
+                                                             : nullptr;
+      if (it->GetSrcArgIndex() != 0 || it->GetDstArgIndex() != 0 ||
+          !graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "MatMul", {1, 9, 13}) ||
+          consumer.GetExecutionProviderType() != norm_node.GetExecutionProviderType() ||
+          weights == nullptr || static_cast<size_t>(weights->dims(0)) != num_channels) {
+        all_consumers_supported = false;
+        break;
+      }
+      matmul_nodes.push_back(graph.GetNode(consumer.Index()));
+    }
+    if (!all_consumers_supported) {
+      continue;
+    }
+
+    // max |W_j| over the weights of all the consumers
+    std::vector<float> weight_abs_max(num_channels, 0.0f);
+    for (const Node* matmul_node : matmul_nodes) {
+      Initializer weights(*GetFloatInitializer(graph, *matmul_node->InputDefs()[1], 2), graph.ModelPath());
+      const auto values = weights.DataAsSpan<float>();
+      const size_t num_columns = values.size() / num_channels;
+      for (size_t j = 0; j < num_channels; ++j) {
+        for (size_t n = 0; n < num_columns; ++n) {
+          weight_abs_max[j] = std::max(weight_abs_max[j], std::abs(values[j * num_columns + n]));
+        }
+      }
+    }
+
+    std::vector<float> factors(num_channels, 1.0f);
+    for (size_t j = 0; j < num_channels; ++j) {
+      if (activation_abs_max[j] > 0.0f && weight_abs_max[j] > 0.0f) {
+        const float factor = std::pow(activation_abs_max[j], alpha_) / std::pow(weight_abs_max[j], 1.0f - alpha_);
+        factors[j] = std::clamp(factor, kMinSmoothingFactor, kMaxSmoothingFactor);
+      }
+    }
+
+    const auto divide_channels = [&factors](gsl::span<float> values) {
+      for (size_t j = 0; j < values.size(); ++j) {
+        values[j] /= factors[j];
+      }
+    };
+    norm_inputs[1] = &AddSmoothedInitializer(graph, *gamma, divide_channels);
+    if (has_beta) {
+      norm_inputs[2] = &AddSmoothedInitializer(graph, *beta, divide_channels);
+    }
+
+    const auto multiply_rows = [&factors](gsl::span<float> values) {
+      const size_t num_columns = values.size() / factors.size();
+      for (size_t j = 0; j < factors.size(); ++j) {
+        for (size_t n = 0; n < num_columns; ++n) {
+          values[j * num_columns + n] *= factors[j];
+        }
+      }
+    };
+    for (Node* matmul_node : matmul_nodes) {
+      auto& matmul_inputs = matmul_node->MutableInputDefs();
+      matmul_inputs[1] = &AddSmoothedInitializer(graph, *GetFloatInitializer(graph, *matmul_inputs[1], 2),
+                                                 multiply_rows);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief SmoothQuant-style migration of activation outliers from the output of a layer normalization to the weights
+ * of the MatMul nodes consuming it.
+ *
+ * Given the per-channel maximum absolute values of the output X of a LayerNormalization or
+ * SimplifiedLayerNormalization, channel j is divided by s_j = max|X_j|^alpha / max|W_j|^(1 - alpha), where W_j is
+ * row j of the MatMul weights, by dividing the gamma and beta of the normalization by s. Row j of the weights is
+ * multiplied by s_j so the MatMul outputs do not change, while the activations no longer have outlier channels that
+ * make them hard to quantize per tensor or per token.
+ *
+ * A normalization is smoothed if all its consumers are MatMul nodes taking it as A with a constant 2D float B. The new
+ * gamma, beta and weights are renamed with a "_smoothed" suffix, which also keeps them from being smoothed again.
+ */
+class ActivationSmoothing : public GraphTransformer {
+ public:
+  // activation_abs_max has the per-channel max absolute values by the name of the normalization output.
+  ActivationSmoothing(InlinedHashMap<std::string, std::vector<float>> activation_abs_max, float alpha,
+                      const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ActivationSmoothing", compatible_execution_providers),
+        activation_abs_max_(std::move(activation_abs_max)),
+        alpha_(alpha) {}
+
+  // Loads the activation max absolute values from a JSON object of arrays of floats by tensor name,
+  // e.g. {"layer_norm_output": [0.5, 12.0, ...]}.
+  static Status LoadActivationAbsMax(const std::string& file_path,
+                                     InlinedHashMap<std::string, std::vector<float>>& activation_abs_max);
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const InlinedHashMap<std::string, std::vector<float>> activation_abs_max_;
+  const float alpha_;
+};
+
+}  // namespace onnxruntime
@@ -2,8 +2,13 @@
 // Licensed under the MIT License.
 
 #include <limits>
+#include <optional>
+#include <string_view>
 
+#include "core/common/parse_string.h"
+#include "core/common/safeint.h"
 #include "core/optimizer/constant_folding.h"
+#include "core/optimizer/constant_sharing.h"
 #include "core/optimizer/initializer.h"
 #include "core/optimizer/utils.h"
 #include "core/graph/graph_utils.h"
@@ -11,6 +16,7 @@
 #include "core/optimizer/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 using namespace onnxruntime::common;
 
@@ -131,7 +137,100 @@ static Status ConstantFoldIfNode(Graph& graph, Node& if_node, const logging::Log
   return status;
 }
 
+// Returns the total size in bytes of the outputs of a node, or nullopt if the type or shape of an output isn't known.
+static std::optional<size_t> GetOutputsSizeInBytes(const Node& node) {
+  SafeInt<size_t> size = 0;
+  for (const auto* output_def : node.OutputDefs()) {
+    const auto* type = output_def->TypeAsProto();
+    const auto* shape = output_def->Shape();
+    if (type == nullptr || !utils::HasTensorType(*type) || !utils::HasElemType(type->tensor_type()) ||
+        shape == nullptr) {
+      return std::nullopt;
+    }
+
+    SafeInt<size_t> output_size =
+        DataTypeImpl::TensorTypeFromONNXEnum(type->tensor_type().elem_type())->GetElementType()->Size();
+    for (const auto& dim : shape->dim()) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+        return std::nullopt;
+      }
+      output_size *= dim.dim_value();
+    }
+
+    size += output_size;
+  }
+
+  return static_cast<size_t>(size);
+}
+
+// Returns the total size in bytes of the constant inputs of a node.
+static size_t GetConstantInputsSizeInBytes(const InitializedTensorSet& constant_inputs) {
+  SafeInt<size_t> size = 0;
+  for (const auto& entry : constant_inputs) {
+    size_t input_size = 0;
+    if (utils::GetSizeInBytesFromTensorProto<0>(*entry.second, &input_size).IsOK()) {
+      size += input_size;
+    }
+  }
+
+  return static_cast<size_t>(size);
+}
+
+// Replaces identical folded results with a single initializer. Results with the same data type, shape and hash of
+// their data are compared, and the later ones are replaced by the first one.
+static bool ShareFoldedInitializers(Graph& graph, gsl::span<const std::string> folded_initializers,
+                                    const InlinedHashSet<std::string>& excluded_initializers) {
+  bool shared = false;
+  InlinedHashMap<std::string, InlinedVector<NodeArg*>> candidates;
+  for (const auto& name : folded_initializers) {
+    const auto* tensor_proto = graph.GetConstantInitializer(name, false);
+    NodeArg* node_arg = graph.GetNodeArg(name);
+    if (tensor_proto == nullptr || node_arg == nullptr || graph.IsOutput(node_arg) ||
+        excluded_initializers.find(name) != excluded_initializers.end() ||
+        graph.GetConsumerNodes(name).empty()) {
+      continue;
+    }
+
+    std::string key;
+    {
+      Initializer initializer{*tensor_proto, graph.ModelPath()};
+      const auto data = initializer.DataAsByteSpan();
+      key = MakeString(initializer.data_type(), "_", TensorShape(initializer.dims()), "_",
+                       std::hash<std::string_view>{}(
+                           std::string_view(reinterpret_cast<const char*>(data.data()), data.size())));
+    }
+
+    auto& same_key = candidates[key];
+    NodeArg* shared_node_arg = nullptr;
+    if (!same_key.empty()) {
+      Initializer initializer{*tensor_proto, graph.ModelPath()};
+      for (NodeArg* candidate : same_key) {
+        Initializer candidate_initializer{*graph.GetConstantInitializer(candidate->Name(), false), graph.ModelPath()};
+        if (SpanEq(initializer.DataAsByteSpan(), candidate_initializer.DataAsByteSpan())) {
+          shared_node_arg = candidate;
+          break;
+        }
+      }
+    }
+
+    if (shared_node_arg != nullptr && ConstantSharing::ShareInitializer(graph, *node_arg, *shared_node_arg)) {
+      shared = true;
+    } else {
+      same_key.push_back(node_arg);
+    }
+  }
+
+  return shared;
+}
+
 Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  size_t max_output_size_in_bytes = 0;
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      config_options_.GetConfigOrDefault(kOrtSessionOptionsConstantFoldingMaxOutputSizeInBytes, "0"),
+      max_output_size_in_bytes));
+
+  // the names of the initializers created for the outputs of folded nodes
+  InlinedVector<std::string> folded_initializers;
   bool have_updated_nodes = false;
   GraphViewer graph_viewer(graph);
   auto& order = graph_viewer.GetNodesInTopologicalOrder();
@@ -224,6 +323,24 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         }
       }
 
+      // Folding a node whose outputs are larger than the size budget and than its inputs would grow the
+      // initializers. Skip it before computing it if the sizes of the outputs are known.
+      const size_t input_size_in_bytes =
+          max_output_size_in_bytes > 0 ? GetConstantInputsSizeInBytes(constant_inputs) : 0;
+      const auto exceeds_size_budget = [&](size_t output_size_in_bytes) {
+        return max_output_size_in_bytes > 0 && output_size_in_bytes > max_output_size_in_bytes &&
+               output_size_in_bytes > input_size_in_bytes;
+      };
+
+      if (max_output_size_in_bytes > 0) {
+        const auto output_size_in_bytes = GetOutputsSizeInBytes(*node);
+        if (output_size_in_bytes.has_value() && exceeds_size_budget(*output_size_in_bytes)) {
+          LOGS(logger, INFO) << "Outputs of " << node->OpType() << " node '" << node->Name()
+                             << "' exceed the constant folding size budget. Not constant folding.";
+          continue;
+        }
+      }
+
 #if !defined(DISABLE_SPARSE_TENSORS)
       // Create execution frame for executing constant nodes.
       OptimizerExecutionFrame::Info info({node}, constant_inputs, graph.ModelPath(), execution_provider_,
@@ -301,6 +418,19 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
         }
       }
 
+      if (converted_to_constant && max_output_size_in_bytes > 0) {
+        SafeInt<size_t> output_size_in_bytes = 0;
+        for (const auto& fetch : fetches) {
+          output_size_in_bytes += fetch.Get<Tensor>().SizeInBytes();
+        }
+
+        if (exceeds_size_budget(static_cast<size_t>(output_size_in_bytes))) {
+          LOGS(logger, INFO) << "Outputs of " << node->OpType() << " node '" << node->Name()
+                             << "' exceed the constant folding size budget. Not constant folding.";
+          converted_to_constant = false;
+        }
+      }
+
       if (converted_to_constant) {
         for (size_t fetch_idx = 0; fetch_idx < fetches.size(); ++fetch_idx) {
           OrtValue& ort_value = fetches[fetch_idx];
@@ -316,6 +446,7 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
 
           constant_arg_out->SetShape(result_shape);
           graph.AddInitializedTensor(out_tensorproto);
+          folded_initializers.push_back(constant_arg_out->Name());
         }
       }
     }
@@ -340,6 +471,11 @@ Status ConstantFolding::ApplyImpl(Graph& graph, bool& modified, int graph_level,
     }
   }
 
+  // Different subexpressions can fold to the same value, e.g. the same operators applied to copies of a weight.
+  if (ShareFoldedInitializers(graph, folded_initializers, excluded_initializers_)) {
+    modified = true;
+  }
+
   return Status::OK();
 }
 }  // namespace onnxruntime
@@ -173,6 +173,20 @@ size_t GetOrAddValueInConstantStore(
 
 }  // namespace
 
+bool ConstantSharing::ShareInitializer(Graph& graph, const NodeArg& origin_initializer_node_arg,
+                                       NodeArg& shared_initializer_node_arg) {
+  InlinedHashMap<const Node*, InlinedVector<int>> consumer_node_to_input_ports_map;
+  bool found_subgraph_usage = PrepareInputPortsToReplace(graph, &origin_initializer_node_arg,
+                                                         consumer_node_to_input_ports_map);
+  if (found_subgraph_usage) {
+    return false;
+  }
+
+  ReplaceInputsToUseSharedInitializer(graph, consumer_node_to_input_ports_map, &origin_initializer_node_arg,
+                                      &shared_initializer_node_arg);
+  return true;
+}
+
 Status ConstantSharing::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
                                   const logging::Logger& logger) const {
   int shared_count = 0;
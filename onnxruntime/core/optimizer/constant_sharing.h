@@ -40,6 +40,16 @@ class ConstantSharing : public GraphTransformer {
 
   static constexpr int64_t TENSOR_ELEM_COUNT_THRESHOLD = 8;
 
+  /**
+   * Replace the uses of an initializer with another initializer of the same value, and remove the initializer if
+   * it's no longer used. It's left unchanged if it's used by a subgraph.
+   * @param origin_initializer_node_arg the initializer to replace.
+   * @param shared_initializer_node_arg the initializer to use instead.
+   * @return true if the initializer was replaced.
+   */
+  static bool ShareInitializer(Graph& graph, const NodeArg& origin_initializer_node_arg,
+                               NodeArg& shared_initializer_node_arg);
+
  private:
   Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
 
@@ -0,0 +1,284 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/elementwise_chain_fusion.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+// the maximum number of operators in a fused chain
+constexpr size_t kMaxChainLength = 16;
+
+// The operators supported by the FusedElementwise CPU kernel.
+bool IsSupportedElementwiseOp(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Abs", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Erf", {9, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Exp", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Neg", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reciprocal", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Relu", {6, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sigmoid", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sqrt", {6, 13}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Tanh", {6, 13});
+}
+
+bool IsFloatTensor(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         type->tensor_type().elem_type() == TensorProto_DataType_FLOAT;
+}
+
+bool CanFuse(const Node& node, const InlinedHashSet<std::string_view>& compatible_providers) {
+  if (!IsSupportedElementwiseOp(node) || !graph_utils::IsSupportedProvider(node, compatible_providers)) {
+    return false;
+  }
+
+  const auto is_float_tensor = [](const NodeArg* node_arg) { return IsFloatTensor(*node_arg); };
+  return std::all_of(node.InputDefs().begin(), node.InputDefs().end(), is_float_tensor) &&
+         std::all_of(node.OutputDefs().begin(), node.OutputDefs().end(), is_float_tensor);
+}
+
+// Whether node_arg has the given shape, whose dimensions must all be known. Symbolic dimensions match if they have
+// the same name.
+bool HasShape(const NodeArg& node_arg, const TensorShapeProto& shape) {
+  const auto* node_arg_shape = node_arg.Shape();
+  if (node_arg_shape == nullptr || node_arg_shape->dim_size() != shape.dim_size()) {
+    return false;
+  }
+
+  for (int i = 0; i < shape.dim_size(); ++i) {
+    const auto& dim = node_arg_shape->dim(i);
+    const auto& expected_dim = shape.dim(i);
+    if (utils::HasDimValue(expected_dim)) {
+      if (!utils::HasDimValue(dim) || dim.dim_value() != expected_dim.dim_value()) {
+        return false;
+      }
+    } else if (utils::HasDimParam(expected_dim)) {
+      if (!utils::HasDimParam(dim) || dim.dim_param() != expected_dim.dim_param()) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Whether the chain can be fused: all values have the shape of the output, apart from inputs with a single element,
+// and the values other than the output are only consumed within the chain.
+bool CanFuseChain(const Graph& graph, gsl::span<Node* const> chain) {
+  const TensorShapeProto* shape = chain.back()->OutputDefs()[0]->Shape();
+  if (shape == nullptr) {
+    return false;
+  }
+
+  InlinedHashSet<NodeIndex> chain_nodes;
+  InlinedHashSet<const NodeArg*> chain_values;
+  for (const Node* node : chain) {
+    chain_nodes.insert(node->Index());
+    chain_values.insert(node->OutputDefs()[0]);
+  }
+
+  for (size_t i = 0; i < chain.size(); ++i) {
+    const Node& node = *chain[i];
+    if (!HasShape(*node.OutputDefs()[0], *shape)) {
+      return false;
+    }
+
+    for (const NodeArg* input : node.InputDefs()) {
+      if (chain_values.count(input) == 0 && !HasShape(*input, *shape) && !optimizer_utils::IsScalar(*input)) {
+        return false;
+      }
+    }
+
+    // a value without consumers in the chain could be consumed by a node that one of the inputs depends on
+    if (i + 1 < chain.size()) {
+      if (graph.NodeProducesGraphOutput(node) || node.GetOutputEdgesCount() == 0) {
+        return false;
+      }
+
+      for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+        if (chain_nodes.count(it->Index()) == 0) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+}  // namespace
+
+Status ElementwiseChainFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashMap<NodeIndex, size_t> topological_positions;
+  topological_positions.reserve(node_topology_list.size());
+  for (size_t i = 0; i < node_topology_list.size(); ++i) {
+    topological_positions[node_topology_list[i]] = i;
+  }
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (!p_node) continue;
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!CanFuse(node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    // Grow the chain with the fusable consumers of its values in topological order, so each operator only reads the
+    // inputs of the chain and the values of the operators before it.
+    InlinedVector<Node*> chain{&node};
+    InlinedHashSet<NodeIndex> chain_nodes{node.Index()};
+    while (chain.size() < kMaxChainLength) {
+      Node* next = nullptr;
+      size_t next_position = 0;
+      for (const Node* chain_node : chain) {
+        for (auto it = chain_node->OutputNodesBegin(), end = chain_node->OutputNodesEnd(); it != end; ++it) {
+          const auto position = topological_positions.find(it->Index());
+          // nodes added by earlier fusions are not in the topological order, and can't be fused
+          if (position == topological_positions.end() || chain_nodes.count(it->Index()) > 0 ||
+              (next != nullptr && position->second >= next_position)) {
+            continue;
+          }
+
+          Node* consumer = graph.GetNode(it->Index());
+          if (CanFuse(*consumer, GetCompatibleExecutionProviders())) {
+            next = consumer;
+            next_position = position->second;
+          }
+        }
+      }
+
+      if (next == nullptr) {
+        break;
+      }
+
+      chain.push_back(next);
+      chain_nodes.insert(next->Index());
+    }
+
+    // use the longest fusable part of the chain. fusing a single operator has no benefit.
+    size_t chain_length = chain.size();
+    while (chain_length >= 2 && !CanFuseChain(graph, gsl::make_span(chain.data(), chain_length))) {
+      --chain_length;
+    }
+
+    if (chain_length < 2) {
+      continue;
+    }
+
+    chain.resize(chain_length);
+    chain_nodes.clear();
+    InlinedHashSet<const NodeArg*> chain_values;
+    for (const Node* chain_node : chain) {
+      chain_nodes.insert(chain_node->Index());
+      chain_values.insert(chain_node->OutputDefs()[0]);
+    }
+
+    Node& last_node = *chain.back();
+    NodeArg* output = last_node.MutableOutputDefs()[0];
+
+    // the inputs of the fused node are the values consumed by the chain which it doesn't compute. the first one must
+    // have the shape of the output.
+    InlinedVector<NodeArg*> inputs;
+    for (Node* chain_node : chain) {
+      for (NodeArg* input : chain_node->MutableInputDefs()) {
+        if (chain_values.count(input) == 0 && std::find(inputs.begin(), inputs.end(), input) == inputs.end()) {
+          inputs.push_back(input);
+        }
+      }
+    }
+
+    auto full_input = std::find_if(inputs.begin(), inputs.end(),
+                                   [output](const NodeArg* input) { return HasShape(*input, *output->Shape()); });
+    if (full_input == inputs.end()) {
+      continue;
+    }
+    std::iter_swap(inputs.begin(), full_input);
+
+    // number the values as described in the FusedElementwise schema
+    InlinedHashMap<const NodeArg*, int64_t> value_indices;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      value_indices[inputs[i]] = static_cast<int64_t>(i);
+    }
+
+    std::vector<std::string> op_types;
+    std::vector<int64_t> op_inputs;
+    for (size_t i = 0; i < chain.size(); ++i) {
+      const Node& chain_node = *chain[i];
+      const auto& input_defs = chain_node.InputDefs();
+      op_types.push_back(chain_node.OpType());
+      op_inputs.push_back(value_indices[input_defs[0]]);
+      op_inputs.push_back(input_defs.size() > 1 ? value_indices[input_defs[1]] : -1);
+      value_indices[chain_node.OutputDefs()[0]] = static_cast<int64_t>(inputs.size() + i);
+    }
+
+    // the edges from the producers of the inputs, with the destination index in the fused node
+    std::vector<graph_utils::GraphEdge> input_edges;
+    for (const Node* chain_node : chain) {
+      for (const auto& edge : graph_utils::GraphEdge::GetNodeInputEdges(*chain_node)) {
+        if (chain_nodes.count(edge.src_node) > 0) {
+          continue;
+        }
+
+        const auto input_index = static_cast<int>(
+            std::find_if(inputs.begin(), inputs.end(),
+                         [&edge](const NodeArg* input) { return input->Name() == edge.arg_name; }) -
+            inputs.begin());
+        if (std::none_of(input_edges.begin(), input_edges.end(),
+                         [input_index](const graph_utils::GraphEdge& e) { return e.dst_arg_index == input_index; })) {
+          input_edges.emplace_back(edge.src_node, edge.dst_node, edge.src_arg_index, input_index, edge.arg_name);
+        }
+      }
+    }
+
+    const auto output_edges = graph_utils::GraphEdge::GetNodeOutputEdges(last_node);
+
+    Node& fused_node = graph.AddNode(graph.GenerateNodeName(last_node.Name() + "/ElementwiseChainFusion/"),
+                                     "FusedElementwise", "Fused chain of elementwise operators", inputs,
+                                     std::array{output}, nullptr, kMSDomain);
+    fused_node.AddAttribute("ops", op_types);
+    fused_node.AddAttribute("op_inputs", op_inputs);
+    fused_node.SetExecutionProviderType(last_node.GetExecutionProviderType());
+
+    for (Node* chain_node : chain) {
+      graph_utils::RemoveNodeOutputEdges(graph, *chain_node);
+      graph.RemoveNode(chain_node->Index());
+    }
+
+    for (const auto& edge : input_edges) {
+      graph.AddEdge(edge.src_node, fused_node.Index(), edge.src_arg_index, edge.dst_arg_index);
+    }
+
+    for (const auto& edge : output_edges) {
+      graph.AddEdge(fused_node.Index(), edge.dst_node, 0, edge.dst_arg_index);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuse chains of float elementwise operators, e.g. Add->Mul->Sigmoid->Mul, into a FusedElementwise node
+ * that computes the chain in a single pass over the data.
+ *
+ * The values in a chain must all have the same shape, apart from inputs with a single element. The intermediate
+ * values must only be consumed within the chain.
+ */
+class ElementwiseChainFusion : public GraphTransformer {
+ public:
+  ElementwiseChainFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("ElementwiseChainFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
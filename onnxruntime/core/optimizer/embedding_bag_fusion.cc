@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/embedding_bag_fusion.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace ::onnxruntime::common;
+namespace onnxruntime {
+
+namespace {
+
+// Returns the mode of EmbeddingBag for a ReduceSum or ReduceMean over axis 1 of the 3D gathered rows, which removes
+// the axis, or nullptr otherwise.
+const char* GetEmbeddingBagMode(const Graph& graph, const Node& reduce_node) {
+  const char* mode = nullptr;
+  bool axes_from_input = false;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceSum", {1, 11})) {
+    mode = "sum";
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceSum", {13})) {
+    mode = "sum";
+    axes_from_input = true;
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceMean", {1, 11, 13})) {
+    mode = "mean";
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(reduce_node, "ReduceMean", {18})) {
+    mode = "mean";
+    axes_from_input = true;
+  } else {
+    return nullptr;
+  }
+
+  const auto& attributes = reduce_node.GetAttributes();
+  const auto keepdims = attributes.find("keepdims");
+  if (keepdims == attributes.end() || keepdims->second.i() != 0) {
+    return nullptr;
+  }
+
+  InlinedVector<int64_t> axes;
+  if (axes_from_input) {
+    const auto& input_defs = reduce_node.InputDefs();
+    if (input_defs.size() < 2 || !input_defs[1]->Exists() ||
+        !optimizer_utils::AppendTensorFromInitializer(graph, *input_defs[1], axes, true)) {
+      return nullptr;
+    }
+  } else {
+    const auto axes_attr = attributes.find("axes");
+    if (axes_attr == attributes.end()) {
+      return nullptr;
+    }
+    axes.assign(axes_attr->second.ints().begin(), axes_attr->second.ints().end());
+  }
+
+  return axes.size() == 1 && (axes[0] == 1 || axes[0] == -2) ? mode : nullptr;
+}
+
+}  // namespace
+
+Status EmbeddingBagFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                     const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (!node_ptr)
+      continue;  // node was removed
+
+    auto& gather_node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(gather_node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(gather_node, "Gather", {1, 11, 13}) ||
+        !graph_utils::IsSupportedProvider(gather_node, GetCompatibleExecutionProviders()) ||
+        gather_node.GetOutputEdgesCount() != 1 || graph.NodeProducesGraphOutput(gather_node)) {
+      continue;
+    }
+
+    const auto& gather_attributes = gather_node.GetAttributes();
+    const auto axis = gather_attributes.find("axis");
+    if (axis != gather_attributes.end() && axis->second.i() != 0) {
+      continue;
+    }
+
+    // The table is 2D and float or float16, the indices 2D.
+    const NodeArg* table = gather_node.InputDefs()[0];
+    const NodeArg* indices = gather_node.InputDefs()[1];
+    const auto* table_shape = table->Shape();
+    const auto* indices_shape = indices->Shape();
+    const auto* table_type = table->TypeAsProto();
+    if (table_shape == nullptr || table_shape->dim_size() != 2 || indices_shape == nullptr ||
+        indices_shape->dim_size() != 2 || table_type == nullptr ||
+        (table_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT &&
+         table_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT16)) {
+      continue;
+    }
+
+    Node& reduce_node = *graph.GetNode(gather_node.OutputNodesBegin()->Index());
+    if (reduce_node.GetExecutionProviderType() != gather_node.GetExecutionProviderType() ||
+        reduce_node.InputDefs()[0] != gather_node.OutputDefs()[0]) {
+      continue;
+    }
+
+    const char* mode = GetEmbeddingBagMode(graph, reduce_node);
+    if (mode == nullptr) {
+      continue;
+    }
+
+    InlinedVector<NodeArg*> embedding_bag_inputs{gather_node.MutableInputDefs()[0], gather_node.MutableInputDefs()[1]};
+    Node& embedding_bag_node = graph.AddNode(graph.GenerateNodeName("EmbeddingBag"),
+                                             "EmbeddingBag",
+                                             "fused " + gather_node.Name() + " and " + reduce_node.Name(),
+                                             embedding_bag_inputs,
+                                             {},
+                                             {},
+                                             kMSDomain);
+    embedding_bag_node.AddAttribute("mode", std::string(mode));
+    embedding_bag_node.SetExecutionProviderType(gather_node.GetExecutionProviderType());
+
+    // move output definitions and edge, remove nodes.
+    graph_utils::FinalizeNodeFusion(graph, {gather_node, reduce_node}, embedding_bag_node);
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
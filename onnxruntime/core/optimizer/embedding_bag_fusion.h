@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class EmbeddingBagFusion
+
+Fuse a Gather of the rows of a 2D table by 2D indices followed by a ReduceSum or ReduceMean over the indices of
+each row to the EmbeddingBag contrib op, which reduces the rows without materializing the gathered tensor.
+
+   table   indices (batch_size, bag_size)
+      \      /
+       Gather                                      table   indices
+          |  (batch_size, bag_size, dim)   ==>        \      /
+  ReduceSum/ReduceMean(axes=[1], keepdims=0)        EmbeddingBag(mode=sum/mean)
+          |  (batch_size, dim)                           |
+*/
+class EmbeddingBagFusion : public GraphTransformer {
+ public:
+  EmbeddingBagFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("EmbeddingBagFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
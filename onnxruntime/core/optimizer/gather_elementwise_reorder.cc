@@ -0,0 +1,123 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gather_elementwise_reorder.h"
+
+#include <algorithm>
+#include <array>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/qdq_transformer/qdq_util.h"
+
+namespace onnxruntime {
+
+namespace {
+// The element types of the tables that are gathered before converting them, which are the fixed size types the
+// Gather kernels are registered for. The tables of int4, uint4 or float8 values are converted before the Gather.
+constexpr std::array kSupportedTableTypes{
+    ONNX_NAMESPACE::TensorProto_DataType_FLOAT, ONNX_NAMESPACE::TensorProto_DataType_DOUBLE,
+    ONNX_NAMESPACE::TensorProto_DataType_FLOAT16, ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16,
+    ONNX_NAMESPACE::TensorProto_DataType_INT64, ONNX_NAMESPACE::TensorProto_DataType_UINT64,
+    ONNX_NAMESPACE::TensorProto_DataType_INT32, ONNX_NAMESPACE::TensorProto_DataType_UINT32,
+    ONNX_NAMESPACE::TensorProto_DataType_INT16, ONNX_NAMESPACE::TensorProto_DataType_UINT16,
+    ONNX_NAMESPACE::TensorProto_DataType_INT8, ONNX_NAMESPACE::TensorProto_DataType_UINT8,
+    ONNX_NAMESPACE::TensorProto_DataType_BOOL,
+};
+
+bool IsSupportedTableType(const NodeArg& table) {
+  const auto* type = table.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         std::find(kSupportedTableTypes.cbegin(), kSupportedTableTypes.cend(), type->tensor_type().elem_type()) !=
+             kSupportedTableTypes.cend();
+}
+
+// Whether the node is a Cast, or a DequantizeLinear with a constant scalar scale and zero point, whose input is a
+// constant initializer.
+bool IsMovableElementwiseNode(const Graph& graph, const Node& node) {
+  if (!graph_utils::IsConstantInitializer(graph, node.InputDefs()[0]->Name()) ||
+      !IsSupportedTableType(*node.InputDefs()[0])) {
+    return false;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Cast", {6, 9, 13, 19, 21})) {
+    return true;
+  }
+
+  if (QDQ::MatchDQNode(node)) {
+    const auto get_constant_initializer = [&graph](const std::string& name) {
+      return graph_utils::GetConstantInitializer(graph, name);
+    };
+    bool zero_point_exists = false;
+    return QDQ::QOrDQNodeHasConstantScalarScaleAndZeroPoint(node, get_constant_initializer, zero_point_exists);
+  }
+
+  return false;
+}
+}  // namespace
+
+bool GatherElementwiseReorder::SatisfyCondition(const Graph& graph, const Node& node, const logging::Logger&) const {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "Gather", {1, 11, 13})) {
+    return false;
+  }
+
+  const Node* elementwise_node = graph_utils::GetInputNode(node, 0);
+  if (elementwise_node == nullptr ||
+      elementwise_node->GetExecutionProviderType() != node.GetExecutionProviderType() ||
+      elementwise_node->GetOutputEdgesCount() != 1 ||
+      graph.NodeProducesGraphOutput(*elementwise_node) ||
+      !IsMovableElementwiseNode(graph, *elementwise_node)) {
+    return false;
+  }
+
+  // a DequantizeLinear -> Gather -> QuantizeLinear group is run on the quantized data
+  for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+    if (QDQ::MatchQNode(*it)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status GatherElementwiseReorder::Apply(Graph& graph, Node& gather, RewriteRuleEffect& rule_effect,
+                                       const logging::Logger&) const {
+  Node& elementwise_node = *graph.GetNode(graph_utils::GetInputNode(gather, 0)->Index());
+  NodeArg* table = elementwise_node.MutableInputDefs()[0];
+
+  // the gathered rows keep the type of the table
+  ONNX_NAMESPACE::TypeProto gathered_type;
+  gathered_type.mutable_tensor_type()->set_elem_type(table->TypeAsProto()->tensor_type().elem_type());
+  NodeArg& gathered = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(gather.Name() + "_gathered"), &gathered_type);
+
+  InlinedVector<NodeArg*> gather_inputs = {table, gather.MutableInputDefs()[1]};
+  Node& new_gather = graph.AddNode(graph.GenerateNodeName(gather.Name()), gather.OpType(), gather.Description(),
+                                   gather_inputs, {&gathered}, &gather.GetAttributes(), gather.Domain());
+  new_gather.SetExecutionProviderType(gather.GetExecutionProviderType());
+
+  InlinedVector<NodeArg*> elementwise_inputs(elementwise_node.MutableInputDefs().begin(),
+                                             elementwise_node.MutableInputDefs().end());
+  elementwise_inputs[0] = &gathered;
+  // the output is replaced by the one of the Gather when the Gather is removed
+  NodeArg& placeholder_output = graph_utils::CreateNodeArg(graph, *gather.OutputDefs()[0]);
+  Node& new_elementwise_node = graph.AddNode(graph.GenerateNodeName(elementwise_node.Name()),
+                                             elementwise_node.OpType(), elementwise_node.Description(),
+                                             elementwise_inputs, {&placeholder_output},
+                                             &elementwise_node.GetAttributes(), elementwise_node.Domain());
+  new_elementwise_node.SetExecutionProviderType(elementwise_node.GetExecutionProviderType());
+
+  // the indices may be produced by a node
+  if (const auto* indices_edge = graph_utils::GetInputEdge(gather, 1); indices_edge != nullptr) {
+    graph.AddEdge(indices_edge->GetNode().Index(), new_gather.Index(), indices_edge->GetSrcArgIndex(), 1);
+  }
+  graph.AddEdge(new_gather.Index(), new_elementwise_node.Index(), 0, 0);
+
+  // the outputs and output edges of the Gather move to the new elementwise node, which also removes the Gather
+  graph_utils::RemoveNodeOutputEdges(graph, elementwise_node);
+  graph.RemoveNode(elementwise_node.Index());
+  graph_utils::FinalizeNodeFusion(graph, new_elementwise_node, gather);
+
+  rule_effect = RewriteRuleEffect::kRemovedCurrentNode;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
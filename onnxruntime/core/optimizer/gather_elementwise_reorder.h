@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/rewrite_rule.h"
+
+namespace onnxruntime {
+
+/**
+@Class GatherElementwiseReorder
+
+Rewrite rule that moves a Cast or a per-tensor DequantizeLinear of a constant table after the Gather which reads it,
+so that only the gathered rows are converted, e.g. for embedding lookups in a quantized or float16 table.
+
+  table -> DequantizeLinear -> Gather ->      becomes      table -> Gather -> DequantizeLinear ->
+                  indices ------^                      indices ------^
+
+The table stays in its smaller type instead of being converted as a whole, and isn't constant folded into a larger
+initializer. The rule doesn't apply if the result of the Gather is quantized again, as the DequantizeLinear is then
+part of a QDQ node group.
+
+It is attempted to be triggered only on nodes with op type "Gather".
+*/
+class GatherElementwiseReorder : public RewriteRule {
+ public:
+  GatherElementwiseReorder() noexcept : RewriteRule("GatherElementwiseReorder") {}
+
+  std::vector<std::string> TargetOpTypes() const noexcept override {
+    return {"Gather"};
+  }
+
+ private:
+  bool SatisfyCondition(const Graph& graph, const Node& node, const logging::Logger& logger) const override;
+
+  Status Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_effect, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
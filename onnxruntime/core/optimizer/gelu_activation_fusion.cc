@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/gelu_activation_fusion.h"
+
+#include <cmath>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/optimizer/selectors_actions/actions.h"
+
+#if !defined(ORT_MINIMAL_BUILD)
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/utils.h"
+#endif
+
+namespace onnxruntime {
+
+namespace {
+
+using NTO = NodesToOptimize;
+
+#if !defined(ORT_MINIMAL_BUILD)
+
+namespace selectors {
+
+// Gelu supports limited data types.
+bool IsSupportedDataType(const Node& node) {
+  for (const auto* input_arg : node.InputDefs()) {
+    const auto* type = input_arg->Type();
+    if (type == nullptr ||
+        (*type != "tensor(float16)" && *type != "tensor(float)" && *type != "tensor(double)")) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsFusableNode(const Node& node, const Node& target, std::string_view op_type,
+                   const std::initializer_list<ONNX_NAMESPACE::OperatorSetVersion>& versions) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, versions) &&
+         node.GetExecutionProviderType() == target.GetExecutionProviderType() &&
+         IsSupportedDataType(node);
+}
+
+// Selects the subgraphs fused by GeluFusion. The target is the Div node and the output nodes are the Erf, Add and
+// two Mul nodes, with the Mul producing the Gelu output last.
+//   pattern 1: root -> Div(sqrt(2)) -> Erf -> Add(1) -> Mul -> , with root -> Mul(0.5) as the other Mul input
+//   pattern 2: root -> Div(sqrt(2)) -> Erf -> Add(1) -> Mul(root) -> Mul(0.5) ->
+class GeluSelector : public NodeSelector {
+ public:
+  std::optional<NodesToOptimizeIndices> Select(const GraphViewer& graph_viewer, const Node& div) const override {
+    const Graph& graph = graph_viewer.GetGraph();
+    if (!optimizer_utils::CheckOutputEdges(graph, div, 1) || !IsSupportedDataType(div)) {
+      return std::nullopt;
+    }
+
+    // Some Bert model uses this approximation of SQRT2 in the Gelu function
+    constexpr float approximated_sqrt_two = 1.4142099618911743f;
+    if (!optimizer_utils::IsInitializerWithExpectedValue(graph, *div.InputDefs()[1], approximated_sqrt_two, true) &&
+        !optimizer_utils::IsInitializerWithExpectedValue(graph, *div.InputDefs()[1], static_cast<float>(M_SQRT2),
+                                                         true)) {
+      return std::nullopt;
+    }
+
+    const Node& erf = *div.OutputNodesBegin();
+    if (!IsFusableNode(erf, div, "Erf", {9, 13}) || !optimizer_utils::CheckOutputEdges(graph, erf, 1)) {
+      return std::nullopt;
+    }
+
+    const Node& add = *erf.OutputNodesBegin();
+    if (!IsFusableNode(add, div, "Add", {7, 13, 14}) || !optimizer_utils::CheckOutputEdges(graph, add, 1)) {
+      return std::nullopt;
+    }
+
+    const bool is_erf_first_input = add.InputDefs()[0]->Name() == erf.OutputDefs()[0]->Name();
+    if (!optimizer_utils::IsInitializerWithExpectedValue(graph, *add.InputDefs()[is_erf_first_input ? 1 : 0], 1.0f,
+                                                         true)) {
+      return std::nullopt;
+    }
+
+    const Node& mul = *add.OutputNodesBegin();
+    if (!IsFusableNode(mul, div, "Mul", {7, 13, 14})) {
+      return std::nullopt;
+    }
+
+    const NodeArg& root = *div.InputDefs()[0];
+    NodesToOptimizeIndicesBuilder builder{};
+    builder.target_node = div.Index();
+
+    if (const Node* mul_half = graph_utils::FirstParentByType(mul, "Mul"); mul_half != nullptr) {
+      // pattern 1
+      if (!IsFusableNode(*mul_half, div, "Mul", {7, 13, 14}) ||
+          !optimizer_utils::CheckOutputEdges(graph, *mul_half, 1)) {
+        return std::nullopt;
+      }
+
+      const int root_index = optimizer_utils::IndexOfNodeInput(*mul_half, root);
+      if (root_index < 0 ||
+          !optimizer_utils::IsInitializerWithExpectedValue(graph, *mul_half->InputDefs()[root_index == 0 ? 1 : 0],
+                                                           0.5f, true)) {
+        return std::nullopt;
+      }
+
+      builder.output_nodes = {erf.Index(), add.Index(), mul_half->Index(), mul.Index()};
+    } else {
+      // pattern 2
+      if (!optimizer_utils::CheckOutputEdges(graph, mul, 1) || optimizer_utils::IndexOfNodeInput(mul, root) < 0) {
+        return std::nullopt;
+      }
+
+      const Node& mul_half_after = *mul.OutputNodesBegin();
+      if (!IsFusableNode(mul_half_after, div, "Mul", {7, 13, 14})) {
+        return std::nullopt;
+      }
+
+      const bool is_mul_first_input = mul_half_after.InputDefs()[0]->Name() == mul.OutputDefs()[0]->Name();
+      if (!optimizer_utils::IsInitializerWithExpectedValue(
+              graph, *mul_half_after.InputDefs()[is_mul_first_input ? 1 : 0], 0.5f, true)) {
+        return std::nullopt;
+      }
+
+      builder.output_nodes = {erf.Index(), add.Index(), mul.Index(), mul_half_after.Index()};
+    }
+
+    return builder.Build();
+  }
+};
+
+// Selects an Add of a 1D bias followed by Gelu, or by FastGelu without a bias, as fused by BiasGeluFusion.
+class BiasGeluSelector : public NodeSelector {
+ public:
+  std::optional<NodesToOptimizeIndices> Select(const GraphViewer& graph_viewer, const Node& add) const override {
+    const Graph& graph = graph_viewer.GetGraph();
+    if (!optimizer_utils::CheckOutputEdges(graph, add, 1) || graph.NodeProducesGraphOutput(add)) {
+      return std::nullopt;
+    }
+
+    const auto* input0_shape = add.InputDefs()[0]->Shape();
+    const auto* input1_shape = add.InputDefs()[1]->Shape();
+    if (input0_shape == nullptr || input1_shape == nullptr ||
+        input0_shape->dim_size() < 1 || input1_shape->dim_size() < 1 ||
+        (input0_shape->dim_size() != 1 && input1_shape->dim_size() != 1) ||
+        input0_shape->dim(input0_shape->dim_size() - 1) != input1_shape->dim(input1_shape->dim_size() - 1)) {
+      return std::nullopt;
+    }
+
+    const Node& gelu = *add.OutputNodesBegin();
+    if (!(graph_utils::IsSupportedOptypeVersionAndDomain(gelu, "Gelu", {1}, kMSDomain) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(gelu, "FastGelu", {1}, kMSDomain)) ||
+        gelu.GetExecutionProviderType() != add.GetExecutionProviderType() ||
+        (gelu.OpType() == "FastGelu" && gelu.InputDefs().size() > 1)) {
+      return std::nullopt;
+    }
+
+    NodesToOptimizeIndicesBuilder builder{};
+    builder.target_node = add.Index();
+    builder.output_nodes = {gelu.Index()};
+    return builder.Build();
+  }
+};
+
+}  // namespace selectors
+
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+namespace actions {
+
+// replaces the Add and Gelu/FastGelu with BiasGelu/FastGelu, taking the 1D Add input as the bias
+class FuseBiasGelu : public ReplaceWithNew {
+ private:
+  std::string OpType(const RuntimeState& runtime_state) const override {
+    return runtime_state.selected_nodes.Output(0)->OpType() == "FastGelu" ? "FastGelu" : "BiasGelu";
+  }
+
+  std::string Domain(const RuntimeState&) const override { return kMSDomain; }
+
+  NodeAttributes ExtraAttributes(const RuntimeState&) const override { return {}; }
+
+  std::vector<NodeAndMoveInfo> ValueMoves(const RuntimeState& runtime_state) const override {
+    const auto* input0_shape = runtime_state.selected_nodes.Target().InputDefs()[0]->Shape();
+    ORT_ENFORCE(input0_shape != nullptr, "Expected the shape of the Add input.");
+    const int bias_index = input0_shape->dim_size() == 1 ? 0 : 1;
+
+    const NTO::NodeLocation add{NTO::NodeType::kTarget, 0};
+    const NTO::NodeLocation gelu{NTO::NodeType::kOutput, 0};
+    return {
+        MoveToSlot(add, ArgType::kInput, 1 - bias_index, ArgType::kInput, 0),  // input
+        MoveToSlot(add, ArgType::kInput, bias_index, ArgType::kInput, 1),      // bias
+        MoveAll(gelu, ArgType::kOutput),
+    };
+  }
+};
+
+}  // namespace actions
+
+void RegisterGeluFusionRule(SelectorActionRegistry& registry) {
+  constexpr const char* name = "Gelu";
+
+  const NTO::NodeLocation div{NTO::NodeType::kTarget, 0};
+  const NTO::NodeLocation last_mul{NTO::NodeType::kOutput, 3};
+  auto action = std::make_unique<ReplaceWithNewFixed>(
+      kMSDomain, "Gelu",
+      std::vector<NodeAndMoveInfo>{MoveToSlot(div, ArgType::kInput, 0, ArgType::kInput, 0),
+                                   MoveAll(last_mul, ArgType::kOutput)});
+
+#if !defined(ORT_MINIMAL_BUILD)
+  auto selector = std::make_unique<selectors::GeluSelector>();
+  registry.RegisterSelectorAndAction(name, {{"Div", {7, 13, 14}}}, std::move(selector), std::move(action));
+#else
+  registry.RegisterAction(name, std::move(action));
+#endif
+}
+
+void RegisterBiasGeluFusionRule(SelectorActionRegistry& registry) {
+  constexpr const char* name = "BiasGelu";
+
+  auto action = std::make_unique<actions::FuseBiasGelu>();
+
+#if !defined(ORT_MINIMAL_BUILD)
+  auto selector = std::make_unique<selectors::BiasGeluSelector>();
+  registry.RegisterSelectorAndAction(name, {{"Add", {7, 13, 14}}}, std::move(selector), std::move(action));
+#else
+  registry.RegisterAction(name, std::move(action));
+#endif
+}
+
+SelectorActionRegistry CreateSelectorActionRegistry() {
+  SelectorActionRegistry registry{};
+  RegisterGeluFusionRule(registry);
+  RegisterBiasGeluFusionRule(registry);
+  return registry;
+}
+
+}  // namespace
+
+GeluActivationFusion::GeluActivationFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers,
+                                           const SatApplyContextVariant& apply_context)
+    : SelectorActionTransformer{
+          "GeluActivationFusion", CreateSelectorActionRegistry(), apply_context, compatible_execution_providers} {
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,22 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/selectors_actions/selector_action_transformer.h"
+
+namespace onnxruntime {
+
+// Performs the Gelu fusions of GeluFusion and BiasGeluFusion as selectors and actions, so they can be saved as
+// runtime optimizations and replayed in a minimal build.
+// Currently supports these fusions:
+// - x * 0.5 * (1.0 + Erf(x / sqrt(2.0))) -> Gelu
+// - Add (with a 1D bias) + Gelu -> BiasGelu
+// - Add (with a 1D bias) + FastGelu -> FastGelu with bias input
+class GeluActivationFusion : public SelectorActionTransformer {
+ public:
+  GeluActivationFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {},
+                       const SatApplyContextVariant& apply_context = {});
+};
+
+}  // namespace onnxruntime
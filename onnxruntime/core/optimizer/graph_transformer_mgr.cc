@@ -26,15 +26,37 @@ common::Status GraphTransformerManager::ApplyTransformers(Graph& graph, Transfor
     return Status::OK();
   }
 
+  // the number of modifications of the graph by the transformers, and its value after the last pass of each
+  // rule-based transformer. if it did not change since then, the transformer can continue incrementally.
+  size_t num_modifications = 0;
+  InlinedHashMap<const RuleBasedGraphTransformer*, size_t> num_modifications_after_pass;
+
   for (unsigned step = 0; step < steps_; ++step) {
     bool graph_changed = false;
     for (const auto& transformer : transformers->second) {
       if (step > 0 && transformer->ShouldOnlyApplyOnce())
         continue;
 
+      const RuleBasedGraphTransformer* rule_based_transformer = nullptr;
+      if (incremental_rule_based_transformers_) {
+        rule_based_transformer = dynamic_cast<const RuleBasedGraphTransformer*>(transformer.get());
+        if (rule_based_transformer) {
+          auto entry = num_modifications_after_pass.find(rule_based_transformer);
+          rule_based_transformer->SetApplyIncrementally(entry != num_modifications_after_pass.end() &&
+                                                        entry->second == num_modifications);
+        }
+      }
+
       bool modified = false;
       ORT_RETURN_IF_ERROR(transformer->Apply(graph, modified, logger));
       graph_changed = graph_changed || modified;
+
+      if (modified) {
+        ++num_modifications;
+      }
+      if (rule_based_transformer) {
+        num_modifications_after_pass[rule_based_transformer] = num_modifications;
+      }
     }
     if (!graph_changed) {
       break;
@@ -24,6 +24,10 @@ class GraphTransformerManager {
   // Get the maximum number of graph transformation steps
   common::Status GetSteps(unsigned& steps) const;
 
+  // Set whether the rule-based transformers only revisit the nodes changed by their previous pass, and their
+  // neighbors, if no other transformer modified the graph since then.
+  void SetIncrementalRuleBasedTransformers(bool incremental) { incremental_rule_based_transformers_ = incremental; }
+
   // Register a transformer with a level.
   common::Status Register(std::unique_ptr<GraphTransformer> transformer, TransformerLevel level);
 
@@ -36,6 +40,8 @@ class GraphTransformerManager {
   // maximum number of graph transformation steps
   unsigned steps_;
 
+  bool incremental_rule_based_transformers_ = false;
+
   InlinedHashMap<TransformerLevel, InlinedVector<std::unique_ptr<GraphTransformer>>> level_to_transformer_map_;
   InlinedHashMap<std::string, GraphTransformer*> transformers_info_;
 };
@@ -7,6 +7,7 @@
 #include <variant>
 
 #include "core/optimizer/conv_activation_fusion.h"
+#include "core/optimizer/gelu_activation_fusion.h"
 #include "core/optimizer/matmul_nbits_fusion.h"
 #include "core/optimizer/nhwc_transformer.h"
 #include "core/optimizer/qdq_transformer/qdq_final_cleanup.h"
@@ -18,6 +19,7 @@
 #if !defined(ORT_MINIMAL_BUILD)
 
 #include "core/mlas/inc/mlas.h"
+#include "core/optimizer/activation_smoothing.h"
 #include "core/optimizer/attention_fusion.h"
 #include "core/optimizer/bias_dropout_fusion.h"
 #include "core/optimizer/bias_gelu_fusion.h"
@@ -34,16 +36,20 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
 #include "core/optimizer/free_dim_override_transformer.h"
+#include "core/optimizer/gather_elementwise_reorder.h"
 #include "core/optimizer/gather_fusion.h"
 #include "core/optimizer/gelu_approximation.h"
 #include "core/optimizer/gelu_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/identical_children_consolidation.h"
 #include "core/optimizer/identity_elimination.h"
 #include "core/optimizer/label_encoder_fusion.h"
@@ -54,9 +60,13 @@
 #include "core/optimizer/matmul_integer_to_float.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/memory_aware_node_ordering.h"
+#include "core/optimizer/memory_budget_optimizer.h"
+#include "core/optimizer/nchwc_conv_chain_fusion.h"
 #include "core/optimizer/nchwc_transformer.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
+#include "core/optimizer/packing_mode_transformer.h"
 #include "core/optimizer/pad_fusion.h"
 #include "core/optimizer/pre_shape_node_elimination.h"
 #ifdef MLAS_TARGET_AMD64_IX86
@@ -64,6 +74,7 @@
 #endif
 #include "core/optimizer/qdq_transformer/clip_quantizelinear.h"
 #include "core/optimizer/qdq_transformer/ensure_unique_dq_for_node_unit.h"
+#include "core/optimizer/qdq_transformer/qdq_int4_weight_to_int8.h"
 #include "core/optimizer/qdq_transformer/qdq_propagation.h"
 #include "core/optimizer/qdq_transformer/qdq_s8_to_u8.h"
 #include "core/optimizer/qdq_transformer/relu_quantizelinear.h"
@@ -73,9 +84,11 @@
 #include "core/optimizer/rocm_blas_alt_impl.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
+#include "core/optimizer/tensor_parallel_partitioner.h"
 #include "core/optimizer/slice_elimination.h"
 #include "core/optimizer/transpose_optimizer.h"
 #include "core/optimizer/unsqueeze_elimination.h"
+#include "core/optimizer/zipmap_removal.h"
 #ifdef ENABLE_TRAINING
 #include "orttraining/core/optimizer/bias_softmax_dropout_fusion.h"
 #include "orttraining/core/optimizer/bitmask_dropout_replacement.h"
@@ -121,6 +134,7 @@ InlinedVector<std::unique_ptr<RewriteRule>> GenerateRewriteRules(
       rules.push_back(std::make_unique<EliminateDropout>());
       rules.push_back(std::make_unique<ExpandElimination>());
       rules.push_back(std::make_unique<CastElimination>());
+      rules.push_back(std::make_unique<GatherElementwiseReorder>());
       rules.push_back(std::make_unique<PreShapeNodeElimination>());
       rules.push_back(std::make_unique<NoopElimination>());
       rules.push_back(std::make_unique<DivMulFusion>());
@@ -212,6 +226,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 
       // no filtering on execution provider for L1 optimizations as they only use official ONNX operators
 
+      if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsRemoveZipMap, "0") == "1") {
+        transformers.emplace_back(std::make_unique<ZipMapRemoval>());
+      }
+
       if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsDisableDoubleQDQRemover, "0") == "0") {
         // We need to remove the duplicated QDQ Pairs before all other GraphTransformation.
         transformers.emplace_back(std::make_unique<DoubleQDQPairsRemover>());
@@ -272,6 +290,13 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
                                                             QDQIsInt8Allowed() ? "1" : "0") == "1";
       const bool enable_gelu_approximation =
           session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGeluApproximation, "0") == "1";
+      const bool enable_elementwise_chain_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableElementwiseChainFusion, "0") == "1";
+      const bool enable_group_query_attention_fusion =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableGroupQueryAttentionFusion,
+                                                            "0") == "1";
+      const bool enable_packing_mode =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnablePackingMode, "0") == "1";
 
       const InlinedHashSet<std::string_view> cuda_rocm_eps = {onnxruntime::kCudaExecutionProvider,
                                                               onnxruntime::kRocmExecutionProvider};
@@ -305,7 +330,27 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
 #else
       const bool avx2_precision_mode = false;
 #endif
+
+#if defined(ORT_USE_NCCL)
+      // The MLP blocks are sharded before the fusions below, which would hide the activations from the pattern.
+      const int64_t tensor_parallel_world_size = ParseStringWithClassicLocale<int64_t>(
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsTensorParallelWorldSize, "1"));
+      if (tensor_parallel_world_size > 1) {
+        const int64_t tensor_parallel_rank = ParseStringWithClassicLocale<int64_t>(
+            session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsTensorParallelRank, "0"));
+        ORT_ENFORCE(tensor_parallel_rank >= 0 && tensor_parallel_rank < tensor_parallel_world_size,
+                    "Invalid tensor parallel rank ", tensor_parallel_rank, " for a world size of ",
+                    tensor_parallel_world_size);
+        // The AllReduce contrib op is only implemented by the CUDA and ROCm EPs.
+        transformers.emplace_back(std::make_unique<TensorParallelPartitioner>(tensor_parallel_rank,
+                                                                              tensor_parallel_world_size,
+                                                                              cuda_rocm_eps));
+      }
+#endif  // defined(ORT_USE_NCCL)
+
       if (!disable_quant_qdq) {
+        // widen 4-bit Conv/Gemm weights first so that the 8-bit rules below apply to them
+        transformers.emplace_back(std::make_unique<QDQInt4WeightToInt8Transformer>(cpu_ep));
         // currently we don't support QDQS8ToU8Transformer in a minimal build and if supported, this needs to run in
         // Level 1 during export and not Level 2 at runtime as it would result in overlapping optimizations which
         // runtime optimization does not support, so add session config value here to force qdqisint8allowed to be true.
@@ -328,8 +373,30 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<GeluFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<LayerNormFusion>(cpu_cuda_dml_rocm_eps));
       transformers.emplace_back(std::make_unique<SimplifiedLayerNormFusion>(cpu_cuda_rocm_eps));
+      // smoothing applies to the fused layer normalizations, and must update the MatMul weights before the attention
+      // fusion packs them
+      const std::string activation_smoothing_scales_file =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsActivationSmoothingScalesFile, "");
+      if (!activation_smoothing_scales_file.empty()) {
+        const float activation_smoothing_alpha = ParseStringWithClassicLocale<float>(
+            session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsActivationSmoothingAlpha, "0.5"));
+        ORT_ENFORCE(activation_smoothing_alpha >= 0.0f && activation_smoothing_alpha <= 1.0f,
+                    "Invalid activation smoothing alpha ", activation_smoothing_alpha, ", expected a value in [0, 1]");
+        InlinedHashMap<std::string, std::vector<float>> activation_abs_max;
+        ORT_THROW_IF_ERROR(ActivationSmoothing::LoadActivationAbsMax(activation_smoothing_scales_file,
+                                                                     activation_abs_max));
+        transformers.emplace_back(std::make_unique<ActivationSmoothing>(std::move(activation_abs_max),
+                                                                        activation_smoothing_alpha,
+                                                                        cpu_cuda_dml_rocm_eps));
+      }
       transformers.emplace_back(std::make_unique<AttentionFusion>(cpu_cuda_dml_rocm_eps));
+      if (enable_group_query_attention_fusion) {
+        transformers.emplace_back(std::make_unique<GroupQueryAttentionFusion>(
+            InlinedHashSet<std::string_view>{onnxruntime::kCpuExecutionProvider,
+                                             onnxruntime::kCudaExecutionProvider}));
+      }
       transformers.emplace_back(std::make_unique<EmbedLayerNormFusion>(cpu_cuda_dml_rocm_eps));
+      transformers.emplace_back(std::make_unique<EmbeddingBagFusion>(cpu_ep));
       transformers.emplace_back(std::make_unique<GatherSliceToSplitFusion>(cpu_cuda_rocm_eps));
       transformers.emplace_back(std::make_unique<GatherToSliceFusion>(cpu_cuda_rocm_eps));
 
@@ -348,12 +415,29 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
         transformers.emplace_back(std::make_unique<GeluApproximation>(cpu_cuda_rocm_eps));
       }
 
+      // PackingModeTransformer must run after the attention, layer normalization and gelu fusions whose nodes it packs.
+      if (enable_packing_mode) {
+        transformers.emplace_back(std::make_unique<PackingModeTransformer>(
+            InlinedHashSet<std::string_view>{onnxruntime::kCudaExecutionProvider}));
+      }
+
+      // the fusion needs the Triton op executor, registered from Python in training builds, so a session asking for it
+      // without one is rejected instead of silently not fusing
+      const std::string triton_fusion_config =
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsTritonFusionConfig, "");
 #ifdef ENABLE_TRITON
-      if (training::framework::triton::TritonOpExecutor::Instance().IsInitialized()) {
-        transformers.emplace_back(
-            std::make_unique<TritonFusion>(training::framework::triton::TritonOpExecutor::Instance().GetConfigJson(),
-                                           InlinedHashSet<std::string_view>{onnxruntime::kCudaExecutionProvider}));
+      const bool has_triton_op_executor = training::framework::triton::TritonOpExecutor::Instance().IsInitialized();
+      ORT_ENFORCE(triton_fusion_config.empty() || has_triton_op_executor, "The session config ",
+                  kOrtSessionOptionsTritonFusionConfig, " requires a Triton op executor to be registered.");
+      if (has_triton_op_executor) {
+        transformers.emplace_back(std::make_unique<TritonFusion>(
+            triton_fusion_config.empty() ? training::framework::triton::TritonOpExecutor::Instance().GetConfigJson()
+                                         : triton_fusion_config,
+            InlinedHashSet<std::string_view>{onnxruntime::kCudaExecutionProvider}));
       }
+#else
+      ORT_ENFORCE(triton_fusion_config.empty(), "The session config ", kOrtSessionOptionsTritonFusionConfig,
+                  " requires a build with Triton enabled (onnxruntime_ENABLE_TRITON, a CUDA training build).");
 #endif  // ENABLE_TRITON
 
       transformers.emplace_back(std::make_unique<BiasSoftmaxFusion>(cpu_cuda_rocm_eps));
@@ -377,6 +461,12 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<MatMulNBitsFusion>(cpu_ep));
 #endif  // !defined(ORT_NEURAL_SPEED)
 
+      // ElementwiseChainFusion must run after the fusions that match elementwise operators, e.g. MatMulScaleFusion,
+      // so it doesn't take their operators.
+      if (enable_elementwise_chain_fusion) {
+        transformers.emplace_back(std::make_unique<ElementwiseChainFusion>(cpu_ep));
+      }
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
       // The QDQFinalCleanupTransformer must run AFTER other transformers that fuse Q/DQ nodes. Otherwise, their
       // fusions might be prevented if this one removes a Q/DQ node too early.
@@ -389,6 +479,10 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       // Register the NCHWc layout transformer if supported by the platform.
       if (MlasNchwcGetBlockSize() > 1) {
         transformers.emplace_back(std::make_unique<NchwcTransformer>());
+        if (session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableNchwcConvChainFusion, "0") ==
+            "1") {
+          transformers.emplace_back(std::make_unique<NchwcConvChainFusion>());
+        }
       }
 
       auto cpu_registry = cpu_execution_provider.GetKernelRegistry();
@@ -405,6 +499,24 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformers(
       transformers.emplace_back(std::make_unique<ConvAddActivationFusion>(cpu_ep));
 #endif
 
+      const size_t intermediate_memory_budget = ParseStringWithClassicLocale<size_t>(
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsIntermediateMemoryBudgetInBytes, "0"));
+      if (intermediate_memory_budget > 0) {
+        // The chunks use Split and Concat nodes, which are assigned to the EP of the chunked nodes.
+        const InlinedHashSet<std::string_view> cpu_cuda_rocm_eps = {onnxruntime::kCpuExecutionProvider,
+                                                                    onnxruntime::kCudaExecutionProvider,
+                                                                    onnxruntime::kRocmExecutionProvider};
+        transformers.emplace_back(std::make_unique<MemoryBudgetOptimizer>(intermediate_memory_budget,
+                                                                          cpu_cuda_rocm_eps));
+      }
+
+      // The node priorities are only used by the priority-based execution order. This runs last so the priorities
+      // are set for the final nodes of the graph.
+      if (session_options.execution_order == ExecutionOrder::PRIORITY_BASED &&
+          session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsEnableMemoryAwareNodeOrdering,
+                                                            "0") == "1") {
+        transformers.emplace_back(std::make_unique<MemoryAwareNodeOrdering>());
+      }
     } break;
 
     default:
@@ -457,6 +569,7 @@ InlinedVector<std::unique_ptr<GraphTransformer>> GenerateTransformersForMinimalB
       }
 
       transformers.emplace_back(std::make_unique<ConvActivationFusion>(cpu_ep, apply_context));
+      transformers.emplace_back(std::make_unique<GeluActivationFusion>(cpu_ep, apply_context));
 #if !defined(ORT_NEURAL_SPEED)
       transformers.emplace_back(std::make_unique<MatMulNBitsFusion>(cpu_ep, apply_context));
 #endif  // !defined(ORT_NEURAL_SPEED)
@@ -0,0 +1,649 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/group_query_attention_fusion.h"
+
+#include <deque>
+#include <map>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/utils.h"
+
+#define DEBUG_LOG(x) LOGS(logger, VERBOSE) << x
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+// the maximum number of values visited when looking for the graph input that the mask is computed from
+constexpr size_t kMaxMaskSearchSize = 256;
+
+// Q, K or V in BNSH format: Transpose(Reshape(input)) where input has shape (B, S, N * H).
+// A RotaryEmbedding may be applied to the input or to the result.
+struct Projection {
+  NodeArg* input = nullptr;
+  const Node* rotary = nullptr;
+  InlinedVector<const Node*> nodes;
+  int64_t num_heads = 0;
+  int64_t head_size = 0;
+};
+
+// The present key or value Concat(past, new, axis=2), which is repeated to the number of query heads with
+// Reshape(Expand(Unsqueeze(present, axes=[2]))) when there are fewer KV heads.
+struct Present {
+  const Node* concat = nullptr;
+  InlinedVector<const Node*> repeat_nodes;
+};
+
+// seqlens_k and total_sequence_length of GroupQueryAttention
+struct SequenceLengths {
+  NodeArg* seqlens_k = nullptr;
+  NodeArg* total_sequence_length = nullptr;
+};
+
+const Node* GetProducer(const Graph& graph, const NodeArg* node_arg) {
+  return node_arg != nullptr && node_arg->Exists() ? graph.GetProducerNode(node_arg->Name()) : nullptr;
+}
+
+int64_t GetIntAttribute(const Node& node, const std::string& name, int64_t default_value) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && attr->has_i() ? attr->i() : default_value;
+}
+
+bool IsAttributeIn(const Node& node, const std::string& name, std::initializer_list<int64_t> values) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  return attr != nullptr && attr->has_i() && std::find(values.begin(), values.end(), attr->i()) != values.end();
+}
+
+bool IsTranspose(const Node& node, const std::vector<int64_t>& perm) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Transpose", {1, 13, 21}) &&
+         optimizer_utils::IsAttributeWithExpectedValues(node, "perm", perm);
+}
+
+bool IsReshape(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Reshape", {5, 13, 14, 19, 21});
+}
+
+bool IsMatMul(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13});
+}
+
+// a RotaryEmbedding that GroupQueryAttention can compute
+bool IsFoldableRotaryEmbedding(const Node& node) {
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(node, "RotaryEmbedding", {1}, kMSDomain) ||
+      GetIntAttribute(node, "rotary_embedding_dim", 0) != 0 || GetIntAttribute(node, "is_packed_batching", 0) != 0) {
+    return false;
+  }
+
+  const auto* scale = graph_utils::GetNodeAttribute(node, "scale");
+  return scale == nullptr || !scale->has_f() || scale->f() == 1.0f;
+}
+
+bool GetConstantScalar(const Graph& graph, const NodeArg& node_arg, float& value) {
+  if (!optimizer_utils::IsScalar(node_arg)) {
+    return false;
+  }
+
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, node_arg.Name());
+  if (tensor_proto == nullptr) {
+    return false;
+  }
+
+  Initializer initializer{*tensor_proto, graph.ModelPath()};
+  switch (tensor_proto->data_type()) {
+    case TensorProto_DataType_FLOAT:
+      value = *initializer.data<float>();
+      return true;
+    case TensorProto_DataType_FLOAT16:
+      value = initializer.data<MLFloat16>()->ToFloat();
+      return true;
+    case TensorProto_DataType_BFLOAT16:
+      value = initializer.data<BFloat16>()->ToFloat();
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool HasAxes(const Graph& graph, const Node& node, int64_t axis) {
+  if (node.InputDefs().size() < 2) {
+    return optimizer_utils::IsAttributeWithExpectedValues(node, "axes", {axis});
+  }
+
+  InlinedVector<int64_t> axes;
+  return optimizer_utils::AppendTensorFromInitializer(graph, *node.InputDefs()[1], axes) && axes.size() == 1 &&
+         axes[0] == axis;
+}
+
+// Get the number of heads and the head size from the BNSH output of the projection, or the shape of its Reshape.
+bool GetHeads(const Graph& graph, const Node& reshape, const Node& transpose, int64_t& num_heads,
+              int64_t& head_size) {
+  const auto* shape = transpose.OutputDefs()[0]->Shape();
+  if (shape != nullptr && shape->dim_size() == 4 && utils::HasDimValue(shape->dim(1)) &&
+      utils::HasDimValue(shape->dim(3))) {
+    num_heads = shape->dim(1).dim_value();
+    head_size = shape->dim(3).dim_value();
+    return num_heads > 0 && head_size > 0;
+  }
+
+  InlinedVector<int64_t> reshape_shape;
+  if (!optimizer_utils::AppendTensorFromInitializer(graph, *reshape.InputDefs()[1], reshape_shape) ||
+      reshape_shape.size() != 4) {
+    return false;
+  }
+
+  num_heads = reshape_shape[2];
+  head_size = reshape_shape[3];
+  return num_heads > 0 && head_size > 0;
+}
+
+bool MatchProjection(Graph& graph, const NodeArg* bnsh, bool allow_rotary, Projection& projection) {
+  const Node* node = GetProducer(graph, bnsh);
+  if (node != nullptr && allow_rotary && IsFoldableRotaryEmbedding(*node)) {
+    projection.rotary = node;
+    projection.nodes.push_back(node);
+    node = GetProducer(graph, node->InputDefs()[0]);
+  }
+
+  if (node == nullptr || !IsTranspose(*node, {0, 2, 1, 3})) {
+    return false;
+  }
+
+  const Node& transpose = *node;
+  projection.nodes.push_back(node);
+  node = GetProducer(graph, transpose.InputDefs()[0]);
+  if (node == nullptr || !IsReshape(*node)) {
+    return false;
+  }
+
+  const Node& reshape = *node;
+  projection.nodes.push_back(node);
+  projection.input = graph.GetNode(reshape.Index())->MutableInputDefs()[0];
+  const Node* input_producer = GetProducer(graph, projection.input);
+  if (projection.rotary == nullptr && allow_rotary && input_producer != nullptr &&
+      IsFoldableRotaryEmbedding(*input_producer)) {
+    projection.rotary = input_producer;
+    projection.nodes.push_back(input_producer);
+    projection.input = graph.GetNode(input_producer->Index())->MutableInputDefs()[0];
+  }
+
+  const auto* input_shape = projection.input->Shape();
+  if (input_shape != nullptr && input_shape->dim_size() != 3) {
+    return false;
+  }
+
+  return GetHeads(graph, reshape, transpose, projection.num_heads, projection.head_size);
+}
+
+bool MatchPresent(const Graph& graph, const NodeArg* value, Present& present) {
+  const Node* node = GetProducer(graph, value);
+  if (node != nullptr && IsReshape(*node)) {
+    const Node* expand = GetProducer(graph, node->InputDefs()[0]);
+    if (expand == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*expand, "Expand", {8, 13})) {
+      return false;
+    }
+
+    const Node* unsqueeze = GetProducer(graph, expand->InputDefs()[0]);
+    if (unsqueeze == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*unsqueeze, "Unsqueeze", {1, 11, 13, 21}) ||
+        !HasAxes(graph, *unsqueeze, 2)) {
+      return false;
+    }
+
+    present.repeat_nodes = {node, expand, unsqueeze};
+    node = GetProducer(graph, unsqueeze->InputDefs()[0]);
+  }
+
+  if (node == nullptr || !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Concat", {4, 11, 13}) ||
+      node->InputDefs().size() != 2 || !IsAttributeIn(*node, "axis", {2, -2})) {
+    return false;
+  }
+
+  present.concat = node;
+  return true;
+}
+
+// Match Q * K^T, optionally multiplied or divided by a constant scale.
+bool MatchScores(const Graph& graph, const NodeArg* scores, const Node*& scale_node, float& scale,
+                 const Node*& qk_matmul) {
+  const Node* node = GetProducer(graph, scores);
+  if (node == nullptr) {
+    return false;
+  }
+
+  scale_node = nullptr;
+  scale = 1.0f;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Mul", {7, 13, 14})) {
+    float value;
+    const int scalar_index = GetConstantScalar(graph, *node->InputDefs()[1], value) ? 1 : 0;
+    if (scalar_index == 0 && !GetConstantScalar(graph, *node->InputDefs()[0], value)) {
+      return false;
+    }
+
+    scale_node = node;
+    scale = value;
+    node = GetProducer(graph, node->InputDefs()[1 - scalar_index]);
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*node, "Div", {7, 13, 14})) {
+    float value;
+    if (!GetConstantScalar(graph, *node->InputDefs()[1], value) || value == 0.0f) {
+      return false;
+    }
+
+    scale_node = node;
+    scale = 1.0f / value;
+    node = GetProducer(graph, node->InputDefs()[0]);
+  }
+
+  if (node == nullptr || !IsMatMul(*node)) {
+    return false;
+  }
+
+  qk_matmul = node;
+  return true;
+}
+
+// Find the 2D integer graph input that the mask is computed from. The values that are only used through their shape,
+// e.g. the input ids, are skipped.
+NodeArg* FindAttentionMask(Graph& graph, gsl::span<const NodeArg* const> mask_values) {
+  NodeArg* attention_mask = nullptr;
+  InlinedHashSet<const NodeArg*> visited;
+  std::deque<const NodeArg*> to_visit(mask_values.begin(), mask_values.end());
+  while (!to_visit.empty()) {
+    const NodeArg* value = to_visit.front();
+    to_visit.pop_front();
+    if (value == nullptr || !value->Exists() || !visited.insert(value).second) {
+      continue;
+    }
+
+    if (visited.size() > kMaxMaskSearchSize) {
+      return nullptr;
+    }
+
+    const auto& graph_inputs = graph.GetInputs();
+    if (std::find(graph_inputs.begin(), graph_inputs.end(), value) != graph_inputs.end()) {
+      const auto* type = value->TypeAsProto();
+      const auto* shape = value->Shape();
+      if (type != nullptr && shape != nullptr && shape->dim_size() == 2 &&
+          (type->tensor_type().elem_type() == TensorProto_DataType_INT64 ||
+           type->tensor_type().elem_type() == TensorProto_DataType_INT32)) {
+        if (attention_mask != nullptr && attention_mask != value) {
+          return nullptr;
+        }
+
+        attention_mask = graph.GetNodeArg(value->Name());
+      }
+
+      continue;
+    }
+
+    const Node* producer = GetProducer(graph, value);
+    if (producer == nullptr || producer->OpType() == "Shape" || producer->OpType() == "Size") {
+      continue;
+    }
+
+    for (const NodeArg* input : producer->InputDefs()) {
+      to_visit.push_back(input);
+    }
+  }
+
+  return attention_mask;
+}
+
+NodeArg& CreateNodeArg(Graph& graph, const std::string& name, TensorProto_DataType data_type) {
+  TypeProto type_proto;
+  type_proto.mutable_tensor_type()->set_elem_type(data_type);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(name), &type_proto);
+}
+
+NodeArg& CreateInitializer(Graph& graph, const std::string& name, TensorProto_DataType data_type,
+                           std::initializer_list<int64_t> dims, int64_t value) {
+  TensorProto initializer;
+  initializer.set_name(graph.GenerateNodeArgName(name));
+  initializer.set_data_type(data_type);
+  for (int64_t dim : dims) {
+    initializer.add_dims(dim);
+  }
+
+  if (data_type == TensorProto_DataType_INT32) {
+    initializer.add_int32_data(static_cast<int32_t>(value));
+  } else {
+    initializer.add_int64_data(value);
+  }
+
+  return graph_utils::AddInitializer(graph, initializer);
+}
+
+// Compute seqlens_k = ReduceSum(attention_mask, axes=[1]) - 1 and total_sequence_length = Shape(attention_mask)[1]
+// as int32 values.
+SequenceLengths CreateSequenceLengths(Graph& graph, NodeArg& attention_mask, const ProviderType& provider_type) {
+  const auto add_node = [&graph, &provider_type](const std::string& op_type, gsl::span<NodeArg* const> inputs,
+                                                 NodeArg& output) -> Node& {
+    Node& node = graph.AddNode(graph.GenerateNodeName("GroupQueryAttentionFusion/" + op_type), op_type,
+                               "Sequence lengths for GroupQueryAttention", inputs, std::array{&output}, nullptr,
+                               kOnnxDomain);
+    node.SetExecutionProviderType(provider_type);
+    return node;
+  };
+
+  NodeArg* mask_int32 = &attention_mask;
+  if (attention_mask.TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_INT32) {
+    mask_int32 = &CreateNodeArg(graph, "attention_mask_int32", TensorProto_DataType_INT32);
+    add_node("Cast", std::array{&attention_mask}, *mask_int32)
+        .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+  }
+
+  NodeArg& axes = CreateInitializer(graph, "seqlens_axes", TensorProto_DataType_INT64, {1}, 1);
+  NodeArg& sum = CreateNodeArg(graph, "attention_mask_sum", TensorProto_DataType_INT32);
+  add_node("ReduceSum", std::array{mask_int32, &axes}, sum).AddAttribute("keepdims", static_cast<int64_t>(0));
+
+  NodeArg& one = CreateInitializer(graph, "seqlens_one", TensorProto_DataType_INT32, {}, 1);
+  NodeArg& seqlens_k = CreateNodeArg(graph, "seqlens_k", TensorProto_DataType_INT32);
+  add_node("Sub", std::array{&sum, &one}, seqlens_k);
+
+  NodeArg& shape = CreateNodeArg(graph, "attention_mask_shape", TensorProto_DataType_INT64);
+  add_node("Shape", std::array{mask_int32}, shape);
+
+  NodeArg& index = CreateInitializer(graph, "total_sequence_length_index", TensorProto_DataType_INT64, {}, 1);
+  NodeArg& total_int64 = CreateNodeArg(graph, "total_sequence_length_int64", TensorProto_DataType_INT64);
+  add_node("Gather", std::array{&shape, &index}, total_int64).AddAttribute("axis", static_cast<int64_t>(0));
+
+  NodeArg& total_sequence_length = CreateNodeArg(graph, "total_sequence_length", TensorProto_DataType_INT32);
+  add_node("Cast", std::array{&total_int64}, total_sequence_length)
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+
+  return {&seqlens_k, &total_sequence_length};
+}
+
+// Whether the kernel of the execution provider supports the data type
+bool IsSupportedDataType(const NodeArg& node_arg, const ProviderType& provider_type) {
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    return false;
+  }
+
+  const auto data_type = type->tensor_type().elem_type();
+  if (provider_type == kCpuExecutionProvider) {
+    return data_type == TensorProto_DataType_FLOAT;
+  }
+
+  return data_type == TensorProto_DataType_FLOAT16 || data_type == TensorProto_DataType_BFLOAT16;
+}
+
+// Remove the nodes which computed values that are no longer used, e.g. the mask of the fused subgraphs.
+void RemoveUnusedProducers(Graph& graph, gsl::span<const NodeArg* const> values) {
+  std::deque<const NodeArg*> to_visit(values.begin(), values.end());
+  while (!to_visit.empty()) {
+    const NodeArg* value = to_visit.front();
+    to_visit.pop_front();
+    const Node* producer = GetProducer(graph, value);
+    if (producer == nullptr || producer->GetOutputEdgesCount() != 0 || graph.NodeProducesGraphOutput(*producer) ||
+        producer->ContainsSubgraph()) {
+      continue;
+    }
+
+    to_visit.insert(to_visit.end(), producer->InputDefs().begin(), producer->InputDefs().end());
+    graph.RemoveNode(producer->Index());
+  }
+}
+
+bool FuseGroupQueryAttention(Graph& graph, const Node& softmax,
+                             std::map<std::string, SequenceLengths>& sequence_lengths_map,
+                             InlinedVector<const NodeArg*>& unused_mask_values, const logging::Logger& logger) {
+  const int64_t softmax_axis = GetIntAttribute(softmax, "axis", -1);
+  if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {13}) ||
+      (softmax_axis != -1 && softmax_axis != 3)) {
+    return false;
+  }
+
+  // Softmax(scores + mask) or Softmax(Where(mask, fill, scores))
+  const Node* masked = GetProducer(graph, softmax.InputDefs()[0]);
+  if (masked == nullptr) {
+    return false;
+  }
+
+  const Node* scale_node = nullptr;
+  const Node* qk_matmul = nullptr;
+  float scale = 1.0f;
+  InlinedVector<const NodeArg*> mask_values;
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(*masked, "Add", {7, 13, 14})) {
+    for (int i = 0; i < 2 && qk_matmul == nullptr; ++i) {
+      if (MatchScores(graph, masked->InputDefs()[i], scale_node, scale, qk_matmul)) {
+        mask_values.push_back(masked->InputDefs()[1 - i]);
+      }
+    }
+  } else if (graph_utils::IsSupportedOptypeVersionAndDomain(*masked, "Where", {9, 16})) {
+    for (int i = 2; i > 0 && qk_matmul == nullptr; --i) {
+      if (MatchScores(graph, masked->InputDefs()[i], scale_node, scale, qk_matmul)) {
+        mask_values.push_back(masked->InputDefs()[0]);
+        mask_values.push_back(masked->InputDefs()[3 - i]);
+      }
+    }
+  }
+
+  if (qk_matmul == nullptr) {
+    DEBUG_LOG("Failed to match the scores of attention");
+    return false;
+  }
+
+  const Node* k_transpose = GetProducer(graph, qk_matmul->InputDefs()[1]);
+  if (k_transpose == nullptr || !IsTranspose(*k_transpose, {0, 1, 3, 2})) {
+    DEBUG_LOG("Failed to match the transpose of K");
+    return false;
+  }
+
+  Present present_k;
+  Present present_v;
+  if (!MatchPresent(graph, k_transpose->InputDefs()[0], present_k)) {
+    DEBUG_LOG("Failed to match the present key");
+    return false;
+  }
+
+  if (softmax.GetOutputEdgesCount() != 1) {
+    return false;
+  }
+
+  const Node& qkv_matmul = *softmax.OutputNodesBegin();
+  if (!IsMatMul(qkv_matmul) || qkv_matmul.InputDefs()[0] != softmax.OutputDefs()[0] ||
+      !MatchPresent(graph, qkv_matmul.InputDefs()[1], present_v)) {
+    DEBUG_LOG("Failed to match the present value");
+    return false;
+  }
+
+  if (qkv_matmul.GetOutputEdgesCount() != 1) {
+    return false;
+  }
+
+  const Node& output_transpose = *qkv_matmul.OutputNodesBegin();
+  if (!IsTranspose(output_transpose, {0, 2, 1, 3}) || output_transpose.GetOutputEdgesCount() != 1) {
+    return false;
+  }
+
+  const Node& output_reshape = *output_transpose.OutputNodesBegin();
+  if (!IsReshape(output_reshape)) {
+    return false;
+  }
+
+  Projection q;
+  Projection k;
+  Projection v;
+  if (!MatchProjection(graph, qk_matmul->InputDefs()[0], true, q) ||
+      !MatchProjection(graph, present_k.concat->InputDefs()[1], true, k) ||
+      !MatchProjection(graph, present_v.concat->InputDefs()[1], false, v)) {
+    DEBUG_LOG("Failed to match the projections of Q, K and V");
+    return false;
+  }
+
+  if (q.head_size != k.head_size || q.head_size != v.head_size || k.num_heads != v.num_heads ||
+      q.num_heads % k.num_heads != 0) {
+    DEBUG_LOG("The numbers of heads or the head sizes of Q, K and V don't match");
+    return false;
+  }
+
+  // K and V must be repeated if and only if there are fewer KV heads
+  const bool is_grouped = q.num_heads != k.num_heads;
+  if (present_k.repeat_nodes.empty() == is_grouped || present_v.repeat_nodes.empty() == is_grouped) {
+    return false;
+  }
+
+  // the rotary embedding of Q and K must be the same
+  const bool do_rotary = q.rotary != nullptr;
+  int64_t rotary_interleaved = 0;
+  if (do_rotary) {
+    if (k.rotary == nullptr) {
+      return false;
+    }
+
+    for (size_t i = 1; i < 4; ++i) {
+      if (q.rotary->InputDefs()[i] != k.rotary->InputDefs()[i]) {
+        return false;
+      }
+    }
+
+    rotary_interleaved = GetIntAttribute(*q.rotary, "interleaved", 0);
+    if (GetIntAttribute(*k.rotary, "interleaved", 0) != rotary_interleaved) {
+      return false;
+    }
+  } else if (k.rotary != nullptr) {
+    return false;
+  }
+
+  const ProviderType& provider_type = softmax.GetExecutionProviderType();
+  if (!IsSupportedDataType(*q.input, provider_type)) {
+    DEBUG_LOG("The data type isn't supported by GroupQueryAttention on " << provider_type);
+    return false;
+  }
+
+  NodeArg* attention_mask = FindAttentionMask(graph, mask_values);
+  if (attention_mask == nullptr) {
+    DEBUG_LOG("Failed to find the attention mask");
+    return false;
+  }
+
+  InlinedVector<const Node*> nodes{masked, qk_matmul, k_transpose, present_k.concat, &softmax,
+                                   &qkv_matmul, present_v.concat, &output_transpose, &output_reshape};
+  if (scale_node != nullptr) {
+    nodes.push_back(scale_node);
+  }
+
+  for (const auto* node_list : {&present_k.repeat_nodes, &present_v.repeat_nodes, &q.nodes, &k.nodes, &v.nodes}) {
+    nodes.insert(nodes.end(), node_list->begin(), node_list->end());
+  }
+
+  // The values computed by the subgraph must only be used within it, except its output and the present key and value
+  InlinedHashSet<NodeIndex> node_indices;
+  for (const Node* node : nodes) {
+    node_indices.insert(node->Index());
+  }
+
+  for (const Node* node : nodes) {
+    if (node == &output_reshape) {
+      continue;
+    }
+
+    const bool is_present = node == present_k.concat || node == present_v.concat;
+    if (!is_present && graph.NodeProducesGraphOutput(*node)) {
+      return false;
+    }
+
+    for (auto it = node->OutputNodesBegin(), end = node->OutputNodesEnd(); it != end; ++it) {
+      if (node_indices.count(it->Index()) == 0) {
+        DEBUG_LOG("The value of " << node->Name() << " is used outside of the attention subgraph");
+        return false;
+      }
+    }
+  }
+
+  auto sequence_lengths = sequence_lengths_map.find(attention_mask->Name());
+  if (sequence_lengths == sequence_lengths_map.end()) {
+    sequence_lengths = sequence_lengths_map.emplace(attention_mask->Name(),
+                                                    CreateSequenceLengths(graph, *attention_mask, provider_type))
+                           .first;
+  }
+
+  InlinedVector<NodeArg*> input_defs{
+      q.input,
+      k.input,
+      v.input,
+      graph.GetNode(present_k.concat->Index())->MutableInputDefs()[0],
+      graph.GetNode(present_v.concat->Index())->MutableInputDefs()[0],
+      sequence_lengths->second.seqlens_k,
+      sequence_lengths->second.total_sequence_length};
+  if (do_rotary) {
+    Node& rotary = *graph.GetNode(q.rotary->Index());
+    input_defs.push_back(rotary.MutableInputDefs()[2]);
+    input_defs.push_back(rotary.MutableInputDefs()[3]);
+  }
+
+  const std::array output_defs{graph.GetNode(output_reshape.Index())->MutableOutputDefs()[0],
+                               graph.GetNode(present_k.concat->Index())->MutableOutputDefs()[0],
+                               graph.GetNode(present_v.concat->Index())->MutableOutputDefs()[0]};
+
+  Node& gqa_node = graph.AddNode(graph.GenerateNodeName("GroupQueryAttention"),
+                                 "GroupQueryAttention",
+                                 "Fused GroupQueryAttention subgraphs",
+                                 input_defs,
+                                 output_defs,
+                                 nullptr,
+                                 kMSDomain);
+  gqa_node.AddAttribute("num_heads", q.num_heads);
+  gqa_node.AddAttribute("kv_num_heads", k.num_heads);
+  gqa_node.AddAttribute("scale", scale);
+  gqa_node.AddAttribute("do_rotary", static_cast<int64_t>(do_rotary ? 1 : 0));
+  gqa_node.AddAttribute("rotary_interleaved", rotary_interleaved);
+  gqa_node.SetExecutionProviderType(provider_type);
+
+  // the mask and the rotary embedding inputs may be computed by nodes that are no longer used after the fusion
+  unused_mask_values.insert(unused_mask_values.end(), mask_values.begin(), mask_values.end());
+  if (do_rotary) {
+    unused_mask_values.push_back(q.rotary->InputDefs()[1]);
+    unused_mask_values.push_back(k.rotary->InputDefs()[1]);
+  }
+
+  for (const Node* node : nodes) {
+    Node* node_to_remove = graph.GetNode(node->Index());
+    graph_utils::RemoveNodeOutputEdges(graph, *node_to_remove);
+    graph.RemoveNode(node_to_remove->Index());
+  }
+
+  DEBUG_LOG("Fused a GroupQueryAttention node.");
+  return true;
+}
+}  // namespace
+
+Status GroupQueryAttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  // the sequence lengths are computed with ReduceSum, whose axes are an input since opset 13
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_version = domain_to_version.find(kOnnxDomain);
+  if (onnx_version == domain_to_version.end() || onnx_version->second < 13) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  std::map<std::string, SequenceLengths> sequence_lengths_map;
+  InlinedVector<const NodeArg*> unused_values;
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (p_node == nullptr) continue;  // node was removed as part of an earlier fusion
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) &&
+        FuseGroupQueryAttention(graph, node, sequence_lengths_map, unused_values, logger)) {
+      modified = true;
+    }
+  }
+
+  RemoveUnusedProducers(graph, unused_values);
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
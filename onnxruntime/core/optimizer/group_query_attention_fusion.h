@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class GroupQueryAttentionFusion
+Rewrite the attention subgraphs of decoder exports (e.g. Llama, Mistral and Phi) into GroupQueryAttention nodes.
+
+The subgraph computes Softmax(Q * K^T * scale + mask) * V per head, where:
+- Q, K and V are 3D projections reshaped and transposed to BNSH, optionally with RotaryEmbedding applied,
+- K and V are concatenated with the past key and value, which gives the present key and value,
+- K and V are repeated to the number of query heads when there are fewer KV heads (repeat_kv),
+- the mask is derived from a 2D attention mask graph input, and is combined with Add or Where.
+
+The rotary embedding is folded into GroupQueryAttention, which computes the positions from the sequence lengths.
+Like the offline fusion script, this assumes the position ids and the causal mask of the export are the standard ones
+for right padded inputs.
+*/
+class GroupQueryAttentionFusion : public GraphTransformer {
+ public:
+  GroupQueryAttentionFusion(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("GroupQueryAttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,297 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/memory_aware_node_ordering.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include "core/common/safeint.h"
+#include "core/framework/data_types.h"
+#include "core/framework/session_options.h"
+#include "core/framework/tensorprotoutils.h"
+
+namespace onnxruntime {
+
+namespace {
+// Estimates the size in bytes of a tensor from its inferred type and shape. Symbolic dimensions count as 1, as they
+// usually scale all the values of the graph alike. Returns 0 if the size can't be estimated.
+size_t EstimateSizeInBytes(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  const auto* shape = node_arg.Shape();
+  if (type == nullptr || !utils::HasTensorType(*type) || !utils::HasElemType(type->tensor_type()) ||
+      shape == nullptr) {
+    return 0;
+  }
+
+  const auto elem_type = type->tensor_type().elem_type();
+  if (elem_type == ONNX_NAMESPACE::TensorProto_DataType_STRING) {
+    return 0;
+  }
+
+  SafeInt<size_t> size = DataTypeImpl::TensorTypeFromONNXEnum(elem_type)->GetElementType()->Size();
+  for (const auto& dim : shape->dim()) {
+    if (utils::HasDimValue(dim) && dim.dim_value() >= 0) {
+      size *= dim.dim_value();
+    }
+  }
+
+  return static_cast<size_t>(size);
+}
+
+constexpr int kDefaultPriority = static_cast<int>(ExecutionPriority::DEFAULT);
+
+// Shape and Size nodes are always run first by the priority-based order, see PriorityNodeCompare.
+bool IsHighPriority(const Node& node) {
+  return node.OpType() == "Shape" || node.OpType() == "Size";
+}
+
+// Tracks the bytes of the values produced by the nodes of a graph which are live while running the nodes in an order.
+// The graph inputs and initializers aren't counted as they are live during the whole run.
+class LiveValues {
+ public:
+  explicit LiveValues(const Graph& graph) {
+    for (const NodeArg* output : graph.GetOutputs()) {
+      graph_outputs_.insert(output);
+    }
+
+    for (const auto& node : graph.Nodes()) {
+      for (const NodeArg* output : node.OutputDefs()) {
+        if (output->Exists()) {
+          sizes_[output] = EstimateSizeInBytes(*output);
+          num_consumers_[output] = 0;
+        }
+      }
+    }
+
+    for (const auto& node : graph.Nodes()) {
+      auto& inputs = node_inputs_[node.Index()];
+      const auto add_input = [&](const NodeArg* input) {
+        if (sizes_.count(input) > 0 && std::find(inputs.begin(), inputs.end(), input) == inputs.end()) {
+          inputs.push_back(input);
+          ++num_consumers_[input];
+        }
+      };
+
+      std::for_each(node.InputDefs().begin(), node.InputDefs().end(), add_input);
+      std::for_each(node.ImplicitInputDefs().begin(), node.ImplicitInputDefs().end(), add_input);
+    }
+
+    remaining_consumers_ = num_consumers_;
+  }
+
+  // Resets the state to before running any node.
+  void Reset() {
+    remaining_consumers_ = num_consumers_;
+    live_bytes_ = 0;
+  }
+
+  // The change of the live bytes after running the node.
+  int64_t GetChange(const Node& node) const {
+    SafeInt<int64_t> change = 0;
+    for (const NodeArg* output : node.OutputDefs()) {
+      if (IsLiveAfterProducer(output)) {
+        change += sizes_.at(output);
+      }
+    }
+
+    for (const NodeArg* input : node_inputs_.at(node.Index())) {
+      if (remaining_consumers_.at(input) == 1 && graph_outputs_.count(input) == 0) {
+        change -= sizes_.at(input);
+      }
+    }
+
+    return change;
+  }
+
+  // Runs the node, and returns the live bytes while it runs, i.e. with its inputs and outputs.
+  size_t Run(const Node& node) {
+    for (const NodeArg* output : node.OutputDefs()) {
+      if (output->Exists()) {
+        live_bytes_ += sizes_.at(output);
+      }
+    }
+
+    const size_t running_bytes = live_bytes_;
+    for (const NodeArg* input : node_inputs_.at(node.Index())) {
+      if (--remaining_consumers_[input] == 0 && graph_outputs_.count(input) == 0) {
+        live_bytes_ -= sizes_.at(input);
+      }
+    }
+
+    for (const NodeArg* output : node.OutputDefs()) {
+      if (output->Exists() && !IsLiveAfterProducer(output)) {
+        live_bytes_ -= sizes_.at(output);
+      }
+    }
+
+    return running_bytes;
+  }
+
+  // Estimates the peak of the live bytes when running the nodes in the given order.
+  size_t EstimatePeak(const Graph& graph, gsl::span<const NodeIndex> order) {
+    Reset();
+    size_t peak = 0;
+    for (NodeIndex index : order) {
+      peak = std::max(peak, Run(*graph.GetNode(index)));
+    }
+
+    return peak;
+  }
+
+ private:
+  bool IsLiveAfterProducer(const NodeArg* output) const {
+    return output->Exists() && (num_consumers_.at(output) > 0 || graph_outputs_.count(output) > 0);
+  }
+
+  InlinedHashMap<const NodeArg*, size_t> sizes_;
+  InlinedHashMap<const NodeArg*, size_t> num_consumers_;
+  InlinedHashMap<const NodeArg*, size_t> remaining_consumers_;
+  // the values produced in the graph which each node consumes, without duplicates
+  InlinedHashMap<NodeIndex, InlinedVector<const NodeArg*>> node_inputs_;
+  InlinedHashSet<const NodeArg*> graph_outputs_;
+  size_t live_bytes_ = 0;
+};
+}  // namespace
+
+Status MemoryAwareNodeOrdering::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                          const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& default_order = graph_viewer.GetNodesInTopologicalOrder();
+  for (auto node_index : default_order) {
+    ORT_RETURN_IF_ERROR(Recurse(*graph.GetNode(node_index), modified, graph_level, logger));
+  }
+
+  // ties are broken by the default order
+  InlinedHashMap<NodeIndex, size_t> default_positions;
+  default_positions.reserve(default_order.size());
+  for (size_t i = 0; i < default_order.size(); ++i) {
+    default_positions[default_order[i]] = i;
+  }
+
+  // Only the priorities of the nodes with the default priority are set, so the nodes whose priority was set by other
+  // passes keep running before or after them. Of two ready nodes, the priority-based order hence runs first the one
+  // which runs first in the order below.
+  const auto runs_before = [&](const Node& node1, int64_t change1, const Node& node2, int64_t change2) {
+    if (IsHighPriority(node1) != IsHighPriority(node2)) {
+      return IsHighPriority(node1);
+    }
+    if (node1.Priority() != node2.Priority()) {
+      return node1.Priority() < node2.Priority();
+    }
+    if (IsHighPriority(node1) || node1.Priority() != kDefaultPriority) {
+      return node1.Index() < node2.Index();
+    }
+    if (change1 != change2) {
+      return change1 < change2;
+    }
+    return default_positions[node1.Index()] < default_positions[node2.Index()];
+  };
+
+  LiveValues live_values(graph);
+  InlinedHashMap<NodeIndex, size_t> in_degrees;
+  InlinedVector<const Node*> ready;
+  for (const auto& node : graph.Nodes()) {
+    in_degrees[node.Index()] = node.GetInputEdgesCount();
+    if (node.GetInputEdgesCount() == 0) {
+      ready.push_back(&node);
+    }
+  }
+
+  std::vector<NodeIndex> order;
+  order.reserve(default_order.size());
+  while (!ready.empty()) {
+    auto best = ready.begin();
+    int64_t best_change = live_values.GetChange(**best);
+    for (auto it = std::next(ready.begin()); it != ready.end(); ++it) {
+      const int64_t change = live_values.GetChange(**it);
+      if (runs_before(**it, change, **best, best_change)) {
+        best = it;
+        best_change = change;
+      }
+    }
+
+    const Node& node = **best;
+    ready.erase(best);
+    live_values.Run(node);
+    order.push_back(node.Index());
+
+    for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+      if (--in_degrees[it->Index()] == 0) {
+        ready.push_back(&*it);
+      }
+    }
+  }
+
+  if (order.size() != default_order.size()) {
+    return Status::OK();
+  }
+
+  // The nodes with the default priority get non-decreasing priorities along the order, starting from the default
+  // one. A node only needs a higher priority than the previous one if a node of the previous priority with a higher
+  // index ran before it, else the priority-based order would run it first. The priorities stay below the lowest
+  // priority set by other passes which is higher than the default one.
+  int priority_limit = std::numeric_limits<int>::max();
+  for (const auto& node : graph.Nodes()) {
+    if (!IsHighPriority(node) && node.Priority() > kDefaultPriority) {
+      priority_limit = std::min(priority_limit, node.Priority());
+    }
+  }
+
+  InlinedVector<std::pair<Node*, int>> new_priorities;
+  int priority = kDefaultPriority;
+  std::optional<NodeIndex> max_index_of_priority;
+  for (NodeIndex index : order) {
+    Node& node = *graph.GetNode(index);
+    if (IsHighPriority(node) || node.Priority() != kDefaultPriority) {
+      continue;
+    }
+
+    if (max_index_of_priority.has_value() && *max_index_of_priority > index) {
+      ++priority;
+      max_index_of_priority.reset();
+    }
+    if (priority >= priority_limit) {
+      LOGS(logger, VERBOSE) << "MemoryAwareNodeOrdering: the priorities set by other passes leave no room for the "
+                            << "order of the nodes of graph " << graph.Name();
+      return Status::OK();
+    }
+
+    if (priority != kDefaultPriority) {
+      new_priorities.emplace_back(&node, priority);
+    }
+    max_index_of_priority = std::max(max_index_of_priority.value_or(index), index);
+  }
+
+  // only change the priorities if this lowers the estimated peak of the priority-based order
+  const size_t priority_based_peak =
+      live_values.EstimatePeak(graph, graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::PRIORITY_BASED));
+  for (auto& [node, new_priority] : new_priorities) {
+    node->SetPriority(new_priority);
+  }
+
+  const size_t ordered_peak =
+      live_values.EstimatePeak(graph, GraphViewer(graph).GetNodesInTopologicalOrder(ExecutionOrder::PRIORITY_BASED));
+  if (ordered_peak >= priority_based_peak) {
+    for (auto& [node, new_priority] : new_priorities) {
+      node->SetPriority(kDefaultPriority);
+    }
+    LOGS(logger, VERBOSE) << "MemoryAwareNodeOrdering: the priority-based order of graph " << graph.Name()
+                          << " already has the lowest estimated peak (" << priority_based_peak << " bytes)";
+    return Status::OK();
+  }
+
+  modified = modified || !new_priorities.empty();
+  const size_t default_peak = live_values.EstimatePeak(graph, default_order);
+  LOGS(logger, INFO) << "MemoryAwareNodeOrdering: estimated peak of the intermediate values of graph " << graph.Name()
+                     << " is " << ordered_peak << " bytes instead of " << priority_based_peak
+                     << " bytes with the previous priorities and " << default_peak
+                     << " bytes with the default order, setting the priorities of " << new_priorities.size()
+                     << " nodes";
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MemoryAwareNodeOrdering
+Set the priorities of the nodes so that the priority-based topological order (ExecutionOrder::PRIORITY_BASED) is one
+with a lower estimated peak of live intermediate values.
+
+The order is built greedily: of the nodes whose inputs are ready, the one which increases the live bytes the least,
+i.e. with the smallest size of its outputs minus the size of the inputs it's the last consumer of, runs next.
+The sizes are estimated from the inferred shapes, where symbolic dimensions count as 1. The priorities are only set
+if this lowers the estimated peak of the priority-based order.
+
+Only the nodes with the default priority are reordered, and given the lowest priorities which reproduce their order.
+The nodes whose priority was set by other passes keep it, and so run before or after the same nodes as before.
+
+The priorities are only used when the session uses the priority-based execution order.
+*/
+class MemoryAwareNodeOrdering : public GraphTransformer {
+ public:
+  MemoryAwareNodeOrdering() noexcept : GraphTransformer("MemoryAwareNodeOrdering") {}
+
+  bool ShouldOnlyApplyOnce() const override { return true; }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
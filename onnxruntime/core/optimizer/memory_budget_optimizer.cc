@@ -0,0 +1,420 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/memory_budget_optimizer.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "core/common/safeint.h"
+#include "core/framework/data_types.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/providers/common.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+// The size in bytes of a tensor, if its type and all its dimensions are known.
+std::optional<size_t> GetSizeInBytes(const NodeArg& node_arg) {
+  const auto* type = node_arg.TypeAsProto();
+  const auto* shape = node_arg.Shape();
+  if (type == nullptr || !utils::HasTensorType(*type) || !utils::HasElemType(type->tensor_type()) ||
+      shape == nullptr || type->tensor_type().elem_type() == TensorProto_DataType_STRING) {
+    return std::nullopt;
+  }
+
+  const auto elem_type = type->tensor_type().elem_type();
+  SafeInt<size_t> size = DataTypeImpl::TensorTypeFromONNXEnum(elem_type)->GetElementType()->Size();
+  for (const auto& dim : shape->dim()) {
+    if (!utils::HasDimValue(dim) || dim.dim_value() < 0) {
+      return std::nullopt;
+    }
+    size *= dim.dim_value();
+  }
+
+  return static_cast<size_t>(size);
+}
+
+// The values are chunked along their second to last axis, i.e. the rows of a MatMul input.
+std::optional<int64_t> GetRowCount(const NodeArg& node_arg) {
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr || shape->dim_size() < 2) {
+    return std::nullopt;
+  }
+
+  const auto& dim = shape->dim(shape->dim_size() - 2);
+  if (!utils::HasDimValue(dim)) {
+    return std::nullopt;
+  }
+
+  return dim.dim_value();
+}
+
+bool IsMatMul(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {13});
+}
+
+// Nodes which compute each row of their outputs from the same rows of their inputs.
+bool IsRowWise(const Node& node) {
+  static const InlinedHashSet<std::string_view> onnx_ops = {
+      "Abs", "Add", "Cast", "Div", "Erf", "Exp", "Gelu", "LeakyRelu", "Mul", "Neg", "Relu", "Sigmoid", "Sqrt",
+      "Sub", "Tanh", "Where"};
+  static const InlinedHashSet<std::string_view> ms_ops = {"BiasGelu", "FastGelu", "Gelu", "QuickGelu"};
+
+  if (node.Domain() == kMSDomain) {
+    return ms_ops.count(node.OpType()) > 0;
+  }
+
+  if (node.Domain() != kOnnxDomain) {
+    return false;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "Softmax", {13}) ||
+      graph_utils::IsSupportedOptypeVersionAndDomain(node, "LogSoftmax", {13})) {
+    // only along the last axis
+    const auto* shape = node.InputDefs()[0]->Shape();
+    const auto& attributes = node.GetAttributes();
+    const auto axis = attributes.find("axis");
+    return shape != nullptr &&
+           HandleNegativeAxis(axis != attributes.end() ? axis->second.i() : -1, shape->dim_size()) ==
+               shape->dim_size() - 1;
+  }
+
+  return onnx_ops.count(node.OpType()) > 0;
+}
+
+// Nodes which are cheap to recompute, as they only broadcast, select or compare values.
+bool IsCheapToRecompute(const Node& node) {
+  static const InlinedHashSet<std::string_view> ops = {
+      "And", "Cast", "ConstantOfShape", "Equal", "Expand", "Greater", "GreaterOrEqual", "Less", "LessOrEqual", "Not",
+      "Or", "Range", "Tile", "Trilu", "Where"};
+  return node.Domain() == kOnnxDomain && ops.count(node.OpType()) > 0 && node.OutputDefs().size() == 1 &&
+         !node.ContainsSubgraph();
+}
+
+enum class ChunkInput {
+  kChunk,  // the value computed by the previous node of the chain, or the input of the chain
+  kKeep,   // used as is by every chunk, e.g. the second MatMul input, or a value broadcast along the rows
+  kSplit,  // split into chunks the same way as the input of the chain
+};
+
+struct ChunkableChain {
+  InlinedVector<Node*> nodes;
+  // the kind of each input of each node
+  InlinedVector<InlinedVector<ChunkInput>> inputs;
+  int64_t row_count = 0;
+  // the size of the largest intermediate value
+  size_t peak_in_bytes = 0;
+};
+
+std::optional<ChunkInput> GetSideInputKind(const NodeArg& input, int64_t row_count) {
+  const auto* shape = input.Shape();
+  if (shape == nullptr) {
+    return std::nullopt;
+  }
+
+  if (shape->dim_size() < 2) {
+    return ChunkInput::kKeep;
+  }
+
+  const auto rows = GetRowCount(input);
+  if (rows == 1) {
+    return ChunkInput::kKeep;
+  }
+
+  if (rows == row_count) {
+    return ChunkInput::kSplit;
+  }
+
+  return std::nullopt;
+}
+
+// Match MatMul -> row-wise nodes -> MatMul starting at the given MatMul.
+std::optional<ChunkableChain> MatchChain(Graph& graph, Node& matmul,
+                                         const InlinedHashSet<std::string_view>& compatible_providers) {
+  const auto row_count = GetRowCount(*matmul.InputDefs()[0]);
+  const auto* b_shape = matmul.InputDefs()[1]->Shape();
+  if (!row_count.has_value() || *row_count < 2 || b_shape == nullptr || b_shape->dim_size() < 2) {
+    return std::nullopt;
+  }
+
+  ChunkableChain chain;
+  chain.nodes.push_back(&matmul);
+  chain.inputs.push_back({ChunkInput::kChunk, ChunkInput::kKeep});
+  chain.row_count = *row_count;
+  Node* node = &matmul;
+  while (true) {
+    const NodeArg& value = *node->OutputDefs()[0];
+    const auto size = GetSizeInBytes(value);
+    if (!size.has_value() || GetRowCount(value) != row_count || node->OutputDefs().size() != 1 ||
+        node->GetOutputEdgesCount() != 1 || graph.NodeProducesGraphOutput(*node)) {
+      return std::nullopt;
+    }
+
+    chain.peak_in_bytes = std::max(chain.peak_in_bytes, *size);
+
+    Node& next = *graph.GetNode(node->OutputNodesBegin()->Index());
+    if (next.GetExecutionProviderType() != matmul.GetExecutionProviderType() ||
+        !graph_utils::IsSupportedProvider(next, compatible_providers)) {
+      return std::nullopt;
+    }
+
+    if (IsMatMul(next)) {
+      if (next.InputDefs()[0] != &value || next.InputDefs()[1] == &value ||
+          GetRowCount(*next.OutputDefs()[0]) != row_count) {
+        return std::nullopt;
+      }
+
+      chain.nodes.push_back(&next);
+      chain.inputs.push_back({ChunkInput::kChunk, ChunkInput::kKeep});
+      return chain;
+    }
+
+    if (!IsRowWise(next)) {
+      return std::nullopt;
+    }
+
+    InlinedVector<ChunkInput> inputs;
+    for (const NodeArg* input : next.InputDefs()) {
+      if (input == &value) {
+        inputs.push_back(ChunkInput::kChunk);
+      } else if (!input->Exists()) {
+        inputs.push_back(ChunkInput::kKeep);
+      } else {
+        const auto kind = GetSideInputKind(*input, *row_count);
+        if (!kind.has_value()) {
+          return std::nullopt;
+        }
+        inputs.push_back(*kind);
+      }
+    }
+
+    chain.nodes.push_back(&next);
+    chain.inputs.push_back(std::move(inputs));
+    node = &next;
+  }
+}
+
+// Create a value for a chunk of the given value, with the given number of rows.
+NodeArg& CreateChunkNodeArg(Graph& graph, const NodeArg& value, int64_t rows) {
+  TypeProto type_proto = *value.TypeAsProto();
+  auto* shape = type_proto.mutable_tensor_type()->mutable_shape();
+  shape->mutable_dim(shape->dim_size() - 2)->set_dim_value(rows);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(value.Name() + "_chunk"), &type_proto);
+}
+
+void ChunkChain(Graph& graph, const ChunkableChain& chain, int64_t num_chunks) {
+  const ProviderType& provider_type = chain.nodes.front()->GetExecutionProviderType();
+
+  // the first chunks get one more row if the rows can't be split evenly
+  InlinedVector<int64_t> chunk_rows(gsl::narrow<size_t>(num_chunks), chain.row_count / num_chunks);
+  for (int64_t i = 0; i < chain.row_count % num_chunks; ++i) {
+    ++chunk_rows[gsl::narrow<size_t>(i)];
+  }
+
+  TensorProto split_initializer;
+  split_initializer.set_name(graph.GenerateNodeArgName("MemoryBudgetOptimizer_chunk_rows"));
+  split_initializer.set_data_type(TensorProto_DataType_INT64);
+  split_initializer.add_dims(num_chunks);
+  for (int64_t rows : chunk_rows) {
+    split_initializer.add_int64_data(rows);
+  }
+  NodeArg& split_arg = graph_utils::AddInitializer(graph, split_initializer);
+
+  InlinedHashMap<const NodeArg*, InlinedVector<NodeArg*>> split_values;
+  const auto split = [&](NodeArg& value) -> const InlinedVector<NodeArg*>& {
+    auto& chunks = split_values[&value];
+    if (chunks.empty()) {
+      for (int64_t rows : chunk_rows) {
+        chunks.push_back(&CreateChunkNodeArg(graph, value, rows));
+      }
+
+      Node& split_node = graph.AddNode(graph.GenerateNodeName("MemoryBudgetOptimizer/Split"), "Split",
+                                       "Split into chunks to lower the peak memory",
+                                       std::array{&value, &split_arg}, chunks, nullptr, kOnnxDomain);
+      split_node.AddAttribute("axis", static_cast<int64_t>(value.Shape()->dim_size() - 2));
+      split_node.SetExecutionProviderType(provider_type);
+    }
+
+    return chunks;
+  };
+
+  NodeArg& chain_input = *chain.nodes.front()->MutableInputDefs()[0];
+  NodeArg& chain_output = *chain.nodes.back()->MutableOutputDefs()[0];
+  InlinedVector<NodeArg*> chunk_outputs;
+  for (size_t chunk = 0; chunk < chunk_rows.size(); ++chunk) {
+    NodeArg* value = split(chain_input)[chunk];
+    for (size_t i = 0; i < chain.nodes.size(); ++i) {
+      Node& node = *chain.nodes[i];
+      InlinedVector<NodeArg*> input_defs;
+      for (size_t j = 0; j < node.InputDefs().size(); ++j) {
+        switch (chain.inputs[i][j]) {
+          case ChunkInput::kChunk:
+            input_defs.push_back(value);
+            break;
+          case ChunkInput::kKeep:
+            input_defs.push_back(node.MutableInputDefs()[j]);
+            break;
+          case ChunkInput::kSplit:
+            input_defs.push_back(split(*node.MutableInputDefs()[j])[chunk]);
+            break;
+        }
+      }
+
+      value = &CreateChunkNodeArg(graph, *node.OutputDefs()[0], chunk_rows[chunk]);
+      Node& chunk_node = graph.AddNode(graph.GenerateNodeName(node.Name() + "_chunk"), node.OpType(),
+                                       node.Description(), input_defs, std::array{value}, &node.GetAttributes(),
+                                       node.Domain());
+      chunk_node.SetExecutionProviderType(provider_type);
+    }
+
+    chunk_outputs.push_back(value);
+  }
+
+  Node& concat_node = graph.AddNode(graph.GenerateNodeName("MemoryBudgetOptimizer/Concat"), "Concat",
+                                    "Concatenate the chunks", chunk_outputs, std::array{&chain_output}, nullptr,
+                                    kOnnxDomain);
+  concat_node.AddAttribute("axis", static_cast<int64_t>(chain_output.Shape()->dim_size() - 2));
+  concat_node.SetExecutionProviderType(provider_type);
+
+  for (Node* node : chain.nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(node->Index());
+  }
+}
+
+// Recompute the output of the node for each of its consumers but the first one in the topological order, so it's
+// freed after each of them.
+bool RecomputeForConsumers(Graph& graph, Node& node, const InlinedHashMap<NodeIndex, size_t>& positions) {
+  const auto consumer_edges = graph_utils::GraphEdge::GetNodeOutputEdges(node);
+  InlinedHashMap<NodeIndex, InlinedVector<graph_utils::GraphEdge>> edges_by_consumer;
+  for (const auto& edge : consumer_edges) {
+    // recomputing for the implicit inputs of nodes with subgraphs isn't supported
+    if (edge.dst_arg_index >= static_cast<int>(graph.GetNode(edge.dst_node)->InputDefs().size())) {
+      return false;
+    }
+    edges_by_consumer[edge.dst_node].push_back(edge);
+  }
+
+  if (edges_by_consumer.size() < 2) {
+    return false;
+  }
+
+  InlinedVector<NodeIndex> consumers;
+  for (const auto& entry : edges_by_consumer) {
+    consumers.push_back(entry.first);
+  }
+  std::sort(consumers.begin(), consumers.end(), [&positions](NodeIndex a, NodeIndex b) {
+    return positions.at(a) < positions.at(b);
+  });
+
+  const auto input_edges = graph_utils::GraphEdge::GetNodeInputEdges(node);
+  for (size_t i = 1; i < consumers.size(); ++i) {
+    NodeArg& output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(node.OutputDefs()[0]->Name()),
+                                               node.OutputDefs()[0]->TypeAsProto());
+    Node& copy = graph.AddNode(graph.GenerateNodeName(node.Name() + "_recompute"), node.OpType(), node.Description(),
+                               node.MutableInputDefs(), std::array{&output}, &node.GetAttributes(), node.Domain());
+    copy.SetExecutionProviderType(node.GetExecutionProviderType());
+    for (const auto& edge : input_edges) {
+      graph.AddEdge(edge.src_node, copy.Index(), edge.src_arg_index, edge.dst_arg_index);
+    }
+
+    Node& consumer = *graph.GetNode(consumers[i]);
+    for (const auto& edge : edges_by_consumer[consumers[i]]) {
+      graph.RemoveEdge(edge.src_node, edge.dst_node, edge.src_arg_index, edge.dst_arg_index);
+      graph_utils::ReplaceNodeInput(consumer, edge.dst_arg_index, output);
+      graph.AddEdge(copy.Index(), edge.dst_node, 0, edge.dst_arg_index);
+    }
+  }
+
+  return true;
+}
+}  // namespace
+
+Status MemoryBudgetOptimizer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                        const logging::Logger& logger) const {
+  if (budget_in_bytes_ == 0) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  InlinedHashMap<NodeIndex, size_t> positions;
+  positions.reserve(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    positions[order[i]] = i;
+  }
+
+  for (auto node_index : order) {
+    Node& node = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!IsCheapToRecompute(node) || !graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        graph.NodeProducesGraphOutput(node)) {
+      continue;
+    }
+
+    const auto output_size = GetSizeInBytes(*node.OutputDefs()[0]);
+    if (!output_size.has_value() || *output_size <= budget_in_bytes_) {
+      continue;
+    }
+
+    // the inputs are kept instead of the output, so they must be small
+    SafeInt<size_t> inputs_size = 0;
+    bool small_inputs = true;
+    for (const NodeArg* input : node.InputDefs()) {
+      const auto input_size = input->Exists() ? GetSizeInBytes(*input) : std::optional<size_t>{0};
+      small_inputs = small_inputs && input_size.has_value();
+      if (small_inputs) {
+        inputs_size += *input_size;
+      }
+    }
+
+    if (small_inputs && static_cast<size_t>(inputs_size) <= budget_in_bytes_ &&
+        RecomputeForConsumers(graph, node, positions)) {
+      LOGS(logger, VERBOSE) << "MemoryBudgetOptimizer: recomputing " << node.OutputDefs()[0]->Name() << " ("
+                            << *output_size << " bytes) for each of its consumers";
+      modified = true;
+    }
+  }
+
+  // chunking uses the split input of Split, which was added in opset 13
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  const auto onnx_version = domain_to_version.find(kOnnxDomain);
+  if (onnx_version == domain_to_version.end() || onnx_version->second < 13) {
+    return Status::OK();
+  }
+
+  InlinedHashSet<NodeIndex> chunked_nodes;
+  for (auto node_index : order) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr || chunked_nodes.count(node_index) > 0 || !IsMatMul(*node) ||
+        !graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const auto chain = MatchChain(graph, *node, GetCompatibleExecutionProviders());
+    if (!chain.has_value() || chain->peak_in_bytes <= budget_in_bytes_) {
+      continue;
+    }
+
+    const int64_t num_chunks = std::min<int64_t>(
+        static_cast<int64_t>((chain->peak_in_bytes + budget_in_bytes_ - 1) / budget_in_bytes_), chain->row_count);
+    for (const Node* chain_node : chain->nodes) {
+      chunked_nodes.insert(chain_node->Index());
+    }
+
+    LOGS(logger, VERBOSE) << "MemoryBudgetOptimizer: chunking the " << chain->nodes.size() << " nodes from "
+                          << node->Name() << " into " << num_chunks << " chunks, the largest intermediate value has "
+                          << chain->peak_in_bytes << " bytes";
+    ChunkChain(graph, *chain, num_chunks);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class MemoryBudgetOptimizer
+Rewrite the graph so that no intermediate value is larger than a memory budget where this is cheap to do, to lower the
+peak memory of inference, e.g. of long-context models.
+
+- A chain of nodes starting and ending with MatMul, with only row-wise nodes in between (elementwise nodes, and
+  Softmax/LogSoftmax along the last axis), is chunked along the rows of the first MatMul input if one of its
+  intermediates is larger than the budget, e.g. the attention scores MatMul(Q, K^T) -> Softmax -> MatMul(., V) or
+  the MLP MatMul -> Gelu -> MatMul. Each chunk only keeps its part of the intermediates, and the results are
+  concatenated.
+- A value larger than the budget which is cheap to recompute from small inputs and is used by several nodes, e.g. an
+  expanded attention mask used by all the layers, is recomputed for each of them instead of being kept for the whole
+  run.
+
+The sizes are taken from the inferred shapes, so values with symbolic dimensions are not changed.
+*/
+class MemoryBudgetOptimizer : public GraphTransformer {
+ public:
+  MemoryBudgetOptimizer(size_t budget_in_bytes,
+                        const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("MemoryBudgetOptimizer", compatible_execution_providers),
+        budget_in_bytes_(budget_in_bytes) {}
+
+  bool ShouldOnlyApplyOnce() const override { return true; }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const size_t budget_in_bytes_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/nchwc_conv_chain_fusion.h"
+
+#include <array>
+
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+
+namespace onnxruntime {
+
+namespace {
+// the maximum number of convolutions in a fused chain
+constexpr size_t kMaxChainLength = 8;
+
+const TensorProto* GetConstantFloatInitializer(const Graph& graph, const NodeArg& node_arg, int rank) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, node_arg.Name());
+  return tensor_proto != nullptr && tensor_proto->data_type() == TensorProto_DataType_FLOAT &&
+                 tensor_proto->dims_size() == rank
+             ? tensor_proto
+             : nullptr;
+}
+
+// Whether node is a NCHWc convolution supported by the ConvChain kernel: 2D, with constant filters and biases,
+// explicit pads and no fused Sum.
+bool CanFuse(const Graph& graph, const Node& node) {
+  if (node.OpType() != "Conv" || node.Domain() != kMSNchwcDomain ||
+      node.GetExecutionProviderType() != kCpuExecutionProvider) {
+    return false;
+  }
+
+  const auto& input_defs = node.InputDefs();
+  if (input_defs.size() > 3 && input_defs[3]->Exists()) {
+    return false;
+  }
+
+  const auto* W = GetConstantFloatInitializer(graph, *input_defs[1], 4);
+  if (W == nullptr) {
+    return false;
+  }
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    const auto* B = GetConstantFloatInitializer(graph, *input_defs[2], 1);
+    if (B == nullptr || B->dims(0) != W->dims(0)) {
+      return false;
+    }
+  }
+
+  const auto* auto_pad_attr = graph_utils::GetNodeAttribute(node, "auto_pad");
+  return auto_pad_attr == nullptr || auto_pad_attr->s() == "NOTSET";
+}
+
+// Appends the values of an INTS attribute, or the default values if the node doesn't have it.
+void AppendInts(const Node& node, const std::string& name, std::vector<int64_t> default_values,
+                std::vector<int64_t>& values) {
+  const auto* attr = graph_utils::GetNodeAttribute(node, name);
+  if (attr != nullptr && static_cast<size_t>(attr->ints_size()) == default_values.size()) {
+    values.insert(values.end(), attr->ints().begin(), attr->ints().end());
+  } else {
+    values.insert(values.end(), default_values.begin(), default_values.end());
+  }
+}
+}  // namespace
+
+Status NchwcConvChainFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                       const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* p_node = graph.GetNode(node_index);
+    if (!p_node) continue;
+
+    Node& node = *p_node;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!CanFuse(graph, node)) {
+      continue;
+    }
+
+    // Grow the chain with the convolution consuming the output of the last one, as long as that output has no
+    // other uses.
+    InlinedVector<std::reference_wrapper<Node>> chain{node};
+    while (chain.size() < kMaxChainLength) {
+      const Node& last_node = chain.back();
+      if (graph.NodeProducesGraphOutput(last_node) || last_node.GetOutputEdgesCount() != 1) {
+        break;
+      }
+
+      const auto output_edge = last_node.OutputEdgesBegin();
+      Node* next_node = graph.GetNode(output_edge->GetNode().Index());
+      if (output_edge->GetDstArgIndex() != 0 || !CanFuse(graph, *next_node)) {
+        break;
+      }
+      chain.push_back(*next_node);
+    }
+
+    if (chain.size() < 2) {
+      continue;
+    }
+
+    std::vector<NodeArg*> inputs{node.MutableInputDefs()[0]};
+    std::vector<int64_t> kernel_shapes;
+    std::vector<int64_t> dilations;
+    std::vector<int64_t> strides;
+    std::vector<int64_t> pads;
+    std::vector<int64_t> groups;
+    std::vector<std::string> activations;
+    std::vector<float> activation_params;
+    for (Node& chain_node : chain) {
+      auto& input_defs = chain_node.MutableInputDefs();
+      const auto* W = graph_utils::GetConstantInitializer(graph, input_defs[1]->Name());
+      inputs.push_back(input_defs[1]);
+
+      // The ConvChain kernel requires the biases, so add zeros for a convolution without them.
+      if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+        inputs.push_back(input_defs[2]);
+      } else {
+        TensorProto zero_bias;
+        zero_bias.set_name(graph.GenerateNodeArgName(input_defs[1]->Name() + "_bias"));
+        zero_bias.set_data_type(TensorProto_DataType_FLOAT);
+        zero_bias.add_dims(W->dims(0));
+        std::vector<float> zeros(static_cast<size_t>(W->dims(0)), 0.0f);
+        utils::SetRawDataInTensorProto(zero_bias, zeros.data(), zeros.size() * sizeof(float));
+        inputs.push_back(&graph_utils::AddInitializer(graph, zero_bias));
+      }
+
+      kernel_shapes.push_back(W->dims(2));
+      kernel_shapes.push_back(W->dims(3));
+      AppendInts(chain_node, "dilations", {1, 1}, dilations);
+      AppendInts(chain_node, "strides", {1, 1}, strides);
+      AppendInts(chain_node, "pads", {0, 0, 0, 0}, pads);
+
+      const auto* group_attr = graph_utils::GetNodeAttribute(chain_node, "group");
+      groups.push_back(group_attr != nullptr ? group_attr->i() : 1);
+
+      const auto* activation_attr = graph_utils::GetNodeAttribute(chain_node, "activation");
+      activations.push_back(activation_attr != nullptr ? activation_attr->s() : std::string());
+
+      // Each convolution has two activation parameters, of which the activation may use fewer.
+      const auto* activation_params_attr = graph_utils::GetNodeAttribute(chain_node, "activation_params");
+      std::array<float, 2> params{0.0f, 0.0f};
+      if (activation_params_attr != nullptr) {
+        for (int i = 0; i < activation_params_attr->floats_size() && i < 2; i++) {
+          params[i] = activation_params_attr->floats(i);
+        }
+      }
+      activation_params.insert(activation_params.end(), params.begin(), params.end());
+    }
+
+    Node& last_node = chain.back();
+    Node& conv_chain_node = graph.AddNode(graph.GenerateNodeName(last_node.Name() + "/NchwcConvChainFusion/"),
+                                          "ConvChain", "Fused chain of NCHWc convolutions", inputs, {}, nullptr,
+                                          kMSNchwcDomain);
+    conv_chain_node.AddAttribute("kernel_shapes", kernel_shapes);
+    conv_chain_node.AddAttribute("dilations", dilations);
+    conv_chain_node.AddAttribute("strides", strides);
+    conv_chain_node.AddAttribute("pads", pads);
+    conv_chain_node.AddAttribute("groups", groups);
+    conv_chain_node.AddAttribute("activations", activations);
+    conv_chain_node.AddAttribute("activation_params", activation_params);
+    conv_chain_node.SetExecutionProviderType(kCpuExecutionProvider);
+
+    graph_utils::FinalizeNodeFusion(graph, chain, conv_chain_node);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
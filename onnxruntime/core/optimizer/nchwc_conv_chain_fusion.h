@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Fuse chains of NCHWc convolutions, where each intermediate output is only consumed by the next convolution,
+ * into a ConvChain node that computes large outputs in bands of rows, so that the intermediate values stay in the
+ * cache instead of being written to and read back from memory.
+ *
+ * This must run after the NchwcTransformer, which produces the NCHWc convolutions and fuses their activations.
+ */
+class NchwcConvChainFusion : public GraphTransformer {
+ public:
+  NchwcConvChainFusion() noexcept : GraphTransformer("NchwcConvChainFusion") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
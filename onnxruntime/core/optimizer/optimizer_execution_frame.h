@@ -84,6 +84,13 @@ class OptimizerExecutionFrame final : public IExecutionFrame {
                           const std::vector<int>& fetch_mlvalue_idxs,
                           const std::vector<OrtValue>& fetches = {});
 
+  // Frame whose node inputs are fed, e.g. to run a kernel created without constant inputs on new values.
+  OptimizerExecutionFrame(const Info& info,
+                          gsl::span<const int> feed_mlvalue_idxs,
+                          gsl::span<const OrtValue> feeds,
+                          const std::vector<int>& fetch_mlvalue_idxs,
+                          const std::vector<OrtValue>& fetches = {});
+
   ~OptimizerExecutionFrame() override = default;
 
  private:
@@ -0,0 +1,386 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/packing_mode_transformer.h"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+
+#include "core/graph/graph_utils.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+using PackedValues = InlinedHashSet<const NodeArg*>;
+
+bool IsAttention(const Node& node) {
+  return node.Domain() == kMSDomain && (node.OpType() == "Attention" || node.OpType() == "MultiHeadAttention");
+}
+
+bool IsLayerNorm(const Node& node) {
+  if (node.Domain() == kMSDomain) {
+    return node.OpType() == "SkipLayerNormalization" || node.OpType() == "SkipSimplifiedLayerNormalization";
+  }
+
+  if (node.Domain() != kOnnxDomain ||
+      (node.OpType() != "LayerNormalization" && node.OpType() != "SimplifiedLayerNormalization")) {
+    return false;
+  }
+
+  // the packed tokens have one dimension less than the padded ones, only the last axis stays the same
+  const auto* axis = graph_utils::GetNodeAttribute(node, "axis");
+  return axis == nullptr || axis->i() == -1;
+}
+
+bool IsActivation(const Node& node) {
+  static const InlinedHashSet<std::string_view> onnx_ops = {"Cast", "Erf", "Gelu", "Identity", "Relu", "Sigmoid",
+                                                            "Tanh"};
+  static const InlinedHashSet<std::string_view> ms_ops = {"BiasGelu", "FastGelu", "Gelu", "QuickGelu"};
+
+  if (node.Domain() == kMSDomain) {
+    return ms_ops.count(node.OpType()) > 0;
+  }
+
+  return node.Domain() == kOnnxDomain && onnx_ops.count(node.OpType()) > 0;
+}
+
+bool IsElementwiseBinary(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "Add", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Sub", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Mul", {7, 13, 14}) ||
+         graph_utils::IsSupportedOptypeVersionAndDomain(node, "Div", {7, 13, 14});
+}
+
+bool HasInput(const Node& node, size_t index) {
+  return node.InputDefs().size() > index && node.InputDefs()[index]->Exists();
+}
+
+bool IsConstant(const Graph& graph, const NodeArg& arg, int max_rank) {
+  const TensorProto* initializer = graph_utils::GetConstantInitializer(graph, arg.Name());
+  return initializer != nullptr && initializer->dims_size() <= max_rank;
+}
+
+// Values which broadcast the same way against the padded and the packed tokens.
+bool IsPackedOrVector(const Graph& graph, const NodeArg& arg, const PackedValues& packed) {
+  return packed.count(&arg) > 0 || IsConstant(graph, arg, 1);
+}
+
+// Only the first output of the attention nodes is supported.
+bool UsesOnlyFirstOutput(const Graph& graph, const Node& node) {
+  for (size_t i = 1; i < node.OutputDefs().size(); ++i) {
+    const NodeArg& output = *node.OutputDefs()[i];
+    if (output.Exists() && (!graph.GetConsumerNodes(output.Name()).empty() || graph.IsOutput(&output))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool IsInt32Vector(const NodeArg& arg) {
+  const auto* type = arg.TypeAsProto();
+  const auto* shape = arg.Shape();
+  return type != nullptr && type->tensor_type().elem_type() == TensorProto_DataType_INT32 && shape != nullptr &&
+         shape->dim_size() == 1;
+}
+
+// Whether the node consuming packed values computes each token independently of the others.
+bool IsTokenWise(const Graph& graph, const Node& node, const PackedValues& packed) {
+  const auto& inputs = node.InputDefs();
+  if (!node.ImplicitInputDefs().empty()) {
+    return false;
+  }
+
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13})) {
+    return packed.count(inputs[0]) > 0 && IsConstant(graph, *inputs[1], 2) && inputs[1]->Shape() != nullptr &&
+           inputs[1]->Shape()->dim_size() == 2;
+  }
+
+  if (node.Domain() == kMSDomain && node.OpType() == "Attention") {
+    const auto* unidirectional = graph_utils::GetNodeAttribute(node, "unidirectional");
+    const auto* do_rotary = graph_utils::GetNodeAttribute(node, "do_rotary");
+    return packed.count(inputs[0]) > 0 && IsConstant(graph, *inputs[1], 2) && HasInput(node, 2) &&
+           IsConstant(graph, *inputs[2], 1) && HasInput(node, 3) && !HasInput(node, 4) &&
+           (!HasInput(node, 5) || packed.count(inputs[5]) == 0) && !HasInput(node, 6) &&
+           (unidirectional == nullptr || unidirectional->i() == 0) && (do_rotary == nullptr || do_rotary->i() == 0) &&
+           UsesOnlyFirstOutput(graph, node);
+  }
+
+  if (node.Domain() == kMSDomain && node.OpType() == "MultiHeadAttention") {
+    const auto* unidirectional = graph_utils::GetNodeAttribute(node, "unidirectional");
+    return HasInput(node, 1) && HasInput(node, 2) && packed.count(inputs[0]) > 0 && packed.count(inputs[1]) > 0 &&
+           packed.count(inputs[2]) > 0 && (!HasInput(node, 3) || IsConstant(graph, *inputs[3], 1)) &&
+           HasInput(node, 4) && (!HasInput(node, 5) || packed.count(inputs[5]) == 0) && !HasInput(node, 6) &&
+           !HasInput(node, 7) && (unidirectional == nullptr || unidirectional->i() == 0) &&
+           UsesOnlyFirstOutput(graph, node);
+  }
+
+  if (!IsElementwiseBinary(node) && !IsActivation(node) && !IsLayerNorm(node)) {
+    return false;
+  }
+
+  // a packed value broadcast against a vector keeps the shape of the packed value
+  return std::all_of(inputs.begin(), inputs.end(), [&](const NodeArg* input) {
+    return !input->Exists() || IsPackedOrVector(graph, *input, packed);
+  });
+}
+
+// The nodes consuming the packed tokens, between the first attention and the last layer normalization.
+struct PackedRegion {
+  NodeArg* padded_input = nullptr;
+  const NodeArg* mask = nullptr;
+  Node* last_norm = nullptr;
+  InlinedVector<Node*> nodes;
+  InlinedVector<Node*> attentions;
+  PackedValues values;
+};
+
+bool FindPackedRegion(Graph& graph, const GraphViewer& graph_viewer,
+                      const InlinedHashSet<std::string_view>& compatible_providers, PackedRegion& region) {
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+  std::optional<size_t> first_attention_position;
+  std::optional<size_t> last_norm_position;
+  for (size_t i = 0; i < order.size(); ++i) {
+    const Node& node = *graph.GetNode(order[i]);
+    if (IsAttention(node) && !first_attention_position.has_value() &&
+        graph_utils::IsSupportedProvider(node, compatible_providers)) {
+      first_attention_position = i;
+    }
+    if (IsLayerNorm(node)) {
+      last_norm_position = i;
+    }
+  }
+
+  if (!first_attention_position.has_value() || !last_norm_position.has_value() ||
+      *last_norm_position < *first_attention_position) {
+    return false;
+  }
+
+  const Node& first_attention = *graph.GetNode(order[*first_attention_position]);
+  const NodeArg& padded_input = *first_attention.InputDefs()[0];
+  const auto* padded_type = padded_input.TypeAsProto();
+  if (padded_input.Shape() == nullptr || padded_input.Shape()->dim_size() != 3 || padded_type == nullptr ||
+      (padded_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT &&
+       padded_type->tensor_type().elem_type() != TensorProto_DataType_FLOAT16)) {
+    return false;
+  }
+
+  region.padded_input = graph.GetNodeArg(padded_input.Name());
+  region.last_norm = graph.GetNode(order[*last_norm_position]);
+  region.values.insert(&padded_input);
+  const NodeArg* restored = region.last_norm->OutputDefs()[0];
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    Node& node = *graph.GetNode(order[i]);
+    const auto& inputs = node.InputDefs();
+    const bool consumes_packed = std::any_of(inputs.begin(), inputs.end(), [&](const NodeArg* input) {
+      return region.values.count(input) > 0;
+    }) || std::any_of(node.ImplicitInputDefs().begin(), node.ImplicitInputDefs().end(), [&](const NodeArg* input) {
+      return region.values.count(input) > 0;
+    });
+    if (!consumes_packed) {
+      continue;
+    }
+
+    // the nodes after the last layer normalization only get its restored output
+    if (i > *last_norm_position) {
+      for (const NodeArg* input : inputs) {
+        if (region.values.count(input) > 0 && input != restored) {
+          return false;
+        }
+      }
+      continue;
+    }
+
+    if (node.GetExecutionProviderType() != first_attention.GetExecutionProviderType() ||
+        !IsTokenWise(graph, node, region.values)) {
+      return false;
+    }
+
+    if (IsAttention(node)) {
+      const NodeArg* mask = node.InputDefs()[node.OpType() == "Attention" ? 3 : 4];
+      if ((region.mask != nullptr && mask != region.mask) || !IsInt32Vector(*mask)) {
+        return false;
+      }
+      region.mask = mask;
+      region.attentions.push_back(&node);
+    }
+
+    region.nodes.push_back(&node);
+    for (const NodeArg* output : node.OutputDefs()) {
+      if (output->Exists()) {
+        region.values.insert(output);
+      }
+    }
+  }
+
+  // the last layer normalization must output the packed tokens, which are the only ones restored
+  if (std::find(region.nodes.begin(), region.nodes.end(), region.last_norm) == region.nodes.end()) {
+    return false;
+  }
+  for (const NodeArg* value : region.values) {
+    if (value != &padded_input && value != restored && graph.IsOutput(value)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+NodeArg& CreateValue(Graph& graph, const std::string& base_name, int32_t elem_type) {
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(elem_type);
+  return graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(base_name), &type);
+}
+
+void AddInputEdge(Graph& graph, const NodeArg& input, Node& node, int input_index) {
+  const Node* producer = graph.GetProducerNode(input.Name());
+  if (producer != nullptr) {
+    graph.AddEdge(producer->Index(), node.Index(), graph_utils::GetNodeOutputIndexFromOutputName(*producer,
+                                                                                                  input.Name()),
+                  input_index);
+  }
+}
+
+// Replace an attention node by its packed version, which takes the token offsets and cumulative sequence lengths.
+void PackAttention(Graph& graph, Node& attention, Node& remove_padding, NodeArg& token_offset,
+                   NodeArg& cumulative_sequence_length) {
+  const bool is_attention = attention.OpType() == "Attention";
+  NodeArg& empty = graph.GetOrCreateNodeArg("", nullptr);
+  auto input = [&](size_t index) -> NodeArg* {
+    return HasInput(attention, index) ? attention.MutableInputDefs()[index] : &empty;
+  };
+
+  // PackedAttention: input, weights, bias, token_offset, cumulative_sequence_length, relative_position_bias
+  // PackedMultiHeadAttention: query, key, value, bias, token_offset, cumulative_sequence_length,
+  // relative_position_bias
+  InlinedVector<NodeArg*> inputs;
+  InlinedVector<int> input_index_map;
+  if (is_attention) {
+    inputs = {input(0), input(1), input(2), &token_offset, &cumulative_sequence_length, input(5)};
+    input_index_map = {0, 1, 2, -1, -1, 5};
+  } else {
+    inputs = {input(0), input(1), input(2), input(3), &token_offset, &cumulative_sequence_length, input(5)};
+    input_index_map = {0, 1, 2, 3, -1, 6};
+  }
+  const int token_offset_index = is_attention ? 3 : 4;
+  while (!inputs.back()->Exists()) {
+    inputs.pop_back();
+  }
+
+  NodeAttributes attributes;
+  const auto& attention_attributes = attention.GetAttributes();
+  const auto attribute_names = is_attention ? std::array{"num_heads", "qkv_hidden_sizes", "scale"}
+                                            : std::array{"num_heads", "mask_filter_value", "scale"};
+  for (const char* name : attribute_names) {
+    auto it = attention_attributes.find(name);
+    if (it != attention_attributes.end()) {
+      attributes.emplace(name, it->second);
+    }
+  }
+
+  Node& packed = graph.AddNode(graph.GenerateNodeName(attention.Name() + "_packed"),
+                               is_attention ? "PackedAttention" : "PackedMultiHeadAttention",
+                               "Attention of the packed tokens", inputs, {attention.MutableOutputDefs()[0]},
+                               &attributes, kMSDomain);
+  packed.SetExecutionProviderType(attention.GetExecutionProviderType());
+
+  for (const auto& edge : graph_utils::GraphEdge::GetNodeInputEdges(attention)) {
+    if (static_cast<size_t>(edge.dst_arg_index) < input_index_map.size() &&
+        input_index_map[edge.dst_arg_index] >= 0) {
+      graph.AddEdge(edge.src_node, packed.Index(), edge.src_arg_index, input_index_map[edge.dst_arg_index]);
+    }
+  }
+  graph.AddEdge(remove_padding.Index(), packed.Index(), 1, token_offset_index);
+  graph.AddEdge(remove_padding.Index(), packed.Index(), 2, token_offset_index + 1);
+
+  graph_utils::ReplaceDownstreamNodeInput(graph, attention, 0, packed, 0);
+  graph_utils::RemoveNodeOutputEdges(graph, attention);
+  graph.RemoveNode(attention.Index());
+}
+}  // namespace
+
+Status PackingModeTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                         const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  for (auto node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node* node = graph.GetNode(node_index);
+    if (node != nullptr) {
+      ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+    }
+  }
+
+  PackedRegion region;
+  if (!FindPackedRegion(graph, graph_viewer, GetCompatibleExecutionProviders(), region)) {
+    return Status::OK();
+  }
+
+  NodeArg& padded_input = *region.padded_input;
+  NodeArg& mask = *graph.GetNodeArg(region.mask->Name());
+  const auto elem_type = padded_input.TypeAsProto()->tensor_type().elem_type();
+  const auto& provider = region.attentions[0]->GetExecutionProviderType();
+
+  // pack the tokens once, before their first consumer
+  NodeArg& packed_input = CreateValue(graph, padded_input.Name() + "_no_padding", elem_type);
+  NodeArg& token_offset = CreateValue(graph, padded_input.Name() + "_token_offset", TensorProto_DataType_INT32);
+  NodeArg& cumulative_sequence_length = CreateValue(graph, padded_input.Name() + "_cumulated_seq_len",
+                                                    TensorProto_DataType_INT32);
+  NodeArg& max_sequence_length = CreateValue(graph, padded_input.Name() + "_max_seq_len", TensorProto_DataType_INT32);
+  Node& remove_padding = graph.AddNode(graph.GenerateNodeName("PackingModeTransformer/RemovePadding"),
+                                       "RemovePadding", "Pack the tokens of the sequences", {&padded_input, &mask},
+                                       {&packed_input, &token_offset, &cumulative_sequence_length,
+                                        &max_sequence_length},
+                                       nullptr, kMSDomain);
+  remove_padding.SetExecutionProviderType(provider);
+  AddInputEdge(graph, padded_input, remove_padding, 0);
+  AddInputEdge(graph, mask, remove_padding, 1);
+
+  for (Node* node : region.nodes) {
+    for (size_t i = 0; i < node->InputDefs().size(); ++i) {
+      if (node->InputDefs()[i] == &padded_input) {
+        const int input_index = static_cast<int>(i);
+        graph_utils::GraphEdge::RemoveGraphEdges(graph, graph_utils::GraphEdge::GetNodeInputEdges(*node, i));
+        graph_utils::ReplaceNodeInput(*node, input_index, packed_input);
+        graph.AddEdge(remove_padding.Index(), node->Index(), 0, input_index);
+      }
+    }
+  }
+
+  // restore the padding of the output of the last layer normalization
+  Node& last_norm = *region.last_norm;
+  NodeArg& restored_output = *last_norm.MutableOutputDefs()[0];
+  NodeArg& packed_output = CreateValue(graph, restored_output.Name() + "_packed", elem_type);
+  const auto output_edges = graph_utils::GraphEdge::GetNodeOutputEdges(last_norm, 0);
+  graph_utils::GraphEdge::RemoveGraphEdges(graph, output_edges);
+  last_norm.MutableOutputDefs()[0] = &packed_output;
+  Node& restore_padding = graph.AddNode(graph.GenerateNodeName("PackingModeTransformer/RestorePadding"),
+                                        "RestorePadding", "Restore the padding of the packed tokens",
+                                        {&packed_output, &token_offset}, {&restored_output}, nullptr, kMSDomain);
+  restore_padding.SetExecutionProviderType(provider);
+  graph.AddEdge(last_norm.Index(), restore_padding.Index(), 0, 0);
+  graph.AddEdge(remove_padding.Index(), restore_padding.Index(), 1, 1);
+  for (const auto& edge : output_edges) {
+    graph.AddEdge(restore_padding.Index(), edge.dst_node, 0, edge.dst_arg_index);
+  }
+
+  for (Node* attention : region.attentions) {
+    PackAttention(graph, *attention, remove_padding, token_offset, cumulative_sequence_length);
+  }
+
+  // the packed tokens have the shape (token_count, hidden_size) instead of (batch_size, sequence_length, hidden_size)
+  for (const NodeArg* value : region.values) {
+    if (value != &padded_input && value != &restored_output) {
+      graph.GetNodeArg(value->Name())->ClearShape();
+    }
+  }
+
+  LOGS(logger, VERBOSE) << "PackingModeTransformer: packed " << region.nodes.size() << " nodes with "
+                        << region.attentions.size() << " attention nodes";
+  modified = true;
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class PackingModeTransformer
+Run the encoder layers of a model on the packed tokens of its sequences instead of the padded batch.
+
+The padded hidden state (batch_size, sequence_length, hidden_size) consumed by the first Attention or
+MultiHeadAttention node is packed once by RemovePadding into (token_count, hidden_size), using the sequence lengths
+of the 1-D mask index of the attention nodes. The attention nodes become PackedAttention and PackedMultiHeadAttention,
+which take the token offsets and cumulative sequence lengths, and the token-wise nodes between them (MatMul, bias Add,
+layer normalizations and activations) run unchanged on the packed tokens. The output of the last layer normalization
+is restored to the padded shape by RestorePadding, with zeros for the padding tokens.
+
+The graph is left unchanged unless every node consuming the packed tokens before the last layer normalization is
+one of those token-wise nodes, and every attention node uses the same 1-D mask without past state.
+*/
+class PackingModeTransformer : public GraphTransformer {
+ public:
+  explicit PackingModeTransformer(const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("PackingModeTransformer", compatible_execution_providers) {}
+
+  bool ShouldOnlyApplyOnce() const override { return true; }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/qdq_transformer/qdq_int4_weight_to_int8.h"
+
+#include <vector>
+
+#include "core/framework/int4.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/qdq_transformer/qdq_util.h"
+
+namespace onnxruntime {
+
+namespace {
+
+bool IsInt4Initializer(const Graph& graph, const NodeArg& arg) {
+  const auto* tensor_proto = graph_utils::GetConstantInitializer(graph, arg.Name());
+  return tensor_proto != nullptr &&
+         (tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT4 ||
+          tensor_proto->data_type() == ONNX_NAMESPACE::TensorProto_DataType_UINT4);
+}
+
+// Conv and Gemm have the quantized weight as input 1, and have 8-bit kernels once it is int8/uint8
+bool IsConsumerWithInt8Kernel(const Graph& graph, const Node& dq_node) {
+  if (graph.NodeProducesGraphOutput(dq_node) || dq_node.GetOutputEdgesCount() != 1) {
+    return false;
+  }
+
+  const auto edge = dq_node.OutputEdgesBegin();
+  const Node& consumer = edge->GetNode();
+  return edge->GetDstArgIndex() == 1 &&
+         (graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "Conv", {1, 11}) ||
+          graph_utils::IsSupportedOptypeVersionAndDomain(consumer, "Gemm", {7, 9, 11, 13}));
+}
+
+template <bool Signed>
+NodeArg& AddWidenedInitializer(Graph& graph, const ONNX_NAMESPACE::TensorProto& src_proto) {
+  using UnpackedType = typename Int4x2Base<Signed>::UnpackedType;
+
+  Initializer src(src_proto, graph.ModelPath());
+  std::vector<UnpackedType> unpacked(src.size());
+  const auto packed = src.DataAsByteSpan();
+  ORT_ENFORCE(Int4x2Base<Signed>::Unpack(
+                  unpacked,
+                  gsl::make_span(reinterpret_cast<const Int4x2Base<Signed>*>(packed.data()), packed.size())),
+              "Failed to unpack 4-bit initializer ", src_proto.name());
+
+  ONNX_NAMESPACE::TensorProto dst_proto;
+  dst_proto.set_name(graph.GenerateNodeArgName(src_proto.name() + "_int4_to_int8"));
+  dst_proto.set_data_type(Signed ? ONNX_NAMESPACE::TensorProto_DataType_INT8
+                                 : ONNX_NAMESPACE::TensorProto_DataType_UINT8);
+  dst_proto.mutable_dims()->CopyFrom(src_proto.dims());
+  utils::SetRawDataInTensorProto(dst_proto, unpacked.data(), unpacked.size() * sizeof(UnpackedType));
+  return graph_utils::AddInitializer(graph, dst_proto);
+}
+
+NodeArg& AddWidenedInitializer(Graph& graph, const NodeArg& arg) {
+  const auto& tensor_proto = *graph_utils::GetConstantInitializer(graph, arg.Name());
+  return tensor_proto.data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT4
+             ? AddWidenedInitializer<true>(graph, tensor_proto)
+             : AddWidenedInitializer<false>(graph, tensor_proto);
+}
+
+bool WidenInt4Weight(Graph& graph, Node& dq_node) {
+  auto& input_defs = dq_node.MutableInputDefs();
+  constexpr size_t weight_idx = 0;
+  constexpr size_t zp_idx = 2;
+  const bool has_zp = input_defs.size() > zp_idx && input_defs[zp_idx]->Exists();
+
+  if (!IsInt4Initializer(graph, *input_defs[weight_idx]) ||
+      (has_zp && !IsInt4Initializer(graph, *input_defs[zp_idx]))) {
+    return false;
+  }
+
+  // the 8-bit kernels only support per-tensor or per-channel quantization
+  const auto* block_size_attr = graph_utils::GetNodeAttribute(dq_node, "block_size");
+  if (block_size_attr != nullptr && block_size_attr->i() != 0) {
+    return false;
+  }
+
+  if (!IsConsumerWithInt8Kernel(graph, dq_node)) {
+    return false;
+  }
+
+  input_defs[weight_idx] = &AddWidenedInitializer(graph, *input_defs[weight_idx]);
+  if (has_zp) {
+    input_defs[zp_idx] = &AddWidenedInitializer(graph, *input_defs[zp_idx]);
+  }
+  return true;
+}
+
+}  // namespace
+
+Status QDQInt4WeightToInt8Transformer::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                                 const logging::Logger& logger) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr)
+      continue;  // node removed as part of an earlier fusion
+
+    Node& node = *node_ptr;
+    ORT_RETURN_IF_ERROR(Recurse(node, modified, graph_level, logger));
+
+    if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders()) ||
+        !QDQ::MatchDQNode(node)) {
+      continue;
+    }
+
+    modified |= WidenInt4Weight(graph, node);
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
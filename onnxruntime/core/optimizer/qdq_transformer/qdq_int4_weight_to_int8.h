@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Widen constant int4/uint4 weights of DequantizeLinear nodes feeding Conv or Gemm to int8/uint8
+ *
+ * QLinearConv and QGemm only have 8-bit kernels, so the QDQ selectors leave Conv and Gemm with 4-bit weights
+ * running in float on dequantized weights. Every 4-bit value is exactly representable in 8 bits, so converting the
+ * weight (and zero point) initializers of those DequantizeLinear nodes is lossless and lets
+ * @Class QDQSelectorActionTransformer fuse the node units into the 8-bit kernels.
+ *
+ * Blockwise quantized weights are skipped as the 8-bit kernels only support per-tensor or per-channel quantization.
+ */
+class QDQInt4WeightToInt8Transformer : public GraphTransformer {
+ public:
+  explicit QDQInt4WeightToInt8Transformer(
+      const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("QDQInt4WeightToInt8Transformer", compatible_execution_providers) {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
@@ -132,7 +132,10 @@ void UnaryOpQDQRules(SelectorActionRegistry& qdq_selector_action_registry) {
                                                           {"LeakyRelu", {}},
                                                           {"GlobalAveragePool", {}},
                                                           {"Sigmoid", {}},
-                                                          {"Softmax", {}}},
+                                                          {"Softmax", {}},
+                                                          {"Gelu", {}},
+                                                          {SelectorActionRegistry::OpVersionsMapKey("Gelu", kMSDomain),
+                                                           {}}},
                                                          std::move(selector),
                                                          std::move(action));
 #else
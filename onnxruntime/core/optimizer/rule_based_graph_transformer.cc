@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/optimizer/rule_based_graph_transformer.h"
+
+#include <algorithm>
+
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/rewrite_rule.h"
 
@@ -39,50 +42,133 @@ Status RuleBasedGraphTransformer::ApplyRulesOnNode(Graph& graph, Node& node,
   return Status::OK();
 }
 
-Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
-  GraphViewer graph_viewer(graph);
-  auto& order = graph_viewer.GetNodesInTopologicalOrder();
-
-  for (NodeIndex i : order) {
-    auto* node = graph.GetNode(i);
-    // A node might not be found as it might have already been deleted from one of the rules.
-    if (!node) {
-      continue;
+Status RuleBasedGraphTransformer::ApplyRulesOnNodeAndRecord(Graph& graph, Node& node, bool& modified,
+                                                            int graph_level,
+                                                            InlinedHashSet<NodeIndex>* modified_nodes,
+                                                            const logging::Logger& logger) const {
+  if (!graph_utils::IsSupportedProvider(node, GetCompatibleExecutionProviders())) {
+    return Status::OK();
+  }
+
+  // First apply rewrite rules that are registered for the op type of the current node; then apply rules that are
+  // registered to be applied regardless of the op type; then recursively apply rules to subgraphs (if any).
+  // Stop further rule application for the current node, if the node gets removed by a rule.
+  const auto* op_type_rules = GetRewriteRulesForOpType(node.OpType());
+  const auto* any_op_rules = GetAnyOpRewriteRules();
+
+  // The neighbors are captured before the rules are applied, as the node may be removed by them.
+  const NodeIndex node_index = node.Index();
+  InlinedVector<NodeIndex> neighbors;
+  if (modified_nodes && (op_type_rules || !any_op_rules->empty())) {
+    for (auto it = node.InputNodesBegin(), end = node.InputNodesEnd(); it != end; ++it) {
+      neighbors.push_back(it->Index());
     }
+    for (auto it = node.OutputNodesBegin(), end = node.OutputNodesEnd(); it != end; ++it) {
+      neighbors.push_back(it->Index());
+    }
+  }
 
-    // Initialize the effect of rules on this node to denote that the graph has not yet been modified
-    // by the rule application on the current node.
-    auto rule_effect = RuleEffect::kNone;
+  // Initialize the effect of rules on this node to denote that the graph has not yet been modified
+  // by the rule application on the current node.
+  auto rule_effect = RuleEffect::kNone;
 
-    if (!graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
-      continue;
-    }
+  if (op_type_rules) {
+    ORT_RETURN_IF_ERROR(ApplyRulesOnNode(graph, node, *op_type_rules, rule_effect, logger));
+  }
 
-    // First apply rewrite rules that are registered for the op type of the current node; then apply rules that are
-    // registered to be applied regardless of the op type; then recursively apply rules to subgraphs (if any).
-    // Stop further rule application for the current node, if the node gets removed by a rule.
-    const InlinedVector<std::reference_wrapper<const RewriteRule>>* rules = nullptr;
+  if (rule_effect != RuleEffect::kRemovedCurrentNode) {
+    ORT_RETURN_IF_ERROR(ApplyRulesOnNode(graph, node, *any_op_rules, rule_effect, logger));
+  }
 
-    rules = GetRewriteRulesForOpType(node->OpType());
-    if (rules) {
-      ORT_RETURN_IF_ERROR(ApplyRulesOnNode(graph, *node, *rules, rule_effect, logger));
+  // Update the modified field of the rule-based transformer.
+  if (rule_effect != RuleEffect::kNone) {
+    modified = true;
+    if (modified_nodes) {
+      modified_nodes->insert(neighbors.begin(), neighbors.end());
+      if (rule_effect != RuleEffect::kRemovedCurrentNode) {
+        modified_nodes->insert(node_index);
+      }
     }
+  }
 
-    if (rule_effect != RuleEffect::kRemovedCurrentNode) {
-      rules = GetAnyOpRewriteRules();
-      if (rules) {
-        ORT_RETURN_IF_ERROR(ApplyRulesOnNode(graph, *node, *rules, rule_effect, logger));
+  if (rule_effect != RuleEffect::kRemovedCurrentNode) {
+    bool subgraph_modified = false;
+    ORT_RETURN_IF_ERROR(Recurse(node, subgraph_modified, graph_level, logger));
+    if (subgraph_modified) {
+      modified = true;
+      if (modified_nodes) {
+        modified_nodes->insert(node_index);
       }
     }
+  }
 
-    // Update the modified field of the rule-based transformer.
-    if (rule_effect != RuleEffect::kNone) {
-      modified = true;
+  return Status::OK();
+}
+
+Status RuleBasedGraphTransformer::ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const {
+  // Only the passes on the main graph are incremental. A subgraph is visited in full whenever its node is visited.
+  const bool is_main_graph = graph_level == 0;
+  const bool incremental = is_main_graph && apply_incrementally_ && modified_nodes_graph_ == &graph;
+  apply_incrementally_ = false;
+
+  InlinedHashSet<NodeIndex>* modified_nodes = is_main_graph ? &modified_nodes_ : nullptr;
+  InlinedVector<NodeIndex> nodes_to_visit;
+  if (incremental) {
+    // Revisit the nodes modified or added by the previous pass, and their current neighbors. The rules are local
+    // to a node and its neighborhood, so the other nodes would not be changed by this pass either.
+    InlinedHashSet<NodeIndex> to_visit;
+    for (NodeIndex i : modified_nodes_) {
+      const auto* node = graph.GetNode(i);
+      if (!node) {
+        continue;
+      }
+      to_visit.insert(i);
+      for (auto it = node->InputNodesBegin(), end = node->InputNodesEnd(); it != end; ++it) {
+        to_visit.insert(it->Index());
+      }
+      for (auto it = node->OutputNodesBegin(), end = node->OutputNodesEnd(); it != end; ++it) {
+        to_visit.insert(it->Index());
+      }
+    }
+    nodes_to_visit.assign(to_visit.begin(), to_visit.end());
+    std::sort(nodes_to_visit.begin(), nodes_to_visit.end());
+  }
+
+  if (modified_nodes) {
+    modified_nodes_.clear();
+    modified_nodes_graph_ = nullptr;
+  }
+
+  const NodeIndex first_added_node_index = graph.MaxNodeIndex();
+  if (incremental) {
+    for (NodeIndex i : nodes_to_visit) {
+      auto* node = graph.GetNode(i);
+      // A node might not be found as it might have already been deleted from one of the rules.
+      if (node) {
+        ORT_RETURN_IF_ERROR(ApplyRulesOnNodeAndRecord(graph, *node, modified, graph_level, modified_nodes, logger));
+      }
+    }
+  } else {
+    GraphViewer graph_viewer(graph);
+    auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+    for (NodeIndex i : order) {
+      auto* node = graph.GetNode(i);
+      // A node might not be found as it might have already been deleted from one of the rules.
+      if (node) {
+        ORT_RETURN_IF_ERROR(ApplyRulesOnNodeAndRecord(graph, *node, modified, graph_level, modified_nodes, logger));
+      }
     }
+  }
 
-    if (rule_effect != RuleEffect::kRemovedCurrentNode) {
-      ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+  if (modified_nodes) {
+    // The nodes added by the rules were not visited in this pass.
+    for (NodeIndex i = first_added_node_index, end = graph.MaxNodeIndex(); i < end; ++i) {
+      if (graph.GetNode(i)) {
+        modified_nodes_.insert(i);
+      }
     }
+    modified_nodes_graph_ = &graph;
   }
 
   return Status::OK();
@@ -0,0 +1,253 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/tensor_parallel_partitioner.h"
+
+#include <optional>
+
+#include "core/graph/graph_utils.h"
+#include "core/optimizer/initializer.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+
+namespace {
+bool IsMatMul(const Node& node) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, "MatMul", {1, 9, 13});
+}
+
+// Elementwise nodes which only take the sharded value, or the sharded value and a bias along its last axis.
+bool IsActivation(const Node& node) {
+  static const InlinedHashSet<std::string_view> onnx_ops = {"Gelu", "Relu", "Sigmoid", "Tanh"};
+  static const InlinedHashSet<std::string_view> ms_ops = {"BiasGelu", "FastGelu", "Gelu", "QuickGelu"};
+
+  if (node.Domain() == kMSDomain) {
+    return ms_ops.count(node.OpType()) > 0;
+  }
+
+  return node.Domain() == kOnnxDomain && onnx_ops.count(node.OpType()) > 0;
+}
+
+bool IsShardableType(int32_t data_type) {
+  // the types of the AllReduce contrib op
+  return data_type == TensorProto_DataType_FLOAT || data_type == TensorProto_DataType_FLOAT16 ||
+         data_type == TensorProto_DataType_DOUBLE;
+}
+
+// A constant initializer of the given rank and type, whose dimension along the sharded axis is dim_value.
+const TensorProto* GetShardableWeight(const Graph& graph, const NodeArg& input, int rank, int64_t axis,
+                                      int64_t dim_value) {
+  const TensorProto* weight = graph_utils::GetConstantInitializer(graph, input.Name());
+  if (weight == nullptr || weight->dims_size() != rank || !IsShardableType(weight->data_type()) ||
+      weight->dims(static_cast<int>(axis)) != dim_value) {
+    return nullptr;
+  }
+
+  return weight;
+}
+
+// MatMul(X, W1) [-> Add(., B1)] -> activations -> MatMul(., W2).
+struct ShardableMlp {
+  Node* first_matmul = nullptr;
+  // the bias of the first MatMul, in an Add or in a BiasGelu or FastGelu activation
+  Node* bias_node = nullptr;
+  int bias_input_index = -1;
+  InlinedVector<Node*> activations;
+  Node* second_matmul = nullptr;
+};
+
+std::optional<ShardableMlp> MatchMlp(const Graph& graph, Node& matmul, int64_t world_size,
+                                     const InlinedHashSet<std::string_view>& compatible_providers) {
+  const TensorProto* w1 = graph_utils::GetConstantInitializer(graph, matmul.InputDefs()[1]->Name());
+  if (w1 == nullptr || w1->dims_size() != 2 || !IsShardableType(w1->data_type())) {
+    return std::nullopt;
+  }
+
+  const int64_t hidden_size = w1->dims(1);
+  if (hidden_size < world_size || hidden_size % world_size != 0) {
+    return std::nullopt;
+  }
+
+  ShardableMlp mlp;
+  mlp.first_matmul = &matmul;
+  Node* node = &matmul;
+  while (true) {
+    const NodeArg& value = *node->OutputDefs()[0];
+    if (node->OutputDefs().size() != 1 || node->GetOutputEdgesCount() != 1 || graph.NodeProducesGraphOutput(*node)) {
+      return std::nullopt;
+    }
+
+    Node& next = *graph.GetNode(node->OutputNodesBegin()->Index());
+    if (next.GetExecutionProviderType() != matmul.GetExecutionProviderType() ||
+        !graph_utils::IsSupportedProvider(next, compatible_providers) || next.InputDefs()[0] != &value) {
+      return std::nullopt;
+    }
+
+    if (IsMatMul(next)) {
+      const TensorProto* w2 = GetShardableWeight(graph, *next.InputDefs()[1], 2, 0, hidden_size);
+      if (mlp.activations.empty() || w2 == nullptr) {
+        return std::nullopt;
+      }
+
+      mlp.second_matmul = &next;
+      return mlp;
+    }
+
+    const bool is_bias_add = graph_utils::IsSupportedOptypeVersionAndDomain(next, "Add", {7, 13, 14}) &&
+                             node == &matmul;
+    if (!is_bias_add && !IsActivation(next)) {
+      return std::nullopt;
+    }
+
+    // the bias is sharded with the columns of W1
+    if (next.InputDefs().size() > 1 && next.InputDefs()[1]->Exists()) {
+      if (mlp.bias_node != nullptr || next.InputDefs().size() > 2 ||
+          GetShardableWeight(graph, *next.InputDefs()[1], 1, 0, hidden_size) == nullptr) {
+        return std::nullopt;
+      }
+
+      mlp.bias_node = &next;
+      mlp.bias_input_index = 1;
+    } else if (is_bias_add) {
+      return std::nullopt;
+    }
+
+    if (!is_bias_add) {
+      mlp.activations.push_back(&next);
+    }
+    node = &next;
+  }
+}
+
+// Add the shard of the constant initializer along the given axis for the given rank.
+NodeArg& AddShardInitializer(Graph& graph, const NodeArg& input, int64_t axis, int64_t rank, int64_t world_size) {
+  const TensorProto& tensor_proto = *graph_utils::GetConstantInitializer(graph, input.Name());
+  Initializer initializer{tensor_proto, graph.ModelPath()};
+  const auto dims = initializer.dims();
+  const auto bytes = initializer.DataAsByteSpan();
+  const size_t element_size = bytes.size() / initializer.size();
+
+  size_t outer_size = 1;
+  for (int64_t i = 0; i < axis; ++i) {
+    outer_size *= narrow<size_t>(dims[narrow<size_t>(i)]);
+  }
+  size_t inner_size = element_size;
+  for (size_t i = narrow<size_t>(axis) + 1; i < dims.size(); ++i) {
+    inner_size *= narrow<size_t>(dims[i]);
+  }
+  const size_t axis_size = narrow<size_t>(dims[narrow<size_t>(axis)]);
+  const size_t shard_size = axis_size / narrow<size_t>(world_size);
+
+  std::string shard_data;
+  shard_data.reserve(outer_size * shard_size * inner_size);
+  for (size_t i = 0; i < outer_size; ++i) {
+    const auto* block = bytes.data() + (i * axis_size + narrow<size_t>(rank) * shard_size) * inner_size;
+    shard_data.append(reinterpret_cast<const char*>(block), shard_size * inner_size);
+  }
+
+  TensorProto shard;
+  shard.set_name(graph.GenerateNodeArgName(input.Name() + "_shard"));
+  shard.set_data_type(tensor_proto.data_type());
+  for (size_t i = 0; i < dims.size(); ++i) {
+    shard.add_dims(i == narrow<size_t>(axis) ? narrow<int64_t>(shard_size) : dims[i]);
+  }
+  utils::SetRawDataInTensorProto(shard, std::move(shard_data));
+  return graph_utils::AddInitializer(graph, shard);
+}
+
+// The sharded intermediate values have 1/world_size of the last dimension.
+void ShardLastDimension(NodeArg& value, int64_t world_size) {
+  const auto* shape = value.Shape();
+  if (shape == nullptr || shape->dim_size() == 0) {
+    return;
+  }
+
+  TensorShapeProto shard_shape = *shape;
+  auto* last_dim = shard_shape.mutable_dim(shard_shape.dim_size() - 1);
+  if (utils::HasDimValue(*last_dim)) {
+    last_dim->set_dim_value(last_dim->dim_value() / world_size);
+    value.SetShape(shard_shape);
+  } else {
+    value.ClearShape();
+  }
+}
+
+void ShardMlp(Graph& graph, const ShardableMlp& mlp, int64_t rank, int64_t world_size) {
+  Node& first = *mlp.first_matmul;
+  Node& second = *mlp.second_matmul;
+
+  graph_utils::ReplaceNodeInput(first, 1, AddShardInitializer(graph, *first.InputDefs()[1], 1, rank, world_size));
+  if (mlp.bias_node != nullptr) {
+    NodeArg& bias = *mlp.bias_node->MutableInputDefs()[mlp.bias_input_index];
+    graph_utils::ReplaceNodeInput(*mlp.bias_node, mlp.bias_input_index,
+                                  AddShardInitializer(graph, bias, 0, rank, world_size));
+  }
+  graph_utils::ReplaceNodeInput(second, 1, AddShardInitializer(graph, *second.InputDefs()[1], 0, rank, world_size));
+
+  ShardLastDimension(*first.MutableOutputDefs()[0], world_size);
+  if (mlp.bias_node != nullptr) {
+    ShardLastDimension(*mlp.bias_node->MutableOutputDefs()[0], world_size);
+  }
+  for (Node* activation : mlp.activations) {
+    ShardLastDimension(*activation->MutableOutputDefs()[0], world_size);
+  }
+
+  // the second MatMul computes a partial sum, which the AllReduce adds up into the original output
+  NodeArg& output = *second.MutableOutputDefs()[0];
+  NodeArg& partial_sum = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output.Name() + "_partial"),
+                                                  output.TypeAsProto());
+  const auto output_edges = graph_utils::GraphEdge::GetNodeOutputEdges(second);
+  graph_utils::GraphEdge::RemoveGraphEdges(graph, output_edges);
+  second.MutableOutputDefs()[0] = &partial_sum;
+
+  Node& all_reduce = graph.AddNode(graph.GenerateNodeName("TensorParallelPartitioner/AllReduce"), "AllReduce",
+                                   "Add the partial sums of the tensor-parallel ranks", std::array{&partial_sum},
+                                   std::array{&output}, nullptr, kMSDomain);
+  all_reduce.SetExecutionProviderType(second.GetExecutionProviderType());
+  graph.AddEdge(second.Index(), all_reduce.Index(), 0, 0);
+  for (const auto& edge : output_edges) {
+    graph.AddEdge(all_reduce.Index(), edge.dst_node, 0, edge.dst_arg_index);
+  }
+}
+}  // namespace
+
+Status TensorParallelPartitioner::ApplyImpl(Graph& graph, bool& modified, int graph_level,
+                                            const logging::Logger& logger) const {
+  if (world_size_ < 2 || rank_ < 0 || rank_ >= world_size_) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& order = graph_viewer.GetNodesInTopologicalOrder();
+
+  InlinedHashSet<NodeIndex> sharded_nodes;
+  for (auto node_index : order) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr) {
+      continue;
+    }
+
+    ORT_RETURN_IF_ERROR(Recurse(*node, modified, graph_level, logger));
+
+    if (sharded_nodes.count(node_index) > 0 || !IsMatMul(*node) ||
+        !graph_utils::IsSupportedProvider(*node, GetCompatibleExecutionProviders())) {
+      continue;
+    }
+
+    const auto mlp = MatchMlp(graph, *node, world_size_, GetCompatibleExecutionProviders());
+    if (!mlp.has_value()) {
+      continue;
+    }
+
+    sharded_nodes.insert(mlp->second_matmul->Index());
+    LOGS(logger, VERBOSE) << "TensorParallelPartitioner: sharding the MLP from " << node->Name() << " to "
+                          << mlp->second_matmul->Name() << " for rank " << rank_ << " of " << world_size_;
+    ShardMlp(graph, *mlp, rank_, world_size_);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,37 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class TensorParallelPartitioner
+Shard the MLP blocks of an unsharded model for one rank of a tensor-parallel group, Megatron-style, so that every
+rank runs the same model with 1/world_size of the MLP weights.
+
+MatMul(X, W1) [-> Add(., B1)] -> unary activations -> MatMul(., W2), with constant 2-D weights, becomes
+MatMul(X, W1[:, shard]) [-> Add(., B1[shard])] -> activations -> MatMul(., W2[shard, :]) -> AllReduce, i.e. W1 and
+its bias are split along their columns and W2 along its rows, and the partial sums of the ranks are added by the
+NCCL AllReduce contrib op. The last dimension of W1 must be a multiple of world_size.
+*/
+class TensorParallelPartitioner : public GraphTransformer {
+ public:
+  TensorParallelPartitioner(int64_t rank, int64_t world_size,
+                            const InlinedHashSet<std::string_view>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("TensorParallelPartitioner", compatible_execution_providers),
+        rank_(rank),
+        world_size_(world_size) {}
+
+  bool ShouldOnlyApplyOnce() const override { return true; }
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+
+  const int64_t rank_;
+  const int64_t world_size_;
+};
+
+}  // namespace onnxruntime
@@ -1177,6 +1177,9 @@ void TransposeOutputs(OptimizerCtx& ctx, api::NodeRef& node, const std::vector<i
 //
 // A rank of 5 is used if rank cannot be determined since 5 is the largest rank we expect from something like a Conv
 // and an unknown rank likely corresponds to a data-carrying (non-weight) tensor, which will be large.
+//
+// When the shapes of all the values involved in a cost comparison are known, the number of bytes transposed is used
+// instead, so a large tensor isn't transposed to avoid a transpose of a smaller one with more non-trivial dimensions.
 
 // Given a value, returns the rank of the value excluding dimensions of value 1. Returns 5 if the rank is unknown.
 static int EstimateValueRank(const api::GraphRef& graph, std::string_view input) {
@@ -1194,17 +1197,79 @@ static int EstimateValueRank(const api::GraphRef& graph, std::string_view input)
   return rank;
 }
 
+// Given a value, returns the number of bytes of the value. Returns nullopt if the shape isn't fully known.
+static std::optional<int64_t> EstimateValueBytes(const api::GraphRef& graph, std::string_view input) {
+  auto value_info = graph.GetValueInfo(input);
+  std::optional<std::vector<int64_t>> shape = value_info->Shape();
+  if (shape == std::nullopt) {
+    return std::nullopt;
+  }
+
+  int64_t bytes;
+  switch (value_info->DType()) {
+    case api::DataType::UINT8:
+    case api::DataType::INT8:
+    case api::DataType::BOOL:
+    case api::DataType::FLOAT8E4M3FN:
+    case api::DataType::FLOAT8E4M3FNUZ:
+    case api::DataType::FLOAT8E5M2:
+    case api::DataType::FLOAT8E5M2FNUZ:
+      bytes = 1;
+      break;
+    case api::DataType::UINT16:
+    case api::DataType::INT16:
+    case api::DataType::FLOAT16:
+    case api::DataType::BFLOAT16:
+      bytes = 2;
+      break;
+    case api::DataType::INT64:
+    case api::DataType::UINT64:
+    case api::DataType::DOUBLE:
+    case api::DataType::COMPLEX64:
+      bytes = 8;
+      break;
+    case api::DataType::COMPLEX128:
+      bytes = 16;
+      break;
+    default:
+      bytes = 4;
+      break;
+  }
+
+  for (int64_t d : *shape) {
+    if (d < 0) {
+      return std::nullopt;
+    }
+    bytes *= d;
+  }
+
+  return bytes;
+}
+
+// Estimates the cost of transposing a value: the number of bytes if `use_bytes` is set, otherwise the rank.
+static int64_t EstimateValueCost(const api::GraphRef& graph, std::string_view input, bool use_bytes) {
+  if (use_bytes) {
+    std::optional<int64_t> bytes = EstimateValueBytes(graph, input);
+    if (bytes != std::nullopt) {
+      return *bytes;
+    }
+  }
+
+  return EstimateValueRank(graph, input);
+}
+
 static const HandlerInfo* GetHandler(api::NodeRef& node, const HandlerMap& extended_handlers);
+static bool CanModifyNode(const OptimizerCtx& ctx, const api::NodeRef& node);
 
 // Returns true if the provided transpose node is only consumed by nodes we can likely push it through.
-static bool CanLikelyRemoveTranspose(const api::GraphRef& graph, api::NodeRef& transpose,
-                                     const HandlerMap& extended_handlers) {
-  auto consumers = graph.GetValueConsumers(transpose.Outputs()[0]);
+// A consumer assigned to another EP can't be modified, so a Transpose before it stays at the EP boundary.
+static bool CanLikelyRemoveTranspose(const OptimizerCtx& ctx, api::NodeRef& transpose) {
+  auto consumers = ctx.graph.GetValueConsumers(transpose.Outputs()[0]);
   if (!consumers->comprehensive) {
     return false;
   }
   for (auto& node : consumers->nodes) {
-    if (GetHandler(*node, extended_handlers) == nullptr) {
+    if (GetHandler(*node, ctx.extended_handlers) == nullptr || !CanModifyNode(ctx, *node)) {
       return false;
     }
   }
@@ -1245,10 +1310,12 @@ static bool IsConstant(const api::GraphRef& graph, std::string_view value_name)
   return false;
 }
 
-// Estimates the cost of transposing an input. Currently uses rank heuristic. Negative if transpose is removed.
-// Feel free to improve as needed.
-static int EstimateTransposeValueCost(const api::GraphRef& graph, std::string_view input,
-                                      const std::vector<int64_t>& perm_inv, const HandlerMap& extended_handlers) {
+// Estimates the cost of transposing an input. Uses the number of bytes if `use_bytes` is set, otherwise the rank
+// heuristic. Negative if transpose is removed.
+static int64_t EstimateTransposeValueCost(const OptimizerCtx& ctx, std::string_view input,
+                                          const std::vector<int64_t>& perm_inv, bool use_bytes) {
+  const api::GraphRef& graph = ctx.graph;
+
   // Case 1: Transposing constants probably costs nothing.
   if (IsConstant(graph, input)) {
     return 0;
@@ -1292,8 +1359,8 @@ static int EstimateTransposeValueCost(const api::GraphRef& graph, std::string_vi
     if (producer_node->IsOp("Transpose")) {
       std::optional<std::vector<int64_t>> perm2 = GetPermAttrIfValid(*producer_node);
       if (perm2 != std::nullopt) {
-        if (*perm2 == perm_inv && CanLikelyRemoveTranspose(graph, *producer_node, extended_handlers)) {
-          return -EstimateValueRank(graph, input);
+        if (*perm2 == perm_inv && CanLikelyRemoveTranspose(ctx, *producer_node)) {
+          return -EstimateValueCost(graph, input, use_bytes);
         } else {
           return 0;
         }
@@ -1301,18 +1368,17 @@ static int EstimateTransposeValueCost(const api::GraphRef& graph, std::string_vi
     }
   }
   // Case 3: We will likely need to add a transpose.
-  return EstimateValueRank(graph, input);
+  return EstimateValueCost(graph, input, use_bytes);
 }
 
 // Estimates total cost of transposing a node's inputs. Negative if transposing is beneficial.
-static int EstimateTransposeInputsCost(const api::GraphRef& graph, const api::NodeRef& node,
-                                       const std::vector<int64_t>& perm_inv,
-                                       const std::vector<size_t>& input_indices,
-                                       const HandlerMap& extended_handlers) {
+static int64_t EstimateTransposeInputsCost(const OptimizerCtx& ctx, const api::NodeRef& node,
+                                           const std::vector<int64_t>& perm_inv,
+                                           const std::vector<size_t>& input_indices, bool use_bytes) {
   auto inputs = node.Inputs();
-  int cost = 0;
+  int64_t cost = 0;
   for (size_t j : input_indices) {
-    cost += EstimateTransposeValueCost(graph, inputs[j], perm_inv, extended_handlers);
+    cost += EstimateTransposeValueCost(ctx, inputs[j], perm_inv, use_bytes);
   }
 
   return cost;
@@ -2378,27 +2444,39 @@ static const HandlerInfo* GetHandler(api::NodeRef& node, const HandlerMap& exten
   return nullptr;
 }
 
-static int CalculateCost(const api::GraphRef& graph, const api::NodeRef& node,
-                         const std::vector<int64_t>& perm,
-                         const std::unordered_set<std::string>& outputs_leading_to_transpose,
-                         const HandlerInfo& info,
-                         const std::vector<size_t>& input_indices,
-                         const HandlerMap& extended_handlers) {
+static int64_t CalculateCost(const OptimizerCtx& ctx, const api::NodeRef& node,
+                             const std::vector<int64_t>& perm,
+                             const std::unordered_set<std::string>& outputs_leading_to_transpose,
+                             const HandlerInfo& info,
+                             const std::vector<size_t>& input_indices) {
+  const api::GraphRef& graph = ctx.graph;
+
+  // Costs can only be compared in bytes if the sizes of all the inputs and outputs involved are known.
+  auto inputs = node.Inputs();
+  auto outputs = node.Outputs();
+  bool use_bytes = std::all_of(input_indices.begin(), input_indices.end(), [&](size_t j) {
+    return EstimateValueBytes(graph, inputs[j]) != std::nullopt;
+  });
+  if (info.transposes_outputs) {
+    use_bytes = use_bytes && std::all_of(outputs.begin(), outputs.end(), [&](std::string_view out) {
+                  return EstimateValueBytes(graph, out) != std::nullopt;
+                });
+  }
+
   // We require the input cost (number of transposes before the op) and the total cost to strictly decrease.
   // Strict decrease of the input cost ensures the optimization is stable, since the total cost decrease is just an
   // estimate (the transpose after the op may or may not cancel with a subsequent transpose). We don't want
   // repeated runs of the optimizer to have a transpose toggle between two inputs of a binary op.
-  int cost = EstimateTransposeInputsCost(graph, node, perm, input_indices, extended_handlers);
+  int64_t cost = EstimateTransposeInputsCost(ctx, node, perm, input_indices, use_bytes);
 
   if (cost < 0 && info.transposes_outputs) {
     // If the output will be transposed and won't ultimately cancel, factor in that cost.
     bool has_output_leading_to_transpose = false;
-    auto outputs = node.Outputs();
-    int out_cost = 0;
+    int64_t out_cost = 0;
     // Having multiple outputs is rare. When it happens (Split), the total size of the outputs isn't much larger
-    // than the largest input. Cost is rank currently, so just use the largest cost (rank) over all outputs.
+    // than the largest input, so just use the largest cost over all outputs.
     for (auto out : outputs) {
-      out_cost = std::max(out_cost, EstimateValueRank(graph, out));
+      out_cost = std::max(out_cost, EstimateValueCost(graph, out, use_bytes));
       if (outputs_leading_to_transpose.find(std::string(out)) != outputs_leading_to_transpose.end()) {
         has_output_leading_to_transpose = true;
       }
@@ -2413,18 +2491,16 @@ static int CalculateCost(const api::GraphRef& graph, const api::NodeRef& node,
 }
 
 // Default cost check. Returns `true` if pushing the Transpose through the node is considered to be beneficial.
-static bool DefaultCostCheck(const api::GraphRef& graph, const api::NodeRef& node,
+static bool DefaultCostCheck(const OptimizerCtx& ctx, const api::NodeRef& node,
                              const std::vector<int64_t>& perm,
                              const std::unordered_set<std::string>& outputs_leading_to_transpose,
                              const HandlerInfo& info,
-                             const std::vector<size_t> transposable_input_indices,
-                             const HandlerMap& extended_handlers) {
+                             const std::vector<size_t> transposable_input_indices) {
   if (node.IsOp("Transpose")) {
     return true;
   }
 
-  int cost = CalculateCost(graph, node, perm, outputs_leading_to_transpose, info, transposable_input_indices,
-                           extended_handlers);
+  int64_t cost = CalculateCost(ctx, node, perm, outputs_leading_to_transpose, info, transposable_input_indices);
   return cost < 0;
 }
 
@@ -2450,8 +2526,7 @@ bool ProcessTranspose(OptimizerCtx& ctx, api::NodeRef& transpose, api::NodeRef&
   }
 
   if (cost == CostCheckResult::kFallThrough) {
-    cost = DefaultCostCheck(ctx.graph, node, perm, outputs_leading_to_transpose, *info, input_indices,
-                            ctx.extended_handlers)
+    cost = DefaultCostCheck(ctx, node, perm, outputs_leading_to_transpose, *info, input_indices)
                ? CostCheckResult::kPushTranspose
                : CostCheckResult::kStop;
   }
@@ -2869,9 +2944,14 @@ OptimizeResult OptimizeImpl(OptimizerCtx& ctx) {
   std::unordered_set<std::string> outputs_leading_to_transpose;
 
   // First iterate over sorted nodes in reverse order to find which outputs have paths through supported ops to
-  // transpose nodes. We pull push transposes towards these outputs.
+  // transpose nodes. We pull push transposes towards these outputs. Nodes that can't be modified, e.g. nodes assigned
+  // to another EP, are skipped as a transpose can't be pushed through them or cancel with them.
   for (size_t i = 0; i < nodes.size(); ++i) {
     api::NodeRef& node = *nodes[nodes.size() - i - 1];
+    if (!CanModifyNode(ctx, node)) {
+      continue;
+    }
+
     if (node.IsOp("Transpose")) {
       outputs_leading_to_transpose.insert(std::string(node.Inputs()[0]));
       continue;
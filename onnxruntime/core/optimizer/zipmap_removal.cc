@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/zipmap_removal.h"
+
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Tests if the ZipMap input can be renamed to its output, i.e. it is produced by a node, ZipMap is its only consumer
+// and it is not a graph output itself.
+bool CanRenameInput(const Graph& graph, const Node& zipmap, int& src_arg_index) {
+  const Node* input_node = graph_utils::GetInputNode(zipmap, 0);
+  if (input_node == nullptr) {
+    return false;
+  }
+
+  src_arg_index = graph_utils::GetNodeOutputIndexFromOutputName(*input_node, zipmap.InputDefs()[0]->Name());
+  if (graph.IsOutput(input_node->OutputDefs()[src_arg_index])) {
+    return false;
+  }
+
+  for (auto it = input_node->OutputEdgesBegin(), end = input_node->OutputEdgesEnd(); it != end; ++it) {
+    if (it->GetSrcArgIndex() == src_arg_index && it->GetNode().Index() != zipmap.Index()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Status ZipMapRemoval::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                const logging::Logger& /*logger*/) const {
+  // the outputs of a subgraph must keep the types the node owning it expects
+  if (graph.IsSubgraph()) {
+    return Status::OK();
+  }
+
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  for (auto node_index : node_topology_list) {
+    auto* node_ptr = graph.GetNode(node_index);
+    if (node_ptr == nullptr)
+      continue;  // node was removed
+
+    Node& zipmap = *node_ptr;
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(zipmap, "ZipMap", {1}, kMLDomain) ||
+        zipmap.GetOutputEdgesCount() != 0 || !graph.NodeProducesGraphOutput(zipmap)) {
+      continue;
+    }
+
+    NodeArg& input = *zipmap.MutableInputDefs()[0];
+    NodeArg& output = *zipmap.MutableOutputDefs()[0];
+    if (input.TypeAsProto() == nullptr) {
+      continue;
+    }
+
+    const auto execution_provider = zipmap.GetExecutionProviderType();
+    graph.SetNodeArgType(output, *input.TypeAsProto());
+
+    int src_arg_index = 0;
+    if (CanRenameInput(graph, zipmap, src_arg_index)) {
+      // the producer of the probabilities writes the graph output directly
+      Node& input_node = *graph.GetNode(graph_utils::GetInputNode(zipmap, 0)->Index());
+      graph.RemoveNode(zipmap.Index());
+      input_node.MutableOutputDefs()[src_arg_index] = &output;
+    } else {
+      const std::string name = zipmap.Name();
+      graph.RemoveNode(zipmap.Index());
+      Node& identity = graph.AddNode(graph.GenerateNodeName(name + "_identity"), "Identity",
+                                     "Replaces the ZipMap of " + name, {&input}, {&output});
+      identity.SetExecutionProviderType(execution_provider);
+    }
+
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
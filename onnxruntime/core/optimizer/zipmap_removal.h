@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class ZipMapRemoval
+
+Removes the ZipMap nodes that produce a graph output, so that the output is the tensor(float) of probabilities of
+the classifier instead of a seq(map(string|int64, float)) with one std::map per row. The output keeps its name and
+the columns are in the order of the classlabels_strings or classlabels_int64s attribute of the ZipMap.
+
+This changes the type of the graph outputs, so it only applies to the main graph and must be explicitly enabled.
+*/
+class ZipMapRemoval : public GraphTransformer {
+ public:
+  ZipMapRemoval() noexcept : GraphTransformer("ZipMapRemoval") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
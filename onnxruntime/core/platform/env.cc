@@ -34,6 +34,14 @@ std::ostream& operator<<(std::ostream& os, gsl::span<const LogicalProcessors> af
 
 Env::Env() = default;
 
+std::vector<LogicalProcessors> Env::GetNumaNodeProcessors() const {
+  return {};
+}
+
+common::Status Env::BindMemoryToNumaNode(void* /*p*/, size_t /*size*/, int /*numa_node*/) const {
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Binding memory to a NUMA node is not supported on this platform.");
+}
+
 std::pair<int, std::string> GetErrnoInfo() {
   auto err = errno;
   std::string msg;
@@ -87,6 +87,9 @@ struct ThreadOptions {
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
 
+  // Adapt how long the threads spin for work to their recent waits, when the pool allows spinning.
+  bool adaptive_spinning = false;
+
   OrtCustomCreateThreadFn custom_create_thread_fn = nullptr;
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
@@ -149,6 +152,18 @@ class Env {
 
   virtual int GetL2CacheSize() const = 0;
 
+  /// <summary>
+  /// The API returns the logical processors of each NUMA node on the system, indexed by node id
+  /// </summary>
+  /// <returns>Logical processors per NUMA node, or an empty vector if the topology is unknown</returns>
+  virtual std::vector<LogicalProcessors> GetNumaNodeProcessors() const;
+
+  /// <summary>
+  /// Sets the preferred NUMA node for the pages backing [p, p + size), including pages that have
+  /// already been touched.  Only whole pages within the range are affected.
+  /// </summary>
+  virtual common::Status BindMemoryToNumaNode(void* p, size_t size, int numa_node) const;
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -183,8 +198,9 @@ class Env {
 
   /**
    * Maps the content of the file into memory.
-   * This is a copy-on-write mapping, so any changes are not written to the
-   * actual file.
+   * This is a read-only shared mapping, so the pages are backed by the page
+   * cache and shared by all processes mapping the same file. Writing to the
+   * mapped memory is not allowed.
    * @param file_path The path to the file.
    * @param offset The file offset from which to start the mapping.
    * @param length The length in bytes of the mapping.
@@ -194,6 +210,22 @@ class Env {
   virtual common::Status MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                                            MappedMemoryPtr& mapped_memory) const = 0;
 
+  /**
+   * Hints that a range of the file will be read soon, so that the OS can start
+   * reading it into the page cache asynchronously. Returns without waiting for
+   * the data. This is a no-op on platforms that do not support it.
+   * @param file_path The path to the file.
+   * @param offset The file offset of the range.
+   * @param length The length in bytes of the range.
+   */
+  virtual common::Status PrefetchFile(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset,
+                                      size_t length) const {
+    ORT_UNUSED_PARAMETER(file_path);
+    ORT_UNUSED_PARAMETER(offset);
+    ORT_UNUSED_PARAMETER(length);
+    return common::Status::OK();
+  }
+
 #ifdef _WIN32
   /// \brief Returns true if the directory exists.
   virtual bool FolderExists(const std::wstring& path) const = 0;
@@ -31,7 +31,10 @@ limitations under the License.
 #endif
 #include <unistd.h>
 
+#include <climits>
+#include <fstream>
 #include <iostream>
+#include <limits>
 #include <optional>
 #include <thread>
 #include <utility>  // for std::forward
@@ -62,6 +65,30 @@ namespace {
 
 constexpr int OneMillion = 1000000;
 
+#if defined(__linux__) && !defined(__ANDROID__)
+// Parse a sysfs id list such as "0-3,8,10-11", as used by /sys/devices/system/node.
+// Returns an empty list if the file cannot be read.
+LogicalProcessors ReadSysfsIdList(const std::string& path) {
+  LogicalProcessors ids;
+  std::ifstream file(path);
+  std::string range;
+  while (std::getline(file, range, ',')) {
+    int from = 0;
+    int to = 0;
+    int matched = sscanf(range.c_str(), "%d-%d", &from, &to);
+    if (matched == 1) {
+      to = from;
+    } else if (matched != 2 || from > to) {
+      continue;
+    }
+    for (int id = from; id <= to; ++id) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+#endif
+
 class UnmapFileParam {
  public:
   void* addr;
@@ -324,6 +351,48 @@ class PosixEnv : public Env {
 #endif
   }
 
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override {
+    std::vector<LogicalProcessors> ret;
+#if defined(__linux__) && !defined(__ANDROID__)
+    for (int node : ReadSysfsIdList("/sys/devices/system/node/online")) {
+      if (static_cast<size_t>(node) >= ret.size()) {
+        ret.resize(static_cast<size_t>(node) + 1);
+      }
+      ret[node] = ReadSysfsIdList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+    }
+#endif
+    return ret;
+  }
+
+  common::Status BindMemoryToNumaNode(void* p, size_t size, int numa_node) const override {
+#if defined(__linux__) && !defined(__ANDROID__) && defined(SYS_mbind)
+    ORT_RETURN_IF(numa_node < 0, "Invalid NUMA node: ", numa_node);
+    // mbind() works on whole pages, so shrink the range to the pages that lie entirely within it.
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(p) + page_size - 1) & ~(page_size - 1);
+    const auto end = (reinterpret_cast<uintptr_t>(p) + size) & ~(page_size - 1);
+    if (end <= begin) {
+      return Status::OK();
+    }
+
+    // Values from <numaif.h>, which we do not depend on.
+    constexpr int kMpolPreferred = 1;
+    constexpr unsigned kMpolMfMove = 1 << 1;
+    constexpr size_t kBitsPerMaskWord = sizeof(unsigned long) * CHAR_BIT;
+    std::vector<unsigned long> node_mask(static_cast<size_t>(numa_node) / kBitsPerMaskWord + 1, 0);
+    node_mask[numa_node / kBitsPerMaskWord] = 1UL << (numa_node % kBitsPerMaskWord);
+    if (syscall(SYS_mbind, begin, end - begin, kMpolPreferred, node_mask.data(),
+                node_mask.size() * kBitsPerMaskWord + 1, kMpolMfMove) != 0) {
+      auto [err_no, err_msg] = GetErrnoInfo();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "mbind failed for NUMA node ", numa_node,
+                             ", error code: ", err_no, " error msg: ", err_msg);
+    }
+    return Status::OK();
+#else
+    return Env::BindMemoryToNumaNode(p, size, numa_node);
+#endif
+  }
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
@@ -443,7 +512,7 @@ class PosixEnv : public Env {
     const size_t mapped_length = length + static_cast<size_t>(offset_to_page);
     const FileOffsetType mapped_offset = offset - offset_to_page;
     void* const mapped_base =
-        mmap(nullptr, mapped_length, PROT_READ | PROT_WRITE, MAP_PRIVATE, file_descriptor.Get(), mapped_offset);
+        mmap(nullptr, mapped_length, PROT_READ, MAP_SHARED, file_descriptor.Get(), mapped_offset);
 
     if (mapped_base == MAP_FAILED) {
       return ReportSystemError("mmap", file_path);
@@ -456,6 +525,38 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  Status PrefetchFile(const ORTCHAR_T* file_path, FileOffsetType offset, size_t length) const override {
+    ORT_RETURN_IF_NOT(file_path, "file_path == nullptr");
+    ORT_RETURN_IF_NOT(offset >= 0, "offset < 0");
+
+    ScopedFileDescriptor file_descriptor{open(file_path, O_RDONLY)};
+    if (!file_descriptor.IsValid()) {
+      return ReportSystemError("open", file_path);
+    }
+
+    if (length == 0) {
+      return Status::OK();
+    }
+
+#if defined(__linux__)
+    // the read ahead is queued by the kernel and continues after the file is closed
+    const int err_no = posix_fadvise(file_descriptor.Get(), offset, static_cast<off_t>(length), POSIX_FADV_WILLNEED);
+    if (err_no != 0) {
+      errno = err_no;
+      return ReportSystemError("posix_fadvise", file_path);
+    }
+#elif defined(__APPLE__)
+    struct radvisory advisory;
+    advisory.ra_offset = offset;
+    advisory.ra_count = narrow<int>(std::min<size_t>(length, std::numeric_limits<int>::max()));
+    if (fcntl(file_descriptor.Get(), F_RDADVISE, &advisory) == -1) {
+      return ReportSystemError("fcntl", file_path);
+    }
+#endif
+
+    return Status::OK();
+  }
+
   static common::Status ReportSystemError(const char* operation_name, const std::string& path) {
     auto [err_no, err_msg] = GetErrnoInfo();
     std::ostringstream oss;
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "core/platform/windows/env.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <optional>
@@ -307,6 +308,47 @@ int WindowsEnv::GetL2CacheSize() const {
   return l2_cache_size_;
 }
 
+std::vector<LogicalProcessors> WindowsEnv::GetNumaNodeProcessors() const {
+  std::vector<LogicalProcessors> ret;
+  DWORD returnLength = 0;
+  GetLogicalProcessorInformationEx(RelationNumaNode, nullptr, &returnLength);
+  if (GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+    return ret;
+  }
+
+  std::unique_ptr<char[]> allocation = std::make_unique<char[]>(returnLength);
+  SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* processorInfos = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(allocation.get());
+  if (!GetLogicalProcessorInformationEx(RelationNumaNode, processorInfos, &returnLength)) {
+    return ret;
+  }
+
+  const BYTE* iter = reinterpret_cast<const BYTE*>(processorInfos);
+  const BYTE* end = iter + returnLength;
+  while (iter < end) {
+    auto processor_info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(iter);
+    if (processor_info->Relationship == RelationNumaNode) {
+      const auto node = static_cast<size_t>(processor_info->NumaNode.NodeNumber);
+      if (node >= ret.size()) {
+        ret.resize(node + 1);
+      }
+      // Translate the node's group-local mask into the global processor ids used by the ort API.
+      constexpr KAFFINITY bit = 1;
+      const auto& group_mask = processor_info->NumaNode.GroupMask;
+      for (const auto& [global_processor_id, info] : global_processor_info_map_) {
+        if (info.group_id == static_cast<int>(group_mask.Group) &&
+            (group_mask.Mask & (bit << info.local_processor_id))) {
+          ret[node].push_back(global_processor_id);
+        }
+      }
+    }
+    iter += processor_info->Size;
+  }
+  for (auto& node_processors : ret) {
+    std::sort(node_processors.begin(), node_processors.end());
+  }
+  return ret;
+}
+
 WindowsEnv& WindowsEnv::Instance() {
   static WindowsEnv default_env;
   return default_env;
@@ -56,6 +56,7 @@ class WindowsEnv : public Env {
   int GetNumPhysicalCpuCores() const override;
   std::vector<LogicalProcessors> GetDefaultThreadAffinities() const override;
   int GetL2CacheSize() const override;
+  std::vector<LogicalProcessors> GetNumaNodeProcessors() const override;
   static WindowsEnv& Instance();
   PIDType GetSelfPid() const override;
   Status GetFileLength(_In_z_ const ORTCHAR_T* file_path, size_t& length) const override;
@@ -2,9 +2,27 @@
 // Licensed under the MIT License.
 
 #include "core/providers/azure/azure_execution_provider.h"
+#include "core/common/parse_string.h"
 #include "core/graph/constants.h"
 
 namespace onnxruntime {
-AzureExecutionProvider::AzureExecutionProvider(const std::unordered_map<std::string, std::string>& config) : IExecutionProvider{onnxruntime::kAzureExecutionProvider}, config_(config) {
+
+namespace {
+int64_t ParseNonNegativeOption(const std::unordered_map<std::string, std::string>& config, const char* key) {
+  int64_t value = 0;
+  const auto it = config.find(key);
+  if (it != config.end()) {
+    ORT_ENFORCE(TryParseStringWithClassicLocale<int64_t>(it->second, value) && value >= 0,
+                "Invalid Azure EP option ", key, ": ", it->second, ". It must be a non-negative integer.");
+  }
+  return value;
+}
+}  // namespace
+
+AzureExecutionProvider::AzureExecutionProvider(const std::unordered_map<std::string, std::string>& config)
+    : IExecutionProvider{onnxruntime::kAzureExecutionProvider},
+      config_(config),
+      batching_window_(ParseNonNegativeOption(config, kAzureProviderOptionBatchingWindowUs)),
+      max_batch_size_(ParseNonNegativeOption(config, kAzureProviderOptionMaxBatchSize)) {
 }
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
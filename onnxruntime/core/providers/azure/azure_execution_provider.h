@@ -3,18 +3,36 @@
 
 #pragma once
 
+#include <chrono>
+
 #include "core/framework/execution_provider.h"
 
 namespace onnxruntime {
 
+// Provider options of the Azure EP.
+// If batching_window_us is positive, concurrent Run() calls of the session wait up to this many microseconds to be
+// merged into a single run, so that the remote invocation ops (AzureTritonInvoker, OpenAIAudioToText, ...) of the model
+// make one request for all of them. max_batch_size, if positive, limits the total batch dimension of a merged run.
+// The calls are merged like with the session.dynamic_batching_window_us session option, which takes precedence.
+static const char* const kAzureProviderOptionBatchingWindowUs = "batching_window_us";
+static const char* const kAzureProviderOptionMaxBatchSize = "max_batch_size";
+
+// The Azure EP claims no nodes and owns no HTTP client. It holds the "azure.*" configuration for the remote
+// invocation ops of onnxruntime-extensions, which issue the remote requests, and the batching of the Run() calls.
 class AzureExecutionProvider : public IExecutionProvider {
  public:
   explicit AzureExecutionProvider(const std::unordered_map<std::string, std::string>& config);
   ~AzureExecutionProvider() = default;
   const std::unordered_map<std::string, std::string>& GetConfig() const { return config_; }
+  ProviderOptions GetProviderOptions() const override { return config_; }
+
+  std::chrono::microseconds GetBatchingWindow() const { return batching_window_; }
+  int64_t GetMaxBatchSize() const { return max_batch_size_; }
 
  private:
   std::unordered_map<std::string, std::string> config_;
+  std::chrono::microseconds batching_window_{0};
+  int64_t max_batch_size_ = 0;
 };
 
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -1,7 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/optimizer/initializer.h"
 #include "core/providers/coreml/builders/impl/base_op_builder.h"
+#include "core/providers/coreml/builders/impl/builder_utils.h"
 #include "core/providers/coreml/builders/op_builder_factory.h"
 #include "core/providers/coreml/builders/model_builder.h"
 #include "core/providers/coreml/shape_utils.h"
@@ -10,6 +12,8 @@
 namespace onnxruntime::coreml {
 
 class GatherOpBuilder : public BaseOpBuilder {
+  void AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) const override;
+
   Status AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node,
                                const logging::Logger& logger) const override;
 
@@ -18,6 +22,8 @@ class GatherOpBuilder : public BaseOpBuilder {
 
   bool IsOpSupportedImpl(const Node& node, const OpBuilderInputParams& input_params,
                          const logging::Logger& logger) const override;
+
+  bool SupportsMLProgram() const override { return true; }
 };
 
 namespace {
@@ -27,14 +33,69 @@ int64_t GetAxisAttribute(const Node& node) {
 }
 }  // namespace
 
+void GatherOpBuilder::AddInitializersToSkip(ModelBuilder& model_builder, const Node& node) const {
+  const auto& indices_name = node.InputDefs()[1]->Name();
+  if (model_builder.CreateMLProgram() && model_builder.GetConstantInitializer(indices_name) != nullptr) {
+    // constant indices are added as an int32 'const' operation in AddToModelBuilderImpl
+    model_builder.AddInitializerToSkip(indices_name);
+  }
+}
+
 Status GatherOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node,
-                                              const logging::Logger& /*logger*/) const {
-  auto layer = model_builder.CreateNNLayer(node);
-  layer->mutable_gather()->set_axis(GetAxisAttribute(node));
-  *layer->mutable_input()->Add() = node.InputDefs()[0]->Name();    // data
-  *layer->mutable_input()->Add() = node.InputDefs()[1]->Name();    // indices
-  *layer->mutable_output()->Add() = node.OutputDefs()[0]->Name();  // output
-  model_builder.AddLayer(std::move(layer));
+                                              const logging::Logger& logger) const {
+#if defined(COREML_ENABLE_MLPROGRAM)
+  if (model_builder.CreateMLProgram()) {
+    using namespace CoreML::Specification::MILSpec;
+
+    // https://github.com/apple/coremltools/blob/7.1/coremltools/converters/mil/mil/ops/defs/iOS15/scatter_gather.py
+    const auto& data = *node.InputDefs()[0];
+    const auto& indices = *node.InputDefs()[1];
+
+    std::unique_ptr<Operation> op = model_builder.CreateOperation(node, "gather");
+    AddOperationInput(*op, "x", data.Name());
+
+    if (const auto* indices_tensor = model_builder.GetConstantInitializer(indices.Name())) {
+      Initializer unpacked_tensor(*indices_tensor);
+      std::vector<int64_t> indices_values;
+      if (unpacked_tensor.data_type() == ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+        auto values = unpacked_tensor.DataAsSpan<int64_t>();
+        indices_values.assign(values.begin(), values.end());
+      } else {
+        auto values = unpacked_tensor.DataAsSpan<int32_t>();
+        indices_values.assign(values.begin(), values.end());
+      }
+
+      const std::vector<int64_t> indices_shape(indices_tensor->dims().begin(), indices_tensor->dims().end());
+      AddOperationInput(*op, "indices",
+                        model_builder.AddConstant(op->type(), "indices", indices_values, AsSpan(indices_shape)));
+    } else {
+      AddOperationInput(*op, "indices", indices.Name());
+    }
+
+    AddOperationInput(*op, "axis", model_builder.AddScalarConstant(op->type(), "axis", GetAxisAttribute(node)));
+
+    // int64 data is converted to int32 when it is provided to the CoreML model, so the output is int32 as well
+    std::optional<int32_t> output_datatype;
+    int32_t input_type;
+    ORT_RETURN_IF_NOT(GetType(data, input_type, logger), "Failed to get input type");
+    if (input_type == ONNX_NAMESPACE::TensorProto_DataType_INT64) {
+      output_datatype = ONNX_NAMESPACE::TensorProto_DataType_INT32;
+    }
+
+    AddOperationOutput(*op, *node.OutputDefs()[0], output_datatype);
+    model_builder.AddOperation(std::move(op));
+  } else
+#endif  // defined(COREML_ENABLE_MLPROGRAM)
+  {
+    ORT_UNUSED_PARAMETER(logger);
+    auto layer = model_builder.CreateNNLayer(node);
+    layer->mutable_gather()->set_axis(GetAxisAttribute(node));
+    *layer->mutable_input()->Add() = node.InputDefs()[0]->Name();    // data
+    *layer->mutable_input()->Add() = node.InputDefs()[1]->Name();    // indices
+    *layer->mutable_output()->Add() = node.OutputDefs()[0]->Name();  // output
+    model_builder.AddLayer(std::move(layer));
+  }
+
   return Status::OK();
 }
 
@@ -55,7 +116,7 @@ bool GatherOpBuilder::HasSupportedInputsImpl(const Node& node, const OpBuilderIn
   return true;
 }
 
-bool GatherOpBuilder::IsOpSupportedImpl(const Node& node, const OpBuilderInputParams& /*input_params*/,
+bool GatherOpBuilder::IsOpSupportedImpl(const Node& node, const OpBuilderInputParams& input_params,
                                         const logging::Logger& logger) const {
   std::vector<int64_t> data_shape, indices_shape;
   if (!GetShape(*node.InputDefs()[0], data_shape, logger)) {
@@ -81,6 +142,13 @@ bool GatherOpBuilder::IsOpSupportedImpl(const Node& node, const OpBuilderInputPa
     return false;
   }
 
+  if (input_params.create_mlprogram &&
+      input_params.graph_viewer.GetConstantInitializer(node.InputDefs()[0]->Name()) != nullptr) {
+    // int64 initializers can't be converted to an ML Program constant, and a constant Gather should be folded
+    LOGS(logger, VERBOSE) << "Gather with constant 'data' is not supported for ML Program";
+    return false;
+  }
+
   return true;
 }
 
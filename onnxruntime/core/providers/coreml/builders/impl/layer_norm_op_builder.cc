@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/common.h"
+#include "core/providers/coreml/builders/helper.h"
+#include "core/providers/coreml/builders/impl/base_op_builder.h"
+#include "core/providers/coreml/builders/impl/builder_utils.h"
+#include "core/providers/coreml/builders/model_builder.h"
+#include "core/providers/coreml/builders/op_builder_factory.h"
+#include "core/providers/shared/utils/utils.h"
+
+namespace onnxruntime {
+namespace coreml {
+
+class LayerNormOpBuilder : public BaseOpBuilder {
+  Status AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node,
+                               const logging::Logger& logger) const override;
+
+  bool IsOpSupportedImpl(const Node& node, const OpBuilderInputParams& input_params,
+                         const logging::Logger& logger) const override;
+
+  bool HasSupportedInputsImpl(const Node& node, const OpBuilderInputParams& input_params,
+                              const logging::Logger& logger) const override;
+
+  bool SupportsMLProgram() const override { return true; }
+};
+
+Status LayerNormOpBuilder::AddToModelBuilderImpl(ModelBuilder& model_builder, const Node& node,
+                                                 const logging::Logger& logger) const {
+#if defined(COREML_ENABLE_MLPROGRAM)
+  using namespace CoreML::Specification::MILSpec;
+
+  // https://github.com/apple/coremltools/blob/7.1/coremltools/converters/mil/mil/ops/defs/iOS15/normalization.py
+  const auto& input_defs = node.InputDefs();
+  std::vector<int64_t> input_shape;
+  ORT_RETURN_IF_NOT(GetShape(*input_defs[0], input_shape, logger), "Cannot get shape");
+
+  NodeAttrHelper helper(node);
+  const auto rank = static_cast<int64_t>(input_shape.size());
+  const auto axis = HandleNegativeAxis(helper.Get("axis", int64_t{-1}), rank);
+  const auto epsilon = helper.Get("epsilon", 1e-05f);
+
+  // ONNX normalizes over all the dimensions from 'axis' on
+  std::vector<int64_t> axes;
+  for (int64_t i = axis; i < rank; ++i) {
+    axes.push_back(i);
+  }
+
+  std::unique_ptr<Operation> op = model_builder.CreateOperation(node, "layer_norm");
+  AddOperationInput(*op, "x", input_defs[0]->Name());
+  AddOperationInput(*op, "axes", model_builder.AddConstant(op->type(), "axes", axes));
+  AddOperationInput(*op, "gamma", input_defs[1]->Name());
+  if (input_defs.size() > 2 && input_defs[2]->Exists()) {
+    AddOperationInput(*op, "beta", input_defs[2]->Name());
+  }
+
+  AddOperationInput(*op, "epsilon", model_builder.AddScalarConstant(op->type(), "epsilon", epsilon));
+  AddOperationOutput(*op, *node.OutputDefs()[0]);
+  model_builder.AddOperation(std::move(op));
+
+  return Status::OK();
+#else
+  ORT_UNUSED_PARAMETER(model_builder);
+  ORT_UNUSED_PARAMETER(node);
+  ORT_UNUSED_PARAMETER(logger);
+  return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "LayerNormalization requires ML Program support.");
+#endif  // defined(COREML_ENABLE_MLPROGRAM)
+}
+
+bool LayerNormOpBuilder::IsOpSupportedImpl(const Node& node, const OpBuilderInputParams& input_params,
+                                           const logging::Logger& logger) const {
+  // NeuralNetwork layer normalization only supports normalizing the trailing dimensions with a fixed shape
+  // so we only support ML Program
+  if (!input_params.create_mlprogram) {
+    LOGS(logger, VERBOSE) << "LayerNormalization is only supported for ML Program";
+    return false;
+  }
+
+  // the optional Mean and InvStdDev outputs are not produced by CoreML
+  const auto& output_defs = node.OutputDefs();
+  for (size_t i = 1; i < output_defs.size(); ++i) {
+    if (output_defs[i]->Exists()) {
+      LOGS(logger, VERBOSE) << "LayerNormalization with the Mean or InvStdDev output is not supported";
+      return false;
+    }
+  }
+
+  std::vector<int64_t> input_shape;
+  if (!GetShape(*node.InputDefs()[0], input_shape, logger)) {
+    LOGS(logger, VERBOSE) << "Failed to get the input shape";
+    return false;
+  }
+
+  if (input_shape.empty()) {
+    LOGS(logger, VERBOSE) << "LayerNormalization does not support scalar input";
+    return false;
+  }
+
+  // CoreML requires gamma and beta to be constants
+  const auto& input_defs = node.InputDefs();
+  if (!CheckIsConstantInitializer(*input_defs[1], input_params.graph_viewer, logger, "Scale")) {
+    return false;
+  }
+
+  if (input_defs.size() > 2 && input_defs[2]->Exists() &&
+      !CheckIsConstantInitializer(*input_defs[2], input_params.graph_viewer, logger, "B")) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LayerNormOpBuilder::HasSupportedInputsImpl(const Node& node, const OpBuilderInputParams& input_params,
+                                                const logging::Logger& logger) const {
+  // X, Scale and B must all be float
+  const auto& input_defs = node.InputDefs();
+  for (size_t i = 0; i < input_defs.size(); ++i) {
+    if (input_defs[i]->Exists() && !IsInputFloat(node, i, input_params, logger)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void CreateLayerNormOpBuilder(const std::string& op_type, OpBuilderRegistrations& op_registrations) {
+  op_registrations.builders.push_back(std::make_unique<LayerNormOpBuilder>());
+  op_registrations.op_builder_map.emplace(op_type, op_registrations.builders.back().get());
+}
+
+}  // namespace coreml
+}  // namespace onnxruntime
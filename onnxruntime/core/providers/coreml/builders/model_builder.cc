@@ -2,8 +2,12 @@
 // Licensed under the MIT License.
 
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
+#include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/platform/env.h"
 #include "core/providers/common.h"
@@ -388,6 +392,33 @@ void CreateEmptyFile(const std::string& filename) {
 
 #endif  // defined(COREML_ENABLE_MLPROGRAM)
 
+// Combine the hash of data into hash. The result depends on the order the data is added in.
+void UpdateHash(const void* data, size_t size, uint32_t (&hash)[4]) {
+  uint32_t data_hash[4];
+  MurmurHash3::x86_128(data, narrow<int>(size), hash[0], data_hash);
+  for (size_t i = 0; i < 4; ++i) {
+    hash[i] = hash[i] * 31 + data_hash[i];
+  }
+}
+
+bool UpdateHashWithFile(const std::string& path, uint32_t (&hash)[4]) {
+  std::ifstream file(path, std::ifstream::in | std::ifstream::binary);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  std::vector<char> buffer(1024 * 1024);
+  while (file) {
+    file.read(buffer.data(), buffer.size());
+    const auto bytes_read = static_cast<size_t>(file.gcount());
+    if (bytes_read > 0) {
+      UpdateHash(buffer.data(), bytes_read, hash);
+    }
+  }
+
+  return file.eof();
+}
+
 std::string GetModelOutputPath(bool create_ml_program) {
   // path is used to create the ML Package directory for ML Program, and for the model directly otherwise.
   auto path = util::GetTemporaryFilePath();
@@ -437,6 +468,7 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const logging::Logge
                                                  "CoreML Model Weights");
     auto weights_info = mlpackage_->findItem(weights_id);
     weights_file_writer_ = std::make_unique<StorageWriter>(weights_info->path() + "/weight.bin");
+    model_files_.push_back(weights_info->path() + "/weight.bin");
 #else
     // should never happen due to handling in coreml_execution_provider.cc
     // throw here so all other code in this class can assume create_ml_program_ is only ever true in a build
@@ -931,6 +963,8 @@ Status ModelBuilder::SaveModel() {
     ORT_RETURN_IF_NOT(coreml_model_->SerializeToOstream(&stream), "Saving the CoreML model failed. Path=", output_path);
   }
 
+  model_files_.push_back(output_path);
+
 #if defined(COREML_ENABLE_MLPROGRAM)
   // need to delete the ModelPackage instance for it to write out the manifest. clear out the other ML Program
   // related types as well.
@@ -942,7 +976,39 @@ Status ModelBuilder::SaveModel() {
   return Status::OK();
 }
 
+std::string ModelBuilder::GetCompiledModelCachePath() const {
+  const std::string cache_dir = Env::Default().GetEnvironmentVar(util::kCompiledModelCacheDirectoryEnvVar);
+  if (cache_dir.empty()) {
+    return {};
+  }
+
+  // the compiled model depends on the saved model, the compute units selected by the flags and the OS it is
+  // compiled on. the weights must be hashed as well as the ML Program only refers to them by offset.
+  uint32_t hash[4] = {0, 0, 0, 0};
+  for (const auto& file : model_files_) {
+    if (!UpdateHashWithFile(file, hash)) {
+      LOGS(logger_, WARNING) << "Failed to read " << file << ". The compiled model will not be cached.";
+      return {};
+    }
+  }
+
+  const std::string os_version = util::GetOperatingSystemVersion();
+  UpdateHash(os_version.data(), os_version.size(), hash);
+  UpdateHash(&coreml_flags_, sizeof(coreml_flags_), hash);
+  UpdateHash(&coreml_version_, sizeof(coreml_version_), hash);
+
+  std::ostringstream name;
+  name << "onnxruntime-" << std::hex << std::setfill('0');
+  for (uint32_t value : hash) {
+    name << std::setw(8) << value;
+  }
+
+  return cache_dir + "/" + name.str() + ".mlmodelc";
+}
+
 Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
+  const std::string compiled_model_cache_path = GetCompiledModelCachePath();
+
 #if defined(COREML_ENABLE_MLPROGRAM)
   if (create_ml_program_) {
     // we need to provide the sanitized names for model inputs/outputs so that info is captured.
@@ -971,6 +1037,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
     };
 
     model = std::make_unique<Model>(model_output_path_,
+                                    compiled_model_cache_path,
                                     get_sanitized_names(std::move(onnx_input_names_)),
                                     get_sanitized_names(std::move(onnx_output_names_)),
                                     get_sanitized_io_info(std::move(input_output_info_)),
@@ -981,6 +1048,7 @@ Status ModelBuilder::LoadModel(std::unique_ptr<Model>& model) {
 #endif
   {
     model = std::make_unique<Model>(model_output_path_,
+                                    compiled_model_cache_path,
                                     std::move(onnx_input_names_),
                                     std::move(onnx_output_names_),
                                     std::move(input_output_info_),
@@ -206,6 +206,10 @@ class ModelBuilder {
   // Record the onnx int64 type output names
   void AddInt64Output(const std::string& output_name);
 
+  // Get the path to cache the compiled model at. The name is a hash of the saved model, the flags and the OS version.
+  // Returns an empty string if the compiled model cache is not enabled.
+  std::string GetCompiledModelCachePath() const;
+
   const GraphViewer& graph_viewer_;
   const logging::Logger& logger_;
   const int32_t coreml_version_;
@@ -216,6 +220,8 @@ class ModelBuilder {
   std::vector<std::string> onnx_input_names_;
   std::vector<std::string> onnx_output_names_;
 
+  std::vector<std::string> model_files_;  // files the saved model consists of
+
   std::unique_ptr<CoreML::Specification::Model> coreml_model_;
   std::unordered_set<std::string> scalar_outputs_;
   std::unordered_set<std::string> int64_outputs_;
@@ -67,6 +67,14 @@ int CoreMLVersion();
 // Get a temporary macOS/iOS temp file path
 std::string GetTemporaryFilePath();
 
+// Get a description of the OS version, including the build number.
+// Compiled models are only reused on the OS version that compiled them.
+std::string GetOperatingSystemVersion();
+
+// Directory to cache compiled CoreML models in. Compiling the generated model can take seconds on device, so if this
+// is set the compiled model is saved and reused by later sessions that generate the same model.
+constexpr const char* kCompiledModelCacheDirectoryEnvVar = "ORT_COREML_EP_COMPILED_MODEL_CACHE_DIR";
+
 #if !defined(NDEBUG) && defined(__APPLE__)
 // Override location the model is written to so that a) it's easily found and b) it is not automatically deleted
 // when the EP exits. Use to debug the model that is generated.
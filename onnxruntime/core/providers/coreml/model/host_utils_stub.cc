@@ -35,6 +35,10 @@ std::string GetTemporaryFilePath() {
   return dir_name;
 }
 
+std::string GetOperatingSystemVersion() {
+  return "stub";
+}
+
 }  // namespace util
 }  // namespace coreml
 }  // namespace onnxruntime
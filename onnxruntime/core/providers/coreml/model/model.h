@@ -47,7 +47,9 @@ Status GetMLMultiArrayCopyInfo(const MLMultiArray* array, int64_t& num_blocks, i
 
 class Model {
  public:
+  // compiled_model_cache_path is where the compiled model is cached. The cache is not used if it is empty.
   Model(const std::string& path,
+        const std::string& compiled_model_cache_path,
         std::vector<std::string>&& model_input_names,
         std::vector<std::string>&& model_output_names,
         std::unordered_map<std::string, OnnxTensorInfo>&& input_output_info,
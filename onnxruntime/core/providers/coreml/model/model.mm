@@ -250,21 +250,24 @@ Status CopyMLMultiArrayBuffer(const void* mlmultiarray_buffer, void* tensor_buff
 NS_ASSUME_NONNULL_BEGIN
 
 // Execution for a CoreML model, it performs
-// 1. Compile the model by given path for execution
+// 1. Compile the model by given path for execution, or load the compiled model from the cache
 // 2. Predict using given OnnxTensorFeatureProvider input and copy the output data back ORT
-// 3. The compiled model will be removed in dealloc or removed using cleanup function
+// 3. The compiled model will be removed in dealloc or removed using cleanup function, unless it was cached
 @interface CoreMLExecution : NSObject {
   NSString* coreml_model_path_;
   NSString* compiled_model_path_;
+  NSString* compiled_model_cache_path_;
   const logging::Logger* logger_;
   uint32_t coreml_flags_;
 }
 
 - (instancetype)initWithPath:(const std::string&)path
+      compiledModelCachePath:(const std::string&)compiled_model_cache_path
                       logger:(const logging::Logger&)logger
                 coreml_flags:(uint32_t)coreml_flags;
 - (void)cleanup;
 - (void)dealloc;
+- (Status)compileModel:(NSURL* _Nullable* _Nonnull)compiled_model_url API_AVAILABLE_COREML3;
 - (Status)loadModel API_AVAILABLE_COREML3;
 - (Status)predict:(const std::unordered_map<std::string, OnnxTensorData>&)inputs
                   outputs:(const std::unordered_map<std::string, OnnxTensorInfo>&)outputs
@@ -278,10 +281,14 @@ NS_ASSUME_NONNULL_BEGIN
 @implementation CoreMLExecution
 
 - (instancetype)initWithPath:(const std::string&)path
+      compiledModelCachePath:(const std::string&)compiled_model_cache_path
                       logger:(const logging::Logger&)logger
                 coreml_flags:(uint32_t)coreml_flags {
   if (self = [super init]) {
     coreml_model_path_ = util::Utf8StringToNSString(path.c_str());
+    compiled_model_cache_path_ = compiled_model_cache_path.empty()
+                                     ? nil
+                                     : util::Utf8StringToNSString(compiled_model_cache_path.c_str());
     logger_ = &logger;
     coreml_flags_ = coreml_flags;
   }
@@ -322,7 +329,7 @@ NS_ASSUME_NONNULL_BEGIN
   [self cleanup];
 }
 
-- (Status)loadModel {
+- (Status)compileModel:(NSURL* _Nullable* _Nonnull)compiled_model_url {
   NSURL* modelUrl = [NSURL URLWithString:coreml_model_path_];
   if (modelUrl == nil) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create model URL from path");
@@ -342,10 +349,56 @@ NS_ASSUME_NONNULL_BEGIN
 
   compiled_model_path_ = [compileUrl path];
 
+  if (compiled_model_cache_path_ != nil) {
+    // move the compiled model into the cache. failing to do so is not an error as we can still use it from the
+    // temporary location.
+    NSFileManager* file_manager = [NSFileManager defaultManager];
+    NSString* cache_dir = [compiled_model_cache_path_ stringByDeletingLastPathComponent];
+    if ([file_manager createDirectoryAtPath:cache_dir withIntermediateDirectories:YES attributes:nil error:&error] &&
+        [file_manager moveItemAtPath:compiled_model_path_ toPath:compiled_model_cache_path_ error:&error]) {
+      LOGS(*logger_, INFO) << "Cached the compiled CoreML model at " << [compiled_model_cache_path_ UTF8String];
+      compileUrl = [NSURL fileURLWithPath:compiled_model_cache_path_ isDirectory:YES];
+      compiled_model_path_ = nil;  // owned by the cache now
+    } else {
+      LOGS(*logger_, WARNING) << "Failed to cache the compiled CoreML model at "
+                              << [compiled_model_cache_path_ UTF8String] << ", error message: "
+                              << (error != nil ? [[error localizedDescription] UTF8String] : "unknown");
+    }
+  }
+
+  *compiled_model_url = compileUrl;
+  return Status::OK();
+}
+
+- (Status)loadModel {
   MLModelConfiguration* config = [MLModelConfiguration alloc];
   config.computeUnits = (coreml_flags_ & COREML_FLAG_USE_CPU_ONLY)
                             ? MLComputeUnitsCPUOnly
                             : MLComputeUnitsAll;
+
+  NSError* error = nil;
+
+  if (compiled_model_cache_path_ != nil &&
+      [[NSFileManager defaultManager] fileExistsAtPath:compiled_model_cache_path_]) {
+    NSURL* cachedUrl = [NSURL fileURLWithPath:compiled_model_cache_path_ isDirectory:YES];
+    _model = [MLModel modelWithContentsOfURL:cachedUrl configuration:config error:&error];
+    if (error == nil && _model != nil) {
+      LOGS(*logger_, INFO) << "Loaded the compiled CoreML model from " << [compiled_model_cache_path_ UTF8String];
+      return Status::OK();
+    }
+
+    // the cache entry is unusable. remove it so it is replaced by the model we compile now.
+    LOGS(*logger_, WARNING) << "Failed to load the cached compiled CoreML model at "
+                            << [compiled_model_cache_path_ UTF8String] << ". Compiling the model.";
+    error = nil;
+    [[NSFileManager defaultManager] removeItemAtPath:compiled_model_cache_path_ error:&error];
+    error = nil;
+    _model = nil;
+  }
+
+  NSURL* compileUrl = nil;
+  ORT_RETURN_IF_ERROR([self compileModel:&compileUrl]);
+
   _model = [MLModel modelWithContentsOfURL:compileUrl configuration:config error:&error];
 
   if (error != nil || _model == nil) {
@@ -501,7 +554,8 @@ Status GetMLMultiArrayCopyInfo(const MLMultiArray* _Nonnull array,
 // This class will bridge Model (c++) with CoreMLExecution (objective c++)
 class Execution {
  public:
-  Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags);
+  Execution(const std::string& path, const std::string& compiled_model_cache_path,
+            const logging::Logger& logger, uint32_t coreml_flags);
   ~Execution() {};
 
   Status LoadModel();
@@ -514,9 +568,11 @@ class Execution {
   CoreMLExecution* execution_;
 };
 
-Execution::Execution(const std::string& path, const logging::Logger& logger, uint32_t coreml_flags) {
+Execution::Execution(const std::string& path, const std::string& compiled_model_cache_path,
+                     const logging::Logger& logger, uint32_t coreml_flags) {
   @autoreleasepool {
     execution_ = [[CoreMLExecution alloc] initWithPath:path
+                                compiledModelCachePath:compiled_model_cache_path
                                                 logger:logger
                                           coreml_flags:coreml_flags];
   }
@@ -556,6 +612,7 @@ Status Execution::Predict(const std::unordered_map<std::string, OnnxTensorData>&
 }
 
 Model::Model(const std::string& path,
+             const std::string& compiled_model_cache_path,
              std::vector<std::string>&& model_input_names,
              std::vector<std::string>&& model_output_names,
              std::unordered_map<std::string, OnnxTensorInfo>&& input_output_info,
@@ -563,7 +620,7 @@ Model::Model(const std::string& path,
              std::unordered_set<std::string>&& int64_outputs,
              const logging::Logger& logger,
              uint32_t coreml_flags)
-    : execution_(std::make_unique<Execution>(path, logger, coreml_flags)),
+    : execution_(std::make_unique<Execution>(path, compiled_model_cache_path, logger, coreml_flags)),
       model_input_names_(std::move(model_input_names)),
       model_output_names_(std::move(model_output_names)),
       input_output_info_(std::move(input_output_info)),
@@ -9,6 +9,7 @@ namespace coreml {
 class Execution {};
 
 Model::Model(const std::string& /*path*/,
+             const std::string& /*compiled_model_cache_path*/,
              std::vector<std::string>&& model_input_names,
              std::vector<std::string>&& model_output_names,
              std::unordered_map<std::string, OnnxTensorInfo>&& input_output_info,
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/activation/activations.h"
 #include "core/providers/cpu/fp16/fp16_activations.h"
@@ -120,6 +122,43 @@ void Tanh<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
   float* output_ptr = output + first;
   MlasComputeTanh(input + first, output_ptr, static_cast<size_t>(len));
 }
+
+// The exponentials are computed in blocks of a local buffer as the output may alias the input.
+constexpr std::ptrdiff_t kTranscendentalBlockSize = 256;
+
+template <>
+void Elu<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  float buffer[kTranscendentalBlockSize];
+  for (std::ptrdiff_t len; first < last; first += len) {
+    len = std::min(last - first, kTranscendentalBlockSize);
+    ConstEigenVectorArrayMap<float> xm(input + first, len);
+    EigenVectorArrayMap<float> ym(output + first, len);
+    EigenVectorArrayMap<float> em(buffer, len);
+    em = xm.cwiseMin(0.0f);
+    MlasComputeExp(buffer, buffer, static_cast<size_t>(len));
+    ym = (xm >= 0).select(xm, alpha * (em - 1));
+  }
+}
+
+template <>
+void Softplus<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  float exp_buffer[kTranscendentalBlockSize];
+  float log_buffer[kTranscendentalBlockSize];
+  for (std::ptrdiff_t len; first < last; first += len) {
+    len = std::min(last - first, kTranscendentalBlockSize);
+    ConstEigenVectorArrayMap<float> xm(input + first, len);
+    EigenVectorArrayMap<float> ym(output + first, len);
+    EigenVectorArrayMap<float> um(exp_buffer, len);
+    EigenVectorArrayMap<float> lm(log_buffer, len);
+    // softplus(x) = max(x, 0) + log1p(exp(-|x|))
+    um = -xm.abs();
+    MlasComputeExp(exp_buffer, exp_buffer, static_cast<size_t>(len));
+    lm = um + 1.0f;
+    MlasComputeLog(log_buffer, log_buffer, static_cast<size_t>(len));
+    // log1p(u) = log(1 + u) * u / ((1 + u) - 1) recovers the bits of u lost by rounding 1 + u
+    ym = xm.cwiseMax(0.0f) + ((um + 1.0f) == 1.0f).select(um, lm * um / ((um + 1.0f) - 1.0f));
+  }
+}
 }  // namespace functors
 
 }  // namespace onnxruntime
@@ -13,6 +13,7 @@
 #include "core/providers/cpu/controlflow/utils.h"
 
 #include "core/framework/allocator.h"
+#include "core/framework/device_stream_collection.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/session_state.h"
@@ -344,14 +345,17 @@ common::Status Loop::SetupSubgraphExecutionInfo(const SessionState& session_stat
 
   // Loop state variables need to be where we can feed them in to the next iteration, so set the fetch location
   // to match the feed location.
+  const auto& loop_outputs = node.OutputDefs();
+  info_->loop_carried_vars_on_output_device.resize(info_->num_loop_carried_vars);
   for (ptrdiff_t i = 0; i < info_->num_loop_carried_vars; ++i) {
     // +2 for both to skip the iter_num and cond input values
     const auto& alloc_info = utils::FindDeviceForValue(session_state, loop_inputs[i + 2]->Name());
     fetch_locations.push_back(&alloc_info);
+    info_->loop_carried_vars_on_output_device[i] =
+        alloc_info == utils::FindDeviceForValue(session_state, loop_outputs[i]->Name());
   }
 
   // remaining outputs we want where the matching Loop output will be allocated
-  const auto& loop_outputs = node.OutputDefs();
   for (size_t i = info_->num_loop_carried_vars, end = loop_outputs.size(); i < end; ++i) {
     const auto& alloc_info = utils::FindDeviceForValue(session_state, loop_outputs[i]->Name());
     fetch_locations.push_back(&alloc_info);
@@ -502,6 +506,11 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
   auto& iter_num_value = *iter_num_mlvalue_.GetMutable<Tensor>()->MutableData<int64_t>();
 
+#ifdef ORT_ENABLE_STREAM
+  // the device streams of the subgraph are held for all the iterations
+  DeviceStreamCollectionHolder device_stream_collection_holder(&session_state_);
+#endif
+
   while (iter_num_value < max_trip_count_ && *condition_mlvalue_.GetMutable<Tensor>()->MutableData<bool>()) {
     if (iter_num_value != 0) {
       SaveOutputsAndUpdateFeeds(fetches, feeds);
@@ -510,6 +519,9 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
 
     status = utils::ExecuteSubgraph(session_state_, ffm, feeds, fetches, {},
                                     ExecutionMode::ORT_SEQUENTIAL, context_.GetTerminateFlag(), context_.Logger(),
+#ifdef ORT_ENABLE_STREAM
+                                    device_stream_collection_holder,
+#endif
                                     context_.GetComputeStream(),
                                     // because the fetch[0] is the loop condition which we need to access on CPU,
                                     // have to perofrm a stream sync to make sure the data arrived.
@@ -521,8 +533,8 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     ++iter_num_value;
   }
 
-  // As the loop carried variables may change shape across iterations there's no way to avoid a copy
-  // as we need the final shape.
+  // As the loop carried variables may change shape across iterations the Loop outputs can't be allocated up front,
+  // so the final values are copied to them, unless the output can share the value (see below).
   auto copy_mlvalue_to_output = [this](OrtValue& input, int output_idx,
                                        int64_t iter_num_value, const TypeProto& tp) {
 #if !defined(DISABLE_OPTIONAL_TYPE)
@@ -540,6 +552,14 @@ Status LoopImpl::Execute(const FeedsFetchesManager& ffm) {
     ORT_UNUSED_PARAMETER(tp);
     if (input.IsTensor()) {
 #endif
+      // A value that no one else holds is a buffer the subgraph allocated for its output in the last iteration,
+      // which is not an input, an implicit input or an initializer, so the Loop output can take it over.
+      // A preallocated output is written below, which checks that its shape matches.
+      if (iter_num_value != 0 && input.IsSoleOwner() && info_.loop_carried_vars_on_output_device[output_idx] &&
+          context_.TryShareOutputMLValue(output_idx, input)) {
+        return Status::OK();
+      }
+
       const auto& input_tensor = input.Get<Tensor>();
       Tensor* output = context_.Output(output_idx, input_tensor.Shape());
       // Safely use the IDataTransfer abstraction as we only allow using
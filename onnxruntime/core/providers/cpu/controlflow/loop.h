@@ -38,6 +38,10 @@ class Loop : public controlflow::IControlFlowKernel {
     std::vector<std::string> subgraph_output_names;
 
     std::vector<const ONNX_NAMESPACE::TypeProto*> loop_carried_vars_types;
+
+    // whether the subgraph fetches the final value of each loop carried var on the device of the matching Loop
+    // output, so that the output can share the value instead of copying it.
+    std::vector<bool> loop_carried_vars_on_output_device;
   };
 
   // function to concatenate the OrtValue instances from each Loop iteration into a single output buffer.
@@ -208,6 +208,11 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
     feeds[num_variadic_inputs + i] = *implicit_inputs[i];
   }
 
+#ifdef ORT_ENABLE_STREAM
+  // the device streams of the subgraph are held for all the iterations
+  DeviceStreamCollectionHolder device_stream_collection_holder(&session_state);
+#endif
+
   int64_t seq_no = 0;
   for (; seq_no < seq_length; ++seq_no) {
     for (int input = 0; input < num_variadic_inputs; ++input) {
@@ -272,6 +277,9 @@ Status IterateSequence(OpKernelContextInternal& context, const SessionState& ses
     // Create Executor and run graph.
     status = utils::ExecuteSubgraph(session_state, ffm, feeds, fetches, fetch_allocators,
                                     ExecutionMode::ORT_SEQUENTIAL, context.GetTerminateFlag(), context.Logger(),
+#ifdef ORT_ENABLE_STREAM
+                                    device_stream_collection_holder,
+#endif
                                     context.GetComputeStream());
 
     ORT_RETURN_IF_ERROR(status);
@@ -5,13 +5,27 @@
 
 #include "core/framework/execution_provider.h"
 #include "core/graph/constants.h"
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
 
 namespace onnxruntime {
 
+namespace cpu {
+struct TunableOpInfo {
+  bool enable{false};
+  bool tuning_enable{false};
+  int max_tuning_duration_ms{};
+};
+}  // namespace cpu
+
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
 
+  // If it is non-negative, prefer memory from this NUMA node for allocations.
+  int numa_node{-1};
+
+  cpu::TunableOpInfo tunable_op{};
+
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
 
@@ -32,9 +46,14 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
 
+  ITuningContext* GetTuningContext() const override;
+
  private:
   CPUExecutionProviderInfo info_;
   std::vector<FuseRuleFn> fuse_rules_;
+
+  // the tuning context might be altered when calling into a TunableOp
+  mutable cpu::tunable::CpuTuningContext tuning_context_;
 };
 
 // Registers all available CPU kernels
@@ -23,11 +23,14 @@ limitations under the License.
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <random>
+#include <vector>
 
 #include "core/common/eigen_common_wrapper.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel_type_control_utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
 
@@ -126,11 +129,99 @@ ONNX_CPU_OPERATOR_KERNEL(
                         BuildKernelDefConstraintsFromTypeList<EnabledMultinomialOutputTypes>()),
     Multinomial);
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor);
+namespace {
+// The number of values generated from every Philox block of 4 x 32 random bits: four floats or two doubles.
+template <typename T>
+constexpr int64_t kValuesPerBlock = static_cast<int64_t>(sizeof(PhiloxEngine::Block) / sizeof(T));
 
-static Status RandomNormalCompute(float mean, float scale, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
-static Status RandomUniformCompute(float high, float low, std::default_random_engine& generator, TensorProto::DataType dtype, Tensor& Y);
+// The number of blocks generated at a time into a buffer on the stack.
+constexpr std::ptrdiff_t kBlocksPerChunk = 64;
+
+template <typename T>
+T ToUniform(const uint32_t* bits);
+
+template <>
+float ToUniform<float>(const uint32_t* bits) {
+  return PhiloxEngine::ToUniformFloat(bits[0]);
+}
+
+template <>
+double ToUniform<double>(const uint32_t* bits) {
+  return PhiloxEngine::ToUniformDouble(bits[0], bits[1]);
+}
+
+template <typename T>
+struct UniformTransform {
+  T low;
+  T range;
+
+  void operator()(const uint32_t* block, T* values) const {
+    constexpr size_t bits_per_value = sizeof(T) / sizeof(uint32_t);
+    for (int64_t i = 0; i < kValuesPerBlock<T>; ++i) {
+      values[i] = low + range * ToUniform<T>(block + i * bits_per_value);
+    }
+  }
+};
+
+// Box-Muller transform of pairs of uniform values.
+template <typename T>
+struct NormalTransform {
+  T mean;
+  T scale;
+
+  void operator()(const uint32_t* block, T* values) const {
+    constexpr size_t bits_per_value = sizeof(T) / sizeof(uint32_t);
+    constexpr T two_pi = static_cast<T>(6.283185307179586476925286766559);
+    for (int64_t i = 0; i < kValuesPerBlock<T>; i += 2) {
+      const T u1 = T{1} - ToUniform<T>(block + i * bits_per_value);  // (0, 1]
+      const T u2 = ToUniform<T>(block + (i + 1) * bits_per_value);
+      const T radius = scale * std::sqrt(T{-2} * std::log(u1));
+      values[i] = mean + radius * std::cos(two_pi * u2);
+      values[i + 1] = mean + radius * std::sin(two_pi * u2);
+    }
+  }
+};
+
+// Fills the tensor from the next range of the Philox stream of the generator. Every value only depends on its
+// block of the stream, so the blocks can be split between the threads and the result does not depend on the number
+// of threads.
+template <typename T, typename TTransform>
+void GenerateData(PhiloxGenerator& generator, const TTransform& transform, concurrency::ThreadPool* tp,
+                  Tensor& tensor) {
+  T* out = tensor.MutableData<T>();
+  const int64_t size = tensor.Shape().Size();
+  const int64_t num_blocks = (size + kValuesPerBlock<T> - 1) / kValuesPerBlock<T>;
+  const auto seeds = generator.NextPhiloxSeeds(static_cast<uint64_t>(num_blocks));
+  const PhiloxEngine engine(seeds.first);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(num_blocks),
+      TensorOpCost{0, static_cast<double>(sizeof(PhiloxEngine::Block)), 100},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        uint32_t bits[kBlocksPerChunk * 4];
+        for (std::ptrdiff_t chunk_begin = first; chunk_begin < last; chunk_begin += kBlocksPerChunk) {
+          const std::ptrdiff_t chunk_size = std::min(kBlocksPerChunk, last - chunk_begin);
+          engine.Generate(seeds.second + chunk_begin, static_cast<size_t>(chunk_size), bits);
+          for (std::ptrdiff_t b = 0; b < chunk_size; ++b) {
+            const int64_t value_begin = (chunk_begin + b) * kValuesPerBlock<T>;
+            if (value_begin + kValuesPerBlock<T> <= size) {
+              transform(bits + b * 4, out + value_begin);
+            } else {
+              // last partial block
+              T values[kValuesPerBlock<T>];
+              transform(bits + b * 4, values);
+              std::copy(values, values + (size - value_begin), out + value_begin);
+            }
+          }
+        }
+      });
+}
+}  // namespace
+
+static Status RandomNormalCompute(float mean, float scale, PhiloxGenerator& generator, concurrency::ThreadPool* tp,
+                                  TensorProto::DataType dtype, Tensor& Y);
+static Status RandomUniformCompute(float low, float high, PhiloxGenerator& generator, concurrency::ThreadPool* tp,
+                                   TensorProto::DataType dtype, Tensor& Y);
 
 static Status CreateOutputTensorFromTensorShape(OpKernelContext* ctx, const Tensor& X, Tensor** Y);
 static TensorProto::DataType InferDataType(const Tensor& tensor);
@@ -138,19 +229,13 @@ static TensorProto::DataType InferDataType(const Tensor& tensor);
 Status RandomNormal::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomNormalCompute(mean_, scale_, generator_, dtype_, Y);
-
-  return status;
+  return RandomNormalCompute(mean_, scale_, generator_, ctx->GetOperatorThreadPool(), dtype_, Y);
 }
 
 Status RandomUniform::Compute(OpKernelContext* ctx) const {
   Tensor& Y = *ctx->Output(0, shape_);
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  auto status = RandomUniformCompute(low_, high_, generator_, dtype_, Y);
-
-  return status;
+  return RandomUniformCompute(low_, high_, generator_, ctx->GetOperatorThreadPool(), dtype_, Y);
 }
 
 Status RandomNormalLike::Compute(OpKernelContext* ctx) const {
@@ -169,10 +254,7 @@ Status RandomNormalLike::Compute(OpKernelContext* ctx) const {
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
 
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomNormalCompute(mean_, scale_, generator_, dtype, *Y);
-
-  return status;
+  return RandomNormalCompute(mean_, scale_, generator_, ctx->GetOperatorThreadPool(), dtype, *Y);
 }
 
 Status RandomUniformLike::Compute(OpKernelContext* ctx) const {
@@ -190,10 +272,8 @@ Status RandomUniformLike::Compute(OpKernelContext* ctx) const {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                            "Could not infer data type from input tensor with data type ",
                            X.DataType());
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
-  status = RandomUniformCompute(low_, high_, generator_, dtype, *Y);
 
-  return status;
+  return RandomUniformCompute(low_, high_, generator_, ctx->GetOperatorThreadPool(), dtype, *Y);
 }
 
 // Rank-2 tensor (matrix) of scalar type T.
@@ -206,6 +286,34 @@ using ConstMatrix = Eigen::TensorMap<Eigen::Tensor<const T, 2, Eigen::RowMajor,
 template <typename T, typename IndexType = int64_t>
 using EigenVector = Eigen::TensorMap<Eigen::Tensor<T, 1, Eigen::RowMajor, IndexType>>;
 
+template <typename T, typename IndexType = int64_t>
+using ConstEigenVector = Eigen::TensorMap<Eigen::Tensor<const T, 1, Eigen::RowMajor, IndexType>>;
+
+// Computes the cumulative probability distribution across the classes of a row of logits into cdf.
+// Note: This isn't normalized. Returns the total.
+static double ComputeCdf(const float* logits_row, const int64_t num_classes, double* cdf_data) {
+  // Takes an along-class maximum (for numerical stability).
+  float maxx = std::numeric_limits<float>::lowest();
+  for (int64_t j = 0; j < num_classes; ++j) {
+    if (Eigen::numext::isfinite(logits_row[j])) {
+      maxx = std::max(maxx, logits_row[j]);
+    }
+  }
+  const auto max_logit = static_cast<double>(maxx);
+
+  Eigen::array<int64_t, 1> dims = {{num_classes}};
+  auto cdf = EigenVector<double>(cdf_data, dims);
+  cdf = (ConstEigenVector<float>(logits_row, dims).cast<double>() - max_logit).exp();
+  double running_total = 0;
+  for (int64_t j = 0; j < num_classes; ++j) {
+    if (Eigen::numext::isfinite(logits_row[j])) {
+      running_total += cdf(j);
+    }
+    cdf(j) = running_total;
+  }
+  return running_total;
+}
+
 template <typename OutputType>
 Status MultinomialComputeShared(AllocatorPtr& alloc,
                                 const Tensor& X,
@@ -229,36 +337,15 @@ Status MultinomialComputeShared(AllocatorPtr& alloc,
   // BEGIN create temporary tensor
   auto cdf_data = static_cast<double*>(alloc->Alloc(SafeInt<size_t>(sizeof(double)) * num_classes));
   BufferUniquePtr cdf_buffer(cdf_data, BufferDeleter(std::move(alloc)));
-  Eigen::array<int64_t, 1> cdf_dims = {{num_classes}};
-  auto cdf = EigenVector<double>(cdf_data, cdf_dims);
   // END create temporary tensor
 
   std::uniform_real_distribution<double> dist(0.0, 1.0);  // TODO: should this be initialized per batch?
 
   for (int64_t b = 0; b < batch_size; ++b) {
-    const float* logits_row = &(logits(b, 0));
-    // Takes an along-class maximum (for numerical stability).
-    float maxx = std::numeric_limits<float>::lowest();
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        maxx = std::max(maxx, logits_row[j]);
-      }
-    }
-    const auto max_logit = static_cast<double>(maxx);
-
-    // Precompute cumulative probability distribution across classes.
-    // Note: This isn't normalized.
-    cdf = (logits.chip<0>(b).cast<double>() - max_logit).exp();
-    double running_total = 0;
-    for (int64_t j = 0; j < num_classes; ++j) {
-      if (Eigen::numext::isfinite(logits_row[j])) {
-        running_total += cdf(j);
-      }
-      cdf(j) = running_total;
-    }
+    const double running_total = ComputeCdf(&(logits(b, 0)), num_classes, cdf_data);
     // Generate each sample.
-    const double* cdf_begin = cdf.data();
-    const double* cdf_end = cdf.data() + num_classes;
+    const double* cdf_begin = cdf_data;
+    const double* cdf_end = cdf_data + num_classes;
     for (int64_t j = 0; j < num_samples; ++j) {
       const double to_find = dist(generator) * running_total;
       auto found_iter = std::upper_bound(cdf_begin, cdf_end, to_find);
@@ -269,18 +356,65 @@ Status MultinomialComputeShared(AllocatorPtr& alloc,
   return Status::OK();
 }
 
+// Multinomial with the Philox RNG. Sample i of the output uses the 64 bits at index i of the next range of the stream
+// of the generator, so the rows are sampled in parallel with a result that does not depend on the number of threads.
 template <typename OutputType>
 static Status MultinomialCompute(OpKernelContext* ctx,
                                  const Tensor& X,
                                  const int64_t batch_size,
                                  const int64_t num_classes,
                                  const int64_t num_samples,
-                                 std::default_random_engine& generator,
+                                 PhiloxGenerator& generator,
                                  Tensor& Y) {
+  if (!utils::HasType<EnabledMultinomialOutputTypes, OutputType>()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Output type not supported in this build.");
+  }
+
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  const std::ptrdiff_t num_partitions =
+      std::min<std::ptrdiff_t>(concurrency::ThreadPool::DegreeOfParallelism(tp), narrow<std::ptrdiff_t>(batch_size));
+
   // BEGIN create temporary tensor
   AllocatorPtr alloc;
   ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
-  return MultinomialComputeShared<OutputType>(alloc, X, batch_size, num_classes, num_samples, generator, Y);
+  auto cdf_data = static_cast<double*>(
+      alloc->Alloc(SafeInt<size_t>(sizeof(double)) * num_classes * num_partitions));
+  BufferUniquePtr cdf_buffer(cdf_data, BufferDeleter(std::move(alloc)));
+  // END create temporary tensor
+
+  // two samples per block
+  const auto seeds = generator.NextPhiloxSeeds(static_cast<uint64_t>((batch_size * num_samples + 1) / 2));
+  const PhiloxEngine engine(seeds.first);
+  const float* logits = X.Data<float>();
+  OutputType* output = Y.MutableData<OutputType>();
+
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_partitions, [&](std::ptrdiff_t partition) {
+    const int64_t row_begin = partition * batch_size / num_partitions;
+    const int64_t row_end = (partition + 1) * batch_size / num_partitions;
+    double* cdf_begin = cdf_data + partition * num_classes;
+    const double* cdf_end = cdf_begin + num_classes;
+    std::vector<uint32_t> bits(narrow<size_t>((num_samples / 2 + 1) * 4));
+
+    for (int64_t b = row_begin; b < row_end; ++b) {
+      const double running_total = ComputeCdf(logits + b * num_classes, num_classes, cdf_begin);
+      const int64_t first_sample = b * num_samples;
+      const int64_t first_block = first_sample / 2;
+      const int64_t last_block = (first_sample + num_samples - 1) / 2;
+      engine.Generate(seeds.second + first_block, static_cast<size_t>(last_block - first_block + 1), bits.data());
+
+      // Generate each sample.
+      for (int64_t j = 0; j < num_samples; ++j) {
+        const int64_t sample = first_sample + j;
+        const uint32_t* sample_bits = bits.data() + (sample / 2 - first_block) * 4 + (sample % 2) * 2;
+        const double to_find = PhiloxEngine::ToUniformDouble(sample_bits[0], sample_bits[1]) * running_total;
+        auto found_iter = std::upper_bound(static_cast<const double*>(cdf_begin), cdf_end, to_find);
+        output[first_sample + j] = static_cast<OutputType>(std::distance(static_cast<const double*>(cdf_begin),
+                                                                         found_iter));
+      }
+    }
+  });
+
+  return Status::OK();
 }
 
 Status Multinomial::Compute(OpKernelContext* ctx) const {
@@ -310,7 +444,6 @@ Status Multinomial::Compute(OpKernelContext* ctx) const {
   Tensor* Y = ctx->Output(0, {batch_size, num_samples_});
 
   Status status = Status::OK();
-  std::lock_guard<onnxruntime::OrtMutex> l(generator_mutex_);
   switch (output_dtype_) {
     case TensorProto::INT32: {
       status = MultinomialCompute<int32_t>(ctx, X, batch_size, num_classes, num_samples_, generator_, *Y);
@@ -347,22 +480,21 @@ static TensorProto::DataType InferDataType(const Tensor& tensor) {
 }
 
 static Status RandomNormalCompute(float mean, float scale,
-                                  std::default_random_engine& generator,
+                                  PhiloxGenerator& generator,
+                                  concurrency::ThreadPool* tp,
                                   TensorProto::DataType dtype, Tensor& Y) {
   bool handled = false;
   switch (dtype) {
     case TensorProto::FLOAT: {
       if (utils::HasType<EnabledRandomNormalComputeOutputTypes, float>()) {
-        GenerateData<float, std::normal_distribution<float>>(
-            generator, std::normal_distribution<float>{mean, scale}, Y);
+        GenerateData<float>(generator, NormalTransform<float>{mean, scale}, tp, Y);
         handled = true;
       }
       break;
     }
     case TensorProto::DOUBLE: {
       if (utils::HasType<EnabledRandomNormalComputeOutputTypes, double>()) {
-        GenerateData<double, std::normal_distribution<double>>(
-            generator, std::normal_distribution<double>{mean, scale}, Y);
+        GenerateData<double>(generator, NormalTransform<double>{mean, scale}, tp, Y);
         handled = true;
       }
       break;
@@ -379,23 +511,22 @@ static Status RandomNormalCompute(float mean, float scale,
 }
 
 static Status RandomUniformCompute(float low, float high,
-                                   std::default_random_engine& generator,
+                                   PhiloxGenerator& generator,
+                                   concurrency::ThreadPool* tp,
                                    TensorProto::DataType dtype,
                                    Tensor& Y) {
   bool handled = false;
   switch (dtype) {
     case TensorProto::FLOAT: {
       if (utils::HasType<EnabledRandomUniformComputeOutputTypes, float>()) {
-        GenerateData<float, std::uniform_real_distribution<float>>(
-            generator, std::uniform_real_distribution<float>{low, high}, Y);
+        GenerateData<float>(generator, UniformTransform<float>{low, high - low}, tp, Y);
         handled = true;
       }
       break;
     }
     case TensorProto::DOUBLE: {
       if (utils::HasType<EnabledRandomUniformComputeOutputTypes, double>()) {
-        GenerateData<double, std::uniform_real_distribution<double>>(
-            generator, std::uniform_real_distribution<double>{low, high}, Y);
+        GenerateData<double>(generator, UniformTransform<double>{low, static_cast<double>(high) - low}, tp, Y);
         handled = true;
       }
       break;
@@ -411,15 +542,6 @@ static Status RandomUniformCompute(float low, float high,
   return Status::OK();
 }
 
-template <typename T, typename TDistribution>
-void GenerateData(std::default_random_engine& generator, TDistribution distribution, Tensor& tensor) {
-  T* out = tensor.MutableData<T>();
-  for (int64_t i = 0, end = tensor.Shape().Size(); i < end; ++i) {
-    *out = distribution(generator);
-    ++out;
-  }
-}
-
 template Status MultinomialComputeShared<int64_t>(AllocatorPtr& alloc,
                                                   const Tensor& X,
                                                   const int64_t batch_size,
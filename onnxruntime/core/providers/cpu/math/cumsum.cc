@@ -3,49 +3,90 @@
 
 #include "cumsum.h"
 #include "core/providers/common.h"
-#include "core/providers/cpu/tensor/utils.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
 
 using namespace onnxruntime;
 
 namespace {
-// static section
-std::vector<int64_t> GetStarts(int64_t rank, int64_t axis, int64_t index) {
-  std::vector<int64_t> starts(onnxruntime::narrow<size_t>(rank), 0);
-  starts[onnxruntime::narrow<size_t>(axis)] = index;
-  return starts;
-}
-template <typename T>
-void ZeroOutSliceAtIndex(Tensor& output, int64_t rank, int64_t axis, int64_t index,
-                         gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  T zero{};
-  auto output_starts(GetStarts(rank, axis, index));
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator) {
-    *output_iterator = zero;
-  }
-}
+// The minimum number of elements in each block of a row that is scanned on several threads.
+constexpr int64_t kMinScanBlockSize = 16 * 1024;
+
+// Scans the columns [first, last) of the input viewed as [outer, dim, inner], where column c is the index c % inner
+// of the outer row c / inner. Consecutive columns are contiguous in memory, so the inner loop vectorizes.
 template <typename T>
-void CopySlices(const Tensor& input, Tensor& output,
-                const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts,
-                gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator) {
-    *output_iterator = *input_iterator;
+void ScanColumns(const T* input, T* output, int64_t dim, int64_t inner, std::ptrdiff_t first, std::ptrdiff_t last,
+                 bool exclusive, bool reverse) {
+  const int64_t step = reverse ? -inner : inner;
+  while (first < last) {
+    const int64_t inner_begin = first % inner;
+    const int64_t count = std::min<int64_t>(inner - inner_begin, last - first);
+    const int64_t row_offset = (first / inner) * dim * inner + inner_begin;
+    const T* row_input = input + row_offset;
+    T* row_output = output + row_offset;
+
+    // the first output slice is zero if exclusive, else a copy of the first input slice
+    int64_t index = reverse ? (dim - 1) * inner : 0;
+    if (exclusive) {
+      std::fill_n(row_output + index, count, T{});
+    } else {
+      std::copy_n(row_input + index, count, row_output + index);
+    }
+
+    // each next output slice is the sum of the previous output slice and the corresponding input slice
+    for (int64_t k = 1; k < dim; ++k) {
+      const T* previous_output = row_output + index;
+      const T* current_input = row_input + (exclusive ? index : index + step);
+      index += step;
+      T* current_output = row_output + index;
+      for (int64_t i = 0; i < count; ++i) {
+        current_output[i] = previous_output[i] + current_input[i];
+      }
+    }
+
+    first += count;
   }
 }
+
+// Scans a single contiguous row in num_blocks blocks: the sums of the blocks are computed in parallel, then each
+// block is scanned in parallel starting from the sum of the blocks before it.
+// N.B. the floating point results may differ in the last bits from a serial scan as the additions are reordered.
 template <typename T>
-void SumSlices(const Tensor& input, Tensor& output,
-               const std::vector<int64_t>& input_starts, const std::vector<int64_t>& output_starts, const std::vector<int64_t>& previous_output_starts,
-               gsl::span<const int64_t> slice_dims, const std::vector<int64_t>& steps, const int64_t slice_size) {
-  SliceIterator<T> input_iterator(input, input_starts, slice_dims, steps);
-  WritableSliceIterator<T> output_iterator(output, output_starts, slice_dims, steps);
-  SliceIterator<T> previous_output_iterator(output, previous_output_starts, slice_dims, steps);
-  for (int64_t k = 0; k < slice_size; ++k, ++output_iterator, ++input_iterator, ++previous_output_iterator) {
-    *output_iterator = *input_iterator + *previous_output_iterator;
+void ScanRowInBlocks(const T* input, T* output, int64_t dim, bool exclusive, bool reverse,
+                     concurrency::ThreadPool* tp, int64_t num_blocks) {
+  // block b covers the positions [b * dim / num_blocks, (b + 1) * dim / num_blocks) in scan order
+  const auto block_begin = [dim, num_blocks](std::ptrdiff_t block) { return block * dim / num_blocks; };
+  const auto position = [dim, reverse](int64_t k) { return reverse ? dim - 1 - k : k; };
+
+  std::vector<T> block_offsets(onnxruntime::narrow<size_t>(num_blocks), T{});
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks - 1, [&](std::ptrdiff_t block) {
+    T sum{};
+    for (int64_t k = block_begin(block), end = block_begin(block + 1); k < end; ++k) {
+      sum += input[position(k)];
+    }
+    block_offsets[block + 1] = sum;
+  });
+
+  for (int64_t block = 1; block < num_blocks; ++block) {
+    block_offsets[block] += block_offsets[block - 1];
   }
+
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+    T sum = block_offsets[block];
+    for (int64_t k = block_begin(block), end = block_begin(block + 1); k < end; ++k) {
+      const int64_t i = position(k);
+      if (exclusive) {
+        output[i] = sum;
+        sum += input[i];
+      } else {
+        sum += input[i];
+        output[i] = sum;
+      }
+    }
+  });
 }
 }  // namespace
 
@@ -200,65 +241,36 @@ Status CumSum<T>::Compute(OpKernelContext* ctx) const {
   int64_t axis = 0;
   ORT_THROW_IF_ERROR(cumsum_op::GetAxis(axis_tensor, rank, axis));
 
-  auto dim(output_tensor.Shape()[onnxruntime::narrow<size_t>(axis)]);  // dimension size for the axis
-  TensorShape slice_shape(input->Shape());                             // the shape of one slice of input/output for the given value of the axis
-  slice_shape[onnxruntime::narrow<size_t>(axis)] = 1;
-  auto slice_size(slice_shape.Size());     // total number of elements in each slice
-  auto slice_dims(slice_shape.GetDims());  // dim array for the slice
-
-  std::vector<int64_t> steps(onnxruntime::narrow<size_t>(rank), 1);  // steps for the slice -- always set to 1
-
-  if (!reverse_) {
-    int64_t index(0);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      ++index;
-    }
-
-    if (index < dim) {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, 0));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      ++index;
-    }
-
-    for (; index < dim; ++index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index - 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index - 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
-    }
-  } else {
-    //_reverse == true
-    int64_t index(dim - 1);  // the index we use as we walkthrough the given axis
-    // If (exclusive == true) the first slice is always 0
-    if (exclusive_) {
-      ::ZeroOutSliceAtIndex<T>(output_tensor, rank, axis, index, slice_dims, steps, slice_size);
-      --index;
-    }
-
-    if (index >= 0) {
-      // The next slice is a copy of the input (if exclusive == false then this is the first slice)
-      auto input_starts(::GetStarts(rank, axis, dim - 1));
-      auto output_starts(::GetStarts(rank, axis, index));
-      ::CopySlices<T>(*input, output_tensor, input_starts, output_starts, slice_dims, steps, slice_size);
-      --index;
-    }
-
-    for (; index >= 0; --index) {
-      // Each output slice is the sum of corresponding input slice and the previous output slice
-      auto input_starts(::GetStarts(rank, axis, exclusive_ ? index + 1 : index));
-      auto output_starts(::GetStarts(rank, axis, index));
-      auto previous_starts(::GetStarts(rank, axis, index + 1));
-      ::SumSlices<T>(*input, output_tensor, input_starts, output_starts, previous_starts,
-                     slice_dims, steps, slice_size);
+  const auto axis_index = onnxruntime::narrow<size_t>(axis);
+  const int64_t dim = output_shape[axis_index];  // dimension size for the axis
+  const int64_t outer = output_shape.SizeToDimension(axis_index);
+  const int64_t inner = output_shape.SizeFromDimension(axis_index + 1);
+  const T* input_data = input->Data<T>();
+  T* output_data = output_tensor.MutableData<T>();
+  const bool exclusive = exclusive_ != 0;
+  const bool reverse = reverse_ != 0;
+
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+  const int64_t num_columns = outer * inner;
+
+  // a few long rows don't have enough columns to keep the threads busy, so scan each of them in blocks instead
+  const int64_t num_blocks = std::min<int64_t>(concurrency::ThreadPool::DegreeOfParallelism(tp),
+                                               dim / kMinScanBlockSize);
+  if (inner == 1 && num_columns < num_blocks) {
+    for (int64_t row = 0; row < outer; ++row) {
+      ScanRowInBlocks(input_data + row * dim, output_data + row * dim, dim, exclusive, reverse, tp, num_blocks);
     }
+    return Status::OK();
   }
 
+  const auto column_size = static_cast<double>(dim * sizeof(T));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(num_columns),
+      TensorOpCost{column_size, column_size, static_cast<double>(dim)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        ScanColumns(input_data, output_data, dim, inner, first, last, exclusive, reverse);
+      });
+
   return Status::OK();
 }
 
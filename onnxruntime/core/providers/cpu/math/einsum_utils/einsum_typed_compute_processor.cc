@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "einsum_typed_compute_processor.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
 #include "core/common/narrow.h"
 #include "core/common/span_utils.h"
 
@@ -343,6 +347,123 @@ void EinsumTypedComputeProcessor<T>::SetDeviceHelpers(const EinsumOp::DeviceHelp
   device_data_copy_func_ = device_data_copy_func;
 }
 
+// Chooses the order in which the operands are contracted. The path is left-deep (the running result is always
+// one side of the pair, as PairwiseOperandProcess() expects) and greedy: the first pair and then each next operand
+// are picked so that the intermediate result is as small as possible, in the spirit of opt_einsum's greedy path.
+// Ties keep the input order, so equations whose candidate intermediates are all the same size run as before.
+// `label_to_last_input_pos` receives, for each subscript label that is not in the output, the position in the
+// returned order after which the label can be reduced (-1 for labels that are in the output).
+static InlinedVector<size_t> GetContractionOrder(gsl::span<const TensorShape> input_dims,
+                                                 gsl::span<const int64_t> label_to_last_input,
+                                                 InlinedVector<int64_t>& label_to_last_input_pos) {
+  const size_t num_inputs = input_dims.size();
+  const size_t num_labels = label_to_last_input.size();
+
+  InlinedVector<size_t> order(num_inputs);
+  std::iota(order.begin(), order.end(), size_t{0});
+
+  // An input takes part in the reduction of a label if it has a non-trivial dim along it
+  // (inputs with a dim value of 1 are broadcast along the label).
+  // The last input holding the label in the equation always does, so the input order reduces where it did before.
+  auto holds = [&](size_t input, size_t label) {
+    return input_dims[input][label] > 1 || label_to_last_input[label] == static_cast<int64_t>(input);
+  };
+
+  if (num_inputs > 2) {
+    // Number of the inputs not contracted yet that take part in the reduction of each label
+    InlinedVector<int64_t> pending(num_labels, 0);
+    for (size_t label = 0; label < num_labels; ++label) {
+      for (size_t input = 0; label_to_last_input[label] != -1 && input < num_inputs; ++input) {
+        pending[label] += holds(input, label) ? 1 : 0;
+      }
+    }
+
+    auto contract = [&](gsl::span<const int64_t> left_dims, size_t right, InlinedVector<int64_t>& result_dims) {
+      double size = 1.;
+      result_dims.resize(num_labels);
+      for (size_t label = 0; label < num_labels; ++label) {
+        const bool reduced = label_to_last_input[label] != -1 && pending[label] - (holds(right, label) ? 1 : 0) == 0;
+        result_dims[label] = reduced ? 1 : std::max(left_dims[label], input_dims[right][label]);
+        size *= static_cast<double>(result_dims[label]);
+      }
+      return size;
+    };
+    auto update_pending = [&](size_t input, int64_t delta) {
+      for (size_t label = 0; label < num_labels; ++label) {
+        pending[label] += (label_to_last_input[label] != -1 && holds(input, label)) ? delta : 0;
+      }
+    };
+
+    InlinedVector<int64_t> current_dims;
+    InlinedVector<int64_t> candidate_dims;
+    InlinedVector<int64_t> best_dims;
+
+    // The first pair
+    double best_size = std::numeric_limits<double>::infinity();
+    size_t best_left = 0;
+    size_t best_right = 1;
+    for (size_t left = 0; left < num_inputs; ++left) {
+      const auto dims = input_dims[left].GetDims();
+      update_pending(left, -1);
+      for (size_t right = left + 1; right < num_inputs; ++right) {
+        const double size = contract(dims, right, candidate_dims);
+        if (size < best_size) {
+          best_size = size;
+          best_left = left;
+          best_right = right;
+          best_dims = candidate_dims;
+        }
+      }
+      update_pending(left, 1);
+    }
+
+    InlinedVector<bool> contracted(num_inputs, false);
+    order.clear();
+    for (size_t input : {best_left, best_right}) {
+      order.push_back(input);
+      contracted[input] = true;
+      update_pending(input, -1);
+    }
+    current_dims = best_dims;
+
+    // Each next operand
+    while (order.size() < num_inputs) {
+      best_size = std::numeric_limits<double>::infinity();
+      size_t best = 0;
+      for (size_t input = 0; input < num_inputs; ++input) {
+        if (contracted[input]) {
+          continue;
+        }
+        const double size = contract(current_dims, input, candidate_dims);
+        if (size < best_size) {
+          best_size = size;
+          best = input;
+          best_dims = candidate_dims;
+        }
+      }
+      order.push_back(best);
+      contracted[best] = true;
+      update_pending(best, -1);
+      current_dims = best_dims;
+    }
+  }
+
+  InlinedVector<int64_t> input_to_pos(num_inputs);
+  for (size_t pos = 0; pos < num_inputs; ++pos) {
+    input_to_pos[order[pos]] = static_cast<int64_t>(pos);
+  }
+  label_to_last_input_pos.assign(num_labels, -1);
+  for (size_t label = 0; label < num_labels; ++label) {
+    for (size_t input = 0; label_to_last_input[label] != -1 && input < num_inputs; ++input) {
+      if (holds(input, label)) {
+        label_to_last_input_pos[label] = std::max(label_to_last_input_pos[label], input_to_pos[input]);
+      }
+    }
+  }
+
+  return order;
+}
+
 template <typename T>
 Status EinsumTypedComputeProcessor<T>::Run() {
   const auto& mapped_indices_to_last_input_index = einsum_compute_preprocessor_.GetMappedSubscriptIndicesToLastInputIndex();
@@ -357,7 +478,13 @@ Status EinsumTypedComputeProcessor<T>::Run() {
 
   auto num_inputs = context_->InputCount();
 
-  // Pre-process the first input so as to reduce any dims that only it has
+  // For 3 or more operands, contract them in an order that keeps the intermediate results small
+  InlinedVector<int64_t> mapped_indices_to_last_contracted_pos;
+  const auto contraction_order = GetContractionOrder(homogenized_input_dims, mapped_indices_to_last_input_index,
+                                                     mapped_indices_to_last_contracted_pos);
+  const size_t first = contraction_order[0];
+
+  // Pre-process the first operand to be contracted so as to reduce any dims that only it has
   std::unique_ptr<const Tensor> result;
 
   {
@@ -368,7 +495,7 @@ Status EinsumTypedComputeProcessor<T>::Run() {
     preserved_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));  // num_subscript_labels is the upper bound. No harm in over-reserving.
 
     for (size_t i = 0; i < onnxruntime::narrow<size_t>(num_subscript_labels); ++i) {
-      if (mapped_indices_to_last_input_index[i] == 0) {
+      if (mapped_indices_to_last_contracted_pos[i] == 0) {
         reduced_dims.push_back(i);
       } else {
         preserved_dims.push_back(i);
@@ -377,14 +504,14 @@ Status EinsumTypedComputeProcessor<T>::Run() {
 
     // Reduce the dims that are last seen in the first input alone
     if (reduced_dims.size() != 0) {
-      result = EinsumOp::ReduceSum<T>(preprocessed_inputs[0] ? *preprocessed_inputs[0] : *raw_inputs[0],
-                                      homogenized_input_dims[0].GetDims(), reduced_dims, allocator_, tp_,
+      result = EinsumOp::ReduceSum<T>(preprocessed_inputs[first] ? *preprocessed_inputs[first] : *raw_inputs[first],
+                                      homogenized_input_dims[first].GetDims(), reduced_dims, allocator_, tp_,
                                       einsum_ep_assets_, device_reduce_sum_func_);
     } else {
       // Check if there is a pre-processed version of this input
       // If so assign it to result
-      if (preprocessed_inputs[0]) {
-        result = std::move(preprocessed_inputs[0]);
+      if (preprocessed_inputs[first]) {
+        result = std::move(preprocessed_inputs[first]);
       }
     }
 
@@ -402,21 +529,22 @@ Status EinsumTypedComputeProcessor<T>::Run() {
   {
     bool is_final_pair = false;
     // Keep processing each input pair-wise
-    for (int input = 1; input < num_inputs; ++input) {
+    for (int pos = 1; pos < num_inputs; ++pos) {
+      const size_t input = contraction_order[pos];
       TensorShapeVector reduced_dims;
       reduced_dims.reserve(onnxruntime::narrow<size_t>(num_subscript_labels));  // num_subscript_labels is the upper bound. No harm in over-reserving by a small margin.
       for (int64_t dim = 0; dim < num_subscript_labels; ++dim) {
-        if (mapped_indices_to_last_input_index[onnxruntime::narrow<size_t>(dim)] == input) {
+        if (mapped_indices_to_last_contracted_pos[onnxruntime::narrow<size_t>(dim)] == pos) {
           // This is the last input we are seeing this dimension (and it doesn't occur in the output), so reduce along the dimension
           reduced_dims.push_back(dim);
         }
       }
-      if (input == num_inputs - 1) {
+      if (pos == num_inputs - 1) {
         is_final_pair = true;
       }
       // Use either the preprocessed inputs (if it is available) or the corresponding raw inputs
-      result = PairwiseOperandProcess(result ? *result : *raw_inputs[0],
-                                      result ? result->Shape() : homogenized_input_dims[0],
+      result = PairwiseOperandProcess(result ? *result : *raw_inputs[first],
+                                      result ? result->Shape() : homogenized_input_dims[first],
                                       preprocessed_inputs[input] ? *preprocessed_inputs[input] : *raw_inputs[input],
                                       homogenized_input_dims[input],
                                       reduced_dims, is_final_pair);
@@ -74,6 +74,13 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
   float* output_ptr = output + first;
   MlasComputeExp(input + first, output_ptr, static_cast<size_t>(len));
 }
+
+template <>
+void Log<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
+  ptrdiff_t len = last - first;
+  float* output_ptr = output + first;
+  MlasComputeLog(input + first, output_ptr, static_cast<size_t>(len));
+}
 }  // namespace functors
 
 #define REG_ELEMENTWISE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)         \
@@ -84,6 +91,47 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
       KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       KERNEL_CLASS<TYPE>);
 
+// The kernels of the unary and binary arithmetic operators compute each output element from the input elements
+// at the same position, or from a broadcast input, so the output may reuse the buffer of an input with the same size.
+// The allocation planner picks an input whose last use is the node.
+#define REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS)            \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                                   \
+      OP_TYPE,                                                                                      \
+      VERSION,                                                                                      \
+      TYPE,                                                                                         \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      KERNEL_CLASS<TYPE>);
+
+#define REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                                                         \
+      OP_TYPE,                                                                                                      \
+      VERSION_FROM, VERSION_TO,                                                                                     \
+      TYPE,                                                                                                         \
+      KernelDefBuilder().MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                 \
+      KERNEL_CLASS<TYPE>);
+
+#define REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                         \
+      OP_TYPE,                                                                            \
+      VERSION,                                                                            \
+      TYPE,                                                                               \
+      KernelDefBuilder()                                                                  \
+          .MayInplace(0, 0)                                                               \
+          .MayInplace(1, 0)                                                               \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                      \
+      KERNEL_CLASS<TYPE>);
+
+#define REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(OP_TYPE, VERSION_FROM, VERSION_TO, TYPE, KERNEL_CLASS) \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                                                          \
+      OP_TYPE,                                                                                                       \
+      VERSION_FROM, VERSION_TO,                                                                                      \
+      TYPE,                                                                                                          \
+      KernelDefBuilder()                                                                                             \
+          .MayInplace(0, 0)                                                                                          \
+          .MayInplace(1, 0)                                                                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()),                                                 \
+      KERNEL_CLASS<TYPE>);
+
 #define REG_ELEMENTWISE_LOGICALOP_TYPED_KERNEL(OP_TYPE, VERSION, TYPE, KERNEL_CLASS) \
   ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                    \
       OP_TYPE,                                                                       \
@@ -153,110 +201,110 @@ void Exp<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const {
           .TypeConstraint("T1", T2_CONSTRAINTS),                                                 \
       KERNEL_CLASS);
 
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, float, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, double, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int32_t, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int64_t, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, float, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, double, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int32_t, Add);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int64_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, float, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, double, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, int32_t, Add);
-REG_ELEMENTWISE_TYPED_KERNEL(Add, 14, int64_t, Add);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, float, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, double, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int32_t, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int64_t, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, float, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, double, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int32_t, Sub);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int64_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, float, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, double, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, int32_t, Sub);
-REG_ELEMENTWISE_TYPED_KERNEL(Sub, 14, int64_t, Sub);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, float, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, double, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int32_t, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int64_t, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, float, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, double, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int32_t, Mul);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int64_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, float, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, double, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, int32_t, Mul);
-REG_ELEMENTWISE_TYPED_KERNEL(Mul, 14, int64_t, Mul);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, float, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, double, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int32_t, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int64_t, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, float, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, double, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int32_t, Div);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int64_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, float, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, double, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, int32_t, Div);
-REG_ELEMENTWISE_TYPED_KERNEL(Div, 14, int64_t, Div);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, float, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, double, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int8_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int16_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int32_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int64_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint8_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint16_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint32_t, Abs);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint64_t, Abs);
-
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, float, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, double, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, int64_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint8_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint16_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint32_t, Abs);
-REG_ELEMENTWISE_TYPED_KERNEL(Abs, 13, uint64_t, Abs);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, float, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, double, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int8_t, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int32_t, Neg);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int64_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, float, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, double, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, int8_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, int32_t, Neg);
-REG_ELEMENTWISE_TYPED_KERNEL(Neg, 13, int64_t, Neg);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, float, Floor);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, double, Floor);
-REG_ELEMENTWISE_TYPED_KERNEL(Floor, 13, float, Floor);
-REG_ELEMENTWISE_TYPED_KERNEL(Floor, 13, double, Floor);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, float, Ceil);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, double, Ceil);
-REG_ELEMENTWISE_TYPED_KERNEL(Ceil, 13, float, Ceil);
-REG_ELEMENTWISE_TYPED_KERNEL(Ceil, 13, double, Ceil);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, float, Reciprocal);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, double, Reciprocal);
-REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 13, float, Reciprocal);
-REG_ELEMENTWISE_TYPED_KERNEL(Reciprocal, 13, double, Reciprocal);
-
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, float, Sqrt);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, double, Sqrt);
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 13, float, Sqrt);
-REG_ELEMENTWISE_TYPED_KERNEL(Sqrt, 13, double, Sqrt);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, float, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, double, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int32_t, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 7, 12, int64_t, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, float, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, double, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int32_t, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Add, 13, 13, int64_t, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Add, 14, float, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Add, 14, double, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Add, 14, int32_t, Add);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Add, 14, int64_t, Add);
+
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, float, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, double, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int32_t, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 7, 12, int64_t, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, float, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, double, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int32_t, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Sub, 13, 13, int64_t, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, float, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, double, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, int32_t, Sub);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Sub, 14, int64_t, Sub);
+
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, float, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, double, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int32_t, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 7, 12, int64_t, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, float, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, double, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int32_t, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Mul, 13, 13, int64_t, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, float, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, double, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, int32_t, Mul);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Mul, 14, int64_t, Mul);
+
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, float, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, double, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int32_t, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 7, 12, int64_t, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, float, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, double, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int32_t, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_VERSIONED_TYPED_KERNEL(Div, 13, 13, int64_t, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Div, 14, float, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Div, 14, double, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Div, 14, int32_t, Div);
+REG_ELEMENTWISE_BINARY_INPLACE_TYPED_KERNEL(Div, 14, int64_t, Div);
+
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, float, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, double, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int8_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int16_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int32_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, int64_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint8_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint16_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint32_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Abs, 6, 12, uint64_t, Abs);
+
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, float, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, double, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int8_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int16_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int32_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, int64_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint8_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint16_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint32_t, Abs);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Abs, 13, uint64_t, Abs);
+
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, float, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, double, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int8_t, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int32_t, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Neg, 6, 12, int64_t, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, float, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, double, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, int8_t, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, int32_t, Neg);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Neg, 13, int64_t, Neg);
+
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, float, Floor);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Floor, 6, 12, double, Floor);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Floor, 13, float, Floor);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Floor, 13, double, Floor);
+
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, float, Ceil);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Ceil, 6, 12, double, Ceil);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Ceil, 13, float, Ceil);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Ceil, 13, double, Ceil);
+
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, float, Reciprocal);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Reciprocal, 6, 12, double, Reciprocal);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Reciprocal, 13, float, Reciprocal);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Reciprocal, 13, double, Reciprocal);
+
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, float, Sqrt);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Sqrt, 6, 12, double, Sqrt);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Sqrt, 13, float, Sqrt);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Sqrt, 13, double, Sqrt);
 
 REG_ELEMENTWISE_VERSIONED_KERNEL_NONT(Pow, 7, 11, Pow,
                                       BuildKernelDefConstraintsFromTypeList<EnabledPow7Types>());
@@ -273,15 +321,15 @@ REG_ELEMENTWISE_KERNEL_NONT_2(Pow, 15, Pow,
                               BuildKernelDefConstraintsFromTypeList<EnabledPow12BaseTypes>(),
                               BuildKernelDefConstraintsFromTypeList<EnabledPow12ExpTypes>());
 
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, float, Exp);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, double, Exp);
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 13, float, Exp);
-REG_ELEMENTWISE_TYPED_KERNEL(Exp, 13, double, Exp);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, float, Exp);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Exp, 6, 12, double, Exp);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Exp, 13, float, Exp);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Exp, 13, double, Exp);
 
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Log, 6, 12, float, Log);
-REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Log, 6, 12, double, Log);
-REG_ELEMENTWISE_TYPED_KERNEL(Log, 13, float, Log);
-REG_ELEMENTWISE_TYPED_KERNEL(Log, 13, double, Log);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Log, 6, 12, float, Log);
+REG_ELEMENTWISE_UNARY_INPLACE_VERSIONED_TYPED_KERNEL(Log, 6, 12, double, Log);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Log, 13, float, Log);
+REG_ELEMENTWISE_UNARY_INPLACE_TYPED_KERNEL(Log, 13, double, Log);
 
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sum, 6, 7, float, Sum_6);
 REG_ELEMENTWISE_VERSIONED_TYPED_KERNEL(Sum, 6, 7, double, Sum_6);
@@ -748,7 +796,8 @@ static Status MinMaxMLFloat16(const OpKernel& inst, OpKernelContext* context) {
 
   ProcessBroadcastSpanFuncs funcs{
       [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.NumOutputElements();
+        // this span may only be part of the output
+        auto num_elements = per_iter_bh.OutputEigen<MLFloat16>().size();
 
         const auto* input_1 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput1<MLFloat16>().data());
         ConstEigenVectorArrayMap<Eigen::half> input_1_vec_map(input_1, num_elements);
@@ -763,7 +812,7 @@ static Status MinMaxMLFloat16(const OpKernel& inst, OpKernelContext* context) {
         }
       },
       [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.NumOutputElements();
+        auto num_elements = per_iter_bh.OutputEigen<MLFloat16>().size();
 
         const auto* input_0 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput0<MLFloat16>().data());
         ConstEigenVectorArrayMap<Eigen::half> input_0_vec_map(input_0, num_elements);
@@ -778,7 +827,7 @@ static Status MinMaxMLFloat16(const OpKernel& inst, OpKernelContext* context) {
         }
       },
       [](BroadcastHelper& per_iter_bh) {
-        auto num_elements = per_iter_bh.NumOutputElements();
+        auto num_elements = per_iter_bh.OutputEigen<MLFloat16>().size();
 
         const auto* input_0 = reinterpret_cast<const Eigen::half*>(per_iter_bh.EigenInput0<MLFloat16>().data());
         ConstEigenVectorArrayMap<Eigen::half> input_0_vec_map(input_0, num_elements);
@@ -857,12 +906,7 @@ struct Max_8::ComputeImpl {
         }};
 
     int input_count = inst.Node().InputArgCount().front();
-    // TODO: Parallelize across spans in UntypedBroadcastVariadic to avoid specific logic here
-    if (input_count == 2) {
-      UntypedBroadcastTwo(*context, funcs, 1.0);
-    } else {
-      UntypedBroadcastVariadic(input_count, *context, typed_allocator, funcs);
-    }
+    UntypedBroadcastVariadic(input_count, *context, typed_allocator, funcs);
 
     return Status::OK();
   }
@@ -1945,6 +1989,70 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
   BroadcastLooper(broadcast_helper, funcs);
 }
 
+// Broadcast the two inputs into output_tensor, partitioning the flattened output across threads.
+// A partition may start or end part way through a span, in which case that part of the span is processed the
+// same way as when parallelizing within a single span.
+static void ParallelBroadcastTwo(const InputBroadcaster& input_broadcaster, Tensor& output_tensor,
+                                 const ProcessBroadcastSpanFuncs& funcs, concurrency::ThreadPool* tp,
+                                 double unit_cost, void* user_data) {
+  const size_t span_size = input_broadcaster.GetSpanSize();
+  const size_t output_size = narrow<size_t>(output_tensor.Shape().Size());
+
+  // one or more zero dimensions so nothing more to do
+  if (output_size == 0) {
+    return;
+  }
+
+  if (span_size == output_size) {  // Input data will be processed in a single span, so parallelize within the span
+    InputBroadcaster single_span_input_broadcaster(input_broadcaster);
+    OutputBroadcaster output_broadcaster(span_size, output_tensor);
+    BroadcastHelper broadcast_helper(single_span_input_broadcaster, output_broadcaster, user_data, tp, unit_cost);
+    BroadcastLooper(broadcast_helper, funcs);
+    return;
+  }
+
+  // every span has the same layout, so the span function can be chosen once
+  const ProcessSpanFunc process_span = input_broadcaster.IsInput0Scalar()   ? funcs.input0scalar
+                                       : input_broadcaster.IsInput1Scalar() ? funcs.input1scalar
+                                                                            : funcs.general;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(output_size),
+      TensorOpCost{static_cast<double>(std::max(input_broadcaster.Input0ElementSize(),
+                                                input_broadcaster.Input1ElementSize())),
+                   static_cast<double>(output_tensor.DataType()->Size()),
+                   unit_cost},
+      [span_size, process_span, &input_broadcaster, &output_tensor, user_data](std::ptrdiff_t first,
+                                                                              std::ptrdiff_t last) {
+        const size_t first_span = static_cast<size_t>(first) / span_size;
+        const size_t end_span = (static_cast<size_t>(last) + span_size - 1) / span_size;
+
+        // copy original input_broadcaster (which is at start of all input) and advance to this segment
+        InputBroadcaster segment_input_broadcaster(input_broadcaster);
+        segment_input_broadcaster.AdvanceBy(first_span * span_size);
+
+        // create broadcaster for the spans this segment of output touches
+        OutputBroadcaster segment_output_broadcaster(span_size, output_tensor,
+                                                     first_span * span_size, end_span * span_size);
+        BroadcastHelper segment_helper(segment_input_broadcaster, segment_output_broadcaster, user_data);
+
+        for (size_t span = first_span; span < end_span; ++span) {
+          const size_t span_start = span * span_size;
+          const size_t begin = std::max(static_cast<size_t>(first), span_start) - span_start;
+          const size_t end = std::min(static_cast<size_t>(last), span_start + span_size) - span_start;
+
+          if (begin == 0 && end == span_size) {
+            process_span(segment_helper);
+          } else {
+            BroadcastHelper partial_span_helper(segment_helper, begin, end - begin);
+            process_span(partial_span_helper);
+          }
+
+          segment_helper.Next();
+        }
+      });
+}
+
 // Variant of UntypedBroadcastTwo that will parallelize.
 // Operator usage is the same as the parallelization is opaque to the operator.
 // unit_cost must be a valid cost value.
@@ -1956,45 +2064,8 @@ void UntypedBroadcastTwo(OpKernelContext& context, const ProcessBroadcastSpanFun
 
   Tensor& output_tensor = *context.Output(0, input_broadcaster.GetOutputShape());
 
-  size_t span_size = input_broadcaster.GetSpanSize();
-  size_t output_size = static_cast<ptrdiff_t>(output_tensor.Shape().Size());
-
-  // one or more zero dimensions so nothing more to do
-  if (output_size == 0) {
-    return;
-  }
-
-  concurrency::ThreadPool* tp = context.GetOperatorThreadPool();
-
-  if (span_size == output_size) {  // Input data will be processed in a single span, so parallelize within the span
-    OutputBroadcaster output_broadcaster(span_size, output_tensor);
-    BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster, user_data, tp, unit_cost);
-    BroadcastLooper(broadcast_helper, funcs);
-  } else {
-    // Input data will be processed in multiple spans, so parallelize across spans.
-
-    // enforce const on input broadcaster we copy from
-    const InputBroadcaster& const_input_broadcaster = input_broadcaster;
-
-    concurrency::ThreadPool::TryParallelFor(
-        tp, output_size / span_size,
-        TensorOpCost{static_cast<double>(input_broadcaster.Input0ElementSize()) * span_size,
-                     static_cast<double>(output_tensor.DataType()->Size()) * span_size,
-                     unit_cost * span_size},
-        [span_size, &const_input_broadcaster, &output_tensor, &funcs, user_data](std::ptrdiff_t first_span,
-                                                                                 std::ptrdiff_t last_span) {
-          // copy original input_broadcaster (which is at start of all input) and advance to this segment
-          InputBroadcaster segment_input_broadcaster(const_input_broadcaster);
-          segment_input_broadcaster.AdvanceBy(first_span * span_size);
-
-          // create broadcaster for this segment of output
-          OutputBroadcaster segment_output_broadcaster(span_size, output_tensor,
-                                                       first_span * span_size, last_span * span_size);
-
-          BroadcastHelper segment_helper(segment_input_broadcaster, segment_output_broadcaster, user_data);
-          BroadcastLooper(segment_helper, funcs);
-        });
-  }
+  ParallelBroadcastTwo(input_broadcaster, output_tensor, funcs, context.GetOperatorThreadPool(), unit_cost,
+                       user_data);
 }
 
 // allocate_tensor should allocate a tensor of the output type with the given shape
@@ -2010,33 +2081,42 @@ static void UntypedBroadcastVariadic(int input_count, OpKernelContext& context,
     return;
   }
 
+  // The output shape is the broadcast of all the inputs. Once the running result has that shape it is accumulated
+  // in place in the output, as each output element then only depends on the same element of the running result.
+  TensorShape output_shape = input0.Shape();
+  for (int i = 1; i < input_count; i++) {
+    output_shape = TensorShape(Broadcaster(output_shape.GetDims(), context.Input<Tensor>(i)->Shape().GetDims())
+                                   .output_shape_);
+  }
+
+  Tensor& output = *context.Output(0, output_shape);
+  concurrency::ThreadPool* tp = context.GetOperatorThreadPool();
+
   TensorAllocator tensor_allocator(context);
   std::unique_ptr<Tensor> temp_input;
   std::unique_ptr<Tensor> temp_output;
+  const Tensor* running_result = &input0;
 
   // For more than 2 tensors, we combine the the current two inputs into a temporary tensor,
   // and combine the next input with that
   for (int i = 0; i < input_count - 1; i++) {
-    auto& tensor0 = temp_input ? *temp_input : input0;
-    auto& tensor1 = *context.Input<Tensor>(i + 1);
+    const auto& tensor1 = *context.Input<Tensor>(i + 1);
 
-    InputBroadcaster input_broadcaster(tensor0, tensor1);
+    InputBroadcaster input_broadcaster(*running_result, tensor1);
 
-    // Create a temporary output for all but the last iteration, which goes to the real output
-    Tensor* p_output = nullptr;
-    if (i == input_count - 2) {
-      p_output = context.Output(0, input_broadcaster.GetOutputShape());
-    } else {
+    // Only use a temporary output while the running result is smaller than the final output
+    Tensor* p_output = &output;
+    if (input_broadcaster.GetOutputShape() != output_shape) {
       temp_output = allocate_tensor(tensor_allocator, input_broadcaster.GetOutputShape());
       p_output = temp_output.get();
     }
 
-    OutputBroadcaster output_broadcaster(input_broadcaster.GetSpanSize(), *p_output);
-    BroadcastHelper broadcast_helper(input_broadcaster, output_broadcaster);
+    ParallelBroadcastTwo(input_broadcaster, *p_output, funcs, tp, 1.0, nullptr);
 
-    BroadcastLooper(broadcast_helper, funcs);
-
-    temp_input = std::move(temp_output);
+    running_result = p_output;
+    if (temp_output) {
+      temp_input = std::move(temp_output);
+    }
   }
 }
 
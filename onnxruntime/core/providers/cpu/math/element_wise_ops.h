@@ -41,6 +41,9 @@ struct Log final : public ElementWiseRangedTransform<T> {
   }
 };
 
+template <>
+void Log<float>::operator()(std::ptrdiff_t first, std::ptrdiff_t last) const;
+
 template <typename T>
 struct Abs final : public ElementWiseRangedTransform<T> {
   Status Init(const onnxruntime::NodeAttributes) {
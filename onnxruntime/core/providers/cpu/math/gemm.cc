@@ -12,6 +12,31 @@
 
 namespace onnxruntime {
 
+namespace {
+// Applies the activation of a fused Gemm to the tiles of the output completed by MLAS.
+// The tiles are processed concurrently, so the functor is bound to the whole output once and only called
+// on the range of each row of the tile.
+class GemmActivationProcessor : public MLAS_GEMM_POSTPROCESSOR<float> {
+ public:
+  GemmActivationProcessor(const functors::ElementWiseRangedTransform<float>& activation, float* y_data)
+      : activation_(activation.Copy()) {
+    activation_->input = y_data;
+    activation_->output = y_data;
+  }
+
+  void Process(float* /*C*/, size_t start_m, size_t start_n, size_t count_m, size_t count_n,
+               size_t ldc) const override {
+    for (size_t m = start_m; m < start_m + count_m; ++m) {
+      const auto first = static_cast<std::ptrdiff_t>(m * ldc + start_n);
+      (*activation_)(first, first + static_cast<std::ptrdiff_t>(count_n));
+    }
+  }
+
+ private:
+  std::unique_ptr<functors::ElementWiseRangedTransform<float>> activation_;
+};
+}  // namespace
+
 ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
     Gemm,
     7,
@@ -284,6 +309,28 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::UseSerializedPrePackedBuffers(const Tensor& /*tensor*/,
+                                              std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                              int /*input_idx*/,
+                                              /*out*/ bool& used_serialized_buffers) {
+  used_serialized_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UseSerializedPrePackedBuffers(const Tensor& tensor,
+                                                  std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                  int input_idx,
+                                                  /*out*/ bool& used_serialized_buffers) {
+  // PrePack() only sets the shape of B besides the packed buffer.
+  ORT_RETURN_IF_ERROR(UseSharedPrePackedBuffers(prepacked_buffers, input_idx, used_serialized_buffers));
+  if (used_serialized_buffers) {
+    b_shape_ = tensor.Shape();
+  }
+  return Status::OK();
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(_Inout_updates_(y_size) T* y_data, ptrdiff_t y_size, _Inout_opt_ concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
@@ -408,27 +455,35 @@ Status Gemm<float>::Compute(OpKernelContext* context) const {
   const float* c_data = C != nullptr ? C->Data<float>() : nullptr;
   const TensorShape* c_shape = C != nullptr ? &C->Shape() : nullptr;
 
+  // The fused activation is applied by MLAS to each tile of the output as soon as the tile is computed,
+  // instead of in a separate pass over the whole output.
+  std::unique_ptr<GemmActivationProcessor> activation_processor;
+  if (activation_) {
+    activation_processor = std::make_unique<GemmActivationProcessor>(*activation_, y_data);
+  }
+
+  GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = A->Data<float>();
+  data.lda = static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K);
   if (B) {
-    ComputeGemm(trans_A_, trans_B_, M, N, K, alpha_, A->Data<float>(), B->Data<float>(), beta_,
-                c_data, c_shape, y_data, thread_pool);
+    data.B = B->Data<float>();
+    data.ldb = static_cast<size_t>(trans_B_ != CblasNoTrans ? K : N);
   } else {
-    GemmBroadcastBias(M, N, beta_, c_data, c_shape, y_data);
-    MlasGemm(
-        trans_A_,
-        static_cast<size_t>(M),
-        static_cast<size_t>(N),
-        static_cast<size_t>(K),
-        alpha_,
-        A->Data<float>(),
-        static_cast<size_t>(trans_A_ != CblasNoTrans ? M : K),
-        packed_b_.get(),
-        c_data != nullptr ? beta_ : 0.0f,
-        y_data,
-        static_cast<size_t>(N),
-        thread_pool);
+    data.B = static_cast<const float*>(packed_b_.get());
+    data.BIsPacked = true;
   }
-
-  ComputeActivation(y_data, SafeInt<size_t>(M) * N, thread_pool);
+  data.C = y_data;
+  data.ldc = static_cast<size_t>(N);
+  data.alpha = alpha_;
+  // ideally we need to set the output buffer contents to 0 if bias is missing,
+  // but passing 0 for beta is cheaper and it will ignore any junk in the output buffer
+  data.beta = c_data != nullptr ? beta_ : 0.0f;
+  data.OutputProcessor = activation_processor.get();
+
+  MlasGemm(trans_A_, B ? trans_B_ : CblasTrans, static_cast<size_t>(M), static_cast<size_t>(N),
+           static_cast<size_t>(K), data, thread_pool);
 
   return Status::OK();
 }
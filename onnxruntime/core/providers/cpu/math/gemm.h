@@ -28,6 +28,10 @@ class Gemm : protected GemmBase, public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       int input_idx,
+                                       /*out*/ bool& used_serialized_buffers) override;
+
   static void ComputeGemm(CBLAS_TRANSPOSE trans_a, CBLAS_TRANSPOSE trans_b,
                           ptrdiff_t M, ptrdiff_t N, ptrdiff_t K,
                           T alpha,
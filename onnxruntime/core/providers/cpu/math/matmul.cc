@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/matmul.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/math.h"
@@ -88,6 +93,41 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
         .TypeConstraint("T", BuildKernelDefConstraints<int64_t, uint64_t>()),
     MatMul<int64_t>);
 
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+// Registered in RegisterFp16Kernels only when the hardware supports fp16 arithmetic.
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    1, 8,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(
+    MatMul,
+    9,
+    12,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    MLFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<MLFloat16>()),
+    MatMul<MLFloat16>);
+#endif
+
+#if defined(__aarch64__) && defined(__linux__)
+// Registered in RegisterBf16Kernels only when the hardware supports bf16 arithmetic.
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    MatMul<BFloat16>);
+#endif
+
 template <typename T>
 Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
@@ -124,7 +164,104 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
 
   return Status::OK();
 }
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+template <>
+Status MatMul<MLFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* a_data = a->Data<MLFloat16>();
+  const auto* b_data = b->Data<MLFloat16>();
+  auto* y_data = y->MutableData<MLFloat16>();
+
+  // the half gemm accumulates in fp16 and threads over all the matrices of the batch at once
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  std::vector<MLAS_HALF_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].B = b_data + helper.RightOffsets()[i];
+    data[i].ldb = N;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+  MlasHalfGemmBatch(static_cast<size_t>(helper.M()), N, K, max_len, data.data(), thread_pool);
+
+  return Status::OK();
+}
+#endif
+
 #if defined(__aarch64__) && defined(__linux__)
+template <>
+Status MatMul<BFloat16>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* a = ctx->Input<Tensor>(0);
+  const auto* b = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b->Shape()));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+
+  // the sbgemm kernels read fp32 operands and round them to bf16 while packing, so widening the bf16 inputs is
+  // exact and the products are computed in bf16 with fp32 accumulation
+  const auto widen = [&alloc](const Tensor& tensor) {
+    const auto count = narrow<size_t>(tensor.Shape().Size());
+    auto buffer = IAllocator::MakeUniquePtr<float>(alloc, count);
+    const auto* src = tensor.Data<BFloat16>();
+    for (size_t i = 0; i < count; i++) {
+      buffer.get()[i] = src[i].ToFloat();
+    }
+    return buffer;
+  };
+  auto a_data = widen(*a);
+  auto b_data = widen(*b);
+  const auto y_count = narrow<size_t>(y->Shape().Size());
+  auto y_data = IAllocator::MakeUniquePtr<float>(alloc, y_count);
+
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].AIsfp32 = true;
+    data[i].BIsfp32 = true;
+    data[i].A = a_data.get() + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    data[i].B = b_data.get() + helper.RightOffsets()[i];
+    data[i].ldb = N;
+    data[i].C = y_data.get() + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+  MlasSBGemmBatch(static_cast<size_t>(helper.M()), N, K, max_len, data.data(), thread_pool);
+
+  auto* y_bf16 = y->MutableData<BFloat16>();
+  for (size_t i = 0; i < y_count; i++) {
+    y_bf16[i] = BFloat16(y_data.get()[i]);
+  }
+
+  return Status::OK();
+}
+
 bool GemmPackBBfloat16(AllocatorPtr& alloc,
                        const Tensor& tensor_b,
                        bool trans_b,
@@ -163,6 +300,95 @@ bool GemmPackBBfloat16(AllocatorPtr& alloc,
 }
 #endif
 
+namespace {
+
+// Packs the 2D weight B in CSR format if at least sparsity_threshold of its elements are zeros, the nonzeros of each
+// of its K rows being in row order.
+bool SparsePackB(AllocatorPtr& alloc,
+                 const Tensor& tensor_b,
+                 bool trans_b,
+                 float sparsity_threshold,
+                 IAllocatorUniquePtr<void>& row_offsets,
+                 IAllocatorUniquePtr<void>& col_indices,
+                 IAllocatorUniquePtr<void>& values,
+                 std::array<size_t, 3>& buffer_sizes,
+                 TensorShape& b_shape) {
+  if (tensor_b.Shape().NumDimensions() != 2) {
+    return false;
+  }
+
+  const auto& shape = tensor_b.Shape();
+  const size_t K = trans_b ? static_cast<size_t>(shape[1]) : static_cast<size_t>(shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(shape[0]) : static_cast<size_t>(shape[1]);
+  if (K * N == 0 || N > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    return false;
+  }
+
+  const float* b_data = tensor_b.Data<float>();
+  const auto b_at = [&](size_t k, size_t n) { return trans_b ? b_data[n * K + k] : b_data[k * N + n]; };
+  const size_t nnz = static_cast<size_t>(
+      std::count_if(b_data, b_data + K * N, [](float value) { return value != 0.0f; }));
+  if (static_cast<float>(K * N - nnz) < sparsity_threshold * static_cast<float>(K * N)) {
+    return false;
+  }
+
+  b_shape = shape;
+  buffer_sizes = {(K + 1) * sizeof(int64_t), std::max<size_t>(nnz, 1) * sizeof(int32_t),
+                  std::max<size_t>(nnz, 1) * sizeof(float)};
+  row_offsets = IAllocator::MakeUniquePtr<void>(alloc, buffer_sizes[0], true);
+  col_indices = IAllocator::MakeUniquePtr<void>(alloc, buffer_sizes[1], true);
+  values = IAllocator::MakeUniquePtr<void>(alloc, buffer_sizes[2], true);
+
+  // The buffers are padded for an all zero B, which is zeroed so that they hash the same when shared.
+  memset(col_indices.get(), 0, buffer_sizes[1]);
+  memset(values.get(), 0, buffer_sizes[2]);
+  auto* offsets_data = static_cast<int64_t*>(row_offsets.get());
+  auto* indices_data = static_cast<int32_t*>(col_indices.get());
+  auto* values_data = static_cast<float*>(values.get());
+  int64_t offset = 0;
+  for (size_t k = 0; k < K; k++) {
+    offsets_data[k] = offset;
+    for (size_t n = 0; n < N; n++) {
+      const float value = b_at(k, n);
+      if (value != 0.0f) {
+        indices_data[offset] = static_cast<int32_t>(n);
+        values_data[offset] = value;
+        offset++;
+      }
+    }
+  }
+  offsets_data[K] = offset;
+  return true;
+}
+
+// C = alpha x A x B with B in CSR format: each row of C is the sum of the nonzeros of the rows of B scaled by the
+// elements of the row of A.
+void SparseGemm(bool trans_a, size_t M, size_t N, size_t K, float alpha,
+                const float* A, size_t lda,
+                const int64_t* row_offsets, const int32_t* col_indices, const float* values,
+                float* C, size_t ldc,
+                concurrency::ThreadPool* thread_pool) {
+  const double nnz = static_cast<double>(row_offsets[K]);
+  const TensorOpCost unit_cost{static_cast<double>(K) * sizeof(float) + nnz * (sizeof(int32_t) + sizeof(float)),
+                               static_cast<double>(N) * sizeof(float),
+                               2.0 * nnz};
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, static_cast<std::ptrdiff_t>(M), unit_cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t m = begin; m < end; m++) {
+          float* c = C + m * ldc;
+          std::fill_n(c, N, 0.0f);
+          for (size_t k = 0; k < K; k++) {
+            const float a = alpha * (trans_a ? A[k * lda + m] : A[m * lda + k]);
+            for (int64_t j = row_offsets[k]; j < row_offsets[k + 1]; j++) {
+              c[col_indices[j]] += a * values[j];
+            }
+          }
+        }
+      });
+}
+
+}  // namespace
+
 Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
                               /*out*/ bool& is_packed,
                               /*out*/ PrePackedWeights* prepacked_weights) {
@@ -170,6 +396,24 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
 
   // only pack Matrix B
   if (input_idx == 1) {
+    if (sparse_weight_threshold_ > 0.0f) {
+      std::array<size_t, 3> sparse_b_sizes;
+      b_is_sparse_ = SparsePackB(alloc, tensor, trans_b_attr_ != 0, sparse_weight_threshold_,
+                                 sparse_b_row_offsets_, sparse_b_col_indices_, sparse_b_values_,
+                                 sparse_b_sizes, b_shape_);
+      if (b_is_sparse_) {
+        is_packed = true;
+        if (prepacked_weights != nullptr) {
+          prepacked_weights->buffers_.push_back(std::move(sparse_b_row_offsets_));
+          prepacked_weights->buffers_.push_back(std::move(sparse_b_col_indices_));
+          prepacked_weights->buffers_.push_back(std::move(sparse_b_values_));
+          prepacked_weights->buffer_sizes_.insert(prepacked_weights->buffer_sizes_.end(),
+                                                  sparse_b_sizes.begin(), sparse_b_sizes.end());
+        }
+        return Status::OK();
+      }
+    }
+
     size_t packed_b_size;
 #if defined(__aarch64__) && defined(__linux__)
     size_t dim1 = 0;
@@ -205,17 +449,37 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
 
   if (input_idx == 1) {
     used_shared_buffers = true;
-    packed_b_ = std::move(prepacked_buffers[0]);
+    // B is packed in one buffer for the dense GEMM, and in three buffers in CSR format.
+    if (prepacked_buffers.size() == 3) {
+      b_is_sparse_ = true;
+      sparse_b_row_offsets_ = std::move(prepacked_buffers[0]);
+      sparse_b_col_indices_ = std::move(prepacked_buffers[1]);
+      sparse_b_values_ = std::move(prepacked_buffers[2]);
+    } else {
+      packed_b_ = std::move(prepacked_buffers[0]);
+    }
   }
 
   return Status::OK();
 }
 
+Status MatMul<float>::UseSerializedPrePackedBuffers(const Tensor& tensor,
+                                                    std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                    int input_idx,
+                                                    /*out*/ bool& used_serialized_buffers) {
+  // PrePack() only sets the shape of B besides the packed buffer.
+  ORT_RETURN_IF_ERROR(UseSharedPrePackedBuffers(prepacked_buffers, input_idx, used_serialized_buffers));
+  if (used_serialized_buffers) {
+    b_shape_ = tensor.Shape();
+  }
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
   const Tensor* a = ctx->Input<Tensor>(0);
-  const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+  const Tensor* b = packed_b_ || b_is_sparse_ ? nullptr : ctx->Input<Tensor>(1);
   const auto& b_shape = b ? b->Shape() : b_shape_;
 
   // match CUDA kernel implementation, ignore transpose for vectors
@@ -240,6 +504,17 @@ Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   const size_t K = static_cast<size_t>(helper.K());
   const size_t lda = helper.Lda(trans_a);
   const size_t ldb = helper.Ldb(trans_b);
+  if (b_is_sparse_) {
+    for (size_t i = 0; i < max_len; i++) {
+      SparseGemm(trans_a, M, N, K, alpha_attr_, a_data + helper.LeftOffsets()[i], lda,
+                 static_cast<const int64_t*>(sparse_b_row_offsets_.get()),
+                 static_cast<const int32_t*>(sparse_b_col_indices_.get()),
+                 static_cast<const float*>(sparse_b_values_.get()),
+                 y_data + helper.OutputOffsets()[i], N, thread_pool);
+    }
+    return Status::OK();
+  }
+
 #if defined(__aarch64__) && defined(__linux__)
   if (use_fastmath_mode_ && !trans_b && ((N * K) >= kFastMathModeKernelsizeThreshold)) {
     std::vector<MLAS_SBGEMM_DATA_PARAMS> data(max_len);
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "core/common/parse_string.h"
 #include "core/framework/op_kernel.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -30,6 +31,12 @@ class MatMul<float> final : public OpKernel {
     trans_batch_a_ = trans_batch_a_attr != 0;
     trans_batch_b_ = trans_batch_b_attr != 0;
 
+    const auto sparse_threshold =
+        info.GetConfigOptions().GetConfigOrDefault(kOrtSessionOptionsMlasMatMulSparseWeightThreshold, "0");
+    ORT_ENFORCE(TryParseStringWithClassicLocale(sparse_threshold, sparse_weight_threshold_) &&
+                    sparse_weight_threshold_ >= 0.0f && sparse_weight_threshold_ <= 1.0f,
+                "Invalid ", kOrtSessionOptionsMlasMatMulSparseWeightThreshold, ": ", sparse_threshold);
+
 #if defined(__aarch64__) && defined(__linux__)
     auto config_ops = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasGemmFastMathArm64Bfloat16);
     use_fastmath_mode_ = (config_ops == "1") && MlasBf16AccelerationSupported();
@@ -43,12 +50,24 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       int input_idx,
+                                       /*out*/ bool& used_serialized_buffers) override;
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
   TensorShape b_shape_;
   IAllocatorUniquePtr<void> packed_b_;
 
+  // B in CSR format, a row of offsets into the column indices and values of its nonzeros for each of its K rows,
+  // when it is sparse enough for sparse_weight_threshold_.
+  float sparse_weight_threshold_;
+  bool b_is_sparse_{false};
+  IAllocatorUniquePtr<void> sparse_b_row_offsets_;
+  IAllocatorUniquePtr<void> sparse_b_col_indices_;
+  IAllocatorUniquePtr<void> sparse_b_values_;
+
   // For FusedMatMul contrib ops
   float alpha_attr_;
   int64_t trans_a_attr_;
@@ -140,6 +140,99 @@ static void SelectTopK(const Comparator& comparer,
   // the data_holder now contains the indices of the top k elements in the first k elements
 }
 
+// Minimum number of elements in each part of a row when the top k of a row are selected from parts of it in parallel.
+constexpr int64_t kMinElementsPerRowPart = 16 * 1024;
+
+// Number of values which are compared with the current k-th best value at a time, before any of them is added to the
+// heap in SelectTopKOfRange.
+constexpr int64_t kThresholdFilterBlockSize = 16;
+
+// Selects the top k elements of the contiguous range [begin, end) of the input into 'heap', which has k entries.
+// The range must have at least k elements.
+template <class Comparator>
+static void SelectTopKOfRange(const Comparator& comparer, const typename Comparator::DataType* input_data,
+                              int64_t begin, int64_t end, const unsigned k, int64_t* heap) {
+  int64_t cur_idx = begin;
+  for (size_t l = 0; l < k; ++l, ++cur_idx) {
+    heap[k - l - 1] = cur_idx;
+    HeapifyIthPosition(heap, k - l - 1, k, comparer);
+  }
+
+  const auto insert = [&](int64_t idx, typename Comparator::DataType& top) {
+    if (comparer.CompareValueOnly(input_data[idx], top)) {
+      heap[0] = idx;
+      HeapifyIthPosition(heap, 0, k, comparer);
+      top = input_data[heap[0]];
+    }
+  };
+
+  // once the heap is filled most values don't beat the current k-th best value (the top of the heap), so a block of
+  // values is first compared with it without branches, which the compiler can vectorize, and the values are only
+  // inserted one by one if one of them beats it.
+  auto top = input_data[heap[0]];
+  for (; cur_idx + kThresholdFilterBlockSize <= end; cur_idx += kThresholdFilterBlockSize) {
+    const auto* block = input_data + cur_idx;
+    bool any_better = false;
+    for (int64_t b = 0; b < kThresholdFilterBlockSize; ++b) {
+      any_better |= comparer.CompareValueOnly(block[b], top);
+    }
+
+    if (any_better) {
+      for (int64_t b = 0; b < kThresholdFilterBlockSize; ++b) {
+        insert(cur_idx + b, top);
+      }
+    }
+  }
+
+  for (; cur_idx < end; ++cur_idx) {
+    insert(cur_idx, top);
+  }
+}
+
+// Finds the top k elements of each row of a [rows, cols] input where k is along the columns, by splitting each row into
+// 'parts_per_row' parts whose top k are selected in parallel, and then selecting the top k of these.
+// This is used when there are fewer rows than threads, e.g. for the logits of a single sequence over a large vocabulary.
+template <class Comparator>
+static void FindTopKElementsInRowParts(const typename Comparator::DataType* input_data, int64_t rows, int64_t cols,
+                                       int64_t parts_per_row, const unsigned k, bool sorted,
+                                       typename Comparator::DataType* values_data, int64_t* indices_data,
+                                       concurrency::ThreadPool* threadpool) {
+  // the indices of the top k elements of each part
+  const size_t candidates_per_row = SafeInt<size_t>(parts_per_row) * k;
+  std::vector<int64_t> candidates(SafeInt<size_t>(rows) * candidates_per_row);
+
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, onnxruntime::narrow<std::ptrdiff_t>(rows * parts_per_row),
+      [&](std::ptrdiff_t part) {
+        const int64_t row = part / parts_per_row;
+        auto work = concurrency::ThreadPool::PartitionWork(onnxruntime::narrow<std::ptrdiff_t>(part % parts_per_row),
+                                                           onnxruntime::narrow<std::ptrdiff_t>(parts_per_row),
+                                                           onnxruntime::narrow<std::ptrdiff_t>(cols));
+        SelectTopKOfRange(Comparator(input_data), input_data, row * cols + work.start, row * cols + work.end, k,
+                          candidates.data() + static_cast<size_t>(part) * k);
+      });
+
+  // the comparison of the indices breaks ties of the values, so the selected elements are the same as when selecting
+  // from the whole row
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      threadpool, onnxruntime::narrow<std::ptrdiff_t>(rows),
+      [&](std::ptrdiff_t row) {
+        Comparator comparer(input_data);
+        auto row_candidates = candidates.begin() + static_cast<size_t>(row) * candidates_per_row;
+        std::nth_element(row_candidates, row_candidates + (k - 1), row_candidates + candidates_per_row, comparer);
+        if (sorted) {
+          std::sort(row_candidates, row_candidates + k, comparer);
+        }
+
+        const int64_t row_offset = row * cols;
+        for (size_t l = 0; l < k; ++l) {
+          const int64_t idx = row_candidates[l];
+          values_data[row * k + l] = input_data[idx];
+          indices_data[row * k + l] = idx - row_offset;
+        }
+      });
+}
+
 // Given an input tensor 'input' and metadata values - 'k' and 'axis_parsed',
 // this method will extract the sorted top k largest/smallest elements and place them in the output tensor 'values'
 // along with the metadata output 'indices'
@@ -165,6 +258,19 @@ static void FindTopKElements(const Tensor* input, const TensorShape& input_shape
   const int64_t block_slice = reduced_cols / k;
 
   int64_t tp_threads = concurrency::ThreadPool::DegreeOfParallelism(threadpool);
+
+  // if there are fewer rows than threads and the rows are long, also split the rows if k is along the innermost axis.
+  // each part needs to be a lot larger than k for this to pay off.
+  if (block_slice == 1 && rows < tp_threads) {
+    const int64_t max_parts_per_row = num_blocks / std::max(kMinElementsPerRowPart, 4 * static_cast<int64_t>(k));
+    const int64_t parts_per_row = std::min(max_parts_per_row, (tp_threads + rows - 1) / rows);
+    if (parts_per_row > 1) {
+      FindTopKElementsInRowParts<Comparator>(input_data, rows, cols, parts_per_row, k, sorted, values_data,
+                                             indices_data, threadpool);
+      return;
+    }
+  }
+
   int64_t num_threads = std::min(tp_threads, rows);  // split on rows so can't have more threads than rows
 
   // rough attempt to make sure there's enough work for each thread. if there's insufficient work the usage of
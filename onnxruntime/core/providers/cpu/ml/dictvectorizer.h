@@ -2,9 +2,11 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <algorithm>
 #include <string>
 #include <vector>
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel.h"
 
 namespace onnxruntime {
@@ -16,24 +18,34 @@ class DictVectorizerOp final : public OpKernel {
     // In some stupid models, the vocabulary could have duplicated elements.
     // We must support that, otherwise some tests will be break.
     ORT_ENFORCE(info.GetAttrs(std::is_same<AttrType, std::string>::value ? "string_vocabulary" : "int64_vocabulary", vocabulary_).IsOK());
+
+    // The input dictionaries are usually much smaller than the vocabulary, so the output is filled by looking up the
+    // positions of each input key rather than by looking up each vocabulary entry in the input.
+    vocabulary_positions_.reserve(vocabulary_.size());
+    for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
+      vocabulary_positions_[vocabulary_[i]].push_back(i);
+    }
   }
   common::Status Compute(OpKernelContext* ctx) const override {
     const auto* map = ctx->Input<std::map<AttrType, TargetType> >(0);
     auto* Y = ctx->Output(0, {1, static_cast<int64_t>(vocabulary_.size())});
     auto* y_data = Y->MutableData<TargetType>();
-    for (size_t i = 0, end = vocabulary_.size(); i < end; ++i) {
-      auto index = map->find(vocabulary_[i]);
-      if (index != map->end()) {
-        *y_data++ = index->second;
-      } else {
-        // Any keys not present in the input dictionary, will be zero in the output array
-        *y_data++ = TargetType();
+    // Any keys not present in the input dictionary, will be zero in the output array
+    std::fill_n(y_data, vocabulary_.size(), TargetType());
+    for (const auto& entry : *map) {
+      auto positions = vocabulary_positions_.find(entry.first);
+      if (positions != vocabulary_positions_.end()) {
+        for (size_t i : positions->second) {
+          y_data[i] = entry.second;
+        }
       }
     }
     return Status::OK();
   }
 
   std::vector<AttrType> vocabulary_;
+  // the positions of each key in vocabulary_, which may have duplicated keys
+  InlinedHashMap<AttrType, InlinedVector<size_t, 1>> vocabulary_positions_;
 };
 
 }  // namespace ml
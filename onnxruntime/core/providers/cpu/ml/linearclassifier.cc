@@ -3,7 +3,6 @@
 
 #include "core/providers/cpu/ml/linearclassifier.h"
 #include "core/common/narrow.h"
-#include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -36,9 +35,11 @@ LinearClassifier::LinearClassifier(const OpKernelInfo& info)
 
   using_strings_ = !classlabels_strings_.empty();
   class_count_ = static_cast<ptrdiff_t>(intercepts_.size());
+  packed_coefficients_ = PackLinearCoefficients(info.GetAllocator(OrtMemType::OrtMemTypeDefault), coefficients_,
+                                                class_count_);
 }
 
-// Use GEMM for the calculations, with broadcasting of intercepts
+// Use GEMM for the calculations, with broadcasting of intercepts and the coefficients packed in the constructor
 // https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gemm
 //
 // X: [num_batches, num_features]
@@ -60,13 +61,11 @@ void LinearClassifier::ComputeImpl(const gsl::span<const float> input,
               "Scores output is incorrect size. Expected:", scores_output_size,
               " Found:", scores_output_data.size());
 
-  TensorShape intercepts_shape({num_targets});
-  onnxruntime::Gemm<float>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                        num_batches, num_targets, num_features,
-                                        1.f, input_data, coefficients.data(), 1.f,
-                                        intercepts.data(), &intercepts_shape,
-                                        scores_output_data.data(),
-                                        threadpool);
+  // the coefficients were packed for the number of features of the model, so only use them for that input size
+  const bool use_packed_coefficients = coefficients.size() == SafeInt<size_t>(num_targets) * num_features;
+  ComputeLinearScores(input_data, num_batches, num_features, num_targets, coefficients.data(),
+                      use_packed_coefficients ? packed_coefficients_.get() : nullptr, intercepts.data(),
+                      scores_output_data.data(), threadpool);
 
   float* score = scores_output_data.data();
   float* end_scores = score + (num_batches * num_targets);  // we haven't added extra targets yet so iterate the original scores
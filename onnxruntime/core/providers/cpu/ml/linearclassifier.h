@@ -31,6 +31,7 @@ class LinearClassifier final : public OpKernel {
   POST_EVAL_TRANSFORM post_transform_;
   bool using_strings_;
   std::vector<float> coefficients_;
+  IAllocatorUniquePtr<void> packed_coefficients_;
   std::vector<float> intercepts_;
   std::vector<std::string> classlabels_strings_;
   std::vector<int64_t> classlabels_ints_;
@@ -3,7 +3,6 @@
 
 #include "core/providers/cpu/ml/linearregressor.h"
 #include "core/common/narrow.h"
-#include "core/providers/cpu/math/gemm.h"
 
 namespace onnxruntime {
 namespace ml {
@@ -26,9 +25,11 @@ LinearRegressor::LinearRegressor(const OpKernelInfo& info)
 
   // use the intercepts_ if they're valid
   use_intercepts_ = intercepts_.size() == static_cast<size_t>(num_targets_);
+  packed_coefficients_ = PackLinearCoefficients(info.GetAllocator(OrtMemType::OrtMemTypeDefault), coefficients_,
+                                                narrow<ptrdiff_t>(num_targets_));
 }
 
-// Use GEMM for the calculations, with broadcasting of intercepts
+// Use GEMM for the calculations, with broadcasting of intercepts and the coefficients packed in the constructor
 // https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gemm
 //
 // X: [num_batches, num_features]
@@ -37,29 +38,18 @@ LinearRegressor::LinearRegressor(const OpKernelInfo& info)
 // Output: X * coefficients_^T + intercepts_: [num_batches, num_targets]
 template <typename T>
 static Status ComputeImpl(const Tensor& input, ptrdiff_t num_batches, ptrdiff_t num_features, ptrdiff_t num_targets,
-                          const std::vector<float>& coefficients,
+                          const std::vector<float>& coefficients, const void* packed_coefficients,
                           const std::vector<float>* intercepts, Tensor& output,
                           POST_EVAL_TRANSFORM post_transform,
                           concurrency::ThreadPool* threadpool) {
   const T* input_data = input.Data<T>();
   T* output_data = output.MutableData<T>();
 
-  if (intercepts != nullptr) {
-    TensorShape intercepts_shape({num_targets});
-    onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                      num_batches, num_targets, num_features,
-                                      1.f, input_data, coefficients.data(), 1.f,
-                                      intercepts->data(), &intercepts_shape,
-                                      output_data,
-                                      threadpool);
-  } else {
-    onnxruntime::Gemm<T>::ComputeGemm(CBLAS_TRANSPOSE::CblasNoTrans, CBLAS_TRANSPOSE::CblasTrans,
-                                      num_batches, num_targets, num_features,
-                                      1.f, input_data, coefficients.data(), 1.f,
-                                      nullptr, nullptr,
-                                      output_data,
-                                      threadpool);
-  }
+  // the coefficients were packed for the number of features of the model, so only use them for that input size
+  const bool use_packed_coefficients = coefficients.size() == SafeInt<size_t>(num_targets) * num_features;
+  ComputeLinearScores(input_data, num_batches, num_features, num_targets, coefficients.data(),
+                      use_packed_coefficients ? packed_coefficients : nullptr,
+                      intercepts != nullptr ? intercepts->data() : nullptr, output_data, threadpool);
 
   if (post_transform != POST_EVAL_TRANSFORM::NONE) {
     ml::batched_update_scores_inplace(gsl::make_span(output_data, SafeInt<size_t>(num_batches) * num_targets),
@@ -91,7 +81,7 @@ Status LinearRegressor::Compute(OpKernelContext* ctx) const {
   switch (element_type) {
     case ONNX_NAMESPACE::TensorProto_DataType_FLOAT: {
       status = ComputeImpl<float>(X, num_batches, num_features, narrow<ptrdiff_t>(num_targets_), coefficients_,
-                                  use_intercepts_ ? &intercepts_ : nullptr,
+                                  packed_coefficients_.get(), use_intercepts_ ? &intercepts_ : nullptr,
                                   Y, post_transform_, tp);
 
       break;
@@ -524,5 +524,82 @@ void batched_update_scores_inplace(gsl::span<T> scores, int64_t num_batches_in,
     }
   }
 }
+
+// Packs the [num_targets, num_features] coefficients of a linear model for MlasGemm, so that they're packed once in
+// the kernel constructor instead of in every call. Returns nullptr if the coefficients can't be packed.
+inline IAllocatorUniquePtr<void> PackLinearCoefficients(const AllocatorPtr& alloc, gsl::span<const float> coefficients,
+                                                        ptrdiff_t num_targets) {
+  if (alloc == nullptr || num_targets <= 0 || coefficients.empty() ||
+      coefficients.size() % static_cast<size_t>(num_targets) != 0) {
+    return nullptr;
+  }
+
+  const size_t N = static_cast<size_t>(num_targets);
+  const size_t K = coefficients.size() / N;
+  const size_t packed_size = MlasGemmPackBSize(N, K);
+  if (packed_size == 0) {
+    return nullptr;
+  }
+
+  auto packed_coefficients = IAllocator::MakeUniquePtr<void>(alloc, packed_size, true);
+  memset(packed_coefficients.get(), 0, packed_size);
+  MlasGemmPackB(CblasTrans, N, K, coefficients.data(), K, packed_coefficients.get());
+  return packed_coefficients;
+}
+
+// Computes scores = input * coefficients^T + intercepts, with input: [num_batches, num_features],
+// coefficients: [num_targets, num_features] and optional intercepts: [num_targets].
+// packed_coefficients are the coefficients from PackLinearCoefficients, or nullptr to use the unpacked ones.
+inline void ComputeLinearScores(const float* input, ptrdiff_t num_batches, ptrdiff_t num_features,
+                                ptrdiff_t num_targets, const float* coefficients, const void* packed_coefficients,
+                                const float* intercepts, float* scores, concurrency::ThreadPool* threadpool) {
+  if (num_batches == 0 || num_targets == 0) {
+    return;
+  }
+
+  if (intercepts != nullptr) {
+    EigenMatrixMapRowMajor<float>(scores, num_batches, num_targets).rowwise() =
+        ConstEigenVectorMap<float>(intercepts, num_targets).transpose();
+  }
+
+  MLAS_SGEMM_DATA_PARAMS data;
+  data.A = input;
+  data.lda = static_cast<size_t>(num_features);
+  if (packed_coefficients != nullptr) {
+    data.B = static_cast<const float*>(packed_coefficients);
+    data.BIsPacked = true;
+  } else {
+    data.B = coefficients;
+    data.ldb = static_cast<size_t>(num_features);
+  }
+  data.C = scores;
+  data.ldc = static_cast<size_t>(num_targets);
+  data.alpha = 1.f;
+  data.beta = intercepts != nullptr ? 1.f : 0.f;
+
+  MlasGemm(CblasNoTrans, CblasTrans, static_cast<size_t>(num_batches), static_cast<size_t>(num_targets),
+           static_cast<size_t>(num_features), data, threadpool);
+}
+
+// Sets each output element to `lookup` of the input element at the same position, in parallel for large inputs.
+// `lookup` is expected to find the element in a hash table, which costs much more than copying the elements, so
+// inputs of a few thousand elements are already split across the threads.
+template <typename TIn, typename TOut, typename Lookup>
+void ParallelLookup(concurrency::ThreadPool* threadpool, gsl::span<const TIn> input, gsl::span<TOut> output,
+                    const Lookup& lookup) {
+  ORT_ENFORCE(input.size() == output.size());
+  constexpr double kLookupCycles = 64.0;
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, static_cast<std::ptrdiff_t>(input.size()),
+      TensorOpCost{static_cast<double>(sizeof(TIn)), static_cast<double>(sizeof(TOut)), kLookupCycles},
+      [&input, &output, &lookup](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const TIn* in = input.data();
+        TOut* out = output.data();
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          out[i] = lookup(in[i]);
+        }
+      });
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
@@ -136,22 +136,39 @@ Status Normalizer::Normalize(OpKernelContext* context) const {
   const T* input = X.Data<T>();
   float* output = Y->MutableData<float>();
 
-  switch (normalization_) {
-    case NORMALIZE::NMAX: {
-      NormalizeMax(input, output, num_batches, batch_size);
-      break;
-    }
-    case NORMALIZE::L1: {
-      NormalizeL1(input, output, num_batches, batch_size);
-      break;
-    }
-    case NORMALIZE::L2: {
-      NormalizeL2(input, output, num_batches, batch_size);
-      break;
-    }
-    default: {
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unexpected NORMALIZE value of ", normalization_);
+  if (normalization_ != NORMALIZE::NMAX && normalization_ != NORMALIZE::L1 && normalization_ != NORMALIZE::L2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unexpected NORMALIZE value of ", normalization_);
+  }
+
+  auto normalize_batches = [this, input, output, batch_size](std::ptrdiff_t first, std::ptrdiff_t last) {
+    const T* in = input + first * batch_size;
+    float* out = output + first * batch_size;
+    switch (normalization_) {
+      case NORMALIZE::NMAX: {
+        NormalizeMax(in, out, last - first, batch_size);
+        break;
+      }
+      case NORMALIZE::L1: {
+        NormalizeL1(in, out, last - first, batch_size);
+        break;
+      }
+      default: {
+        NormalizeL2(in, out, last - first, batch_size);
+        break;
+      }
     }
+  };
+
+  // The batches are independent, unless the output reuses the buffer of a larger input type. Each batch then
+  // overwrites the input of the earlier batches, so they must be normalized in order.
+  if (sizeof(T) == sizeof(float) || static_cast<const void*>(input) != static_cast<const void*>(output)) {
+    const double batch_elements = static_cast<double>(batch_size);
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_batches),
+        TensorOpCost{batch_elements * sizeof(T), batch_elements * sizeof(float), batch_elements * 4.0},
+        normalize_batches);
+  } else {
+    normalize_batches(0, static_cast<std::ptrdiff_t>(num_batches));
   }
 
   return Status::OK();
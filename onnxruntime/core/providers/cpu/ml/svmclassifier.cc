@@ -247,7 +247,10 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
     batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
                               threadpool);
 
-    for (int64_t n = 0; n < num_batches; n++) {
+    // the batches are independent, so a large number of them is split across the threads like finalize_batch below
+    auto compute_classifier_scores = [this, &kernels_span, &classifier_scores, &votes_span,
+                                      num_slots_per_iteration, num_classifiers](ptrdiff_t idx) {
+      const int64_t n = idx;
       // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
       // per class.
       // coefficients: [num_classes - 1, vector_count_]
@@ -304,6 +307,14 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
           ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
         }
       }
+    };
+
+    if (num_batches > 512) {
+      concurrency::ThreadPool::TryBatchParallelFor(threadpool, num_batches, compute_classifier_scores, -1);
+    } else {
+      for (ptrdiff_t i = 0; i < num_batches; ++i) {
+        compute_classifier_scores(i);
+      }
     }
   }
 
@@ -39,28 +39,29 @@ class SVMCommon {
     assert(a.size() == size_t(m * k) && b.size() == size_t(k * n) && out.size() == size_t(m * n));
 
     if (kernel_type_ == KERNEL::RBF) {
-      T* cur_out = out.data();
-      const T* cur_batch = a.data();
-
-      // each batch has 'k' features
-      for (int64_t batch = 0; batch < m; ++batch) {
-        const T* cur_support_vector = b.data();
-
-        // broadcast the support vectors against the k features in each batch. output is one value per support vector
-        for (int64_t support_vector = 0; support_vector < n; ++support_vector) {
-          T sum = 0.f;
-          const T* cur_input = cur_batch;
-
-          for (int64_t feature = 0; feature < k; ++feature) {
-            T val = *cur_input++ - *cur_support_vector++;
-            sum += val * val;
-          }
-
-          *cur_out++ = std::exp(-gamma_ * sum);
-        }
-
-        cur_batch += k;  // move to start of next batch
-      }
+      const auto batches = ConstEigenMatrixMapRowMajor<T>(a.data(), m, k);
+      const auto support_vectors = ConstEigenMatrixMapRowMajor<T>(b.data(), n, k);
+
+      // each batch has 'k' features. broadcast the support vectors against the features of each batch, computing the
+      // squared distances with vectorized row operations. output is one value per support vector.
+      const double cost = static_cast<double>(n) * static_cast<double>(k) * 3.0;
+      concurrency::ThreadPool::TryParallelFor(
+          threadpool, m,
+          TensorOpCost{static_cast<double>(k * sizeof(T)), static_cast<double>(n * sizeof(T)), cost},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t batch = first; batch < last; ++batch) {
+              EigenVectorMap<T>(out.data() + batch * n, n) =
+                  (support_vectors.rowwise() - batches.row(batch)).rowwise().squaredNorm() * static_cast<T>(-gamma_);
+            }
+
+            T* cur_out = out.data() + first * n;
+            const size_t count = static_cast<size_t>((last - first) * n);
+            if constexpr (std::is_same_v<T, float>) {
+              MlasComputeExp(cur_out, cur_out, count);
+            } else {
+              EigenVectorArrayMap<T>(cur_out, count) = EigenVectorArrayMap<T>(cur_out, count).exp();
+            }
+          });
     } else {
       float alpha = 1.f;
       float beta = 1.f;
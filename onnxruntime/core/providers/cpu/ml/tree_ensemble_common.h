@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "tree_ensemble_aggregator.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
@@ -34,6 +36,16 @@ class TreeEnsembleCommonAttributes {
   int parallel_N_;       // starts parallelizing the computing by rows if n_rows <= parallel_N_
 };
 
+// Node of the breadth-first copy of the trees, see TreeEnsembleCommon::BuildCompactTrees.
+template <typename T>
+struct CompactTreeNode {
+  int32_t feature_id;
+  // The position of the true child, the false child is the next node. If the node is a leaf, it's ~i where i is the
+  // position of the leaf in `TreeEnsembleCommon::compact_leaves_`.
+  int32_t children;
+  T threshold;
+};
+
 // TI: input type
 // TH: tree type (types of the node values and targets)
 // TO: output type, usually float
@@ -47,6 +59,11 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   // `ThresholdType` is used as well for output type (double as well for lightgbm) and not `OutputType`.
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
+  // Breadth-first copy of the trees, used instead of nodes_ to find the leaves if it isn't empty.
+  std::vector<CompactTreeNode<ThresholdType>> compact_nodes_;
+  std::vector<int32_t> compact_roots_;
+  std::vector<TreeNodeElement<ThresholdType>*> compact_leaves_;
+  NODE_MODE compact_mode_;
 
  public:
   TreeEnsembleCommon() {}
@@ -82,6 +99,7 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
  protected:
   TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(TreeNodeElement<ThresholdType>* root,
                                                        const InputType* x_data) const;
+  TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(size_t tree_index, const InputType* x_data) const;
 
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
@@ -92,6 +110,11 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
                   const std::vector<ThresholdType>& nodes_values_as_tensor, const std::vector<float>& node_values,
                   const std::vector<int64_t>& nodes_missing_value_tracks_true, std::vector<size_t>& updated_mapping,
                   int64_t tree_id, const InlinedVector<TreeNodeElementId>& node_tree_ids);
+
+  void BuildCompactTrees();
+
+  template <typename Compare>
+  TreeNodeElement<ThresholdType>* ProcessCompactTree(size_t tree_index, const InputType* x_data) const;
 };
 
 template <typename InputType, typename ThresholdType, typename OutputType>
@@ -338,9 +361,77 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     }
   }
 
+  BuildCompactTrees();
   return Status::OK();
 }
 
+// Copies the trees into compact_nodes_ in breadth-first order, with the two children of a node next to each other.
+// The nodes are smaller than TreeNodeElement, and the first levels of a tree share a few cache lines, so finding a
+// leaf has fewer cache misses, and it's branchless as the next node only depends on the comparison.
+// The copy is only made if all the nodes use the same comparison without missing value tracks, if no node is shared
+// by two parents, and if the trees aren't too deep: the false branches of deep trees are usually long chains, which
+// nodes_ stores contiguously.
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::BuildCompactTrees() {
+  constexpr int64_t kMaxCompactTreeDepth = 24;
+
+  compact_nodes_.clear();
+  compact_roots_.clear();
+  compact_leaves_.clear();
+  if (!same_mode_ || has_missing_tracks_ || n_nodes_ >= std::numeric_limits<int32_t>::max()) {
+    return;
+  }
+
+  compact_mode_ = NODE_MODE::BRANCH_LEQ;
+  for (const auto& node : nodes_) {
+    if (node.is_not_leaf()) {
+      compact_mode_ = node.mode();
+      break;
+    }
+  }
+
+  struct QueuedNode {
+    const TreeNodeElement<ThresholdType>* node;
+    size_t position;
+    int64_t depth;
+  };
+
+  compact_nodes_.reserve(nodes_.size());
+  compact_roots_.reserve(roots_.size());
+  InlinedVector<QueuedNode> queue;
+  for (TreeNodeElement<ThresholdType>* root : roots_) {
+    compact_roots_.push_back(static_cast<int32_t>(compact_nodes_.size()));
+    compact_nodes_.push_back({});
+    queue.clear();
+    queue.push_back({root, compact_nodes_.size() - 1, 0});
+    for (size_t head = 0; head < queue.size(); ++head) {
+      const QueuedNode queued = queue[head];
+      auto& compact_node = compact_nodes_[queued.position];
+      if (!queued.node->is_not_leaf()) {
+        compact_node.children = ~static_cast<int32_t>(compact_leaves_.size());
+        compact_leaves_.push_back(&nodes_[queued.node - nodes_.data()]);
+        continue;
+      }
+
+      // every node is copied once unless it's shared by two parents
+      if (queued.depth >= kMaxCompactTreeDepth || compact_nodes_.size() + 2 > nodes_.size()) {
+        compact_nodes_.clear();
+        compact_roots_.clear();
+        compact_leaves_.clear();
+        return;
+      }
+
+      const size_t true_position = compact_nodes_.size();
+      compact_node.feature_id = queued.node->feature_id;
+      compact_node.threshold = queued.node->value_or_unique_weight;
+      compact_node.children = static_cast<int32_t>(true_position);
+      compact_nodes_.resize(true_position + 2);
+      queue.push_back({queued.node->truenode_or_weight.ptr, true_position, queued.depth + 1});
+      queue.push_back({queued.node + 1, true_position + 1, queued.depth + 1});
+    }
+  }
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 size_t TreeEnsembleCommon<InputType, ThresholdType, OutputType>::AddNodes(
     const size_t i, const InlinedVector<NODE_MODE>& cmodes, const InlinedVector<size_t>& truenode_ids,
@@ -460,7 +551,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       ScoreValue<ThresholdType> score = {0, 0};
       if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A: 1 output, 1 row and not enough trees to parallelize */
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data));
+          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(onnxruntime::narrow<size_t>(j), x_data));
         }
       } else { /* section B: 1 output, 1 row and enough trees to parallelize */
         std::vector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_trees_), {0, 0});
@@ -468,7 +559,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
             ttp,
             SafeInt<int32_t>(n_trees_),
             [this, &scores, &agg, x_data](ptrdiff_t j) {
-              agg.ProcessTreeNodePrediction1(scores[j], *ProcessTreeNodeLeave(roots_[j], x_data));
+              agg.ProcessTreeNodePrediction1(scores[j], *ProcessTreeNodeLeave(j, x_data));
             },
             max_num_threads);
 
@@ -499,7 +590,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
         }
         for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
           for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(j, x_data + i * stride));
           }
         }
         for (i = batch; i < batch_end; ++i) {
@@ -524,7 +615,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
               for (auto j = work.start; j < work.end; ++j) {
                 for (int64_t i = begin_n; i < end_n; ++i) {
                   agg.ProcessTreeNodePrediction1(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                 *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+                                                 *ProcessTreeNodeLeave(j, x_data + i * stride));
                 }
               }
             });
@@ -550,7 +641,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
             ScoreValue<ThresholdType> score = {0, 0};
             for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(j, x_data + i * stride));
             }
 
             agg.FinalizeScores1(z_data + i, score,
@@ -563,7 +654,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A2 */
         InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data), weights_);
+          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(onnxruntime::narrow<size_t>(j), x_data), weights_);
         }
         agg.FinalizeScores(scores, z_data, -1, label_data);
       } else { /* section B2: 2+ outputs, 1 row, enough trees to parallelize */
@@ -576,7 +667,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
               scores[batch_num].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(n_trees_));
               for (auto j = work.start; j < work.end; ++j) {
-                agg.ProcessTreeNodePrediction(scores[batch_num], *ProcessTreeNodeLeave(roots_[j], x_data), weights_);
+                agg.ProcessTreeNodePrediction(scores[batch_num], *ProcessTreeNodeLeave(j, x_data), weights_);
               }
             });
         for (size_t i = 1, limit = scores.size(); i < limit; ++i) {
@@ -599,7 +690,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
         }
         for (j = 0, limit = roots_.size(); j < limit; ++j) {
           for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(j, x_data + i * stride), weights_);
           }
         }
         for (i = batch; i < batch_end; ++i) {
@@ -625,7 +716,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
               for (auto j = work.start; j < work.end; ++j) {
                 for (int64_t i = begin_n; i < end_n; ++i) {
                   agg.ProcessTreeNodePrediction(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+                                                *ProcessTreeNodeLeave(j, x_data + i * stride), weights_);
                 }
               }
             });
@@ -657,7 +748,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
             for (auto i = work.start; i < work.end; ++i) {
               std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
               for (j = 0, limit = roots_.size(); j < limit; ++j) {
-                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(j, x_data + i * stride), weights_);
               }
 
               agg.FinalizeScores(scores,
@@ -767,6 +858,46 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename Compare>
+TreeNodeElement<ThresholdType>*
+TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessCompactTree(size_t tree_index,
+                                                                             const InputType* x_data) const {
+  const Compare compare;
+  const CompactTreeNode<ThresholdType>* nodes = compact_nodes_.data();
+  const CompactTreeNode<ThresholdType>* node = nodes + compact_roots_[tree_index];
+  while (node->children >= 0) {
+    node = nodes + node->children + (compare(x_data[node->feature_id], node->threshold) ? 0 : 1);
+  }
+  return compact_leaves_[~node->children];
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+TreeNodeElement<ThresholdType>*
+TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(size_t tree_index,
+                                                                               const InputType* x_data) const {
+  if (compact_nodes_.empty()) {
+    return ProcessTreeNodeLeave(roots_[tree_index], x_data);
+  }
+
+  switch (compact_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      return ProcessCompactTree<std::less_equal<>>(tree_index, x_data);
+    case NODE_MODE::BRANCH_LT:
+      return ProcessCompactTree<std::less<>>(tree_index, x_data);
+    case NODE_MODE::BRANCH_GTE:
+      return ProcessCompactTree<std::greater_equal<>>(tree_index, x_data);
+    case NODE_MODE::BRANCH_GT:
+      return ProcessCompactTree<std::greater<>>(tree_index, x_data);
+    case NODE_MODE::BRANCH_EQ:
+      return ProcessCompactTree<std::equal_to<>>(tree_index, x_data);
+    case NODE_MODE::BRANCH_NEQ:
+      return ProcessCompactTree<std::not_equal_to<>>(tree_index, x_data);
+    default:
+      return ProcessTreeNodeLeave(roots_[tree_index], x_data);
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
@@ -17,13 +17,114 @@
 
 #include "core/providers/cpu/nn/conv.h"
 
+#include <sstream>
+
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
+#include "core/providers/cpu/tunable/cpu_tunable.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 using ConvPadVector = ConvAttributes::ConvPadVector;
 
+namespace {
+// The arguments of a MLAS convolution, tuned for the shapes, attributes and intra-op thread count.
+struct MlasConvParams : cpu::tunable::OpParams {
+  explicit MlasConvParams(cpu::tunable::CpuTuningContext* tuning_ctx) : OpParams(tuning_ctx, nullptr) {}
+
+  std::string Signature() const override {
+    std::ostringstream oss;
+    const auto append = [&oss](const char* name, const int64_t* values, size_t count) {
+      oss << name;
+      for (size_t i = 0; i < count; ++i) {
+        oss << (i == 0 ? "" : "x") << values[i];
+      }
+    };
+    oss << "N" << batch_count << "_G" << group_count << "_C" << input_channels << "_M" << filter_count;
+    append("_X", input_shape, kernel_rank);
+    append("_K", kernel_shape, kernel_rank);
+    append("_D", dilations, kernel_rank);
+    append("_P", pads, kernel_rank * 2);
+    append("_S", strides, kernel_rank);
+    oss << "_A" << activation->ActivationKind
+        << "_T" << concurrency::ThreadPool::DegreeOfParallelism(thread_pool);
+    return oss.str();
+  }
+
+  size_t kernel_rank;
+  size_t batch_count;
+  size_t group_count;
+  size_t input_channels;
+  size_t filter_count;
+  const int64_t* input_shape;
+  const int64_t* kernel_shape;
+  const int64_t* dilations;
+  const int64_t* pads;
+  const int64_t* strides;
+  const int64_t* output_shape;
+  const MLAS_ACTIVATION* activation;
+  float beta;
+  bool allow_winograd;
+  const float* X;
+  const float* W;
+  const float* B;
+  float* Y;
+  AllocatorPtr alloc;
+  concurrency::ThreadPool* thread_pool;
+};
+
+Status MlasConvolution(const MlasConvParams* params, bool allow_winograd, bool require_winograd) {
+  MLAS_CONV_PARAMETERS Parameters;
+  size_t WorkingBufferSize;
+  MlasConvPrepare(&Parameters,
+                  params->kernel_rank,
+                  params->batch_count,
+                  params->group_count,
+                  params->input_channels,
+                  params->input_shape,
+                  params->kernel_shape,
+                  params->dilations,
+                  params->pads,
+                  params->strides,
+                  params->output_shape,
+                  params->filter_count,
+                  params->activation,
+                  &WorkingBufferSize,
+                  params->beta,
+                  params->thread_pool,
+                  allow_winograd);
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(require_winograd && Parameters.Algorithm != MlasConvAlgorithmWinograd,
+                                            "the Winograd algorithm is not applicable");
+
+  auto* working_data = WorkingBufferSize > 0
+                           ? params->alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
+                           : nullptr;
+  BufferUniquePtr working_buffer(working_data, BufferDeleter(params->alloc));
+
+  MlasConv(&Parameters,
+           params->X,
+           params->W,
+           params->B,
+           static_cast<float*>(working_buffer.get()),
+           params->Y,
+           params->thread_pool);
+  return Status::OK();
+}
+
+// Chooses between the MLAS algorithm selected by shape and the Winograd algorithm.
+class MlasConvTunableOp : public cpu::tunable::TunableOp<MlasConvParams> {
+ public:
+  MlasConvTunableOp() {
+    this->RegisterOp([](const MlasConvParams* params) {
+      return MlasConvolution(params, params->allow_winograd, false);
+    });
+    this->RegisterOp([](const MlasConvParams* params) {
+      return MlasConvolution(params, true, true);
+    });
+  }
+};
+}  // namespace
+
 template <typename T>
 Status Conv<T>::Compute(OpKernelContext* context) const {
   const auto* X = context->Input<Tensor>(0);
@@ -214,36 +315,40 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
 
   if (kernel_rank >= 1 && kernel_rank <= 3) {
-    MLAS_CONV_PARAMETERS Parameters;
-    size_t WorkingBufferSize;
-    MlasConvPrepare(&Parameters,
-                    kernel_rank,
-                    narrow<size_t>(N),
-                    narrow<size_t>(conv_attrs_.group),
-                    narrow<size_t>(C / conv_attrs_.group),
-                    input_shape.GetDims().data(),
-                    kernel_shape.data(),
-                    dilations.data(),
-                    pads.data(),
-                    strides.data(),
-                    output_shape.GetDims().data(),
-                    narrow<size_t>(M / conv_attrs_.group),
-                    &activation_,
-                    &WorkingBufferSize,
-                    Beta,
-                    thread_pool);
-
-    auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
-                                               : nullptr;
-    BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
-
-    MlasConv(&Parameters,
-             Xdata.data(),
-             W->Data<float>(),
-             Bdata,
-             static_cast<float*>(working_buffer.get()),
-             Ydata.data(),
-             thread_pool);
+    auto* provider = Info().GetExecutionProvider();
+    auto* tuning_ctx = provider->Type() == kCpuExecutionProvider
+                           ? static_cast<cpu::tunable::CpuTuningContext*>(provider->GetTuningContext())
+                           : nullptr;
+
+    MlasConvParams params(tuning_ctx);
+    params.kernel_rank = kernel_rank;
+    params.batch_count = narrow<size_t>(N);
+    params.group_count = narrow<size_t>(conv_attrs_.group);
+    params.input_channels = narrow<size_t>(C / conv_attrs_.group);
+    params.filter_count = narrow<size_t>(M / conv_attrs_.group);
+    params.input_shape = input_shape.GetDims().data();
+    params.kernel_shape = kernel_shape.data();
+    params.dilations = dilations.data();
+    params.pads = pads.data();
+    params.strides = strides.data();
+    params.output_shape = output_shape.GetDims().data();
+    params.activation = &activation_;
+    params.beta = Beta;
+    params.allow_winograd = use_winograd_;
+    params.X = Xdata.data();
+    params.W = W->Data<float>();
+    params.B = Bdata;
+    params.Y = Ydata.data();
+    params.alloc = std::move(alloc);
+    params.thread_pool = thread_pool;
+
+    // the tuning runs the convolution repeatedly, which would accumulate into the output of a Conv/Sum fusion
+    if (tuning_ctx != nullptr && tuning_ctx->IsTunableOpEnabled() && Beta == 0.0f) {
+      static MlasConvTunableOp op;
+      return op(&params);
+    }
+
+    return MlasConvolution(&params, use_winograd_, false);
   } else {
     const int64_t input_image_size = input_shape.Size();
     const int64_t output_image_size = output_shape.Size();
@@ -6,6 +6,7 @@
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
 #include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 namespace onnxruntime {
 
@@ -26,6 +27,7 @@ class Conv<float> : public OpKernel {
  public:
   Conv(const OpKernelInfo& info) : OpKernel(info), conv_attrs_(info) {
     activation_.ActivationKind = MlasIdentityActivation;
+    use_winograd_ = info.GetConfigOptions().GetConfigEntry(kOrtSessionOptionsMlasConvWinograd) == "1";
   }
 
   Status Compute(OpKernelContext* context) const override;
@@ -34,6 +36,9 @@ class Conv<float> : public OpKernel {
   MLAS_ACTIVATION activation_;
 
   ConvAttributes conv_attrs_;
+
+  // whether 3x3 stride 1 convolutions may use the Winograd algorithm of MLAS
+  bool use_winograd_;
 };
 
 }  // namespace onnxruntime
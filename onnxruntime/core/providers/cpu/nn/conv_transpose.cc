@@ -218,6 +218,62 @@ Status ConvTranspose<T>::DoConvTranspose(OpKernelContext* context, bool dynamic_
   return Status::OK();
 }
 
+namespace {
+// Accumulates the columns of the GEMM into the output image. The columns of every output channel only add to the
+// image plane of that channel, so ranges of channels are accumulated in parallel.
+void Col2imPerChannel(const float* col_buffer_data, const ConvTransposeAttributes::Prepare& p,
+                      const TensorShape& output_shape, int64_t kernel_size, int64_t input_image_size,
+                      int64_t channels, float* Ydata, concurrency::ThreadPool* thread_pool) {
+  const int64_t col_channel_size = kernel_size * input_image_size;
+  const int64_t output_image_size = output_shape.Size();
+  const auto col_channel_bytes = static_cast<double>(col_channel_size * sizeof(float));
+
+  concurrency::ThreadPool::TryParallelFor(
+      thread_pool, onnxruntime::narrow<std::ptrdiff_t>(channels),
+      TensorOpCost{col_channel_bytes, static_cast<double>(output_image_size * sizeof(float)),
+                   static_cast<double>(col_channel_size)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        const float* col_data = col_buffer_data + first * col_channel_size;
+        float* image_data = Ydata + first * output_image_size;
+        const int64_t count = last - first;
+
+        if (p.X->Shape().NumDimensions() == 4) {
+          math::Col2im<float, CPUMathUtil, StorageOrder::NCHW>(
+              col_data,
+              count,
+              p.Y->Shape()[2],
+              p.Y->Shape()[3],
+              p.kernel_shape[0],
+              p.kernel_shape[1],
+              p.dilations[0],
+              p.dilations[1],
+              p.pads[0],
+              p.pads[1],
+              p.pads[2],
+              p.pads[3],
+              p.strides[0],
+              p.strides[1],
+              image_data,
+              &CPUMathUtil::Instance());
+        } else {
+          math::Col2imNd<float, CPUMathUtil, StorageOrder::NCHW>(
+              col_data,
+              output_shape.GetDims().data(),
+              p.input_shape.GetDims().data(),
+              count * kernel_size,
+              count * output_image_size,
+              p.kernel_shape.data(),
+              p.strides.data(),
+              p.dilations.data(),
+              p.pads.data(),
+              static_cast<int>(p.kernel_shape.size()),
+              image_data,
+              &CPUMathUtil::Instance());
+        }
+      });
+}
+}  // namespace
+
 template <>
 Status ConvTranspose<float>::DoConvTranspose(OpKernelContext* context, bool dynamic_padding) const {
   concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
@@ -270,39 +326,9 @@ Status ConvTranspose<float>::DoConvTranspose(OpKernelContext* context, bool dyna
           col_buffer_data,
           thread_pool);
 
-      if (p.X->Shape().NumDimensions() == 4) {
-        math::Col2im<float, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            p.num_output_channels / conv_transpose_attrs_.group,
-            p.Y->Shape()[2],
-            p.Y->Shape()[3],
-            p.kernel_shape[0],
-            p.kernel_shape[1],
-            p.dilations[0],
-            p.dilations[1],
-            p.pads[0],
-            p.pads[1],
-            p.pads[2],
-            p.pads[3],
-            p.strides[0],
-            p.strides[1],
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
-      } else {
-        math::Col2imNd<float, CPUMathUtil, StorageOrder::NCHW>(
-            col_buffer_data,
-            output_shape.GetDims().data(),
-            p.input_shape.GetDims().data(),
-            kernel_dim,
-            Y_offset,
-            p.kernel_shape.data(),
-            p.strides.data(),
-            p.dilations.data(),
-            p.pads.data(),
-            static_cast<int>(p.kernel_shape.size()),
-            Ydata + group_id * Y_offset,
-            &CPUMathUtil::Instance());
-      }
+      Col2imPerChannel(col_buffer_data, p, output_shape, kernel_size, input_image_size,
+                       p.num_output_channels / conv_transpose_attrs_.group, Ydata + group_id * Y_offset,
+                       thread_pool);
     }
 
     if (p.B != nullptr) {
@@ -77,32 +77,26 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
   concurrency::ThreadPool::TryBatchParallelFor(
       p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(norm_count),
       [&](ptrdiff_t task_idx) {
-        const T* p_input = X_data + task_idx * norm_size;
-        T* p_output = Y_data + task_idx * norm_size;
+        // the reductions and the normalization are expressed on Eigen arrays so they vectorize
+        ConstEigenVectorArrayMap<T> input(X_data + task_idx * norm_size, norm_size);
+        EigenVectorArrayMap<T> output(Y_data + task_idx * norm_size, norm_size);
+        ConstEigenVectorArrayMap<T> scale_array(scale_data, norm_size);
 
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < norm_size; h++) {
-          mean += p_input[h];
-          mean_square += p_input[h] * p_input[h];
-        }
-
-        mean = mean / norm_size;
+        T mean = input.sum() / norm_size;
+        T mean_square = input.square().sum() / norm_size;
         if (simplified) {
-          mean_square = sqrt(mean_square / norm_size + epsilon);
+          mean_square = sqrt(mean_square + epsilon);
         } else {
-          mean_square = sqrt(mean_square / norm_size - mean * mean + epsilon);
+          mean_square = sqrt(mean_square - mean * mean + epsilon);
         }
 
-        for (int64_t h = 0; h < norm_size; h++) {
-          if (simplified) {
-            p_output[h] = p_input[h] / mean_square * scale_data[h];
-          } else if (nullptr == bias) {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h];
-          } else {
-            p_output[h] = (p_input[h] - mean) / mean_square * scale_data[h] + bias_data[h];
-          }
+        const T inv_std_dev = 1 / mean_square;
+        if (simplified) {
+          output = input * inv_std_dev * scale_array;
+        } else if (nullptr == bias_data) {
+          output = (input - mean) * inv_std_dev * scale_array;
+        } else {
+          output = (input - mean) * inv_std_dev * scale_array + ConstEigenVectorArrayMap<T>(bias_data, norm_size);
         }
 
         if (mean_data != nullptr) {
@@ -111,7 +105,7 @@ Status ComputeImpl(OpKernelContext* p_ctx, int64_t orig_axis, float epsilon, boo
         }
 
         if (inv_std_dev_data != nullptr) {
-          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(1 / mean_square);
+          inv_std_dev_data[task_idx] = gsl::narrow_cast<U>(inv_std_dev);
         }
       },
       0);
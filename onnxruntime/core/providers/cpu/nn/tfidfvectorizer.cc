@@ -9,6 +9,7 @@
 #include "core/platform/threadpool.h"
 
 #include <functional>
+#include <limits>
 #include <string_view>
 
 namespace onnxruntime {
@@ -25,66 +26,79 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
-// for (1,2,3) node 2 would be a child of 1 but have id == 0
-// because (1,2) does not exists. Node 3 would have a valid id.
-template <class T>
-struct NgramPart;
-
-template <>
-struct NgramPart<int64_t>;
-
-template <>
-struct NgramPart<std::string>;
-
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
-
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = InlinedHashMap<int64_t, std::unique_ptr<NgramPartInt>>;
-
-#ifndef DISABLE_ABSEIL
-using StrMap = absl::flat_hash_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                   std::hash<std::string>, std::equal_to<std::string>>;
-#else
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
-#endif
-
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+// NgramTrie is a trie of the n-grams of the pool over the ids of their items.
+// for a unigram (1) it would add a child to the root with a valid n-gram id.
+// for (1,2,3) node 2 would be a child of 1 but have an n-gram id of 0
+// because (1,2) does not exists. Node 3 would have a valid n-gram id.
+// The nodes are indexes in flat arrays instead of a hash map per node, and the children of the root are
+// indexed directly by the item id, so that the lookups don't chase pointers.
+struct NgramTrie {
+  static constexpr uint32_t kRoot = 0;
+  static constexpr uint32_t kNoNode = 0;  // the root is never a child
+  static constexpr uint32_t kNoItem = std::numeric_limits<uint32_t>::max();
+
+  // n-gram id of each node, 0 - means no entry, search for a bigger N
+  std::vector<size_t> ngram_ids_{0};
+  // child of the root by item id
+  std::vector<uint32_t> root_children_;
+  // child of the other nodes by (node << 32) | item id
+  InlinedHashMap<uint64_t, uint32_t> children_;
+
+  uint32_t Child(uint32_t node, uint32_t item) const {
+    if (node == kRoot) {
+      return item < root_children_.size() ? root_children_[item] : kNoNode;
+    }
+    auto hit = children_.find(ChildKey(node, item));
+    return hit == children_.end() ? kNoNode : hit->second;
+  }
+
+  uint32_t AddChild(uint32_t node, uint32_t item) {
+    uint32_t child = Child(node, item);
+    if (child == kNoNode) {
+      child = narrow<uint32_t>(ngram_ids_.size());
+      ngram_ids_.push_back(0);
+      if (node == kRoot) {
+        if (item >= root_children_.size()) {
+          root_children_.resize(SafeInt<size_t>(item) + 1, kNoNode);
+        }
+        root_children_[item] = child;
+      } else {
+        children_.emplace(ChildKey(node, item), child);
+      }
+    }
+    return child;
+  }
 
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
+  static uint64_t ChildKey(uint32_t node, uint32_t item) {
+    return (uint64_t{node} << 32) | item;
+  }
 };
 
+// Maps the items of the pool to dense ids, so that each input item is looked up once per row.
+using IntVocabulary = InlinedHashMap<int64_t, uint32_t>;
+// This map contains references to pool_strings entries
+using StrVocabulary = InlinedHashMap<std::string_view, uint32_t>;
+
+inline uint32_t AddItem(IntVocabulary& vocabulary, int64_t item) {
+  return vocabulary.emplace(item, narrow<uint32_t>(vocabulary.size())).first->second;
+}
+
+inline uint32_t AddItem(StrVocabulary& vocabulary, const std::string& item) {
+  return vocabulary.emplace(item, narrow<uint32_t>(vocabulary.size())).first->second;
+}
+
 // Returns next ngram_id
-template <class K, class ForwardIter, class Map>
+template <class ForwardIter, class Vocabulary>
 inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
+                            Vocabulary& vocabulary, NgramTrie& trie) {
   for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, std::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
-      }
-      ++n;
-      m = &p.first->second->leafs_;
+    uint32_t node = NgramTrie::kRoot;
+    for (size_t n = 0; n < ngram_size; ++n, ++first) {
+      node = trie.AddChild(node, AddItem(vocabulary, *first));
     }
+    ORT_ENFORCE(trie.ngram_ids_[node] == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+    trie.ngram_ids_[node] = ngram_id;
+    ++ngram_id;
   }
   return ngram_id;
 }
@@ -134,11 +148,10 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const int64_t> ngram_indexes_;
   gsl::span<const float> weights_;
 
-  // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // Ids of the pool_strings or pool_int64s entries
+  StrVocabulary str_vocabulary_;
+  IntVocabulary int64_vocabulary_;
+  NgramTrie trie_;
 
   size_t output_size_ = 0;
 
@@ -241,9 +254,11 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
         if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
+          ngram_id = PopulateGrams(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id,
+                                   impl_->int64_vocabulary_, impl_->trie_);
         } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
+          ngram_id = PopulateGrams(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id,
+                                   impl_->str_vocabulary_, impl_->trie_);
         }
       } else {
         ngram_id += ngrams;
@@ -255,69 +270,58 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
 
 TfIdfVectorizer::~TfIdfVectorizer() = default;
 
-void TfIdfVectorizer::ComputeImpl(const void* x_data_raw, size_t elem_size, ptrdiff_t row_num, size_t row_size,
-                                  bool is_input_string, gsl::span<float> output_data,
-                                  std::function<void(size_t, gsl::span<float>&)>& fn_weight) const {
+void TfIdfVectorizer::MapRowItems(const void* x_data_raw, size_t elem_size, ptrdiff_t row_num, size_t row_size,
+                                  bool is_input_string, gsl::span<uint32_t> items) const {
   const void* const row_begin = AdvanceElementPtr(x_data_raw, row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
+  const auto& impl = *impl_;
+
+  if (is_input_string) {
+    const std::string* str_items = reinterpret_cast<const std::string*>(row_begin);
+    for (size_t i = 0; i < row_size; ++i) {
+      auto hit = impl.str_vocabulary_.find(std::string_view(str_items[i]));
+      items[i] = hit == impl.str_vocabulary_.end() ? NgramTrie::kNoItem : hit->second;
+    }
+  } else {
+    for (size_t i = 0; i < row_size; ++i) {
+      const void* item = AdvanceElementPtr(row_begin, i, elem_size);
+      int64_t val = (elem_size == 4) ? int64_t{*reinterpret_cast<const int32_t*>(item)} : *reinterpret_cast<const int64_t*>(item);
+      auto hit = impl.int64_vocabulary_.find(val);
+      items[i] = hit == impl.int64_vocabulary_.end() ? NgramTrie::kNoItem : hit->second;
+    }
+  }
+}
 
+void TfIdfVectorizer::ComputeImpl(gsl::span<const uint32_t> items, gsl::span<float> output_data,
+                                  std::function<void(size_t, gsl::span<float>&)>& fn_weight) const {
   const auto& impl = *impl_;
+  const auto& trie = impl.trie_;
+  const size_t row_size = items.size();
   const auto max_gram_length = impl.max_gram_length_;
   const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
   auto start_ngram_size = impl.min_gram_length_;
   size_t output_idx;
 
   for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
-
-    while (ngram_start < ngram_row_end) {
+    for (size_t ngram_start = 0; ngram_start < row_size; ++ngram_start) {
       // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, SafeInt<size_t>(skip_distance) * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
+      if (ngram_start + SafeInt<size_t>(skip_distance) * (start_ngram_size - 1) >= row_size) {
         break;
       }
 
-      auto ngram_item = ngram_start;
-      if (is_input_string) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
-            fn_weight(output_idx, output_data);
-          }
-          str_map = &hit->second->leafs_;
+      uint32_t node = NgramTrie::kRoot;
+      size_t item = ngram_start;
+      for (auto ngram_size = 1;
+           ngram_size <= max_gram_length && item < row_size;
+           ++ngram_size, item += skip_distance) {
+        node = trie.Child(node, items[item]);
+        if (node == NgramTrie::kNoNode) {
+          break;
         }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (elem_size == 4) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            output_idx = impl.OutputIdToIncrement(hit->second->id_);
-            fn_weight(output_idx, output_data);
-          }
-          int_map = &hit->second->leafs_;
+        if (ngram_size >= start_ngram_size && trie.ngram_ids_[node] != 0) {
+          output_idx = impl.OutputIdToIncrement(trie.ngram_ids_[node]);
+          fn_weight(output_idx, output_data);
         }
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
     }
     // We count UniGrams only once since they are not affected
     // by skip distance
@@ -373,8 +377,8 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   const bool is_input_string = X->IsDataTypeString();
 
   if (total_items == 0 ||
-      (is_input_string && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+      (is_input_string && impl_->str_vocabulary_.empty()) ||
+      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_vocabulary_.empty())) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
@@ -418,10 +422,12 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
                                        is_input_string, num_batches, num_rows, &fn_weight](ptrdiff_t batch_num) {
     // Frequency holder allocate [B..output_size_] and init all to zero.
     auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_batches, static_cast<size_t>(num_rows));
+    std::vector<uint32_t> items(C);
     for (auto row_num = work.start; row_num < work.end; ++row_num) {
       auto out = gsl::span<float>(output_data + row_num * this->impl_->output_size_, this->impl_->output_size_);
       std::fill(out.begin(), out.end(), 0.0f);
-      ComputeImpl(x_data_raw, elem_size, row_num, C, is_input_string, out, fn_weight);
+      MapRowItems(x_data_raw, elem_size, row_num, C, is_input_string, items);
+      ComputeImpl(items, out, fn_weight);
     }
   };
 
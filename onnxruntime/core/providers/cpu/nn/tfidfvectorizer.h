@@ -19,8 +19,12 @@ class TfIdfVectorizer final : public OpKernel {
   Status Compute(OpKernelContext* ctx) const override;
 
  private:
-  void ComputeImpl(const void* x_data_raw, size_t elem_size, ptrdiff_t row_num, size_t row_size, bool is_input_string,
-                   gsl::span<float> output_data, std::function<void(size_t, gsl::span<float>&)>& fn_weight) const;
+  // Maps the items of a row to their ids in the pool, or NgramTrie::kNoItem if they aren't in it.
+  void MapRowItems(const void* x_data_raw, size_t elem_size, ptrdiff_t row_num, size_t row_size, bool is_input_string,
+                   gsl::span<uint32_t> items) const;
+
+  void ComputeImpl(gsl::span<const uint32_t> items, gsl::span<float> output_data,
+                   std::function<void(size_t, gsl::span<float>&)>& fn_weight) const;
 
   struct Impl;
   std::unique_ptr<Impl> impl_;
@@ -13,10 +13,11 @@ limitations under the License.
 
 #include "non_max_suppression.h"
 
-#include <queue>
+#include <algorithm>
 #include <utility>
 
 #include "core/common/narrow.h"
+#include "core/platform/threadpool.h"
 #include "non_max_suppression_helper.h"
 
 // TODO:fix the warnings
@@ -118,6 +119,178 @@ Status NonMaxSuppressionBase::GetThresholdsFromInputs(const PrepareContext& pc,
   return Status::OK();
 }
 
+namespace {
+// The corners and areas of boxes, in separate arrays so that the IOU of a box with a block of boxes can be vectorized.
+struct BoxCorners {
+  std::vector<float> x_min;
+  std::vector<float> y_min;
+  std::vector<float> x_max;
+  std::vector<float> y_max;
+  std::vector<float> area;
+
+  void Resize(size_t num_boxes) {
+    x_min.resize(num_boxes);
+    y_min.resize(num_boxes);
+    x_max.resize(num_boxes);
+    y_max.resize(num_boxes);
+    area.resize(num_boxes);
+  }
+
+  void Clear() {
+    x_min.clear();
+    y_min.clear();
+    x_max.clear();
+    y_max.clear();
+    area.clear();
+  }
+
+  void Add(const BoxCorners& boxes, size_t index) {
+    x_min.push_back(boxes.x_min[index]);
+    y_min.push_back(boxes.y_min[index]);
+    x_max.push_back(boxes.x_max[index]);
+    y_max.push_back(boxes.y_max[index]);
+    area.push_back(boxes.area[index]);
+  }
+
+  void Set(size_t to, const BoxCorners& boxes, size_t index) {
+    x_min[to] = boxes.x_min[index];
+    y_min[to] = boxes.y_min[index];
+    x_max[to] = boxes.x_max[index];
+    y_max[to] = boxes.y_max[index];
+    area[to] = boxes.area[index];
+  }
+};
+
+// Computes the corners the same way as SuppressByIOU.
+void ComputeBoxCorners(const float* boxes_data, int64_t num_boxes, int64_t center_point_box, BoxCorners& corners) {
+  corners.Resize(narrow<size_t>(num_boxes));
+  for (size_t i = 0; i < narrow<size_t>(num_boxes); ++i) {
+    const float* box = boxes_data + 4 * i;
+    // center_point_box_ only support 0 or 1
+    if (0 == center_point_box) {
+      // boxes data format [y1, x1, y2, x2],
+      MaxMin(box[1], box[3], corners.x_min[i], corners.x_max[i]);
+      MaxMin(box[0], box[2], corners.y_min[i], corners.y_max[i]);
+    } else {
+      // 1 == center_point_box_ => boxes data format [x_center, y_center, width, height]
+      const float width_half = box[2] / 2;
+      const float height_half = box[3] / 2;
+      corners.x_min[i] = box[0] - width_half;
+      corners.x_max[i] = box[0] + width_half;
+      corners.y_min[i] = box[1] - height_half;
+      corners.y_max[i] = box[1] + height_half;
+    }
+
+    corners.area[i] = (corners.x_max[i] - corners.x_min[i]) * (corners.y_max[i] - corners.y_min[i]);
+  }
+}
+
+// Whether box2 suppresses box1, the same as SuppressByIOU but without branches so that it can be vectorized.
+inline bool IsSuppressedByIOU(const BoxCorners& boxes1, size_t index1, const BoxCorners& boxes2, size_t index2,
+                              float iou_threshold) {
+  const float intersection_width = std::min(boxes1.x_max[index1], boxes2.x_max[index2]) -
+                                   std::max(boxes1.x_min[index1], boxes2.x_min[index2]);
+  const float intersection_height = std::min(boxes1.y_max[index1], boxes2.y_max[index2]) -
+                                    std::max(boxes1.y_min[index1], boxes2.y_min[index2]);
+  const float intersection_area = intersection_width * intersection_height;
+  const float area1 = boxes1.area[index1];
+  const float area2 = boxes2.area[index2];
+  const float union_area = area1 + area2 - intersection_area;
+  return (intersection_width > .0f) & (intersection_height > .0f) & (intersection_area > .0f) &
+         (area1 > .0f) & (area2 > .0f) & (union_area > .0f) & (intersection_area / union_area > iou_threshold);
+}
+
+// The selected boxes are compared with a candidate in blocks, stopping at the first block which suppresses it.
+constexpr size_t kIOUBlockSize = 16;
+
+bool IsSuppressedBySelectedBoxes(const BoxCorners& boxes, size_t index, const BoxCorners& selected_boxes,
+                                 float iou_threshold) {
+  const size_t num_selected = selected_boxes.area.size();
+  for (size_t block_start = 0; block_start < num_selected; block_start += kIOUBlockSize) {
+    const size_t block_end = std::min(num_selected, block_start + kIOUBlockSize);
+    bool suppressed = false;
+    for (size_t i = block_start; i < block_end; ++i) {
+      suppressed |= IsSuppressedByIOU(boxes, index, selected_boxes, i, iou_threshold);
+    }
+
+    if (suppressed) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// The bitmask based selection is used for the (batch, class) pairs with this many candidates when there are fewer
+// pairs than threads. It computes the IOU of all the pairs of candidates across the threads before selecting, which
+// does more work than the greedy selection but isn't serial.
+constexpr size_t kMinBitmaskCandidates = 256;
+constexpr size_t kMaxBitmaskCandidates = 4096;
+constexpr size_t kBitsPerMaskWord = 64;
+
+struct BoxInfoPtr {
+  float score_{};
+  int64_t index_{};
+
+  BoxInfoPtr() = default;
+  explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
+  inline bool operator<(const BoxInfoPtr& rhs) const {
+    return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
+  }
+};
+
+// Selects the candidates in the order of their scores using a bitmask of the candidates each candidate suppresses.
+void SelectBoxesWithBitmask(const BoxCorners& boxes, std::vector<BoxInfoPtr>& candidate_boxes,
+                            int64_t max_output_boxes_per_class, float iou_threshold,
+                            std::vector<int64_t>& selected_box_indices, concurrency::ThreadPool* tp) {
+  std::sort(candidate_boxes.begin(), candidate_boxes.end(),
+            [](const BoxInfoPtr& lhs, const BoxInfoPtr& rhs) { return rhs < lhs; });
+
+  const size_t num_candidates = candidate_boxes.size();
+  BoxCorners sorted_boxes;
+  sorted_boxes.Resize(num_candidates);
+  for (size_t i = 0; i < num_candidates; ++i) {
+    sorted_boxes.Set(i, boxes, narrow<size_t>(candidate_boxes[i].index_));
+  }
+
+  // bit j of row i is set if the i-th candidate suppresses the j-th one, for j > i
+  const size_t num_words = (num_candidates + kBitsPerMaskWord - 1) / kBitsPerMaskWord;
+  std::vector<uint64_t> masks(num_candidates * num_words, 0);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(num_candidates), static_cast<double>(num_candidates * 8),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (size_t i = narrow<size_t>(first); i < narrow<size_t>(last); ++i) {
+          uint64_t* mask = masks.data() + i * num_words;
+          for (size_t word = (i + 1) / kBitsPerMaskWord; word < num_words; ++word) {
+            const size_t j_begin = std::max(i + 1, word * kBitsPerMaskWord);
+            const size_t j_end = std::min(num_candidates, (word + 1) * kBitsPerMaskWord);
+            uint64_t bits = 0;
+            for (size_t j = j_begin; j < j_end; ++j) {
+              bits |= static_cast<uint64_t>(IsSuppressedByIOU(sorted_boxes, j, sorted_boxes, i, iou_threshold))
+                      << (j % kBitsPerMaskWord);
+            }
+            mask[word] = bits;
+          }
+        }
+      });
+
+  std::vector<uint64_t> suppressed(num_words, 0);
+  for (size_t i = 0; i < num_candidates &&
+                     static_cast<int64_t>(selected_box_indices.size()) < max_output_boxes_per_class;
+       ++i) {
+    if (suppressed[i / kBitsPerMaskWord] & (uint64_t{1} << (i % kBitsPerMaskWord))) {
+      continue;
+    }
+
+    selected_box_indices.push_back(candidate_boxes[i].index_);
+    const uint64_t* mask = masks.data() + i * num_words;
+    for (size_t word = i / kBitsPerMaskWord; word < num_words; ++word) {
+      suppressed[word] |= mask[word];
+    }
+  }
+}
+}  // namespace
+
 Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   PrepareContext pc;
   ORT_RETURN_IF_ERROR(PrepareCompute(ctx, pc));
@@ -136,32 +309,35 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
   const auto* const boxes_data = pc.boxes_data_;
   const auto* const scores_data = pc.scores_data_;
 
-  struct BoxInfoPtr {
-    float score_{};
-    int64_t index_{};
-
-    BoxInfoPtr() = default;
-    explicit BoxInfoPtr(float score, int64_t idx) : score_(score), index_(idx) {}
-    inline bool operator<(const BoxInfoPtr& rhs) const {
-      return score_ < rhs.score_ || (score_ == rhs.score_ && index_ > rhs.index_);
-    }
-  };
-
   const auto center_point_box = GetCenterPointBox();
-
-  std::vector<SelectedIndex> selected_indices;
-  std::vector<BoxInfoPtr> selected_boxes_inside_class;
-  selected_boxes_inside_class.reserve(std::min<size_t>(static_cast<size_t>(max_output_boxes_per_class), pc.num_boxes_));
-
-  for (int64_t batch_index = 0; batch_index < pc.num_batches_; ++batch_index) {
-    for (int64_t class_index = 0; class_index < pc.num_classes_; ++class_index) {
-      int64_t box_score_offset = (batch_index * pc.num_classes_ + class_index) * pc.num_boxes_;
-      const float* batch_boxes = boxes_data + (batch_index * pc.num_boxes_ * 4);
-      std::vector<BoxInfoPtr> candidate_boxes;
-      candidate_boxes.reserve(pc.num_boxes_);
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  // the boxes of a batch are shared by all its classes
+  std::vector<BoxCorners> batch_boxes(narrow<size_t>(pc.num_batches_));
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, narrow<std::ptrdiff_t>(pc.num_batches_),
+                                                [&](std::ptrdiff_t batch_index) {
+                                                  ComputeBoxCorners(boxes_data + batch_index * pc.num_boxes_ * 4,
+                                                                    pc.num_boxes_, center_point_box,
+                                                                    batch_boxes[narrow<size_t>(batch_index)]);
+                                                });
+
+  // the (batch, class) pairs are run across the threads, unless there are fewer of them than threads, in which case
+  // each of them runs the bitmask based selection across the threads if it has enough candidates
+  const int64_t num_pairs = pc.num_batches_ * pc.num_classes_;
+  const bool parallel_pairs = num_pairs >= concurrency::ThreadPool::DegreeOfParallelism(tp);
+  std::vector<std::vector<int64_t>> selected_box_indices(narrow<size_t>(num_pairs));
+
+  const auto select_boxes = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    std::vector<BoxInfoPtr> candidate_boxes;
+    candidate_boxes.reserve(pc.num_boxes_);
+    BoxCorners selected_boxes;
+    for (std::ptrdiff_t pair = first; pair < last; ++pair) {
+      const BoxCorners& boxes = batch_boxes[narrow<size_t>(pair / pc.num_classes_)];
+      auto& selected = selected_box_indices[narrow<size_t>(pair)];
+      candidate_boxes.clear();
 
       // Filter by score_threshold_
-      const auto* class_scores = scores_data + box_score_offset;
+      const auto* class_scores = scores_data + pair * pc.num_boxes_;
       if (pc.score_threshold_ != nullptr) {
         for (int64_t box_index = 0; box_index < pc.num_boxes_; ++box_index, ++class_scores) {
           if (*class_scores > score_threshold) {
@@ -173,33 +349,54 @@ Status NonMaxSuppression::Compute(OpKernelContext* ctx) const {
           candidate_boxes.emplace_back(*class_scores, box_index);
         }
       }
-      std::priority_queue<BoxInfoPtr, std::vector<BoxInfoPtr>> sorted_boxes(std::less<BoxInfoPtr>(), std::move(candidate_boxes));
 
-      selected_boxes_inside_class.clear();
-      // Get the next box with top score, filter by iou_threshold
-      while (!sorted_boxes.empty() && static_cast<int64_t>(selected_boxes_inside_class.size()) < max_output_boxes_per_class) {
-        const BoxInfoPtr& next_top_score = sorted_boxes.top();
-
-        bool selected = true;
-        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union) threshold
-        for (const auto& selected_index : selected_boxes_inside_class) {
-          if (SuppressByIOU(batch_boxes, next_top_score.index_, selected_index.index_, center_point_box, iou_threshold)) {
-            selected = false;
-            break;
-          }
-        }
+      if (!parallel_pairs && candidate_boxes.size() >= kMinBitmaskCandidates &&
+          candidate_boxes.size() <= kMaxBitmaskCandidates) {
+        SelectBoxesWithBitmask(boxes, candidate_boxes, max_output_boxes_per_class, iou_threshold, selected, tp);
+        continue;
+      }
 
-        if (selected) {
-          selected_boxes_inside_class.push_back(next_top_score);
-          selected_indices.emplace_back(batch_index, class_index, next_top_score.index_);
+      // the candidates are taken from a heap so that only the ones which are reached are ordered
+      std::make_heap(candidate_boxes.begin(), candidate_boxes.end());
+      auto heap_end = candidate_boxes.end();
+      selected_boxes.Clear();
+      // Get the next box with top score, filter by iou_threshold
+      while (heap_end != candidate_boxes.begin() &&
+             static_cast<int64_t>(selected.size()) < max_output_boxes_per_class) {
+        const auto box_index = narrow<size_t>(candidate_boxes.front().index_);
+        // Check with existing selected boxes for this class, suppress if exceed the IOU (Intersection Over Union)
+        // threshold
+        if (!IsSuppressedBySelectedBoxes(boxes, box_index, selected_boxes, iou_threshold)) {
+          selected_boxes.Add(boxes, box_index);
+          selected.push_back(static_cast<int64_t>(box_index));
         }
-        sorted_boxes.pop();
+        std::pop_heap(candidate_boxes.begin(), heap_end);
+        --heap_end;
       }  // while
-    }  // for class_index
-  }  // for batch_index
+    }
+  };
+
+  if (parallel_pairs) {
+    concurrency::ThreadPool::TryParallelFor(tp, narrow<std::ptrdiff_t>(num_pairs),
+                                            static_cast<double>(pc.num_boxes_) * 64, select_boxes);
+  } else {
+    select_boxes(0, narrow<std::ptrdiff_t>(num_pairs));
+  }
+
+  size_t num_selected = 0;
+  for (const auto& selected : selected_box_indices) {
+    num_selected += selected.size();
+  }
+
+  std::vector<SelectedIndex> selected_indices;
+  selected_indices.reserve(num_selected);
+  for (int64_t pair = 0; pair < num_pairs; ++pair) {
+    for (int64_t box_index : selected_box_indices[narrow<size_t>(pair)]) {
+      selected_indices.emplace_back(pair / pc.num_classes_, pair % pc.num_classes_, box_index);
+    }
+  }
 
   constexpr auto last_dim = 3;
-  const auto num_selected = selected_indices.size();
   Tensor* output = ctx->Output(0, {static_cast<int64_t>(num_selected), last_dim});
   ORT_ENFORCE(output != nullptr);
   static_assert(last_dim * sizeof(int64_t) == sizeof(SelectedIndex), "Possible modification of SelectedIndex");
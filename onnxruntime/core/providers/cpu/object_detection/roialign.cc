@@ -163,50 +163,72 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
   int64_t pooled_height = output_shape[2];
   int64_t pooled_width = output_shape[3];
 
-  // 100 is a random chosed value, need be tuned
-  double cost = static_cast<double>(channels * pooled_width * pooled_height * 100);
+  // When there are fewer ROIs than threads, the channels of the ROIs are split into blocks across the threads as well.
+  // Each block computes the interpolation weights of its ROI, which costs much less than interpolating the channels.
+  const int64_t num_threads = ThreadPool::DegreeOfParallelism(ttp);
+  const int64_t channel_blocks =
+      (n_rois == 0 || n_rois >= num_threads)
+          ? 1
+          : std::max<int64_t>(1, std::min(channels, (num_threads + n_rois - 1) / n_rois));
+  const int64_t channels_per_block = (channels + channel_blocks - 1) / channel_blocks;
 
-  ThreadPool::TryParallelFor(ttp, static_cast<ptrdiff_t>(n_rois), cost, [&](ptrdiff_t n, ptrdiff_t end) {
-    for (; n != end; ++n) {
+  // 100 is a random chosed value, need be tuned
+  double cost = static_cast<double>(channels_per_block * pooled_width * pooled_height * 100);
+
+  const auto num_work_items = static_cast<ptrdiff_t>(n_rois * channel_blocks);
+  ThreadPool::TryParallelFor(ttp, num_work_items, cost, [&](ptrdiff_t first, ptrdiff_t last) {
+    std::vector<PreCalc<T>> pre_calc;
+    int64_t roi_bin_grid_h = 0;
+    int64_t roi_bin_grid_w = 0;
+    int64_t count = 0;
+    int64_t current_n = -1;
+
+    for (ptrdiff_t work_index = first; work_index != last; ++work_index) {
+      const int64_t n = work_index / channel_blocks;
+      const int64_t c_begin = (work_index % channel_blocks) * channels_per_block;
+      const int64_t c_end = std::min(c_begin + channels_per_block, channels);
       int64_t index_n = n * channels * pooled_width * pooled_height;
-
-      const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
       const auto roi_batch_ind = batch_indices_ptr[n];
 
-      // Do not using rounding; this implementation detail is critical
-      T offset = half_pixel ? (T)0.5 : (T)0.0;
-      T roi_start_w = offset_bottom_rois[0] * spatial_scale - offset;
-      T roi_start_h = offset_bottom_rois[1] * spatial_scale - offset;
-      T roi_end_w = offset_bottom_rois[2] * spatial_scale - offset;
-      T roi_end_h = offset_bottom_rois[3] * spatial_scale - offset;
-
-      T roi_width = roi_end_w - roi_start_w;
-      T roi_height = roi_end_h - roi_start_h;
-      if (!half_pixel) {
-        // Force malformed ROIs to be 1x1
-        roi_width = std::max(roi_width, (T)1.);
-        roi_height = std::max(roi_height, (T)1.);
-      }
+      if (n != current_n) {
+        current_n = n;
+        const T* offset_bottom_rois = bottom_rois + n * num_roi_cols;
+
+        // Do not using rounding; this implementation detail is critical
+        T offset = half_pixel ? (T)0.5 : (T)0.0;
+        T roi_start_w = offset_bottom_rois[0] * spatial_scale - offset;
+        T roi_start_h = offset_bottom_rois[1] * spatial_scale - offset;
+        T roi_end_w = offset_bottom_rois[2] * spatial_scale - offset;
+        T roi_end_h = offset_bottom_rois[3] * spatial_scale - offset;
+
+        T roi_width = roi_end_w - roi_start_w;
+        T roi_height = roi_end_h - roi_start_h;
+        if (!half_pixel) {
+          // Force malformed ROIs to be 1x1
+          roi_width = std::max(roi_width, (T)1.);
+          roi_height = std::max(roi_height, (T)1.);
+        }
 
-      T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
-      T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
+        T bin_size_h = static_cast<T>(roi_height) / static_cast<T>(pooled_height);
+        T bin_size_w = static_cast<T>(roi_width) / static_cast<T>(pooled_width);
 
-      // We use roi_bin_grid to sample the grid and mimic integral
-      int64_t roi_bin_grid_h = (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_height / pooled_height));  // e.g., = 2
-      int64_t roi_bin_grid_w =
-          (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
+        // We use roi_bin_grid to sample the grid and mimic integral
+        roi_bin_grid_h = (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_height / pooled_height));  // e.g., = 2
+        roi_bin_grid_w =
+            (sampling_ratio > 0) ? sampling_ratio : static_cast<int64_t>(std::ceil(roi_width / pooled_width));
 
-      // We do average (integral) pooling inside a bin
-      const int64_t count = std::max(roi_bin_grid_h * roi_bin_grid_w, static_cast<int64_t>(1));  // e.g. = 4
+        // We do average (integral) pooling inside a bin
+        count = std::max(roi_bin_grid_h * roi_bin_grid_w, static_cast<int64_t>(1));  // e.g. = 4
 
-      // we want to precalculate indices and weights shared by all channels,
-      // this is the key point of optimization
-      std::vector<PreCalc<T>> pre_calc(roi_bin_grid_h * roi_bin_grid_w * pooled_width * SafeInt<size_t>(pooled_height));
-      PreCalcForBilinearInterpolate(height, width, pooled_height, pooled_width, roi_bin_grid_h, roi_bin_grid_w,
-                                    roi_start_h, roi_start_w, bin_size_h, bin_size_w, roi_bin_grid_h,
-                                    roi_bin_grid_w, pre_calc);
+        // we want to precalculate indices and weights shared by all channels,
+        // this is the key point of optimization
+        pre_calc.resize(roi_bin_grid_h * roi_bin_grid_w * pooled_width * SafeInt<size_t>(pooled_height));
+        PreCalcForBilinearInterpolate(height, width, pooled_height, pooled_width, roi_bin_grid_h, roi_bin_grid_w,
+                                      roi_start_h, roi_start_w, bin_size_h, bin_size_w, roi_bin_grid_h,
+                                      roi_bin_grid_w, pre_calc);
+      }
 
-      for (int64_t c = 0; c < channels; c++) {
+      for (int64_t c = c_begin; c < c_end; c++) {
         int64_t index_n_c = index_n + c * pooled_width * pooled_height;
         const T* offset_bottom_data =
             bottom_data + static_cast<int64_t>((roi_batch_ind * channels + c) * height * width);
@@ -253,7 +275,7 @@ void RoiAlignForward(const TensorShape& output_shape, const T* bottom_data, floa
           }  // for pw
         }  // for ph
       }  // for c
-    }  // for n
+    }  // for work_index
   });
 }
 }  // namespace
@@ -479,6 +479,66 @@ struct ParallelizedData {
   typename AGG::value_type* to_data;
 };
 
+// Number of consecutive outputs which NoTransposeReduceTiles reduces together.
+constexpr int64_t kReduceTileSize = 16;
+
+// Reduces the outputs [first, end) when the innermost axis isn't reduced, i.e. last_loop_inc is 1.
+// The consecutive outputs along this axis are reduced together in tiles, so that the input values of a tile are read
+// from contiguous memory for each reduced position, instead of reading the values of each output with a stride.
+// The values are accumulated in the same order for each output as when reducing one output at a time.
+template <typename AGG, bool two_loops>
+void NoTransposeReduceTiles(const ParallelizedData<AGG>& data, std::ptrdiff_t first, std::ptrdiff_t end) {
+  const ResultsNoTransposePrepareForReduce& last_results = *data.last_results;
+  InlinedVector<AGG, kReduceTileSize> accumulators;
+
+  const auto update_tile = [&](int64_t origin, int64_t tile_size, bool first_loop) {
+    for (auto it = last_results.projected_index.begin(); it != last_results.projected_index.end(); ++it) {
+      const typename AGG::input_type* loop_red_ptr = data.from_data + (origin + *it);
+      for (int64_t red = 0; red < data.loop_size; red += last_results.last_loop_red_inc) {
+        const typename AGG::input_type* values = loop_red_ptr + red;
+        if (first_loop) {
+          for (int64_t i = 0; i < tile_size; ++i) {
+            accumulators[onnxruntime::narrow<size_t>(i)].update0(values[i]);
+          }
+        } else {
+          for (int64_t i = 0; i < tile_size; ++i) {
+            accumulators[onnxruntime::narrow<size_t>(i)].update(values[i]);
+          }
+        }
+      }
+    }
+  };
+
+  int64_t main_index = first / last_results.last_loop_size;
+  int64_t loop = first % last_results.last_loop_size;
+  for (int64_t main_index_last_loop = first; main_index_last_loop < end;) {
+    const int64_t tile_size = std::min({kReduceTileSize, end - main_index_last_loop,
+                                        last_results.last_loop_size - loop});
+    const int64_t origin = last_results.unprojected_index[onnxruntime::narrow<size_t>(main_index)] + loop;
+
+    accumulators.clear();
+    for (int64_t i = 0; i < tile_size; ++i) {
+      accumulators.emplace_back(data.denominator, data.from_data[origin + i + last_results.projected_index[0]]);
+    }
+
+    if (two_loops) {
+      update_tile(origin, tile_size, true);
+    }
+    update_tile(origin, tile_size, false);
+
+    for (int64_t i = 0; i < tile_size; ++i) {
+      data.to_data[main_index_last_loop + i] = accumulators[onnxruntime::narrow<size_t>(i)].get_value();
+    }
+
+    main_index_last_loop += tile_size;
+    loop += tile_size;
+    if (loop >= last_results.last_loop_size) {
+      loop = 0;
+      ++main_index;
+    }
+  }
+}
+
 template <typename AGG>
 void NoTransposeReduce1Loop(Tensor* output, const TensorShape& new_input_shape, const Tensor& input,
                             gsl::span<const int64_t> reduced_axes, concurrency::ThreadPool* tp,
@@ -512,6 +572,11 @@ void NoTransposeReduce1Loop(Tensor* output, const TensorShape& new_input_shape,
   auto fn = [&data](std::ptrdiff_t first, std::ptrdiff_t end) {
     const typename AGG::input_type* loop_red_ptr;
     const ResultsNoTransposePrepareForReduce& last_results = *data.last_results;
+    if (last_results.last_loop_inc == 1 && last_results.last_loop_size > 1) {
+      NoTransposeReduceTiles<AGG, false>(data, first, end);
+      return;
+    }
+
     int64_t main_index = first / last_results.last_loop_size;
     int64_t loop = first % last_results.last_loop_size;
     int64_t origin = last_results.unprojected_index[onnxruntime::narrow<size_t>(main_index)] + loop * last_results.last_loop_inc;
@@ -577,6 +642,11 @@ void NoTransposeReduce2Loops(Tensor* output, const TensorShape& new_input_shape,
   auto fn = [&](std::ptrdiff_t first, std::ptrdiff_t end) {
     const typename AGG::input_type* loop_red_ptr;
     const ResultsNoTransposePrepareForReduce& last_results = *data.last_results;
+    if (last_results.last_loop_inc == 1 && last_results.last_loop_size > 1) {
+      NoTransposeReduceTiles<AGG, true>(data, first, end);
+      return;
+    }
+
     int64_t main_index = first / last_results.last_loop_size;
     int64_t loop = first % last_results.last_loop_size;
     int64_t origin = last_results.unprojected_index[onnxruntime::narrow<size_t>(main_index)] + loop * last_results.last_loop_inc;
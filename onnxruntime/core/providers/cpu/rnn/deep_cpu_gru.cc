@@ -483,21 +483,38 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
     gsl::span<T> hidden_output_2 = hidden_output.subspan(hidden_output_size_per_direction,
                                                          hidden_output_size_per_direction);
 
+    // the directions write to separate parts of the outputs, so they can run concurrently
+    const bool concurrent_directions = RunDirectionsConcurrently(thread_pool, batch_size, hidden_size_, 3);
+    concurrency::ThreadPool* direction_thread_pool = concurrent_directions ? nullptr : thread_pool;
+
     detail::UniDirectionalGru<T> fw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_ != 0, Direction::kForward, bias_1, initial_hidden_1,
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
-                                    clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_ZR_1, recurrent_weights_H_1,
-               output_1, hidden_output_1);
+                                    clip_, direction_thread_pool);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_ != 0, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
-                                    clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_ZR_2, recurrent_weights_H_2,
-               output_2, hidden_output_2);
+                                    clip_, direction_thread_pool);
+
+    const auto compute_direction = [&](std::ptrdiff_t direction) {
+      if (direction == 0) {
+        fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_ZR_1,
+                   recurrent_weights_H_1, output_1, hidden_output_1);
+      } else {
+        bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_ZR_2,
+                   recurrent_weights_H_2, output_2, hidden_output_2);
+      }
+    };
+
+    if (concurrent_directions) {
+      concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, 2, compute_direction);
+    } else {
+      compute_direction(0);
+      compute_direction(1);
+    }
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_ != 0, direction_, bias_1, initial_hidden_1,
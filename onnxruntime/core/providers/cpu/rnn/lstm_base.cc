@@ -143,20 +143,36 @@ Status LSTMBase::ComputeImpl(OpKernelContext& context,
         hidden_output.subspan(hidden_output_size_per_direction, hidden_output_size_per_direction);
     gsl::span<InputT> last_cell_2 = last_cell.subspan(last_cell_size_per_direction, last_cell_size_per_direction);
 
+    // the directions write to separate parts of the outputs, so they can run concurrently
+    const bool concurrent_directions = RunDirectionsConcurrently(thread_pool, batch_size, hidden_size_, 4);
+    concurrency::ThreadPool* direction_thread_pool = concurrent_directions ? nullptr : thread_pool;
+
     lstm::UniDirectionalLstm<InputT> fw(alloc, logger, seq_length, batch_size, input_size, hidden_size_,
                                         Direction::kForward, input_forget_, bias_1, peephole_weights_1, initial_hidden_1,
                                         initial_cell_1, activation_funcs_.Entries()[0], activation_funcs_.Entries()[1],
-                                        activation_funcs_.Entries()[2], clip_, thread_pool);
+                                        activation_funcs_.Entries()[2], clip_, direction_thread_pool);
 
     lstm::UniDirectionalLstm<InputT> bw(alloc, logger, seq_length, batch_size, input_size, hidden_size_,
                                         Direction::kReverse, input_forget_, bias_2, peephole_weights_2, initial_hidden_2,
                                         initial_cell_2, activation_funcs_.Entries()[3], activation_funcs_.Entries()[4],
-                                        activation_funcs_.Entries()[5], clip_, thread_pool);
-
-    fw.Compute(input, sequence_lens_span, num_directions_, W_1, R_1, output_1,
-               hidden_output_1, last_cell_1);
-    bw.Compute(input, sequence_lens_span, num_directions_, W_2, R_2, output_2,
-               hidden_output_2, last_cell_2);
+                                        activation_funcs_.Entries()[5], clip_, direction_thread_pool);
+
+    const auto compute_direction = [&](std::ptrdiff_t direction) {
+      if (direction == 0) {
+        fw.Compute(input, sequence_lens_span, num_directions_, W_1, R_1, output_1,
+                   hidden_output_1, last_cell_1);
+      } else {
+        bw.Compute(input, sequence_lens_span, num_directions_, W_2, R_2, output_2,
+                   hidden_output_2, last_cell_2);
+      }
+    };
+
+    if (concurrent_directions) {
+      concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, 2, compute_direction);
+    } else {
+      compute_direction(0);
+      compute_direction(1);
+    }
   } else {
     lstm::UniDirectionalLstm<InputT> fw(alloc, logger, seq_length, batch_size, input_size, hidden_size_, direction_,
                                         input_forget_, bias_1, peephole_weights_1, initial_hidden_1, initial_cell_1,
@@ -103,6 +103,19 @@ Status ValidateCommonRnnInputs(const Tensor& X,
   return Status::OK();
 }  // namespace detail
 
+// The number of multiply-adds of the recurrent GEMM of a step up to which the directions run concurrently.
+constexpr int64_t kMaxStepMultiplyAddsForConcurrentDirections = 256 * 1024;
+
+bool RunDirectionsConcurrently(const concurrency::ThreadPool* thread_pool, int batch_size, int hidden_size,
+                               int num_gates) {
+  if (concurrency::ThreadPool::DegreeOfParallelism(thread_pool) < 2) {
+    return false;
+  }
+
+  const int64_t step_multiply_adds = static_cast<int64_t>(batch_size) * num_gates * hidden_size * hidden_size;
+  return step_multiply_adds <= kMaxStepMultiplyAddsForConcurrentDirections;
+}
+
 // map of arg name and whether the alpha and/or beta arguments are required
 static std::unordered_map<std::string, std::pair<bool, bool>> NameToArgUsageMap{
     {"affine", {true, true}},
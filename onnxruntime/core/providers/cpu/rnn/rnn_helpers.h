@@ -79,6 +79,12 @@ Status ValidateCommonRnnInputs(const Tensor& X,
                                int64_t num_directions,
                                int64_t hidden_size);
 
+// Whether the two directions of a bidirectional RNN, LSTM or GRU should run concurrently on the thread pool, each of
+// them running its own loops without the thread pool. This is the case when the recurrent GEMM of a step is too small
+// to be split across the threads, e.g. in streaming models with a batch of one.
+bool RunDirectionsConcurrently(const concurrency::ThreadPool* thread_pool, int batch_size, int hidden_size,
+                               int num_gates);
+
 /// Copy an input array repeatedly to an output array
 /// @param input_begin Beginning of input
 /// @param input_end End of input
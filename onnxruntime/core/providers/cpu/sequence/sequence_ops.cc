@@ -17,8 +17,9 @@ using namespace onnxruntime::common;
 
 namespace onnxruntime {
 
-// TODO: The current implementation of sequence ops relies on tensor copies. Ideally we should try to avoid
-// these copies. This has been postponed due to lack of time.
+// A TensorSeq holds its tensors as OrtValues, so tensors already in a sequence are shared between the input and
+// output sequences rather than copied. Tensors coming from outside a sequence are still copied in, as their buffers
+// are owned by the execution plan and may be reused once the producing value is dead.
 
 // SequenceLength
 ONNX_CPU_OPERATOR_KERNEL(
@@ -195,7 +196,8 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("S", DataTypeImpl::AllSequenceTensorTypes())
         .TypeConstraint("I", std::vector<MLDataType>{
                                  DataTypeImpl::GetTensorType<int32_t>(),
-                                 DataTypeImpl::GetTensorType<int64_t>()}),
+                                 DataTypeImpl::GetTensorType<int64_t>()})
+        .MayInplace(0, 0),
     SequenceInsert);
 
 // Using DataTransferManager here allows other non-CPU EPs to use this implementation of the sequence ops
@@ -234,6 +236,14 @@ Status SequenceInsert::Compute(OpKernelContext* context) const {
   }
 
   auto* Y = context->Output<TensorSeq>(0);
+
+  // the planner gave us the input sequence as it isn't used after this node, so update it in place
+  if (Y == S) {
+    Y->Insert(onnxruntime::narrow<size_t>(input_seq_idx),
+              CloneTensor(*X, context, Info().GetDataTransferManager()));
+    return Status::OK();
+  }
+
   Y->SetType(S->DataType());
   Y->Reserve(SafeInt<size_t>(num_tensors_input_seq) + 1);
 
@@ -262,7 +272,8 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("S", DataTypeImpl::AllSequenceTensorTypes())
         .TypeConstraint("I", std::vector<MLDataType>{
                                  DataTypeImpl::GetTensorType<int32_t>(),
-                                 DataTypeImpl::GetTensorType<int64_t>()}),
+                                 DataTypeImpl::GetTensorType<int64_t>()})
+        .MayInplace(0, 0),
     SequenceErase);
 
 Status SequenceErase::Compute(OpKernelContext* context) const {
@@ -284,6 +295,13 @@ Status SequenceErase::Compute(OpKernelContext* context) const {
   }
 
   auto* Y = context->Output<TensorSeq>(0);
+
+  // the planner gave us the input sequence as it isn't used after this node, so update it in place
+  if (Y == S) {
+    Y->Erase(onnxruntime::narrow<size_t>(input_seq_idx));
+    return Status::OK();
+  }
+
   Y->SetType(S->DataType());
   Y->Reserve(SafeInt<size_t>(num_tensors_input_seq) - 1);
 
@@ -3,10 +3,14 @@
 
 #include "core/providers/cpu/signal/dft.h"
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
 #include <functional>
 #include <limits>
+#include <memory>
+#include <mutex>
+#include <type_traits>
 #include <vector>
 #include <core/common/safeint.h>
 
@@ -100,224 +104,261 @@ static std::complex<T> compute_exponential(size_t index, const T angular_velocit
   return std::complex<T>(cos(angle), sin(angle));
 }
 
-template <typename T, typename U>
-static Status fft_radix2(OpKernelContext* /*ctx*/, const Tensor* X, Tensor* Y, size_t X_offset, size_t X_stride,
-                         size_t Y_offset, size_t Y_stride, int64_t axis, size_t dft_length, const Tensor* window,
-                         bool is_onesided, bool inverse, InlinedVector<std::complex<T>>& V,
-                         InlinedVector<std::complex<T>>& temp_output) {
-  // Get shape and significant bits
-  const auto& X_shape = X->Shape();
-  size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
-  unsigned significant_bits = static_cast<unsigned>(log2(dft_length));
+template <typename T>
+T next_power_of_2(T in) {
+  in--;
+  T out = 1;
+  while (out <= in) {
+    out <<= 1;
+  }
+  return out;
+}
 
-  // Get data
-  auto* X_data = const_cast<U*>(reinterpret_cast<const U*>(X->DataRaw())) + X_offset;
-  // Get window
-  U* window_data = nullptr;
-  if (window) {
-    window_data = const_cast<U*>(reinterpret_cast<const U*>(window->DataRaw()));
+template <typename T>
+struct FFTPlan {
+  size_t length = 0;
+  bool inverse = false;
+
+  // Power of 2 lengths: the radix-2 decimation in time, with the position of each input in the bit reversed order
+  // and the twiddle factors exp(+-2 pi i k / length) for k < length / 2.
+  std::vector<size_t> bit_reversed_positions;
+  std::vector<std::complex<T>> twiddles;
+
+  // Other lengths: Bluestein's algorithm, the transform being the convolution of the chirped input with the
+  // conjugated chirp, computed with power of 2 transforms. b_fft is the transform of the conjugated chirp.
+  std::vector<std::complex<T>> chirp;
+  std::vector<std::complex<T>> b_fft;
+  std::unique_ptr<FFTPlan<T>> convolution_forward;
+  std::unique_ptr<FFTPlan<T>> convolution_inverse;
+
+  // Forward transform of a real input of power of 2 length: the complex transform of half the length of the even
+  // and odd samples packed as real and imaginary parts, split with the twiddle factors exp(-2 pi i k / length).
+  std::unique_ptr<FFTPlan<T>> half_length;
+  std::vector<std::complex<T>> real_twiddles;
+
+  bool is_bluestein() const { return convolution_forward != nullptr; }
+  bool is_real() const { return half_length != nullptr; }
+};
+
+// Per thread buffers of the transforms.
+template <typename T>
+struct FFTScratch {
+  std::vector<T> real_input;
+  std::vector<std::complex<T>> input;
+  std::vector<std::complex<T>> output;
+  std::vector<std::complex<T>> work;
+  std::vector<std::complex<T>> work_fft;
+};
+
+// Runs the butterflies of a power of 2 plan in place, on data in the bit reversed order. The output is not scaled.
+template <typename T>
+static void fft_radix2_butterflies(const FFTPlan<T>& plan, std::complex<T>* data) {
+  const size_t length = plan.length;
+  for (size_t size = 2, twiddle_step = length >> 1; size <= length; size <<= 1, twiddle_step >>= 1) {
+    const size_t midpoint = size >> 1;
+    for (size_t j = 0; j < length; j += size) {
+      std::complex<T>* even = data + j;
+      std::complex<T>* odd = data + j + midpoint;
+      for (size_t k = 0; k < midpoint; k++) {
+        const std::complex<T> t = plan.twiddles[k * twiddle_step] * odd[k];
+        odd[k] = even[k] - t;
+        even[k] += t;
+      }
+    }
   }
+}
 
-  size_t Y_data_stride = 1;
-  std::complex<T>* Y_data;
-  if (is_onesided) {
-    if (temp_output.size() != dft_length) {
-      temp_output.resize(dft_length);
+template <typename T>
+static std::unique_ptr<FFTPlan<T>> make_fft_plan(size_t length, bool inverse, bool real_input) {
+  auto plan = std::make_unique<FFTPlan<T>>();
+  plan->length = length;
+  plan->inverse = inverse;
+
+  if (real_input) {
+    // only created for the forward transform of power of 2 lengths >= 2
+    const size_t half = length >> 1;
+    plan->half_length = make_fft_plan<T>(half, false, false);
+    const auto angular_velocity = compute_angular_velocity<T>(length, false);
+    plan->real_twiddles.resize(half);
+    for (size_t k = 0; k < half; k++) {
+      plan->real_twiddles[k] = compute_exponential(k, angular_velocity);
+    }
+  } else if (is_power_of_2(length)) {
+    const unsigned significant_bits = static_cast<unsigned>(log2(length));
+    plan->bit_reversed_positions.resize(length);
+    for (size_t i = 0; i < length; i++) {
+      plan->bit_reversed_positions[i] = bit_reverse(i, significant_bits);
+    }
+    const auto angular_velocity = compute_angular_velocity<T>(length, inverse);
+    plan->twiddles.resize(length >> 1);
+    for (size_t k = 0; k < (length >> 1); k++) {
+      plan->twiddles[k] = compute_exponential(k, angular_velocity);
     }
-    Y_data = temp_output.data();
   } else {
-    Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
-    Y_data_stride = Y_stride;
+    static constexpr T pi = static_cast<T>(M_PI);
+    const size_t M = next_power_of_2(2 * length - 1);
+    const T direction = inverse ? 1.f : -1.f;
+    plan->convolution_forward = make_fft_plan<T>(M, false, false);
+    plan->convolution_inverse = make_fft_plan<T>(M, true, false);
+
+    plan->chirp.resize(length);
+    std::vector<std::complex<T>> b(M);
+    for (size_t n = 0; n < length; n++) {
+      // n^2 modulo 2 x length keeps the angle small, the chirp having this period
+      const size_t n_squared = static_cast<size_t>((static_cast<uint64_t>(n) * n) % (2 * length));
+      const T exponent = direction * pi * static_cast<T>(n_squared) / static_cast<T>(length);
+      plan->chirp[n] = std::complex<T>(cos(exponent), sin(exponent));
+      b[n] = std::conj(plan->chirp[n]);
+    }
+    for (size_t n = M - length + 1; n < M; n++) {
+      b[n] = b[M - n];
+    }
+    plan->b_fft.resize(M);
+    const auto& convolution = *plan->convolution_forward;
+    for (size_t i = 0; i < M; i++) {
+      plan->b_fft[convolution.bit_reversed_positions[i]] = b[i];
+    }
+    fft_radix2_butterflies(convolution, plan->b_fft.data());
   }
+  return plan;
+}
 
-  auto angular_velocity = compute_angular_velocity<T>(dft_length, inverse);
-
-  // Create vandermonde matrix V ordered with the bit-reversed permutation
-  if (V.size() != dft_length) {
-    V.resize(dft_length);
-    for (size_t i = 0; i < dft_length; i++) {
-      size_t bit_reversed_index = bit_reverse(i, significant_bits);
-      V[bit_reversed_index] = compute_exponential(i, angular_velocity);
+// Transforms the contiguous complex input of the plan length into the output, with the 1/length scaling of the
+// inverse transform.
+template <typename T>
+static void fft_execute(const FFTPlan<T>& plan, const std::complex<T>* input, std::complex<T>* output,
+                        FFTScratch<T>& scratch) {
+  const size_t length = plan.length;
+  if (!plan.is_bluestein()) {
+    for (size_t i = 0; i < length; i++) {
+      output[plan.bit_reversed_positions[i]] = input[i];
     }
+    fft_radix2_butterflies(plan, output);
+    if (plan.inverse) {
+      const T scale = static_cast<T>(1) / static_cast<T>(length);
+      for (size_t i = 0; i < length; i++) {
+        output[i] *= scale;
+      }
+    }
+    return;
   }
 
-  for (size_t i = 0; i < dft_length; i++) {
-    size_t bit_reversed_index = bit_reverse(i, significant_bits);
-    auto x = (bit_reversed_index < number_of_samples) ? *(X_data + bit_reversed_index * X_stride) : 0;
-    auto window_element = window_data ? *(window_data + bit_reversed_index) : 1;
-    *(Y_data + i * Y_data_stride) = std::complex<T>(1, 0) * x * window_element;
+  const auto& forward = *plan.convolution_forward;
+  const auto& inverse = *plan.convolution_inverse;
+  const size_t M = forward.length;
+  scratch.work.assign(M, std::complex<T>(0, 0));
+  for (size_t n = 0; n < length; n++) {
+    scratch.work[forward.bit_reversed_positions[n]] = input[n] * plan.chirp[n];
   }
+  fft_radix2_butterflies(forward, scratch.work.data());
 
-  // Run fft_radix2
-  unsigned current_significant_bits = 0;
-  for (size_t i = 2; i <= dft_length; i <<= 1) {
-    size_t midpoint = i >> 1;
-    current_significant_bits++;
-
-    for (size_t k = 0; k < midpoint; k++) {
-      auto first_idx = bit_reverse(k, current_significant_bits);
-      auto second_idx = bit_reverse(midpoint + k, current_significant_bits);
-      for (size_t j = 0; j < dft_length; j += i) {
-        auto even_index = k + j;
-        auto odd_index = k + j + midpoint;
-        std::complex<T>* even = (Y_data + even_index * Y_data_stride);
-        std::complex<T>* odd = (Y_data + odd_index * Y_data_stride);
-        std::complex<T> first = *even + (V[first_idx] * *odd);
-        std::complex<T> second = *even + (V[second_idx] * *odd);
-        *even = first;
-        *odd = second;
-      }
-    }
+  scratch.work_fft.resize(M);
+  for (size_t i = 0; i < M; i++) {
+    scratch.work_fft[inverse.bit_reversed_positions[i]] = scratch.work[i] * plan.b_fft[i];
   }
+  fft_radix2_butterflies(inverse, scratch.work_fft.data());
 
-  // Scale the output if inverse
-  if (inverse) {
-    for (size_t i = 0; i < dft_length; i++) {
-      std::complex<T>& val = *(Y_data + i * Y_data_stride);
-      val /= static_cast<T>(dft_length);
-    }
+  const T scale = (plan.inverse ? static_cast<T>(1) / static_cast<T>(length) : static_cast<T>(1)) /
+                  static_cast<T>(M);
+  for (size_t k = 0; k < length; k++) {
+    output[k] = scratch.work_fft[k] * plan.chirp[k] * scale;
   }
+}
 
-  if (is_onesided) {
-    const size_t output_size = (dft_length >> 1) + 1;
-    auto destination = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
-    for (size_t i = 0; i < output_size; i++) {
-      *(destination + Y_stride * i) = *(Y_data + i * Y_data_stride);
-    }
+// Transforms the real input of the plan length into the output of the plan length.
+template <typename T>
+static void fft_execute_real(const FFTPlan<T>& plan, const T* input, std::complex<T>* output,
+                             FFTScratch<T>& scratch) {
+  const size_t half = plan.length >> 1;
+  scratch.work.resize(half);
+  for (size_t m = 0; m < half; m++) {
+    scratch.work[m] = std::complex<T>(input[2 * m], input[2 * m + 1]);
+  }
+  scratch.work_fft.resize(half);
+  fft_execute(*plan.half_length, scratch.work.data(), scratch.work_fft.data(), scratch);
+
+  // X[k] = E[k] + exp(-2 pi i k / N) O[k], the transforms E and O of the even and odd samples being the
+  // conjugate symmetric and antisymmetric parts of Z, the transform of the packed samples.
+  const std::complex<T>* Z = scratch.work_fft.data();
+  for (size_t k = 0; k <= half; k++) {
+    const std::complex<T> z = Z[k % half];
+    const std::complex<T> z_conj = std::conj(Z[(half - k) % half]);
+    const std::complex<T> even = (z + z_conj) * static_cast<T>(0.5);
+    const std::complex<T> odd = (z - z_conj) * std::complex<T>(0, -0.5);
+    output[k] = k < half ? even + plan.real_twiddles[k] * odd : even - odd;
+  }
+  for (size_t k = half + 1; k < plan.length; k++) {
+    output[k] = std::conj(output[plan.length - k]);
   }
-
-  return Status::OK();
 }
 
 template <typename T>
-T next_power_of_2(T in) {
-  in--;
-  T out = 1;
-  while (out <= in) {
-    out <<= 1;
+std::shared_ptr<const FFTPlan<T>> FFTPlanCache::Get(size_t length, bool inverse, bool real_input) const {
+  // the lengths with cached plans are few in practice, the cache is dropped if a model keeps changing them
+  constexpr size_t kMaxCachedPlans = 64;
+  const Key key{sizeof(T), length, inverse, real_input};
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = plans_.find(key);
+  if (it != plans_.end()) {
+    return std::static_pointer_cast<const FFTPlan<T>>(it->second);
   }
-  return out;
+  if (plans_.size() == kMaxCachedPlans) {
+    plans_.clear();
+  }
+  std::shared_ptr<const FFTPlan<T>> plan = make_fft_plan<T>(length, inverse, real_input);
+  plans_.emplace(key, plan);
+  return plan;
 }
 
 template <typename T, typename U>
-static Status dft_bluestein_z_chirp(
-    OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp, size_t X_offset, size_t X_stride, size_t Y_offset, size_t Y_stride,
-    int64_t axis, size_t dft_length, const Tensor* window, bool inverse, InlinedVector<std::complex<T>>& V,
-    InlinedVector<std::complex<T>>& temp_output) {
-  static constexpr T pi = static_cast<T>(M_PI);
-
-  AllocatorPtr alloc;
-  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
-
-  size_t N = static_cast<size_t>(dft_length);
-  size_t M = next_power_of_2(2 * N - 1);
-  auto dft_input_shape = onnxruntime::TensorShape({1, (int64_t)M, 2});
-  T scale = inverse ? 1.f / N : 1.f;
-  T direction = inverse ? 1.f : -1.f;
-
-  bool should_recreate_b_fft = b_fft.Shape().Size() != dft_input_shape.Size();
-  bool should_recreate_chirp = chirp.Shape().Size() != dft_input_shape.Size();
-  bool should_recreate = should_recreate_b_fft || should_recreate_chirp;
-  if (should_recreate) {
-    auto b = onnxruntime::Tensor(X->DataType(), dft_input_shape, alloc);
-    b_fft = onnxruntime::Tensor(Y->DataType(), dft_input_shape, alloc);
-    chirp = onnxruntime::Tensor(X->DataType(), dft_input_shape, alloc);
-
-    std::complex<T>* b_data = reinterpret_cast<std::complex<T>*>(b.MutableDataRaw());
-    std::complex<T>* b_fft_data = reinterpret_cast<std::complex<T>*>(b_fft.MutableDataRaw());
-    std::complex<T>* chirp_data = reinterpret_cast<std::complex<T>*>(chirp.MutableDataRaw());
-    memset(reinterpret_cast<void*>(b_data), 0, b.SizeInBytes());
-    memset(reinterpret_cast<void*>(b_fft_data), 0, b_fft.SizeInBytes());
-    memset(reinterpret_cast<void*>(chirp_data), 0, chirp.SizeInBytes());
-
-    for (size_t n = 0; n < N; n++) {
-      std::complex<T>& chirp_n = *(chirp_data + n);
-      // chirp
-      auto exponent = direction * pi * n * n / N;
-      chirp_n = std::complex<T>(cos(exponent), sin(exponent));
-
-      // b
-      std::complex<T>& b_n = *(b_data + n);
-      b_n = std::conj(chirp_n);
-    }
-
-    for (size_t n = M - N + 1; n < M; n++) {
-      std::complex<T>& b_n = *(b_data + n);
-      std::complex<T>& b_m_minus_n = *(b_data + M - n);
-      b_n = b_m_minus_n;
+static void fft_transform(const FFTPlan<T>& plan, const U* X_data, size_t X_stride, size_t number_of_samples,
+                          const T* window_data, std::complex<T>* Y_data, size_t Y_stride, size_t dft_output_size,
+                          FFTScratch<T>& scratch) {
+  // Gather the windowed input, truncated or padded with zeros to the transform length.
+  const size_t dft_length = plan.length;
+  const size_t samples = std::min(number_of_samples, dft_length);
+  scratch.output.resize(dft_length);
+  if constexpr (std::is_same_v<T, U>) {
+    if (plan.is_real()) {
+      scratch.real_input.assign(dft_length, static_cast<T>(0));
+      for (size_t i = 0; i < samples; i++) {
+        scratch.real_input[i] = X_data[i * X_stride] * (window_data ? window_data[i] : static_cast<T>(1));
+      }
+      fft_execute_real(plan, scratch.real_input.data(), scratch.output.data(), scratch);
     }
-
-    // Forward FFT radix2 for the "b" signal
-    // This will be cached and reused!
-    ORT_RETURN_IF_ERROR((fft_radix2<T, std::complex<T>>(ctx, &b, &b_fft, 0, 1, 0, 1, 1, M, nullptr,
-                                                        false, false, V, temp_output)));
   }
-
-  // Get data
-  auto* X_data = const_cast<U*>(reinterpret_cast<const U*>(X->DataRaw())) + X_offset;
-  auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw()) + Y_offset;
-  U* window_data = nullptr;
-  if (window) {
-    window_data = const_cast<U*>(reinterpret_cast<const U*>(window->DataRaw()));
-  }
-
-  auto a = onnxruntime::Tensor(X->DataType(), dft_input_shape, alloc);
-  auto a_fft = onnxruntime::Tensor(Y->DataType(), dft_input_shape, alloc);
-  std::complex<T>* a_data = reinterpret_cast<std::complex<T>*>(a.MutableDataRaw());
-  std::complex<T>* a_fft_data = reinterpret_cast<std::complex<T>*>(a_fft.MutableDataRaw());
-  std::complex<T>* b_fft_data = reinterpret_cast<std::complex<T>*>(b_fft.MutableDataRaw());
-  std::complex<T>* chirp_data = reinterpret_cast<std::complex<T>*>(chirp.MutableDataRaw());
-  memset(reinterpret_cast<void*>(a_data), 0, a.SizeInBytes());
-
-  const auto& X_shape = X->Shape();
-  size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
-
-  // Prepare "a" signal
-  for (size_t n = 0; n < number_of_samples; n++) {
-    std::complex<T>& a_n = *(a_data + n);
-    std::complex<T>& chirp_n = *(chirp_data + n);
-    auto window_n = window_data ? *(window_data + n) : 1;
-    a_n = *(X_data + n * X_stride);  // input
-    a_n *= window_n;
-    a_n *= chirp_n;
+  if (!plan.is_real()) {
+    scratch.input.assign(dft_length, std::complex<T>(0, 0));
+    for (size_t i = 0; i < samples; i++) {
+      scratch.input[i] = std::complex<T>(1, 0) * X_data[i * X_stride] *
+                         (window_data ? window_data[i] : static_cast<T>(1));
+    }
+    fft_execute(plan, scratch.input.data(), scratch.output.data(), scratch);
   }
 
-  // Forward FFT radix2 for the "a" signal
-  ORT_RETURN_IF_ERROR((fft_radix2<T, std::complex<T>>(ctx, &a, &a_fft, 0, 1, 0, 1, 1, M, nullptr,
-                                                      false, false, V, temp_output)));
-
-  for (size_t i = 0; i < M; i++) {
-    std::complex<T>& a_i = *(a_fft_data + i);
-    std::complex<T>& b_i = *(b_fft_data + i);
-    a_i *= b_i;
+  for (size_t i = 0; i < dft_output_size; i++) {
+    Y_data[i * Y_stride] = scratch.output[i];
   }
+}
 
-  // Inverse FFT radix2 for the "a" signal
-  ORT_RETURN_IF_ERROR((fft_radix2<T, std::complex<T>>(ctx, &a_fft, &a, 0, 1, 0, 1, 1, M, nullptr,
-                                                      false, true, V, temp_output)));
-  const auto& Y_shape = Y->Shape();
-  size_t dft_output_size = static_cast<size_t>(Y_shape[onnxruntime::narrow<size_t>(axis)]);
+template <typename T, typename U>
+static std::shared_ptr<const FFTPlan<T>> get_fft_plan(const FFTPlanCache& plan_cache, size_t dft_length,
+                                                      bool inverse) {
+  // A real input takes the transform of half the length, its output being conjugate symmetric.
+  const bool real_input = std::is_same_v<T, U> && !inverse && dft_length >= 2 && is_power_of_2(dft_length);
+  return plan_cache.Get<T>(dft_length, inverse, real_input);
+}
 
-  for (size_t i = 0; i < dft_output_size; i++) {
-    std::complex<T>& chirp_i = *(chirp_data + i);
-    std::complex<T>& out = *(Y_data + i * Y_stride);
-    std::complex<T>& c_i = *(a_data + i);
-    if (i > 0) {
-      // The inverse fft is computed using the same cached vandermonde matrix (V) created by the
-      // forward fft. This reversal causes the output to be reversed as well.
-      // Therefore we undo the reversal when writing the output back out.
-      c_i = *(a_data + M - i);
-    }
-    out = c_i * chirp_i * scale;
-  }
-  return Status::OK();
+// The cost of a transform for the thread pool.
+static TensorOpCost fft_cost(size_t dft_length, size_t element_size) {
+  const double length = static_cast<double>(dft_length);
+  return TensorOpCost{2 * length * static_cast<double>(element_size), 2 * length * static_cast<double>(element_size),
+                      5 * length * std::max(1.0, std::log2(length))};
 }
 
 template <typename T, typename U>
-static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor& b_fft, Tensor& chirp,
-                                         int64_t axis, int64_t dft_length, const Tensor* window, bool is_onesided, bool inverse,
-                                         InlinedVector<std::complex<T>>& V,
-                                         InlinedVector<std::complex<T>>& temp_output) {
+static Status discrete_fourier_transform(OpKernelContext* ctx, const FFTPlanCache& plan_cache, const Tensor* X,
+                                         Tensor* Y, int64_t axis, int64_t dft_length, bool inverse) {
   // Get shape
   const auto& X_shape = X->Shape();
   const auto& Y_shape = Y->Shape();
@@ -332,10 +373,19 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
     batch_and_signal_rank -= 1;
   }
 
+  const auto plan = get_fft_plan<T, U>(plan_cache, onnxruntime::narrow<size_t>(dft_length), inverse);
+  const size_t number_of_samples = static_cast<size_t>(X_shape[onnxruntime::narrow<size_t>(axis)]);
+  const size_t dft_output_size = static_cast<size_t>(Y_shape[onnxruntime::narrow<size_t>(axis)]);
+  const auto* X_data = reinterpret_cast<const U*>(X->DataRaw());
+  auto* Y_data = reinterpret_cast<std::complex<T>*>(Y->MutableDataRaw());
+
   // Calculate x/y offsets/strides
-  for (size_t i = 0; i < total_dfts; i++) {
-    size_t X_offset = 0;
-    size_t X_stride = onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  const size_t X_stride =
+      onnxruntime::narrow<size_t>(X_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / complex_input_factor);
+  const size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
+  auto offsets = [&](size_t i, size_t& X_offset, size_t& Y_offset) {
+    X_offset = 0;
+    Y_offset = 0;
     size_t cumulative_packed_stride = total_dfts;
     size_t temp = i;
     for (size_t r = 0; r < batch_and_signal_rank; r++) {
@@ -346,35 +396,27 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, const Tensor* X,
       auto index = temp / cumulative_packed_stride;
       temp -= (index * cumulative_packed_stride);
       X_offset += index * SafeInt<size_t>(X_shape.SizeFromDimension(r + 1)) / complex_input_factor;
-    }
-
-    size_t Y_offset = 0;
-    size_t Y_stride = onnxruntime::narrow<size_t>(Y_shape.SizeFromDimension(SafeInt<size_t>(axis) + 1) / 2);
-    cumulative_packed_stride = total_dfts;
-    temp = i;
-    for (size_t r = 0; r < batch_and_signal_rank; r++) {
-      if (r == static_cast<size_t>(axis)) {
-        continue;
-      }
-      cumulative_packed_stride /= onnxruntime::narrow<size_t>(X_shape[r]);
-      auto index = temp / cumulative_packed_stride;
-      temp -= (index * cumulative_packed_stride);
       Y_offset += index * SafeInt<size_t>(Y_shape.SizeFromDimension(r + 1)) / 2;
     }
-
-    if (is_power_of_2(onnxruntime::narrow<size_t>(dft_length))) {
-      ORT_RETURN_IF_ERROR((fft_radix2<T, U>(ctx, X, Y, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window,
-                                            is_onesided, inverse, V, temp_output)));
-    } else {
-      ORT_RETURN_IF_ERROR(
-          (dft_bluestein_z_chirp<T, U>(ctx, X, Y, b_fft, chirp, X_offset, X_stride, Y_offset, Y_stride, axis, onnxruntime::narrow<size_t>(dft_length), window, inverse, V, temp_output)));
-    }
-  }
+  };
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(total_dfts),
+      fft_cost(plan->length, sizeof(std::complex<T>)), [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        FFTScratch<T> scratch;
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          size_t X_offset, Y_offset;
+          offsets(static_cast<size_t>(i), X_offset, Y_offset);
+          fft_transform<T, U>(*plan, X_data + X_offset, X_stride, number_of_samples, nullptr, Y_data + Y_offset,
+                              Y_stride, dft_output_size, scratch);
+        }
+      });
 
   return Status::OK();
 }
 
-static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, bool is_onesided, bool inverse) {
+static Status discrete_fourier_transform(OpKernelContext* ctx, const FFTPlanCache& plan_cache, int64_t axis,
+                                         bool is_onesided, bool inverse) {
   // Get input shape
   const auto* X = ctx->Input<Tensor>(0);
   const auto* dft_length = ctx->Input<Tensor>(1);
@@ -408,17 +450,14 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
   // Get data type
   auto data_type = X->DataType();
 
-  Tensor b_fft, chirp;
   auto element_size = data_type->Size();
   if (element_size == sizeof(float)) {
-    InlinedVector<std::complex<float>> V;
-    InlinedVector<std::complex<float>> temp_output;
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, float>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                    is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, float>(ctx, plan_cache, X, Y, axis, number_of_samples,
+                                                                    inverse)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, std::complex<float>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<float, std::complex<float>>(ctx, plan_cache, X, Y, axis,
+                                                                                  number_of_samples, inverse)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -427,14 +466,12 @@ static Status discrete_fourier_transform(OpKernelContext* ctx, int64_t axis, boo
           data_type);
     }
   } else if (element_size == sizeof(double)) {
-    InlinedVector<std::complex<double>> V;
-    InlinedVector<std::complex<double>> temp_output;
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, double>(ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr,
-                                                                      is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, double>(ctx, plan_cache, X, Y, axis, number_of_samples,
+                                                                      inverse)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, std::complex<double>>(
-          ctx, X, Y, b_fft, chirp, axis, number_of_samples, nullptr, is_onesided, inverse, V, temp_output)));
+      ORT_RETURN_IF_ERROR((discrete_fourier_transform<double, std::complex<double>>(ctx, plan_cache, X, Y, axis,
+                                                                                    number_of_samples, inverse)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimension must be the batch dimension and its second "
@@ -456,12 +493,13 @@ Status DFT::Compute(OpKernelContext* ctx) const {
     axis = axes_tensor->Data<int64_t>()[0];
   }
 
-  ORT_RETURN_IF_ERROR(discrete_fourier_transform(ctx, axis, is_onesided_, is_inverse_));
+  ORT_RETURN_IF_ERROR(discrete_fourier_transform(ctx, plan_cache_, axis, is_onesided_, is_inverse_));
   return Status::OK();
 }
 
 template <typename T, typename U>
-static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_onesided, bool /*inverse*/) {
+static Status short_time_fourier_transform(OpKernelContext* ctx, const FFTPlanCache& plan_cache, bool is_onesided,
+                                           bool /*inverse*/) {
   // Attr("onesided"): default = 1
   // Input(0, "signal") type = T1
   // Input(1, "frame_length") type = T2
@@ -521,37 +559,30 @@ static Status short_time_fourier_transform(OpKernelContext* ctx, bool is_oneside
   auto Y = ctx->Output(0, output_spectra_shape);
   auto Y_data = reinterpret_cast<T*>(Y->MutableDataRaw());
 
-  // Get/create the signal mutable data
-  auto* signal_data = const_cast<U*>(reinterpret_cast<const U*>(signal->DataRaw()));
+  // Get the signal data
+  const auto* signal_data = reinterpret_cast<const U*>(signal->DataRaw());
+  const T* window_data = window ? reinterpret_cast<const T*>(window->DataRaw()) : nullptr;
 
-  // Define tensor shapes for each dft run
   constexpr int64_t output_components = 2;
-  auto dft_input_shape = onnxruntime::TensorShape({1, window_size, signal_components});
-  auto dft_output_shape = onnxruntime::TensorShape({1, dft_output_size, output_components});
-
-  Tensor b_fft, chirp;
-  InlinedVector<std::complex<T>> V;
-  InlinedVector<std::complex<T>> temp_output;
-
-  // Run each dft of each batch as if it was a real-valued batch size 1 dft operation
-  for (int64_t batch_idx = 0; batch_idx < batch_size; batch_idx++) {
-    for (int64_t i = 0; i < n_dfts; i++) {
-      auto input_frame_begin =
-          signal_data + (batch_idx * signal_size * signal_components) + (i * frame_step * signal_components);
-
-      auto output_frame_begin = Y_data + (batch_idx * n_dfts * dft_output_size * output_components) +
-                                (i * dft_output_size * output_components);
-
-      // Tensors do not own the backing memory, so no worries on destruction
-      auto input = onnxruntime::Tensor(signal->DataType(), dft_input_shape, input_frame_begin, signal->Location(), 0);
-
-      auto output = onnxruntime::Tensor(Y->DataType(), dft_output_shape, output_frame_begin, Y->Location(), 0);
-
-      // Run individual dft
-      ORT_RETURN_IF_ERROR((discrete_fourier_transform<T, U>(ctx, &input, &output, b_fft, chirp, 1, window_size, window, is_onesided,
-                                                            false, V, temp_output)));
-    }
-  }
+  const auto plan = get_fft_plan<T, U>(plan_cache, onnxruntime::narrow<size_t>(window_size), false);
+
+  // The frames of all the batches are independent transforms, run in parallel with the plan shared.
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(batch_size * n_dfts),
+      fft_cost(plan->length, sizeof(std::complex<T>)), [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        FFTScratch<T> scratch;
+        for (std::ptrdiff_t frame = begin; frame != end; ++frame) {
+          const int64_t batch_idx = frame / n_dfts;
+          const int64_t i = frame % n_dfts;
+          // the signal components are packed in U
+          const U* input_frame_begin = signal_data + (batch_idx * signal_size) + (i * frame_step);
+          auto* output_frame_begin = reinterpret_cast<std::complex<T>*>(
+              Y_data + (batch_idx * n_dfts * dft_output_size * output_components) +
+              (i * dft_output_size * output_components));
+          fft_transform<T, U>(*plan, input_frame_begin, 1, onnxruntime::narrow<size_t>(window_size), window_data,
+                              output_frame_begin, 1, onnxruntime::narrow<size_t>(dft_output_size), scratch);
+        }
+      });
 
   return Status::OK();
 }
@@ -576,9 +607,9 @@ Status STFT::Compute(OpKernelContext* ctx) const {
   const auto element_size = data_type->Size();
   if (element_size == sizeof(float)) {
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, float>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, float>(ctx, plan_cache_, is_onesided_, false)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, std::complex<float>>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<float, std::complex<float>>(ctx, plan_cache_, is_onesided_, false)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimenstion must be the batch dimension and its second "
@@ -588,9 +619,10 @@ Status STFT::Compute(OpKernelContext* ctx) const {
     }
   } else if (element_size == sizeof(double)) {
     if (is_real_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, double>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, double>(ctx, plan_cache_, is_onesided_, false)));
     } else if (is_complex_valued) {
-      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, std::complex<double>>(ctx, is_onesided_, false)));
+      ORT_RETURN_IF_ERROR((short_time_fourier_transform<double, std::complex<double>>(
+          ctx, plan_cache_, is_onesided_, false)));
     } else {
       ORT_THROW(
           "Unsupported input signal shape. The signal's first dimenstion must be the batch dimension and its second "
@@ -1,11 +1,34 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <map>
+#include <memory>
+#include <tuple>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
+template <typename T>
+struct FFTPlan;
+
+// Caches the FFT plans of a kernel: the twiddle factors and the bit reversal permutation of the lengths seen, and
+// the chirp of Bluestein's algorithm, so that they are computed once instead of on each run. The plans are read
+// only once created, and shared by the threads computing the transforms.
+class FFTPlanCache {
+ public:
+  template <typename T>
+  std::shared_ptr<const FFTPlan<T>> Get(size_t length, bool inverse, bool real_input) const;
+
+ private:
+  // key: element size, length, inverse, real input
+  using Key = std::tuple<size_t, size_t, bool, bool>;
+  mutable OrtMutex mutex_;
+  mutable std::map<Key, std::shared_ptr<const void>> plans_;
+};
+
 class DFT final : public OpKernel {
   int opset_;
   bool is_onesided_ = true;
@@ -23,6 +46,9 @@ class DFT final : public OpKernel {
     is_inverse_ = info.GetAttrOrDefault<int64_t>("inverse", 0);
   }
   Status Compute(OpKernelContext* ctx) const override;
+
+ private:
+  FFTPlanCache plan_cache_;
 };
 
 class STFT final : public OpKernel {
@@ -33,6 +59,9 @@ class STFT final : public OpKernel {
     is_onesided_ = static_cast<bool>(info.GetAttrOrDefault<int64_t>("onesided", 1));
   }
   Status Compute(OpKernelContext* ctx) const override;
+
+ private:
+  FFTPlanCache plan_cache_;
 };
 
 }  // namespace onnxruntime
@@ -1,8 +1,12 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
+#include <cstring>
+#include <functional>
 #include <string>
 #include <type_traits>
 
@@ -15,6 +19,8 @@
 #include "core/framework/data_types.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/op_kernel_type_control_utils.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/tensor/utils.h"
 #include "core/providers/op_kernel_type_control.h"
 #include "core/util/math_cpuonly.h"
@@ -45,6 +51,15 @@ ORT_SPECIFY_OP_KERNEL_ARG_DEFAULT_TYPE_LIST_ALL_OPSETS(
 ORT_SPECIFY_OP_KERNEL_ARG_REQUIRED_TYPES_ALL_OPSETS(
     kCpuExecutionProvider, kOnnxDomain, Cast, Output, 0,
     bool, int32_t, int64_t);
+
+// Opset 21 added support for int4 and uint4.
+ORT_SPECIFY_OP_KERNEL_ARG_DEFAULT_TYPE_LIST(
+    kCpuExecutionProvider, kOnnxDomain, Cast, 21, Input, 0,
+    element_type_lists::AllIRv10);
+
+ORT_SPECIFY_OP_KERNEL_ARG_DEFAULT_TYPE_LIST(
+    kCpuExecutionProvider, kOnnxDomain, Cast, 21, Output, 0,
+    element_type_lists::AllIRv10);
 }  // namespace op_kernel_type_control
 
 namespace {
@@ -52,6 +67,17 @@ using EnabledSrcTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(kCpuExecu
                                                                        Cast, Input, 0);
 using EnabledDstTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(kCpuExecutionProvider, kOnnxDomain,
                                                                        Cast, Output, 0);
+using EnabledSrcTypesOpset21 = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST(kCpuExecutionProvider, kOnnxDomain,
+                                                                   Cast, 21, Input, 0);
+using EnabledDstTypesOpset21 = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST(kCpuExecutionProvider, kOnnxDomain,
+                                                                   Cast, 21, Output, 0);
+
+// the kernel is shared by all opsets, so it handles the types of any of them
+using DispatchedSrcTypes = utils::TypeSetUnion<EnabledSrcTypes, EnabledSrcTypesOpset21>;
+using DispatchedDstTypes = utils::TypeSetUnion<EnabledDstTypes, EnabledDstTypesOpset21>;
+
+template <typename T>
+using IsInt4Type = boost::mp11::mp_contains<TypeList<Int4x2, UInt4x2>, T>;
 
 template <typename T>
 using IsOrtFloat16Type = boost::mp11::mp_contains<TypeList<BFloat16, MLFloat16>, T>;
@@ -161,6 +187,20 @@ CastFromString(const std::string& input, DstType& output) {
   output = DstType(intermediate);
 }
 
+// Elements are cast independently, so they are split across the intra-op threads.
+template <typename SrcType, typename DstType>
+void ParallelCast(const OpKernelContext& context, const TensorShape& shape,
+                  const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& cast_range,
+                  double cycles_per_element = 1.0) {
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), narrow<std::ptrdiff_t>(shape.Size()),
+      TensorOpCost{static_cast<double>(sizeof(SrcType)), static_cast<double>(sizeof(DstType)), cycles_per_element},
+      cast_range);
+}
+
+// formatting and parsing strings is much slower than a numeric conversion
+constexpr double kStringCastCycles = 64.0;
+
 // type that is usable with Eigen cast
 template <typename T>
 struct EigenCastType {
@@ -181,42 +221,51 @@ struct EigenCastType<BFloat16> {
 // generic tensor X -> Y
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCaster {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     using SrcEigenCastType = typename EigenCastType<SrcType>::type;
     using DstEigenCastType = typename EigenCastType<DstType>::type;
 
-    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
-    const auto in_vector =
-        ConstEigenVectorMap<SrcEigenCastType>(reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>()), shape_size);
-    auto out_vector =
-        EigenVectorMap<DstEigenCastType>(reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>()), shape_size);
-    out_vector = in_vector.template cast<DstEigenCastType>();
+    const auto* in_data = reinterpret_cast<const SrcEigenCastType*>(in.Data<SrcType>());
+    auto* out_data = reinterpret_cast<DstEigenCastType*>(out.MutableData<DstType>());
+    ParallelCast<SrcType, DstType>(context, shape, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+      const auto in_vector = ConstEigenVectorMap<SrcEigenCastType>(in_data + first, last - first);
+      auto out_vector = EigenVectorMap<DstEigenCastType>(out_data + first, last - first);
+      out_vector = in_vector.template cast<DstEigenCastType>();
+    });
   }
 };
 
 // tensor X -> string
 template <typename SrcType>
 struct TensorCaster<SrcType, std::string> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
-    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     const auto* in_data = in.Data<SrcType>();
     auto* out_data = out.MutableData<std::string>();
-    for (std::ptrdiff_t i = 0; i < shape_size; ++i) {
-      CastToString(in_data[i], out_data[i]);
-    }
+    ParallelCast<SrcType, std::string>(
+        context, shape,
+        [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            CastToString(in_data[i], out_data[i]);
+          }
+        },
+        kStringCastCycles);
   }
 };
 
 // tensor string -> X
 template <typename DstType>
 struct TensorCaster<std::string, DstType> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
-    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     const auto* in_data = in.Data<std::string>();
     auto* out_data = out.MutableData<DstType>();
-    for (std::ptrdiff_t i = 0; i < shape_size; ++i) {
-      CastFromString(in_data[i], out_data[i]);
-    }
+    ParallelCast<std::string, DstType>(
+        context, shape,
+        [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            CastFromString(in_data[i], out_data[i]);
+          }
+        },
+        kStringCastCycles);
   }
 };
 
@@ -225,28 +274,33 @@ struct TensorCaster<std::string, DstType> {
 // tensor X -> float 8
 template <typename SrcType, typename DstType, typename Enable = void>
 struct TensorCasterNoSat {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
-    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     const auto* in_data = in.Data<SrcType>();
     auto* out_data = out.MutableData<DstType>();
-    for (std::ptrdiff_t i = 0; i < shape_size; ++i) {
-      out_data[i] = DstType(static_cast<float>(in_data[i]), false);
-    }
+    ParallelCast<SrcType, DstType>(context, shape, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) {
+        out_data[i] = DstType(static_cast<float>(in_data[i]), false);
+      }
+    });
   }
 };
 
 // tensor string -> float 8
 template <typename DstType>
 struct TensorCasterNoSat<std::string, DstType> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
-    const std::ptrdiff_t shape_size = narrow<std::ptrdiff_t>(shape.Size());
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     const auto* in_data = in.Data<std::string>();
     auto* out_data = out.MutableData<DstType>();
-    float float_value;
-    for (std::ptrdiff_t i = 0; i < shape_size; ++i) {
-      CastFromString(in_data[i], float_value);
-      out_data[i] = DstType(float_value, false);
-    }
+    ParallelCast<std::string, DstType>(
+        context, shape,
+        [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+          float float_value;
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            CastFromString(in_data[i], float_value);
+            out_data[i] = DstType(float_value, false);
+          }
+        },
+        kStringCastCycles);
   }
 };
 
@@ -259,11 +313,12 @@ struct TensorCasterNoSat<std::string, DstType> {
 // tensor MLFloat16 -> float
 template <>
 struct TensorCaster<MLFloat16, float> {
-  void Cast(const OpKernelContext&, const TensorShape& shape, const Tensor& in, Tensor& out) const {
+  void Cast(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) const {
     auto out_data = out.MutableData<float>();
     auto in_data = in.Data<MLFloat16>();
-    const size_t shape_size = narrow<size_t>(shape.Size());
-    MlasConvertHalfToFloatBuffer(&in_data[0].val, out_data, shape_size);
+    ParallelCast<MLFloat16, float>(context, shape, [in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+      MlasConvertHalfToFloatBuffer(&in_data[first].val, out_data + first, narrow<size_t>(last - first));
+    });
   }
 };
 
@@ -301,6 +356,91 @@ struct TensorCaster<MLFloat16, std::string> {
 };
 #endif
 
+// unpacks the int4 elements of `in` to one per byte
+template <typename SrcType>
+void UnpackInt4(const OpKernelContext& context, const TensorShape& shape, const Tensor& in,
+                typename SrcType::UnpackedType* out_data) {
+  const std::ptrdiff_t num_elements = narrow<std::ptrdiff_t>(shape.Size());
+  const auto* in_data = in.Data<SrcType>();
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), narrow<std::ptrdiff_t>(SrcType::CalcNumInt4Pairs(narrow<size_t>(num_elements))),
+      TensorOpCost{1.0, 2.0, 2.0},
+      [num_elements, in_data, out_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          out_data[2 * i] = in_data[i].GetElem(0);
+          if (2 * i + 1 < num_elements) {
+            out_data[2 * i + 1] = in_data[i].GetElem(1);
+          }
+        }
+      });
+}
+
+// tensor X -> int4. Like the ONNX reference, values are clamped to the int4 range and rounded half to even.
+// They go through float, which is exact for everything inside that range.
+template <typename SrcType, typename DstType>
+void CastToInt4(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) {
+  using UnpackedType = typename DstType::UnpackedType;
+
+  Tensor intermediate_tensor;
+  const float* in_data;
+  if constexpr (std::is_same_v<SrcType, float>) {
+    in_data = in.Data<float>();
+  } else {
+    AllocatorPtr allocator;
+    ORT_THROW_IF_ERROR(context.GetTempSpaceAllocator(&allocator));
+    intermediate_tensor = Tensor{DataTypeImpl::GetType<float>(), shape, allocator};
+    TensorCaster<SrcType, float>{}.Cast(context, shape, in, intermediate_tensor);
+    in_data = intermediate_tensor.Data<float>();
+  }
+
+  const auto to_int4 = [](float value) -> UnpackedType {
+    if (std::isnan(value)) {
+      return 0;
+    }
+    return static_cast<UnpackedType>(std::nearbyint(
+        std::clamp(value, static_cast<float>(DstType::min_val), static_cast<float>(DstType::max_val))));
+  };
+
+  const std::ptrdiff_t num_elements = narrow<std::ptrdiff_t>(shape.Size());
+  auto* out_data = out.MutableData<DstType>();
+  concurrency::ThreadPool::TryParallelFor(
+      context.GetOperatorThreadPool(), narrow<std::ptrdiff_t>(DstType::CalcNumInt4Pairs(narrow<size_t>(num_elements))),
+      TensorOpCost{2.0 * sizeof(float), 1.0, 8.0},
+      [num_elements, in_data, out_data, &to_int4](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const UnpackedType high = 2 * i + 1 < num_elements ? to_int4(in_data[2 * i + 1]) : UnpackedType{0};
+          out_data[i] = DstType(to_int4(in_data[2 * i]), high);
+        }
+      });
+}
+
+// tensor int4 -> X, by casting the unpacked 8-bit values with `Caster`
+template <template <typename, typename, typename> class Caster, typename SrcType, typename DstType>
+void CastFromInt4(const OpKernelContext& context, const TensorShape& shape, const Tensor& in, Tensor& out) {
+  using UnpackedType = typename SrcType::UnpackedType;
+
+  // unpacking in place would overwrite pairs that are still to be read
+  if constexpr (std::is_same_v<DstType, UnpackedType>) {
+    if (out.DataRaw() != in.DataRaw()) {
+      UnpackInt4<SrcType>(context, shape, in, out.MutableData<UnpackedType>());
+      return;
+    }
+  }
+
+  AllocatorPtr allocator;
+  ORT_THROW_IF_ERROR(context.GetTempSpaceAllocator(&allocator));
+  Tensor unpacked_tensor{DataTypeImpl::GetType<UnpackedType>(), shape, allocator};
+  UnpackInt4<SrcType>(context, shape, in, unpacked_tensor.MutableData<UnpackedType>());
+
+  if constexpr (IsInt4Type<DstType>::value) {
+    CastToInt4<UnpackedType, DstType>(context, shape, unpacked_tensor, out);
+  } else if constexpr (std::is_same_v<DstType, UnpackedType>) {
+    memcpy(out.MutableDataRaw(), unpacked_tensor.DataRaw(), unpacked_tensor.SizeInBytes());
+  } else {
+    Caster<UnpackedType, DstType, void>{}.Cast(context, shape, unpacked_tensor, out);
+  }
+}
+
 class Cast final : public OpKernel {
  public:
   Cast(const OpKernelInfo& info) : OpKernel(info) {
@@ -335,7 +475,13 @@ class Cast final : public OpKernel {
 template <typename TSrc, typename TDst>
 struct Dispatcher {
   void operator()(const OpKernelContext& context, const TensorShape& shape, const Tensor& src, Tensor& dst) {
-    TensorCaster<TSrc, TDst>{}.Cast(context, shape, src, dst);
+    if constexpr (IsInt4Type<TSrc>::value) {
+      CastFromInt4<TensorCaster, TSrc, TDst>(context, shape, src, dst);
+    } else if constexpr (IsInt4Type<TDst>::value) {
+      CastToInt4<TSrc, TDst>(context, shape, src, dst);
+    } else {
+      TensorCaster<TSrc, TDst>{}.Cast(context, shape, src, dst);
+    }
   }
 };
 
@@ -344,7 +490,11 @@ struct Dispatcher {
 template <typename TSrc, typename TDst>
 struct DispatcherNoSat {
   void operator()(const OpKernelContext& context, const TensorShape& shape, const Tensor& src, Tensor& dst) {
-    TensorCasterNoSat<TSrc, TDst>{}.Cast(context, shape, src, dst);
+    if constexpr (IsInt4Type<TSrc>::value) {
+      CastFromInt4<TensorCasterNoSat, TSrc, TDst>(context, shape, src, dst);
+    } else {
+      TensorCasterNoSat<TSrc, TDst>{}.Cast(context, shape, src, dst);
+    }
   }
 };
 
@@ -355,7 +505,7 @@ struct SrcDispatcher {
   void operator()(
       int32_t to, const OpKernelContext& context, const TensorShape& shape, const Tensor& src, Tensor& dst) {
     using EnabledDstTypesWithoutSrcType =
-        boost::mp11::mp_remove_if_q<EnabledDstTypes, boost::mp11::mp_bind_front<std::is_same, TSrc>>;
+        boost::mp11::mp_remove_if_q<DispatchedDstTypes, boost::mp11::mp_bind_front<std::is_same, TSrc>>;
     utils::MLTypeCallDispatcherFromTypeList<EnabledDstTypesWithoutSrcType> dispatcher{to};
     dispatcher.template InvokeWithLeadingTemplateArgs<Dispatcher, TypeList<TSrc>>(context, shape, src, dst);
   }
@@ -368,7 +518,7 @@ struct SrcDispatcherNoSat {
   void operator()(
       int32_t to, const OpKernelContext& context, const TensorShape& shape, const Tensor& src, Tensor& dst) {
     using EnabledDstTypeOnlyFloat8 = boost::mp11::mp_set_intersection<
-        EnabledDstTypes, element_type_lists::AllFloat8>;
+        DispatchedDstTypes, element_type_lists::AllFloat8>;
     using EnabledDstTypesWithoutSrcType =
         boost::mp11::mp_remove_if_q<EnabledDstTypeOnlyFloat8, boost::mp11::mp_bind_front<std::is_same, TSrc>>;
     utils::MLTypeCallDispatcherFromTypeList<EnabledDstTypesWithoutSrcType> dispatcher{to};
@@ -398,14 +548,14 @@ Status Cast::Compute(OpKernelContext* context) const {
 #if !defined(DISABLE_FLOAT8_TYPES)
   if (saturate_) {
 #endif
-    utils::MLTypeCallDispatcherFromTypeList<EnabledSrcTypes> dispatcher{from};
+    utils::MLTypeCallDispatcherFromTypeList<DispatchedSrcTypes> dispatcher{from};
     dispatcher.Invoke<SrcDispatcher>(to_, *context, shape, *X, *Y);
 #if !defined(DISABLE_FLOAT8_TYPES)
   } else if (to_ == ONNX_NAMESPACE::TensorProto::FLOAT8E4M3FN ||
              to_ == ONNX_NAMESPACE::TensorProto::FLOAT8E4M3FNUZ ||
              to_ == ONNX_NAMESPACE::TensorProto::FLOAT8E5M2 ||
              to_ == ONNX_NAMESPACE::TensorProto::FLOAT8E5M2FNUZ) {
-    utils::MLTypeCallDispatcherFromTypeList<EnabledSrcTypes> dispatcher{from};
+    utils::MLTypeCallDispatcherFromTypeList<DispatchedSrcTypes> dispatcher{from};
     dispatcher.Invoke<SrcDispatcherNoSat>(to_, *context, shape, *X, *Y);
   }
 #endif
@@ -444,13 +594,12 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
         .MayInplace(0, 0),  // allocation planner will check input and output sizes match before inplacing
     Cast);
 
-// TODO(adrianlizarraga): Implement support for int4 and uint4.
 ONNX_CPU_OPERATOR_KERNEL(
     Cast,
     21,
     KernelDefBuilder()
-        .TypeConstraint("T1", BuildKernelDefConstraintsFromTypeList<EnabledSrcTypes>())
-        .TypeConstraint("T2", BuildKernelDefConstraintsFromTypeList<EnabledDstTypes>())
+        .TypeConstraint("T1", BuildKernelDefConstraintsFromTypeList<EnabledSrcTypesOpset21>())
+        .TypeConstraint("T2", BuildKernelDefConstraintsFromTypeList<EnabledDstTypesOpset21>())
         .MayInplace(0, 0),  // allocation planner will check input and output sizes match before inplacing
     Cast);
 
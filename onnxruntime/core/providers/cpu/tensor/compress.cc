@@ -3,6 +3,9 @@
 
 #include "core/providers/cpu/tensor/compress.h"
 #include "core/providers/common.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
 using namespace ::onnxruntime::common;
 
 namespace onnxruntime {
@@ -25,6 +28,11 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()),
     Compress);
 
+namespace {
+// The minimum number of entries of each block of the condition that is processed on a separate thread.
+constexpr int64_t kMinCompressBlockSize = 16 * 1024;
+}  // namespace
+
 Status Compress::Compute(OpKernelContext* ctx) const {
   const auto* input_tensor = ctx->Input<Tensor>(0);
   size_t rank = input_tensor->Shape().NumDimensions();
@@ -38,17 +46,12 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto condition_length = condition->Shape().Size();
   auto condition_data = condition->Data<bool>();
 
-  int64_t positive_condition_count = 0;
   // if has axis, we need to compress on dimension[axis], otherwise compress on the flattened input data
   int64_t compress_input_length = has_axis_ ? input_dimensions[onnxruntime::narrow<size_t>(axis)] : input_tensor->Shape().Size();
   int64_t valid_condition_length = compress_input_length < condition_length ? compress_input_length : condition_length;
 
   // Figure out output shape
-  for (int i = 0; i < valid_condition_length; ++i) {
-    if (condition_data[i]) {
-      ++positive_condition_count;
-    }
-  }
+  const int64_t positive_condition_count = std::count(condition_data, condition_data + valid_condition_length, true);
 
   std::vector<int64_t> output_dims(input_dimensions.begin(), input_dimensions.end());
   if (has_axis_) {
@@ -68,7 +71,18 @@ Status Compress::Compute(OpKernelContext* ctx) const {
   auto* output_data = static_cast<uint8_t*>(output_tensor->MutableDataRaw());
   auto element_bytes = input_tensor->DataType()->Size();
   bool is_string_type = input_tensor->IsDataTypeString();
-  int64_t output_index = 0;
+  concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
+
+  // copies the block_size elements at input_offset to output_offset
+  const auto copy_elements = [&](int64_t input_offset, int64_t output_offset, int64_t block_size) {
+    if (is_string_type) {
+      const auto* input_strings = reinterpret_cast<const std::string*>(input_data) + input_offset;
+      std::copy(input_strings, input_strings + block_size, reinterpret_cast<std::string*>(output_data) + output_offset);
+    } else {
+      memcpy(output_data + output_offset * element_bytes, input_data + input_offset * element_bytes,
+             SafeInt<size_t>(block_size) * element_bytes);
+    }
+  };
 
   if (has_axis_) {
     int64_t axes_left_stride = 1;
@@ -81,42 +95,65 @@ Status Compress::Compute(OpKernelContext* ctx) const {
       axes_right_stride *= input_dimensions[i];
     }
     int64_t axes_included_right_stride = axes_right_stride * input_dimensions[onnxruntime::narrow<size_t>(axis)];
-    int64_t axes_included_right_stride_bytes = axes_included_right_stride * element_bytes;
     ORT_ENFORCE(axes_right_stride >= 0 &&
                 static_cast<uint64_t>(axes_right_stride) < std::numeric_limits<size_t>::max());
     size_t axes_right_stride_bytes = 0;
     if (!IAllocator::CalcMemSizeForArray(static_cast<size_t>(axes_right_stride), element_bytes,
                                          &axes_right_stride_bytes))
       return Status(ONNXRUNTIME, FAIL, "size overflow");
-    for (int i = 0; i < axes_left_stride; ++i) {
-      for (int j = 0; j < valid_condition_length; ++j) {
-        if (!condition_data[j]) {
-          continue;
-        }
-        if (is_string_type) {
-          for (int idxItem = 0; idxItem < axes_right_stride; ++idxItem) {
-            reinterpret_cast<std::string*>(output_data)[output_index + idxItem] =
-                reinterpret_cast<const std::string*>(input_data)[i * axes_included_right_stride + j * axes_right_stride + idxItem];
-          }
-          output_index += axes_right_stride;
-        } else {
-          memcpy(output_data + output_index, input_data + i * axes_included_right_stride_bytes + j * axes_right_stride_bytes, axes_right_stride_bytes);
-          output_index += axes_right_stride_bytes;
-        }
+
+    // the entries of the axis that are kept
+    std::vector<int64_t> selected_indices;
+    selected_indices.reserve(onnxruntime::narrow<size_t>(positive_condition_count));
+    for (int64_t j = 0; j < valid_condition_length; ++j) {
+      if (condition_data[j]) {
+        selected_indices.push_back(j);
       }
     }
+
+    // every output slice k is the slice selected_indices[k % positive_condition_count] of the outer row
+    // k / positive_condition_count, so the slices are copied in parallel
+    const auto slice_bytes = static_cast<double>(axes_right_stride_bytes);
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(axes_left_stride * positive_condition_count),
+        TensorOpCost{slice_bytes, slice_bytes, static_cast<double>(axes_right_stride)},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t k = first; k < last; ++k) {
+            const int64_t input_offset = (k / positive_condition_count) * axes_included_right_stride +
+                                         selected_indices[k % positive_condition_count] * axes_right_stride;
+            copy_elements(input_offset, k * axes_right_stride, axes_right_stride);
+          }
+        });
   } else {
-    for (int i = 0; i < valid_condition_length; ++i) {
-      if (!condition_data[i]) {
-        continue;
-      }
-      if (is_string_type) {
-        reinterpret_cast<std::string*>(output_data)[output_index] = reinterpret_cast<const std::string*>(input_data)[i];
-      } else {
-        memcpy(output_data + output_index * element_bytes, input_data + i * element_bytes, element_bytes);
+    // The condition is processed in blocks in two passes: the entries kept in each block are counted in parallel,
+    // and after a scan of the counts every block copies its entries to its own range of the output in parallel.
+    const std::ptrdiff_t num_blocks = std::max<std::ptrdiff_t>(
+        1, std::min<std::ptrdiff_t>(concurrency::ThreadPool::DegreeOfParallelism(tp),
+                                    valid_condition_length / kMinCompressBlockSize));
+    const auto block_begin = [valid_condition_length, num_blocks](std::ptrdiff_t block) {
+      return block * valid_condition_length / num_blocks;
+    };
+
+    std::vector<int64_t> block_offsets(SafeInt<size_t>(num_blocks) + 1, 0);
+    if (num_blocks > 1) {
+      concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks - 1, [&](std::ptrdiff_t block) {
+        block_offsets[block + 1] = std::count(condition_data + block_begin(block),
+                                              condition_data + block_begin(block + 1), true);
+      });
+
+      for (std::ptrdiff_t block = 0; block < num_blocks; ++block) {
+        block_offsets[block + 1] += block_offsets[block];
       }
-      ++output_index;
     }
+
+    concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+      int64_t output_index = block_offsets[block];
+      for (int64_t i = block_begin(block), end = block_begin(block + 1); i < end; ++i) {
+        if (condition_data[i]) {
+          copy_elements(i, output_index++, 1);
+        }
+      }
+    });
   }
 
   return Status::OK();
@@ -4,22 +4,30 @@
 #include "expand.h"
 #include <cmath>
 #include <core/common/safeint.h>
+#include "core/common/type_list.h"
+#include "core/framework/copy.h"
 
 namespace onnxruntime {
 
-#define REG_EXPAND_KERNEL(TYPE)                                                    \
-  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                        \
-      Expand,                                                                      \
-      8,                                                                           \
-      12,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
-      Expand<TYPE>);                                                               \
-  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                  \
-      Expand,                                                                      \
-      13,                                                                          \
-      TYPE,                                                                        \
-      KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder().MayStridedInput(0).MayStridedOutput(0, 0)
+#else
+#define CREATE_EXPAND_KERNEL_DEF KernelDefBuilder()
+#endif
+
+#define REG_EXPAND_KERNEL(TYPE)                                                          \
+  ONNX_CPU_OPERATOR_VERSIONED_TYPED_KERNEL(                                              \
+      Expand,                                                                            \
+      8,                                                                                 \
+      12,                                                                                \
+      TYPE,                                                                              \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
+      Expand<TYPE>);                                                                     \
+  ONNX_CPU_OPERATOR_TYPED_KERNEL(                                                        \
+      Expand,                                                                            \
+      13,                                                                                \
+      TYPE,                                                                              \
+      CREATE_EXPAND_KERNEL_DEF.TypeConstraint("T", DataTypeImpl::GetTensorType<TYPE>()), \
       Expand<TYPE>);
 
 REG_EXPAND_KERNEL(float)
@@ -35,6 +43,36 @@ REG_EXPAND_KERNEL(uint64_t)
 REG_EXPAND_KERNEL(bool)
 REG_EXPAND_KERNEL(MLFloat16)
 
+#ifdef ENABLE_STRIDED_TENSORS
+namespace {
+// Strides of the output as a view of the input: zero along the dims the input is broadcast in.
+TensorShapeVector ComputeOutputStrides(const TensorShape& input_shape, gsl::span<const int64_t> input_strides,
+                                       const TensorShape& output_shape) {
+  const size_t rank = output_shape.NumDimensions();
+  const size_t input_rank = input_shape.NumDimensions();
+
+  if (input_rank == 0 || input_shape.Size() == 1) {
+    return TensorShapeVector(rank, 0);
+  }
+
+  TensorShapeVector output_strides(rank);
+  const size_t offset = rank - input_rank;
+  for (size_t dim = rank - 1;; --dim) {
+    int64_t stride = 0;
+    int64_t input_dim_size = dim >= offset ? input_shape[dim - offset] : 1;
+    if (input_dim_size == output_shape[dim]) {
+      stride = dim >= offset ? input_strides[dim - offset] : output_shape[dim + 1] * output_strides[dim + 1];
+    }
+
+    output_strides[dim] = stride;
+    if (dim == 0) break;
+  }
+
+  return output_strides;
+}
+}  // namespace
+#endif
+
 template <typename T>
 Status Expand<T>::Compute(OpKernelContext* context) const {
   const auto* input_tensor = context->Input<Tensor>(0);
@@ -69,6 +107,19 @@ Status Expand<T>::Compute(OpKernelContext* context) const {
 
   TensorShape output_tensor_shape(output_shape);
   auto* output_tensor = context->Output(0, output_tensor_shape);
+
+#ifdef ENABLE_STRIDED_TENSORS
+  // The output is a view of the input if the allocation planner made it share the input's buffer.
+  // A strided input is copied through the same strides.
+  if (output_tensor_shape.Size() > 0 &&
+      (output_tensor->DataRaw() == input_tensor->DataRaw() || !input_tensor->IsContiguous())) {
+    const auto output_strides =
+        ComputeOutputStrides(input_tensor->Shape(), input_tensor->Strides(), output_tensor_shape);
+    return CreateStridedView<TypeList<T>>(context->GetOperatorThreadPool(), *input_tensor, 0, output_strides,
+                                          *output_tensor);
+  }
+#endif
+
   auto* output_data = output_tensor->MutableData<T>();
   auto* output_dims = output_shape.data();
   auto output_dims_size = static_cast<int64_t>(output_shape.size());
@@ -3,12 +3,16 @@
 
 // https://github.com/onnx/onnx/blob/main/docs/Operators.md#Gather
 #include "core/providers/cpu/tensor/gather.h"
+
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/op_kernel_type_control.h"
+#include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
 
@@ -83,6 +87,14 @@ Status GatherBase::PrepareForCompute(OpKernelContext* context, Prepare& p) const
   return Status::OK();
 }
 
+// The number of rows ahead of the current one which are prefetched when gathering from a large input.
+constexpr ptrdiff_t kGatherPrefetchDistance = 4;
+// Inputs with batches smaller than this likely stay in the cache, and aren't prefetched.
+constexpr int64_t kGatherPrefetchMinBatchBytes = 1024 * 1024;
+// Only the start of long rows is prefetched, the hardware prefetcher follows the rest of the row once it is copied.
+constexpr int64_t kGatherPrefetchMaxBytesPerRow = 256;
+constexpr int64_t kGatherCacheLineBytes = 64;
+
 template <typename Tin>
 Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uint8_t* dst_base, bool is_string_type,
                       const size_t element_bytes, const int64_t block_size, const int64_t M,
@@ -102,30 +114,45 @@ Status GatherCopyData(const Tensor* indices_tensor, const uint8_t* src_base, uin
     }
   }
 
-  auto lambda = [&](int64_t index) {
-    int64_t batch = index / N;
-    int64_t i = index % N;
-
-    const int64_t src_offset_batch = batch * data_batch_bytes;
-    const int64_t dst_offset_batch = batch * gathered_batch_bytes;
-    Tin idx = indices_data[i];
+  const auto source_offset = [&](int64_t index) {
+    const int64_t batch = index / N;
+    Tin idx = indices_data[index % N];
     idx = idx < 0 ? idx + static_cast<Tin>(axis_dim_limit) : idx;
-    const int64_t src_offset = src_offset_batch + idx * block_size;
-    const int64_t dst_offset = dst_offset_batch + i * block_size;
+    return batch * data_batch_bytes + idx * block_size;
+  };
+
+  // rows gathered from a large table, e.g. embedding lookups, are far apart and usually not in the cache, so the
+  // rows a few iterations ahead are prefetched while the current one is copied
+  const bool prefetch = !is_string_type && data_batch_bytes >= kGatherPrefetchMinBatchBytes;
+  const int64_t prefetch_bytes = std::min(block_size, kGatherPrefetchMaxBytesPerRow);
+
+  auto lambda = [&](int64_t index) {
+    const int64_t src_offset = source_offset(index);
+    const int64_t dst_offset = (index / N) * gathered_batch_bytes + (index % N) * block_size;
 
     if (is_string_type) {
-      reinterpret_cast<std::string*>(dst_base)[dst_offset / element_bytes] =
-          reinterpret_cast<const std::string*>(src_base)[src_offset / element_bytes];
+      const auto* src = reinterpret_cast<const std::string*>(src_base) + src_offset / element_bytes;
+      std::copy(src, src + block_size / element_bytes,
+                reinterpret_cast<std::string*>(dst_base) + dst_offset / element_bytes);
     } else {
       memcpy(dst_base + dst_offset, src_base + src_offset, narrow<size_t>(block_size));
     }
   };
-  concurrency::ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(M) * N, static_cast<double>(block_size),
-                                          [&lambda](ptrdiff_t first, ptrdiff_t last) {
-                                            for (int index = static_cast<int>(first), end = static_cast<int>(last); index < end; ++index) {
-                                              lambda(index);
-                                            }
-                                          });
+  concurrency::ThreadPool::TryParallelFor(
+      tp, SafeInt<ptrdiff_t>(M) * N,
+      TensorOpCost{static_cast<double>(block_size), static_cast<double>(block_size), 1.0},
+      [&](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t index = first; index < last; ++index) {
+          if (prefetch && index + kGatherPrefetchDistance < last) {
+            const uint8_t* row = src_base + source_offset(index + kGatherPrefetchDistance);
+            for (int64_t offset = 0; offset < prefetch_bytes; offset += kGatherCacheLineBytes) {
+              PrefetchForRead(row + offset);
+            }
+          }
+
+          lambda(index);
+        }
+      });
 
   return Status::OK();
 }
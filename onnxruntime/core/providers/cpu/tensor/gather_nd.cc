@@ -3,6 +3,7 @@
 #include <core/common/safeint.h>
 #include "gather_nd.h"
 #include "core/platform/threadpool.h"
+#include "core/providers/cpu/tensor/utils.h"
 
 namespace onnxruntime {
 
@@ -106,7 +107,7 @@ Status GatherNDBase::PrepareForCompute(const TensorShape& input_shape, const Ten
   concurrency::ThreadPool::TryParallelFor(
       tp, onnxruntime::narrow<size_t>(num_slices), static_cast<double>(num_slice_dims),
       [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
+        for (ptrdiff_t slice_idx = first; slice_idx < last; ++slice_idx) {
           lambda(slice_idx);
         }
       });
@@ -176,15 +177,26 @@ Status GatherND::Compute(OpKernelContext* context) const {
   return nullptr == p.input_str_base ? GatherNumber(p, tp) : GatherString(p, tp);
 }
 
+// The number of slices ahead of the current one which are prefetched.
+constexpr ptrdiff_t kGatherNDPrefetchDistance = 4;
+
 Status GatherND::GatherNumber(const Prepare& p, concurrency::ThreadPool* tp) const {
   auto lambda = [&](int64_t slice_idx) {
     memcpy(p.output_base + slice_idx * p.bytes_per_slice, p.input_base + p.slice_offsets[onnxruntime::narrow<size_t>(slice_idx)] * p.element_bytes,
            onnxruntime::narrow<size_t>(p.bytes_per_slice));
   };
+  // the slices are usually scattered across the input, so the slice a few iterations ahead is prefetched while the
+  // current one is copied
   concurrency::ThreadPool::TryParallelFor(
-      tp, p.slice_offsets.size(), static_cast<double>(p.bytes_per_slice),
-      [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
+      tp, p.slice_offsets.size(),
+      TensorOpCost{static_cast<double>(p.bytes_per_slice), static_cast<double>(p.bytes_per_slice), 1.0},
+      [&lambda, &p](ptrdiff_t first, ptrdiff_t last) {
+        for (ptrdiff_t slice_idx = first; slice_idx < last; ++slice_idx) {
+          if (slice_idx + kGatherNDPrefetchDistance < last) {
+            const auto next_offset = p.slice_offsets[onnxruntime::narrow<size_t>(slice_idx + kGatherNDPrefetchDistance)];
+            PrefetchForRead(p.input_base + next_offset * p.element_bytes);
+          }
+
           lambda(slice_idx);
         }
       });
@@ -201,7 +213,7 @@ Status GatherND::GatherString(const Prepare& p, concurrency::ThreadPool* tp) con
   concurrency::ThreadPool::TryParallelFor(
       tp, p.slice_offsets.size(), static_cast<double>(p.element_count_per_slice),
       [&lambda](ptrdiff_t first, ptrdiff_t last) {
-        for (int slice_idx = static_cast<int>(first), end = static_cast<int>(last); slice_idx < end; ++slice_idx) {
+        for (ptrdiff_t slice_idx = first; slice_idx < last; ++slice_idx) {
           lambda(slice_idx);
         }
       });
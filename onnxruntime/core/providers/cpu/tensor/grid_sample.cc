@@ -3,6 +3,8 @@
 
 #include "core/providers/cpu/tensor/grid_sample.h"
 
+#include <vector>
+
 #include "core/framework/element_type_lists.h"
 #include "core/framework/TensorSeq.h"
 #include "core/providers/common.h"
@@ -102,23 +104,28 @@ T GsBicubicInterpolate(T p[4][4], T x, T y) {
   return static_cast<T>(coeffs[0] * v[0] + coeffs[1] * v[1] + coeffs[2] * v[2] + coeffs[3] * v[3]);
 }
 
+// The index of the pixel at row r and column c of an H x W image after padding, or -1 if the pixel is zero padding.
 template <typename T>
-T GridSample<T>::PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const {
-  T pixel = {};  // default 0
+int64_t GridSample<T>::IndexAtGrid(int64_t r, int64_t c, int64_t H, int64_t W, const T border[/* 4 */]) const {
   if (padding_mode_ == Zeros) {
     if (c >= 0 && c < W && r >= 0 && r < H) {
-      pixel = image[r * W + c];
+      return r * W + c;
     }
+    return -1;
   } else if (padding_mode_ == Border) {
     c = std::clamp<int64_t>(c, 0, W - 1);
     r = std::clamp<int64_t>(r, 0, H - 1);
-    pixel = image[r * W + c];
   } else {  // (padding_mode_ == Reflection)
     c = static_cast<int64_t>(GsReflect(static_cast<T>(c), border[0], border[2]));
     r = static_cast<int64_t>(GsReflect(static_cast<T>(r), border[1], border[3]));
-    pixel = image[r * W + c];
   }
-  return pixel;
+  return r * W + c;
+}
+
+template <typename T>
+T GridSample<T>::PixelAtGrid(const T* image, int64_t r, int64_t c, int64_t H, int64_t W, T border[/* 4 */]) const {
+  const int64_t index = IndexAtGrid(r, c, H, W, border);
+  return index >= 0 ? image[index] : T{};  // default 0
 }
 
 template <typename T>
@@ -203,46 +210,42 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
     }
     T border[] = {x_min, y_min, x_max, y_max};  // l-t-r-b
 
-    concurrency::ThreadPool* tp = H_out * W_out > 64 ? context->GetOperatorThreadPool() : nullptr;
-    for (int64_t n = 0; n < N; n++) {
-      const T* grid_data = grid->Data<T>() + n * (H_out * W_out) * 2;
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          tp, onnxruntime::narrow<std::ptrdiff_t>(C),
-          [&](std::ptrdiff_t c) {
-            const T* X_data = input->Data<T>() + (n * C + c) * (H_in * W_in);
-            T* Y_data = Y.MutableData<T>() + (n * C + c) * (H_out * W_out);
-
-            for (int64_t oy = 0; oy < H_out; oy++) {
-              for (int64_t ox = 0; ox < W_out; ox++) {
-                const T* gridpoint = grid_data + (oy * W_out + ox) * 2;
-                T* Y_gridpoint = Y_data + oy * W_out + ox;
-                auto nx = gridpoint[0];  // normalized location
-                auto ny = gridpoint[1];
-                auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
-                auto y = GsDenormalize<T>(ny, H_in, align_corners_);
-
-                if (mode_ == Nearest) {
-                  x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
-                  y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
-                  // x, y are integers in all padding modes
-                  *Y_gridpoint = PixelAtGrid(X_data, static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
-                } else if (mode_ == Linear) {
-                  int64_t x1 = static_cast<int64_t>(std::floor(x));
-                  int64_t y1 = static_cast<int64_t>(std::floor(y));
-                  int64_t x2 = x1 + 1;
-                  int64_t y2 = y1 + 1;
-
-                  T p11 = PixelAtGrid(X_data, y1, x1, H_in, W_in, border);
-                  T p12 = PixelAtGrid(X_data, y1, x2, H_in, W_in, border);
-                  T p21 = PixelAtGrid(X_data, y2, x1, H_in, W_in, border);
-                  T p22 = PixelAtGrid(X_data, y2, x2, H_in, W_in, border);
-
-                  T dx2 = static_cast<T>(x2) - x;
-                  T dx1 = x - static_cast<T>(x1);
-                  T dy2 = static_cast<T>(y2) - y;
-                  T dy1 = y - static_cast<T>(y1);
-                  *Y_gridpoint = dy2 * (dx2 * p11 + dx1 * p12) + dy1 * (dx2 * p21 + dx1 * p22);
-                } else if (mode_ == Cubic) {
+    // The output rows of all the images are sampled in parallel. Each row is sampled for all the channels, so that
+    // the locations and weights of its samples, which only depend on the grid, are computed once for the channels
+    // and the inner loops over the channels are plain weighted gathers.
+    const int64_t num_taps = mode_ == Linear ? 4 : 1;
+    const T* X_images = input->Data<T>();
+    const T* grid_images = grid->Data<T>();
+    T* Y_images = Y.MutableData<T>();
+    const double row_samples = static_cast<double>(C * W_out);
+    const double taps_per_sample = mode_ == Cubic ? 16.0 : static_cast<double>(num_taps);
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), onnxruntime::narrow<std::ptrdiff_t>(N * H_out),
+        TensorOpCost{row_samples * taps_per_sample * sizeof(T), row_samples * sizeof(T),
+                     row_samples * taps_per_sample * 2 + static_cast<double>(W_out) * 20},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          std::vector<int64_t> tap_indices;
+          std::vector<T> tap_weights;
+          if (mode_ != Cubic) {
+            tap_indices.resize(onnxruntime::narrow<size_t>(W_out * num_taps));
+            tap_weights.resize(onnxruntime::narrow<size_t>(W_out * num_taps));
+          }
+
+          for (std::ptrdiff_t row = first; row < last; row++) {
+            const int64_t n = row / H_out;
+            const int64_t oy = row % H_out;
+            const T* grid_data = grid_images + (n * H_out + oy) * W_out * 2;
+            const T* X_image = X_images + n * C * (H_in * W_in);
+            T* Y_row = Y_images + n * C * (H_out * W_out) + oy * W_out;
+
+            if (mode_ == Cubic) {
+              for (int64_t c = 0; c < C; c++) {
+                const T* X_data = X_image + c * (H_in * W_in);
+                T* Y_data = Y_row + c * (H_out * W_out);
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  const T* gridpoint = grid_data + ox * 2;
+                  auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+                  auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
                   int64_t x0 = static_cast<int64_t>(std::floor(x)) - 1;  // top-left corner of the bbox
                   int64_t y0 = static_cast<int64_t>(std::floor(y)) - 1;
 
@@ -254,12 +257,68 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
                   }
                   T dx = static_cast<T>(x - x0 - 1);
                   T dy = static_cast<T>(y - y0 - 1);
-                  *Y_gridpoint = GsBicubicInterpolate(p, dx, dy);
+                  Y_data[ox] = GsBicubicInterpolate(p, dx, dy);
                 }
               }
+              continue;
             }
-          });
-    }
+
+            // the pixels sampled for every output pixel of the row, -1 for zero padding, and their weights
+            for (int64_t ox = 0; ox < W_out; ox++) {
+              const T* gridpoint = grid_data + ox * 2;
+              auto x = GsDenormalize<T>(gridpoint[0], W_in, align_corners_);  // actual location
+              auto y = GsDenormalize<T>(gridpoint[1], H_in, align_corners_);
+              int64_t* indices = tap_indices.data() + ox * num_taps;
+              T* weights = tap_weights.data() + ox * num_taps;
+
+              if (mode_ == Nearest) {
+                // x, y are integers in all padding modes
+                x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
+                y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
+                indices[0] = IndexAtGrid(static_cast<int64_t>(y), static_cast<int64_t>(x), H_in, W_in, border);
+                weights[0] = T{1};
+              } else {  // (mode_ == Linear)
+                int64_t x1 = static_cast<int64_t>(std::floor(x));
+                int64_t y1 = static_cast<int64_t>(std::floor(y));
+                int64_t x2 = x1 + 1;
+                int64_t y2 = y1 + 1;
+
+                T dx2 = static_cast<T>(x2) - x;
+                T dx1 = x - static_cast<T>(x1);
+                T dy2 = static_cast<T>(y2) - y;
+                T dy1 = y - static_cast<T>(y1);
+
+                indices[0] = IndexAtGrid(y1, x1, H_in, W_in, border);
+                indices[1] = IndexAtGrid(y1, x2, H_in, W_in, border);
+                indices[2] = IndexAtGrid(y2, x1, H_in, W_in, border);
+                indices[3] = IndexAtGrid(y2, x2, H_in, W_in, border);
+                weights[0] = dy2 * dx2;
+                weights[1] = dy2 * dx1;
+                weights[2] = dy1 * dx2;
+                weights[3] = dy1 * dx1;
+              }
+            }
+
+            for (int64_t c = 0; c < C; c++) {
+              const T* X_data = X_image + c * (H_in * W_in);
+              T* Y_data = Y_row + c * (H_out * W_out);
+              const auto pixel = [X_data](int64_t index) { return index >= 0 ? X_data[index] : T{}; };
+
+              if (mode_ == Nearest) {
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  Y_data[ox] = pixel(tap_indices[ox]);
+                }
+              } else {
+                for (int64_t ox = 0; ox < W_out; ox++) {
+                  const int64_t* indices = tap_indices.data() + ox * 4;
+                  const T* weights = tap_weights.data() + ox * 4;
+                  Y_data[ox] = weights[0] * pixel(indices[0]) + weights[1] * pixel(indices[1]) +
+                               weights[2] * pixel(indices[2]) + weights[3] * pixel(indices[3]);
+                }
+              }
+            }
+          }
+        });
   } else if (data_dims == 3) {
     // sample 3d;
     auto D_in = input_dims[2];
@@ -292,68 +351,70 @@ Status GridSample<T>::Compute(OpKernelContext* context) const {
     }
     T border[] = {x_min, y_min, z_min, x_max, y_max, z_max};
 
-    concurrency::ThreadPool* tp = D_out * H_out * W_out > 64 ? context->GetOperatorThreadPool() : nullptr;
-    for (int64_t n = 0; n < N; n++) {
-      const T* grid_data = grid->Data<T>() + n * (D_out * H_out * W_out) * 3;
-      concurrency::ThreadPool::TrySimpleParallelFor(
-          tp, onnxruntime::narrow<std::ptrdiff_t>(C),
-          [&](std::ptrdiff_t c) {
-            const T* X_data = input->Data<T>() + (n * C + c) * (D_in * H_in * W_in);
-            T* Y_data = Y.MutableData<T>() + (n * C + c) * (D_out * H_out * W_out);
-
-            for (int64_t oz = 0; oz < D_out; oz++) {
-              for (int64_t oy = 0; oy < H_out; oy++) {
-                for (int64_t ox = 0; ox < W_out; ox++) {
-                  const T* gridpoint = grid_data + (oz * H_out * W_out + oy * W_out + ox) * 3;
-                  T* Y_gridpoint = Y_data + oz * H_out * W_out + oy * W_out + ox;
-                  auto nx = gridpoint[0];  // normalized location
-                  auto ny = gridpoint[1];
-                  auto nz = gridpoint[2];
-                  auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
-                  auto y = GsDenormalize<T>(ny, H_in, align_corners_);
-                  auto z = GsDenormalize<T>(nz, D_in, align_corners_);
-
-                  if (mode_ == Nearest) {
-                    x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
-                    y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
-                    z = static_cast<T>(std::nearbyint(static_cast<T>(z)));
-
-                    // x, y are integers in all padding modes
-                    *Y_gridpoint = PixelAtGrid3D(X_data, static_cast<int64_t>(z), static_cast<int64_t>(y), static_cast<int64_t>(x),
-                                                 D_in, H_in, W_in, border);
-                  } else if (mode_ == Linear) {
-                    int64_t x1 = static_cast<int64_t>(std::floor(x));
-                    int64_t y1 = static_cast<int64_t>(std::floor(y));
-                    int64_t z1 = static_cast<int64_t>(std::floor(z));
-                    int64_t x2 = x1 + 1;
-                    int64_t y2 = y1 + 1;
-                    int64_t z2 = z1 + 1;
-
-                    T dx2 = static_cast<T>(x2) - x;
-                    T dx1 = x - static_cast<T>(x1);
-                    T dy2 = static_cast<T>(y2) - y;
-                    T dy1 = y - static_cast<T>(y1);
-                    T dz2 = static_cast<T>(z2) - z;
-                    T dz1 = z - static_cast<T>(z1);
-
-                    T p111 = PixelAtGrid3D(X_data, z1, y1, x1, D_in, H_in, W_in, border);
-                    T p112 = PixelAtGrid3D(X_data, z1, y1, x2, D_in, H_in, W_in, border);
-                    T p121 = PixelAtGrid3D(X_data, z1, y2, x1, D_in, H_in, W_in, border);
-                    T p122 = PixelAtGrid3D(X_data, z1, y2, x2, D_in, H_in, W_in, border);
-                    T Y_gridpoint_z1 = dy2 * (dx2 * p111 + dx1 * p112) + dy1 * (dx2 * p121 + dx1 * p122);
-
-                    T p211 = PixelAtGrid3D(X_data, z2, y1, x1, D_in, H_in, W_in, border);
-                    T p212 = PixelAtGrid3D(X_data, z2, y1, x2, D_in, H_in, W_in, border);
-                    T p221 = PixelAtGrid3D(X_data, z2, y2, x1, D_in, H_in, W_in, border);
-                    T p222 = PixelAtGrid3D(X_data, z2, y2, x2, D_in, H_in, W_in, border);
-                    T Y_gridpoint_z2 = dy2 * (dx2 * p211 + dx1 * p212) + dy1 * (dx2 * p221 + dx1 * p222);
-                    *Y_gridpoint = dz2 * Y_gridpoint_z1 + dz1 * Y_gridpoint_z2;
-                  }
-                }
+    // The output rows of all the channel planes are sampled in parallel.
+    const double row_cost = static_cast<double>(W_out) * (mode_ == Linear ? 8 : 1);
+    concurrency::ThreadPool::TryParallelFor(
+        context->GetOperatorThreadPool(), onnxruntime::narrow<std::ptrdiff_t>(N * C * D_out * H_out),
+        TensorOpCost{row_cost * sizeof(T), static_cast<double>(W_out * sizeof(T)), row_cost * 3 + W_out * 30},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t row = first; row < last; row++) {
+            const int64_t oy = row % H_out;
+            const int64_t oz = (row / H_out) % D_out;
+            const int64_t plane = row / (H_out * D_out);  // n * C + c
+            const int64_t n = plane / C;
+            const T* grid_data = grid->Data<T>() + n * (D_out * H_out * W_out) * 3;
+            const T* X_data = input->Data<T>() + plane * (D_in * H_in * W_in);
+            T* Y_data = Y.MutableData<T>() + plane * (D_out * H_out * W_out);
+
+            for (int64_t ox = 0; ox < W_out; ox++) {
+              const T* gridpoint = grid_data + (oz * H_out * W_out + oy * W_out + ox) * 3;
+              T* Y_gridpoint = Y_data + oz * H_out * W_out + oy * W_out + ox;
+              auto nx = gridpoint[0];  // normalized location
+              auto ny = gridpoint[1];
+              auto nz = gridpoint[2];
+              auto x = GsDenormalize<T>(nx, W_in, align_corners_);  // actual location
+              auto y = GsDenormalize<T>(ny, H_in, align_corners_);
+              auto z = GsDenormalize<T>(nz, D_in, align_corners_);
+
+              if (mode_ == Nearest) {
+                x = static_cast<T>(std::nearbyint(static_cast<T>(x)));
+                y = static_cast<T>(std::nearbyint(static_cast<T>(y)));
+                z = static_cast<T>(std::nearbyint(static_cast<T>(z)));
+
+                // x, y are integers in all padding modes
+                *Y_gridpoint = PixelAtGrid3D(X_data, static_cast<int64_t>(z), static_cast<int64_t>(y), static_cast<int64_t>(x),
+                                             D_in, H_in, W_in, border);
+              } else if (mode_ == Linear) {
+                int64_t x1 = static_cast<int64_t>(std::floor(x));
+                int64_t y1 = static_cast<int64_t>(std::floor(y));
+                int64_t z1 = static_cast<int64_t>(std::floor(z));
+                int64_t x2 = x1 + 1;
+                int64_t y2 = y1 + 1;
+                int64_t z2 = z1 + 1;
+
+                T dx2 = static_cast<T>(x2) - x;
+                T dx1 = x - static_cast<T>(x1);
+                T dy2 = static_cast<T>(y2) - y;
+                T dy1 = y - static_cast<T>(y1);
+                T dz2 = static_cast<T>(z2) - z;
+                T dz1 = z - static_cast<T>(z1);
+
+                T p111 = PixelAtGrid3D(X_data, z1, y1, x1, D_in, H_in, W_in, border);
+                T p112 = PixelAtGrid3D(X_data, z1, y1, x2, D_in, H_in, W_in, border);
+                T p121 = PixelAtGrid3D(X_data, z1, y2, x1, D_in, H_in, W_in, border);
+                T p122 = PixelAtGrid3D(X_data, z1, y2, x2, D_in, H_in, W_in, border);
+                T Y_gridpoint_z1 = dy2 * (dx2 * p111 + dx1 * p112) + dy1 * (dx2 * p121 + dx1 * p122);
+
+                T p211 = PixelAtGrid3D(X_data, z2, y1, x1, D_in, H_in, W_in, border);
+                T p212 = PixelAtGrid3D(X_data, z2, y1, x2, D_in, H_in, W_in, border);
+                T p221 = PixelAtGrid3D(X_data, z2, y2, x1, D_in, H_in, W_in, border);
+                T p222 = PixelAtGrid3D(X_data, z2, y2, x2, D_in, H_in, W_in, border);
+                T Y_gridpoint_z2 = dy2 * (dx2 * p211 + dx1 * p212) + dy1 * (dx2 * p221 + dx1 * p222);
+                *Y_gridpoint = dz2 * Y_gridpoint_z1 + dz1 * Y_gridpoint_z2;
               }
             }
-          });
-    }
+          }
+        });
   } else {
     // shall not reach here due to above checks
     return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "Only support GirdSample in 4-D or 5-D cases.");
@@ -3,10 +3,11 @@
 
 #include "core/providers/cpu/tensor/nonzero_op.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <core/common/safeint.h>
-#include "core/util/math_cpuonly.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 // kernel builder functions
@@ -51,6 +52,11 @@ NONZERO_TYPED_KERNEL(float)
 #undef NONZERO_9_TYPED_KERNEL
 #undef NONZERO_TYPED_KERNEL
 
+namespace {
+// The minimum number of elements of each block of the input that is counted and written on a separate thread.
+constexpr int64_t kMinNonZeroBlockSize = 16 * 1024;
+}  // namespace
+
 template <typename T>
 Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto X = context->Input<Tensor>(0);
@@ -59,25 +65,59 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
   const auto& X_shape = X->Shape();
   assert(X_shape.Size() >= 0);
 
-  const Eigen::Index coordinate_size = X_shape.IsScalar() ? 1 : onnxruntime::narrow<Eigen::Index>(X_shape.NumDimensions());
-  std::vector<int64_t> non_zero_indices_buffer{};
-  // reserve enough space for indices for every element of X
-  non_zero_indices_buffer.reserve(SafeInt<size_t>(X_shape.Size()) * coordinate_size);
-
   const T* data = X->Data<T>();
 
   if (X_shape.IsScalar()) {
-    const T& value = *data;
-    if (value != T{}) {
-      non_zero_indices_buffer.push_back(0);
+    const int64_t num_non_zero_values = *data != T{} ? 1 : 0;
+    Tensor* const Y = context->Output(0, {1, num_non_zero_values});
+    ORT_ENFORCE(Y, "failed to get first output!");
+    if (num_non_zero_values != 0) {
+      *Y->MutableData<int64_t>() = 0;
     }
-  } else {
+
+    return Status::OK();
+  }
+
+  // The output size depends on the data, so the input is processed in blocks in two passes:
+  // the non-zero values of each block are counted in parallel, and after a scan of the counts every block writes
+  // the coordinates of its values to its own columns of the output in parallel.
+  const size_t coordinate_size = X_shape.NumDimensions();
+  const int64_t size = X_shape.Size();
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  const std::ptrdiff_t num_blocks = std::max<std::ptrdiff_t>(
+      1, std::min<std::ptrdiff_t>(concurrency::ThreadPool::DegreeOfParallelism(tp), size / kMinNonZeroBlockSize));
+  const auto block_begin = [size, num_blocks](std::ptrdiff_t block) { return block * size / num_blocks; };
+
+  std::vector<int64_t> block_offsets(SafeInt<size_t>(num_blocks) + 1, 0);
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+    block_offsets[block + 1] = std::count_if(data + block_begin(block), data + block_begin(block + 1),
+                                             [](const T& value) { return value != T{}; });
+  });
+
+  for (std::ptrdiff_t block = 0; block < num_blocks; ++block) {
+    block_offsets[block + 1] += block_offsets[block];
+  }
+
+  const int64_t num_non_zero_values = block_offsets[num_blocks];
+  Tensor* const Y = context->Output(0, {static_cast<int64_t>(coordinate_size), num_non_zero_values});
+  ORT_ENFORCE(Y, "failed to get first output!");
+  int64_t* const y_data = Y->MutableData<int64_t>();
+
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+    const int64_t begin = block_begin(block);
+    const int64_t end = block_begin(block + 1);
+
+    // the coordinate of the first entry of the block
     std::vector<int64_t> coordinate(coordinate_size, 0);
+    for (int64_t idx = static_cast<int64_t>(coordinate_size) - 1, remainder = begin; idx >= 0 && remainder > 0; --idx) {
+      coordinate[idx] = remainder % X_shape[idx];
+      remainder /= X_shape[idx];
+    }
 
     // as we iterate the entries, increment the coordinate for the current entry
     // e.g. if shape is {2,2}, we start with 0,0 increment to 0,1 increment to 1,0 and finally 1,1
-    auto increment_coordinate = [&coordinate, &coordinate_size, &X_shape]() {
-      for (Eigen::Index idx = coordinate_size - 1; idx >= 0; --idx) {
+    auto increment_coordinate = [&coordinate, coordinate_size, &X_shape]() {
+      for (int64_t idx = static_cast<int64_t>(coordinate_size) - 1; idx >= 0; --idx) {
         int64_t& cur_coord = coordinate[idx];
         if (cur_coord != X_shape[idx] - 1) {
           ++cur_coord;
@@ -87,31 +127,19 @@ Status NonZero<T>::Compute(OpKernelContext* context) const {
       }
     };
 
-    for (size_t i = 0, end = onnxruntime::narrow<size_t>(X_shape.Size()); i < end; ++i) {
-      const T& value = *data++;
-      if (value != T{}) {
-        non_zero_indices_buffer.insert(non_zero_indices_buffer.end(),
-                                       coordinate.begin(), coordinate.end());
+    // the output is [coordinate_size, num_non_zero_values], so each coordinate of a value goes to another row
+    int64_t output_index = block_offsets[block];
+    for (int64_t i = begin; i < end; ++i) {
+      if (data[i] != T{}) {
+        for (size_t idx = 0; idx < coordinate_size; ++idx) {
+          y_data[idx * num_non_zero_values + output_index] = coordinate[idx];
+        }
+        ++output_index;
       }
 
       increment_coordinate();
     }
-  }
-
-  const Eigen::Index num_non_zero_values = onnxruntime::narrow<Eigen::Index>(non_zero_indices_buffer.size()) / coordinate_size;
-
-  // transpose result for output
-  ConstEigenMatrixMapRowMajor<int64_t> non_zero_indices_matrix{
-      non_zero_indices_buffer.data(),
-      num_non_zero_values, coordinate_size};
-
-  Tensor* const Y = context->Output(0, {coordinate_size, num_non_zero_values});
-  ORT_ENFORCE(Y, "failed to get first output!");
-
-  EigenMatrixMapRowMajor<int64_t> y_matrix{
-      Y->MutableData<int64_t>(),
-      coordinate_size, num_non_zero_values};
-  y_matrix = non_zero_indices_matrix.transpose();
+  });
 
   return Status::OK();
 }
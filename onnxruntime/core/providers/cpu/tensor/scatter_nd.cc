@@ -3,6 +3,10 @@
 
 #include "core/providers/cpu/tensor/scatter_nd.h"
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/platform/threadpool.h"
@@ -122,7 +126,7 @@ struct Prepare {
 };  // struct Prepare
 
 template <typename TData>
-Status PrepareForCompute(OpKernelContext* context, Prepare<TData>& p) {
+Status PrepareForCompute(OpKernelContext* context, Prepare<TData>& p, concurrency::ThreadPool* tp) {
   const auto* input_tensor = context->Input<Tensor>(0);
   const auto* indice_tensor = context->Input<Tensor>(1);
   const auto* update_tensor = context->Input<Tensor>(2);
@@ -168,25 +172,39 @@ Status PrepareForCompute(OpKernelContext* context, Prepare<TData>& p) {
   p.input_base = update_tensor->Data<TData>();
   p.output_base = output_tensor->MutableData<TData>();
 
-  for (int64_t i = 0; i < offset_count; ++i) {
-    for (int64_t j = 0; j < last_indice_dimension; ++j) {
-      auto indice = *(indice_offset + i * last_indice_dimension + j);
+  // the offsets are computed in parallel, any of the invalid indices found is reported
+  std::atomic<bool> has_invalid_indice{false};
+  std::atomic<int64_t> invalid_indice{0};
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(offset_count), static_cast<double>(last_indice_dimension),
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          uint64_t element_offset = 0;
+          for (int64_t j = 0; j < last_indice_dimension; ++j) {
+            auto indice = *(indice_offset + i * last_indice_dimension + j);
+            const auto dim = input_shape[onnxruntime::narrow<size_t>(j)];
+            if (indice < -dim || indice >= dim) {
+              if (!has_invalid_indice.exchange(true)) {
+                invalid_indice = indice;
+              }
+              return;
+            }
+
+            if (indice < 0) {
+              indice += dim;
+            }
+
+            element_offset += indice * element_counts[onnxruntime::narrow<size_t>(j)];
+          }
 
-      if (indice >= 0) {
-        if (indice >= input_shape[onnxruntime::narrow<size_t>(j)]) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", indice);
-        }
-      } else {
-        if (indice < -input_shape[onnxruntime::narrow<size_t>(j)]) {
-          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", indice);
-        } else {
-          indice += input_shape[onnxruntime::narrow<size_t>(j)];
+          p.element_offsets[onnxruntime::narrow<size_t>(i)] = element_offset;
         }
-      }
+      });
 
-      p.element_offsets[onnxruntime::narrow<size_t>(i)] += indice * element_counts[onnxruntime::narrow<size_t>(j)];
-    }
+  if (has_invalid_indice) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "invalid indice found, indice = ", invalid_indice.load());
   }
+
   return Status::OK();
 }
 
@@ -354,7 +372,7 @@ template <typename TData>
 struct ScatterNDDispatchTarget {
   Status operator()(OpKernelContext* context, concurrency::ThreadPool* tp, ScatterND::Reduction reduction) const {
     Prepare<TData> prepare;
-    ORT_RETURN_IF_ERROR(PrepareForCompute(context, prepare));
+    ORT_RETURN_IF_ERROR(PrepareForCompute(context, prepare, tp));
 
     auto lambda = [&](int64_t i) {
       switch (reduction) {
@@ -396,13 +414,57 @@ struct ScatterNDDispatchTarget {
         } break;
       }
     };
-    concurrency::ThreadPool::TryParallelFor(
-        tp, prepare.element_offsets.size(), static_cast<double>(prepare.element_to_copy),
-        [&lambda](ptrdiff_t first, ptrdiff_t last) {
-          for (int i = static_cast<int>(first), end = static_cast<int>(last); i < end; ++i) {
-            lambda(i);
-          }
-        });
+
+    // The updates of a reduction which write the same slice of the output conflict. The updates are then grouped by
+    // the slice they write, and the groups are split across the threads, so that each slice is only updated by one
+    // thread, in the order of the updates. Without a reduction, duplicate indices aren't allowed and the updates are
+    // independent.
+    const auto& element_offsets = prepare.element_offsets;
+    InlinedVector<size_t> order;
+    InlinedVector<size_t> group_starts;
+    if (reduction != ScatterND::Reduction::None && element_offsets.size() > 1) {
+      order.resize(element_offsets.size());
+      std::iota(order.begin(), order.end(), size_t{0});
+      std::stable_sort(order.begin(), order.end(), [&element_offsets](size_t lhs, size_t rhs) {
+        return element_offsets[lhs] < element_offsets[rhs];
+      });
+
+      for (size_t i = 0; i < order.size(); ++i) {
+        if (i == 0 || element_offsets[order[i]] != element_offsets[order[i - 1]]) {
+          group_starts.push_back(i);
+        }
+      }
+
+      if (group_starts.size() == order.size()) {
+        // all the slices are different
+        order.clear();
+      }
+    }
+
+    if (order.empty()) {
+      concurrency::ThreadPool::TryParallelFor(
+          tp, element_offsets.size(), static_cast<double>(prepare.element_to_copy),
+          [&lambda](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t i = first; i < last; ++i) {
+              lambda(i);
+            }
+          });
+    } else {
+      group_starts.push_back(order.size());
+      const double updates_per_group = static_cast<double>(order.size()) / static_cast<double>(group_starts.size() - 1);
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(group_starts.size() - 1),
+          updates_per_group * static_cast<double>(prepare.element_to_copy),
+          [&](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t group = first; group < last; ++group) {
+              const auto group_index = static_cast<size_t>(group);
+              for (size_t i = group_starts[group_index]; i < group_starts[group_index + 1]; ++i) {
+                lambda(onnxruntime::narrow<int64_t>(order[i]));
+              }
+            }
+          });
+    }
+
     return Status::OK();
   }
 };
@@ -7,6 +7,8 @@
 #include <unordered_map>
 
 #include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/op_kernel_type_control_utils.h"
 #include "core/providers/common.h"
@@ -39,16 +41,22 @@ using EnabledIndicesTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(kCpuE
                                                                            Slice, Input, 1);
 }  // namespace
 
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_SLICE_KERNEL_DEF KernelDefBuilder().MayStridedInput(0).MayStridedOutput(0, 0)
+#else
+#define CREATE_SLICE_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     1, 9,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
+    CREATE_SLICE_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>()),
     Slice1);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     10, 10,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -57,7 +65,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Slice,
     11,
     12,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -65,7 +73,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Slice,
     13,
-    KernelDefBuilder()
+    CREATE_SLICE_KERNEL_DEF
         .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypes>())
         .TypeConstraint("Tind", BuildKernelDefConstraintsFromTypeList<EnabledIndicesTypes>()),
     Slice10);
@@ -299,13 +307,38 @@ Status SliceBase::Compute(OpKernelContext* ctx) const {
                                              input_starts, input_ends,
                                              input_axes, input_steps));
 
-    ORT_RETURN_IF_ERROR(PrepareForCompute(input_starts, input_ends, input_axes, input_steps, compute_metadata));
+    ORT_RETURN_IF_ERROR(SliceOp::PrepareForComputeHelper(input_starts, input_ends, input_axes, input_steps,
+                                                         compute_metadata));
   }
   // Slice V1-9
   else {
-    ORT_RETURN_IF_ERROR(PrepareForCompute(attr_starts_, attr_ends_, attr_axes_, compute_metadata));
+    ORT_RETURN_IF_ERROR(SliceOp::PrepareForComputeHelper(attr_starts_, attr_ends_, attr_axes_, compute_metadata));
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // The output is a view of the input if the allocation planner made it share the input's buffer, and a strided
+  // input is copied through the same view. Both need the starts and steps of every dim, so come before flattening.
+  TensorShape output_shape(compute_metadata.output_dims_);
+  Tensor& output_tensor = *ctx->Output(0, output_shape);
+  if (output_shape.Size() > 0 &&
+      (output_tensor.DataRaw() == input_tensor.DataRaw() || !input_tensor.IsContiguous())) {
+    const auto input_strides = input_tensor.Strides();
+    SafeInt<ptrdiff_t> input_offset = 0;
+    TensorShapeVector output_strides(input_strides.size());
+    for (size_t i = 0; i < input_strides.size(); ++i) {
+      input_offset += SafeInt<ptrdiff_t>(compute_metadata.starts_[i]) * input_strides[i];
+      output_strides[i] = input_strides[i] * compute_metadata.steps_[i];
+    }
+    return CreateStridedView<EnabledDataTypes>(ctx->GetOperatorThreadPool(), input_tensor, input_offset,
+                                               output_strides, output_tensor);
+  }
+#endif
+
+  ORT_RETURN_IF_ERROR(FlattenOutputDims(compute_metadata.input_dimensions_, compute_metadata.output_dims_,
+                                        compute_metadata.starts_, compute_metadata.ends_, compute_metadata.steps_,
+                                        compute_metadata.p_flattened_input_dims_,
+                                        compute_metadata.p_flattened_output_dims_));
+
   Status status = Status::OK();
 
   bool supported = false;
@@ -28,12 +28,18 @@ ORT_SPECIFY_OP_KERNEL_ARG_REQUIRED_TYPES_ALL_OPSETS(
 using EnabledSplitDataTypes = ORT_OP_KERNEL_ARG_ENABLED_TYPE_LIST_ALL_OPSETS(
     kCpuExecutionProvider, kOnnxDomain, Split, Input, 0);
 
+// The outputs are strided copies of the input, so it may be a strided view too.
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_SPLIT_KERNEL_DEF KernelDefBuilder().MayStridedInput(0)
+#else
+#define CREATE_SPLIT_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     2,
     10,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    CREATE_SPLIT_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
     Split_1_13);
 
 // Opset 11 starts to support Neg Axis.
@@ -41,8 +47,7 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     11,
     12,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    CREATE_SPLIT_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
     Split_1_13);
 
 // Opset 13 starts to supports 'split' as optional input.
@@ -50,16 +55,14 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Split,
     13,
     17,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    CREATE_SPLIT_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
     Split_1_13);
 
 // TODO: support unequal split and num_outputs
 ONNX_CPU_OPERATOR_KERNEL(
     Split,
     18,
-    KernelDefBuilder().TypeConstraint("T",
-                                      BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
+    CREATE_SPLIT_KERNEL_DEF.TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledSplitDataTypes>()),
     Split_18);
 
 Status SplitBase::PrepareForCompute(const TensorShape& input_shape, int num_outputs, int64_t& axis, int& before_dims,
@@ -159,14 +162,21 @@ Status SplitImpl::Compute(OpKernelContext* context) const {
     output_dimensions[narrow<size_t>(axis)] = split_size;
 
     Tensor* output = context->Output(i, TensorShape{output_dimensions});
-    const auto output_strides = StridesForTensor(*output);
 
-    ORT_RETURN_IF_ERROR(DispatchStridedCopy<EnabledSplitDataTypes>(context->GetOperatorThreadPool(),
-                                                                   *output, /* dst_offset */ 0, output_strides,
-                                                                   output->Shape(),
-                                                                   input, input_offset, input_strides));
+    // the allocation planner may have placed this output in the input already
+    const bool is_in_place =
+        output->DataRaw() == static_cast<const char*>(input.DataRaw()) +
+                                 static_cast<ptrdiff_t>(input_offset) * static_cast<ptrdiff_t>(input.DataType()->Size());
+    if (!is_in_place) {
+      const auto output_strides = StridesForTensor(*output);
+
+      ORT_RETURN_IF_ERROR(DispatchStridedCopy<EnabledSplitDataTypes>(context->GetOperatorThreadPool(),
+                                                                     *output, /* dst_offset */ 0, output_strides,
+                                                                     output->Shape(),
+                                                                     input, input_offset, input_strides));
+    }
 
-    input_offset += SafeInt<ptrdiff_t>(split_size) * after_dims_excluding_split;  // offset by the data we used in this iteration
+    input_offset += SafeInt<ptrdiff_t>(split_size) * input_strides[narrow<size_t>(axis)];  // offset by the data we used in this iteration
   }
 
   return Status::OK();
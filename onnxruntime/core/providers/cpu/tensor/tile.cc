@@ -9,8 +9,11 @@
 #pragma warning(disable : 4996)
 #endif
 
+#include <algorithm>
+
 #include "core/providers/cpu/tensor/tile.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/platform/threadpool.h"
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -57,6 +60,22 @@ ONNX_CPU_OPERATOR_KERNEL(
         .TypeConstraint("T1", DataTypeImpl::GetTensorType<int64_t>()),
     Tile);
 
+namespace {
+// Appends num_repeats copies of the block_size bytes at block right after it. Each memcpy copies all the data
+// tiled so far, so many repeats of a small block take O(log(num_repeats)) calls. Returns the end of the copies.
+uint8_t* RepeatBlock(uint8_t* block, size_t block_size, size_t num_repeats) {
+  uint8_t* output = block + block_size;
+  size_t remaining = SafeInt<size_t>(block_size) * num_repeats;
+  while (remaining > 0) {
+    const size_t copy_size = std::min(static_cast<size_t>(output - block), remaining);
+    memcpy(output, block, copy_size);
+    output += copy_size;
+    remaining -= copy_size;
+  }
+  return output;
+}
+}  // namespace
+
 Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tensor, const int64_t* repeats, TensorAxisCounters& input_counters, const TensorPitches& output_pitches, size_t element_size) {
   const auto& input_shape = input_tensor.Shape().GetDims();
   const size_t dimension_count = input_shape.size();
@@ -67,7 +86,6 @@ Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tens
   // some helper variables that will be used along the way
   size_t block_size = 0;
   int64_t num_repeats = 0;
-  const uint8_t* copy = nullptr;
   const int64_t innermost_dim = input_shape[dimension_count - 1];
 
   while (input_counters) {
@@ -78,23 +96,15 @@ Status TileCoreForFixedSizeTypes(const Tensor& input_tensor, Tensor& output_tens
     input += block_size;
 
     // Tile data for the innermost axis
-    copy = output - block_size;
     num_repeats = repeats[dimension_count - 1] - 1;
-    for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-      memcpy(output, copy, block_size);
-      output += block_size;
-    }
+    output = RepeatBlock(output - block_size, block_size, onnxruntime::narrow<size_t>(num_repeats));
 
     // Tile data for other axes
     while (input_counters.Increment()) {
       ptrdiff_t pitch = onnxruntime::narrow<size_t>(output_pitches[input_counters.Axis()] * input_shape[input_counters.Axis()]);
       block_size = pitch * element_size;
-      copy = output - block_size;
       num_repeats = repeats[input_counters.Axis()] - 1;
-      for (int64_t repeat = 0; repeat < num_repeats; ++repeat) {
-        memcpy(output, copy, block_size);
-        output += block_size;
-      }
+      output = RepeatBlock(output - block_size, block_size, onnxruntime::narrow<size_t>(num_repeats));
     }
   }
   return Status::OK();
@@ -230,41 +240,50 @@ Status Tile::Compute(OpKernelContext* ctx) const {
                            num_of_copies_per_batch,
                            num_of_batch_copies) &&
       !input_tensor.IsDataType<std::string>()) {
-    int8_t* output_data_casted = reinterpret_cast<int8_t*>(output_tensor.MutableDataRaw());
-    const int8_t* input_data_casted = reinterpret_cast<const int8_t*>(input_tensor.DataRaw());
-    const void* input_data_raw = input_tensor.DataRaw();
+    auto* output_data_casted = reinterpret_cast<uint8_t*>(output_tensor.MutableDataRaw());
+    const auto* input_data_casted = reinterpret_cast<const uint8_t*>(input_tensor.DataRaw());
+    concurrency::ThreadPool* tp = ctx->GetOperatorThreadPool();
 
     if (!is_batched_memcpy) {
+      // every thread tiles the input over its own range of copies
       size_t copy_bytes = input_tensor.SizeInBytes();
-      // TODO: Add multi-threading logic if num_of_copies_per_batch is large enough
-      for (size_t i = 0; i < num_of_copies_per_batch; ++i) {
-        memcpy(static_cast<void*>(output_data_casted), input_data_raw, copy_bytes);
-        output_data_casted += copy_bytes;
-      }
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(num_of_copies_per_batch),
+          TensorOpCost{0, static_cast<double>(copy_bytes), static_cast<double>(copy_bytes) / 64},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            uint8_t* output = output_data_casted + first * copy_bytes;
+            memcpy(output, input_data_casted, copy_bytes);
+            RepeatBlock(output, copy_bytes, onnxruntime::narrow<size_t>(last - first - 1));
+          });
     } else {
       size_t copy_bytes = num_of_elements_per_batch * input_tensor.DataType()->Size();
       size_t batch_count = static_cast<size_t>(input_tensor.Shape()[0]);  // The tensor is atleast 1-D- this is safe
-
-      // TODO: Multi-thread if needed
-      for (size_t batch = 0; batch < batch_count; ++batch) {
-        for (size_t i = 0; i < num_of_copies_per_batch; ++i) {
-          memcpy(static_cast<void*>(output_data_casted), static_cast<const void*>(input_data_casted), copy_bytes);
-          output_data_casted += copy_bytes;
-        }
-        input_data_casted += copy_bytes;
-      }
+      const size_t batch_output_bytes = copy_bytes * num_of_copies_per_batch;
+
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(batch_count),
+          TensorOpCost{static_cast<double>(copy_bytes), static_cast<double>(batch_output_bytes),
+                       static_cast<double>(batch_output_bytes) / 64},
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            for (std::ptrdiff_t batch = first; batch < last; ++batch) {
+              uint8_t* output = output_data_casted + batch * batch_output_bytes;
+              memcpy(output, input_data_casted + batch * copy_bytes, copy_bytes);
+              RepeatBlock(output, copy_bytes, num_of_copies_per_batch - 1);
+            }
+          });
 
       // Now account for batch dim repeat
       if (num_of_batch_copies > 1) {
-        // reset some values
-        output_data_casted = reinterpret_cast<int8_t*>(output_tensor.MutableDataRaw());
-        copy_bytes *= num_of_copies_per_batch * batch_count;
-        int8_t* copy_ptr = output_data_casted + copy_bytes;
-
-        for (size_t i = 1; i < num_of_batch_copies; ++i) {
-          memcpy(static_cast<void*>(copy_ptr), static_cast<const void*>(output_data_casted), copy_bytes);
-          copy_ptr += copy_bytes;
-        }
+        copy_bytes = batch_output_bytes * batch_count;
+        concurrency::ThreadPool::TryParallelFor(
+            tp, onnxruntime::narrow<std::ptrdiff_t>(num_of_batch_copies - 1),
+            TensorOpCost{static_cast<double>(copy_bytes), static_cast<double>(copy_bytes),
+                         static_cast<double>(copy_bytes) / 64},
+            [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+              for (std::ptrdiff_t i = first + 1; i <= last; ++i) {
+                memcpy(output_data_casted + i * copy_bytes, output_data_casted, copy_bytes);
+              }
+            });
       }
     }
 
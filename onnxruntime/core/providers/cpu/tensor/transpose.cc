@@ -3,7 +3,10 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
+#include "core/framework/copy.h"
 #include "core/framework/element_type_lists.h"
 #include "core/framework/utils.h"
 #include "core/framework/transpose_helper.h"
@@ -138,6 +141,20 @@ static inline void IncrementIndexAndComputeOffset(MultiIndex& mindex, const T*&
   }
 }
 
+/* This function sets an array of MultiIndex initialized by function IncrementIndexAndComputeOffsetSetup
+ * to the position of the i-th element of the iteration, and returns the offset of the source at this position,
+ * so that the iteration can start from any element, e.g. from the start of a range processed by a thread.
+ */
+static inline int64_t SetIndexAndComputeOffset(MultiIndex& mindex, size_t i) {
+  int64_t offset = 0;
+  for (int pos = static_cast<int>(mindex.n_axes) - 1; pos >= 0; --pos) {
+    mindex.index[pos] = i % mindex.upper_bound[pos];
+    i /= mindex.upper_bound[pos];
+    offset += static_cast<int64_t>(mindex.index[pos]) * mindex.stride[pos];
+  }
+  return offset;
+}
+
 // DoTransposeSingleBlock: specialization of DoTranspose for the num_blocks=1 case.
 // copies source tensor to target, transposing elements.
 static inline void DoTransposeSingleBlock(size_t num_elts_in_block, const void* source, void* target,
@@ -154,20 +171,29 @@ static inline void DoTransposeSingleBlock(size_t num_elts_in_block, const std::s
 
 // DoTranspose: copies source tensor to target, transposing elements.
 // The stride vector indicates the transposition.
+// The blocks are split across the threads of the thread pool if there is one.
 static void DoTransposeImpl(int64_t num_axes, gsl::span<const int64_t> target_dims,
                             size_t num_blocks, size_t num_elts_in_block, const gsl::span<const size_t>& stride,
-                            const uint8_t* source, uint8_t* target, size_t element_size) {
+                            const uint8_t* source, uint8_t* target, size_t element_size,
+                            concurrency::ThreadPool* tp) {
   size_t blocksize = num_elts_in_block * element_size;
   MultiIndex mindex;
   IncrementIndexAndComputeOffsetSetup(mindex, onnxruntime::narrow<size_t>(num_axes), target_dims, stride, element_size);
 
-  const uint8_t* local_source = source;
-  for (size_t i = 0; i < num_blocks; ++i) {
-    ORT_ENFORCE((local_source >= source) && (local_source < source + num_blocks * blocksize));
-    memcpy(target, local_source, blocksize);
-    IncrementIndexAndComputeOffset(mindex, local_source);
-    target += blocksize;
-  }
+  const double bytes_per_block = static_cast<double>(blocksize);
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(num_blocks), TensorOpCost{bytes_per_block, bytes_per_block, 1.0},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        MultiIndex local_mindex = mindex;
+        const uint8_t* local_source = source + SetIndexAndComputeOffset(local_mindex, static_cast<size_t>(first));
+        uint8_t* local_target = target + static_cast<size_t>(first) * blocksize;
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          ORT_ENFORCE((local_source >= source) && (local_source < source + num_blocks * blocksize));
+          memcpy(local_target, local_source, blocksize);
+          IncrementIndexAndComputeOffset(local_mindex, local_source);
+          local_target += blocksize;
+        }
+      });
 }
 
 static void DoTransposeImpl(int64_t num_axes, gsl::span<const int64_t> target_dims,
@@ -191,23 +217,122 @@ inline void CopyPrim(uint8_t* target, const uint8_t* source) {
   *reinterpret_cast<T*>(target) = *reinterpret_cast<const T*>(source);
 }
 
+// Size of the square tiles of TypedDoTransposeEltWiseTiled. The rows of a tile which are read and written
+// stay in the L1 cache.
+constexpr int64_t kTransposeTileSize = 16;
+
+// Element-wise transpose where the innermost axis of the output and the innermost axis of the input are different
+// axes which are both at least a tile long. 'input_axis' is the position in the output of the innermost input axis.
+// These two axes are transposed in square tiles, so that each tile reads and writes a few cache lines per row
+// instead of reading a new cache line for each element. The tiles of a row of tiles along the innermost input axis
+// are processed by the same thread, and these rows for all the positions along the other axes are split across
+// the threads of the thread pool.
+template <class T>
+static void TypedDoTransposeEltWiseTiled(gsl::span<const int64_t> target_dims, size_t input_axis,
+                                         const gsl::span<const size_t>& stride, const uint8_t* source,
+                                         uint8_t* target, concurrency::ThreadPool* tp) {
+  const size_t rank = target_dims.size();
+  const size_t output_axis = rank - 1;
+  const int64_t output_axis_size = target_dims[output_axis];
+  const int64_t input_axis_size = target_dims[input_axis];
+  const int64_t output_axis_stride = onnxruntime::narrow<int64_t>(stride[output_axis]);
+
+  // the strides of the output, and the other axes
+  InlinedVector<int64_t> target_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    target_strides[i - 1] = target_strides[i] * target_dims[i];
+  }
+  const int64_t input_axis_target_stride = target_strides[input_axis];
+
+  InlinedVector<int64_t> outer_dims, outer_source_strides, outer_target_strides;
+  int64_t outer_size = 1;
+  for (size_t i = 0; i < output_axis; ++i) {
+    if (i != input_axis) {
+      outer_dims.push_back(target_dims[i]);
+      outer_source_strides.push_back(onnxruntime::narrow<int64_t>(stride[i]));
+      outer_target_strides.push_back(target_strides[i]);
+      outer_size *= target_dims[i];
+    }
+  }
+
+  const int64_t num_row_tiles = (input_axis_size + kTransposeTileSize - 1) / kTransposeTileSize;
+  const auto* source_data = reinterpret_cast<const T*>(source);
+  auto* target_data = reinterpret_cast<T*>(target);
+
+  const double bytes_per_row_of_tiles = static_cast<double>(kTransposeTileSize * output_axis_size * sizeof(T));
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(outer_size * num_row_tiles),
+      TensorOpCost{bytes_per_row_of_tiles, bytes_per_row_of_tiles,
+                   static_cast<double>(kTransposeTileSize * output_axis_size)},
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row_of_tiles = first; row_of_tiles < last; ++row_of_tiles) {
+          int64_t outer_index = row_of_tiles / num_row_tiles;
+          const int64_t row_begin = (row_of_tiles % num_row_tiles) * kTransposeTileSize;
+          const int64_t row_end = std::min(row_begin + kTransposeTileSize, input_axis_size);
+
+          const T* source_base = source_data + row_begin;
+          T* target_base = target_data + row_begin * input_axis_target_stride;
+          for (size_t i = outer_dims.size(); i > 0; --i) {
+            const int64_t index = outer_index % outer_dims[i - 1];
+            outer_index /= outer_dims[i - 1];
+            source_base += index * outer_source_strides[i - 1];
+            target_base += index * outer_target_strides[i - 1];
+          }
+
+          for (int64_t col_begin = 0; col_begin < output_axis_size; col_begin += kTransposeTileSize) {
+            const int64_t col_end = std::min(col_begin + kTransposeTileSize, output_axis_size);
+            for (int64_t row = row_begin; row < row_end; ++row) {
+              const T* local_source = source_base + (row - row_begin) + col_begin * output_axis_stride;
+              T* local_target = target_base + (row - row_begin) * input_axis_target_stride;
+              for (int64_t col = col_begin; col < col_end; ++col, local_source += output_axis_stride) {
+                local_target[col] = *local_source;
+              }
+            }
+          }
+        }
+      });
+}
+
 // The function does not check num_axes > 0 but this is expected.
 template <class T>
 static bool TypedDoTransposeEltWise(int64_t num_axes, gsl::span<const int64_t> target_dims, size_t num_blocks,
-                                    const gsl::span<const size_t>& stride, const uint8_t* source, uint8_t* target) {
+                                    const gsl::span<const size_t>& stride, const uint8_t* source, uint8_t* target,
+                                    concurrency::ThreadPool* tp) {
   constexpr bool enabled = utils::HasTypeWithSameSize<EnabledDataTypesAllOpsets, T>();
 
   if (enabled) {
+    // the position in the output of the innermost input axis
+    const size_t rank = onnxruntime::narrow<size_t>(num_axes);
+    size_t input_axis = rank;
+    for (size_t i = 0; i < rank; ++i) {
+      if (stride[i] == 1 && target_dims[i] > 1) {
+        input_axis = i;
+      }
+    }
+
+    if (rank == target_dims.size() && input_axis + 1 < rank && target_dims[input_axis] >= kTransposeTileSize &&
+        target_dims[rank - 1] >= kTransposeTileSize) {
+      TypedDoTransposeEltWiseTiled<T>(target_dims, input_axis, stride, source, target, tp);
+      return enabled;
+    }
+
     MultiIndex mindex;
     IncrementIndexAndComputeOffsetSetup(mindex, onnxruntime::narrow<size_t>(num_axes), target_dims, stride, sizeof(T));
 
-    const uint8_t* local_source = source;
-    uint8_t* target_end = target + sizeof(T) * num_blocks;
-    for (; target != target_end; target += sizeof(T)) {
-      ORT_ENFORCE((local_source >= source) && (local_source < source + sizeof(T) * num_blocks));
-      CopyPrim<T>(target, local_source);
-      IncrementIndexAndComputeOffset(mindex, local_source);
-    }
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(num_blocks),
+        TensorOpCost{static_cast<double>(sizeof(T)), static_cast<double>(sizeof(T)), 4.0},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          MultiIndex local_mindex = mindex;
+          const uint8_t* local_source = source + SetIndexAndComputeOffset(local_mindex, static_cast<size_t>(first));
+          uint8_t* local_target = target + sizeof(T) * static_cast<size_t>(first);
+          uint8_t* target_end = target + sizeof(T) * static_cast<size_t>(last);
+          for (; local_target != target_end; local_target += sizeof(T)) {
+            ORT_ENFORCE((local_source >= source) && (local_source < source + sizeof(T) * num_blocks));
+            CopyPrim<T>(local_target, local_source);
+            IncrementIndexAndComputeOffset(local_mindex, local_source);
+          }
+        });
   }
 
   return enabled;
@@ -218,20 +343,20 @@ static bool TypedDoTransposeEltWise(int64_t num_axes, gsl::span<const int64_t> t
 // The stride vector indicates the transposition.
 Status DoTransposeEltWise(int64_t num_axes, gsl::span<const int64_t> target_dims, size_t num_blocks,
                           const gsl::span<const size_t>& stride, const uint8_t* source, uint8_t* target,
-                          size_t element_size) {
+                          size_t element_size, concurrency::ThreadPool* tp) {
   bool enabled = false;
   switch (element_size) {
     case sizeof(uint64_t):
-      enabled = TypedDoTransposeEltWise<uint64_t>(num_axes, target_dims, num_blocks, stride, source, target);
+      enabled = TypedDoTransposeEltWise<uint64_t>(num_axes, target_dims, num_blocks, stride, source, target, tp);
       break;
     case sizeof(uint32_t):
-      enabled = TypedDoTransposeEltWise<uint32_t>(num_axes, target_dims, num_blocks, stride, source, target);
+      enabled = TypedDoTransposeEltWise<uint32_t>(num_axes, target_dims, num_blocks, stride, source, target, tp);
       break;
     case sizeof(uint16_t):
-      enabled = TypedDoTransposeEltWise<uint16_t>(num_axes, target_dims, num_blocks, stride, source, target);
+      enabled = TypedDoTransposeEltWise<uint16_t>(num_axes, target_dims, num_blocks, stride, source, target, tp);
       break;
     case sizeof(uint8_t):
-      enabled = TypedDoTransposeEltWise<uint8_t>(num_axes, target_dims, num_blocks, stride, source, target);
+      enabled = TypedDoTransposeEltWise<uint8_t>(num_axes, target_dims, num_blocks, stride, source, target, tp);
       break;
     default:
       // leave enabled as false
@@ -259,13 +384,74 @@ static void DoTransposeEltWise(int64_t num_axes, gsl::span<const int64_t> target
   }
 }
 
+// Removes the axes of size 1 and merges the axes which are next to each other in both the input and the output, so
+// that the transpose iterates over as few axes as possible.
+// e.g. the permutation (2, 3, 0, 1) of the shape (2, 3, 4, 5) is the permutation (1, 0) of the shape (6, 20).
+static void CoalesceTransposeAxes(const gsl::span<const size_t>& permutations, gsl::span<const int64_t> input_dims,
+                                  InlinedVector<size_t>& coalesced_permutations,
+                                  TensorShapeVector& coalesced_input_dims) {
+  const size_t rank = input_dims.size();
+
+  // the index of each input axis among the axes which aren't of size 1
+  InlinedVector<size_t> squeezed_axes(rank);
+  size_t num_squeezed_axes = 0;
+  for (size_t axis = 0; axis < rank; ++axis) {
+    squeezed_axes[axis] = num_squeezed_axes;
+    if (input_dims[axis] != 1) {
+      ++num_squeezed_axes;
+    }
+  }
+
+  // the runs of output axes whose input axes follow each other, as the first of these input axes and the size of
+  // the run, in the order of the output
+  InlinedVector<std::pair<size_t, int64_t>> runs;
+  size_t last_squeezed_axis = 0;
+  for (size_t i = 0; i < rank; ++i) {
+    const size_t axis = permutations[i];
+    if (input_dims[axis] == 1) {
+      continue;
+    }
+
+    if (!runs.empty() && squeezed_axes[axis] == last_squeezed_axis + 1) {
+      runs.back().second *= input_dims[axis];
+    } else {
+      runs.emplace_back(squeezed_axes[axis], input_dims[axis]);
+    }
+
+    last_squeezed_axis = squeezed_axes[axis];
+  }
+
+  // each run is an axis of the coalesced input, in the order of the first input axes of the runs
+  InlinedVector<size_t> input_order(runs.size());
+  std::iota(input_order.begin(), input_order.end(), size_t{0});
+  std::sort(input_order.begin(), input_order.end(),
+            [&runs](size_t lhs, size_t rhs) { return runs[lhs].first < runs[rhs].first; });
+
+  coalesced_permutations.resize(runs.size());
+  coalesced_input_dims.resize(runs.size());
+  for (size_t i = 0; i < input_order.size(); ++i) {
+    coalesced_input_dims[i] = runs[input_order[i]].second;
+    coalesced_permutations[input_order[i]] = i;
+  }
+}
+
 //  `input_shape_override` overrides the shape of `input` for compute purposes.
-static Status DoUntypedTranspose(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
-                                 const TensorShape* input_shape_override = nullptr) {
-  const auto& input_shape = input_shape_override ? *input_shape_override : input.Shape();
-  const auto& input_dims = input_shape.GetDims();
+static Status DoUntypedTranspose(const gsl::span<const size_t>& original_permutations, const Tensor& input,
+                                 Tensor& output, const TensorShape* input_shape_override = nullptr,
+                                 concurrency::ThreadPool* tp = nullptr) {
+  const auto& original_input_shape = input_shape_override ? *input_shape_override : input.Shape();
+
+  InlinedVector<size_t> permutations;
+  TensorShapeVector input_dims;
+  CoalesceTransposeAxes(original_permutations, original_input_shape.GetDims(), permutations, input_dims);
+  const TensorShape input_shape(input_dims);
   auto rank = input_shape.NumDimensions();
 
+  TensorShapeVector output_dims(rank);
+  for (size_t i = 0; i < rank; i++) {
+    output_dims[i] = input_dims[permutations[i]];
+  }
+
   const auto element_size = input.DataType()->Size();
   const bool is_string_type = input.IsDataTypeString();
 
@@ -307,10 +493,9 @@ static Status DoUntypedTranspose(const gsl::span<const size_t>& permutations, co
       if (1 == prefix_blocksize) {
         DoTransposeSingleBlock(suffix_blocksize, input_data, output_data);
       } else if (1 == suffix_blocksize) {
-        DoTransposeEltWise(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, stride,
-                           input_data, output_data);
+        DoTransposeEltWise(num_axes_in_prefix, output_dims, prefix_blocksize, stride, input_data, output_data);
       } else {
-        DoTransposeImpl(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, suffix_blocksize, stride,
+        DoTransposeImpl(num_axes_in_prefix, output_dims, prefix_blocksize, suffix_blocksize, stride,
                         input_data, output_data);
       }
     } else {
@@ -323,11 +508,11 @@ static Status DoUntypedTranspose(const gsl::span<const size_t>& permutations, co
       DoTransposeSingleBlock(suffix_blocksize, input_data, output_data, element_size);
     } else if (1 == suffix_blocksize) {
       // this may return a failed status if the data size is not supported in this build
-      status = DoTransposeEltWise(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, stride,
-                                  input_data, output_data, element_size);
+      status = DoTransposeEltWise(num_axes_in_prefix, output_dims, prefix_blocksize, stride,
+                                  input_data, output_data, element_size, tp);
     } else {
-      DoTransposeImpl(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, suffix_blocksize, stride,
-                      input_data, output_data, element_size);
+      DoTransposeImpl(num_axes_in_prefix, output_dims, prefix_blocksize, suffix_blocksize, stride,
+                      input_data, output_data, element_size, tp);
     }
   }
 
@@ -368,7 +553,7 @@ static Status TransposeImpl(const gsl::span<const size_t>& permutations, const T
   }
 
   // fall back to default implementation
-  return DoUntypedTranspose(permutations, input, output, input_shape_override);
+  return DoUntypedTranspose(permutations, input, output, input_shape_override, tp);
 }
 
 template <typename Int4Type>
@@ -450,21 +635,42 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
+#ifdef ENABLE_STRIDED_TENSORS
+  // The output is a view of the input with permuted strides if the allocation planner made it share the input's
+  // buffer. A strided input is copied through the same permuted strides.
+  if (Y.DataRaw() == X.DataRaw() || !X.IsContiguous()) {
+    const auto input_strides = X.Strides();
+    TensorShapeVector output_strides(rank);
+    for (size_t i = 0; i < rank; ++i) {
+      output_strides[i] = input_strides[(*p_perm)[i]];
+    }
+    return CreateStridedView<EnabledDataTypesAllOpsets>(ctx->GetOperatorThreadPool(), X, 0, output_strides, Y);
+  }
+#endif
+
   return DoTranspose(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool());
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+#define CREATE_TRANSPOSE_KERNEL_DEF KernelDefBuilder().MayStridedInput(0).MayStridedOutput(0, 0)
+#else
+#define CREATE_TRANSPOSE_KERNEL_DEF KernelDefBuilder()
+#endif
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     1,
     12,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
+    CREATE_TRANSPOSE_KERNEL_DEF
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
     Transpose);
 
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Transpose,
     13,
     20,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
+    CREATE_TRANSPOSE_KERNEL_DEF
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesAllOpsets>()),
     Transpose);
 
 // Opset 21 added support for float8e4m3fnuz, float8e5m2, float8e5m2fnuz, int4 and uint4.
@@ -472,7 +678,8 @@ ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
 ONNX_CPU_OPERATOR_KERNEL(
     Transpose,
     21,
-    KernelDefBuilder().TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesOpset21>()),
+    CREATE_TRANSPOSE_KERNEL_DEF
+        .TypeConstraint("T", BuildKernelDefConstraintsFromTypeList<EnabledDataTypesOpset21>()),
     Transpose);
 
 }  // namespace onnxruntime
@@ -24,7 +24,7 @@ bool IsTransposeReshape(const gsl::span<const size_t>& perm, gsl::span<const int
 // Public function for element-wise transpose, primarily to unit test any out of bounds access
 Status DoTransposeEltWise(int64_t num_axes, gsl::span<const int64_t> target_dims, size_t num_blocks,
                           const gsl::span<const size_t>& stride, const uint8_t* source, uint8_t* target,
-                          size_t element_size);
+                          size_t element_size, concurrency::ThreadPool* tp = nullptr);
 
 class TransposeBase {
  public:
@@ -145,60 +145,35 @@ class Subtensor {
 };
 
 template <typename T>
-static void CreateFlattenedOutput(OpKernelContext& context,
-                                  const std::map<const T, int64_t>& offsets,         // map sorted key to unsorted idx
-                                  const std::vector<std::vector<int64_t>>& indices,  // unsorted
-                                  const std::vector<int64_t>& inverse_index,         // unsorted
-                                  bool sorted) {
-  int64_t num_unique = static_cast<int64_t>(indices.size());
+static void CreateFlattenedOutput(OpKernelContext& context, gsl::span<const T> data, bool sorted) {
+  Tensor* inverse_indices = context.Output(2, {static_cast<int64_t>(data.size())});
+  gsl::span<int64_t> inverse_indices_data = inverse_indices != nullptr ? inverse_indices->MutableDataAsSpan<int64_t>()
+                                                                       : gsl::span<int64_t>();
+
+  const auto unique_values = unique_op::FindUniqueValues(data, sorted, context.GetOperatorThreadPool(),
+                                                         inverse_indices_data);
+
+  int64_t num_unique = static_cast<int64_t>(unique_values.ordered.size());
   Tensor& Y = *context.Output(0, {num_unique});
   Tensor* indices_out = context.Output(1, {num_unique});
-  Tensor* inverse_indices = context.Output(2, {static_cast<int64_t>(inverse_index.size())});
   Tensor* counts = context.Output(3, {num_unique});
 
   auto Y_data = Y.MutableDataAsSpan<T>();
   gsl::span<int64_t> indices_data = indices_out != nullptr ? indices_out->MutableDataAsSpan<int64_t>()
                                                            : gsl::span<int64_t>();
-  gsl::span<int64_t> inverse_indices_data = inverse_indices != nullptr ? inverse_indices->MutableDataAsSpan<int64_t>()
-                                                                       : gsl::span<int64_t>();
   gsl::span<int64_t> counts_data = counts != nullptr ? counts->MutableDataAsSpan<int64_t>()
                                                      : gsl::span<int64_t>();
 
-  // iterate using 'offsets' which is sorted, but contains the offset of the unsorted entry
-  auto offsets_iter = offsets.begin();
-  for (int64_t i = 0, end = num_unique; i < end; ++i, ++offsets_iter) {
-    // write sequentially if we want sorted output, use the unsorted_idx if not
-    auto unsorted_idx = offsets_iter->second;
-    auto output_idx = sorted ? i : unsorted_idx;
-
-    Y_data[onnxruntime::narrow<size_t>(output_idx)] = offsets_iter->first;
+  for (size_t i = 0, end = unique_values.ordered.size(); i < end; ++i) {
+    const auto& entry = *unique_values.ordered[i];
+    Y_data[i] = entry.first;
 
     if (indices_out) {
-      indices_data[onnxruntime::narrow<size_t>(output_idx)] = indices[onnxruntime::narrow<size_t>(unsorted_idx)].front();
+      indices_data[i] = entry.second.first_index;
     }
 
     if (counts) {
-      counts_data[onnxruntime::narrow<size_t>(output_idx)] = indices[onnxruntime::narrow<size_t>(unsorted_idx)].size();
-    }
-  }
-
-  if (inverse_indices) {
-    if (sorted) {
-      // need to convert unsorted entries in the inverse index to their sorted values
-      std::vector<int64_t> unsorted_to_sorted;
-      unsorted_to_sorted.resize(onnxruntime::narrow<size_t>(num_unique));
-      int64_t sorted_idx = 0;
-      for (const auto& offset : offsets) {
-        unsorted_to_sorted[onnxruntime::narrow<size_t>(offset.second)] = sorted_idx++;
-      }
-
-      for (size_t i = 0, end = inverse_index.size(); i < end; ++i) {
-        inverse_indices_data[onnxruntime::narrow<size_t>(i)] = unsorted_to_sorted[onnxruntime::narrow<size_t>(inverse_index[i])];
-      }
-    } else {
-      for (size_t i = 0, end = inverse_index.size(); i < end; ++i) {
-        inverse_indices_data[i] = inverse_index[i];
-      }
+      counts_data[i] = entry.second.count;
     }
   }
 }
@@ -308,30 +283,7 @@ Status Unique::ComputeImpl(OpKernelContext& context) const {
   auto data = input.DataAsSpan<T>();
 
   if (flatten_) {
-    std::map<const T, int64_t> offsets;  // offset of entry in indices. provides map between sorted and unsorted values
-    std::vector<std::vector<int64_t>> indices;
-    std::vector<int64_t> inverse_index;
-
-    indices.reserve(data.size() / 2);  // arbitrary value. at worst 1 realloc but could be too large
-    inverse_index.reserve(data.size());
-
-    int64_t num_unique = 0;
-
-    for (int64_t i = 0, end = input.Shape().Size(); i < end; ++i) {
-      auto entry = offsets.find(data[onnxruntime::narrow<size_t>(i)]);
-      if (entry == offsets.end()) {
-        offsets[data[onnxruntime::narrow<size_t>(i)]] = num_unique;
-        inverse_index.push_back({num_unique});
-        indices.push_back({i});
-        ++num_unique;
-      } else {
-        size_t indices_idx = onnxruntime::narrow<size_t>(entry->second);
-        indices[indices_idx].push_back(i);
-        inverse_index.push_back(onnxruntime::narrow<int64_t>(indices_idx));
-      }
-    }
-
-    CreateFlattenedOutput(context, offsets, indices, inverse_index, sort_);
+    CreateFlattenedOutput(context, data, sort_);
   } else {
     const auto& input_shape = input.Shape();
     const int64_t input_dims = static_cast<int64_t>(input_shape.NumDimensions());
@@ -3,8 +3,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
 #include "core/common/common.h"
+#include "core/common/inlined_containers.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 class Unique final : public OpKernel {
@@ -27,4 +34,127 @@ class Unique final : public OpKernel {
   bool flatten_{false};
   int64_t axis_{0};
 };
+
+namespace unique_op {
+
+// The position of the first occurrence of a unique value, its number of occurrences and its index in the output.
+struct UniqueEntry {
+  int64_t first_index;
+  int64_t count;
+  int64_t output_index;
+};
+
+template <typename T>
+struct UniqueValues {
+  InlinedHashMap<T, UniqueEntry> entries;
+  // the entries in the order of the output
+  std::vector<const typename InlinedHashMap<T, UniqueEntry>::value_type*> ordered;
+};
+
+// The minimum number of elements of each block of the input that is hashed on a separate thread.
+constexpr int64_t kMinUniqueBlockSize = 16 * 1024;
+
+template <typename T>
+bool IsNaN(const T& value) {
+  if constexpr (std::is_floating_point<T>::value) {
+    return std::isnan(value);
+  } else {
+    ORT_UNUSED_PARAMETER(value);
+    return false;
+  }
+}
+
+// Finds the unique values of data. The input is hashed in blocks in parallel and the unique values of the blocks are
+// merged. The output order is the order of the first occurrences, or ascending if sorted.
+// NaNs can't be hashed as they are never equal, so they are counted separately as a single unique value which sorts
+// after all the numbers.
+// If inverse_indices is not empty it receives the index in the output of every element, computed in parallel.
+template <typename T>
+UniqueValues<T> FindUniqueValues(gsl::span<const T> data, bool sorted, concurrency::ThreadPool* tp,
+                                 gsl::span<int64_t> inverse_indices) {
+  const auto size = static_cast<int64_t>(data.size());
+  const std::ptrdiff_t num_blocks = std::max<std::ptrdiff_t>(
+      1, std::min<std::ptrdiff_t>(concurrency::ThreadPool::DegreeOfParallelism(tp), size / kMinUniqueBlockSize));
+
+  std::vector<InlinedHashMap<T, UniqueEntry>> block_entries(num_blocks);
+  std::vector<UniqueEntry> block_nan_entries(num_blocks, UniqueEntry{-1, 0, 0});
+  concurrency::ThreadPool::TrySimpleParallelFor(tp, num_blocks, [&](std::ptrdiff_t block) {
+    auto& entries = block_entries[block];
+    auto& nan_entry = block_nan_entries[block];
+    for (int64_t i = block * size / num_blocks, end = (block + 1) * size / num_blocks; i < end; ++i) {
+      if (IsNaN(data[i])) {
+        if (nan_entry.count++ == 0) {
+          nan_entry.first_index = i;
+        }
+      } else {
+        ++entries.try_emplace(data[i], UniqueEntry{i, 0, 0}).first->second.count;
+      }
+    }
+  });
+
+  // the blocks are merged in order, so the first occurrence found is the first one of the input
+  UniqueValues<T> unique_values;
+  auto& entries = unique_values.entries;
+  entries = std::move(block_entries[0]);
+  UniqueEntry nan_entry = block_nan_entries[0];
+  for (std::ptrdiff_t block = 1; block < num_blocks; ++block) {
+    for (const auto& entry : block_entries[block]) {
+      auto result = entries.try_emplace(entry.first, entry.second);
+      if (!result.second) {
+        result.first->second.count += entry.second.count;
+      }
+    }
+
+    if (block_nan_entries[block].count > 0) {
+      if (nan_entry.count == 0) {
+        nan_entry.first_index = block_nan_entries[block].first_index;
+      }
+      nan_entry.count += block_nan_entries[block].count;
+    }
+  }
+
+  // the NaN entry is inserted last, and can't be found by the lookups of the inverse indices
+  const typename InlinedHashMap<T, UniqueEntry>::value_type* nan_value = nullptr;
+  if (nan_entry.count > 0) {
+    nan_value = &*entries.emplace(data[nan_entry.first_index], nan_entry).first;
+  }
+
+  auto& ordered = unique_values.ordered;
+  ordered.reserve(entries.size());
+  for (const auto& entry : entries) {
+    ordered.push_back(&entry);
+  }
+
+  if (sorted) {
+    std::sort(ordered.begin(), ordered.end(), [nan_value](const auto* lhs, const auto* rhs) {
+      if (lhs == nan_value || rhs == nan_value) {
+        return lhs != nan_value;
+      }
+      return lhs->first < rhs->first;
+    });
+  } else {
+    std::sort(ordered.begin(), ordered.end(), [](const auto* lhs, const auto* rhs) {
+      return lhs->second.first_index < rhs->second.first_index;
+    });
+  }
+
+  for (size_t i = 0; i < ordered.size(); ++i) {
+    const_cast<UniqueEntry&>(ordered[i]->second).output_index = static_cast<int64_t>(i);
+  }
+
+  if (!inverse_indices.empty()) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(size), TensorOpCost{static_cast<double>(sizeof(T)), 8.0, 20.0},
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            inverse_indices[i] = IsNaN(data[i]) ? nan_value->second.output_index
+                                                : entries.find(data[i])->second.output_index;
+          }
+        });
+  }
+
+  return unique_values;
+}
+
+}  // namespace unique_op
 }  // namespace onnxruntime
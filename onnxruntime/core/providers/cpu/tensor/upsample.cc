@@ -918,49 +918,78 @@ std::array<float, CubicModeGridLength> GetCubicCoeffs(float s, float cubic_coeff
   return coeffs;
 }
 
-// Get the tensor data at the requested coordinate
-template <typename T>
-T GetDataForCoordinate(const T* Xdata,
-                       int64_t x, int64_t y,
-                       int64_t input_height, int64_t input_width) {
-  x = std::max(static_cast<int64_t>(0), std::min(x, input_width - 1));
-  y = std::max(static_cast<int64_t>(0), std::min(y, input_height - 1));
-  return Xdata[y * input_width + x];
+// The taps of the cubic filter along one axis for each output coordinate: the indices of the CubicModeGridLength
+// input samples, clamped to the input, and their weights. The weights are renormalized by 'weight_sums' when
+// exclude_outside is set. 'out_of_bounds' is set for the coordinates which get the extrapolation value.
+struct CubicAxisTaps {
+  std::vector<int64_t> indices;
+  std::vector<float> weights;
+  std::vector<float> weight_sums;
+  std::vector<uint8_t> out_of_bounds;
+};
+
+static CubicAxisTaps SetupCubicAxisTaps(int64_t input_size, int64_t output_size, float scale, float cubic_coeff_a,
+                                        bool use_extrapolation, bool exclude_outside, float roi_start, float roi_end,
+                                        const GetOriginalCoordinateFunc& get_original_coordinate) {
+  CubicAxisTaps taps;
+  const size_t n = narrow<size_t>(output_size);
+  taps.indices.resize(n * CubicModeGridLength);
+  taps.weights.resize(n * CubicModeGridLength);
+  taps.weight_sums.resize(n, 1.0f);
+  taps.out_of_bounds.resize(n, 0);
+
+  for (size_t i = 0; i < n; ++i) {
+    const float in = scale == 1 ? static_cast<float>(i)
+                                : get_original_coordinate(static_cast<float>(i), scale, static_cast<float>(output_size),
+                                                          static_cast<float>(input_size), roi_start, roi_end);
+    // when use_extrapolation is set and original index is out of the dim range
+    // then use extrapolation_value as the output value.
+    if (use_extrapolation && (in < 0 || in > static_cast<float>(input_size - 1))) {
+      taps.out_of_bounds[i] = 1;
+    }
+
+    const auto in_int = static_cast<int64_t>(std::floor(in));
+    const auto coeffs = GetCubicCoeffs(in - static_cast<float>(in_int), cubic_coeff_a);
+    float weight_sum = exclude_outside ? 0.0f : 1.0f;
+    for (size_t k = 0; k < CubicModeGridLength; ++k) {
+      const int64_t index = in_int - 1 + static_cast<int64_t>(k);
+      float weight = coeffs[k];
+      if (exclude_outside) {
+        // When true, the weight of sampling locations outside the grid will be set to 0
+        // and the weight will be renormalized so that their sum is 1.0
+        weight = (index < 0 || index >= input_size) ? 0.0f : weight;
+        weight_sum += weight;
+      }
+
+      taps.indices[i * CubicModeGridLength + k] = std::max<int64_t>(0, std::min(index, input_size - 1));
+      taps.weights[i * CubicModeGridLength + k] = weight;
+    }
+
+    taps.weight_sums[i] = weight_sum;
+  }
+
+  return taps;
 }
 
-// Computes cubic convolution interpolation in 1D
 template <typename T>
-float CubicInterpolation1D(const T* Xdata,
-                           int64_t x,
-                           int64_t y,
-                           int64_t input_height,
-                           int64_t input_width,
-                           std::array<float, CubicModeGridLength>& coeff_array,
-                           float coeff_sum,
-                           std::unordered_map<int64_t, float>& cache) {
-  // When calculating cubic interpolation we move the 4*4 grid across the original data and therefore there is
-  // opportunity to cache the results for previously seen combinations.
-  // Check if the result is already available in the cache
-  auto grid_start_pos = (y)*input_width + (x - 1);
-  if (cache.find(grid_start_pos) != cache.end()) {
-    return cache[grid_start_pos];
+static T CubicResultToOutput(float result) {
+  if constexpr (is_8bit_v<T>) {
+    const float rounded = std::nearbyint(result);
+    return static_cast<T>(std::max(static_cast<float>(std::numeric_limits<T>::min()),
+                                   std::min(rounded, static_cast<float>(std::numeric_limits<T>::max()))));
+  } else if constexpr (std::is_same<T, int32_t>::value) {
+    return static_cast<T>(std::nearbyint(result));
+  } else {
+    return static_cast<T>(result);
   }
+}
 
-  // get the neighbors in 1D and find interpolation for this dimension
-  // for 1D cubic interpolation 4 samples are used. 2 on the left and 2 on the right of x
-  float result = 0;
-  for (int i = 0, j = -1; i < static_cast<int>(CubicModeGridLength); i++, j++) {
-    auto orig_data = GetDataForCoordinate(Xdata, x + j, y, input_height, input_width);
-    result += coeff_array[narrow<size_t>(i)] / coeff_sum * orig_data;
-  }
-  cache[grid_start_pos] = result;
+// The number of output rows of a channel computed together. The horizontal pass is computed for the input rows
+// which the block of rows reads, and the blocks of all the channels are split across the threads.
+constexpr int64_t kBiCubicRowsPerBlock = 32;
 
-  return result;
-}
-#if defined(_MSC_VER)
-#pragma warning(push)
-#pragma warning(disable : 6001)
-#endif
+// Bicubic resize as a horizontal pass over the input rows followed by a vertical pass, with the taps of both axes
+// computed once. The vertical pass combines whole rows, so that its inner loop can be vectorized.
 template <typename T>
 void ResizeBiCubic(int64_t batch_size,
                    int64_t num_channels,
@@ -977,138 +1006,95 @@ void ResizeBiCubic(int64_t batch_size,
                    gsl::span<const float> roi,
                    const T* Xdata,
                    T* Ydata,
-                   const GetOriginalCoordinateFunc& get_original_coordinate) {
-  std::vector<float> y_original;
-  y_original.reserve(narrow<size_t>(output_height));
-
-  std::vector<float> x_original;
-  x_original.reserve(narrow<size_t>(output_width));
-
-  std::unordered_map<float, std::array<float, CubicModeGridLength>> cubic_coeffs;
-  std::unordered_map<float, std::unordered_map<int64_t, float>> coeff_to_1Dinterpolation_map;
+                   const GetOriginalCoordinateFunc& get_original_coordinate,
+                   concurrency::ThreadPool* tp) {
   auto roi_y_start = roi.size() / 2 - 2;
   auto roi_y_end = roi.size() - 2;
   auto roi_x_start = roi.size() / 2 - 1;
   auto roi_x_end = roi.size() - 1;
 
-  // generate coefficients in y direction
-  for (int64_t y = 0; y < output_height; ++y) {
-    float in_y = height_scale == 1 ? static_cast<float>(y)
-                                   : get_original_coordinate(static_cast<float>(y), height_scale,
-                                                             static_cast<float>(output_height),
-                                                             static_cast<float>(input_height),
-                                                             roi[roi_y_start], roi[roi_y_end]);
-    y_original.emplace_back(in_y);
-    auto s = y_original[narrow<size_t>(y)] - std::floor(y_original[narrow<size_t>(y)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // generate coefficients in x direction
-  for (int64_t x = 0; x < output_width; ++x) {
-    float in_x = width_scale == 1 ? static_cast<float>(x)
-                                  : get_original_coordinate(static_cast<float>(x),
-                                                            width_scale,
-                                                            static_cast<float>(output_width),
-                                                            static_cast<float>(input_width),
-                                                            roi[roi_x_start], roi[roi_x_end]);
-    x_original.emplace_back(in_x);
-    auto s = x_original[narrow<size_t>(x)] - std::floor(x_original[narrow<size_t>(x)]);
-    if (cubic_coeffs.find(s) == cubic_coeffs.end()) {
-      cubic_coeffs[s] = GetCubicCoeffs(s, cubic_coeff_a);
-      coeff_to_1Dinterpolation_map[s] = {};
-    }
-  }
-
-  // setup up temp arrays to hold coefficients when exclude_outside is set to true
-  std::array<float, CubicModeGridLength> y_coeff_holder;
-  std::array<float, CubicModeGridLength> x_coeff_holder;
-  float y_coeff_sum = 1;
-  float x_coeff_sum = 1;
-
-  for (int64_t n = 0; n < batch_size; n++) {
-    for (int64_t c = 0; c < num_channels; c++) {
-      for (int64_t y = 0; y < output_height; ++y) {
-        auto in_y = y_original[narrow<size_t>(y)];
-
-        // when use_extrapolation is set and original index is out of the dim range
-        // then use extrapolation_value as the output value.
-        if (use_extrapolation && (in_y < 0 || in_y > static_cast<float>(input_height - 1))) {
-          for (int64_t x = 0; x < output_width; ++x) {
-            Ydata[y * output_width + x] = extrapolation_value;
+  const CubicAxisTaps y_taps = SetupCubicAxisTaps(input_height, output_height, height_scale, cubic_coeff_a,
+                                                  use_extrapolation, exclude_outside, roi[roi_y_start],
+                                                  roi[roi_y_end], get_original_coordinate);
+  const CubicAxisTaps x_taps = SetupCubicAxisTaps(input_width, output_width, width_scale, cubic_coeff_a,
+                                                  use_extrapolation, exclude_outside, roi[roi_x_start],
+                                                  roi[roi_x_end], get_original_coordinate);
+
+  const int64_t num_row_blocks = (output_height + kBiCubicRowsPerBlock - 1) / kBiCubicRowsPerBlock;
+  const size_t width = narrow<size_t>(output_width);
+  const double cost_per_block = static_cast<double>(std::min(kBiCubicRowsPerBlock, output_height) * output_width *
+                                                    CubicModeGridLength * 2);
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(batch_size * num_channels * num_row_blocks), cost_per_block,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<float> rows;
+        std::vector<float> result(width);
+        for (std::ptrdiff_t block = first; block < last; ++block) {
+          const int64_t plane = block / num_row_blocks;
+          const int64_t y_begin = (block % num_row_blocks) * kBiCubicRowsPerBlock;
+          const int64_t y_end = std::min(y_begin + kBiCubicRowsPerBlock, output_height);
+          const T* X = Xdata + plane * input_height * input_width;
+          T* Y = Ydata + plane * output_height * output_width;
+
+          // the input rows read by the block
+          int64_t row_min = input_height;
+          int64_t row_max = -1;
+          for (int64_t y = y_begin; y < y_end; ++y) {
+            if (!y_taps.out_of_bounds[narrow<size_t>(y)]) {
+              const size_t first_tap = narrow<size_t>(y) * CubicModeGridLength;
+              row_min = std::min(row_min, y_taps.indices[first_tap]);
+              row_max = std::max(row_max, y_taps.indices[first_tap + CubicModeGridLength - 1]);
+            }
           }
-          continue;
-        }
 
-        auto y_int = static_cast<int64_t>(std::floor(in_y));
-        auto& coeff_y = exclude_outside ? y_coeff_holder : cubic_coeffs[in_y - y_int];
-        y_coeff_sum = 1;
-
-        if (exclude_outside) {
-          // When true, the weight of sampling locations outside the grid will be set to 0
-          // and the weight will be renormalized so that their sum is 1.0
-          y_coeff_sum = 0;
-          auto& orig_y_coeffs = cubic_coeffs[in_y - y_int];
-          for (int64_t i = 0, y_val = y_int - 1; y_val <= y_int + 2; y_val++, i++) {
-            y_coeff_holder[narrow<size_t>(i)] = (y_val < 0 || y_val >= static_cast<float>(input_height)) ? 0.0f : orig_y_coeffs[narrow<size_t>(i)];
-            y_coeff_sum += y_coeff_holder[narrow<size_t>(i)];
+          // horizontal pass
+          if (row_min <= row_max) {
+            rows.resize(narrow<size_t>(row_max - row_min + 1) * width);
+            for (int64_t row = row_min; row <= row_max; ++row) {
+              const T* X_row = X + row * input_width;
+              float* row_data = rows.data() + narrow<size_t>(row - row_min) * width;
+              for (size_t x = 0; x < width; ++x) {
+                const int64_t* indices = x_taps.indices.data() + x * CubicModeGridLength;
+                const float* weights = x_taps.weights.data() + x * CubicModeGridLength;
+                const float weight_sum = x_taps.weight_sums[x];
+                float value = 0;
+                for (size_t k = 0; k < CubicModeGridLength; ++k) {
+                  value += weights[k] / weight_sum * X_row[indices[k]];
+                }
+                row_data[x] = value;
+              }
+            }
           }
-        }
 
-        for (int64_t x = 0; x < output_width; ++x) {
-          auto in_x = x_original[narrow<size_t>(x)];
-
-          // when use_extrapolation is set and original index is out of the dim range
-          // then use extrapolation_value as the output value.
-          if (use_extrapolation && (in_x < 0 || in_x > static_cast<float>(input_width - 1))) {
-            Ydata[y * output_width + x] = extrapolation_value;
-            continue;
-          }
+          // vertical pass
+          for (int64_t y = y_begin; y < y_end; ++y) {
+            T* Y_row = Y + y * output_width;
+            if (y_taps.out_of_bounds[narrow<size_t>(y)]) {
+              std::fill_n(Y_row, width, static_cast<T>(extrapolation_value));
+              continue;
+            }
 
-          auto x_int = static_cast<int64_t>(std::floor(in_x));
-          auto s_x = static_cast<float>(in_x - x_int);
-          auto& coeff_x = exclude_outside ? x_coeff_holder : cubic_coeffs[s_x];
-          x_coeff_sum = 1;
-
-          if (exclude_outside) {
-            // When true, the weight of sampling locations outside the grid will be set to 0
-            // and the weight will be renormalized so that their sum is 1.0
-            x_coeff_sum = 0;
-            auto& orig_x_coeff = cubic_coeffs[s_x];
-            for (int64_t i = 0, x_val = x_int - 1; x_val <= x_int + 2; x_val++, i++) {
-              x_coeff_holder[narrow<size_t>(i)] = (x_val < 0 || x_val >= static_cast<float>(input_width)) ? 0.0f : orig_x_coeff[narrow<size_t>(i)];
-              x_coeff_sum += x_coeff_holder[narrow<size_t>(i)];
+            const int64_t* indices = y_taps.indices.data() + narrow<size_t>(y) * CubicModeGridLength;
+            const float* weights = y_taps.weights.data() + narrow<size_t>(y) * CubicModeGridLength;
+            const float weight_sum = y_taps.weight_sums[narrow<size_t>(y)];
+            std::fill(result.begin(), result.end(), 0.0f);
+            for (size_t k = 0; k < CubicModeGridLength; ++k) {
+              const float* row_data = rows.data() + narrow<size_t>(indices[k] - row_min) * width;
+              const float weight = weights[k];
+              for (size_t x = 0; x < width; ++x) {
+                result[x] += row_data[x] * weight / weight_sum;
+              }
             }
-          }
 
-          // Compute cubic interpolation in x dimension using the x coefficients.
-          // From the result of cubic interpolation in x dim, compute cubic interpolation in y dimension
-          auto& interpolation_result_cache = coeff_to_1Dinterpolation_map[s_x];
-          float result = 0;
-          for (int64_t y_val = y_int - 1, i = 0; y_val <= y_int + 2; y_val++, i++) {
-            auto x_interpolation_result = CubicInterpolation1D(Xdata, x_int, y_val,
-                                                               input_height, input_width, coeff_x, x_coeff_sum,
-                                                               interpolation_result_cache);
-            result += x_interpolation_result * coeff_y[narrow<size_t>(i)] / y_coeff_sum;
+            for (size_t x = 0; x < width; ++x) {
+              Y_row[x] = x_taps.out_of_bounds[x] ? static_cast<T>(extrapolation_value)
+                                                 : CubicResultToOutput<T>(result[x]);
+            }
           }
-
-          Ydata[y * output_width + x] = static_cast<T>(result);
         }
-      }
-
-      Xdata += input_height * input_width;
-      Ydata += output_height * output_width;
-
-      // clear the cache when moving to the next channel
-      coeff_to_1Dinterpolation_map.clear();
-    }
-  }
+      });
 }
-#if defined(_MSC_VER)
-#pragma warning(pop)
-#endif
 
 template <typename T>
 Status Upsample<T>::BaseCompute(OpKernelContext* context,
@@ -1351,8 +1337,9 @@ Status Upsample<T>::BaseCompute(OpKernelContext* context,
       } else {
         ResizeBiCubic(batch_size, num_channels, input_height, input_width, output_height, output_width,
                       height_scale, width_scale, cubic_coeff_a_, use_extrapolation_,
-                      extrapolation_value_, exclude_outside_, roi, X->Data<float>(),
-                      Y->MutableData<float>(), get_original_coordinate_);
+                      extrapolation_value_, exclude_outside_, roi, X->Data<T>(),
+                      Y->MutableData<T>(), get_original_coordinate_,
+                      output_height * output_width * num_channels > 64 ? context->GetOperatorThreadPool() : nullptr);
       }
       return Status::OK();
     }
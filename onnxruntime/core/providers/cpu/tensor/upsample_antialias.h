@@ -250,23 +250,26 @@ void ComputeInterpolationAtLevel1(int64_t num_channels, int64_t input_height, in
                                   concurrency::ThreadPool* tp) {
   const uint8_t* clip8_lookups = &p.GetClip8LookupTable()[640];
 
-  concurrency::ThreadPool::TrySimpleParallelFor(
-      tp, narrow<std::ptrdiff_t>(num_channels),
-      [&](std::ptrdiff_t c) {
-        auto x_start = c * (input_height * input_width);
-        auto y_start = c * (output_height * output_width);
-
-        const InputType* Xdata = Xdata_span.data() + x_start;
-        InputType* Ydata = Ydata_span.data() + y_start;
-        // no need to do scale
-        if (output_width == input_width) {
-          std::copy_n(Xdata_span.begin() + narrow<size_t>(x_start), narrow<size_t>(output_height * output_width),
-                      Ydata_span.begin() + narrow<size_t>(y_start));
-          return;
-        }
+  // The rows of all the channels are split across the threads, so that images with few channels use all of them.
+  // The cost of a row grows with the width of the filter, which is wide when downsampling.
+  const TensorOpCost cost{static_cast<double>(input_width * sizeof(InputType)),
+                          static_cast<double>(output_width * sizeof(InputType)),
+                          static_cast<double>(output_width * p_dim.window_size)};
+  concurrency::ThreadPool::TryParallelFor(
+      tp, narrow<std::ptrdiff_t>(num_channels * output_height), cost,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t row = first; row < last; ++row) {
+          const auto c = row / output_height;
+          const auto y = row % output_height;
+          const InputType* Xdata = Xdata_span.data() + c * (input_height * input_width) + y * input_width;
+          InputType* Ydata_offset = Ydata_span.data() + c * (output_height * output_width) + y * output_width;
+
+          // no need to do scale
+          if (output_width == input_width) {
+            std::copy_n(Xdata, narrow<size_t>(output_width), Ydata_offset);
+            continue;
+          }
 
-        for (size_t y = 0; y < narrow<size_t>(output_height); ++y) {
-          auto* Ydata_offset = Ydata + output_width * y;
           auto* bound = p_dim.bound.data();
           for (size_t x = 0; x < narrow<size_t>(output_width); ++x) {
             AccumulateType output = is_8bit_v<InputType> ? ConstValue::mag_factor : 0;
@@ -274,7 +277,7 @@ void ComputeInterpolationAtLevel1(int64_t num_channels, int64_t input_height, in
             const auto* weight_coeff = p_dim.weight_coefficients.get() + p_dim.window_size * x;
             int64_t xmin = *bound++;
             int64_t xmax = *bound++;
-            const auto* Xdata_offset = Xdata + y * input_width + xmin;
+            const auto* Xdata_offset = Xdata + xmin;
             for (; xmin < xmax; ++xmin) {
               output += (*Xdata_offset++) * (*weight_coeff++);
             }
@@ -291,6 +294,41 @@ void ComputeInterpolationAtLevel1(int64_t num_channels, int64_t input_height, in
       });
 }
 
+/**
+ * @brief Computes the output row 'y' of a channel along the penultimate axis.
+ * The taps of the filter are accumulated a whole row at a time into 'row_buffer', so that the inner loops read and
+ * write contiguous rows and can be vectorized, instead of walking down a column for each output element.
+ */
+template <typename InputType, typename AccumulateType>
+void ComputeRowAtLevel2(const InputType* Xdata, InputType* Ydata_row, size_t y, int64_t output_width,
+                        const FilterParamsBaseAntiAlias<AccumulateType>& p_dim, const uint8_t* clip8_lookups,
+                        gsl::span<AccumulateType> row_buffer) {
+  const auto* weight_coeff = p_dim.weight_coefficients.get() + p_dim.window_size * y;
+  const int64_t ymin = p_dim.bound[2 * y];
+  const int64_t ymax = p_dim.bound[2 * y + 1];
+  const size_t width = narrow<size_t>(output_width);
+
+  AccumulateType* accumulated = row_buffer.data();
+  std::fill_n(accumulated, width, static_cast<AccumulateType>(is_8bit_v<InputType> ? ConstValue::mag_factor : 0));
+  for (auto idx = ymin; idx < ymax; ++idx) {
+    const AccumulateType weight = *weight_coeff++;
+    const InputType* Xdata_row = Xdata + idx * output_width;
+    for (size_t x = 0; x < width; ++x) {
+      accumulated[x] += Xdata_row[x] * weight;
+    }
+  }
+
+  for (size_t x = 0; x < width; ++x) {
+    if constexpr (is_8bit_v<InputType>) {
+      Ydata_row[x] = static_cast<InputType>(clip8_lookups[accumulated[x] >> 22]);
+    } else if constexpr (std::is_same<InputType, int32_t>::value) {
+      Ydata_row[x] = narrow<int32_t>(std::round(accumulated[x]));
+    } else {  // float double
+      Ydata_row[x] = accumulated[x];
+    }
+  }
+}
+
 /**
  * @brief To calculate interpolation along with penultimate axis.
  * For brief, we assume the input tensor has 3 dimensions and we all it CHW for each character represent a dim.
@@ -335,36 +373,17 @@ void ComputeInterpolationAtLevel2(int64_t num_channels, int64_t input_height, in
             return;
           }
 
-          const auto* y_bound = p_dim.bound.data();
+          std::vector<AccumulateType> row_buffer(narrow<size_t>(output_width));
           for (size_t y = 0; y < narrow<size_t>(output_height); ++y) {
-            const auto* weight_coeff = p_dim.weight_coefficients.get() + p_dim.window_size * y;
-            int64_t ymin = *y_bound++;
-            int64_t ymax = *y_bound++;
-            auto* Ydata_offset = Ydata + output_width * y;
-            for (size_t x = 0; x < narrow<size_t>(output_width); ++x) {
-              AccumulateType output = is_8bit_v<InputType> ? ConstValue::mag_factor : 0;
-              auto* weight_coeff_start = weight_coeff;
-
-              const auto* Xdata_offset = Xdata + ymin * output_width + x;
-              for (auto idx = ymin; idx < ymax; ++idx) {
-                output += *Xdata_offset * (*weight_coeff_start++);
-                Xdata_offset += output_width;
-              }
-
-              if constexpr (is_8bit_v<InputType>) {
-                *Ydata_offset++ = static_cast<InputType>(clip8_lookups[output >> 22]);
-              } else if constexpr (std::is_same<InputType, int32_t>::value) {
-                *Ydata_offset++ = narrow<int32_t>(std::round(output));
-              } else {  // float double
-                *Ydata_offset++ = output;
-              }
-            }
+            ComputeRowAtLevel2(Xdata, Ydata + output_width * y, y, output_width, p_dim, clip8_lookups,
+                               gsl::make_span(row_buffer));
           }
         });
   } else {
+    // the cost of a row grows with the width of the filter, which is wide when downsampling
     concurrency::ThreadPool::TryParallelFor(
         tp, static_cast<std::ptrdiff_t>(output_height * num_channels),
-        static_cast<double>(output_height * 2),
+        static_cast<double>(output_width * p_dim.window_size),
         [&](std::ptrdiff_t first, std::ptrdiff_t last) {
           if (output_height == input_height) {
             auto workload_in_thread = narrow<size_t>(last) - narrow<size_t>(first);
@@ -373,6 +392,7 @@ void ComputeInterpolationAtLevel2(int64_t num_channels, int64_t input_height, in
             return;
           }
 
+          std::vector<AccumulateType> row_buffer(narrow<size_t>(output_width));
           for (auto start = first; start != last; start++) {
             auto c = start / output_height;
             auto y = start % output_height;
@@ -383,29 +403,8 @@ void ComputeInterpolationAtLevel2(int64_t num_channels, int64_t input_height, in
             const InputType* Xdata = Xdata_span.data() + x_start;
             InputType* Ydata = Ydata_span.data() + y_start;
 
-            const auto* y_bound = p_dim.bound.data();
-            const auto* weight_coeff = p_dim.weight_coefficients.get() + p_dim.window_size * y;
-            int64_t ymin = y_bound[2 * narrow<size_t>(y)];
-            int64_t ymax = y_bound[2 * narrow<size_t>(y) + 1];
-            auto* Ydata_offset = Ydata + output_width * y;
-            for (size_t x = 0; x < narrow<size_t>(output_width); ++x) {
-              AccumulateType output = is_8bit_v<InputType> ? ConstValue::mag_factor : 0;
-              auto* weight_coeff_start = weight_coeff;
-
-              const auto* Xdata_offset = Xdata + ymin * output_width + x;
-              for (auto idx = ymin; idx < ymax; ++idx) {
-                output += *Xdata_offset * (*weight_coeff_start++);
-                Xdata_offset += output_width;
-              }
-
-              if constexpr (is_8bit_v<InputType>) {
-                *Ydata_offset++ = static_cast<InputType>(clip8_lookups[output >> 22]);
-              } else if constexpr (std::is_same<InputType, int32_t>::value) {
-                *Ydata_offset++ = narrow<int32_t>(std::round(output));
-              } else {  // float double
-                *Ydata_offset++ = output;
-              }
-            }
+            ComputeRowAtLevel2(Xdata, Ydata + output_width * y, narrow<size_t>(y), output_width, p_dim,
+                               clip8_lookups, gsl::make_span(row_buffer));
           }
         });
   }
@@ -9,6 +9,9 @@
 #include "core/framework/utils.h"
 #endif
 #include "core/common/safeint.h"
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 namespace onnxruntime {
 
 struct TensorPitches : TensorShapeVector {
@@ -590,4 +593,16 @@ struct WritableSliceIterator {
   TensorShapeVector indices_;  // There is no index for innermost axis since it's a special case
 };
 
+// Hints the processor to load the cache line of 'address', e.g. the source of a copy a few iterations ahead when the
+// sources are scattered across a large tensor and the hardware prefetcher can't predict them.
+inline void PrefetchForRead(const void* address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+  ORT_UNUSED_PARAMETER(address);
+#endif
+}
+
 }  // namespace onnxruntime
@@ -11,9 +11,12 @@
 #include <locale.h>
 #endif  // _MSC_VER
 
+#include <algorithm>
 #include <codecvt>
+#include <cstring>
 #include <locale>
 #include <functional>
+#include <string_view>
 
 #if defined(__GNUC__)
 // Allow deprecated-declarations warning - std::codecvt_utf8 is deprecatedd
@@ -435,6 +438,36 @@ const std::string default_locale("en_US.UTF-8");  // All non-MS and not Apple
 #endif
 
 #endif  // _MSC_VER
+
+// Whether all the characters of the string are ASCII. The bytes are checked 8 at a time.
+bool IsAscii(std::string_view str) {
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  uint64_t bits = 0;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= str.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, str.data() + i, sizeof(word));
+    bits |= word;
+  }
+  for (; i < str.size(); ++i) {
+    bits |= static_cast<unsigned char>(str[i]);
+  }
+  return (bits & kHighBits) == 0;
+}
+
+// Changes the case of an ASCII string without converting it to wide characters. This is the same as the default
+// locale does, but not as every locale does, e.g. the Turkish locale changes the case of 'i' differently.
+void ChangeAsciiCase(StringNormalizer::CaseAction caseaction, const std::string& src, std::string& dest) {
+  assert(caseaction != StringNormalizer::NONE);
+  dest = src;
+  if (caseaction == StringNormalizer::LOWER) {
+    std::transform(dest.begin(), dest.end(), dest.begin(),
+                   [](char ch) { return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch; });
+  } else {
+    std::transform(dest.begin(), dest.end(), dest.begin(),
+                   [](char ch) { return ch >= 'a' && ch <= 'z' ? static_cast<char>(ch - 'a' + 'A') : ch; });
+  }
+}
 }  // namespace string_normalizer
 
 using namespace string_normalizer;
@@ -538,17 +571,25 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   std::wstring wchar_buffer;
   wchar_buffer.reserve(max_wide_buffer_len);
 
+  // ASCII strings don't need to be converted to wide characters to change their case with the default locale
+  const bool ascii_case_change = locale_name_ == default_locale;
+
   // Output everything and change case as required
   auto output_no_filtering = [&](const TensorShape& output_shape) {
     auto output_tensor = ctx->Output(0, output_shape);
     auto const output_data = output_tensor->MutableData<std::string>();
     for (size_t i = 0, lim = input_span.size(); i < lim; ++i) {
       const std::string& s = input_span[i];
+      auto& dest = output_data[i];
+      if (ascii_case_change && IsAscii(s)) {
+        ChangeAsciiCase(case_change_action_, s, dest);
+        continue;
+      }
+
       wchar_buffer.resize(max_wide_buffer_len);
       ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
       locale.ChangeCase(case_change_action_, wchar_buffer);
 
-      auto& dest = output_data[i];
       size_t utf8_buffer_len = converter.ComputeRequiredSizeToUtf8(wchar_buffer);
       dest.resize(utf8_buffer_len);
       ORT_RETURN_IF_ERROR(converter.ConvertToUtf8(wchar_buffer, dest));
@@ -561,7 +602,9 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
     auto output_data = output_tensor->MutableData<std::string>();
     for (size_t i : filtered_indices) {
       const std::string& s = input_span[i];
-      if (case_change_action_ != NONE) {
+      if (case_change_action_ != NONE && ascii_case_change && IsAscii(s)) {
+        ChangeAsciiCase(case_change_action_, s, *output_data++);
+      } else if (case_change_action_ != NONE) {
         wchar_buffer.resize(max_wide_buffer_len);
         ORT_RETURN_IF_ERROR(converter.ConvertToWideChar(s, wchar_buffer));
         locale.ChangeCase(case_change_action_, wchar_buffer);
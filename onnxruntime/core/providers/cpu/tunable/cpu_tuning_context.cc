@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/tunable/cpu_tuning_context.h"
+
+#include <sstream>
+
+#include "core/common/cpuid_info.h"
+#include "core/framework/tuning_context.h"
+#define TUNING_CONTEXT_IMPL
+#include "core/framework/tuning_context_impl.h"
+#undef TUNING_CONTEXT_IMPL
+#include "core/providers/cpu/cpu_execution_provider.h"
+
+namespace onnxruntime {
+namespace cpu {
+namespace tunable {
+
+std::string CpuTuningResultsValidator::GetCpuIsa() {
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream oss;
+  oss << "AVX=" << cpuid_info.HasAVX() << "|"
+      << "AVX2=" << cpuid_info.HasAVX2() << "|"
+      << "AVX512F=" << cpuid_info.HasAVX512f() << "|"
+      << "AMX_BF16=" << cpuid_info.HasAMX_BF16() << "|"
+      << "NEON_DOT=" << cpuid_info.HasArmNeonDot() << "|"
+      << "NEON_I8MM=" << cpuid_info.HasArmNeon_I8MM() << "|"
+      << "SVE=" << cpuid_info.HasArmSVE() << "|";
+  return oss.str();
+}
+
+Status CpuTuningResultsValidator::ValidateCpuIsa(const std::string& value) {
+  auto current = GetCpuIsa();
+  ORT_RETURN_IF(current != value, "CPU instruction set mismatch: tuning results produced with ", value,
+                ", onnxruntime currently run with ", current);
+  return Status::OK();
+}
+
+CpuTuningResultsValidator::CpuTuningResultsValidator() {
+  RegisterValidator("CPU_ISA", GetCpuIsa, ValidateCpuIsa);
+}
+
+CpuTuningContext::CpuTuningContext(CPUExecutionProvider* ep, TunableOpInfo* info)
+    : ITuningContext(ep), info_(info) {}
+
+void CpuTuningContext::EnableTunableOp() {
+  LOGS_DEFAULT(INFO) << "Enable TunableOp for CPU Execution Provider";
+  info_->enable = true;
+}
+
+void CpuTuningContext::DisableTunableOp() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp for CPU Execution Provider";
+  info_->enable = false;
+}
+
+bool CpuTuningContext::IsTunableOpEnabled() const {
+  return info_->enable;
+}
+
+void CpuTuningContext::EnableTuning() {
+  LOGS_DEFAULT(INFO) << "Enable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = true;
+}
+
+void CpuTuningContext::DisableTuning() {
+  LOGS_DEFAULT(INFO) << "Disable TunableOp tuning for CPU Execution Provider";
+  info_->tuning_enable = false;
+}
+
+bool CpuTuningContext::IsTuningEnabled() const {
+  return info_->tuning_enable;
+}
+
+void CpuTuningContext::SetMaxTuningDurationMs(int max_duration_ms) {
+  info_->max_tuning_duration_ms = max_duration_ms;
+}
+
+int CpuTuningContext::GetMaxTuningDurationMs() const {
+  return info_->max_tuning_duration_ms > 0 ? info_->max_tuning_duration_ms : std::numeric_limits<int>::max();
+}
+
+TuningResultsManager& CpuTuningContext::GetTuningResultsManager() {
+  return manager_;
+}
+
+const TuningResultsManager& CpuTuningContext::GetTuningResultsManager() const {
+  return manager_;
+}
+
+const TuningResultsValidator& CpuTuningContext::GetTuningResultsValidator() const {
+  return validator_;
+}
+
+}  // namespace tunable
+}  // namespace cpu
+}  // namespace onnxruntime
@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "cuda_allocator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/framework/stream_handles.h"
 #include "cuda_common.h"
 #include "gpu_data_transfer.h"
 
@@ -86,6 +91,124 @@ void* CUDAExternalAllocator::Reserve(size_t size) {
   return p;
 }
 
+CUDAMemPoolAllocator::CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold,
+                                           size_t mem_limit)
+    : CUDAAllocator(device_id, name), mem_limit_(mem_limit) {
+  cudaMemPoolProps props{};
+  props.allocType = cudaMemAllocationTypePinned;
+  props.handleTypes = cudaMemHandleTypeNone;
+  props.location.type = cudaMemLocationTypeDevice;
+  props.location.id = device_id;
+  CUDA_CALL_THROW(cudaMemPoolCreate(&pool_, &props));
+
+  // by default the pool releases all its unused memory whenever a stream synchronizes
+  uint64_t threshold = release_threshold == 0 ? std::numeric_limits<uint64_t>::max() : release_threshold;
+  CUDA_CALL_THROW(cudaMemPoolSetAttribute(pool_, cudaMemPoolAttrReleaseThreshold, &threshold));
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&unordered_stream_, cudaStreamNonBlocking));
+
+  stats_.bytes_limit = mem_limit == std::numeric_limits<size_t>::max() ? 0 : static_cast<int64_t>(mem_limit);
+}
+
+CUDAMemPoolAllocator::~CUDAMemPoolAllocator() {
+  // the pool is destroyed once the outstanding allocations and frees complete
+  cudaStreamDestroy(unordered_stream_);
+  cudaMemPoolDestroy(pool_);
+}
+
+void* CUDAMemPoolAllocator::AllocOnCudaStream(size_t size, cudaStream_t stream, bool ordered) {
+  SetDevice(true);
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    ORT_ENFORCE(static_cast<size_t>(stats_.bytes_in_use) + size <= mem_limit_,
+                "Failed to allocate ", size, " bytes from the CUDA memory pool, ", stats_.bytes_in_use,
+                " bytes are in use and the limit is ", mem_limit_);
+    stats_.bytes_in_use += static_cast<int64_t>(size);
+  }
+
+  void* p = nullptr;
+  const auto status = cudaMallocFromPoolAsync(&p, size, pool_, stream);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  if (status != cudaSuccess) {
+    stats_.bytes_in_use -= static_cast<int64_t>(size);
+    CUDA_CALL_THROW(status);
+  }
+  allocations_[p] = Allocation{size, ordered ? stream : nullptr};
+  stats_.num_allocs += 1;
+  stats_.total_allocated_bytes += static_cast<int64_t>(size);
+  stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
+  stats_.max_alloc_size = std::max(stats_.max_alloc_size, static_cast<int64_t>(size));
+  return p;
+}
+
+void* CUDAMemPoolAllocator::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  // Allocations which aren't ordered on a stream are usable on any stream once the allocation completed. They are
+  // made on a stream of the allocator, so that waiting for them doesn't wait for the kernels of other streams.
+  void* p = AllocOnCudaStream(size, unordered_stream_, false);
+  CUDA_CALL_THROW(cudaStreamSynchronize(unordered_stream_));
+  return p;
+}
+
+void* CUDAMemPoolAllocator::AllocWithStream(size_t size, Stream* stream) {
+  if (stream == nullptr || stream->GetHandle() == nullptr || stream->GetDevice().Type() != OrtDevice::GPU) {
+    return Alloc(size);
+  }
+
+  return size == 0 ? nullptr : AllocOnCudaStream(size, static_cast<cudaStream_t>(stream->GetHandle()), true);
+}
+
+void CUDAMemPoolAllocator::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  Allocation allocation{};
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    auto it = allocations_.find(p);
+    ORT_ENFORCE(it != allocations_.end(), "Freeing a pointer which wasn't allocated by the CUDA memory pool");
+    allocation = it->second;
+    allocations_.erase(it);
+    stats_.bytes_in_use -= static_cast<int64_t>(allocation.size);
+  }
+
+  // An allocation ordered on a stream is freed on it, the other streams using it having been synchronized with it
+  // by the execution plan as for the allocations of the arena. An allocation which isn't ordered on a stream may be
+  // in use on any stream, so the device is synchronized before freeing it, as cudaFree does. Do not throw, as freeing
+  // may fail during shutdown.
+  SetDevice(false);
+  if (allocation.stream != nullptr) {
+    cudaFreeAsync(p, allocation.stream);
+  } else if (cudaDeviceSynchronize() == cudaSuccess) {
+    cudaFreeAsync(p, unordered_stream_);
+  }
+}
+
+void CUDAMemPoolAllocator::ReleaseStream(Stream* stream) {
+  if (stream == nullptr || stream->GetHandle() == nullptr) {
+    return;
+  }
+
+  // The stream may be destroyed before the allocations ordered on it, e.g. the outputs of a run, are freed. They are
+  // freed as the allocations which aren't ordered on a stream from then on.
+  const auto cuda_stream = static_cast<cudaStream_t>(stream->GetHandle());
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (auto& entry : allocations_) {
+    if (entry.second.stream == cuda_stream) {
+      entry.second.stream = nullptr;
+    }
+  }
+}
+
+void CUDAMemPoolAllocator::GetStats(AllocatorStats* stats) {
+  std::lock_guard<OrtMutex> lock(lock_);
+  *stats = stats_;
+}
+
 void* CUDAPinnedAllocator::Alloc(size_t size) {
   void* p = nullptr;
   if (size > 0) {
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <cuda_runtime_api.h>
+
 #include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/platform/ort_mutex.h"
@@ -19,7 +21,7 @@ class CUDAAllocator : public IAllocator {
   void* Alloc(size_t size) override;
   void Free(void* p) override;
 
- private:
+ protected:
   void CheckDevice(bool throw_when_fail) const;
   void SetDevice(bool throw_when_fail) const;
 };
@@ -49,6 +51,45 @@ class CUDAExternalAllocator : public CUDAAllocator {
   InlinedHashSet<void*> reserved_;
 };
 
+// Allocates from a stream-ordered CUDA memory pool (cudaMallocFromPoolAsync) instead of an arena. The allocations made
+// on a stream are freed on that stream with cudaFreeAsync, so the pool reuses the memory of each stream without host
+// synchronization and without the bookkeeping and fragmentation of an arena.
+class CUDAMemPoolAllocator : public CUDAAllocator {
+ public:
+  // release_threshold is the amount of reserved memory the pool keeps when the streams synchronize, 0 keeps all of it.
+  // mem_limit limits the amount of memory in use.
+  CUDAMemPoolAllocator(OrtDevice::DeviceId device_id, const char* name, size_t release_threshold, size_t mem_limit);
+  ~CUDAMemPoolAllocator() override;
+
+  void* Alloc(size_t size) override;
+  void Free(void* p) override;
+
+  bool IsStreamAware() const override { return true; }
+  void* AllocWithStream(size_t size, Stream* stream) override;
+  void ReleaseStream(Stream* stream) override;
+
+  void GetStats(AllocatorStats* stats) override;
+
+ private:
+  // The allocation is ordered on stream if ordered is true, else it is usable on any stream once it completed.
+  void* AllocOnCudaStream(size_t size, cudaStream_t stream, bool ordered);
+
+  struct Allocation {
+    size_t size;
+    // nullptr if the allocation isn't ordered on a stream
+    cudaStream_t stream;
+  };
+
+  cudaMemPool_t pool_{};
+  // the stream of the allocations and frees which aren't ordered on a stream of the EP
+  cudaStream_t unordered_stream_{};
+  const size_t mem_limit_;
+
+  OrtMutex lock_;
+  InlinedHashMap<void*, Allocation> allocations_;
+  AllocatorStats stats_;
+};
+
 // TODO: add a default constructor
 class CUDAPinnedAllocator : public IAllocator {
  public:
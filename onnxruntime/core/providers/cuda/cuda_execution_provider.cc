@@ -240,6 +240,33 @@ Status CUDAExecutionProvider::PerThreadContext::ReplayGraph(CudaGraphAnnotation_
   return cuda_graph_.Replay(graph_annotation_id);
 }
 
+void CUDAExecutionProvider::PerThreadContext::ReleaseGraph(CudaGraphAnnotation_t cuda_graph_annotation_id) {
+  cuda_graph_.Release(cuda_graph_annotation_id);
+  graph_id_to_run_count_.erase(cuda_graph_annotation_id);
+}
+
+void CUDAExecutionProvider::PerThreadContext::AddPendingReleasedGraph(
+    CudaGraphAnnotation_t cuda_graph_annotation_id) {
+  pending_released_graphs_.insert(cuda_graph_annotation_id);
+  has_pending_released_graphs_.store(true, std::memory_order_release);
+}
+
+void CUDAExecutionProvider::PerThreadContext::ReleasePendingGraphs(OrtMutex& context_state_mutex) {
+  if (!has_pending_released_graphs_.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  std::unordered_set<CudaGraphAnnotation_t> released_graphs;
+  {
+    std::lock_guard<OrtMutex> lock(context_state_mutex);
+    released_graphs.swap(pending_released_graphs_);
+    has_pending_released_graphs_.store(false, std::memory_order_relaxed);
+  }
+  for (const CudaGraphAnnotation_t cuda_graph_annotation_id : released_graphs) {
+    ReleaseGraph(cuda_graph_annotation_id);
+  }
+}
+
 void CUDAExecutionProvider::PerThreadContext::IncrementRegularRunCountBeforeGraphCapture(
     CudaGraphAnnotation_t cuda_graph_annotation_id) {
   if (graph_id_to_run_count_.find(cuda_graph_annotation_id) == graph_id_to_run_count_.end()) {
@@ -421,6 +448,7 @@ Status CUDAExecutionProvider::Sync() const {
 Status CUDAExecutionProvider::OnRunStart(const onnxruntime::RunOptions& run_options) {
   // always set CUDA device when session::Run() in case it runs in a worker thread
   CUDA_RETURN_IF_ERROR(cudaSetDevice(GetDeviceId()));
+  GetPerThreadContext().ReleasePendingGraphs(context_state_.mutex);
   CudaGraphAnnotation_t cuda_graph_annotation_id = GetPerThreadContext().GetCudaGraphAnnotationId(run_options);
   if (IsGraphCaptureEnabled() && !GetPerThreadContext().IsGraphCaptured(cuda_graph_annotation_id) &&
       GetPerThreadContext().IsGraphCaptureAllowed(cuda_graph_annotation_id)) {
@@ -469,13 +497,30 @@ bool CUDAExecutionProvider::IsGraphCaptureEnabled() const {
 }
 
 bool CUDAExecutionProvider::IsGraphCaptured(int graph_annotation_id) const {
-  return GetPerThreadContext().IsGraphCaptured(graph_annotation_id);
+  auto& context = GetPerThreadContext();
+  context.ReleasePendingGraphs(context_state_.mutex);
+  return context.IsGraphCaptured(graph_annotation_id);
 }
 
 Status CUDAExecutionProvider::ReplayGraph(int graph_annotation_id) {
   return GetPerThreadContext().ReplayGraph(graph_annotation_id);
 }
 
+Status CUDAExecutionProvider::ReleaseGraph(int graph_annotation_id) {
+  // every thread running the session captures graphs in its own context
+  {
+    std::lock_guard<OrtMutex> lock(context_state_.mutex);
+    for (const auto& context : context_state_.active_contexts) {
+      context->AddPendingReleasedGraph(graph_annotation_id);
+    }
+    for (const auto& context : context_state_.retired_context_pool) {
+      context->AddPendingReleasedGraph(graph_annotation_id);
+    }
+  }
+  GetPerThreadContext().ReleasePendingGraphs(context_state_.mutex);
+  return Status::OK();
+}
+
 namespace cuda {
 // opset 1 to 9
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kCudaExecutionProvider, kOnnxDomain, 1, MemcpyFromHost);
@@ -2625,6 +2670,22 @@ std::vector<AllocatorPtr> CUDAExecutionProvider::CreatePreferredAllocators() {
       // correct to use the GPU device id, unless we wanted to share the pinned memory allocator across devices,
       // at the risk the lifetime isn't managed correctly if one of those devices go away.
       0);
+
+  // The memory pool is not used with CUDA graphs, whose replays require the addresses of the captured allocations.
+  if (info_.use_cuda_mempool && !info_.enable_cuda_graph && !info_.external_allocator_info.UseExternalAllocator()) {
+    AllocatorCreationInfo mempool_memory_info(
+        [release_threshold = info_.cuda_mempool_release_threshold,
+         mem_limit = info_.gpu_mem_limit](OrtDevice::DeviceId id) {
+          return std::make_unique<CUDAMemPoolAllocator>(id, CUDA, release_threshold, mem_limit);
+        },
+        info_.device_id,
+        false);
+    return std::vector<AllocatorPtr>{
+        CreateAllocator(mempool_memory_info),
+        CreateAllocator(pinned_memory_info),
+    };
+  }
+
   return std::vector<AllocatorPtr>{
       CreateCudaAllocator(info_.device_id, info_.gpu_mem_limit, info_.arena_extend_strategy,
                           info_.external_allocator_info, info_.default_memory_arena_cfg),
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <atomic>
 #include <set>
+#include <unordered_set>
 #include <vector>
 
 #include "core/framework/arena_extend_strategy.h"
@@ -107,6 +109,7 @@ class CUDAExecutionProvider : public IExecutionProvider {
   bool IsGraphCaptureEnabled() const override;
   bool IsGraphCaptured(CudaGraphAnnotation_t graph_annotation_id) const override;
   Status ReplayGraph(CudaGraphAnnotation_t graph_annotation_id) override;
+  Status ReleaseGraph(CudaGraphAnnotation_t graph_annotation_id) override;
   void RegisterStreamHandlers(IStreamCommandHandleRegistry& stream_handle_registry, AllocatorMap& allocators) const override;
   OrtDevice GetOrtDeviceByMemType(OrtMemType mem_type) const override;
   std::vector<AllocatorPtr> CreatePreferredAllocators() override;
@@ -193,8 +196,14 @@ class CUDAExecutionProvider : public IExecutionProvider {
     bool IsGraphCaptured(CudaGraphAnnotation_t cuda_graph_annotation_id) const;
     CudaGraphAnnotation_t GetCudaGraphAnnotationId(const onnxruntime::RunOptions& run_options) const;
     Status ReplayGraph(CudaGraphAnnotation_t cuda_graph_annotation_id);
+    void ReleaseGraph(CudaGraphAnnotation_t cuda_graph_annotation_id);
     void IncrementRegularRunCountBeforeGraphCapture(CudaGraphAnnotation_t cuda_graph_annotation_id);
 
+    // A graph released by another thread is released by the thread using this context the next time it runs, as
+    // the context is only used by one thread at a time. Both are called with the mutex of PerThreadContextState.
+    void AddPendingReleasedGraph(CudaGraphAnnotation_t cuda_graph_annotation_id);
+    void ReleasePendingGraphs(OrtMutex& context_state_mutex);
+
    private:
     cublasHandle_t cublas_handle_ = nullptr;
     cudnnHandle_t cudnn_handle_ = nullptr;
@@ -214,6 +223,9 @@ class CUDAExecutionProvider : public IExecutionProvider {
     CUDAGraph cuda_graph_;
     // Map of graph id to regular_run_count_before_graph_capture
     std::unordered_map<CudaGraphAnnotation_t, int> graph_id_to_run_count_;
+    // graphs to release before the next run, guarded by the mutex of PerThreadContextState
+    std::unordered_set<CudaGraphAnnotation_t> pending_released_graphs_;
+    std::atomic<bool> has_pending_released_graphs_{false};
 
     // There is chance that the second regular run allocates GPU memory for causes like:
     // (1) memory pattern is enabled. (2) arena allocation for stream.
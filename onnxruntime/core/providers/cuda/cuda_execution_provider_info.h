@@ -82,6 +82,10 @@ struct CUDAExecutionProviderInfo {
 
   int sdpa_kernel{0};
 
+  // Allocate the device memory from a stream-ordered CUDA memory pool (cudaMallocAsync) instead of the arena.
+  bool use_cuda_mempool{false};
+  size_t cuda_mempool_release_threshold{0};
+
   static CUDAExecutionProviderInfo FromProviderOptions(const ProviderOptions& options);
   static ProviderOptions ToProviderOptions(const CUDAExecutionProviderInfo& info);
   static ProviderOptions ToProviderOptions(const OrtCUDAProviderOptionsV2& info);
@@ -115,6 +119,8 @@ struct std::hash<::onnxruntime::CUDAExecutionProviderInfo> {
     onnxruntime::HashCombine(info.gpu_mem_limit, value);
     onnxruntime::HashCombine(info.tunable_op.max_tuning_duration_ms, value);
     onnxruntime::HashCombine(info.sdpa_kernel, value);
+    onnxruntime::HashCombine(info.use_cuda_mempool, value);
+    onnxruntime::HashCombine(info.cuda_mempool_release_threshold, value);
 
     // Memory pointers
     onnxruntime::HashCombine(reinterpret_cast<size_t>(info.user_compute_stream), value);
@@ -3,10 +3,103 @@
 
 #include "core/providers/shared_library/provider_api.h"
 
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include "core/providers/cuda/gpu_data_transfer.h"
 #include "cuda_common.h"
 
 namespace onnxruntime {
+// Uploads pageable host memory to the GPU through a ring of pinned staging buffers. Consecutive uploads are packed
+// in the same staging buffer, so that a batch of small tensors only waits for a staging buffer to be free once per
+// kStagingBufferSize bytes instead of once per tensor. The staging buffers, stream and events of a device are created
+// once and reused by the following batches.
+class StagedHostToDeviceCopier {
+ public:
+  static Status Create(int device_id, std::unique_ptr<StagedHostToDeviceCopier>& copier) {
+    copier.reset(new StagedHostToDeviceCopier());
+    CUDA_RETURN_IF_ERROR(cudaSetDevice(device_id));
+    CUDA_RETURN_IF_ERROR(cudaStreamCreateWithFlags(&copier->stream_, cudaStreamNonBlocking));
+    for (size_t i = 0; i < kNumStagingBuffers; ++i) {
+      CUDA_RETURN_IF_ERROR(cudaHostAlloc(&copier->buffers_[i], kStagingBufferSize, cudaHostAllocDefault));
+      CUDA_RETURN_IF_ERROR(cudaEventCreateWithFlags(&copier->events_[i], cudaEventDisableTiming));
+    }
+    return Status::OK();
+  }
+
+  ~StagedHostToDeviceCopier() {
+    if (stream_ != nullptr) {
+      ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaStreamSynchronize(stream_)));
+    }
+    for (size_t i = 0; i < kNumStagingBuffers; ++i) {
+      if (events_[i] != nullptr) {
+        ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaEventDestroy(events_[i])));
+      }
+      if (buffers_[i] != nullptr) {
+        ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaFreeHost(buffers_[i])));
+      }
+    }
+    if (stream_ != nullptr) {
+      ORT_IGNORE_RETURN_VALUE(CUDA_CALL(cudaStreamDestroy(stream_)));
+    }
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(StagedHostToDeviceCopier);
+
+  // Enqueues the upload of `bytes` from `src` to `dst`. `src` may be reused once this returns.
+  Status Copy(void* dst, const void* src, size_t bytes) {
+    for (size_t offset = 0; offset < bytes;) {
+      if (buffer_offset_ == kStagingBufferSize) {
+        ORT_RETURN_IF_ERROR(NextBuffer());
+      }
+
+      const size_t chunk_size = std::min(kStagingBufferSize - buffer_offset_, bytes - offset);
+      char* staging = static_cast<char*>(buffers_[next_buffer_]) + buffer_offset_;
+      memcpy(staging, static_cast<const char*>(src) + offset, chunk_size);
+      CUDA_RETURN_IF_ERROR(cudaMemcpyAsync(static_cast<char*>(dst) + offset, staging, chunk_size,
+                                           cudaMemcpyHostToDevice, stream_));
+      offset += chunk_size;
+      buffer_offset_ += chunk_size;
+    }
+
+    // keep the next upload aligned in the staging buffer
+    buffer_offset_ = std::min((buffer_offset_ + kStagingAlignment - 1) / kStagingAlignment * kStagingAlignment,
+                              kStagingBufferSize);
+    return Status::OK();
+  }
+
+  // Waits for all enqueued uploads, after which the staging buffers are free for the next batch.
+  Status Flush() {
+    next_buffer_ = 0;
+    buffer_offset_ = 0;
+    return CUDA_CALL(cudaStreamSynchronize(stream_));
+  }
+
+ private:
+  static constexpr size_t kNumStagingBuffers = 4;
+  static constexpr size_t kStagingBufferSize = size_t{16} * 1024 * 1024;
+  static constexpr size_t kStagingAlignment = 256;
+
+  StagedHostToDeviceCopier() = default;
+
+  // Marks the end of the uploads from the current staging buffer and waits until the uploads enqueued from the next
+  // one have completed.
+  Status NextBuffer() {
+    CUDA_RETURN_IF_ERROR(cudaEventRecord(events_[next_buffer_], stream_));
+    next_buffer_ = (next_buffer_ + 1) % kNumStagingBuffers;
+    CUDA_RETURN_IF_ERROR(cudaEventSynchronize(events_[next_buffer_]));
+    buffer_offset_ = 0;
+    return Status::OK();
+  }
+
+  cudaStream_t stream_ = nullptr;
+  std::array<void*, kNumStagingBuffers> buffers_{};
+  std::array<cudaEvent_t, kNumStagingBuffers> events_{};
+  size_t next_buffer_ = 0;
+  size_t buffer_offset_ = 0;
+};
+
 GPUDataTransfer::GPUDataTransfer() {}
 
 GPUDataTransfer::~GPUDataTransfer() {}
@@ -83,4 +176,70 @@ common::Status GPUDataTransfer::CopyTensorAsync(const Tensor& src, Tensor& dst,
   return Status::OK();
 }
 
+common::Status GPUDataTransfer::CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const {
+  int prev_device_id = 0;
+  CUDA_RETURN_IF_ERROR(cudaGetDevice(&prev_device_id));
+
+  // the staging buffers of a device are shared by the concurrent batches
+  std::lock_guard<OrtMutex> lock(staging_copiers_mutex_);
+  std::vector<StagedHostToDeviceCopier*> used_copiers;
+  bool sync_default_stream = false;
+  Status status;
+  for (const auto& pair : src_dst_pairs) {
+    const Tensor& src = pair.src;
+    Tensor& dst = pair.dst;
+    const auto& src_device = src.Location().device;
+    const auto& dst_device = dst.Location().device;
+
+    if (pair.src_stream == nullptr && src_device.Type() == OrtDevice::CPU &&
+        src_device.MemType() == OrtDevice::MemType::DEFAULT && dst_device.Type() == OrtDevice::GPU) {
+      auto& copier = staging_copiers_[dst_device.Id()];
+      if (copier == nullptr) {
+        status = StagedHostToDeviceCopier::Create(dst_device.Id(), copier);
+        if (!status.IsOK()) {
+          copier.reset();
+          break;
+        }
+      }
+      if (std::find(used_copiers.begin(), used_copiers.end(), copier.get()) == used_copiers.end()) {
+        used_copiers.push_back(copier.get());
+      }
+      status = copier->Copy(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+    } else if (pair.src_stream == nullptr && src_device.Type() == OrtDevice::GPU) {
+      // copies from the GPU are enqueued on the default stream, which is synchronized once for the whole batch
+      // instead of after each copy as CopyTensor does
+      if (dst.MutableDataRaw() != src.DataRaw()) {
+        status = CUDA_CALL(cudaMemcpyAsync(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes(),
+                                           dst_device.Type() == OrtDevice::GPU ? cudaMemcpyDeviceToDevice
+                                                                               : cudaMemcpyDeviceToHost,
+                                           nullptr));
+        sync_default_stream = true;
+      }
+    } else {
+      status = pair.src_stream ? CopyTensorAsync(src, dst, *pair.src_stream) : CopyTensor(src, dst);
+    }
+
+    if (!status.IsOK()) {
+      break;
+    }
+  }
+
+  Status flush_status;
+  for (StagedHostToDeviceCopier* copier : used_copiers) {
+    Status copier_status = copier->Flush();
+    if (flush_status.IsOK()) {
+      flush_status = copier_status;
+    }
+  }
+  if (sync_default_stream) {
+    Status sync_status = CUDA_CALL(cudaStreamSynchronize(nullptr));
+    if (flush_status.IsOK()) {
+      flush_status = sync_status;
+    }
+  }
+  CUDA_RETURN_IF_ERROR(cudaSetDevice(prev_device_id));
+  ORT_RETURN_IF_ERROR(status);
+  return flush_status;
+}
+
 }  // namespace onnxruntime
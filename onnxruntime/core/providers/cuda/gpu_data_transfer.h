@@ -3,11 +3,17 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+
 #include "cuda_pch.h"
 #include "core/framework/data_transfer.h"
+#include "core/platform/ort_mutex.h"
 
 namespace onnxruntime {
 
+class StagedHostToDeviceCopier;
+
 class GPUDataTransfer : public IDataTransfer {
  public:
   GPUDataTransfer();
@@ -19,6 +25,16 @@ class GPUDataTransfer : public IDataTransfer {
   using IDataTransfer::CopyTensor;
   common::Status CopyTensor(const Tensor& src, Tensor& dst) const override;
   common::Status CopyTensorAsync(const Tensor& src, Tensor& dst, Stream& stream) const override;
+
+  // Copies from pageable host memory to the GPU are uploaded through a ring of pinned staging buffers on a dedicated
+  // stream, so that filling the next staging buffer overlaps with the upload of the previous one. Returns once all
+  // copies have completed. The staging buffers of a device are allocated by the first batch and kept until this is
+  // destroyed.
+  common::Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const override;
+
+ private:
+  mutable OrtMutex staging_copiers_mutex_;
+  mutable std::unordered_map<int, std::unique_ptr<StagedHostToDeviceCopier>> staging_copiers_;
 };
 
 }  // namespace onnxruntime
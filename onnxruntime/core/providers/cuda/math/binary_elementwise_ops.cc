@@ -85,14 +85,19 @@ Status BinaryElementwise<ShouldBroadcast>::Prepare(OpKernelContext* context, Bin
   return Status::OK();
 }
 
-#define BINARY_ELEMENTWISE_REGISTER_KERNEL_TYPED_V(x, class_name, ver, T)                  \
-  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                           \
-      x,                                                                                   \
-      kOnnxDomain,                                                                         \
-      ver,                                                                                 \
-      T,                                                                                   \
-      kCudaExecutionProvider,                                                              \
-      (*KernelDefBuilder::Create()).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+// each output element only depends on the input elements at the same position or on a broadcast input, so the output
+// may reuse an input of the same size
+#define BINARY_ELEMENTWISE_REGISTER_KERNEL_TYPED_V(x, class_name, ver, T) \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                          \
+      x,                                                                  \
+      kOnnxDomain,                                                        \
+      ver,                                                                \
+      T,                                                                  \
+      kCudaExecutionProvider,                                             \
+      (*KernelDefBuilder::Create())                                       \
+          .MayInplace(0, 0)                                               \
+          .MayInplace(1, 0)                                               \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),         \
       class_name<T>);
 
 #define BINARY_ELEMENTWISE_REGISTER_KERNEL_TYPED(x, ver, T) \
@@ -128,15 +133,18 @@ Status BinaryElementwise<ShouldBroadcast>::Prepare(OpKernelContext* context, Bin
       (*KernelDefBuilder::Create()).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()).TypeConstraint("T1", DataTypeImpl::GetTensorType<bool>()), \
       x<T>);
 
-#define BINARY_ELEMENTWISE_REGISTER_KERNEL_VERSIONED_TYPED(x, startver, endver, T)         \
-  ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(                                                 \
-      x,                                                                                   \
-      kOnnxDomain,                                                                         \
-      startver,                                                                            \
-      endver,                                                                              \
-      T,                                                                                   \
-      kCudaExecutionProvider,                                                              \
-      (*KernelDefBuilder::Create()).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+#define BINARY_ELEMENTWISE_REGISTER_KERNEL_VERSIONED_TYPED(x, startver, endver, T) \
+  ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(                                         \
+      x,                                                                           \
+      kOnnxDomain,                                                                 \
+      startver,                                                                    \
+      endver,                                                                      \
+      T,                                                                           \
+      kCudaExecutionProvider,                                                      \
+      (*KernelDefBuilder::Create())                                                \
+          .MayInplace(0, 0)                                                        \
+          .MayInplace(1, 0)                                                        \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),                  \
       x<T>);
 
 #define BINARY_ELEMENTWISE_REGISTER_KERNEL_VERSIONED_TYPED_CLASS(x, class_name, startver, endver, T) \
@@ -147,7 +155,10 @@ Status BinaryElementwise<ShouldBroadcast>::Prepare(OpKernelContext* context, Bin
       endver,                                                                                        \
       T,                                                                                             \
       kCudaExecutionProvider,                                                                        \
-      (*KernelDefBuilder::Create()).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),           \
+      (*KernelDefBuilder::Create())                                                                  \
+          .MayInplace(0, 0)                                                                          \
+          .MayInplace(1, 0)                                                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()),                                    \
       class_name<T>);
 
 #define BINARY_ELEMENTWISE_COMPUTE(x, T)                                                                \
@@ -7,6 +7,7 @@
 #include "core/providers/cuda/cudnn_common.h"
 #include "core/providers/cuda/shared_inc/accumulation_type.h"
 #include "core/providers/cuda/tensor/transpose.h"
+#include "core/providers/cuda/tunable/math/softmax.h"
 
 namespace onnxruntime {
 namespace cuda {
@@ -176,16 +177,10 @@ Status Softmax<T>::ComputeInternal(OpKernelContext* ctx) const {
     compute_input_shape = &input_shape;
   }
 
-  Status status;
-  if (log_softmax_) {
-    status = SoftMaxComputeHelper<T, T, true>(ctx->GetComputeStream(), X_data, *compute_input_shape, Y_data,
-                                              is_transpose_required ? static_cast<int64_t>(rank) - 1
-                                                                    : static_cast<int64_t>(axis));
-  } else {
-    status = SoftMaxComputeHelper<T, T, false>(ctx->GetComputeStream(), X_data, *compute_input_shape, Y_data,
-                                               is_transpose_required ? static_cast<int64_t>(rank) - 1
-                                                                     : static_cast<int64_t>(axis));
-  }
+  const int64_t compute_axis = is_transpose_required ? static_cast<int64_t>(rank) - 1 : static_cast<int64_t>(axis);
+  Status status = tunable::TunableSoftmax<T>(GetTuningContext(), ctx->GetComputeStream(), X_data, Y_data,
+                                             compute_input_shape->SizeToDimension(compute_axis),
+                                             compute_input_shape->SizeFromDimension(compute_axis), log_softmax_);
 
   if (!status.IsOK())
     return status;
@@ -13,25 +13,26 @@ Status UnaryElementwise::Prepare(OpKernelContext* context, UnaryElementwisePrepa
   return Status::OK();
 }
 
-#define UNARY_ELEMENTWISE_REGISTER_VERSIONED_KERNEL(x, startver, endver, T)                \
-  ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(                                                 \
-      x,                                                                                   \
-      kOnnxDomain,                                                                         \
-      startver,                                                                            \
-      endver,                                                                              \
-      T,                                                                                   \
-      kCudaExecutionProvider,                                                              \
-      (*KernelDefBuilder::Create()).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+// each output element only depends on the input element at the same position, so the output may reuse the input
+#define UNARY_ELEMENTWISE_REGISTER_VERSIONED_KERNEL(x, startver, endver, T)                                 \
+  ONNX_OPERATOR_VERSIONED_TYPED_KERNEL_EX(                                                                  \
+      x,                                                                                                    \
+      kOnnxDomain,                                                                                          \
+      startver,                                                                                             \
+      endver,                                                                                               \
+      T,                                                                                                    \
+      kCudaExecutionProvider,                                                                               \
+      (*KernelDefBuilder::Create()).MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       x<T>);
 
-#define UNARY_ELEMENTWISE_REGISTER_KERNEL(x, ver, T)                                       \
-  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                           \
-      x,                                                                                   \
-      kOnnxDomain,                                                                         \
-      ver,                                                                                 \
-      T,                                                                                   \
-      kCudaExecutionProvider,                                                              \
-      (*KernelDefBuilder::Create()).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+#define UNARY_ELEMENTWISE_REGISTER_KERNEL(x, ver, T)                                                        \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                                                            \
+      x,                                                                                                    \
+      kOnnxDomain,                                                                                          \
+      ver,                                                                                                  \
+      T,                                                                                                    \
+      kCudaExecutionProvider,                                                                               \
+      (*KernelDefBuilder::Create()).MayInplace(0, 0).TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
       x<T>);
 
 #define UNARY_ELEMENTWISE_LOGICALOP_REGISTER_KERNEL_TYPED(x, ver, T)  \
@@ -116,6 +116,7 @@ Status Conv<T, Layout>::CreateCudnnFeExecutionPlan(const onnxruntime::TensorShap
                                                    const bool use_tf32) const {
   s_.bias_fused = fuse_bias;
   s_.act_fused = fuse_act;
+  s_.z_is_y = false;
   s_.variant_pack.clear();  // clear variant pack, as stored pointers to tensors change
   s_.cudnn_fe_graph = std::make_unique<cudnn_frontend::graph::Graph>();
   cudnn_frontend::DataType_t data_type = CudnnFeTensor::GetDataType<CudaT>();
@@ -154,7 +155,7 @@ Status Conv<T, Layout>::CreateCudnnFeExecutionPlan(const onnxruntime::TensorShap
       cudnn_fe_z_tensor = CudnnFeTensor(z_shape, "z", data_type, Layout == LAYOUT_NHWC).Get();
     } else if (fuse_bias && Layout == LAYOUT_NCHW) {
       // Z is required for NCHW precompiled kernels in cuDNN
-      s_.z_data = s_.y_data;
+      s_.z_is_y = true;
       cudnn_fe_z_tensor = cudnn_fe_y_tensor;
     }
 
@@ -435,14 +436,39 @@ Status Conv<T, Layout>::UpdateState(OpKernelContext* context, bool bias_expected
     const auto fuse_bias = cuda_ep->IsFuseConvBias() || is_fused_node_;
     const auto fuse_act = is_fused_node_;
 
-    ORT_RETURN_IF_ERROR(CreateCudnnFeExecutionPlan(x_dims_cudnn, w_dims_cudnn, B, Z, y_dims_cudnn, handle, heur_mode,
-                                                   std::vector<int64_t>(pads.begin(),
-                                                                        pads.end()),
-                                                   std::vector<int64_t>(strides.begin(),
-                                                                        strides.end()),
-                                                   std::vector<int64_t>(dilations.begin(),
-                                                                        dilations.end()),
-                                                   bias_expected, fuse_bias, fuse_act, w_in_nhwc, use_tf32));
+    // everything else the graph depends on is fixed for the node
+    TensorShapeVector graph_key{x_dims.begin(), x_dims.end()};
+    graph_key.insert(graph_key.end(), w_dims.begin(), w_dims.end());
+    if (s_.cached_cudnn_fe_graphs.contains(graph_key)) {
+      const auto& entry = s_.cached_cudnn_fe_graphs.at(graph_key);
+      s_.cudnn_fe_graph = entry.graph;
+      s_.cudnn_fe_X = entry.X;
+      s_.cudnn_fe_W = entry.W;
+      s_.cudnn_fe_Z = entry.Z;
+      s_.cudnn_fe_B = entry.B;
+      s_.cudnn_fe_Y = entry.Y;
+      s_.bias_fused = entry.bias_fused;
+      s_.act_fused = entry.act_fused;
+      s_.z_is_y = entry.z_is_y;
+      s_.workspace_bytes = entry.workspace_bytes;
+      s_.variant_pack.clear();
+    } else {
+      ORT_RETURN_IF_ERROR(CreateCudnnFeExecutionPlan(x_dims_cudnn, w_dims_cudnn, B, Z, y_dims_cudnn, handle,
+                                                     heur_mode,
+                                                     std::vector<int64_t>(pads.begin(),
+                                                                          pads.end()),
+                                                     std::vector<int64_t>(strides.begin(),
+                                                                          strides.end()),
+                                                     std::vector<int64_t>(dilations.begin(),
+                                                                          dilations.end()),
+                                                     bias_expected, fuse_bias, fuse_act, w_in_nhwc, use_tf32));
+
+      if (s_.bias_fused || (B == nullptr && Z == nullptr)) {
+        s_.cached_cudnn_fe_graphs.insert(graph_key, {s_.cudnn_fe_graph, s_.cudnn_fe_X, s_.cudnn_fe_W, s_.cudnn_fe_Z,
+                                                     s_.cudnn_fe_B, s_.cudnn_fe_Y, s_.bias_fused, s_.act_fused,
+                                                     s_.z_is_y, s_.workspace_bytes});
+      }
+    }
 #endif
   } else {
     // set Y
@@ -471,6 +497,9 @@ Status Conv<T, Layout>::ComputeInternal(OpKernelContext* context) const {
   if (s_.bias_fused && s_.b_data != nullptr) {
     s_.variant_pack.insert_or_assign(s_.cudnn_fe_B, const_cast<void*>(s_.b_data));
   }
+  if (s_.z_is_y) {
+    s_.z_data = s_.y_data;
+  }
   if (s_.bias_fused && s_.z_data != nullptr) {
     s_.variant_pack.insert_or_assign(s_.cudnn_fe_Z, const_cast<void*>(s_.z_data));
     if (Layout == LAYOUT_NCHW && s_.z_data == s_.y_data) {
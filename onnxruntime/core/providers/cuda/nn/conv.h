@@ -130,6 +130,8 @@ class lru_unordered_map {
 
 // cached cudnn descriptors
 constexpr size_t MAX_CACHED_ALGO_PERF_RESULTS = 10000;
+// cached cudnn frontend graphs, which hold their built execution plans
+constexpr size_t MAX_CACHED_CUDNN_FE_GRAPHS = 32;
 
 template <typename AlgoPerfType>
 struct CudnnConvState {
@@ -158,9 +160,11 @@ struct CudnnConvState {
   CudnnConvolutionDescriptor conv_desc;
   bool bias_fused = true;
   bool act_fused = true;
+  // the fused graph adds y as z, which cuDNN requires for NCHW precompiled kernels
+  bool z_is_y = false;
 
 #if !defined(__CUDACC__)
-  std::unique_ptr<cudnn_frontend::graph::Graph> cudnn_fe_graph;
+  std::shared_ptr<cudnn_frontend::graph::Graph> cudnn_fe_graph;
   std::unique_ptr<cudnn_frontend::graph::Graph> cudnn_fe_bias_graph;
   std::shared_ptr<cudnn_frontend::graph::Tensor_attributes> cudnn_fe_X;
   std::shared_ptr<cudnn_frontend::graph::Tensor_attributes> cudnn_fe_W;
@@ -173,6 +177,25 @@ struct CudnnConvState {
 
   std::unordered_map<std::shared_ptr<cudnn_frontend::graph::Tensor_attributes>, void*> variant_pack;
   std::unordered_map<std::shared_ptr<cudnn_frontend::graph::Tensor_attributes>, void*> variant_pack_bias;
+
+  // a graph built for the x and w dims of its key, so that returning to dims seen before, e.g. with alternating
+  // batch sizes, does not build the graph and its execution plans again.
+  // only graphs that need no separate bias or z addition are cached, as those need the cudnn tensor descriptors.
+  struct CudnnFeGraphCacheEntry {
+    std::shared_ptr<cudnn_frontend::graph::Graph> graph;
+    std::shared_ptr<cudnn_frontend::graph::Tensor_attributes> X;
+    std::shared_ptr<cudnn_frontend::graph::Tensor_attributes> W;
+    std::shared_ptr<cudnn_frontend::graph::Tensor_attributes> Z;
+    std::shared_ptr<cudnn_frontend::graph::Tensor_attributes> B;
+    std::shared_ptr<cudnn_frontend::graph::Tensor_attributes> Y;
+    bool bias_fused;
+    bool act_fused;
+    bool z_is_y;
+    size_t workspace_bytes;
+  };
+
+  lru_unordered_map<TensorShapeVector, CudnnFeGraphCacheEntry, tensor_shape_vector_hash> cached_cudnn_fe_graphs{
+      MAX_CACHED_CUDNN_FE_GRAPHS};
 #endif
 
   struct PerfResultParams {
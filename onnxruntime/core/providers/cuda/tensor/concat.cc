@@ -66,6 +66,19 @@ Status Concat::ComputeInternal(OpKernelContext* ctx) const {
   }
 
   auto element_bytes = p.output_tensor->DataType()->Size();
+
+  // the allocation planner may have placed all the inputs in the output already
+  bool all_in_place = true;
+  size_t output_offset = 0;
+  for (int i = 0; i < input_count && all_in_place; ++i) {
+    all_in_place = p.inputs[i].tensor->DataRaw() ==
+                   static_cast<const char*>(p.output_tensor->DataRaw()) + output_offset;
+    output_offset += static_cast<size_t>(p.inputs[i].num_elements) * element_bytes;
+  }
+  if (all_in_place) {
+    return Status::OK();
+  }
+
   int block_size_inside_axis_dim = static_cast<int>(p.output_axis_pitch / p.output_tensor->Shape()[p.axis]);
   int block_size_including_axis_dim = static_cast<int>(p.output_axis_pitch);
   if (std::all_of(concat_sizes.begin(), concat_sizes.end(), [&](int64_t size) { return size == concat_sizes[0]; })) {
@@ -42,6 +42,21 @@ ONNX_OPERATOR_KERNEL_EX(Split,
                             .TypeConstraint("T", DataTypeImpl::AllFixedSizeTensorTypes()),
                         Split_18);
 
+namespace {
+// Checks if the allocation planner placed all the outputs in the input already, one after another
+bool AreOutputsInPlace(const Tensor& input, OpKernelContext* ctx, int num_outputs) {
+  const char* expected = static_cast<const char*>(input.DataRaw());
+  for (int i = 0; i < num_outputs; ++i) {
+    const Tensor* output = ctx->Output<Tensor>(i);
+    if (output->DataRaw() != expected) {
+      return false;
+    }
+    expected += output->SizeInBytes();
+  }
+  return true;
+}
+}  // namespace
+
 Status SplitKernel::ComputeInternal(OpKernelContext* ctx) const {
   const Tensor* input_tensor = ctx->Input<Tensor>(0);
   ORT_ENFORCE(input_tensor);
@@ -89,7 +104,7 @@ Status SplitKernel::ComputeInternal(OpKernelContext* ctx) const {
     Tensor* output2 = ctx->Output(2, TensorShape{output_dimensions});
 
     // if input tensor is empty, we don't need to launch kernel, but still need to set output tensor.
-    if (input_tensor->Shape().Size() <= 0) return Status::OK();
+    if (input_tensor->Shape().Size() <= 0 || AreOutputsInPlace(*input_tensor, ctx, num_outputs)) return Status::OK();
 
     return Split3Inner(Stream(ctx),
                        input_tensor->DataType()->Size(),
@@ -120,7 +135,7 @@ Status SplitKernel::ComputeInternal(OpKernelContext* ctx) const {
     }
   }
 
-  if (input_tensor->Shape().Size() <= 0) return Status::OK();
+  if (input_tensor->Shape().Size() <= 0 || AreOutputsInPlace(*input_tensor, ctx, num_outputs)) return Status::OK();
 
   size_t element_size = input_tensor->DataType()->Size();
   if (std::all_of(split_sizes.begin(), split_sizes.end(), [&](int64_t size) { return size == split_sizes[0]; })) {
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cuda/tunable/math/softmax.h"
+
+#include "core/providers/cuda/math/softmax.h"
+#include "core/providers/cuda/shared_inc/accumulation_type.h"
+
+namespace onnxruntime {
+namespace cuda {
+namespace tunable {
+
+template <typename T>
+SoftmaxParams<T>::SoftmaxParams(CudaTuningContext* tuning_ctx, onnxruntime::Stream* stream, const T* input, T* output,
+                                int64_t batch_count, int64_t softmax_elements, bool is_log_softmax)
+    : OpParams(tuning_ctx, stream),
+      input_(input),
+      output_(output),
+      batch_count_(batch_count),
+      softmax_elements_(softmax_elements),
+      is_log_softmax_(is_log_softmax) {}
+
+template <typename T>
+std::string SoftmaxParams<T>::Signature() const {
+  return MakeString((is_log_softmax_ ? "L" : "S"), "_", batch_count_, "_", softmax_elements_);
+}
+
+namespace {
+
+template <typename T>
+common::Status DefaultSoftmaxOp(const SoftmaxParams<T>* params) {
+  const TensorShape shape({params->batch_count_, params->softmax_elements_});
+  if (params->is_log_softmax_) {
+    return SoftMaxComputeHelper<T, T, true>(params->Stream(), params->input_, shape, params->output_, 1);
+  }
+  return SoftMaxComputeHelper<T, T, false>(params->Stream(), params->input_, shape, params->output_, 1);
+}
+
+template <typename T>
+common::Status WarpwiseSoftmaxOp(const SoftmaxParams<T>* params) {
+  // the warpwise kernels hold a row in registers, or in shared memory above 1024 elements
+  TUNABLE_OP_RETURN_UNSUPPORTED_ARGUMENT_IF(
+      params->softmax_elements_ > 2048 || params->softmax_elements_ * static_cast<int64_t>(sizeof(T)) > 4096);
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  auto* output = reinterpret_cast<CudaT*>(params->output_);
+  const auto* input = reinterpret_cast<const CudaT*>(params->input_);
+  const int softmax_elements = gsl::narrow_cast<int>(params->softmax_elements_);
+  const int batch_count = gsl::narrow_cast<int>(params->batch_count_);
+  if (params->is_log_softmax_) {
+    return dispatch_warpwise_softmax_forward<CudaT, CudaT, AccumulationType_t<CudaT>, true>(
+        params->Stream(), output, input, softmax_elements, softmax_elements, batch_count);
+  }
+  return dispatch_warpwise_softmax_forward<CudaT, CudaT, AccumulationType_t<CudaT>, false>(
+      params->Stream(), output, input, softmax_elements, softmax_elements, batch_count);
+}
+
+template <typename T>
+common::Status BlockwiseSoftmaxOp(const SoftmaxParams<T>* params) {
+  typedef typename ToCudaType<T>::MappedType CudaT;
+  auto* output = reinterpret_cast<CudaT*>(params->output_);
+  const auto* input = reinterpret_cast<const CudaT*>(params->input_);
+  const int softmax_elements = gsl::narrow_cast<int>(params->softmax_elements_);
+  const int batch_count = gsl::narrow_cast<int>(params->batch_count_);
+  if (params->is_log_softmax_) {
+    return dispatch_blockwise_softmax_forward<CudaT, CudaT, AccumulationType_t<CudaT>, true>(
+        params->Stream(), output, input, softmax_elements, softmax_elements, softmax_elements, batch_count);
+  }
+  return dispatch_blockwise_softmax_forward<CudaT, CudaT, AccumulationType_t<CudaT>, false>(
+      params->Stream(), output, input, softmax_elements, softmax_elements, softmax_elements, batch_count);
+}
+
+template <typename T>
+class SoftmaxTunableOp : public TunableOp<SoftmaxParams<T>> {
+ public:
+  SoftmaxTunableOp() {
+    this->RegisterOp(DefaultSoftmaxOp<T>);
+    this->RegisterOp(WarpwiseSoftmaxOp<T>);
+    this->RegisterOp(BlockwiseSoftmaxOp<T>);
+  }
+};
+
+}  // namespace
+
+template <typename T>
+inline common::Status TunableSoftmax(CudaTuningContext* tuning_ctx, onnxruntime::Stream* stream, const T* input,
+                                     T* output, int64_t batch_count, int64_t softmax_elements, bool is_log_softmax) {
+  SoftmaxParams<T> params(tuning_ctx, stream, input, output, batch_count, softmax_elements, is_log_softmax);
+  if (params.tuning_ctx->IsTunableOpEnabled()) {
+    static SoftmaxTunableOp<T> softmax{};
+    return softmax(&params);
+  }
+
+  return DefaultSoftmaxOp(&params);
+}
+
+#define SPECIALIZE_TUNABLE_SOFTMAX(T)                                                                          \
+  template common::Status TunableSoftmax<T>(CudaTuningContext * tuning_ctx, onnxruntime::Stream * stream,      \
+                                            const T* input, T* output, int64_t batch_count,                    \
+                                            int64_t softmax_elements, bool is_log_softmax);
+
+SPECIALIZE_TUNABLE_SOFTMAX(float)
+SPECIALIZE_TUNABLE_SOFTMAX(double)
+SPECIALIZE_TUNABLE_SOFTMAX(MLFloat16)
+SPECIALIZE_TUNABLE_SOFTMAX(BFloat16)
+
+#undef SPECIALIZE_TUNABLE_SOFTMAX
+
+}  // namespace tunable
+}  // namespace cuda
+}  // namespace onnxruntime
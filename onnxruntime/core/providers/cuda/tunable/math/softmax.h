@@ -0,0 +1,36 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/status.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/tunable/cuda_tunable.h"
+
+namespace onnxruntime {
+namespace cuda {
+namespace tunable {
+
+template <typename T>
+struct SoftmaxParams : OpParams {
+  SoftmaxParams(CudaTuningContext* tuning_ctx, onnxruntime::Stream* stream, const T* input, T* output,
+                int64_t batch_count, int64_t softmax_elements, bool is_log_softmax);
+
+  std::string Signature() const override;
+
+  const T* input_;
+  T* output_;
+  int64_t batch_count_;
+  int64_t softmax_elements_;
+  bool is_log_softmax_;
+};
+
+// Computes the softmax of the batch_count rows of softmax_elements contiguous values. The warpwise or blockwise
+// kernel is selected by TunableOp if it is enabled, else by the same heuristic as SoftMaxComputeHelper.
+template <typename T>
+common::Status TunableSoftmax(CudaTuningContext* tuning_ctx, onnxruntime::Stream* stream, const T* input, T* output,
+                              int64_t batch_count, int64_t softmax_elements, bool is_log_softmax);
+
+}  // namespace tunable
+}  // namespace cuda
+}  // namespace onnxruntime
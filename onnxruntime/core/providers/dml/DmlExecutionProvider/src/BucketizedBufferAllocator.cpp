@@ -94,8 +94,10 @@ namespace Dml
         uint64_t resourceId = 0;
         uint64_t bucketSize = 0;
 
-        // Use a pooled resource if the size (post rounding, if requested) matches a bucket size
-        if (roundingMode == AllocatorRoundingMode::Enabled || size == GetBucketSizeFromIndex(GetBucketIndexFromSize(size)))
+        // Use a pooled resource if the size (post rounding, if requested) matches a bucket size, unless the
+        // sub-allocator reuses freed resources itself
+        if (!m_subAllocator->PoolsResources() &&
+            (roundingMode == AllocatorRoundingMode::Enabled || size == GetBucketSizeFromIndex(GetBucketIndexFromSize(size))))
         {
             Bucket* bucket = nullptr;
 
@@ -174,7 +176,7 @@ namespace Dml
 
         // Free the resource to the pool if its size matches a bucket size
         gsl::index bucketIndex = GetBucketIndexFromSize(allocInfo->GetRequestedSize());
-        if (GetBucketSizeFromIndex(bucketIndex) == allocInfo->GetResource()->GetDesc().Width)
+        if (!m_subAllocator->PoolsResources() && GetBucketSizeFromIndex(bucketIndex) == allocInfo->GetResource()->GetDesc().Width)
         {
             assert(gsl::narrow_cast<gsl::index>(m_pool.size()) > bucketIndex);
 
@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "precomp.h"
+
+#include <functional>
+#include <mutex>
+
+#include "DmlHeapAllocator.h"
+#include "DmlResourceWrapper.h"
+
+namespace Dml
+{
+    class DmlHeapAllocator::HeapPool : public std::enable_shared_from_this<HeapPool>
+    {
+    public:
+        HeapPool(ID3D12Device* device, ExecutionContext* context) : m_device(device), m_context(context) {}
+
+        ComPtr<DmlResourceWrapper> Alloc(size_t size);
+        void Free(size_t heapIndex, uint64_t offset, uint64_t size);
+
+    private:
+        // Most buffers are much smaller, larger ones get a heap of their own size
+        static constexpr uint64_t c_heapSize = 64ull * 1024 * 1024;
+
+        struct Heap
+        {
+            ComPtr<ID3D12Heap> heap;
+            uint64_t size = 0;
+            uint64_t usedSize = 0;
+            std::map<uint64_t, uint64_t> freeRanges; // offset -> size
+            bool resident = true;
+            // Signaled once the GPU is done with the buffers of an empty heap
+            std::optional<GpuEvent> emptiedEvent;
+        };
+
+        void EvictIdleHeaps();
+
+        ComPtr<ID3D12Device> m_device;
+        ComPtr<ExecutionContext> m_context;
+        std::vector<Heap> m_heaps;
+        std::mutex m_mutex;
+    };
+
+    namespace
+    {
+        class DmlHeapResourceWrapper : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>, DmlResourceWrapper>
+        {
+        public:
+            DmlHeapResourceWrapper(
+                ComPtr<ID3D12Resource>&& d3d12Resource,
+                std::function<void()>&& freeRange)
+                : m_d3d12Resource(std::move(d3d12Resource)),
+                  m_freeRange(std::move(freeRange))
+            {
+            }
+
+            ~DmlHeapResourceWrapper()
+            {
+                m_freeRange();
+            }
+
+            ID3D12Resource* GetD3D12Resource() const final { return m_d3d12Resource.Get(); }
+
+        private:
+            ComPtr<ID3D12Resource> m_d3d12Resource;
+            std::function<void()> m_freeRange;
+        };
+    }
+
+    ComPtr<DmlResourceWrapper> DmlHeapAllocator::HeapPool::Alloc(size_t size)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        const uint64_t alignedSize = (static_cast<uint64_t>(size) + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) &
+                                     ~static_cast<uint64_t>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1);
+        EvictIdleHeaps();
+
+        // Best fit among the free ranges of all heaps
+        size_t heapIndex = m_heaps.size();
+        uint64_t offset = 0;
+        uint64_t rangeSize = std::numeric_limits<uint64_t>::max();
+        for (size_t i = 0; i < m_heaps.size(); ++i)
+        {
+            for (const auto& [freeOffset, freeSize] : m_heaps[i].freeRanges)
+            {
+                if (freeSize >= alignedSize && freeSize < rangeSize)
+                {
+                    heapIndex = i;
+                    offset = freeOffset;
+                    rangeSize = freeSize;
+                }
+            }
+        }
+
+        const bool newHeap = heapIndex == m_heaps.size();
+        if (newHeap)
+        {
+            Heap heap;
+            heap.size = std::max(c_heapSize, alignedSize);
+            CD3DX12_HEAP_DESC heapDesc(heap.size, D3D12_HEAP_TYPE_DEFAULT, 0, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+            ORT_THROW_IF_FAILED(m_device->CreateHeap(&heapDesc, IID_GRAPHICS_PPV_ARGS(heap.heap.GetAddressOf())));
+            heap.freeRanges[0] = heap.size;
+            m_heaps.push_back(std::move(heap));
+            offset = 0;
+            rangeSize = m_heaps.back().size;
+        }
+
+        Heap& heap = m_heaps[heapIndex];
+        if (!heap.resident)
+        {
+            ID3D12Pageable* pageable = heap.heap.Get();
+            ORT_THROW_IF_FAILED(m_device->MakeResident(1, &pageable));
+            heap.resident = true;
+        }
+
+        ComPtr<ID3D12Resource> resource;
+        auto buffer = CD3DX12_RESOURCE_DESC::Buffer(size, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        ORT_THROW_IF_FAILED(m_device->CreatePlacedResource(
+            heap.heap.Get(),
+            offset,
+            &buffer,
+            D3D12_RESOURCE_STATE_COMMON,
+            nullptr,
+            IID_GRAPHICS_PPV_ARGS(resource.GetAddressOf())
+        ));
+
+        heap.freeRanges.erase(offset);
+        if (rangeSize > alignedSize)
+        {
+            heap.freeRanges[offset + alignedSize] = rangeSize - alignedSize;
+        }
+        heap.usedSize += alignedSize;
+        heap.emptiedEvent.reset();
+        lock.unlock();
+
+        // The range may have held another buffer used by queued work
+        if (!newHeap && !m_context->IsClosed())
+        {
+            D3D12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource.Get());
+            m_context->ResourceBarrier(gsl::make_span(&barrier, 1));
+        }
+
+        std::weak_ptr<HeapPool> weakPool = weak_from_this();
+        ComPtr<DmlResourceWrapper> resourceWrapper;
+        wil::MakeOrThrow<DmlHeapResourceWrapper>(
+            std::move(resource),
+            [weakPool, heapIndex, offset, alignedSize]()
+            {
+                if (auto pool = weakPool.lock())
+                {
+                    pool->Free(heapIndex, offset, alignedSize);
+                }
+            }).As(&resourceWrapper);
+        return resourceWrapper;
+    }
+
+    void DmlHeapAllocator::HeapPool::Free(size_t heapIndex, uint64_t offset, uint64_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Heap& heap = m_heaps[heapIndex];
+        auto range = heap.freeRanges.emplace(offset, size).first;
+
+        // Coalesce with the free ranges around it
+        auto next = std::next(range);
+        if (next != heap.freeRanges.end() && range->first + range->second == next->first)
+        {
+            range->second += next->second;
+            heap.freeRanges.erase(next);
+        }
+        if (range != heap.freeRanges.begin())
+        {
+            auto previous = std::prev(range);
+            if (previous->first + previous->second == range->first)
+            {
+                previous->second += range->second;
+                heap.freeRanges.erase(range);
+            }
+        }
+
+        heap.usedSize -= size;
+        if (heap.usedSize == 0 && !m_context->IsClosed())
+        {
+            heap.emptiedEvent = m_context->GetCurrentCompletionEvent();
+        }
+    }
+
+    void DmlHeapAllocator::HeapPool::EvictIdleHeaps()
+    {
+        // Keep the most recently emptied heap resident, it is likely to be needed again soon
+        Heap* keptHeap = nullptr;
+        for (auto& heap : m_heaps)
+        {
+            if (heap.resident && heap.usedSize == 0 && heap.emptiedEvent && heap.emptiedEvent->IsSignaled() &&
+                (keptHeap == nullptr || heap.emptiedEvent->fenceValue > keptHeap->emptiedEvent->fenceValue))
+            {
+                keptHeap = &heap;
+            }
+        }
+
+        for (auto& heap : m_heaps)
+        {
+            if (&heap != keptHeap && heap.resident && heap.usedSize == 0 && heap.emptiedEvent && heap.emptiedEvent->IsSignaled())
+            {
+                ID3D12Pageable* pageable = heap.heap.Get();
+                ORT_THROW_IF_FAILED(m_device->Evict(1, &pageable));
+                heap.resident = false;
+            }
+        }
+    }
+
+    DmlHeapAllocator::DmlHeapAllocator(ID3D12Device* device, ExecutionContext* context)
+        : m_heapPool(std::make_shared<HeapPool>(device, context))
+    {
+    }
+
+    ComPtr<DmlResourceWrapper> DmlHeapAllocator::Alloc(size_t size)
+    {
+        return m_heapPool->Alloc(size);
+    }
+}
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "DmlSubAllocator.h"
+#include "ExecutionContext.h"
+
+namespace Dml
+{
+    struct DmlResourceWrapper;
+
+    // Places the buffers in a few large D3D12 heaps instead of committing a resource per buffer. Free ranges of the
+    // heaps are coalesced and handed out best-fit, so that memory freed by buffers of one size is reused by buffers
+    // of other sizes. Heaps left empty once the GPU is done with them are evicted, except for one kept resident for
+    // the next allocations, and made resident again when they are allocated from. This lowers the memory pressure of
+    // large models on GPUs sharing memory with the CPU.
+    class DmlHeapAllocator : public DmlSubAllocator
+    {
+    public:
+        DmlHeapAllocator(ID3D12Device* device, ExecutionContext* context);
+
+        Microsoft::WRL::ComPtr<DmlResourceWrapper> Alloc(size_t size) final;
+        bool PoolsResources() const final { return true; }
+
+    private:
+        class HeapPool;
+        std::shared_ptr<HeapPool> m_heapPool;
+    };
+}
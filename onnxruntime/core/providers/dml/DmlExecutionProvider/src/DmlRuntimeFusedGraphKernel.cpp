@@ -14,6 +14,32 @@ namespace Dml
 {
     class DmlRuntimeFusedGraphKernel : public onnxruntime::OpKernel
     {
+        // A graph compiled for the shapes of the inputs and the values of the CPU inputs of one execution
+        struct CompiledGraph
+        {
+            std::string key;
+            // Values of the CPU inputs, compiled into the graph as constants
+            std::vector<std::unique_ptr<ONNX_NAMESPACE::TensorProto>> cpuInputs;
+            ComPtr<IDMLCompiledOperator> compiledExecutionPlanOperator;
+            std::optional<DML_BUFFER_BINDING> persistentResourceBinding;
+            ComPtr<ID3D12Resource> persistentResource;
+            ComPtr<IUnknown> persistentResourceAllocatorUnknown; // Controls when the persistent resource is returned to the allocator
+            Windows::AI::MachineLearning::Adapter::EdgeShapes outputShapes;
+            std::vector<bool> inputsUsed;
+            std::deque<std::unique_ptr<DmlReusedCommandListState>> reusedCommandLists;
+        };
+
+        // Number of compiled graphs kept, so that inputs with dynamic shapes, such as the sequence length of a decoder,
+        // don't recompile the graph each time a shape seen recently comes back. Each holds its own persistent resource.
+        static constexpr size_t c_maxCompiledGraphs = 8;
+
+        static void AppendToKey(std::string& key, gsl::span<const std::byte> bytes)
+        {
+            const uint64_t size = bytes.size();
+            key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            key.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+
     public:
         DmlRuntimeFusedGraphKernel() = delete;
 
@@ -62,24 +88,24 @@ namespace Dml
             }
         }
 
-        void TranslateAndCompileGraph(const onnxruntime::OpKernelInfo& kernelInfo, std::vector<DML_BUFFER_BINDING> initInputBindings) const
+        void TranslateAndCompileGraph(const onnxruntime::OpKernelInfo& kernelInfo, std::vector<DML_BUFFER_BINDING> initInputBindings, CompiledGraph& compiledGraph) const
         {
             // Allocate a persistent resource and initialize the operator
-            UINT64 persistentResourceSize = m_compiledExecutionPlanOperator->GetBindingProperties().PersistentResourceSize;
+            UINT64 persistentResourceSize = compiledGraph.compiledExecutionPlanOperator->GetBindingProperties().PersistentResourceSize;
             if (persistentResourceSize > 0)
             {
                 ORT_THROW_IF_FAILED(m_provider->AllocatePooledResource(
                     static_cast<size_t>(persistentResourceSize),
                     AllocatorRoundingMode::Disabled,
-                    m_persistentResource.ReleaseAndGetAddressOf(),
-                    m_persistentResourceAllocatorUnknown.ReleaseAndGetAddressOf()));
+                    compiledGraph.persistentResource.ReleaseAndGetAddressOf(),
+                    compiledGraph.persistentResourceAllocatorUnknown.ReleaseAndGetAddressOf()));
 
-                m_persistentResourceBinding = DML_BUFFER_BINDING { m_persistentResource.Get(), 0, persistentResourceSize };
+                compiledGraph.persistentResourceBinding = DML_BUFFER_BINDING { compiledGraph.persistentResource.Get(), 0, persistentResourceSize };
             }
 
             ORT_THROW_IF_FAILED(m_provider->InitializeOperator(
-                m_compiledExecutionPlanOperator.Get(),
-                m_persistentResourceBinding ? &*m_persistentResourceBinding : nullptr,
+                compiledGraph.compiledExecutionPlanOperator.Get(),
+                compiledGraph.persistentResourceBinding ? &*compiledGraph.persistentResourceBinding : nullptr,
                 gsl::make_span(initInputBindings)));
         }
 
@@ -91,61 +117,53 @@ namespace Dml
 
             ORT_THROW_HR_IF(E_UNEXPECTED, static_cast<ptrdiff_t>(m_subgraphInputs.size()) != kernelContext->InputCount());
 
-            bool recompileNeeded = m_compiledExecutionPlanOperator == nullptr;
+            // The compiled graph depends on the shapes of the inputs, and on the values of the CPU inputs which are
+            // compiled into the graph as constants
+            std::string compiledGraphKey;
+            std::vector<std::pair<std::string, std::unique_ptr<ONNX_NAMESPACE::TensorProto>>> cpuInputs;
 
             for (int inputIndex = 0; inputIndex < kernelContext->InputCount(); ++inputIndex)
             {
                 const auto& input = kernelContext->RequiredInput<onnxruntime::Tensor>(inputIndex);
                 const std::string& inputName = m_subgraphInputs[inputIndex]->Name();
-                auto shapeIter = m_inferredInputShapes.find(inputName);
+                const auto dims = input.Shape().GetDims();
+                AppendToKey(compiledGraphKey, gsl::as_bytes(dims));
 
-                if (shapeIter == m_inferredInputShapes.end())
+                // If we have CPU inputs that are not initializers (i.e. they were computed at runtime), add them to the initializer list
+                if (input.Location().device.Type() == OrtDevice::CPU)
                 {
-                    m_inferredInputShapes[inputName] = input.Shape();
-                    recompileNeeded = true;
+                    auto inputProto = std::make_unique<ONNX_NAMESPACE::TensorProto>(onnxruntime::utils::TensorToTensorProto(input, inputName));
+                    AppendToKey(compiledGraphKey, gsl::as_bytes(gsl::make_span(inputProto->raw_data().data(), inputProto->raw_data().size())));
+                    cpuInputs.emplace_back(inputName, std::move(inputProto));
                 }
-                else if (shapeIter->second != input.Shape())
+            }
+
+            auto compiledGraphIter = m_compiledGraphsByKey.find(compiledGraphKey);
+            const bool recompileNeeded = compiledGraphIter == m_compiledGraphsByKey.end();
+            if (!recompileNeeded)
+            {
+                // Most recently used first
+                m_compiledGraphs.splice(m_compiledGraphs.begin(), m_compiledGraphs, compiledGraphIter->second);
+            }
+            else
+            {
+                for (int inputIndex = 0; inputIndex < kernelContext->InputCount(); ++inputIndex)
                 {
-                    shapeIter->second = input.Shape();
-                    recompileNeeded = true;
+                    const auto& input = kernelContext->RequiredInput<onnxruntime::Tensor>(inputIndex);
+                    m_inferredInputShapes[m_subgraphInputs[inputIndex]->Name()] = input.Shape();
                 }
 
-                // If we have CPU inputs that are not initializers (i.e. they were computed at runtime), add them to the initializer list
-                if (input.Location().device.Type() == OrtDevice::CPU)
+                CompiledGraph& newGraph = m_compiledGraphs.emplace_front();
+                newGraph.key = compiledGraphKey;
+                for (auto& cpuInput : cpuInputs)
                 {
-                    auto inputProto = onnxruntime::utils::TensorToTensorProto(input, inputName);
-
-                    // We can only avoid recompiling the graph when all CPU inputs are identical
-                    auto initializerIter = m_isInitializerTransferable.find(inputName);
-
-                    if (initializerIter != m_isInitializerTransferable.end())
-                    {
-                        if (initializerIter->second.first->raw_data().length() == inputProto.raw_data().length())
-                        {
-                            for (int i = 0; i < inputProto.raw_data().length(); ++i)
-                            {
-                                if (initializerIter->second.first->raw_data()[i] != inputProto.raw_data()[i])
-                                {
-                                    recompileNeeded = true;
-                                    break;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            recompileNeeded = true;
-                        }
-                    }
-                    else
-                    {
-                        recompileNeeded = true;
-                    }
-
-                    m_ownedCpuInputs.push_back(std::make_unique<ONNX_NAMESPACE::TensorProto>(std::move(inputProto)));
-                    m_isInitializerTransferable[inputName] = std::make_pair(m_ownedCpuInputs.back().get(), false);
+                    newGraph.cpuInputs.push_back(std::move(cpuInput.second));
+                    m_isInitializerTransferable[cpuInput.first] = std::make_pair(newGraph.cpuInputs.back().get(), false);
                 }
             }
 
+            CompiledGraph& compiledGraph = m_compiledGraphs.front();
+
             if (recompileNeeded)
             {
                 // Go through all the node args and replace their shapes with the real ones
@@ -201,15 +219,15 @@ namespace Dml
                     serializedGraphLargeConstantNameToSubgraphInputIndex,
                     smallConstantData);
 
-                m_outputShapes = graphDesc.outputShapes;
+                compiledGraph.outputShapes = graphDesc.outputShapes;
 
                 // Walk through each graph edge and mark used inputs
-                m_inputsUsed = std::vector<bool>(fusedNodeInputCount);
+                compiledGraph.inputsUsed = std::vector<bool>(fusedNodeInputCount);
                 for (auto it = serializedGraphInputIndexToSubgraphInputIndex.begin(); it != serializedGraphInputIndexToSubgraphInputIndex.end(); it++) {
-                    m_inputsUsed[it->second] = true;
+                    compiledGraph.inputsUsed[it->second] = true;
                 }
                 for (auto it = serializedGraphLargeConstantNameToSubgraphInputIndex.begin(); it != serializedGraphLargeConstantNameToSubgraphInputIndex.end(); it++) {
-                    m_inputsUsed[it->second] = true;
+                    compiledGraph.inputsUsed[it->second] = true;
                 }
 
                 m_isInputsUploadedByDmlEP.resize(fusedNodeInputCount, 0);
@@ -217,7 +235,7 @@ namespace Dml
                 graphDesc.reuseCommandList = true;
 
                 // Compile the operator
-                m_compiledExecutionPlanOperator = DmlGraphFusionHelper::TryCreateCompiledOperator(
+                compiledGraph.compiledExecutionPlanOperator = DmlGraphFusionHelper::TryCreateCompiledOperator(
                     graphDesc,
                     *m_indexedSubGraph,
                     providerImpl,
@@ -225,14 +243,31 @@ namespace Dml
                     &serializedGraphLargeConstantNameToSubgraphInputIndex);
 
                 // Queue references to objects which must be kept alive until resulting GPU work completes
-                m_winmlProvider->QueueReference(m_compiledExecutionPlanOperator.Get());
-
-                TranslateAndCompileGraph(Info(), initInputBindings);
+                m_winmlProvider->QueueReference(compiledGraph.compiledExecutionPlanOperator.Get());
 
-                std::vector<DML_BUFFER_BINDING> inputBindings(kernelContext->InputCount());
-                std::vector<DML_BINDING_DESC> inputBindingDescs(kernelContext->InputCount());
+                TranslateAndCompileGraph(Info(), initInputBindings, compiledGraph);
 
-                m_reusedCommandLists.clear();
+                m_compiledGraphsByKey[compiledGraphKey] = m_compiledGraphs.begin();
+                while (m_compiledGraphs.size() > c_maxCompiledGraphs)
+                {
+                    // The GPU may still be executing the evicted graph. Its command lists were queued when they were
+                    // executed, keep the operator and persistent resource alive as long.
+                    CompiledGraph& evictedGraph = m_compiledGraphs.back();
+                    if (evictedGraph.compiledExecutionPlanOperator)
+                    {
+                        m_winmlProvider->QueueReference(evictedGraph.compiledExecutionPlanOperator.Get());
+                    }
+                    if (evictedGraph.persistentResource)
+                    {
+                        m_winmlProvider->QueueReference(evictedGraph.persistentResource.Get());
+                    }
+                    auto evictedGraphIter = m_compiledGraphsByKey.find(evictedGraph.key);
+                    if (evictedGraphIter != m_compiledGraphsByKey.end() && &*evictedGraphIter->second == &evictedGraph)
+                    {
+                        m_compiledGraphsByKey.erase(evictedGraphIter);
+                    }
+                    m_compiledGraphs.pop_back();
+                }
             }
 
             // When we are capturing a graph, we don't pool the command list and instead transfer it to the execution provider. Captured graph
@@ -241,12 +276,12 @@ namespace Dml
             {
                 auto reusableCommandList = DmlGraphFusionHelper::BuildReusableCommandList(
                     m_provider.Get(),
-                    m_compiledExecutionPlanOperator.Get(),
-                    m_persistentResource.Get(),
-                    m_persistentResourceBinding);
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
+                    compiledGraph.persistentResource.Get(),
+                    compiledGraph.persistentResourceBinding);
 
-                reusableCommandList->persistentResource = m_persistentResource;
-                reusableCommandList->persistentResourceAllocatorUnknown = m_persistentResourceAllocatorUnknown;
+                reusableCommandList->persistentResource = compiledGraph.persistentResource;
+                reusableCommandList->persistentResourceAllocatorUnknown = compiledGraph.persistentResourceAllocatorUnknown;
 
                 // Keep the temporary resource alive since we won't call ExecuteReusableCommandList again, but will merely replay
                 // the graph in the future. Therefore, all executions of the graph will use the same temporary resource that was
@@ -256,31 +291,31 @@ namespace Dml
                 DmlGraphFusionHelper::ExecuteReusableCommandList(
                     kernelContext,
                     *reusableCommandList,
-                    m_compiledExecutionPlanOperator.Get(),
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
                     Info(),
                     m_isInputsUploadedByDmlEP,
-                    m_inputsUsed,
+                    compiledGraph.inputsUsed,
                     m_nonOwnedGraphInputsFromInitializers,
-                    m_outputShapes,
+                    compiledGraph.outputShapes,
                     m_winmlProvider.Get(),
                     m_provider.Get(),
-                    m_persistentResourceAllocatorUnknown.Get(),
+                    compiledGraph.persistentResourceAllocatorUnknown.Get(),
                     keepTemporaryResourceAlive);
 
                 providerImpl->AppendCapturedGraph(providerImpl->GetCurrentGraphAnnotationId(), std::move(reusableCommandList));
             }
             else
             {
-                if (m_reusedCommandLists.empty() ||
-                    m_reusedCommandLists.front()->fence && m_reusedCommandLists.front()->fence->GetCompletedValue() < m_reusedCommandLists.front()->completionValue)
+                if (compiledGraph.reusedCommandLists.empty() ||
+                    compiledGraph.reusedCommandLists.front()->fence && compiledGraph.reusedCommandLists.front()->fence->GetCompletedValue() < compiledGraph.reusedCommandLists.front()->completionValue)
                 {
                     auto reusableCommandList = DmlGraphFusionHelper::BuildReusableCommandList(
                         m_provider.Get(),
-                        m_compiledExecutionPlanOperator.Get(),
-                        m_persistentResource.Get(),
-                        m_persistentResourceBinding);
+                        compiledGraph.compiledExecutionPlanOperator.Get(),
+                        compiledGraph.persistentResource.Get(),
+                        compiledGraph.persistentResourceBinding);
 
-                    m_reusedCommandLists.push_front(std::move(reusableCommandList));
+                    compiledGraph.reusedCommandLists.push_front(std::move(reusableCommandList));
                 }
 
                 // We don't need to keep a reference on the temporary resource once we have recorded into the command list, so the
@@ -289,20 +324,20 @@ namespace Dml
 
                 DmlGraphFusionHelper::ExecuteReusableCommandList(
                     kernelContext,
-                    *m_reusedCommandLists.front(),
-                    m_compiledExecutionPlanOperator.Get(),
+                    *compiledGraph.reusedCommandLists.front(),
+                    compiledGraph.compiledExecutionPlanOperator.Get(),
                     Info(),
                     m_isInputsUploadedByDmlEP,
-                    m_inputsUsed,
+                    compiledGraph.inputsUsed,
                     m_nonOwnedGraphInputsFromInitializers,
-                    m_outputShapes,
+                    compiledGraph.outputShapes,
                     m_winmlProvider.Get(),
                     m_provider.Get(),
-                    m_persistentResourceAllocatorUnknown.Get(),
+                    compiledGraph.persistentResourceAllocatorUnknown.Get(),
                     keepTemporaryResourceAlive);
 
-                m_reusedCommandLists.push_back(std::move(m_reusedCommandLists.front()));
-                m_reusedCommandLists.pop_front();
+                compiledGraph.reusedCommandLists.push_back(std::move(compiledGraph.reusedCommandLists.front()));
+                compiledGraph.reusedCommandLists.pop_front();
             }
 
             return onnxruntime::Status::OK();
@@ -312,7 +347,6 @@ namespace Dml
         ComPtr<IWinmlExecutionProvider> m_winmlProvider;
         ComPtr<Dml::IExecutionProvider> m_provider;
 
-        mutable std::optional<DML_BUFFER_BINDING> m_persistentResourceBinding;
         std::shared_ptr<const onnxruntime::IndexedSubGraph> m_indexedSubGraph;
         const std::filesystem::path& m_modelPath;
 
@@ -325,15 +359,11 @@ namespace Dml
         mutable std::unordered_map<std::string, std::pair<const ONNX_NAMESPACE::TensorProto*, bool>> m_isInitializerTransferable;
         std::vector<const onnxruntime::Node*> m_subgraphNodePointers;
 
-        // Bindings from previous executions of a re-used command list
-        mutable std::vector<std::unique_ptr<ONNX_NAMESPACE::TensorProto>> m_ownedCpuInputs;
-        mutable ComPtr<IDMLCompiledOperator> m_compiledExecutionPlanOperator;
-        mutable std::vector<bool> m_inputsUsed;
-        mutable ComPtr<ID3D12Resource> m_persistentResource;
-        mutable ComPtr<IUnknown> m_persistentResourceAllocatorUnknown; // Controls when the persistent resource is returned to the allocator
-        mutable Windows::AI::MachineLearning::Adapter::EdgeShapes m_outputShapes;
         mutable std::unordered_map<std::string, onnxruntime::TensorShape> m_inferredInputShapes;
-        mutable std::deque<std::unique_ptr<DmlReusedCommandListState>> m_reusedCommandLists;
+
+        // Compiled graphs, most recently used first
+        mutable std::list<CompiledGraph> m_compiledGraphs;
+        mutable std::unordered_map<std::string, std::list<CompiledGraph>::iterator> m_compiledGraphsByKey;
         mutable std::vector<uint8_t> m_isInputsUploadedByDmlEP;
         mutable std::vector<ComPtr<ID3D12Resource>> m_nonOwnedGraphInputsFromInitializers;
     };
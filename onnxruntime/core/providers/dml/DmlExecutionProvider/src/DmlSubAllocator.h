@@ -11,6 +11,10 @@ namespace Dml
     {
     public:
         virtual Microsoft::WRL::ComPtr<DmlResourceWrapper> Alloc(size_t size) = 0;
+
+        // Whether freed resources are reused by the sub-allocator itself, in which case they are not kept in
+        // the buckets of BucketizedBufferAllocator.
+        virtual bool PoolsResources() const { return false; }
         virtual ~DmlSubAllocator(){}
     };
 }
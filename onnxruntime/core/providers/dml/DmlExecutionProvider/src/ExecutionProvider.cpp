@@ -18,6 +18,7 @@
 #include "core/framework/compute_capability.h"
 #include "core/framework/fallback_cpu_capability.h"
 #include "DmlCommittedResourceAllocator.h"
+#include "DmlHeapAllocator.h"
 #include "DmlCommittedResourceWrapper.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #include "core/common/parse_string.h"
@@ -236,7 +237,9 @@ namespace Dml
                 D3D12_HEAP_FLAG_NONE,
                 D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS,
                 D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
-                std::make_unique<DmlCommittedResourceAllocator>(m_d3d12Device.Get()));
+                m_memoryArenaDisabled
+                    ? std::unique_ptr<DmlSubAllocator>(std::make_unique<DmlCommittedResourceAllocator>(m_d3d12Device.Get()))
+                    : std::make_unique<DmlHeapAllocator>(m_d3d12Device.Get(), m_context.Get()));
             m_context->SetAllocator(m_allocator);
             // CPU Allocator used to create buffers for the MemcpyFromHost, Shape and Size operators.
             m_cpuInputAllocator = std::make_shared<CPUAllocator>(OrtMemType::OrtMemTypeCPUInput);
@@ -3,28 +3,62 @@
 
 #include <emscripten.h>
 
+#include <algorithm>
+
 #include "core/framework/session_state.h"
 #include "core/providers/js/allocator.h"
 
 namespace onnxruntime {
 namespace js {
 
+JsCustomAllocator::JsCustomAllocator()
+    : IAllocator(
+          OrtMemoryInfo("JsCustomAllocator", OrtAllocatorType::OrtDeviceAllocator,
+                        OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0),
+                        0, OrtMemTypeDefault)),
+      buffer_cache_([this](void* p) {
+        buffer_sizes_.erase(p);
+        EM_ASM({ Module.jsepFree($0); }, p);
+      }) {
+}
+
+JsCustomAllocator::~JsCustomAllocator() = default;
+
 void* JsCustomAllocator::Alloc(size_t size) {
   if (size == 0) {
     return nullptr;
   }
 
-  void* p = EM_ASM_PTR({ return Module.jsepAlloc($0); }, size);
+  void* p = buffer_cache_.Take(size);
+  if (p == nullptr) {
+    p = EM_ASM_PTR({ return Module.jsepAlloc($0); }, size);
+    if (p == nullptr) {
+      return nullptr;
+    }
+    buffer_sizes_[p] = size;
+  }
+
   stats_.num_allocs++;
   stats_.bytes_in_use += size;
+  stats_.max_bytes_in_use = std::max(stats_.max_bytes_in_use, stats_.bytes_in_use);
   return p;
 }
 
 void JsCustomAllocator::Free(void* p) {
-  if (p != nullptr) {
-    size_t size = (size_t)(void*)EM_ASM_PTR({ return Module.jsepFree($0); }, p);
+  if (p == nullptr) {
+    return;
+  }
+
+  auto buffer_size = buffer_sizes_.find(p);
+  if (buffer_size != buffer_sizes_.end()) {
+    const size_t size = buffer_size->second;
     stats_.bytes_in_use -= size;
+    buffer_cache_.Put(p, size, std::min(kMaxCachedBytes, static_cast<size_t>(stats_.max_bytes_in_use)));
+    return;
   }
+
+  size_t size = (size_t)(void*)EM_ASM_PTR({ return Module.jsepFree($0); }, p);
+  stats_.bytes_in_use -= size;
 }
 
 void JsCustomAllocator::GetStats(AllocatorStats* stats) {
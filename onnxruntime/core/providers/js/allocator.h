@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include "core/common/inlined_containers.h"
 #include "core/framework/allocator.h"
 #include "core/framework/ortdevice.h"
+#include "core/providers/js/buffer_cache.h"
 
 namespace onnxruntime {
 namespace js {
@@ -20,19 +22,23 @@ class JsCPUAllocator : public CPUAllocator {
 
 class JsCustomAllocator : public IAllocator {
  public:
-  JsCustomAllocator()
-      : IAllocator(
-            OrtMemoryInfo("JsCustomAllocator", OrtAllocatorType::OrtDeviceAllocator,
-                          OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0),
-                          0, OrtMemTypeDefault)) {
-  }
+  JsCustomAllocator();
+  ~JsCustomAllocator() override;
 
   virtual void* Alloc(size_t size) override;
   virtual void Free(void* p) override;
   void GetStats(AllocatorStats* stats) override;
 
  private:
+  // Freed GPU buffers are kept and handed out again for tensors of the same size. The tensors of a model mostly have
+  // the same sizes from one run to the next, e.g. in every decoding step of an LLM, so this saves creating and
+  // destroying their GPU buffers in each run. The cached bytes are limited to this many bytes and to the high-water
+  // mark of the bytes in use, so that a small model does not keep more idle buffers than its working set.
+  static constexpr size_t kMaxCachedBytes = 64 * 1024 * 1024;
+
   AllocatorStats stats_;
+  InlinedHashMap<void*, size_t> buffer_sizes_;
+  BufferCache buffer_cache_;
 };
 
 }  // namespace js
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/js/buffer_cache.h"
+
+namespace onnxruntime {
+namespace js {
+
+BufferCache::~BufferCache() {
+  Trim(0);
+}
+
+void* BufferCache::Take(size_t size) {
+  auto it = entries_by_size_.find(size);
+  if (it == entries_by_size_.end()) {
+    return nullptr;
+  }
+
+  auto entry = it->second.back();
+  it->second.pop_back();
+  if (it->second.empty()) {
+    entries_by_size_.erase(it);
+  }
+  void* p = entry->p;
+  entries_.erase(entry);
+  cached_bytes_ -= size;
+  return p;
+}
+
+void BufferCache::Put(void* p, size_t size, size_t limit) {
+  if (size > limit) {
+    release_(p);
+    return;
+  }
+
+  entries_.push_front(Entry{p, size});
+  entries_by_size_[size].push_back(entries_.begin());
+  cached_bytes_ += size;
+  Trim(limit);
+}
+
+void BufferCache::Trim(size_t limit) {
+  while (cached_bytes_ > limit) {
+    const Entry entry = entries_.back();
+    auto& same_size_entries = entries_by_size_[entry.size];
+    // the least recently cached buffer is the first one of its size
+    same_size_entries.erase(same_size_entries.begin());
+    if (same_size_entries.empty()) {
+      entries_by_size_.erase(entry.size);
+    }
+    entries_.pop_back();
+    cached_bytes_ -= entry.size;
+    release_(entry.p);
+  }
+}
+
+}  // namespace js
+}  // namespace onnxruntime
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <list>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+
+namespace onnxruntime {
+namespace js {
+
+// Keeps freed buffers to hand them out again for buffers of the same size. The cache holds up to a limit of bytes,
+// releasing the least recently freed buffers first, so the buffers of sizes which are not used anymore, e.g. those of
+// the previous sequence lengths of an LLM, do not stay in the cache.
+class BufferCache {
+ public:
+  using ReleaseFn = std::function<void(void*)>;
+
+  explicit BufferCache(ReleaseFn release) : release_(std::move(release)) {}
+  ~BufferCache();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BufferCache);
+
+  // Returns a cached buffer of the size, or nullptr if there is none.
+  void* Take(size_t size);
+
+  // Caches the freed buffer, then releases the least recently cached buffers while the cached bytes exceed limit.
+  void Put(void* p, size_t size, size_t limit);
+
+  // Releases the least recently cached buffers while the cached bytes exceed limit.
+  void Trim(size_t limit);
+
+  size_t CachedBytes() const { return cached_bytes_; }
+
+ private:
+  struct Entry {
+    void* p;
+    size_t size;
+  };
+
+  ReleaseFn release_;
+  // the most recently cached buffer first
+  std::list<Entry> entries_;
+  // the cached buffers of each size, the most recently cached one last
+  InlinedHashMap<size_t, InlinedVector<std::list<Entry>::iterator>> entries_by_size_;
+  size_t cached_bytes_ = 0;
+};
+
+}  // namespace js
+}  // namespace onnxruntime
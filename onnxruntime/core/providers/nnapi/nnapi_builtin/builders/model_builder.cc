@@ -8,9 +8,11 @@
 #include "core/common/common.h"
 #include "core/common/inlined_containers_fwd.h"
 #include "core/common/logging/logging.h"
+#include "core/common/narrow.h"
 #include "core/common/safeint.h"
 #include "core/common/status.h"
 #include "core/framework/execution_provider.h"
+#include "core/framework/murmurhash3.h"
 #include "core/framework/node_unit.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_viewer.h"
@@ -42,6 +44,7 @@ ModelBuilder::ModelBuilder(const GraphViewer& graph_viewer, const NnApi& nnapi_h
   Status ModelBuilder::AddOperandFromScalar(scalar_type value, uint32_t& index) { \
     OperandType operandType(Type::op_type, InlinedVector<uint32_t>{});            \
     ORT_RETURN_IF_ERROR(AddNewNNAPIOperand(operandType, index));                  \
+    UpdateModelHash(&value, sizeof(value));                                       \
     RETURN_STATUS_ON_ERROR_WITH_NOTE(                                             \
         nnapi_.ANeuralNetworksModel_setOperandValue(                              \
             nnapi_model_->model_, index, &value, sizeof(value)),                  \
@@ -388,6 +391,11 @@ Status ModelBuilder::AddNewNNAPIOperand(const OperandType& operand_type, uint32_
       nnapi_.ANeuralNetworksModel_addOperand(nnapi_model_->model_, &operand_type.operandType));
   index = next_index_++;
 
+  UpdateModelHash(&operand_type.operandType.type, sizeof(operand_type.operandType.type));
+  UpdateModelHash(gsl::make_span(operand_type.dimensions));
+  UpdateModelHash(&operand_type.operandType.scale, sizeof(operand_type.operandType.scale));
+  UpdateModelHash(&operand_type.operandType.zeroPoint, sizeof(operand_type.operandType.zeroPoint));
+
   if (operand_type.channelQuant) {
     if (nnapi_effective_feature_level_ < ANEURALNETWORKS_FEATURE_LEVEL_3) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
@@ -397,6 +405,9 @@ Status ModelBuilder::AddNewNNAPIOperand(const OperandType& operand_type, uint32_
 
     RETURN_STATUS_ON_ERROR(nnapi_.ANeuralNetworksModel_setOperandSymmPerChannelQuantParams(
         nnapi_model_->model_, index, &operand_type.channelQuant->params));
+
+    UpdateModelHash(&operand_type.channelQuant->params.channelDim, sizeof(uint32_t));
+    UpdateModelHash(gsl::make_span(operand_type.channelQuant->scales));
   }
 
   return Status::OK();
@@ -412,6 +423,8 @@ void ModelBuilder::RegisterOperand(const std::string& name, uint32_t index,
 Status ModelBuilder::SetOperandValue(uint32_t index,
                                      Model::NNMemory* memory,
                                      size_t size, size_t offset) {
+  UpdateModelHash(memory->GetDataPtr() + offset, size);
+
 #ifdef USENNAPISHAREDMEM
   RETURN_STATUS_ON_ERROR(
       nnapi_.ANeuralNetworksModel_setOperandValueFromMemory(
@@ -440,6 +453,7 @@ Status ModelBuilder::AddOperandFromPersistMemoryBuffer(
   // for small size operand, the value will be copied
   // no need to persist
   if (size < ANEURALNETWORKS_MAX_SIZE_OF_IMMEDIATELY_COPIED_VALUES) {
+    UpdateModelHash(buffer, size);
     RETURN_STATUS_ON_ERROR(
         nnapi_.ANeuralNetworksModel_setOperandValue(
             nnapi_model_->model_, index,
@@ -508,6 +522,10 @@ Status ModelBuilder::AddOperation(int op, const InlinedVector<uint32_t>& input_i
     output_indices.push_back(index);
   }
 
+  UpdateModelHash(&op, sizeof(op));
+  UpdateModelHash(gsl::make_span(input_indices));
+  UpdateModelHash(gsl::make_span(output_indices));
+
   RETURN_STATUS_ON_ERROR_WITH_NOTE(
       nnapi_.ANeuralNetworksModel_addOperation(
           nnapi_model_->model_, op, static_cast<uint32_t>(input_indices.size()), &input_indices[0],
@@ -520,6 +538,17 @@ Status ModelBuilder::AddOperation(int op, const InlinedVector<uint32_t>& input_i
   return Status::OK();
 }
 
+void ModelBuilder::UpdateModelHash(const void* data, size_t size) {
+  // two differently seeded 128-bit hashes to fill the 256-bit compilation cache token
+  for (size_t half = 0; half < 2; ++half) {
+    uint32_t data_hash[4];
+    MurmurHash3::x86_128(data, narrow<int>(size), model_hash_[half * 4] ^ static_cast<uint32_t>(half), data_hash);
+    for (size_t i = 0; i < 4; ++i) {
+      model_hash_[half * 4 + i] = model_hash_[half * 4 + i] * 31 + data_hash[i];
+    }
+  }
+}
+
 Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
   ORT_RETURN_IF_ERROR(Prepare());
 
@@ -644,6 +673,26 @@ Status ModelBuilder::Compile(std::unique_ptr<Model>& model) {
           nnapi_model_->compilation_, static_cast<int32_t>(exe_pref_)),
       "on setPreference");
 
+  // The compilation cache is only available on API 29+
+  if (!compilation_cache_dir_.empty() && nnapi_effective_feature_level_ >= ANEURALNETWORKS_FEATURE_LEVEL_3 &&
+      nnapi_.ANeuralNetworksCompilation_setCaching != nullptr) {
+    // the compiled model also depends on the compilation settings and the devices it is compiled for
+    UpdateModelHash(gsl::make_span(input_index_vec_));
+    UpdateModelHash(gsl::make_span(output_index_vec_));
+    UpdateModelHash(&use_fp16_, sizeof(use_fp16_));
+    UpdateModelHash(&exe_pref_, sizeof(exe_pref_));
+    UpdateModelHash(&use_create_for_devices, sizeof(use_create_for_devices));
+    const std::string devices_description = GetDevicesDescription(nnapi_target_devices_);
+    UpdateModelHash(devices_description.data(), devices_description.size());
+
+    static_assert(sizeof(model_hash_) == 32, "The NNAPI compilation cache token is 32 bytes");
+    RETURN_STATUS_ON_ERROR_WITH_NOTE(
+        nnapi_.ANeuralNetworksCompilation_setCaching(
+            nnapi_model_->compilation_, compilation_cache_dir_.c_str(),
+            reinterpret_cast<const uint8_t*>(model_hash_.data())),
+        "on setCaching");
+  }
+
   RETURN_STATUS_ON_ERROR_WITH_NOTE(
       nnapi_.ANeuralNetworksCompilation_finish(nnapi_model_->compilation_),
       "on compilation finish");
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <onnx/onnx_pb.h>
+#include <array>
 #include <unordered_set>
 
 #include "core/common/inlined_containers_fwd.h"
@@ -80,6 +81,11 @@ class ModelBuilder {
   void SetExecutePreference(
       android::nn::wrapper::ExecutePreference pref) { exe_pref_ = pref; }
 
+  // Set the directory NNAPI caches the compiled model in, this is only available on Android API level 29+
+  // The cache token is a hash of the NNAPI model and the compilation settings
+  // Caching is off by default
+  void SetCompilationCacheDir(const std::string& cache_dir) { compilation_cache_dir_ = cache_dir; }
+
   // Accessors for members
   Shaper& GetShaper() { return shaper_; }
 
@@ -126,6 +132,11 @@ class ModelBuilder {
   android::nn::wrapper::ExecutePreference exe_pref_{
       android::nn::wrapper::ExecutePreference::PREFER_FAST_SINGLE_ANSWER};
 
+  std::string compilation_cache_dir_;
+  // Hash of everything added to the NNAPI model, used as the compilation cache token
+  // The size matches ANEURALNETWORKS_BYTE_SIZE_OF_CACHE_TOKEN
+  std::array<uint32_t, 8> model_hash_{};
+
   Shaper shaper_;
 
   std::unordered_map<std::string, uint32_t> operand_indices_;
@@ -195,6 +206,13 @@ class ModelBuilder {
 
   common::Status SetOperandValue(uint32_t index, Model::NNMemory* memory, size_t size, size_t offset);
 
+  // Add data defining the NNAPI model to model_hash_
+  void UpdateModelHash(const void* data, size_t size);
+  template <typename T>
+  void UpdateModelHash(gsl::span<T> values) {
+    UpdateModelHash(values.data(), values.size_bytes());
+  }
+
   common::Status AddNewNNAPIOperand(const android::nn::wrapper::OperandType& type, uint32_t& index);
   common::Status AddNewOperand(const std::string& name,
                                const android::nn::wrapper::OperandType& operand_type,
@@ -105,6 +105,9 @@ class Model {
   // this output may need special handling
   bool IsScalarOutput(const std::string& output_name) const;
 
+  // Create an execution for a single run
+  // The execution reuses the burst object of the model on Android API level 29+. This requires the caller to hold
+  // the lock from GetMutex() until the execution is done.
   common::Status PrepareForExecution(std::unique_ptr<Execution>& execution);
 
  private:
@@ -113,6 +116,10 @@ class Model {
   ANeuralNetworksModel* model_{nullptr};
   ANeuralNetworksCompilation* compilation_{nullptr};
 
+  // Burst object for the compilation, created on first use. Reusing it across runs lets the driver keep resources
+  // and the fast message queue to the accelerator alive between executions.
+  ANeuralNetworksBurst* burst_{nullptr};
+
   size_t dynamic_output_buffer_size_{1024};
 
   std::unique_ptr<NNMemory> mem_initializers_;
@@ -158,7 +165,9 @@ class Execution {
   };
 
  public:
-  explicit Execution(ANeuralNetworksExecution& execution /* , const Shaper& shaper */, const NnApi& nnapi_handle);
+  // If burst is not null the execution is computed with it, otherwise it is computed asynchronously and waited on
+  explicit Execution(ANeuralNetworksExecution& execution /* , const Shaper& shaper */, const NnApi& nnapi_handle,
+                     ANeuralNetworksBurst* burst = nullptr);
   ~Execution();
   Execution(const Execution&) = delete;
   Execution& operator=(const Execution&) = delete;
@@ -182,6 +191,7 @@ class Execution {
 
   const NnApi& nnapi_;
   ANeuralNetworksExecution* execution_;
+  ANeuralNetworksBurst* burst_;
   /* Shaper shaper_; */
 };
 
@@ -433,6 +433,7 @@ void BackendManager::Compute(OrtKernelContext* context) {
     std::vector<std::vector<int64_t>> tensor_shapes = GetInputTensorShapes(ctx);
     auto key = MakeMapKeyString(tensor_shapes, GetGlobalContext().device_type);
     std::shared_ptr<IBackend> dynamic_backend;
+    std::unique_lock<std::mutex> lock(backend_map_mutex_);
     auto search = backend_map_.find(key);
     if (search == backend_map_.end()) {
       LOGS_DEFAULT(INFO) << "[OpenVINO-EP] "
@@ -476,6 +477,7 @@ void BackendManager::Compute(OrtKernelContext* context) {
     } else {
       dynamic_backend = search->second;
     }
+    lock.unlock();
 
     dynamic_backend->Infer(context);
   } else {
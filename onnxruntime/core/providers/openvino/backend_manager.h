@@ -6,6 +6,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "core/providers/openvino/ov_interface.h"
@@ -50,6 +51,8 @@ class BackendManager {
   std::unique_ptr<ONNX_NAMESPACE::ModelProto> model_proto_;
   std::shared_ptr<IBackend> concrete_backend_;
   std::map<std::string, std::shared_ptr<IBackend>> backend_map_;
+  // Guards backend_map_ as concurrent Run calls may create dynamic backends at the same time
+  std::mutex backend_map_mutex_;
   SubGraphContext subgraph_context_;
   GlobalContext global_context_;
   EPCtxHandler ep_ctx_handle_{};
@@ -1,6 +1,7 @@
 // Copyright (C) Intel Corporation
 // Licensed under the MIT License
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <memory>
@@ -119,7 +120,17 @@ BasicBackend::BasicBackend(const ONNX_NAMESPACE::ModelProto& model_proto,
     ORT_THROW(msg);
   }
 
-  inferRequestsQueue_ = std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(exe_network_, 1));
+  // Size the pool by the number of requests the compiled model can run in parallel, so that concurrent Run calls
+  // overlap on the device instead of waiting for a single request
+  size_t num_infer_requests = 1;
+  try {
+    num_infer_requests = std::max<size_t>(
+        num_infer_requests, exe_network_.Get().get_property(ov::optimal_number_of_infer_requests));
+  } catch (const std::exception& e) {
+    LOGS_DEFAULT(INFO) << log_tag << "Using a single infer request: " << e.what();
+  }
+  LOGS_DEFAULT(INFO) << log_tag << "Number of infer requests: " << num_infer_requests;
+  inferRequestsQueue_ = std::unique_ptr<InferRequestsQueue>(new InferRequestsQueue(exe_network_, num_infer_requests));
 }
 
 bool BasicBackend::ValidateSubgraph(std::map<std::string, std::shared_ptr<ov::Node>>& const_outputs_map) {
@@ -163,6 +174,12 @@ void BasicBackend::PopulateConfigValue(ov::AnyMap& device_config) {
   if (global_context_.device_type.find("CPU") == std::string::npos)
     device_config.emplace(ov::hint::model_priority(global_context_.model_priority));
 
+  if (!global_context_.performance_hint.empty()) {
+    ov::hint::PerformanceMode performance_mode;
+    std::istringstream(global_context_.performance_hint) >> performance_mode;
+    device_config.emplace(ov::hint::performance_mode(performance_mode));
+  }
+
   if (global_context_.device_type.find("NPU") != std::string::npos) {
     std::pair<std::string, ov::Any> device_property;
     device_property = std::make_pair("NPU_COMPILER_TYPE", "DRIVER");
@@ -207,6 +224,10 @@ void BasicBackend::EnableStreams() {
   if (global_context_.device_type.find("NPU") != std::string::npos)
     return;
 
+  // The number of streams is derived from the performance hint if one is set
+  if (!global_context_.performance_hint.empty() && global_context_.num_streams == 1)
+    return;
+
   // Streams can be set only if the device is not one of AUTO, MULTI, or HETERO
   // Throw an exception if the user tries to set num_streams for these devices
   if ((global_context_.device_type.find("MULTI") != std::string::npos) ||
@@ -485,8 +506,7 @@ void BasicBackend::CompleteAsyncInference(Ort::KernelContext& context, OVInferRe
 }
 
 void BasicBackend::Infer(OrtKernelContext* ctx) {
-  // Preliminary Thread safety mechanism
-  // currently allows a maximum of 8 Infer request's to parallel execute at the same time
+  // Concurrent calls each take an idle infer request from the pool, so up to the size of the pool run in parallel
   Ort::KernelContext context(ctx);
 
   LOGS_DEFAULT(INFO) << log_tag << "Running graph " << subgraph_context_.subgraph_name;
@@ -28,6 +28,7 @@ struct GlobalContext {
   std::string model_precision;
   std::string cache_dir;
   std::string model_priority = "DEFAULT";
+  std::string performance_hint;
   int num_streams;
   std::vector<bool> deviceAvailableList = {true, true, true, true, true, true, true, true};
   std::string onnx_model_name;
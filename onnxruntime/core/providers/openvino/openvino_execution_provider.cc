@@ -24,6 +24,12 @@ OpenVINOExecutionProvider::OpenVINOExecutionProvider(const OpenVINOExecutionProv
   global_context_->precision_str = info.precision_;
   global_context_->enable_npu_fast_compile = info.enable_npu_fast_compile_;
   global_context_->cache_dir = info.cache_dir_;
+  if (global_context_->cache_dir.empty() && !info.export_ep_ctx_blob_) {
+    // Cache the compiled blobs by default if a cache location is configured for the environment,
+    // so that sessions of every application sharing it skip the model compilation after the first one.
+    global_context_->cache_dir = onnxruntime::GetEnvironmentVar("ORT_OPENVINO_CACHE_DIR");
+  }
+  global_context_->performance_hint = info.performance_hint_;
   global_context_->model_priority = info.model_priority_;
   global_context_->num_streams = info.num_streams_;
   global_context_->context = info.context_;
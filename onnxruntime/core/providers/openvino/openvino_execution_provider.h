@@ -83,6 +83,7 @@ struct OpenVINOExecutionProviderInfo {
   size_t num_of_threads_{0};
   std::string cache_dir_{""};
   std::string model_priority_{""};
+  std::string performance_hint_{""};
   int num_streams_{1};
   void* context_{NULL};
   bool enable_opencl_throttling_{false};
@@ -100,12 +101,13 @@ struct OpenVINOExecutionProviderInfo {
                                          int num_streams, void* context, bool enable_opencl_throttling,
                                          bool disable_dynamic_shapes, bool export_ep_ctx_blob,
                                          bool enable_qdq_optimizer, bool disable_cpu_fallback,
-                                         bool so_epctx_embed_mode)
+                                         bool so_epctx_embed_mode, const std::string& performance_hint)
       : precision_(std::move(precision)),
         enable_npu_fast_compile_(enable_npu_fast_compile),
         num_of_threads_(num_of_threads),
         cache_dir_(std::move(cache_dir)),
         model_priority_(std::move(model_priority)),
+        performance_hint_(performance_hint),
         num_streams_(num_streams),
         context_(context),
         enable_opencl_throttling_(enable_opencl_throttling),
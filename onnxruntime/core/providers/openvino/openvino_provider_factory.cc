@@ -15,7 +15,8 @@ struct OpenVINOProviderFactory : IExecutionProviderFactory {
                           bool enable_opencl_throttling, bool disable_dynamic_shapes,
                           bool export_ep_ctx_blob, bool enable_qdq_optimizer,
                           bool disable_cpu_fallback,
-                          bool so_epctx_embed_mode)
+                          bool so_epctx_embed_mode,
+                          const char* performance_hint)
       : precision_(precision),
         enable_npu_fast_compile_(enable_npu_fast_compile),
         num_of_threads_(num_of_threads),
@@ -30,6 +31,7 @@ struct OpenVINOProviderFactory : IExecutionProviderFactory {
         so_epctx_embed_mode_(so_epctx_embed_mode) {
     device_type_ = (device_type == nullptr) ? "" : device_type;
     cache_dir_ = (cache_dir == nullptr) ? "" : cache_dir;
+    performance_hint_ = (performance_hint == nullptr) ? "" : performance_hint;
   }
 
   ~OpenVINOProviderFactory() override {
@@ -52,6 +54,7 @@ struct OpenVINOProviderFactory : IExecutionProviderFactory {
   bool enable_qdq_optimizer_;
   bool disable_cpu_fallback_;
   bool so_epctx_embed_mode_;
+  std::string performance_hint_;
 };
 
 std::unique_ptr<IExecutionProvider> OpenVINOProviderFactory::CreateProvider() {
@@ -59,7 +62,7 @@ std::unique_ptr<IExecutionProvider> OpenVINOProviderFactory::CreateProvider() {
                                      cache_dir_, model_priority_, num_streams_, context_, enable_opencl_throttling_,
                                      disable_dynamic_shapes_, export_ep_ctx_blob_, enable_qdq_optimizer_,
                                      disable_cpu_fallback_,
-                                     so_epctx_embed_mode_);
+                                     so_epctx_embed_mode_, performance_hint_);
   return std::make_unique<OpenVINOExecutionProvider>(info);
 }
 
@@ -112,6 +115,11 @@ struct OpenVINO_Provider : Provider {
 
     bool so_epctx_embed_mode = true;
 
+    std::string performance_hint = "";       // [performance_hint]: High-level OpenVINO performance hint, one of
+                                             // LATENCY, THROUGHPUT or CUMULATIVE_THROUGHPUT. THROUGHPUT lets the
+                                             // device (including AUTO) pick the number of streams so that concurrent
+                                             // Run calls overlap.
+
     if (provider_options_map.find("device_type") != provider_options_map.end()) {
       device_type = provider_options_map.at("device_type").c_str();
 
@@ -224,6 +232,15 @@ struct OpenVINO_Provider : Provider {
                               << "Executing with num_streams=1";
       }
     }
+    if (provider_options_map.find("performance_hint") != provider_options_map.end()) {
+      performance_hint = provider_options_map.at("performance_hint");
+      std::vector<std::string> supported_hints({"LATENCY", "THROUGHPUT", "CUMULATIVE_THROUGHPUT"});
+      if (std::find(supported_hints.begin(), supported_hints.end(), performance_hint) == supported_hints.end()) {
+        ORT_THROW("[ERROR] [OpenVINO] The value for the key 'performance_hint' should be one of LATENCY, "
+                  "THROUGHPUT or CUMULATIVE_THROUGHPUT. \n");
+      }
+    }
+
     std::string bool_flag = "";
     if (provider_options_map.find("enable_npu_fast_compile") != provider_options_map.end()) {
       bool_flag = provider_options_map.at("enable_npu_fast_compile");
@@ -333,7 +350,8 @@ struct OpenVINO_Provider : Provider {
                                                      export_ep_ctx_blob,
                                                      enable_qdq_optimizer,
                                                      disable_cpu_fallback,
-                                                     so_epctx_embed_mode);
+                                                     so_epctx_embed_mode,
+                                                     performance_hint.c_str());
   }
 
   void Initialize() override {
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/providers/qnn/builder/onnx_ctx_model_helper.h"
+#include "core/framework/ep_context_package.h"
 #include "core/graph/constants.h"
 #include "core/providers/qnn/builder/qnn_model.h"
 
@@ -91,74 +92,38 @@ Status CreateNodeArgs(const std::vector<std::string>& names,
 Status GetEpContextFromMainNode(const onnxruntime::Node& main_context_node,
                                 const onnxruntime::PathString& ctx_onnx_model_path,
                                 QnnBackendManager* qnn_backend_manager,
-                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models) {
+                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                bool share_ep_contexts) {
   ORT_RETURN_IF_NOT(EPCONTEXT_OP == main_context_node.OpType(), "Should only filter in the EPContext node.");
-  NodeAttrHelper node_helper(main_context_node);
-  bool is_embed_mode = node_helper.Get(EMBED_MODE, true);
-  if (is_embed_mode) {
-    const std::string& context_binary = node_helper.Get(EP_CACHE_CONTEXT, "");
-    return qnn_backend_manager->LoadCachedQnnContextFromBuffer(const_cast<char*>(context_binary.c_str()),
-                                                               static_cast<uint64_t>(context_binary.length()),
-                                                               main_context_node.Name(),
-                                                               qnn_models);
+  InlinedVector<ep_context::Variant> variants;
+  ORT_RETURN_IF_ERROR(ep_context::GetVariants(main_context_node, variants));
+  ORT_RETURN_IF(variants.empty(), "The EPContext node ", main_context_node.Name(), " has no ep_cache_context.");
+
+  // Prefer the context binary of the QNN SDK version in use. Otherwise load the first one, which was the only
+  // one before EPContext nodes could hold several variants, and let QNN reject it if it is incompatible.
+  const ep_context::Variant* variant = ep_context::SelectVariant(variants, "", qnn_backend_manager->GetSdkVersion());
+  if (variant == nullptr) {
+    variant = &variants.front();
   }
 
-  std::filesystem::path folder_path = std::filesystem::path(ctx_onnx_model_path).parent_path();
-  std::string external_qnn_ctx_binary_file_name = node_helper.Get(EP_CACHE_CONTEXT, "");
-  ORT_RETURN_IF(external_qnn_ctx_binary_file_name.empty(), "The file path in ep_cache_context should not be empty.");
-#ifdef _WIN32
-  onnxruntime::PathString external_qnn_context_binary_path = onnxruntime::ToPathString(external_qnn_ctx_binary_file_name);
-  auto ctx_file_path = std::filesystem::path(external_qnn_context_binary_path.c_str());
-  ORT_RETURN_IF(ctx_file_path.is_absolute(), "External mode should set ep_cache_context field with a relative path, but it is an absolute path: ",
-                external_qnn_ctx_binary_file_name);
-  auto relative_path = ctx_file_path.lexically_normal().make_preferred().wstring();
-  if (relative_path.find(L"..", 0) != std::string::npos) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context field has '..'. It's not allowed to point outside the directory.");
-  }
-
-  std::filesystem::path context_binary_path = folder_path.append(relative_path);
-#else
-  ORT_RETURN_IF(external_qnn_ctx_binary_file_name[0] == '/',
-                "External mode should set ep_cache_context field with a relative path, but it is an absolute path: ",
-                external_qnn_ctx_binary_file_name);
-  if (external_qnn_ctx_binary_file_name.find("..", 0) != std::string::npos) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context field has '..'. It's not allowed to point outside the directory.");
-  }
-  std::filesystem::path context_binary_path = folder_path.append(external_qnn_ctx_binary_file_name);
-  std::string file_full_path = context_binary_path.string();
-#endif
-  if (!std::filesystem::is_regular_file(context_binary_path)) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_GRAPH, "The file path in ep_cache_context does not exist or is not accessible.");
-  }
-
-  size_t buffer_size{0};
-  std::ifstream cache_file(context_binary_path.string().c_str(), std::ifstream::binary);
-  ORT_RETURN_IF(!cache_file || !cache_file.good(), "Failed to open cache file.");
-
-  cache_file.seekg(0, cache_file.end);
-  buffer_size = static_cast<size_t>(cache_file.tellg());
-  ORT_RETURN_IF(0 == buffer_size, "Empty cache file encountered.");
-
-  cache_file.seekg(0, cache_file.beg);
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(buffer_size);
-  ORT_RETURN_IF(nullptr == buffer, "Failed to allocate memory for cache file.");
-  // Load file into buffer
-  const auto& read_result = cache_file.read(buffer.get(), buffer_size);
-  ORT_RETURN_IF(!read_result, "Failed to read contents from cached context file.");
-  cache_file.close();
-  return qnn_backend_manager->LoadCachedQnnContextFromBuffer(buffer.get(),
-                                                             static_cast<uint64_t>(buffer_size),
+  ep_context::Blob blob;
+  ORT_RETURN_IF_ERROR(ep_context::LoadBlob(main_context_node, *variant, ctx_onnx_model_path, blob));
+  return qnn_backend_manager->LoadCachedQnnContextFromBuffer(const_cast<char*>(blob.data.data()),
+                                                             static_cast<uint64_t>(blob.data.size()),
                                                              main_context_node.Name(),
-                                                             qnn_models);
+                                                             qnn_models,
+                                                             share_ep_contexts);
 }
 
 Status LoadQnnCtxFromOnnxGraph(const onnxruntime::GraphViewer& graph_viewer,
                                const onnxruntime::PathString& ctx_onnx_model_path,
                                QnnBackendManager* qnn_backend_manager,
                                std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
-                               const logging::Logger& logger) {
+                               const logging::Logger& logger,
+                               bool share_ep_contexts) {
   for (const auto& ep_context_node : graph_viewer.Nodes()) {
-    Status status = GetEpContextFromMainNode(ep_context_node, ctx_onnx_model_path, qnn_backend_manager, qnn_models);
+    Status status = GetEpContextFromMainNode(ep_context_node, ctx_onnx_model_path, qnn_backend_manager, qnn_models,
+                                             share_ep_contexts);
 
     // This is the protocol with customer that status with INVALID_GRAPH will be generated if failed to load context model
     if (!status.IsOK()) {
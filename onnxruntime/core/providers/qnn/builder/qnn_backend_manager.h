@@ -87,9 +87,12 @@ class QnnBackendManager {
 
   std::unique_ptr<unsigned char[]> GetContextBinaryBuffer(uint64_t& written_buffer_size);
 
+  // With share_ep_contexts, the graphs of the context that are not in qnn_models are added to it instead of failing,
+  // for the other sessions sharing the context.
   Status LoadCachedQnnContextFromBuffer(char* buffer, uint64_t buffer_length,
                                         std::string node_name,
-                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models);
+                                        std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>>& qnn_models,
+                                        bool share_ep_contexts = false);
 
   Status SetupBackend(const logging::Logger& logger, bool load_from_cached_context);
 
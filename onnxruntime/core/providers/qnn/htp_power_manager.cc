@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/qnn/htp_power_manager.h"
+
+#include "core/common/logging/logging.h"
+
+namespace onnxruntime {
+
+HtpPowerManager& HtpPowerManager::GetInstance() {
+  static HtpPowerManager instance;
+  return instance;
+}
+
+HtpPowerManager::~HtpPowerManager() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  if (vote_thread_.joinable()) {
+    vote_thread_.join();
+  }
+}
+
+void HtpPowerManager::VoteWhenIdle(qnn::QnnBackendManager* qnn_backend_manager, uint32_t htp_power_config_id,
+                                   qnn::HtpPerformanceMode mode, std::chrono::milliseconds idle_timeout) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_votes_[{qnn_backend_manager, htp_power_config_id}] =
+        PendingVote{mode, std::chrono::steady_clock::now() + idle_timeout};
+    if (!vote_thread_.joinable()) {
+      vote_thread_ = std::thread(&HtpPowerManager::VoteLoop, this);
+    }
+  }
+  cv_.notify_all();
+}
+
+void HtpPowerManager::CancelVote(qnn::QnnBackendManager* qnn_backend_manager, uint32_t htp_power_config_id) {
+  // waits for the vote being made through the client, if any
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_votes_.erase({qnn_backend_manager, htp_power_config_id});
+}
+
+void HtpPowerManager::VoteLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    if (pending_votes_.empty()) {
+      cv_.wait(lock);
+      continue;
+    }
+
+    auto next = pending_votes_.begin();
+    for (auto it = pending_votes_.begin(); it != pending_votes_.end(); ++it) {
+      if (it->second.deadline < next->second.deadline) {
+        next = it;
+      }
+    }
+    if (std::chrono::steady_clock::now() < next->second.deadline) {
+      cv_.wait_until(lock, next->second.deadline);
+      continue;
+    }
+
+    // The lock is held while voting, so that the client is not destroyed meanwhile
+    auto* qnn_backend_manager = next->first.first;
+    const auto status = qnn_backend_manager->SetHtpPowerConfig(next->first.second, next->second.mode);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(WARNING) << "Failed to vote the HTP performance mode of an idle session: " << status.ErrorMessage();
+    }
+    pending_votes_.erase(next);
+  }
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "core/common/common.h"
+#include "core/providers/qnn/builder/qnn_backend_manager.h"
+#include "core/providers/qnn/builder/qnn_def.h"
+
+namespace onnxruntime {
+
+// Lowers the HTP performance votes of the sessions of the process once they have been idle for a while.
+// Each thread running a session votes through its own HTP power config client, the HTP combines the votes of the
+// clients. A vote to lower, e.g. to a power saver mode after an interactive run, is held back until no run voted
+// through the client for the idle timeout, so back to back runs do not switch the clocks down and up again.
+// One thread serves the delayed votes of all the sessions.
+class HtpPowerManager {
+ public:
+  static HtpPowerManager& GetInstance();
+
+  // Votes mode through the client once it has been idle for idle_timeout, replacing a pending vote of the client.
+  void VoteWhenIdle(qnn::QnnBackendManager* qnn_backend_manager, uint32_t htp_power_config_id,
+                    qnn::HtpPerformanceMode mode, std::chrono::milliseconds idle_timeout);
+
+  // Drops the pending vote of the client, when it votes again or before it is destroyed.
+  void CancelVote(qnn::QnnBackendManager* qnn_backend_manager, uint32_t htp_power_config_id);
+
+ private:
+  HtpPowerManager() = default;
+  ~HtpPowerManager();
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(HtpPowerManager);
+
+  void VoteLoop();
+
+  struct PendingVote {
+    qnn::HtpPerformanceMode mode;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  using Client = std::pair<qnn::QnnBackendManager*, uint32_t>;
+  std::map<Client, PendingVote> pending_votes_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::thread vote_thread_;
+  bool stop_ = false;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "qnn_execution_provider.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <unordered_set>
 #include "core/framework/compute_capability.h"
@@ -22,6 +23,8 @@
 #include "core/providers/qnn/builder/qnn_node_group.h"
 #include "core/providers/qnn/builder/qnn_def.h"
 #include "core/providers/qnn/builder/onnx_ctx_model_helper.h"
+#include "core/providers/qnn/htp_power_manager.h"
+#include "core/providers/qnn/shared_context.h"
 #include "core/framework/run_options.h"
 
 #ifdef _WIN32
@@ -206,6 +209,10 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     // User can set this context_node_name_prefix for each split pieces to avoid that happens.
     context_node_name_prefix_ = session_options->config_options.GetConfigOrDefault(kOrtSessionOptionEpContextNodeNamePrefix, "");
     LOGS_DEFAULT(VERBOSE) << "User specified QNN context node name prefix: " << context_node_name_prefix_;
+
+    share_ep_contexts_ = session_options->config_options.GetConfigOrDefault(
+                             kOrtSessionOptionShareEpContexts, "0") == "1";
+    LOGS_DEFAULT(VERBOSE) << "User specified option - share EP contexts across sessions: " << share_ep_contexts_;
   }
 
   static const std::string BACKEND_PATH = "backend_path";
@@ -385,16 +392,24 @@ QNNExecutionProvider::QNNExecutionProvider(const ProviderOptions& provider_optio
     LOGS_DEFAULT(VERBOSE) << "User specified enable_htp_fp16_precision: " << enable_HTP_FP16_precision_;
   }
 
-  qnn_backend_manager_ = std::make_unique<qnn::QnnBackendManager>(
-      std::move(backend_path),
-      profiling_level_etw,
-      profiling_level,
-      std::move(profiling_file_path),
-      context_priority,
-      std::move(qnn_saver_path),
-      device_id_,
-      htp_arch,
-      soc_model);
+  auto create_backend_manager = [&]() {
+    return std::make_shared<qnn::QnnBackendManager>(
+        std::move(backend_path),
+        profiling_level_etw,
+        profiling_level,
+        std::move(profiling_file_path),
+        context_priority,
+        std::move(qnn_saver_path),
+        device_id_,
+        htp_arch,
+        soc_model);
+  };
+  if (share_ep_contexts_) {
+    // the options of the first session sharing the contexts are used
+    qnn_backend_manager_ = SharedContext::GetInstance().GetOrCreateBackendManager(create_backend_manager);
+  } else {
+    qnn_backend_manager_ = create_backend_manager();
+  }
 }
 
 QNNExecutionProvider::~QNNExecutionProvider() {
@@ -575,7 +590,9 @@ QNNExecutionProvider::GetCapability(const onnxruntime::GraphViewer& graph_viewer
 
   // It will load the QnnSystem lib if is_qnn_ctx_model=true, and
   // delay the Qnn context creation to Compile() using the cached context binary
-  auto rt = qnn_backend_manager_->SetupBackend(logger, is_qnn_ctx_model);
+  // The shared backend manager outlives the session, it does not log to the session logger
+  auto rt = qnn_backend_manager_->SetupBackend(share_ep_contexts_ ? logging::LoggingManager::DefaultLogger() : logger,
+                                               is_qnn_ctx_model);
   if (Status::OK() != rt) {
     LOGS(logger, ERROR) << "QNN SetupBackend failed " << rt.ErrorMessage();
     return result;
@@ -811,14 +828,44 @@ Status QNNExecutionProvider::Compile(const std::vector<FusedNodeAndGraph>& fused
     ORT_RETURN_IF_ERROR(qnn::GetMainContextNode(fused_nodes_and_graphs, qnn_backend_manager_.get(),
                                                 logger, main_context_pos_list, qnn_models));
 
-    for (auto main_context_pos : main_context_pos_list) {
-      const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
-      // Create QNN context from the cached binary, deserialize the QNN graph from the binary
-      ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
-                                                       context_cache_path,
-                                                       qnn_backend_manager_.get(),
-                                                       qnn_models,
-                                                       logger));
+    std::vector<std::string> ep_context_node_names;
+    for (const auto& qnn_model : qnn_models) {
+      ep_context_node_names.push_back(qnn_model.first);
+    }
+    auto& shared_context = SharedContext::GetInstance();
+    if (share_ep_contexts_ && shared_context.HasQnnModels(ep_context_node_names)) {
+      // Another session already loaded the context binary, use its graphs instead of loading it again
+      LOGS(logger, VERBOSE) << "Using the QNN graphs loaded by another session sharing the EP contexts.";
+      for (const auto& name : ep_context_node_names) {
+        qnn_models[name] = shared_context.TakeQnnModel(name);
+        ORT_RETURN_IF(qnn_models[name] == nullptr, "The shared QNN graph ", name, " was taken by another session.");
+      }
+    } else {
+      for (auto main_context_pos : main_context_pos_list) {
+        const onnxruntime::GraphViewer& main_ctx_graph_viewer(fused_nodes_and_graphs[main_context_pos].filtered_graph);
+        // Create QNN context from the cached binary, deserialize the QNN graph from the binary
+        ORT_RETURN_IF_ERROR(qnn::LoadQnnCtxFromOnnxGraph(main_ctx_graph_viewer,
+                                                         context_cache_path,
+                                                         qnn_backend_manager_.get(),
+                                                         qnn_models,
+                                                         logger,
+                                                         share_ep_contexts_));
+      }
+
+      if (share_ep_contexts_) {
+        // Keep the graphs of the context binary that belong to the other sessions
+        for (auto it = qnn_models.begin(); it != qnn_models.end();) {
+          if (std::find(ep_context_node_names.begin(), ep_context_node_names.end(), it->first) ==
+              ep_context_node_names.end()) {
+            if (!shared_context.AddQnnModel(it->first, std::move(it->second))) {
+              LOGS(logger, WARNING) << "A shared QNN graph named " << it->first << " exists already, it is not replaced.";
+            }
+            it = qnn_models.erase(it);
+          } else {
+            ++it;
+          }
+        }
+      }
     }
 
     for (auto fused_node_and_graph : fused_nodes_and_graphs) {
@@ -898,6 +945,7 @@ QNNExecutionProvider::PerThreadContext::PerThreadContext(qnn::QnnBackendManager*
 
 QNNExecutionProvider::PerThreadContext::~PerThreadContext() {
   if (is_htp_power_config_id_valid_) {
+    HtpPowerManager::GetInstance().CancelVote(qnn_backend_manager_, htp_power_config_id_);
     ORT_IGNORE_RETURN_VALUE(qnn_backend_manager_->DestroyHTPPowerConfigID(htp_power_config_id_));
   }
 }
@@ -980,6 +1028,8 @@ Status QNNExecutionProvider::OnRunStart(const onnxruntime::RunOptions& run_optio
 
   if (GetPerThreadContext().IsHtpPowerConfigIdValid()) {
     if (qnn::HtpPerformanceMode::kHtpDefault != htp_performance_mode) {
+      // the vote of this run replaces the one the previous run left for when the thread is idle
+      HtpPowerManager::GetInstance().CancelVote(qnn_backend_manager_.get(), GetPerThreadContext().GetHtpPowerConfigId());
       ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetHtpPowerConfig(GetPerThreadContext().GetHtpPowerConfigId(),
                                                                   htp_performance_mode));
     }
@@ -1006,12 +1056,27 @@ Status QNNExecutionProvider::OnRunEnd(bool /*sync_stream*/, const onnxruntime::R
     ParseHtpPerformanceMode(htp_perf_mode, htp_performance_mode);
   }
 
+  std::string idle_timeout = "";
+  uint32_t idle_timeout_ms = 0;
+  if (run_options.config_options.TryGetConfigEntry(kOrtRunOptionsConfigQnnPerfModePostRunIdleTimeout, idle_timeout)) {
+    idle_timeout_ms = static_cast<uint32_t>(std::stoul(idle_timeout));
+    LOGS_DEFAULT(VERBOSE) << "htp_perf_mode_post_run_idle_timeout_ms: " << idle_timeout_ms;
+  }
+
   if (qnn::HtpPerformanceMode::kHtpDefault != htp_performance_mode) {
     if (!GetPerThreadContext().IsHtpPowerConfigIdValid()) {
       return Status::OK();
     }
-    ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetHtpPowerConfig(GetPerThreadContext().GetHtpPowerConfigId(),
-                                                                htp_performance_mode));
+    if (idle_timeout_ms > 0) {
+      HtpPowerManager::GetInstance().VoteWhenIdle(qnn_backend_manager_.get(),
+                                                  GetPerThreadContext().GetHtpPowerConfigId(),
+                                                  htp_performance_mode,
+                                                  std::chrono::milliseconds(idle_timeout_ms));
+    } else {
+      HtpPowerManager::GetInstance().CancelVote(qnn_backend_manager_.get(), GetPerThreadContext().GetHtpPowerConfigId());
+      ORT_RETURN_IF_ERROR(qnn_backend_manager_->SetHtpPowerConfig(GetPerThreadContext().GetHtpPowerConfigId(),
+                                                                  htp_performance_mode));
+    }
   }
 
   return Status::OK();
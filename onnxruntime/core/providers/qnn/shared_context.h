@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/platform/ort_mutex.h"
+#include "core/providers/qnn/builder/qnn_backend_manager.h"
+#include "core/providers/qnn/builder/qnn_model.h"
+
+namespace onnxruntime {
+
+// QNN backend and models shared by the sessions of the process when ep.share_ep_contexts is enabled.
+// The sessions use one backend manager, so the QNN contexts and the weights they hold are created once. The graphs
+// loaded from a context binary that no EPContext node of the loading session refers to are kept here until the
+// session whose EPContext nodes refer to them takes them.
+class SharedContext {
+ public:
+  static SharedContext& GetInstance() {
+    static SharedContext instance;
+    return instance;
+  }
+
+  // Returns the backend manager of the sessions sharing their contexts, creating it with create if there is none.
+  // The sessions own it, it is released with the last of them.
+  std::shared_ptr<qnn::QnnBackendManager> GetOrCreateBackendManager(
+      const std::function<std::shared_ptr<qnn::QnnBackendManager>()>& create) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    auto backend_manager = backend_manager_.lock();
+    if (!backend_manager) {
+      // the models left refer to the released backend manager
+      shared_qnn_models_.clear();
+      backend_manager = create();
+      backend_manager_ = backend_manager;
+    }
+    return backend_manager;
+  }
+
+  bool HasQnnModels(const std::vector<std::string>& names) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    if (backend_manager_.expired()) {
+      return false;
+    }
+    for (const auto& name : names) {
+      if (shared_qnn_models_.find(name) == shared_qnn_models_.end()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::unique_ptr<qnn::QnnModel> TakeQnnModel(const std::string& name) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    auto it = shared_qnn_models_.find(name);
+    if (it == shared_qnn_models_.end() || backend_manager_.expired()) {
+      return nullptr;
+    }
+    auto qnn_model = std::move(it->second);
+    shared_qnn_models_.erase(it);
+    return qnn_model;
+  }
+
+  // Keeps a model created by the shared backend manager. Returns false if there is one with this name already.
+  bool AddQnnModel(const std::string& name, std::unique_ptr<qnn::QnnModel>&& qnn_model) {
+    const std::lock_guard<OrtMutex> lock(mtx_);
+    return shared_qnn_models_.emplace(name, std::move(qnn_model)).second;
+  }
+
+ private:
+  SharedContext() = default;
+  ~SharedContext() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SharedContext);
+
+  std::weak_ptr<qnn::QnnBackendManager> backend_manager_;
+  std::unordered_map<std::string, std::unique_ptr<qnn::QnnModel>> shared_qnn_models_;
+  OrtMutex mtx_;
+};
+
+}  // namespace onnxruntime
@@ -25,6 +25,7 @@
 #include <map>
 #include <memory>
 #include <filesystem>
+#include <optional>
 // TODO: find a better way to share this
 #include "core/providers/cuda/cuda_stream_handle.h"
 
@@ -239,14 +240,27 @@ inline std::vector<char> loadTimingCacheFile(const std::string inFileName) {
   return content;
 }
 
-inline void saveTimingCacheFile(const std::string outFileName, const nvinfer1::IHostMemory* blob) {
-  std::ofstream oFile(outFileName, std::ios::out | std::ios::binary);
-  if (!oFile) {
+// Merges the entries that other processes saved since the timing cache was loaded into it, then saves it.
+inline bool saveTimingCacheFile(const std::string outFileName, nvinfer1::IBuilderConfig& config,
+                                nvinfer1::ITimingCache& timing_cache) {
+  CacheFileLock lock(outFileName);
+  if (std::filesystem::exists(outFileName)) {
+    std::vector<char> saved_cache = loadTimingCacheFile(outFileName);
+    std::unique_ptr<nvinfer1::ITimingCache> saved_timing_cache{
+        config.createTimingCache(static_cast<const void*>(saved_cache.data()), saved_cache.size())};
+    if (saved_timing_cache == nullptr || !timing_cache.combine(*saved_timing_cache, true)) {
+      LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not merge the timing cache saved in: " << outFileName;
+    }
+  }
+
+  std::unique_ptr<nvinfer1::IHostMemory> blob{timing_cache.serialize()};
+  if (blob == nullptr) {
+    return false;
+  }
+  if (!WriteCacheFile(outFileName, blob->data(), blob->size())) {
     LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write timing cache to: " << outFileName;
-    return;
   }
-  oFile.write((char*)blob->data(), blob->size());
-  oFile.close();
+  return true;
 }
 }  // namespace
 
@@ -585,6 +599,23 @@ bool ApplyProfileShapesFromProviderOptions(std::vector<nvinfer1::IOptimizationPr
   return true;
 }
 
+/*
+ * Round a profile dimension to a power of two, down for a lower bound and up for an upper bound.
+ */
+int64_t RoundProfileDimension(int64_t dim, bool round_up) {
+  if (dim <= 1) {
+    return dim;
+  }
+  int64_t power = 1;
+  while (power * 2 <= dim) {
+    power *= 2;
+  }
+  if (power == dim || !round_up) {
+    return power;
+  }
+  return std::min<int64_t>(power * 2, std::numeric_limits<int32_t>::max());
+}
+
 /*
  * Apply TensorRT optimization profile shapes from input tensor value.
  *
@@ -593,6 +624,8 @@ bool ApplyProfileShapesFromProviderOptions(std::vector<nvinfer1::IOptimizationPr
  *
  * @param shape_tensor_values holds "shape tensor -> shape values" for the INT32 shape tensor input across this inference run
  * @param shape_tensor_values_int64 holds "shape tensor -> shape values" for the INT64 shape tensor input across this inference run
+ * @param profile_growth_enable rounds the updated bounds of the execution tensor dimensions to powers of two, so that
+ *        shapes growing across runs only rebuild the engine a logarithmic number of times
  */
 Status ApplyProfileShapesFromInputTensorValue(std::vector<nvinfer1::IOptimizationProfile*>& trt_profiles,
                                               Ort::KernelContext ctx,
@@ -602,7 +635,8 @@ Status ApplyProfileShapesFromInputTensorValue(std::vector<nvinfer1::IOptimizatio
                                               std::unordered_map<std::string, std::vector<int32_t>>& shape_tensor_values,
                                               std::unordered_map<std::string, std::vector<int64_t>>& shape_tensor_values_int64,
                                               cudaStream_t stream,
-                                              bool* engine_update) {
+                                              bool* engine_update,
+                                              bool profile_growth_enable) {
   for (size_t i = 0; i < trt_profiles.size(); i++) {
     const std::string& input_name = input->getName();
     nvinfer1::Dims dims = input->getDimensions();
@@ -749,15 +783,15 @@ Status ApplyProfileShapesFromInputTensorValue(std::vector<nvinfer1::IOptimizatio
 
           // Update minimum dimension
           if (tensor_shape < shape_range[0]) {
-            shape_range[0] = tensor_shape;
-            dims_min.d[j] = static_cast<int32_t>(tensor_shape);
+            shape_range[0] = profile_growth_enable ? RoundProfileDimension(tensor_shape, false) : tensor_shape;
+            dims_min.d[j] = static_cast<int32_t>(shape_range[0]);
             *engine_update = true;
           }
           // Update maximum dimension
           if (tensor_shape > shape_range[1]) {
-            shape_range[1] = tensor_shape;
+            shape_range[1] = profile_growth_enable ? RoundProfileDimension(tensor_shape, true) : tensor_shape;
             shape_range[2] = tensor_shape;
-            dims_max.d[j] = static_cast<int32_t>(tensor_shape);
+            dims_max.d[j] = static_cast<int32_t>(shape_range[1]);
             dims_opt.d[j] = static_cast<int32_t>(tensor_shape);
             *engine_update = true;
           }
@@ -1379,6 +1413,7 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
     profile_opt_shapes = info.profile_opt_shapes;
     cuda_graph_enable_ = info.cuda_graph_enable;
     engine_hw_compatible_ = info.engine_hw_compatible;
+    profile_growth_enable_ = info.profile_growth_enable;
   } else {
     try {
       const std::string max_partition_iterations_env = onnxruntime::GetEnvironmentVar(tensorrt_env_vars::kMaxPartitionIterations);
@@ -1766,6 +1801,7 @@ TensorrtExecutionProvider::TensorrtExecutionProvider(const TensorrtExecutionProv
                         << ", trt_ep_context_embed_mode: " << ep_context_embed_mode_
                         << ", trt_cache_prefix: " << cache_prefix_
                         << ", trt_engine_hw_compatible: " << engine_hw_compatible_
+                        << ", trt_profile_growth_enable: " << profile_growth_enable_
                         << ", trt_onnx_model_bytestream_size_: " << onnx_model_bytestream_size_;
 }
 
@@ -2673,9 +2709,11 @@ common::Status TensorrtExecutionProvider::RefitEngine(std::string onnx_model_fil
   if (serialize_refitted_engine) {
     std::string refitted_engine_cache = GetWeightRefittedEnginePath(weight_stripped_engine_cath_path);
     nvinfer1::IHostMemory* serialized_engine = trt_engine->serialize();
-    std::ofstream engine_file(refitted_engine_cache, std::ios::binary | std::ios::out);
-    engine_file.write(reinterpret_cast<const char*>(serialized_engine->data()), serialized_engine->size());
-    LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialize the refitted engine to " << refitted_engine_cache;
+    if (WriteCacheFile(refitted_engine_cache, serialized_engine->data(), serialized_engine->size())) {
+      LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialize the refitted engine to " << refitted_engine_cache;
+    } else {
+      LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write the refitted engine to " << refitted_engine_cache;
+    }
   }
   return Status::OK();
 #else
@@ -3087,6 +3125,12 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       // ifstream file check, engine serialization/deserialization and engine build are in critical section. It needs lock protection to prevent race condition when inferencing with multithreading.
       auto lock = GetApiLock();
 
+      // Other processes sharing the engine cache wait until this one built and saved the engine, then load it.
+      std::optional<CacheFileLock> cache_lock;
+      if (engine_cache_enable_) {
+        cache_lock.emplace(cache_path_prefix);
+      }
+
       // If explicit profile flag is on and engine cache enable flag is on,
       // we need to compare explicit profiles and profiles used to build the engine in order to decide whether to rebuild the engine.
       if (has_explicit_profile && engine_cache_enable_) {
@@ -3200,21 +3244,18 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
             } else {
               LOGS_DEFAULT(WARNING) << "[TensorRT EP] Engine cache encryption function is not found. No cache is written to disk";
             }
-          } else {
-            std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
-            file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
+          } else if (WriteCacheFile(engine_cache_path, serialized_engine->data(), serialized_engine->size())) {
             LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized engine " + engine_cache_path;
+          } else {
+            LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write engine cache to: " + engine_cache_path;
           }
         }
         // serialize and save timing cache
         if (timing_cache_enable_) {
-          auto timing_cache = trt_config->getTimingCache();
-          std::unique_ptr<nvinfer1::IHostMemory> timingCacheHostData{timing_cache->serialize()};
-          if (timingCacheHostData == nullptr) {
+          if (!saveTimingCacheFile(timing_cache_path, *trt_config, *timing_cache)) {
             return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
                                    "TensorRT EP could not serialize timing cache: " + timing_cache_path);
           }
-          saveTimingCacheFile(timing_cache_path, timingCacheHostData.get());
           if (detailed_build_log_) {
             LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
           }
@@ -3460,6 +3501,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
 
     // Load serialized engine
     if (trt_state->engine_cache_enable && trt_engine == nullptr) {
+      CacheFileLock cache_lock(cache_path_prefix);
       std::ifstream engine_file(engine_cache_path, std::ios::binary | std::ios::in);
       std::ifstream profile_file(profile_cache_path, std::ios::binary | std::ios::in);
       if (engine_file && !trt_state->engine_decryption_enable && profile_file) {
@@ -3525,7 +3567,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       // If there is any input tensor in shape_ranges, it means this input tensor has dynamic shape and its profile shape values have not yet resolved.
       // TRT EP will help determine the min/max/opt profile values based on current input tensor value.
       if (shape_ranges.find(input_name) != shape_ranges.end()) {
-        auto status = ApplyProfileShapesFromInputTensorValue(trt_profiles, ctx, input, shape_ranges, input_indexes, shape_tensor_values, shape_tensor_values_int64, stream, &engine_update);
+        auto status = ApplyProfileShapesFromInputTensorValue(trt_profiles, ctx, input, shape_ranges, input_indexes, shape_tensor_values, shape_tensor_values_int64, stream, &engine_update, profile_growth_enable_);
         if (status != Status::OK()) {
           return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL, "TensorRT EP failed to parse input tensor and generate optimization profiles.");
         }
@@ -3673,6 +3715,7 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
       }
       trt_engine = trt_state->engine->get();
       if (trt_state->engine_cache_enable) {
+        CacheFileLock cache_lock(cache_path_prefix);
         // Serialize engine profile
         SerializeProfileV2(profile_cache_path, shape_ranges);
         LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + profile_cache_path;
@@ -3689,22 +3732,19 @@ Status TensorrtExecutionProvider::CreateNodeComputeInfoFromGraph(const GraphView
           } else {
             LOGS_DEFAULT(WARNING) << "[TensorRT EP] Engine cache encryption function is not found. No cache is written to disk";
           }
-        } else {
-          std::ofstream file(engine_cache_path, std::ios::binary | std::ios::out);
-          file.write(reinterpret_cast<char*>(serialized_engine->data()), serialized_engine->size());
+        } else if (WriteCacheFile(engine_cache_path, serialized_engine->data(), serialized_engine->size())) {
           LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized " + engine_cache_path;
+        } else {
+          LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not write engine cache to: " + engine_cache_path;
         }
       }
 
       // serialize and save timing cache
       if (trt_state->timing_cache_enable) {
-        auto timing_cache = trt_config->getTimingCache();
-        std::unique_ptr<nvinfer1::IHostMemory> timingCacheHostData{timing_cache->serialize()};
-        if (timingCacheHostData == nullptr) {
+        if (!saveTimingCacheFile(timing_cache_path, *trt_config, *timing_cache)) {
           return ORT_MAKE_STATUS(ONNXRUNTIME, EP_FAIL,
                                  "TensorRT EP could not serialize timing cache: " + timing_cache_path);
         }
-        saveTimingCacheFile(timing_cache_path, timingCacheHostData.get());
         if (detailed_build_log_) {
           LOGS_DEFAULT(VERBOSE) << "[TensorRT EP] Serialized timing cache " + timing_cache_path;
         }
@@ -15,6 +15,14 @@
 #include "core/common/path_string.h"
 #include "core/framework/murmurhash3.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
 namespace fs = std::filesystem;
 
 namespace onnxruntime {
@@ -511,6 +519,102 @@ void RemoveCachesByType(const std::string& root, std::string file_extension) {
   }
 }
 
+/*
+ * Exclusive lock of a cache file shared by the processes using the same cache directory
+ *
+ * The lock is taken on the file "<file_name>.lock" and blocks until the other processes released it,
+ * so that the first process builds and writes a cache entry and the others load it instead of building it again.
+ * The lock file is left in place, removing it would let two processes hold a lock on different files.
+ * No lock is taken if the lock file cannot be opened, e.g. in a read-only cache directory.
+ */
+class CacheFileLock {
+ public:
+  explicit CacheFileLock(const std::string& file_name) {
+    const std::string lock_file_name = file_name + ".lock";
+#ifdef _WIN32
+    handle_ = CreateFileA(lock_file_name.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                          nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle_ != INVALID_HANDLE_VALUE) {
+      OVERLAPPED overlapped{};
+      if (!LockFileEx(handle_, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+        CloseHandle(handle_);
+        handle_ = INVALID_HANDLE_VALUE;
+      }
+    }
+    if (handle_ == INVALID_HANDLE_VALUE) {
+#else
+    fd_ = open(lock_file_name.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ != -1 && flock(fd_, LOCK_EX) != 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+    if (fd_ == -1) {
+#endif
+      LOGS_DEFAULT(WARNING) << "[TensorRT EP] Could not lock " << lock_file_name
+                            << ". The cache is not protected against concurrent processes.";
+    }
+  }
+
+  ~CacheFileLock() {
+#ifdef _WIN32
+    if (handle_ != INVALID_HANDLE_VALUE) {
+      OVERLAPPED overlapped{};
+      UnlockFileEx(handle_, 0, MAXDWORD, MAXDWORD, &overlapped);
+      CloseHandle(handle_);
+    }
+#else
+    if (fd_ != -1) {
+      flock(fd_, LOCK_UN);
+      close(fd_);
+    }
+#endif
+  }
+
+  CacheFileLock(const CacheFileLock&) = delete;
+  CacheFileLock& operator=(const CacheFileLock&) = delete;
+
+ private:
+#ifdef _WIN32
+  HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+  int fd_ = -1;
+#endif
+};
+
+/*
+ * Write a cache file atomically
+ *
+ * The content is written to a temporary file in the same directory that is then renamed to file_name,
+ * so that a process reading the cache without the lock never sees a partially written file.
+ */
+bool WriteCacheFile(const std::string& file_name, const void* data, size_t size) {
+#ifdef _WIN32
+  const std::string temp_file_name = file_name + ".tmp" + std::to_string(GetCurrentProcessId());
+#else
+  const std::string temp_file_name = file_name + ".tmp" + std::to_string(getpid());
+#endif
+  {
+    std::ofstream file(temp_file_name, std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file) {
+      return false;
+    }
+    file.write(static_cast<const char*>(data), size);
+    if (!file) {
+      file.close();
+      fs::remove(temp_file_name);
+      return false;
+    }
+  }
+
+  std::error_code error;
+  fs::rename(temp_file_name, file_name, error);
+  if (error) {
+    fs::remove(temp_file_name, error);
+    return false;
+  }
+  return true;
+}
+
 /**
  * <summary>
  * Helper class to generate engine id via model name/model content/env metadata
@@ -15,6 +15,7 @@
 #include "core/providers/xnnpack/detail/utils.h"
 
 // each operator provides a helper to check if supported
+#include "core/providers/xnnpack/math/dynamic_quantize_matmul.h"
 #include "core/providers/xnnpack/math/gemm.h"
 #include "core/providers/xnnpack/math/matmul.h"
 #include "core/providers/xnnpack/math/softmax.h"
@@ -102,6 +103,12 @@ bool NodeSupportChecker::IsNodeSupported(const NodeUnit& nodeunit) {
       {"MatMul", MatMul::IsOnnxNodeSupported},
   };
 
+#if !defined(DISABLE_CONTRIB_OPS)
+  static std::unordered_map<std::string, CheckerFn> ms_domain_checkers{
+      {"DynamicQuantizeMatMul", DynamicQuantizeMatMul::IsOnnxNodeSupported},
+  };
+#endif
+
   bool supported = false;
 
   if (nodeunit.Domain() == onnxruntime::kOnnxDomain) {
@@ -110,6 +117,14 @@ bool NodeSupportChecker::IsNodeSupported(const NodeUnit& nodeunit) {
       supported = entry->second(nodeunit, graph_);
     }
   }
+#if !defined(DISABLE_CONTRIB_OPS)
+  else if (nodeunit.Domain() == onnxruntime::kMSDomain) {
+    const auto entry = ms_domain_checkers.find(nodeunit.OpType());
+    if (entry != ms_domain_checkers.cend()) {
+      supported = entry->second(nodeunit, graph_);
+    }
+  }
+#endif
 
   return supported;
 }
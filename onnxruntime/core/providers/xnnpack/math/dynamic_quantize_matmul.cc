@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(DISABLE_CONTRIB_OPS)
+
+#include "dynamic_quantize_matmul.h"
+
+#include <algorithm>
+
+#include "core/optimizer/initializer.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+namespace onnxruntime {
+namespace xnnpack {
+
+namespace {
+bool IsScalarOr1DOfSize(const ONNX_NAMESPACE::TensorShapeProto* shape, int64_t size) {
+  if (shape == nullptr) {
+    return false;
+  }
+  if (shape->dim_size() == 0) {
+    return true;
+  }
+  return shape->dim_size() == 1 && shape->dim(0).has_dim_value() &&
+         (shape->dim(0).dim_value() == 1 || shape->dim(0).dim_value() == size);
+}
+}  // namespace
+
+bool DynamicQuantizeMatMul::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph) {
+  bool supported = false;
+  const onnxruntime::Node& node = node_unit.GetNode();
+
+  // use do {} while(false) so it's easier to set a breakpoint on the return
+  do {
+    const auto input_defs = node.InputDefs();
+    if (input_defs.size() < 3) {
+      break;
+    }
+
+    const auto& A_arg = *input_defs[0];
+    const auto& B_arg = *input_defs[1];
+    const auto& b_scale_arg = *input_defs[2];
+
+    const auto* A_type = A_arg.TypeAsProto();
+    const auto* B_type = B_arg.TypeAsProto();
+    if (A_type == nullptr || A_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT ||
+        B_type == nullptr || B_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_INT8) {
+      break;
+    }
+
+    // A is multiplied as a batch of rows
+    const auto* A_shape = A_arg.Shape();
+    if (A_shape == nullptr || A_shape->dim_size() < 1) {
+      break;
+    }
+
+    // B matrix must be constant
+    const auto* B_shape = B_arg.Shape();
+    if (B_shape == nullptr || B_shape->dim_size() != 2 || !B_shape->dim(0).has_dim_value() ||
+        !B_shape->dim(1).has_dim_value() || B_shape->dim(0).dim_value() == 0 || B_shape->dim(1).dim_value() == 0 ||
+        !graph.IsConstantInitializer(B_arg.Name(), true)) {
+      break;
+    }
+    const int64_t N = B_shape->dim(1).dim_value();
+
+    // per tensor or per column scale of B
+    if (!IsScalarOr1DOfSize(b_scale_arg.Shape(), N) || !graph.IsConstantInitializer(b_scale_arg.Name(), true)) {
+      break;
+    }
+
+    // XNNPACK requires B to be quantized symmetrically
+    if (input_defs.size() > 3 && input_defs[3]->Exists()) {
+      const auto* zero_point = graph.GetConstantInitializer(input_defs[3]->Name(), true);
+      if (zero_point == nullptr) {
+        break;
+      }
+      Initializer zero_point_values(*zero_point, graph.ModelPath());
+      const auto zero_points = zero_point_values.DataAsSpan<int8_t>();
+      if (std::any_of(zero_points.begin(), zero_points.end(), [](int8_t zp) { return zp != 0; })) {
+        break;
+      }
+    }
+
+    if (input_defs.size() > 4 && input_defs[4]->Exists()) {
+      const auto* bias_shape = input_defs[4]->Shape();
+      if (bias_shape == nullptr || bias_shape->dim_size() != 1 || !bias_shape->dim(0).has_dim_value() ||
+          bias_shape->dim(0).dim_value() != N || !graph.IsConstantInitializer(input_defs[4]->Name(), true)) {
+        break;
+      }
+    }
+
+    supported = true;
+
+  } while (false);
+
+  return supported;
+}
+
+DynamicQuantizeMatMul::DynamicQuantizeMatMul(const OpKernelInfo& info)
+    : XnnpackKernel(info, /*enable_caches*/ true) {
+  const Tensor* b_scale = nullptr;
+  ORT_ENFORCE(info.TryGetConstantInput(2, &b_scale), "b_scale must be a constant initializer");
+  const auto b_scale_data = b_scale->DataAsSpan<float>();
+  b_scales_.assign(b_scale_data.begin(), b_scale_data.end());
+
+  if (!info.TryGetConstantInput(4, &bias_)) {
+    bias_ = nullptr;
+  }
+
+  struct xnn_operator* p = nullptr;
+  xnn_status status = xnn_create_convert_nc_f32_qd8(/*flags*/ 0, &p);
+  ORT_ENFORCE(status == xnn_status_success, "xnn_create_convert_nc_f32_qd8 returned ", status);
+  convert_op_.reset(p);
+}
+
+Status DynamicQuantizeMatMul::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr /*alloc*/,
+                                      /*out*/ bool& is_packed,
+                                      /*out*/ PrePackedWeights* /*Not used*/) {
+  is_packed = false;
+
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  is_packed = true;
+
+  b_shape_ = tensor.Shape();
+  const size_t input_channels = narrow<size_t>(b_shape_[0]);
+  const size_t output_channels = narrow<size_t>(b_shape_[1]);
+
+  // XNNPACK expects one scale per output channel
+  if (b_scales_.size() == 1) {
+    b_scales_.resize(output_channels, b_scales_[0]);
+  }
+
+  struct xnn_operator* p = nullptr;
+  xnn_status status = xnn_create_fully_connected_nc_qd8_f32_qc8w(
+      input_channels,                                    // size_t input_channels,
+      output_channels,                                   // size_t output_channels,
+      input_channels,                                    // size_t input_stride,
+      output_channels,                                   // size_t output_stride,
+      b_scales_.data(),                                  // const float* kernel_scale,
+      tensor.Data<int8_t>(),                             // const int8_t* kernel,
+      bias_ != nullptr ? bias_->Data<float>() : nullptr,  // const float* bias,
+      -INFINITY,
+      INFINITY,
+      XNN_FLAG_TRANSPOSE_WEIGHTS,
+      GetCodeCache(),
+      GetWeightsCache(),
+      &p);
+
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_create_fully_connected_nc_qd8_f32_qc8w returned ", status);
+  }
+
+  op0_.reset(p);
+
+  return Status::OK();
+}
+
+Status DynamicQuantizeMatMul::Compute(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  pthreadpool_t threadpool = GetThreadPool();
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape_));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const size_t channels = narrow<size_t>(b_shape_[0]);
+  const size_t batch_size = narrow<size_t>(a->Shape().Size()) / channels;
+
+  // A quantized per row, with the extra bytes and parameters XNNPACK may read past the end
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  auto quantized_a = IAllocator::MakeUniquePtr<int8_t>(alloc, batch_size * channels + XNN_EXTRA_BYTES);
+  auto quantization_params = IAllocator::MakeUniquePtr<xnn_dynamic_quantization_params>(
+      alloc, batch_size + XNN_EXTRA_QUANTIZATION_PARAMS);
+
+  xnn_status status = xnn_reshape_convert_nc_f32_qd8(convert_op_.get(), batch_size, channels, channels, channels,
+                                                     threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_convert_nc_f32_qd8 returned ", status);
+  }
+
+  status = xnn_setup_convert_nc_f32_qd8(convert_op_.get(), a->Data<float>(), quantized_a.get(),
+                                        quantization_params.get());
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_convert_nc_f32_qd8 returned ", status);
+  }
+
+  status = xnn_run_operator(convert_op_.get(), threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
+  }
+
+  status = xnn_reshape_fully_connected_nc_qd8_f32_qc8w(op0_.get(), batch_size, threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_fully_connected_nc_qd8_f32_qc8w returned ", status);
+  }
+
+  status = xnn_setup_fully_connected_nc_qd8_f32_qc8w(op0_.get(), quantized_a.get(), y->MutableData<float>(),
+                                                     quantization_params.get());
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_fully_connected_nc_qd8_f32_qc8w returned ", status);
+  }
+
+  status = xnn_run_operator(op0_.get(), threadpool);
+  if (status != xnn_status_success) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
+  }
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(DynamicQuantizeMatMul, kMSDomain, 1, kXnnpackExecutionProvider,
+                        KernelDefBuilder()
+                            .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+                            .TypeConstraint("T2", DataTypeImpl::GetTensorType<int8_t>()),
+                        DynamicQuantizeMatMul);
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
+
+#endif  // !defined(DISABLE_CONTRIB_OPS)
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/providers/xnnpack/xnnpack_kernel.h"
+#include "core/framework/allocator.h"
+#include "core/providers/xnnpack/detail/utils.h"
+#include "core/common/common.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class Node;
+namespace xnnpack {
+
+// com.microsoft.DynamicQuantizeMatMul with a constant int8 B quantized symmetrically, per tensor or per column.
+// A is quantized per row at run time and multiplied with XNNPACK's qd8 x qc8w fully connected operator.
+class DynamicQuantizeMatMul : public XnnpackKernel {
+ public:
+  DynamicQuantizeMatMul(const OpKernelInfo& info);
+
+  Status Compute(OpKernelContext* /*context*/) const override;
+
+  // Required for checking XNNpack restrictions on ORT side
+  static bool IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& graph);
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+ private:
+  TensorShape b_shape_;
+  std::vector<float> b_scales_;
+  const Tensor* bias_ = nullptr;
+
+  XnnpackOperator convert_op_ = nullptr;
+  XnnpackOperator op0_ = nullptr;
+};
+
+}  // namespace xnnpack
+}  // namespace onnxruntime
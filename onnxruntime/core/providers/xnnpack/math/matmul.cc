@@ -3,6 +3,7 @@
 
 #include "matmul.h"
 #include "core/providers/cpu/math/matmul_helper.h"
+#include "core/providers/xnnpack/xnnpack_init.h"
 
 // Todo -
 // 1. Integrate activation layers - Cliping & Relu
@@ -28,13 +29,17 @@ bool MatMul::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& g
     const auto& A_arg = *input_defs[0];
     const auto& B_arg = *input_defs[1];
 
-    // Support only float
+    // Support only float, and float16 where XNNPACK has fp16 kernels
     const auto* A_type = A_arg.TypeAsProto();
 
     const auto* A_shape = A_arg.Shape();
     const auto* B_shape = B_arg.Shape();
 
-    if (A_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    if (A_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT
+#ifdef XNNPACK_FP16_SUPPORTED
+        && A_type->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_FLOAT16
+#endif
+    ) {
       break;
     }
 
@@ -62,7 +67,11 @@ bool MatMul::IsOnnxNodeSupported(const NodeUnit& node_unit, const GraphViewer& g
   return supported;
 }
 
-MatMul::MatMul(const OpKernelInfo& info) : XnnpackKernel(info, /*enable_caches*/ true) {}
+MatMul::MatMul(const OpKernelInfo& info) : XnnpackKernel(info, /*enable_caches*/ true) {
+  const auto input_type = info.node().InputDefs()[0]->TypeAsProto()->tensor_type().elem_type();
+  op_type_ = input_type == ONNX_NAMESPACE::TensorProto_DataType_FLOAT16 ? OpComputeType::op_compute_type_fp16
+                                                                           : OpComputeType::op_compute_type_fp32;
+}
 
 Status MatMul::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
                        /*out*/ bool& is_packed,
@@ -88,27 +97,46 @@ Status MatMul::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
   if (b_shape_.NumDimensions() == 1) {
     shape_broadcast.push_back(1);
   }
-  status = xnn_create_fully_connected_nc_f32(
-      shape_broadcast[0],    // size_t input_channels,
-      shape_broadcast[1],    // size_t output_channels,
-      shape_broadcast[0],    // size_t input_stride,
-      shape_broadcast[1],    // size_t output_stride,
-      tensor.Data<float>(),  // const float* kernel,
-      nullptr,               // const float* bias,
-      output_min,
-      output_max,
-      flags,
 #ifdef XNN_CACHE_ENABLE
-      GetCodeCache(),
-      GetWeightsCache(),
+  xnn_code_cache_t code_cache = GetCodeCache();
+  xnn_weights_cache_t weights_cache = GetWeightsCache();
 #else
-      nullptr,
-      nullptr,
+  xnn_code_cache_t code_cache = nullptr;
+  xnn_weights_cache_t weights_cache = nullptr;
 #endif
-      &p);
+  if (op_type_ == OpComputeType::op_compute_type_fp16) {
+    status = xnn_create_fully_connected_nc_f16(
+        shape_broadcast[0],        // size_t input_channels,
+        shape_broadcast[1],        // size_t output_channels,
+        shape_broadcast[0],        // size_t input_stride,
+        shape_broadcast[1],        // size_t output_stride,
+        tensor.DataRaw(),          // const void* kernel,
+        nullptr,                   // const void* bias,
+        output_min,
+        output_max,
+        flags,
+        code_cache,
+        weights_cache,
+        &p);
+  } else {
+    status = xnn_create_fully_connected_nc_f32(
+        shape_broadcast[0],    // size_t input_channels,
+        shape_broadcast[1],    // size_t output_channels,
+        shape_broadcast[0],    // size_t input_stride,
+        shape_broadcast[1],    // size_t output_stride,
+        tensor.Data<float>(),  // const float* kernel,
+        nullptr,               // const float* bias,
+        output_min,
+        output_max,
+        flags,
+        code_cache,
+        weights_cache,
+        &p);
+  }
 
   if (status != xnn_status_success) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_create_fully_connected_nc_f32 returned ", status);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_create_fully_connected_nc_",
+                           op_type_ == OpComputeType::op_compute_type_fp16 ? "f16" : "f32", " returned ", status);
   }
 
   op0_.reset(p);
@@ -126,35 +154,53 @@ Status MatMul::Compute(OpKernelContext* ctx) const {
   if (y->Shape().Size() == 0)
     return Status::OK();
 
-  auto* y_data = y->MutableData<float>();
-
-  xnn_status status = xnn_reshape_fully_connected_nc_f32(op0_.get(), a->Shape()[0], threadpool);
+  auto reshape_fn = op_type_ == OpComputeType::op_compute_type_fp16 ? xnn_reshape_fully_connected_nc_f16
+                                                                      : xnn_reshape_fully_connected_nc_f32;
+  xnn_status status = reshape_fn(op0_.get(), a->Shape()[0], threadpool);
   if (status != xnn_status_success) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_fully_connected_nc_f32 returned ", status);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_reshape_fully_connected_nc_",
+                           op_type_ == OpComputeType::op_compute_type_fp16 ? "f16" : "f32", " returned ", status);
   }
 
-  status = xnn_setup_fully_connected_nc_f32(op0_.get(), a->Data<float>(), y_data);
+  if (op_type_ == OpComputeType::op_compute_type_fp16) {
+    status = xnn_setup_fully_connected_nc_f16(op0_.get(), a->DataRaw(), y->MutableDataRaw());
+  } else {
+    status = xnn_setup_fully_connected_nc_f32(op0_.get(), a->Data<float>(), y->MutableData<float>());
+  }
   if (status != xnn_status_success) {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_fully_connected_nc_f32 returned ", status);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_setup_fully_connected_nc_",
+                           op_type_ == OpComputeType::op_compute_type_fp16 ? "f16" : "f32", " returned ", status);
   }
 
-  status = xnn_run_operator(op0_.get(), nullptr);
+  status = xnn_run_operator(op0_.get(), threadpool);
   if (status != xnn_status_success) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "xnn_run_operator returned ", status);
   }
   return Status::OK();
 }
 
+namespace {
+const std::vector<MLDataType>& MatMulTypes() {
+  static const std::vector<MLDataType> types{
+      DataTypeImpl::GetTensorType<float>(),
+#ifdef XNNPACK_FP16_SUPPORTED
+      DataTypeImpl::GetTensorType<MLFloat16>(),
+#endif
+  };
+  return types;
+}
+}  // namespace
+
 ONNX_OPERATOR_VERSIONED_KERNEL_EX(MatMul, kOnnxDomain, 1, 8, kXnnpackExecutionProvider,
-                                  KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                                  KernelDefBuilder().TypeConstraint("T", MatMulTypes()),
                                   MatMul);
 
 ONNX_OPERATOR_VERSIONED_KERNEL_EX(MatMul, kOnnxDomain, 9, 12, kXnnpackExecutionProvider,
-                                  KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                                  KernelDefBuilder().TypeConstraint("T", MatMulTypes()),
                                   MatMul);
 
 ONNX_OPERATOR_KERNEL_EX(MatMul, kOnnxDomain, 13, kXnnpackExecutionProvider,
-                        KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+                        KernelDefBuilder().TypeConstraint("T", MatMulTypes()),
                         MatMul);
 
 }  // namespace xnnpack
@@ -31,6 +31,7 @@ class MatMul : public XnnpackKernel {
   BufferUniquePtr packed_b_;
   AllocatorPtr myAlloc;
 
+  OpComputeType op_type_ = OpComputeType::op_compute_type_invalid;
   XnnpackOperator op0_ = nullptr;
 };
 
@@ -11,6 +11,7 @@
 #include "core/framework/node_unit.h"
 #include "core/graph/function_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/util/thread_utils.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/qdq_selectors.h"
 #include "core/optimizer/qdq_transformer/selectors_actions/shared/utils.h"
 #include "core/providers/xnnpack/xnnpack_execution_provider.h"
@@ -86,6 +87,11 @@ class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kOnnxDomain, 13
 // Internal domain
 class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kDynamicDomainByCreate, 1, QLinearSoftmax);
 
+#if !defined(DISABLE_CONTRIB_OPS)
+// Microsoft domain
+class ONNX_OPERATOR_KERNEL_CLASS_NAME(kXnnpackExecutionProvider, kMSDomain, 1, DynamicQuantizeMatMul);
+#endif
+
 std::unique_ptr<KernelRegistry> RegisterKernels() {
   auto kernel_registry = std::make_unique<onnxruntime::KernelRegistry>();
 
@@ -138,6 +144,10 @@ std::unique_ptr<KernelRegistry> RegisterKernels() {
       KERNEL_CREATE_INFO_TYPED(10, int8_t, QLinearConv, kMSInternalNHWCDomain),
 
       KERNEL_CREATE_INFO(1, QLinearSoftmax, kDynamicDomainByCreate),
+
+#if !defined(DISABLE_CONTRIB_OPS)
+      KERNEL_CREATE_INFO(1, DynamicQuantizeMatMul, kMSDomain),
+#endif
   };
 
   for (auto& function_table_entry : function_table) {
@@ -161,7 +171,8 @@ XnnpackExecutionProvider::XnnpackExecutionProvider(const XnnpackExecutionProvide
   bool allow_intra_op_spinning = (info.session_options == nullptr) ||
                                  (info.session_options &&
                                   info.session_options->config_options.GetConfigOrDefault(
-                                      kOrtSessionOptionsConfigAllowIntraOpSpinning, "1") == "1");
+                                      kOrtSessionOptionsConfigAllowIntraOpSpinning,
+                                      kOrtThreadPoolDefaultAllowSpinning ? "1" : "0") == "1");
   if (xnn_thread_pool_size > 1 && allow_intra_op_spinning && ort_thread_pool_size > 1) {
     LOGS_DEFAULT(WARNING)
         << "The XNNPACK EP utilizes an internal pthread-based thread pool for multi-threading."
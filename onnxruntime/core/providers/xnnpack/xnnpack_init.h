@@ -46,6 +46,11 @@ namespace xnnpack {
 #define XNN_ALLOCATION_ALIGNMENT 16
 #endif
 
+// fp16 kernels are only used on Arm64, where the hardware has fp16 arithmetic
+#if (defined(__aarch64__) || defined(_M_ARM64)) && !defined(_M_ARM64EC)
+#define XNNPACK_FP16_SUPPORTED
+#endif
+
 std::pair<AllocatorPtr&, xnn_allocator*> GetStoredAllocator();
 
 }  // namespace xnnpack
@@ -2,6 +2,10 @@
 // Licensed under the MIT License.
 
 #include "core/session/IOBinding.h"
+
+#include <algorithm>
+#include <utility>
+
 #include "core/common/logging/logging.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel.h"
@@ -42,6 +46,7 @@ common::Status IOBinding::BindInput(const std::string& name, const OrtValue& ml_
 }
 
 void IOBinding::ClearInputs() {
+  states_.clear();
   mapped_feed_names_.clear();
   feed_names_.clear();
   feeds_.clear();
@@ -104,12 +109,59 @@ common::Status IOBinding::BindOutputImpl(const std::string& name, const OrtValue
 }
 
 void IOBinding::ClearOutputs() {
+  states_.clear();
   mapped_output_names_.clear();
   output_names_.clear();
   outputs_.clear();
   outputs_device_info_.clear();
 }
 
+common::Status IOBinding::BindState(const std::string& input_name, const std::string& output_name,
+                                    const OrtValue& initial_value) {
+  ORT_RETURN_IF_NOT(initial_value.IsTensor(), "The initial value of state ", input_name, " must be a tensor.");
+  ORT_RETURN_IF_ERROR(BindInput(input_name, initial_value));
+
+  const size_t input_index = mapped_feed_names_.at(input_name);
+  // the output is allocated on the device the input was bound on
+  ORT_RETURN_IF_ERROR(BindOutput(output_name, feeds_[input_index].Get<Tensor>().Location().device));
+  const size_t output_index = mapped_output_names_.at(output_name);
+
+  auto it = std::find_if(states_.begin(), states_.end(),
+                         [input_index](const State& state) { return state.input_index == input_index; });
+  if (it == states_.end()) {
+    states_.push_back({input_index, output_index, false, OrtValue()});
+  } else {
+    *it = {input_index, output_index, false, OrtValue()};
+  }
+
+  return Status::OK();
+}
+
+void IOBinding::PrepareStates() {
+  for (auto& state : states_) {
+    outputs_[state.output_index] = std::move(state.output_buffer);
+    state.output_buffer = OrtValue();
+  }
+}
+
+void IOBinding::AdvanceStates(bool run_succeeded) {
+  for (auto& state : states_) {
+    OrtValue& input = feeds_[state.input_index];
+    OrtValue& output = outputs_[state.output_index];
+    if (!run_succeeded) {
+      output = OrtValue();
+      continue;
+    }
+
+    // the next output is written to the buffer of the input of the last run, unless it is the initial value
+    if (state.input_is_reusable) {
+      state.output_buffer = std::move(input);
+    }
+    input = output;
+    state.input_is_reusable = true;
+  }
+}
+
 const std::vector<std::string>& IOBinding::GetOutputNames() const { return output_names_; }
 
 const std::vector<OrtValue>& IOBinding::GetOutputs() const { return outputs_; }
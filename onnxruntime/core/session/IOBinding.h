@@ -71,6 +71,18 @@ class IOBinding {
    */
   common::Status BindOutput(const std::string& name, OrtDevice device = {});
 
+  /**
+   * Bind a state carried from each run to the next one, e.g. the cache of a streaming model run chunk by chunk.
+   * initial_value is bound as the input named input_name, and after each successful InferenceSession::Run the output
+   * named output_name is bound in its place, on the same device, without a copy.
+   * The state is double buffered: from the third run on, the output is written to the buffer of the input of the
+   * previous run, so that running a chunk neither copies nor allocates the state. The state must hence keep its shape
+   * across the runs. The buffer of initial_value is not written to.
+   * After a run the bound output is the state computed by the run, and after a failed run it is unset.
+   */
+  common::Status BindState(const std::string& input_name, const std::string& output_name,
+                           const OrtValue& initial_value);
+
   /**
    * This simply collects the outputs obtained after calling Run() inside the @param outputs.
    */
@@ -107,8 +119,26 @@ class IOBinding {
   std::vector<OrtValue> outputs_;
   std::vector<OrtDevice> outputs_device_info_;
 
+  struct State {
+    size_t input_index;
+    size_t output_index;
+    // whether the buffer of the input may be written to by a later run, i.e. it isn't the initial value
+    bool input_is_reusable;
+    // the buffer the output of the next run is written to, unset if the run allocates it
+    OrtValue output_buffer;
+  };
+  std::vector<State> states_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IOBinding);
 
+  // Binds the buffers the state outputs of the next run are written to. Called by InferenceSession::Run.
+  void PrepareStates();
+
+  // Binds the state outputs of the last run as the state inputs of the next one, keeping them as the bound outputs.
+  // After a failed run, the state inputs are kept and the state outputs, which may be partially written, are unset.
+  // Called by InferenceSession::Run.
+  void AdvanceStates(bool run_succeeded);
+
   // device info for all outputs. only used by InferenceSession if the output is not pre-allocated.
   const std::vector<OrtDevice>& GetOutputsDeviceInfo() const;
 
@@ -9,6 +9,7 @@
 #include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <gsl/gsl>
 #include "core/framework/data_types.h"
@@ -46,6 +47,7 @@ static constexpr uint32_t min_ort_version_with_custom_version = 17;
 #if ENABLE_CUSTOM_OP_API
 static constexpr uint32_t min_ort_version_with_compute_v2_support = 16;
 static constexpr uint32_t min_ort_version_with_shape_inference = 17;
+static constexpr uint32_t min_ort_version_with_prepack_support = 20;
 #endif
 
 #if !defined(DISABLE_FLOAT8_TYPES)
@@ -246,6 +248,39 @@ ORT_API_STATUS_IMPL(OrtApis::KernelContext_ParallelFor, _In_ const OrtKernelCont
   });
 };
 
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_ParallelForRange, _In_ const OrtKernelContext* context,
+                    _In_ void (*fn)(void*, size_t, size_t), _In_ size_t total, _In_ double cost_per_unit,
+                    _In_ void* usr_data) {
+  return ExecuteIfKernelContextApiEnabled([&]() -> OrtStatusPtr {
+    if (!context) {
+      return OrtApis::CreateStatus(ORT_RUNTIME_EXCEPTION, "Invalid context");
+    }
+    if (fn && total) {
+      const auto* ctx = reinterpret_cast<const onnxruntime::OpKernelContext*>(context);
+      onnxruntime::concurrency::ThreadPool::TryParallelFor(
+          ctx->GetOperatorThreadPool(),
+          static_cast<std::ptrdiff_t>(total),
+          cost_per_unit,
+          [fn, usr_data](std::ptrdiff_t begin, std::ptrdiff_t end) {
+            fn(usr_data, static_cast<size_t>(begin), static_cast<size_t>(end));
+          });
+    }
+    return nullptr;
+  });
+};
+
+ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetDegreeOfParallelism, _In_ const OrtKernelContext* context,
+                    _Out_ int* out) {
+  return ExecuteIfKernelContextApiEnabled([&]() -> OrtStatusPtr {
+    if (!context || !out) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Invalid context or output");
+    }
+    const auto* ctx = reinterpret_cast<const onnxruntime::OpKernelContext*>(context);
+    *out = onnxruntime::concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool());
+    return nullptr;
+  });
+};
+
 ORT_API_STATUS_IMPL(OrtApis::KernelContext_GetLogger, _In_ const OrtKernelContext* context,
                     _Outptr_ const OrtLogger** logger) {
   return ExecuteIfKernelContextApiEnabled([&]() -> OrtStatusPtr {
@@ -804,11 +839,42 @@ struct CustomOpKernel : OpKernel {
     }
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override {
+    is_packed = false;
+    // the custom kernel owns its packed data, so it can't be shared with the kernels of other sessions
+    if (op_.version < min_ort_version_with_prepack_support || !op_.KernelPrePackWeight ||
+        prepacked_weights != nullptr) {
+      return Status::OK();
+    }
+
+    OrtValue value;
+    Tensor::InitOrtValue(tensor.DataType(), tensor.Shape(), const_cast<void*>(tensor.DataRaw()), tensor.Location(),
+                         value);
+    int packed = 0;
+    ORT_RETURN_IF_ERROR(ToStatus(op_.KernelPrePackWeight(op_kernel_, &value, input_idx,
+                                                         GetPrePackAllocator(std::move(alloc)), &packed)));
+    is_packed = packed != 0;
+    return Status::OK();
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CustomOpKernel);
 
+  // the wrappers must outlive the kernel as it frees its packed data with them
+  OrtAllocator* GetPrePackAllocator(AllocatorPtr alloc) {
+    for (auto& allocator : prepack_allocators_) {
+      if (allocator->GetWrappedIAllocator() == alloc) {
+        return allocator.get();
+      }
+    }
+    prepack_allocators_.push_back(std::make_unique<OrtAllocatorImplWrappingIAllocator>(std::move(alloc)));
+    return prepack_allocators_.back().get();
+  }
+
   const OrtCustomOp& op_;
   void* op_kernel_;
+  std::vector<std::unique_ptr<OrtAllocatorImplWrappingIAllocator>> prepack_allocators_;
 };
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -0,0 +1,250 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+thread_local bool running_batch = false;
+
+// Copies num_rows rows (slices along the batch dimension) of src starting at src_row into dst starting at dst_row.
+void CopyRows(const Tensor& src, int64_t src_row, Tensor& dst, int64_t dst_row, int64_t num_rows) {
+  const auto row_elements = src.Shape().SizeFromDimension(1);
+  const auto src_offset = narrow<size_t>(src_row * row_elements);
+  const auto dst_offset = narrow<size_t>(dst_row * row_elements);
+  const auto num_elements = narrow<size_t>(num_rows * row_elements);
+  if (src.IsDataTypeString()) {
+    const auto* src_strings = src.Data<std::string>() + src_offset;
+    std::copy(src_strings, src_strings + num_elements, dst.MutableData<std::string>() + dst_offset);
+  } else {
+    const auto element_size = src.DataType()->Size();
+    std::memcpy(static_cast<char*>(dst.MutableDataRaw()) + dst_offset * element_size,
+                static_cast<const char*>(src.DataRaw()) + src_offset * element_size,
+                num_elements * element_size);
+  }
+}
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(RunFn run_fn, std::chrono::microseconds window, int64_t max_batch_size)
+    : run_fn_(std::move(run_fn)),
+      window_(window),
+      max_batch_size_(max_batch_size),
+      allocator_(std::make_shared<CPUAllocator>()) {
+}
+
+bool DynamicBatcher::IsRunningBatch() {
+  return running_batch;
+}
+
+bool DynamicBatcher::GetBatchKey(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, const std::vector<OrtValue>& fetches,
+                                 std::string& key, int64_t& batch_size) {
+  if (run_options.terminate || feeds.empty() || feed_names.size() != feeds.size()) {
+    return false;
+  }
+
+  // Pre-allocated fetches are filled in place, which a batched run can not do.
+  if (std::any_of(fetches.cbegin(), fetches.cend(), [](const OrtValue& fetch) { return fetch.IsAllocated(); })) {
+    return false;
+  }
+
+  std::ostringstream key_stream;
+  key_stream << run_options.run_tag << '\n';
+  batch_size = -1;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor()) {
+      return false;
+    }
+    const auto& tensor = feeds[i].Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.Location().device.Type() != OrtDevice::CPU || shape.NumDimensions() == 0 || shape[0] <= 0) {
+      return false;
+    }
+    // All feeds must agree on the batch dimension.
+    if (batch_size != -1 && shape[0] != batch_size) {
+      return false;
+    }
+    batch_size = shape[0];
+
+    key_stream << feed_names[i] << ':' << tensor.GetElementType() << ':';
+    for (size_t dim = 1; dim < shape.NumDimensions(); ++dim) {
+      key_stream << shape[dim] << ',';
+    }
+    key_stream << '\n';
+  }
+  for (const auto& output_name : output_names) {
+    key_stream << output_name << '\n';
+  }
+  key = key_stream.str();
+  return true;
+}
+
+Status DynamicBatcher::Run(const RunOptions& run_options,
+                           gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                           gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) {
+  std::string key;
+  int64_t batch_size = 0;
+  if (!GetBatchKey(run_options, feed_names, feeds, output_names, fetches, key, batch_size) ||
+      (max_batch_size_ > 0 && batch_size >= max_batch_size_)) {
+    return RunRequest(run_options, feed_names, feeds, output_names, fetches);
+  }
+
+  Request request{&run_options, feed_names, feeds, output_names, &fetches, batch_size, Status::OK()};
+  std::unique_lock<OrtMutex> lock(mutex_);
+
+  // Join an open batch if there is room in it, and wait for its first request to run it.
+  auto open_batch = open_batches_.find(key);
+  if (open_batch != open_batches_.end() &&
+      (max_batch_size_ <= 0 || open_batch->second->batch_size + batch_size <= max_batch_size_)) {
+    auto& batch = *open_batch->second;
+    batch.requests.push_back(&request);
+    batch.batch_size += batch_size;
+    if (max_batch_size_ > 0 && batch.batch_size >= max_batch_size_) {
+      cv_.notify_all();
+    }
+    cv_.wait(lock, [&request]() { return request.done; });
+    return request.status;
+  }
+
+  // Otherwise start a new batch (replacing a full one), and wait for other requests to join it until the
+  // window expires or the batch is full.
+  auto batch = std::make_shared<Batch>();
+  batch->requests.push_back(&request);
+  batch->batch_size = batch_size;
+  open_batches_[key] = batch;
+
+  const auto deadline = std::chrono::steady_clock::now() + window_;
+  for (auto now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now()) {
+    if (max_batch_size_ > 0 && batch->batch_size >= max_batch_size_) {
+      break;
+    }
+    cv_.wait_for(lock, deadline - now);
+  }
+
+  // Close the batch.  Once it is no longer open, its requests can be accessed without the lock.
+  open_batch = open_batches_.find(key);
+  if (open_batch != open_batches_.end() && open_batch->second == batch) {
+    open_batches_.erase(open_batch);
+  }
+  lock.unlock();
+
+  RunBatch(*batch);
+
+  lock.lock();
+  for (auto* batched_request : batch->requests) {
+    batched_request->done = true;
+  }
+  cv_.notify_all();
+  return request.status;
+}
+
+Status DynamicBatcher::RunRequest(const RunOptions& run_options,
+                                  gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                  gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) {
+  const bool was_running_batch = running_batch;
+  running_batch = true;
+  auto reset_running_batch = gsl::finally([was_running_batch]() { running_batch = was_running_batch; });
+  return run_fn_(run_options, feed_names, feeds, output_names, fetches);
+}
+
+void DynamicBatcher::RunBatch(Batch& batch) {
+  if (batch.requests.size() == 1) {
+    auto& request = *batch.requests.front();
+    request.status = RunRequest(*request.run_options, request.feed_names, request.feeds, request.output_names,
+                                *request.fetches);
+    return;
+  }
+
+  const auto& first = *batch.requests.front();
+  std::vector<OrtValue> batched_feeds;
+  std::vector<OrtValue> batched_fetches;
+  Status status = ConcatenateFeeds(batch, batched_feeds);
+  if (status.IsOK()) {
+    status = RunRequest(*first.run_options, first.feed_names, batched_feeds, first.output_names, batched_fetches);
+    if (!status.IsOK()) {
+      for (auto* request : batch.requests) {
+        request->status = status;
+      }
+      return;
+    }
+    status = SplitFetches(batch, batched_fetches);
+  }
+
+  if (!status.IsOK()) {
+    // The batch could not be assembled or split, fall back to running its requests one by one.
+    for (auto* request : batch.requests) {
+      request->fetches->clear();
+      request->status = RunRequest(*request->run_options, request->feed_names, request->feeds,
+                                   request->output_names, *request->fetches);
+    }
+    return;
+  }
+
+  for (auto* request : batch.requests) {
+    request->status = Status::OK();
+  }
+}
+
+Status DynamicBatcher::ConcatenateFeeds(const Batch& batch, std::vector<OrtValue>& batched_feeds) const {
+  const auto& first = *batch.requests.front();
+  batched_feeds.resize(first.feeds.size());
+  for (size_t i = 0; i < first.feeds.size(); ++i) {
+    const auto& first_tensor = first.feeds[i].Get<Tensor>();
+    TensorShape batched_shape = first_tensor.Shape();
+    batched_shape[0] = batch.batch_size;
+    Tensor::InitOrtValue(first_tensor.DataType(), batched_shape, allocator_, batched_feeds[i]);
+    auto& batched_tensor = *batched_feeds[i].GetMutable<Tensor>();
+
+    int64_t row = 0;
+    for (const auto* request : batch.requests) {
+      const auto& tensor = request->feeds[i].Get<Tensor>();
+      ORT_RETURN_IF_NOT(request->feed_names[i] == first.feed_names[i], "Mismatched feed names in batch");
+      CopyRows(tensor, 0, batched_tensor, row, request->batch_size);
+      row += request->batch_size;
+    }
+  }
+  return Status::OK();
+}
+
+Status DynamicBatcher::SplitFetches(const Batch& batch, const std::vector<OrtValue>& batched_fetches) const {
+  // Check all fetches first, so that no request is left with partial fetches.
+  for (const auto& batched_fetch : batched_fetches) {
+    ORT_RETURN_IF_NOT(batched_fetch.IsTensor(), "Batched output is not a tensor");
+    const auto& shape = batched_fetch.Get<Tensor>().Shape();
+    ORT_RETURN_IF_NOT(shape.NumDimensions() > 0 && shape[0] == batch.batch_size,
+                      "Batched output does not have the batch dimension ", batch.batch_size, ": ", shape);
+  }
+
+  // The fetches of a request are views of its rows of the batched fetches, which they keep alive, so the outputs
+  // are not copied.
+  int64_t row = 0;
+  for (auto* request : batch.requests) {
+    request->fetches->resize(batched_fetches.size());
+    for (size_t i = 0; i < batched_fetches.size(); ++i) {
+      const auto& batched_fetch = batched_fetches[i];
+      const auto& batched_tensor = batched_fetch.Get<Tensor>();
+      TensorShape shape = batched_tensor.Shape();
+      shape[0] = request->batch_size;
+      const auto row_bytes = narrow<ptrdiff_t>(shape.SizeFromDimension(1)) *
+                             narrow<ptrdiff_t>(batched_tensor.DataType()->Size());
+      auto view = std::make_unique<Tensor>(batched_tensor.DataType(), shape,
+                                           const_cast<void*>(batched_tensor.DataRaw()), batched_tensor.Location(),
+                                           narrow<ptrdiff_t>(row) * row_bytes);
+      (*request->fetches)[i].Init(view.release(), DataTypeImpl::GetType<Tensor>(),
+                                  [batched_fetch](void* p) { delete static_cast<Tensor*>(p); });
+    }
+    row += request->batch_size;
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
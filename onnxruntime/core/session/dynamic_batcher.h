@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Combines concurrent Run calls into a single batched run.
+ *
+ * Requests whose feeds are CPU tensors with the same names, element types and shapes apart from the
+ * first (batch) dimension, and which request the same outputs, are collected for up to the batching window.
+ * Their feeds are concatenated along the batch dimension, the model is run once with the run options of the
+ * first request, and the fetches are split back along the batch dimension. The fetches of each request are views of
+ * the batched fetches, so the outputs are not copied.
+ *
+ * Requests that cannot be batched, e.g. with pre-allocated fetches, are run as is. If the fetches of a batched
+ * run can not be split by batch, e.g. because an output has no batch dimension, the requests of the batch are
+ * run one by one instead.
+ */
+class DynamicBatcher {
+ public:
+  using RunFn = std::function<Status(const RunOptions& run_options,
+                                     gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                     gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches)>;
+
+  /**
+   * @param run_fn Runs a single (possibly batched) request.
+   * @param window How long the first request of a batch waits for other requests to join it.
+   * @param max_batch_size If positive, the maximum total batch dimension of a batch.
+   */
+  DynamicBatcher(RunFn run_fn, std::chrono::microseconds window, int64_t max_batch_size);
+
+  Status Run(const RunOptions& run_options,
+             gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches);
+
+  // True while the calling thread runs a request on behalf of the batcher.
+  static bool IsRunningBatch();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(DynamicBatcher);
+
+  struct Request {
+    const RunOptions* run_options;
+    gsl::span<const std::string> feed_names;
+    gsl::span<const OrtValue> feeds;
+    gsl::span<const std::string> output_names;
+    std::vector<OrtValue>* fetches;
+    int64_t batch_size;
+    Status status;
+    bool done = false;
+  };
+
+  struct Batch {
+    std::vector<Request*> requests;
+    int64_t batch_size = 0;
+  };
+
+  // Returns false if the request can not be batched, otherwise the key identifying compatible requests
+  // and the size of the batch dimension of the request.
+  static bool GetBatchKey(const RunOptions& run_options,
+                          gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                          gsl::span<const std::string> output_names, const std::vector<OrtValue>& fetches,
+                          std::string& key, int64_t& batch_size);
+
+  Status RunRequest(const RunOptions& run_options,
+                    gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                    gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches);
+
+  // Runs the requests of a batch, setting the status of each request.
+  void RunBatch(Batch& batch);
+
+  Status ConcatenateFeeds(const Batch& batch, std::vector<OrtValue>& batched_feeds) const;
+
+  Status SplitFetches(const Batch& batch, const std::vector<OrtValue>& batched_fetches) const;
+
+  const RunFn run_fn_;
+  const std::chrono::microseconds window_;
+  const int64_t max_batch_size_;
+  const AllocatorPtr allocator_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  // Batches still accepting requests, by batch key.
+  std::unordered_map<std::string, std::shared_ptr<Batch>> open_batches_;
+};
+
+}  // namespace onnxruntime
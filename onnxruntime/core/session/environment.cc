@@ -3,6 +3,7 @@
 
 #include "core/session/environment.h"
 #include "core/session/allocator_adapters.h"
+#include "core/session/model_cache.h"
 #include "core/framework/allocator_utils.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
@@ -137,6 +138,9 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
     int max_dead_bytes_per_chunk = -1;
     int initial_growth_chunk_size_bytes = -1;
     int64_t max_power_of_two_extend_bytes = -1L;
+    int64_t thread_cache_bytes = -1L;
+    int thread_cache_max_chunk_bytes = -1;
+    int64_t trim_window_ms = -1L;
 
     // override with values from the user supplied arena_cfg object
     if (arena_cfg) {
@@ -154,10 +158,14 @@ Status Environment::CreateAndRegisterAllocator(const OrtMemoryInfo& mem_info, co
       max_dead_bytes_per_chunk = arena_cfg->max_dead_bytes_per_chunk;
       initial_growth_chunk_size_bytes = arena_cfg->initial_growth_chunk_size_bytes;
       max_power_of_two_extend_bytes = arena_cfg->max_power_of_two_extend_bytes;
+      thread_cache_bytes = arena_cfg->thread_cache_bytes;
+      thread_cache_max_chunk_bytes = arena_cfg->thread_cache_max_chunk_bytes;
+      trim_window_ms = arena_cfg->trim_window_ms;
     }
 
     OrtArenaCfg l_arena_cfg{max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk,
-                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes};
+                            initial_growth_chunk_size_bytes, max_power_of_two_extend_bytes,
+                            thread_cache_bytes, thread_cache_max_chunk_bytes, trim_window_ms};
     AllocatorCreationInfo alloc_creation_info{
         [mem_info](int) { return std::make_unique<CPUAllocator>(mem_info); },
         0,
@@ -198,6 +206,7 @@ Status Environment::Initialize(std::unique_ptr<logging::LoggingManager> logging_
   auto status = Status::OK();
 
   logging_manager_ = std::move(logging_manager);
+  model_cache_ = std::make_shared<ModelCache>();
 
   // create thread pools
   if (create_global_thread_pools) {
@@ -4,6 +4,8 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <list>
@@ -36,6 +38,7 @@
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/transform_layout_functions.h"
 #include "core/framework/utils.h"
+#include "core/graph/graph_flatbuffers_utils.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/model.h"
 #include "core/optimizer/graph_transformer_utils.h"
@@ -57,6 +60,9 @@
 #endif
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
+#if defined(USE_AZURE)
+#include "core/providers/azure/azure_execution_provider.h"
+#endif
 #ifdef USE_DML  // TODO: This is necessary for the workaround in TransformGraph
 #include "core/providers/dml/DmlExecutionProvider/src/DmlGraphFusionTransformer.h"
 #include "core/providers/dml/DmlExecutionProvider/src/DmlRuntimeGraphFusionTransformer.h"
@@ -65,6 +71,11 @@
 #include "core/providers/dml/DmlExecutionProvider/src/ExecutionProvider.h"
 #include "core/optimizer/stft_decomposition.h"
 #endif
+#include "core/session/dynamic_batcher.h"
+#include "core/session/model_cache.h"
+#include "core/session/optimized_model_cache.h"
+#include "core/session/prefix_kv_cache.h"
+#include "core/session/run_completion_queue.h"
 #include "core/session/environment.h"
 #include "core/session/user_logging_sink.h"
 #include "core/session/IOBinding.h"
@@ -361,6 +372,18 @@ void InferenceSession::SetLoggingManager(const SessionOptions& session_options,
   }
 }
 
+void InferenceSession::CreateDynamicBatcher(std::chrono::microseconds window, int64_t max_batch_size) {
+  LOGS(*session_logger_, INFO) << "Dynamic batching enabled with a window of " << window.count()
+                               << " us and max batch size " << max_batch_size;
+  dynamic_batcher_ = std::make_unique<DynamicBatcher>(
+      [this](const RunOptions& run_options,
+             gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) {
+        return Run(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+      },
+      window, max_batch_size);
+}
+
 void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                                          const Environment& session_env) {
   auto status = FinalizeSessionOptions(session_options, model_proto_, is_model_proto_parsed_, session_options_);
@@ -454,6 +477,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
 #if !defined(ORT_MINIMAL_BUILD)
   // Update the number of steps for the graph transformer manager using the "finalized" session options
   ORT_THROW_IF_ERROR(graph_transformer_mgr_.SetSteps(session_options_.max_num_graph_transformation_steps));
+  graph_transformer_mgr_.SetIncrementalRuleBasedTransformers(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsIncrementalRuleBasedTransformers, "0") == "1");
 #endif
 
 #if !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
@@ -492,7 +517,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     {
       if (!external_intra_op_thread_pool_) {
         bool allow_intra_op_spinning =
-            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowIntraOpSpinning, "1") == "1";
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowIntraOpSpinning,
+                                                           kOrtThreadPoolDefaultAllowSpinning ? "1" : "0") == "1";
         OrtThreadPoolParams to = session_options_.intra_op_param;
         std::basic_stringstream<ORTCHAR_T> ss;
         if (to.name) {
@@ -505,6 +531,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         // If the thread pool can use all the processors, then
         // we set affinity of each thread to each processor.
         to.allow_spinning = allow_intra_op_spinning;
+        to.adaptive_spinning =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpAdaptiveSpinning, "0") == "1";
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
 
@@ -515,6 +543,9 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        to.numa_node = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaNode, "-1"));
+        ORT_ENFORCE(to.numa_node < 0 || to.affinity_str.empty(),
+                    "Affinity string can not be combined with ", kOrtSessionOptionsConfigIntraOpNumaNode);
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
@@ -530,7 +561,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     if (session_options_.execution_mode == ExecutionMode::ORT_PARALLEL) {
       if (!external_inter_op_thread_pool_) {
         bool allow_inter_op_spinning =
-            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning, "1") == "1";
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAllowInterOpSpinning,
+                                                           kOrtThreadPoolDefaultAllowSpinning ? "1" : "0") == "1";
         OrtThreadPoolParams to = session_options_.inter_op_param;
         to.auto_set_affinity = to.thread_pool_size == 0 && session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
         std::basic_stringstream<ORTCHAR_T> ss;
@@ -564,12 +596,46 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
     LOGS(*session_logger_, INFO) << "Using global/env threadpools since use_per_session_threads_ is false";
     intra_op_thread_pool_from_env_ = session_env.GetIntraOpThreadPool();
     inter_op_thread_pool_from_env_ = session_env.GetInterOpThreadPool();
+
+    std::string shared_pool_weight;
+    std::string shared_pool_max_threads;
+    bool has_weight = session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpSharedPoolWeight,
+                                                                         shared_pool_weight);
+    bool has_max_threads = session_options_.config_options.TryGetConfigEntry(
+        kOrtSessionOptionsConfigIntraOpSharedPoolMaxThreads, shared_pool_max_threads);
+    if (intra_op_thread_pool_from_env_ && (has_weight || has_max_threads)) {
+      concurrency::ThreadPoolShareOptions share_options;
+      if (has_weight) {
+        share_options.weight = std::stoi(shared_pool_weight);
+      }
+      if (has_max_threads) {
+        share_options.max_degree_of_parallelism = std::stoi(shared_pool_max_threads);
+      }
+      LOGS(*session_logger_, INFO) << "Sharing the global intra op threadpool with weight " << share_options.weight
+                                   << " and max threads " << share_options.max_degree_of_parallelism;
+      shared_intra_op_thread_pool_ = std::make_unique<concurrency::ThreadPool>(intra_op_thread_pool_from_env_,
+                                                                               share_options);
+      intra_op_thread_pool_from_env_ = shared_intra_op_thread_pool_.get();
+    }
     ORT_ENFORCE(session_env.EnvCreatedWithGlobalThreadPools(),
                 "When the session is not configured to use per session"
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
   }
 
+  const int64_t dynamic_batching_window_us = std::stoll(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingWindowUs, "0"));
+  if (dynamic_batching_window_us > 0) {
+    const int64_t dynamic_batching_max_batch_size = std::stoll(
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBatchingMaxBatchSize, "0"));
+    CreateDynamicBatcher(std::chrono::microseconds(dynamic_batching_window_us), dynamic_batching_max_batch_size);
+  }
+
+  graph_capture_per_input_shapes_ =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigGraphCapturePerInputShapes, "0") == "1";
+
   session_profiler_.Initialize(session_logger_);
+  session_profiler_.SetFlushIntervalEvents(static_cast<size_t>(std::stoull(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsProfilingFlushIntervalEvents, "0"))));
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
   }
@@ -723,6 +789,18 @@ InferenceSession::~InferenceSession() {
     }
   }
 
+#if !defined(ORT_MINIMAL_BUILD)
+  SaveTuningResultsFile();
+#endif
+
+  if (shared_intra_op_thread_pool_) {
+    auto stats = shared_intra_op_thread_pool_->GetShareStats();
+    LOGS(*session_logger_, INFO) << "Global intra op threadpool usage: loops: " << stats.num_loops
+                                 << ", helper threads: " << stats.num_helpers
+                                 << ", total queueing delay (ns): " << stats.total_queueing_delay_ns
+                                 << ", max queueing delay (ns): " << stats.max_queueing_delay_ns;
+  }
+
   // Unregister the session and ETW callbacks
 #ifdef _WIN32
   std::lock_guard<OrtMutex> lock(active_sessions_mutex_);
@@ -889,10 +967,27 @@ common::Status InferenceSession::SaveToOrtFormat(const std::filesystem::path& fi
   fbs_buffer_size = ((fbs_buffer_size + m_bytes - 1) / m_bytes) * m_bytes;
   flatbuffers::FlatBufferBuilder builder(fbs_buffer_size);
 
-  auto ort_model_version = builder.CreateString(std::to_string(kOrtModelVersion));
+  // large initializers are optionally stored in an aligned data section after the flatbuffer
+  std::vector<uint8_t> data_section;
+  fbs::utils::ExternalDataWriter external_data_writer;
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSaveOrtModelAlignedInitializers,
+                                                         "0") == "1") {
+    external_data_writer = [&data_section](int32_t /*data_type*/, gsl::span<const uint8_t> bytes,
+                                           uint64_t& offset) {
+      constexpr size_t alignment = fbs::utils::kOrtFormatInitializerAlignment;
+      const size_t aligned_offset = (data_section.size() + alignment - 1) / alignment * alignment;
+      data_section.resize(aligned_offset + bytes.size());
+      std::copy(bytes.begin(), bytes.end(), data_section.begin() + aligned_offset);
+      offset = aligned_offset;
+      return Status::OK();
+    };
+  }
+
   flatbuffers::Offset<fbs::Model> fbs_model;
   ORT_RETURN_IF_ERROR(
-      model_->SaveToOrtFormat(builder, fbs_model));
+      model_->SaveToOrtFormat(builder, fbs_model, external_data_writer));
+  auto ort_model_version = builder.CreateString(
+      std::to_string(data_section.empty() ? kOrtModelVersion : kOrtModelVersionWithDataSection));
 
   flatbuffers::Offset<fbs::KernelTypeStrResolver> fbs_kernel_type_str_resolver;
   KernelTypeStrResolver kernel_type_str_resolver{};
@@ -917,13 +1012,104 @@ common::Status InferenceSession::SaveToOrtFormat(const std::filesystem::path& fi
     std::ofstream file(filepath, std::ios::binary);
     uint8_t* buf = builder.GetBufferPointer();
     int size = builder.GetSize();
-    file.write(reinterpret_cast<const char*>(buf), size);
+    if (data_section.empty()) {
+      file.write(reinterpret_cast<const char*>(buf), size);
+    } else {
+      ORT_RETURN_IF_ERROR(fbs::utils::SaveOrtFormatModelWithDataSection(
+          file, gsl::make_span(buf, static_cast<size_t>(size)), data_section));
+    }
     ORT_RETURN_IF_NOT(file, "Failed to save ORT format model to file: ", ToUTF8String(filepath.native()));
   }
 
   return Status::OK();
 }
 
+void InferenceSession::HashModelForOptimizedModelCache(const std::function<Status(std::string&)>& hash_model) {
+  optimized_model_cache_model_hash_.clear();
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, "").empty()) {
+    return;
+  }
+
+  auto status = hash_model(optimized_model_cache_model_hash_);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Optimized model cache disabled as the model could not be hashed: "
+                                    << status.ErrorMessage();
+    optimized_model_cache_model_hash_.clear();
+  }
+}
+
+common::Status InferenceSession::LoadFromOptimizedModelCache(PathString& cache_path) {
+  cache_path.clear();
+  if (optimized_model_cache_model_hash_.empty() || !ort_format_model_bytes_.empty() ||
+      !session_options_.optimized_model_filepath.empty()) {
+    return Status::OK();
+  }
+
+  const auto cache_dir = ToPathString(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizedModelCacheDir, ""));
+  const auto path = optimized_model_cache::GetCachedModelPath(cache_dir, optimized_model_cache_model_hash_,
+                                                              session_options_, optimizers_to_disable_,
+                                                              execution_providers_);
+  std::error_code error_code;
+  if (!std::filesystem::exists(path, error_code)) {
+    LOGS(*session_logger_, INFO) << "Optimized model not found in the cache, it will be saved to "
+                                 << ToUTF8String(path);
+    cache_path = path;
+    return Status::OK();
+  }
+
+  // Keep the ONNX model in case the cached model can not be loaded.
+  auto onnx_model = std::move(model_);
+  const auto onnx_model_location = model_location_;
+  is_model_loaded_ = false;
+  auto status = LoadOrtModel(path);
+  // The model location is used to resolve external data, which the ORT format model does not have.
+  model_location_ = onnx_model_location;
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to load the optimized model from the cache at " << ToUTF8String(path)
+                                    << ", using the ONNX model: " << status.ErrorMessage();
+    model_ = std::move(onnx_model);
+    ORT_RETURN_IF_ERROR(SaveModelMetadata(*model_));
+    ort_format_model_bytes_ = gsl::span<const uint8_t>();
+    std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+    ort_format_model_mapped_bytes_.reset();
+    is_model_loaded_ = true;
+    return Status::OK();
+  }
+
+  LOGS(*session_logger_, INFO) << "Loaded the optimized model from the cache at " << ToUTF8String(path);
+  return Status::OK();
+}
+
+void InferenceSession::SaveToOptimizedModelCache(const PathString& cache_path) const {
+  if (session_state_->GetFuncMgr().NumFuncs() > 0) {
+    LOGS(*session_logger_, INFO) << "Optimized model is not cached as it contains compiled nodes.";
+    return;
+  }
+
+  // Save to a temporary file first, so that other processes never load a partially written model.
+  const std::filesystem::path path(cache_path);
+  auto temp_path = path;
+  temp_path += ToPathString(".tmp" + std::to_string(Env::Default().GetSelfPid()));
+  std::error_code error_code;
+  std::filesystem::create_directories(path.parent_path(), error_code);
+  auto status = SaveToOrtFormat(temp_path);
+  if (status.IsOK()) {
+    std::filesystem::rename(temp_path, path, error_code);
+    if (error_code) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, error_code.message());
+    }
+  }
+
+  if (!status.IsOK()) {
+    std::filesystem::remove(temp_path, error_code);
+    LOGS(*session_logger_, WARNING) << "Failed to save the optimized model to the cache at "
+                                    << ToUTF8String(cache_path) << ": " << status.ErrorMessage();
+  } else {
+    LOGS(*session_logger_, INFO) << "Saved the optimized model to the cache at " << ToUTF8String(cache_path);
+  }
+}
+
 common::Status InferenceSession::LoadWithLoader(std::function<common::Status(std::shared_ptr<Model>&)> loader,
                                                 const std::string& event_name) {
   Status status = Status::OK();
@@ -972,6 +1158,11 @@ common::Status InferenceSession::LoadWithLoader(std::function<common::Status(std
 
 common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
   model_location_ = model_uri;
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseEnvModelCache, "0") == "1" &&
+      session_options_.optimized_model_filepath.empty()) {
+    ORT_RETURN_IF_ERROR(environment_.GetModelCache().GetOrLoad(model_uri, cached_model_));
+  }
+
   auto loader = [this](std::shared_ptr<onnxruntime::Model>& model) {
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
     LoadInterOp(model_location_, interop_domains_, [&](const char* msg) { LOGS(*session_logger_, WARNING) << msg; });
@@ -982,6 +1173,13 @@ common::Status InferenceSession::LoadOnnxModel(const PathString& model_uri) {
 #endif
     const bool strict_shape_type_inference = session_options_.config_options.GetConfigOrDefault(
                                                  kOrtSessionOptionsConfigStrictShapeTypeInference, "0") == "1";
+    if (cached_model_) {
+      // only the small initializers are copied, the others reference the weights of the cached model
+      ModelProto model_proto = cached_model_->model_proto;
+      return onnxruntime::Model::Load(std::move(model_proto), model_location_, model,
+                                      HasLocalSchema() ? &custom_schema_registries_ : nullptr, *session_logger_,
+                                      ModelOptions(true, strict_shape_type_inference));
+    }
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr,
                                     *session_logger_,
                                     ModelOptions(true, strict_shape_type_inference));
@@ -1021,6 +1219,9 @@ common::Status InferenceSession::Load(const PathString& model_uri) {
                            "Invoke Load().");
   }
 
+  HashModelForOptimizedModelCache([&model_uri](std::string& model_hash) {
+    return optimized_model_cache::HashModelFile(model_uri, model_hash);
+  });
   return LoadOnnxModel(model_uri);
 #else
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ONNX format model is not supported in this build.");
@@ -1073,6 +1274,11 @@ common::Status InferenceSession::Load(const void* model_data, int model_data_len
                                     ModelOptions(true, strict_shape_type_inference));
   };
 
+  HashModelForOptimizedModelCache([model_data, model_data_len](std::string& model_hash) {
+    model_hash = optimized_model_cache::HashModelBytes(
+        gsl::make_span(static_cast<const uint8_t*>(model_data), static_cast<size_t>(model_data_len)));
+    return Status::OK();
+  });
   return LoadWithLoader(loader, "model_loading_array");
 #else
   return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "ONNX format model is not supported in this build.");
@@ -1210,9 +1416,19 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
     ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(ensure_unique_dq_for_node_unit, *session_logger_, graph));
   }
 
+  // the phases are recorded when profiling, to break the session initialization down
+  TimePoint tp;
+  if (session_profiler_.IsEnabled()) {
+    tp = session_profiler_.Start();
+  }
+
   // apply execution provider independent level 1 graph optimizations.
   ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformer_mgr_.ApplyTransformers(graph, TransformerLevel::Level1, *session_logger_));
 
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_transformation_level1", tp);
+  }
+
   // if saving model to ORT format we only assign nodes a custom EP can handle and don't compile them.
   // we do this to preserve the original nodes in the model but prevent optimizers from changing them.
   // at runtime, the ORT format model will re-do the partitioning/compilation of these nodes, which may change
@@ -1282,15 +1498,32 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
   }
 
   // Do partitioning based on execution providers' capabilities.
+  if (session_profiler_.IsEnabled()) {
+    tp = session_profiler_.Start();
+  }
+
   ORT_RETURN_IF_ERROR_SESSIONID_(partitioner.Partition(graph, session_state_->GetMutableFuncMgr(), transform_layout_fn,
                                                        session_options_.config_options, *session_logger_,
                                                        mode, debug_graph_fn));
 
+  if (session_profiler_.IsEnabled()) {
+    session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_partitioning", tp);
+  }
+
   // apply Level2 and higher transformers.
   // we do not run Level 1 again as those transformers assume partitioning will run later to do node assignment.
   for (int i = static_cast<int>(TransformerLevel::Level2); i <= static_cast<int>(TransformerLevel::MaxLevel); i++) {
+    if (session_profiler_.IsEnabled()) {
+      tp = session_profiler_.Start();
+    }
+
     ORT_RETURN_IF_ERROR_SESSIONID_(
         graph_transformer_mgr_.ApplyTransformers(graph, static_cast<TransformerLevel>(i), *session_logger_));
+
+    if (session_profiler_.IsEnabled()) {
+      session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT,
+                                              "graph_transformation_level" + std::to_string(i), tp);
+    }
   }
 
   // Insert cast node/s.
@@ -1360,6 +1593,15 @@ Status InferenceSession::LoadOrtModel(const PathString& model_uri) {
   return LoadOrtModelWithLoader(
       [&]() {
         model_location_ = model_uri;
+        if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMapOrtModelFile, "0") == "1") {
+          size_t num_bytes = 0;
+          ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(model_location_.c_str(), num_bytes));
+          ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(model_location_.c_str(), 0, num_bytes,
+                                                               ort_format_model_mapped_bytes_));
+          ort_format_model_bytes_ = gsl::make_span(
+              reinterpret_cast<const uint8_t*>(ort_format_model_mapped_bytes_.get()), num_bytes);
+          return Status::OK();
+        }
         ORT_RETURN_IF_ERROR(
             LoadOrtModelBytes(model_location_, ort_format_model_bytes_, ort_format_model_bytes_data_holder_));
         return Status::OK();
@@ -1404,11 +1646,15 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
 
   ORT_RETURN_IF_ERROR(load_ort_format_model_bytes());
 
+  gsl::span<const uint8_t> flatbuffer_bytes;
+  gsl::span<const uint8_t> data_section;
+  ORT_RETURN_IF_ERROR(fbs::utils::SplitOrtFormatModelBytes(ort_format_model_bytes_, flatbuffer_bytes, data_section));
+
   // Verify the ort_format_model_bytes_ is a valid InferenceSessionBuffer before we access the data
-  flatbuffers::Verifier verifier(ort_format_model_bytes_.data(), ort_format_model_bytes_.size());
+  flatbuffers::Verifier verifier(flatbuffer_bytes.data(), flatbuffer_bytes.size());
   ORT_RETURN_IF_NOT(fbs::VerifyInferenceSessionBuffer(verifier), "ORT model verification failed.");
 
-  const auto* fbs_session = fbs::GetInferenceSession(ort_format_model_bytes_.data());
+  const auto* fbs_session = fbs::GetInferenceSession(flatbuffer_bytes.data());
   ORT_RETURN_IF(nullptr == fbs_session, "InferenceSession is null. Invalid ORT format model.");
 
   // Check version mismatch, for now we will only proceed when runtime version matches the model's ort version
@@ -1417,6 +1663,9 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
 
   const auto model_version = std::stoi(fbs_ort_model_version->str());
   const bool is_supported = IsOrtModelVersionSupported(model_version);
+  ORT_RETURN_IF(!data_section.empty() && model_version < kOrtModelVersionWithDataSection,
+                "The ORT format model version [", fbs_ort_model_version->string_view(),
+                "] does not support a data section. Invalid ORT format model.");
 
   OrtFormatLoadOptions load_options{};
 
@@ -1467,11 +1716,14 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
   // provided an existing buffer of bytes when creating the InferenceSession, ort_format_model_bytes_data_holder_
   // will be empty.
   // if that is the case we also allow creating initializers that directly use those bytes.
+  // a memory mapped model file is owned by the session, so its initializers always use the mapped bytes.
   const auto& config_options = session_options_.config_options;
   using_ort_model_bytes_for_initializers_ =
       load_options.can_use_flatbuffer_for_initializers =
-          ort_format_model_bytes_data_holder_.empty() &&
-          config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1";
+          ort_format_model_mapped_bytes_ != nullptr ||
+          (ort_format_model_bytes_data_holder_.empty() &&
+           config_options.GetConfigOrDefault(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "0") == "1");
+  load_options.data_section = data_section;
 
   // need to go from unique_ptr to shared_ptr when moving into model_
   std::unique_ptr<Model> tmp_model;
@@ -1645,6 +1897,22 @@ static void ResolveMemoryPatternFlags(SessionState& session_state) {
     }
   }
 }
+
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+// Collects the initializers of the graph and its subgraphs.
+static void CollectInitializers(const Graph& graph, InlinedVector<const ONNX_NAMESPACE::TensorProto*>& initializers) {
+  for (const auto& [name, tensor_proto] : graph.GetAllInitializedTensors()) {
+    ORT_UNUSED_PARAMETER(name);
+    initializers.push_back(tensor_proto);
+  }
+
+  for (const auto& node : graph.Nodes()) {
+    for (const auto& subgraph : node.GetSubgraphs()) {
+      CollectInitializers(*subgraph, initializers);
+    }
+  }
+}
+#endif
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // VC++ reports: "Releasing unheld lock 'l' in function 'onnxruntime::InferenceSession::Initialize'". But I don't see anything wrong.
@@ -1680,6 +1948,47 @@ common::Status InferenceSession::Initialize() {
       have_cpu_ep = execution_providers_.Get(onnxruntime::kCpuExecutionProvider) != nullptr;
     }
 
+    const std::string graph_capture_max_graphs =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigGraphCaptureMaxGraphs, "8");
+    if (!TryParseStringWithClassicLocale<size_t>(graph_capture_max_graphs, graph_capture_max_graphs_)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ", kOrtSessionOptionsConfigGraphCaptureMaxGraphs,
+                             ": ", graph_capture_max_graphs, ". It must be a non-negative integer.");
+    }
+
+    const std::string prefix_kv_cache_max_bytes_config =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrefixKVCacheMaxBytes, "0");
+    size_t prefix_kv_cache_max_bytes = 0;
+    if (!TryParseStringWithClassicLocale<size_t>(prefix_kv_cache_max_bytes_config, prefix_kv_cache_max_bytes)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ", kOrtSessionOptionsConfigPrefixKVCacheMaxBytes,
+                             ": ", prefix_kv_cache_max_bytes_config, ". It must be a non-negative integer.");
+    }
+    if (prefix_kv_cache_max_bytes > 0) {
+      LOGS(*session_logger_, INFO) << "Prefix key/value cache enabled with " << prefix_kv_cache_max_bytes << " bytes";
+      prefix_kv_cache_ = std::make_unique<PrefixKVCache>(prefix_kv_cache_max_bytes);
+    }
+
+#if defined(USE_AZURE)
+    // Merge the concurrent Run() calls so that the remote invocation ops make a single request for them.
+    if (dynamic_batcher_ == nullptr) {
+      const auto* azure_ep = static_cast<const AzureExecutionProvider*>(
+          execution_providers_.Get(onnxruntime::kAzureExecutionProvider));
+      if (azure_ep != nullptr && azure_ep->GetBatchingWindow().count() > 0) {
+        CreateDynamicBatcher(azure_ep->GetBatchingWindow(), azure_ep->GetMaxBatchSize());
+      }
+    }
+#endif
+
+#if !defined(ORT_MINIMAL_BUILD)
+    // Look up the optimized model before anything refers to the graph of the loaded model.
+    // The execution providers that are part of the key are complete, apart from the default CPU execution provider,
+    // which is always added if there is none.
+    PathString optimized_model_cache_path;
+    ORT_RETURN_IF_ERROR_SESSIONID_(LoadFromOptimizedModelCache(optimized_model_cache_path));
+    const bool saving_to_optimized_model_cache = !optimized_model_cache_path.empty();
+#else
+    const bool saving_to_optimized_model_cache = false;
+#endif
+
     // Verify that there are no external initializers in the graph if external data is disabled.
     onnxruntime::Graph& graph = model_->MainGraph();
 #ifdef DISABLE_EXTERNAL_INITIALIZERS
@@ -1697,6 +2006,13 @@ common::Status InferenceSession::Initialize() {
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
       CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
+      epi.numa_node = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaNode, "-1"));
+      epi.tunable_op.enable =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpEnable, "0") == "1";
+      epi.tunable_op.tuning_enable =
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpTuningEnable, "0") == "1";
+      epi.tunable_op.max_tuning_duration_ms = std::stoi(
+          session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsCpuTunableOpMaxTuningDurationMs, "0"));
       auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi);
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
       execution_providers_.SetCpuProviderWasImplicitlyAdded(true);
@@ -1719,6 +2035,22 @@ common::Status InferenceSession::Initialize() {
     }
 #endif
 
+#if !defined(DISABLE_EXTERNAL_INITIALIZERS)
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrefetchExternalInitializers,
+                                                           "0") == "1" &&
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigLazyExternalInitializers,
+                                                           "0") != "1") {
+      // the external data is read while the graph is optimized and partitioned and the kernels are created
+      InlinedVector<const ONNX_NAMESPACE::TensorProto*> initializers;
+      CollectInitializers(graph, initializers);
+      auto prefetch_status = utils::PrefetchExternalData(env, model_location_, initializers);
+      if (!prefetch_status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << "Failed to prefetch the external initializers: "
+                                        << prefetch_status.ErrorMessage();
+      }
+    }
+#endif
+
 #ifdef ONNXRUNTIME_ENABLE_INSTRUMENT
     TraceLoggingWriteStart(session_activity, "OrtInferenceSessionActivity");
     session_activity_started_ = true;
@@ -1853,12 +2185,25 @@ common::Status InferenceSession::Initialize() {
       }
 #endif
 
+      graph.SetIncrementalTypeAndShapeInference(
+          session_options_.config_options.GetConfigOrDefault(
+              kOrtSessionOptionsIncrementalTypeAndShapeInference, "0") == "1");
+
       // apply any transformations to the main graph and any subgraphs
       ORT_RETURN_IF_ERROR_SESSIONID_(TransformGraph(graph, saving_ort_format));
 
       // now that all the transforms are done, call Resolve on the main graph. this will recurse into the subgraphs.
+      TimePoint resolve_tp;
+      if (session_profiler_.IsEnabled()) {
+        resolve_tp = session_profiler_.Start();
+      }
+
       ORT_RETURN_IF_ERROR_SESSIONID_(graph.Resolve());
 
+      if (session_profiler_.IsEnabled()) {
+        session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, "graph_resolve", resolve_tp);
+      }
+
       // Currently graph capture is only considered by CUDA EP, TRT EP, ROCM EP and JS EP.
       //
       // Check for CUDA EP:
@@ -2021,7 +2366,7 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR_SESSIONID_(
         session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
                                              // need to keep the initializers if saving the optimized model
-                                             !saving_model,
+                                             !saving_model && !saving_to_optimized_model_cache,
                                              saving_ort_format));
 
 #if !defined(ORT_MINIMAL_BUILD)
@@ -2054,14 +2399,22 @@ common::Status InferenceSession::Initialize() {
           const size_t optimized_model_external_initializers_min_size_in_bytes =
               ParseStringWithClassicLocale<size_t>(session_options_.config_options.GetConfigOrDefault(
                   kOrtSessionOptionsOptimizedModelExternalInitializersMinSizeInBytes, "1024"));
+          const bool compress_optimized_model_external_initializers =
+              session_options_.config_options.GetConfigOrDefault(
+                  kOrtSessionOptionsOptimizedModelExternalInitializersCompress, "0") == "1";
           ORT_RETURN_IF_ERROR_SESSIONID_(Model::SaveWithExternalInitializers(*model_,
                                                                              session_options_.optimized_model_filepath,
                                                                              optimized_model_external_initializers_file_name,
-                                                                             optimized_model_external_initializers_min_size_in_bytes));
+                                                                             optimized_model_external_initializers_min_size_in_bytes,
+                                                                             compress_optimized_model_external_initializers));
         }
       }
     }
 
+    if (saving_to_optimized_model_cache) {
+      SaveToOptimizedModelCache(optimized_model_cache_path);
+    }
+
     std::vector<TuningResults> tuning_results;
     bool found_tuning_results = false;
     ORT_RETURN_IF_ERROR_SESSIONID_(inference_session_utils::ParseTuningResultsFromModelMetadata(
@@ -2069,16 +2422,39 @@ common::Status InferenceSession::Initialize() {
     if (found_tuning_results) {
       ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false, /*auto_enable*/ true));
     }
+
+    const std::string tuning_results_file_path =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsTuningResultsFilePath, "");
+    if (!tuning_results_file_path.empty()) {
+      // a missing or unreadable file only means that the kernels have to be tuned again
+      auto status = inference_session_utils::LoadTuningResultsFromFile(tuning_results_file_path, tuning_results,
+                                                                         found_tuning_results);
+      if (!status.IsOK()) {
+        LOGS(*session_logger_, WARNING) << status.ErrorMessage() << ". Ignoring...";
+      } else if (found_tuning_results) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(SetTuningResults(tuning_results, /*error_on_invalid*/ false,
+                                                        /*auto_enable*/ true));
+      }
+    }
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigRecordExecution, "0") == "1") {
+      std::string reason;
+      record_execution_ = RecordedExecution::CanRecord(*session_state_, reason);
+      if (!record_execution_) {
+        LOGS(*session_logger_, WARNING) << "Runs are not recorded because " << reason;
+      }
+    }
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
       ort_format_model_bytes_ = gsl::span<const uint8_t>();
       std::vector<uint8_t>().swap(ort_format_model_bytes_data_holder_);
+      ort_format_model_mapped_bytes_.reset();
     }
 
     // once the model is saved, we may remove unnecessary attributes for inference
@@ -2129,6 +2505,70 @@ common::Status InferenceSession::Initialize() {
 #pragma warning(pop)
 #endif
 
+common::Status InferenceSession::Clone(std::unique_ptr<InferenceSession>& clone) const {
+  std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+  if (!is_inited_) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session must be initialized to be cloned.");
+  }
+
+  // the runs of the clones aren't serialized with the runs of this session, and a captured graph is owned by the EP
+  if (!is_concurrent_run_supported_ || cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "Sessions with execution providers that don't support concurrent runs or that capture "
+                           "graphs can't be cloned.");
+  }
+
+  // the clone runs on the thread pools of this session, so it doesn't create any threads
+  auto new_session = std::make_unique<InferenceSession>(session_options_, environment_,
+                                                        GetIntraOpThreadPoolToUse(), GetInterOpThreadPoolToUse());
+
+  for (const auto& provider : execution_providers_) {
+    ORT_RETURN_IF_ERROR(new_session->execution_providers_.Add(provider->Type(), provider));
+  }
+  new_session->execution_providers_.SetCpuProviderWasImplicitlyAdded(
+      execution_providers_.GetCpuProviderWasImplicitlyAdded());
+
+  new_session->cached_model_ = cached_model_;
+  new_session->model_ = model_;
+  new_session->model_location_ = model_location_;
+  new_session->custom_schema_registries_ = custom_schema_registries_;
+  new_session->custom_registries_ = custom_registries_;
+  new_session->session_state_ = session_state_;
+  new_session->model_metadata_ = model_metadata_;
+  new_session->input_def_map_ = input_def_map_;
+  new_session->output_def_map_ = output_def_map_;
+  new_session->record_execution_ = record_execution_;
+  new_session->initializers_lock_ = initializers_lock_;
+  new_session->is_model_loaded_ = true;
+  new_session->is_inited_ = true;
+
+  LOGS(*session_logger_, INFO) << "Cloned the session into session " << new_session->session_id_;
+  clone = std::move(new_session);
+  return Status::OK();
+}
+
+common::Status InferenceSession::UpdateInitializers(gsl::span<const std::string> names,
+                                                    gsl::span<const OrtValue> values) {
+  if (!IsInitialized()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Session must be initialized to update its initializers.");
+  }
+
+  // a captured graph keeps using the buffers of the previous values
+  if (cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "The initializers of a session capturing graphs can't be updated.");
+  }
+
+  // hold the runs starting meanwhile at the gate, and wait for the runs in progress to complete with the previous
+  // values so that no kernel runs while it is pre-packed again
+  std::lock_guard<OrtMutex> gate(initializers_lock_->gate);
+  std::unique_lock<std::shared_mutex> lock(initializers_lock_->mutex);
+  ORT_RETURN_IF_ERROR_SESSIONID_(session_state_->UpdateInitializedTensors(names, values));
+
+  LOGS(*session_logger_, INFO) << "Updated " << names.size() << " initializers";
+  return Status::OK();
+}
+
 int InferenceSession::GetCurrentNumRuns() const {
   return current_num_runs_.load();
 }
@@ -2146,7 +2586,8 @@ const SessionOptions& InferenceSession::GetSessionOptions() const {
 }
 
 const DataTransferManager& InferenceSession::GetDataTransferManager() const {
-  return data_transfer_mgr_;
+  // a clone has no data transfers of its own, it uses those of the session state it shares
+  return session_state_ ? session_state_->GetDataTransferMgr() : data_transfer_mgr_;
 }
 
 common::Status InferenceSession::CheckShapes(const std::string& input_output_name, const TensorShape& input_output_shape,
@@ -2463,6 +2904,56 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateGraphAnnotationId(run_options));
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info, nullptr);
+}
+
+Status InferenceSession::ValidateGraphAnnotationId(const RunOptions& run_options) const {
+  // the ids assigned to input shapes are only set by RunImpl, so that they never collide with the ids of the caller
+  const auto graph_annotation_str = run_options.config_options.GetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation);
+  if (!graph_capture_per_input_shapes_ || !graph_annotation_str.has_value()) {
+    return Status::OK();
+  }
+
+  int graph_annotation_id = 0;
+  if (!TryParseStringWithClassicLocale<int>(*graph_annotation_str, graph_annotation_id)) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Failed to parse the cuda graph annotation id: ",
+                           *graph_annotation_str);
+  }
+  if (graph_annotation_id >= kFirstInputShapesGraphAnnotationId) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "The graph annotation id ", graph_annotation_id,
+                           " is reserved for the graphs captured per input shapes, the ids from ",
+                           kFirstInputShapesGraphAnnotationId, " are assigned by the session when ",
+                           kOrtSessionOptionsConfigGraphCapturePerInputShapes, " is enabled.");
+  }
+  return Status::OK();
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 PreparedRun* prepared_run) {
+  // Hand the call to the dynamic batcher, which runs it (possibly batched with other calls) by calling back
+  // into this method.
+  if (dynamic_batcher_ && p_fetches != nullptr && p_fetches_device_info == nullptr &&
+      !DynamicBatcher::IsRunningBatch()) {
+    return dynamic_batcher_->Run(run_options, feed_names, feeds, output_names, *p_fetches);
+  }
+
+  // Run with the graph annotation id of the input shapes set in the run options, so that the execution provider
+  // captures and replays the graph of these shapes.
+  if (graph_capture_per_input_shapes_ && cached_execution_provider_for_graph_replay_.IsGraphCaptureEnabled() &&
+      !run_options.config_options.GetConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation).has_value()) {
+    int shape_graph_annotation_id = 0;
+    ORT_RETURN_IF_ERROR(GetGraphAnnotationIdForInputShapes(feed_names, feeds, shape_graph_annotation_id));
+    RunOptions shape_run_options = run_options;
+    ORT_RETURN_IF_ERROR(shape_run_options.config_options.AddConfigEntry(
+        kOrtRunOptionsConfigCudaGraphAnnotation, std::to_string(shape_graph_annotation_id).c_str()));
+    return RunImpl(shape_run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                   prepared_run);
+  }
+
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -2486,6 +2977,19 @@ Status InferenceSession::Run(const RunOptions& run_options,
     }
   }
 
+  int run_priority = 0;
+  const std::string& run_priority_str =
+      run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigRunPriority, "");
+  if (!run_priority_str.empty()) {
+    if (!TryParseStringWithClassicLocale<int>(run_priority_str, run_priority) ||
+        run_priority < concurrency::ThreadPool::kMinRunPriority ||
+        run_priority > concurrency::ThreadPool::kMaxRunPriority) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid run priority: ", run_priority_str,
+                             ". It must be an integer in [", concurrency::ThreadPool::kMinRunPriority, ", ",
+                             concurrency::ThreadPool::kMaxRunPriority, "].");
+    }
+  }
+
   // Increment/decrement concurrent_num_runs_ and control
   // session threads spinning as configured. Do nothing for graph replay except the counter.
   const bool control_spinning = use_per_session_threads_ &&
@@ -2495,6 +2999,13 @@ Status InferenceSession::Run(const RunOptions& run_options,
   auto* inter_tp = (control_spinning) ? inter_op_thread_pool_.get() : nullptr;
   ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
 
+  // the run uses the initializers and the pre-packed kernels until it completes, see UpdateInitializers
+  std::shared_lock<std::shared_mutex> initializers_lock;
+  {
+    std::lock_guard<OrtMutex> gate(initializers_lock_->gate);
+    initializers_lock = std::shared_lock<std::shared_mutex>(initializers_lock_->mutex);
+  }
+
   // Check if this Run() is simply going to be a CUDA Graph replay.
   if (cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
     LOGS(*session_logger_, INFO) << "Replaying the captured "
@@ -2517,8 +3028,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
       // log evaluation start to trace logging provider
       env.GetTelemetryProvider().LogEvaluationStart();
 
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      if (prepared_run) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidatePreparedRun(*prepared_run, feeds, *p_fetches));
+      } else {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      }
 
       // shrink certain default memory arenas if the user has requested for it
       const std::string& shrink_memory_arenas =
@@ -2528,8 +3043,23 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
       }
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+      const bool fail_on_arena_allocation =
+          run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigFailOnArenaAllocation, "0") == "1";
+      InlinedVector<std::pair<AllocatorPtr, AllocatorStats>> arena_stats;
+      if (fail_on_arena_allocation) {
+        GetArenaStats(arena_stats);
+      }
+
+      // a prepared run has its copy info set up already, unless the devices of the feeds or fetches changed
+      std::optional<FeedsFetchesManager> run_feeds_fetches_manager;
+      if (prepared_run) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(prepared_run->FinalizeCopyInfo(*session_state_, feeds, *p_fetches));
+      } else {
+        run_feeds_fetches_manager.emplace(
+            FeedsFetchesInfo(feed_names, output_names, session_state_->GetOrtValueNameIdxMap()));
+      }
+      FeedsFetchesManager& feeds_fetches_manager =
+          prepared_run ? *prepared_run->feeds_fetches_manager_ : *run_feeds_fetches_manager;
 
       if (p_fetches_device_info) {
         // populate the target device info. ignored if pre-allocated fetches are provided
@@ -2555,6 +3085,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
         sequential_run_lock.emplace(session_mutex_);
       }
 
+      // registered once the run holds its locks, so that runs with a lower priority never wait for one blocked
+      // on them
+      concurrency::ThreadPool::RunPriorityScope run_priority_scope(GetIntraOpThreadPoolToUse(), run_priority);
+
       // info all execution providers InferenceSession:Run started
       // TODO: only call OnRunStart for all providers in-use
       for (auto& xp : execution_providers_) {
@@ -2588,14 +3122,30 @@ Status InferenceSession::Run(const RunOptions& run_options,
       DeviceStreamCollectionHolder device_stream_collection_holder(session_state_.get());
 #endif
 
-      if (retval.IsOK()) {
-        retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                                     session_options_.execution_mode,
-                                     run_options,
+      bool ran_recorded_execution = false;
+      if (retval.IsOK() && record_execution_ && p_fetches_device_info == nullptr) {
+        retval = RunRecordedExecution(run_options, feed_names, feeds, output_names, *p_fetches,
+                                      ran_recorded_execution);
+      }
+
+      if (retval.IsOK() && !ran_recorded_execution) {
+        if (prepared_run) {
+          retval = utils::ExecuteGraphWithFinalizedCopyInfo(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                                            session_options_.execution_mode,
+                                                            run_options,
 #ifdef ORT_ENABLE_STREAM
-                                     device_stream_collection_holder,
+                                                            device_stream_collection_holder,
 #endif
-                                     run_logger);
+                                                            run_logger);
+        } else {
+          retval = utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
+                                       session_options_.execution_mode,
+                                       run_options,
+#ifdef ORT_ENABLE_STREAM
+                                       device_stream_collection_holder,
+#endif
+                                       run_logger);
+        }
       }
 
       // info all execution providers InferenceSession:Run ended
@@ -2615,6 +3165,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_CHECK_AND_SET_RETVAL(device_stream_collection->CleanUp(sync_execution_provider));
       }
 #endif
+
+      if (fail_on_arena_allocation) {
+        ORT_CHECK_AND_SET_RETVAL(CheckNoArenaAllocation(arena_stats));
+      }
     }
     ORT_CATCH(const std::exception& e) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -2626,10 +3180,14 @@ Status InferenceSession::Run(const RunOptions& run_options,
     }
 
     if (!arenas_to_shrink.empty()) {
-      ShrinkMemoryArenas(arenas_to_shrink);
+      const bool to_working_set =
+          run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigMemoryArenaShrinkToWorkingSet, "0") == "1";
+      ShrinkMemoryArenas(arenas_to_shrink, to_working_set);
     }
   }
 
+  initializers_lock.unlock();
+
   // keep track of telemetry
   ++telemetry_.total_runs_since_last_;
   telemetry_.total_run_duration_since_last_ += TimeDiffMicroSeconds(tp);
@@ -2666,11 +3224,107 @@ Status InferenceSession::Run(const RunOptions& run_options,
       cached_execution_provider_for_graph_replay_.AllowGraphCaptureOnRun(graph_annotation_id) &&
       !cached_execution_provider_for_graph_replay_.IsGraphCaptured(graph_annotation_id)) {
     LOGS(*session_logger_, INFO) << "Start another run for necessary memory allocation or graph capture.";
-    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
+    ORT_RETURN_IF_ERROR(RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                                prepared_run));
   }
   return retval;
 }
 
+Status InferenceSession::RunRecordedExecution(const RunOptions& run_options,
+                                              gsl::span<const std::string> feed_names,
+                                              gsl::span<const OrtValue> feeds,
+                                              gsl::span<const std::string> output_names,
+                                              std::vector<OrtValue>& fetches, bool& ran) {
+  ran = false;
+#ifdef ENABLE_TRAINING
+  if (run_options.only_execute_path_to_fetches) {
+    return Status::OK();
+  }
+#endif
+  if (session_profiler_.IsEnabled()) {
+    return Status::OK();
+  }
+
+  auto is_cpu_tensor = [](const OrtValue& value) {
+    return value.IsTensor() && value.Get<Tensor>().Location().device.Type() == OrtDevice::CPU;
+  };
+  if (!std::all_of(feeds.begin(), feeds.end(), is_cpu_tensor) ||
+      !std::all_of(fetches.begin(), fetches.end(),
+                   [&is_cpu_tensor](const OrtValue& value) { return !value.IsAllocated() || is_cpu_tensor(value); })) {
+    return Status::OK();
+  }
+
+  // the recording is used by one run at a time. other runs go through the executor instead of waiting.
+  std::unique_lock<OrtMutex> lock(recorded_execution_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return Status::OK();
+  }
+
+  // the recorded run holds the initializers it ran with
+  if (recorded_execution_ && recorded_initializers_version_ != session_state_->GetInitializedTensorsVersion()) {
+    recorded_execution_.reset();
+  }
+
+  if (recorded_execution_ && recorded_execution_->CanReplay(feed_names, feeds, output_names)) {
+    Status status = recorded_execution_->Replay(feeds, fetches, run_options.terminate);
+    if (status.IsOK() || run_options.terminate) {
+      ran = true;
+      return status;
+    }
+
+    // e.g. an output shape depends on the input data. run through the executor, and record again next time.
+    LOGS(*session_logger_, INFO) << "Replaying the recorded execution failed, running through the executor. "
+                                 << status.ErrorMessage();
+    recorded_execution_.reset();
+    return Status::OK();
+  }
+
+  VLOGS(*session_logger_, 1) << "Recording the execution of the run";
+  ran = true;
+  recorded_initializers_version_ = session_state_->GetInitializedTensorsVersion();
+  return RecordedExecution::Record(*session_state_, feed_names, feeds, output_names, fetches, *session_logger_,
+                                   run_options.terminate, recorded_execution_);
+}
+
+Status InferenceSession::GetGraphAnnotationIdForInputShapes(gsl::span<const std::string> feed_names,
+                                                            gsl::span<const OrtValue> feeds,
+                                                            int& graph_annotation_id) {
+  std::ostringstream key;
+  for (size_t i = 0, end = std::min(feed_names.size(), feeds.size()); i < end; ++i) {
+    if (!feeds[i].IsTensor()) {
+      // only the shapes of tensors are known, so don't capture a graph for other inputs
+      graph_annotation_id = CachedExecutionProviderForGraphReplay::kGraphAnnotationSkip;
+      return Status::OK();
+    }
+    key << feed_names[i] << feeds[i].Get<Tensor>().Shape() << ';';
+  }
+
+  std::lock_guard<OrtMutex> lock(graph_annotation_ids_mutex_);
+  std::string key_str = key.str();
+  auto it = graph_annotation_ids_.find(key_str);
+  if (it != graph_annotation_ids_.end()) {
+    graph_annotation_ids_lru_.splice(graph_annotation_ids_lru_.begin(), graph_annotation_ids_lru_, it->second);
+    graph_annotation_id = it->second->second;
+    return Status::OK();
+  }
+
+  if (graph_capture_max_graphs_ > 0 && graph_annotation_ids_lru_.size() >= graph_capture_max_graphs_) {
+    const auto& least_recent = graph_annotation_ids_lru_.back();
+    LOGS(*session_logger_, INFO) << "Releasing the graph with annotation id " << least_recent.second
+                                 << " captured for input shapes " << least_recent.first;
+    ORT_RETURN_IF_ERROR(cached_execution_provider_for_graph_replay_.ReleaseGraph(least_recent.second));
+    graph_annotation_ids_.erase(least_recent.first);
+    graph_annotation_ids_lru_.pop_back();
+  }
+
+  ORT_RETURN_IF(next_graph_annotation_id_ == std::numeric_limits<int>::max(),
+                "All the graph annotation ids for input shapes have been assigned.");
+  graph_annotation_id = next_graph_annotation_id_++;
+  graph_annotation_ids_lru_.emplace_front(key_str, graph_annotation_id);
+  graph_annotation_ids_.emplace(std::move(key_str), graph_annotation_ids_lru_.begin());
+  return Status::OK();
+}
+
 Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const char* const> feed_names,
                              gsl::span<const OrtValue* const> feeds,
@@ -2754,6 +3408,7 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
   if (!tp || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "intra op thread pool must have at least one thread for RunAsync");
   }
+  RunCompletionQueue* completion_queue = run_options ? run_options->completion_queue : nullptr;
   std::function<void()> run_fn = [=]() {
     Status status = Status::OK();
     ORT_TRY {
@@ -2772,7 +3427,13 @@ common::Status InferenceSession::RunAsync(const RunOptions* run_options,
     ORT_CATCH(...) {
       status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "unknown exception");
     }
-    callback(user_data, fetches.data(), status.IsOK() ? num_fetches : 0, ToOrtStatus(status));
+    const size_t num_outputs = status.IsOK() ? num_fetches : 0;
+    if (completion_queue) {
+      OrtStatus* ort_status = ToOrtStatus(status);
+      completion_queue->Push([=]() { callback(user_data, fetches.data(), num_outputs, ort_status); });
+    } else {
+      callback(user_data, fetches.data(), num_outputs, ToOrtStatus(status));
+    }
   };  // run_fn
   concurrency::ThreadPool::Schedule(tp, run_fn);
   return Status::OK();
@@ -2783,6 +3444,50 @@ common::Status InferenceSession::Run(const NameMLValMap& feeds, gsl::span<const
   return Run(RunOptions(), feeds, output_names, p_fetches);
 }
 
+common::Status InferenceSession::RunBatch(const RunOptions& run_options, gsl::span<const NameMLValMap> feeds,
+                                          gsl::span<const std::string> output_names,
+                                          std::vector<std::vector<OrtValue>>* p_fetches) {
+  ORT_RETURN_IF(p_fetches == nullptr, "Output vector pointer is NULL");
+  p_fetches->clear();
+  p_fetches->resize(feeds.size());
+  std::vector<Status> statuses(feeds.size());
+  auto run_request = [&](size_t i) {
+    ORT_TRY {
+      statuses[i] = Run(run_options, feeds[i], output_names, &(*p_fetches)[i]);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        statuses[i] = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+      });
+    }
+  };
+
+  // as for RunAsync, the requests are scheduled as tasks on the intra op threads rather than in a parallel loop, so
+  // that the parallel loops of their kernels are not nested in it. The inter op threads are not used: a run with
+  // several streams blocks its thread until they complete. The calling thread runs the first request.
+  auto* tp = GetIntraOpThreadPoolToUse();
+  if (feeds.size() < 2 || tp == nullptr || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2) {
+    for (size_t i = 0; i < feeds.size(); ++i) {
+      run_request(i);
+    }
+  } else {
+    Barrier barrier(static_cast<unsigned int>(feeds.size() - 1));
+    for (size_t i = 1; i < feeds.size(); ++i) {
+      concurrency::ThreadPool::Schedule(tp, [&run_request, &barrier, i]() {
+        run_request(i);
+        barrier.Notify();
+      });
+    }
+    run_request(0);
+    barrier.Wait();
+  }
+
+  for (auto& status : statuses) {
+    ORT_RETURN_IF_ERROR(status);
+  }
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const RunOptions& run_options, const NameMLValMap& feeds_map,
                                      gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches) {
   InlinedVector<std::string> feed_names;
@@ -2866,8 +3571,11 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
-  return Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(), io_binding.GetOutputNames(),
-             &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+  io_binding.PrepareStates();
+  const auto status = Run(run_options, io_binding.GetInputNames(), io_binding.GetInputs(),
+                          io_binding.GetOutputNames(), &io_binding.GetOutputs(), &io_binding.GetOutputsDeviceInfo());
+  io_binding.AdvanceStates(status.IsOK());
+  return status;
 }
 
 common::Status InferenceSession::Run(IOBinding& io_binding) {
@@ -2875,6 +3583,227 @@ common::Status InferenceSession::Run(IOBinding& io_binding) {
   return Run(run_options, io_binding);
 }
 
+Status PreparedRun::FinalizeCopyInfo(const SessionState& session_state, gsl::span<const OrtValue> feeds,
+                                     std::vector<OrtValue>& fetches) {
+  if (!copy_info_depends_on_devices_) {
+    return Status::OK();
+  }
+
+  const size_t num_outputs = feeds_fetches_info_.output_names.size();
+  fetches.resize(num_outputs);
+
+  bool devices_changed = feeds_fetches_manager_ == nullptr;
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    const OrtDevice& device = feeds[i].Get<Tensor>().Location().device;
+    if (feed_devices_[i] != device) {
+      feed_devices_[i] = device;
+      devices_changed = true;
+    }
+  }
+
+  for (size_t i = 0; i < num_outputs; ++i) {
+    std::optional<OrtDevice> device;
+    if (fetches[i].IsAllocated()) {
+      device = fetches[i].Get<Tensor>().Location().device;
+    }
+    if (fetch_devices_[i] != device) {
+      fetch_devices_[i] = device;
+      devices_changed = true;
+    }
+  }
+
+  if (!devices_changed) {
+    return Status::OK();
+  }
+
+  // the copy info of a FeedsFetchesManager can only be finalized once, so it's set up again for the new devices.
+  // if that fails, the next run sets it up again.
+  feeds_fetches_manager_.reset();
+  auto feeds_fetches_manager = std::make_unique<FeedsFetchesManager>(FeedsFetchesInfo(feeds_fetches_info_));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, *feeds_fetches_manager));
+
+  InlinedVector<const OrtDevice*> fetch_alloc_info;
+  fetch_alloc_info.reserve(num_outputs);
+  for (const auto& device : fetch_devices_) {
+    fetch_alloc_info.push_back(device.has_value() ? &*device : nullptr);
+  }
+  utils::FinalizeFeedFetchCopyInfo(*feeds_fetches_manager, feed_devices_, fetch_alloc_info);
+
+  feeds_fetches_manager_ = std::move(feeds_fetches_manager);
+  return Status::OK();
+}
+
+common::Status InferenceSession::PrepareRun(gsl::span<const std::string> feed_names,
+                                            gsl::span<const std::string> output_names,
+                                            std::unique_ptr<PreparedRun>& prepared_run) const {
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  if (output_names.empty()) {
+    return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "At least one output should be requested.");
+  }
+
+  auto get_tensor_meta_data = [](const std::string& name, const InputOutputDefMetaMap& meta_map,
+                                 const char* input_output_moniker,
+                                 InlinedVector<PreparedRun::TensorMetaData>& tensor_meta_data) -> Status {
+    auto iter = meta_map.find(name);
+    if (meta_map.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid ", input_output_moniker, " name: ", name);
+    }
+
+    const auto& meta_data = iter->second;
+    if (!meta_data.ml_data_type->IsTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "A prepared run only supports tensors. ",
+                             input_output_moniker, " with name: '", name, "' is not a tensor.");
+    }
+
+    tensor_meta_data.push_back({meta_data.ml_data_type->AsTensorType()->GetElementType(), meta_data.tensor_shape});
+    return Status::OK();
+  };
+
+  std::unique_ptr<PreparedRun> run(new PreparedRun());
+  run->feed_meta_data_.reserve(feed_names.size());
+  for (const auto& name : feed_names) {
+    ORT_RETURN_IF_ERROR(get_tensor_meta_data(name, input_def_map_, "input", run->feed_meta_data_));
+  }
+  run->output_meta_data_.reserve(output_names.size());
+  for (const auto& name : output_names) {
+    ORT_RETURN_IF_ERROR(get_tensor_meta_data(name, output_def_map_, "output", run->output_meta_data_));
+  }
+
+  run->feeds_fetches_info_.feed_names.assign(feed_names.begin(), feed_names.end());
+  run->feeds_fetches_info_.output_names.assign(output_names.begin(), output_names.end());
+  ORT_RETURN_IF_ERROR(run->feeds_fetches_info_.SetMLValueIdxs(session_state_->GetOrtValueNameIdxMap()));
+
+  // with only CPU based providers no copies are needed whatever the devices of the feeds and fetches are, and the
+  // copy info is complete once initialized. otherwise it's set up by the first run.
+  run->feeds_fetches_manager_ = std::make_unique<FeedsFetchesManager>(FeedsFetchesInfo(run->feeds_fetches_info_));
+  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(*session_state_, *run->feeds_fetches_manager_));
+  if (run->feeds_fetches_manager_->GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy) {
+    run->copy_info_depends_on_devices_ = true;
+    run->feeds_fetches_manager_.reset();
+    run->feed_devices_.resize(feed_names.size());
+    run->fetch_devices_.resize(output_names.size());
+  }
+
+  prepared_run = std::move(run);
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidatePreparedRun(const PreparedRun& prepared_run,
+                                                     gsl::span<const OrtValue> feeds,
+                                                     const std::vector<OrtValue>& fetches) const {
+  const auto feed_names = prepared_run.FeedNames();
+  const auto output_names = prepared_run.OutputNames();
+  if (feeds.size() != feed_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "feed names has ", feed_names.size(),
+                           " elements, but feed has ", feeds.size(), " elements.");
+  }
+  if (!fetches.empty() && fetches.size() != output_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fetch names has ", output_names.size(),
+                           " elements, but fetch has ", fetches.size(), " elements.");
+  }
+
+  auto validate_tensor = [this](const std::string& name, const OrtValue& value,
+                                const PreparedRun::TensorMetaData& meta_data,
+                                const char* input_output_moniker) -> Status {
+    if (!value.IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, input_output_moniker, " with name: '", name,
+                             "' expected to be a tensor.");
+    }
+
+    const auto& tensor = value.Get<Tensor>();
+    ORT_RETURN_IF_ERROR(CheckTypes(tensor.DataType(), meta_data.element_type, "tensor", input_output_moniker));
+    if (meta_data.shape.has_value() && !meta_data.shape->GetDims().empty()) {
+      ORT_RETURN_IF_ERROR(CheckShapes(name, tensor.Shape(), *meta_data.shape, input_output_moniker));
+    }
+    return Status::OK();
+  };
+
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    ORT_RETURN_IF_ERROR_SESSIONID_(validate_tensor(feed_names[i], feeds[i], prepared_run.feed_meta_data_[i], "input"));
+  }
+
+  // the user may supply unallocated placeholders for the outputs
+  for (size_t i = 0, end = fetches.size(); i < end; ++i) {
+    if (fetches[i].IsAllocated()) {
+      ORT_RETURN_IF_ERROR_SESSIONID_(validate_tensor(output_names[i], fetches[i], prepared_run.output_meta_data_[i],
+                                                     "output"));
+    }
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                     gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches) {
+  ORT_RETURN_IF_ERROR_SESSIONID_(ValidateGraphAnnotationId(run_options));
+  return RunImpl(run_options, prepared_run.FeedNames(), feeds, prepared_run.OutputNames(), &fetches, nullptr,
+                 &prepared_run);
+}
+
+common::Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                     gsl::span<const OrtValue* const> feeds, gsl::span<OrtValue*> fetches) {
+  if (feeds.size() != prepared_run.FeedNames().size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "feed names has ", prepared_run.FeedNames().size(),
+                           " elements, but feed has ", feeds.size(), " elements.");
+  }
+  if (fetches.size() != prepared_run.OutputNames().size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "fetch names has ", prepared_run.OutputNames().size(),
+                           " elements, but fetch has ", fetches.size(), " elements.");
+  }
+
+  // the buffers of the prepared run keep their capacity across runs
+  auto& feed_vec = prepared_run.feeds_;
+  feed_vec.clear();
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    if (!feeds[i]) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NULL input supplied for input ",
+                             prepared_run.FeedNames()[i]);
+    }
+    feed_vec.push_back(*feeds[i]);
+  }
+
+  auto& fetch_vec = prepared_run.fetches_;
+  fetch_vec.clear();
+  for (auto* fetch : fetches) {
+    if (fetch != nullptr) {
+      fetch_vec.push_back(*fetch);
+    } else {
+      fetch_vec.emplace_back();
+    }
+  }
+
+  // release the references to the values held by the buffers when the run is done
+  auto clear_buffers = gsl::finally([&feed_vec, &fetch_vec]() {
+    feed_vec.clear();
+    fetch_vec.clear();
+  });
+
+  ORT_RETURN_IF_ERROR(Run(run_options, prepared_run, gsl::make_span(feed_vec), fetch_vec));
+
+  // We do it in two loops to make sure copy __ctors does not throw
+  InlinedVector<std::unique_ptr<OrtValue>> fetch_unique_ptrs;
+  fetch_unique_ptrs.reserve(fetches.size());
+  for (size_t i = 0, end = fetches.size(); i < end; ++i) {
+    if (fetches[i] == nullptr) {
+      fetch_unique_ptrs.emplace_back(std::make_unique<OrtValue>(fetch_vec[i]));
+    } else {
+      fetch_unique_ptrs.emplace_back();
+    }
+  }
+
+  for (size_t i = 0, end = fetches.size(); i < end; ++i) {
+    if (fetches[i] == nullptr) {
+      fetches[i] = fetch_unique_ptrs[i].release();
+    }
+  }
+
+  return Status::OK();
+}
+
 template <typename T>
 void InferenceSession::StartProfiling(const std::basic_string<T>& file_prefix) {
   std::basic_ostringstream<T> ss;
@@ -2899,6 +3828,16 @@ void InferenceSession::StartProfiling(const logging::Logger* logger_ptr) {
 std::string InferenceSession::EndProfiling() {
   if (is_model_loaded_) {
     if (session_profiler_.IsEnabled()) {
+      auto* hardware_counters = session_state_ ? session_state_->GetHardwareCounters() : nullptr;
+      if (hardware_counters != nullptr) {
+        for (const auto& [op_type, totals] : hardware_counters->TakeOpTypeTotals()) {
+          session_profiler_.EndTimeAndRecordEvent(profiling::SESSION_EVENT, op_type + "_hardware_counters",
+                                                  session_profiler_.Start(),
+                                                  {{"op_type", op_type},
+                                                   {"count", std::to_string(totals.count)},
+                                                   {"counters", profiling::HardwareCounters::ToJson(totals.values)}});
+        }
+      }
       return session_profiler_.EndProfiling();
     } else {
       LOGS(*session_logger_, VERBOSE) << "Profiler is disabled.";
@@ -2913,6 +3852,100 @@ const profiling::Profiler& InferenceSession::GetProfiling() const {
   return session_profiler_;
 }
 
+concurrency::ThreadPoolStats InferenceSession::GetIntraOpThreadPoolStats() const {
+  return concurrency::ThreadPool::GetStats(GetIntraOpThreadPoolToUse());
+}
+
+namespace {
+
+// Name of a node in the latency histograms, the same as in profiles.
+std::string LatencyHistogramNodeName(const Node& node) {
+  return node.Name().empty() ? MakeString(node.OpType(), "_", node.Index()) : node.Name();
+}
+
+}  // namespace
+
+Status InferenceSession::GetNodeLatencyPercentile(const std::string& node_name, double percentile,
+                                                  int64_t& latency_ns) const {
+  ORT_RETURN_IF_NOT(is_inited_, "Session was not initialized");
+  const auto* histograms = session_state_->GetLatencyHistograms();
+  ORT_RETURN_IF(histograms == nullptr, "Latency histograms are not enabled, set the ",
+                kOrtSessionOptionsConfigEnableLatencyHistograms, " session config entry to 1");
+  for (const auto& node : session_state_->GetGraphViewer().Nodes()) {
+    if (LatencyHistogramNodeName(node) == node_name) {
+      latency_ns = static_cast<int64_t>(histograms->GetSnapshot(node.Index()).ValueAtPercentile(percentile));
+      return Status::OK();
+    }
+  }
+  return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Node '", node_name, "' is not in the main graph");
+}
+
+Status InferenceSession::GetOpTypeLatencyPercentile(const std::string& op_type, double percentile,
+                                                    int64_t& latency_ns) const {
+  ORT_RETURN_IF_NOT(is_inited_, "Session was not initialized");
+  const auto* histograms = session_state_->GetLatencyHistograms();
+  ORT_RETURN_IF(histograms == nullptr, "Latency histograms are not enabled, set the ",
+                kOrtSessionOptionsConfigEnableLatencyHistograms, " session config entry to 1");
+  profiling::LatencyHistograms::Snapshot snapshot;
+  bool found = false;
+  for (const auto& node : session_state_->GetGraphViewer().Nodes()) {
+    if (node.OpType() == op_type) {
+      snapshot.Merge(histograms->GetSnapshot(node.Index()));
+      found = true;
+    }
+  }
+  ORT_RETURN_IF_NOT(found, "No node of operator type '", op_type, "' in the main graph");
+  latency_ns = static_cast<int64_t>(snapshot.ValueAtPercentile(percentile));
+  return Status::OK();
+}
+
+Status InferenceSession::GetLatencyHistogramsPrometheus(std::string& text) const {
+  ORT_RETURN_IF_NOT(is_inited_, "Session was not initialized");
+  const auto* histograms = session_state_->GetLatencyHistograms();
+  ORT_RETURN_IF(histograms == nullptr, "Latency histograms are not enabled, set the ",
+                kOrtSessionOptionsConfigEnableLatencyHistograms, " session config entry to 1");
+
+  using profiling::LatencyHistograms;
+  std::ostringstream out;
+  std::map<std::string, LatencyHistograms::Snapshot> op_type_snapshots;
+  out << "# HELP onnxruntime_node_latency_seconds Latency of the kernel of a node.\n"
+      << "# TYPE onnxruntime_node_latency_seconds histogram\n";
+  for (const auto& node : session_state_->GetGraphViewer().Nodes()) {
+    auto snapshot = histograms->GetSnapshot(node.Index());
+    LatencyHistograms::WritePrometheus(
+        out, "onnxruntime_node_latency_seconds",
+        MakeString("node=\"", LatencyHistograms::EscapeLabelValue(LatencyHistogramNodeName(node)),
+                   "\",op_type=\"", LatencyHistograms::EscapeLabelValue(node.OpType()), "\""),
+        snapshot);
+    op_type_snapshots[node.OpType()].Merge(snapshot);
+  }
+  out << "# HELP onnxruntime_op_type_latency_seconds Latency of the kernels of the nodes of an operator type.\n"
+      << "# TYPE onnxruntime_op_type_latency_seconds histogram\n";
+  for (const auto& [op_type, snapshot] : op_type_snapshots) {
+    LatencyHistograms::WritePrometheus(
+        out, "onnxruntime_op_type_latency_seconds",
+        MakeString("op_type=\"", LatencyHistograms::EscapeLabelValue(op_type), "\""), snapshot);
+  }
+  text = out.str();
+  return Status::OK();
+}
+
+Status InferenceSession::GetActivationStatistics(
+    std::unordered_map<std::string, ActivationStatistics::Snapshot>& statistics) const {
+  ORT_RETURN_IF_NOT(is_inited_, "Session was not initialized");
+  const auto* activation_statistics = session_state_->GetActivationStatistics();
+  ORT_RETURN_IF(activation_statistics == nullptr, "Activation statistics are not collected, set the ",
+                kOrtSessionOptionsConfigCollectActivationStatistics, " session config entry to 1");
+  statistics.clear();
+  for (const auto& [name, idx] : session_state_->GetOrtValueNameIdxMap()) {
+    auto snapshot = activation_statistics->GetSnapshot(static_cast<size_t>(idx));
+    if (snapshot.count > 0) {
+      statistics.emplace(name, std::move(snapshot));
+    }
+  }
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   std::vector<TuningResults> ret;
@@ -2925,6 +3958,36 @@ std::vector<TuningResults> InferenceSession::GetTuningResults() const {
   return ret;
 }
 
+void InferenceSession::SaveTuningResultsFile() const {
+  const std::string file_path =
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsTuningResultsFilePath, "");
+  if (file_path.empty() || !is_inited_) {
+    return;
+  }
+
+  // only the sessions that tuned have new results to save
+  const bool tuning_enabled = std::any_of(execution_providers_.begin(), execution_providers_.end(),
+                                          [](const auto& provider) {
+                                            const auto* tuning_ctx = provider->GetTuningContext();
+                                            return tuning_ctx != nullptr && tuning_ctx->IsTuningEnabled();
+                                          });
+  if (!tuning_enabled) {
+    return;
+  }
+
+  ORT_TRY {
+    auto status = inference_session_utils::SaveTuningResultsToFile(file_path, GetTuningResults());
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "Failed to save tuning results: " << status.ErrorMessage();
+    }
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      LOGS(*session_logger_, WARNING) << "Failed to save tuning results: " << e.what();
+    });
+  }
+}
+
 Status InferenceSession::SetTuningResults(
     const std::vector<TuningResults>& trs,
     bool error_on_invalid,
@@ -3028,9 +4091,10 @@ common::Status InferenceSession::ValidateAndParseShrinkArenaString(const std::st
   return Status::OK();
 }
 
-void InferenceSession::ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink) {
+void InferenceSession::ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink, bool to_working_set) {
   for (auto& alloc : arenas_to_shrink) {
-    auto status = static_cast<BFCArena*>(alloc.get())->Shrink();
+    auto* arena = static_cast<BFCArena*>(alloc.get());
+    auto status = to_working_set ? arena->TrimToWorkingSet() : arena->Shrink();
 
     if (!status.IsOK()) {
       LOGS(*session_logger_, WARNING) << "Unable to shrink arena: " << alloc->Info().ToString()
@@ -3039,6 +4103,34 @@ void InferenceSession::ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_t
   }
 }
 
+void InferenceSession::GetArenaStats(InlinedVector<std::pair<AllocatorPtr, AllocatorStats>>& arena_stats) const {
+  for (const auto& [device, alloc] : session_state_->GetAllocators()) {
+    if (alloc->Info().alloc_type == OrtAllocatorType::OrtArenaAllocator) {
+      AllocatorStats stats;
+      alloc->GetStats(&stats);
+      arena_stats.emplace_back(alloc, stats);
+    }
+  }
+}
+
+common::Status InferenceSession::CheckNoArenaAllocation(
+    gsl::span<const std::pair<AllocatorPtr, AllocatorStats>> arena_stats) const {
+  for (const auto& [alloc, stats_before_run] : arena_stats) {
+    AllocatorStats stats;
+    alloc->GetStats(&stats);
+    if (stats.num_arena_extensions > stats_before_run.num_arena_extensions ||
+        stats.num_reserves > stats_before_run.num_reserves) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "The run allocated memory from the system through the arena ",
+                             alloc->Info().ToString(), ": ",
+                             stats.num_arena_extensions - stats_before_run.num_arena_extensions, " extensions and ",
+                             stats.num_reserves - stats_before_run.num_reserves, " reserves, while ",
+                             kOrtRunOptionsConfigFailOnArenaAllocation, " is set.");
+    }
+  }
+
+  return Status::OK();
+}
+
 #if !defined(ORT_MINIMAL_BUILD)
 // assumes model has already been loaded before
 common::Status InferenceSession::DoPostLoadProcessing(onnxruntime::Model& model) {
@@ -3,8 +3,11 @@
 
 #pragma once
 
+#include <chrono>
+#include <list>
 #include <map>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <filesystem>
@@ -20,6 +23,7 @@
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/recorded_execution.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tuning_results.h"
 #include "core/framework/framework_provider_common.h"
@@ -28,6 +32,7 @@
 #include "core/optimizer/graph_transformer_level.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/insert_cast_transformer.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
 #ifdef ENABLE_LANGUAGE_INTEROP_OPS
 #include "core/language_interop_ops/language_interop_ops.h"
@@ -46,11 +51,14 @@ class ModelProto;
 }  // namespace ONNX_NAMESPACE
 
 namespace onnxruntime {  // forward declarations
+struct CachedModel;
 class CustomRegistry;
+class DynamicBatcher;
 class Environment;
 class GraphTransformer;
 class IExecutionProvider;
 class IOBinding;
+class PrefixKVCache;
 struct Notification;
 
 #ifdef ENABLE_TRAINING
@@ -81,6 +89,51 @@ struct ModelMetadata {
   std::unordered_map<std::string, std::string> custom_metadata_map;
 };
 
+/**
+ * Inputs and outputs of runs that always use the same tensor inputs and outputs, resolved once by
+ * InferenceSession::PrepareRun.
+ * A run with it skips the lookups of the names, and sets up the device copies of the feeds and fetches only when
+ * their devices differ from the previous run. Only the types and shapes of the feeds and of pre-allocated fetches are
+ * validated.
+ * Not thread-safe: a prepared run must not be used by concurrent Run() calls. It must not outlive its session.
+ */
+class PreparedRun {
+ public:
+  gsl::span<const std::string> FeedNames() const { return feeds_fetches_info_.feed_names; }
+  gsl::span<const std::string> OutputNames() const { return feeds_fetches_info_.output_names; }
+
+ private:
+  friend class InferenceSession;
+
+  struct TensorMetaData {
+    MLDataType element_type;
+    std::optional<TensorShape> shape;
+  };
+
+  PreparedRun() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+  // Sets up the copy info of feeds_fetches_manager_ for the devices of feeds and fetches, if they differ from the
+  // devices of the previous run.
+  Status FinalizeCopyInfo(const SessionState& session_state, gsl::span<const OrtValue> feeds,
+                          std::vector<OrtValue>& fetches);
+
+  FeedsFetchesInfo feeds_fetches_info_;
+  InlinedVector<TensorMetaData> feed_meta_data_;
+  InlinedVector<TensorMetaData> output_meta_data_;
+
+  // whether the copy info depends on the devices of the feeds and fetches, i.e. the session has non-CPU providers
+  bool copy_info_depends_on_devices_ = false;
+  std::unique_ptr<FeedsFetchesManager> feeds_fetches_manager_;
+  InlinedVector<OrtDevice> feed_devices_;
+  // the devices of the pre-allocated fetches. nullopt if the fetch is allocated by the run.
+  InlinedVector<std::optional<OrtDevice>> fetch_devices_;
+
+  // buffers for the feeds and fetches of the Run() overload taking pointers, reused by its calls
+  std::vector<OrtValue> feeds_;
+  std::vector<OrtValue> fetches_;
+};
+
 /**
  * @brief This is the main class used to Run a model.
  * Sample simple usage:
@@ -329,6 +382,35 @@ class InferenceSession {
    */
   [[nodiscard]] common::Status Initialize();
 
+  /**
+   * Create a replica of an initialized session that shares its immutable state: the session state with the kernels,
+   * initializers, pre-packed weights and execution plan, the execution providers and the thread pools. The clone
+   * has its own run counters, logger, profiler, IO bindings, dynamic batcher and prefix key/value cache, so a
+   * replica per thread or per tenant can be created without loading and initializing the model again.
+   * The session must outlive its clones, and can't be cloned if its execution providers don't support
+   * concurrent runs or capture graphs.
+   * This API is thread-safe.
+   * @param clone Set to the new session, initialized and ready to run.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status Clone(std::unique_ptr<InferenceSession>& clone) const;
+
+  /**
+   * Replace the values of initializers of the main graph of an initialized session, e.g. to roll out new weights
+   * without creating another session. The values must have the element type and shape of the initializers they
+   * replace, and are copied. Only the kernels using a replaced initializer pre-pack it again.
+   * The runs in progress complete with the previous values, and the runs starting during the update wait for it and
+   * use the new values. This also applies to the clones of the session, which share its initializers.
+   * Kernels that compute state from a constant initializer when they are created, other than by pre-packing it,
+   * keep using that state.
+   * This API is thread-safe.
+   * @param names Names of the initializers.
+   * @param values New values of the initializers.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status UpdateInitializers(gsl::span<const std::string> names,
+                                                  gsl::span<const OrtValue> values);
+
   [[nodiscard]] common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
                                    gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches,
@@ -370,6 +452,18 @@ class InferenceSession {
                                    gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches);
 
+  /**
+   * Runs a batch of independent requests concurrently on the intra op thread pool, the calling thread taking part.
+   * Without an intra op thread pool the requests run one after the other on the calling thread.
+   * @param feeds named inputs of each request.
+   * @param output_names output names, the same for all the requests.
+   * @param p_fetches receives the output values of each request, in the order specified by output_names.
+   * @return OK if all the requests succeeded, else the status of the first request that failed.
+   */
+  [[nodiscard]] common::Status RunBatch(const RunOptions& run_options, gsl::span<const NameMLValMap> feeds,
+                                        gsl::span<const std::string> output_names,
+                                        std::vector<std::vector<OrtValue>>* p_fetches);
+
   /**
    * Creates a new binding object for binding inputs and outputs.
    * @param provider_type specifies the location where the inputs need to be potentially copied.
@@ -380,6 +474,30 @@ class InferenceSession {
   [[nodiscard]] virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   [[nodiscard]] common::Status Run(IOBinding& io_binding);
 
+  /**
+   * Prepares runs with the given inputs and outputs, which must be tensors. The session must be initialized.
+   * @param feed_names names of the inputs of the runs, in the order of their feeds.
+   * @param output_names names of the outputs of the runs, in the order of their fetches.
+   * @param prepared_run the prepared run to pass to Run().
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status PrepareRun(gsl::span<const std::string> feed_names,
+                                          gsl::span<const std::string> output_names,
+                                          std::unique_ptr<PreparedRun>& prepared_run) const;
+
+  /**
+   * Runs with the inputs and outputs of a prepared run. See PreparedRun.
+   * @param feeds the inputs in the order of the feed names of prepared_run.
+   * @param fetches the outputs in the order of the output names of prepared_run. May be empty, or contain
+   *        pre-allocated tensors.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                   gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches);
+
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                   gsl::span<const OrtValue* const> feeds, gsl::span<OrtValue*> fetches);
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -459,6 +577,11 @@ class InferenceSession {
    */
   const ProviderOptionsMap& GetAllProviderOptions() const;
 
+  /*
+   * Get the prefix key/value cache of this session, or nullptr if it is not enabled in the session options.
+   */
+  PrefixKVCache* GetPrefixKVCache() const { return prefix_kv_cache_.get(); }
+
   /**
    * Start profiling on this inference session. This simply turns on profiling events to be
    * recorded. A corresponding EndProfiling has to follow to write profiling data to a file.
@@ -486,6 +609,40 @@ class InferenceSession {
     */
   const profiling::Profiler& GetProfiling() const;
 
+  /**
+   * Return the counters of the intra op thread pool the session runs with, the session or the environment one.
+   * All counters are zero when the session has no intra op worker threads.
+   */
+  concurrency::ThreadPoolStats GetIntraOpThreadPoolStats() const;
+
+  /**
+   * Get a latency percentile of the kernel of a node of the main graph, from the latency histograms
+   * enabled with the session.enable_latency_histograms config entry.
+   * @param node_name is the name of the node. Nodes without a name are named <op type>_<node index>, as in profiles.
+   * @param percentile is between 0 and 100.
+   * @param latency_ns receives the latency in nanoseconds, or 0 if the node has not run yet.
+   */
+  common::Status GetNodeLatencyPercentile(const std::string& node_name, double percentile, int64_t& latency_ns) const;
+
+  /**
+   * Get a latency percentile of the kernels of all the nodes of the main graph with the given operator type.
+   * See GetNodeLatencyPercentile.
+   */
+  common::Status GetOpTypeLatencyPercentile(const std::string& op_type, double percentile, int64_t& latency_ns) const;
+
+  /**
+   * Write the per-node and per-operator type latency histograms in the Prometheus text exposition format.
+   */
+  common::Status GetLatencyHistogramsPrometheus(std::string& text) const;
+
+  /**
+   * Get the activation statistics collected when the "session.collect_activation_statistics" session config entry
+   * is "1": the min, max and histogram of every float CPU tensor produced by a node of the main graph so far.
+   * @param statistics receives the statistics by tensor name. Tensors which were not produced yet are omitted.
+   */
+  common::Status GetActivationStatistics(
+      std::unordered_map<std::string, ActivationStatistics::Snapshot>& statistics) const;
+
 #if !defined(ORT_MINIMAL_BUILD)
   /**
    * Get the TuningResults of TunableOp for every execution providers.
@@ -592,6 +749,10 @@ class InferenceSession {
   /// convenience pointer to logger. should always be the same as session_state_.Logger();
   const logging::Logger* session_logger_;
 
+  // The model shared through the model cache of the environment, see kOrtSessionOptionsConfigUseEnvModelCache.
+  // The initializers of model_ and of the session state reference its weights, so it is released after them.
+  std::shared_ptr<const CachedModel> cached_model_;
+
   // The model served by this inference session instance.
   // Currently this has to be a shared ptr because the Model::Load method
   // returns a shared_ptr only. Ideally factory functions should always return
@@ -612,8 +773,40 @@ class InferenceSession {
   void ConstructorCommon(const SessionOptions& session_options,
                          const Environment& session_env);
 
+  // Combines the concurrent Run() calls into batched runs.
+  void CreateDynamicBatcher(std::chrono::microseconds window, int64_t max_batch_size);
+
   [[nodiscard]] common::Status SaveModelMetadata(const onnxruntime::Model& model);
 
+  // Implements Run(). prepared_run is the prepared run of feed_names and output_names, or nullptr.
+  [[nodiscard]] common::Status RunImpl(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                       gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                       std::vector<OrtValue>* p_fetches,
+                                       const std::vector<OrtDevice>* p_fetches_device_info,
+                                       PreparedRun* prepared_run);
+
+  // Validates the feeds and pre-allocated fetches of a run with prepared_run.
+  [[nodiscard]] common::Status ValidatePreparedRun(const PreparedRun& prepared_run, gsl::span<const OrtValue> feeds,
+                                                   const std::vector<OrtValue>& fetches) const;
+
+  // Runs with the recorded execution if kOrtSessionOptionsConfigRecordExecution is enabled, recording it first if
+  // there is no recording for these inputs and outputs. `ran` is false if the run has to go through the executor.
+  [[nodiscard]] common::Status RunRecordedExecution(const RunOptions& run_options,
+                                                    gsl::span<const std::string> feed_names,
+                                                    gsl::span<const OrtValue> feeds,
+                                                    gsl::span<const std::string> output_names,
+                                                    std::vector<OrtValue>& fetches, bool& ran);
+
+  // Rejects the graph annotation ids of the run options reserved for the input shapes, if
+  // kOrtSessionOptionsConfigGraphCapturePerInputShapes is enabled.
+  [[nodiscard]] common::Status ValidateGraphAnnotationId(const RunOptions& run_options) const;
+
+  // Gets the graph annotation id for the names and shapes of the feeds if kOrtSessionOptionsConfigGraphCapturePerInputShapes
+  // is enabled, assigning a new one (and releasing the graph of the least recently run shapes) for new shapes.
+  [[nodiscard]] common::Status GetGraphAnnotationIdForInputShapes(gsl::span<const std::string> feed_names,
+                                                                  gsl::span<const OrtValue> feeds,
+                                                                  int& graph_annotation_id);
+
 #if !defined(ORT_MINIMAL_BUILD)
 
   [[nodiscard]] common::Status LoadOnnxModel(const PathString& model_uri);
@@ -623,6 +816,20 @@ class InferenceSession {
   }
 
   common::Status SaveToOrtFormat(const std::filesystem::path& filepath) const;
+
+  // Hashes the model for the optimized model cache if kOrtSessionOptionsConfigOptimizedModelCacheDir is set.
+  void HashModelForOptimizedModelCache(const std::function<Status(std::string&)>& hash_model);
+
+  // Replaces the loaded ONNX model with the optimized model from the cache if it is there, otherwise returns the
+  // path to save the optimized model to in cache_path. cache_path is empty if the model is not to be cached.
+  [[nodiscard]] common::Status LoadFromOptimizedModelCache(PathString& cache_path);
+
+  // Saves the optimized model to the cache. Failures are only logged as the session can use the model regardless.
+  void SaveToOptimizedModelCache(const PathString& cache_path) const;
+
+  // Saves the tuning results to the tuning results file of the session options, if any, when tuning is enabled.
+  // Failures are only logged as the session is being destroyed.
+  void SaveTuningResultsFile() const;
 #endif
 
   /**
@@ -687,8 +894,18 @@ class InferenceSession {
   /*
    * Performs the shrinkage of arenas requested to be shrunk by the user
    * The `arenas_to_shrink` parameter is got from ValidateAndParseShrinkArenaString()
+   * If `to_working_set` is true only the memory above the working set of each arena is released.
+   */
+  void ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink, bool to_working_set);
+
+  /*
+   * Gets the stats of the arena based allocators of the session, to check with CheckNoArenaAllocation() after a run
+   * that the run did not allocate memory from the system through them.
    */
-  void ShrinkMemoryArenas(gsl::span<const AllocatorPtr> arenas_to_shrink);
+  void GetArenaStats(/*out*/ InlinedVector<std::pair<AllocatorPtr, AllocatorStats>>& arena_stats) const;
+
+  [[nodiscard]] common::Status CheckNoArenaAllocation(
+      gsl::span<const std::pair<AllocatorPtr, AllocatorStats>> arena_stats) const;
 
 #ifdef _WIN32
   void LogAllSessions();
@@ -731,9 +948,9 @@ class InferenceSession {
   MemoryProfiler memory_profiler_;
 #endif
 
-  // Immutable state for each op in the model. Shared by all executors.
+  // Immutable state for each op in the model. Shared by all executors, and by the clones of the session.
   // It has a dependency on execution_providers_.
-  std::unique_ptr<SessionState> session_state_;
+  std::shared_ptr<SessionState> session_state_;
 
   // Threadpools per session. These are initialized and used for the entire duration of the session
   // when use_per_session_threads is true.
@@ -754,6 +971,16 @@ class InferenceSession {
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
   onnxruntime::concurrency::ThreadPool* inter_op_thread_pool_from_env_{};
 
+  // Combines concurrent Run() calls into batched runs, if enabled in the session options.
+  std::unique_ptr<DynamicBatcher> dynamic_batcher_;
+
+  // Key/value tensors of token prefixes shared by Run() calls, if enabled in the session options.
+  std::unique_ptr<PrefixKVCache> prefix_kv_cache_;
+
+  // Shares the threads of the global intra op threadpool with other sessions, if the session
+  // options ask for a weighted share of them.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> shared_intra_op_thread_pool_;
+
   // External threadpools.
   onnxruntime::concurrency::ThreadPool* external_intra_op_thread_pool_{};
   onnxruntime::concurrency::ThreadPool* external_inter_op_thread_pool_{};
@@ -848,8 +1075,18 @@ class InferenceSession {
   // "session.use_ort_model_bytes_directly" to "1", this will be empty
   std::vector<uint8_t> ort_format_model_bytes_data_holder_;
 
+  // The memory mapped model file if the session config option "session.map_ort_model_file" is "1".
+  // ort_format_model_bytes_ refers to it then.
+  Env::MappedMemoryPtr ort_format_model_mapped_bytes_;
+
   bool using_ort_model_bytes_for_initializers_{false};
 
+#if !defined(ORT_MINIMAL_BUILD)
+  // Hash of the loaded ONNX model bytes, used to look up the optimized model in the optimized model cache.
+  // Empty if the cache is not enabled, or the model was not loaded from a file or bytes.
+  std::string optimized_model_cache_model_hash_;
+#endif
+
   // Container to store pre-packed weights to share between sessions.
   // The life-cycle of the cache itself is maintained by the user and the user will ensure
   // the cache is valid until any session reliant on it is still in scope.
@@ -887,6 +1124,13 @@ class InferenceSession {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cached EP instance for graph replay is not set yet before calling ReplayGraph()");
     }
 
+    Status ReleaseGraph(int graph_annotation_id) {
+      if (cached_execution_provider_for_graph_replay_) {
+        return cached_execution_provider_for_graph_replay_->ReleaseGraph(graph_annotation_id);
+      }
+      return Status::OK();
+    }
+
     const std::string& Type() const {
       return cached_execution_provider_for_graph_replay_->Type();
     }
@@ -897,6 +1141,32 @@ class InferenceSession {
   };
 
   CachedExecutionProviderForGraphReplay cached_execution_provider_for_graph_replay_;
+
+  // Graph annotation ids assigned to the input shapes of runs if kOrtSessionOptionsConfigGraphCapturePerInputShapes
+  // is enabled. The list is ordered from the most to the least recently run shapes.
+  bool graph_capture_per_input_shapes_ = false;
+  size_t graph_capture_max_graphs_ = 0;
+  OrtMutex graph_annotation_ids_mutex_;
+  std::list<std::pair<std::string, int>> graph_annotation_ids_lru_;
+  InlinedHashMap<std::string, std::list<std::pair<std::string, int>>::iterator> graph_annotation_ids_;
+  // the ids assigned to input shapes, above the ids the callers use, and never reused once their graph is released
+  static constexpr int kFirstInputShapesGraphAnnotationId = 1 << 30;
+  int next_graph_annotation_id_ = kFirstInputShapesGraphAnnotationId;
+
+  // The recorded run replayed by later runs if kOrtSessionOptionsConfigRecordExecution is enabled.
+  bool record_execution_ = false;
+  OrtMutex recorded_execution_mutex_;
+  std::unique_ptr<RecordedExecution> recorded_execution_;
+  size_t recorded_initializers_version_ = 0;
+
+  // Runs hold the shared lock of mutex while they run, and UpdateInitializers holds it exclusively. A run takes it
+  // through the gate, which UpdateInitializers holds while it waits so that a steady stream of runs can't starve it.
+  // Shared with the clones of the session.
+  struct InitializersLock {
+    OrtMutex gate;
+    std::shared_mutex mutex;
+  };
+  std::shared_ptr<InitializersLock> initializers_lock_ = std::make_shared<InitializersLock>();
 };
 
 struct SessionIOBinding {
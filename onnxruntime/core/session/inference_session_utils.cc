@@ -5,6 +5,15 @@
 
 #include "core/session/inference_session_utils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include "core/common/path_string.h"
+#include "core/platform/env.h"
+#include "core/platform/ort_mutex.h"
+
 namespace onnxruntime {
 
 //---------------------
@@ -110,6 +119,10 @@ void from_json(const json& j, TuningResults& trs) {
   j.at("validators").get_to(trs.validators);
 }
 
+void to_json(json& j, const TuningResults& trs) {
+  j = json{{"ep", trs.ep}, {"results", trs.results}, {"validators", trs.validators}};
+}
+
 //---------------------------------------------------
 //--- end of session options related helpers ---
 //---------------------------------------------------
@@ -264,6 +277,96 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
   return Status::OK();
 }
 
+Status LoadTuningResultsFromFile(const std::string& file_path,
+                                 std::vector<TuningResults>& results,
+                                 bool& file_found) {
+  results.clear();
+  file_found = false;
+  std::ifstream file(file_path);
+  if (!file.good()) {
+    return Status::OK();
+  }
+
+  file_found = true;
+  LOGS_DEFAULT(INFO) << "Found tuning results file " << file_path;
+
+  Status status;
+  ORT_TRY {
+    results = json::parse(file).get<std::vector<TuningResults>>();
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      results.clear();
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Tuning results file ", file_path,
+                               " cannot be parsed. Error message: ", e.what());
+    });
+  }
+
+  return status;
+}
+
+Status SaveTuningResultsToFile(const std::string& file_path, const std::vector<TuningResults>& results) {
+  // The sessions of the process merge their results one at a time, so none of them is lost. The ones of other
+  // processes may be, the last rename of the file winning.
+  static OrtMutex save_mutex;
+  std::lock_guard<OrtMutex> lock(save_mutex);
+
+  std::vector<TuningResults> file_results;
+  bool file_found = false;
+  auto status = LoadTuningResultsFromFile(file_path, file_results, file_found);
+  if (!status.IsOK()) {
+    LOGS_DEFAULT(WARNING) << status.ErrorMessage() << ". Overwriting it.";
+  }
+
+  for (const auto& tr : results) {
+    file_results.erase(std::remove_if(file_results.begin(), file_results.end(),
+                                      [&tr](const TuningResults& file_tr) {
+                                        return file_tr.ep == tr.ep && file_tr.validators == tr.validators;
+                                      }),
+                       file_results.end());
+    file_results.push_back(tr);
+  }
+
+  std::string serialized;
+  ORT_TRY {
+    serialized = json(file_results).dump();
+  }
+  ORT_CATCH(const std::exception& e) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Tuning results cannot be serialized. Error message: ", e.what());
+    });
+    ORT_RETURN_IF_ERROR(status);
+  }
+
+  // Write a temporary file next to the file and rename it over the file, so that a reader or a failed write never
+  // sees a truncated file.
+  static std::atomic<uint64_t> temp_file_count{0};
+  const std::filesystem::path path(ToPathString(file_path));
+  std::filesystem::path temp_path(path);
+  temp_path += ToPathString("." + std::to_string(Env::Default().GetSelfPid()) + "." +
+                            std::to_string(temp_file_count++) + ".tmp");
+  std::error_code error;
+  {
+    std::ofstream file(temp_path, std::ios::trunc);
+    file << serialized;
+    file.close();
+    if (!file.good()) {
+      std::filesystem::remove(temp_path, error);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write tuning results file ", file_path);
+    }
+  }
+
+  std::filesystem::rename(temp_path, path, error);
+  if (error) {
+    std::error_code remove_error;
+    std::filesystem::remove(temp_path, remove_error);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace tuning results file ", file_path, ": ",
+                           error.message());
+  }
+
+  return Status::OK();
+}
+
 }  // namespace inference_session_utils
 }  // namespace onnxruntime
 
@@ -62,6 +62,17 @@ Status ParseTuningResultsFromModelMetadata(const onnxruntime::ModelMetadata& met
                                            /*out*/ std::vector<TuningResults>& results,
                                            /*out*/ bool& key_found);
 
+// Loads the tuning results of a tuning results file. file_found is false if the file does not exist.
+Status LoadTuningResultsFromFile(const std::string& file_path,
+                                 /*out*/ std::vector<TuningResults>& results,
+                                 /*out*/ bool& file_found);
+
+// Saves the tuning results to a tuning results file. The results in the file with another EP or other validators
+// are kept, the ones with the same EP and validators are replaced. The file is replaced by renaming a complete
+// temporary file over it, and the saves of the process are serialized. Processes saving to the same file at the same
+// time are not: the last one to rename the file wins, and the results of the others may be lost.
+Status SaveTuningResultsToFile(const std::string& file_path, const std::vector<TuningResults>& results);
+
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 }  // namespace inference_session_utils
@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/model_cache.h"
+
+#include <filesystem>
+#include <mutex>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensor_external_data_info.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/model.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Smaller initializers, e.g. shapes, keep their data in the proto, as in utils::TensorToTensorProto.
+constexpr size_t kMinSharedInitializerSize = 128;
+
+void MoveInitializerDataToWeights(ONNX_NAMESPACE::GraphProto& graph_proto,
+                                  std::vector<std::unique_ptr<std::string>>& weights) {
+  for (auto& initializer : *graph_proto.mutable_initializer()) {
+    if (!initializer.has_raw_data() || initializer.raw_data().size() < kMinSharedInitializerSize) {
+      continue;
+    }
+
+    std::unique_ptr<std::string> data{initializer.release_raw_data()};
+    const auto offset = narrow<ExternalDataInfo::OFFSET_TYPE>(reinterpret_cast<intptr_t>(data->data()));
+    initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
+    auto* entry = initializer.mutable_external_data()->Add();
+    entry->set_key("location");
+    entry->set_value(ToUTF8String(utils::kTensorProtoMemoryAddressTag));
+    entry = initializer.mutable_external_data()->Add();
+    entry->set_key("offset");
+    entry->set_value(std::to_string(offset));
+    entry = initializer.mutable_external_data()->Add();
+    entry->set_key("length");
+    entry->set_value(std::to_string(data->size()));
+    weights.push_back(std::move(data));
+  }
+}
+
+Status GetModelKey(const PathString& model_path, PathString& key) {
+  std::error_code error_code;
+  const auto canonical_path = std::filesystem::canonical(model_path, error_code);
+  ORT_RETURN_IF(error_code, "Failed to resolve the path of ", ToUTF8String(model_path), ": ", error_code.message());
+  const auto size = std::filesystem::file_size(canonical_path, error_code);
+  ORT_RETURN_IF(error_code, "Failed to get the size of ", ToUTF8String(model_path), ": ", error_code.message());
+  const auto write_time = std::filesystem::last_write_time(canonical_path, error_code);
+  ORT_RETURN_IF(error_code, "Failed to get the modification time of ", ToUTF8String(model_path), ": ",
+                error_code.message());
+
+  key = canonical_path.native() +
+        ToPathString("|" + std::to_string(size) + "|" + std::to_string(write_time.time_since_epoch().count()));
+  return Status::OK();
+}
+
+}  // namespace
+
+Status ModelCache::GetOrLoad(const PathString& model_path, std::shared_ptr<const CachedModel>& model) {
+  PathString key;
+  ORT_RETURN_IF_ERROR(GetModelKey(model_path, key));
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    auto it = models_.find(key);
+    if (it != models_.end()) {
+      model = it->second.lock();
+      if (model) {
+        return Status::OK();
+      }
+    }
+  }
+
+  // Parse without holding the lock, sessions of other models need not wait for this one.
+  auto cached_model = std::make_shared<CachedModel>();
+  ORT_RETURN_IF_ERROR(Model::Load(model_path, cached_model->model_proto));
+  MoveInitializerDataToWeights(*cached_model->model_proto.mutable_graph(), cached_model->weights);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  // Drop the models no session holds anymore.
+  for (auto it = models_.begin(); it != models_.end();) {
+    it = it->second.expired() ? models_.erase(it) : std::next(it);
+  }
+
+  // Another session may have parsed the model meanwhile, use its copy so that the weights are in memory once.
+  auto& entry = models_[key];
+  model = entry.lock();
+  if (!model) {
+    model = cached_model;
+    entry = model;
+  }
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * An ONNX model parsed once for all the sessions of the process loading it.
+ * The raw data of the initializers of the main graph is moved out of model_proto into weights, and the initializers
+ * reference it by memory address (utils::kTensorProtoMemoryAddressTag). model_proto is therefore cheap to copy for each
+ * session, while the weights are in memory once, read-only, for as long as a session holds the model.
+ */
+struct CachedModel {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  std::vector<std::unique_ptr<std::string>> weights;
+};
+
+/**
+ * Process-wide cache of the ONNX models that sessions with kOrtSessionOptionsConfigUseEnvModelCache load from files,
+ * see Environment::GetModelCache. A model stays in the cache while a session holds it.
+ */
+class ModelCache {
+ public:
+  ModelCache() = default;
+
+  /**
+   * Gets the model of the file at model_path, parsing the file unless a session holds the model already.
+   * The file is identified by its canonical path, size and modification time, so a rewritten file is parsed again.
+   */
+  Status GetOrLoad(const PathString& model_path, std::shared_ptr<const CachedModel>& model);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ModelCache);
+
+  OrtMutex mutex_;
+  std::unordered_map<PathString, std::weak_ptr<const CachedModel>> models_;
+};
+
+}  // namespace onnxruntime
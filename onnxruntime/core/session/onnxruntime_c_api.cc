@@ -33,6 +33,10 @@
 #include "core/session/inference_session.h"
 #include "core/session/ort_apis.h"
 #include "core/session/ort_env.h"
+#include "core/session/overlapped_runner.h"
+#include "core/session/pipeline_runner.h"
+#include "core/session/prefix_kv_cache.h"
+#include "core/session/run_completion_queue.h"
 #include "core/framework/data_types.h"
 #include "abi_session_options_impl.h"
 #include "core/framework/TensorSeq.h"
@@ -869,6 +873,250 @@ ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _In_ const OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<std::string> input_name_vec;
+  input_name_vec.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    input_name_vec.emplace_back(input_names[i]);
+  }
+
+  InlinedVector<std::string> output_name_vec;
+  output_name_vec.reserve(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names[i] == nullptr || output_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_name_vec.emplace_back(output_names[i]);
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->PrepareRun(input_name_vec, output_name_vec, prepared_run));
+  *out = reinterpret_cast<OrtPreparedRun*>(prepared_run.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _Inout_updates_all_(outputs_len) OrtValue** outputs, size_t outputs_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& run = *reinterpret_cast<::onnxruntime::PreparedRun*>(prepared_run);
+
+  gsl::span<const OrtValue* const> input_span(inputs, input_len);
+  gsl::span<OrtValue*> output_span(outputs, outputs_len);
+
+  Status status;
+  if (run_options) {
+    status = session->Run(*run_options, run, input_span, output_span);
+  } else {
+    const RunOptions default_run_options;
+    status = session->Run(default_run_options, run, input_span, output_span);
+  }
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetIntraOpThreadPoolStats, _In_ const OrtSession* sess,
+                    _Out_ OrtThreadPoolStats* stats) {
+  API_IMPL_BEGIN
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  const auto pool_stats = session->GetIntraOpThreadPoolStats();
+  stats->num_threads = pool_stats.num_threads;
+  stats->queue_depth = pool_stats.queue_depth;
+  stats->num_tasks = pool_stats.num_tasks;
+  stats->num_steals = pool_stats.num_steals;
+  stats->spin_time_ns = pool_stats.spin_time_ns;
+  stats->idle_time_ns = pool_stats.blocked_time_ns;
+  stats->num_spin_wakeups = pool_stats.num_spin_wakeups;
+  stats->num_blocked_wakeups = pool_stats.num_blocked_wakeups;
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CloneSession, _In_ const OrtSession* sess, _Outptr_ OrtSession** out) {
+  API_IMPL_BEGIN
+  *out = nullptr;
+  const auto* session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::InferenceSession> clone;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->Clone(clone));
+  *out = reinterpret_cast<OrtSession*>(clone.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionUpdateInitializers, _Inout_ OrtSession* sess,
+                    _In_reads_(count) const char* const* names, _In_reads_(count) const OrtValue* const* values,
+                    size_t count) {
+  API_IMPL_BEGIN
+  auto* session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::vector<std::string> initializer_names;
+  std::vector<OrtValue> initializer_values;
+  initializer_names.reserve(count);
+  initializer_values.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    if (names[i] == nullptr || values[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "names and values must not contain null pointers");
+    }
+    initializer_names.emplace_back(names[i]);
+    initializer_values.push_back(*values[i]);
+  }
+
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->UpdateInitializers(initializer_names, initializer_values));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPipeline, _In_reads_(num_sessions) OrtSession* const* sessions, size_t num_sessions,
+                    int64_t num_micro_batches, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** outputs) {
+  API_IMPL_BEGIN
+  std::vector<::onnxruntime::PipelineRunner::Stage> stages(num_sessions);
+  for (size_t i = 0; i < num_sessions; ++i) {
+    if (sessions[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "sessions must not contain null pointers");
+    }
+    ORT_API_RETURN_IF_STATUS_NOT_OK(::onnxruntime::PipelineRunner::CreateStage(
+        *reinterpret_cast<::onnxruntime::InferenceSession*>(sessions[i]), stages[i]));
+  }
+  if (stages.empty()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "A pipeline requires at least one session");
+  }
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  feed_names.reserve(input_len);
+  feeds.reserve(input_len);
+  for (size_t i = 0; i < input_len; ++i) {
+    if (input_names[i] == nullptr || inputs[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input names and inputs must not contain null pointers");
+    }
+    feed_names.emplace_back(input_names[i]);
+    feeds.push_back(*inputs[i]);
+  }
+  std::vector<std::string> fetch_names;
+  fetch_names.reserve(output_names_len);
+  for (size_t i = 0; i < output_names_len; ++i) {
+    if (output_names[i] == nullptr || outputs[i] != nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                   "output names must not contain null pointers, and outputs must be null pointers");
+    }
+    fetch_names.emplace_back(output_names[i]);
+  }
+
+  const ::onnxruntime::PipelineRunner runner(std::move(stages), num_micro_batches);
+  const RunOptions default_run_options;
+  std::vector<OrtValue> fetches;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(runner.Run(run_options != nullptr ? *run_options : default_run_options, feed_names,
+                                             feeds, fetch_names, fetches));
+  for (size_t i = 0; i < output_names_len; ++i) {
+    outputs[i] = std::make_unique<OrtValue>(std::move(fetches[i])).release();
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateOverlappedRunner, _In_ OrtSession* sess,
+                    _In_ const OrtMemoryInfo* device_memory_info, size_t num_slots,
+                    _Outptr_ OrtOverlappedRunner** out) {
+  API_IMPL_BEGIN
+  *out = nullptr;
+  std::unique_ptr<::onnxruntime::OverlappedRunner> runner;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(::onnxruntime::OverlappedRunner::Create(
+      *reinterpret_cast<::onnxruntime::InferenceSession*>(sess), *device_memory_info, num_slots, runner));
+  *out = reinterpret_cast<OrtOverlappedRunner*>(runner.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::OverlappedRunnerRunAsync, _Inout_ OrtOverlappedRunner* ort_runner,
+                    _In_opt_ const OrtRunOptions* run_options, _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto* runner = reinterpret_cast<::onnxruntime::OverlappedRunner*>(ort_runner);
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "A callback is required");
+  }
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  feed_names.reserve(input_len);
+  feeds.reserve(input_len);
+  for (size_t i = 0; i < input_len; ++i) {
+    if (input_names[i] == nullptr || inputs[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input names and inputs must not contain null pointers");
+    }
+    feed_names.emplace_back(input_names[i]);
+    feeds.push_back(*inputs[i]);
+  }
+  std::vector<std::string> fetch_names;
+  fetch_names.reserve(output_names_len);
+  for (size_t i = 0; i < output_names_len; ++i) {
+    if (output_names[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output names must not contain null pointers");
+    }
+    fetch_names.emplace_back(output_names[i]);
+  }
+
+  auto on_completion = [callback, user_data](Status status, std::vector<OrtValue> fetches) {
+    std::vector<OrtValue*> outputs;
+    outputs.reserve(fetches.size());
+    for (auto& fetch : fetches) {
+      outputs.push_back(std::make_unique<OrtValue>(std::move(fetch)).release());
+    }
+    callback(user_data, outputs.data(), outputs.size(), ToOrtStatus(status));
+  };
+  ORT_API_RETURN_IF_STATUS_NOT_OK(runner->RunAsync(run_options != nullptr ? *run_options : RunOptions{},
+                                                   std::move(feed_names), std::move(feeds), std::move(fetch_names),
+                                                   std::move(on_completion)));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::OverlappedRunnerWait, _Inout_ OrtOverlappedRunner* runner) {
+  API_IMPL_BEGIN
+  reinterpret_cast<::onnxruntime::OverlappedRunner*>(runner)->Wait();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateRunCompletionQueue, _Outptr_ OrtRunCompletionQueue** out) {
+  API_IMPL_BEGIN
+  *out = reinterpret_cast<OrtRunCompletionQueue*>(new ::onnxruntime::RunCompletionQueue());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunCompletionQueueGetFd, _In_ const OrtRunCompletionQueue* queue, _Out_ int* fd) {
+  API_IMPL_BEGIN
+  *fd = reinterpret_cast<const ::onnxruntime::RunCompletionQueue*>(queue)->GetFd();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunCompletionQueueDispatch, _Inout_ OrtRunCompletionQueue* queue, int timeout_ms,
+                    _Out_ size_t* num_dispatched) {
+  API_IMPL_BEGIN
+  *num_dispatched = reinterpret_cast<::onnxruntime::RunCompletionQueue*>(queue)->Dispatch(timeout_ms);
+  return nullptr;
+  API_IMPL_END
+}
+
 struct OrtIoBinding {
   std::unique_ptr<::onnxruntime::IOBinding> binding_;
   explicit OrtIoBinding(std::unique_ptr<::onnxruntime::IOBinding>&& binding) : binding_(std::move(binding)) {}
@@ -911,6 +1159,47 @@ ORT_API(void, OrtApis::ReleaseIoBinding, _Frees_ptr_opt_ OrtIoBinding* binding_p
   delete binding_ptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionInsertCachedPrefix, _Inout_ OrtSession* sess,
+                    _In_reads_(num_tokens) const int64_t* tokens, size_t num_tokens,
+                    _In_reads_(num_values) const char* const* input_names,
+                    _In_reads_(num_values) const OrtValue* const* values, size_t num_values) {
+  API_IMPL_BEGIN
+  auto* prefix_kv_cache = reinterpret_cast<::onnxruntime::InferenceSession*>(sess)->GetPrefixKVCache();
+  if (prefix_kv_cache == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "The prefix key/value cache is not enabled, set session.prefix_kv_cache_max_bytes");
+  }
+  std::vector<std::string> names;
+  std::vector<OrtValue> cached_values;
+  names.reserve(num_values);
+  cached_values.reserve(num_values);
+  for (size_t i = 0; i < num_values; ++i) {
+    if (input_names[i] == nullptr || values[i] == nullptr) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input_names and values must not contain null pointers");
+    }
+    names.emplace_back(input_names[i]);
+    cached_values.push_back(*values[i]);
+  }
+  ORT_API_RETURN_IF_STATUS_NOT_OK(prefix_kv_cache->Insert(gsl::make_span(tokens, num_tokens), std::move(names),
+                                                          std::move(cached_values)));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionBindLongestCachedPrefix, _Inout_ OrtSession* sess, _Inout_ OrtIoBinding* binding,
+                    _In_reads_(num_tokens) const int64_t* tokens, size_t num_tokens, _Out_ size_t* prefix_length) {
+  API_IMPL_BEGIN
+  auto* prefix_kv_cache = reinterpret_cast<::onnxruntime::InferenceSession*>(sess)->GetPrefixKVCache();
+  if (prefix_kv_cache == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "The prefix key/value cache is not enabled, set session.prefix_kv_cache_max_bytes");
+  }
+  ORT_API_RETURN_IF_STATUS_NOT_OK(prefix_kv_cache->BindLongestPrefix(gsl::make_span(tokens, num_tokens),
+                                                                     *binding->binding_, *prefix_length));
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::BindInput, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* name, _In_ const OrtValue* val_ptr) {
   API_IMPL_BEGIN
   auto st = binding_ptr->binding_->BindInput(name, *val_ptr);
@@ -941,6 +1230,17 @@ ORT_API_STATUS_IMPL(OrtApis::BindOutputToDevice, _Inout_ OrtIoBinding* binding_p
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::BindState, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* input_name,
+                    _In_ const char* output_name, _In_ const OrtValue* initial_value) {
+  API_IMPL_BEGIN
+  auto st = binding_ptr->binding_->BindState(input_name, output_name, *initial_value);
+  if (!st.IsOK()) {
+    return ToOrtStatus(st);
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputNames, _In_ const OrtIoBinding* binding_ptr, _In_ OrtAllocator* allocator,
                     _Out_ char** buffer, _Outptr_result_maybenull_ size_t** lengths, _Out_ size_t* count) {
   API_IMPL_BEGIN
@@ -1363,6 +1663,35 @@ ORT_API_STATUS_IMPL(OrtApis::SessionEndProfiling, _In_ OrtSession* sess, _Inout_
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::SessionGetNodeLatencyPercentile, _In_ const OrtSession* sess,
+                    _In_ const char* node_name, _In_ double percentile, _Out_ int64_t* latency_ns) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetNodeLatencyPercentile(node_name, percentile, *latency_ns));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetOpTypeLatencyPercentile, _In_ const OrtSession* sess,
+                    _In_ const char* op_type, _In_ double percentile, _Out_ int64_t* latency_ns) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetOpTypeLatencyPercentile(op_type, percentile, *latency_ns));
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SessionGetLatencyHistogramsPrometheus, _In_ const OrtSession* sess,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<const ::onnxruntime::InferenceSession*>(sess);
+  std::string text;
+  ORT_API_RETURN_IF_STATUS_NOT_OK(session->GetLatencyHistogramsPrometheus(text));
+  *out = StrDup(text, allocator);
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API_STATUS_IMPL(OrtApis::SessionGetModelMetadata, _In_ const OrtSession* sess,
                     _Outptr_ OrtModelMetadata** out) {
   API_IMPL_BEGIN
@@ -1786,6 +2115,75 @@ ORT_API_STATUS_IMPL(OrtApis::GetValue, _In_ const OrtValue* value, int index, _I
   API_IMPL_END
 }
 
+#if !defined(DISABLE_ML_OPS)
+template <typename T>
+static ORT_STATUS_PTR OrtGetSequenceOfMapsAsColumnsImpl(_In_ const OrtValue* value, _Inout_ OrtAllocator* allocator,
+                                                        _Outptr_ OrtValue** keys, _Outptr_ OrtValue** values,
+                                                        _Outptr_ OrtValue** offsets) {
+  using TKey = typename T::value_type::key_type;
+  using TVal = typename T::value_type::mapped_type;
+  const auto& maps = value->Get<T>();
+
+  size_t num_kv_pairs = 0;
+  for (const auto& map : maps) {
+    num_kv_pairs += map.size();
+  }
+  const int64_t kv_pairs_dims[] = {narrow<int64_t>(num_kv_pairs)};
+  const int64_t offsets_dims[] = {narrow<int64_t>(maps.size() + 1)};
+
+  auto keys_value = std::make_unique<OrtValue>();
+  auto values_value = std::make_unique<OrtValue>();
+  auto offsets_value = std::make_unique<OrtValue>();
+  ORT_API_RETURN_IF_ERROR(CreateTensorImpl(DataTypeImpl::GetType<TKey>(), kv_pairs_dims, 1, allocator, *keys_value));
+  ORT_API_RETURN_IF_ERROR(CreateTensorImpl(DataTypeImpl::GetType<TVal>(), kv_pairs_dims, 1, allocator,
+                                           *values_value));
+  ORT_API_RETURN_IF_ERROR(CreateTensorImpl(DataTypeImpl::GetType<int64_t>(), offsets_dims, 1, allocator,
+                                           *offsets_value));
+
+  auto* keys_data = keys_value->GetMutable<Tensor>()->MutableData<TKey>();
+  auto* values_data = values_value->GetMutable<Tensor>()->MutableData<TVal>();
+  auto* offsets_data = offsets_value->GetMutable<Tensor>()->MutableData<int64_t>();
+  int64_t offset = 0;
+  for (const auto& map : maps) {
+    *offsets_data++ = offset;
+    for (const auto& kv : map) {
+      *keys_data++ = kv.first;
+      *values_data++ = kv.second;
+    }
+    offset += narrow<int64_t>(map.size());
+  }
+  *offsets_data = offset;
+
+  *keys = keys_value.release();
+  *values = values_value.release();
+  *offsets = offsets_value.release();
+  return nullptr;
+}
+#endif
+
+ORT_API_STATUS_IMPL(OrtApis::GetSequenceOfMapsAsColumns, _In_ const OrtValue* value, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ OrtValue** keys, _Outptr_ OrtValue** values, _Outptr_ OrtValue** offsets) {
+  API_IMPL_BEGIN
+#if !defined(DISABLE_ML_OPS)
+  // Note: keep these in sync with the registered types in data_types.h
+  utils::ContainerChecker c_checker(value->Type());
+  if (c_checker.IsSequenceOf<std::map<std::string, float>>()) {
+    return OrtGetSequenceOfMapsAsColumnsImpl<VectorMapStringToFloat>(value, allocator, keys, values, offsets);
+  } else if (c_checker.IsSequenceOf<std::map<int64_t, float>>()) {
+    return OrtGetSequenceOfMapsAsColumnsImpl<VectorMapInt64ToFloat>(value, allocator, keys, values, offsets);
+  }
+  return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Input is not a sequence of one of the supported map types.");
+#else
+  ORT_UNUSED_PARAMETER(value);
+  ORT_UNUSED_PARAMETER(allocator);
+  ORT_UNUSED_PARAMETER(keys);
+  ORT_UNUSED_PARAMETER(values);
+  ORT_UNUSED_PARAMETER(offsets);
+  return OrtApis::CreateStatus(ORT_FAIL, "Map type is not supported in this build.");
+#endif
+  API_IMPL_END
+}
+
 ///////////////////
 // OrtCreateValue
 
@@ -2229,6 +2627,12 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "max_power_of_two_extend_bytes") == 0) {
       cfg->max_power_of_two_extend_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_bytes") == 0) {
+      cfg->thread_cache_bytes = static_cast<int64_t>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_max_chunk_bytes") == 0) {
+      cfg->thread_cache_max_chunk_bytes = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "trim_window_ms") == 0) {
+      cfg->trim_window_ms = static_cast<int64_t>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2730,6 +3134,32 @@ static constexpr OrtApi ort_api_1_to_20 = {
     &OrtApis::KernelInfoGetAllocator,
     &OrtApis::AddExternalInitializersFromFilesInMemory,
     // End of Version 18 - DO NOT MODIFY ABOVE (see above text for more information)
+
+    &OrtApis::SessionGetNodeLatencyPercentile,
+    &OrtApis::SessionGetOpTypeLatencyPercentile,
+    &OrtApis::SessionGetLatencyHistogramsPrometheus,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::SessionGetIntraOpThreadPoolStats,
+    &OrtApis::CreateRunCompletionQueue,
+    &OrtApis::ReleaseRunCompletionQueue,
+    &OrtApis::RunCompletionQueueGetFd,
+    &OrtApis::RunCompletionQueueDispatch,
+    &OrtApis::RunOptionsSetCompletionQueue,
+    &OrtApis::CloneSession,
+    &OrtApis::SessionUpdateInitializers,
+    &OrtApis::KernelContext_ParallelForRange,
+    &OrtApis::KernelContext_GetDegreeOfParallelism,
+    &OrtApis::GetSequenceOfMapsAsColumns,
+    &OrtApis::RunPipeline,
+    &OrtApis::CreateOverlappedRunner,
+    &OrtApis::ReleaseOverlappedRunner,
+    &OrtApis::OverlappedRunnerRunAsync,
+    &OrtApis::OverlappedRunnerWait,
+    &OrtApis::SessionInsertCachedPrefix,
+    &OrtApis::SessionBindLongestCachedPrefix,
+    &OrtApis::BindState,
 };
 
 // OrtApiBase can never change as there is no way to know what version of OrtApiBase is returned by OrtGetApiBase.
@@ -2802,3 +3232,6 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(ModelMetadata, ::onnxruntime::ModelMetadata)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(PreparedRun, ::onnxruntime::PreparedRun)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunCompletionQueue, ::onnxruntime::RunCompletionQueue)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(OverlappedRunner, ::onnxruntime::OverlappedRunner)
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/optimized_model_cache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include "core/common/cpuid_info.h"
+#include "core/framework/murmurhash3.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+namespace {
+// MurmurHash3 takes the length as an int, so large inputs are hashed in chunks, each seeded with the hash so far.
+constexpr size_t kHashChunkSize = size_t{1} << 24;
+
+class Hasher {
+ public:
+  void Update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+      const size_t chunk_size = std::min(size, kHashChunkSize);
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk_size), hash_[0], &hash_);
+      bytes += chunk_size;
+      size -= chunk_size;
+    }
+  }
+
+  std::string HexDigest() const {
+    std::ostringstream ss;
+    for (auto word : hash_) {
+      ss << std::hex << std::setw(8) << std::setfill('0') << word;
+    }
+    return ss.str();
+  }
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+}  // namespace
+
+std::string HashModelBytes(gsl::span<const uint8_t> model_bytes) {
+  Hasher hasher;
+  hasher.Update(model_bytes.data(), model_bytes.size());
+  return hasher.HexDigest();
+}
+
+Status HashModelFile(const PathString& model_path, std::string& model_hash) {
+  std::ifstream model_stream(model_path, std::ifstream::in | std::ifstream::binary);
+  ORT_RETURN_IF_NOT(model_stream, "Failed to open model file ", ToUTF8String(model_path));
+
+  Hasher hasher;
+  std::vector<char> buffer(kHashChunkSize);
+  while (model_stream) {
+    model_stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    hasher.Update(buffer.data(), static_cast<size_t>(model_stream.gcount()));
+  }
+  ORT_RETURN_IF_NOT(model_stream.eof(), "Failed to read model file ", ToUTF8String(model_path));
+
+  model_hash = hasher.HexDigest();
+  return Status::OK();
+}
+
+PathString GetCachedModelPath(const PathString& cache_dir, const std::string& model_hash,
+                              const SessionOptions& session_options,
+                              const InlinedHashSet<std::string>& optimizers_to_disable,
+                              const ExecutionProviders& execution_providers) {
+  std::ostringstream key;
+  key << "ort_version:" << ORT_VERSION << '\n'
+      << "model:" << model_hash << '\n'
+      << "graph_optimization_level:" << static_cast<int>(session_options.graph_optimization_level) << '\n';
+
+  for (const auto& free_dimension_override : session_options.free_dimension_overrides) {
+    key << "free_dimension_override:" << static_cast<int>(free_dimension_override.dim_identifier_type) << ':'
+        << free_dimension_override.dim_identifier << '=' << free_dimension_override.dim_value << '\n';
+  }
+
+  // Hash containers are ordered for the key to be the same across processes.
+  const std::map<std::string, std::string> config_entries(session_options.config_options.configurations.begin(),
+                                                          session_options.config_options.configurations.end());
+  for (const auto& [config_key, config_value] : config_entries) {
+    if (config_key != kOrtSessionOptionsConfigOptimizedModelCacheDir) {
+      key << "config:" << config_key << '=' << config_value << '\n';
+    }
+  }
+
+  const std::set<std::string> disabled_optimizers(optimizers_to_disable.begin(), optimizers_to_disable.end());
+  for (const auto& optimizer : disabled_optimizers) {
+    key << "disabled_optimizer:" << optimizer << '\n';
+  }
+
+  for (const auto& execution_provider : execution_providers) {
+    key << "execution_provider:" << execution_provider->Type() << '\n';
+    const auto provider_options = execution_provider->GetProviderOptions();
+    const std::map<std::string, std::string> sorted_provider_options(provider_options.begin(), provider_options.end());
+    for (const auto& [option_key, option_value] : sorted_provider_options) {
+      key << "  " << option_key << '=' << option_value << '\n';
+    }
+  }
+
+  // Level 3 optimizers such as the NchwcTransformer and the prepacking of weights depend on the instruction sets.
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  key << "cpu:" << cpuid_info.HasSSE3() << cpuid_info.HasSSE4_1() << cpuid_info.HasAVX() << cpuid_info.HasAVX2()
+      << cpuid_info.HasAVX512f() << cpuid_info.HasAVX512Skylake() << cpuid_info.HasAVX512_BF16()
+      << cpuid_info.HasAMX_BF16() << cpuid_info.HasF16C() << cpuid_info.HasArmNeonDot()
+      << cpuid_info.HasArmNeon_I8MM() << cpuid_info.HasArmSVE_I8MM() << cpuid_info.HasArmNeon_BF16() << '\n';
+
+  const std::string key_str = key.str();
+  Hasher hasher;
+  hasher.Update(key_str.data(), key_str.size());
+  return (std::filesystem::path(cache_dir) / ToPathString(hasher.HexDigest() + ".ort")).native();
+}
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+
+#include <gsl/gsl>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/path_string.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/session_options.h"
+
+namespace onnxruntime {
+namespace optimized_model_cache {
+
+/**
+ * Hashes the bytes of a model.
+ * @return The hash as a string of hex digits.
+ */
+std::string HashModelBytes(gsl::span<const uint8_t> model_bytes);
+
+/**
+ * Hashes the bytes of the model file at model_path.
+ * Gives the same hash as HashModelBytes for the bytes of the file.
+ */
+Status HashModelFile(const PathString& model_path, std::string& model_hash);
+
+/**
+ * Gets the path in cache_dir of the ORT format model that a model with the given hash is optimized to.
+ * The path depends on everything that may change the optimized model: the ORT version, the session options,
+ * the execution providers and their options, and the instruction sets of the CPU.
+ */
+PathString GetCachedModelPath(const PathString& cache_dir, const std::string& model_hash,
+                              const SessionOptions& session_options,
+                              const InlinedHashSet<std::string>& optimizers_to_disable,
+                              const ExecutionProviders& execution_providers);
+
+}  // namespace optimized_model_cache
+}  // namespace onnxruntime
@@ -523,4 +523,64 @@ ORT_API_STATUS_IMPL(SessionOptionsAppendExecutionProvider_VitisAI, _In_ OrtSessi
 ORT_API_STATUS_IMPL(KernelContext_GetScratchBuffer, _In_ const OrtKernelContext* context, _In_ const OrtMemoryInfo* mem_info, _In_ size_t count_or_bytes, _Outptr_ void** out);
 
 ORT_API_STATUS_IMPL(KernelInfoGetAllocator, _In_ const OrtKernelInfo* info, _In_ OrtMemType mem_type, _Outptr_ OrtAllocator** out);
+
+ORT_API_STATUS_IMPL(SessionGetNodeLatencyPercentile, _In_ const OrtSession* session, _In_ const char* node_name,
+                    _In_ double percentile, _Out_ int64_t* latency_ns);
+ORT_API_STATUS_IMPL(SessionGetOpTypeLatencyPercentile, _In_ const OrtSession* session, _In_ const char* op_type,
+                    _In_ double percentile, _Out_ int64_t* latency_ns);
+ORT_API_STATUS_IMPL(SessionGetLatencyHistogramsPrometheus, _In_ const OrtSession* session,
+                    _Inout_ OrtAllocator* allocator, _Outptr_ char** out);
+
+ORT_API_STATUS_IMPL(CreatePreparedRun, _In_ const OrtSession* session,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out);
+ORT_API_STATUS_IMPL(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _Inout_updates_all_(outputs_len) OrtValue** outputs, size_t outputs_len);
+ORT_API(void, ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun*);
+ORT_API_STATUS_IMPL(SessionGetIntraOpThreadPoolStats, _In_ const OrtSession* session,
+                    _Out_ OrtThreadPoolStats* stats);
+ORT_API_STATUS_IMPL(CreateRunCompletionQueue, _Outptr_ OrtRunCompletionQueue** out);
+ORT_API(void, ReleaseRunCompletionQueue, _Frees_ptr_opt_ OrtRunCompletionQueue*);
+ORT_API_STATUS_IMPL(RunCompletionQueueGetFd, _In_ const OrtRunCompletionQueue* queue, _Out_ int* fd);
+ORT_API_STATUS_IMPL(RunCompletionQueueDispatch, _Inout_ OrtRunCompletionQueue* queue, int timeout_ms,
+                    _Out_ size_t* num_dispatched);
+ORT_API_STATUS_IMPL(RunOptionsSetCompletionQueue, _Inout_ OrtRunOptions* options,
+                    _In_opt_ OrtRunCompletionQueue* queue);
+ORT_API_STATUS_IMPL(CloneSession, _In_ const OrtSession* session, _Outptr_ OrtSession** out);
+ORT_API_STATUS_IMPL(SessionUpdateInitializers, _Inout_ OrtSession* session,
+                    _In_reads_(count) const char* const* names, _In_reads_(count) const OrtValue* const* values,
+                    size_t count);
+ORT_API_STATUS_IMPL(KernelContext_ParallelForRange, _In_ const OrtKernelContext* context,
+                    _In_ void (*fn)(void*, size_t, size_t), _In_ size_t total, _In_ double cost_per_unit,
+                    _In_ void* usr_data);
+ORT_API_STATUS_IMPL(KernelContext_GetDegreeOfParallelism, _In_ const OrtKernelContext* context, _Out_ int* out);
+ORT_API_STATUS_IMPL(GetSequenceOfMapsAsColumns, _In_ const OrtValue* value, _Inout_ OrtAllocator* allocator,
+                    _Outptr_ OrtValue** keys, _Outptr_ OrtValue** values, _Outptr_ OrtValue** offsets);
+ORT_API_STATUS_IMPL(RunPipeline, _In_reads_(num_sessions) OrtSession* const* sessions, size_t num_sessions,
+                    int64_t num_micro_batches, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** outputs);
+ORT_API_STATUS_IMPL(CreateOverlappedRunner, _In_ OrtSession* session, _In_ const OrtMemoryInfo* device_memory_info,
+                    size_t num_slots, _Outptr_ OrtOverlappedRunner** out);
+ORT_API(void, ReleaseOverlappedRunner, _Frees_ptr_opt_ OrtOverlappedRunner*);
+ORT_API_STATUS_IMPL(OverlappedRunnerRunAsync, _Inout_ OrtOverlappedRunner* runner,
+                    _In_opt_ const OrtRunOptions* run_options, _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+ORT_API_STATUS_IMPL(OverlappedRunnerWait, _Inout_ OrtOverlappedRunner* runner);
+ORT_API_STATUS_IMPL(SessionInsertCachedPrefix, _Inout_ OrtSession* session,
+                    _In_reads_(num_tokens) const int64_t* tokens, size_t num_tokens,
+                    _In_reads_(num_values) const char* const* input_names,
+                    _In_reads_(num_values) const OrtValue* const* values, size_t num_values);
+ORT_API_STATUS_IMPL(SessionBindLongestCachedPrefix, _Inout_ OrtSession* session, _Inout_ OrtIoBinding* binding,
+                    _In_reads_(num_tokens) const int64_t* tokens, size_t num_tokens, _Out_ size_t* prefix_length);
+
+ORT_API_STATUS_IMPL(BindState, _Inout_ OrtIoBinding* binding_ptr, _In_ const char* input_name,
+                    _In_ const char* output_name, _In_ const OrtValue* initial_value);
 }  // namespace OrtApis
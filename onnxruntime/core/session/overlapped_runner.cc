@@ -0,0 +1,179 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/overlapped_runner.h"
+
+#include <algorithm>
+
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+OverlappedRunner::OverlappedRunner(RunFn run_fn, CopyFn copy_inputs, CopyFn copy_outputs, size_t num_slots)
+    : run_fn_(std::move(run_fn)),
+      copy_inputs_(std::move(copy_inputs)),
+      copy_outputs_(std::move(copy_outputs)),
+      slot_feeds_(std::max<size_t>(num_slots, 1)) {
+  // the slots are taken from the back
+  for (size_t i = slot_feeds_.size(); i > 0; --i) {
+    free_slots_.push_back(i - 1);
+  }
+
+  threads_.emplace_back([this]() {
+    RunStage(upload_queue_, &compute_queue_, [this](Request& request) { Upload(request); });
+  });
+  threads_.emplace_back([this]() {
+    RunStage(compute_queue_, &download_queue_, [this](Request& request) { Compute(request); });
+  });
+  threads_.emplace_back([this]() {
+    RunStage(download_queue_, nullptr, [this](Request& request) { Download(request); });
+  });
+}
+
+OverlappedRunner::~OverlappedRunner() {
+  Wait();
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+OverlappedRunner::CopyFn OverlappedRunner::CreateCopyFn(const DataTransferManager& data_transfer_manager,
+                                                        AllocatorPtr allocator) {
+  return [&data_transfer_manager, allocator](gsl::span<const OrtValue> src, std::vector<OrtValue>& dst) {
+    dst.resize(src.size());
+    for (size_t i = 0; i < src.size(); ++i) {
+      ORT_RETURN_IF_NOT(src[i].IsTensor(), "Only tensors can be copied, value ", i, " is not a tensor");
+      const auto& src_tensor = src[i].Get<Tensor>();
+      const bool reuse = dst[i].IsTensor() &&
+                         dst[i].Get<Tensor>().DataType() == src_tensor.DataType() &&
+                         dst[i].Get<Tensor>().Shape() == src_tensor.Shape() &&
+                         dst[i].Get<Tensor>().Location() == allocator->Info();
+      if (!reuse) {
+        // release the previous buffer before allocating the new one
+        dst[i] = OrtValue();
+        Tensor::InitOrtValue(src_tensor.DataType(), src_tensor.Shape(), allocator, dst[i]);
+      }
+      ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(src_tensor, *dst[i].GetMutable<Tensor>()));
+    }
+
+    return Status::OK();
+  };
+}
+
+Status OverlappedRunner::Create(InferenceSession& session, const OrtMemoryInfo& device_memory_info, size_t num_slots,
+                                std::unique_ptr<OverlappedRunner>& runner) {
+  AllocatorPtr device_allocator = session.GetAllocator(device_memory_info);
+  ORT_RETURN_IF(device_allocator == nullptr, "The session has no allocator for ", device_memory_info.ToString());
+
+  const DataTransferManager& data_transfer_manager = session.GetDataTransferManager();
+  auto run_fn = [&session](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                           gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                           std::vector<OrtValue>& fetches) {
+    return session.Run(run_options, feed_names, feeds, output_names, &fetches);
+  };
+  runner = std::make_unique<OverlappedRunner>(std::move(run_fn),
+                                              CreateCopyFn(data_transfer_manager, std::move(device_allocator)),
+                                              CreateCopyFn(data_transfer_manager, std::make_shared<CPUAllocator>()),
+                                              num_slots);
+  return Status::OK();
+}
+
+Status OverlappedRunner::RunAsync(const RunOptions& run_options,
+                                  std::vector<std::string> feed_names, std::vector<OrtValue> feeds,
+                                  std::vector<std::string> output_names, CallbackFn callback) {
+  ORT_RETURN_IF_NOT(feed_names.size() == feeds.size(), "The number of feed names and feeds differ");
+  ORT_RETURN_IF_NOT(callback, "A callback is required");
+
+  auto request = std::make_unique<Request>();
+  request->run_options = run_options;
+  request->feed_names = std::move(feed_names);
+  request->feeds = std::move(feeds);
+  request->output_names = std::move(output_names);
+  request->callback = std::move(callback);
+
+  {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return !free_slots_.empty(); });
+    request->slot = free_slots_.back();
+    free_slots_.pop_back();
+    upload_queue_.push_back(std::move(request));
+  }
+  cv_.notify_all();
+
+  return Status::OK();
+}
+
+void OverlappedRunner::Wait() {
+  std::unique_lock<OrtMutex> lock(mutex_);
+  cv_.wait(lock, [this]() { return free_slots_.size() == slot_feeds_.size(); });
+}
+
+void OverlappedRunner::RunStage(RequestQueue& queue, RequestQueue* next_queue,
+                                const std::function<void(Request&)>& process) {
+  while (true) {
+    std::unique_ptr<Request> request;
+    {
+      std::unique_lock<OrtMutex> lock(mutex_);
+      cv_.wait(lock, [this, &queue]() { return shutdown_ || !queue.empty(); });
+      if (queue.empty()) {
+        return;
+      }
+      request = std::move(queue.front());
+      queue.pop_front();
+    }
+
+    process(*request);
+
+    if (next_queue != nullptr) {
+      {
+        std::lock_guard<OrtMutex> lock(mutex_);
+        next_queue->push_back(std::move(request));
+      }
+      cv_.notify_all();
+    }
+  }
+}
+
+void OverlappedRunner::Upload(Request& request) {
+  request.status = copy_inputs_(request.feeds, slot_feeds_[request.slot]);
+  if (request.status.IsOK() && slot_feeds_[request.slot].size() != request.feeds.size()) {
+    request.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Copying ", request.feeds.size(), " feeds returned ",
+                                     slot_feeds_[request.slot].size(), " values");
+  }
+  // the host feeds are not needed anymore
+  request.feeds.clear();
+}
+
+void OverlappedRunner::Compute(Request& request) {
+  if (request.status.IsOK()) {
+    request.status = run_fn_(request.run_options, request.feed_names, slot_feeds_[request.slot],
+                             request.output_names, request.device_fetches);
+  }
+}
+
+void OverlappedRunner::Download(Request& request) {
+  std::vector<OrtValue> fetches;
+  if (request.status.IsOK()) {
+    request.status = copy_outputs_(request.device_fetches, fetches);
+  }
+  request.device_fetches.clear();
+  if (!request.status.IsOK()) {
+    fetches.clear();
+  }
+
+  request.callback(request.status, std::move(fetches));
+
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    free_slots_.push_back(request.slot);
+  }
+  cv_.notify_all();
+}
+
+}  // namespace onnxruntime
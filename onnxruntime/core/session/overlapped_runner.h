@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/data_transfer_manager.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/dynamic_batcher.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+
+/**
+ * Runs a stream of requests with host-resident feeds and fetches, overlapping the host to device copies of the
+ * feeds, the model run and the device to host copies of the fetches of consecutive requests. The upload of
+ * request N + 1 and the download of request N - 1 are then hidden behind the compute of request N.
+ *
+ * Each of the three stages runs on its own thread. At most num_slots requests are in flight, RunAsync blocks while
+ * all of them are. Every slot keeps the device feeds of its last request, so that copy_inputs can reuse their
+ * buffers when the next request using the slot has the same types and shapes.
+ */
+class OverlappedRunner {
+ public:
+  using RunFn = DynamicBatcher::RunFn;
+
+  // Copies the values of src into dst. dst holds the values the previous request of the same slot copied, if any.
+  using CopyFn = std::function<Status(gsl::span<const OrtValue> src, std::vector<OrtValue>& dst)>;
+
+  // Called on the download thread with the status and the host fetches of a request.
+  using CallbackFn = std::function<void(Status status, std::vector<OrtValue> fetches)>;
+
+  /**
+   * @param run_fn Runs a request with the device feeds, e.g. InferenceSession::Run.
+   * @param copy_inputs Copies the host feeds of a request to the device.
+   * @param copy_outputs Copies the fetches of a request to the host.
+   * @param num_slots The maximum number of requests in flight.
+   */
+  OverlappedRunner(RunFn run_fn, CopyFn copy_inputs, CopyFn copy_outputs, size_t num_slots);
+
+  // Completes the requests in flight.
+  ~OverlappedRunner();
+
+  /**
+   * Creates a CopyFn copying tensors to the memory of allocator with the given data transfers, e.g. those of
+   * a session. The destination tensors are reused when they have the type, shape and location of the source.
+   */
+  static CopyFn CreateCopyFn(const DataTransferManager& data_transfer_manager, AllocatorPtr allocator);
+
+  /**
+   * Creates a runner of the session, copying the feeds to the memory of the session's allocator for
+   * device_memory_info and the fetches to CPU memory with the data transfers of the session. The session must outlive
+   * the runner.
+   */
+  static Status Create(InferenceSession& session, const OrtMemoryInfo& device_memory_info, size_t num_slots,
+                       std::unique_ptr<OverlappedRunner>& runner);
+
+  // Queues a request, blocking while num_slots requests are in flight.
+  Status RunAsync(const RunOptions& run_options,
+                  std::vector<std::string> feed_names, std::vector<OrtValue> feeds,
+                  std::vector<std::string> output_names, CallbackFn callback);
+
+  // Waits until all the queued requests completed.
+  void Wait();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OverlappedRunner);
+
+  struct Request {
+    RunOptions run_options;
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> output_names;
+    CallbackFn callback;
+    size_t slot = 0;
+    std::vector<OrtValue> device_fetches;
+    Status status;
+  };
+
+  using RequestQueue = std::deque<std::unique_ptr<Request>>;
+
+  // Processes the requests of a stage in order until the runner shuts down, then passes them to the next stage.
+  void RunStage(RequestQueue& queue, RequestQueue* next_queue, const std::function<void(Request&)>& process);
+
+  void Upload(Request& request);
+  void Compute(Request& request);
+  void Download(Request& request);
+
+  const RunFn run_fn_;
+  const CopyFn copy_inputs_;
+  const CopyFn copy_outputs_;
+
+  // The device feeds of each slot.
+  std::vector<std::vector<OrtValue>> slot_feeds_;
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::vector<size_t> free_slots_;
+  RequestQueue upload_queue_;
+  RequestQueue compute_queue_;
+  RequestQueue download_queue_;
+  bool shutdown_ = false;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace onnxruntime
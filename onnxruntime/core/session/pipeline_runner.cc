@@ -0,0 +1,206 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_runner.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensor.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+PipelineRunner::PipelineRunner(std::vector<Stage> stages, int64_t num_micro_batches)
+    : stages_(std::move(stages)),
+      num_micro_batches_(std::max<int64_t>(num_micro_batches, 1)),
+      allocator_(std::make_shared<CPUAllocator>()) {
+  ORT_ENFORCE(!stages_.empty(), "A pipeline requires at least one stage");
+}
+
+Status PipelineRunner::CreateStage(InferenceSession& session, Stage& stage) {
+  const auto inputs = session.GetModelInputs();
+  ORT_RETURN_IF_ERROR(inputs.first);
+  const auto outputs = session.GetModelOutputs();
+  ORT_RETURN_IF_ERROR(outputs.first);
+
+  stage.input_names.clear();
+  for (const auto* input : *inputs.second) {
+    stage.input_names.push_back(input->Name());
+  }
+  stage.output_names.clear();
+  for (const auto* output : *outputs.second) {
+    stage.output_names.push_back(output->Name());
+  }
+  stage.run_fn = [&session](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                            gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                            std::vector<OrtValue>& fetches) {
+    return session.Run(run_options, feed_names, feeds, output_names, &fetches);
+  };
+  return Status::OK();
+}
+
+Status PipelineRunner::Run(const RunOptions& run_options,
+                           gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                           gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) const {
+  ORT_RETURN_IF_NOT(!feeds.empty() && feed_names.size() == feeds.size(), "Invalid feeds");
+
+  int64_t batch_size = -1;
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    ORT_RETURN_IF_NOT(feeds[i].IsTensor(), "Feed ", feed_names[i], " is not a tensor");
+    const auto& tensor = feeds[i].Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    ORT_RETURN_IF_NOT(tensor.Location().device.Type() == OrtDevice::CPU && !tensor.IsDataTypeString(),
+                      "Feed ", feed_names[i], " must be a CPU tensor of a numeric type");
+    ORT_RETURN_IF_NOT(shape.NumDimensions() > 0 && (batch_size == -1 || shape[0] == batch_size),
+                      "All the feeds must have the same batch dimension, feed ", feed_names[i], " has shape ", shape);
+    batch_size = shape[0];
+  }
+  ORT_RETURN_IF_NOT(batch_size > 0, "The batch dimension must be positive");
+
+  // the first micro-batches get one more row if the batch can't be split evenly
+  const int64_t num_micro_batches = std::min(num_micro_batches_, batch_size);
+  InlinedVector<int64_t> micro_batch_rows(narrow<size_t>(num_micro_batches), batch_size / num_micro_batches);
+  for (int64_t i = 0; i < batch_size % num_micro_batches; ++i) {
+    ++micro_batch_rows[narrow<size_t>(i)];
+  }
+
+  // the micro-batch feeds use the buffers of the feeds
+  std::vector<MicroBatch> micro_batches(micro_batch_rows.size());
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    const auto& tensor = feeds[i].Get<Tensor>();
+    const size_t row_size = narrow<size_t>(tensor.Shape().SizeFromDimension(1)) * tensor.DataType()->Size();
+    auto* data = static_cast<char*>(const_cast<void*>(tensor.DataRaw()));
+    for (size_t m = 0; m < micro_batch_rows.size(); ++m) {
+      TensorShape shape = tensor.Shape();
+      shape[0] = micro_batch_rows[m];
+      Tensor::InitOrtValue(tensor.DataType(), shape, data, tensor.Location(), micro_batches[m][feed_names[i]]);
+      data += narrow<size_t>(micro_batch_rows[m]) * row_size;
+    }
+  }
+
+  Progress progress;
+  progress.completed.resize(stages_.size(), 0);
+  std::vector<std::thread> threads;
+  threads.reserve(stages_.size());
+  for (size_t s = 0; s < stages_.size(); ++s) {
+    threads.emplace_back([this, s, &run_options, &micro_batches, &progress]() {
+      RunStage(s, run_options, micro_batches, progress);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ORT_RETURN_IF_ERROR(progress.status);
+
+  return ConcatenateFetches(micro_batches, micro_batch_rows, output_names, fetches);
+}
+
+void PipelineRunner::RunStage(size_t stage_index, const RunOptions& run_options,
+                              std::vector<MicroBatch>& micro_batches, Progress& progress) const {
+  const Stage& stage = stages_[stage_index];
+  for (size_t m = 0; m < micro_batches.size(); ++m) {
+    {
+      std::unique_lock<OrtMutex> lock(progress.mutex);
+      progress.cv.wait(lock, [&]() {
+        return !progress.status.IsOK() || stage_index == 0 || progress.completed[stage_index - 1] > m;
+      });
+      if (!progress.status.IsOK()) {
+        return;
+      }
+      if (run_options.terminate) {
+        progress.status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+        progress.cv.notify_all();
+        return;
+      }
+    }
+
+    // a micro-batch is only used by one stage at a time, the stages before this one are done with it
+    MicroBatch& micro_batch = micro_batches[m];
+    Status status;
+    std::vector<OrtValue> inputs;
+    inputs.reserve(stage.input_names.size());
+    for (const auto& name : stage.input_names) {
+      auto value = micro_batch.find(name);
+      if (value == micro_batch.end()) {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input ", name, " of pipeline stage ", stage_index,
+                                 " is neither a feed nor an output of a previous stage");
+        break;
+      }
+      inputs.push_back(value->second);
+    }
+
+    std::vector<OrtValue> outputs;
+    if (status.IsOK()) {
+      status = stage.run_fn(run_options, stage.input_names, inputs, stage.output_names, outputs);
+    }
+    if (status.IsOK() && outputs.size() != stage.output_names.size()) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Pipeline stage ", stage_index, " returned ", outputs.size(),
+                               " outputs instead of ", stage.output_names.size());
+    }
+    if (status.IsOK()) {
+      for (size_t i = 0; i < stage.output_names.size(); ++i) {
+        micro_batch[stage.output_names[i]] = std::move(outputs[i]);
+      }
+    }
+
+    std::lock_guard<OrtMutex> lock(progress.mutex);
+    if (!status.IsOK()) {
+      if (progress.status.IsOK()) {
+        progress.status = status;
+      }
+      progress.cv.notify_all();
+      return;
+    }
+    progress.completed[stage_index] = m + 1;
+    progress.cv.notify_all();
+  }
+}
+
+Status PipelineRunner::ConcatenateFetches(const std::vector<MicroBatch>& micro_batches,
+                                          gsl::span<const int64_t> micro_batch_rows,
+                                          gsl::span<const std::string> output_names,
+                                          std::vector<OrtValue>& fetches) const {
+  fetches.clear();
+  fetches.resize(output_names.size());
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    const Tensor* first = nullptr;
+    int64_t batch_size = 0;
+    for (size_t m = 0; m < micro_batches.size(); ++m) {
+      const auto value = micro_batches[m].find(output_names[i]);
+      ORT_RETURN_IF_NOT(value != micro_batches[m].end() && value->second.IsTensor(),
+                        "Output ", output_names[i], " is not a tensor produced by the pipeline");
+      const auto& tensor = value->second.Get<Tensor>();
+      const auto& shape = tensor.Shape();
+      ORT_RETURN_IF_NOT(tensor.Location().device.Type() == OrtDevice::CPU && !tensor.IsDataTypeString(),
+                        "Output ", output_names[i], " must be a CPU tensor of a numeric type");
+      ORT_RETURN_IF_NOT(shape.NumDimensions() > 0 && shape[0] == micro_batch_rows[m],
+                        "Output ", output_names[i], " does not have the batch dimension ", micro_batch_rows[m],
+                        " of its micro-batch: ", shape);
+      if (first == nullptr) {
+        first = &tensor;
+      } else {
+        ORT_RETURN_IF_NOT(tensor.DataType() == first->DataType() &&
+                              tensor.Shape().Slice(1) == first->Shape().Slice(1),
+                          "Output ", output_names[i], " has different types or shapes in different micro-batches");
+      }
+      batch_size += shape[0];
+    }
+
+    TensorShape shape = first->Shape();
+    shape[0] = batch_size;
+    Tensor::InitOrtValue(first->DataType(), shape, allocator_, fetches[i]);
+    auto* data = static_cast<char*>(fetches[i].GetMutable<Tensor>()->MutableDataRaw());
+    for (const auto& micro_batch : micro_batches) {
+      const auto& tensor = micro_batch.at(output_names[i]).Get<Tensor>();
+      std::memcpy(data, tensor.DataRaw(), tensor.SizeInBytes());
+      data += tensor.SizeInBytes();
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/run_options.h"
+#include "core/platform/ort_mutex.h"
+#include "core/session/dynamic_batcher.h"
+
+namespace onnxruntime {
+
+class InferenceSession;
+
+/**
+ * Runs a model split into consecutive stages, e.g. one session per device, as a pipeline of micro-batches.
+ *
+ * The CPU feeds are split along their first (batch) dimension into micro-batches, without copying. Each stage runs
+ * on its own thread and processes the micro-batches in order, so stage i runs micro-batch m while stage i + 1 runs
+ * micro-batch m - 1. A stage takes its inputs by name from the feeds and from the outputs of the previous stages
+ * for the same micro-batch. The requested outputs are concatenated back along the batch dimension, so they
+ * must be CPU tensors with the batch dimension of their micro-batch.
+ *
+ * Setting RunOptions::terminate stops the stages before their next micro-batch. It is also passed to the stages.
+ */
+class PipelineRunner {
+ public:
+  using RunFn = DynamicBatcher::RunFn;
+
+  struct Stage {
+    RunFn run_fn;
+    std::vector<std::string> input_names;
+    std::vector<std::string> output_names;
+  };
+
+  /**
+   * @param stages The stages in execution order.
+   * @param num_micro_batches The number of micro-batches a batch is split into. Batches smaller than this are split
+   *                          into micro-batches of 1.
+   */
+  PipelineRunner(std::vector<Stage> stages, int64_t num_micro_batches);
+
+  // Creates a stage running the session with all the inputs and outputs of its model. The session must outlive the
+  // stage.
+  static Status CreateStage(InferenceSession& session, Stage& stage);
+
+  Status Run(const RunOptions& run_options,
+             gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PipelineRunner);
+
+  using MicroBatch = InlinedHashMap<std::string, OrtValue>;
+
+  struct Progress {
+    OrtMutex mutex;
+    OrtCondVar cv;
+    // The number of micro-batches each stage is done with.
+    std::vector<size_t> completed;
+    // The first error of a stage, which stops all the stages.
+    Status status;
+  };
+
+  // Runs the given stage for all the micro-batches, once the previous stage is done with each of them.
+  void RunStage(size_t stage_index, const RunOptions& run_options, std::vector<MicroBatch>& micro_batches,
+                Progress& progress) const;
+
+  Status ConcatenateFetches(const std::vector<MicroBatch>& micro_batches, gsl::span<const int64_t> micro_batch_rows,
+                            gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) const;
+
+  const std::vector<Stage> stages_;
+  const int64_t num_micro_batches_;
+  const AllocatorPtr allocator_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/prefix_kv_cache.h"
+
+#include <algorithm>
+
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/session/IOBinding.h"
+
+namespace onnxruntime {
+
+namespace {
+// MurmurHash3 takes the length as an int, so long prefixes are hashed in chunks, each seeded with the hash so far.
+constexpr size_t kHashChunkTokens = size_t{1} << 20;
+}  // namespace
+
+uint64_t PrefixKVCache::Hash(gsl::span<const int64_t> tokens) {
+  uint32_t hash[4] = {0, 0, 0, 0};
+  for (size_t offset = 0; offset < tokens.size(); offset += kHashChunkTokens) {
+    const size_t chunk_size = std::min(tokens.size() - offset, kHashChunkTokens);
+    MurmurHash3::x86_128(tokens.data() + offset, static_cast<int>(chunk_size * sizeof(int64_t)), hash[0], &hash);
+  }
+  return (static_cast<uint64_t>(hash[1]) << 32) | hash[0];
+}
+
+PrefixKVCache::LruList::iterator PrefixKVCache::Find(uint64_t hash, gsl::span<const int64_t> tokens) {
+  auto range = index_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    // Compare the tokens too, the hash may collide.
+    const auto& entry_tokens = (*it->second)->tokens;
+    if (std::equal(entry_tokens.begin(), entry_tokens.end(), tokens.begin(), tokens.end())) {
+      return it->second;
+    }
+  }
+  return lru_.end();
+}
+
+void PrefixKVCache::Erase(uint64_t hash, LruList::iterator it) {
+  auto range = index_.equal_range(hash);
+  for (auto index_it = range.first; index_it != range.second; ++index_it) {
+    if (index_it->second == it) {
+      index_.erase(index_it);
+      break;
+    }
+  }
+
+  const size_t prefix_length = (*it)->tokens.size();
+  auto length_it = prefix_lengths_.find(prefix_length);
+  if (--length_it->second == 0) {
+    prefix_lengths_.erase(length_it);
+  }
+  size_in_bytes_ -= (*it)->size_in_bytes;
+  lru_.erase(it);
+}
+
+Status PrefixKVCache::Insert(gsl::span<const int64_t> tokens, std::vector<std::string> names,
+                             std::vector<OrtValue> values) {
+  ORT_RETURN_IF_NOT(!tokens.empty(), "The prefix to cache has no tokens");
+  ORT_RETURN_IF_NOT(names.size() == values.size(), "Expected a name for each of the ", values.size(),
+                    " values to cache but got ", names.size());
+
+  auto entry = std::make_shared<Entry>();
+  entry->size_in_bytes = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    ORT_RETURN_IF_NOT(values[i].IsTensor(), "The cached value ", names[i], " is not a tensor");
+    entry->size_in_bytes += values[i].Get<Tensor>().SizeInBytes();
+  }
+  if (entry->size_in_bytes > max_bytes_) {
+    return Status::OK();
+  }
+  entry->tokens.assign(tokens.begin(), tokens.end());
+  entry->names = std::move(names);
+  entry->values = std::move(values);
+
+  const uint64_t hash = Hash(tokens);
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto existing = Find(hash, tokens);
+  if (existing != lru_.end()) {
+    Erase(hash, existing);
+  }
+
+  while (size_in_bytes_ + entry->size_in_bytes > max_bytes_) {
+    auto last = std::prev(lru_.end());
+    Erase(Hash((*last)->tokens), last);
+  }
+
+  size_in_bytes_ += entry->size_in_bytes;
+  ++prefix_lengths_[entry->tokens.size()];
+  lru_.push_front(std::move(entry));
+  index_.emplace(hash, lru_.begin());
+  return Status::OK();
+}
+
+std::shared_ptr<const PrefixKVCache::Entry> PrefixKVCache::Lookup(gsl::span<const int64_t> tokens) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  for (const auto& [prefix_length, num_entries] : prefix_lengths_) {
+    if (prefix_length > tokens.size()) {
+      continue;
+    }
+    const auto prefix = tokens.first(prefix_length);
+    auto it = Find(Hash(prefix), prefix);
+    if (it != lru_.end()) {
+      lru_.splice(lru_.begin(), lru_, it);
+      return *it;
+    }
+  }
+  return nullptr;
+}
+
+Status PrefixKVCache::BindLongestPrefix(gsl::span<const int64_t> tokens, IOBinding& io_binding,
+                                        size_t& prefix_length) {
+  prefix_length = 0;
+  // The entry is kept alive by the binding even if it is evicted meanwhile.
+  auto entry = Lookup(tokens);
+  if (entry == nullptr) {
+    return Status::OK();
+  }
+  for (size_t i = 0; i < entry->names.size(); ++i) {
+    ORT_RETURN_IF_ERROR(io_binding.BindInput(entry->names[i], entry->values[i]));
+  }
+  prefix_length = entry->tokens.size();
+  return Status::OK();
+}
+
+void PrefixKVCache::Clear() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  lru_.clear();
+  index_.clear();
+  prefix_lengths_.clear();
+  size_in_bytes_ = 0;
+}
+
+size_t PrefixKVCache::NumEntries() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return lru_.size();
+}
+
+size_t PrefixKVCache::SizeInBytes() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return size_in_bytes_;
+}
+
+}  // namespace onnxruntime
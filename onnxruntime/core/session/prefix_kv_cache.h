@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+class IOBinding;
+
+/**
+ * Caches the present key/value tensors computed for token prefixes, e.g. a system prompt shared by many requests,
+ * so that later Run calls can bind them as past key/value instead of recomputing the prefix.
+ *
+ * Entries are keyed by a hash of the token ids of the prefix and hold the fetched OrtValues as is, on whichever
+ * device they were produced. Binding them with IOBinding::BindInput shares the buffers, nothing is copied.
+ * The least recently used entries are evicted once the total size of the cached tensors exceeds the budget.
+ *
+ * The cached tensors must not be written to. In particular they can not be bound as the past of a model that
+ * updates its past key/value in place (past_present_share_buffer), since concurrent runs would overwrite each
+ * other's cache entries.
+ */
+class PrefixKVCache {
+ public:
+  struct Entry {
+    std::vector<int64_t> tokens;
+    std::vector<std::string> names;
+    std::vector<OrtValue> values;
+    size_t size_in_bytes;
+  };
+
+  // max_bytes is the total size of the tensors the cache may hold.
+  explicit PrefixKVCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  /**
+   * Caches values, named by the graph inputs they are to be bound to, as the key/value of the prefix tokens.
+   * An existing entry for the same tokens is replaced. Entries which alone exceed the budget are not cached.
+   */
+  Status Insert(gsl::span<const int64_t> tokens, std::vector<std::string> names, std::vector<OrtValue> values);
+
+  // Returns the entry of the longest cached prefix of tokens, or nullptr if no prefix is cached.
+  std::shared_ptr<const Entry> Lookup(gsl::span<const int64_t> tokens);
+
+  /**
+   * Binds the values of the longest cached prefix of tokens as inputs of io_binding.
+   * @param prefix_length Set to the number of tokens of the bound prefix, 0 if no prefix is cached and nothing
+   *                      was bound. The caller runs the remaining tokens with a past sequence length of prefix_length.
+   */
+  Status BindLongestPrefix(gsl::span<const int64_t> tokens, IOBinding& io_binding, size_t& prefix_length);
+
+  void Clear();
+
+  size_t NumEntries() const;
+  size_t SizeInBytes() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrefixKVCache);
+
+  using LruList = std::list<std::shared_ptr<const Entry>>;
+
+  static uint64_t Hash(gsl::span<const int64_t> tokens);
+
+  // Finds the entry of exactly these tokens. The caller holds mutex_.
+  LruList::iterator Find(uint64_t hash, gsl::span<const int64_t> tokens);
+  void Erase(uint64_t hash, LruList::iterator it);
+
+  const size_t max_bytes_;
+  mutable OrtMutex mutex_;
+  // Most recently used first.
+  LruList lru_;
+  std::unordered_multimap<uint64_t, LruList::iterator> index_;
+  // Number of cached entries by prefix length, to look up the longest prefixes first.
+  std::map<size_t, size_t, std::greater<size_t>> prefix_lengths_;
+  size_t size_in_bytes_ = 0;
+};
+
+}  // namespace onnxruntime
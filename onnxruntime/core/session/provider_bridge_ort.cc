@@ -1787,6 +1787,8 @@ OrtCUDAProviderOptionsV2 OrtCUDAProviderOptionsToOrtCUDAProviderOptionsV2(const
   cuda_options_converted.enable_skip_layer_norm_strict_mode = 0;
   cuda_options_converted.use_ep_level_unified_stream = 0;
   cuda_options_converted.use_tf32 = 1;
+  cuda_options_converted.use_cuda_mempool = 0;
+  cuda_options_converted.cuda_mempool_release_threshold = 0;
 
   return cuda_options_converted;
 }
@@ -1861,6 +1863,7 @@ OrtTensorRTProviderOptionsV2 OrtTensorRTProviderOptionsToOrtTensorRTProviderOpti
   trt_options_converted.trt_ep_context_embed_mode = 0;
   trt_options_converted.trt_engine_cache_prefix = "";
   trt_options_converted.trt_engine_hw_compatible = 0;
+  trt_options_converted.trt_profile_growth_enable = 0;
 
   return trt_options_converted;
 }
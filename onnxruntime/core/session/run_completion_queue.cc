@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/run_completion_queue.h"
+
+#include <cerrno>
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace onnxruntime {
+
+RunCompletionQueue::RunCompletionQueue() {
+#ifdef __linux__
+  fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  ORT_ENFORCE(fd_ >= 0, "eventfd failed with errno ", errno);
+#endif
+}
+
+RunCompletionQueue::~RunCompletionQueue() {
+#ifdef __linux__
+  close(fd_);
+#endif
+}
+
+void RunCompletionQueue::Push(std::function<void()> completion) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    completions_.push_back(std::move(completion));
+  }
+  cv_.notify_one();
+#ifdef __linux__
+  const uint64_t one = 1;
+  // Only fails if the counter would overflow, in which case the fd is readable already.
+  [[maybe_unused]] const auto written = write(fd_, &one, sizeof(one));
+#endif
+}
+
+size_t RunCompletionQueue::Dispatch(int timeout_ms) {
+#ifdef __linux__
+  // Reset the fd before taking the completions, so that a completion pushed after them makes it readable again.
+  uint64_t count = 0;
+  [[maybe_unused]] const auto read_size = read(fd_, &count, sizeof(count));
+#endif
+
+  std::vector<std::function<void()>> completions;
+  {
+    std::unique_lock<OrtMutex> lock(mutex_);
+    const auto pending = [this]() { return !completions_.empty(); };
+    if (timeout_ms < 0) {
+      cv_.wait(lock, pending);
+    } else if (timeout_ms > 0) {
+      // OrtCondVar::wait_for has no predicate overload
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+      for (auto now = std::chrono::steady_clock::now(); !pending() && now < deadline;
+           now = std::chrono::steady_clock::now()) {
+        cv_.wait_for(lock, deadline - now);
+      }
+    }
+    completions.swap(completions_);
+  }
+
+  for (auto& completion : completions) {
+    completion();
+  }
+  return completions.size();
+}
+
+}  // namespace onnxruntime
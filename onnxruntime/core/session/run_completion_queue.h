@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Collects the completion callbacks of RunAsync calls so that they run on a thread of the caller's choosing, e.g.
+ * the thread of an event loop, instead of on the intra op thread that ran the model.
+ *
+ * On Linux the queue has an eventfd that is readable while completions are pending, so that the event loop can
+ * poll it along with its other file descriptors (epoll, io_uring, ...) and call Dispatch when it is readable.
+ * Elsewhere Dispatch can wait for the completions itself.
+ */
+class RunCompletionQueue {
+ public:
+  RunCompletionQueue();
+  ~RunCompletionQueue();
+
+  // The eventfd signaled by Push, or -1 where there is none. It is reset by Dispatch.
+  int GetFd() const { return fd_; }
+
+  // Queues a completion, called from the thread that completed the run.
+  void Push(std::function<void()> completion);
+
+  /**
+   * Runs the pending completions on the calling thread.
+   * @param timeout_ms how long to wait for a completion when none is pending, 0 not to wait, negative to wait
+   *        indefinitely.
+   * @return the number of completions that ran.
+   */
+  size_t Dispatch(int timeout_ms);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunCompletionQueue);
+
+  OrtMutex mutex_;
+  OrtCondVar cv_;
+  std::vector<std::function<void()>> completions_;
+  int fd_ = -1;
+};
+
+}  // namespace onnxruntime
@@ -19,9 +19,11 @@ std::ostream& operator<<(std::ostream& os, const OrtThreadPoolParams& params) {
   os << " thread_pool_size: " << params.thread_pool_size;
   os << " auto_set_affinity: " << params.auto_set_affinity;
   os << " allow_spinning: " << params.allow_spinning;
+  os << " adaptive_spinning: " << params.adaptive_spinning;
   os << " dynamic_block_base_: " << params.dynamic_block_base_;
   os << " stack_size: " << params.stack_size;
   os << " affinity_str: " << params.affinity_str;
+  os << " numa_node: " << params.numa_node;
   // os << " name: " << (params.name ? params.name : L"nullptr");
   os << " set_denormal_as_zero: " << params.set_denormal_as_zero;
   // os << " custom_create_thread_fn: " << (params.custom_create_thread_fn ? "set" : "nullptr");
@@ -87,12 +89,51 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
   }
   ORT_THROW("Failed to read affinities from affinity string");
 }
+
+// Build the affinities for a thread pool confined to the logical processors of a NUMA node.
+// With the default pool size there is one thread per physical core of the node, otherwise each
+// of the thread_pool_size threads may run on any processor of the node.
+static std::vector<LogicalProcessors> GetNumaNodeThreadAffinities(const Env& env, int numa_node, int thread_pool_size) {
+  auto numa_nodes = env.GetNumaNodeProcessors();
+  ORT_ENFORCE(static_cast<size_t>(numa_node) < numa_nodes.size() && !numa_nodes[numa_node].empty(),
+              "NUMA node ", numa_node, " does not exist, number of NUMA nodes found: ", numa_nodes.size());
+  const auto& node_processors = numa_nodes[numa_node];
+  auto in_node = [&node_processors](int processor_id) {
+    return std::find(node_processors.cbegin(), node_processors.cend(), processor_id) != node_processors.cend();
+  };
+
+  std::vector<LogicalProcessors> affinities;
+  if (thread_pool_size <= 0) {
+    for (auto& core : env.GetDefaultThreadAffinities()) {
+      if (!core.empty() && std::all_of(core.cbegin(), core.cend(), in_node)) {
+        affinities.push_back(std::move(core));
+      }
+    }
+    if (affinities.empty()) {
+      // Core topology is unknown, use a thread per logical processor of the node.
+      affinities.assign(node_processors.size(), node_processors);
+    }
+  } else {
+    affinities.assign(static_cast<size_t>(thread_pool_size), node_processors);
+  }
+  return affinities;
+}
 #endif
 
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
-  if (options.thread_pool_size <= 0) {  // default
+  if (options.numa_node >= 0) {
+#if defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
+    ORT_THROW("Setting thread affinity is not implemented in this build.");
+#else
+    ORT_ENFORCE(options.affinity_str.empty(), "An affinity string can not be combined with a NUMA node");
+    // As with the default affinities, the first entry is a placeholder for the main thread, which
+    // will be dropped during threadpool creation.
+    to.affinities = GetNumaNodeThreadAffinities(*env, options.numa_node, options.thread_pool_size);
+    options.thread_pool_size = static_cast<int>(to.affinities.size());
+#endif
+  } else if (options.thread_pool_size <= 0) {  // default
     if (options.auto_set_affinity) {
 #ifdef _WIN32
       // Only set thread affinity on Server with auto affinity.
@@ -146,6 +187,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   }
 
   to.set_denormal_as_zero = options.set_denormal_as_zero;
+  to.adaptive_spinning = options.adaptive_spinning;
   // set custom thread management members
   to.custom_create_thread_fn = options.custom_create_thread_fn;
   to.custom_thread_creation_options = options.custom_thread_creation_options;
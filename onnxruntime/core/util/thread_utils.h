@@ -7,6 +7,14 @@
 #include <memory>
 #include <string>
 
+// Whether the thread pools spin a while before blocking when they run out of work. WebAssembly builds run in browser
+// tabs, where spinning costs battery and CPU, so their threads block (in Atomics.wait) right away by default.
+#if defined(__wasm__)
+constexpr bool kOrtThreadPoolDefaultAllowSpinning = false;
+#else
+constexpr bool kOrtThreadPoolDefaultAllowSpinning = true;
+#endif
+
 struct OrtThreadPoolParams {
   // 0: Use default setting. (All the physical cores or half of the logical cores)
   // 1: Don't create thread pool
@@ -19,7 +27,10 @@ struct OrtThreadPoolParams {
   bool auto_set_affinity = false;
 
   // If it is true, the thread pool will spin a while after the queue became empty.
-  bool allow_spinning = true;
+  bool allow_spinning = kOrtThreadPoolDefaultAllowSpinning;
+
+  // If it is true and allow_spinning is true, each thread adapts how long it spins to its recent waits for work.
+  bool adaptive_spinning = false;
 
   // It it is non-negative, thread pool will split a task by a decreasing block size
   // of remaining_of_total_iterations / (num_of_threads * dynamic_block_base_)
@@ -37,6 +48,11 @@ struct OrtThreadPoolParams {
   // meaning ith thread will be attached to first 8 logical processors
   std::string affinity_str;
 
+  // If it is non-negative, confine the threads of the pool to the logical processors of this NUMA node.
+  // With thread_pool_size = 0 one thread is created per physical core of the node.
+  // Can not be combined with affinity_str.
+  int numa_node = -1;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
@@ -199,25 +199,38 @@ class Session:
                 f"Required inputs ({missing_input_names}) are missing from input feed ({feed_input_names})."
             )
 
-    def run(self, output_names, input_feed, run_options=None):
+    def run(self, output_names, input_feed, run_options=None, output_buffers=None):
         """
         Compute the predictions.
 
         :param output_names: name of the outputs
-        :param input_feed: dictionary ``{ input_name: input_value }``
+        :param input_feed: dictionary ``{ input_name: input_value }``. Besides numpy arrays, the values can be
+            objects implementing the ``__dlpack__`` protocol (e.g. torch or cupy tensors, on any device) or the
+            ``__arrow_c_array__`` protocol (e.g. pyarrow arrays without nulls), whose memory is used without a copy.
         :param run_options: See :class:`onnxruntime.RunOptions`.
+        :param output_buffers: optional dictionary ``{ output_name: buffer }`` of pre-allocated outputs, without
+            an :class:`onnxruntime.IOBinding`. A buffer is a writeable C-contiguous numpy array, an
+            :class:`onnxruntime.OrtValue` or an object implementing the ``__dlpack__`` protocol, of the type and
+            shape of the output. The outputs are written into them and they are returned for these outputs.
         :return: list of results, every result is either a numpy array,
             a sparse tensor, a list or a dictionary.
 
         ::
 
             sess.run([output_name], {input_name: x})
+            sess.run([output_name], {input_name: x}, output_buffers={output_name: y})
         """
         self._validate_input(list(input_feed.keys()))
         if not output_names:
             output_names = [output.name for output in self._outputs_meta]
-        try:
+
+        def invoke():
+            if output_buffers:
+                return self._sess.run_with_output_buffers(output_names, input_feed, output_buffers, run_options)
             return self._sess.run(output_names, input_feed, run_options)
+
+        try:
+            return invoke()
         except C.EPFail as err:
             if self._enable_fallback:
                 print(f"EP Error: {err!s} using {self._providers}")
@@ -225,9 +238,31 @@ class Session:
                 self.set_providers(self._fallback_providers)
                 # Fallback only once.
                 self.disable_fallback()
-                return self._sess.run(output_names, input_feed, run_options)
+                return invoke()
             raise
 
+    def run_batch(self, output_names, input_feeds, run_options=None):
+        """
+        Compute the predictions of several independent requests, run concurrently on the ort intra-op threadpool.
+        The feeds are converted and the results wrapped once for the whole batch, with the GIL released while the
+        requests run.
+
+        :param output_names: name of the outputs, the same for all the requests
+        :param input_feeds: list of dictionaries ``{ input_name: input_value }``, one per request
+        :param run_options: See :class:`onnxruntime.RunOptions`.
+        :return: list of the results of each request, in the order of ``input_feeds``. An error of any request
+            is raised for the whole batch.
+
+        ::
+
+            results = sess.run_batch([output_name], [{input_name: x0}, {input_name: x1}])
+        """
+        for input_feed in input_feeds:
+            self._validate_input(list(input_feed.keys()))
+        if not output_names:
+            output_names = [output.name for output in self._outputs_meta]
+        return self._sess.run_batch(output_names, input_feeds, run_options)
+
     def run_async(self, output_names, input_feed, callback, user_data, run_options=None):
         """
         Compute the predictions asynchronously in a separate cxx thread from ort intra-op threadpool.
@@ -579,6 +614,18 @@ class IOBinding:
         """
         self._iobinding.bind_ortvalue_input(name, ortvalue._ortvalue)
 
+    def bind_state(self, input_name, output_name, initial_value):
+        """
+        Binds a state carried from each run to the next one, e.g. the cache of a streaming model run chunk by chunk.
+        initial_value is bound as the input, and after each successful run the output is bound in its place
+        without a copy. The state must keep its shape across the runs.
+
+        :param input_name: name of the model input of the state
+        :param output_name: name of the model output of the state
+        :param initial_value: OrtValue instance holding the state of the first run, which is not written to
+        """
+        self._iobinding.bind_state(input_name, output_name, initial_value._ortvalue)
+
     def synchronize_inputs(self):
         self._iobinding.synchronize_inputs()
 
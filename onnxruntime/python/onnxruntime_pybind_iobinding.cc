@@ -84,6 +84,12 @@ void addIoBindingMethods(pybind11::module& m) {
           throw std::runtime_error("Error when binding input: " + status.ErrorMessage());
         }
       })
+      .def("bind_state", [](SessionIOBinding* io_binding, const std::string& input_name, const std::string& output_name, const OrtValue& initial_value) -> void {
+        auto status = io_binding->Get()->BindState(input_name, output_name, initial_value);
+        if (!status.IsOK()) {
+          throw std::runtime_error("Error when binding state: " + status.ErrorMessage());
+        }
+      })
       .def("synchronize_inputs", [](SessionIOBinding* io_binding) -> void {
         auto status = io_binding->Get()->SynchronizeInputs();
         if (!status.IsOK()) {
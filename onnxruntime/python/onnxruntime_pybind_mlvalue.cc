@@ -4,6 +4,9 @@
 #include "python/onnxruntime_pybind_state_common.h"
 #include "pybind11/numpy.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 #define NO_IMPORT_ARRAY
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #define PY_ARRAY_UNIQUE_SYMBOL onnxruntime_python_ARRAY_API
@@ -941,6 +944,145 @@ static void CreateGenericIterableMLValue(PyObject* iterator, AllocatorPtr alloc,
   }
 }
 
+static const NodeArg* FindInputDef(const InputDefList* input_def_list, const std::string& name_input) {
+  if (input_def_list == nullptr) {
+    return nullptr;
+  }
+  auto it = std::find_if(input_def_list->begin(), input_def_list->end(),
+                         [&name_input](const NodeArg* node_arg) { return node_arg->Name() == name_input; });
+  return it != input_def_list->end() ? *it : nullptr;
+}
+
+#ifdef ENABLE_DLPACK
+// Wraps the memory of an object implementing the __dlpack__ protocol, e.g. a torch or cupy tensor, on any device.
+// DLPack has no boolean type, bool tensors come as uint8 and are taken as bool when the model input is bool.
+static void CreateTensorMLValueFromDlpack(const InputDefList* input_def_list, const std::string& name_input,
+                                          const py::object& value, OrtValue* p_mlvalue) {
+  const NodeArg* input_def = FindInputDef(input_def_list, name_input);
+  const bool is_bool_tensor = input_def != nullptr && input_def->TypeAsProto() != nullptr &&
+                              input_def->TypeAsProto()->tensor_type().elem_type() ==
+                                  ONNX_NAMESPACE::TensorProto_DataType_BOOL;
+  py::object capsule = value.attr("__dlpack__")();
+  *p_mlvalue = FromDlpack(capsule.ptr(), is_bool_tensor);
+}
+#endif
+
+// The structures of the Arrow C data interface, https://arrow.apache.org/docs/format/CDataInterface.html
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+struct ArrowSchema {
+  const char* format;
+  const char* name;
+  const char* metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema** children;
+  struct ArrowSchema* dictionary;
+  void (*release)(struct ArrowSchema*);
+  void* private_data;
+};
+
+struct ArrowArray {
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void** buffers;
+  struct ArrowArray** children;
+  struct ArrowArray* dictionary;
+  void (*release)(struct ArrowArray*);
+  void* private_data;
+};
+
+#endif  // ARROW_C_DATA_INTERFACE
+
+// The element type of an Arrow primitive format, nullptr for the formats without a tensor equivalent.
+static MLDataType ArrowFormatToTensorType(const std::string& format) {
+  static const std::unordered_map<std::string, MLDataType> types = {
+      {"c", DataTypeImpl::GetType<int8_t>()},
+      {"C", DataTypeImpl::GetType<uint8_t>()},
+      {"s", DataTypeImpl::GetType<int16_t>()},
+      {"S", DataTypeImpl::GetType<uint16_t>()},
+      {"i", DataTypeImpl::GetType<int32_t>()},
+      {"I", DataTypeImpl::GetType<uint32_t>()},
+      {"l", DataTypeImpl::GetType<int64_t>()},
+      {"L", DataTypeImpl::GetType<uint64_t>()},
+      {"e", DataTypeImpl::GetType<MLFloat16>()},
+      {"f", DataTypeImpl::GetType<float>()},
+      {"g", DataTypeImpl::GetType<double>()},
+  };
+  auto it = types.find(format);
+  return it != types.end() ? it->second : nullptr;
+}
+
+static void CheckArrowArrayHasNoNulls(const ArrowArray& array, const std::string& name_input) {
+  if (array.null_count != 0 && (array.null_count > 0 || array.buffers[0] != nullptr)) {
+    throw std::runtime_error("The Arrow array of input '" + name_input + "' has null values.");
+  }
+}
+
+// Wraps the values of an object implementing the __arrow_c_array__ protocol, e.g. a pyarrow.Array, without copying
+// them. The array must be a primitive array, which is fed as a column of shape [length] or [length, 1] depending on
+// the rank of the model input, or a fixed size list of primitive values fed as a [length, list size] matrix, and must
+// not have null values. The OrtValue keeps the array alive.
+static void CreateTensorMLValueFromArrow(const InputDefList* input_def_list, const AllocatorPtr& alloc,
+                                         const std::string& name_input, const py::object& value,
+                                         OrtValue* p_mlvalue) {
+  py::tuple capsules = value.attr("__arrow_c_array__")();
+  py::capsule schema_capsule = capsules[0].cast<py::capsule>();
+  py::capsule array_capsule = capsules[1].cast<py::capsule>();
+  const auto* schema = static_cast<const ArrowSchema*>(PyCapsule_GetPointer(schema_capsule.ptr(), "arrow_schema"));
+  const auto* array = static_cast<const ArrowArray*>(PyCapsule_GetPointer(array_capsule.ptr(), "arrow_array"));
+  if (schema == nullptr || array == nullptr) {
+    throw std::runtime_error("__arrow_c_array__ of input '" + name_input + "' did not return Arrow capsules.");
+  }
+  CheckArrowArrayHasNoNulls(*array, name_input);
+
+  const std::string format = schema->format;
+  MLDataType element_type = nullptr;
+  const void* values = nullptr;
+  TensorShapeVector dims{array->length};
+  if (format.rfind("+w:", 0) == 0) {
+    const int64_t list_size = std::stoll(format.substr(3));
+    if (schema->n_children != 1 || array->n_children != 1) {
+      throw std::runtime_error("Malformed Arrow fixed size list for input '" + name_input + "'.");
+    }
+    const ArrowArray& child = *array->children[0];
+    CheckArrowArrayHasNoNulls(child, name_input);
+    element_type = ArrowFormatToTensorType(schema->children[0]->format);
+    if (element_type != nullptr) {
+      values = static_cast<const char*>(child.buffers[1]) +
+               (child.offset + array->offset * list_size) * element_type->Size();
+    }
+    dims.push_back(list_size);
+  } else {
+    element_type = ArrowFormatToTensorType(format);
+    if (element_type != nullptr) {
+      values = static_cast<const char*>(array->buffers[1]) + array->offset * element_type->Size();
+    }
+    const NodeArg* input_def = FindInputDef(input_def_list, name_input);
+    if (input_def != nullptr && input_def->Shape() != nullptr && input_def->Shape()->dim_size() == 2) {
+      dims.push_back(1);
+    }
+  }
+  if (element_type == nullptr) {
+    throw std::runtime_error("Unsupported Arrow format '" + format + "' for input '" + name_input +
+                             "', the array must be a primitive numeric array or a fixed size list of them.");
+  }
+
+  auto p_tensor = std::make_unique<Tensor>(element_type, TensorShape(dims), const_cast<void*>(values), alloc->Info());
+  // The capsule releases the array when it is destroyed. Like the numpy arrays, it is released with the GIL held as
+  // the feeds are destroyed in the bindings.
+  PyObject* array_object = array_capsule.release().ptr();
+  auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+  p_mlvalue->Init(p_tensor.release(), ml_tensor, [array_object](void* p) {
+    DataTypeImpl::GetType<Tensor>()->GetDeleteFunc()(p);
+    Py_DECREF(array_object);
+  });
+}
+
 // Setting `use_numpy_data_memory` to `true` will ensure that the underlying numpy array buffer is directly used
 // as the backing data buffer for the ORT Tensor where applicable (for numeric tensors)
 // The numpy object owns the memory and needs to be alive until the corresponding OrtValue is in scope
@@ -992,6 +1134,12 @@ void CreateGenericMLValue(const onnxruntime::InputDefList* input_def_list, const
     // This should just increase the ref counts of the underlying shared_ptrs in the native OrtValue
     // and the ref count will be decreased when the OrtValue used for Run() is destroyed upon exit.
     *p_mlvalue = *value.attr(PYTHON_ORTVALUE_NATIVE_OBJECT_ATTR).cast<OrtValue*>();
+#ifdef ENABLE_DLPACK
+  } else if (!accept_only_numpy_array && py::hasattr(value, "__dlpack__")) {
+    CreateTensorMLValueFromDlpack(input_def_list, name_input, value, p_mlvalue);
+#endif
+  } else if (!accept_only_numpy_array && py::hasattr(value, "__arrow_c_array__")) {
+    CreateTensorMLValueFromArrow(input_def_list, alloc, name_input, value, p_mlvalue);
   } else if (!accept_only_numpy_array) {
     auto iterator = PyObject_GetIter(value.ptr());
     if (iterator == NULL) {
@@ -809,6 +809,14 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
             } else {
               ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_engine_hw_compatible' should be 'True' or 'False'. Default value is 'False'.\n");
             }
+          } else if (option.first == "trt_profile_growth_enable") {
+            if (option.second == "True" || option.second == "true") {
+              params.trt_profile_growth_enable = true;
+            } else if (option.second == "False" || option.second == "false") {
+              params.trt_profile_growth_enable = false;
+            } else {
+              ORT_THROW("[ERROR] [TensorRT] The value for the key 'trt_profile_growth_enable' should be 'True' or 'False'. Default value is 'False'.\n");
+            }
           } else {
             ORT_THROW("Invalid TensorRT EP option: ", option.first);
           }
@@ -1078,6 +1086,9 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
         } else if (option.first == "cache_dir") {
           OV_provider_options_map[option.first] = option.second;
           continue;
+        } else if (option.first == "performance_hint") {
+          OV_provider_options_map[option.first] = option.second;
+          continue;
         } else if (option.first == "context") {
           OV_provider_options_map[option.first] = option.second;
           continue;
@@ -1349,6 +1360,142 @@ static void LogDeprecationWarning(
 }
 #endif
 
+// Creates an OrtValue over the memory of a python object an output is written into. Only objects whose memory can be
+// used without a copy are accepted, as the output would be lost in the copy.
+static OrtValue CreateOutputBufferMLValue(const std::string& name, const py::object& buffer) {
+  OrtValue ml_value;
+  if (py::isinstance<py::array>(buffer)) {
+    auto array = buffer.cast<py::array>();
+    if (!IsNumericNumpyArray(buffer) || !(array.flags() & py::array::c_style) || !array.writeable()) {
+      throw std::runtime_error("The output buffer of '" + name +
+                               "' must be a writeable C-contiguous numpy array of a numeric type.");
+    }
+    CreateGenericMLValue(nullptr, GetAllocator(), name, buffer, &ml_value, /*accept_only_numpy_array*/ true);
+  } else if (strcmp(Py_TYPE(buffer.ptr())->tp_name, PYTHON_ORTVALUE_OBJECT_NAME) == 0) {
+    ml_value = *buffer.attr(PYTHON_ORTVALUE_NATIVE_OBJECT_ATTR).cast<OrtValue*>();
+#ifdef ENABLE_DLPACK
+  } else if (py::hasattr(buffer, "__dlpack__")) {
+    py::object capsule = buffer.attr("__dlpack__")();
+    ml_value = FromDlpack(capsule.ptr(), /*is_bool_tensor*/ false);
+#endif
+  } else {
+    throw std::runtime_error("Unsupported output buffer type for '" + name + "'.");
+  }
+  return ml_value;
+}
+
+// Converts the python objects fed to a run into OrtValues. numpy arrays are used without a copy where their type and
+// layout allow it, which is why this holds the GIL.
+static NameMLValMap CreateFeedsFromPyFeeds(PyInferenceSession* sess,
+                                           const std::map<std::string, const py::object>& pyfeeds) {
+  auto px = sess->GetSessionHandle()->GetModelInputs();
+  if (!px.first.IsOK() || !px.second) {
+    throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+  }
+
+  NameMLValMap feeds;
+  feeds.reserve(pyfeeds.size());
+  for (const auto& feed : pyfeeds) {
+    // No need to process 'None's sent in by the user
+    // to feed Optional inputs in the graph.
+    // We just won't include anything in the feed and ORT
+    // will handle such implicit 'None's internally.
+    if (!feed.second.is(py::none())) {
+      OrtValue ml_value;
+      CreateGenericMLValue(px.second, GetAllocator(), feed.first, feed.second, &ml_value);
+      ThrowIfPyErrOccured();
+      feeds.insert(std::make_pair(feed.first, ml_value));
+    }
+  }
+  return feeds;
+}
+
+// Wraps the outputs of a run into python objects, the objects of output_buffers for the outputs written into them.
+static py::list CreatePyListFromFetches(const std::vector<std::string>& output_names,
+                                        const std::vector<OrtValue>& fetches,
+                                        const std::map<std::string, py::object>& output_buffers) {
+  py::list result;
+  size_t pos = 0;
+  for (const auto& fet : fetches) {
+    auto buffer = output_buffers.find(output_names[pos]);
+    if (buffer != output_buffers.end()) {
+      result.append(buffer->second);
+    } else if (fet.IsAllocated()) {
+      if (fet.IsTensor()) {
+        result.append(AddTensorAsPyObj(fet, nullptr, nullptr));
+      } else if (fet.IsSparseTensor()) {
+        result.append(GetPyObjectFromSparseTensor(pos, fet, nullptr));
+      } else {
+        result.append(AddNonTensorAsPyObj(fet, nullptr, nullptr));
+      }
+    } else {  // Send back None because the corresponding OrtValue was empty
+      result.append(py::none());
+    }
+    ++pos;
+  }
+  return result;
+}
+
+// Runs the session with feeds converted from python objects. The outputs in output_buffers are written into the
+// memory of the given objects, which are returned for them, the others are returned as numpy arrays, sparse tensors,
+// sequences or maps.
+static py::list RunWithPyFeeds(PyInferenceSession* sess, const std::vector<std::string>& output_names,
+                               const std::map<std::string, const py::object>& pyfeeds, RunOptions* run_options,
+                               const std::map<std::string, py::object>& output_buffers) {
+  NameMLValMap feeds = CreateFeedsFromPyFeeds(sess, pyfeeds);
+
+  std::vector<OrtValue> fetches;
+  if (!output_buffers.empty()) {
+    fetches.resize(output_names.size());
+    for (size_t i = 0; i < output_names.size(); ++i) {
+      auto buffer = output_buffers.find(output_names[i]);
+      if (buffer != output_buffers.end()) {
+        fetches[i] = CreateOutputBufferMLValue(output_names[i], buffer->second);
+      }
+    }
+  } else {
+    fetches.reserve(output_names.size());
+  }
+
+  {
+    // release GIL to allow multiple python threads to invoke Run() in parallel.
+    py::gil_scoped_release release;
+    if (run_options != nullptr) {
+      OrtPybindThrowIfError(sess->GetSessionHandle()->Run(*run_options, feeds, output_names, &fetches));
+    } else {
+      OrtPybindThrowIfError(sess->GetSessionHandle()->Run(feeds, output_names, &fetches));
+    }
+  }
+
+  return CreatePyListFromFetches(output_names, fetches, output_buffers);
+}
+
+// Runs the session once per feed dict. The GIL is taken once to convert all the feeds and once to wrap all the
+// outputs, and released while the runs execute concurrently, so the binding overhead is paid once for the batch.
+static py::list RunBatchWithPyFeeds(PyInferenceSession* sess, const std::vector<std::string>& output_names,
+                                    const std::vector<std::map<std::string, const py::object>>& pyfeeds_batch,
+                                    RunOptions* run_options) {
+  std::vector<NameMLValMap> feeds_batch;
+  feeds_batch.reserve(pyfeeds_batch.size());
+  for (const auto& pyfeeds : pyfeeds_batch) {
+    feeds_batch.push_back(CreateFeedsFromPyFeeds(sess, pyfeeds));
+  }
+
+  std::vector<std::vector<OrtValue>> fetches_batch;
+  {
+    py::gil_scoped_release release;
+    const RunOptions default_run_options;
+    OrtPybindThrowIfError(sess->GetSessionHandle()->RunBatch(run_options ? *run_options : default_run_options,
+                                                             feeds_batch, output_names, &fetches_batch));
+  }
+
+  py::list results;
+  for (const auto& fetches : fetches_batch) {
+    results.append(CreatePyListFromFetches(output_names, fetches, {}));
+  }
+  return results;
+}
+
 void addGlobalMethods(py::module& m) {
   m.def("get_default_session_options", &GetDefaultCPUSessionOptions, "Return a default session_options instance.");
   m.def("get_session_initializer", &SessionObjectInitializer::Get, "Return a default session object initializer.");
@@ -1569,6 +1716,12 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
             ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
           } else if (key == "max_power_of_two_extend_bytes") {
             ort_arena_cfg->max_power_of_two_extend_bytes = kvp.second.cast<int>();
+          } else if (key == "thread_cache_bytes") {
+            ort_arena_cfg->thread_cache_bytes = kvp.second.cast<int64_t>();
+          } else if (key == "thread_cache_max_chunk_bytes") {
+            ort_arena_cfg->thread_cache_max_chunk_bytes = kvp.second.cast<int>();
+          } else if (key == "trim_window_ms") {
+            ort_arena_cfg->trim_window_ms = kvp.second.cast<int64_t>();
           } else {
             ORT_THROW("Invalid OrtArenaCfg option: ", key);
           }
@@ -1580,7 +1733,10 @@ void addObjectMethods(py::module& m, ExecutionProviderRegistrationFn ep_registra
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
       .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
-      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes);
+      .def_readwrite("max_power_of_two_extend_bytes", &OrtArenaCfg::max_power_of_two_extend_bytes)
+      .def_readwrite("thread_cache_bytes", &OrtArenaCfg::thread_cache_bytes)
+      .def_readwrite("thread_cache_max_chunk_bytes", &OrtArenaCfg::thread_cache_max_chunk_bytes)
+      .def_readwrite("trim_window_ms", &OrtArenaCfg::trim_window_ms);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
@@ -1992,56 +2148,24 @@ including arg name, arg type (contains both type and shape).)pbdoc")
            [](PyInferenceSession* sess, const std::vector<std::string>& output_names,
               const std::map<std::string, const py::object>& pyfeeds, RunOptions* run_options = nullptr)
                -> py::list {
-             NameMLValMap feeds;
-             feeds.reserve(pyfeeds.size());
-             for (const auto& feed : pyfeeds) {
-               // No need to process 'None's sent in by the user
-               // to feed Optional inputs in the graph.
-               // We just won't include anything in the feed and ORT
-               // will handle such implicit 'None's internally.
-               if (!feed.second.is(py::none())) {
-                 OrtValue ml_value;
-                 auto px = sess->GetSessionHandle()->GetModelInputs();
-                 if (!px.first.IsOK() || !px.second) {
-                   throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
-                 }
-                 CreateGenericMLValue(px.second, GetAllocator(), feed.first, feed.second, &ml_value);
-                 ThrowIfPyErrOccured();
-                 feeds.insert(std::make_pair(feed.first, ml_value));
-               }
-             }
-
-             std::vector<OrtValue> fetches;
-             fetches.reserve(output_names.size());
-             common::Status status;
-
-             {
-               // release GIL to allow multiple python threads to invoke Run() in parallel.
-               py::gil_scoped_release release;
-               if (run_options != nullptr) {
-                 OrtPybindThrowIfError(sess->GetSessionHandle()->Run(*run_options, feeds, output_names, &fetches));
-               } else {
-                 OrtPybindThrowIfError(sess->GetSessionHandle()->Run(feeds, output_names, &fetches));
-               }
-             }
-
-             py::list result;
-             size_t pos = 0;
-             for (const auto& fet : fetches) {
-               if (fet.IsAllocated()) {
-                 if (fet.IsTensor()) {
-                   result.append(AddTensorAsPyObj(fet, nullptr, nullptr));
-                 } else if (fet.IsSparseTensor()) {
-                   result.append(GetPyObjectFromSparseTensor(pos, fet, nullptr));
-                 } else {
-                   result.append(AddNonTensorAsPyObj(fet, nullptr, nullptr));
-                 }
-               } else {  // Send back None because the corresponding OrtValue was empty
-                 result.append(py::none());
-               }
-               ++pos;
-             }
-             return result;
+             return RunWithPyFeeds(sess, output_names, pyfeeds, run_options, {});
+           })
+      /// Like run, with some outputs written into the given numpy arrays, OrtValues or objects implementing the
+      /// __dlpack__ protocol, which are returned for these outputs.
+      .def("run_with_output_buffers",
+           [](PyInferenceSession* sess, const std::vector<std::string>& output_names,
+              const std::map<std::string, const py::object>& pyfeeds,
+              const std::map<std::string, py::object>& output_buffers, RunOptions* run_options = nullptr)
+               -> py::list {
+             return RunWithPyFeeds(sess, output_names, pyfeeds, run_options, output_buffers);
+           })
+      /// Runs the session once per feed dict of the list, concurrently on the intra op thread pool, and returns the
+      /// list of the outputs of each run.
+      .def("run_batch",
+           [](PyInferenceSession* sess, const std::vector<std::string>& output_names,
+              const std::vector<std::map<std::string, const py::object>>& pyfeeds_batch,
+              RunOptions* run_options = nullptr) -> py::list {
+             return RunBatchWithPyFeeds(sess, output_names, pyfeeds_batch, run_options);
            })
       .def("run_async",
            [](PyInferenceSession* sess,
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/hardware_counters.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+using profiling::HardwareCounters;
+
+TEST(HardwareCountersTest, DeltaAndOpTypeTotals) {
+  const HardwareCounters::Values begin{10, 20, 30, 40};
+  const HardwareCounters::Values end{15, 40, 30, 35};
+  // counters of exited threads may make a sum decrease
+  const HardwareCounters::Values delta = HardwareCounters::Delta(begin, end);
+  EXPECT_EQ(delta, (HardwareCounters::Values{5, 20, 0, 0}));
+  EXPECT_EQ(HardwareCounters::ToJson(delta),
+            "{\"cycles\": 5, \"instructions\": 20, \"cache_references\": 0, \"cache_misses\": 0}");
+
+  std::string error;
+  auto counters = HardwareCounters::Create(error);
+  if (!counters) {
+    GTEST_SKIP() << "Hardware counters are not available: " << error;
+  }
+
+  counters->RecordOpType("MatMul", delta);
+  counters->RecordOpType("MatMul", delta);
+  counters->RecordOpType("Add", end);
+  auto totals = counters->TakeOpTypeTotals();
+  ASSERT_EQ(totals.size(), 2U);
+  EXPECT_EQ(totals["MatMul"].count, 2U);
+  EXPECT_EQ(totals["MatMul"].values, (HardwareCounters::Values{10, 40, 0, 0}));
+  EXPECT_EQ(totals["Add"].count, 1U);
+  EXPECT_EQ(totals["Add"].values, end);
+  EXPECT_TRUE(counters->TakeOpTypeTotals().empty());
+}
+
+TEST(HardwareCountersTest, CountsOtherThreads) {
+  std::string error;
+  auto counters = HardwareCounters::Create(error);
+  if (!counters) {
+    GTEST_SKIP() << "Hardware counters are not available: " << error;
+  }
+
+  bool started = false;
+  bool stop = false;
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::thread worker([&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    started = true;
+    cv.notify_all();
+    cv.wait(lock, [&]() { return stop; });
+    lock.unlock();
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < 10000000; ++i) {
+      sum = sum + i;
+    }
+  });
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return started; });
+  }
+
+  // the worker was created after the counters, it is only counted once the threads are refreshed
+  counters->RefreshThreads();
+  const auto begin = counters->Read();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+  }
+  cv.notify_all();
+  worker.join();
+  const auto delta = HardwareCounters::Delta(begin, counters->Read());
+
+  // the loop runs at least 10M instructions on the worker
+  EXPECT_GT(delta[0], 0U);
+  EXPECT_GT(delta[1], 10000000U);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/latency_histograms.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+using profiling::LatencyHistograms;
+
+TEST(LatencyHistogramsTest, Buckets) {
+  // every bucket holds the values above the upper bound of the previous one, up to its own upper bound
+  uint64_t previous_upper_bound = 0;
+  for (size_t bucket = 0; bucket + 1 < LatencyHistograms::kNumBuckets; ++bucket) {
+    const uint64_t lower_bound = bucket == 0 ? 0 : previous_upper_bound + 1;
+    const uint64_t upper_bound = LatencyHistograms::BucketUpperBound(bucket);
+    ASSERT_LE(lower_bound, upper_bound);
+    EXPECT_EQ(LatencyHistograms::BucketIndex(lower_bound), bucket);
+    EXPECT_EQ(LatencyHistograms::BucketIndex(upper_bound), bucket);
+    // relative width of a bucket is at most 1/4
+    EXPECT_LE((upper_bound - previous_upper_bound) * LatencyHistograms::kSubBucketCount,
+              std::max<uint64_t>(previous_upper_bound, 4));
+    previous_upper_bound = upper_bound;
+  }
+  EXPECT_EQ(previous_upper_bound, uint64_t{1} << LatencyHistograms::kMaxExponent);
+
+  EXPECT_EQ(LatencyHistograms::BucketIndex(0), 0U);
+  EXPECT_EQ(LatencyHistograms::BucketIndex(1), 0U);
+  EXPECT_EQ(LatencyHistograms::BucketIndex(8), 7U);
+  // the powers of two are upper bounds
+  EXPECT_EQ(LatencyHistograms::BucketUpperBound(LatencyHistograms::BucketIndex(1024)), 1024U);
+  EXPECT_EQ(LatencyHistograms::BucketIndex(1025), LatencyHistograms::BucketIndex(1024) + 1);
+  EXPECT_EQ(LatencyHistograms::BucketIndex((uint64_t{1} << 36) + 1), LatencyHistograms::kNumBuckets - 1);
+  EXPECT_EQ(LatencyHistograms::BucketIndex(uint64_t{1} << 40), LatencyHistograms::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramsTest, Percentiles) {
+  LatencyHistograms histograms(2);
+  for (uint64_t i = 1; i <= 1000; ++i) {
+    histograms.Record(1, i * 1000);
+  }
+
+  const auto empty = histograms.GetSnapshot(0);
+  EXPECT_EQ(empty.count, 0U);
+  EXPECT_EQ(empty.ValueAtPercentile(50), 0U);
+
+  const auto snapshot = histograms.GetSnapshot(1);
+  EXPECT_EQ(snapshot.count, 1000U);
+  EXPECT_EQ(snapshot.sum_ns, 500500U * 1000U);
+  for (double percentile : {1.0, 50.0, 90.0, 99.0, 100.0}) {
+    const double exact = percentile * 10 * 1000;
+    const double value = static_cast<double>(snapshot.ValueAtPercentile(percentile));
+    EXPECT_GE(value, exact) << "percentile " << percentile;
+    EXPECT_LE(value, exact * 1.25 + 1000) << "percentile " << percentile;
+  }
+  EXPECT_EQ(snapshot.CountAtMost(uint64_t{1} << 20), 1000U);
+  EXPECT_EQ(snapshot.CountAtMost(uint64_t{1} << 16), 65U);
+  EXPECT_EQ(snapshot.CountAtMost(57344), 57U);
+}
+
+TEST(LatencyHistogramsTest, ConcurrentRecording) {
+  LatencyHistograms histograms(1);
+  constexpr int num_threads = 8;
+  constexpr uint64_t num_values = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&histograms]() {
+      for (uint64_t i = 0; i < num_values; ++i) {
+        histograms.Record(0, 100);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto snapshot = histograms.GetSnapshot(0);
+  EXPECT_EQ(snapshot.count, num_threads * num_values);
+  EXPECT_EQ(snapshot.sum_ns, num_threads * num_values * 100);
+}
+
+TEST(LatencyHistogramsTest, Prometheus) {
+  LatencyHistograms histograms(1);
+  histograms.Record(0, 500);
+  histograms.Record(0, 3000);
+  // a value equal to a bound is counted in it
+  histograms.Record(0, 4096);
+
+  std::ostringstream out;
+  LatencyHistograms::WritePrometheus(out, "latency_seconds", "node=\"a\"", histograms.GetSnapshot(0));
+  const std::string text = out.str();
+  EXPECT_NE(text.find("latency_seconds_bucket{node=\"a\",le=\"1.024e-06\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("latency_seconds_bucket{node=\"a\",le=\"2.048e-06\"} 1\n"), std::string::npos);
+  EXPECT_NE(text.find("latency_seconds_bucket{node=\"a\",le=\"4.096e-06\"} 3\n"), std::string::npos);
+  EXPECT_NE(text.find("latency_seconds_bucket{node=\"a\",le=\"+Inf\"} 3\n"), std::string::npos);
+  EXPECT_NE(text.find("latency_seconds_sum{node=\"a\"} 7.596e-06\n"), std::string::npos);
+  EXPECT_NE(text.find("latency_seconds_count{node=\"a\"} 3\n"), std::string::npos);
+
+  EXPECT_EQ(LatencyHistograms::EscapeLabelValue("a\"b\\c\nd"), "a\\\"b\\\\c\\nd");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
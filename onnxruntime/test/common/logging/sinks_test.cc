@@ -1,12 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <sstream>
+#include <thread>
+
 #include "core/common/logging/capture.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/sinks/cerr_sink.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/logging/sinks/composite_sink.h"
 #include "core/common/logging/sinks/file_sink.h"
+#include "core/common/logging/sinks/ring_buffer_sink.h"
 
 #include "test/common/logging/helpers.h"
 
@@ -137,6 +141,36 @@ TEST(LoggingTests, TestFileSink) {
   CheckStringInFile(filename, message);
   DeleteFile(filename);
 }
+/// <summary>
+/// Tests that the ring_buffer_sink keeps the last messages of each thread.
+/// </summary>
+TEST(LoggingTests, TestRingBufferSink) {
+  const std::string logid{"RingBufferSink"};
+  const Severity min_log_level = Severity::kVERBOSE;
+
+  RingBufferSink* sink = new RingBufferSink(2);
+  LoggingManager manager{std::unique_ptr<ISink>{sink}, min_log_level, false, InstanceType::Temporal};
+  auto logger = manager.CreateLogger(logid, min_log_level, false);
+
+  const auto log_messages = [&logger](const std::string& prefix) {
+    for (int i = 0; i < 3; ++i) {
+      LOGS(*logger, VERBOSE) << prefix << " message " << i;
+    }
+  };
+  log_messages("main");
+  std::thread other_thread(log_messages, "other");
+  other_thread.join();
+
+  EXPECT_EQ(sink->Size(), 4u);
+  std::ostringstream dump;
+  sink->Dump(dump);
+  const std::string output = dump.str();
+  for (const char* kept : {"main message 1", "main message 2", "other message 1", "other message 2"}) {
+    EXPECT_NE(output.find(kept), std::string::npos) << kept;
+  }
+  EXPECT_EQ(output.find("message 0"), std::string::npos);
+  EXPECT_NE(output.find("[V:onnxruntime:" + logid), std::string::npos);
+}
 // TODO: fix the warnings
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(disable : 26400)
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/platform/env_var_utils.h"
+#include "core/session/onnxruntime_run_options_config_keys.h"
 #include "gtest/gtest.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
@@ -568,6 +569,63 @@ TEST(AttentionTest, AttentionBatch2) {
                    batch_size, sequence_length, hidden_size, number_of_heads);
 }
 
+// The CPU kernel computes the attention probs of fewer batches at a time when they do not fit in the memory budget
+// of the run, and the run fails when the kernel must not do so or nothing fits.
+TEST(AttentionTest, AttentionBatch2RunMemoryBudget) {
+  constexpr int64_t batch_size = 2;
+  constexpr int64_t sequence_length = 2;
+  constexpr int64_t hidden_size = 4;
+
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f,
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f};
+
+  std::vector<float> weight_data = {
+      0.1f, -0.2f, 0.3f, 1.0f, 1.1f, 0.3f, 0.5f, 0.2f, 0.3f, -0.6f, 1.5f, 2.0f,
+      0.5f, 0.1f, 0.4f, 1.6f, 1.0f, 2.0f, 0.4f, 0.8f, 0.9f, 0.1f, -1.3f, 0.7f,
+      0.3f, 0.2f, 4.0f, 2.2f, 1.6f, 1.1f, 0.7f, 0.2f, 0.4f, 1.0f, 1.2f, 0.5f,
+      0.2f, 0.1f, 0.4f, 1.6f, 2.4f, 3.3f, 2.1f, 4.2f, 8.4f, 0.0f, 2.1f, 3.2f};
+
+  std::vector<float> bias_data = {
+      -0.5f, 0.6f, 1.2f, 2.1f, 0.5f, 0.7f, 0.2f, 1.2f, 0.5f, 0.4f, 0.3f, 1.2f};
+
+  std::vector<int32_t> mask_index_data = {2L, 2L};
+
+  std::vector<float> output_data = {
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f,
+      3.1495983600616455f, 0.10843668878078461f, 4.25f, 5.6499996185302734f,
+      3.9696791172027588f, 0.073143675923347473f, 4.2499995231628418f, 5.6499991416931152f};
+
+  // The run allocates the output (64 bytes), the projected QKV (192 bytes) and the mask (32 bytes) before the
+  // attention probs and the temporary output, 64 bytes per batch. 360 bytes fit one batch at a time.
+  auto run = [&](const char* budget, const char* allow_chunking, OpTester::ExpectResult expect_result,
+                 const std::string& expected_failure) {
+    OpTester tester("Attention", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("num_heads", 2);
+    tester.AddInput<float>("input", {batch_size, sequence_length, hidden_size}, input_data);
+    tester.AddInput<float>("weight", {hidden_size, 3 * hidden_size}, weight_data);
+    tester.AddInput<float>("bias", {3 * hidden_size}, bias_data);
+    tester.AddInput<int32_t>("mask_index", {batch_size}, mask_index_data);
+    tester.AddOutput<float>("output", {batch_size, sequence_length, hidden_size}, output_data);
+
+    RunOptions run_options;
+    ORT_THROW_IF_ERROR(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigMemoryBudgetBytes, budget));
+    ORT_THROW_IF_ERROR(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigMemoryBudgetAllowChunking,
+                                                                 allow_chunking));
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(expect_result, expected_failure, {}, &run_options, &execution_providers);
+  };
+
+  run("4096", "1", OpTester::ExpectResult::kExpectSuccess, "");
+  run("360", "1", OpTester::ExpectResult::kExpectSuccess, "");
+  run("360", "0", OpTester::ExpectResult::kExpectFailure, "Run memory budget of 360 bytes exceeded");
+  run("300", "1", OpTester::ExpectResult::kExpectFailure, "Run memory budget of 300 bytes exceeded");
+}
+
 TEST(AttentionTest, AttentionMaskPartialSequence) {
   int batch_size = 1;
   int sequence_length = 2;
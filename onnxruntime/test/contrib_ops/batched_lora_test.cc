@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::vector<float> MakeValues(size_t count, float scale) {
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = scale * static_cast<float>(static_cast<int>(i % 7) - 3);
+  }
+  return values;
+}
+
+void RunBatchedLoRATest(const std::vector<int32_t>& adapter_ids, bool with_base, float scaling) {
+  constexpr int64_t sequence_length = 3, hidden_size = 5, lora_rank = 2, output_size = 4, num_adapters = 2;
+  const int64_t batch_size = static_cast<int64_t>(adapter_ids.size());
+  const int64_t rows = batch_size * sequence_length;
+
+  const auto input = MakeValues(static_cast<size_t>(rows * hidden_size), 0.25f);
+  const auto lora_a = MakeValues(static_cast<size_t>(num_adapters * hidden_size * lora_rank), 0.5f);
+  const auto lora_b = MakeValues(static_cast<size_t>(num_adapters * lora_rank * output_size), 0.125f);
+  const auto base = with_base ? MakeValues(static_cast<size_t>(rows * output_size), 1.0f)
+                              : std::vector<float>(static_cast<size_t>(rows * output_size), 0.0f);
+
+  // reference: y = base + scaling * (x * A[id]) * B[id] for the entries with an adapter
+  std::vector<float> expected = base;
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const int64_t id = adapter_ids[static_cast<size_t>(b)];
+    if (id < 0) {
+      continue;
+    }
+    for (int64_t s = 0; s < sequence_length; ++s) {
+      const int64_t row = b * sequence_length + s;
+      std::vector<float> down(lora_rank, 0.0f);
+      for (int64_t r = 0; r < lora_rank; ++r) {
+        for (int64_t k = 0; k < hidden_size; ++k) {
+          down[r] += input[row * hidden_size + k] * lora_a[(id * hidden_size + k) * lora_rank + r];
+        }
+      }
+      for (int64_t n = 0; n < output_size; ++n) {
+        float sum = 0.0f;
+        for (int64_t r = 0; r < lora_rank; ++r) {
+          sum += down[r] * lora_b[(id * lora_rank + r) * output_size + n];
+        }
+        expected[row * output_size + n] += scaling * sum;
+      }
+    }
+  }
+
+  OpTester test("BatchedLoRA", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<float>("scaling", scaling);
+  test.AddInput<float>("input", {batch_size, sequence_length, hidden_size}, input);
+  test.AddInput<float>("lora_A", {num_adapters, hidden_size, lora_rank}, lora_a);
+  test.AddInput<float>("lora_B", {num_adapters, lora_rank, output_size}, lora_b);
+  test.AddInput<int32_t>("adapter_ids", {batch_size}, adapter_ids);
+  if (with_base) {
+    test.AddInput<float>("base", {batch_size, sequence_length, output_size}, base);
+  } else {
+    test.AddOptionalInputEdge<float>();
+  }
+  test.AddOutput<float>("output", {batch_size, sequence_length, output_size}, expected);
+  test.SetOutputAbsErr("output", 1e-4f);
+  test.Run();
+}
+}  // namespace
+
+TEST(BatchedLoRATest, MixedAdapters) {
+  RunBatchedLoRATest({1, -1, 1, 0}, false, 1.0f);
+}
+
+TEST(BatchedLoRATest, MixedAdaptersWithBase) {
+  RunBatchedLoRATest({0, 0, -1, 1, 1}, true, 0.5f);
+}
+
+TEST(BatchedLoRATest, NoAdapter) {
+  RunBatchedLoRATest({-1, -1}, true, 2.0f);
+}
+
+TEST(BatchedLoRATest, InvalidAdapterId) {
+  OpTester test("BatchedLoRA", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("input", {1, 1, 2}, {1.0f, 2.0f});
+  test.AddInput<float>("lora_A", {1, 2, 1}, {1.0f, 1.0f});
+  test.AddInput<float>("lora_B", {1, 1, 2}, {1.0f, 1.0f});
+  test.AddInput<int32_t>("adapter_ids", {1}, {1});
+  test.AddOutput<float>("output", {1, 1, 2}, {0.0f, 0.0f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "adapter id 1 is out of range");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -4,6 +4,7 @@
 #include "core/common/span_utils.h"
 #include "core/framework/tensor.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "test/framework/test_utils.h"
 #include "test/optimizer/graph_transform_test_builder.h"
@@ -203,6 +204,70 @@ TEST(DynamicQuantizeMatMul, HasZeroPoint_HasBias_test_U8) {
   RunDynamicQuantizeMatMulTest<uint8_t, true, true>();
 }
 
+template <typename T>
+void TestDynamicQuantizeMatMulPerRow() {
+  RandomValueGenerator random{1668426375};
+
+  constexpr int64_t M = 4;
+  constexpr int64_t N = 32;
+  constexpr int64_t K = 64;
+  std::vector<float> A_data = random.Uniform<float>(AsSpan({M, K}), -1.0f, 1.0f);
+  // rows of very different magnitudes, which one scale for the whole tensor would mostly round to zero
+  const float row_magnitudes[M] = {1.0f, 0.001f, 20.0f, 0.05f};
+  for (int64_t m = 0; m < M; m++) {
+    std::for_each(A_data.begin() + m * K, A_data.begin() + (m + 1) * K, [&](float& v) { v *= row_magnitudes[m]; });
+  }
+  std::vector<T> B_data = random.Uniform<T>(AsSpan({K, N}),
+                                            std::numeric_limits<T>::lowest() / 2, std::numeric_limits<T>::max() / 2);
+  std::vector<float> B_scale = random.Uniform<float>(AsSpan({N}), 0.01f, 0.1f);
+  std::vector<T> B_zero_point = random.Uniform<T>(AsSpan({N}), std::numeric_limits<T>::lowest() / 4,
+                                                  std::numeric_limits<T>::max() / 4);
+  std::vector<float> Bias = random.Uniform<float>(AsSpan({N}), -0.1f, 0.1f);
+
+  // each row is quantized symmetrically with its own scale
+  std::vector<float> Y_data(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    float abs_max = 0.0f;
+    for (int64_t k = 0; k < K; k++) {
+      abs_max = std::max(abs_max, std::abs(A_data[m * K + k]));
+    }
+    const float a_scale = abs_max / 127.0f;
+    for (int64_t n = 0; n < N; n++) {
+      float sum = Bias[n];
+      for (int64_t k = 0; k < K; k++) {
+        const float a_dequantized = std::clamp(std::nearbyint(A_data[m * K + k] / a_scale), -128.0f, 127.0f) * a_scale;
+        const float b_dequantized =
+            (static_cast<int>(B_data[k * N + n]) - static_cast<int>(B_zero_point[n])) * B_scale[n];
+        sum += a_dequantized * b_dequantized;
+      }
+      Y_data[m * N + n] = sum;
+    }
+  }
+
+  OpTester test("DynamicQuantizeMatMul", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("A", {M, K}, A_data);
+  test.AddInput<T>("B", {K, N}, B_data, true);
+  test.AddInput<float>("b_scale", {N}, B_scale);
+  test.AddInput<T>("b_zero_point", {N}, B_zero_point);
+  test.AddInput<float>("bias", {N}, Bias);
+  test.AddOutput<float>("Y", {M, N}, Y_data);
+  test.SetOutputRelErr("Y", 0.02f);
+
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsDynamicQuantizeMatMulPerRow, "1"));
+  test.Config(so)
+      .ConfigEp(DefaultCpuExecutionProvider())
+      .RunWithConfig();
+}
+
+TEST(DynamicQuantizeMatMul, PerRow_S8) {
+  TestDynamicQuantizeMatMulPerRow<int8_t>();
+}
+
+TEST(DynamicQuantizeMatMul, PerRow_U8) {
+  TestDynamicQuantizeMatMulPerRow<uint8_t>();
+}
+
 TEST(DynamicQuantizeMatMul, UInt8_test_with_empty_input) {
   std::vector<int64_t> A_dims{0, 2};
   std::vector<int64_t> B_dims{2, 2};
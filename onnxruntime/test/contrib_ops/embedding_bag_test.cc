@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+constexpr int64_t kNumEmbeddings = 6, kDim = 3;
+
+std::vector<float> MakeTable() {
+  std::vector<float> table(kNumEmbeddings * kDim);
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = 0.5f * static_cast<float>(static_cast<int>(i % 5) - 2);
+  }
+  return table;
+}
+
+// reference: the rows of each bag [bag_begins[b], bag_begins[b + 1]) reduced by mode, zeros for an empty bag
+std::vector<float> ReferenceEmbeddingBag(const std::vector<float>& table, const std::vector<int64_t>& indices,
+                                         const std::vector<int64_t>& bag_begins, const std::string& mode,
+                                         const std::vector<float>& weights) {
+  const size_t batch_size = bag_begins.size() - 1;
+  std::vector<float> output(batch_size * kDim, 0.0f);
+  for (size_t b = 0; b < batch_size; ++b) {
+    const int64_t begin = bag_begins[b], end = bag_begins[b + 1];
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t row = indices[i] < 0 ? indices[i] + kNumEmbeddings : indices[i];
+      for (int64_t d = 0; d < kDim; ++d) {
+        const float value = table[row * kDim + d];
+        float& out = output[b * kDim + d];
+        if (mode == "max") {
+          out = i == begin ? value : std::max(out, value);
+        } else {
+          out += (weights.empty() ? 1.0f : weights[i]) * value;
+        }
+      }
+    }
+    if (mode == "mean" && end > begin) {
+      for (int64_t d = 0; d < kDim; ++d) {
+        output[b * kDim + d] /= static_cast<float>(end - begin);
+      }
+    }
+  }
+  return output;
+}
+}  // namespace
+
+TEST(EmbeddingBagTest, SumWithOffsetsAndWeights) {
+  const auto table = MakeTable();
+  const std::vector<int64_t> indices{0, 5, 2, 2, 1, 4, 3};
+  const std::vector<int64_t> offsets{0, 2, 2, 5};
+  const std::vector<float> weights{1.0f, 0.5f, 2.0f, -1.0f, 0.25f, 1.5f, 3.0f};
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "sum");
+  test.AddInput<float>("table", {kNumEmbeddings, kDim}, table);
+  test.AddInput<int64_t>("indices", {7}, indices);
+  test.AddInput<int64_t>("offsets", {4}, offsets);
+  test.AddInput<float>("per_sample_weights", {7}, weights);
+  test.AddOutput<float>("output", {4, kDim}, ReferenceEmbeddingBag(table, indices, {0, 2, 2, 5, 7}, "sum", weights));
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, MeanAndMax2DIndices) {
+  const auto table = MakeTable();
+  const std::vector<int32_t> indices{0, -1, 2, 3, 3, -6, 1, 4};
+  const std::vector<int64_t> indices64(indices.begin(), indices.end());
+
+  for (const char* mode : {"mean", "max"}) {
+    OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<std::string>("mode", mode);
+    test.AddInput<float>("table", {kNumEmbeddings, kDim}, table);
+    test.AddInput<int32_t>("indices", {2, 4}, indices);
+    test.AddOutput<float>("output", {2, kDim}, ReferenceEmbeddingBag(table, indices64, {0, 4, 8}, mode, {}));
+    test.Run();
+  }
+}
+
+TEST(EmbeddingBagTest, Float16Table) {
+  const auto table = MakeTable();
+  const std::vector<int64_t> indices{1, 2, 5, 0};
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<MLFloat16>("table", {kNumEmbeddings, kDim}, ToFloat16(table));
+  test.AddInput<int64_t>("indices", {2, 2}, indices);
+  test.AddOutput<MLFloat16>("output", {2, kDim},
+                            ToFloat16(ReferenceEmbeddingBag(table, indices, {0, 2, 4}, "sum", {})));
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, Int8TableWithScales) {
+  const std::vector<int8_t> quantized_table{1, -2, 3, 4, 5, -6, -7, 8, 9, 10, -11, 12, 13, 14, 15, -16, 17, 18};
+  const std::vector<float> scales{0.5f, 0.25f, 1.0f, 0.125f, 2.0f, 0.75f};
+  std::vector<float> table(quantized_table.size());
+  for (size_t i = 0; i < table.size(); ++i) {
+    table[i] = scales[i / kDim] * static_cast<float>(quantized_table[i]);
+  }
+  const std::vector<int64_t> indices{4, 1, 0, 5, 5};
+  const std::vector<int64_t> offsets{0, 3};
+
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("mode", "mean");
+  test.AddInput<int8_t>("table", {kNumEmbeddings, kDim}, quantized_table);
+  test.AddInput<int64_t>("indices", {5}, indices);
+  test.AddInput<int64_t>("offsets", {2}, offsets);
+  test.AddOptionalInputEdge<float>();
+  test.AddInput<float>("scales", {kNumEmbeddings}, scales);
+  test.AddOutput<float>("output", {2, kDim}, ReferenceEmbeddingBag(table, indices, {0, 3, 5}, "mean", {}));
+  test.Run();
+}
+
+TEST(EmbeddingBagTest, IndexOutOfRange) {
+  OpTester test("EmbeddingBag", 1, onnxruntime::kMSDomain);
+  test.AddInput<float>("table", {kNumEmbeddings, kDim}, MakeTable());
+  test.AddInput<int64_t>("indices", {1, 2}, {0, kNumEmbeddings});
+  test.AddOutput<float>("output", {1, kDim}, std::vector<float>(kDim));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "indices element out of data bounds");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
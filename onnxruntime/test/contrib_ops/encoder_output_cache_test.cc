@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "contrib_ops/cpu/transformers/encoder_output_cache.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::EncoderOutputCache;
+
+namespace {
+template <typename T>
+OrtValue MakeValue(const std::vector<int64_t>& dims, const std::vector<T>& data) {
+  static AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  OrtValue value;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<T>(), TensorShape(dims), allocator, value);
+  std::copy(data.begin(), data.end(), value.GetMutable<Tensor>()->MutableData<T>());
+  return value;
+}
+}  // namespace
+
+TEST(EncoderOutputCacheTest, FindsOutputsOfSameInputs) {
+  EncoderOutputCache cache(2);
+  const std::vector<OrtValue> feeds{MakeValue<int32_t>({1, 3}, {5, 6, 7}), MakeValue<int32_t>({1, 1}, {0})};
+  const std::vector<OrtValue> fetches{MakeValue<float>({1, 2}, {1.f, 2.f})};
+
+  std::vector<OrtValue> found;
+  EXPECT_FALSE(cache.Find(feeds, found));
+  cache.Add(feeds, fetches);
+
+  const std::vector<OrtValue> same_feeds{MakeValue<int32_t>({1, 3}, {5, 6, 7}), MakeValue<int32_t>({1, 1}, {0})};
+  ASSERT_TRUE(cache.Find(same_feeds, found));
+  ASSERT_EQ(found.size(), 1u);
+  // the outputs are shared, not copied
+  EXPECT_EQ(found[0].Get<Tensor>().DataRaw(), fetches[0].Get<Tensor>().DataRaw());
+
+  const std::vector<OrtValue> other_data{MakeValue<int32_t>({1, 3}, {5, 6, 8}), MakeValue<int32_t>({1, 1}, {0})};
+  EXPECT_FALSE(cache.Find(other_data, found));
+  const std::vector<OrtValue> other_shape{MakeValue<int32_t>({3, 1}, {5, 6, 7}), MakeValue<int32_t>({1, 1}, {0})};
+  EXPECT_FALSE(cache.Find(other_shape, found));
+}
+
+TEST(EncoderOutputCacheTest, EvictsLeastRecentlyUsed) {
+  EncoderOutputCache cache(2);
+  const std::vector<OrtValue> fetches{MakeValue<float>({1}, {1.f})};
+  const auto feeds = [](int32_t id) { return std::vector<OrtValue>{MakeValue<int32_t>({1}, {id})}; };
+
+  std::vector<OrtValue> found;
+  cache.Add(feeds(0), fetches);
+  cache.Add(feeds(1), fetches);
+  ASSERT_TRUE(cache.Find(feeds(0), found));  // 1 is now the least recently used
+  cache.Add(feeds(2), fetches);
+
+  EXPECT_TRUE(cache.Find(feeds(0), found));
+  EXPECT_FALSE(cache.Find(feeds(1), found));
+  EXPECT_TRUE(cache.Find(feeds(2), found));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FusedElementwiseTest, BinaryAndUnaryOps) {
+  // Y = Relu((X0 - X1) * X0)
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Sub", "Mul", "Relu"});
+  test.AddAttribute<std::vector<int64_t>>("op_inputs", {0, 1, 2, 0, 3, -1});
+  test.AddInput<float>("X0", {2, 3}, {1.f, -2.f, 3.f, -4.f, 5.f, 6.f});
+  test.AddInput<float>("X1", {2, 3}, {2.f, 1.f, 1.f, -1.f, 5.f, -1.f});
+  test.AddOutput<float>("Y", {2, 3}, {0.f, 6.f, 6.f, 12.f, 0.f, 42.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, nullptr);
+}
+
+TEST(FusedElementwiseTest, SingleElementInputs) {
+  // Y = Exp(X0 * (X1 + X2)) where X1 and X2 have a single element
+  const std::vector<float> x0{0.5f, -1.f, 2.f, 0.f};
+  std::vector<float> y;
+  for (float x : x0) {
+    y.push_back(std::exp(x * (1.5f + 0.5f)));
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Add", "Mul", "Exp"});
+  test.AddAttribute<std::vector<int64_t>>("op_inputs", {1, 2, 0, 3, 4, -1});
+  test.AddInput<float>("X0", {4}, x0);
+  test.AddInput<float>("X1", {1}, {1.5f});
+  test.AddInput<float>("X2", {}, {0.5f});
+  test.AddOutput<float>("Y", {4}, y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, nullptr);
+}
+
+TEST(FusedElementwiseTest, SingleElementFirstOperand) {
+  // Y = (X1 / X0) - X1 where X1 has a single element
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Div", "Sub"});
+  test.AddAttribute<std::vector<int64_t>>("op_inputs", {1, 0, 2, 1});
+  test.AddInput<float>("X0", {2, 2}, {1.f, 2.f, -4.f, 8.f});
+  test.AddInput<float>("X1", {1}, {8.f});
+  test.AddOutput<float>("Y", {2, 2}, {0.f, -4.f, -10.f, -7.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, nullptr);
+}
+
+TEST(FusedElementwiseTest, LargeInput) {
+  // cover several blocks, with a partial last block
+  constexpr int64_t size = 5000;
+  std::vector<float> x0(size);
+  std::vector<float> y(size);
+  for (int64_t i = 0; i < size; ++i) {
+    x0[i] = static_cast<float>(i % 17) - 8.f;
+    y[i] = std::abs(x0[i]) + 1.f;
+  }
+
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Abs", "Add"});
+  test.AddAttribute<std::vector<int64_t>>("op_inputs", {0, -1, 2, 1});
+  test.AddInput<float>("X0", {size}, x0);
+  test.AddInput<float>("X1", {1}, {1.f});
+  test.AddOutput<float>("Y", {size}, y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, nullptr);
+}
+
+TEST(FusedElementwiseTest, InvalidOpInput) {
+  // an operator can't read the result of a later operator
+  OpTester test("FusedElementwise", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::vector<std::string>>("ops", {"Neg", "Neg"});
+  test.AddAttribute<std::vector<int64_t>>("op_inputs", {2, -1, 1, -1});
+  test.AddInput<float>("X0", {2}, {1.f, 2.f});
+  test.AddOutput<float>("Y", {2}, {1.f, 2.f});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "Invalid input 2 of operator 0", {}, nullptr, nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
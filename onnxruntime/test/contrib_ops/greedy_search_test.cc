@@ -1,12 +1,19 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include <gsl/gsl>
+#include "core/graph/model.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/default_providers.h"
 
 #ifdef USE_CUDA
 #include "core/providers/cuda/cuda_provider_options.h"
@@ -17,6 +24,254 @@ extern std::unique_ptr<Ort::Env> ort_env;
 namespace onnxruntime {
 namespace test {
 
+namespace {
+constexpr int kToyVocabSize = 8;
+constexpr int kToyMaxPositions = 32;
+
+// Logit of the vocabulary index after the token at the position in the toy GPT decoder. The logits of a token are
+// distinct, the position shifts them enough to change the greedy choice at some positions, and the last token of
+// the vocabulary is never chosen.
+float ToyLogit(int token, int position, int vocab_index, float position_scale) {
+  if (vocab_index == kToyVocabSize - 1) {
+    return -1.0f;
+  }
+  return static_cast<float>((token * 7 + vocab_index * 3) % kToyVocabSize) / kToyVocabSize +
+         position_scale * static_cast<float>((position * 5 + vocab_index) % kToyVocabSize) / kToyVocabSize;
+}
+
+ONNX_NAMESPACE::TypeProto MakeTensorType(ONNX_NAMESPACE::TensorProto_DataType type,
+                                         const std::vector<std::string>& dim_params,
+                                         const std::vector<int64_t>& dim_values) {
+  ONNX_NAMESPACE::TypeProto type_proto;
+  type_proto.mutable_tensor_type()->set_elem_type(type);
+  auto* shape = type_proto.mutable_tensor_type()->mutable_shape();
+  for (size_t i = 0; i < dim_params.size(); ++i) {
+    if (dim_params[i].empty()) {
+      shape->add_dim()->set_dim_value(dim_values[i]);
+    } else {
+      shape->add_dim()->set_dim_param(dim_params[i]);
+    }
+  }
+  return type_proto;
+}
+
+// A GPT decoder subgraph with one layer of one head of size 1, whose logits are the ToyLogit of the input tokens at
+// their positions multiplied by logits_scale, and whose present state appends the input tokens to the past state.
+ONNX_NAMESPACE::GraphProto CreateToyGptDecoder(float position_scale, float logits_scale = 1.0f) {
+  using ONNX_NAMESPACE::TensorProto_DataType_FLOAT;
+  using ONNX_NAMESPACE::TensorProto_DataType_INT32;
+  onnxruntime::Model model("toy_gpt_decoder", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  const auto ids_type = MakeTensorType(TensorProto_DataType_INT32, {"batch", "seq"}, {0, 0});
+  const auto mask_type = MakeTensorType(TensorProto_DataType_INT32, {"batch", "total_seq"}, {0, 0});
+  const auto past_type = MakeTensorType(TensorProto_DataType_FLOAT, {"", "batch", "", "past_seq", ""},
+                                        {2, 0, 1, 0, 1});
+  const auto logits_type = MakeTensorType(TensorProto_DataType_FLOAT, {"batch", "seq", ""}, {0, 0, kToyVocabSize});
+  const auto present_type = MakeTensorType(TensorProto_DataType_FLOAT, {"", "batch", "", "total_seq", ""},
+                                           {2, 0, 1, 0, 1});
+  auto& input_ids = graph.GetOrCreateNodeArg("input_ids", &ids_type);
+  auto& position_ids = graph.GetOrCreateNodeArg("position_ids", &ids_type);
+  auto& attention_mask = graph.GetOrCreateNodeArg("attention_mask", &mask_type);
+  auto& past = graph.GetOrCreateNodeArg("past_0", &past_type);
+  auto& logits = graph.GetOrCreateNodeArg("logits", &logits_type);
+  auto& present = graph.GetOrCreateNodeArg("present_0", &present_type);
+
+  // token_logits[token, v] + position_logits[position, v] = ToyLogit(token, position, v) * logits_scale
+  ONNX_NAMESPACE::TensorProto token_logits;
+  token_logits.set_name("token_logits");
+  token_logits.set_data_type(TensorProto_DataType_FLOAT);
+  token_logits.add_dims(kToyVocabSize);
+  token_logits.add_dims(kToyVocabSize);
+  for (int token = 0; token < kToyVocabSize; ++token) {
+    for (int v = 0; v < kToyVocabSize; ++v) {
+      token_logits.add_float_data(ToyLogit(token, 0, v, 0.0f) * logits_scale);
+    }
+  }
+  ONNX_NAMESPACE::TensorProto position_logits;
+  position_logits.set_name("position_logits");
+  position_logits.set_data_type(TensorProto_DataType_FLOAT);
+  position_logits.add_dims(kToyMaxPositions);
+  position_logits.add_dims(kToyVocabSize);
+  for (int position = 0; position < kToyMaxPositions; ++position) {
+    for (int v = 0; v < kToyVocabSize; ++v) {
+      position_logits.add_float_data((ToyLogit(0, position, v, position_scale) - ToyLogit(0, 0, v, 0.0f)) *
+                                     logits_scale);
+    }
+  }
+  ONNX_NAMESPACE::TensorProto axes;
+  axes.set_name("axes");
+  axes.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  axes.add_dims(3);
+  for (int64_t axis : {0, 2, 4}) {
+    axes.add_int64_data(axis);
+  }
+  graph.AddInitializedTensor(token_logits);
+  graph.AddInitializedTensor(position_logits);
+  graph.AddInitializedTensor(axes);
+
+  auto& token_logits_arg = graph.GetOrCreateNodeArg("token_logits", nullptr);
+  auto& position_logits_arg = graph.GetOrCreateNodeArg("position_logits", nullptr);
+  auto& axes_arg = graph.GetOrCreateNodeArg("axes", nullptr);
+  auto& gathered_token_logits = graph.GetOrCreateNodeArg("gathered_token_logits", nullptr);
+  auto& gathered_position_logits = graph.GetOrCreateNodeArg("gathered_position_logits", nullptr);
+  graph.AddNode("gather_tokens", "Gather", "", {&token_logits_arg, &input_ids}, {&gathered_token_logits});
+  graph.AddNode("gather_positions", "Gather", "", {&position_logits_arg, &position_ids}, {&gathered_position_logits});
+  graph.AddNode("add_logits", "Add", "", {&gathered_token_logits, &gathered_position_logits}, {&logits});
+
+  // present_0 = Concat(past_0, [input_ids, input_ids] with shape (2, batch, 1, seq, 1)) on the sequence axis
+  auto& float_ids = graph.GetOrCreateNodeArg("float_ids", nullptr);
+  auto& unsqueezed_ids = graph.GetOrCreateNodeArg("unsqueezed_ids", nullptr);
+  auto& key_value = graph.GetOrCreateNodeArg("key_value", nullptr);
+  graph.AddNode("cast_ids", "Cast", "", {&input_ids}, {&float_ids})
+      .AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("unsqueeze_ids", "Unsqueeze", "", {&float_ids, &axes_arg}, {&unsqueezed_ids});
+  graph.AddNode("concat_key_value", "Concat", "", {&unsqueezed_ids, &unsqueezed_ids}, {&key_value})
+      .AddAttribute("axis", static_cast<int64_t>(0));
+  graph.AddNode("concat_past", "Concat", "", {&past, &key_value}, {&present})
+      .AddAttribute("axis", static_cast<int64_t>(3));
+
+  graph.SetInputs({&input_ids, &position_ids, &attention_mask, &past});
+  graph.SetOutputs({&logits, &present});
+  EXPECT_STATUS_OK(graph.Resolve());
+  return graph.ToGraphProto();
+}
+
+// Greedy search of the toy decoder after a prompt without padding. The token after eos_token_id and the following
+// ones are the pad_token_id.
+std::vector<int32_t> ToyGreedySearch(std::vector<int32_t> sequence, int max_length, int eos_token_id,
+                                     int pad_token_id, float position_scale) {
+  bool eos_meet = false;
+  while (static_cast<int>(sequence.size()) < max_length) {
+    if (eos_meet) {
+      sequence.push_back(pad_token_id);
+      continue;
+    }
+    const int position = static_cast<int>(sequence.size()) - 1;
+    int next_token = 0;
+    for (int v = 1; v < kToyVocabSize; ++v) {
+      if (ToyLogit(sequence.back(), position, v, position_scale) >
+          ToyLogit(sequence.back(), position, next_token, position_scale)) {
+        next_token = v;
+      }
+    }
+    eos_meet = next_token == eos_token_id;
+    sequence.push_back(eos_meet ? pad_token_id : next_token);
+  }
+  return sequence;
+}
+
+void RunToyGreedySearch(const std::vector<int32_t>& input_ids, int64_t batch_size, int max_length, int eos_token_id,
+                        float position_scale, const std::vector<int32_t>& expected_sequences,
+                        const ONNX_NAMESPACE::GraphProto* draft_decoder = nullptr,
+                        int64_t num_speculative_tokens = 4,
+                        OpTester::ExpectResult expect_result = OpTester::ExpectResult::kExpectSuccess,
+                        const std::string& expected_failure = "") {
+  OpTester tester("GreedySearch", 1, kMSDomain);
+  tester.AddAttribute<int64_t>("eos_token_id", eos_token_id);
+  tester.AddAttribute<int64_t>("pad_token_id", kToyVocabSize - 1);
+  tester.AddAttribute("decoder", CreateToyGptDecoder(position_scale));
+  if (draft_decoder != nullptr) {
+    tester.AddAttribute("draft_decoder", *draft_decoder);
+    tester.AddAttribute<int64_t>("num_speculative_tokens", num_speculative_tokens);
+  }
+  const int64_t prompt_length = static_cast<int64_t>(input_ids.size()) / batch_size;
+  tester.AddInput<int32_t>("input_ids", {batch_size, prompt_length}, input_ids);
+  tester.AddInput<int32_t>("max_length", {1}, {max_length});
+  tester.AddOutput<int32_t>("sequences", {batch_size, max_length}, expected_sequences);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(expect_result, expected_failure, {}, nullptr, &execution_providers);
+}
+}  // namespace
+
+// The tokens proposed by the draft decoder are only kept where the decoder makes the same greedy choice, so the
+// output is the one of greedy search, whether the draft decoder agrees with the decoder always, sometimes or never.
+TEST(GreedySearchTest, GptSpeculativeDecodingMatchesGreedySearch) {
+  constexpr float position_scale = 0.3f;
+  constexpr int max_length = 16;
+  const std::vector<int32_t> prompt{1, 2, 3};
+  // the last token is never generated, so the search goes on to max_length
+  const std::vector<int32_t> expected = ToyGreedySearch(prompt, max_length, kToyVocabSize - 1, kToyVocabSize - 1,
+                                                        position_scale);
+
+  for (float draft_position_scale : {position_scale, 0.0f, -0.3f}) {
+    const auto draft_decoder = CreateToyGptDecoder(draft_position_scale);
+    for (int64_t num_speculative_tokens : {1, 3, 20}) {
+      SCOPED_TRACE("draft position scale " + std::to_string(draft_position_scale) + ", " +
+                   std::to_string(num_speculative_tokens) + " speculative tokens");
+      RunToyGreedySearch(prompt, 1, max_length, kToyVocabSize - 1, position_scale, expected, &draft_decoder,
+                         num_speculative_tokens);
+    }
+  }
+}
+
+// The generation stops at the eos token even when it is proposed with other tokens after it.
+TEST(GreedySearchTest, GptSpeculativeDecodingStopsAtEos) {
+  constexpr float position_scale = 0.3f;
+  constexpr int max_length = 16;
+  const std::vector<int32_t> prompt{4, 0};
+  const std::vector<int32_t> greedy = ToyGreedySearch(prompt, max_length, kToyVocabSize - 1, kToyVocabSize - 1,
+                                                      position_scale);
+  const int eos_token_id = greedy[prompt.size() + 5];
+  const std::vector<int32_t> expected = ToyGreedySearch(prompt, max_length, eos_token_id, kToyVocabSize - 1,
+                                                        position_scale);
+  ASSERT_EQ(expected.back(), kToyVocabSize - 1);
+
+  const auto draft_decoder = CreateToyGptDecoder(0.0f);
+  RunToyGreedySearch(prompt, 1, max_length, eos_token_id, position_scale, expected, &draft_decoder, 4);
+}
+
+TEST(GreedySearchTest, GptSpeculativeDecodingRejectsBatches) {
+  const auto draft_decoder = CreateToyGptDecoder(0.0f);
+  RunToyGreedySearch({1, 2, 3, 4}, 2, 8, kToyVocabSize - 1, 0.3f, std::vector<int32_t>(16, 0), &draft_decoder, 4,
+                     OpTester::ExpectResult::kExpectFailure, "Speculative decoding only supports batch_size of 1");
+}
+
+// The rows that met the eos token are dropped from the decoder inputs while the others go on, which gives the same
+// sequences as running all the rows: here the first row finishes first, then the last one, and the middle one never.
+TEST(GreedySearchTest, GptEvictFinishedSequences) {
+  constexpr float position_scale = 0.3f;
+  constexpr int max_length = 12;
+  constexpr int eos_token_id = 6;
+  constexpr int pad_token_id = kToyVocabSize - 1;
+  const std::vector<std::vector<int32_t>> prompts{{6, 3}, {5, 5}, {4, 0}};
+
+  std::vector<int32_t> input_ids;
+  std::vector<int32_t> expected;
+  std::vector<size_t> eos_positions;
+  for (const auto& prompt : prompts) {
+    input_ids.insert(input_ids.end(), prompt.begin(), prompt.end());
+    const auto sequence = ToyGreedySearch(prompt, max_length, eos_token_id, pad_token_id, position_scale);
+    expected.insert(expected.end(), sequence.begin(), sequence.end());
+    eos_positions.push_back(std::find(sequence.begin() + prompt.size(), sequence.end(), pad_token_id) -
+                            sequence.begin());
+  }
+  ASSERT_LT(eos_positions[0], eos_positions[2]);
+  ASSERT_LT(eos_positions[2], static_cast<size_t>(max_length));
+  ASSERT_EQ(eos_positions[1], static_cast<size_t>(max_length));
+
+  const int64_t batch_size = static_cast<int64_t>(prompts.size());
+  for (const char* op_type : {"GreedySearch", "Sampling"}) {
+    SCOPED_TRACE(op_type);
+    OpTester tester(op_type, 1, kMSDomain);
+    tester.AddAttribute<int64_t>("eos_token_id", eos_token_id);
+    tester.AddAttribute<int64_t>("pad_token_id", pad_token_id);
+    // the logits are scaled so that sampling always picks the greedy choice
+    tester.AddAttribute("decoder", CreateToyGptDecoder(position_scale, 1000.0f));
+    tester.AddInput<int32_t>("input_ids", {batch_size, 2}, input_ids);
+    tester.AddInput<int32_t>("max_length", {1}, {max_length});
+    tester.AddOutput<int32_t>("sequences", {batch_size, max_length}, expected);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
 TEST(GreedySearchTest, GptGreedySearchFp16_VocabPadded) {
   std::vector<int64_t> input_ids_shape{2, 4};
   std::vector<int32_t> input_ids{
@@ -0,0 +1,542 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Symmetric per token quantization of the kv cache, as done by the kernel.
+void QuantizeToken(const float* x, int head_size, int8_t* quantized, float& scale) {
+  float max_abs = 0.0f;
+  for (int h = 0; h < head_size; h++) {
+    max_abs = std::max(max_abs, std::abs(x[h]));
+  }
+  scale = max_abs / 127.0f;
+  for (int h = 0; h < head_size; h++) {
+    quantized[h] = max_abs > 0.0f ? static_cast<int8_t>(std::nearbyint(x[h] * 127.0f / max_abs)) : 0;
+  }
+}
+
+// Attention of a head over the given keys and values of head_size, each row of the query with its attended tokens.
+std::vector<float> ReferenceAttention(const std::vector<float>& query, const std::vector<float>& keys,
+                                      const std::vector<float>& values, const std::vector<std::vector<int>>& tokens,
+                                      int head_size) {
+  std::vector<float> output(query.size(), 0.0f);
+  for (size_t s = 0; s < tokens.size(); s++) {
+    std::vector<float> probs;
+    for (int t : tokens[s]) {
+      float dot = 0.0f;
+      for (int h = 0; h < head_size; h++) {
+        dot += query[s * head_size + h] * keys[t * head_size + h];
+      }
+      probs.push_back(dot / std::sqrt(static_cast<float>(head_size)));
+    }
+    const float max_prob = *std::max_element(probs.begin(), probs.end());
+    float sum = 0.0f;
+    for (float& p : probs) {
+      p = std::exp(p - max_prob);
+      sum += p;
+    }
+    for (size_t i = 0; i < probs.size(); i++) {
+      for (int h = 0; h < head_size; h++) {
+        output[s * head_size + h] += probs[i] / sum * values[tokens[s][i] * head_size + h];
+      }
+    }
+  }
+  return output;
+}
+
+// Rotary embedding of the first rotary_dim values of each head_size row of x at the positions 0, 1, ...
+std::vector<float> ReferenceRotary(const std::vector<float>& x, const std::vector<float>& cos_cache,
+                                   const std::vector<float>& sin_cache, int head_size, int rotary_dim,
+                                   bool interleaved) {
+  std::vector<float> rotated(x);
+  const int half = rotary_dim / 2;
+  for (size_t s = 0; s < x.size() / head_size; s++) {
+    for (int i = 0; i < half; i++) {
+      const size_t x_index = s * head_size + (interleaved ? 2 * i : i);
+      const size_t y_index = s * head_size + (interleaved ? 2 * i + 1 : half + i);
+      const float cos = cos_cache[s * half + i];
+      const float sin = sin_cache[s * half + i];
+      rotated[x_index] = x[x_index] * cos - x[y_index] * sin;
+      rotated[y_index] = x[y_index] * cos + x[x_index] * sin;
+    }
+  }
+  return rotated;
+}
+
+// A prompt with N = 2 heads sharing N_kv = 1 kv head and rotary over half of the head, packed QKV or not.
+void RunRotaryPrompt(bool packed_qkv, bool interleaved) {
+  constexpr int num_heads = 2;
+  constexpr int head_size = 32;
+  constexpr int rotary_dim = 16;
+  constexpr int sequence_length = 3;
+
+  std::vector<float> cos_cache;
+  std::vector<float> sin_cache;
+  for (int s = 0; s < sequence_length; s++) {
+    for (int i = 0; i < rotary_dim / 2; i++) {
+      const float angle = static_cast<float>(s) * std::pow(100.0f, -static_cast<float>(i) / (rotary_dim / 2));
+      cos_cache.push_back(std::cos(angle));
+      sin_cache.push_back(std::sin(angle));
+    }
+  }
+
+  // the heads of each token, each head in (S, H)
+  const auto make_head = [](int seed) {
+    std::vector<float> head(sequence_length * head_size);
+    for (size_t i = 0; i < head.size(); i++) {
+      head[i] = static_cast<float>((static_cast<int>(i) * 7 + seed * 13) % 17 - 8) / 8.0f;
+    }
+    return head;
+  };
+  const std::vector<std::vector<float>> query_heads{make_head(0), make_head(1)};
+  const std::vector<float> key = make_head(2);
+  const std::vector<float> value = make_head(3);
+
+  const std::vector<float> present_key = ReferenceRotary(key, cos_cache, sin_cache, head_size, rotary_dim, interleaved);
+  std::vector<float> output(sequence_length * num_heads * head_size);
+  std::vector<float> query(sequence_length * num_heads * head_size);
+  for (int n = 0; n < num_heads; n++) {
+    const std::vector<float> rotated = ReferenceRotary(query_heads[n], cos_cache, sin_cache, head_size, rotary_dim,
+                                                       interleaved);
+    const std::vector<float> head_output = ReferenceAttention(rotated, present_key, value, {{0}, {0, 1}, {0, 1, 2}},
+                                                              head_size);
+    for (int s = 0; s < sequence_length; s++) {
+      std::copy_n(query_heads[n].begin() + s * head_size, head_size, query.begin() + (s * num_heads + n) * head_size);
+      std::copy_n(head_output.begin() + s * head_size, head_size, output.begin() + (s * num_heads + n) * head_size);
+    }
+  }
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", num_heads);
+  tester.AddAttribute<int64_t>("kv_num_heads", 1);
+  tester.AddAttribute<int64_t>("do_rotary", 1);
+  tester.AddAttribute<int64_t>("rotary_interleaved", interleaved ? 1 : 0);
+  if (packed_qkv) {
+    std::vector<float> packed;
+    for (int s = 0; s < sequence_length; s++) {
+      packed.insert(packed.end(), query.begin() + s * num_heads * head_size,
+                    query.begin() + (s + 1) * num_heads * head_size);
+      packed.insert(packed.end(), key.begin() + s * head_size, key.begin() + (s + 1) * head_size);
+      packed.insert(packed.end(), value.begin() + s * head_size, value.begin() + (s + 1) * head_size);
+    }
+    tester.AddInput<float>("query", {1, sequence_length, (num_heads + 2) * head_size}, packed);
+    tester.AddOptionalInputEdge<float>();
+    tester.AddOptionalInputEdge<float>();
+  } else {
+    tester.AddInput<float>("query", {1, sequence_length, num_heads * head_size}, query);
+    tester.AddInput<float>("key", {1, sequence_length, head_size}, key);
+    tester.AddInput<float>("value", {1, sequence_length, head_size}, value);
+  }
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("seqlens_k", {1}, {sequence_length - 1});
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {sequence_length});
+  tester.AddInput<float>("cos_cache", {sequence_length, rotary_dim / 2}, cos_cache);
+  tester.AddInput<float>("sin_cache", {sequence_length, rotary_dim / 2}, sin_cache);
+
+  tester.AddOutput<float>("output", {1, sequence_length, num_heads * head_size}, output);
+  tester.AddOutput<float>("present_key", {1, 1, sequence_length, head_size}, present_key);
+  tester.AddOutput<float>("present_value", {1, 1, sequence_length, head_size}, value);
+  tester.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// Runs N = 2 heads sharing N_kv = 1 kv head over a paged kv cache of 6 blocks of 4 tokens, the block table mapping
+// token t of sequence b to block block_table[b][t / 4]. The new tokens follow the seqlens_k[b] past ones when
+// decoding, and start at 0 for a prompt.
+void RunPagedKVCache(int sequence_length, const std::vector<int32_t>& seqlens_k,
+                     const std::vector<int32_t>& block_table, const std::string& expected_failure = "") {
+  constexpr int num_heads = 2;
+  constexpr int head_size = 8;
+  constexpr int block_size = 4;
+  constexpr int num_blocks = 6;
+  const int batch_size = static_cast<int>(seqlens_k.size());
+  const int max_blocks_per_sequence = static_cast<int>(block_table.size()) / batch_size;
+  const bool is_prompt = sequence_length != 1;
+
+  const auto make_values = [](size_t size, int seed) {
+    std::vector<float> values(size);
+    for (size_t i = 0; i < size; i++) {
+      values[i] = static_cast<float>((static_cast<int>(i) * 7 + seed * 13) % 17 - 8) / 8.0f;
+    }
+    return values;
+  };
+  const std::vector<float> query = make_values(static_cast<size_t>(batch_size) * sequence_length * num_heads *
+                                                   head_size,
+                                               0);
+  const std::vector<float> key = make_values(static_cast<size_t>(batch_size) * sequence_length * head_size, 1);
+  const std::vector<float> value = make_values(key.size(), 2);
+  const std::vector<float> past_key = make_values(static_cast<size_t>(num_blocks) * block_size * head_size, 3);
+  const std::vector<float> past_value = make_values(past_key.size(), 4);
+
+  // the new tokens are written to their blocks, the other tokens of the pool are unchanged
+  std::vector<float> present_key(past_key);
+  std::vector<float> present_value(past_value);
+  const auto token_offset = [&](int b, int t) {
+    return (static_cast<size_t>(block_table[b * max_blocks_per_sequence + t / block_size]) * block_size +
+            t % block_size) *
+           head_size;
+  };
+  std::vector<float> output(query.size());
+  for (int b = 0; b < batch_size; b++) {
+    const int past_seqlen = is_prompt ? 0 : seqlens_k[b];
+    for (int s = 0; s < sequence_length; s++) {
+      const size_t input_offset = (static_cast<size_t>(b) * sequence_length + s) * head_size;
+      std::copy_n(key.begin() + input_offset, head_size, present_key.begin() + token_offset(b, past_seqlen + s));
+      std::copy_n(value.begin() + input_offset, head_size, present_value.begin() + token_offset(b, past_seqlen + s));
+    }
+
+    // attention over the tokens of the sequence, gathered from their blocks
+    std::vector<float> keys;
+    std::vector<float> values;
+    for (int t = 0; t < past_seqlen + sequence_length; t++) {
+      keys.insert(keys.end(), present_key.begin() + token_offset(b, t),
+                  present_key.begin() + token_offset(b, t) + head_size);
+      values.insert(values.end(), present_value.begin() + token_offset(b, t),
+                    present_value.begin() + token_offset(b, t) + head_size);
+    }
+    std::vector<std::vector<int>> tokens(sequence_length);
+    for (int s = 0; s < sequence_length; s++) {
+      for (int t = 0; t <= past_seqlen + s; t++) {
+        tokens[s].push_back(t);
+      }
+    }
+    for (int n = 0; n < num_heads; n++) {
+      std::vector<float> head_query(static_cast<size_t>(sequence_length) * head_size);
+      for (int s = 0; s < sequence_length; s++) {
+        std::copy_n(query.begin() + ((static_cast<size_t>(b) * sequence_length + s) * num_heads + n) * head_size,
+                    head_size, head_query.begin() + s * head_size);
+      }
+      const std::vector<float> head_output = ReferenceAttention(head_query, keys, values, tokens, head_size);
+      for (int s = 0; s < sequence_length; s++) {
+        std::copy_n(head_output.begin() + s * head_size, head_size,
+                    output.begin() + ((static_cast<size_t>(b) * sequence_length + s) * num_heads + n) * head_size);
+      }
+    }
+  }
+
+  int total_sequence_length = 0;
+  for (int32_t seqlen : seqlens_k) {
+    total_sequence_length = std::max(total_sequence_length, seqlen + 1);
+  }
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", num_heads);
+  tester.AddAttribute<int64_t>("kv_num_heads", 1);
+  tester.AddInput<float>("query", {batch_size, sequence_length, num_heads * head_size}, query);
+  tester.AddInput<float>("key", {batch_size, sequence_length, head_size}, key);
+  tester.AddInput<float>("value", {batch_size, sequence_length, head_size}, value);
+  tester.AddInput<float>("past_key", {num_blocks, 1, block_size, head_size}, past_key);
+  tester.AddInput<float>("past_value", {num_blocks, 1, block_size, head_size}, past_value);
+  tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {total_sequence_length});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("block_table", {batch_size, max_blocks_per_sequence}, block_table);
+
+  tester.AddOutput<float>("output", {batch_size, sequence_length, num_heads * head_size}, output);
+  tester.AddOutput<float>("present_key", {num_blocks, 1, block_size, head_size}, present_key);
+  tester.AddOutput<float>("present_value", {num_blocks, 1, block_size, head_size}, present_value);
+  tester.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(expected_failure.empty() ? OpTester::ExpectResult::kExpectSuccess
+                                      : OpTester::ExpectResult::kExpectFailure,
+             expected_failure, {}, nullptr, &execution_providers);
+}
+}  // namespace
+
+TEST(GroupQueryAttentionTest, RotaryPrompt) {
+  RunRotaryPrompt(false, false);
+  RunRotaryPrompt(false, true);
+}
+
+TEST(GroupQueryAttentionTest, RotaryPackedQKVPrompt) {
+  RunRotaryPrompt(true, false);
+  RunRotaryPrompt(true, true);
+}
+
+// Decoding a token with N = 2 heads sharing N_kv = 1 kv head over an int8 kv cache of 3 past tokens.
+TEST(GroupQueryAttentionTest, Int8KVCacheDecoding) {
+  constexpr int num_heads = 2;
+  constexpr int head_size = 4;
+  constexpr int past_seqlen = 3;
+  constexpr int total_seqlen = past_seqlen + 1;
+
+  const std::vector<float> query{0.5f, -1.0f, 0.25f, 2.0f, -0.75f, 1.5f, 1.0f, -0.5f};
+  const std::vector<float> key{1.0f, 0.5f, -2.0f, 0.25f};
+  const std::vector<float> value{-1.0f, 3.0f, 0.5f, 2.0f};
+  const std::vector<float> past_keys{0.1f, -0.4f, 0.3f, 0.8f, -1.2f, 0.6f, 0.9f, -0.3f, 0.7f, 0.2f, -0.5f, 1.1f};
+  const std::vector<float> past_values{2.0f, -1.0f, 0.5f, 0.0f, -0.5f, 1.5f, 1.0f, 0.25f, 1.0f, 1.0f, -2.0f, 0.5f};
+
+  std::vector<int8_t> present_key(total_seqlen * head_size);
+  std::vector<int8_t> present_value(total_seqlen * head_size);
+  std::vector<float> present_key_scale(total_seqlen);
+  std::vector<float> present_value_scale(total_seqlen);
+  for (int t = 0; t < past_seqlen; t++) {
+    QuantizeToken(past_keys.data() + t * head_size, head_size, present_key.data() + t * head_size,
+                  present_key_scale[t]);
+    QuantizeToken(past_values.data() + t * head_size, head_size, present_value.data() + t * head_size,
+                  present_value_scale[t]);
+  }
+  const std::vector<int8_t> past_key(present_key.begin(), present_key.begin() + past_seqlen * head_size);
+  const std::vector<int8_t> past_value(present_value.begin(), present_value.begin() + past_seqlen * head_size);
+  const std::vector<float> past_key_scale(present_key_scale.begin(), present_key_scale.begin() + past_seqlen);
+  const std::vector<float> past_value_scale(present_value_scale.begin(), present_value_scale.begin() + past_seqlen);
+  QuantizeToken(key.data(), head_size, present_key.data() + past_seqlen * head_size, present_key_scale[past_seqlen]);
+  QuantizeToken(value.data(), head_size, present_value.data() + past_seqlen * head_size,
+                present_value_scale[past_seqlen]);
+
+  // Attention over the dequantized cache.
+  std::vector<float> output(num_heads * head_size, 0.0f);
+  for (int n = 0; n < num_heads; n++) {
+    std::vector<float> probs(total_seqlen);
+    for (int t = 0; t < total_seqlen; t++) {
+      float dot = 0.0f;
+      for (int h = 0; h < head_size; h++) {
+        dot += query[n * head_size + h] * present_key_scale[t] * present_key[t * head_size + h];
+      }
+      probs[t] = dot / std::sqrt(static_cast<float>(head_size));
+    }
+    const float max_prob = *std::max_element(probs.begin(), probs.end());
+    float sum = 0.0f;
+    for (float& p : probs) {
+      p = std::exp(p - max_prob);
+      sum += p;
+    }
+    for (int t = 0; t < total_seqlen; t++) {
+      for (int h = 0; h < head_size; h++) {
+        output[n * head_size + h] +=
+            probs[t] / sum * present_value_scale[t] * present_value[t * head_size + h];
+      }
+    }
+  }
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", num_heads);
+  tester.AddAttribute<int64_t>("kv_num_heads", 1);
+  tester.AddInput<float>("query", {1, 1, num_heads * head_size}, query);
+  tester.AddInput<float>("key", {1, 1, head_size}, key);
+  tester.AddInput<float>("value", {1, 1, head_size}, value);
+  tester.AddInput<int8_t>("past_key", {1, 1, past_seqlen, head_size}, past_key);
+  tester.AddInput<int8_t>("past_value", {1, 1, past_seqlen, head_size}, past_value);
+  tester.AddInput<int32_t>("seqlens_k", {1}, {past_seqlen});
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {total_seqlen});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<float>("past_key_scale", {1, 1, past_seqlen}, past_key_scale);
+  tester.AddInput<float>("past_value_scale", {1, 1, past_seqlen}, past_value_scale);
+
+  tester.AddOutput<float>("output", {1, 1, num_heads * head_size}, output);
+  tester.AddOutput<int8_t>("present_key", {1, 1, total_seqlen, head_size}, present_key);
+  tester.AddOutput<int8_t>("present_value", {1, 1, total_seqlen, head_size}, present_value);
+  tester.AddOutput<float>("present_key_scale", {1, 1, total_seqlen}, present_key_scale);
+  tester.AddOutput<float>("present_value_scale", {1, 1, total_seqlen}, present_value_scale);
+  tester.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// A right padded prompt of S = 3 tokens in a batch of 2 with N = 2 heads sharing N_kv = 1 kv head over an int8 kv
+// cache, the second sequence holding only 2 tokens: its total sequence length is below the sequence length.
+TEST(GroupQueryAttentionTest, Int8KVCachePaddedBatchPrompt) {
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 2;
+  constexpr int head_size = 4;
+  constexpr int sequence_length = 3;
+  const std::vector<int32_t> seqlens_k{2, 1};
+
+  const std::vector<float> query{0.5f, -1.0f, 0.25f, 2.0f, -0.75f, 1.5f, 1.0f, -0.5f,
+                                 1.0f, 0.5f, -0.5f, 0.25f, -1.0f, -0.25f, 0.75f, 1.5f,
+                                 0.3f, 0.9f, -1.5f, 0.5f, 2.0f, -0.5f, 0.25f, 1.0f,
+                                 -0.25f, 1.25f, 0.5f, -1.0f, 0.75f, 0.5f, -2.0f, 0.1f,
+                                 1.5f, -0.5f, 0.6f, 0.2f, -0.4f, 1.0f, 0.3f, -0.8f,
+                                 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  const std::vector<float> key{0.1f, -0.4f, 0.3f, 0.8f, -1.2f, 0.6f, 0.9f, -0.3f, 0.7f, 0.2f, -0.5f, 1.1f,
+                               1.0f, 0.5f, -2.0f, 0.25f, -0.6f, 0.4f, 1.2f, -0.9f, 0.0f, 0.0f, 0.0f, 0.0f};
+  const std::vector<float> value{2.0f, -1.0f, 0.5f, 0.0f, -0.5f, 1.5f, 1.0f, 0.25f, 1.0f, 1.0f, -2.0f, 0.5f,
+                                 -1.0f, 3.0f, 0.5f, 2.0f, 0.8f, -0.2f, 1.4f, -0.6f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+  const size_t kv_chunk_length = static_cast<size_t>(sequence_length) * head_size;
+  std::vector<int8_t> present_key(batch_size * kv_chunk_length);
+  std::vector<int8_t> present_value(batch_size * kv_chunk_length);
+  std::vector<float> present_key_scale(batch_size * sequence_length);
+  std::vector<float> present_value_scale(batch_size * sequence_length);
+  std::vector<float> output(query.size());
+  for (int b = 0; b < batch_size; b++) {
+    std::vector<float> keys(kv_chunk_length);
+    std::vector<float> values(kv_chunk_length);
+    for (int t = 0; t < sequence_length; t++) {
+      const size_t token = b * sequence_length + t;
+      QuantizeToken(key.data() + token * head_size, head_size, present_key.data() + token * head_size,
+                    present_key_scale[token]);
+      QuantizeToken(value.data() + token * head_size, head_size, present_value.data() + token * head_size,
+                    present_value_scale[token]);
+      for (int h = 0; h < head_size; h++) {
+        keys[t * head_size + h] = present_key_scale[token] * present_key[token * head_size + h];
+        values[t * head_size + h] = present_value_scale[token] * present_value[token * head_size + h];
+      }
+    }
+    // the padding token of the second sequence attends causally like the others, its output being ignored
+    for (int n = 0; n < num_heads; n++) {
+      std::vector<float> head_query(kv_chunk_length);
+      for (int s = 0; s < sequence_length; s++) {
+        std::copy_n(query.data() + (b * sequence_length + s) * num_heads * head_size + n * head_size, head_size,
+                    head_query.data() + s * head_size);
+      }
+      const std::vector<float> head_output =
+          ReferenceAttention(head_query, keys, values, {{0}, {0, 1}, {0, 1, 2}}, head_size);
+      for (int s = 0; s < sequence_length; s++) {
+        std::copy_n(head_output.data() + s * head_size, head_size,
+                    output.data() + (b * sequence_length + s) * num_heads * head_size + n * head_size);
+      }
+    }
+  }
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", num_heads);
+  tester.AddAttribute<int64_t>("kv_num_heads", 1);
+  tester.AddInput<float>("query", {batch_size, sequence_length, num_heads * head_size}, query);
+  tester.AddInput<float>("key", {batch_size, sequence_length, head_size}, key);
+  tester.AddInput<float>("value", {batch_size, sequence_length, head_size}, value);
+  tester.AddInput<int8_t>("past_key", {batch_size, 1, 0, head_size}, {});
+  tester.AddInput<int8_t>("past_value", {batch_size, 1, 0, head_size}, {});
+  tester.AddInput<int32_t>("seqlens_k", {batch_size}, seqlens_k);
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {sequence_length});
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<int32_t>();
+  tester.AddInput<float>("past_key_scale", {batch_size, 1, 0}, {});
+  tester.AddInput<float>("past_value_scale", {batch_size, 1, 0}, {});
+
+  tester.AddOutput<float>("output", {batch_size, sequence_length, num_heads * head_size}, output);
+  tester.AddOutput<int8_t>("present_key", {batch_size, 1, sequence_length, head_size}, present_key);
+  tester.AddOutput<int8_t>("present_value", {batch_size, 1, sequence_length, head_size}, present_value);
+  tester.AddOutput<float>("present_key_scale", {batch_size, 1, sequence_length}, present_key_scale);
+  tester.AddOutput<float>("present_value_scale", {batch_size, 1, sequence_length}, present_value_scale);
+  tester.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// With 1 sink token and a local window of 1, the ring buffer kv cache holds 3 tokens: the sink in slot 0, and
+// the position p > 0 in slot 1 + (p - 1) % 2.
+TEST(GroupQueryAttentionTest, RingBufferKVCachePrompt) {
+  constexpr int head_size = 4;
+  constexpr int sequence_length = 4;
+  const std::vector<float> query{0.5f, -1.0f, 0.25f, 2.0f, -0.75f, 1.5f, 1.0f, -0.5f,
+                                 1.0f, 0.5f, -0.5f, 0.25f, -1.0f, -0.25f, 0.75f, 1.5f};
+  const std::vector<float> key{0.1f, -0.4f, 0.3f, 0.8f, -1.2f, 0.6f, 0.9f, -0.3f,
+                               0.7f, 0.2f, -0.5f, 1.1f, 1.0f, 0.5f, -2.0f, 0.25f};
+  const std::vector<float> value{2.0f, -1.0f, 0.5f, 0.0f, -0.5f, 1.5f, 1.0f, 0.25f,
+                                 1.0f, 1.0f, -2.0f, 0.5f, -1.0f, 3.0f, 0.5f, 2.0f};
+  // the last token attends to the sink and the window of the tokens 2 and 3, not to the token 1
+  const std::vector<float> output = ReferenceAttention(query, key, value, {{0}, {0, 1}, {0, 1, 2}, {0, 2, 3}},
+                                                       head_size);
+  std::vector<float> present_key(key.begin(), key.begin() + head_size);
+  present_key.insert(present_key.end(), key.begin() + 3 * head_size, key.end());
+  present_key.insert(present_key.end(), key.begin() + 2 * head_size, key.begin() + 3 * head_size);
+  std::vector<float> present_value(value.begin(), value.begin() + head_size);
+  present_value.insert(present_value.end(), value.begin() + 3 * head_size, value.end());
+  present_value.insert(present_value.end(), value.begin() + 2 * head_size, value.begin() + 3 * head_size);
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", 1);
+  tester.AddAttribute<int64_t>("kv_num_heads", 1);
+  tester.AddAttribute<int64_t>("local_window_size", 1);
+  tester.AddAttribute<int64_t>("num_sink_tokens", 1);
+  tester.AddInput<float>("query", {1, sequence_length, head_size}, query);
+  tester.AddInput<float>("key", {1, sequence_length, head_size}, key);
+  tester.AddInput<float>("value", {1, sequence_length, head_size}, value);
+  tester.AddOptionalInputEdge<float>();
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("seqlens_k", {1}, {sequence_length - 1});
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {sequence_length});
+
+  tester.AddOutput<float>("output", {1, sequence_length, head_size}, output);
+  tester.AddOutput<float>("present_key", {1, 1, 3, head_size}, present_key);
+  tester.AddOutput<float>("present_value", {1, 1, 3, head_size}, present_value);
+  tester.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(GroupQueryAttentionTest, RingBufferKVCacheDecoding) {
+  constexpr int head_size = 4;
+  // the cache after 5 tokens holds the sink, the token 3 in slot 1 and the token 4 in slot 2
+  const std::vector<float> past_key{0.1f, -0.4f, 0.3f, 0.8f, -1.2f, 0.6f, 0.9f, -0.3f, 0.7f, 0.2f, -0.5f, 1.1f};
+  const std::vector<float> past_value{2.0f, -1.0f, 0.5f, 0.0f, -0.5f, 1.5f, 1.0f, 0.25f, 1.0f, 1.0f, -2.0f, 0.5f};
+  const std::vector<float> query{0.5f, -1.0f, 0.25f, 2.0f};
+  const std::vector<float> key{1.0f, 0.5f, -2.0f, 0.25f};
+  const std::vector<float> value{-1.0f, 3.0f, 0.5f, 2.0f};
+
+  // the token 5 replaces the token 3 leaving the window in slot 1
+  std::vector<float> present_key(past_key);
+  std::copy(key.begin(), key.end(), present_key.begin() + head_size);
+  std::vector<float> present_value(past_value);
+  std::copy(value.begin(), value.end(), present_value.begin() + head_size);
+  const std::vector<float> output = ReferenceAttention(query, present_key, present_value, {{0, 1, 2}}, head_size);
+
+  OpTester tester("GroupQueryAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", 1);
+  tester.AddAttribute<int64_t>("kv_num_heads", 1);
+  tester.AddAttribute<int64_t>("local_window_size", 1);
+  tester.AddAttribute<int64_t>("num_sink_tokens", 1);
+  tester.AddInput<float>("query", {1, 1, head_size}, query);
+  tester.AddInput<float>("key", {1, 1, head_size}, key);
+  tester.AddInput<float>("value", {1, 1, head_size}, value);
+  tester.AddInput<float>("past_key", {1, 1, 3, head_size}, past_key);
+  tester.AddInput<float>("past_value", {1, 1, 3, head_size}, past_value);
+  tester.AddInput<int32_t>("seqlens_k", {1}, {5});
+  tester.AddInput<int32_t>("total_sequence_length", {1}, {6});
+
+  tester.AddOutput<float>("output", {1, 1, head_size}, output);
+  tester.AddOutput<float>("present_key", {1, 1, 3, head_size}, present_key);
+  tester.AddOutput<float>("present_value", {1, 1, 3, head_size}, present_value);
+  tester.SetOutputTolerance(1e-5f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+// A prompt written to blocks out of order, its last block partially filled.
+TEST(GroupQueryAttentionTest, PagedKVCachePrompt) {
+  RunPagedKVCache(6, {5}, {2, 4, 0});
+}
+
+// Decoding a token at the start of a block and one in the middle of a block, the other blocks being unchanged.
+TEST(GroupQueryAttentionTest, PagedKVCacheDecoding) {
+  RunPagedKVCache(1, {8, 5}, {3, 0, 5, 1, 4, 2});
+}
+
+TEST(GroupQueryAttentionTest, PagedKVCacheInvalidBlock) {
+  RunPagedKVCache(1, {8, 5}, {3, 0, 6, 1, 4, 2}, "which is not a block of the kv cache with 6 blocks");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "contrib_ops/cpu/transformers/logits_processor.h"
+#include "core/platform/env.h"
+#include "core/platform/threadpool.h"
+#include "core/util/thread_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+using contrib::transformers::ElementwiseLogitsProcessor;
+using contrib::transformers::NextTokenScores;
+
+namespace {
+// The scores of the separate vocabulary mask, temperature and presence penalty processors, applied in this order.
+std::vector<float> ReferenceElementwiseScores(std::vector<float> scores, int vocab_size,
+                                              const std::vector<int32_t>& vocab_mask, float temperature,
+                                              const std::vector<int32_t>& presence_mask, float presence_penalty) {
+  for (size_t i = 0; i < scores.size(); i++) {
+    if (!vocab_mask.empty() && vocab_mask[i % vocab_size] == 0) {
+      scores[i] = std::numeric_limits<float>::lowest();
+    }
+  }
+  if (temperature != 1.0f) {
+    for (auto& score : scores) {
+      score /= temperature;
+    }
+  }
+  if (!presence_mask.empty() && presence_penalty != 0.0f) {
+    for (size_t i = 0; i < scores.size(); i++) {
+      scores[i] -= presence_mask[i] * presence_penalty;
+    }
+  }
+  return scores;
+}
+
+void RunElementwiseLogitsProcessor(concurrency::ThreadPool* thread_pool, int batch_beam_size, int vocab_size,
+                                   bool use_vocab_mask, float temperature, bool use_presence_mask,
+                                   float presence_penalty) {
+  std::vector<float> scores(static_cast<size_t>(batch_beam_size) * vocab_size);
+  for (size_t i = 0; i < scores.size(); i++) {
+    scores[i] = static_cast<float>(static_cast<int>(i * 37 % 101) - 50) / 10.0f;
+  }
+  std::vector<int32_t> vocab_mask;
+  if (use_vocab_mask) {
+    for (int v = 0; v < vocab_size; v++) {
+      vocab_mask.push_back(v % 3 == 1 ? 0 : 1);
+    }
+  }
+  std::vector<int32_t> presence_mask;
+  if (use_presence_mask) {
+    for (size_t i = 0; i < scores.size(); i++) {
+      presence_mask.push_back(i % 7 == 2 ? 1 : 0);
+    }
+  }
+
+  const std::vector<float> expected = ReferenceElementwiseScores(scores, vocab_size, vocab_mask, temperature,
+                                                                 presence_mask, presence_penalty);
+
+  ElementwiseLogitsProcessor<float> processor(vocab_mask, temperature, presence_mask, presence_penalty, thread_pool);
+  EXPECT_EQ(processor.IsEnabled(), use_vocab_mask || temperature != 1.0f ||
+                                       (use_presence_mask && presence_penalty != 0.0f));
+  gsl::span<float> scores_span(scores);
+  NextTokenScores<float> next_token_scores{scores_span, batch_beam_size, vocab_size};
+  processor.Process(nullptr, next_token_scores);
+
+  // The fused pass does the same operations on each score, so the results are identical.
+  for (size_t i = 0; i < scores.size(); i++) {
+    ASSERT_EQ(scores[i], expected[i]) << "index " << i;
+  }
+}
+}  // namespace
+
+TEST(LogitsProcessorTest, Elementwise) {
+  OrtThreadPoolParams thread_pool_params;
+  thread_pool_params.thread_pool_size = 4;
+  auto thread_pool = concurrency::CreateThreadPool(&Env::Default(), thread_pool_params,
+                                                   concurrency::ThreadPoolType::INTRA_OP);
+
+  // A vocabulary which the thread pool splits in blocks that do not end at the rows, and a small one.
+  for (concurrency::ThreadPool* tp : {static_cast<concurrency::ThreadPool*>(nullptr), thread_pool.get()}) {
+    for (int vocab_size : {5, 50257}) {
+      SCOPED_TRACE(std::string(tp == nullptr ? "no thread pool" : "thread pool") + ", vocab_size " +
+                   std::to_string(vocab_size));
+      RunElementwiseLogitsProcessor(tp, 3, vocab_size, true, 0.7f, true, 1.5f);
+      RunElementwiseLogitsProcessor(tp, 3, vocab_size, true, 1.0f, false, 0.0f);
+      RunElementwiseLogitsProcessor(tp, 3, vocab_size, false, 2.0f, false, 0.0f);
+      RunElementwiseLogitsProcessor(tp, 3, vocab_size, false, 1.0f, true, 0.5f);
+      RunElementwiseLogitsProcessor(tp, 2, vocab_size, false, 1.0f, true, 0.0f);
+    }
+  }
+}
+
+// The presence penalty is applied to the score of each present token, not only the first score.
+TEST(LogitsProcessorTest, PresencePenaltyPerToken) {
+  std::vector<float> scores{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const std::vector<int32_t> presence_mask{0, 1, 0, 1, 1, 0};
+  ElementwiseLogitsProcessor<float> processor({}, 1.0f, presence_mask, 2.0f, nullptr);
+  gsl::span<float> scores_span(scores);
+  NextTokenScores<float> next_token_scores{scores_span, 2, 3};
+  processor.Process(nullptr, next_token_scores);
+  EXPECT_EQ(scores, (std::vector<float>{1.0f, 0.0f, 3.0f, 2.0f, 3.0f, 6.0f}));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
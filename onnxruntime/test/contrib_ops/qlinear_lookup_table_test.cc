@@ -133,6 +133,46 @@ TEST(QLinearLookupTableBasedOperatorTests, QLinearSigmoid_UInt8_0_Y_ZP) {
 ```
 \see then followed by the [DOC](https://pytorch.org/docs/stable/quantization.html)
 */
+TEST(QLinearLookupTableBasedOperatorTests, QLinearGelu_Int8) {
+  OpTester test("QLinearGelu", 1, onnxruntime::kMSDomain);
+  float X_scale = 0.05f;
+  float Y_scale = 0.02f;
+  int8_t Y_zero_point = -20;
+
+  std::vector<int64_t> dims = {16};
+  test.AddInput<int8_t>("X", dims, {-128, -100, -60, -30, -17, -5, -1, 0, 1, 5, 17, 30, 60, 90, 110, 127});
+  test.AddInput<float>("X_scale", {}, {X_scale});
+  test.AddOptionalInputEdge<int8_t>();  // optional "X_zero_point" using default value here
+  test.AddInput<float>("Y_scale", {}, {Y_scale});
+  test.AddInput<int8_t>("Y_zero_point", {}, {Y_zero_point});
+  test.AddOutput<int8_t>("Y", dims, {-20, -20, -20, -25, -28, -25, -21, -20, -19, -13, 14, 50, 127, 127, 127, 127});
+  auto origin_round_mode = std::fegetround();
+  std::fesetround(FE_TONEAREST);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kDmlExecutionProvider});
+  std::fesetround(origin_round_mode);
+}
+
+TEST(QLinearLookupTableBasedOperatorTests, QLinearGelu_UInt8_Tanh) {
+  OpTester test("QLinearGelu", 1, onnxruntime::kMSDomain);
+  test.AddAttribute<std::string>("approximate", "tanh");
+  float X_scale = 0.05f;
+  uint8_t X_zero_point = 128;
+  float Y_scale = 0.02f;
+  uint8_t Y_zero_point = 20;
+
+  std::vector<int64_t> dims = {8};
+  test.AddInput<uint8_t>("X", dims, {0, 68, 98, 123, 128, 133, 145, 158});
+  test.AddInput<float>("X_scale", {}, {X_scale});
+  test.AddInput<uint8_t>("X_zero_point", {}, {X_zero_point});
+  test.AddInput<float>("Y_scale", {}, {Y_scale});
+  test.AddInput<uint8_t>("Y_zero_point", {}, {Y_zero_point});
+  test.AddOutput<uint8_t>("Y", dims, {20, 20, 15, 15, 20, 27, 54, 90});
+  auto origin_round_mode = std::fegetround();
+  std::fesetround(FE_TONEAREST);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kDmlExecutionProvider});
+  std::fesetround(origin_round_mode);
+}
+
 TEST(QLinearLookupTableBasedOperatorTests, QLinearSoftmax_UInt8_v12) {
   auto run_test = [](bool add_shape_to_input) {
     OpTester test("QLinearSoftmax", 1, onnxruntime::kMSDomain);
@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+constexpr int kNumHeads = 4;
+constexpr int kKvNumHeads = 2;
+constexpr int kNumLayouts = 2;
+constexpr int kHeadSize = 8;
+constexpr int kBlockSize = 4;
+constexpr int kMaxBlocks = 4;
+constexpr int kCacheLength = kMaxBlocks * kBlockSize;
+
+// Whether the query block attends to the key block in the layout. The diagonal blocks are active, and the layouts
+// skip every other block below the diagonal, each one different blocks.
+bool IsActiveBlock(int layout, int query_block, int key_block) {
+  return key_block == query_block || (key_block < query_block && (query_block - key_block + layout) % 2 == 1);
+}
+
+// Runs SparseAttention over the kv cache with past and present sharing a buffer, the new tokens of batch b being at
+// the positions [total_key_lengths[b] - sequence_length, total_key_lengths[b]), and compares it with the attention
+// of each query over all the keys before it, masked by the dense block mask.
+void RunSparseAttention(int sequence_length, const std::vector<int32_t>& total_key_lengths) {
+  const int batch_size = static_cast<int>(total_key_lengths.size());
+  const int total_sequence_length = *std::max_element(total_key_lengths.begin(), total_key_lengths.end());
+
+  std::default_random_engine generator(static_cast<unsigned>(sequence_length * 100 + total_sequence_length));
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  const auto random_values = [&](size_t size) {
+    std::vector<float> values(size);
+    for (auto& value : values) {
+      value = distribution(generator);
+    }
+    return values;
+  };
+  const std::vector<float> query = random_values(static_cast<size_t>(batch_size) * sequence_length * kNumHeads *
+                                                 kHeadSize);
+  const std::vector<float> key = random_values(static_cast<size_t>(batch_size) * sequence_length * kKvNumHeads *
+                                               kHeadSize);
+  const std::vector<float> value = random_values(key.size());
+  // the cache holds the past tokens, followed by values that are not attended to
+  const std::vector<float> past_key = random_values(static_cast<size_t>(batch_size) * kKvNumHeads * kCacheLength *
+                                                    kHeadSize);
+  const std::vector<float> past_value = random_values(past_key.size());
+
+  // CSR format of the block masks
+  std::vector<int32_t> row_indices;
+  std::vector<std::vector<int32_t>> layout_col_indices(kNumLayouts);
+  for (int layout = 0; layout < kNumLayouts; layout++) {
+    row_indices.push_back(0);
+    for (int query_block = 0; query_block < kMaxBlocks; query_block++) {
+      for (int key_block = 0; key_block < kMaxBlocks; key_block++) {
+        if (IsActiveBlock(layout, query_block, key_block)) {
+          layout_col_indices[layout].push_back(key_block);
+        }
+      }
+      row_indices.push_back(static_cast<int32_t>(layout_col_indices[layout].size()));
+    }
+  }
+  const size_t max_nnz = std::max(layout_col_indices[0].size(), layout_col_indices[1].size());
+  std::vector<int32_t> col_indices;
+  for (auto& indices : layout_col_indices) {
+    indices.resize(max_nnz, -1);
+    col_indices.insert(col_indices.end(), indices.begin(), indices.end());
+  }
+
+  // the new keys and values are written in the cache after the past ones
+  std::vector<float> present_key(past_key);
+  std::vector<float> present_value(past_value);
+  for (int b = 0; b < batch_size; b++) {
+    const int past_length = total_key_lengths[b] - sequence_length;
+    for (int n = 0; n < kKvNumHeads; n++) {
+      for (int s = 0; s < sequence_length; s++) {
+        const size_t input_offset = ((static_cast<size_t>(b) * sequence_length + s) * kKvNumHeads + n) * kHeadSize;
+        const size_t cache_offset = ((static_cast<size_t>(b) * kKvNumHeads + n) * kCacheLength + past_length + s) *
+                                    kHeadSize;
+        std::copy_n(key.begin() + input_offset, kHeadSize, present_key.begin() + cache_offset);
+        std::copy_n(value.begin() + input_offset, kHeadSize, present_value.begin() + cache_offset);
+      }
+    }
+  }
+
+  std::vector<float> expected_output(query.size(), 0.0f);
+  for (int b = 0; b < batch_size; b++) {
+    const int past_length = total_key_lengths[b] - sequence_length;
+    for (int s = 0; s < sequence_length; s++) {
+      const int position = past_length + s;
+      for (int n = 0; n < kNumHeads; n++) {
+        const float* q = query.data() + ((static_cast<size_t>(b) * sequence_length + s) * kNumHeads + n) * kHeadSize;
+        const size_t cache_offset = (static_cast<size_t>(b) * kKvNumHeads + n / (kNumHeads / kKvNumHeads)) *
+                                    kCacheLength * kHeadSize;
+        std::vector<int> keys;
+        std::vector<double> scores;
+        for (int t = 0; t <= position; t++) {
+          if (IsActiveBlock(n % kNumLayouts, position / kBlockSize, t / kBlockSize)) {
+            double dot = 0.0;
+            for (int h = 0; h < kHeadSize; h++) {
+              dot += static_cast<double>(q[h]) * present_key[cache_offset + t * kHeadSize + h];
+            }
+            keys.push_back(t);
+            scores.push_back(dot / std::sqrt(static_cast<double>(kHeadSize)));
+          }
+        }
+
+        const double max_score = *std::max_element(scores.begin(), scores.end());
+        double sum = 0.0;
+        for (auto& score : scores) {
+          score = std::exp(score - max_score);
+          sum += score;
+        }
+        float* o = expected_output.data() + ((static_cast<size_t>(b) * sequence_length + s) * kNumHeads + n) *
+                                                kHeadSize;
+        for (size_t i = 0; i < keys.size(); i++) {
+          for (int h = 0; h < kHeadSize; h++) {
+            o[h] += static_cast<float>(scores[i] / sum * present_value[cache_offset + keys[i] * kHeadSize + h]);
+          }
+        }
+      }
+    }
+  }
+
+  onnxruntime::Model model("sparse_attention", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}, {kMSDomain, 1}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  ONNX_NAMESPACE::TypeProto int32_tensor;
+  int32_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_INT32);
+  const std::vector<std::string> input_names{"query", "key", "value", "past_key", "past_value", "block_row_indices",
+                                             "block_col_indices", "total_sequence_length",
+                                             "key_total_sequence_lengths"};
+  const std::vector<std::string> output_names{"output", "present_key", "present_value"};
+  std::vector<NodeArg*> inputs;
+  for (size_t i = 0; i < input_names.size(); i++) {
+    inputs.push_back(&graph.GetOrCreateNodeArg(input_names[i], i < 5 ? &float_tensor : &int32_tensor));
+  }
+  std::vector<NodeArg*> outputs;
+  for (const auto& name : output_names) {
+    outputs.push_back(&graph.GetOrCreateNodeArg(name, &float_tensor));
+  }
+  auto& node = graph.AddNode("sparse_attention", "SparseAttention", "SparseAttention over a kv cache", inputs,
+                             outputs, nullptr, kMSDomain);
+  node.AddAttribute("num_heads", static_cast<int64_t>(kNumHeads));
+  node.AddAttribute("kv_num_heads", static_cast<int64_t>(kKvNumHeads));
+  node.AddAttribute("sparse_block_size", static_cast<int64_t>(kBlockSize));
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  SessionOptions so;
+  so.session_logid = "SparseAttentionTest";
+  InferenceSession session(so, GetEnvironment());
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  std::vector<OrtValue> feeds(input_names.size());
+  CreateMLValue<float>(allocator, {batch_size, sequence_length, kNumHeads * kHeadSize}, query, &feeds[0]);
+  CreateMLValue<float>(allocator, {batch_size, sequence_length, kKvNumHeads * kHeadSize}, key, &feeds[1]);
+  CreateMLValue<float>(allocator, {batch_size, sequence_length, kKvNumHeads * kHeadSize}, value, &feeds[2]);
+  CreateMLValue<float>(allocator, {batch_size, kKvNumHeads, kCacheLength, kHeadSize}, past_key, &feeds[3]);
+  CreateMLValue<float>(allocator, {batch_size, kKvNumHeads, kCacheLength, kHeadSize}, past_value, &feeds[4]);
+  CreateMLValue<int32_t>(allocator, {kNumLayouts, kMaxBlocks + 1}, row_indices, &feeds[5]);
+  CreateMLValue<int32_t>(allocator, {kNumLayouts, static_cast<int64_t>(max_nnz)}, col_indices, &feeds[6]);
+  CreateMLValue<int32_t>(allocator, {1}, {total_sequence_length}, &feeds[7]);
+  CreateMLValue<int32_t>(allocator, {batch_size}, total_key_lengths, &feeds[8]);
+
+  // the present key and value are written in the buffers of the past ones
+  std::vector<OrtValue> fetches{OrtValue(), feeds[3], feeds[4]};
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, input_names, feeds, output_names, &fetches));
+
+  const auto expect_near = [](const OrtValue& actual, const std::vector<float>& expected, const char* name) {
+    auto data = actual.Get<Tensor>().DataAsSpan<float>();
+    ASSERT_EQ(data.size(), expected.size()) << name;
+    for (size_t i = 0; i < expected.size(); i++) {
+      ASSERT_NEAR(data[i], expected[i], 1e-5f) << name << " index " << i;
+    }
+  };
+  expect_near(fetches[0], expected_output, "output");
+  expect_near(fetches[1], present_key, "present_key");
+  expect_near(fetches[2], present_value, "present_value");
+}
+}  // namespace
+
+// A prompt whose last block is partial, and one that fills its blocks.
+TEST(SparseAttentionTest, Prompt) {
+  RunSparseAttention(10, {10, 10});
+  RunSparseAttention(8, {8});
+}
+
+// Decoding a token at the first, a middle and the last position of a block, with past tokens of different lengths.
+TEST(SparseAttentionTest, Decode) {
+  RunSparseAttention(1, {5, 7, 16});
+}
+
+// New tokens following past ones, starting in the middle of a block and straddling the next ones.
+TEST(SparseAttentionTest, ContinuationStraddlingBlocks) {
+  RunSparseAttention(3, {6, 10});
+  RunSparseAttention(7, {9, 16});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "gtest/gtest.h"
+#include "test/providers/provider_test_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace subword_tokenizer_test {
+constexpr const char* domain = onnxruntime::kMSDomain;
+constexpr int opset_ver = 1;
+
+// "\xE2\x96\x81" is the word boundary marker U+2581
+const std::vector<std::string> bpe_vocab{"<unk>", "\xE2\x96\x81", "l", "o", "w", "e", "r",
+                                         "\xE2\x96\x81l", "\xE2\x96\x81lo", "\xE2\x96\x81low", "er"};
+const std::vector<std::string> bpe_merges{"\xE2\x96\x81 l", "\xE2\x96\x81l o", "\xE2\x96\x81lo w", "e r"};
+}  // namespace subword_tokenizer_test
+
+using namespace subword_tokenizer_test;
+
+TEST(ContribOpTest, SubwordTokenizerBpe) {
+  OpTester test("SubwordTokenizer", opset_ver, domain);
+  test.AddAttribute("vocab", bpe_vocab);
+  test.AddAttribute("merges", bpe_merges);
+  test.AddAttribute("pad_id", int64_t{-1});
+
+  // "x" is not in the vocab, so its word is the marker and an unknown piece
+  test.AddInput<std::string>("X", {2}, {"low lower", " \tx "});
+  test.AddOutput<int64_t>("Y", {2, 3}, {9, 9, 10, 1, 0, -1});
+  test.AddOutput<int64_t>("lengths", {2}, {3, 2});
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, SubwordTokenizerUnigram) {
+  OpTester test("SubwordTokenizer", opset_ver, domain);
+  test.AddAttribute("model", std::string("unigram"));
+  test.AddAttribute("vocab", std::vector<std::string>{"<unk>", "\xE2\x96\x81", "\xE2\x96\x81" "a", "b", "ab",
+                                                      "\xE2\x96\x81" "ab", "c"});
+  test.AddAttribute("scores", std::vector<float>{0.0f, -1.0f, -2.0f, -1.0f, -1.5f, -5.0f, -2.0f});
+
+  // "abc" is best split into the marker, "ab" and "c" (-4.5), and "d" is unknown
+  test.AddInput<std::string>("X", {1}, {"abc d"});
+  test.AddOutput<int64_t>("Y", {1, 5}, {1, 4, 6, 1, 0});
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(ContribOpTest, SubwordTokenizerInvalidUtf8) {
+  OpTester test("SubwordTokenizer", opset_ver, domain);
+  test.AddAttribute("vocab", bpe_vocab);
+  test.AddAttribute("merges", bpe_merges);
+
+  test.AddInput<std::string>("X", {1}, {"lo\xE2\x96"});
+  test.AddOutput<int64_t>("Y", {1, 0}, {});
+  test.Run(OpTester::ExpectResult::kExpectFailure, "is not valid UTF-8");
+}
+
+TEST(ContribOpTest, SubwordDetokenizer) {
+  {
+    OpTester test("SubwordDetokenizer", opset_ver, domain);
+    test.AddAttribute("vocab", bpe_vocab);
+    test.AddAttribute("skip_ids", std::vector<int64_t>{0});
+
+    test.AddInput<int64_t>("ids", {2, 3}, {9, 9, 10, 7, 3, 0});
+    test.AddOutput<std::string>("text", {2}, {"low lower", "lo"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+  {
+    OpTester test("SubwordDetokenizer", opset_ver, domain);
+    test.AddAttribute("vocab", bpe_vocab);
+
+    test.AddInput<int64_t>("ids", {2}, {9, 10});
+    test.AddOutput<std::string>("text", {}, {"lower"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
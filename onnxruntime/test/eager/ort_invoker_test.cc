@@ -0,0 +1,129 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/eager/ort_kernel_invoker.h"
+#include "core/graph/node_attr_utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::shared_ptr<IExecutionProvider> CreateCPUExecutionProvider() {
+  return std::make_shared<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+}
+
+// Invokes a binary op on x and y, both of dims {3, 2}, and checks its output.
+void InvokeBinaryOp(ORTInvoker& invoker, const std::string& op_name, const std::vector<float>& x,
+                    const std::vector<float>& y, const std::vector<float>& expected) {
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue a, b;
+  CreateMLValue<float>(allocator, {3, 2}, x, &a);
+  CreateMLValue<float>(allocator, {3, 2}, y, &b);
+  std::vector<OrtValue> outputs(1);
+  ASSERT_STATUS_OK(invoker.Invoke(op_name, {a, b}, outputs, nullptr));
+
+  const auto& output = outputs[0].Get<Tensor>();
+  ASSERT_EQ(output.Shape(), TensorShape({3, 2}));
+  auto data = output.DataAsSpan<float>();
+  ASSERT_EQ(std::vector<float>(data.begin(), data.end()), expected) << op_name;
+}
+}  // namespace
+
+TEST(InvokerTest, Basic) {
+  const IOnnxRuntimeOpSchemaRegistryList custom_op_registries;
+  ORTInvoker invoker(CreateCPUExecutionProvider(), DefaultLoggingManager().DefaultLogger(), custom_op_registries);
+  InvokeBinaryOp(invoker, "Add", {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+                 {2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f});
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 1u);
+
+  // the cached kernel runs on the new inputs
+  InvokeBinaryOp(invoker, "Add", {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f}, {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f},
+                 {2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f});
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 1u);
+
+  InvokeBinaryOp(invoker, "Mul", {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, {2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f},
+                 {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f});
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 2u);
+}
+
+// Kernels of the same op with different attributes are cached separately.
+TEST(InvokerTest, Attributes) {
+  const IOnnxRuntimeOpSchemaRegistryList custom_op_registries;
+  ORTInvoker invoker(CreateCPUExecutionProvider(), DefaultLoggingManager().DefaultLogger(), custom_op_registries);
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue x;
+  CreateMLValue<float>(allocator, {2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x);
+
+  const auto invoke_transpose = [&](const std::vector<int64_t>& perm, const TensorShape& expected_shape,
+                                    const std::vector<float>& expected) {
+    NodeAttributes attributes;
+    attributes["perm"] = utils::MakeAttribute("perm", perm);
+    std::vector<OrtValue> outputs(1);
+    ASSERT_STATUS_OK(invoker.Invoke("Transpose", {x}, outputs, &attributes));
+    const auto& output = outputs[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), expected_shape);
+    auto data = output.DataAsSpan<float>();
+    ASSERT_EQ(std::vector<float>(data.begin(), data.end()), expected);
+  };
+
+  invoke_transpose({1, 0}, TensorShape({3, 2}), {1.0f, 4.0f, 2.0f, 5.0f, 3.0f, 6.0f});
+  invoke_transpose({0, 1}, TensorShape({2, 3}), {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 2u);
+  invoke_transpose({1, 0}, TensorShape({3, 2}), {1.0f, 4.0f, 2.0f, 5.0f, 3.0f, 6.0f});
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 2u);
+}
+
+// The cache holds up to its capacity kernels, releasing the least recently used one first.
+TEST(InvokerTest, KernelCacheEviction) {
+  const IOnnxRuntimeOpSchemaRegistryList custom_op_registries;
+  ORTInvoker invoker(CreateCPUExecutionProvider(), DefaultLoggingManager().DefaultLogger(), custom_op_registries, 2);
+  const std::vector<float> x{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  const std::vector<float> y{2.0f, 2.0f, 2.0f, 2.0f, 2.0f, 2.0f};
+  const std::vector<float> sum{3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+  const std::vector<float> product{2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+  const std::vector<float> difference{-1.0f, 0.0f, 1.0f, 2.0f, 3.0f, 4.0f};
+
+  InvokeBinaryOp(invoker, "Add", x, y, sum);
+  InvokeBinaryOp(invoker, "Mul", x, y, product);
+  // Add is the most recently used, so Mul is evicted
+  InvokeBinaryOp(invoker, "Add", x, y, sum);
+  InvokeBinaryOp(invoker, "Sub", x, y, difference);
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 2u);
+
+  // the evicted kernel is created again
+  InvokeBinaryOp(invoker, "Mul", x, y, product);
+  InvokeBinaryOp(invoker, "Add", x, y, sum);
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 2u);
+}
+
+TEST(InvokerTest, KernelCacheDisabled) {
+  const IOnnxRuntimeOpSchemaRegistryList custom_op_registries;
+  ORTInvoker invoker(CreateCPUExecutionProvider(), DefaultLoggingManager().DefaultLogger(), custom_op_registries, 0);
+  InvokeBinaryOp(invoker, "Add", {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f},
+                 {2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f});
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 0u);
+}
+
+// A failed kernel creation leaves no entry in the cache.
+TEST(InvokerTest, UnknownOp) {
+  const IOnnxRuntimeOpSchemaRegistryList custom_op_registries;
+  ORTInvoker invoker(CreateCPUExecutionProvider(), DefaultLoggingManager().DefaultLogger(), custom_op_registries);
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue x;
+  CreateMLValue<float>(allocator, {2}, {1.0f, 2.0f}, &x);
+  std::vector<OrtValue> outputs(1);
+  EXPECT_FALSE(invoker.Invoke("NotAnOp", {x}, outputs, nullptr).IsOK());
+  EXPECT_EQ(invoker.GetKernelCacheSize(), 0u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
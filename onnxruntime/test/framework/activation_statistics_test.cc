@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/activation_statistics.h"
+
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ActivationStatisticsTest, GrowHistogram) {
+  ActivationStatistics statistics(2, 4);
+
+  const std::vector<float> values = {0.0f, 1.0f, 2.0f, 3.0f, 4.0f};
+  statistics.Record(0, values);
+  auto snapshot = statistics.GetSnapshot(0);
+  EXPECT_EQ(snapshot.count, 5U);
+  EXPECT_EQ(snapshot.histogram_begin, 0.0);
+  EXPECT_EQ(snapshot.histogram_end, 4.0);
+  EXPECT_EQ(snapshot.histogram, (std::vector<uint64_t>{1, 1, 1, 2}));
+
+  // the range doubles upwards, then downwards, merging pairs of bins
+  const std::vector<float> above = {6.0f};
+  statistics.Record(0, above);
+  snapshot = statistics.GetSnapshot(0);
+  EXPECT_EQ(snapshot.histogram_end, 8.0);
+  EXPECT_EQ(snapshot.histogram, (std::vector<uint64_t>{2, 3, 0, 1}));
+
+  const std::vector<float> below = {-5.0f};
+  statistics.Record(0, below);
+  snapshot = statistics.GetSnapshot(0);
+  EXPECT_EQ(snapshot.histogram_begin, -8.0);
+  EXPECT_EQ(snapshot.histogram_end, 8.0);
+  EXPECT_EQ(snapshot.histogram, (std::vector<uint64_t>{1, 0, 5, 1}));
+  EXPECT_EQ(snapshot.count, 7U);
+  EXPECT_EQ(snapshot.min, -5.0f);
+  EXPECT_EQ(snapshot.max, 6.0f);
+
+  EXPECT_EQ(statistics.GetSnapshot(1).count, 0U);
+}
+
+TEST(ActivationStatisticsTest, NonFiniteValues) {
+  ActivationStatistics statistics(1, 2);
+
+  const std::vector<float> values = {std::numeric_limits<float>::quiet_NaN(), 1.0f,
+                                     std::numeric_limits<float>::infinity()};
+  statistics.Record(0, values);
+  const auto snapshot = statistics.GetSnapshot(0);
+  EXPECT_EQ(snapshot.count, 1U);
+  EXPECT_EQ(snapshot.min, 1.0f);
+  EXPECT_EQ(snapshot.max, 1.0f);
+  EXPECT_LT(snapshot.histogram_begin, 1.0);
+  EXPECT_GT(snapshot.histogram_end, 1.0);
+  EXPECT_EQ(snapshot.histogram[0] + snapshot.histogram[1], 1U);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -356,6 +356,18 @@ class PlannerTest : public ::testing::Test {
     EXPECT_EQ(plan_->allocation_plan[id].alloc_kind, kind) << "Error in allocation kind for " << name;
   }
 
+  void CheckSubBuffer(const std::string& name, const std::string& buffer_name, size_t offset) {
+    int id;
+    int buffer_id;
+    index(name, id);
+    index(buffer_name, buffer_id);
+    const auto& value_plan = plan_->allocation_plan[id];
+    EXPECT_EQ(value_plan.alloc_kind, AllocKind::kReuse) << "Error in allocation kind for " << name;
+    EXPECT_TRUE(value_plan.is_sub_buffer) << name << " is not placed in " << buffer_name;
+    EXPECT_EQ(value_plan.reused_buffer, buffer_id) << "Error in reused buffer for " << name;
+    EXPECT_EQ(value_plan.sub_buffer_offset, offset) << "Error in sub buffer offset for " << name;
+  }
+
   void CheckFreed(int step_number, std::initializer_list<std::string> freed_items) {
     // TODO: add the checker for new implementation of release plan
     //// create set and check equality
@@ -744,6 +756,102 @@ TEST_F(PlannerTest, PlanOutputTest) {
   }
 }
 
+#if !defined(ENABLE_TRAINING)
+// SubBufferConcatTest: Check that the inputs of a Concat are placed in its output.
+TEST_F(PlannerTest, SubBufferConcatTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), concat("concat");
+
+  // graph structure:
+  std::unique_ptr<::onnxruntime::KernelDef> concat_kernel =
+      KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(4, 10).Build();
+  AddNormalNode(X1, X2);  // X2: placed at the start of X4
+  AddNormalNode(X1, X3);  // X3: placed after X2 in X4
+  std::vector<onnxruntime::NodeArg*> inputs{Arg(X2), Arg(X3)}, outputs{Arg(X4)};
+  AddNode(*concat_kernel, concat, inputs, outputs)->AddAttribute("axis", int64_t{1});
+  AddNormalNode(X4, X5);
+
+  // simulate shape-inference results:
+  Shape part_shape{1, 64};
+  Shape whole_shape{1, 128};
+  SetShape({{X1, &part_shape.value}, {X2, &part_shape.value}, {X3, &part_shape.value},
+            {X4, &whole_shape.value}, {X5, &whole_shape.value}});
+
+  CreatePlan();
+
+  CheckAllocKind(X4, AllocKind::kAllocate);
+  CheckSubBuffer(X2, X4, 0);
+  CheckSubBuffer(X3, X4, 64 * sizeof(float));
+
+  // X2 and X3 are freed with X4
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {});
+  CheckFreed(3, {X4});
+}
+
+// SubBufferConcatNonContiguousTest: Check that the inputs of a Concat are not placed in its output
+// when they are not contiguous in it.
+TEST_F(PlannerTest, SubBufferConcatNonContiguousTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), concat("concat");
+
+  // graph structure:
+  std::unique_ptr<::onnxruntime::KernelDef> concat_kernel =
+      KernelDefBuilder().SetName("Concat").Provider(kCpuExecutionProvider).SinceVersion(4, 10).Build();
+  AddNormalNode(X1, X2);
+  AddNormalNode(X1, X3);
+  std::vector<onnxruntime::NodeArg*> inputs{Arg(X2), Arg(X3)}, outputs{Arg(X4)};
+  AddNode(*concat_kernel, concat, inputs, outputs)->AddAttribute("axis", int64_t{1});
+  AddNormalNode(X4, X5);
+
+  // simulate shape-inference results:
+  Shape part_shape{2, 64};
+  Shape whole_shape{2, 128};
+  SetShape({{X1, &part_shape.value}, {X2, &part_shape.value}, {X3, &part_shape.value},
+            {X4, &whole_shape.value}, {X5, &whole_shape.value}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckAllocKind(X3, AllocKind::kAllocate);
+  CheckAllocKind(X4, AllocKind::kAllocate);
+}
+
+// SubBufferSplitTest: Check that the outputs of a Split are placed in its input.
+TEST_F(PlannerTest, SubBufferSplitTest) {
+  // tensor variables:
+  std::string X1("X1"), X2("X2"), X3("X3"), X4("X4"), X5("X5"), X6("X6"), split("split");
+
+  // graph structure:
+  std::unique_ptr<::onnxruntime::KernelDef> split_kernel =
+      KernelDefBuilder().SetName("Split").Provider(kCpuExecutionProvider).SinceVersion(2, 10).Build();
+  AddNormalNode(X1, X2);
+  std::vector<onnxruntime::NodeArg*> inputs{Arg(X2)}, outputs{Arg(X3), Arg(X4)};
+  AddNode(*split_kernel, split, inputs, outputs)->AddAttribute("axis", int64_t{1});
+  AddNormalNode(X3, X5);
+  AddNormalNode(X4, X6);
+
+  // simulate shape-inference results:
+  Shape whole_shape{1, 128};
+  Shape part_shape{1, 64};
+  SetShape({{X1, &whole_shape.value}, {X2, &whole_shape.value}, {X3, &part_shape.value},
+            {X4, &part_shape.value}, {X5, &part_shape.value}, {X6, &part_shape.value}});
+
+  CreatePlan();
+
+  CheckAllocKind(X2, AllocKind::kAllocate);
+  CheckSubBuffer(X3, X2, 0);
+  CheckSubBuffer(X4, X2, 64 * sizeof(float));
+
+  // X2 is freed after the last consumer of X3 and X4
+  CheckFreed(0, {});
+  CheckFreed(1, {});
+  CheckFreed(2, {});
+  CheckFreed(3, {X2});
+}
+#endif  // !defined(ENABLE_TRAINING)
+
 #ifdef USE_CUDA
 TEST_F(PlannerTest, LocationPlanningForPassThroughExplicitAndImplicitSubgraphInputs) {
   // Types
@@ -1263,6 +1371,37 @@ TEST_F(PlannerTest, LocationPlanningForImplicitInputsWithoutExplicitConsumersInM
   // EXPECT_EQ(para_graph_plan->allocation_plan[input_data_index].location.device.Type(), OrtDevice::GPU);
 }
 
+// The CPU output copied to the GPU by MemcpyFromHost is placed in pinned memory and released at the end of the run
+// node1(CPU ep)->node2(MemcpyFromHost, CUDA ep)->node3(CUDA ep)
+TEST_F(PlannerTest, PinnedHostMemoryForMemcpyFromHostInput) {
+  std::unique_ptr<::onnxruntime::KernelDef> cudaKernelMemcpy = KernelDefBuilder().SetName("MemcpyFromHost").Provider(kCudaExecutionProvider).InputMemoryType(OrtMemTypeCPUInput, 0).Build();
+  std::unique_ptr<::onnxruntime::KernelDef> cudaKernelTrans = KernelDefBuilder().SetName("Transpose").Provider(kCudaExecutionProvider).SinceVersion(1, 10).Build();
+  std::string Graph_input("Graph_input"), Arg1("Arg1"), Arg2("Arg2"), Arg3("Arg3"), node1("node1"), node2("node2"), node3("node3");
+  std::vector<onnxruntime::NodeArg*> input1{Arg(Graph_input)}, output1{Arg(Arg1)}, output2{Arg(Arg2)}, output3{Arg(Arg3)};
+  AddNode(*GetStdKernel(), node1, input1, output1);
+  AddNode(*cudaKernelMemcpy, node2, output1, output2);
+  AddNode(*cudaKernelTrans, node3, output2, output3);
+
+  CUDAExecutionProviderInfo epi;
+  onnxruntime::ProviderInfo_CUDA& ep = onnxruntime::GetProviderInfo_CUDA();
+  auto epFactory = ep.CreateExecutionProviderFactory(epi);
+  std::unique_ptr<IExecutionProvider> execution_provider = epFactory->CreateProvider();
+  ORT_THROW_IF_ERROR(GetExecutionProviders().Add("CUDAExecutionProvider", std::move(execution_provider)));
+
+  CreatePlan({}, false);
+
+  const auto* plan = GetState().GetExecutionPlan();
+  int arg1_index;
+  ASSERT_STATUS_OK(GetState().GetOrtValueNameIdxMap().GetIdx(Arg1, arg1_index));
+  const auto& arg1_location = plan->allocation_plan[arg1_index].location;
+  EXPECT_EQ(arg1_location.Type(), OrtDevice::CPU);
+  EXPECT_EQ(arg1_location.MemType(), OrtDevice::MemType::CUDA_PINNED);
+  EXPECT_EQ(plan->allocation_plan[arg1_index].alloc_kind, AllocKind::kAllocate);
+  for (const auto& release_action : plan->release_actions) {
+    EXPECT_NE(release_action.value_index, static_cast<size_t>(arg1_index)) << "Arg1 is released before the end of the run";
+  }
+}
+
 // Test MultiStream scenario for the graph:
 // node1(CPU ep)->node2(CPU ep)->node3(CUDA ep)->node4(CPU ep)
 TEST_F(PlannerTest, MultiStream) {
@@ -1908,6 +2047,127 @@ TEST_F(PlannerTest, TestMultiStreamConfig) {
               graph_partitioner_cpu_gpu->Streams() == 2);
 }
 
+// Independent branches are placed in different CPU streams, with the longest branch in the first stream
+TEST_F(PlannerTest, CriticalPathPartitionTest) {
+  std::string X("X"), A("A"), B("B"), C("C"), D("D");
+  std::string node_1("node_1"), node_2("node_2"), node_3("node_3"), node_4("node_4");
+  std::vector<onnxruntime::NodeArg*> node_1_in{Arg(X)}, node_1_out{Arg(A)};
+  std::vector<onnxruntime::NodeArg*> node_2_in{Arg(A)}, node_2_out{Arg(B)};
+  std::vector<onnxruntime::NodeArg*> node_3_in{Arg(B)}, node_3_out{Arg(C)};
+  std::vector<onnxruntime::NodeArg*> node_4_in{Arg(A)}, node_4_out{Arg(D)};
+
+  // graph structure: node_1 feeds the branches node_2 -> node_3 and node_4
+  auto* p_node_1 = AddNode(*GetStdKernel(), node_1, node_1_in, node_1_out);
+  auto* p_node_2 = AddNode(*GetStdKernel(), node_2, node_2_in, node_2_out);
+  auto* p_node_3 = AddNode(*GetStdKernel(), node_3, node_3_in, node_3_out);
+  auto* p_node_4 = AddNode(*GetStdKernel(), node_4, node_4_in, node_4_out);
+
+  CreatePlan({}, false);
+
+  onnxruntime::GraphViewer graph_viewer{GetGraph()};
+  std::vector<InlinedVector<NodeIndex>> stream_nodes;
+
+  auto single_stream_partitioner = IGraphPartitioner::CreateGraphPartitioner(DefaultLoggingManager().DefaultLogger(),
+                                                                             ORT_TSTR(""), 1);
+  ASSERT_STREQ(single_stream_partitioner->Type(), "DeviceBasedPartitioner");
+  ASSERT_STATUS_OK(single_stream_partitioner->PartitionGraph(graph_viewer, GetExecutionProviders(), stream_nodes,
+                                                             ExecutionOrder::DEFAULT));
+  ASSERT_EQ(stream_nodes.size(), 1U);
+
+  auto partitioner = IGraphPartitioner::CreateGraphPartitioner(DefaultLoggingManager().DefaultLogger(),
+                                                               ORT_TSTR(""), 2);
+  ASSERT_STREQ(partitioner->Type(), "CriticalPathPartitioner");
+  ASSERT_STATUS_OK(partitioner->PartitionGraph(graph_viewer, GetExecutionProviders(), stream_nodes,
+                                               ExecutionOrder::DEFAULT));
+  ASSERT_EQ(partitioner->Streams(), 2U);
+  ASSERT_EQ(stream_nodes.size(), 2U);
+  EXPECT_EQ(stream_nodes[0], (InlinedVector<NodeIndex>{p_node_1->Index(), p_node_2->Index(), p_node_3->Index()}));
+  EXPECT_EQ(stream_nodes[1], (InlinedVector<NodeIndex>{p_node_4->Index()}));
+}
+
+// Allowing several GPU streams selects the critical path partitioner, which still keeps the CPU nodes in one stream
+TEST_F(PlannerTest, CriticalPathPartitionGpuStreamsTest) {
+  std::string X("X"), A("A"), B("B"), C("C");
+  std::string node_1("node_1"), node_2("node_2"), node_3("node_3");
+  std::vector<onnxruntime::NodeArg*> node_1_in{Arg(X)}, node_1_out{Arg(A)};
+  std::vector<onnxruntime::NodeArg*> node_2_in{Arg(A)}, node_2_out{Arg(B)};
+  std::vector<onnxruntime::NodeArg*> node_3_in{Arg(A)}, node_3_out{Arg(C)};
+
+  AddNode(*GetStdKernel(), node_1, node_1_in, node_1_out);
+  AddNode(*GetStdKernel(), node_2, node_2_in, node_2_out);
+  AddNode(*GetStdKernel(), node_3, node_3_in, node_3_out);
+
+  CreatePlan({}, false);
+
+  onnxruntime::GraphViewer graph_viewer{GetGraph()};
+  std::vector<InlinedVector<NodeIndex>> stream_nodes;
+  auto partitioner = IGraphPartitioner::CreateGraphPartitioner(DefaultLoggingManager().DefaultLogger(),
+                                                               ORT_TSTR(""), 1, 4);
+  ASSERT_STREQ(partitioner->Type(), "CriticalPathPartitioner");
+  ASSERT_STATUS_OK(partitioner->PartitionGraph(graph_viewer, GetExecutionProviders(), stream_nodes,
+                                               ExecutionOrder::DEFAULT));
+  ASSERT_EQ(partitioner->Streams(), 1U);
+  EXPECT_EQ(stream_nodes[0].size(), 3U);
+}
+
+// An execution provider on a GPU device, to partition nodes as GPU nodes without a GPU
+class MockGpuExecutionProvider : public IExecutionProvider {
+ public:
+  MockGpuExecutionProvider()
+      : IExecutionProvider("MockGpuExecutionProvider", OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0)) {}
+};
+
+// The GPU nodes are spread over the GPU streams and the CPU nodes stay in their own streams
+TEST_F(PlannerTest, CriticalPathPartitionGpuNodesTest) {
+  // node_1 -> (node_2, node_3) on the GPU, node_4 on the CPU
+  std::string X("X"), A("A"), B("B"), C("C"), D("D");
+  std::string node_1("node_1"), node_2("node_2"), node_3("node_3"), node_4("node_4");
+  std::vector<onnxruntime::NodeArg*> node_1_in{Arg(X)}, node_1_out{Arg(A)};
+  std::vector<onnxruntime::NodeArg*> node_2_in{Arg(A)}, node_2_out{Arg(B)};
+  std::vector<onnxruntime::NodeArg*> node_3_in{Arg(A)}, node_3_out{Arg(C)};
+  std::vector<onnxruntime::NodeArg*> node_4_in{Arg(X)}, node_4_out{Arg(D)};
+
+  auto* p_node_1 = AddNode(*GetStdKernel(), node_1, node_1_in, node_1_out);
+  auto* p_node_2 = AddNode(*GetStdKernel(), node_2, node_2_in, node_2_out);
+  auto* p_node_3 = AddNode(*GetStdKernel(), node_3, node_3_in, node_3_out);
+  auto* p_node_4 = AddNode(*GetStdKernel(), node_4, node_4_in, node_4_out);
+
+  CreatePlan({}, false);
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(kCpuExecutionProvider,
+                                           std::make_shared<CPUExecutionProvider>(CPUExecutionProviderInfo())));
+  auto gpu_execution_provider = std::make_shared<MockGpuExecutionProvider>();
+  ASSERT_STATUS_OK(execution_providers.Add(gpu_execution_provider->Type(), gpu_execution_provider));
+  for (auto* p_node : {p_node_1, p_node_2, p_node_3}) {
+    p_node->SetExecutionProviderType(gpu_execution_provider->Type());
+  }
+
+  onnxruntime::GraphViewer graph_viewer{GetGraph()};
+  std::vector<InlinedVector<NodeIndex>> stream_nodes;
+  auto partitioner = IGraphPartitioner::CreateGraphPartitioner(DefaultLoggingManager().DefaultLogger(),
+                                                               ORT_TSTR(""), 1, 2);
+  ASSERT_STREQ(partitioner->Type(), "CriticalPathPartitioner");
+  ASSERT_STATUS_OK(partitioner->PartitionGraph(graph_viewer, execution_providers, stream_nodes,
+                                               ExecutionOrder::DEFAULT));
+  // node_1 is on the longest path so it is scheduled first, node_4 is independent and the branches of node_1 run
+  // concurrently on two GPU streams
+  ASSERT_EQ(partitioner->Streams(), 3U);
+  ASSERT_EQ(stream_nodes.size(), 3U);
+  EXPECT_EQ(stream_nodes[0], (InlinedVector<NodeIndex>{p_node_1->Index(), p_node_2->Index()}));
+  EXPECT_EQ(stream_nodes[1], (InlinedVector<NodeIndex>{p_node_4->Index()}));
+  EXPECT_EQ(stream_nodes[2], (InlinedVector<NodeIndex>{p_node_3->Index()}));
+
+  // with a single GPU stream the GPU nodes run in order on it
+  partitioner = IGraphPartitioner::CreateGraphPartitioner(DefaultLoggingManager().DefaultLogger(), ORT_TSTR(""), 2, 1);
+  ASSERT_STREQ(partitioner->Type(), "CriticalPathPartitioner");
+  ASSERT_STATUS_OK(partitioner->PartitionGraph(graph_viewer, execution_providers, stream_nodes,
+                                               ExecutionOrder::DEFAULT));
+  ASSERT_EQ(partitioner->Streams(), 2U);
+  EXPECT_EQ(stream_nodes[0], (InlinedVector<NodeIndex>{p_node_1->Index(), p_node_2->Index(), p_node_3->Index()}));
+  EXPECT_EQ(stream_nodes[1], (InlinedVector<NodeIndex>{p_node_4->Index()}));
+}
+
 // Save partition config to a file and check its completeness
 TEST_F(PlannerTest, TestMultiStreamSaveConfig) {
   const char* config_file_path = "./testdata/multi_stream_models/conv_add_relu_single_stream.json";
@@ -2128,5 +2388,72 @@ TEST(AllocationPlannerTest, AvoidReuseOfBufferForNodeOutputWithNoConsumers) {
 }
 #endif
 
+// The outputs of the CPU elementwise kernels are written in place of an input at its last use, when the input has
+// the element type and shape of the output.
+TEST(AllocationPlannerTest, InPlaceReuseOfElementwiseKernels) {
+  // A = Exp(X), B = Neg(A), W = Sqrt(Y), D = Add(W, B), E = Mul(D, W), V = Exp(R), G = Add(V, E), Z = Relu(G)
+  // with X and Y of shape {2, 3} and R of shape {3}
+  onnxruntime::Model model("elementwise_in_place", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto matrix_type;
+  matrix_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  matrix_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  matrix_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  TypeProto row_type;
+  row_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  row_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+  auto arg = [&graph](const std::string& name, const TypeProto* type = nullptr) {
+    return &graph.GetOrCreateNodeArg(name, type);
+  };
+  graph.AddNode("exp_x", "Exp", "", {arg("X", &matrix_type)}, {arg("A")});
+  graph.AddNode("neg", "Neg", "", {arg("A")}, {arg("B")});
+  graph.AddNode("sqrt", "Sqrt", "", {arg("Y", &matrix_type)}, {arg("W")});
+  graph.AddNode("add_w_b", "Add", "", {arg("W"), arg("B")}, {arg("D")});
+  graph.AddNode("mul", "Mul", "", {arg("D"), arg("W")}, {arg("E")});
+  graph.AddNode("exp_r", "Exp", "", {arg("R", &row_type)}, {arg("V")});
+  graph.AddNode("add_v_e", "Add", "", {arg("V"), arg("E")}, {arg("G")});
+  graph.AddNode("relu", "Relu", "", {arg("G")}, {arg("Z")});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  SessionOptions so;
+  so.graph_optimization_level = TransformerLevel::Default;
+  InferenceSession session{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  const auto& session_state = session.GetSessionState();
+  const auto& ort_value_index_map = session_state.GetOrtValueNameIdxMap();
+  const SequentialExecutionPlan* plan = session_state.GetExecutionPlan();
+  auto index = [&ort_value_index_map](const std::string& name) {
+    OrtValueIndex idx = -1;
+    EXPECT_STATUS_OK(ort_value_index_map.GetIdx(name, idx));
+    return idx;
+  };
+  auto check_reuse = [&](const std::string& name, const std::string& reused_name) {
+    const auto& value_plan = plan->allocation_plan[index(name)];
+    EXPECT_EQ(value_plan.alloc_kind, AllocKind::kReuse) << name;
+    EXPECT_EQ(value_plan.reused_buffer, index(reused_name)) << name;
+  };
+
+  // graph inputs are not written to
+  EXPECT_EQ(plan->allocation_plan[index("A")].alloc_kind, AllocKind::kAllocate);
+  EXPECT_EQ(plan->allocation_plan[index("W")].alloc_kind, AllocKind::kAllocate);
+  EXPECT_EQ(plan->allocation_plan[index("V")].alloc_kind, AllocKind::kAllocate);
+  // unary kernel
+  check_reuse("B", "A");
+  // W is used by Mul after Add, so Add writes to its second input
+  check_reuse("D", "B");
+  // both inputs are at their last use, so Mul writes to its first input
+  check_reuse("E", "D");
+  // V is broadcast to the shape of the output, so Add writes to its second input
+  check_reuse("G", "E");
+  EXPECT_EQ(plan->allocation_plan[index("Z")].alloc_kind, AllocKind::kAllocateOutput);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -6,7 +6,9 @@
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <chrono>
 #include <cstdlib>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -307,6 +309,162 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, TestThreadCache) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES,
+             64 * 1024, 16 * 1024);
+
+  // a freed chunk is served again from the cache for any request of the same size class
+  void* p1 = a.Alloc(1000);
+  EXPECT_EQ(a.AllocatedSize(p1), 1024u);
+  a.Free(p1);
+  void* p2 = a.Alloc(900);
+  EXPECT_EQ(p2, p1);
+  a.Free(p2);
+
+  // size classes above 1KB have four steps per power of two
+  void* p3 = a.Alloc(5000);
+  EXPECT_EQ(a.AllocatedSize(p3), 5120u);
+  a.Free(p3);
+
+  // allocations larger than the max chunk size bypass the cache
+  void* large = a.Alloc(32 * 1024);
+  EXPECT_EQ(a.AllocatedSize(large), 32u * 1024);
+  a.Free(large);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  // only the cached chunks are still in use from the arena's point of view
+  EXPECT_EQ(stats.bytes_in_use, 1024 + 5120);
+
+  // exceeding the cache budget returns chunks to the bins in a batch
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; ++i) {
+    ptrs.push_back(a.Alloc(8 * 1024));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+  a.GetStats(&stats);
+  EXPECT_LE(stats.bytes_in_use, 64 * 1024);
+
+  // shrink releases the cached chunks so their regions can be freed
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, TestThreadCacheMultiThreaded) {
+  OrtArenaCfg config(0, -1, -1, -1, -1, -1L, 256 * 1024, -1);
+  AllocatorCreationInfo device_info{
+      [](OrtDevice::DeviceId) { return std::make_unique<CPUAllocator>(); },
+      0, true, config};
+  auto allocator = CreateAllocator(device_info);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&allocator, t]() {
+      std::vector<void*> ptrs;
+      for (int i = 0; i < 1000; ++i) {
+        size_t size = 256 + ((i * 37 + t * 101) % 64) * 1024;
+        void* p = allocator->Alloc(size);
+        memset(p, t, size);
+        ptrs.push_back(p);
+        if (ptrs.size() > 8) {
+          // free on a different position than allocated to mix size classes
+          allocator->Free(ptrs[i % ptrs.size()]);
+          ptrs.erase(ptrs.begin() + i % ptrs.size());
+        }
+      }
+      for (void* p : ptrs) {
+        allocator->Free(p);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  BFCArena& a = *static_cast<BFCArena*>(allocator.get());
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+static AllocatorPtr CreateArenaWithTrimWindow(int64_t trim_window_ms) {
+  OrtArenaCfg config(0, static_cast<int>(ArenaExtendStrategy::kSameAsRequested), -1, -1, -1, -1L, -1L, -1,
+                     trim_window_ms);
+  AllocatorCreationInfo device_info{
+      [](OrtDevice::DeviceId) { return std::make_unique<CPUAllocator>(); },
+      0, true, config};
+  return CreateAllocator(device_info);
+}
+
+TEST(BFCArenaTest, TestTrimToWorkingSet) {
+  AllocatorStats stats;
+  // a window long enough for the peak below to stay in it for the whole test
+  auto allocator = CreateArenaWithTrimWindow(60 * 60 * 1000);
+  BFCArena& a = *static_cast<BFCArena*>(allocator.get());
+
+  // peak of 3 x 1MB in use
+  void* p1 = a.Alloc(1 << 20);
+  void* p2 = a.Alloc(1 << 20);
+  void* p3 = a.Alloc(1 << 20);
+  a.Free(p1);
+  a.Free(p2);
+  a.Free(p3);
+
+  // a one-off allocation that doesn't fit in the existing regions
+  void* p4 = a.Alloc(2 << 20);
+  a.Free(p4);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 5 << 20);
+
+  EXPECT_EQ(a.TrimToWorkingSet(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 3 << 20) << "only the memory above the high-water mark is released";
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+}
+
+TEST(BFCArenaTest, TestTrimWhenWorkingSetExpires) {
+  AllocatorStats stats;
+  auto allocator = CreateArenaWithTrimWindow(80);
+  BFCArena& a = *static_cast<BFCArena*>(allocator.get());
+
+  void* p1 = a.Alloc(1 << 20);
+  void* p2 = a.Alloc(1 << 20);
+  a.Free(p1);
+  a.Free(p2);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 2 << 20) << "the peak is still in the window";
+
+  // once the peak has left the window, freeing memory trims the arena down to the new working set
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  void* p3 = a.Alloc(1024);
+  a.Free(p3);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.total_allocated_bytes, 1 << 20) << "one region is kept to cover the 1KB working set";
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+}
+
+TEST(BFCArenaTest, TestTrimToWorkingSetWithoutWindow) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested);
+  void* p1k = a.Alloc(1024);
+  void* p10M = a.Alloc(10 * 1024 * 1024);
+  a.Free(p1k);
+
+  // without a window the working set is what is currently in use
+  EXPECT_EQ(a.TrimToWorkingSet(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_arena_extensions, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024);
+  a.Free(p10M);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
@@ -414,6 +572,31 @@ TEST(StreamAwareArenaTest, TestSecureTheChunk) {
   EXPECT_TRUE(waitFunctionInvoked) << "wait function should be invoked";
   a.Free(p2);
 }
+
+TEST(StreamAwareArenaTest, TestThreadCachePerStream) {
+  StreamAwareArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, false,
+                     BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY, BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+                     BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK, BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+                     BFCArena::DEFAULT_MAX_POWER_OF_TWO_EXTEND_BYTES, 64 * 1024);
+  OrtDevice tmp;
+  StreamMock stream1(tmp), stream2(tmp);
+
+  void* stream1_chunk = a.AllocOnStream(4096, &stream1, nullptr);
+  a.Free(stream1_chunk);
+  // a cached chunk is never handed to another stream
+  void* stream2_chunk = a.AllocOnStream(4096, &stream2, nullptr);
+  EXPECT_NE(stream2_chunk, stream1_chunk);
+  // but is reused by the stream it was allocated on
+  EXPECT_EQ(a.AllocOnStream(4096, &stream1, nullptr), stream1_chunk);
+  a.Free(stream1_chunk);
+  a.Free(stream2_chunk);
+
+  // releasing the stream buffers returns the cached chunks of the stream to the bins
+  a.ReleaseStreamBuffers(&stream1);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 4096);
+}
 #endif
 
 TEST(BFCArenaTest, TestExtendStrategy) {
@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/common/span_utils.h"
+#include "core/framework/customregistry.h"
+#include "core/graph/model.h"
+#include "core/session/custom_ops.h"
+#include "core/session/onnxruntime_cxx_api.h"
+#include "test/framework/test_utils.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/inference_session_wrapper.h"
+#include "test/test_environment.h"
+
+using namespace ONNX_NAMESPACE;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// multiplies its input by a constant weight that it copies when the session is initialized
+struct PackedMulKernel {
+  PackedMulKernel(const OrtApi& /*api*/, const OrtKernelInfo* /*info*/) {}
+
+  ~PackedMulKernel() {
+    if (packed_ != nullptr) {
+      allocator_->Free(allocator_, packed_);
+    }
+  }
+
+  Ort::Status PrePackWeight(Ort::ConstValue tensor, int input_index, OrtAllocator* allocator, bool& is_packed) {
+    is_packed = false;
+    if (input_index != 1) {
+      return Ort::Status{nullptr};
+    }
+    num_weights_ = tensor.GetTensorTypeAndShapeInfo().GetElementCount();
+    allocator_ = allocator;
+    packed_ = static_cast<float*>(allocator->Alloc(allocator, num_weights_ * sizeof(float)));
+    std::copy_n(tensor.GetTensorData<float>(), num_weights_, packed_);
+    ++num_prepacks;
+    is_packed = true;
+    return Ort::Status{nullptr};
+  }
+
+  void Compute(OrtKernelContext* context) {
+    Ort::KernelContext ctx(context);
+    auto input = ctx.GetInput(0);
+    const float* x = input.GetTensorData<float>();
+    const auto shape = input.GetTensorTypeAndShapeInfo().GetShape();
+    float* y = ctx.GetOutput(0, shape).GetTensorMutableData<float>();
+    ORT_ENFORCE(packed_ != nullptr, "The weight was not pre-packed");
+
+    ORT_ENFORCE(ctx.GetDegreeOfParallelism() >= 1);
+    ctx.ParallelForRange(num_weights_, 1.0, [this, x, y](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        y[i] = x[i] * packed_[i];
+      }
+    });
+  }
+
+  static int num_prepacks;
+
+ private:
+  OrtAllocator* allocator_ = nullptr;
+  float* packed_ = nullptr;
+  size_t num_weights_ = 0;
+};
+
+int PackedMulKernel::num_prepacks = 0;
+
+struct PackedMulOp : Ort::CustomOpBase<PackedMulOp, PackedMulKernel> {
+  void* CreateKernel(const OrtApi& api, const OrtKernelInfo* info) const { return new PackedMulKernel(api, info); }
+
+  const char* GetName() const { return "PackedMul"; }
+
+  size_t GetInputTypeCount() const { return 2; }
+  ONNXTensorElementDataType GetInputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; }
+
+  size_t GetOutputTypeCount() const { return 1; }
+  ONNXTensorElementDataType GetOutputType(size_t /*index*/) const { return ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT; }
+
+  static std::vector<std::pair<int, int>> GetMayInplacePairs() { return {{0, 0}}; }
+};
+
+}  // namespace
+
+TEST(CustomOpKernelTest, MayInplacePairs) {
+  PackedMulOp custom_op;
+  int* input_index = nullptr;
+  int* output_index = nullptr;
+  ASSERT_EQ(custom_op.GetMayInplace(&input_index, &output_index), size_t{1});
+  EXPECT_EQ(input_index[0], 0);
+  EXPECT_EQ(output_index[0], 0);
+  custom_op.ReleaseMayInplace(input_index, output_index);
+
+  // no alias pairs are declared by the op
+  EXPECT_EQ(custom_op.GetAliasMap, nullptr);
+}
+
+TEST(CustomOpKernelTest, PrePackWeightAndParallelForRange) {
+  PackedMulOp custom_op;
+  Ort::CustomOpDomain op_domain("test");
+  op_domain.Add(&custom_op);
+  std::initializer_list<OrtCustomOpDomain*> op_domains = {static_cast<OrtCustomOpDomain*>(op_domain)};
+
+  std::shared_ptr<CustomRegistry> registry;
+  ASSERT_STATUS_OK(CreateCustomRegistry(AsSpan(op_domains), registry));
+
+  const int64_t num_elements = 64;
+  std::vector<float> x(num_elements), w(num_elements), expected(num_elements);
+  for (int64_t i = 0; i < num_elements; ++i) {
+    x[i] = static_cast<float>(i);
+    w[i] = static_cast<float>(i % 3) - 1.0f;
+    expected[i] = x[i] * w[i];
+  }
+
+  std::string serialized_model;
+  {
+    IOnnxRuntimeOpSchemaRegistryList schema_registries = {registry->GetOpschemaRegistry()};
+    std::unordered_map<std::string, int> domain_to_version = {{kOnnxDomain, 12}, {"test", 1}};
+    Model model("CustomOpPrePack", false, ModelMetaData(), PathString(), schema_registries, domain_to_version,
+                {}, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+
+    TypeProto tensor_type;
+    tensor_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    tensor_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(num_elements);
+    auto& x_arg = graph.GetOrCreateNodeArg("X", &tensor_type);
+    auto& w_arg = graph.GetOrCreateNodeArg("W", &tensor_type);
+    auto& y_arg = graph.GetOrCreateNodeArg("Y", &tensor_type);
+
+    TensorProto weight;
+    weight.set_name("W");
+    weight.set_data_type(TensorProto_DataType_FLOAT);
+    weight.add_dims(num_elements);
+    for (float value : w) {
+      weight.add_float_data(value);
+    }
+    graph.AddInitializedTensor(weight);
+
+    graph.AddNode("packed_mul", "PackedMul", "", {&x_arg, &w_arg}, {&y_arg}, nullptr, "test");
+    graph.SetInputs({&x_arg});
+    ASSERT_STATUS_OK(graph.Resolve());
+    ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  }
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 2;
+  InferenceSessionWrapper session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session.AddCustomOpDomains(AsSpan(op_domains)));
+  std::stringstream model_stream(serialized_model);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+
+  PackedMulKernel::num_prepacks = 0;
+  ASSERT_STATUS_OK(session.Initialize());
+  EXPECT_EQ(PackedMulKernel::num_prepacks, 1);
+  EXPECT_EQ(session.GetSessionState().GetNumberOfPrepacksCounter(), size_t{1});
+
+  OrtValue x_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {num_elements}, x, &x_value);
+  NameMLValMap feeds{{"X", x_value}};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, feeds, {"Y"}, &fetches));
+  ASSERT_EQ(fetches.size(), size_t{1});
+  auto result = fetches[0].Get<Tensor>().DataAsSpan<float>();
+  EXPECT_EQ(std::vector<float>(result.begin(), result.end()), expected);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
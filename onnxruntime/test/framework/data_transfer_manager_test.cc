@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/data_transfer_manager.h"
+
+#include <cstring>
+#include <vector>
+
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Copies between host buffers labelled with the given devices and records the batches it is given.
+class MockDataTransfer : public IDataTransfer {
+ public:
+  MockDataTransfer(OrtDevice::DeviceType src_type, OrtDevice::DeviceType dst_type)
+      : src_type_(src_type), dst_type_(dst_type) {}
+
+  bool CanCopy(const OrtDevice& src_device, const OrtDevice& dst_device) const override {
+    return src_device.Type() == src_type_ && dst_device.Type() == dst_type_;
+  }
+
+  Status CopyTensor(const Tensor& src, Tensor& dst) const override {
+    memcpy(dst.MutableDataRaw(), src.DataRaw(), src.SizeInBytes());
+    return Status::OK();
+  }
+
+  Status CopyTensors(const std::vector<SrcDstPair>& src_dst_pairs) const override {
+    batch_sizes.push_back(src_dst_pairs.size());
+    return IDataTransfer::CopyTensors(src_dst_pairs);
+  }
+
+  mutable std::vector<size_t> batch_sizes;
+
+ private:
+  const OrtDevice::DeviceType src_type_;
+  const OrtDevice::DeviceType dst_type_;
+};
+}  // namespace
+
+TEST(DataTransferManagerTest, CopyTensorsBatchesByDataTransfer) {
+  auto upload = std::make_unique<MockDataTransfer>(OrtDevice::CPU, OrtDevice::GPU);
+  auto download = std::make_unique<MockDataTransfer>(OrtDevice::GPU, OrtDevice::CPU);
+  const auto* upload_ptr = upload.get();
+  const auto* download_ptr = download.get();
+
+  DataTransferManager data_transfer_manager;
+  ASSERT_STATUS_OK(data_transfer_manager.RegisterDataTransfer(std::move(upload)));
+  ASSERT_STATUS_OK(data_transfer_manager.RegisterDataTransfer(std::move(download)));
+
+  const OrtMemoryInfo cpu_info(CPU, OrtDeviceAllocator);
+  const OrtMemoryInfo gpu_info("FakeGpu", OrtDeviceAllocator, OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0));
+  const auto float_type = DataTypeImpl::GetType<float>();
+
+  // alternate uploads and downloads
+  std::vector<float> src_data = {1.0f, 2.0f, 3.0f, 4.0f};
+  std::vector<float> dst_data(src_data.size(), 0.0f);
+  std::vector<Tensor> src_tensors;
+  std::vector<Tensor> dst_tensors;
+  src_tensors.reserve(src_data.size());
+  dst_tensors.reserve(src_data.size());
+  for (size_t i = 0; i < src_data.size(); ++i) {
+    src_tensors.emplace_back(float_type, TensorShape({1}), &src_data[i], i % 2 == 0 ? cpu_info : gpu_info);
+    dst_tensors.emplace_back(float_type, TensorShape({1}), &dst_data[i], i % 2 == 0 ? gpu_info : cpu_info);
+  }
+
+  std::vector<IDataTransfer::SrcDstPair> src_dst_pairs;
+  for (size_t i = 0; i < src_data.size(); ++i) {
+    src_dst_pairs.push_back({src_tensors[i], dst_tensors[i], nullptr});
+  }
+
+  ASSERT_STATUS_OK(data_transfer_manager.CopyTensors(src_dst_pairs));
+  EXPECT_EQ(dst_data, src_data);
+  EXPECT_EQ(upload_ptr->batch_sizes, std::vector<size_t>{2});
+  EXPECT_EQ(download_ptr->batch_sizes, std::vector<size_t>{2});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
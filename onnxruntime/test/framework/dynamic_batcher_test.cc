@@ -0,0 +1,199 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/dynamic_batcher.h"
+
+#include <atomic>
+#include <thread>
+
+#include "core/framework/tensor.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Doubles input "X" into output "Y", recording the batch dimension of each call.
+struct DoublingModel {
+  Status Run(const RunOptions&, gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string> output_names, std::vector<OrtValue>& fetches) {
+    EXPECT_TRUE(DynamicBatcher::IsRunningBatch());
+    EXPECT_EQ(feed_names.size(), 1u);
+    EXPECT_EQ(output_names.size(), 1u);
+    const auto& x = feeds[0].Get<Tensor>();
+    {
+      std::lock_guard<OrtMutex> lock(mutex);
+      batch_sizes.push_back(x.Shape()[0]);
+    }
+
+    fetches.resize(1);
+    std::vector<int64_t> output_dims;
+    if (!reduce_output) {
+      output_dims.assign(x.Shape().GetDims().begin(), x.Shape().GetDims().end());
+    }
+    AllocateMLValue<float>(allocator, output_dims, &fetches[0]);
+    auto y = fetches[0].GetMutable<Tensor>()->MutableDataAsSpan<float>();
+    {
+      std::lock_guard<OrtMutex> lock(mutex);
+      outputs.push_back(y.data());
+    }
+    auto x_data = x.DataAsSpan<float>();
+    if (reduce_output) {
+      y[0] = 0.0f;
+      for (float value : x_data) {
+        y[0] += 2 * value;
+      }
+    } else {
+      for (size_t i = 0; i < x_data.size(); ++i) {
+        y[i] = 2 * x_data[i];
+      }
+    }
+    return Status::OK();
+  }
+
+  DynamicBatcher::RunFn GetRunFn() {
+    return [this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                  gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                  std::vector<OrtValue>& fetches) {
+      return Run(run_options, feed_names, feeds, output_names, fetches);
+    };
+  }
+
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  bool reduce_output = false;
+  OrtMutex mutex;
+  std::vector<int64_t> batch_sizes;
+  std::vector<const float*> outputs;
+};
+
+const std::vector<std::string> kFeedNames{"X"};
+const std::vector<std::string> kOutputNames{"Y"};
+
+// Run num_requests concurrent requests, each with a single row of width elements filled with its index.
+void RunConcurrentRequests(DynamicBatcher& batcher, int num_requests, const std::vector<int64_t>& widths) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<std::thread> threads;
+  std::atomic<int> num_failures{0};
+  for (int r = 0; r < num_requests; ++r) {
+    threads.emplace_back([&, r]() {
+      const int64_t width = widths[r % widths.size()];
+      std::vector<OrtValue> feeds(1);
+      CreateMLValue<float>(allocator, {1, width}, std::vector<float>(static_cast<size_t>(width), static_cast<float>(r)),
+                           &feeds[0]);
+      std::vector<OrtValue> fetches;
+      RunOptions run_options;
+      auto status = batcher.Run(run_options, kFeedNames, feeds, kOutputNames, fetches);
+      if (!status.IsOK() || fetches.size() != 1) {
+        ++num_failures;
+        return;
+      }
+      const auto& y = fetches[0].Get<Tensor>();
+      if (y.Shape().NumDimensions() == 2) {
+        if (y.Shape() != TensorShape({1, width})) {
+          ++num_failures;
+          return;
+        }
+        for (float value : y.DataAsSpan<float>()) {
+          if (value != 2.0f * r) {
+            ++num_failures;
+          }
+        }
+      } else if (y.DataAsSpan<float>()[0] != 2.0f * r * width) {
+        ++num_failures;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(num_failures, 0);
+}
+}  // namespace
+
+TEST(DynamicBatcherTest, ConcurrentRequestsAreBatched) {
+  DoublingModel model;
+  // With a long window the batch is only run once it is full.
+  DynamicBatcher batcher(model.GetRunFn(), std::chrono::seconds(10), 4);
+  RunConcurrentRequests(batcher, 4, {3});
+  ASSERT_EQ(model.batch_sizes, std::vector<int64_t>{4});
+}
+
+TEST(DynamicBatcherTest, WindowExpires) {
+  DoublingModel model;
+  DynamicBatcher batcher(model.GetRunFn(), std::chrono::milliseconds(1), 0);
+  RunConcurrentRequests(batcher, 8, {3});
+  int64_t total = 0;
+  for (auto batch_size : model.batch_sizes) {
+    total += batch_size;
+  }
+  ASSERT_EQ(total, 8);
+}
+
+TEST(DynamicBatcherTest, MismatchedShapesAreNotBatched) {
+  DoublingModel model;
+  DynamicBatcher batcher(model.GetRunFn(), std::chrono::milliseconds(50), 2);
+  RunConcurrentRequests(batcher, 4, {2, 3});
+  for (auto batch_size : model.batch_sizes) {
+    ASSERT_LE(batch_size, 2);
+  }
+}
+
+TEST(DynamicBatcherTest, OutputsWithoutBatchDimensionAreRunOneByOne) {
+  DoublingModel model;
+  model.reduce_output = true;
+  DynamicBatcher batcher(model.GetRunFn(), std::chrono::seconds(10), 2);
+  RunConcurrentRequests(batcher, 2, {3});
+  // One batched run whose output can not be split, then each request on its own.
+  ASSERT_EQ(model.batch_sizes, (std::vector<int64_t>{2, 1, 1}));
+}
+
+TEST(DynamicBatcherTest, FetchesAreViewsOfTheBatchedFetches) {
+  DoublingModel model;
+  DynamicBatcher batcher(model.GetRunFn(), std::chrono::seconds(10), 2);
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<std::vector<OrtValue>> fetches(2);
+  std::vector<std::thread> threads;
+  for (int r = 0; r < 2; ++r) {
+    threads.emplace_back([&, r]() {
+      std::vector<OrtValue> feeds(1);
+      CreateMLValue<float>(allocator, {1, 3}, std::vector<float>(3, static_cast<float>(r)), &feeds[0]);
+      EXPECT_STATUS_OK(batcher.Run(RunOptions{}, kFeedNames, feeds, kOutputNames, fetches[r]));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(model.batch_sizes, std::vector<int64_t>{2});
+
+  // The rows of the requests follow each other in the batched output, in the order in which they joined the batch.
+  const float* batched_output = model.outputs[0];
+  const float* y0 = fetches[0][0].Get<Tensor>().Data<float>();
+  const float* y1 = fetches[1][0].Get<Tensor>().Data<float>();
+  EXPECT_TRUE((y0 == batched_output && y1 == batched_output + 3) || (y1 == batched_output && y0 == batched_output + 3));
+
+  // Each view keeps the batched output alive.
+  fetches[0].clear();
+  EXPECT_EQ(fetches[1][0].Get<Tensor>().Shape(), TensorShape({1, 3}));
+  for (float value : fetches[1][0].Get<Tensor>().DataAsSpan<float>()) {
+    EXPECT_EQ(value, 2.0f);
+  }
+}
+
+TEST(DynamicBatcherTest, PreallocatedFetchesAreNotBatched) {
+  DoublingModel model;
+  DynamicBatcher batcher(model.GetRunFn(), std::chrono::seconds(10), 2);
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {1, 3}, {1.0f, 2.0f, 3.0f}, &feeds[0]);
+  std::vector<OrtValue> fetches(1);
+  AllocateMLValue<float>(allocator, {1, 3}, &fetches[0]);
+  // Runs immediately, without waiting for the window.
+  ASSERT_TRUE(batcher.Run(RunOptions{}, kFeedNames, feeds, kOutputNames, fetches).IsOK());
+  ASSERT_EQ(model.batch_sizes, std::vector<int64_t>{1});
+  ASSERT_FALSE(DynamicBatcher::IsRunningBatch());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/ep_context_package.h"
+
+#include <fstream>
+
+#include "core/graph/constants.h"
+#include "core/graph/model.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/temp_dir.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+Node& AddEpContextNode(Graph& graph, const std::string& name, int64_t embed_mode) {
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto& input = graph.GetOrCreateNodeArg(name + "_input", &float_tensor);
+  auto& output = graph.GetOrCreateNodeArg(name + "_output", &float_tensor);
+  Node& node = graph.AddNode(name, ep_context::kEpContextOp, "", {&input}, {&output}, nullptr, kMSDomain);
+  node.AddAttribute(ep_context::kEmbedMode, embed_mode);
+  return node;
+}
+
+std::string_view GetBlob(const ep_context::Variant* variant) {
+  return variant == nullptr ? std::string_view{"none"} : variant->cache_context;
+}
+}  // namespace
+
+TEST(EpContextPackageTest, SelectsVariant) {
+  Model model("ep_context_package", false, DefaultLoggingManager().DefaultLogger());
+  Node& node = AddEpContextNode(model.MainGraph(), "ep_context", 1);
+  ep_context::AddVariant(node, "sm80", "10.0", "sm80 10.0");
+  ep_context::AddVariant(node, "sm90", "10.0", "sm90 10.0");
+  ep_context::AddVariant(node, "sm90", "", "sm90 any");
+  // replaces the first variant added for sm90
+  ep_context::AddVariant(node, "sm90", "10.0", "sm90 10.0 updated");
+
+  InlinedVector<ep_context::Variant> variants;
+  ASSERT_STATUS_OK(ep_context::GetVariants(node, variants));
+  ASSERT_EQ(variants.size(), 3u);
+  EXPECT_EQ(variants[0].cache_context, "sm80 10.0");
+  EXPECT_EQ(variants[1].cache_context, "sm90 10.0 updated");
+
+  EXPECT_EQ(GetBlob(ep_context::SelectVariant(variants, "sm80", "10.0")), "sm80 10.0");
+  EXPECT_EQ(GetBlob(ep_context::SelectVariant(variants, "sm90", "10.0")), "sm90 10.0 updated");
+  EXPECT_EQ(GetBlob(ep_context::SelectVariant(variants, "sm90", "10.1")), "sm90 any");
+  EXPECT_EQ(GetBlob(ep_context::SelectVariant(variants, "sm80", "10.1")), "none");
+  EXPECT_EQ(GetBlob(ep_context::SelectVariant(variants, "sm70", "")), "none");
+  EXPECT_EQ(GetBlob(ep_context::SelectVariant(variants, "", "10.0")), "sm80 10.0");
+}
+
+TEST(EpContextPackageTest, LoadsBlobs) {
+  TemporaryDirectory model_dir(ORT_TSTR("ep_context_package_test"));
+  const std::filesystem::path model_path = std::filesystem::path(model_dir.Path()) / ORT_TSTR("model.onnx");
+  {
+    std::ofstream file(std::filesystem::path(model_dir.Path()) / ORT_TSTR("sm80.bin"), std::ios::binary);
+    file << "sm80 blob";
+  }
+
+  Model model("ep_context_package", false, DefaultLoggingManager().DefaultLogger());
+  Node& embedded_node = AddEpContextNode(model.MainGraph(), "embedded", 1);
+  ep_context::AddVariant(embedded_node, "sm80", "", "embedded blob");
+  InlinedVector<ep_context::Variant> variants;
+  ASSERT_STATUS_OK(ep_context::GetVariants(embedded_node, variants));
+  ep_context::Blob blob;
+  ASSERT_STATUS_OK(ep_context::LoadBlob(embedded_node, variants[0], model_path, blob));
+  EXPECT_EQ(std::string_view(blob.data.data(), blob.data.size()), "embedded blob");
+
+  Node& file_node = AddEpContextNode(model.MainGraph(), "file", 0);
+  ep_context::AddVariant(file_node, "sm80", "", "sm80.bin");
+  ep_context::AddVariant(file_node, "sm90", "", "../sm90.bin");
+  ep_context::AddVariant(file_node, "sm70", "", "sm70.bin");
+  ASSERT_STATUS_OK(ep_context::GetVariants(file_node, variants));
+  ASSERT_EQ(variants.size(), 3u);
+  ASSERT_STATUS_OK(ep_context::LoadBlob(file_node, variants[0], model_path, blob));
+  ASSERT_TRUE(blob.mapped_memory);
+  EXPECT_EQ(std::string_view(blob.data.data(), blob.data.size()), "sm80 blob");
+
+  // outside the directory of the model, and missing
+  EXPECT_EQ(ep_context::LoadBlob(file_node, variants[1], model_path, blob).Code(), common::INVALID_GRAPH);
+  EXPECT_EQ(ep_context::LoadBlob(file_node, variants[2], model_path, blob).Code(), common::INVALID_GRAPH);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
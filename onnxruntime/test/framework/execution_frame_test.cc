@@ -8,6 +8,7 @@
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test_utils.h"
 #include "test/test_environment.h"
 #include "test/framework/TestAllocatorManager.h"
@@ -366,6 +367,128 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   ASSERT_EQ(p->GetBlock(4)->offset_, kAllocAlignment);
 }
 
+TEST_F(ExecutionFrameTest, MemPatternShapeBucketsTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &tensor_float),
+      input_def2("X2", &tensor_float),
+      gemm_out_def("T1", &tensor_float),
+      clip_out_def("T2", &tensor_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "Clip", "clip1", ArgMap{&gemm_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  KernelRegistryManager kernel_registry_manager;
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(xp_type, std::move(cpu_xp)));
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternShapeBuckets,
+                                                              "4,8"));
+  ASSERT_STATUS_OK(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternCacheMaxEntries,
+                                                              "1"));
+
+  SessionState state(graph, execution_providers, &tp_, nullptr, dtm,
+                     DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+
+  ASSERT_STATUS_OK(state.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+  ASSERT_TRUE(state.GetMemoryPatternsAreBucketed());
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+  int x1_idx = -1, x2_idx = -1, t1_idx = -1, t2_idx = -1;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X1", x1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X2", x2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T1", t1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T2", t2_idx).IsOK());
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->CreatePreferredAllocators()[0];
+  const auto& location = cpu_allocator->Info().device;
+
+  // Inputs of a sequence length seq_len.
+  auto create_feeds = [&](int64_t seq_len) {
+    std::vector<OrtValue> feeds(2);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{seq_len, 2},
+                         std::vector<float>(static_cast<size_t>(seq_len * 2), 1.0f), &feeds[0]);
+    CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 32}, std::vector<float>(64, 1.0f), &feeds[1]);
+    return feeds;
+  };
+  auto get_mem_patterns = [&](int64_t seq_len) {
+    std::shared_ptr<const InlinedHashMap<int, TensorShape>> inferred_shapes;
+    return state.GetMemoryPatternGroup(create_feeds(seq_len), AsSpan({x1_idx, x2_idx}), inferred_shapes);
+  };
+
+  // Trace the allocations of a run with a sequence length of 3 and cache the pattern.
+  {
+    auto feeds = create_feeds(3);
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(AsSpan({x1_idx, x2_idx}), feeds, AsSpan({t2_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+    ASSERT_TRUE(frame.HasMemoryPatternPlanner());
+    OrtValue& t1_value = *frame.GetMutableNodeInputOrOutputMLValue(t1_idx);
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1_value, t1_idx, DataTypeImpl::GetType<float>(),
+                                                              location, TensorShape(std::vector<int64_t>{3, 32})));
+    MemoryPatternGroup pattern;
+    ASSERT_STATUS_OK(frame.GeneratePatterns(pattern));
+    ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(feeds, std::move(pattern)));
+  }
+
+  // Smaller sequence lengths of the same bucket use the cached pattern, larger ones do not.
+  auto mem_patterns = get_mem_patterns(2);
+  ASSERT_NE(mem_patterns, nullptr);
+  ASSERT_EQ(get_mem_patterns(3), mem_patterns);
+  ASSERT_EQ(get_mem_patterns(4), nullptr);
+  ASSERT_EQ(get_mem_patterns(5), nullptr);
+
+  // A frame with a smaller sequence length allocates from the planned block.
+  {
+    auto feeds = create_feeds(2);
+    std::vector<OrtValue> outputs;
+    ExecutionFrame frame(AsSpan({x1_idx, x2_idx}), feeds, AsSpan({t2_idx}), outputs, {},
+#ifdef ORT_ENABLE_STREAM
+                         {},
+#endif
+                         state);
+    ASSERT_FALSE(frame.HasMemoryPatternPlanner());
+    OrtValue& t1_value = *frame.GetMutableNodeInputOrOutputMLValue(t1_idx);
+    ASSERT_STATUS_OK(frame.AllocateMLValueTensorSelfOwnBuffer(t1_value, t1_idx, DataTypeImpl::GetType<float>(),
+                                                              location, TensorShape(std::vector<int64_t>{2, 32})));
+    // The tensor does not own its buffer, which is owned by the frame.
+    ASSERT_FALSE(t1_value.Get<Tensor>().OwnsBuffer());
+  }
+
+  // A pattern for larger inputs of the bucket replaces the cached one.
+  ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(create_feeds(4), MemoryPatternGroup{}));
+  ASSERT_NE(get_mem_patterns(3), mem_patterns);
+  ASSERT_NE(get_mem_patterns(3), nullptr);
+
+  // The cache only keeps the most recently used pattern, but patterns in use remain valid.
+  ASSERT_STATUS_OK(state.UpdateMemoryPatternGroupCache(create_feeds(6), MemoryPatternGroup{}));
+  ASSERT_NE(get_mem_patterns(5), nullptr);
+  ASSERT_EQ(get_mem_patterns(3), nullptr);
+  ASSERT_EQ(mem_patterns->patterns.size(), 1u);
+}
+
 #ifdef ENABLE_TRAINING
 TEST_F(ExecutionFrameTest, MemPatternWithExternalOutputsTest) {
   auto cpu_xp = CreateCPUExecutionProvider();
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "core/framework/external_data_compression.h"
+#include "core/platform/threadpool.h"
+#include "core/util/thread_utils.h"
+#include "test/util/include/asserts.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ExternalDataCompressionTest, RoundTrip) {
+  // more than two blocks so the last one is partial
+  std::vector<float> values(2 * utils::kExternalDataCompressionBlockSize / sizeof(float) + 1000);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = std::sin(static_cast<float>(i) * 0.01f);
+  }
+  const auto data = gsl::make_span(reinterpret_cast<const uint8_t*>(values.data()), values.size() * sizeof(float));
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 4;
+  auto thread_pool = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo,
+                                                   concurrency::ThreadPoolType::INTRA_OP);
+
+  for (size_t shuffle_element_size : {size_t{0}, sizeof(float)}) {
+    std::vector<uint8_t> compressed;
+    ASSERT_STATUS_OK(utils::CompressExternalData(data, shuffle_element_size, compressed));
+    EXPECT_LT(compressed.size(), data.size());
+
+    for (concurrency::ThreadPool* tp : {static_cast<concurrency::ThreadPool*>(nullptr), thread_pool.get()}) {
+      std::vector<uint8_t> decompressed(data.size());
+      ASSERT_STATUS_OK(utils::DecompressExternalData(compressed, shuffle_element_size, decompressed, tp));
+      EXPECT_EQ(std::memcmp(decompressed.data(), data.data(), data.size()), 0);
+    }
+  }
+}
+
+TEST(ExternalDataCompressionTest, InvalidData) {
+  std::vector<uint8_t> data(10000, 42);
+  std::vector<uint8_t> compressed;
+  ASSERT_STATUS_OK(utils::CompressExternalData(data, 0, compressed));
+
+  std::vector<uint8_t> decompressed(data.size() + 1);
+  ASSERT_STATUS_NOT_OK(utils::DecompressExternalData(compressed, 0, decompressed));
+
+  decompressed.resize(data.size());
+  compressed.resize(compressed.size() - 1);
+  ASSERT_STATUS_NOT_OK(utils::DecompressExternalData(compressed, 0, decompressed));
+
+  // data can't be shuffled with an element size it is not a multiple of
+  ASSERT_STATUS_NOT_OK(utils::CompressExternalData(gsl::make_span(data).first(9999), 4, compressed));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
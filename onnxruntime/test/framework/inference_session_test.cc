@@ -6,8 +6,11 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <filesystem>
 #include <functional>
 #include <iterator>
+#include <numeric>
+#include <set>
 #include <thread>
 #include <fstream>
 
@@ -44,6 +47,7 @@
 #endif
 #include "core/session/environment.h"
 #include "core/session/IOBinding.h"
+#include "core/session/model_cache.h"
 #include "core/session/inference_session_utils.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
@@ -55,6 +59,7 @@
 #include "test/optimizer/dummy_graph_transformer.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/inference_session_wrapper.h"
+#include "test/util/include/temp_dir.h"
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -496,6 +501,158 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 }
 
+TEST(InferenceSessionTests, OptimizedModelCache) {
+  TemporaryDirectory cache_dir(ORT_TSTR("optimized_model_cache_test"));
+  const ORTCHAR_T* test_model = ORT_TSTR("testdata/transform/abs-id-max.onnx");
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.OptimizedModelCache";
+  so.graph_optimization_level = TransformerLevel::Level1;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigOptimizedModelCacheDir,
+                                                    ToUTF8String(cache_dir.Path()).c_str()));
+
+  auto get_cached_models = [&cache_dir]() {
+    std::set<std::filesystem::path> cached_models;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir.Path())) {
+      cached_models.insert(entry.path());
+    }
+    return cached_models;
+  };
+  auto create_session = [&](const SessionOptions& session_options) {
+    InferenceSessionWrapper session_object{session_options, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(test_model));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    std::map<std::string, int> op_to_count = CountOpsInGraph(session_object.GetGraph());
+    ASSERT_EQ(op_to_count["Identity"] > 0, session_options.graph_optimization_level == TransformerLevel::Default);
+  };
+
+  // The first session saves the optimized model to the cache.
+  create_session(so);
+  const auto cached_models = get_cached_models();
+  ASSERT_EQ(cached_models.size(), 1u);
+  const auto cached_model = *cached_models.begin();
+  ASSERT_EQ(cached_model.extension(), ORT_TSTR(".ort"));
+  const auto cached_model_size = std::filesystem::file_size(cached_model);
+
+  // The second session loads it, and does not save it again.
+  create_session(so);
+  ASSERT_EQ(get_cached_models(), cached_models);
+
+  // Other options do not use the cached model.
+  SessionOptions so_noopt = so;
+  so_noopt.graph_optimization_level = TransformerLevel::Default;
+  create_session(so_noopt);
+  ASSERT_EQ(get_cached_models().size(), 2u);
+
+  // A session falls back to the ONNX model if the cached model is invalid, and does not overwrite it.
+  {
+    std::ofstream cached_model_stream(cached_model, std::ios::binary | std::ios::trunc);
+    cached_model_stream << "invalid";
+  }
+  create_session(so);
+  ASSERT_NE(std::filesystem::file_size(cached_model), cached_model_size);
+}
+
+TEST(InferenceSessionTests, TuningResultsFile) {
+  TemporaryDirectory dir(ORT_TSTR("tuning_results_file_test"));
+  const std::string file_path = ToUTF8String(dir.Path()) + "/tuning_results.json";
+
+  std::vector<TuningResults> loaded;
+  bool file_found = true;
+  ASSERT_STATUS_OK(inference_session_utils::LoadTuningResultsFromFile(file_path, loaded, file_found));
+  ASSERT_FALSE(file_found);
+
+  TuningResults tr_a;
+  tr_a.ep = "TestEP";
+  tr_a.validators = {{"DEVICE_MODEL", "A"}};
+  tr_a.results = {{"TestOp", {{"1_2", 1}}}};
+  TuningResults tr_b = tr_a;
+  tr_b.validators = {{"DEVICE_MODEL", "B"}};
+  tr_b.results = {{"TestOp", {{"1_2", 2}}}};
+
+  auto load_sorted = [&]() {
+    ASSERT_STATUS_OK(inference_session_utils::LoadTuningResultsFromFile(file_path, loaded, file_found));
+    ASSERT_TRUE(file_found);
+    std::sort(loaded.begin(), loaded.end(), [](const TuningResults& lhs, const TuningResults& rhs) {
+      return lhs.validators.at("DEVICE_MODEL") < rhs.validators.at("DEVICE_MODEL");
+    });
+  };
+
+  // The results of other devices are kept, the ones of the same device are replaced.
+  ASSERT_STATUS_OK(inference_session_utils::SaveTuningResultsToFile(file_path, {tr_a}));
+  ASSERT_STATUS_OK(inference_session_utils::SaveTuningResultsToFile(file_path, {tr_b}));
+  tr_a.results["TestOp"]["3_4"] = 0;
+  ASSERT_STATUS_OK(inference_session_utils::SaveTuningResultsToFile(file_path, {tr_a}));
+  load_sorted();
+  ASSERT_EQ(loaded.size(), 2u);
+  ASSERT_EQ(loaded[0].ep, tr_a.ep);
+  ASSERT_EQ(loaded[0].validators, tr_a.validators);
+  ASSERT_EQ(loaded[0].results, tr_a.results);
+  ASSERT_EQ(loaded[1].validators, tr_b.validators);
+  ASSERT_EQ(loaded[1].results, tr_b.results);
+
+  // An invalid file fails to load, and is overwritten by the next save.
+  {
+    std::ofstream file(file_path, std::ios::trunc);
+    file << "invalid";
+  }
+  ASSERT_FALSE(inference_session_utils::LoadTuningResultsFromFile(file_path, loaded, file_found).IsOK());
+  ASSERT_STATUS_OK(inference_session_utils::SaveTuningResultsToFile(file_path, {tr_b}));
+  load_sorted();
+  ASSERT_EQ(loaded.size(), 1u);
+  ASSERT_EQ(loaded[0].results, tr_b.results);
+
+  // The file is replaced by a temporary file, which is not left behind.
+  size_t num_files = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(dir.Path())) {
+    EXPECT_EQ(entry.path().filename(), std::filesystem::path(ORT_TSTR("tuning_results.json")));
+    ++num_files;
+  }
+  EXPECT_EQ(num_files, 1u);
+
+  // A file that cannot be replaced fails the save and is kept.
+  const std::string dir_path = ToUTF8String(dir.Path()) + "/tuning_results_dir";
+  std::filesystem::create_directory(dir_path);
+  std::filesystem::create_directory(dir_path + "/entry");
+  ASSERT_FALSE(inference_session_utils::SaveTuningResultsToFile(dir_path, {tr_a}).IsOK());
+  EXPECT_TRUE(std::filesystem::is_directory(dir_path + "/entry"));
+}
+
+TEST(InferenceSessionTests, TuningResultsFileConcurrentSaves) {
+  TemporaryDirectory dir(ORT_TSTR("tuning_results_file_concurrent_test"));
+  const std::string file_path = ToUTF8String(dir.Path()) + "/tuning_results.json";
+
+  // The saves of the sessions of a process are merged, whatever their order.
+  constexpr int num_threads = 8;
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(num_threads);
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&, i]() {
+      TuningResults tr;
+      tr.ep = "TestEP";
+      tr.validators = {{"DEVICE_MODEL", std::to_string(i)}};
+      tr.results = {{"TestOp", {{"1_2", i}}}};
+      statuses[i] = inference_session_utils::SaveTuningResultsToFile(file_path, {tr});
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& status : statuses) {
+    ASSERT_STATUS_OK(status);
+  }
+
+  std::vector<TuningResults> loaded;
+  bool file_found = false;
+  ASSERT_STATUS_OK(inference_session_utils::LoadTuningResultsFromFile(file_path, loaded, file_found));
+  ASSERT_TRUE(file_found);
+  std::set<std::string> devices;
+  for (const auto& tr : loaded) {
+    devices.insert(tr.validators.at("DEVICE_MODEL"));
+    EXPECT_EQ(tr.results.at("TestOp").at("1_2"), std::stoi(tr.validators.at("DEVICE_MODEL")));
+  }
+  EXPECT_EQ(devices.size(), static_cast<size_t>(num_threads));
+}
+
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
 static bool Compare(const InputDefList& f_arg, const InputDefList& s_arg) {
   if (f_arg.size() != s_arg.size()) {
@@ -741,6 +898,50 @@ TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions2) {
 #endif
 }
 
+// The events flushed as they come in make the same profile as the events written by EndProfiling.
+TEST(InferenceSessionTests, CheckRunProfilerWithFlushInterval) {
+  SessionOptions so;
+
+  so.session_logid = "CheckRunProfilerWithFlushInterval";
+  so.enable_profiling = true;
+  so.profile_file_prefix = ORT_TSTR("onnxprofile_flush_interval_test");
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsProfilingFlushIntervalEvents, "2"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "RunTag";
+
+  RunModel(session_object, run_options);
+  std::string profile_file = session_object.EndProfiling();
+
+  std::ifstream profile(profile_file);
+  ASSERT_TRUE(profile);
+  std::string line;
+  std::vector<std::string> lines;
+
+  while (std::getline(profile, line)) {
+    lines.push_back(line);
+  }
+
+  // model loading, session initialization, the run and its kernels
+  auto size = lines.size();
+  ASSERT_GT(size, 5u);
+  ASSERT_EQ(lines[0], "[");
+  ASSERT_TRUE(lines[1].find("model_loading_uri") != string::npos);
+  ASSERT_EQ(lines[size - 1], "]");
+  std::vector<std::string> tags = {"pid", "dur", "ts", "ph", "X", "name", "args"};
+  for (size_t i = 1; i < size - 1; ++i) {
+    for (auto& s : tags) {
+      ASSERT_TRUE(lines[i].find(s) != string::npos);
+    }
+    // one event per line, separated by commas but the last one
+    ASSERT_EQ(lines[i].back(), i == size - 2 ? '}' : ',');
+  }
+}
+
 TEST(InferenceSessionTests, CheckRunProfilerWithStartProfile) {
   SessionOptions so;
 
@@ -806,6 +1007,544 @@ TEST(InferenceSessionTests, CheckRunProfilerStartTime) {
   ASSERT_TRUE(before_start_time <= profiling_start_time && profiling_start_time <= after_start_time);
 }
 
+TEST(InferenceSessionTests, LatencyHistograms) {
+  SessionOptions so;
+  so.session_logid = "LatencyHistograms";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableLatencyHistograms, "1"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  int64_t latency_ns = -1;
+  ASSERT_STATUS_OK(session_object.GetOpTypeLatencyPercentile("Mul", 50, latency_ns));
+  EXPECT_EQ(latency_ns, 0);
+
+  RunOptions run_options;
+  constexpr int num_runs = 3;
+  for (int i = 0; i < num_runs; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  ASSERT_STATUS_OK(session_object.GetOpTypeLatencyPercentile("Mul", 99, latency_ns));
+  EXPECT_GT(latency_ns, 0);
+  EXPECT_FALSE(session_object.GetOpTypeLatencyPercentile("Conv", 99, latency_ns).IsOK());
+  EXPECT_FALSE(session_object.GetNodeLatencyPercentile("no_such_node", 99, latency_ns).IsOK());
+
+  std::string text;
+  ASSERT_STATUS_OK(session_object.GetLatencyHistogramsPrometheus(text));
+  EXPECT_NE(text.find("# TYPE onnxruntime_node_latency_seconds histogram"), std::string::npos);
+  EXPECT_NE(text.find("onnxruntime_op_type_latency_seconds_count{op_type=\"Mul\"} " + std::to_string(num_runs)),
+            std::string::npos);
+}
+
+// The per input shapes graph capture settings are checked without throwing, and the caller can't use the graph
+// annotation ids the session assigns to the input shapes.
+TEST(InferenceSessionTests, GraphCapturePerInputShapesOptions) {
+  {
+    SessionOptions so;
+    so.session_logid = "GraphCapturePerInputShapesOptions.InvalidMaxGraphs";
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigGraphCaptureMaxGraphs, "many"));
+    InferenceSession session_object(so, GetEnvironment());
+    ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+    const Status status = session_object.Initialize();
+    EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT) << status.ErrorMessage();
+  }
+
+  SessionOptions so;
+  so.session_logid = "GraphCapturePerInputShapesOptions";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigGraphCapturePerInputShapes, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigGraphCaptureMaxGraphs, "2"));
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &x);
+  const NameMLValMap feeds{{"X", x}};
+  const std::vector<std::string> output_names{"Y"};
+  const auto run_with_graph_annotation_id = [&](const char* graph_annotation_id) {
+    RunOptions run_options;
+    EXPECT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigCudaGraphAnnotation,
+                                                               graph_annotation_id));
+    std::vector<OrtValue> fetches;
+    return session_object.Run(run_options, feeds, output_names, &fetches);
+  };
+
+  EXPECT_STATUS_OK(run_with_graph_annotation_id("1"));
+  EXPECT_STATUS_OK(run_with_graph_annotation_id("-1"));
+  for (const char* graph_annotation_id : {"1073741824", "2147483647", "one"}) {
+    const Status status = run_with_graph_annotation_id(graph_annotation_id);
+    EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT) << graph_annotation_id << ": " << status.ErrorMessage();
+  }
+
+  // the shapes of the feeds are only used by the execution providers capturing graphs
+  RunModel(session_object, RunOptions{});
+}
+
+TEST(InferenceSessionTests, LatencyHistogramsDisabled) {
+  SessionOptions so;
+  so.session_logid = "LatencyHistogramsDisabled";
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::string text;
+  EXPECT_FALSE(session_object.GetLatencyHistogramsPrometheus(text).IsOK());
+}
+
+TEST(InferenceSessionTests, ActivationStatistics) {
+  SessionOptions so;
+  so.session_logid = "ActivationStatistics";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigCollectActivationStatistics, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigActivationStatisticsNumBins, "8"));
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  constexpr int num_runs = 2;
+  for (int i = 0; i < num_runs; ++i) {
+    RunModel(session_object, run_options);
+  }
+
+  std::unordered_map<std::string, ActivationStatistics::Snapshot> statistics;
+  ASSERT_STATUS_OK(session_object.GetActivationStatistics(statistics));
+  // Y = X * X with X = [1, 6]
+  ASSERT_EQ(statistics.count("Y"), 1U);
+  const auto& y = statistics.at("Y");
+  EXPECT_EQ(y.count, 6U * num_runs);
+  EXPECT_EQ(y.min, 1.0f);
+  EXPECT_EQ(y.max, 36.0f);
+  ASSERT_EQ(y.histogram.size(), 8U);
+  EXPECT_EQ(std::accumulate(y.histogram.begin(), y.histogram.end(), uint64_t{0}), y.count);
+  // graph inputs are not produced by a node
+  EXPECT_EQ(statistics.count("X"), 0U);
+}
+
+TEST(InferenceSessionTests, ActivationStatisticsDisabled) {
+  SessionOptions so;
+  so.session_logid = "ActivationStatisticsDisabled";
+
+  InferenceSession session_object(so, GetEnvironment());
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::unordered_map<std::string, ActivationStatistics::Snapshot> statistics;
+  EXPECT_FALSE(session_object.GetActivationStatistics(statistics).IsOK());
+}
+
+TEST(InferenceSessionTests, LazyExternalInitializers) {
+  // Y = MatMul(A, B) with B stored as external data
+  const PathString weights_file_name = ORT_TSTR("lazy_external_initializers_test.bin");
+  const std::vector<float> b_values = {1.0f, 2.0f, 3.0f, 4.0f};
+  {
+    std::ofstream weights_file{weights_file_name, std::ios::binary};
+    weights_file.write(reinterpret_cast<const char*>(b_values.data()), b_values.size() * sizeof(float));
+  }
+  auto remove_weights_file = gsl::finally([&weights_file_name]() { std::filesystem::remove(weights_file_name); });
+
+  onnxruntime::Model model("lazy_external_initializers", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("matmul", "MatMul", "MatMul with external weights", {&a, &b}, {&y});
+
+  ONNX_NAMESPACE::TensorProto b_initializer;
+  b_initializer.set_name("B");
+  b_initializer.add_dims(2);
+  b_initializer.add_dims(2);
+  b_initializer.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  b_initializer.set_data_location(ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL);
+  auto* location = b_initializer.add_external_data();
+  location->set_key("location");
+  location->set_value(ToUTF8String(weights_file_name));
+  graph.AddInitializedTensor(b_initializer);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  auto run_model = [&model_data](bool lazy, size_t& prepacks_after_load, size_t& prepacks_after_run,
+                                 PrepackedWeightsContainer* prepacked_weights_container = nullptr,
+                                 size_t* used_shared_prepacked_weights = nullptr) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.LazyExternalInitializers";
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigLazyExternalInitializers,
+                                                      lazy ? "1" : "0"));
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    if (prepacked_weights_container != nullptr) {
+      ASSERT_STATUS_OK(session_object.AddPrePackedWeightsContainer(prepacked_weights_container));
+    }
+    std::stringstream model_stream(model_data);
+    ASSERT_STATUS_OK(session_object.Load(model_stream));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    prepacks_after_load = session_object.GetSessionState().GetNumberOfPrepacksCounter();
+
+    OrtValue a_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {1, 2}, {1.0f, 1.0f},
+                         &a_value);
+    NameMLValMap feeds{{"A", a_value}};
+    std::vector<std::string> output_names{"Y"};
+    std::vector<OrtValue> fetches;
+    for (int run = 0; run < 2; ++run) {
+      ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+      VerifyOutputs(fetches[0].Get<Tensor>(), {1, 2}, {4.0f, 6.0f});
+    }
+    prepacks_after_run = session_object.GetSessionState().GetNumberOfPrepacksCounter();
+    if (used_shared_prepacked_weights != nullptr) {
+      *used_shared_prepacked_weights = session_object.GetSessionState().GetUsedSharedPrePackedWeightCounter();
+    }
+  };
+
+  size_t prepacks_after_load = 0;
+  size_t prepacks_after_run = 0;
+  run_model(false, prepacks_after_load, prepacks_after_run);
+  const size_t expected_prepacks = prepacks_after_load;
+  EXPECT_EQ(prepacks_after_run, expected_prepacks);
+
+  // B is only loaded and pre-packed when the graph first runs
+  run_model(true, prepacks_after_load, prepacks_after_run);
+  EXPECT_EQ(prepacks_after_load, 0u);
+  EXPECT_EQ(prepacks_after_run, expected_prepacks);
+
+  // the pre-packed B is cached in the container on the first run of a session, and used by the other sessions
+  if (expected_prepacks > 0) {
+    PrepackedWeightsContainer prepacked_weights_container;
+    size_t used_shared_prepacked_weights = 0;
+    run_model(true, prepacks_after_load, prepacks_after_run, &prepacked_weights_container,
+              &used_shared_prepacked_weights);
+    EXPECT_EQ(prepacked_weights_container.GetNumberOfElements(), expected_prepacks);
+    EXPECT_EQ(used_shared_prepacked_weights, 0u);
+
+    run_model(true, prepacks_after_load, prepacks_after_run, &prepacked_weights_container,
+              &used_shared_prepacked_weights);
+    EXPECT_EQ(prepacks_after_load, 0u);
+    EXPECT_EQ(prepacks_after_run, expected_prepacks);
+    EXPECT_EQ(prepacked_weights_container.GetNumberOfElements(), expected_prepacks);
+    EXPECT_EQ(used_shared_prepacked_weights, expected_prepacks);
+  }
+}
+
+TEST(InferenceSessionTests, UpdateInitializers) {
+  // Y = MatMul(A, B), with B pre-packed by the MatMul kernel
+  onnxruntime::Model model("update_initializers", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("matmul", "MatMul", "MatMul with constant weights", {&a, &b}, {&y});
+
+  ONNX_NAMESPACE::TensorProto b_initializer;
+  b_initializer.set_name("B");
+  b_initializer.add_dims(2);
+  b_initializer.add_dims(2);
+  b_initializer.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (float value : {1.0f, 2.0f, 3.0f, 4.0f}) {
+    b_initializer.add_float_data(value);
+  }
+  graph.AddInitializedTensor(b_initializer);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.UpdateInitializers";
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  const size_t prepacks_after_load = session_object.GetSessionState().GetNumberOfPrepacksCounter();
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue a_value;
+  CreateMLValue<float>(allocator, {1, 2}, {1.0f, 1.0f}, &a_value);
+  NameMLValMap feeds{{"A", a_value}};
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+  VerifyOutputs(fetches[0].Get<Tensor>(), {1, 2}, {4.0f, 6.0f});
+
+  // the values must match the initializers they replace
+  OrtValue wrong_shape;
+  CreateMLValue<float>(allocator, {4}, {5.0f, 6.0f, 7.0f, 8.0f}, &wrong_shape);
+  const std::vector<std::string> names{"B"};
+  EXPECT_FALSE(session_object.UpdateInitializers(names, std::vector<OrtValue>{wrong_shape}).IsOK());
+  OrtValue new_b;
+  CreateMLValue<float>(allocator, {2, 2}, {5.0f, 6.0f, 7.0f, 8.0f}, &new_b);
+  const std::vector<OrtValue> values{new_b};
+  EXPECT_FALSE(session_object.UpdateInitializers(std::vector<std::string>{"A"}, values).IsOK());
+
+  ASSERT_STATUS_OK(session_object.UpdateInitializers(names, values));
+  if (prepacks_after_load > 0) {
+    EXPECT_EQ(session_object.GetSessionState().GetNumberOfPrepacksCounter(), 2 * prepacks_after_load);
+  }
+
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(RunOptions{}, feeds, output_names, &fetches));
+  VerifyOutputs(fetches[0].Get<Tensor>(), {1, 2}, {12.0f, 14.0f});
+}
+
+TEST(InferenceSessionTests, RecordedExecution) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RecordedExecution";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigRecordExecution, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // the first run is recorded and the following ones are replayed
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options, true);
+
+  // a replay reads the new inputs
+  SessionOptions reference_so;
+  reference_so.session_logid = "InferenceSessionTests.RecordedExecution.Reference";
+  InferenceSession reference_session{reference_so, GetEnvironment()};
+  ASSERT_STATUS_OK(reference_session.Load(MODEL_URI));
+  ASSERT_STATUS_OK(reference_session.Initialize());
+
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {3, 2},
+                       {6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f}, &x);
+  NameMLValMap feeds{{"X", x}};
+  std::vector<std::string> output_names{"Y"};
+  std::vector<OrtValue> fetches;
+  std::vector<OrtValue> expected_fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+  ASSERT_STATUS_OK(reference_session.Run(run_options, feeds, output_names, &expected_fetches));
+  const auto& expected = expected_fetches[0].Get<Tensor>();
+  const auto expected_dims = expected.Shape().GetDims();
+  VerifyOutputs(fetches[0].Get<Tensor>(), std::vector<int64_t>(expected_dims.begin(), expected_dims.end()),
+                std::vector<float>(expected.Data<float>(), expected.Data<float>() + expected.Shape().Size()));
+
+  RunModel(session_object, run_options);
+}
+
+TEST(InferenceSessionTests, PreparedRun) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.PreparedRun";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<std::string> feed_names{"X"};
+  std::vector<std::string> output_names{"Y"};
+  std::unique_ptr<PreparedRun> prepared_run;
+  ASSERT_STATUS_OK(session_object.PrepareRun(feed_names, output_names, prepared_run));
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, dims_mul_x, values_mul_x, &feeds[0]);
+
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(run_options, *prepared_run, feeds, fetches));
+  VerifyOutputs(fetches, dims_mul_x, expected_values_mul_y);
+
+  // the outputs are written to pre-allocated fetches
+  std::vector<OrtValue> preallocated_fetches(1);
+  CreateMLValue<float>(allocator, dims_mul_x, std::vector<float>(6, 0.0f), &preallocated_fetches[0]);
+  ASSERT_STATUS_OK(session_object.Run(run_options, *prepared_run, feeds, preallocated_fetches));
+  VerifyOutputs(preallocated_fetches, dims_mul_x, expected_values_mul_y);
+
+  // the feeds are still validated against the types of the inputs
+  std::vector<OrtValue> int_feeds(1);
+  CreateMLValue<int32_t>(allocator, dims_mul_x, {1, 2, 3, 4, 5, 6}, &int_feeds[0]);
+  fetches.clear();
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, int_feeds, fetches).IsOK());
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, gsl::span<const OrtValue>{}, fetches).IsOK());
+
+  std::vector<std::string> invalid_feed_names{"Z"};
+  std::unique_ptr<PreparedRun> invalid_prepared_run;
+  ASSERT_FALSE(session_object.PrepareRun(invalid_feed_names, output_names, invalid_prepared_run).IsOK());
+  ASSERT_FALSE(session_object.PrepareRun(feed_names, std::vector<std::string>{}, invalid_prepared_run).IsOK());
+}
+
+TEST(InferenceSessionTests, RunBatch) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunBatch";
+  so.intra_op_param.thread_pool_size = 4;
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  std::vector<NameMLValMap> feeds(8);
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    OrtValue ml_value;
+    CreateMLValue<float>(allocator, dims_mul_x, std::vector<float>(6, static_cast<float>(i)), &ml_value);
+    feeds[i].insert(std::make_pair("X", ml_value));
+  }
+
+  RunOptions run_options;
+  std::vector<std::string> output_names{"Y"};
+  std::vector<std::vector<OrtValue>> fetches;
+  ASSERT_STATUS_OK(session_object.RunBatch(run_options, feeds, output_names, &fetches));
+  ASSERT_EQ(feeds.size(), fetches.size());
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    VerifyOutputs(fetches[i], dims_mul_x, std::vector<float>(6, static_cast<float>(i * i)));
+  }
+
+  // a request that fails fails the batch
+  OrtValue int_value;
+  CreateMLValue<int32_t>(allocator, dims_mul_x, {1, 2, 3, 4, 5, 6}, &int_value);
+  feeds[3]["X"] = int_value;
+  ASSERT_FALSE(session_object.RunBatch(run_options, feeds, output_names, &fetches).IsOK());
+}
+
+TEST(InferenceSessionTests, EnvModelCache) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.EnvModelCache";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseEnvModelCache, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+  InferenceSession other_session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(other_session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(other_session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+  RunModel(other_session_object, run_options);
+
+  // the sessions hold the model, which is not parsed again
+  std::shared_ptr<const CachedModel> cached_model;
+  std::shared_ptr<const CachedModel> other_cached_model;
+  ASSERT_STATUS_OK(GetEnvironment().GetModelCache().GetOrLoad(MODEL_URI, cached_model));
+  ASSERT_STATUS_OK(GetEnvironment().GetModelCache().GetOrLoad(MODEL_URI, other_cached_model));
+  ASSERT_EQ(cached_model, other_cached_model);
+}
+
+TEST(InferenceSessionTests, Clone) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.Clone";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  std::unique_ptr<InferenceSession> clone;
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_FALSE(session_object.Clone(clone).IsOK());
+  ASSERT_STATUS_OK(session_object.Initialize());
+  ASSERT_STATUS_OK(session_object.Clone(clone));
+
+  // the clone runs the kernels of the session without being initialized again
+  ASSERT_EQ(&clone->GetSessionState(), &session_object.GetSessionState());
+
+  std::thread thread1{[&session_object]() {
+    RunOptions run_options;
+    run_options.run_tag = "session";
+    RunModel(session_object, run_options);
+  }};
+
+  std::thread thread2{[&clone]() {
+    RunOptions run_options;
+    run_options.run_tag = "clone";
+    RunModel(*clone, run_options);
+  }};
+
+  thread1.join();
+  thread2.join();
+}
+
+// the requests of a batch run large MatMuls, whose kernels run parallel loops on the intra op threads
+TEST(InferenceSessionTests, RunBatchParallelKernels) {
+  onnxruntime::Model model("run_batch_matmul", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("matmul", "MatMul", "MatMul of the inputs", {&a, &b}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.RunBatchParallelKernels";
+  so.intra_op_param.thread_pool_size = 4;
+  InferenceSession session_object{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session_object.Load(model_stream));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  constexpr int64_t n = 256;
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue b_value;
+  CreateMLValue<float>(allocator, {n, n}, std::vector<float>(n * n, 1.0f), &b_value);
+  std::vector<NameMLValMap> feeds(8);
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    OrtValue a_value;
+    CreateMLValue<float>(allocator, {n, n}, std::vector<float>(n * n, static_cast<float>(i + 1)), &a_value);
+    feeds[i] = {{"A", a_value}, {"B", b_value}};
+  }
+
+  std::vector<std::string> output_names{"Y"};
+  std::vector<std::vector<OrtValue>> fetches;
+  ASSERT_STATUS_OK(session_object.RunBatch(RunOptions{}, feeds, output_names, &fetches));
+  ASSERT_EQ(feeds.size(), fetches.size());
+  for (size_t i = 0; i < fetches.size(); ++i) {
+    VerifyOutputs(fetches[i], {n, n}, std::vector<float>(n * n, static_cast<float>((i + 1) * n)));
+  }
+}
+
+TEST(InferenceSessionTests, FailOnArenaAllocation) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.FailOnArenaAllocation";
+  so.enable_cpu_mem_arena = true;
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], dims_mul_x, values_mul_x, &x);
+  NameMLValMap feeds{{"X", x}};
+  std::vector<std::string> output_names{"Y"};
+
+  RunOptions run_options;
+  ASSERT_STATUS_OK(run_options.config_options.AddConfigEntry(kOrtRunOptionsConfigFailOnArenaAllocation, "1"));
+
+  // the first run extends the arena of the session
+  std::vector<OrtValue> fetches;
+  auto status = session_object.Run(run_options, feeds, output_names, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr(kOrtRunOptionsConfigFailOnArenaAllocation));
+
+  // once warmed up, the runs are served by the arena
+  fetches.clear();
+  ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+  VerifyOutputs(fetches, dims_mul_x, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+}
+
 TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   SessionOptions session_options;
 
@@ -1073,6 +1812,68 @@ TEST(InferenceSessionTests, TestIOBindingReuse) {
   }
 }
 
+TEST(InferenceSessionTests, TestIOBindingState) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.TestIOBindingState";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue initial_value;
+  CreateMLValue<float>(allocator, dims_mul_x, values_mul_x, &initial_value);
+
+  unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session_object.NewIOBinding(&io_binding));
+  ASSERT_STATUS_OK(io_binding->BindState("X", "Y", initial_value));
+
+  // the output of each run is the input of the next one, the expected values are computed with plain runs
+  std::vector<OrtValue> expected(1, initial_value);
+  std::vector<std::string> output_names{"Y"};
+  const float* first_output = nullptr;
+  RunOptions run_options;
+  for (int run = 0; run < 4; ++run) {
+    NameMLValMap feeds{{"X", expected[0]}};
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session_object.Run(run_options, feeds, output_names, &fetches));
+    expected = fetches;
+
+    ASSERT_STATUS_OK(session_object.Run(run_options, *io_binding));
+    ASSERT_EQ(io_binding->GetInputs().size(), 1u);
+    const auto& state = io_binding->GetInputs()[0].Get<Tensor>();
+    const auto& expected_state = expected[0].Get<Tensor>();
+    ASSERT_EQ(state.Shape(), expected_state.Shape());
+    for (int64_t i = 0; i < state.Shape().Size(); ++i) {
+      EXPECT_EQ(state.Data<float>()[i], expected_state.Data<float>()[i]);
+    }
+
+    // the bound output is the state computed by the run, not the buffer the next run writes to
+    ASSERT_EQ(io_binding->GetOutputs().size(), 1u);
+    EXPECT_EQ(io_binding->GetOutputs()[0].Get<Tensor>().Data<float>(), state.Data<float>());
+
+    // the buffers of the state are reused from the third run on
+    if (run == 0) {
+      first_output = state.Data<float>();
+    } else if (run == 2) {
+      EXPECT_EQ(state.Data<float>(), first_output);
+    }
+  }
+
+  // a failed run keeps the state, and unsets the output which may be partially written
+  const float* state_data = io_binding->GetInputs()[0].Get<Tensor>().Data<float>();
+  run_options.terminate = true;
+  ASSERT_FALSE(session_object.Run(run_options, *io_binding).IsOK());
+  EXPECT_EQ(io_binding->GetInputs()[0].Get<Tensor>().Data<float>(), state_data);
+  EXPECT_FALSE(io_binding->GetOutputs()[0].IsAllocated());
+
+  // the initial value is not written to
+  auto initial_span = initial_value.Get<Tensor>().DataAsSpan<float>();
+  EXPECT_TRUE(std::equal(initial_span.begin(), initial_span.end(), values_mul_x.begin()));
+}
+
 TEST(InferenceSessionTests, InvalidInputTypeOfTensorElement) {
   SessionOptions so;
 
@@ -6,7 +6,10 @@
 #include <gtest/gtest.h>
 
 #include "asserts.h"
+#include "core/framework/kernel_type_str_resolver.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
+#include "test/test_environment.h"
 
 namespace onnxruntime::test {
 
@@ -101,4 +104,46 @@ TEST(KernelRegistryTests, two_versions4) {
   ASSERT_STATUS_NOT_OK(RegKernels(r, function_table, CreateFakeKernel));
 }
 
+// The kernels found for nodes are cached by op, version and types, which must not mix up nodes of different types.
+TEST(KernelRegistryTests, find_kernel_cached) {
+  KernelRegistry r;
+  std::vector<std::unique_ptr<KernelDef>> function_table;
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<float>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  function_table.emplace_back(KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()).SetName("Elu").SetDomain("").SinceVersion(6).Provider(kCpuExecutionProvider).Build());
+  ASSERT_STATUS_OK(RegKernels(r, function_table, CreateFakeKernel));
+
+  Model model("kernel_registry_test", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_type;
+  float_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  ONNX_NAMESPACE::TypeProto double_type;
+  double_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_DOUBLE);
+  auto add_elu = [&graph](const std::string& name, const ONNX_NAMESPACE::TypeProto& type) -> Node& {
+    auto& input = graph.GetOrCreateNodeArg(name + "_X", &type);
+    auto& output = graph.GetOrCreateNodeArg(name + "_Y", &type);
+    return graph.AddNode(name, "Elu", "", {&input}, {&output});
+  };
+  Node& float_node = add_elu("float_elu", float_type);
+  Node& float_node2 = add_elu("float_elu2", float_type);
+  Node& double_node = add_elu("double_elu", double_type);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  const OpSchemaKernelTypeStrResolver kernel_type_str_resolver{};
+  const KernelCreateInfo* float_info = nullptr;
+  const KernelCreateInfo* float_info2 = nullptr;
+  const KernelCreateInfo* double_info = nullptr;
+  const KernelCreateInfo* double_info2 = nullptr;
+  ASSERT_STATUS_OK(r.TryFindKernel(float_node, kCpuExecutionProvider, kernel_type_str_resolver, &float_info));
+  ASSERT_STATUS_OK(r.TryFindKernel(float_node2, kCpuExecutionProvider, kernel_type_str_resolver, &float_info2));
+  ASSERT_STATUS_OK(r.TryFindKernel(double_node, kCpuExecutionProvider, kernel_type_str_resolver, &double_info));
+  ASSERT_STATUS_OK(r.TryFindKernel(double_node, kCpuExecutionProvider, kernel_type_str_resolver, &double_info2));
+
+  EXPECT_EQ(float_info, float_info2);
+  EXPECT_EQ(double_info, double_info2);
+  EXPECT_NE(float_info, double_info);
+  EXPECT_EQ(float_info->kernel_def->TypeConstraints().at("T")[0], DataTypeImpl::GetTensorType<float>());
+  EXPECT_EQ(double_info->kernel_def->TypeConstraints().at("T")[0], DataTypeImpl::GetTensorType<double>());
+}
+
 }  // namespace onnxruntime::test
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/flatbuffers/flatbuffers_utils.h"
+#include "core/flatbuffers/ort_format_version.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/data_types.h"
 #include "core/framework/tensorprotoutils.h"
@@ -322,6 +324,134 @@ TEST(OrtModelOnlyTests, SerializeToOrtFormat) {
   RunOrtModel(test_info);
 }
 
+// save with the initializers in an aligned data section and run the model from a memory mapped file
+TEST(OrtModelOnlyTests, SerializeToOrtFormatWithAlignedInitializers) {
+  const auto ort_file = ORT_TSTR("testdata/mnist.onnx.aligned_initializers.test_output.ort");
+  {
+    SessionOptions so;
+    so.session_logid = "SerializeToOrtFormatWithAlignedInitializers";
+    so.optimized_model_filepath = ort_file;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigSaveOrtModelAlignedInitializers, "1"));
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/mnist.onnx")));
+    ASSERT_STATUS_OK(session_object.Initialize());
+  }
+
+  size_t num_bytes = 0;
+  ASSERT_STATUS_OK(Env::Default().GetFileLength(ort_file, num_bytes));
+  std::vector<uint8_t> model_bytes(num_bytes);
+  std::ifstream bytes_stream(ort_file, std::ifstream::in | std::ifstream::binary);
+  bytes_stream.read(reinterpret_cast<char*>(model_bytes.data()), num_bytes);
+  bytes_stream.close();
+
+  gsl::span<const uint8_t> flatbuffer, data_section;
+  ASSERT_STATUS_OK(fbs::utils::SplitOrtFormatModelBytes(model_bytes, flatbuffer, data_section));
+  ASSERT_FALSE(data_section.empty());
+  EXPECT_EQ((data_section.data() - model_bytes.data()) % fbs::utils::kOrtFormatDataSectionAlignment, 0);
+  ASSERT_TRUE(fbs::InferenceSessionBufferHasIdentifier(flatbuffer.data()));
+  EXPECT_EQ(fbs::GetInferenceSession(flatbuffer.data())->ort_version()->str(),
+            std::to_string(kOrtModelVersionWithDataSection));
+
+  // every initializer stored in the data section is at an aligned offset
+  const auto* fbs_graph = fbs::GetInferenceSession(flatbuffer.data())->model()->graph();
+  size_t num_in_data_section = 0;
+  for (const auto* fbs_tensor : *fbs_graph->initializers()) {
+    if (fbs_tensor->external_data_offset() >= 0) {
+      EXPECT_EQ(fbs_tensor->external_data_offset() % fbs::utils::kOrtFormatInitializerAlignment, 0);
+      ++num_in_data_section;
+    }
+  }
+  EXPECT_GT(num_in_data_section, size_t{0});
+
+  OrtValue ml_value;
+  std::vector<float> data(28 * 28, 1.0f);
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {1, 1, 28, 28}, data,
+                       &ml_value);
+
+  std::vector<OrtValue> expected_fetches;
+  {
+    SessionOptions so;
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/mnist.onnx")));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_STATUS_OK(session_object.Run({{"Input3", ml_value}}, {"Plus214_Output_0"}, &expected_fetches));
+  }
+
+  OrtModelTestInfo test_info;
+  test_info.model_filename = ort_file;
+  test_info.logid = "SerializeToOrtFormatWithAlignedInitializers";
+  test_info.configs.push_back(std::make_pair(kOrtSessionOptionsConfigMapOrtModelFile, "1"));
+  test_info.inputs.insert(std::make_pair("Input3", ml_value));
+  test_info.output_names = {"Plus214_Output_0"};
+  test_info.output_verifier = [&expected_fetches](const std::vector<OrtValue>& fetches) {
+    const auto& expected = expected_fetches[0].Get<Tensor>();
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), expected.Shape());
+    for (int64_t i = 0; i < output.Shape().Size(); ++i) {
+      EXPECT_NEAR(output.Data<float>()[i], expected.Data<float>()[i], 1e-4f);
+    }
+  };
+
+  RunOrtModel(test_info);
+}
+
+// a model saved without a data section keeps the ORT format version older runtimes load
+TEST(OrtModelOnlyTests, SerializeToOrtFormatWithoutDataSection) {
+  const auto ort_file = ORT_TSTR("testdata/mnist.onnx.no_data_section.test_output.ort");
+  {
+    SessionOptions so;
+    so.session_logid = "SerializeToOrtFormatWithoutDataSection";
+    so.optimized_model_filepath = ort_file;
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/mnist.onnx")));
+    ASSERT_STATUS_OK(session_object.Initialize());
+  }
+
+  size_t num_bytes = 0;
+  ASSERT_STATUS_OK(Env::Default().GetFileLength(ort_file, num_bytes));
+  std::vector<uint8_t> model_bytes(num_bytes);
+  std::ifstream bytes_stream(ort_file, std::ifstream::in | std::ifstream::binary);
+  bytes_stream.read(reinterpret_cast<char*>(model_bytes.data()), num_bytes);
+  bytes_stream.close();
+
+  gsl::span<const uint8_t> flatbuffer, data_section;
+  ASSERT_STATUS_OK(fbs::utils::SplitOrtFormatModelBytes(model_bytes, flatbuffer, data_section));
+  EXPECT_TRUE(data_section.empty());
+  EXPECT_EQ(flatbuffer.size(), model_bytes.size());
+  ASSERT_TRUE(fbs::InferenceSessionBufferHasIdentifier(flatbuffer.data()));
+  EXPECT_EQ(fbs::GetInferenceSession(flatbuffer.data())->ort_version()->str(), std::to_string(kOrtModelVersion));
+
+  OrtValue ml_value;
+  std::vector<float> data(28 * 28, 1.0f);
+  CreateMLValue<float>(TestCPUExecutionProvider()->CreatePreferredAllocators()[0], {1, 1, 28, 28}, data,
+                       &ml_value);
+
+  std::vector<OrtValue> expected_fetches;
+  {
+    SessionOptions so;
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/mnist.onnx")));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_STATUS_OK(session_object.Run({{"Input3", ml_value}}, {"Plus214_Output_0"}, &expected_fetches));
+  }
+
+  OrtModelTestInfo test_info;
+  test_info.model_filename = ort_file;
+  test_info.logid = "SerializeToOrtFormatWithoutDataSection";
+  test_info.inputs.insert(std::make_pair("Input3", ml_value));
+  test_info.output_names = {"Plus214_Output_0"};
+  test_info.output_verifier = [&expected_fetches](const std::vector<OrtValue>& fetches) {
+    const auto& expected = expected_fetches[0].Get<Tensor>();
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), expected.Shape());
+    for (int64_t i = 0; i < output.Shape().Size(); ++i) {
+      EXPECT_NEAR(output.Data<float>()[i], expected.Data<float>()[i], 1e-4f);
+    }
+  };
+
+  RunOrtModel(test_info);
+}
+
 TEST(OrtModelOnlyTests, SparseInitializerHandling) {
   const auto ort_file = ORT_TSTR("testdata/ort_minimal_test_models/sparse_initializer_handling.onnx.test_output.ort");
   SaveAndCompareModels(ORT_TSTR("testdata/ort_minimal_test_models/sparse_initializer_handling.onnx"), ort_file);
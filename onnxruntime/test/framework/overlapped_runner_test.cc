@@ -0,0 +1,244 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/overlapped_runner.h"
+
+#include <chrono>
+#include <sstream>
+
+#include "core/framework/data_transfer.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Computes Y = X * 2, recording the address of the feed of each call.
+struct DoubleModel {
+  Status Run(const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string>, std::vector<OrtValue>& fetches) {
+    const auto& x = feeds[0].Get<Tensor>();
+    {
+      std::lock_guard<OrtMutex> lock(mutex);
+      feed_addresses.push_back(x.DataRaw());
+    }
+    if (on_run) {
+      ORT_RETURN_IF_ERROR(on_run(feed_addresses.size() - 1));
+    }
+
+    fetches.resize(1);
+    AllocateMLValue<float>(allocator, std::vector<int64_t>(x.Shape().GetDims().begin(), x.Shape().GetDims().end()),
+                           &fetches[0]);
+    auto y = fetches[0].GetMutable<Tensor>()->MutableDataAsSpan<float>();
+    auto x_data = x.DataAsSpan<float>();
+    for (size_t i = 0; i < x_data.size(); ++i) {
+      y[i] = 2.0f * x_data[i];
+    }
+    return Status::OK();
+  }
+
+  OverlappedRunner::RunFn GetRunFn() {
+    return [this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                  gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                  std::vector<OrtValue>& fetches) {
+      return Run(run_options, feed_names, feeds, output_names, fetches);
+    };
+  }
+
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  std::function<Status(size_t)> on_run;
+  OrtMutex mutex;
+  std::vector<const void*> feed_addresses;
+};
+
+struct Results {
+  void Add(size_t index, Status status, std::vector<OrtValue> fetches) {
+    std::lock_guard<OrtMutex> lock(mutex);
+    statuses[index] = std::move(status);
+    outputs[index] = std::move(fetches);
+  }
+
+  OrtMutex mutex;
+  std::vector<Status> statuses;
+  std::vector<std::vector<OrtValue>> outputs;
+};
+
+const std::vector<std::string> kFeedNames{"X"};
+const std::vector<std::string> kOutputNames{"Y"};
+
+void SubmitRequests(OverlappedRunner& runner, size_t num_requests, Results& results) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  results.statuses.resize(num_requests);
+  results.outputs.resize(num_requests);
+  for (size_t r = 0; r < num_requests; ++r) {
+    std::vector<OrtValue> feeds(1);
+    CreateMLValue<float>(allocator, {2}, {static_cast<float>(r), 1.0f}, &feeds[0]);
+    ASSERT_STATUS_OK(runner.RunAsync(RunOptions{}, kFeedNames, std::move(feeds), kOutputNames,
+                                     [&results, r](Status status, std::vector<OrtValue> fetches) {
+                                       results.Add(r, std::move(status), std::move(fetches));
+                                     }));
+  }
+  runner.Wait();
+}
+
+void ExpectResult(const Results& results, size_t r) {
+  ASSERT_STATUS_OK(results.statuses[r]);
+  ASSERT_EQ(results.outputs[r].size(), 1u);
+  auto y = results.outputs[r][0].Get<Tensor>().DataAsSpan<float>();
+  ASSERT_EQ(y.size(), 2u);
+  EXPECT_EQ(y[0], 2.0f * static_cast<float>(r));
+  EXPECT_EQ(y[1], 2.0f);
+}
+
+class OverlappedRunnerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_STATUS_OK(data_transfer_manager_.RegisterDataTransfer(std::make_unique<CPUDataTransfer>()));
+  }
+
+  OverlappedRunner::CopyFn GetCopyFn() {
+    return OverlappedRunner::CreateCopyFn(data_transfer_manager_, std::make_shared<CPUAllocator>());
+  }
+
+  DataTransferManager data_transfer_manager_;
+};
+}  // namespace
+
+TEST_F(OverlappedRunnerTest, RequestsComplete) {
+  DoubleModel model;
+  Results results;
+  {
+    OverlappedRunner runner(model.GetRunFn(), GetCopyFn(), GetCopyFn(), 2);
+    SubmitRequests(runner, 5, results);
+  }
+  for (size_t r = 0; r < 5; ++r) {
+    ExpectResult(results, r);
+  }
+}
+
+TEST_F(OverlappedRunnerTest, UploadOverlapsCompute) {
+  DoubleModel model;
+  OrtMutex mutex;
+  OrtCondVar cv;
+  bool uploaded_next = false;
+  bool overlapped = false;
+
+  // the first run only finishes once the feeds of the second request were uploaded
+  model.on_run = [&](size_t call) {
+    if (call == 0) {
+      std::unique_lock<OrtMutex> lock(mutex);
+      overlapped = cv.wait_for(lock, std::chrono::seconds(10), [&]() { return uploaded_next; });
+    }
+    return Status::OK();
+  };
+  auto copy_fn = GetCopyFn();
+  size_t num_uploads = 0;
+  auto copy_inputs = [&](gsl::span<const OrtValue> src, std::vector<OrtValue>& dst) {
+    ORT_RETURN_IF_ERROR(copy_fn(src, dst));
+    if (++num_uploads == 2) {
+      std::lock_guard<OrtMutex> lock(mutex);
+      uploaded_next = true;
+      cv.notify_all();
+    }
+    return Status::OK();
+  };
+
+  Results results;
+  OverlappedRunner runner(model.GetRunFn(), copy_inputs, GetCopyFn(), 2);
+  SubmitRequests(runner, 2, results);
+  EXPECT_TRUE(overlapped);
+  ExpectResult(results, 0);
+  ExpectResult(results, 1);
+}
+
+TEST_F(OverlappedRunnerTest, SlotFeedsAreReused) {
+  DoubleModel model;
+  Results results;
+  OverlappedRunner runner(model.GetRunFn(), GetCopyFn(), GetCopyFn(), 1);
+  SubmitRequests(runner, 3, results);
+  ASSERT_EQ(model.feed_addresses.size(), 3u);
+  EXPECT_EQ(model.feed_addresses[0], model.feed_addresses[1]);
+  EXPECT_EQ(model.feed_addresses[1], model.feed_addresses[2]);
+  ExpectResult(results, 2);
+}
+
+TEST_F(OverlappedRunnerTest, FailedRequestDoesNotStopOthers) {
+  DoubleModel model;
+  model.on_run = [](size_t call) {
+    return call == 1 ? ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "run failure") : Status::OK();
+  };
+  Results results;
+  OverlappedRunner runner(model.GetRunFn(), GetCopyFn(), GetCopyFn(), 2);
+  SubmitRequests(runner, 3, results);
+  ExpectResult(results, 0);
+  EXPECT_FALSE(results.statuses[1].IsOK());
+  EXPECT_TRUE(results.outputs[1].empty());
+  ExpectResult(results, 2);
+}
+
+// a session computing Y = X + X runs the requests, with feeds of different shapes
+TEST_F(OverlappedRunnerTest, SessionRunner) {
+  onnxruntime::Model model("overlapped_runner_add", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add", "Add", "Add of the input to itself", {&x, &x}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  SessionOptions so;
+  so.session_logid = "OverlappedRunnerTest.SessionRunner";
+  InferenceSession session{so, GetEnvironment()};
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+  ASSERT_STATUS_OK(session.Initialize());
+
+  // the session has no GPU allocator
+  std::unique_ptr<OverlappedRunner> runner;
+  const OrtMemoryInfo gpu_memory_info("Cuda", OrtDeviceAllocator,
+                                      OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0));
+  EXPECT_FALSE(OverlappedRunner::Create(session, gpu_memory_info, 2, runner).IsOK());
+  ASSERT_STATUS_OK(OverlappedRunner::Create(session, OrtMemoryInfo(CPU, OrtDeviceAllocator), 2, runner));
+
+  constexpr size_t num_requests = 6;
+  auto allocator = std::make_shared<CPUAllocator>();
+  Results results;
+  results.statuses.resize(num_requests);
+  results.outputs.resize(num_requests);
+  for (size_t r = 0; r < num_requests; ++r) {
+    const int64_t size = 1 + static_cast<int64_t>(r % 3);
+    std::vector<float> values(static_cast<size_t>(size), static_cast<float>(r));
+    std::vector<OrtValue> feeds(1);
+    CreateMLValue<float>(allocator, {size}, values, &feeds[0]);
+    ASSERT_STATUS_OK(runner->RunAsync(RunOptions{}, kFeedNames, std::move(feeds), kOutputNames,
+                                      [&results, r](Status status, std::vector<OrtValue> fetches) {
+                                        results.Add(r, std::move(status), std::move(fetches));
+                                      }));
+  }
+  runner->Wait();
+
+  for (size_t r = 0; r < num_requests; ++r) {
+    ASSERT_STATUS_OK(results.statuses[r]);
+    ASSERT_EQ(results.outputs[r].size(), 1u);
+    const auto& output = results.outputs[r][0].Get<Tensor>();
+    EXPECT_EQ(output.Location().device.Type(), OrtDevice::CPU);
+    EXPECT_EQ(output.Shape(), TensorShape({1 + static_cast<int64_t>(r % 3)}));
+    for (float value : output.DataAsSpan<float>()) {
+      EXPECT_EQ(value, 2.0f * static_cast<float>(r));
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
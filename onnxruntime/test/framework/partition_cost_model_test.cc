@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/partition_cost_model.h"
+
+#include <fstream>
+
+#include "core/common/path_string.h"
+#include "core/framework/execution_providers.h"
+#include "core/framework/kernel_registry_manager.h"
+#include "core/graph/model.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "gtest/gtest.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/temp_dir.h"
+
+using namespace ONNX_NAMESPACE;
+namespace onnxruntime {
+namespace test {
+
+namespace {
+void WriteProfile(const std::string& path) {
+  std::ofstream stream(path);
+  stream << R"([
+{"cat" : "Session","pid" :1,"tid" :1,"dur" :500,"ts" :0,"ph" : "X","name" :"model_run","args" : {}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :2,"ts" :1,"ph" : "X","name" :"add_kernel_time","args" : {"op_name" : "Add","provider" : "CUDAExecutionProvider"}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :50,"ts" :2,"ph" : "X","name" :"matmul_kernel_time","args" : {"op_name" : "MatMul","provider" : "CUDAExecutionProvider"}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :1,"ts" :3,"ph" : "X","name" :"other_add_kernel_time","args" : {"op_name" : "Add","provider" : "CPUExecutionProvider"}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :3,"ts" :4,"ph" : "X","name" :"other_add_kernel_time","args" : {"op_name" : "Add","provider" : "CPUExecutionProvider"}},
+{"cat" : "Node","pid" :1,"tid" :1,"dur" :1000,"ts" :5,"ph" : "X","name" :"matmul_kernel_time","args" : {"op_name" : "MatMul","provider" : "CPUExecutionProvider"}}
+])";
+}
+}  // namespace
+
+TEST(PartitionCostModelTest, MovesShapeComputationToCpu) {
+  TemporaryDirectory profile_dir(ORT_TSTR("partition_cost_model_test"));
+  const std::string profile_path = PathToUTF8String(profile_dir.Path()) + "/profile.json";
+  WriteProfile(profile_path);
+
+  PartitionCostModel cost_model;
+  ASSERT_STATUS_OK(PartitionCostModel::Load(std::vector<std::string>{profile_path}, cost_model));
+
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 13}};
+  Model model("partition_cost_model", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              domain_to_version, std::vector<FunctionProto>(), DefaultLoggingManager().DefaultLogger());
+  Graph& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(64);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(64);
+  TypeProto int64_tensor;
+  int64_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  auto& x = graph.GetOrCreateNodeArg("x", &float_tensor);
+  auto& shape = graph.GetOrCreateNodeArg("shape", &int64_tensor);
+  auto& new_shape = graph.GetOrCreateNodeArg("new_shape", &int64_tensor);
+  auto& reshaped = graph.GetOrCreateNodeArg("reshaped", &float_tensor);
+  auto& product = graph.GetOrCreateNodeArg("product", &float_tensor);
+  graph.AddNode("shape", "Shape", "", {&x}, {&shape}).SetExecutionProviderType(kCpuExecutionProvider);
+  // a shape computation on the device between two CPU nodes
+  Node& add = graph.AddNode("add", "Add", "", {&shape, &shape}, {&new_shape});
+  add.SetExecutionProviderType(kCudaExecutionProvider);
+  graph.AddNode("reshape", "Reshape", "", {&x, &new_shape}, {&reshaped}).SetExecutionProviderType(kCpuExecutionProvider);
+  // much faster on the device, even with the copies of its input and output
+  Node& matmul = graph.AddNode("matmul", "MatMul", "", {&x, &x}, {&product});
+  matmul.SetExecutionProviderType(kCudaExecutionProvider);
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  ASSERT_STATUS_OK(execution_providers.Add(kCpuExecutionProvider,
+                                           std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo())));
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+
+  EXPECT_EQ(cost_model.GetKernelTime(add, kCpuExecutionProvider), 2.0);
+  EXPECT_FALSE(cost_model.GetKernelTime(add, kDmlExecutionProvider).has_value());
+
+  ASSERT_STATUS_OK(RefinePlacementByCost(graph, kernel_registry_manager, cost_model,
+                                         DefaultLoggingManager().DefaultLogger()));
+  EXPECT_EQ(add.GetExecutionProviderType(), kCpuExecutionProvider);
+  EXPECT_EQ(matmul.GetExecutionProviderType(), kCudaExecutionProvider);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
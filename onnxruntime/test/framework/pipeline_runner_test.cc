@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/pipeline_runner.h"
+
+#include <chrono>
+#include <sstream>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// A stage computing output = input0 * scale + input1 (if any), recording the batch dimension of each call.
+struct ElementwiseStage {
+  Status Run(const RunOptions&, gsl::span<const std::string>, gsl::span<const OrtValue> feeds,
+             gsl::span<const std::string>, std::vector<OrtValue>& fetches) {
+    const auto& x = feeds[0].Get<Tensor>();
+    {
+      std::lock_guard<OrtMutex> lock(mutex);
+      batch_sizes.push_back(x.Shape()[0]);
+    }
+    if (fail) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "stage failure");
+    }
+    if (on_run) {
+      on_run(batch_sizes.size() - 1);
+    }
+
+    fetches.resize(1);
+    AllocateMLValue<float>(allocator, std::vector<int64_t>(x.Shape().GetDims().begin(), x.Shape().GetDims().end()),
+                           &fetches[0]);
+    auto y = fetches[0].GetMutable<Tensor>()->MutableDataAsSpan<float>();
+    auto x_data = x.DataAsSpan<float>();
+    for (size_t i = 0; i < x_data.size(); ++i) {
+      y[i] = scale * x_data[i] + (feeds.size() > 1 ? feeds[1].Get<Tensor>().DataAsSpan<float>()[i] : 0.0f);
+    }
+    return Status::OK();
+  }
+
+  PipelineRunner::Stage GetStage(std::vector<std::string> input_names, std::vector<std::string> output_names) {
+    return {[this](const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                   gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                   std::vector<OrtValue>& fetches) {
+              return Run(run_options, feed_names, feeds, output_names, fetches);
+            },
+            std::move(input_names), std::move(output_names)};
+  }
+
+  AllocatorPtr allocator = std::make_shared<CPUAllocator>();
+  float scale = 1.0f;
+  bool fail = false;
+  std::function<void(size_t)> on_run;
+  OrtMutex mutex;
+  std::vector<int64_t> batch_sizes;
+};
+
+const std::vector<std::string> kFeedNames{"X"};
+const std::vector<std::string> kOutputNames{"Y"};
+
+// Y = (X * 2) * 3 + X for a batch of the given size with rows of 2 elements.
+void RunTwoStagePipeline(PipelineRunner& runner, int64_t batch_size) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<float> x(static_cast<size_t>(batch_size * 2));
+  for (size_t i = 0; i < x.size(); ++i) {
+    x[i] = static_cast<float>(i);
+  }
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {batch_size, 2}, x, &feeds[0]);
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(runner.Run(RunOptions{}, kFeedNames, feeds, kOutputNames, fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  const auto& y = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), TensorShape({batch_size, 2}));
+  auto y_data = y.DataAsSpan<float>();
+  for (size_t i = 0; i < x.size(); ++i) {
+    EXPECT_EQ(y_data[i], 7.0f * x[i]);
+  }
+}
+}  // namespace
+
+TEST(PipelineRunnerTest, MicroBatchesFlowThroughStages) {
+  ElementwiseStage first, second;
+  first.scale = 2.0f;
+  second.scale = 3.0f;
+  // the second stage also uses the feed of the first one
+  PipelineRunner runner({first.GetStage({"X"}, {"H"}), second.GetStage({"H", "X"}, {"Y"})}, 3);
+  RunTwoStagePipeline(runner, 7);
+  EXPECT_EQ(first.batch_sizes, (std::vector<int64_t>{3, 2, 2}));
+  EXPECT_EQ(second.batch_sizes, (std::vector<int64_t>{3, 2, 2}));
+}
+
+TEST(PipelineRunnerTest, SmallBatch) {
+  ElementwiseStage first, second;
+  first.scale = 2.0f;
+  second.scale = 3.0f;
+  PipelineRunner runner({first.GetStage({"X"}, {"H"}), second.GetStage({"H", "X"}, {"Y"})}, 4);
+  RunTwoStagePipeline(runner, 2);
+  EXPECT_EQ(first.batch_sizes, (std::vector<int64_t>{1, 1}));
+}
+
+TEST(PipelineRunnerTest, StagesRunConcurrently) {
+  ElementwiseStage first, second;
+  first.scale = 2.0f;
+  second.scale = 3.0f;
+
+  // the first stage only finishes its second micro-batch once the second stage started on the first one
+  OrtMutex mutex;
+  OrtCondVar cv;
+  bool second_started = false;
+  bool overlapped = false;
+  first.on_run = [&](size_t call) {
+    if (call == 1) {
+      std::unique_lock<OrtMutex> lock(mutex);
+      overlapped = cv.wait_for(lock, std::chrono::seconds(10), [&]() { return second_started; });
+    }
+  };
+  second.on_run = [&](size_t) {
+    std::lock_guard<OrtMutex> lock(mutex);
+    second_started = true;
+    cv.notify_all();
+  };
+
+  PipelineRunner runner({first.GetStage({"X"}, {"H"}), second.GetStage({"H", "X"}, {"Y"})}, 2);
+  RunTwoStagePipeline(runner, 4);
+  EXPECT_TRUE(overlapped);
+}
+
+TEST(PipelineRunnerTest, StageFailureStopsPipeline) {
+  ElementwiseStage first, second;
+  first.fail = true;
+  PipelineRunner runner({first.GetStage({"X"}, {"H"}), second.GetStage({"H"}, {"Y"})}, 2);
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {2, 1}, {1.0f, 2.0f}, &feeds[0]);
+  std::vector<OrtValue> fetches;
+  const auto status = runner.Run(RunOptions{}, kFeedNames, feeds, kOutputNames, fetches);
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_EQ(first.batch_sizes.size(), 1u);
+  EXPECT_TRUE(second.batch_sizes.empty());
+}
+
+TEST(PipelineRunnerTest, MissingStageInput) {
+  ElementwiseStage first;
+  PipelineRunner runner({first.GetStage({"Z"}, {"Y"})}, 2);
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {2, 1}, {1.0f, 2.0f}, &feeds[0]);
+  std::vector<OrtValue> fetches;
+  const auto status = runner.Run(RunOptions{}, kFeedNames, feeds, kOutputNames, fetches);
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("Input Z of pipeline stage 0"), std::string::npos);
+}
+
+TEST(PipelineRunnerTest, TerminateStopsPipeline) {
+  ElementwiseStage first, second;
+  PipelineRunner runner({first.GetStage({"X"}, {"H"}), second.GetStage({"H"}, {"Y"})}, 4);
+
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {4, 1}, {1.0f, 2.0f, 3.0f, 4.0f}, &feeds[0]);
+  std::vector<OrtValue> fetches;
+
+  RunOptions run_options;
+  run_options.terminate = true;
+  auto status = runner.Run(run_options, kFeedNames, feeds, kOutputNames, fetches);
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_NE(status.ErrorMessage().find("terminate"), std::string::npos);
+  EXPECT_TRUE(first.batch_sizes.empty());
+  EXPECT_TRUE(second.batch_sizes.empty());
+
+  // set while the first stage runs its first micro-batch, so neither stage runs the next ones
+  run_options.terminate = false;
+  first.on_run = [&run_options](size_t) { run_options.terminate = true; };
+  status = runner.Run(run_options, kFeedNames, feeds, kOutputNames, fetches);
+  EXPECT_FALSE(status.IsOK());
+  EXPECT_EQ(first.batch_sizes.size(), 1u);
+  EXPECT_TRUE(second.batch_sizes.empty());
+}
+
+// the stages are sessions, H = X + X and Y = H + X
+TEST(PipelineRunnerTest, SessionStages) {
+  auto create_session = [](const std::string& name, const std::string& a, const std::string& b,
+                           const std::string& y) {
+    onnxruntime::Model model(name, false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                             {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    ONNX_NAMESPACE::TypeProto float_tensor;
+    float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    auto& a_arg = graph.GetOrCreateNodeArg(a, &float_tensor);
+    auto& b_arg = graph.GetOrCreateNodeArg(b, &float_tensor);
+    auto& y_arg = graph.GetOrCreateNodeArg(y, &float_tensor);
+    graph.AddNode("add", "Add", "Add of the inputs", {&a_arg, &b_arg}, {&y_arg});
+    ORT_THROW_IF_ERROR(graph.Resolve());
+    std::string model_data;
+    ORT_ENFORCE(model.ToProto().SerializeToString(&model_data));
+
+    SessionOptions so;
+    so.session_logid = "PipelineRunnerTest.SessionStages." + name;
+    auto session = std::make_unique<InferenceSession>(so, GetEnvironment());
+    std::stringstream model_stream(model_data);
+    ORT_THROW_IF_ERROR(session->Load(model_stream));
+    ORT_THROW_IF_ERROR(session->Initialize());
+    return session;
+  };
+  auto first = create_session("first", "X", "X", "H");
+  auto second = create_session("second", "H", "X", "Y");
+
+  std::vector<PipelineRunner::Stage> stages(2);
+  ASSERT_STATUS_OK(PipelineRunner::CreateStage(*first, stages[0]));
+  ASSERT_STATUS_OK(PipelineRunner::CreateStage(*second, stages[1]));
+  EXPECT_EQ(stages[0].input_names, std::vector<std::string>{"X"});
+  EXPECT_EQ(stages[0].output_names, std::vector<std::string>{"H"});
+  EXPECT_EQ(stages[1].input_names, (std::vector<std::string>{"H", "X"}));
+  EXPECT_EQ(stages[1].output_names, std::vector<std::string>{"Y"});
+
+  PipelineRunner runner(std::move(stages), 2);
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {3, 2}, {0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f}, &feeds[0]);
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(runner.Run(RunOptions{}, kFeedNames, feeds, kOutputNames, fetches));
+  ASSERT_EQ(fetches.size(), 1u);
+  const auto& y = fetches[0].Get<Tensor>();
+  ASSERT_EQ(y.Shape(), TensorShape({3, 2}));
+  auto y_data = y.DataAsSpan<float>();
+  for (size_t i = 0; i < y_data.size(); ++i) {
+    EXPECT_EQ(y_data[i], 3.0f * static_cast<float>(i));
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,168 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/prefix_kv_cache.h"
+
+#include <sstream>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Caches a single float key of num_elements elements for the tokens.
+void InsertPrefix(PrefixKVCache& cache, const std::vector<int64_t>& tokens, int64_t num_elements) {
+  auto allocator = std::make_shared<CPUAllocator>();
+  std::vector<OrtValue> values(1);
+  CreateMLValue<float>(allocator, {num_elements},
+                       std::vector<float>(static_cast<size_t>(num_elements), static_cast<float>(tokens.size())),
+                       &values[0]);
+  ASSERT_TRUE(cache.Insert(tokens, {"past_key"}, std::move(values)).IsOK());
+}
+
+// Loads a model computing present_key = past_key + x in the session.
+void LoadAddSession(InferenceSession& session) {
+  onnxruntime::Model model("prefix_kv_cache", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 13}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  graph.AddNode("add", "Add", "", {&graph.GetOrCreateNodeArg("past_key", &float_tensor),
+                                   &graph.GetOrCreateNodeArg("x", &float_tensor)},
+                {&graph.GetOrCreateNodeArg("present_key", &float_tensor)});
+  ASSERT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  std::stringstream model_stream(model_data);
+  ASSERT_STATUS_OK(session.Load(model_stream));
+}
+}  // namespace
+
+TEST(PrefixKVCacheTest, LookupReturnsLongestPrefix) {
+  PrefixKVCache cache(1024);
+  InsertPrefix(cache, {1, 2}, 4);
+  InsertPrefix(cache, {1, 2, 3}, 4);
+  InsertPrefix(cache, {1, 2, 3, 4, 5, 6}, 4);
+
+  auto entry = cache.Lookup(std::vector<int64_t>{1, 2, 3, 4, 7});
+  ASSERT_NE(entry, nullptr);
+  ASSERT_EQ(entry->tokens, (std::vector<int64_t>{1, 2, 3}));
+  ASSERT_EQ(entry->names, std::vector<std::string>{"past_key"});
+  ASSERT_EQ(entry->values[0].Get<Tensor>().DataAsSpan<float>()[0], 3.0f);
+
+  ASSERT_EQ(cache.Lookup(std::vector<int64_t>{1, 2, 3, 4, 5, 6})->tokens.size(), 6u);
+  ASSERT_EQ(cache.Lookup(std::vector<int64_t>{2, 1, 3}), nullptr);
+  ASSERT_EQ(cache.Lookup(std::vector<int64_t>{1}), nullptr);
+}
+
+TEST(PrefixKVCacheTest, InsertReplacesExistingEntry) {
+  PrefixKVCache cache(1024);
+  InsertPrefix(cache, {1, 2}, 4);
+  InsertPrefix(cache, {1, 2}, 8);
+  ASSERT_EQ(cache.NumEntries(), 1u);
+  ASSERT_EQ(cache.SizeInBytes(), 8 * sizeof(float));
+  ASSERT_EQ(cache.Lookup(std::vector<int64_t>{1, 2})->values[0].Get<Tensor>().Shape().Size(), 8);
+}
+
+TEST(PrefixKVCacheTest, LeastRecentlyUsedEntriesAreEvicted) {
+  PrefixKVCache cache(3 * 4 * sizeof(float));
+  InsertPrefix(cache, {1}, 4);
+  InsertPrefix(cache, {2}, 4);
+  InsertPrefix(cache, {3}, 4);
+  // Uses {1}, so that {2} is the least recently used.
+  ASSERT_NE(cache.Lookup(std::vector<int64_t>{1, 5}), nullptr);
+  InsertPrefix(cache, {4}, 4);
+
+  ASSERT_EQ(cache.NumEntries(), 3u);
+  ASSERT_EQ(cache.SizeInBytes(), 3 * 4 * sizeof(float));
+  ASSERT_NE(cache.Lookup(std::vector<int64_t>{1}), nullptr);
+  ASSERT_EQ(cache.Lookup(std::vector<int64_t>{2}), nullptr);
+  ASSERT_NE(cache.Lookup(std::vector<int64_t>{3}), nullptr);
+  ASSERT_NE(cache.Lookup(std::vector<int64_t>{4}), nullptr);
+}
+
+TEST(PrefixKVCacheTest, EntriesOverBudgetAreNotCached) {
+  PrefixKVCache cache(4 * sizeof(float));
+  InsertPrefix(cache, {1}, 4);
+  InsertPrefix(cache, {2}, 8);
+  ASSERT_EQ(cache.NumEntries(), 1u);
+  ASSERT_NE(cache.Lookup(std::vector<int64_t>{1}), nullptr);
+}
+
+TEST(PrefixKVCacheTest, LookedUpEntriesOutliveEviction) {
+  PrefixKVCache cache(4 * sizeof(float));
+  InsertPrefix(cache, {1}, 4);
+  auto entry = cache.Lookup(std::vector<int64_t>{1});
+  cache.Clear();
+  ASSERT_EQ(cache.NumEntries(), 0u);
+  ASSERT_EQ(entry->values[0].Get<Tensor>().DataAsSpan<float>()[0], 1.0f);
+}
+
+TEST(PrefixKVCacheTest, BindLongestPrefix) {
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigPrefixKVCacheMaxBytes, "1024"));
+  InferenceSession session(so, GetEnvironment());
+  ASSERT_NO_FATAL_FAILURE(LoadAddSession(session));
+  ASSERT_STATUS_OK(session.Initialize());
+  PrefixKVCache* cache = session.GetPrefixKVCache();
+  ASSERT_NE(cache, nullptr);
+  InsertPrefix(*cache, {1, 2}, 4);
+
+  std::unique_ptr<IOBinding> io_binding;
+  ASSERT_STATUS_OK(session.NewIOBinding(&io_binding));
+  size_t prefix_length = 42;
+  ASSERT_STATUS_OK(cache->BindLongestPrefix(std::vector<int64_t>{3, 4}, *io_binding, prefix_length));
+  ASSERT_EQ(prefix_length, 0u);
+  ASSERT_TRUE(io_binding->GetInputNames().empty());
+
+  ASSERT_STATUS_OK(cache->BindLongestPrefix(std::vector<int64_t>{1, 2, 3}, *io_binding, prefix_length));
+  ASSERT_EQ(prefix_length, 2u);
+  ASSERT_EQ(io_binding->GetInputNames(), std::vector<std::string>{"past_key"});
+  // The cached tensor is bound as is, not copied.
+  auto entry = cache->Lookup(std::vector<int64_t>{1, 2});
+  ASSERT_EQ(io_binding->GetInputs()[0].Get<Tensor>().DataRaw(), entry->values[0].Get<Tensor>().DataRaw());
+
+  // The remaining token runs with the cached past.
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  OrtValue x;
+  CreateMLValue<float>(allocator, {4}, {1.0f, 2.0f, 3.0f, 4.0f}, &x);
+  ASSERT_STATUS_OK(io_binding->BindInput("x", x));
+  ASSERT_STATUS_OK(io_binding->BindOutput("present_key"));
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, *io_binding));
+  ASSERT_EQ(io_binding->GetOutputs().size(), 1u);
+  auto present_key = io_binding->GetOutputs()[0].Get<Tensor>().DataAsSpan<float>();
+  ASSERT_EQ(std::vector<float>(present_key.begin(), present_key.end()), (std::vector<float>{3.0f, 4.0f, 5.0f, 6.0f}));
+}
+
+TEST(PrefixKVCacheTest, SessionMaxBytesConfig) {
+  {
+    SessionOptions so;
+    InferenceSession session(so, GetEnvironment());
+    ASSERT_NO_FATAL_FAILURE(LoadAddSession(session));
+    ASSERT_STATUS_OK(session.Initialize());
+    ASSERT_EQ(session.GetPrefixKVCache(), nullptr);
+  }
+  for (const char* max_bytes : {"-1", "1KB", ""}) {
+    SCOPED_TRACE(max_bytes);
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigPrefixKVCacheMaxBytes, max_bytes));
+    InferenceSession session(so, GetEnvironment());
+    ASSERT_NO_FATAL_FAILURE(LoadAddSession(session));
+    auto status = session.Initialize();
+    ASSERT_EQ(status.Code(), common::INVALID_ARGUMENT) << status.ErrorMessage();
+    ASSERT_EQ(session.GetPrefixKVCache(), nullptr);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -3,6 +3,10 @@
 
 #include "core/framework/random_seed.h"
 #include "core/framework/random_generator.h"
+
+#include <algorithm>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 namespace onnxruntime {
@@ -54,5 +58,35 @@ TEST(RandomTest, PhiloxGeneratorTest) {
   ASSERT_EQ(seeds.second, 0u);
 }
 
+TEST(RandomTest, PhiloxEngineTest) {
+  // known answers of Philox4x32-10
+  ASSERT_EQ(PhiloxEngine::ComputeBlock({0, 0, 0, 0}, 0),
+            (PhiloxEngine::Block{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+  ASSERT_EQ(PhiloxEngine::ComputeBlock({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, 0xffffffffffffffff),
+            (PhiloxEngine::Block{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+  ASSERT_EQ(PhiloxEngine::ComputeBlock({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, 0x299f31d0a4093822),
+            (PhiloxEngine::Block{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+
+  // the stream is the same however it is split
+  constexpr uint64_t seed = 0x123456789abc;
+  constexpr uint64_t first_block = 0xfffffffe;  // crosses into the high word of the counter
+  constexpr size_t num_blocks = 37;
+  PhiloxEngine engine(seed);
+  std::vector<uint32_t> stream(num_blocks * 4);
+  engine.Generate(first_block, num_blocks, stream.data());
+
+  std::vector<uint32_t> split_stream(num_blocks * 4);
+  engine.Generate(first_block, 11, split_stream.data());
+  engine.Generate(first_block + 11, num_blocks - 11, split_stream.data() + 11 * 4);
+  ASSERT_EQ(split_stream, stream);
+
+  for (size_t i = 0; i < num_blocks; ++i) {
+    const uint64_t counter = first_block + i;
+    const auto block = PhiloxEngine::ComputeBlock(
+        {static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0}, seed);
+    ASSERT_TRUE(std::equal(block.begin(), block.end(), stream.begin() + i * 4));
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
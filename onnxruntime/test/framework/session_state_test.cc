@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <atomic>
+#include <filesystem>
 #include <iostream>
 #include <absl/base/config.h>
 
@@ -18,9 +20,12 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/util/thread_utils.h"
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "test/framework/test_utils.h"
 #include "test/test_environment.h"
 #include "test/util/include/default_providers.h"
+#include "test/util/include/temp_dir.h"
 #include "core/optimizer/layout_transformation/layout_transformation.h"
 
 using namespace ONNX_NAMESPACE;
@@ -113,6 +118,72 @@ TEST_P(SessionStateAddGetKernelTest, AddGetKernelTest) {
 
 INSTANTIATE_TEST_SUITE_P(SessionStateTests, SessionStateAddGetKernelTest, testing::Values(0, 1));
 
+// Creates the kernels of a chain of num_nodes Abs nodes with parallel kernel creation enabled, and returns the
+// status of finalizing the session state. The kernel of the node named failing_node fails to be created.
+static Status CreateKernelsInParallel(int num_nodes, const std::string& failing_node,
+                                      std::atomic<int>& num_kernels_created) {
+  OrtThreadPoolParams to;
+  to.thread_pool_size = 4;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+
+  std::unordered_map<std::string, int> domain_to_version{{kOnnxDomain, 12}};
+  onnxruntime::Model model("graph_1", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           domain_to_version, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  tensor_float.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  std::vector<onnxruntime::NodeArg*> args{&graph.GetOrCreateNodeArg("X", &tensor_float)};
+  for (int i = 0; i < num_nodes; ++i) {
+    args.push_back(&graph.GetOrCreateNodeArg("T" + std::to_string(i), &tensor_float));
+    graph.AddNode("node_" + std::to_string(i), "Abs", "", {args[i]}, {args[i + 1]})
+        .SetExecutionProviderType(kCpuExecutionProvider);
+  }
+  ORT_RETURN_IF_ERROR(graph.Resolve());
+
+  ExecutionProviders execution_providers;
+  ORT_RETURN_IF_ERROR(execution_providers.Add(kCpuExecutionProvider,
+                                              std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false))));
+  KernelRegistryManager kernel_registry_manager;
+  ORT_RETURN_IF_ERROR(kernel_registry_manager.RegisterKernels(execution_providers));
+  auto kernel_registry = std::make_shared<KernelRegistry>();
+  ORT_RETURN_IF_ERROR(kernel_registry->Register(KernelCreateInfo(
+      KernelDefBuilder().SetName("Abs").Provider(kCpuExecutionProvider).SinceVersion(6, 12).Build(),
+      [&](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) -> Status {
+        ORT_RETURN_IF(info.node().Name() == failing_node, "Failed to create kernel");
+        out = std::make_unique<TestOpKernel>(info);
+        ++num_kernels_created;
+        return Status::OK();
+      })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+
+  DataTransferManager dtm;
+  profiling::Profiler profiler;
+  SessionOptions sess_options;
+  ORT_RETURN_IF_ERROR(sess_options.config_options.AddConfigEntry(kOrtSessionOptionsConfigParallelKernelCreation, "1"));
+  SessionState s(graph, execution_providers, tp.get(), nullptr, dtm,
+                 DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  ORT_RETURN_IF_ERROR(s.FinalizeSessionState(ORT_TSTR(""), kernel_registry_manager));
+
+  for (const auto& node : graph.Nodes()) {
+    ORT_RETURN_IF(s.GetKernel(node.Index()) == nullptr, "Missing kernel for node ", node.Name());
+  }
+  return Status::OK();
+}
+
+TEST(SessionStateTest, ParallelKernelCreation) {
+  std::atomic<int> num_kernels_created{0};
+  ASSERT_STATUS_OK(CreateKernelsInParallel(64, "", num_kernels_created));
+  ASSERT_EQ(num_kernels_created, 64);
+}
+
+TEST(SessionStateTest, ParallelKernelCreationFailure) {
+  std::atomic<int> num_kernels_created{0};
+  auto status = CreateKernelsInParallel(64, "node_42", num_kernels_created);
+  ASSERT_FALSE(status.IsOK());
+  ASSERT_NE(status.ErrorMessage().find("Failed to create kernel"), std::string::npos) << status.ErrorMessage();
+}
+
 class TestParam {
  public:
   int ir_version;
@@ -368,6 +439,18 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  Status UseSerializedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                       int input_idx,
+                                       /*out*/ bool& used_serialized_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+
+    weight_packed_ = std::move(prepacked_buffers[0]);
+    used_serialized_buffers = true;
+    ++use_serialized_pre_packed_weight_calls_count;
+    return Status::OK();
+  }
+
   Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
                  /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override {
     ORT_UNUSED_PARAMETER(tensor);
@@ -391,6 +474,7 @@ class PrePackingTestOpKernel : public OpKernel {
 
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
+  int use_serialized_pre_packed_weight_calls_count = 0;
   IAllocatorUniquePtr<void> weight_packed_;
 };
 
@@ -983,6 +1067,189 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test4) {
   ASSERT_EQ(if_node_branches_shared_prepack_counter_2, static_cast<size_t>(2));
 }
 
+// Pre-packing enabled + pre-packed weights file = the second session uses the weight pre-packed by the first one
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, PrepackedWeightsFile) {
+  TemporaryDirectory temp_dir(ORT_TSTR("prepacked_weights_file_test"));
+  const auto prepacked_weights_file_path = ToUTF8String(temp_dir.Path() + ORT_TSTR("/weights.prepacked"));
+
+  SessionOptions sess_options;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigPrepackedWeightsFilePath] =
+      prepacked_weights_file_path;
+
+  auto finalize_session_state = [&](size_t expected_prepack_calls, size_t expected_serialized_weights) {
+    Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+    CreateSimpleGraph(model.MainGraph());
+    PlaceAllNodesToCPUEP(model.MainGraph());
+    SessionState session_state(model.MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options);
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager));
+
+    const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state.GetKernel(0));
+    ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+    ASSERT_EQ(kernel->prepack_calls_count, static_cast<int>(expected_prepack_calls));
+    ASSERT_EQ(kernel->use_serialized_pre_packed_weight_calls_count, static_cast<int>(expected_serialized_weights));
+    ASSERT_EQ(session_state.GetUsedSerializedPrePackedWeightCounter(), expected_serialized_weights);
+
+    const float* data_weights_packed = reinterpret_cast<const float*>(kernel->weight_packed_.get());
+    ASSERT_EQ(data_weights_packed[0], 1.2345f);
+    ASSERT_EQ(data_weights_packed[1], 1.2345f * 2.f);
+  };
+
+  // The first session pre-packs the weight and saves it
+  finalize_session_state(1, 0);
+  ASSERT_TRUE(std::filesystem::exists(prepacked_weights_file_path));
+
+  // The second session uses the weight from the file
+  finalize_session_state(0, 1);
+
+  // A session with a different configuration can not use the file, and pre-packs the weight again
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigParallelKernelCreation] = "0";
+  finalize_session_state(1, 0);
+}
+
+// Pre-packs the weight of input 1 with its first value, and fails to pre-pack a negative one
+class UpdatePrePackingTestOpKernel : public OpKernel {
+ public:
+  UpdatePrePackingTestOpKernel(const OpKernelInfo& info) : OpKernel(info) {}
+  Status Compute(OpKernelContext* context) const override {
+    ORT_UNUSED_PARAMETER(context);
+    return Status::OK();
+  }
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed, /*out*/ PrePackedWeights* prepacked_weights) override {
+    ORT_UNUSED_PARAMETER(alloc);
+    ORT_UNUSED_PARAMETER(prepacked_weights);
+    is_packed = false;
+    if (input_idx != 1) {
+      return Status::OK();
+    }
+
+    const float value = tensor.Data<float>()[0];
+    ORT_RETURN_IF(value < 0.0f, "Can't pre-pack the negative weight ", value, ".");
+    packed_value = value;
+    is_packed = true;
+    return Status::OK();
+  }
+
+  float packed_value = 0.0f;
+};
+
+// A failure to update the initializers, when checking them or pre-packing them, leaves the session state unchanged
+TEST(SessionStateTest, UpdateInitializedTensorsFailure) {
+  ONNX_OPERATOR_SCHEMA(UpdatePrePackingTest)
+      .SetDoc("Faking Node for pre-packing updated initializers")
+      .Input(0, "Input_0", "input 0", "tensor(float)")
+      .Input(1, "Input_1", "input 1", "tensor(float)")
+      .Output(0, "output_0", "docstr for output_0.", "tensor(float)");
+
+  OrtThreadPoolParams to;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(), to, concurrency::ThreadPoolType::INTRA_OP);
+  ExecutionProviders execution_providers;
+  auto cpu_execution_provider = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo(false));
+  ASSERT_STATUS_OK(execution_providers.Add(kCpuExecutionProvider, std::move(cpu_execution_provider)));
+  DataTransferManager dtm;
+  ASSERT_STATUS_OK(dtm.RegisterDataTransfer(std::make_unique<CPUDataTransfer>()));
+  profiling::Profiler profiler;
+
+  // node_0 pre-packs W0 and node_1 pre-packs W1, W0 is kept as node_1 reads it without pre-packing it
+  Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+              DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  TypeProto type;
+  type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  auto& x = graph.GetOrCreateNodeArg("X", &type);
+  auto& w0 = graph.GetOrCreateNodeArg("W0", &type);
+  auto& w1 = graph.GetOrCreateNodeArg("W1", &type);
+  graph.AddNode("node_0", "UpdatePrePackingTest", "node 0", {&x, &w0}, {&graph.GetOrCreateNodeArg("Y0", &type)});
+  graph.AddNode("node_1", "UpdatePrePackingTest", "node 1", {&w0, &w1}, {&graph.GetOrCreateNodeArg("Y1", &type)});
+  for (const auto& [name, value] : {std::make_pair("W0", 1.0f), std::make_pair("W1", 2.0f)}) {
+    ONNX_NAMESPACE::TensorProto tensor;
+    tensor.add_dims(1);
+    tensor.add_float_data(value);
+    tensor.set_data_type(TensorProto_DataType_FLOAT);
+    tensor.set_name(name);
+    graph.AddInitializedTensor(tensor);
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+  PlaceAllNodesToCPUEP(graph);
+
+  SessionOptions sess_options;
+  SessionState session_state(graph, execution_providers, tp.get(), nullptr, dtm,
+                             DefaultLoggingManager().DefaultLogger(), profiler, sess_options);
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_STATUS_OK(kernel_registry_manager.RegisterKernels(execution_providers));
+  std::shared_ptr<KernelRegistry> kernel_registry = std::make_shared<KernelRegistry>();
+  auto kernel_def =
+      KernelDefBuilder().SetName("UpdatePrePackingTest").Provider(kCpuExecutionProvider).SinceVersion(1).Build();
+  ASSERT_STATUS_OK(kernel_registry->Register(
+      KernelCreateInfo(std::move(kernel_def),
+                       [](FuncManager&, const OpKernelInfo& info, std::unique_ptr<OpKernel>& out) -> Status {
+                         out = std::make_unique<UpdatePrePackingTestOpKernel>(info);
+                         return Status::OK();
+                       })));
+  kernel_registry_manager.RegisterKernelRegistry(kernel_registry);
+  ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(), kernel_registry_manager));
+
+  int w0_idx = -1;
+  ASSERT_STATUS_OK(session_state.GetOrtValueNameIdxMap().GetIdx("W0", w0_idx));
+  const auto* kernel_0 = static_cast<const UpdatePrePackingTestOpKernel*>(session_state.GetKernel(0));
+  const auto* kernel_1 = static_cast<const UpdatePrePackingTestOpKernel*>(session_state.GetKernel(1));
+  const auto expect_state = [&](float w0_value, float packed_0, float packed_1, size_t version) {
+    const auto& initializers = session_state.GetConstantInitializedTensors();
+    ASSERT_EQ(initializers.size(), 1u);
+    ASSERT_EQ(initializers.count(w0_idx), 1u);
+    EXPECT_EQ(initializers.at(w0_idx).Get<Tensor>().Data<float>()[0], w0_value);
+    EXPECT_EQ(kernel_0->packed_value, packed_0);
+    EXPECT_EQ(kernel_1->packed_value, packed_1);
+    EXPECT_EQ(session_state.GetInitializedTensorsVersion(), version);
+  };
+  expect_state(1.0f, 1.0f, 2.0f, 0);
+
+  auto allocator = execution_providers.Get(kCpuExecutionProvider)->CreatePreferredAllocators()[0];
+  const auto make_value = [&](std::vector<int64_t> dims, std::vector<float> values) {
+    OrtValue value;
+    CreateMLValue<float>(allocator, dims, values, &value);
+    return value;
+  };
+  const std::vector<std::string> names{"W0", "W1"};
+
+  // the last value has the wrong shape
+  std::vector<OrtValue> values{make_value({1}, {3.0f}), make_value({2}, {4.0f, 4.0f})};
+  EXPECT_FALSE(session_state.UpdateInitializedTensors(names, values).IsOK());
+  expect_state(1.0f, 1.0f, 2.0f, 0);
+
+  // the same initializer twice
+  values = {make_value({1}, {3.0f}), make_value({1}, {4.0f})};
+  EXPECT_FALSE(session_state.UpdateInitializedTensors(std::vector<std::string>{"W0", "W0"}, values).IsOK());
+  expect_state(1.0f, 1.0f, 2.0f, 0);
+
+  // node_0 pre-packs the new W0 before node_1 fails to pre-pack W1, and pre-packs the previous W0 again
+  values = {make_value({1}, {3.0f}), make_value({1}, {-4.0f})};
+  const Status status = session_state.UpdateInitializedTensors(names, values);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Can't pre-pack the negative weight"));
+  EXPECT_THAT(status.ErrorMessage(), testing::Not(testing::HasSubstr("could not be restored")));
+  expect_state(1.0f, 1.0f, 2.0f, 0);
+
+  values = {make_value({1}, {3.0f}), make_value({1}, {4.0f})};
+  ASSERT_STATUS_OK(session_state.UpdateInitializedTensors(names, values));
+  expect_state(3.0f, 3.0f, 4.0f, 1);
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
@@ -1507,6 +1507,44 @@ TEST_F(GraphTest, ShapeInferenceErrorHandling) {
                                       "Node (node_1) Op (ShapeInferenceThrowsOp) [ShapeInferenceError] try harder");
 }
 
+TEST_F(GraphTest, IncrementalTypeAndShapeInference) {
+  Model model("graph_1", false, *logger_);
+  auto& graph = model.MainGraph();
+  graph.SetIncrementalTypeAndShapeInference(true);
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("x", &input_type);
+  auto& y = graph.GetOrCreateNodeArg("y", nullptr);
+  auto& z = graph.GetOrCreateNodeArg("z", nullptr);
+  graph.AddNode("relu", "Relu", "relu", {&x}, {&y});
+  auto& transpose = graph.AddNode("transpose", "Transpose", "transpose", {&y}, {&z});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  auto dims = [](const NodeArg& node_arg) {
+    return utils::GetTensorShapeFromTensorShapeProto(*node_arg.Shape()).AsShapeVector();
+  };
+  ASSERT_EQ(dims(z), (TensorShapeVector{3, 2}));
+
+  // the consumer of the NodeArg with the cleared shape is inferred again
+  z.ClearShape();
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_NE(z.Shape(), nullptr);
+  ASSERT_EQ(dims(z), (TensorShapeVector{3, 2}));
+
+  // as is a node with a modified attribute
+  transpose.AddAttribute("perm", AsSpan<int64_t>({0, 1}));
+  z.ClearShape();
+  graph.SetGraphResolveNeeded();
+  ASSERT_STATUS_OK(graph.Resolve());
+  ASSERT_EQ(dims(y), (TensorShapeVector{2, 3}));
+  ASSERT_EQ(dims(z), (TensorShapeVector{2, 3}));
+}
+
 TEST_F(GraphTest, AddTensorAttribute) {
   OPERATOR_SCHEMA(__Constant)
       .SetDoc("Constant Op.")
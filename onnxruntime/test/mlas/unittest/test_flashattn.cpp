@@ -0,0 +1,196 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <vector>
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  struct TestCase {
+    int BatchSize;
+    int NumHeads;
+    int KvNumHeads;
+    int QSequenceLength;
+    int KvSequenceLength;
+    // capacity of the kv cache, at least KvSequenceLength
+    int KvSequenceStride;
+    int HeadSize;
+    int QBlockSize;
+    int KvBlockSize;
+    bool IsCausal;
+    int LocalWindowSize;
+    // valid kv lengths of the batches, empty if all of them are valid
+    std::vector<int32_t> KvSequenceLengths;
+  };
+
+  //
+  // Q is BNSH, K and V are B x KvNumHeads x KvSequenceStride x H and the output is BSNH.
+  //
+  void ReferenceAttention(const TestCase& tc, const float* Query, const float* Key, const float* Value, float Scale,
+                          float* Output) {
+    const int HeadsPerKvHead = tc.NumHeads / tc.KvNumHeads;
+    std::vector<float> Probabilities(tc.KvSequenceLength);
+
+    for (int b = 0; b < tc.BatchSize; b++) {
+      const int TotalLength = tc.KvSequenceLengths.empty() ? tc.KvSequenceLength : tc.KvSequenceLengths[b];
+      const int PastLength = std::max(TotalLength - tc.QSequenceLength, 0);
+
+      for (int h = 0; h < tc.NumHeads; h++) {
+        const size_t KvHead = static_cast<size_t>(b) * tc.KvNumHeads + h / HeadsPerKvHead;
+        const float* K = Key + KvHead * tc.KvSequenceStride * tc.HeadSize;
+        const float* V = Value + KvHead * tc.KvSequenceStride * tc.HeadSize;
+
+        for (int i = 0; i < tc.QSequenceLength; i++) {
+          const float* Q = Query + ((static_cast<size_t>(b) * tc.NumHeads + h) * tc.QSequenceLength + i) * tc.HeadSize;
+          float* O = Output + ((static_cast<size_t>(b) * tc.QSequenceLength + i) * tc.NumHeads + h) * tc.HeadSize;
+          std::fill_n(O, tc.HeadSize, 0.0f);
+
+          int Begin = 0;
+          int End = TotalLength;
+          if (tc.IsCausal && TotalLength > 0) {
+            End = std::min(PastLength + i, TotalLength - 1) + 1;
+            if (tc.LocalWindowSize > 0) {
+              Begin = std::max(End - 1 - tc.LocalWindowSize, 0);
+            }
+          }
+          if (Begin >= End) {
+            continue;
+          }
+
+          float Maximum = std::numeric_limits<float>::lowest();
+          for (int j = Begin; j < End; j++) {
+            double Dot = 0.0;
+            for (int d = 0; d < tc.HeadSize; d++) {
+              Dot += double(Q[d]) * double(K[j * tc.HeadSize + d]);
+            }
+            Probabilities[j] = float(Dot) * Scale;
+            Maximum = std::max(Maximum, Probabilities[j]);
+          }
+
+          double Sum = 0.0;
+          for (int j = Begin; j < End; j++) {
+            Probabilities[j] = std::exp(Probabilities[j] - Maximum);
+            Sum += Probabilities[j];
+          }
+
+          for (int j = Begin; j < End; j++) {
+            const float P = float(Probabilities[j] / Sum);
+            for (int d = 0; d < tc.HeadSize; d++) {
+              O[d] += P * V[j * tc.HeadSize + d];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void Test(const TestCase& tc) {
+    const size_t QueryElements = static_cast<size_t>(tc.BatchSize) * tc.NumHeads * tc.QSequenceLength * tc.HeadSize;
+    const size_t KvElements = static_cast<size_t>(tc.BatchSize) * tc.KvNumHeads * tc.KvSequenceStride * tc.HeadSize;
+    float* Query = BufferQuery.GetBuffer(QueryElements);
+    float* Key = BufferKey.GetBuffer(KvElements);
+    float* Value = BufferValue.GetBuffer(KvElements);
+    float* Output = BufferOutput.GetBuffer(QueryElements);
+    float* OutputReference = BufferOutputReference.GetBuffer(QueryElements);
+
+    std::default_random_engine generator(static_cast<unsigned>(QueryElements + KvElements));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (size_t i = 0; i < QueryElements; i++) {
+      Query[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < KvElements; i++) {
+      Key[i] = distribution(generator);
+      Value[i] = distribution(generator);
+    }
+
+    const int ThreadCount = Threaded ? 4 : 1;
+    const size_t BufferSizePerThread =
+        (static_cast<size_t>(tc.QBlockSize) * 2 + static_cast<size_t>(tc.QBlockSize) * tc.KvBlockSize +
+         static_cast<size_t>(tc.QBlockSize) * tc.HeadSize) *
+        sizeof(float);
+    std::vector<float> Buffer(BufferSizePerThread * ThreadCount / sizeof(float));
+
+    MlasFlashAttentionThreadedArgs args;
+    args.batch_size = tc.BatchSize;
+    args.num_heads = tc.NumHeads;
+    args.q_sequence_length = tc.QSequenceLength;
+    args.kv_sequence_length = tc.KvSequenceLength;
+    args.qk_head_size = tc.HeadSize;
+    args.v_head_size = tc.HeadSize;
+    args.q_block_size = tc.QBlockSize;
+    args.kv_block_size = tc.KvBlockSize;
+    args.scale = 1.0f / std::sqrt(static_cast<float>(tc.HeadSize));
+    args.thread_count = ThreadCount;
+    args.buffer = Buffer.data();
+    args.buffer_size_per_thread = BufferSizePerThread;
+    args.query = Query;
+    args.key = Key;
+    args.value = Value;
+    args.output = Output;
+    args.kv_num_heads = tc.KvNumHeads;
+    args.kv_sequence_stride = tc.KvSequenceStride;
+    args.kv_sequence_lengths = tc.KvSequenceLengths.empty() ? nullptr : tc.KvSequenceLengths.data();
+    args.is_causal = tc.IsCausal;
+    args.local_window_size = tc.LocalWindowSize;
+
+    MlasFlashAttention(&args, threadpool_);
+    ReferenceAttention(tc, Query, Key, Value, args.scale, OutputReference);
+
+    constexpr float AbsoluteTolerance = 1e-5f;
+    constexpr float RelativeTolerance = 1e-4f;
+
+    for (size_t i = 0; i < QueryElements; i++) {
+      float diff = std::fabs(Output[i] - OutputReference[i]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[i]) * RelativeTolerance)
+          << "B" << tc.BatchSize << " N" << tc.NumHeads << "/" << tc.KvNumHeads << " S" << tc.QSequenceLength
+          << " T" << tc.KvSequenceLength << " blocks " << tc.QBlockSize << "x" << tc.KvBlockSize
+          << " causal " << tc.IsCausal << " window " << tc.LocalWindowSize
+          << ", index " << i << ", got: " << Output[i] << ", expecting: " << OutputReference[i];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "FlashAttention_Threaded" : "FlashAttention_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    for (bool IsCausal : {false, true}) {
+      // prompts with sequence lengths which are not multiples of the block sizes
+      Test({1, 2, 2, 13, 13, 13, 8, 4, 5, IsCausal, -1, {}});
+      Test({2, 4, 2, 17, 17, 17, 16, 8, 3, IsCausal, -1, {}});
+      // past keys and values in a cache with more rows than the valid ones
+      Test({2, 4, 1, 5, 21, 32, 8, 2, 4, IsCausal, -1, {}});
+      // decoding a token, with padded batches of different lengths
+      Test({3, 4, 2, 1, 19, 24, 8, 1, 6, IsCausal, -1, {19, 7, 1}});
+      Test({2, 2, 2, 3, 11, 16, 4, 2, 4, IsCausal, -1, {11, 5}});
+    }
+
+    // a local window shorter than a kv block, and spanning several kv blocks
+    Test({1, 2, 1, 12, 20, 20, 8, 3, 8, true, 2, {}});
+    Test({2, 2, 2, 9, 9, 9, 8, 4, 2, true, 5, {9, 6}});
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasGemmEpilogueTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferResidual;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCRef;
+
+  static float Activate(float x, MLAS_EPILOGUE_ACTIVATION_KIND ActivationKind) {
+    switch (ActivationKind) {
+      case MlasEpilogueReluActivation:
+        return std::max(x, 0.0f);
+      case MlasEpilogueGeluActivation:
+        return 0.5f * x * (1.0f + std::erf(x * 0.70710678118654752f));
+      case MlasEpilogueFastGeluActivation:
+        return 0.5f * x * (1.0f + std::tanh(0.79788456080286536f * (x + 0.044715f * x * x * x)));
+      case MlasEpilogueSiluActivation:
+        return x / (1.0f + std::exp(-x));
+      default:
+        return x;
+    }
+  }
+
+  void Test(size_t M, size_t N, size_t K, MLAS_EPILOGUE_ACTIVATION_KIND ActivationKind, bool HasResidual) {
+    float* A = BufferA.GetBuffer(M * K);
+    float* B = BufferB.GetBuffer(K * N);
+    float* Bias = BufferBias.GetBuffer(N);
+    float* Residual = BufferResidual.GetBuffer(M * N);
+    float* C = BufferC.GetBuffer(M * N, true);
+    float* CRef = BufferCRef.GetBuffer(M * N, true);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t s = 0; s < M * K; s++) {
+      A[s] = distribution(generator);
+    }
+    for (size_t s = 0; s < K * N; s++) {
+      B[s] = distribution(generator);
+    }
+    for (size_t s = 0; s < N; s++) {
+      Bias[s] = distribution(generator);
+    }
+    for (size_t s = 0; s < M * N; s++) {
+      Residual[s] = distribution(generator);
+    }
+
+    MLAS_GEMM_EPILOGUE Epilogue;
+    Epilogue.Scale = 0.5f;
+    Epilogue.Bias = Bias;
+    Epilogue.ActivationKind = ActivationKind;
+    if (HasResidual) {
+      Epilogue.Residual = Residual;
+      Epilogue.ldr = N;
+    }
+    MLAS_GEMM_EPILOGUE_PROCESSOR OutputProcessor(Epilogue);
+
+    MLAS_SGEMM_DATA_PARAMS Data;
+    Data.A = A;
+    Data.lda = K;
+    Data.B = B;
+    Data.ldb = N;
+    Data.C = C;
+    Data.ldc = N;
+    Data.OutputProcessor = &OutputProcessor;
+    MlasGemm(CblasNoTrans, CblasNoTrans, M, N, K, Data, GetMlasThreadPool());
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          sum += A[m * K + k] * B[k * N + n];
+        }
+        CRef[m * N + n] = Activate(sum * Epilogue.Scale + Bias[n], ActivationKind) +
+                          (HasResidual ? Residual[m * N + n] : 0.0f);
+      }
+    }
+
+    for (size_t f = 0; f < M * N; f++) {
+      ASSERT_TRUE(CloseEnough(C[f], CRef[f]))
+          << " @[" << f / N << "," << f % N << "], total:[" << M << "," << N << "," << K
+          << "], activation:" << ActivationKind << ", residual:" << HasResidual
+          << ", got:" << C[f] << ", expecting:" << CRef[f];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("GemmEpilogue");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const MLAS_EPILOGUE_ACTIVATION_KIND ActivationKinds[] = {
+        MlasEpilogueIdentityActivation,
+        MlasEpilogueReluActivation,
+        MlasEpilogueGeluActivation,
+        MlasEpilogueFastGeluActivation,
+        MlasEpilogueSiluActivation,
+    };
+
+    for (MLAS_EPILOGUE_ACTIVATION_KIND ActivationKind : ActivationKinds) {
+      for (bool HasResidual : {false, true}) {
+        Test(1, 1, 1, ActivationKind, HasResidual);
+        Test(1, 300, 17, ActivationKind, HasResidual);
+        Test(7, 33, 300, ActivationKind, HasResidual);
+        Test(32, 129, 64, ActivationKind, HasResidual);
+      }
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasGemmEpilogueTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,105 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasGemmGroupedTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferB;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCRef;
+
+  struct GroupShape {
+    size_t M;
+    size_t N;
+    size_t K;
+  };
+
+  void Test(const std::vector<GroupShape>& Shapes, CBLAS_TRANSPOSE TransB) {
+    size_t TotalA = 0;
+    size_t TotalB = 0;
+    size_t TotalC = 0;
+    for (const GroupShape& Shape : Shapes) {
+      TotalA += Shape.M * Shape.K;
+      TotalB += Shape.K * Shape.N;
+      TotalC += Shape.M * Shape.N;
+    }
+
+    float* A = BufferA.GetBuffer(TotalA + 1);
+    float* B = BufferB.GetBuffer(TotalB + 1);
+    float* C = BufferC.GetBuffer(TotalC + 1, true);
+    float* CRef = BufferCRef.GetBuffer(TotalC + 1, true);
+
+    std::default_random_engine generator(static_cast<unsigned>(TotalA + TotalB + TotalC));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t s = 0; s < TotalA; s++) {
+      A[s] = distribution(generator);
+    }
+    for (size_t s = 0; s < TotalB; s++) {
+      B[s] = distribution(generator);
+    }
+
+    std::vector<MLAS_SGEMM_GROUP_PARAMS> Groups(Shapes.size());
+    size_t OffsetA = 0;
+    size_t OffsetB = 0;
+    size_t OffsetC = 0;
+    for (size_t g = 0; g < Shapes.size(); g++) {
+      const GroupShape& Shape = Shapes[g];
+      MLAS_SGEMM_GROUP_PARAMS& Group = Groups[g];
+      Group.TransB = TransB;
+      Group.M = Shape.M;
+      Group.N = Shape.N;
+      Group.K = Shape.K;
+      Group.Data.A = A + OffsetA;
+      Group.Data.lda = Shape.K;
+      Group.Data.B = B + OffsetB;
+      Group.Data.ldb = (TransB == CblasNoTrans) ? Shape.N : Shape.K;
+      Group.Data.C = C + OffsetC;
+      Group.Data.ldc = Shape.N;
+
+      for (size_t m = 0; m < Shape.M; m++) {
+        for (size_t n = 0; n < Shape.N; n++) {
+          float sum = 0.0f;
+          for (size_t k = 0; k < Shape.K; k++) {
+            const float b = (TransB == CblasNoTrans) ? B[OffsetB + k * Shape.N + n] : B[OffsetB + n * Shape.K + k];
+            sum += A[OffsetA + m * Shape.K + k] * b;
+          }
+          CRef[OffsetC + m * Shape.N + n] = sum;
+        }
+      }
+
+      OffsetA += Shape.M * Shape.K;
+      OffsetB += Shape.K * Shape.N;
+      OffsetC += Shape.M * Shape.N;
+    }
+
+    MlasGemmGrouped(Groups.data(), Groups.size(), GetMlasThreadPool());
+
+    for (size_t f = 0; f < TotalC; f++) {
+      ASSERT_TRUE(CloseEnough(C[f], CRef[f]))
+          << " @" << f << " of " << TotalC << ", groups:" << Shapes.size() << ", transB:" << TransB
+          << ", got:" << C[f] << ", expecting:" << CRef[f];
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("GemmGrouped");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (CBLAS_TRANSPOSE TransB : {CblasNoTrans, CblasTrans}) {
+      Test({{1, 1, 1}}, TransB);
+      Test({{3, 16, 8}, {0, 16, 8}, {5, 33, 17}}, TransB);
+      Test({{64, 128, 32}, {1, 128, 32}, {7, 128, 32}, {0, 128, 32}, {29, 128, 32}}, TransB);
+      Test({{128, 300, 64}, {2, 3, 300}, {17, 1, 9}}, TransB);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasGemmGroupedTest>::RegisterShortExecute() : 0;
+});
@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasComputeLogTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+
+  void Test(size_t N, float MinimumValue, float MaximumValue) {
+    float* Input = BufferInput.GetBuffer(N);
+    float* Output = BufferOutput.GetBuffer(N);
+    float* OutputReference = BufferOutputReference.GetBuffer(N);
+
+    std::default_random_engine generator(static_cast<unsigned>(N));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+    for (size_t n = 0; n < N; n++) {
+      Input[n] = distribution(generator);
+    }
+
+    for (size_t n = 0; n < N; n++) {
+      OutputReference[n] = std::log(Input[n]);
+    }
+
+    MlasComputeLog(Input, Output, N);
+
+    constexpr float AbsoluteTolerance = 1e-6f;
+    constexpr float RelativeTolerance = 1e-6f;
+
+    for (size_t n = 0; n < N; n++) {
+      float diff = std::fabs(Output[n] - OutputReference[n]);
+      ASSERT_TRUE(diff <= AbsoluteTolerance || diff <= std::fabs(OutputReference[n]) * RelativeTolerance)
+          << " @" << n << " of " << N << ", got: " << Output[n] << ", expecting: " << OutputReference[n];
+    }
+  }
+
+  void TestSpecialValues() {
+    constexpr float Infinity = std::numeric_limits<float>::infinity();
+    const float Input[] = {0.0f, -0.0f, -1.0f, Infinity, -Infinity, std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::denorm_min(), 1.0f};
+    constexpr size_t N = sizeof(Input) / sizeof(Input[0]);
+    float Output[N];
+
+    MlasComputeLog(Input, Output, N);
+
+    ASSERT_EQ(Output[0], -Infinity);
+    ASSERT_EQ(Output[1], -Infinity);
+    ASSERT_TRUE(std::isnan(Output[2]));
+    ASSERT_EQ(Output[3], Infinity);
+    ASSERT_TRUE(std::isnan(Output[4]));
+    ASSERT_TRUE(std::isnan(Output[5]));
+    ASSERT_NEAR(Output[6], std::log(std::numeric_limits<float>::denorm_min()), 1e-4f);
+    ASSERT_EQ(Output[7], 0.0f);
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Log");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t n = 1; n < 128; n++) {
+      Test(n, 1e-3f, 10.f);
+      Test(n, 10.f, 1e6f);
+    }
+    TestSpecialValues();
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  // no long execute needed
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasComputeLogTest>::RegisterShortExecute() : 0;
+});
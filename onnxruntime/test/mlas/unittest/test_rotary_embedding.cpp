@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+class MlasRotaryEmbeddingTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferCos;
+  MatrixGuardBuffer<float> BufferSin;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferOutputReference;
+
+  void Test(size_t RotaryEmbeddingDim, bool Interleaved) {
+    const size_t HalfDim = RotaryEmbeddingDim / 2;
+    float* Input = BufferInput.GetBuffer(RotaryEmbeddingDim);
+    float* CosData = BufferCos.GetBuffer(HalfDim);
+    float* SinData = BufferSin.GetBuffer(HalfDim);
+    float* Output = BufferOutput.GetBuffer(RotaryEmbeddingDim);
+    float* OutputReference = BufferOutputReference.GetBuffer(RotaryEmbeddingDim);
+
+    std::default_random_engine generator(static_cast<unsigned>(RotaryEmbeddingDim));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < RotaryEmbeddingDim; i++) {
+      Input[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < HalfDim; i++) {
+      const float Angle = distribution(generator) * 3.0f;
+      CosData[i] = std::cos(Angle);
+      SinData[i] = std::sin(Angle);
+    }
+
+    for (size_t i = 0; i < HalfDim; i++) {
+      const size_t x = Interleaved ? 2 * i : i;
+      const size_t y = Interleaved ? 2 * i + 1 : HalfDim + i;
+      OutputReference[x] = Input[x] * CosData[i] - Input[y] * SinData[i];
+      OutputReference[y] = Input[y] * CosData[i] + Input[x] * SinData[i];
+    }
+
+    MlasRotaryEmbedOneRow(Input, CosData, SinData, RotaryEmbeddingDim, Interleaved, Output);
+
+    constexpr float AbsoluteTolerance = 1e-6f;
+
+    for (size_t i = 0; i < RotaryEmbeddingDim; i++) {
+      ASSERT_NEAR(Output[i], OutputReference[i], AbsoluteTolerance)
+          << " @" << i << " of " << RotaryEmbeddingDim << ", interleaved: " << Interleaved;
+    }
+
+    // in place
+    MlasRotaryEmbedOneRow(Input, CosData, SinData, RotaryEmbeddingDim, Interleaved, Input);
+
+    for (size_t i = 0; i < RotaryEmbeddingDim; i++) {
+      ASSERT_EQ(Input[i], Output[i]) << " @" << i << " of " << RotaryEmbeddingDim << ", interleaved: " << Interleaved;
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("RotaryEmbedding");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t n = 2; n <= 160; n += 2) {
+      Test(n, false);
+      Test(n, true);
+    }
+  }
+};
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  // no long execute needed
+  return is_short_execute ? MlasDirectShortExecuteTests<MlasRotaryEmbeddingTest>::RegisterShortExecute() : 0;
+});
@@ -9,12 +9,14 @@ class MlasScaleOutputTest : public MlasTestBase {
   MatrixGuardBuffer<float> BufferOutput;
   MatrixGuardBuffer<float> BufferOutputRef;
   MatrixGuardBuffer<float> BufferScale;
+  MatrixGuardBuffer<float> BufferRowScale;
 
-  void Test(size_t M, size_t N, bool PerColumn, bool AccumulateMode) {
+  void Test(size_t M, size_t N, bool PerColumn, bool AccumulateMode, bool PerRow = false) {
     int32_t* Input = BufferInput.GetBuffer(M * N);
     float* Output = BufferOutput.GetBuffer(M * N);
     float* OutputRef = BufferOutputRef.GetBuffer(M * N);
     float* Scale = BufferScale.GetBuffer(PerColumn ? N : 1);
+    float* RowScale = PerRow ? BufferRowScale.GetBuffer(M) : nullptr;
 
     std::default_random_engine generator(static_cast<unsigned>(M * N));
     std::uniform_real_distribution<float> real_distribution(-1.0f, 1.0f);
@@ -30,10 +32,14 @@ class MlasScaleOutputTest : public MlasTestBase {
       Scale[s] = real_distribution(generator);
     }
 
+    for (size_t s = 0; PerRow && s < M; s++) {
+      RowScale[s] = real_distribution(generator);
+    }
+
     // Compute Reference Value
     for (size_t m = 0; m < M; m++) {
       for (size_t n = 0; n < N; n++) {
-        float current_scale = PerColumn ? Scale[n] : Scale[0];
+        float current_scale = (PerColumn ? Scale[n] : Scale[0]) * (PerRow ? RowScale[m] : 1.0f);
         if (AccumulateMode) {
           OutputRef[m * N + n] += Input[m * N + n] * current_scale;
         } else {
@@ -46,7 +52,8 @@ class MlasScaleOutputTest : public MlasTestBase {
     MLAS_QGEMM_SCALE_BIAS_OUTPUT_PROCESSOR OutputProcessor(
         Output, N, Scale, nullptr,
         AccumulateMode ? MLAS_QGEMM_OUTPUT_MODE::AccumulateMode : MLAS_QGEMM_OUTPUT_MODE::ZeroMode,
-        PerColumn ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix);
+        PerColumn ? MLAS_QUANTIZATION_GRANULARITY::PerColumn : MLAS_QUANTIZATION_GRANULARITY::PerMatrix,
+        RowScale);
     OutputProcessor.Process(Input, 0, 0, M, N, N);
 
     constexpr float epsilon = 1e-6f;
@@ -72,6 +79,8 @@ class MlasScaleOutputTest : public MlasTestBase {
         Test(m, n, true, false);
         Test(m, n, false, true);
         Test(m, n, false, false);
+        Test(m, n, true, false, true);
+        Test(m, n, false, true, true);
       }
     }
   }
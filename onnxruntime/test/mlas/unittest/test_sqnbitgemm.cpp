@@ -17,6 +17,7 @@ Abstract:
 #include "test_util.h"
 #include "mlas_q4.h"
 #include "mlas_qnbit.h"
+#include "core/mlas/lib/mlasi.h"
 
 static constexpr const char* ComputeTypeName(MLAS_SQNBIT_GEMM_COMPUTE_TYPE ComputeType) {
   switch (ComputeType) {
@@ -420,6 +421,64 @@ class SQNBitGemmShortExecuteTest : public MlasTestFixture<MlasSQNBitGemmTest<Blk
   bool WithThreadpool_, Symmetric_, WithBias_;
 };
 
+#if defined(MLAS_TARGET_AMD64)
+
+//
+// Tests of the CompInt8 kernel of the AMX dispatch with shapes straddling its tiles of 16 rows and 16 columns.
+// The tests are skipped if the AMX dispatch is not selected, i.e. on processors without AMX-INT8 or when the OS
+// does not grant the tile data.
+//
+template <size_t BlkBitWidth, size_t BlkLen>
+class SQNBitGemmAmxTest : public SQNBitGemmShortExecuteTest<BlkBitWidth, BlkLen> {
+ public:
+  using SQNBitGemmShortExecuteTest<BlkBitWidth, BlkLen>::SQNBitGemmShortExecuteTest;
+
+  void TestBody() override {
+    if (GetMlasPlatform().SQNBitGemmDispatch != &MlasSQNBitGemmDispatchAmx) {
+      GTEST_SKIP() << "the AMX SQNBitGemm dispatch is not selected on this processor";
+    }
+    SQNBitGemmShortExecuteTest<BlkBitWidth, BlkLen>::TestBody();
+  }
+
+  static size_t RegisterAmxTests() {
+    size_t tests_registered = 0;
+
+    if (!MlasIsSQNBitGemmAvailable(BlkBitWidth, BlkLen, CompInt8)) {
+      return tests_registered;
+    }
+
+    for (size_t M : {1, 15, 16, 17, 33}) {
+      for (size_t N : {1, 15, 16, 17, 48}) {
+        for (size_t K : {BlkLen - 1, BlkLen, 3 * BlkLen + 1}) {
+          for (bool Symmetric : {false, true}) {
+            std::stringstream ss;
+            ss << "Amx/isSymmetric" << Symmetric << "/M" << M << "xN" << N << "xK" << K;
+            auto test_name = ss.str();
+
+            testing::RegisterTest(
+                MlasSQNBitGemmTest<BlkBitWidth, BlkLen>::GetTestSuiteName(),
+                test_name.c_str(),
+                nullptr,
+                test_name.c_str(),
+                __FILE__,
+                __LINE__,
+                // Important to use the fixture type as the return type here.
+                [=]() -> MlasTestFixture<MlasSQNBitGemmTest<BlkBitWidth, BlkLen>>* {
+                  return new SQNBitGemmAmxTest(M, N, K, CompInt8, true, Symmetric, Symmetric);
+                });
+
+            tests_registered += 1;
+          }
+        }
+      }
+    }
+
+    return tests_registered;
+  }
+};
+
+#endif  // defined(MLAS_TARGET_AMD64)
+
 static size_t SQNBitGemmRegisterAllShortExecuteTests() {
   size_t count = 0;
 
@@ -428,6 +487,10 @@ static size_t SQNBitGemmRegisterAllShortExecuteTests() {
   count += SQNBitGemmShortExecuteTest<4, 64>::RegisterShortExecuteTests();
   count += SQNBitGemmShortExecuteTest<4, 128>::RegisterShortExecuteTests();
   count += SQNBitGemmShortExecuteTest<4, 256>::RegisterShortExecuteTests();
+#if defined(MLAS_TARGET_AMD64)
+  count += SQNBitGemmAmxTest<4, 32>::RegisterAmxTests();
+  count += SQNBitGemmAmxTest<4, 128>::RegisterAmxTests();
+#endif
 
   return count;
 }
@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Overhead of the framework around the kernels. The models are chains of Identity nodes on a tensor of one float,
+// whose kernel does next to nothing as the allocation planner lets the output reuse the input, so the time is the
+// cost of a run (feeds and fetches, execution frame setup) plus the dispatch of each node (OpKernelContext,
+// allocation of the outputs per the plan). The per_node counter divides the time of a run by the length of the chain.
+// The cost of a node is the slope between the chain lengths and the cost of a run is what a chain of one node takes.
+//
+// The same chains run through the public API, with an IoBinding, with a prepared run and through InferenceSession, so
+// an entry point reducing the overhead can be compared with the others. The graph optimizations are disabled so the
+// Identity nodes are kept, and the session uses one intra op thread.
+
+#include <benchmark/benchmark.h>
+#include <core/common/common.h>
+#include <core/framework/ort_value.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/inference_session.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <core/session/ort_env.h>
+
+#include <string>
+#include <vector>
+
+using namespace onnxruntime;
+
+extern OrtEnv* env;
+
+namespace {
+
+// A model of chain_length Identity nodes from input to output.
+std::string CreateIdentityChainModel(int64_t chain_length) {
+  ONNX_NAMESPACE::ModelProto model;
+  model.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+  auto* opset = model.add_opset_import();
+  opset->set_domain(kOnnxDomain);
+  opset->set_version(17);
+
+  auto* graph = model.mutable_graph();
+  auto add_value_info = [](ONNX_NAMESPACE::ValueInfoProto* value_info, const std::string& name) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    tensor_type->mutable_shape()->add_dim()->set_dim_value(1);
+  };
+  add_value_info(graph->add_input(), "input");
+  add_value_info(graph->add_output(), "output");
+
+  std::string previous = "input";
+  for (int64_t i = 0; i < chain_length; ++i) {
+    auto* node = graph->add_node();
+    node->set_op_type("Identity");
+    node->set_name("identity_" + std::to_string(i));
+    node->add_input(previous);
+    previous = i + 1 == chain_length ? "output" : "t" + std::to_string(i);
+    node->add_output(previous);
+  }
+
+  std::string model_data;
+  model.SerializeToString(&model_data);
+  return model_data;
+}
+
+Ort::SessionOptions CreateSessionOptions() {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(1);
+  session_options.SetGraphOptimizationLevel(ORT_DISABLE_ALL);
+  return session_options;
+}
+
+// The environment is a process wide singleton, this refers to the one the benchmarks main created.
+Ort::Env& GetEnv() {
+  static Ort::Env ort_env{ORT_LOGGING_LEVEL_ERROR, "framework_overhead"};
+  return ort_env;
+}
+
+void SetPerNodeCounter(benchmark::State& state) {
+  state.counters["per_node"] = benchmark::Counter(static_cast<double>(state.range(0)),
+                                                  benchmark::Counter::kIsIterationInvariantRate |
+                                                      benchmark::Counter::kInvert);
+}
+
+constexpr const char* kInputName = "input";
+constexpr const char* kOutputName = "output";
+const std::vector<int64_t> kShape{1};
+
+}  // namespace
+
+// Session::Run of the C/C++ API, the outputs allocated by the run.
+static void BM_IdentityChainRun(benchmark::State& state) {
+  ORT_TRY {
+    const std::string model_data = CreateIdentityChainModel(state.range(0));
+    Ort::Session session(GetEnv(), model_data.data(), model_data.size(), CreateSessionOptions());
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    float input_data = 1.0f;
+    auto input = Ort::Value::CreateTensor<float>(memory_info, &input_data, 1, kShape.data(), kShape.size());
+
+    for (auto _ : state) {
+      auto outputs = session.Run(Ort::RunOptions{nullptr}, &kInputName, &input, 1, &kOutputName, 1);
+      benchmark::DoNotOptimize(outputs);
+    }
+    SetPerNodeCounter(state);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      state.SkipWithError(ex.what());
+    });
+  }
+}
+
+BENCHMARK(BM_IdentityChainRun)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000);
+
+// Session::Run with an IoBinding of the input and of a pre-allocated output.
+static void BM_IdentityChainIoBinding(benchmark::State& state) {
+  ORT_TRY {
+    const std::string model_data = CreateIdentityChainModel(state.range(0));
+    Ort::Session session(GetEnv(), model_data.data(), model_data.size(), CreateSessionOptions());
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    float input_data = 1.0f;
+    float output_data = 0.0f;
+    auto input = Ort::Value::CreateTensor<float>(memory_info, &input_data, 1, kShape.data(), kShape.size());
+    auto output = Ort::Value::CreateTensor<float>(memory_info, &output_data, 1, kShape.data(), kShape.size());
+
+    Ort::IoBinding binding(session);
+    binding.BindInput(kInputName, input);
+    binding.BindOutput(kOutputName, output);
+
+    for (auto _ : state) {
+      session.Run(Ort::RunOptions{nullptr}, binding);
+    }
+    SetPerNodeCounter(state);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      state.SkipWithError(ex.what());
+    });
+  }
+}
+
+BENCHMARK(BM_IdentityChainIoBinding)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000);
+
+// Session::Run of a prepared run, into a pre-allocated output.
+static void BM_IdentityChainPreparedRun(benchmark::State& state) {
+  ORT_TRY {
+    const std::string model_data = CreateIdentityChainModel(state.range(0));
+    Ort::Session session(GetEnv(), model_data.data(), model_data.size(), CreateSessionOptions());
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    float input_data = 1.0f;
+    float output_data = 0.0f;
+    auto input = Ort::Value::CreateTensor<float>(memory_info, &input_data, 1, kShape.data(), kShape.size());
+    auto output = Ort::Value::CreateTensor<float>(memory_info, &output_data, 1, kShape.data(), kShape.size());
+
+    // released before the session
+    Ort::PreparedRun prepared_run(session, &kInputName, 1, &kOutputName, 1);
+    for (auto _ : state) {
+      session.Run(Ort::RunOptions{nullptr}, prepared_run, &input, 1, &output, 1);
+    }
+    SetPerNodeCounter(state);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      state.SkipWithError(ex.what());
+    });
+  }
+}
+
+BENCHMARK(BM_IdentityChainPreparedRun)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000);
+
+// InferenceSession::Run, without the checks and conversions of the public API.
+static void BM_IdentityChainInferenceSession(benchmark::State& state) {
+  ORT_TRY {
+    const std::string model_data = CreateIdentityChainModel(state.range(0));
+    SessionOptions session_options;
+    session_options.graph_optimization_level = TransformerLevel::Default;
+    session_options.intra_op_param.thread_pool_size = 1;
+    InferenceSession session{session_options, env->GetEnvironment()};
+    ORT_THROW_IF_ERROR(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    ORT_THROW_IF_ERROR(session.Initialize());
+
+    auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+    float input_data = 1.0f;
+    auto input = Ort::Value::CreateTensor<float>(memory_info, &input_data, 1, kShape.data(), kShape.size());
+    const std::vector<std::string> feed_names{kInputName};
+    const std::vector<OrtValue> feeds{*static_cast<OrtValue*>(input)};
+    const std::vector<std::string> output_names{kOutputName};
+    RunOptions run_options;
+
+    for (auto _ : state) {
+      std::vector<OrtValue> fetches;
+      ORT_THROW_IF_ERROR(session.Run(run_options, feed_names, feeds, output_names, &fetches));
+      benchmark::DoNotOptimize(fetches);
+    }
+    SetPerNodeCounter(state);
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      state.SkipWithError(ex.what());
+    });
+  }
+}
+
+BENCHMARK(BM_IdentityChainInferenceSession)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000);
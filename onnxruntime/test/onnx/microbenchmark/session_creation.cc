@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Time to create a session for each model of a corpus, broken down into the phases the session profiler records:
+// model_loading_uri (protobuf parse and graph construction), graph_transformation_level1, graph_partitioning,
+// graph_transformation_level2 and 3, graph_resolve, allocation_planning, initializer_loading, kernel_creation,
+// prepacking, and session_initialization, which covers all of them but the model loading. Each phase is a counter of
+// the benchmark, its mean duration in seconds.
+//
+// The models are the .onnx and .ort files found under the directories listed, separated by ';', in the
+// ORT_BENCHMARK_MODEL_DIRS environment variable. There is one benchmark per model, named after its path.
+// e.g. ORT_BENCHMARK_MODEL_DIRS=/data/models onnxruntime_benchmark --benchmark_filter=BM_CreateSession
+//                                --benchmark_format=json
+
+#include <benchmark/benchmark.h>
+#include <core/common/common.h>
+#include <core/platform/env.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include "nlohmann/json.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace {
+
+// The environment is a process wide singleton, this refers to the one the benchmarks main created.
+Ort::Env& GetEnv() {
+  static Ort::Env ort_env{ORT_LOGGING_LEVEL_ERROR, "session_creation"};
+  return ort_env;
+}
+
+// Adds the durations of the session events of the profile to phase_durations, in microseconds.
+void AddPhaseDurations(const std::filesystem::path& profile_file, std::map<std::string, double>& phase_durations) {
+  std::ifstream profile(profile_file);
+  const auto events = nlohmann::json::parse(profile);
+  for (const auto& event : events) {
+    if (event.value("cat", "") == "Session") {
+      phase_durations[event.value("name", "")] += event.value("dur", 0.0);
+    }
+  }
+}
+
+void BM_CreateSession(benchmark::State& state, const std::filesystem::path& model_path) {
+  ORT_TRY {
+    const auto profile_prefix = (std::filesystem::temp_directory_path() / "ort_session_creation").native();
+    Ort::SessionOptions session_options;
+    session_options.EnableProfiling(profile_prefix.c_str());
+    Ort::AllocatorWithDefaultOptions allocator;
+
+    std::map<std::string, double> phase_durations;
+    for (auto _ : state) {
+      Ort::Session session(GetEnv(), model_path.c_str(), session_options);
+
+      state.PauseTiming();
+      const std::filesystem::path profile_file{session.EndProfilingAllocated(allocator).get()};
+      AddPhaseDurations(profile_file, phase_durations);
+      std::filesystem::remove(profile_file);
+      session = Ort::Session{nullptr};
+      state.ResumeTiming();
+    }
+
+    for (const auto& phase : phase_durations) {
+      state.counters[phase.first] = benchmark::Counter(phase.second / 1e6, benchmark::Counter::kAvgIterations);
+    }
+  }
+  ORT_CATCH(const std::exception& ex) {
+    ORT_HANDLE_EXCEPTION([&]() {
+      state.SkipWithError(ex.what());
+    });
+  }
+}
+
+bool RegisterCreateSessionBenchmarks() {
+  std::istringstream model_dirs(onnxruntime::Env::Default().GetEnvironmentVar("ORT_BENCHMARK_MODEL_DIRS"));
+  std::string model_dir;
+  while (std::getline(model_dirs, model_dir, ';')) {
+    std::error_code ec;
+    for (std::filesystem::recursive_directory_iterator it(model_dir, ec), end; !ec && it != end; it.increment(ec)) {
+      const auto& path = it->path();
+      if (path.extension() == ".onnx" || path.extension() == ".ort") {
+        benchmark::RegisterBenchmark(("BM_CreateSession/" + path.string()).c_str(), BM_CreateSession, path)
+            ->UseRealTime()
+            ->Unit(benchmark::TimeUnit::kMillisecond);
+      }
+    }
+  }
+  return true;
+}
+
+[[maybe_unused]] const bool create_session_benchmarks_registered = RegisterCreateSessionBenchmarks();
+
+}  // namespace
@@ -0,0 +1,418 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Benchmarks of the CPU kernels, each running a model of a single node through an inference session, so the numbers
+// include what the session adds to the kernel itself, as in a real model. The shapes are those the ops have in
+// popular models. The inputs are generated from a fixed seed and the session uses one intra op thread, so the
+// results of different commits and machines with a different number of cores can be compared,
+// e.g. with --benchmark_format=json and tools/compare.py of Google Benchmark.
+//
+// A kernel is benchmarked by describing its node with SingleNodeModel and the shapes with Args.
+
+#include <benchmark/benchmark.h>
+#include <core/common/common.h>
+#include <core/graph/constants.h>
+#include <core/graph/onnx_protobuf.h>
+#include <core/session/onnxruntime_cxx_api.h>
+#include <onnx/defs/attr_proto_util.h>
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace onnxruntime;
+
+namespace {
+
+constexpr uint32_t kSeed = 42;
+
+// The environment is a process wide singleton, this refers to the one the benchmarks main created.
+Ort::Env& GetEnv() {
+  static Ort::Env ort_env{ORT_LOGGING_LEVEL_ERROR, "single_node"};
+  return ort_env;
+}
+
+class SingleNodeModel {
+ public:
+  SingleNodeModel(const std::string& op_type, const std::string& domain = "") : gen_(kSeed) {
+    model_.set_ir_version(ONNX_NAMESPACE::Version::IR_VERSION);
+    AddOpset(kOnnxDomain, 17);
+    AddOpset(kMSDomain, 1);
+    AddOpset(kMLDomain, 3);
+    node_ = model_.mutable_graph()->add_node();
+    node_->set_op_type(op_type);
+    node_->set_domain(domain);
+  }
+
+  SingleNodeModel& FloatInput(const std::string& name, const std::vector<int64_t>& shape,
+                              bool is_initializer = false) {
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> values(static_cast<size_t>(Size(shape)));
+    for (auto& v : values) {
+      v = dist(gen_);
+    }
+    AddInput(name, ONNX_NAMESPACE::TensorProto_DataType_FLOAT, shape, values.data(), values.size() * sizeof(float),
+             is_initializer);
+    return *this;
+  }
+
+  // Random values in [0, max_value), e.g. indices into an axis of size max_value.
+  SingleNodeModel& Int64Input(const std::string& name, const std::vector<int64_t>& shape, int64_t max_value,
+                              bool is_initializer = false) {
+    std::uniform_int_distribution<int64_t> dist(0, max_value - 1);
+    std::vector<int64_t> values(static_cast<size_t>(Size(shape)));
+    for (auto& v : values) {
+      v = dist(gen_);
+    }
+    return Int64Input(name, shape, values, is_initializer);
+  }
+
+  SingleNodeModel& Int64Input(const std::string& name, const std::vector<int64_t>& shape,
+                              const std::vector<int64_t>& values, bool is_initializer = false) {
+    AddInput(name, ONNX_NAMESPACE::TensorProto_DataType_INT64, shape, values.data(), values.size() * sizeof(int64_t),
+             is_initializer);
+    return *this;
+  }
+
+  // Random words of 1 to 12 letters, in mixed case.
+  SingleNodeModel& StringInput(const std::string& name, const std::vector<int64_t>& shape) {
+    std::uniform_int_distribution<int> length(1, 12);
+    std::uniform_int_distribution<int> letter(0, 51);
+    Feed feed{name, ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING, shape, {}, {}};
+    feed.strings.resize(static_cast<size_t>(Size(shape)));
+    for (auto& s : feed.strings) {
+      s.resize(length(gen_));
+      for (auto& c : s) {
+        const int l = letter(gen_);
+        c = static_cast<char>(l < 26 ? 'a' + l : 'A' + l - 26);
+      }
+    }
+    AddValueInfo(model_.mutable_graph()->add_input(), name, ONNX_NAMESPACE::TensorProto_DataType_STRING, &shape);
+    node_->add_input(name);
+    feeds_.push_back(std::move(feed));
+    return *this;
+  }
+
+  SingleNodeModel& Output(const std::string& name, int32_t elem_type = ONNX_NAMESPACE::TensorProto_DataType_FLOAT) {
+    AddValueInfo(model_.mutable_graph()->add_output(), name, elem_type, nullptr);
+    node_->add_output(name);
+    output_names_.push_back(name);
+    return *this;
+  }
+
+  SingleNodeModel& Attribute(ONNX_NAMESPACE::AttributeProto&& attribute) {
+    *node_->add_attribute() = std::move(attribute);
+    return *this;
+  }
+
+  void Run(benchmark::State& state) const {
+    ORT_TRY {
+      std::string model_data;
+      model_.SerializeToString(&model_data);
+
+      Ort::SessionOptions session_options;
+      session_options.SetIntraOpNumThreads(1);
+      Ort::Session session(GetEnv(), model_data.data(), model_data.size(), session_options);
+
+      Ort::AllocatorWithDefaultOptions allocator;
+      std::vector<const char*> input_names;
+      std::vector<Ort::Value> inputs;
+      for (const auto& feed : feeds_) {
+        auto value = Ort::Value::CreateTensor(allocator, feed.shape.data(), feed.shape.size(), feed.type);
+        if (feed.type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING) {
+          std::vector<const char*> strings;
+          for (const auto& s : feed.strings) {
+            strings.push_back(s.c_str());
+          }
+          value.FillStringTensor(strings.data(), strings.size());
+        } else {
+          memcpy(value.GetTensorMutableRawData(), feed.data.data(), feed.data.size());
+        }
+        input_names.push_back(feed.name.c_str());
+        inputs.push_back(std::move(value));
+      }
+
+      std::vector<const char*> output_names;
+      for (const auto& name : output_names_) {
+        output_names.push_back(name.c_str());
+      }
+
+      for (auto _ : state) {
+        auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names.data(), inputs.data(), inputs.size(),
+                                   output_names.data(), output_names.size());
+        benchmark::DoNotOptimize(outputs);
+      }
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        state.SkipWithError(ex.what());
+      });
+    }
+  }
+
+ private:
+  struct Feed {
+    std::string name;
+    ONNXTensorElementDataType type;
+    std::vector<int64_t> shape;
+    std::string data;
+    std::vector<std::string> strings;
+  };
+
+  static int64_t Size(const std::vector<int64_t>& shape) {
+    int64_t size = 1;
+    for (auto dim : shape) {
+      size *= dim;
+    }
+    return size;
+  }
+
+  static void AddValueInfo(ONNX_NAMESPACE::ValueInfoProto* value_info, const std::string& name, int32_t elem_type,
+                           const std::vector<int64_t>* shape) {
+    value_info->set_name(name);
+    auto* tensor_type = value_info->mutable_type()->mutable_tensor_type();
+    tensor_type->set_elem_type(elem_type);
+    if (shape != nullptr) {
+      auto* shape_proto = tensor_type->mutable_shape();
+      for (auto dim : *shape) {
+        shape_proto->add_dim()->set_dim_value(dim);
+      }
+    }
+  }
+
+  void AddOpset(const std::string& domain, int64_t version) {
+    auto* opset = model_.add_opset_import();
+    opset->set_domain(domain);
+    opset->set_version(version);
+  }
+
+  void AddInput(const std::string& name, int32_t elem_type, const std::vector<int64_t>& shape, const void* data,
+                size_t size, bool is_initializer) {
+    node_->add_input(name);
+    if (is_initializer) {
+      auto* initializer = model_.mutable_graph()->add_initializer();
+      initializer->set_name(name);
+      initializer->set_data_type(elem_type);
+      for (auto dim : shape) {
+        initializer->add_dims(dim);
+      }
+      initializer->set_raw_data(data, size);
+      return;
+    }
+
+    AddValueInfo(model_.mutable_graph()->add_input(), name, elem_type, &shape);
+    feeds_.push_back(Feed{name, static_cast<ONNXTensorElementDataType>(elem_type), shape,
+                          std::string(static_cast<const char*>(data), size), {}});
+  }
+
+  ONNX_NAMESPACE::ModelProto model_;
+  ONNX_NAMESPACE::NodeProto* node_;
+  std::vector<Feed> feeds_;
+  std::vector<std::string> output_names_;
+  std::mt19937 gen_;
+};
+
+}  // namespace
+
+// Embedding lookup: {vocabulary size, hidden size, batch size, sequence length}
+static void BM_GatherEmbedding(benchmark::State& state) {
+  const int64_t vocab_size = state.range(0);
+  const int64_t hidden_size = state.range(1);
+  const int64_t batch_size = state.range(2);
+  const int64_t sequence_length = state.range(3);
+  SingleNodeModel("Gather")
+      .FloatInput("data", {vocab_size, hidden_size}, /*is_initializer*/ true)
+      .Int64Input("indices", {batch_size, sequence_length}, vocab_size)
+      .Output("output")
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("axis", int64_t{0}))
+      .Run(state);
+}
+
+BENCHMARK(BM_GatherEmbedding)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({30522, 768, 1, 128})   // BERT-base
+    ->Args({30522, 768, 8, 128})   // BERT-base
+    ->Args({30522, 768, 1, 512})   // BERT-base
+    ->Args({50257, 768, 1, 1024})  // GPT-2
+    ->Args({32000, 4096, 1, 1});   // Llama 2 7B, decoding
+
+// Split of the attention heads: {batch size, sequence length, number of heads, head size}, permuted to BNSH
+static void BM_TransposeAttentionHeads(benchmark::State& state) {
+  SingleNodeModel("Transpose")
+      .FloatInput("data", {state.range(0), state.range(1), state.range(2), state.range(3)})
+      .Output("transposed")
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("perm", std::vector<int64_t>{0, 2, 1, 3}))
+      .Run(state);
+}
+
+BENCHMARK(BM_TransposeAttentionHeads)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 128, 12, 64})     // BERT-base
+    ->Args({8, 128, 12, 64})     // BERT-base
+    ->Args({1, 384, 16, 64})     // BERT-large, SQuAD
+    ->Args({1, 1024, 12, 64})    // GPT-2
+    ->Args({1, 2048, 32, 128});  // Llama 2 7B, prompt
+
+// Layout conversion: {batch size, channels, height, width}, permuted to NHWC
+static void BM_TransposeNchwToNhwc(benchmark::State& state) {
+  SingleNodeModel("Transpose")
+      .FloatInput("data", {state.range(0), state.range(1), state.range(2), state.range(3)})
+      .Output("transposed")
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("perm", std::vector<int64_t>{0, 2, 3, 1}))
+      .Run(state);
+}
+
+BENCHMARK(BM_TransposeNchwToNhwc)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 3, 224, 224})   // ImageNet input
+    ->Args({1, 64, 112, 112})  // ResNet-50
+    ->Args({1, 256, 56, 56})   // ResNet-50
+    ->Args({1, 2048, 7, 7})    // ResNet-50
+    ->Args({1, 3, 640, 640});  // YOLOv5 / YOLOv8 input
+
+// {batch size, sequence length, hidden size}, normalized over the hidden size
+static void BM_LayerNormalization(benchmark::State& state) {
+  const int64_t hidden_size = state.range(2);
+  SingleNodeModel("LayerNormalization")
+      .FloatInput("X", {state.range(0), state.range(1), hidden_size})
+      .FloatInput("scale", {hidden_size}, /*is_initializer*/ true)
+      .FloatInput("bias", {hidden_size}, /*is_initializer*/ true)
+      .Output("Y")
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("axis", int64_t{-1}))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("epsilon", 1e-5f))
+      .Run(state);
+}
+
+BENCHMARK(BM_LayerNormalization)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 128, 768})   // BERT-base
+    ->Args({8, 128, 768})   // BERT-base
+    ->Args({1, 384, 1024})  // BERT-large, SQuAD
+    ->Args({1, 1024, 768})  // GPT-2
+    ->Args({1, 197, 768});  // ViT-B/16
+
+#if !defined(DISABLE_CONTRIB_OPS)
+// com.microsoft.Attention with the QKV projection: {batch size, sequence length, hidden size, number of heads}
+static void BM_Attention(benchmark::State& state) {
+  const int64_t hidden_size = state.range(2);
+  SingleNodeModel("Attention", kMSDomain)
+      .FloatInput("input", {state.range(0), state.range(1), hidden_size})
+      .FloatInput("weights", {hidden_size, 3 * hidden_size}, /*is_initializer*/ true)
+      .FloatInput("bias", {3 * hidden_size}, /*is_initializer*/ true)
+      .Output("output")
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("num_heads", state.range(3)))
+      .Run(state);
+}
+
+BENCHMARK(BM_Attention)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMillisecond)
+    ->Args({1, 128, 768, 12})   // BERT-base
+    ->Args({8, 128, 768, 12})   // BERT-base
+    ->Args({1, 384, 1024, 16})  // BERT-large, SQuAD
+    ->Args({1, 197, 768, 12});  // ViT-B/16
+#endif
+
+// {rows, columns, k}, along the last axis
+static void BM_TopK(benchmark::State& state) {
+  SingleNodeModel("TopK")
+      .FloatInput("X", {state.range(0), state.range(1)})
+      .Int64Input("K", {1}, std::vector<int64_t>{state.range(2)}, /*is_initializer*/ true)
+      .Output("Values")
+      .Output("Indices", ONNX_NAMESPACE::TensorProto_DataType_INT64)
+      .Run(state);
+}
+
+BENCHMARK(BM_TopK)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 1000, 5})     // ImageNet classes
+    ->Args({64, 1000, 5})    // ImageNet classes
+    ->Args({1, 50257, 50})   // GPT-2 top-k sampling
+    ->Args({8, 32000, 50})   // Llama 2 top-k sampling
+    ->Args({1, 8400, 100});  // YOLOv8 candidate boxes
+
+// ai.onnx.ml.TreeEnsembleRegressor: {batch size, number of features, number of trees, tree depth}, with complete trees
+// as gradient boosting produces them.
+static void BM_TreeEnsembleRegressor(benchmark::State& state) {
+  const int64_t n_features = state.range(1);
+  const int64_t n_trees = state.range(2);
+  const int64_t depth = state.range(3);
+
+  std::mt19937 gen(kSeed);
+  std::uniform_int_distribution<int64_t> feature(0, n_features - 1);
+  std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+  std::vector<int64_t> nodes_treeids, nodes_nodeids, nodes_featureids, nodes_truenodeids, nodes_falsenodeids;
+  std::vector<float> nodes_values;
+  std::vector<std::string> nodes_modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+  const int64_t n_branches = (int64_t{1} << depth) - 1;
+  const int64_t n_nodes = (int64_t{1} << (depth + 1)) - 1;
+  for (int64_t tree = 0; tree < n_trees; ++tree) {
+    for (int64_t node = 0; node < n_nodes; ++node) {
+      nodes_treeids.push_back(tree);
+      nodes_nodeids.push_back(node);
+      const bool is_leaf = node >= n_branches;
+      nodes_featureids.push_back(is_leaf ? 0 : feature(gen));
+      nodes_values.push_back(is_leaf ? 0.0f : value(gen));
+      nodes_modes.push_back(is_leaf ? "LEAF" : "BRANCH_LEQ");
+      nodes_truenodeids.push_back(is_leaf ? 0 : 2 * node + 1);
+      nodes_falsenodeids.push_back(is_leaf ? 0 : 2 * node + 2);
+      if (is_leaf) {
+        target_treeids.push_back(tree);
+        target_nodeids.push_back(node);
+        target_ids.push_back(0);
+        target_weights.push_back(value(gen));
+      }
+    }
+  }
+
+  SingleNodeModel("TreeEnsembleRegressor", kMLDomain)
+      .FloatInput("X", {state.range(0), n_features})
+      .Output("Y")
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("n_targets", int64_t{1}))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("aggregate_function", std::string("SUM")))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("post_transform", std::string("NONE")))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("nodes_treeids", nodes_treeids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("nodes_nodeids", nodes_nodeids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("nodes_featureids", nodes_featureids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("nodes_values", nodes_values))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("nodes_modes", nodes_modes))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("nodes_truenodeids", nodes_truenodeids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("nodes_falsenodeids", nodes_falsenodeids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("target_treeids", target_treeids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("target_nodeids", target_nodeids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("target_ids", target_ids))
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("target_weights", target_weights))
+      .Run(state);
+}
+
+BENCHMARK(BM_TreeEnsembleRegressor)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Args({1, 100, 100, 6})     // online scoring
+    ->Args({1000, 100, 100, 6})  // batch scoring
+    ->Args({1, 28, 500, 8})      // HIGGS
+    ->Args({1000, 28, 500, 8});  // HIGGS
+
+// Lower casing of a text split in words: {number of words}
+static void BM_StringNormalizer(benchmark::State& state) {
+  SingleNodeModel("StringNormalizer")
+      .StringInput("X", {1, state.range(0)})
+      .Output("Y", ONNX_NAMESPACE::TensorProto_DataType_STRING)
+      .Attribute(ONNX_NAMESPACE::MakeAttribute("case_change_action", std::string("LOWER")))
+      .Run(state);
+}
+
+BENCHMARK(BM_StringNormalizer)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(128)
+    ->Arg(512)
+    ->Arg(16384);
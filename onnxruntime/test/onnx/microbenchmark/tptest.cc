@@ -4,6 +4,9 @@
 #include <core/session/onnxruntime_c_api.h>
 #include <core/platform/Barrier.h>
 
+#include <chrono>
+#include <thread>
+
 #ifdef _WIN32
 #include <Windows.h>
 #endif
@@ -132,6 +135,84 @@ BENCHMARK(BM_ThreadPoolSimpleParallelFor)
     ->Args({HALF_THREADS_PLUS_1, HALF_THREADS_PLUS_1, 1000})
     ->Args({NUM_THREADS, NUM_THREADS, 1000});
 
+// Reports the counters of the pool per iteration of the benchmark.
+static void SetThreadPoolStatsCounters(benchmark::State& state, const ThreadPool* tp) {
+  const ThreadPoolStats stats = ThreadPool::GetStats(tp);
+  state.counters["tasks"] = benchmark::Counter(static_cast<double>(stats.num_tasks), benchmark::Counter::kAvgIterations);
+  state.counters["steals"] = benchmark::Counter(static_cast<double>(stats.num_steals), benchmark::Counter::kAvgIterations);
+  state.counters["spin_s"] = benchmark::Counter(stats.spin_time_ns / 1e9, benchmark::Counter::kAvgIterations);
+  state.counters["blocked_s"] = benchmark::Counter(stats.blocked_time_ns / 1e9, benchmark::Counter::kAvgIterations);
+}
+
+// A loop of a fixed amount of work split into blocks of a given grain size, to find the grain below which the cost of
+// scheduling the blocks outweighs the parallelism.
+static void BM_ThreadPoolParallelForGrainSize(benchmark::State& state) {
+  const std::ptrdiff_t total = 1 << 20;
+  const std::ptrdiff_t grain = state.range(0);
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(),
+                                         onnxruntime::ThreadOptions(),
+                                         nullptr,
+                                         NUM_THREADS, ALLOW_SPINNING);
+  for (auto _ : state) {
+    ThreadPool::TrySimpleParallelFor(tp.get(), total / grain, [grain](std::ptrdiff_t block) {
+      SimpleForLoop(block * grain, (block + 1) * grain);
+    });
+  }
+  SetThreadPoolStatsCounters(state, tp.get());
+}
+BENCHMARK(BM_ThreadPoolParallelForGrainSize)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->RangeMultiplier(4)
+    ->Range(16, 1 << 16);
+
+// Latency of a loop of one tiny block per thread after the pool was idle for a while, with and without spinning.
+// Once the workers spun for their spin count without finding work they block, so a long enough idle period turns the
+// spin wake-up into an OS wake-up. The idle period is not timed.
+static void BM_ThreadPoolWakeUp(benchmark::State& state) {
+  const bool allow_spinning = state.range(0) != 0;
+  const auto idle = std::chrono::microseconds(state.range(1));
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(),
+                                         onnxruntime::ThreadOptions(),
+                                         nullptr,
+                                         NUM_THREADS, allow_spinning);
+  for (auto _ : state) {
+    if (idle.count() > 0) {
+      std::this_thread::sleep_for(idle);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    ThreadPool::TrySimpleParallelFor(tp.get(), NUM_THREADS, [](std::ptrdiff_t) { SimpleForLoop(0, 100); });
+    state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+  SetThreadPoolStatsCounters(state, tp.get());
+}
+BENCHMARK(BM_ThreadPoolWakeUp)
+    ->UseManualTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->ArgNames({"spin", "idle_us"})
+    ->ArgsProduct({{0, 1}, {0, 100, 1000, 10000}});
+
+// Several sessions with a pool of their own each, as with per session threads, running loops concurrently so that
+// the pools together have more threads than there are cores. Each benchmark thread stands for a session.
+static void BM_ThreadPoolConcurrentSessions(benchmark::State& state) {
+  const bool allow_spinning = state.range(0) != 0;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(),
+                                         onnxruntime::ThreadOptions(),
+                                         nullptr,
+                                         NUM_THREADS, allow_spinning);
+  for (auto _ : state) {
+    ThreadPool::TryParallelFor(tp.get(), 10000, 200, SimpleForLoop);
+  }
+  SetThreadPoolStatsCounters(state, tp.get());
+}
+BENCHMARK(BM_ThreadPoolConcurrentSessions)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->ArgName("spin")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 8);
+
 static void BM_SimpleForLoop(benchmark::State& state) {
   const size_t len = state.range(0);
   for (auto _ : state) {
@@ -38,14 +38,18 @@
 #include "core/optimizer/double_qdq_pairs_remover.h"
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/dynamic_quantize_matmul_fusion.h"
+#include "core/optimizer/elementwise_chain_fusion.h"
+#include "core/optimizer/embedding_bag_fusion.h"
 #include "core/optimizer/expand_elimination.h"
 #include "core/optimizer/fast_gelu_fusion.h"
+#include "core/optimizer/gather_elementwise_reorder.h"
 #include "core/optimizer/gather_fusion.h"
 #include "core/optimizer/gelu_approximation.h"
 #include "core/optimizer/gelu_fusion.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/gemm_sum_fusion.h"
 #include "core/optimizer/gemm_transpose_fusion.h"
+#include "core/optimizer/group_query_attention_fusion.h"
 #include "core/optimizer/graph_transformer_config.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/graph_transformer_utils.h"
@@ -60,8 +64,11 @@
 #include "core/optimizer/matmul_integer_to_float.h"
 #include "core/optimizer/matmul_scale_fusion.h"
 #include "core/optimizer/matmul_transpose_fusion.h"
+#include "core/optimizer/memory_aware_node_ordering.h"
+#include "core/optimizer/memory_budget_optimizer.h"
 #include "core/optimizer/noop_elimination.h"
 #include "core/optimizer/not_where_fusion.h"
+#include "core/optimizer/packing_mode_transformer.h"
 #include "core/optimizer/pad_fusion.h"
 #include "core/optimizer/pre_shape_node_elimination.h"
 #include "core/optimizer/propagate_cast_ops.h"
@@ -71,8 +78,10 @@
 #include "core/optimizer/reshape_fusion.h"
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/slice_elimination.h"
+#include "core/optimizer/tensor_parallel_partitioner.h"
 #include "core/optimizer/unsqueeze_elimination.h"
 #include "core/optimizer/utils.h"
+#include "core/optimizer/zipmap_removal.h"
 #include "core/platform/env.h"
 #include "core/session/inference_session.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
@@ -137,6 +146,28 @@ TEST_F(GraphTransformationTests, IdentityEliminationWithGraphOutput) {
   ASSERT_TRUE(op_to_count["Identity"] == 0);
 }
 
+TEST_F(GraphTransformationTests, IdentityEliminationIncremental) {
+  constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "abs-id-max.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, *logger_));
+  Graph& graph = model->MainGraph();
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Identity"] == 1);
+  const int num_nodes = graph.NumberOfNodes();
+
+  // the second pass only revisits the neighbors of the removed Identity node, and must not change the graph
+  auto rule_transformer_L1 = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer1");
+  ASSERT_STATUS_OK(rule_transformer_L1->Register(std::make_unique<EliminateIdentity>()));
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.SetIncrementalRuleBasedTransformers(true);
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(std::move(rule_transformer_L1), TransformerLevel::Level1));
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level1, *logger_));
+
+  op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Identity"] == 0);
+  ASSERT_EQ(graph.NumberOfNodes(), num_nodes - 1);
+}
+
 TEST_F(GraphTransformationTests, IdentityWithSharedNodeArgNotEliminated) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "id-elim.onnx";
   std::shared_ptr<Model> model;
@@ -1049,6 +1080,93 @@ TEST_F(GraphTransformationTests, ConstantFoldingStringInitializer) {
   ASSERT_EQ(op_to_count.size(), 0U) << "Identity node should have been removed";
 }
 
+TEST_F(GraphTransformationTests, ConstantFoldingSizeBudget) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input0_arg = builder.MakeInput<float>({256, 256}, -1.0f, 1.0f);
+    auto* input1_arg = builder.MakeInput<float>({4}, -1.0f, 1.0f);
+    auto* value_arg = builder.MakeInitializer<float>({1}, {2.0f});
+    auto* shape_arg = builder.Make1DInitializer<int64_t>({256, 256});
+    auto* addend0_arg = builder.MakeInitializer<float>({4}, {1.0f, 2.0f, 3.0f, 4.0f});
+    auto* addend1_arg = builder.MakeInitializer<float>({4}, {4.0f, 3.0f, 2.0f, 1.0f});
+    auto* expand_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* output0_arg = builder.MakeOutput();
+    auto* output1_arg = builder.MakeOutput();
+
+    // the Expand output is 256KB, while the output of the Add of the constants is 16 bytes
+    builder.AddNode("Expand", {value_arg, shape_arg}, {expand_out});
+    builder.AddNode("Mul", {input0_arg, expand_out}, {output0_arg});
+    builder.AddNode("Add", {addend0_arg, addend1_arg}, {add_out});
+    builder.AddNode("Mul", {input1_arg, add_out}, {output1_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Expand"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_to_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_to_count["Expand"] == 1);
+    TEST_RETURN_IF_NOT(op_to_count["Add"] == 0);
+    TEST_RETURN_IF_NOT(op_to_count["Mul"] == 2);
+    return Status::OK();
+  };
+
+  ConfigOptions config_options;
+  ASSERT_STATUS_OK(config_options.AddConfigEntry(kOrtSessionOptionsConstantFoldingMaxOutputSizeInBytes, "1024"));
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  ASSERT_STATUS_OK(TestGraphTransformer(
+      build_test_case, 14, *logger_,
+      std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, config_options),
+      TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, ConstantFoldingSharesIdenticalResults) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({3, 2}, -1.0f, 1.0f);
+    auto* weight0_arg = builder.MakeInitializer<float>({2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+    auto* weight1_arg = builder.MakeInitializer<float>({2, 3}, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f});
+    auto* transpose0_out = builder.MakeIntermediate();
+    auto* transpose1_out = builder.MakeIntermediate();
+    auto* output0_arg = builder.MakeOutput();
+    auto* output1_arg = builder.MakeOutput();
+
+    builder.AddNode("Transpose", {weight0_arg}, {transpose0_out});
+    builder.AddNode("Transpose", {weight1_arg}, {transpose1_out});
+    builder.AddNode("Add", {input_arg, transpose0_out}, {output0_arg});
+    builder.AddNode("Add", {input_arg, transpose1_out}, {output1_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Transpose"] == 2);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Transpose"] == 0);
+
+    // both Add nodes use the same folded initializer
+    std::set<const NodeArg*> addends;
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Add") {
+        addends.insert(node.InputDefs()[1]);
+      }
+    }
+    TEST_RETURN_IF_NOT(addends.size() == 1);
+    return Status::OK();
+  };
+
+  const ConfigOptions empty_config_options;
+  std::unique_ptr<CPUExecutionProvider> e = std::make_unique<CPUExecutionProvider>(CPUExecutionProviderInfo());
+  ASSERT_STATUS_OK(TestGraphTransformer(
+      build_test_case, 14, *logger_,
+      std::make_unique<ConstantFolding>(*e.get(), false /*skip_dequantize_linear*/, empty_config_options),
+      TransformerLevel::Level1, 1, pre_graph_checker, post_graph_checker));
+}
+
 TEST_F(GraphTransformationTests, ConstantFoldingIfConstantInlining) {
   // This test covers the following necessary cases:
   // The input refers to the explicit or implicit inputs of If node.
@@ -1973,6 +2091,63 @@ TEST_F(GraphTransformationTests, LabelEncoderFusion) {
   EXPECT_EQ(ret.first, COMPARE_RESULT::SUCCESS) << ret.second;
 }
 
+#if !defined(DISABLE_ML_OPS)
+TEST_F(GraphTransformationTests, ZipMapRemoval) {
+  // the graph outputs are the probabilities of the classifier instead of a sequence of maps
+  auto post_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["ai.onnx.ml.ZipMap"] == 0);
+    for (const NodeArg* output : graph.GetOutputs()) {
+      TEST_RETURN_IF_NOT(output->TypeAsProto()->has_tensor_type());
+      TEST_RETURN_IF_NOT(output->TypeAsProto()->tensor_type().elem_type() ==
+                         ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    }
+    return Status::OK();
+  };
+
+  // the producer of the probabilities writes the output of the ZipMap
+  {
+    auto build_test_case = [](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 3}});
+      auto* softmax_out = builder.MakeIntermediate();
+      auto* zipmap_out = builder.MakeOutput();
+
+      builder.AddNode("Softmax", {input_arg}, {softmax_out});
+      Node& zipmap = builder.AddNode("ZipMap", {softmax_out}, {zipmap_out}, kMLDomain);
+      zipmap.AddAttribute("classlabels_int64s", std::vector<int64_t>{0, 1, 2});
+    };
+
+    auto check_graph = [&](Graph& graph) {
+      ORT_RETURN_IF_ERROR(post_graph_checker(graph));
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Identity"] == 0);
+      return Status::OK();
+    };
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::make_unique<ZipMapRemoval>(),
+                                          TransformerLevel::Level1, 1, nullptr, check_graph));
+  }
+
+  // the probabilities are also a graph output, so the ZipMap is replaced by an Identity
+  {
+    auto build_test_case = [](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>({{2, 3}});
+      auto* softmax_out = builder.MakeOutput();
+      auto* zipmap_out = builder.MakeOutput();
+
+      builder.AddNode("Softmax", {input_arg}, {softmax_out});
+      Node& zipmap = builder.AddNode("ZipMap", {softmax_out}, {zipmap_out}, kMLDomain);
+      zipmap.AddAttribute("classlabels_strings", std::vector<std::string>{"a", "b", "c"});
+    };
+
+    auto check_graph = [&](Graph& graph) {
+      ORT_RETURN_IF_ERROR(post_graph_checker(graph));
+      TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Identity"] == 1);
+      return Status::OK();
+    };
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::make_unique<ZipMapRemoval>(),
+                                          TransformerLevel::Level1, 1, nullptr, check_graph));
+  }
+}
+#endif  // !defined(DISABLE_ML_OPS)
+
 TEST_F(GraphTransformationTests, NotWhereFusion) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "fusion/not_where.onnx";
   std::shared_ptr<Model> model;
@@ -4055,6 +4230,101 @@ TEST_F(GraphTransformationTests, CastElimination) {
   ASSERT_TRUE(op_to_count["Cast"] == 4);
 }
 
+TEST_F(GraphTransformationTests, GatherElementwiseReorder) {
+  // the table is dequantized, or cast, before the Gather, and the Gather may be followed by a QuantizeLinear
+  auto build_test_case = [](const std::string& op_type, bool quantize_output) {
+    return [op_type, quantize_output](ModelTestBuilder& builder) {
+      auto* indices_arg = builder.MakeInput<int64_t>({{2, 3}});
+      auto* converted_arg = builder.MakeIntermediate();
+      auto* gather_out = quantize_output ? builder.MakeIntermediate() : builder.MakeOutput();
+
+      if (op_type == "Cast") {
+        auto* table_arg = builder.MakeInitializer<MLFloat16>({16, 4}, std::vector<MLFloat16>(64, MLFloat16(0.5f)));
+        builder.AddNode("Cast", {table_arg}, {converted_arg})
+            .AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+      } else {
+        auto* table_arg = builder.MakeInitializer<int8_t>({16, 4}, -64, 64);
+        builder.AddDequantizeLinearNode<int8_t>(table_arg, 0.05f, 1, converted_arg);
+      }
+
+      builder.AddNode("Gather", {converted_arg, indices_arg}, {gather_out}).AddAttribute("axis", int64_t(0));
+      if (quantize_output) {
+        builder.AddQuantizeLinearNode<int8_t>(gather_out, 0.05f, 1, builder.MakeOutput());
+      }
+    };
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+    return Status::OK();
+  };
+
+  // the Gather reads the table, and the converting node reads the gathered rows
+  auto reordered_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Gather"] == 1);
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Gather") {
+        TEST_RETURN_IF_NOT(graph_utils::IsConstantInitializer(graph, node.InputDefs()[0]->Name()));
+        TEST_RETURN_IF_NOT(node.GetOutputEdgesCount() == 1);
+        const std::string& consumer = node.OutputNodesBegin()->OpType();
+        TEST_RETURN_IF_NOT(consumer == "Cast" || consumer == "DequantizeLinear");
+      }
+    }
+    return Status::OK();
+  };
+
+  auto unchanged_graph_checker = [](Graph& graph) {
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Gather") {
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 0) != nullptr);
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 0)->OpType() == "DequantizeLinear");
+      }
+    }
+    return Status::OK();
+  };
+
+  for (const std::string& op_type : {std::string("Cast"), std::string("DequantizeLinear")}) {
+    auto rule_transformer = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer");
+    ASSERT_STATUS_OK(rule_transformer->Register(std::make_unique<GatherElementwiseReorder>()));
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case(op_type, false), 13, *logger_, std::move(rule_transformer),
+                                          TransformerLevel::Level1, 1, pre_graph_checker, reordered_graph_checker));
+  }
+
+  // DequantizeLinear -> Gather -> QuantizeLinear is left to the QDQ transformers
+  auto rule_transformer = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer");
+  ASSERT_STATUS_OK(rule_transformer->Register(std::make_unique<GatherElementwiseReorder>()));
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case("DequantizeLinear", true), 13, *logger_,
+                                        std::move(rule_transformer), TransformerLevel::Level1, 1, pre_graph_checker,
+                                        unchanged_graph_checker));
+
+  // a uint8 table is gathered before it is dequantized
+  auto build_uint8_test_case = [](ModelTestBuilder& builder) {
+    auto* table_arg = builder.MakeInitializer<uint8_t>({16, 4}, 0, 255);
+    auto* indices_arg = builder.MakeInput<int64_t>({{2, 3}});
+    auto* dq_arg = builder.MakeIntermediate();
+    builder.AddDequantizeLinearNode<uint8_t>(table_arg, 0.05f, 128, dq_arg);
+    builder.AddNode("Gather", {dq_arg, indices_arg}, {builder.MakeOutput()}).AddAttribute("axis", int64_t(0));
+  };
+  rule_transformer = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer");
+  ASSERT_STATUS_OK(rule_transformer->Register(std::make_unique<GatherElementwiseReorder>()));
+  ASSERT_STATUS_OK(TestGraphTransformer(build_uint8_test_case, 13, *logger_, std::move(rule_transformer),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, reordered_graph_checker));
+
+  // there is no Gather kernel for int4 tables, so they are dequantized first
+  auto build_int4_test_case = [](ModelTestBuilder& builder) {
+    auto* table_arg = builder.MakeInitializer<Int4x2>({16, 4}, Int4x2(Int4x2::min_val, 0),
+                                                      Int4x2(Int4x2::max_val, 0));
+    auto* indices_arg = builder.MakeInput<int64_t>({{2, 3}});
+    auto* dq_arg = builder.MakeIntermediate();
+    builder.AddDequantizeLinearNode<Int4x2>(table_arg, 0.05f, Int4x2(1, 0), dq_arg);
+    builder.AddNode("Gather", {dq_arg, indices_arg}, {builder.MakeOutput()}).AddAttribute("axis", int64_t(0));
+  };
+  rule_transformer = std::make_unique<RuleBasedGraphTransformer>("RuleTransformer");
+  ASSERT_STATUS_OK(rule_transformer->Register(std::make_unique<GatherElementwiseReorder>()));
+  ASSERT_STATUS_OK(TestGraphTransformer(build_int4_test_case, 21, *logger_, std::move(rule_transformer),
+                                        TransformerLevel::Level1, 1, pre_graph_checker, unchanged_graph_checker));
+}
+
 TEST_F(GraphTransformationTests, PreShapeNodeElimination) {
   constexpr const ORTCHAR_T* model_uri = MODEL_FOLDER "pre_shape_node_elimination.onnx";
   std::shared_ptr<Model> model;
@@ -7641,6 +7911,52 @@ TEST_F(GraphTransformationTests, GatherToSliceFusion) {
   }
 }
 
+TEST_F(GraphTransformationTests, EmbeddingBagFusion) {
+  auto pre_graph_checker = [&](Graph& graph) {
+    auto op_count_map = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count_map["Gather"] == 1);
+    return Status::OK();
+  };
+
+  // ReduceSum with the axes as an input, ReduceMean with the axes as an attribute, and a ReduceSum keeping the axis.
+  for (int case_index = 0; case_index < 3; case_index++) {
+    const bool fused = case_index != 2;
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* table_arg = builder.MakeInitializer<float>({16, 4}, 0.0f, 1.0f);
+      auto* indices_arg = builder.MakeInput<int64_t>({{2, 3}});
+      auto* gather_output = builder.MakeIntermediate();
+      auto* reduce_output = builder.MakeOutput();
+
+      builder.AddNode("Gather", {table_arg, indices_arg}, {gather_output});
+      if (case_index == 1) {
+        Node& reduce_node = builder.AddNode("ReduceMean", {gather_output}, {reduce_output});
+        reduce_node.AddAttribute("axes", std::vector<int64_t>{1});
+        reduce_node.AddAttribute("keepdims", static_cast<int64_t>(0));
+      } else {
+        auto* axes_arg = builder.MakeInitializer<int64_t>({1}, {-2});
+        builder.AddNode("ReduceSum", {gather_output, axes_arg}, {reduce_output})
+            .AddAttribute("keepdims", static_cast<int64_t>(case_index == 0 ? 0 : 1));
+      }
+    };
+
+    auto post_graph_checker = [&](Graph& graph) {
+      auto op_count_map = CountOpsInGraph(graph);
+      TEST_RETURN_IF_NOT(op_count_map["Gather"] == (fused ? 0 : 1));
+      TEST_RETURN_IF_NOT(op_count_map["com.microsoft.EmbeddingBag"] == (fused ? 1 : 0));
+      for (auto& node : graph.Nodes()) {
+        if (node.OpType() == "EmbeddingBag") {
+          TEST_RETURN_IF_NOT(node.GetAttributes().at("mode").s() == (case_index == 0 ? "sum" : "mean"));
+        }
+      }
+      return Status::OK();
+    };
+
+    std::unique_ptr<GraphTransformer> transformer = std::make_unique<EmbeddingBagFusion>();
+    ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::move(transformer),
+                                          TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+  }
+}
+
 #if !defined(DISABLE_CONTRIB_OPS)
 
 TEST_F(GraphTransformationTests, MatMulNBitsBiasFusion) {
@@ -7733,7 +8049,636 @@ TEST_F(GraphTransformationTests, MatMulNBitsBiasFusion) {
   }
 }
 
+TEST_F(GraphTransformationTests, ElementwiseChainFusion) {
+  // Sigmoid((x + bias) * x) * y, where bias has a single element
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({2, 3, 17, 41}, -2.f, 2.f);
+    auto* y_arg = builder.MakeInput<float>({2, 3, 17, 41}, -2.f, 2.f);
+    auto* bias_arg = builder.MakeInitializer<float>({1}, {0.5f});
+    auto* add_out = builder.MakeIntermediate();
+    auto* mul_out_0 = builder.MakeIntermediate();
+    auto* sigmoid_out = builder.MakeIntermediate();
+    auto* mul_out_1 = builder.MakeOutput();
+
+    builder.AddNode("Add", {x_arg, bias_arg}, {add_out});
+    builder.AddNode("Mul", {add_out, x_arg}, {mul_out_0});
+    builder.AddNode("Sigmoid", {mul_out_0}, {sigmoid_out});
+    builder.AddNode("Mul", {sigmoid_out, y_arg}, {mul_out_1});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_count["Add"], 0);
+    EXPECT_EQ(op_count["Mul"], 0);
+    EXPECT_EQ(op_count["Sigmoid"], 0);
+    EXPECT_EQ(op_count["com.microsoft.FusedElementwise"], 1);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-6, 1e-6, std::make_unique<ElementwiseChainFusion>());
+}
+
+TEST_F(GraphTransformationTests, ElementwiseChainFusionIntermediateGraphOutput) {
+  // the result of the Add is a graph output, so only Mul->Sigmoid can be fused
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* x_arg = builder.MakeInput<float>({{4, 8}});
+    auto* y_arg = builder.MakeInput<float>({{4, 8}});
+    auto* add_out = builder.MakeOutput();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* sigmoid_out = builder.MakeOutput();
+
+    builder.AddNode("Add", {x_arg, y_arg}, {add_out});
+    builder.AddNode("Mul", {add_out, y_arg}, {mul_out});
+    builder.AddNode("Sigmoid", {mul_out}, {sigmoid_out});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Add"] == 1);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Mul"] == 1);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Sigmoid"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count["Add"] == 1);
+    TEST_RETURN_IF_NOT(op_count["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_count["Sigmoid"] == 0);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.FusedElementwise"] == 1);
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "FusedElementwise") {
+        const auto& attrs = node.GetAttributes();
+        TEST_RETURN_IF_NOT(attrs.at("ops").strings_size() == 2);
+        TEST_RETURN_IF_NOT(attrs.at("ops").strings(0) == "Mul");
+        TEST_RETURN_IF_NOT(attrs.at("ops").strings(1) == "Sigmoid");
+        // the Mul reads both inputs, and the Sigmoid reads the result of the Mul
+        TEST_RETURN_IF_NOT(attrs.at("op_inputs").ints_size() == 4);
+        TEST_RETURN_IF_NOT(attrs.at("op_inputs").ints(0) == 0);
+        TEST_RETURN_IF_NOT(attrs.at("op_inputs").ints(1) == 1);
+        TEST_RETURN_IF_NOT(attrs.at("op_inputs").ints(2) == 2);
+        TEST_RETURN_IF_NOT(attrs.at("op_inputs").ints(3) == -1);
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::make_unique<ElementwiseChainFusion>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+// Build the attention of a decoder export with rotary embedding, KV cache and repeated KV heads:
+// B = 2, S = sequence_length, past sequence length P = 5, N = 4, KV heads = 2, H = 8.
+// The graph has no causal mask, so it only computes the same values as GroupQueryAttention when S = 1.
+static void BuildDecoderAttention(ModelTestBuilder& builder, bool use_attention_mask, int64_t sequence_length = 3) {
+  const int64_t S = sequence_length;
+  auto* query = builder.MakeInput<float>({2, S, 32}, -1.f, 1.f);
+  auto* key = builder.MakeInput<float>({2, S, 16}, -1.f, 1.f);
+  auto* value = builder.MakeInput<float>({2, S, 16}, -1.f, 1.f);
+  auto* past_key = builder.MakeInput<float>({2, 2, 5, 8}, -1.f, 1.f);
+  auto* past_value = builder.MakeInput<float>({2, 2, 5, 8}, -1.f, 1.f);
+  std::vector<int64_t> positions;
+  for (int64_t b = 0; b < 2; b++) {
+    for (int64_t s = 0; s < S; s++) {
+      positions.push_back(5 + s);
+    }
+  }
+  auto* position_ids = builder.MakeInitializer<int64_t>({2, S}, positions);
+  auto* cos_cache = builder.MakeInitializer<float>({16, 4}, -1.f, 1.f);
+  auto* sin_cache = builder.MakeInitializer<float>({16, 4}, -1.f, 1.f);
+
+  // Q, K and V to BNSH, with the rotary embedding on Q and K
+  const auto project = [&](NodeArg* input, int64_t num_heads, bool rotary) {
+    auto* reshape_out = builder.MakeIntermediate();
+    auto* transpose_out = builder.MakeIntermediate();
+    builder.AddNode("Reshape", {input, builder.Make1DInitializer<int64_t>({2, S, num_heads, 8})}, {reshape_out});
+    builder.AddNode("Transpose", {reshape_out}, {transpose_out})
+        .AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+    if (!rotary) {
+      return transpose_out;
+    }
+
+    auto* rotary_out = builder.MakeIntermediate();
+    builder.AddNode("RotaryEmbedding", {transpose_out, position_ids, cos_cache, sin_cache}, {rotary_out}, kMSDomain);
+    return rotary_out;
+  };
+
+  // Concat the past and repeat the 2 KV heads to 4 heads
+  const auto concat_and_repeat = [&](NodeArg* past, NodeArg* current, NodeArg* present) {
+    builder.AddNode("Concat", {past, current}, {present}).AddAttribute("axis", static_cast<int64_t>(2));
+    auto* unsqueeze_out = builder.MakeIntermediate();
+    auto* expand_out = builder.MakeIntermediate();
+    auto* reshape_out = builder.MakeIntermediate();
+    builder.AddNode("Unsqueeze", {present, builder.Make1DInitializer<int64_t>({2})}, {unsqueeze_out});
+    builder.AddNode("Expand", {unsqueeze_out, builder.Make1DInitializer<int64_t>({2, 2, 2, 5 + S, 8})}, {expand_out});
+    builder.AddNode("Reshape", {expand_out, builder.Make1DInitializer<int64_t>({2, 4, 5 + S, 8})}, {reshape_out});
+    return reshape_out;
+  };
+
+  auto* present_key = builder.MakeOutput();
+  auto* present_value = builder.MakeOutput();
+  auto* q = project(query, 4, true);
+  auto* k = concat_and_repeat(past_key, project(key, 2, true), present_key);
+  auto* v = concat_and_repeat(past_value, project(value, 2, false), present_value);
+
+  auto* k_transpose_out = builder.MakeIntermediate();
+  auto* qk_out = builder.MakeIntermediate();
+  auto* scaled_out = builder.MakeIntermediate();
+  builder.AddNode("Transpose", {k}, {k_transpose_out}).AddAttribute("perm", std::vector<int64_t>{0, 1, 3, 2});
+  builder.AddNode("MatMul", {q, k_transpose_out}, {qk_out});
+  builder.AddNode("Div", {qk_out, builder.MakeScalarInitializer<float>(std::sqrt(8.f))}, {scaled_out});
+
+  // (1 - mask) * -10000 of shape (B, 1, 1, P + S)
+  NodeArg* mask = nullptr;
+  if (use_attention_mask) {
+    auto* attention_mask = builder.MakeInput<int64_t>({2, 5 + S}, std::vector<int64_t>(2 * (5 + S), 1));
+    auto* cast_out = builder.MakeIntermediate();
+    auto* sub_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    mask = builder.MakeIntermediate();
+    builder.AddNode("Cast", {attention_mask}, {cast_out})
+        .AddAttribute("to", static_cast<int64_t>(ONNX_NAMESPACE::TensorProto_DataType_FLOAT));
+    builder.AddNode("Sub", {builder.MakeScalarInitializer<float>(1.f), cast_out}, {sub_out});
+    builder.AddNode("Mul", {sub_out, builder.MakeScalarInitializer<float>(-10000.f)}, {mul_out});
+    builder.AddNode("Unsqueeze", {mul_out, builder.Make1DInitializer<int64_t>({1, 2})}, {mask});
+  } else {
+    mask = builder.MakeInitializer<float>({1, 1, S, 5 + S}, -1.f, 0.f);
+  }
+
+  auto* masked_out = builder.MakeIntermediate();
+  auto* softmax_out = builder.MakeIntermediate();
+  auto* qkv_out = builder.MakeIntermediate();
+  auto* transpose_out = builder.MakeIntermediate();
+  auto* output = builder.MakeOutput();
+  builder.AddNode("Add", {scaled_out, mask}, {masked_out});
+  builder.AddNode("Softmax", {masked_out}, {softmax_out}).AddAttribute("axis", static_cast<int64_t>(-1));
+  builder.AddNode("MatMul", {softmax_out, v}, {qkv_out});
+  builder.AddNode("Transpose", {qkv_out}, {transpose_out}).AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  builder.AddNode("Reshape", {transpose_out, builder.Make1DInitializer<int64_t>({2, S, 32})}, {output});
+}
+
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusion) {
+  auto build_test_case = [](ModelTestBuilder& builder) { BuildDecoderAttention(builder, true); };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.RotaryEmbedding"] == 2);
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Softmax"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.GroupQueryAttention"] == 1);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.RotaryEmbedding"] == 0);
+    TEST_RETURN_IF_NOT(op_count["Softmax"] == 0);
+    TEST_RETURN_IF_NOT(op_count["MatMul"] == 0);
+    TEST_RETURN_IF_NOT(op_count["Concat"] == 0);
+    TEST_RETURN_IF_NOT(op_count["Expand"] == 0);
+    TEST_RETURN_IF_NOT(op_count["Transpose"] == 0);
+    // the float mask is replaced by the sequence lengths computed from the attention mask
+    TEST_RETURN_IF_NOT(op_count["Mul"] == 0);
+    TEST_RETURN_IF_NOT(op_count["ReduceSum"] == 1);
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "GroupQueryAttention") {
+        const auto& attrs = node.GetAttributes();
+        TEST_RETURN_IF_NOT(attrs.at("num_heads").i() == 4);
+        TEST_RETURN_IF_NOT(attrs.at("kv_num_heads").i() == 2);
+        TEST_RETURN_IF_NOT(attrs.at("do_rotary").i() == 1);
+        TEST_RETURN_IF_NOT(std::abs(attrs.at("scale").f() - 1.f / std::sqrt(8.f)) < 1e-6f);
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 9);
+        TEST_RETURN_IF_NOT(graph.IsOutput(node.OutputDefs()[1]) && graph.IsOutput(node.OutputDefs()[2]));
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_,
+                                        std::make_unique<GroupQueryAttentionFusion>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+// Compare the outputs and the present key and value of a decoding step with the ones of the unfused graph.
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusionNumerics) {
+  auto build_test_case = [](ModelTestBuilder& builder) { BuildDecoderAttention(builder, true, 1); };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_count["com.microsoft.GroupQueryAttention"], 1);
+    EXPECT_EQ(op_count["Softmax"], 0);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14, 1e-5, 1e-4,
+                    std::make_unique<GroupQueryAttentionFusion>());
+}
+
+TEST_F(GraphTransformationTests, GroupQueryAttentionFusionWithoutAttentionMask) {
+  // the sequence lengths can't be computed without an attention mask input
+  auto build_test_case = [](ModelTestBuilder& builder) { BuildDecoderAttention(builder, false); };
+
+  auto pre_graph_checker = [](Graph&) { return Status::OK(); };
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.GroupQueryAttention"] == 0);
+    TEST_RETURN_IF_NOT(op_count["Softmax"] == 1);
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_,
+                                        std::make_unique<GroupQueryAttentionFusion>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
 #endif  // !defined(DISABLE_CONTRIB_OPS)
 
+TEST_F(GraphTransformationTests, MemoryAwareNodeOrdering) {
+  // Two branches which each produce a large value and reduce it. With the same priority for all the nodes, the
+  // priority-based order runs both Relu nodes first, so both large values are live at the same time.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({64, 64}, -1.0f, 1.0f);
+    auto* relu0_out = builder.MakeIntermediate();
+    auto* relu1_out = builder.MakeIntermediate();
+    auto* reduce0_out = builder.MakeIntermediate();
+    auto* reduce1_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("Relu", {input_arg}, {relu0_out});
+    builder.AddNode("Relu", {input_arg}, {relu1_out});
+    builder.AddNode("ReduceMean", {relu0_out}, {reduce0_out}).AddAttribute("axes", std::vector<int64_t>{0, 1});
+    builder.AddNode("ReduceMean", {relu1_out}, {reduce1_out}).AddAttribute("axes", std::vector<int64_t>{0, 1});
+    builder.AddNode("Concat", {reduce0_out, reduce1_out}, {output_arg}).AddAttribute("axis", int64_t{0});
+  };
+
+  const auto get_priority_based_op_types = [](Graph& graph) {
+    GraphViewer graph_viewer(graph);
+    std::vector<std::string> op_types;
+    for (auto node_index : graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::PRIORITY_BASED)) {
+      op_types.push_back(graph.GetNode(node_index)->OpType());
+    }
+    return op_types;
+  };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    const std::vector<std::string> expected{"Relu", "Relu", "ReduceMean", "ReduceMean", "Concat"};
+    TEST_RETURN_IF_NOT(get_priority_based_op_types(graph) == expected);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    const std::vector<std::string> expected{"Relu", "ReduceMean", "Relu", "ReduceMean", "Concat"};
+    TEST_RETURN_IF_NOT(get_priority_based_op_types(graph) == expected);
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::make_unique<MemoryAwareNodeOrdering>(),
+                                        TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, MemoryAwareNodeOrderingKeepsPrioritiesOfOtherPasses) {
+  // Three branches which each produce a large value and reduce it, the last one having a low priority set by another
+  // pass. Only the priorities needed to run the first two branches one after the other are set.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({64, 64}, -1.0f, 1.0f);
+    std::vector<NodeArg*> relu_outs{builder.MakeIntermediate(), builder.MakeIntermediate(),
+                                    builder.MakeIntermediate()};
+    std::vector<NodeArg*> reduce_outs{builder.MakeIntermediate(), builder.MakeIntermediate(),
+                                      builder.MakeIntermediate()};
+    auto* output_arg = builder.MakeOutput();
+
+    for (size_t i = 0; i < relu_outs.size(); ++i) {
+      builder.AddNode("Relu", {input_arg}, {relu_outs[i]});
+    }
+    for (size_t i = 0; i < reduce_outs.size(); ++i) {
+      builder.AddNode("ReduceMean", {relu_outs[i]}, {reduce_outs[i]})
+          .AddAttribute("axes", std::vector<int64_t>{0, 1});
+    }
+    builder.AddNode("Concat", reduce_outs, {output_arg}).AddAttribute("axis", int64_t{0});
+  };
+
+  const auto get_priority_based_order = [](Graph& graph) {
+    GraphViewer graph_viewer(graph);
+    std::vector<std::string> nodes;
+    for (auto node_index : graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::PRIORITY_BASED)) {
+      const Node& node = *graph.GetNode(node_index);
+      nodes.push_back(node.OpType() == "Relu" ? "relu" + std::to_string(node.Index()) : node.OpType());
+    }
+    return nodes;
+  };
+
+  // the Relu nodes are the first ones added to the graph
+  const auto get_relu = [](Graph& graph, NodeIndex index) -> Node& { return *graph.GetNode(index); };
+
+  auto pre_graph_checker = [&](Graph& graph) {
+    get_relu(graph, 2).SetPriority(static_cast<int>(ExecutionPriority::LOCAL_LOW));
+    const std::vector<std::string> expected{"relu0", "relu1", "ReduceMean", "ReduceMean", "relu2", "ReduceMean",
+                                            "Concat"};
+    TEST_RETURN_IF_NOT(get_priority_based_order(graph) == expected);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    const std::vector<std::string> expected{"relu0", "ReduceMean", "relu1", "ReduceMean", "relu2", "ReduceMean",
+                                            "Concat"};
+    TEST_RETURN_IF_NOT(get_priority_based_order(graph) == expected);
+    // the priority set by the other pass is kept, and the nodes which already run in order aren't changed
+    TEST_RETURN_IF_NOT(get_relu(graph, 2).Priority() == static_cast<int>(ExecutionPriority::LOCAL_LOW));
+    TEST_RETURN_IF_NOT(get_relu(graph, 0).Priority() == static_cast<int>(ExecutionPriority::DEFAULT));
+    TEST_RETURN_IF_NOT(get_relu(graph, 1).Priority() > static_cast<int>(ExecutionPriority::DEFAULT));
+    TEST_RETURN_IF_NOT(get_relu(graph, 1).Priority() < static_cast<int>(ExecutionPriority::LOCAL_LOW));
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 13, *logger_, std::make_unique<MemoryAwareNodeOrdering>(),
+                                        TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, MemoryBudgetOptimizerChunksAttention) {
+  // Softmax(Q * K^T * scale + mask) * V, whose 480 bytes of scores are chunked into 3 chunks of rows for a budget of
+  // 200 bytes. The mask has a row for each row of Q, so it's split too.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* q_arg = builder.MakeInput<float>({2, 2, 5, 4}, -1.f, 1.f);
+    auto* k_arg = builder.MakeInput<float>({2, 2, 4, 6}, -1.f, 1.f);
+    auto* v_arg = builder.MakeInput<float>({2, 2, 6, 4}, -1.f, 1.f);
+    auto* mask_arg = builder.MakeInput<float>({1, 1, 5, 6}, -1.f, 0.f);
+    auto* scale_arg = builder.MakeInitializer<float>({}, {0.5f});
+    auto* qk_out = builder.MakeIntermediate();
+    auto* mul_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* softmax_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {q_arg, k_arg}, {qk_out});
+    builder.AddNode("Mul", {qk_out, scale_arg}, {mul_out});
+    builder.AddNode("Add", {mul_out, mask_arg}, {add_out});
+    builder.AddNode("Softmax", {add_out}, {softmax_out}).AddAttribute("axis", int64_t{-1});
+    builder.AddNode("MatMul", {softmax_out, v_arg}, {output_arg});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    auto op_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_count["Split"], 2);
+    EXPECT_EQ(op_count["Concat"], 1);
+    EXPECT_EQ(op_count["MatMul"], 6);
+    EXPECT_EQ(op_count["Softmax"], 3);
+  };
+
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 14,
+                    1e-6, 1e-6, std::make_unique<MemoryBudgetOptimizer>(200));
+}
+
+TEST_F(GraphTransformationTests, MemoryBudgetOptimizerRecomputesLargeValues) {
+  // A mask expanded to 1536 bytes and used by two nodes is recomputed for the second one for a budget of 1024 bytes.
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* mask_arg = builder.MakeInput<float>({1, 1, 1, 6}, -1.f, 0.f);
+    auto* x_arg = builder.MakeInput<float>({1, 1, 64, 6}, -1.f, 1.f);
+    auto* y_arg = builder.MakeInput<float>({1, 1, 64, 6}, -1.f, 1.f);
+    auto* shape_arg = builder.MakeInitializer<int64_t>({4}, {1, 1, 64, 6});
+    auto* expand_out = builder.MakeIntermediate();
+    auto* output0_arg = builder.MakeOutput();
+    auto* output1_arg = builder.MakeOutput();
+
+    builder.AddNode("Expand", {mask_arg, shape_arg}, {expand_out});
+    builder.AddNode("Add", {x_arg, expand_out}, {output0_arg});
+    builder.AddNode("Add", {y_arg, expand_out}, {output1_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Expand"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["Expand"] == 2);
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "Expand") {
+        TEST_RETURN_IF_NOT(node.GetOutputEdgesCount() == 1);
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_, std::make_unique<MemoryBudgetOptimizer>(1024),
+                                        TransformerLevel::Level3, 1, pre_graph_checker, post_graph_checker));
+}
+
+#if defined(ORT_USE_NCCL)
+TEST_F(GraphTransformationTests, TensorParallelPartitionerShardsMlp) {
+  // MatMul -> Add -> Gelu -> MatMul for rank 1 of 2: W1 and B1 keep their last 3 columns, W2 its last 3 rows.
+  std::vector<float> w1_data(4 * 6), w2_data(6 * 4);
+  for (size_t i = 0; i < w1_data.size(); ++i) {
+    w1_data[i] = static_cast<float>(i);
+    w2_data[i] = static_cast<float>(100 + i);
+  }
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 3, 4}, -1.f, 1.f);
+    auto* w1_arg = builder.MakeInitializer<float>({4, 6}, w1_data);
+    auto* b1_arg = builder.MakeInitializer<float>({6}, {0.f, 1.f, 2.f, 3.f, 4.f, 5.f});
+    auto* w2_arg = builder.MakeInitializer<float>({6, 4}, w2_data);
+    auto* matmul1_out = builder.MakeIntermediate();
+    auto* add_out = builder.MakeIntermediate();
+    auto* gelu_out = builder.MakeIntermediate();
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("MatMul", {input_arg, w1_arg}, {matmul1_out});
+    builder.AddNode("Add", {matmul1_out, b1_arg}, {add_out});
+    builder.AddNode("Gelu", {add_out}, {gelu_out}, kMSDomain);
+    builder.AddNode("MatMul", {gelu_out, w2_arg}, {output_arg});
+  };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.AllReduce"] == 0);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [&](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.AllReduce"] == 1);
+    TEST_RETURN_IF_NOT(op_count["MatMul"] == 2);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "AllReduce") {
+        TEST_RETURN_IF_NOT(graph.NodeProducesGraphOutput(node));
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 0)->OpType() == "MatMul");
+        continue;
+      }
+
+      if (node.OpType() != "MatMul" && node.OpType() != "Add") {
+        continue;
+      }
+
+      const auto* weight = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      TEST_RETURN_IF_NOT(weight != nullptr);
+      Initializer shard{*weight, graph.ModelPath()};
+      const auto values = shard.DataAsSpan<float>();
+      if (node.OpType() == "Add") {
+        TEST_RETURN_IF_NOT(shard.dims().size() == 1 && shard.dims()[0] == 3);
+        TEST_RETURN_IF_NOT(values[0] == 3.f && values[2] == 5.f);
+      } else if (graph_utils::GetInputNode(node, 0) == nullptr) {
+        // W1[:, 3:6]
+        TEST_RETURN_IF_NOT(shard.dims().size() == 2 && shard.dims()[0] == 4 && shard.dims()[1] == 3);
+        TEST_RETURN_IF_NOT(values[0] == w1_data[3] && values[3] == w1_data[9] && values[11] == w1_data[23]);
+      } else {
+        // W2[3:6, :]
+        TEST_RETURN_IF_NOT(shard.dims().size() == 2 && shard.dims()[0] == 3 && shard.dims()[1] == 4);
+        TEST_RETURN_IF_NOT(values[0] == w2_data[12] && values[11] == w2_data[23]);
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 14, *logger_,
+                                        std::make_unique<TensorParallelPartitioner>(1, 2), TransformerLevel::Level2,
+                                        1, pre_graph_checker, post_graph_checker));
+}
+#endif  // defined(ORT_USE_NCCL)
+
+namespace {
+// Attention -> [identity Transpose] -> Add(., X) -> MatMul -> FastGelu -> SkipLayerNormalization(., X) on padded tokens.
+void BuildPackableEncoder(ModelTestBuilder& builder, bool add_transpose) {
+  auto* input_arg = builder.MakeInput<float>({2, 4, 8}, -1.f, 1.f);
+  auto* mask_arg = builder.MakeInput<int32_t>({2}, {3, 4});
+  auto* qkv_weight = builder.MakeInitializer<float>({8, 24}, -1.f, 1.f);
+  auto* qkv_bias = builder.MakeInitializer<float>({24}, -1.f, 1.f);
+  auto* ffn_weight = builder.MakeInitializer<float>({8, 8}, -1.f, 1.f);
+  auto* ffn_bias = builder.MakeInitializer<float>({8}, -1.f, 1.f);
+  auto* gamma = builder.MakeInitializer<float>({8}, 0.5f, 1.5f);
+  auto* beta = builder.MakeInitializer<float>({8}, -1.f, 1.f);
+  auto* attention_out = builder.MakeIntermediate();
+  auto* add_out = builder.MakeIntermediate();
+  auto* matmul_out = builder.MakeIntermediate();
+  auto* gelu_out = builder.MakeIntermediate();
+  auto* output_arg = builder.MakeOutput();
+
+  builder.AddNode("Attention", {input_arg, qkv_weight, qkv_bias, mask_arg}, {attention_out}, kMSDomain)
+      .AddAttribute("num_heads", static_cast<int64_t>(2));
+  if (add_transpose) {
+    auto* transpose_out = builder.MakeIntermediate();
+    builder.AddNode("Transpose", {attention_out}, {transpose_out})
+        .AddAttribute("perm", std::vector<int64_t>{0, 1, 2});
+    builder.AddNode("Add", {transpose_out, input_arg}, {add_out});
+  } else {
+    builder.AddNode("Add", {attention_out, input_arg}, {add_out});
+  }
+  builder.AddNode("MatMul", {add_out, ffn_weight}, {matmul_out});
+  builder.AddNode("FastGelu", {matmul_out, ffn_bias}, {gelu_out}, kMSDomain);
+  builder.AddNode("SkipLayerNormalization", {gelu_out, add_out, gamma, beta}, {output_arg}, kMSDomain);
+}
+}  // namespace
+
+TEST_F(GraphTransformationTests, PackingModeTransformerPacksEncoder) {
+  auto build_test_case = [](ModelTestBuilder& builder) { BuildPackableEncoder(builder, false); };
+
+  auto pre_graph_checker = [](Graph& graph) {
+    TEST_RETURN_IF_NOT(CountOpsInGraph(graph)["com.microsoft.Attention"] == 1);
+    return Status::OK();
+  };
+
+  auto post_graph_checker = [](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.Attention"] == 0);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.PackedAttention"] == 1);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.RemovePadding"] == 1);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.RestorePadding"] == 1);
+
+    for (const auto& node : graph.Nodes()) {
+      if (node.OpType() == "RestorePadding") {
+        TEST_RETURN_IF_NOT(graph.NodeProducesGraphOutput(node));
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 0)->OpType() == "SkipLayerNormalization");
+        const auto* output_shape = node.OutputDefs()[0]->Shape();
+        TEST_RETURN_IF_NOT(output_shape != nullptr && output_shape->dim_size() == 3);
+      } else if (node.OpType() == "PackedAttention") {
+        TEST_RETURN_IF_NOT(node.InputDefs().size() == 5);
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 0)->OpType() == "RemovePadding");
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 3)->OpType() == "RemovePadding");
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 4)->OpType() == "RemovePadding");
+      } else if (node.OpType() == "Add" || node.OpType() == "SkipLayerNormalization") {
+        // the residual connections use the packed tokens too
+        TEST_RETURN_IF_NOT(graph_utils::GetInputNode(node, 1) != nullptr);
+        const auto* shape = node.OutputDefs()[0]->Shape();
+        TEST_RETURN_IF_NOT(node.OpType() != "Add" || shape == nullptr || shape->dim_size() == 2);
+      }
+    }
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 17, *logger_, std::make_unique<PackingModeTransformer>(),
+                                        TransformerLevel::Level2, 1, pre_graph_checker, post_graph_checker));
+}
+
+TEST_F(GraphTransformationTests, PackingModeTransformerSkipsNonTokenWiseNodes) {
+  auto build_test_case = [](ModelTestBuilder& builder) { BuildPackableEncoder(builder, true); };
+
+  auto check_graph = [](Graph& graph) {
+    auto op_count = CountOpsInGraph(graph);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.Attention"] == 1);
+    TEST_RETURN_IF_NOT(op_count["com.microsoft.RemovePadding"] == 0);
+    return Status::OK();
+  };
+
+  ASSERT_STATUS_OK(TestGraphTransformer(build_test_case, 17, *logger_, std::make_unique<PackingModeTransformer>(),
+                                        TransformerLevel::Level2, 1, check_graph, check_graph));
+}
+
+#if defined(USE_CUDA) && !defined(DISABLE_CONTRIB_OPS)
+namespace {
+// Runs the encoder on the CUDA EP with and without the packing mode, and checks that the packed encoder computes the
+// outputs of the padded one for the valid tokens, and zeros for the padding tokens.
+void RunPackedEncoder() {
+  Model model("PackingModeTransformer", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 17}, {kMSDomain, 1}}, {}, DefaultLoggingManager().DefaultLogger());
+  ModelTestBuilder builder(model.MainGraph());
+  BuildPackableEncoder(builder, false);
+  builder.SetGraphOutputs();
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  const auto run = [&](bool enable_packing_mode, std::vector<OrtValue>& fetches) {
+    SessionOptions so;
+    so.graph_optimization_level = TransformerLevel::Level2;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsEnablePackingMode,
+                                                      enable_packing_mode ? "1" : "0"));
+    InferenceSessionWrapper session{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session.RegisterExecutionProvider(DefaultCudaExecutionProvider()));
+    ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+    ASSERT_STATUS_OK(session.Initialize());
+    auto op_count = CountOpsInGraph(session.GetGraph());
+    ASSERT_EQ(op_count["com.microsoft.PackedAttention"], enable_packing_mode ? 1 : 0);
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, builder.feeds_, builder.output_names_, &fetches));
+  };
+
+  std::vector<OrtValue> padded_fetches;
+  ASSERT_NO_FATAL_FAILURE(run(false, padded_fetches));
+  std::vector<OrtValue> packed_fetches;
+  ASSERT_NO_FATAL_FAILURE(run(true, packed_fetches));
+
+  // the sequence lengths of the mask of BuildPackableEncoder
+  const std::vector<int64_t> sequence_lengths{3, 4};
+  constexpr int64_t kSequenceLength = 4;
+  constexpr int64_t kHiddenSize = 8;
+  const auto& padded = padded_fetches[0].Get<Tensor>();
+  const auto& packed = packed_fetches[0].Get<Tensor>();
+  ASSERT_EQ(packed.Shape(), padded.Shape());
+  auto padded_data = padded.DataAsSpan<float>();
+  auto packed_data = packed.DataAsSpan<float>();
+  for (int64_t b = 0; b < static_cast<int64_t>(sequence_lengths.size()); b++) {
+    for (int64_t s = 0; s < kSequenceLength; s++) {
+      for (int64_t h = 0; h < kHiddenSize; h++) {
+        const size_t i = static_cast<size_t>((b * kSequenceLength + s) * kHiddenSize + h);
+        if (s < sequence_lengths[b]) {
+          ASSERT_NEAR(packed_data[i], padded_data[i], 1e-4f) << "batch " << b << " token " << s;
+        } else {
+          ASSERT_EQ(packed_data[i], 0.0f) << "batch " << b << " padding token " << s;
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+TEST_F(GraphTransformationTests, PackingModeTransformerNumerics) {
+  RunPackedEncoder();
+}
+#endif  // defined(USE_CUDA) && !defined(DISABLE_CONTRIB_OPS)
+
 }  // namespace test
 }  // namespace onnxruntime
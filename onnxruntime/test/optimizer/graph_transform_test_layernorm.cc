@@ -6,6 +6,7 @@
 #endif
 
 #include <algorithm>
+#include <fstream>
 
 #include "gtest/gtest.h"
 
@@ -14,6 +15,7 @@
 #include "core/graph/model.h"
 #include "core/optimizer/initializer.h"
 
+#include "core/optimizer/activation_smoothing.h"
 #include "core/optimizer/embed_layer_norm_fusion.h"
 #include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/skip_layer_norm_fusion.h"
@@ -974,6 +976,81 @@ TEST_F(GraphTransformationTests, EmbedLayerNormFusionMultiple_OpSet13) {
   EmbedLayerNormFusionFormatMultiple(MODEL_FOLDER "fusion/embed_layer_norm_multiple_opset13.onnx", logger_.get());
 }
 
+TEST_F(GraphTransformationTests, ActivationSmoothing) {
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 3, 4}, -2.f, 2.f);
+    auto* gamma_arg = builder.MakeInitializer<float>({4}, 0.5f, 2.f);
+    auto* beta_arg = builder.MakeInitializer<float>({4}, -0.5f, 0.5f);
+    auto* norm_out = &builder.graph_.GetOrCreateNodeArg("norm_output", nullptr);
+    builder.AddNode("LayerNormalization", {input_arg, gamma_arg, beta_arg}, {norm_out});
+
+    // the normalization feeds two MatMul nodes, e.g. an MLP's gate and up projections
+    auto* weights_0 = builder.MakeInitializer<float>({4, 5}, -1.f, 1.f);
+    auto* weights_1 = builder.MakeInitializer<float>({4, 6}, -1.f, 1.f);
+    builder.AddNode("MatMul", {norm_out, weights_0}, {builder.MakeOutput()});
+    builder.AddNode("MatMul", {norm_out, weights_1}, {builder.MakeOutput()});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    for (const Node& node : session.GetGraph().Nodes()) {
+      const auto& inputs = node.InputDefs();
+      EXPECT_NE(inputs[1]->Name().find("_smoothed"), std::string::npos) << node.OpType();
+      if (node.OpType() == "LayerNormalization") {
+        EXPECT_NE(inputs[2]->Name().find("_smoothed"), std::string::npos);
+      }
+    }
+  };
+
+  InlinedHashMap<std::string, std::vector<float>> activation_abs_max{{"norm_output", {10.f, 0.5f, 3.f, 1.f}}};
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 17,
+                    1e-4, 1e-4, std::make_unique<ActivationSmoothing>(std::move(activation_abs_max), 0.5f));
+}
+
+TEST_F(GraphTransformationTests, ActivationSmoothingSkipsOtherConsumers) {
+  // the Relu would see the smoothed activations, so the normalization is left as is
+  auto build_test_case = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 4}, -2.f, 2.f);
+    auto* gamma_arg = builder.MakeInitializer<float>({4}, 0.5f, 2.f);
+    auto* norm_out = &builder.graph_.GetOrCreateNodeArg("norm_output", nullptr);
+    builder.AddNode("LayerNormalization", {input_arg, gamma_arg}, {norm_out});
+    builder.AddNode("MatMul", {norm_out, builder.MakeInitializer<float>({4, 5}, -1.f, 1.f)}, {builder.MakeOutput()});
+    builder.AddNode("Relu", {norm_out}, {builder.MakeOutput()});
+  };
+
+  auto check_graph = [](InferenceSessionWrapper& session) {
+    for (const Node& node : session.GetGraph().Nodes()) {
+      for (const auto* input : node.InputDefs()) {
+        EXPECT_EQ(input->Name().find("_smoothed"), std::string::npos);
+      }
+    }
+  };
+
+  InlinedHashMap<std::string, std::vector<float>> activation_abs_max{{"norm_output", {10.f, 0.5f, 3.f, 1.f}}};
+  TransformerTester(build_test_case, check_graph, TransformerLevel::Level1, TransformerLevel::Level2, 17,
+                    0.0, 0.0, std::make_unique<ActivationSmoothing>(std::move(activation_abs_max), 0.5f));
+}
+
+TEST_F(GraphTransformationTests, ActivationSmoothingLoadScales) {
+  const std::string file_path = "activation_smoothing_scales.json";
+  {
+    std::ofstream file(file_path);
+    file << R"({"a": [1.0, 2.5], "b": [3]})";
+  }
+
+  InlinedHashMap<std::string, std::vector<float>> activation_abs_max;
+  ASSERT_STATUS_OK(ActivationSmoothing::LoadActivationAbsMax(file_path, activation_abs_max));
+  EXPECT_EQ(activation_abs_max.size(), 2u);
+  EXPECT_EQ(activation_abs_max["a"], (std::vector<float>{1.0f, 2.5f}));
+  EXPECT_EQ(activation_abs_max["b"], (std::vector<float>{3.0f}));
+
+  {
+    std::ofstream file(file_path);
+    file << "[1, 2]";
+  }
+  EXPECT_FALSE(ActivationSmoothing::LoadActivationAbsMax(file_path, activation_abs_max).IsOK());
+  std::remove(file_path.c_str());
+}
+
 #endif
 
 }  // namespace test
@@ -6,9 +6,14 @@
 #include "test/framework/test_utils.h"
 #include "test/capturing_sink.h"
 #include "test/test_environment.h"
+#include "test/util/include/asserts.h"
 #include "gtest/gtest.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#ifdef ENABLE_TRITON
+#include "orttraining/core/framework/triton/triton_op_executor.h"
+#endif
 
 using namespace ONNX_NAMESPACE;
 
@@ -66,5 +71,26 @@ TEST(GraphTransformerUtilsTests, TestGenerateGraphTransformers) {
   ASSERT_TRUE(filtered_transformers.size() == all_transformers.size() - 1);
 #endif
 }
+
+#if !defined(DISABLE_CONTRIB_OPS) && !defined(ORT_NO_EXCEPTIONS)
+// The Triton fusion config is rejected when the Triton fusion can't apply it.
+TEST(GraphTransformerUtilsTests, TritonFusionConfigWithoutTriton) {
+  CPUExecutionProvider cpu_ep(CPUExecutionProviderInfo{});
+  SessionOptions session_options;
+  ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(
+      kOrtSessionOptionsTritonFusionConfig, R"({"ops": {"Add": {"versions": [13, 14]}}})"));
+
+#ifdef ENABLE_TRITON
+  if (training::framework::triton::TritonOpExecutor::Instance().IsInitialized()) {
+    GTEST_SKIP() << "A Triton op executor is registered.";
+  }
+#endif
+  EXPECT_THROW(optimizer_utils::GenerateTransformers(TransformerLevel::Level2, session_options, cpu_ep),
+               OnnxRuntimeException);
+
+  // the other levels don't fuse with Triton
+  EXPECT_NO_THROW(optimizer_utils::GenerateTransformers(TransformerLevel::Level1, session_options, cpu_ep));
+}
+#endif
 }  // namespace test
 }  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include "core/mlas/inc/mlas.h"
 #include "core/session/environment.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/framework/tensorprotoutils.h"
 #include "test/compare_ortvalue.h"
 #include "test/test_environment.h"
@@ -78,6 +79,15 @@ struct NchwcTestHelper {
     return MakeInitializer<float>(shape, FillRandomData<float>(shape));
   }
 
+  // Makes weights of -1, 0 and 1, so that chains of convolutions compute exact values.
+  NodeArg* MakeSmallInitializer(const std::vector<int64_t>& shape) {
+    std::vector<float> data = FillRandomData<float>(shape);
+    for (auto& value : data) {
+      value = static_cast<float>(static_cast<int>(value) % 2);
+    }
+    return MakeInitializer<float>(shape, data);
+  }
+
   template <typename T>
   NodeArg* Make1DInitializer(const std::vector<T>& data) {
     return MakeInitializer({static_cast<int64_t>(data.size())}, data);
@@ -168,7 +178,8 @@ struct NchwcTestHelper {
 
 void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& build_test_case,
                           const std::function<void(InferenceSessionWrapper& session)>& check_nchwc_graph,
-                          int opset_version = 13) {
+                          int opset_version = 13,
+                          const std::vector<std::pair<std::string, std::string>>& session_config = {}) {
   // Ignore the test if NCHWc is not supported by the platform.
   if (MlasNchwcGetBlockSize() <= 1) {
     return;
@@ -191,6 +202,9 @@ void NchwcOptimizerTester(const std::function<void(NchwcTestHelper& helper)>& bu
     SessionOptions session_options;
     session_options.graph_optimization_level = level;
     session_options.session_logid = "NchwcOptimizerTests";
+    for (const auto& [key, value] : session_config) {
+      ASSERT_STATUS_OK(session_options.config_options.AddConfigEntry(key.c_str(), value.c_str()));
+    }
     InferenceSessionWrapper session{session_options, GetEnvironment()};
     ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
     ASSERT_STATUS_OK(session.Initialize());
@@ -1376,6 +1390,71 @@ TEST(NchwcOptimizerTests, Activation) {
   }
 }
 
+TEST(NchwcOptimizerTests, ConvChain) {
+  auto test_case = [&](int64_t batch_count) {
+    auto build_test_case = [&](NchwcTestHelper& helper) {
+      auto* input_arg = helper.MakeInput<float>({batch_count, 3, 256, 256});
+      auto* conv1_output_arg = helper.MakeIntermediate();
+      auto* relu_output_arg = helper.MakeIntermediate();
+      auto* conv2_output_arg = helper.MakeIntermediate();
+      auto* clip_output_arg = helper.MakeIntermediate();
+      auto* output_arg = helper.MakeOutput();
+
+      auto& conv1_node = helper.AddNode("Conv", {input_arg, helper.MakeSmallInitializer({16, 3, 3, 3}),
+                                                 helper.MakeInitializer({16})},
+                                        {conv1_output_arg});
+      conv1_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      conv1_node.AddAttribute("strides", std::vector<int64_t>{2, 2});
+      helper.AddNode("Relu", {conv1_output_arg}, {relu_output_arg});
+
+      auto& conv2_node = helper.AddNode("Conv", {relu_output_arg, helper.MakeSmallInitializer({16, 1, 3, 3}),
+                                                 helper.MakeInitializer({16})},
+                                        {conv2_output_arg});
+      conv2_node.AddAttribute("pads", std::vector<int64_t>{1, 1, 1, 1});
+      conv2_node.AddAttribute("group", static_cast<int64_t>(16));
+      helper.AddClipNode(conv2_output_arg, clip_output_arg, 0.0f, 6.0f);
+
+      helper.AddNode("Conv", {clip_output_arg, helper.MakeSmallInitializer({32, 16, 1, 1})}, {output_arg});
+    };
+
+    auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ConvChain"], 1);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderInput"], 0);
+      EXPECT_EQ(op_to_count["com.microsoft.nchwc.ReorderOutput"], 1);
+    };
+
+    NchwcOptimizerTester(build_test_case, check_nchwc_graph, 13,
+                         {{kOrtSessionOptionsEnableNchwcConvChainFusion, "1"}});
+  };
+
+  test_case(1);
+  test_case(3);
+}
+
+TEST(NchwcOptimizerTests, ConvChainIntermediateOutput) {
+  auto build_test_case = [&](NchwcTestHelper& helper) {
+    auto* input_arg = helper.MakeInput<float>({1, 16, 40, 40});
+    auto* conv1_output_arg = helper.MakeOutput();
+    auto* conv2_output_arg = helper.MakeIntermediate();
+    auto* output_arg = helper.MakeOutput();
+
+    // The output of the first convolution is a graph output, so only the other two are fused.
+    helper.AddNode("Conv", {input_arg, helper.MakeSmallInitializer({16, 16, 1, 1})}, {conv1_output_arg});
+    helper.AddNode("Conv", {conv1_output_arg, helper.MakeSmallInitializer({16, 16, 1, 1})}, {conv2_output_arg});
+    helper.AddNode("Conv", {conv2_output_arg, helper.MakeSmallInitializer({16, 16, 1, 1})}, {output_arg});
+  };
+
+  auto check_nchwc_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.ConvChain"], 1);
+    EXPECT_EQ(op_to_count["com.microsoft.nchwc.Conv"], 1);
+  };
+
+  NchwcOptimizerTester(build_test_case, check_nchwc_graph, 13, {{kOrtSessionOptionsEnableNchwcConvChainFusion, "1"}});
+}
+
 TEST(NchwcOptimizerTests, MaxPoolTypeCheck) {
   auto build_test_case = [&](NchwcTestHelper& helper) {
     auto add_pool_node = [&](NchwcTestHelper& helper, NodeArg* input_arg) {
@@ -344,6 +344,59 @@ TEST(QDQTransformerTests, DQ_S8_to_U8) {
 }
 #endif  // Only for X64 with contrib ops enabled
 
+// Conv and Gemm with 4-bit weights are fused into the 8-bit QLinearConv and QGemm by widening the weights
+template <typename WeightType>
+void QDQTransformerInt4WeightTests(const std::string& op_type) {
+  const bool is_conv = op_type == "Conv";
+  const std::vector<int64_t> input_shape = is_conv ? std::vector<int64_t>{1, 12, 37} : std::vector<int64_t>{7, 12};
+  const std::vector<int64_t> weight_shape = is_conv ? std::vector<int64_t>{16, 12, 5} : std::vector<int64_t>{12, 16};
+
+  auto build_test_case = [&](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>(input_shape, -1.f, 1.f);
+    auto* output_arg = builder.MakeOutput();
+
+    auto* dq_input_output = AddQDQNodePair<uint8_t>(builder, input_arg, .04f, 129);
+
+    auto* weight = builder.MakeInitializer<WeightType>(weight_shape, WeightType(WeightType::min_val, 0),
+                                                       WeightType(WeightType::max_val, 0));
+    auto* dq_w_output = builder.MakeIntermediate();
+    builder.AddDequantizeLinearNode<WeightType>(weight, .03f, WeightType(1, 0), dq_w_output);
+
+    auto* op_output = builder.MakeIntermediate();
+    builder.AddNode(op_type, {dq_input_output, dq_w_output}, {op_output});
+
+    auto* q_output = builder.MakeIntermediate();
+    builder.AddQuantizeLinearNode<uint8_t>(op_output, .039f, 129, q_output);
+    builder.AddDequantizeLinearNode<uint8_t>(q_output, .039f, 129, output_arg);
+  };
+
+  auto check_graph = [&](InferenceSessionWrapper& session) {
+    auto op_to_count = CountOpsInGraph(session.GetGraph());
+    EXPECT_EQ(op_to_count[is_conv ? "QLinearConv" : "com.microsoft.QGemm"], 1);
+    EXPECT_EQ(op_to_count[op_type], 0);
+    EXPECT_EQ(op_to_count["QuantizeLinear"], 1);
+    EXPECT_EQ(op_to_count["DequantizeLinear"], 1);
+  };
+
+  TransformerTester(build_test_case,
+                    check_graph,
+                    TransformerLevel::Level1,
+                    TransformerLevel::Level2,
+                    21 /*opset_version*/,
+                    0.01 /*per_sample_tolerance*/,
+                    0.01 /*relative_per_sample_tolerance*/);
+}
+
+TEST(QDQTransformerTests, Conv_Int4Weight) {
+  QDQTransformerInt4WeightTests<Int4x2>("Conv");
+  QDQTransformerInt4WeightTests<UInt4x2>("Conv");
+}
+
+TEST(QDQTransformerTests, Gemm_Int4Weight) {
+  QDQTransformerInt4WeightTests<Int4x2>("Gemm");
+  QDQTransformerInt4WeightTests<UInt4x2>("Gemm");
+}
+
 template <typename InputType, typename OutputType>
 void QDQTransformerAveragePoolTests() {
   auto test_case = [&](const std::vector<int64_t>& input_shape, bool use_contrib_qdq = false) {
@@ -2415,6 +2468,71 @@ TEST(QDQTransformerTests, Sigmoid_U8S8) {
   QDQTransformerSigmoidTests<uint8_t, int8_t>();
 }
 
+template <typename InputType, typename OutputType>
+void QDQTransformerGeluTests() {
+  auto test_case = [&](const std::vector<int64_t>& input_shape, bool use_contrib_qdq) {
+    auto build_test_case = [&](ModelTestBuilder& builder) {
+      auto* input_arg = builder.MakeInput<float>(input_shape, -1.f, 1.f);
+      auto* output_arg = builder.MakeOutput();
+      // add QDQ + Gelu
+      auto* dq_output = AddQDQNodePair<InputType>(builder, input_arg, .0035f, 7, use_contrib_qdq);
+      auto* gelu_output = builder.MakeIntermediate();
+      builder.AddNode("Gelu", {dq_output}, {gelu_output}, kMSDomain);
+
+      // add QDQ output
+      auto* q_output = builder.MakeIntermediate();
+      builder.AddQuantizeLinearNode<OutputType>(gelu_output,
+                                                .0038f,
+                                                std::numeric_limits<OutputType>::max() / 2,
+                                                q_output, use_contrib_qdq);
+      builder.AddDequantizeLinearNode<OutputType>(q_output,
+                                                  .0039f,
+                                                  std::numeric_limits<OutputType>::max() / 2,
+                                                  output_arg, use_contrib_qdq);
+    };
+
+    auto check_graph = [&](InferenceSessionWrapper& session) {
+      auto op_to_count = CountOpsInGraph(session.GetGraph());
+      const QDQOpKeys qdq_keys = GetQDQOpKeys(use_contrib_qdq);
+      if constexpr (std::is_same<InputType, OutputType>::value) {
+        EXPECT_EQ(op_to_count["com.microsoft.QLinearGelu"], 1);
+        EXPECT_EQ(op_to_count["com.microsoft.Gelu"], 0);
+        EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], 1);
+        EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], 1);
+      } else {
+        EXPECT_EQ(op_to_count["com.microsoft.QLinearGelu"], 0);
+        EXPECT_EQ(op_to_count["com.microsoft.Gelu"], 1);
+        EXPECT_EQ(op_to_count[qdq_keys.quantize_linear], 2);
+        EXPECT_EQ(op_to_count[qdq_keys.dequantize_linear], 2);
+      }
+    };
+
+    TransformerTester(build_test_case,
+                      check_graph,
+                      TransformerLevel::Level1,
+                      TransformerLevel::Level2,
+                      18 /*opset_version*/,
+                      0.01 /*per_sample_tolerance*/,
+                      0.01 /*relative_per_sample_tolerance*/,
+                      std::make_unique<QDQSelectorActionTransformer>(QDQIsInt8Allowed()));
+  };
+
+  test_case({1, 12, 37}, false /*use_contrib_qdq*/);
+  test_case({1, 12, 37}, true /*use_contrib_qdq*/);
+}
+
+TEST(QDQTransformerTests, Gelu_S8S8) {
+  QDQTransformerGeluTests<int8_t, int8_t>();
+}
+
+TEST(QDQTransformerTests, Gelu_U8U8) {
+  QDQTransformerGeluTests<uint8_t, uint8_t>();
+}
+
+TEST(QDQTransformerTests, Gelu_S8U8) {
+  QDQTransformerGeluTests<int8_t, uint8_t>();
+}
+
 TEST(QDQTransformerTests, ConvTranspose_QBackward) {
   auto test_case = [&](const std::vector<int64_t>& input_shape, const std::vector<int64_t>& weights_shape,
                        const std::vector<int64_t>& perms, bool use_contrib_qdq) {
@@ -4325,6 +4325,35 @@ TEST(TransposeOptimizerTests, TestOptimizeBothInputs) {
                     /*opset_version*/ {15, 18});
 }
 
+TEST(TransposeOptimizerTests, TestOptimizeTowardsTransposeBySize) {
+  auto build_test_case_1 = [&](ModelTestBuilder& builder) {
+    auto* input0_arg = builder.MakeInput<float>({20, 1, 30, 40}, 0.0, 1.0);
+    auto* input1_arg = builder.MakeInput<float>({1, 3, 20, 40}, 0.0, 1.0);
+    auto* transpose_1_out_0 = builder.MakeIntermediate();
+    auto* mul_1_out_0 = builder.MakeIntermediate();
+    auto* transpose_2_out_0 = builder.MakeOutput();
+
+    auto& transpose_1 = builder.AddNode("Transpose", {input0_arg}, {transpose_1_out_0});
+    transpose_1.AddAttribute("perm", std::vector<int64_t>{2, 1, 0, 3});
+    builder.AddNode("Mul", {transpose_1_out_0, input1_arg}, {mul_1_out_0});
+    auto& transpose_2 = builder.AddNode("Transpose", {mul_1_out_0}, {transpose_2_out_0});
+    transpose_2.AddAttribute("perm", std::vector<int64_t>{2, 1, 0, 3});
+  };
+
+  auto check_optimized_graph_1 = [&](InferenceSessionWrapper& session) {
+    int transpose_cost = EstimateTransposeCost(session.GetGraph());
+    // Both inputs of Mul have rank 3, but the transposed input is 10x larger than the input which needs a transpose
+    // after pushing, so the transposes are pushed and cancel. Cost 7 -> at most 3.
+    EXPECT_LE(transpose_cost, 3);
+  };
+
+  TransformerTester(build_test_case_1,
+                    check_optimized_graph_1,
+                    TransformerLevel::Default,
+                    TransformerLevel::Level1,
+                    /*opset_version*/ {15, 18});
+}
+
 TEST(TransposeOptimizerTests, TestOmitIdentityTranspose) {
   auto build_test_case_1 = [&](ModelTestBuilder& builder) {
     auto* input0_arg = MakeInput<float>(builder, {{-1, 4, -1, 5}}, {2, 4, 6, 5}, 0.0, 1.0);
@@ -44,6 +44,11 @@ namespace perftest {
       "\t-r [repeated_times]: Specifies the repeated times if running in 'times' test mode.Default:1000.\n"
       "\t-t [seconds_to_run]: Specifies the seconds to run for 'duration' mode. Default:600.\n"
       "\t-p [profile_file]: Specifies the profile name to enable profiling and dump the profile data to the file.\n"
+      "\t-Q [target_qps]: Run open-loop instead: requests arrive as a Poisson process at target_qps requests per second and\n"
+      "\t\tup to [parallel runs] of them run at a time. The latencies are measured from the scheduled arrivals. A comma separated\n"
+      "\t\tlist of rates runs a sweep, each rate for [seconds_to_run] or [repeated_times] requests. [Example] -Q 10,20,40\n"
+      "\t-R [load_report_file]: Writes the rates and latency percentiles of the open-loop runs to the file, as JSON if it ends\n"
+      "\t\twith '.json' and as CSV otherwise.\n"
       "\t-s: Show statistics result, like P75, P90. If no result_file provided this defaults to on.\n"
       "\t-S: Given random seed, to produce the same input data. This defaults to -1(no initialize).\n"
       "\t-v: Show verbose information.\n"
@@ -76,7 +81,8 @@ namespace perftest {
       "\t    [OpenVINO only] [device_id]: Selects a particular hardware device for inference.\n"
       "\t    [OpenVINO only] [enable_npu_fast_compile]: Optionally enabled to speeds up the model's compilation on NPU device targets.\n"
       "\t    [OpenVINO only] [num_of_threads]: Overrides the accelerator hardware type and precision with these values at runtime.\n"
-      "\t    [OpenVINO only] [cache_dir]: Explicitly specify the path to dump and load the blobs(Model caching) or cl_cache (Kernel Caching) files feature. If blob files are already present, it will be directly loaded.\n"
+      "\t    [OpenVINO only] [cache_dir]: Explicitly specify the path to dump and load the blobs(Model caching) or cl_cache (Kernel Caching) files feature. If blob files are already present, it will be directly loaded. Defaults to the ORT_OPENVINO_CACHE_DIR environment variable.\n"
+      "\t    [OpenVINO only] [performance_hint]: OpenVINO performance hint: 'LATENCY', 'THROUGHPUT' or 'CUMULATIVE_THROUGHPUT'.\n"
       "\t    [OpenVINO only] [enable_opencl_throttling]: Enables OpenCL queue throttling for GPU device(Reduces the CPU Utilization while using GPU) \n"
       "\t    [Example] [For OpenVINO EP] -e openvino -i \"device_type|CPU enable_npu_fast_compile|true num_of_threads|5 enable_opencl_throttling|true cache_dir|\"<path>\"\"\n"
       "\n"
@@ -113,6 +119,7 @@ namespace perftest {
       "\t    [TensorRT only] [trt_engine_cache_path]: Specify engine cache path.\n"
       "\t    [TensorRT only] [trt_engine_cache_prefix]: Customize engine cache prefix when trt_engine_cache_enable is true.\n"
       "\t    [TensorRT only] [trt_engine_hw_compatible]: Enable hardware compatibility. Engines ending with '_sm80+' can be re-used across all Ampere+ GPU (a hardware-compatible engine may have lower throughput and/or higher latency than its non-hardware-compatible counterpart).\n"
+      "\t    [TensorRT only] [trt_profile_growth_enable]: Round the bounds of the profiles built from the observed input shapes to powers of two, so that growing shapes rebuild the engine less often.\n"
       "\t    [TensorRT only] [trt_weight_stripped_engine_enable]: Enable weight-stripped engine build.\n"
       "\t    [TensorRT only] [trt_onnx_model_folder_path]: Folder path for the ONNX model with weights.\n"
       "\t    [TensorRT only] [trt_force_sequential_engine_build]: Force TensorRT engines to be built sequentially.\n"
@@ -204,9 +211,29 @@ static bool ParseSessionConfigs(const std::string& configs_string,
   return true;
 }
 
+static bool ParseTargetQps(const std::string& qps_string, std::vector<double>& target_qps) {
+  std::istringstream ss(qps_string);
+  std::string token;
+
+  while (std::getline(ss, token, ',')) {
+    ORT_TRY {
+      double qps = std::stod(token);
+      if (!(qps > 0)) {
+        return false;
+      }
+      target_qps.push_back(qps);
+    }
+    ORT_CATCH(...) {
+      return false;
+    }
+  }
+
+  return !target_qps.empty();
+}
+
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:AMPIDZvhsqznl"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:C:Q:R:AMPIDZvhsqznl"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -381,6 +408,14 @@ static bool ParseSessionConfigs(const std::string& configs_string,
         }
         break;
       }
+      case 'Q':
+        if (!ParseTargetQps(ToUTF8String(optarg), test_config.run_config.target_qps)) {
+          return false;
+        }
+        break;
+      case 'R':
+        test_config.run_config.load_report_file = optarg;
+        break;
       case 'D':
         test_config.run_config.disable_spinning = true;
         break;
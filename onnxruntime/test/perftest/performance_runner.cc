@@ -7,7 +7,9 @@
 #endif
 
 #include "performance_runner.h"
+#include <deque>
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "utils.h"
@@ -131,15 +133,19 @@ Status PerformanceRunner::Run() {
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (!performance_test_config_.run_config.target_qps.empty()) {
+    ORT_RETURN_IF_ERROR(OpenLoopTest());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -255,6 +261,164 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::OpenLoopTest() {
+  const auto& run_config = performance_test_config_.run_config;
+  std::mt19937 engine(run_config.random_seed_for_input_data >= 0
+                          ? static_cast<std::mt19937::result_type>(run_config.random_seed_for_input_data)
+                          : std::random_device{}());
+
+  std::vector<OpenLoopResult> results;
+  for (double target_qps : run_config.target_qps) {
+    OpenLoopResult result;
+    ORT_RETURN_IF_ERROR(RunOpenLoop(target_qps, engine, result));
+
+    const auto& latencies = result.latencies;
+    std::cout << "Target QPS: " << result.target_qps << "\n"
+              << "Achieved QPS: " << result.achieved_qps << "\n"
+              << "Completed requests: " << latencies.size() << "\n";
+    if (!latencies.empty()) {
+      std::cout << "P50 Latency: " << latencies[static_cast<size_t>(latencies.size() * 0.5)] << " s\n"
+                << "P99 Latency: " << latencies[static_cast<size_t>(latencies.size() * 0.99)] << " s\n"
+                << "P999 Latency: " << latencies[static_cast<size_t>(latencies.size() * 0.999)] << " s\n"
+                << "Max Latency: " << latencies.back() << " s\n";
+    }
+    std::cout << std::endl;
+
+    results.push_back(std::move(result));
+  }
+
+  if (!run_config.load_report_file.empty()) {
+    DumpOpenLoopResults(results);
+  }
+
+  return Status::OK();
+}
+
+Status PerformanceRunner::RunOpenLoop(double target_qps, std::mt19937& engine, OpenLoopResult& result) {
+  using Clock = std::chrono::steady_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  // Requests arrive as a Poisson process at target_qps, whether or not the previous ones completed, and up to
+  // concurrent_session_runs of them run at a time. The latency of a request is measured from its scheduled arrival,
+  // so the time it waited for a free worker is included and a slow run cannot hide the requests queued behind it.
+  std::deque<Clock::time_point> arrivals;
+  std::vector<double> latencies;
+  Clock::time_point last_completion;
+  bool done = false;
+  OrtMutex m;
+  OrtCondVar cv;
+
+  auto worker = [&]() {
+    for (;;) {
+      Clock::time_point arrival;
+      {
+        std::unique_lock<OrtMutex> lock(m);
+        cv.wait(lock, [&]() { return done || !arrivals.empty(); });
+        if (arrivals.empty()) {
+          return;
+        }
+        arrival = arrivals.front();
+        arrivals.pop_front();
+      }
+
+      auto status = RunOneIteration<false>();
+      auto completion = Clock::now();
+      if (!status.IsOK()) {
+        std::cerr << status.ErrorMessage();
+        continue;
+      }
+
+      std::lock_guard<OrtMutex> lg(m);
+      latencies.push_back(std::chrono::duration<double>(completion - arrival).count());
+      last_completion = std::max(last_completion, completion);
+    }
+  };
+
+  // dedicated threads rather than the Eigen pool, whose queues run the work inline on the scheduling thread once
+  // they are full and would hold back the arrivals
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    workers.emplace_back(worker);
+  }
+
+  std::exponential_distribution<double> inter_arrival(target_qps);
+  const bool fixed_duration = run_config.test_mode == TestMode::kFixDurationMode;
+  const auto start = Clock::now();
+  const auto end = start + std::chrono::seconds(run_config.duration_in_seconds);
+  last_completion = start;
+  auto arrival = start;
+  for (size_t sent = 0;; ++sent) {
+    arrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(inter_arrival(engine)));
+    if (fixed_duration ? arrival >= end : sent >= run_config.repeated_times) {
+      break;
+    }
+
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<OrtMutex> lg(m);
+      arrivals.push_back(arrival);
+    }
+    cv.notify_one();
+  }
+
+  // the requests queued when the arrivals stop still run
+  {
+    std::lock_guard<OrtMutex> lg(m);
+    done = true;
+  }
+  cv.notify_all();
+  for (auto& t : workers) {
+    t.join();
+  }
+
+  std::chrono::duration<double> elapsed = last_completion - start;
+  result.target_qps = target_qps;
+  result.achieved_qps = elapsed.count() > 0 ? latencies.size() / elapsed.count() : 0;
+  std::sort(latencies.begin(), latencies.end());
+  result.latencies = std::move(latencies);
+
+  return Status::OK();
+}
+
+void PerformanceRunner::DumpOpenLoopResults(const std::vector<OpenLoopResult>& results) const {
+  const auto& path = performance_test_config_.run_config.load_report_file;
+  std::ofstream outfile(path, std::ofstream::out);
+  if (!outfile.good()) {
+    std::cerr << "failed to open load report file '" << ToUTF8String(path.c_str()) << "'.\n";
+    return;
+  }
+
+  auto percentile = [](const std::vector<double>& latencies, double p) {
+    return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(latencies.size() * p)];
+  };
+
+  // one record per arrival rate, as JSON if the file name says so and as CSV otherwise
+  if (HasExtensionOf(path, ORT_TSTR("json"))) {
+    outfile << "[\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+      const auto& result = results[i];
+      outfile << "  {\"model_name\": \"" << performance_result_.model_name << "\""
+              << ", \"target_qps\": " << result.target_qps
+              << ", \"achieved_qps\": " << result.achieved_qps
+              << ", \"requests\": " << result.latencies.size()
+              << ", \"p50_latency_s\": " << percentile(result.latencies, 0.5)
+              << ", \"p99_latency_s\": " << percentile(result.latencies, 0.99)
+              << ", \"p999_latency_s\": " << percentile(result.latencies, 0.999)
+              << ", \"max_latency_s\": " << (result.latencies.empty() ? 0.0 : result.latencies.back())
+              << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    outfile << "]" << std::endl;
+  } else {
+    outfile << "model_name,target_qps,achieved_qps,requests,p50_latency_s,p99_latency_s,p999_latency_s,max_latency_s\n";
+    for (const auto& result : results) {
+      outfile << performance_result_.model_name << "," << result.target_qps << "," << result.achieved_qps << ","
+              << result.latencies.size() << "," << percentile(result.latencies, 0.5) << ","
+              << percentile(result.latencies, 0.99) << "," << percentile(result.latencies, 0.999) << ","
+              << (result.latencies.empty() ? 0.0 : result.latencies.back()) << std::endl;
+    }
+  }
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   const auto& file_path = performance_test_config_.model_info.model_file_path;
 #if !defined(ORT_MINIMAL_BUILD)
@@ -39,6 +39,14 @@ struct PerformanceResult {
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
 };
 
+// Result of an open-loop run at one arrival rate.
+struct OpenLoopResult {
+  double target_qps{0};
+  double achieved_qps{0};
+  // seconds from the scheduled arrival of each request to its completion, sorted
+  std::vector<double> latencies;
+};
+
 class PerformanceRunner {
  public:
   PerformanceRunner(Ort::Env& env, const PerformanceTestConfig& test_config, std::random_device& rd);
@@ -90,6 +98,9 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status OpenLoopTest();
+  Status RunOpenLoop(double target_qps, std::mt19937& engine, OpenLoopResult& result);
+  void DumpOpenLoopResults(const std::vector<OpenLoopResult>& results) const;
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
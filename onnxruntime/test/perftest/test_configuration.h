@@ -7,6 +7,7 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/graph/constants.h"
 #include "core/framework/session_options.h"
@@ -65,6 +66,9 @@ struct RunConfig {
   bool disable_spinning = false;
   bool disable_spinning_between_run = false;
   bool exit_after_session_creation = false;
+  // Arrival rates of the open-loop runs, one run per rate. Empty for the closed-loop runs.
+  std::vector<double> target_qps;
+  std::basic_string<ORTCHAR_T> load_report_file;
 };
 
 struct PerformanceTestConfig {
@@ -152,6 +152,48 @@ TEST(FileIoTest, MapFileIntoMemory) {
     ASSERT_FALSE(Env::Default().MapFileIntoMemory(tmp.path.c_str(), -1, 0, mapped_memory).IsOK());
   }
 }
+
+TEST(FileIoTest, MapFileIntoMemoryIsShared) {
+  static const auto page_size = sysconf(_SC_PAGESIZE);
+  ASSERT_GT(page_size, 0);
+
+  TempFilePath tmp(ORT_TSTR("map_file_test_"));
+  const auto initial_data = GenerateData(page_size * 2);
+  WriteDataToFile(gsl::make_span(initial_data), tmp.path);
+
+  Env::MappedMemoryPtr mapped_memory{};
+  ASSERT_TRUE(Env::Default().MapFileIntoMemory(tmp.path.c_str(), 0, initial_data.size(), mapped_memory).IsOK());
+  auto mapped_span = gsl::make_span(mapped_memory.get(), initial_data.size());
+  ASSERT_TRUE(SpanEq(mapped_span, gsl::make_span(initial_data)));
+
+  // the mapping is backed by the page cache, so updates to the file are visible through it
+  const auto updated_data = GenerateData(page_size * 2, 1);
+  {
+    std::fstream file{tmp.path, std::ios::binary | std::ios::in | std::ios::out};
+    file.write(updated_data.data(), updated_data.size());
+    ASSERT_TRUE(file.good());
+  }
+  ASSERT_TRUE(SpanEq(mapped_span, gsl::make_span(updated_data)));
+}
+
+TEST(FileIoTest, PrefetchFile) {
+  TempFilePath tmp(ORT_TSTR("prefetch_test_"));
+  const auto expected_data = GenerateData(4096);
+  WriteDataToFile(gsl::make_span(expected_data), tmp.path);
+
+  ASSERT_TRUE(Env::Default().PrefetchFile(tmp.path.c_str(), 0, expected_data.size()).IsOK());
+  ASSERT_TRUE(Env::Default().PrefetchFile(tmp.path.c_str(), 100, 0).IsOK());
+
+  // prefetching does not change what is read
+  std::vector<char> buffer(expected_data.size());
+  ASSERT_TRUE(Env::Default().ReadFileIntoBuffer(tmp.path.c_str(), 0, buffer.size(), gsl::make_span(buffer)).IsOK());
+  ASSERT_TRUE(SpanEq(gsl::make_span(buffer), gsl::make_span(expected_data)));
+
+  // invalid - negative offset
+  ASSERT_FALSE(Env::Default().PrefetchFile(tmp.path.c_str(), -1, 1).IsOK());
+  // invalid - missing file
+  ASSERT_FALSE(Env::Default().PrefetchFile(ORT_TSTR("prefetch_test_missing_file"), 0, 1).IsOK());
+}
 #else
 TEST(FileIoTest, MapFileIntoMemory) {
   SYSTEM_INFO sysinfo;
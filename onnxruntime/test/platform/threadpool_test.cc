@@ -12,8 +12,11 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <functional>
+#include <optional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -85,6 +88,26 @@ void TestBatchParallelFor(const std::string& name, int num_threads, int num_task
   ValidateTestData(*test_data);
 }
 
+// Run a loop with TryParallelForAdaptive.  If skewed is set then the first iterations are made
+// much more expensive than the rest, so that the thread starting with them needs help from others.
+void TestParallelForAdaptive(const std::string& name, int num_threads, int num_tasks, bool skewed = false) {
+  auto test_data = CreateTestData(num_tasks);
+  CreateThreadPoolAndTest(name, num_threads, [&](ThreadPool* tp) {
+    ThreadPool::TryParallelForAdaptive(tp, num_tasks, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      ASSERT_LE(0, first);
+      ASSERT_LT(first, last);
+      ASSERT_LE(last, num_tasks);
+      for (std::ptrdiff_t i = first; i < last; i++) {
+        if (skewed && i < num_tasks / 8) {
+          std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        IncrementElement(*test_data, i);
+      }
+    });
+  });
+  ValidateTestData(*test_data);
+}
+
 void TestConcurrentParallelFor(const std::string& name, int num_threads, int num_concurrent, int num_tasks, int dynamic_block_base = 0, bool mock_hybrid = false) {
   // Test running multiple concurrent loops over the same thread pool.  This aims to provoke a
   // more diverse mix of interleavings than with a single loop running at a time.
@@ -276,6 +299,207 @@ TEST(ThreadPoolTest, TestBatchParallelFor_2_Thread_81_Task_20_Batch) {
   TestBatchParallelFor("TestBatchParallelFor_2_Thread_81_Task_20_Batch", 2, 81, 20);
 }
 
+TEST(ThreadPoolTest, TestParallelForAdaptive_0_Thread_NoTask) {
+  TestParallelForAdaptive("TestParallelForAdaptive_0_Thread_NoTask", 0, 0);
+}
+
+TEST(ThreadPoolTest, TestParallelForAdaptive_0_Thread_50_Task) {
+  TestParallelForAdaptive("TestParallelForAdaptive_0_Thread_50_Task", 0, 50);
+}
+
+TEST(ThreadPoolTest, TestParallelForAdaptive_4_Thread_NoTask) {
+  TestParallelForAdaptive("TestParallelForAdaptive_4_Thread_NoTask", 4, 0);
+}
+
+TEST(ThreadPoolTest, TestParallelForAdaptive_4_Thread_1_Task) {
+  TestParallelForAdaptive("TestParallelForAdaptive_4_Thread_1_Task", 4, 1);
+}
+
+TEST(ThreadPoolTest, TestParallelForAdaptive_4_Thread_3_Task) {
+  TestParallelForAdaptive("TestParallelForAdaptive_4_Thread_3_Task", 4, 3);
+}
+
+TEST(ThreadPoolTest, TestParallelForAdaptive_4_Thread_1M_Task) {
+  TestParallelForAdaptive("TestParallelForAdaptive_4_Thread_1M_Task", 4, 1000000);
+}
+
+TEST(ThreadPoolTest, TestParallelForAdaptive_4_Thread_1K_Task_Skewed) {
+  TestParallelForAdaptive("TestParallelForAdaptive_4_Thread_1K_Task_Skewed", 4, 1000, true);
+}
+
+TEST(ThreadPoolTest, TestParallelForAdaptive_MultiLoopSection) {
+  constexpr int num_tasks = 1024;
+  constexpr int num_loops = 10;
+  auto test_data = CreateTestData(num_tasks);
+  CreateThreadPoolAndTest("TestParallelForAdaptive_MultiLoopSection", 4, [&](ThreadPool* tp) {
+    ThreadPool::ParallelSection ps(tp);
+    for (int l = 0; l < num_loops; l++) {
+      ThreadPool::TryParallelForAdaptive(tp, num_tasks, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) {
+          IncrementElement(*test_data, i);
+        }
+      });
+    }
+  });
+  ValidateTestData(*test_data, num_loops);
+}
+
+TEST(ThreadPoolTest, TestSharedPool) {
+  auto shared_tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  ThreadPool tp1(shared_tp.get(), ThreadPoolShareOptions{});
+  ThreadPool tp2(&tp1, ThreadPoolShareOptions{2, 0});
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&tp1), ThreadPool::DegreeOfParallelism(shared_tp.get()));
+
+  constexpr int num_tasks = 1000;
+  constexpr int num_loops = 10;
+  auto test_data1 = CreateTestData(num_tasks);
+  auto test_data2 = CreateTestData(num_tasks);
+  // Run loops on both pools concurrently, so that they compete for the shared threads.
+  std::thread other([&]() {
+    for (int l = 0; l < num_loops; l++) {
+      ThreadPool::TryParallelFor(&tp2, num_tasks, 1000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) {
+          IncrementElement(*test_data2, i);
+        }
+      });
+    }
+  });
+  for (int l = 0; l < num_loops; l++) {
+    ThreadPool::TrySimpleParallelFor(&tp1, num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data1, i); });
+  }
+  other.join();
+  ValidateTestData(*test_data1, num_loops);
+  ValidateTestData(*test_data2, num_loops);
+
+  auto stats = tp1.GetShareStats();
+  ASSERT_EQ(stats.num_loops, static_cast<uint64_t>(num_loops));
+  ASSERT_LE(stats.max_queueing_delay_ns, stats.total_queueing_delay_ns);
+  ASSERT_EQ(shared_tp->GetShareStats().num_loops, 0u);
+}
+
+TEST(ThreadPoolTest, TestSharedPoolMaxDegreeOfParallelism) {
+  auto shared_tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  ThreadPool tp(shared_tp.get(), ThreadPoolShareOptions{1, 2});
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(&tp) * 2, ThreadPool::DegreeOfParallelism(shared_tp.get()));
+
+  constexpr int num_tasks = 50;
+  auto test_data = CreateTestData(num_tasks);
+  ThreadPool::TrySimpleParallelFor(&tp, num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
+TEST(ThreadPoolTest, TestRunPriority) {
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  ThreadPool shared_tp(tp.get(), ThreadPoolShareOptions{});
+
+  constexpr int num_tasks = 1000;
+  auto test_data = CreateTestData(num_tasks);
+  std::atomic<int> num_helped{0};
+  std::atomic<bool> loop_done{false};
+  std::atomic<bool> yielded{false};
+  // The runs are registered on the pool owning the threads, hence a run on the sharing pool competes with them.
+  std::optional<ThreadPool::RunPriorityScope> high_priority_run;
+  high_priority_run.emplace(tp.get(), 1);
+  std::thread low_priority([&]() {
+    ThreadPool::RunPriorityScope run(&shared_tp, -1);
+    const auto caller = std::this_thread::get_id();
+    ThreadPool::TrySimpleParallelFor(&shared_tp, num_tasks, [&](std::ptrdiff_t i) {
+      if (std::this_thread::get_id() != caller) {
+        ++num_helped;
+      }
+      IncrementElement(*test_data, i);
+    });
+    loop_done = true;
+    ThreadPool::YieldToHigherPriorityRuns();
+    yielded = true;
+  });
+
+  while (!loop_done) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_FALSE(yielded);
+  high_priority_run.reset();
+  low_priority.join();
+  ASSERT_TRUE(yielded);
+  ASSERT_EQ(num_helped, 0);
+  ValidateTestData(*test_data);
+
+  // Without a higher priority run, yielding returns right away.
+  ThreadPool::RunPriorityScope run(tp.get(), 0);
+  ThreadPool::YieldToHigherPriorityRuns();
+}
+
+TEST(ThreadPoolTest, TestStats) {
+  ThreadPoolStats no_pool_stats = ThreadPool::GetStats(nullptr);
+  ASSERT_EQ(no_pool_stats.num_threads, 0u);
+  ASSERT_EQ(no_pool_stats.num_tasks, 0u);
+
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions{}, nullptr, 4, true);
+  ThreadPool shared_tp(tp.get(), ThreadPoolShareOptions{});
+  ASSERT_EQ(ThreadPool::GetStats(tp.get()).num_threads, 3u);
+
+  constexpr int num_tasks = 100;
+  onnxruntime::Barrier barrier(num_tasks);
+  for (int i = 0; i < num_tasks; i++) {
+    ThreadPool::Schedule(tp.get(), [&barrier]() { barrier.Notify(); });
+  }
+  barrier.Wait();
+
+  // The workers count a task once it returned, which may be after the barrier released this thread.
+  ThreadPoolStats stats;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  do {
+    stats = ThreadPool::GetStats(tp.get());
+  } while (stats.num_tasks < num_tasks && std::chrono::steady_clock::now() < deadline);
+  ASSERT_EQ(stats.num_tasks, static_cast<uint64_t>(num_tasks));
+  ASSERT_EQ(stats.queue_depth, 0u);
+  ASSERT_LE(stats.num_steals, stats.num_tasks);
+  ASSERT_EQ(ThreadPool::GetStats(&shared_tp).num_tasks, stats.num_tasks);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveSpinPolicy) {
+  AdaptiveSpinPolicy policy;
+  ASSERT_GT(policy.SpinBudgetNs(), 0u);
+
+  // Long waits back off to blocking right away.
+  for (int i = 0; i < 100; i++) {
+    policy.RecordWait(100 * AdaptiveSpinPolicy::kMaxSpinNs);
+  }
+  ASSERT_EQ(policy.SpinBudgetNs(), 0u);
+  ASSERT_LE(policy.AverageWaitNs(), AdaptiveSpinPolicy::kMaxWaitSampleNs);
+
+  // Short waits restore spinning within a bounded number of waits, and the budget covers the wait.
+  constexpr uint64_t wait_ns = 50 * 1000;
+  for (int i = 0; i < 100; i++) {
+    policy.RecordWait(wait_ns);
+  }
+  ASSERT_GE(policy.SpinBudgetNs(), wait_ns);
+  ASSERT_LE(policy.SpinBudgetNs(), AdaptiveSpinPolicy::kMaxSpinNs);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveSpinning) {
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.adaptive_spinning = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, 4, true);
+
+  // Parallel sections with gaps longer than the maximum spin, so that the workers learn to block.
+  constexpr int num_sections = 20;
+  for (int section = 0; section < num_sections; section++) {
+    auto test_data = CreateTestData(1000);
+    ThreadPool::TryParallelFor(tp.get(), 1000, 1000.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; i++) {
+        IncrementElement(*test_data, i);
+      }
+    });
+    ValidateTestData(*test_data);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  ThreadPoolStats stats = ThreadPool::GetStats(tp.get());
+  ASSERT_GT(stats.num_blocked_wakeups, 0u);
+}
+
 TEST(ThreadPoolTest, TestConcurrentParallelFor_0Thread_1Conc_0Tasks) {
   TestConcurrentParallelFor("TestConcurrentParallelFor_0Thread_1Conc_0Tasks", 0, 1, 0);
 }
@@ -613,6 +837,44 @@ TEST(ThreadPoolTest, TestAffinityStringWellShaped) {
   }
 }
 
+TEST(ThreadPoolTest, TestNumaNodeAffinity) {
+  auto numa_nodes = onnxruntime::Env::Default().GetNumaNodeProcessors();
+  if (numa_nodes.empty() || numa_nodes[0].empty()) {
+    GTEST_SKIP() << "NUMA topology is not available";
+  }
+  OrtThreadPoolParams tp_params;
+  tp_params.numa_node = 0;
+  tp_params.thread_pool_size = 3;
+  auto tp = concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                          tp_params,
+                                          concurrency::ThreadPoolType::INTRA_OP);
+  ASSERT_TRUE(tp != nullptr);
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()) % 3, 0);  // for hybrid cpu, dop is a multiple of 3
+
+  auto test_data = CreateTestData(50);
+  ThreadPool::TrySimpleParallelFor(tp.get(), 50, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
+#ifndef ORT_NO_EXCEPTIONS
+TEST(ThreadPoolTest, TestNumaNodeMisconfigured) {
+  OrtThreadPoolParams tp_params;
+  tp_params.numa_node = static_cast<int>(onnxruntime::Env::Default().GetNumaNodeProcessors().size());
+  ASSERT_THROW(concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                             tp_params,
+                                             concurrency::ThreadPoolType::INTRA_OP),
+               std::exception);
+
+  tp_params.numa_node = 0;
+  tp_params.thread_pool_size = 2;
+  tp_params.affinity_str = "1";
+  ASSERT_THROW(concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                             tp_params,
+                                             concurrency::ThreadPoolType::INTRA_OP),
+               std::exception);
+}
+#endif
+
 #ifdef _WIN32
 TEST(ThreadPoolTest, TestDefaultAffinity) {
   test::CpuGroup cpu_group = {{0, 1},
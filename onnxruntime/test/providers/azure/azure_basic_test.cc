@@ -1,8 +1,16 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "core/graph/model.h"
 #include "core/session/onnxruntime_cxx_api.h"
 #include "core/session/inference_session.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
 #include "test/util/include/inference_session_wrapper.h"
 #include "test/util/include/test_allocator.h"
 #include "gtest/gtest.h"
@@ -23,5 +31,69 @@ TEST(AzureEP, TestSessionCreation) {
   EXPECT_NO_THROW((Ort::Session{*ort_env, ort_model_path, so}));
 }
 
+namespace {
+// Y = X + X, X being a float tensor of shape (N, 2).
+std::string CreateAddModel() {
+  onnxruntime::Model model("add", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 13}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add", "Add", "Y = X + X", {&x, &x}, {&y});
+  EXPECT_STATUS_OK(graph.Resolve());
+  std::string model_data;
+  EXPECT_TRUE(model.ToProto().SerializeToString(&model_data));
+  return model_data;
+}
+}  // namespace
+
+TEST(AzureEP, BatchesConcurrentRuns) {
+  const std::string model_data = CreateAddModel();
+  Ort::SessionOptions so;
+  onnxruntime::ProviderOptions options{{"batching_window_us", "10000000"}, {"max_batch_size", "2"}};
+  so.AppendExecutionProvider("AZURE", options);
+  Ort::Session session{*ort_env, model_data.data(), model_data.size(), so};
+
+  // With a window of 10 s, the Run() calls only return early when they are merged into one full batch.
+  const auto start = std::chrono::steady_clock::now();
+  std::atomic<int> num_failures{0};
+  std::vector<std::thread> threads;
+  for (int r = 0; r < 2; ++r) {
+    threads.emplace_back([&, r]() {
+      std::array<float, 2> x{static_cast<float>(r), static_cast<float>(r) + 0.5f};
+      const std::array<int64_t, 2> shape{1, 2};
+      auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+      auto input = Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), shape.data(), shape.size());
+      const char* input_names[] = {"X"};
+      const char* output_names[] = {"Y"};
+      auto outputs = session.Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+      const float* y = outputs[0].GetTensorData<float>();
+      if (outputs[0].GetTensorTypeAndShapeInfo().GetShape() != std::vector<int64_t>{1, 2} ||
+          y[0] != 2 * x[0] || y[1] != 2 * x[1]) {
+        ++num_failures;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_failures, 0);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+}
+
+TEST(AzureEP, InvalidBatchingOptions) {
+  const std::string model_data = CreateAddModel();
+  for (const char* window : {"-1", "10ms"}) {
+    Ort::SessionOptions so;
+    onnxruntime::ProviderOptions options{{"batching_window_us", window}};
+    so.AppendExecutionProvider("AZURE", options);
+    EXPECT_THROW((Ort::Session{*ort_env, model_data.data(), model_data.size(), so}), Ort::Exception) << window;
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include <future>
+#include <sstream>
 #include <thread>
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -13,6 +14,8 @@
 #include "test/providers/provider_test_utils.h"
 #include "test/util/include/default_providers.h"
 #include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
 
 using namespace ONNX_NAMESPACE;
 
@@ -1327,5 +1330,139 @@ TEST(Loop, OptionalTypeAsLoopCarriedDependency) {
 
 #endif
 
+// Creates a model with a Loop whose loop carried variable is loop_var_0 + one, or one if forward_outer_scope_value,
+// which the Identity may alias.
+static std::string CreateLoopCarriedVarModel(bool forward_outer_scope_value) {
+  TypeProto int64_scalar;
+  int64_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  int64_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto bool_scalar;
+  bool_scalar.mutable_tensor_type()->set_elem_type(TensorProto_DataType_BOOL);
+  bool_scalar.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  GraphProto body;
+  {
+    Model model("Loop carried var subgraph", false, DefaultLoggingManager().DefaultLogger());
+    auto& graph = model.MainGraph();
+    auto& iter_num_in = graph.GetOrCreateNodeArg("iter_num_in", &int64_scalar);
+    auto& cond_in = graph.GetOrCreateNodeArg("cond_in", &bool_scalar);
+    auto& loop_var_0_in = graph.GetOrCreateNodeArg("loop_var_0_in", &float_tensor);
+    auto& one = graph.GetOrCreateNodeArg("one", &float_tensor);
+    graph.AddOuterScopeNodeArg("one");
+    auto& cond_out = graph.GetOrCreateNodeArg("cond_out", &bool_scalar);
+    auto& loop_var_0_out = graph.GetOrCreateNodeArg("loop_var_0_out", &float_tensor);
+
+    graph.AddNode("cond_in_identity", "Identity", "Forward cond_in to cond_out", {&cond_in}, {&cond_out});
+    if (forward_outer_scope_value) {
+      graph.AddNode("loop_var_out", "Identity", "Forward one to loop_var_0_out", {&one}, {&loop_var_0_out});
+    } else {
+      graph.AddNode("loop_var_out", "Add", "Add one to loop_var_0_in", {&loop_var_0_in, &one}, {&loop_var_0_out});
+    }
+
+    graph.SetInputs({&iter_num_in, &cond_in, &loop_var_0_in});
+    graph.SetOutputs({&cond_out, &loop_var_0_out});
+    EXPECT_STATUS_OK(graph.Resolve());
+    body = graph.ToGraphProto();
+  }
+
+  Model model("Loop carried var", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+              {{kOnnxDomain, 11}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+  auto& max_trip_count = graph.GetOrCreateNodeArg("M", &int64_scalar);
+  auto& cond = graph.GetOrCreateNodeArg("cond", &bool_scalar);
+  auto& loop_var_0 = graph.GetOrCreateNodeArg("loop_var_0", &float_tensor);
+  auto& one = graph.GetOrCreateNodeArg("one", &float_tensor);
+  auto& loop_var_0_final = graph.GetOrCreateNodeArg("loop_var_0_final", &float_tensor);
+  auto& loop = graph.AddNode("loop", "Loop", "Loop", {&max_trip_count, &cond, &loop_var_0}, {&loop_var_0_final});
+  loop.AddAttribute("body", body);
+  graph.SetInputs({&max_trip_count, &cond, &loop_var_0, &one});
+  graph.SetOutputs({&loop_var_0_final});
+  EXPECT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  EXPECT_TRUE(model.ToProto().SerializeToString(&model_data));
+  return model_data;
+}
+
+// Runs the model of CreateLoopCarriedVarModel for max_trip_count iterations from loop_var_0 = {1, 2}, with one = {1, 1}.
+static Status RunLoopCarriedVarModel(bool forward_outer_scope_value, int64_t max_trip_count,
+                                     std::vector<OrtValue>& feeds, std::vector<OrtValue>& fetches) {
+  SessionOptions so;
+  so.session_logid = "LoopCarriedVar";
+  InferenceSession session(so, GetEnvironment());
+  std::stringstream model_stream(CreateLoopCarriedVarModel(forward_outer_scope_value));
+  ORT_RETURN_IF_ERROR(session.Load(model_stream));
+  ORT_RETURN_IF_ERROR(session.Initialize());
+
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  feeds.resize(4);
+  CreateMLValue<int64_t>(allocator, {1}, {max_trip_count}, &feeds[0]);
+  CreateMLValue<bool>(allocator, {1}, {true}, &feeds[1]);
+  CreateMLValue<float>(allocator, {2}, {1.f, 2.f}, &feeds[2]);
+  CreateMLValue<float>(allocator, {2}, {1.f, 1.f}, &feeds[3]);
+  return session.Run(onnxruntime::RunOptions{}, {"M", "cond", "loop_var_0", "one"}, feeds, {"loop_var_0_final"},
+                     &fetches);
+}
+
+static std::vector<float> TensorValues(const OrtValue& value) {
+  auto data = value.Get<Tensor>().DataAsSpan<float>();
+  return std::vector<float>(data.begin(), data.end());
+}
+
+// The Loop output takes over the final value the subgraph allocated, and copies the values which others hold
+TEST(Loop, LoopCarriedVarOutputSharesFinalValue) {
+  {
+    std::vector<OrtValue> feeds, fetches;
+    ASSERT_STATUS_OK(RunLoopCarriedVarModel(false, 3, feeds, fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(TensorValues(fetches[0]), (std::vector<float>{4.f, 5.f}));
+  }
+
+  // the final value is the initial Loop input, an input of the session
+  {
+    std::vector<OrtValue> feeds, fetches;
+    ASSERT_STATUS_OK(RunLoopCarriedVarModel(false, 0, feeds, fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(TensorValues(fetches[0]), (std::vector<float>{1.f, 2.f}));
+    EXPECT_NE(fetches[0].Get<Tensor>().DataRaw(), feeds[2].Get<Tensor>().DataRaw());
+  }
+
+  // the final value may be the outer scope value forwarded by the Identity
+  {
+    std::vector<OrtValue> feeds, fetches;
+    ASSERT_STATUS_OK(RunLoopCarriedVarModel(true, 3, feeds, fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(TensorValues(fetches[0]), (std::vector<float>{1.f, 1.f}));
+    EXPECT_NE(fetches[0].Get<Tensor>().DataRaw(), feeds[3].Get<Tensor>().DataRaw());
+  }
+}
+
+// A Loop output preallocated by the user gets a copy of the final value, which must have the shape of the output
+TEST(Loop, LoopCarriedVarCopiedToPreallocatedOutput) {
+  auto allocator = TestCPUExecutionProvider()->CreatePreferredAllocators()[0];
+  {
+    std::vector<OrtValue> feeds, fetches(1);
+    CreateMLValue<float>(allocator, {2}, {0.f, 0.f}, &fetches[0]);
+    const void* output_buffer = fetches[0].Get<Tensor>().DataRaw();
+    ASSERT_STATUS_OK(RunLoopCarriedVarModel(false, 3, feeds, fetches));
+    ASSERT_EQ(fetches.size(), 1u);
+    EXPECT_EQ(fetches[0].Get<Tensor>().DataRaw(), output_buffer);
+    EXPECT_EQ(TensorValues(fetches[0]), (std::vector<float>{4.f, 5.f}));
+  }
+
+  // same byte size, different shape
+  {
+    std::vector<OrtValue> feeds, fetches(1);
+    CreateMLValue<float>(allocator, {1, 2}, {0.f, 0.f}, &fetches[0]);
+    ASSERT_FALSE(RunLoopCarriedVarModel(false, 3, feeds, fetches).IsOK());
+    EXPECT_EQ(TensorValues(fetches[0]), (std::vector<float>{0.f, 0.f}));
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
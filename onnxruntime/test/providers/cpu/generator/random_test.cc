@@ -2,14 +2,72 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/framework/random_generator.h"
 #include "test/providers/provider_test_utils.h"
 
 #include <algorithm>
-#include <random>
+#include <cmath>
+#include <functional>
+#include <type_traits>
+#include <vector>
 using namespace ONNX_NAMESPACE;
 namespace onnxruntime {
 namespace test {
 
+template <typename T>
+static T PhiloxToUniform(const uint32_t* bits) {
+  if constexpr (std::is_same_v<T, float>) {
+    return PhiloxEngine::ToUniformFloat(bits[0]);
+  } else {
+    return PhiloxEngine::ToUniformDouble(bits[0], bits[1]);
+  }
+}
+
+// Reference of the CPU kernels: the values of the output come from the blocks of the Philox stream of the seed,
+// four float values or two double values per block.
+template <typename T>
+static std::vector<T> GeneratePhiloxData(float seed, int64_t size, const std::function<void(const T*, T*)>& transform) {
+  constexpr int64_t values_per_block = static_cast<int64_t>(sizeof(PhiloxEngine::Block) / sizeof(T));
+  constexpr int64_t bits_per_value = static_cast<int64_t>(sizeof(T) / sizeof(uint32_t));
+  std::vector<T> output(size);
+  for (int64_t i = 0; i < size; i += values_per_block) {
+    const auto block = PhiloxEngine::ComputeBlock({static_cast<uint32_t>(i / values_per_block), 0, 0, 0},
+                                                  static_cast<uint64_t>(seed));
+    T uniform[values_per_block];
+    T values[values_per_block];
+    for (int64_t j = 0; j < values_per_block; ++j) {
+      uniform[j] = PhiloxToUniform<T>(block.data() + j * bits_per_value);
+    }
+    transform(uniform, values);
+    std::copy(values, values + std::min(values_per_block, size - i), output.begin() + i);
+  }
+  return output;
+}
+
+template <typename T>
+static std::vector<T> GeneratePhiloxUniform(float seed, int64_t size, float low, float high) {
+  return GeneratePhiloxData<T>(seed, size, [low, high](const T* uniform, T* values) {
+    constexpr size_t values_per_block = sizeof(PhiloxEngine::Block) / sizeof(T);
+    for (size_t j = 0; j < values_per_block; ++j) {
+      values[j] = static_cast<T>(low) + (static_cast<T>(high) - static_cast<T>(low)) * uniform[j];
+    }
+  });
+}
+
+template <typename T>
+static std::vector<T> GeneratePhiloxNormal(float seed, int64_t size, float mean, float scale) {
+  return GeneratePhiloxData<T>(seed, size, [mean, scale](const T* uniform, T* values) {
+    constexpr size_t values_per_block = sizeof(PhiloxEngine::Block) / sizeof(T);
+    constexpr T two_pi = static_cast<T>(6.283185307179586476925286766559);
+    for (size_t j = 0; j < values_per_block; j += 2) {
+      // Box-Muller
+      const T radius = static_cast<T>(scale) * std::sqrt(T{-2} * std::log(T{1} - uniform[j]));
+      values[j] = static_cast<T>(mean) + radius * std::cos(two_pi * uniform[j + 1]);
+      values[j + 1] = static_cast<T>(mean) + radius * std::sin(two_pi * uniform[j + 1]);
+    }
+  });
+}
+
 TEST(Random, RandomNormal2DDouble) {
   OpTester test("RandomNormal");
 
@@ -25,16 +83,11 @@ TEST(Random, RandomNormal2DDouble) {
   test.AddAttribute<int64_t>("dtype", TensorProto::DOUBLE);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<double> distribution{mean, scale};
-
-  std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  std::vector<double> expected_output = GeneratePhiloxNormal<double>(seed, TensorShape(dims).Size(), mean, scale);
 
   test.AddOutput<double>("Y", dims, expected_output);
 
-  // The expected_output is generated using std lib, which is used by CPU kernel only.
+  // The expected_output is generated using the Philox stream of the CPU kernel only.
   // So we need to exclude other EPs here. Ditto for other places.
   test.Run(OpTester::ExpectResult::kExpectSuccess, "",
            {kCudaExecutionProvider, kCudaNHWCExecutionProvider, kRocmExecutionProvider});
@@ -63,12 +116,7 @@ void RunRandomNormalLike3DFloat(bool infer_dtype = false) {
                         0.f, 0.f, 0.f,
                         0.f, 0.f, 0.f});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::normal_distribution<float> distribution{mean, scale};
-
-  std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  std::vector<float> expected_output = GeneratePhiloxNormal<float>(seed, TensorShape(dims).Size(), mean, scale);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -101,12 +149,7 @@ TEST(Random, RandomUniform1DFloat) {
   test.AddAttribute<int64_t>("dtype", TensorProto::FLOAT);
   test.AddAttribute("shape", dims);
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<float> distribution{low, high};
-
-  std::vector<float> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](float& value) { value = distribution(generator); });
+  std::vector<float> expected_output = GeneratePhiloxUniform<float>(seed, TensorShape(dims).Size(), low, high);
 
   test.AddOutput<float>("Y", dims, expected_output);
 
@@ -135,12 +178,7 @@ void RunRandomUniformLikeTest(bool infer_dtype = false) {
                         {0., 0., 0., 0., 0., 0.,
                          0., 0., 0., 0., 0., 0.});
 
-  std::default_random_engine generator{gsl::narrow_cast<uint32_t>(seed)};
-  std::uniform_real_distribution<double> distribution{low, high};
-
-  std::vector<double> expected_output(TensorShape(dims).Size());
-  std::for_each(expected_output.begin(), expected_output.end(),
-                [&generator, &distribution](double& value) { value = distribution(generator); });
+  std::vector<double> expected_output = GeneratePhiloxUniform<double>(seed, TensorShape(dims).Size(), low, high);
 
   test.AddOutput<double>("Y", dims, expected_output);
 
@@ -231,10 +269,9 @@ TEST(Random, InvalidDType) {
 }
 
 /*
-Note: There are no reference tests that can be reused in this case. I tried to use the tensorflow
-test cases but they use a different RNG (Philox) and hence the test results differ. Since the implementation
-of the op is same as tensorflow, for now I've just relied on the output generated by this code as ground truth
-for verification.
+Note: There are no reference tests that can be reused in this case. The tensorflow test cases use a different
+stream of the Philox RNG and hence the test results differ. Since the implementation of the op is same as
+tensorflow, for now I've just relied on the output generated by this code as ground truth for verification.
 */
 TEST(Random, MultinomialGoodCase) {
   OpTester test("Multinomial");
@@ -254,13 +291,7 @@ TEST(Random, MultinomialGoodCase) {
   test.AddAttribute<int64_t>("dtype", TensorProto::INT64);
 
   const std::vector<int64_t> output_dims{batch_size, num_samples};
-#ifdef _WIN32
-  const std::vector<int64_t> expected_output{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-#elif defined(__MACH__) || defined(__ANDROID__) || defined(__FreeBSD__) || defined(__wasm__) || defined(_AIX)
-  const std::vector<int64_t> expected_output{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-#else
-  const std::vector<int64_t> expected_output{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-#endif
+  const std::vector<int64_t> expected_output{2, 2, 2, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1, 0, 0, 1, 0, 0, 2, 1};
   test.AddOutput<int64_t>("Y", output_dims, expected_output);
 
   test.Run();
@@ -291,16 +322,8 @@ TEST(Random, MultinomialDefaultDType) {
     test.Run();
   };
 
-#ifdef _WIN32
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 2, 2, 2, 0, 2, 2, 1, 1, 2, 1, 1, 1, 1, 2, 1, 2, 0};
-  const std::vector<int32_t> expected_output_2{0, 0, 1, 0, 2, 2, 2, 0, 2, 1, 2, 1, 0, 2, 0, 2, 2, 1, 2, 1};
-#elif defined(__MACH__) || defined(__ANDROID__) || defined(__FreeBSD__) || defined(__wasm__) || defined(_AIX)
-  const std::vector<int32_t> expected_output_1{1, 1, 2, 2, 0, 2, 2, 2, 0, 2, 1, 1, 2, 0, 2, 2, 0, 2, 1, 1};
-  const std::vector<int32_t> expected_output_2{1, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0, 2, 0, 1, 1, 0, 2, 2, 2, 1};
-#else
-  const std::vector<int32_t> expected_output_1{2, 0, 0, 1, 0, 1, 2, 0, 1, 0, 0, 1, 1, 0, 1, 0, 2, 0, 2, 0};
-  const std::vector<int32_t> expected_output_2{2, 2, 1, 1, 0, 2, 2, 1, 1, 2, 0, 0, 0, 2, 0, 1, 1, 1, 0, 0};
-#endif
+  const std::vector<int32_t> expected_output_1{2, 2, 2, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1, 0, 0, 1, 0, 0, 2, 1};
+  const std::vector<int32_t> expected_output_2{1, 0, 0, 0, 1, 1, 2, 0, 0, 1, 1, 1, 2, 1, 1, 2, 0, 2, 0, 0};
 
   // Test output from a single call to Multinomial::Compute
   run_test(1, expected_output_1);
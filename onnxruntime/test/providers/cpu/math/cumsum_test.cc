@@ -247,5 +247,25 @@ TEST(CumSumTest, _1DTestdouble_WithInt64Axis) {
   test.AddOutput<double>("y", {5}, {1., 3., 6., 10., 15.});
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
 }
+TEST(CumSumTest, _1DTestLongRowReverseExclusive) {
+  // long enough for the row to be scanned in blocks on several threads
+  constexpr int64_t dim = 100000;
+  std::vector<int64_t> input(dim);
+  std::vector<int64_t> output(dim);
+  int64_t sum = 0;
+  for (int64_t i = dim - 1; i >= 0; --i) {
+    input[i] = i % 7 - 3;
+    output[i] = sum;
+    sum += input[i];
+  }
+
+  OpTester test("CumSum", 11, onnxruntime::kOnnxDomain);
+  test.AddAttribute<int64_t>("exclusive", 1);
+  test.AddAttribute<int64_t>("reverse", 1);
+  test.AddInput<int64_t>("x", {dim}, input);
+  test.AddInput<int32_t>("axis", {}, {0});
+  test.AddOutput<int64_t>("y", {dim}, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
 }  // namespace test
 }  // namespace onnxruntime
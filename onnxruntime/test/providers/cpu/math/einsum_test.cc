@@ -237,6 +237,29 @@ TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
 }
 
+// The last two operands are the cheapest pair and are contracted first
+TEST(Einsum, ExplicitEinsumAsMatmul_Multi_Input_Reordered) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ij,jk,k->i");
+  test.AddInput<float>("x", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  test.AddInput<float>("y", {3, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f});
+  test.AddInput<float>("z", {4}, {1.f, -1.f, 2.f, 0.5f});
+  test.AddOutput<float>("o", {2}, {122.f, 275.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
+// Contracted in the order x, w, y, z so that every intermediate is a vector or a scalar
+TEST(Einsum, ExplicitEinsumAsReduceOp_Multi_Input_Reordered) {
+  OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
+  test.AddAttribute<std::string>("equation", "ab,bc,c,a->");
+  test.AddInput<float>("x", {2, 2}, {1.f, 2.f, 3.f, 4.f});
+  test.AddInput<float>("y", {2, 3}, {1.f, 0.f, -1.f, 2.f, 1.f, 1.f});
+  test.AddInput<float>("z", {3}, {2.f, 1.f, 0.f});
+  test.AddInput<float>("w", {2}, {1.f, -2.f});
+  test.AddOutput<float>("o", {}, {-40.f});
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
+}
+
 TEST(Einsum, ExplicitEinsumAsBatchedMatmul) {
   OpTester test("Einsum", 12, onnxruntime::kOnnxDomain);
   test.AddAttribute<std::string>("equation", "bij,bjk->bik");
@@ -10,6 +10,7 @@
 #include "core/util/math.h"
 #include <algorithm>
 #include <limits>
+#include <numeric>
 #include <math.h>
 
 namespace onnxruntime {
@@ -1415,6 +1416,36 @@ TEST(MathOpTest, SumMultipleInputsNoBroadcasting_double) {
   }
 }
 
+// [B,1,S,1] + [1,H,1,D] + [D] with an output large enough to be partitioned part way through a span.
+// The first partial sum is smaller than the output so goes to a temporary, the second is accumulated in place.
+TEST(MathOpTest, SumMultipleInputsMultidirectionalBroadcast) {
+  constexpr int64_t B = 2, H = 8, S = 64, D = 17;
+
+  std::vector<float> a(B * S), b(H * D), c(D);
+  std::iota(a.begin(), a.end(), 0.0f);
+  std::iota(b.begin(), b.end(), 1000.0f);
+  std::iota(c.begin(), c.end(), 100000.0f);
+
+  std::vector<float> expected;
+  expected.reserve(B * H * S * D);
+  for (int64_t i = 0; i < B; ++i) {
+    for (int64_t j = 0; j < H; ++j) {
+      for (int64_t k = 0; k < S; ++k) {
+        for (int64_t l = 0; l < D; ++l) {
+          expected.push_back(a[i * S + k] + b[j * D + l] + c[l]);
+        }
+      }
+    }
+  }
+
+  OpTester test("Sum", 8);
+  test.AddInput<float>("data_0", {B, 1, S, 1}, a);
+  test.AddInput<float>("data_1", {1, H, 1, D}, b);
+  test.AddInput<float>("data_2", {D}, c);
+  test.AddOutput<float>("sum", {B, H, S, D}, expected);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 #if defined(USE_DNNL)
 TEST(MathOpTest, Sum_13_bfloat16) {
 #ifdef USE_DNNL
@@ -2111,6 +2142,21 @@ TEST(MathOpTest, Max_12_MLFloat16) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});  // TensorRT: Input batch size is inconsistent
 }
 
+TEST(MathOpTest, Max_12_MLFloat16_MultipleSpans) {
+  OpTester test("Max", 12);
+  test.AddInput<MLFloat16>("data_0", {2, 3},
+                           MakeMLFloat16({1.f, 2.f, 3.f,
+                                          4.f, 5.f, 6.f}));
+  test.AddInput<MLFloat16>("data_1", {3},
+                           MakeMLFloat16({3.f, 3.f, 3.f}));
+  test.AddInput<MLFloat16>("data_2", {2, 1},
+                           MakeMLFloat16({2.f, 5.f}));
+  test.AddOutput<MLFloat16>("max", {2, 3},
+                            MakeMLFloat16({3.f, 3.f, 3.f,
+                                           5.f, 5.f, 6.f}));
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+}
+
 TEST(MathOpTest, Max_12_MLFloat16_Scalar0) {
   OpTester test("Max", 12);
   test.AddInput<MLFloat16>("data_0", {},
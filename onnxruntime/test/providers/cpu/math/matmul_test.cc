@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/providers/run_options_config_keys.h"
 #include "test/common/dnnl_op_test_utils.h"
@@ -219,7 +221,7 @@ TEST(MathOpTest, MatMulUint64Type) {
   RunMatMulTest<uint64_t>(9);
 }
 
-#if defined(USE_CUDA) || defined(USE_ROCM)
+#if defined(USE_CUDA) || defined(USE_ROCM) || defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
 TEST(MathOpTest, MatMul_Float16) {
 #ifdef USE_CUDA
   int min_cuda_architecture = 530;
@@ -227,6 +229,12 @@ TEST(MathOpTest, MatMul_Float16) {
     LOGS_DEFAULT(WARNING) << "Hardware NOT support FP16";
     return;
   }
+#endif
+#if !defined(USE_CUDA) && !defined(USE_ROCM)
+  // the CPU EP is the only one which can run the model, and it registers MatMul<MLFloat16> with fp16 acceleration only
+  if (!MlasFp16AccelerationSupported()) {
+    GTEST_SKIP() << "Hardware NOT support FP16";
+  }
 #endif
   OpTester test("MatMul", 14);
 
@@ -252,6 +260,60 @@ TEST(MathOpTest, MatMul_Float16) {
 }
 #endif
 
+#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+TEST(MathOpTest, MatMul_Float16_BroadcastBatch) {
+  if (!MlasFp16AccelerationSupported()) {
+    GTEST_SKIP() << "Hardware NOT support FP16";
+  }
+
+  RandomValueGenerator random{};
+  const std::vector<int64_t> a_shape{2, 3, 5, 8};
+  const std::vector<int64_t> b_shape{3, 8, 7};
+  const int64_t M = 5, K = 8, N = 7;
+  std::vector<float> A = random.Uniform<float>(a_shape, -1.0f, 1.0f);
+  std::vector<float> B = random.Uniform<float>(b_shape, -1.0f, 1.0f);
+  std::vector<float> Y(2 * 3 * M * N);
+  for (int64_t batch = 0; batch < 6; batch++) {
+    const float* a = A.data() + batch * M * K;
+    const float* b = B.data() + (batch % 3) * K * N;
+    for (int64_t m = 0; m < M; m++) {
+      for (int64_t n = 0; n < N; n++) {
+        float sum = 0.0f;
+        for (int64_t k = 0; k < K; k++) {
+          sum += a[m * K + k] * b[k * N + n];
+        }
+        Y[(batch * M + m) * N + n] = sum;
+      }
+    }
+  }
+
+  OpTester test("MatMul", 13);
+  test.AddInput<MLFloat16>("A", a_shape, FloatsToMLFloat16s(A));
+  test.AddInput<MLFloat16>("B", b_shape, FloatsToMLFloat16s(B));
+  test.AddOutput<MLFloat16>("Y", {2, 3, M, N}, FloatsToMLFloat16s(Y));
+  test.SetOutputTolerance(0.02f);
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
+
+#if defined(__aarch64__) && defined(__linux__)
+TEST(MathOpTest, MatMul_bfloat16_Cpu) {
+  if (!MlasBf16AccelerationSupported()) {
+    GTEST_SKIP() << "Hardware does NOT support BF16";
+  }
+
+  OpTester test("MatMul", 14);
+  test.AddInput<BFloat16>("A", {2, 1, 4}, MakeBFloat16({1.0f, 2.0f, 3.0f, 4.0f, -1.0f, -2.0f, -3.0f, -4.0f}));
+  test.AddInput<BFloat16>("B", {4, 3}, MakeBFloat16({1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f}));
+  test.AddOutput<BFloat16>("Y", {2, 1, 3}, MakeBFloat16({10.0f, 10.0f, 10.0f, -10.0f, -10.0f, -10.0f}));
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+#endif
+
 #if defined(USE_CUDA) || defined(USE_ROCM) || defined(USE_DNNL)
 TEST(MathOpTest, MatMul_bfloat16) {
 #ifdef USE_CUDA
@@ -369,6 +431,38 @@ TEST(MathOpTest, MatMulSharedPrepackedWeights) {
   }
 }
 
+
+TEST(MathOpTest, MatMulSparseWeights) {
+  // B has 8 zeros out of 12, so it is packed in CSR format with a threshold of 0.5 and not with one of 0.9.
+  for (const char* threshold : {"0", "0.5", "0.9"}) {
+    OpTester test("MatMul", 13);
+    test.AddInput<float>("A", {2, 2, 4},
+                         {1.0f, 2.0f, 3.0f, 4.0f,
+                          -1.0f, -2.0f, -3.0f, -4.0f,
+                          0.5f, 0.0f, -0.5f, 1.0f,
+                          2.0f, 1.0f, 0.0f, -1.0f});
+    test.AddInput<float>("B", {4, 3},
+                         {1.0f, 0.0f, 0.0f,
+                          0.0f, 0.0f, 2.0f,
+                          0.0f, -1.0f, 0.0f,
+                          3.0f, 0.0f, 0.0f},
+                         true);
+    test.AddOutput<float>("Y", {2, 2, 3},
+                          {13.0f, -3.0f, 4.0f,
+                           -13.0f, 3.0f, -4.0f,
+                           3.5f, 0.5f, 0.0f,
+                           -1.0f, 0.0f, 2.0f});
+
+    SessionOptions so;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasMatMulSparseWeightThreshold, threshold));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Config(so)
+        .ConfigEps(std::move(execution_providers))
+        .RunWithConfig();
+  }
+}
 #endif
 
 }  // namespace test
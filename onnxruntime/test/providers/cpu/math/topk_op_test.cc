@@ -861,5 +861,38 @@ TEST(TopKOperator, SelectTopKThreaded) {
   TestThreaded<double>(k, n, batch_size);
 }
 
+// a single row which is long enough to be split into parts which are selected from in parallel, as the logits of a
+// sampling step over a large vocabulary.
+template <typename T>
+static void TestSingleLargeRow(int64_t k, int64_t largest) {
+  // a permutation of [0, n) as n is prime, so the best values are spread over the row
+  constexpr int64_t n = 100003;
+  std::vector<T> input_vals(n);
+  for (int64_t i = 0; i < n; ++i) {
+    input_vals[i] = static_cast<T>((i * 7919) % n);
+  }
+
+  std::vector<int64_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](int64_t lhs, int64_t rhs) {
+    return largest ? input_vals[lhs] > input_vals[rhs] : input_vals[lhs] < input_vals[rhs];
+  });
+
+  std::vector<T> expected_vals(k);
+  std::vector<int64_t> expected_indices(order.begin(), order.begin() + k);
+  for (int64_t i = 0; i < k; ++i) {
+    expected_vals[i] = input_vals[expected_indices[i]];
+  }
+
+  RunTest(11, k, input_vals, {1, n}, expected_vals, expected_indices, {1, k}, false, -1, largest);
+}
+
+TEST(TopKOperator, SingleLargeRowThreaded) {
+  TestSingleLargeRow<float>(1, 1);
+  TestSingleLargeRow<float>(50, 1);
+  TestSingleLargeRow<float>(50, 0);  // smallest
+  TestSingleLargeRow<double>(50, 1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -43,5 +43,28 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+TEST(CategoryMapper, LargeInput) {
+  // large enough to be split across the threads of the thread pool
+  constexpr int64_t size = 100000;
+  std::vector<int64_t> dims{size};
+
+  static const std::vector<std::string> categories = {"Unknown", "One", "Two", "Three"};
+  std::vector<std::string> string_values;
+  std::vector<int64_t> int_values;
+  for (int64_t i = 0; i < size; ++i) {
+    string_values.push_back(categories[i % 4]);
+    int_values.push_back(i % 4 == 0 ? 99 : i % 4);
+  }
+  RunTest(dims, string_values, int_values);
+
+  std::vector<int64_t> int_inputs;
+  std::vector<std::string> string_outputs;
+  for (int64_t i = 0; i < size; ++i) {
+    int_inputs.push_back(i % 4);
+    string_outputs.push_back(i % 4 == 0 ? "default" : categories[i % 4]);
+  }
+  RunTest(dims, int_inputs, string_outputs);
+}
 }  // namespace test
 }  // namespace onnxruntime
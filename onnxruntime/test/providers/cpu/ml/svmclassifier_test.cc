@@ -7,7 +7,17 @@
 namespace onnxruntime {
 namespace test {
 
-TEST(MLOpTest, SVMClassifierMulticlassSVC) {
+// Repeats the values of a batch, so that tests can cover the batches being split across threads.
+template <typename T>
+static std::vector<T> RepeatBatches(const std::vector<T>& values, int64_t repeats) {
+  std::vector<T> repeated;
+  for (int64_t i = 0; i < repeats; ++i) {
+    repeated.insert(repeated.end(), values.begin(), values.end());
+  }
+  return repeated;
+}
+
+static void RunMulticlassSVCTest(int64_t repeats) {
   OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
 
   std::vector<float> dual_coefficients = {1.14360327f, 1.95968249f, -1.175683f, -1.92760275f, -1.32575698f,
@@ -43,13 +53,21 @@ TEST(MLOpTest, SVMClassifierMulticlassSVC) {
   test.AddAttribute("kernel_params", kernel_params);
   test.AddAttribute("classlabels_ints", classes);
 
-  test.AddInput<float>("X", {8, 3}, X);
-  test.AddOutput<int64_t>("Y", {8}, predictions);
-  test.AddOutput<float>("Z", {8, 6}, scores);
+  test.AddInput<float>("X", {8 * repeats, 3}, RepeatBatches(X, repeats));
+  test.AddOutput<int64_t>("Y", {8 * repeats}, RepeatBatches(predictions, repeats));
+  test.AddOutput<float>("Z", {8 * repeats, 6}, RepeatBatches(scores, repeats));
 
   test.Run();
 }
 
+TEST(MLOpTest, SVMClassifierMulticlassSVC) {
+  RunMulticlassSVCTest(1);
+}
+
+TEST(MLOpTest, SVMClassifierMulticlassSVCLargeBatch) {
+  RunMulticlassSVCTest(100);
+}
+
 TEST(MLOpTest, SVMClassifierMulticlassLinearSVC) {
   OpTester test("SVMClassifier", 1, onnxruntime::kMLDomain);
 
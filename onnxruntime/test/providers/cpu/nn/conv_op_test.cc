@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 using namespace std;
@@ -979,5 +981,70 @@ TEST(ConvTest, Conv_AutoPad_with_non_default_strides) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// 3x3 stride 1 convolution with enough channels and filters to use the Winograd algorithm of MLAS, run with the
+// Winograd algorithm disabled, enabled and chosen by the CPU TunableOp.
+TEST(ConvTest, Conv2D_Winograd) {
+  constexpr int64_t C = 16, M = 18, H = 7, W = 9;
+  const vector<int64_t> pads = {1, 0, 0, 1};
+  constexpr int64_t OH = H + 1 - 2, OW = W + 1 - 2;
+
+  vector<float> X(C * H * W);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(static_cast<int>(i % 11) - 5) * 0.1f;
+  }
+  vector<float> filter(M * C * 9);
+  for (size_t i = 0; i < filter.size(); ++i) {
+    filter[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.1f;
+  }
+  vector<float> B(M);
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<float>(i) * 0.1f;
+  }
+
+  vector<float> expected(M * OH * OW);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t oh = 0; oh < OH; ++oh) {
+      for (int64_t ow = 0; ow < OW; ++ow) {
+        float sum = B[m];
+        for (int64_t c = 0; c < C; ++c) {
+          for (int64_t kh = 0; kh < 3; ++kh) {
+            for (int64_t kw = 0; kw < 3; ++kw) {
+              const int64_t ih = oh + kh - pads[0], iw = ow + kw - pads[1];
+              if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                sum += X[(c * H + ih) * W + iw] * filter[((m * C + c) * 3 + kh) * 3 + kw];
+              }
+            }
+          }
+        }
+        expected[(m * OH + oh) * OW + ow] = sum;
+      }
+    }
+  }
+
+  for (const char* use_winograd : {"0", "1", "tunable"}) {
+    OpTester test("Conv", 11);
+    test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+    test.AddAttribute("pads", pads);
+    test.AddInput<float>("X", {1, C, H, W}, X);
+    test.AddInput<float>("W", {M, C, 3, 3}, filter, true);
+    test.AddInput<float>("B", {M}, B, true);
+    test.AddOutput<float>("Y", {1, M, OH, OW}, expected);
+    test.SetOutputTolerance(0.0001f);
+
+    SessionOptions so;
+    CPUExecutionProviderInfo info;
+    if (std::string(use_winograd) == "tunable") {
+      info.tunable_op.enable = true;
+      info.tunable_op.tuning_enable = true;
+    } else {
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsMlasConvWinograd, use_winograd));
+    }
+
+    test.Config(so)
+        .ConfigEp(std::make_unique<CPUExecutionProvider>(info))
+        .RunWithConfig();
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
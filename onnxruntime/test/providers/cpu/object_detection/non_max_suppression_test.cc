@@ -305,6 +305,61 @@ TEST(NonMaxSuppressionOpTest, InconsistentBoxAndScoreShapes) {
   test.Run(OpTester::ExpectResult::kExpectFailure, "boxes and scores should have same spatial_dimension.");
 }
 
+TEST(NonMaxSuppressionOpTest, ManyClasses) {
+  // every class has the scores of WithIOUThreshold, so the same boxes are selected for each of them
+  constexpr int64_t num_classes = 80;
+  const std::vector<float> class_scores{0.9f, 0.75f, 0.6f, 0.95f, 0.5f, 0.3f};
+  std::vector<float> scores;
+  std::vector<int64_t> selected_indices;
+  for (int64_t class_index = 0; class_index < num_classes; ++class_index) {
+    scores.insert(scores.end(), class_scores.begin(), class_scores.end());
+    for (int64_t box_index : {3, 0, 5}) {
+      selected_indices.insert(selected_indices.end(), {0, class_index, box_index});
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {1, 6, 4},
+                       {0.0f, 0.0f, 1.0f, 1.0f,
+                        0.0f, 0.1f, 1.0f, 1.1f,
+                        0.0f, -0.1f, 1.0f, 0.9f,
+                        0.0f, 10.0f, 1.0f, 11.0f,
+                        0.0f, 10.1f, 1.0f, 11.1f,
+                        0.0f, 100.0f, 1.0f, 101.0f});
+  test.AddInput<float>("scores", {1, num_classes, 6}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {3L});
+  test.AddInput<float>("iou_threshold", {}, {0.5f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {3 * num_classes, 3}, selected_indices);
+  test.Run();
+}
+
+TEST(NonMaxSuppressionOpTest, ManyOverlappingCandidates) {
+  // each box overlaps its neighbors by half of its width, so that the IOU of neighbors is 1/3, and boxes two apart
+  // only touch. The scores decrease with the index, so every other box is selected.
+  constexpr int64_t num_boxes = 600;
+  std::vector<float> boxes;
+  std::vector<float> scores;
+  std::vector<int64_t> selected_indices;
+  for (int64_t box_index = 0; box_index < num_boxes; ++box_index) {
+    const float x = 0.5f * static_cast<float>(box_index);
+    boxes.insert(boxes.end(), {0.0f, x, 1.0f, x + 1.0f});
+    scores.push_back(1.0f - static_cast<float>(box_index) / 1000.0f);
+    if (box_index % 2 == 0) {
+      selected_indices.insert(selected_indices.end(), {0, 0, box_index});
+    }
+  }
+
+  OpTester test("NonMaxSuppression", 11, kOnnxDomain);
+  test.AddInput<float>("boxes", {1, num_boxes, 4}, boxes);
+  test.AddInput<float>("scores", {1, 1, num_boxes}, scores);
+  test.AddInput<int64_t>("max_output_boxes_per_class", {}, {1000L});
+  test.AddInput<float>("iou_threshold", {}, {0.3f});
+  test.AddInput<float>("score_threshold", {}, {0.0f});
+  test.AddOutput<int64_t>("selected_indices", {num_boxes / 2, 3}, selected_indices);
+  test.Run();
+}
+
 TEST(NonMaxSuppressionOpTest, InvalidIOUThreshold) {
   OpTester test("NonMaxSuppression", 10, kOnnxDomain);
   test.AddInput<float>("boxes", {1, 1, 4}, {0.0f, 0.0f, 1.0f, 1.0f});
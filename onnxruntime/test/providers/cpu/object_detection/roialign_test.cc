@@ -692,6 +692,33 @@ TEST(RoiAlignTest, MaxModePositive) {
   test.Run();
 }
 
+TEST(RoiAlignTest, AvgModeSingleRoiManyChannels) {
+  // the value of each channel is its index, which is the average of each bin inside the feature map
+  OpTester test("RoiAlign", 10);
+  test.AddAttribute<int64_t>("output_height", 2);
+  test.AddAttribute<int64_t>("output_width", 2);
+  test.AddAttribute<int64_t>("sampling_ratio", 2);
+  test.AddAttribute<float>("spatial_scale", 1.0f);
+
+  constexpr int64_t N = 1;
+  constexpr int64_t C = 16;
+  constexpr int64_t H = 4;
+  constexpr int64_t W = 4;
+
+  std::vector<float> X;
+  std::vector<float> Y;
+  for (int64_t c = 0; c < C; ++c) {
+    X.insert(X.end(), H * W, static_cast<float>(c));
+    Y.insert(Y.end(), 2 * 2, static_cast<float>(c));
+  }
+
+  test.AddInput<float>("X", {N, C, H, W}, X);
+  test.AddInput<float>("rois", {1, 4}, {0., 0., 3., 3.});
+  test.AddInput<int64_t>("batch_indices", {1}, {0});
+  test.AddOutput<float>("Y", {1, C, 2, 2}, Y);
+  test.Run();
+}
+
 TEST(RoiAlignTest, AvgModeNegativeInvalidMode) {
   // TODO: Unskip when fixed #41968513
   if (DefaultDmlExecutionProvider().get() != nullptr) {
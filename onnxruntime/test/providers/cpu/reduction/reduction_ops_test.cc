@@ -5843,6 +5843,54 @@ TEST(ReductionOpTest, ReduceSum_RKRK_keepdims) {
   test.Run();
 }
 
+// the innermost axis is longer than a tile of the outputs which are reduced together, and isn't a multiple of it
+TEST(ReductionOpTest, ReduceSumMaxLogSumExp_RKRK_tiled) {
+  const std::vector<int64_t> input_shape = {3, 2, 4, 37};
+  std::vector<float> data(3 * 2 * 4 * 37);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>((i * 7) % 23) * 0.25f - 2.0f;
+  }
+
+  std::vector<float> sum(2 * 37, 0.0f);
+  std::vector<float> max(2 * 37, std::numeric_limits<float>::lowest());
+  for (int64_t i0 = 0; i0 < 3; ++i0) {
+    for (int64_t i1 = 0; i1 < 2; ++i1) {
+      for (int64_t i2 = 0; i2 < 4; ++i2) {
+        for (int64_t i3 = 0; i3 < 37; ++i3) {
+          const float value = data[((i0 * 2 + i1) * 4 + i2) * 37 + i3];
+          sum[i1 * 37 + i3] += value;
+          max[i1 * 37 + i3] = std::max(max[i1 * 37 + i3], value);
+        }
+      }
+    }
+  }
+
+  std::vector<float> log_sum_exp(2 * 37, 0.0f);
+  for (int64_t i0 = 0; i0 < 3; ++i0) {
+    for (int64_t i1 = 0; i1 < 2; ++i1) {
+      for (int64_t i2 = 0; i2 < 4; ++i2) {
+        for (int64_t i3 = 0; i3 < 37; ++i3) {
+          log_sum_exp[i1 * 37 + i3] += std::exp(data[((i0 * 2 + i1) * 4 + i2) * 37 + i3] - max[i1 * 37 + i3]);
+        }
+      }
+    }
+  }
+  for (size_t i = 0; i < log_sum_exp.size(); ++i) {
+    log_sum_exp[i] = std::log(log_sum_exp[i]) + max[i];
+  }
+
+  for (const auto& [op, expected] : {std::make_pair("ReduceSum", &sum),
+                                     std::make_pair("ReduceMax", &max),
+                                     std::make_pair("ReduceLogSumExp", &log_sum_exp)}) {
+    OpTester test(op);
+    test.AddAttribute("axes", std::vector<int64_t>{0, 2});
+    test.AddAttribute("keepdims", (int64_t)0);
+    test.AddInput<float>("data", input_shape, data);
+    test.AddOutput<float>("reduced", {2, 37}, *expected);
+    test.Run();
+  }
+}
+
 void test_empty_set(const std::string& op, int opset, bool axes_as_input, float empty_value) {
   OpTester test(op, opset);
   std::vector<int64_t> input_shape = {2, 0, 4};
@@ -313,6 +313,55 @@ TEST(SequenceOpsTest, SequenceEraseInvalidNegativeIdx) {
   test.Run(OpTester::ExpectResult::kExpectFailure, "Invalid sequence index");
 }
 
+// SequenceInsert -> SequenceInsert -> SequenceErase -> SequenceInsert. The intermediate sequences are not used again
+// so the second insert and the erase update them in place. The graph input and output are never updated in place.
+class SequenceInsertEraseChainTester : public OpTester {
+ public:
+  SequenceInsertEraseChainTester() : OpTester("SequenceInsert", 11) {}
+
+ protected:
+  void AddNodes(onnxruntime::Graph& graph,
+                std::vector<onnxruntime::NodeArg*>& graph_input_defs,
+                std::vector<onnxruntime::NodeArg*>& graph_output_defs,
+                std::vector<std::function<void(onnxruntime::Node& node)>>& /*add_attribute_funcs*/) override {
+    ASSERT_EQ(graph_input_defs.size(), 3u);
+    ASSERT_EQ(graph_output_defs.size(), 1u);
+
+    ONNX_NAMESPACE::TypeProto seq_type;
+    seq_type.mutable_sequence_type()->mutable_elem_type()->mutable_tensor_type()->set_elem_type(
+        ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    auto& seq1 = graph.GetOrCreateNodeArg("seq1", &seq_type);
+    auto& seq2 = graph.GetOrCreateNodeArg("seq2", &seq_type);
+    auto& seq3 = graph.GetOrCreateNodeArg("seq3", &seq_type);
+
+    NodeArg* s = graph_input_defs[0];
+    NodeArg* t = graph_input_defs[1];
+    NodeArg* i = graph_input_defs[2];
+    graph.AddNode("insert1", "SequenceInsert", "", {s, t}, {&seq1});
+    graph.AddNode("insert2", "SequenceInsert", "", {&seq1, t}, {&seq2});
+    graph.AddNode("erase", "SequenceErase", "", {&seq2, i}, {&seq3});
+    graph.AddNode("insert3", "SequenceInsert", "", {&seq3, t}, {graph_output_defs[0]});
+  }
+};
+
+TEST(SequenceOpsTest, SequenceInsertEraseInPlace) {
+  SequenceInsertEraseChainTester test;
+  SeqTensors<int64_t> input;
+  input.AddTensor({3, 2}, {1, 2, 3, 4, 5, 6});
+  input.AddTensor({3, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  test.AddSeqInput("S", input);
+  test.AddInput<int64_t>("T", {2}, {10, 20});
+  test.AddInput<int64_t>("I", {}, {0});
+
+  SeqTensors<int64_t> output;
+  output.AddTensor({3, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  output.AddTensor({2}, {10, 20});
+  output.AddTensor({2}, {10, 20});
+  output.AddTensor({2}, {10, 20});
+  test.AddSeqOutput("S2", output);
+  test.Run();
+}
+
 // SequenceConstruct
 TEST(SequenceOpsTest, SequenceConstructPositive) {
   OpTester test("SequenceConstruct", 11);
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -233,6 +234,48 @@ TEST(SignalOpsTest, STFTFloat) {
   test.Run();
 }
 
+// Frames of a batch of complex signals, of a length that is not a power of 2, against a naive DFT.
+TEST(SignalOpsTest, STFTFloat_complex_batched) {
+  constexpr int64_t batch_size = 2;
+  constexpr int64_t signal_length = 20;
+  constexpr int64_t frame_length = 6;
+  constexpr int64_t frame_step = 4;
+  constexpr int64_t n_frames = (signal_length - frame_length) / frame_step + 1;
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  vector<float> signal = random.Uniform<float>({batch_size, signal_length, 2}, -1.f, 1.f);
+  vector<float> window = random.Uniform<float>({frame_length}, 0.f, 1.f);
+
+  vector<float> expected_output;
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t frame = 0; frame < n_frames; frame++) {
+      for (int64_t k = 0; k < frame_length; k++) {
+        double real = 0, imaginary = 0;
+        for (int64_t n = 0; n < frame_length; n++) {
+          const size_t index = static_cast<size_t>((b * signal_length + frame * frame_step + n) * 2);
+          const double angle = -2 * M_PI * static_cast<double>(k * n) / frame_length;
+          const double x_real = signal[index] * window[n];
+          const double x_imaginary = signal[index + 1] * window[n];
+          real += x_real * std::cos(angle) - x_imaginary * std::sin(angle);
+          imaginary += x_real * std::sin(angle) + x_imaginary * std::cos(angle);
+        }
+        expected_output.push_back(static_cast<float>(real));
+        expected_output.push_back(static_cast<float>(imaginary));
+      }
+    }
+  }
+
+  OpTester test("STFT", kMinOpsetVersion);
+  test.AddAttribute<int64_t>("onesided", 0);
+  test.AddInput<float>("signal", {batch_size, signal_length, 2}, signal);
+  test.AddInput<int64_t>("frame_step", {}, {frame_step});
+  test.AddInput<float>("window", {frame_length}, window);
+  test.AddInput<int64_t>("frame_length", {}, {frame_length});
+  test.AddOutput<float>("output", {batch_size, n_frames, frame_length, 2}, expected_output);
+  test.SetOutputAbsErr("output", 0.0001f);
+  test.Run();
+}
+
 TEST(SignalOpsTest, HannWindowFloat) {
   OpTester test("HannWindow", kMinOpsetVersion);
 
@@ -276,5 +276,55 @@ TEST(CastOpTest, ToFloat8E5M2FNUZ) {
 
 #endif
 
+TEST(CastOpTest, ToInt4) {
+  // values are clamped to the int4 range and rounded half to even
+  {
+    OpTester test("Cast", 21);
+    test.AddAttribute<int64_t>("to", utils::ToTensorProtoElementType<Int4x2>());
+    test.AddInput<float>("input", {5}, {-9.f, -2.5f, 0.5f, 1.5f, 100.f});
+    test.AddOutput<Int4x2>("output", {5}, {Int4x2(-8, -2), Int4x2(0, 2), Int4x2(7, 0)});
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+  {
+    OpTester test("Cast", 21);
+    test.AddAttribute<int64_t>("to", utils::ToTensorProtoElementType<UInt4x2>());
+    test.AddInput<int32_t>("input", {3}, {-1, 3, 20});
+    test.AddOutput<UInt4x2>("output", {3}, {UInt4x2(0, 3), UInt4x2(15, 0)});
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+}
+
+TEST(CastOpTest, FromInt4) {
+  const std::vector<Int4x2> input{Int4x2(-8, 7), Int4x2(-3, 0)};
+  {
+    OpTester test("Cast", 21);
+    test.AddAttribute<int64_t>("to", utils::ToTensorProtoElementType<float>());
+    test.AddInput<Int4x2>("input", {3}, input);
+    test.AddOutput<float>("output", {3}, {-8.f, 7.f, -3.f});
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+  {
+    OpTester test("Cast", 21);
+    test.AddAttribute<int64_t>("to", utils::ToTensorProtoElementType<int8_t>());
+    test.AddInput<Int4x2>("input", {3}, input);
+    test.AddOutput<int8_t>("output", {3}, {-8, 7, -3});
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+  {
+    OpTester test("Cast", 21);
+    test.AddAttribute<int64_t>("to", utils::ToTensorProtoElementType<UInt4x2>());
+    test.AddInput<Int4x2>("input", {3}, input);
+    test.AddOutput<UInt4x2>("output", {3}, {UInt4x2(0, 7), UInt4x2(0, 0)});
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+  {
+    OpTester test("Cast", 21);
+    test.AddAttribute<int64_t>("to", utils::ToTensorProtoElementType<std::string>());
+    test.AddInput<Int4x2>("input", {3}, input);
+    test.AddOutput<std::string>("output", {3}, {"-8", "7", "-3"});
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider});
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
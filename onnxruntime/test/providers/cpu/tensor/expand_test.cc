@@ -5,7 +5,7 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
-#if defined(ENABLE_STRIDED_TENSORS) && (defined(USE_CUDA) || defined(USE_ROCM))
+#ifdef ENABLE_STRIDED_TENSORS
 #include "test/providers/kernel_compute_test_utils.h"
 #endif
 
@@ -250,5 +250,28 @@ TEST(ExpandOpTest, Strided) {
 }
 #endif
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(ExpandOpTest, StridedCpu) {
+  // The output is a view of the input.
+  {
+    KernelComputeTester test("Expand");
+    test.AddInput<float>("input_0", {3, 1}, {1.f, 2.f, 3.f});
+    test.AddInput<int64_t>("input_1", {2}, {1, 3});
+    test.AddOutput<float>("output", {3, 3}, {1.f, 2.f, 3.f}, {1, 0});
+    test.Run({0});
+  }
+
+  // A strided input is copied through the broadcast strides.
+  {
+    KernelComputeTester test("Expand");
+    test.AddInput<float>("input_0", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, {1, 2});
+    test.AddInput<int64_t>("input_1", {3}, {2, 1, 1});
+    test.AddOutput<float>("output", {2, 2, 3},
+                          {1.f, 3.f, 5.f, 2.f, 4.f, 6.f, 1.f, 3.f, 5.f, 2.f, 4.f, 6.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
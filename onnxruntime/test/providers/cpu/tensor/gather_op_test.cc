@@ -430,6 +430,49 @@ TEST(GatherOpTest, Gather_axis1_scalar_indices) {
   run_test(false);
   run_test(true);
 }
+TEST(GatherOpTest, Gather_axis0_string_rows) {
+  OpTester test("Gather");
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<std::string>("data", {3, 2},
+                             {"0", "1",
+                              "10", "11",
+                              "20", "21"});
+  test.AddInput<int64_t>("indices", {3}, {2, 0, -1});
+  test.AddOutput<std::string>("output", {3, 2},
+                              {"20", "21",
+                               "0", "1",
+                               "20", "21"});
+  test.Run();
+}
+
+// The rows are gathered from a table larger than the prefetch threshold, like an embedding lookup.
+TEST(GatherOpTest, Gather_axis0_large_table) {
+  constexpr int64_t num_rows = 4096;
+  constexpr int64_t row_size = 96;
+  std::vector<float> data(num_rows * row_size);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<float>(i);
+  }
+
+  std::vector<int64_t> indices;
+  for (int64_t i = 0; i < 300; ++i) {
+    indices.push_back((i * 1237) % num_rows - (i % 3 == 0 ? num_rows : 0));
+  }
+
+  std::vector<float> output;
+  for (int64_t index : indices) {
+    const int64_t row = index < 0 ? index + num_rows : index;
+    output.insert(output.end(), data.begin() + row * row_size, data.begin() + (row + 1) * row_size);
+  }
+
+  OpTester test("Gather", 13);
+  test.AddAttribute<int64_t>("axis", 0LL);
+  test.AddInput<float>("data", {num_rows, row_size}, data);
+  test.AddInput<int64_t>("indices", {3, 100}, indices);
+  test.AddOutput<float>("output", {3, 100, row_size}, output);
+  test.Run();
+}
+
 #ifdef ENABLE_TRAINING_OPS
 // Should remove the shrunken_gather include from ENABLE_TRAINING_OPS once 1). compute optimizer is enabled for inference or
 // 2). this is needed by inference for other purpose.
@@ -99,5 +99,31 @@ TEST(NonZeroOpTest, EmptyInput) {
   test.Run();
 }
 
+TEST(NonZeroOpTest, LargeInput) {
+  // large enough for the input to be processed in blocks on several threads
+  constexpr int64_t rows = 300;
+  constexpr int64_t cols = 257;
+  std::vector<int32_t> X(rows * cols, 0);
+  std::vector<int64_t> row_indices;
+  std::vector<int64_t> col_indices;
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      if ((r * cols + c) % 3 == 0) {
+        X[r * cols + c] = 1;
+        row_indices.push_back(r);
+        col_indices.push_back(c);
+      }
+    }
+  }
+
+  std::vector<int64_t> Y(row_indices);
+  Y.insert(Y.end(), col_indices.begin(), col_indices.end());
+
+  OpTester test{kOpName, kOpVersion};
+  test.AddInput<int32_t>("X", {rows, cols}, X);
+  test.AddOutput<int64_t>("Y", {2, static_cast<int64_t>(row_indices.size())}, Y);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
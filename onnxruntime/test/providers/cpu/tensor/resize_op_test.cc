@@ -1367,6 +1367,35 @@ TEST(ResizeOpTest, ResizeOpCubicDownSampleTest) {
   test.Run(OpTester::ExpectResult::kExpectSuccess, "", ExcludeTrtOnA100());
 }
 
+TEST(ResizeOpTest, ResizeOpCubicDownSampleTest_uint8) {
+  OpTester test("Resize", 13);
+  std::vector<float> scales{1.0f, 1.0f, 0.8f, 0.8f};
+  std::vector<float> roi{};
+
+  test.AddAttribute("mode", "cubic");
+
+  constexpr int64_t N = 1, C = 1, H = 4, W = 4;
+  std::vector<uint8_t> X = {
+      1, 2, 3, 4,
+      5, 6, 7, 8,
+      9, 10, 11, 12,
+      13, 14, 15, 16};
+
+  test.AddInput<uint8_t>("X", {N, C, H, W}, X);
+  test.AddInput<float>("roi", {0}, roi);
+  test.AddInput<float>("scales", {4}, scales);
+
+  // the results of the float test rounded to the nearest integer
+  std::vector<uint8_t> Y = {1, 3, 4,
+                            7, 8, 9,
+                            12, 13, 15};
+
+  test.AddOutput<uint8_t>("Y", {N, C, static_cast<int64_t>(H * scales[2]), static_cast<int64_t>(W * scales[3])}, Y);
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "",
+           {kCudaExecutionProvider, kCudaNHWCExecutionProvider, kTensorrtExecutionProvider, kRocmExecutionProvider,
+            kDmlExecutionProvider});
+}
+
 TEST(ResizeOpTest, ResizeOpCubicDownSampleTest_exclude_outside) {
   OpTester test("Resize", 13);
   std::vector<float> roi{};
@@ -235,5 +235,32 @@ TEST(ScatterNDOpTest, ScatterND_18_max) {
   test1.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
 }
 
+// Many updates write the same slices, which are reduced in the order of the updates.
+TEST(ScatterNDOpTest, ScatterND_18_add_duplicate_indices_many_updates) {
+  constexpr int64_t num_slices = 7;
+  constexpr int64_t slice_size = 5;
+  constexpr int64_t num_updates = 1000;
+
+  std::vector<int64_t> data(num_slices * slice_size, 1);
+  std::vector<int64_t> indices(num_updates);
+  std::vector<int64_t> updates(num_updates * slice_size);
+  std::vector<int64_t> output = data;
+  for (int64_t i = 0; i < num_updates; ++i) {
+    indices[i] = (i * 3) % num_slices;
+    for (int64_t j = 0; j < slice_size; ++j) {
+      updates[i * slice_size + j] = i + j;
+      output[indices[i] * slice_size + j] += i + j;
+    }
+  }
+
+  OpTester test1("ScatterND", 18);
+  test1.AddAttribute("reduction", "add");
+  test1.AddInput<int64_t>("data", {num_slices, slice_size}, data);
+  test1.AddInput<int64_t>("indices", {num_updates, 1}, indices);
+  test1.AddInput<int64_t>("updates", {num_updates, slice_size}, updates);
+  test1.AddOutput<int64_t>("output", {num_slices, slice_size}, output);
+  test1.Run(OpTester::ExpectResult::kExpectSuccess, "", {kTensorrtExecutionProvider, kOpenVINOExecutionProvider});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -5,6 +5,9 @@
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 #include "test/util/include/default_providers.h"
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
 
 namespace onnxruntime {
 namespace test {
@@ -766,5 +769,42 @@ TEST(SliceTest, CoalesceDims) {
   RunSliceTest<float>({1, 1, 1}, {1.f}, {0}, {std::numeric_limits<int64_t>::max()}, {1}, {}, {1, 1, 1}, {1.f}, true);
 }
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(SliceTest, Strided) {
+  // The output is a view of the input.
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {3, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f});
+    test.AddInput<int64_t>("starts", {2}, {0, 0});
+    test.AddInput<int64_t>("ends", {2}, {3, 4});
+    test.AddInput<int64_t>("axes", {2}, {0, 1});
+    test.AddInput<int64_t>("steps", {2}, {2, 2});
+    test.AddOutput<float>("output", {2, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f}, {8, 2});
+    test.Run({0});
+  }
+
+  // A strided input is copied through the slice, forwards and backwards.
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, {1, 2});
+    test.AddInput<int64_t>("starts", {1}, {1});
+    test.AddInput<int64_t>("ends", {1}, {3});
+    test.AddInput<int64_t>("axes", {1}, {1});
+    test.AddOutput<float>("output", {2, 2}, {3.f, 5.f, 4.f, 6.f});
+    test.Run();
+  }
+  {
+    KernelComputeTester test("Slice");
+    test.AddInput<float>("data", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, {1, 2});
+    test.AddInput<int64_t>("starts", {1}, {-1});
+    test.AddInput<int64_t>("ends", {1}, {std::numeric_limits<int64_t>::min()});
+    test.AddInput<int64_t>("axes", {1}, {1});
+    test.AddInput<int64_t>("steps", {1}, {-1});
+    test.AddOutput<float>("output", {2, 3}, {5.f, 3.f, 1.f, 6.f, 4.f, 2.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
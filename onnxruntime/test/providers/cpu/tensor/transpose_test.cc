@@ -8,6 +8,9 @@
 #include "core/providers/cpu/tensor/transpose.h"
 #include "test/util/include/default_providers.h"
 #include "test/util/include/asserts.h"
+#ifdef ENABLE_STRIDED_TENSORS
+#include "test/providers/kernel_compute_test_utils.h"
+#endif
 
 namespace onnxruntime {
 namespace test {
@@ -684,6 +687,51 @@ TEST(TransposeOpTest, NDim) {
   TransposeTest(input_shape, input_vals, &perm, input_shape, expected_vals2);
 }
 
+// Computes the expected output of a transpose element by element, for the tests of large transposes.
+static void TransposeTestWithReference(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+
+  const int64_t size = input_strides[0] * input_shape[0];
+  std::vector<float> input_vals(static_cast<size_t>(size));
+  for (int64_t i = 0; i < size; ++i) {
+    input_vals[static_cast<size_t>(i)] = static_cast<float>(i);
+  }
+
+  std::vector<int64_t> expected_shape(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    expected_shape[i] = input_shape[static_cast<size_t>(perm[i])];
+  }
+
+  std::vector<float> expected_vals(static_cast<size_t>(size));
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t remainder = i;
+    int64_t input_offset = 0;
+    for (size_t j = rank; j > 0; --j) {
+      input_offset += (remainder % expected_shape[j - 1]) * input_strides[static_cast<size_t>(perm[j - 1])];
+      remainder /= expected_shape[j - 1];
+    }
+    expected_vals[static_cast<size_t>(i)] = input_vals[static_cast<size_t>(input_offset)];
+  }
+
+  TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, {kTensorrtExecutionProvider});
+}
+
+// The innermost axes of the input and the output are both longer than a tile, with other axes in between.
+TEST(TransposeOpTest, HighRankTiled) {
+  TransposeTestWithReference({2, 1, 17, 3, 18, 20}, {5, 0, 3, 2, 1, 4});
+}
+
+// Axes which stay next to each other, and axes of size 1, are merged before transposing.
+TEST(TransposeOpTest, HighRankCoalesced) {
+  TransposeTestWithReference({4, 5, 6, 7, 8}, {3, 4, 0, 1, 2});
+  TransposeTestWithReference({3, 1, 4, 5, 1, 6}, {4, 3, 0, 1, 5, 2});
+  TransposeTestWithReference({2, 3, 4, 5, 6, 7}, {1, 2, 0, 5, 3, 4});
+}
+
 TEST(TransposeOpTest, DoTransposeImpl) {
   std::vector<int64_t> input_shape({5, 2, 1, 3});
   std::vector<float> input_vals(30);
@@ -864,5 +912,27 @@ TEST(TransposeOpTest, TransposeBigMLFloat16) {  // Exercises CanUse_cublasTransp
 }
 #endif  // defined(USE_CUDA) || defined(USE_ROCM)
 
+#ifdef ENABLE_STRIDED_TENSORS
+TEST(TransposeOpTest, Strided) {
+  // The output is a view of the input.
+  {
+    KernelComputeTester test("Transpose");
+    test.AddAttribute("perm", std::vector<int64_t>{1, 0});
+    test.AddInput<float>("X", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.AddOutput<float>("Y", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, {1, 3});
+    test.Run({0});
+  }
+
+  // A strided input is copied in the permuted order.
+  {
+    KernelComputeTester test("Transpose");
+    test.AddAttribute("perm", std::vector<int64_t>{1, 0});
+    test.AddInput<float>("X", {2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, {1, 2});
+    test.AddOutput<float>("Y", {3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+    test.Run();
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -137,6 +139,27 @@ TEST(Unique, Flatten_Sorted_String) {
                              inverse_indices_dims, inverse_indices, counts_dims, counts);
 }
 
+TEST(Unique, Flatten_Sorted_NaN) {
+  // the NaNs are a single unique value which sorts last
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<int64_t> X_dims{2, 3};
+  const std::vector<float> X{1.f, nan, 1.f, 2.f, nan, 0.f};
+  const int64_t* axis = nullptr;
+  bool sorted = true;
+  const std::vector<int64_t> Y_dims{4};
+  const std::vector<float> Y{0.f, 1.f, 2.f, nan};
+
+  const std::vector<int64_t> indices_dims{4};
+  const std::vector<int64_t> indices{5, 0, 3, 1};
+  const std::vector<int64_t> inverse_indices_dims{6};
+  const std::vector<int64_t> inverse_indices{1, 3, 1, 2, 3, 0};
+  const std::vector<int64_t> counts_dims{4};
+  const std::vector<int64_t> counts{1, 2, 1, 2};
+
+  RunUniqueTest<float>(X_dims, X, axis, sorted, Y_dims, Y, indices_dims, indices,
+                       inverse_indices_dims, inverse_indices, counts_dims, counts);
+}
+
 TEST(Unique, NoOptionalOutput) {
   const std::vector<int64_t> X_dims{2, 4};
   const std::vector<int8_t> X{1, 4, -1, 2, 2, 0, -1, 4};
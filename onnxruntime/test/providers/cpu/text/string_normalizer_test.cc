@@ -211,6 +211,22 @@ TEST(ContribOpTest, StringNormalizerSensitiveFilterOutUpperEmptyCase) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(ContribOpTest, StringNormalizerLowerAsciiAndNonAscii) {
+  // - casesensitive approach
+  // - no stopwords
+  // - LOWER changes the case of ASCII strings without the locale, the non ASCII
+  //   characters may be after the first 8 bytes.
+  OpTester test("StringNormalizer", opset_ver, domain);
+  InitTestAttr(test, "LOWER", true, {}, test_locale);
+  std::vector<int64_t> dims{5};
+  std::vector<std::string> input = {"MONDAY", "Mixed Case 123!@[`{", "ABCDEFGHÉCOLE", "", "École"};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<std::string> output = {"monday", "mixed case 123!@[`{", "abcdefghécole", "", "école"};
+  test.AddOutput<std::string>("Y", dims, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 // Fails on iOS because necessary locales are not installed
 // MacOS runs fine.
 #ifndef ORT_IOS
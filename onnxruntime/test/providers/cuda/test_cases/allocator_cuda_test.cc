@@ -1,10 +1,14 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <limits>
+#include <vector>
+
 #include "core/framework/allocator_utils.h"
 #include "gtest/gtest.h"
 #include "cuda_runtime.h"
 #include "core/framework/allocator.h"
+#include "core/framework/stream_handles.h"
 #include "core/providers/cuda/cuda_allocator.h"
 #include "core/providers/cuda/cuda_common.h"
 
@@ -113,5 +117,89 @@ TEST(AllocatorTest, CUDAAllocatorFallbackTest) {
   auto last_error = cudaGetLastError();
   EXPECT_EQ(last_error, cudaSuccess) << "Last error should be cleared if handled gracefully";
 }
+
+// allocations without a stream are usable once Alloc returns, and are accounted until they are freed
+TEST(AllocatorTest, CUDAMemPoolAllocatorTest) {
+  CUDA_CALL_THROW(cudaSetDevice(0));
+  CUDAMemPoolAllocator allocator(0, CUDA, 0, 1 << 20);
+  EXPECT_TRUE(allocator.IsStreamAware());
+
+  const std::vector<int> values(1024, 7);
+  void* p = allocator.Alloc(values.size() * sizeof(int));
+  ASSERT_NE(p, nullptr);
+  CUDA_CALL_THROW(cudaMemcpy(p, values.data(), values.size() * sizeof(int), cudaMemcpyHostToDevice));
+  std::vector<int> copied(values.size());
+  CUDA_CALL_THROW(cudaMemcpy(copied.data(), p, values.size() * sizeof(int), cudaMemcpyDeviceToHost));
+  EXPECT_EQ(copied, values);
+
+  AllocatorStats stats;
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, static_cast<int64_t>(values.size() * sizeof(int)));
+  EXPECT_EQ(stats.num_allocs, 1);
+  EXPECT_EQ(stats.bytes_limit, 1 << 20);
+
+  // the limit applies to the bytes in use
+  EXPECT_ANY_THROW(allocator.Alloc(1 << 20));
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, static_cast<int64_t>(values.size() * sizeof(int)));
+
+  allocator.Free(p);
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(allocator.Alloc(0), nullptr);
+  EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+}
+
+// Allocations ordered on a stream are freed on it, so a block freed behind the kernels of the stream is reused by
+// the next allocation on it, and the allocations are freed without the stream once it is released.
+TEST(AllocatorTest, CUDAMemPoolAllocatorStreamTest) {
+  CUDA_CALL_THROW(cudaSetDevice(0));
+  CUDAMemPoolAllocator allocator(0, CUDA, 0, std::numeric_limits<size_t>::max());
+  cudaStream_t cuda_stream;
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+  Stream stream(cuda_stream, OrtDevice(OrtDevice::GPU, OrtDevice::MemType::DEFAULT, 0));
+
+  constexpr size_t size = 1 << 20;
+  void* first = allocator.AllocWithStream(size, &stream);
+  ASSERT_NE(first, nullptr);
+  CUDA_CALL_THROW(cudaMemsetAsync(first, 1, size, cuda_stream));
+  allocator.Free(first);
+
+  void* second = allocator.AllocWithStream(size, &stream);
+  ASSERT_NE(second, nullptr);
+  CUDA_CALL_THROW(cudaMemsetAsync(second, 2, size, cuda_stream));
+  std::vector<char> copied(size);
+  CUDA_CALL_THROW(cudaMemcpyAsync(copied.data(), second, size, cudaMemcpyDeviceToHost, cuda_stream));
+  CUDA_CALL_THROW(cudaStreamSynchronize(cuda_stream));
+  EXPECT_EQ(copied, std::vector<char>(size, 2));
+
+  allocator.ReleaseStream(&stream);
+  CUDA_CALL_THROW(cudaStreamDestroy(cuda_stream));
+  allocator.Free(second);
+
+  AllocatorStats stats;
+  allocator.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_allocs, 2);
+  EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+}
+
+// an allocation which isn't ordered on a stream is only freed once the kernels of the other streams using it are done
+TEST(AllocatorTest, CUDAMemPoolAllocatorUnorderedFreeTest) {
+  CUDA_CALL_THROW(cudaSetDevice(0));
+  CUDAMemPoolAllocator allocator(0, CUDA, 0, std::numeric_limits<size_t>::max());
+  cudaStream_t cuda_stream;
+  CUDA_CALL_THROW(cudaStreamCreateWithFlags(&cuda_stream, cudaStreamNonBlocking));
+
+  constexpr size_t size = 64 << 20;
+  void* p = allocator.Alloc(size);
+  ASSERT_NE(p, nullptr);
+  CUDA_CALL_THROW(cudaMemsetAsync(p, 3, size, cuda_stream));
+  allocator.Free(p);
+  EXPECT_EQ(cudaStreamQuery(cuda_stream), cudaSuccess);
+
+  CUDA_CALL_THROW(cudaStreamDestroy(cuda_stream));
+  EXPECT_EQ(cudaGetLastError(), cudaSuccess);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/shared_library/provider_api.h"
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "cuda_runtime.h"
+#include "core/providers/cuda/cuda_allocator.h"
+#include "core/providers/cuda/cuda_common.h"
+#include "core/providers/cuda/gpu_data_transfer.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+std::vector<float> CopyToHost(const Tensor& tensor) {
+  std::vector<float> values(tensor.Shape().Size());
+  CUDA_CALL_THROW(cudaMemcpy(values.data(), tensor.DataRaw(), tensor.SizeInBytes(), cudaMemcpyDeviceToHost));
+  return values;
+}
+}  // namespace
+
+// Batches of pageable host to GPU copies spanning several staging buffers, including a tensor larger than a
+// staging buffer, are uploaded through the staging buffers allocated by the first batch.
+TEST(GPUDataTransferTest, CopyTensorsFromPageableHostMemory) {
+  CUDA_CALL_THROW(cudaSetDevice(0));
+  auto cpu_allocator = std::make_shared<CPUAllocator>();
+  auto cuda_allocator = std::make_shared<CUDAAllocator>(0, CUDA);
+  GPUDataTransfer data_transfer;
+
+  // 20M floats exceed the 16 MB staging buffers, 1000 floats leave the next upload unaligned
+  const std::vector<int64_t> sizes{1000, 20 * 1024 * 1024 / 4, 3, 2 * 1024 * 1024, 1};
+  for (int batch = 0; batch < 2; ++batch) {
+    std::vector<std::unique_ptr<Tensor>> sources;
+    std::vector<std::unique_ptr<Tensor>> destinations;
+    std::vector<IDataTransfer::SrcDstPair> pairs;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      sources.push_back(Tensor::Create(DataTypeImpl::GetType<float>(), TensorShape({sizes[i]}), cpu_allocator));
+      float* data = sources.back()->MutableData<float>();
+      std::iota(data, data + sizes[i], static_cast<float>(batch * 100 + i));
+      destinations.push_back(Tensor::Create(DataTypeImpl::GetType<float>(), TensorShape({sizes[i]}),
+                                            cuda_allocator));
+      pairs.push_back({*sources.back(), *destinations.back(), nullptr});
+    }
+
+    ASSERT_TRUE(data_transfer.CopyTensors(pairs).IsOK());
+
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      const std::vector<float> values = CopyToHost(*destinations[i]);
+      const float* expected = sources[i]->Data<float>();
+      ASSERT_EQ(values, std::vector<float>(expected, expected + sizes[i])) << "batch " << batch << ", tensor " << i;
+    }
+  }
+}
+
+// GPU to host copies of a batch are synchronized once at the end of the batch.
+TEST(GPUDataTransferTest, CopyTensorsToHost) {
+  CUDA_CALL_THROW(cudaSetDevice(0));
+  auto cpu_allocator = std::make_shared<CPUAllocator>();
+  auto cuda_allocator = std::make_shared<CUDAAllocator>(0, CUDA);
+  GPUDataTransfer data_transfer;
+
+  constexpr int64_t size = 4096;
+  std::vector<float> expected(size);
+  std::iota(expected.begin(), expected.end(), 1.0f);
+  auto gpu_tensor = Tensor::Create(DataTypeImpl::GetType<float>(), TensorShape({size}), cuda_allocator);
+  CUDA_CALL_THROW(cudaMemcpy(gpu_tensor->MutableDataRaw(), expected.data(), gpu_tensor->SizeInBytes(),
+                             cudaMemcpyHostToDevice));
+  auto first = Tensor::Create(DataTypeImpl::GetType<float>(), TensorShape({size}), cpu_allocator);
+  auto second = Tensor::Create(DataTypeImpl::GetType<float>(), TensorShape({size}), cpu_allocator);
+
+  ASSERT_TRUE(data_transfer.CopyTensors({{*gpu_tensor, *first, nullptr}, {*gpu_tensor, *second, nullptr}}).IsOK());
+
+  EXPECT_EQ(std::vector<float>(first->Data<float>(), first->Data<float>() + size), expected);
+  EXPECT_EQ(std::vector<float>(second->Data<float>(), second->Data<float>() + size), expected);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
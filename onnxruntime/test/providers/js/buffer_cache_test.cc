@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstdint>
+#include <vector>
+
+#include "core/providers/js/buffer_cache.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+using js::BufferCache;
+
+namespace {
+void* Buffer(size_t i) {
+  return reinterpret_cast<void*>(static_cast<uintptr_t>(i) * 64);
+}
+}  // namespace
+
+TEST(JsBufferCacheTest, ReusesBuffersOfTheSameSize) {
+  std::vector<void*> released;
+  BufferCache cache([&released](void* p) { released.push_back(p); });
+  EXPECT_EQ(cache.Take(16), nullptr);
+
+  cache.Put(Buffer(1), 16, 100);
+  cache.Put(Buffer(2), 32, 100);
+  EXPECT_EQ(cache.CachedBytes(), 48u);
+  EXPECT_EQ(cache.Take(8), nullptr);
+  EXPECT_EQ(cache.Take(16), Buffer(1));
+  EXPECT_EQ(cache.Take(16), nullptr);
+  EXPECT_EQ(cache.CachedBytes(), 32u);
+  EXPECT_TRUE(released.empty());
+}
+
+// Beyond the limit, the least recently cached buffers are released first.
+TEST(JsBufferCacheTest, ReleasesTheLeastRecentlyCachedBuffers) {
+  std::vector<void*> released;
+  BufferCache cache([&released](void* p) { released.push_back(p); });
+
+  cache.Put(Buffer(1), 40, 100);
+  cache.Put(Buffer(2), 30, 100);
+  cache.Put(Buffer(3), 20, 100);
+  EXPECT_TRUE(released.empty());
+
+  cache.Put(Buffer(4), 40, 100);
+  EXPECT_EQ(released, std::vector<void*>{Buffer(1)});
+  EXPECT_EQ(cache.CachedBytes(), 90u);
+
+  // the buffer cached later with the size of the released one is still cached
+  EXPECT_EQ(cache.Take(40), Buffer(4));
+  EXPECT_EQ(cache.Take(40), nullptr);
+  EXPECT_EQ(cache.Take(30), Buffer(2));
+}
+
+TEST(JsBufferCacheTest, Limit) {
+  std::vector<void*> released;
+  BufferCache cache([&released](void* p) { released.push_back(p); });
+
+  // a buffer larger than the limit is not cached
+  cache.Put(Buffer(1), 200, 100);
+  EXPECT_EQ(released, std::vector<void*>{Buffer(1)});
+  EXPECT_EQ(cache.CachedBytes(), 0u);
+
+  cache.Put(Buffer(2), 50, 100);
+  cache.Put(Buffer(3), 50, 100);
+  cache.Trim(60);
+  EXPECT_EQ(released, (std::vector<void*>{Buffer(1), Buffer(2)}));
+  EXPECT_EQ(cache.CachedBytes(), 50u);
+  EXPECT_EQ(cache.Take(50), Buffer(3));
+}
+
+TEST(JsBufferCacheTest, ReleasesTheCachedBuffersOnDestruction) {
+  std::vector<void*> released;
+  {
+    BufferCache cache([&released](void* p) { released.push_back(p); });
+    cache.Put(Buffer(1), 16, 100);
+    cache.Put(Buffer(2), 16, 100);
+    EXPECT_EQ(cache.Take(16), Buffer(2));
+  }
+  EXPECT_EQ(released, std::vector<void*>{Buffer(1)});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
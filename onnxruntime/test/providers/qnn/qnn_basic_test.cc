@@ -677,6 +677,62 @@ TEST_F(QnnHTPBackendTests, MultithreadHtpPowerCfgSessionRunOption) {
   }
 }
 
+// Tests running two sessions in multiple threads on the HTP backend, voting burst mode for the runs and power saver
+// mode once the threads are idle
+TEST_F(QnnHTPBackendTests, MultithreadHtpPowerCfgPostRunIdleTimeout) {
+  std::unique_ptr<ModelAndBuilder> model;
+  std::vector<float> input_data = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> shape = {1, 3, 2};
+  std::vector<std::vector<int64_t>> output_shapes = {shape};
+  std::vector<std::vector<float>> output_values = {{3.0f, 6.0f, 9.0f, 12.0f, 15.0f, 18.0f}};
+
+  CreateModelInMemory(model,
+                      QDQBuildAdd3Tensors<uint8_t>(TestInputDef<float>(shape, false, input_data),
+                                                   TestInputDef<float>(shape, false, input_data),
+                                                   TestInputDef<float>(shape, false, input_data)),
+                      "add3.qdq");
+
+  onnxruntime::ProviderOptions options;
+#if defined(_WIN32)
+  options["backend_path"] = "QnnHtp.dll";
+#else
+  options["backend_path"] = "libQnnHtp.so";
+#endif
+
+  constexpr int num_sessions = 2;
+  std::vector<std::unique_ptr<InferenceSession>> sessions;
+  for (int i = 0; i < num_sessions; ++i) {
+    SessionOptions session_opts;
+    session_opts.session_logid = "logger" + std::to_string(i);
+    auto session_obj = std::make_unique<InferenceSession>(session_opts, GetEnvironment());
+    EXPECT_TRUE(session_obj->RegisterExecutionProvider(QnnExecutionProviderWithOptions(options, &session_opts)).IsOK());
+    ASSERT_TRUE(session_obj->Load(model->model_data.data(), static_cast<int>(model->model_data.size())).IsOK());
+    ASSERT_TRUE(session_obj->Initialize().IsOK());
+    sessions.push_back(std::move(session_obj));
+  }
+
+  RunOptions run_opts;
+  ASSERT_TRUE(run_opts.config_options.AddConfigEntry(kOrtRunOptionsConfigQnnPerfMode, "burst").IsOK());
+  ASSERT_TRUE(run_opts.config_options.AddConfigEntry(kOrtRunOptionsConfigQnnPerfModePostRun, "power_saver").IsOK());
+  ASSERT_TRUE(run_opts.config_options.AddConfigEntry(kOrtRunOptionsConfigQnnPerfModePostRunIdleTimeout, "5").IsOK());
+
+  std::vector<std::thread> threads;
+  constexpr int num_threads = 4;
+  constexpr int loop_count = 10;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(std::thread(RunSessionAndVerify, std::ref(*sessions[i % num_sessions]), run_opts,
+                                  model->builder.feeds_, model->builder.output_names_,
+                                  output_shapes, output_values, loop_count));
+  }
+
+  for (auto& th : threads) {
+    th.join();
+  }
+
+  // let the idle votes of some threads be made and release the sessions with the others pending
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+}
+
 // Tests running a single session in multiple threads on the HTP backend with EP option to set default power config
 TEST_F(QnnHTPBackendTests, MultithreadDefaultHtpPowerCfgFromEpOption) {
   std::unique_ptr<ModelAndBuilder> model;
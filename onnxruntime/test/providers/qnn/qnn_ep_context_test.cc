@@ -801,6 +801,66 @@ TEST_F(QnnHTPBackendTests, QnnMultiContextExternal) {
   Ort::Session session(*ort_env, ORT_TSTR("testdata/qnn_ctx/qnn_multi_ctx_external.onnx"), so);
 }
 
+// Two sessions sharing the EP contexts generate their EP context models into one QNN context, so the context binary
+// of the second model holds the graphs of both. Loading it keeps the graph of the first model, which is then used by
+// the session of the first model instead of loading its context binary again.
+TEST_F(QnnHTPBackendTests, QnnContextShareAcrossSessions) {
+  ProviderOptions provider_options;
+#if defined(_WIN32)
+  provider_options["backend_path"] = "QnnHtp.dll";
+#else
+  provider_options["backend_path"] = "libQnnHtp.so";
+#endif
+
+  const std::unordered_map<std::string, int> domain_to_version = {{"", 13}, {kMSDomain, 1}};
+  auto& logging_manager = DefaultLoggingManager();
+  logging_manager.SetDefaultLoggerSeverity(logging::Severity::kERROR);
+
+  onnxruntime::Model model("QNN_EP_TestModel", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), domain_to_version, {},
+                           logging_manager.DefaultLogger());
+  Graph& graph = model.MainGraph();
+  ModelTestBuilder helper(graph);
+  BuildCastAddTestCase()(helper);
+  helper.SetGraphOutputs();
+  ASSERT_STATUS_OK(model.MainGraph().Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  const auto model_data_span = AsByteSpan(model_data.data(), model_data.size());
+
+  const std::vector<std::string> context_model_files = {"./qnn_ctx_share_test_1.onnx", "./qnn_ctx_share_test_2.onnx"};
+  {
+    std::vector<Ort::Session> sessions;
+    for (size_t i = 0; i < context_model_files.size(); ++i) {
+      std::remove(context_model_files[i].c_str());
+      Ort::SessionOptions so;
+      so.AddConfigEntry(kOrtSessionOptionEpContextEnable, "1");
+      so.AddConfigEntry(kOrtSessionOptionEpContextFilePath, context_model_files[i].c_str());
+      so.AddConfigEntry(kOrtSessionOptionEpContextNodeNamePrefix, ("share_" + std::to_string(i)).c_str());
+      so.AddConfigEntry(kOrtSessionOptionShareEpContexts, "1");
+      so.AppendExecutionProvider("QNN", provider_options);
+      sessions.emplace_back(*ort_env, model_data_span.data(), model_data_span.size(), so);
+      ASSERT_TRUE(std::filesystem::exists(context_model_files[i].c_str()));
+    }
+  }
+
+  {
+    std::vector<Ort::Session> sessions;
+    for (auto it = context_model_files.rbegin(); it != context_model_files.rend(); ++it) {
+      Ort::SessionOptions so;
+      so.AddConfigEntry(kOrtSessionOptionShareEpContexts, "1");
+      so.AppendExecutionProvider("QNN", provider_options);
+      sessions.emplace_back(*ort_env, ToPathString(*it).c_str(), so);
+    }
+  }
+
+  // clean up
+  for (const auto& context_model_file : context_model_files) {
+    ASSERT_EQ(std::remove(context_model_file.c_str()), 0);
+  }
+}
+
 #endif  // defined(__aarch64__) || defined(_M_ARM64) || defined(__linux__)
 
 }  // namespace test
@@ -389,6 +389,25 @@ TEST(XnnpackEP, TestQDQSoftMax_axisLast) {
                {ExpectedEPNodeAssignment::All});
 }
 
+#if !defined(DISABLE_CONTRIB_OPS)
+TEST(XnnpackEP, TestDynamicQuantizeMatMul) {
+  auto modelBuilder = [](ModelTestBuilder& builder) {
+    auto* input_arg = builder.MakeInput<float>({2, 5, 16}, -1.f, 1.f);
+    auto* weight_arg = builder.MakeInitializer<int8_t>({16, 8}, -127, 127);
+    auto* scale_arg = builder.Make1DInitializer<float>({0.01f, 0.02f, 0.01f, 0.02f, 0.01f, 0.02f, 0.01f, 0.02f});
+    auto* zero_point_arg = builder.MakeScalarInitializer<int8_t>(0);
+    auto* bias_arg = builder.MakeInitializer<float>({8}, -1.f, 1.f);
+    auto* output_arg = builder.MakeOutput();
+
+    builder.AddNode("DynamicQuantizeMatMul", {input_arg, weight_arg, scale_arg, zero_point_arg, bias_arg},
+                    {output_arg}, kMSDomain);
+  };
+  // A is quantized per row rather than per tensor as on the CPU
+  RunModelTest(modelBuilder, "xnnpack_test_graph_dynamic_quantize_matmul",
+               {ExpectedEPNodeAssignment::All, 0.2f /* fp32_abs_err */});
+}
+#endif
+
 TEST(XnnpackEP, TestConvTranspose) {
   // Conv+ConvTranspose with attributes of Group and Dilation
   const ORTCHAR_T* ort_model_path = ORT_MODEL_FOLDER "test_conv_follow_convtrans.onnx";
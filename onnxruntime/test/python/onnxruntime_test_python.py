@@ -0,0 +1,129 @@
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License.
+
+# -*- coding: UTF-8 -*-
+import unittest
+
+import numpy as np
+from onnx import TensorProto, helper
+
+import onnxruntime as onnxrt
+from onnxruntime.capi import _pybind_state as C
+
+try:
+    import pyarrow as pa
+except ImportError:
+    pa = None
+
+
+def make_add_model(dims):
+    # Z = X + Y, X and Y being float tensors of the given dims
+    graph = helper.make_graph(
+        [helper.make_node("Add", ["X", "Y"], ["Z"])],
+        "add",
+        [
+            helper.make_tensor_value_info("X", TensorProto.FLOAT, dims),
+            helper.make_tensor_value_info("Y", TensorProto.FLOAT, dims),
+        ],
+        [helper.make_tensor_value_info("Z", TensorProto.FLOAT, dims)],
+    )
+    return helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)]).SerializeToString()
+
+
+class DlpackOnly:
+    # Exposes an array through the __dlpack__ protocol only, so that it is not fed as a numpy array.
+    def __init__(self, array):
+        self.array = array
+
+    def __dlpack__(self, stream=None):
+        return self.array.__dlpack__()
+
+    def __dlpack_device__(self):
+        return self.array.__dlpack_device__()
+
+
+class TestInferenceSession(unittest.TestCase):
+    def test_run_model_with_output_buffers(self):
+        sess = onnxrt.InferenceSession(make_add_model([2, 3]), providers=["CPUExecutionProvider"])
+        x = np.arange(6, dtype=np.float32).reshape(2, 3)
+        y = np.ones((2, 3), dtype=np.float32)
+
+        z = np.zeros((2, 3), dtype=np.float32)
+        res = sess.run(["Z"], {"X": x, "Y": y}, output_buffers={"Z": z})
+        self.assertIs(res[0], z)
+        np.testing.assert_allclose(z, x + y)
+
+        z_ortvalue = onnxrt.OrtValue.ortvalue_from_numpy(np.zeros((2, 3), dtype=np.float32))
+        res = sess.run(["Z"], {"X": x, "Y": y}, output_buffers={"Z": z_ortvalue})
+        self.assertIs(res[0], z_ortvalue)
+        np.testing.assert_allclose(z_ortvalue.numpy(), x + y)
+
+        # the output is written in place, so a buffer that would be copied is rejected
+        with self.assertRaises(RuntimeError):
+            sess.run(["Z"], {"X": x, "Y": y}, output_buffers={"Z": np.zeros((3, 2), dtype=np.float32).T})
+        read_only = np.zeros((2, 3), dtype=np.float32)
+        read_only.flags.writeable = False
+        with self.assertRaises(RuntimeError):
+            sess.run(["Z"], {"X": x, "Y": y}, output_buffers={"Z": read_only})
+
+    def test_io_binding_state(self):
+        sess = onnxrt.InferenceSession(make_add_model([2, 3]), providers=["CPUExecutionProvider"])
+        x = np.arange(6, dtype=np.float32).reshape(2, 3)
+        initial_value = onnxrt.OrtValue.ortvalue_from_numpy(x.copy())
+
+        # Z = X + Y is fed back as X, Y being the same at each run
+        io_binding = sess.io_binding()
+        io_binding.bind_state("X", "Z", initial_value)
+        io_binding.bind_cpu_input("Y", np.ones((2, 3), dtype=np.float32))
+        for run in range(1, 4):
+            sess.run_with_iobinding(io_binding)
+            outputs = io_binding.get_outputs()
+            self.assertEqual(len(outputs), 1)
+            np.testing.assert_allclose(outputs[0].numpy(), x + run)
+
+        # the initial value is not written to
+        np.testing.assert_allclose(initial_value.numpy(), x)
+
+    @unittest.skipIf(not hasattr(C.OrtValue, "from_dlpack"), "not built with DLPack")
+    @unittest.skipIf(not hasattr(np.ndarray, "__dlpack__"), "numpy does not implement __dlpack__")
+    def test_run_model_with_dlpack_feeds(self):
+        sess = onnxrt.InferenceSession(make_add_model([2, 3]), providers=["CPUExecutionProvider"])
+        x = np.arange(6, dtype=np.float32).reshape(2, 3)
+        y = np.full((2, 3), 2.0, dtype=np.float32)
+        res = sess.run(["Z"], {"X": DlpackOnly(x), "Y": DlpackOnly(y)})
+        np.testing.assert_allclose(res[0], x + y)
+
+        # the output is written into the memory of a DLPack buffer
+        z = np.zeros((2, 3), dtype=np.float32)
+        res = sess.run(["Z"], {"X": DlpackOnly(x), "Y": y}, output_buffers={"Z": DlpackOnly(z)})
+        np.testing.assert_allclose(z, x + y)
+
+    @unittest.skipIf(pa is None, "pyarrow is not installed")
+    def test_run_model_with_arrow_feeds(self):
+        sess = onnxrt.InferenceSession(make_add_model(["N"]), providers=["CPUExecutionProvider"])
+        x = pa.array([1.0, 2.0, 3.0], type=pa.float32())
+        y = pa.array([0.5, 0.5, 0.5], type=pa.float32())
+        res = sess.run(["Z"], {"X": x, "Y": y})
+        np.testing.assert_allclose(res[0], np.array([1.5, 2.5, 3.5], dtype=np.float32))
+
+        # an offset slice is fed from its first value
+        res = sess.run(["Z"], {"X": x.slice(1), "Y": y.slice(1)})
+        np.testing.assert_allclose(res[0], np.array([2.5, 3.5], dtype=np.float32))
+
+        # a primitive array is a column of a rank 2 input
+        sess_2d = onnxrt.InferenceSession(make_add_model(["N", 1]), providers=["CPUExecutionProvider"])
+        res = sess_2d.run(["Z"], {"X": x, "Y": y})
+        np.testing.assert_allclose(res[0], np.array([[1.5], [2.5], [3.5]], dtype=np.float32))
+
+        # a fixed size list array is a matrix
+        sess_matrix = onnxrt.InferenceSession(make_add_model(["N", 2]), providers=["CPUExecutionProvider"])
+        matrix = pa.FixedSizeListArray.from_arrays(pa.array([1.0, 2.0, 3.0, 4.0], type=pa.float32()), 2)
+        res = sess_matrix.run(["Z"], {"X": matrix, "Y": matrix})
+        np.testing.assert_allclose(res[0], np.array([[2.0, 4.0], [6.0, 8.0]], dtype=np.float32))
+
+        with self.assertRaises(RuntimeError):
+            sess.run(["Z"], {"X": pa.array([1.0, None, 3.0], type=pa.float32()), "Y": y})
+
+
+if __name__ == "__main__":
+    unittest.main(verbosity=1)
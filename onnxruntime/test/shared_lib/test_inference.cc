@@ -2072,6 +2072,41 @@ TEST(CApiTest, io_binding) {
   binding.ClearBoundOutputs();
 }
 
+TEST(CApiTest, io_binding_state) {
+  Ort::SessionOptions session_options;
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+  const std::array<int64_t, 2> x_shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value initial_x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(),
+                                                  x_shape.data(), x_shape.size());
+
+  Ort::IoBinding binding(session);
+  binding.BindState("X", "Y", initial_x);
+
+  // the output of each run is the input of the next one, the expected values are computed with plain runs
+  std::vector<float> expected(x_values.begin(), x_values.end());
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  for (int run = 0; run < 3; ++run) {
+    Ort::Value x = Ort::Value::CreateTensor(info_cpu, expected.data(), expected.size(), x_shape.data(), x_shape.size());
+    auto y = session.Run(Ort::RunOptions{}, input_names, &x, 1, output_names, 1);
+    const float* y_values = y[0].GetTensorData<float>();
+    expected.assign(y_values, y_values + expected.size());
+
+    session.Run(Ort::RunOptions(), binding);
+    std::vector<Ort::Value> output_values = binding.GetOutputValues();
+    ASSERT_EQ(output_values.size(), 1U);
+    ASSERT_EQ(output_values[0].GetTensorTypeAndShapeInfo().GetElementCount(), expected.size());
+    const float* values = output_values[0].GetTensorData<float>();
+    ASSERT_TRUE(std::equal(expected.begin(), expected.end(), values));
+  }
+
+  // the initial value is not written to
+  ASSERT_EQ(x_values, (std::array<float, 3 * 2>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+}
+
 #if defined(USE_CUDA) || defined(USE_TENSORRT)
 TEST(CApiTest, io_binding_cuda) {
   Ort::SessionOptions session_options;
@@ -4377,6 +4412,57 @@ TEST(CApiTest, RunAsync) {
   EXPECT_EQ(atomic_wait.load(), true);
 }
 
+void CallbackOnDispatchingThread(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status_ptr) {
+  EXPECT_EQ(*(reinterpret_cast<std::thread::id*>(user_data)), std::this_thread::get_id());
+  Ort::Status status(status_ptr);
+  EXPECT_TRUE(status.IsOK());
+  EXPECT_EQ(num_outputs, 1UL);
+  Ort::Value output_value(outputs[0]);
+  EXPECT_EQ(output_value.At<float>({1, 0}), 9.f);
+  output_value.release();
+}
+
+TEST(CApiTest, RunAsyncCompletionQueue) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(2);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  const char* input_names[] = {"X"};
+  float x_value[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  int64_t x_dim[] = {3, 2};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+  Ort::Value input_tensors[1] = {
+      Ort::Value::CreateTensor<float>(memory_info, x_value, 6, x_dim, 2),
+  };
+  const char* output_names[] = {"Y"};
+
+  Ort::RunCompletionQueue queue;
+#ifdef __linux__
+  EXPECT_GE(queue.GetFd(), 0);
+#endif
+  Ort::RunOptions run_options;
+  run_options.SetCompletionQueue(queue);
+
+  constexpr size_t num_runs = 8;
+  std::vector<Ort::Value> output_values;
+  for (size_t i = 0; i < num_runs; ++i) {
+    output_values.emplace_back(nullptr);
+  }
+  std::thread::id dispatching_tid = std::this_thread::get_id();
+  for (size_t i = 0; i < num_runs; ++i) {
+    EXPECT_NO_THROW(session.RunAsync(run_options, input_names, input_tensors, 1, output_names,
+                                     &output_values[i], 1,
+                                     CallbackOnDispatchingThread, &dispatching_tid));
+  }
+
+  size_t num_dispatched = 0;
+  // timeout in about 10 secs
+  for (int i = 0; i < 100 && num_dispatched < num_runs; ++i) {
+    num_dispatched += queue.Dispatch(100);
+  }
+  EXPECT_EQ(num_dispatched, num_runs);
+}
+
 void CallbackFail(void*, OrtValue**, size_t, OrtStatusPtr) {
   EXPECT_TRUE(false);  // the callback is not supposed to be invoked
 }
@@ -157,6 +157,41 @@ TEST(CApiTest, CreateGetVectorOfMapsStringFloat) {  // support zipmap output typ
               std::set<float>(std::begin(values), std::end(values)));
   }
 }
+
+TEST(CApiTest, GetVectorOfMapsInt64FloatAsColumns) {
+  auto default_allocator = std::make_unique<MockedOrtAllocator>();
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+
+  // maps of different sizes, with the keys out of order
+  std::vector<std::vector<int64_t>> keys{{3, 1}, {2, 0, 5}};
+  std::vector<std::vector<float>> values{{3.0f, 1.0f}, {2.0f, 0.0f, 5.0f}};
+  std::vector<Ort::Value> in;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    std::vector<int64_t> dims = {static_cast<int64_t>(keys[i].size())};
+    Ort::Value keys_tensor = Ort::Value::CreateTensor(info, keys[i].data(), keys[i].size() * sizeof(int64_t),
+                                                      dims.data(), dims.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64);
+    Ort::Value values_tensor = Ort::Value::CreateTensor(info, values[i].data(), values[i].size() * sizeof(float),
+                                                        dims.data(), dims.size(), ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT);
+    in.emplace_back(Ort::Value::CreateMap(keys_tensor, values_tensor));
+  }
+  Ort::Value seq_ort = Ort::Value::CreateSequence(in);
+
+  Ort::Value keys_ort{nullptr};
+  Ort::Value values_ort{nullptr};
+  Ort::Value offsets_ort{nullptr};
+  seq_ort.GetSequenceOfMapsAsColumns(default_allocator.get(), keys_ort, values_ort, offsets_ort);
+
+  ASSERT_EQ(keys_ort.GetTensorTypeAndShapeInfo().GetShape(), std::vector<int64_t>{5});
+  ASSERT_EQ(values_ort.GetTensorTypeAndShapeInfo().GetShape(), std::vector<int64_t>{5});
+  ASSERT_EQ(offsets_ort.GetTensorTypeAndShapeInfo().GetShape(), std::vector<int64_t>{3});
+
+  const int64_t* keys_ret = keys_ort.GetTensorData<int64_t>();
+  const float* values_ret = values_ort.GetTensorData<float>();
+  const int64_t* offsets_ret = offsets_ort.GetTensorData<int64_t>();
+  EXPECT_EQ(std::vector<int64_t>(keys_ret, keys_ret + 5), (std::vector<int64_t>{1, 3, 0, 2, 5}));
+  EXPECT_EQ(std::vector<float>(values_ret, values_ret + 5), (std::vector<float>{1.0f, 3.0f, 0.0f, 2.0f, 5.0f}));
+  EXPECT_EQ(std::vector<int64_t>(offsets_ret, offsets_ret + 3), (std::vector<int64_t>{0, 2, 5}));
+}
 #endif  // !defined(DISABLE_ML_OPS)
 
 TEST(CApiTest, TypeInfoMap) {
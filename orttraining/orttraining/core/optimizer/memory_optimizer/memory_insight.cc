@@ -17,6 +17,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
 #include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/transformer_specific.h"
 
 namespace onnxruntime::optimizer::memory_optimizer {
@@ -248,6 +249,13 @@ Status FindORTModuleMemoryOpportunity(const GraphViewer& graph_viewer,
         memory_opt_planner.AddNodeOptimizationPlan(p_node, std::move(recompute_with_compromise_plan));
       }
     }
+
+    if (probe_config.enable_offload) {
+      std::unique_ptr<NodeOffloadPlan> offload_plan = CheckNodeForOffload(*p_node, candidate_output_args_map, logger);
+      if (offload_plan != nullptr) {
+        memory_opt_planner.AddNodeOptimizationPlan(p_node, std::move(offload_plan));
+      }
+    }
   }
 
   return Status::OK();
@@ -299,6 +307,8 @@ void GetMemoryRecordsGroupedByNodeClusterId(const MemoryOptimizationPlanner& mem
             dynamic_cast<NodeRecomputePlan*>(plan.get())->GetNodesInTopoOrderStr();
       } else if (plan->GetOptimizationType() == OptimizationType::Recompute) {
         record.recompute_subgraph_str = dynamic_cast<NodeRecomputePlan*>(plan.get())->GetNodesInTopoOrderStr();
+      } else if (plan->GetOptimizationType() == OptimizationType::Offload) {
+        record.offload_subgraph_str = plan->GetClusterId();
       }
 
       gsl::span<const size_t> output_indices = plan->GetActivationOutputIndices();
@@ -324,6 +334,11 @@ void GetMemoryRecordsGroupedByNodeClusterId(const MemoryOptimizationPlanner& mem
                                                  plan->GetActivationOutputDimParamString(output_index),
                                                  byte_count_per_element,
                                                  plan->GetSaveRatio());
+        } else if (plan->GetOptimizationType() == OptimizationType::Offload) {
+          record.offloaded_outputs.emplace_back(output_index,
+                                                plan->GetActivationOutputDimParamString(output_index),
+                                                byte_count_per_element,
+                                                plan->GetSaveRatio());
         }
       }
     }
@@ -370,6 +385,9 @@ void GetMemoryRecordsGroupedByNodeClusterId(const MemoryOptimizationPlanner& mem
         node_cluster_id_to_record_map[node_cluster_id]->actual_recompute_with_compromise_count += 1;
         node_cluster_id_to_record_map[node_cluster_id]->request_recompute_with_compromise_count =
             apply_context->requested_count;
+      } else if (apply_context->type == OptimizationType::Offload) {
+        node_cluster_id_to_record_map[node_cluster_id]->actual_offload_count += 1;
+        node_cluster_id_to_record_map[node_cluster_id]->request_offload_count = apply_context->requested_count;
       } else {
         ORT_THROW("Unsupported optimization type found.");
       }
@@ -637,6 +655,37 @@ void FormatRecomputeMemoryRecords(int option_index,
                    "% saved");
   }
 }
+
+void FormatOffloadMemoryRecords(int option_index,
+                                const MemoryRecord& record,
+                                InlinedVector<std::string>& rows) {
+  const std::string empty_first_col = "|" + ToFixedLengthString(std::string(), kFirstColumnWidth) + "|";
+
+  rows.push_back(empty_first_col);
+  rows.push_back(empty_first_col +
+                 ToFixedLengthString(">>Option " + std::to_string(option_index), kTitleWidthInSecondColumn) + ": " +
+                 OptimizationTypeToString(OptimizationType::Offload) + " subgraph " + record.offload_subgraph_str);
+
+  if (record.request_offload_count) {
+    rows.push_back(
+        empty_first_col +
+        ToFixedLengthString("  Status", kTitleWidthInSecondColumn) + ": " + "Enabled, requested count=" +
+        std::to_string(record.request_offload_count) +
+        ", actual applied count=" + std::to_string(record.actual_offload_count));
+  } else {
+    rows.push_back(empty_first_col + ToFixedLengthString("  Status", kTitleWidthInSecondColumn) +
+                   ": Disabled.");
+  }
+
+  rows.push_back(empty_first_col + "  Stashed Activations: ");
+  for (const auto& stat : record.offloaded_outputs) {
+    rows.push_back(empty_first_col +
+                   ToFixedLengthString("   - Output " + std::to_string(stat.output_index), kTitleWidthInSecondColumn) +
+                   ": [" + stat.output_shape_str + "], byte/elem: " +
+                   std::to_string(stat.output_byte_count_per_element) +
+                   ", moved to host memory");
+  }
+}
 }  // namespace
 
 std::string SerializeMemoryRecords(
@@ -663,6 +712,11 @@ std::string SerializeMemoryRecords(
       FormatRecomputeMemoryRecords(option_index, record, true, rows);
       option_index++;
     }
+
+    if (record.offloaded_outputs.size() > 0) {
+      FormatOffloadMemoryRecords(option_index, record, rows);
+      option_index++;
+    }
     rows.push_back(kTableRowSeparator);
   }
 
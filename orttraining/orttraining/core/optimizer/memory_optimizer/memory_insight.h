@@ -53,6 +53,12 @@ class MemoryRecord {
   int actual_recompute_with_compromise_count = 0;
   InlinedHashMap<size_t, int> output_port_reuse_recompute_with_compromise_count;
 
+  // Offload Column
+  std::string offload_subgraph_str;
+  InlinedVector<OutputStat> offloaded_outputs;
+  int request_offload_count = 0;
+  int actual_offload_count = 0;
+
   // Frequency Column
   int freq = 0;
 };
@@ -10,6 +10,7 @@
 #include <onnx/defs/attr_proto_util.h>
 
 #include "core/framework/random_seed.h"
+#include "core/framework/session_options.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/graph_utils.h"
 #include "core/optimizer/utils.h"
@@ -19,6 +20,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
 #include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
 
 namespace onnxruntime {
 
@@ -111,6 +113,14 @@ bool MemoryOptimizer::ModifyGraph(Graph& graph,
           dynamic_cast<optimizer::memory_optimizer::NodeRecomputePlan*>(node_plan.get());
       ORT_ENFORCE(recompute_plan != nullptr);
       ORT_ENFORCE(CreateRecomputeGraph(graph, recompute_plan->GetNodesInTopoOrder(), logger, replacement_node_ptr).IsOK());
+    } else if (apply_context->type == optimizer::memory_optimizer::OptimizationType::Offload) {
+      // The backward consumers are connected to the copies brought back from host memory, there is no single
+      // replacement node for all the outputs.
+      ORT_ENFORCE(CreateOffloadGraph(graph, *node, node_plan->GetActivationOutputIndices(),
+                                     node_index_to_its_order_in_topological_sort_map,
+                                     boundary_op_order_in_topological_sort, logger)
+                      .IsOK());
+      return true;
     } else {
       ORT_THROW("unsupported optimization type found.");
     }
@@ -260,10 +270,10 @@ Status MemoryOptimizer::CreateRecomputeGraph(Graph& graph,
   for (size_t i = 0; i < nodes_in_topological_order.size(); ++i) {
     Node* node_to_duplicate = graph.GetNode(nodes_in_topological_order[i]->Index());
 
-    // Check whether the node has been recomputed/offloaded or not. Simply check the existence of the first output
+    // Check whether the node has been recomputed or not. Simply check the existence of the first output
     // of the node has its corresponding recompute name or not.
-    // TODO: if there is more optimization types like offload added, we will add a corresponding check
-    // whether the outputs already be offloaded or not.
+    // Offloaded outputs don't need a check, the nodes are applied in reversed topological order so the recompute
+    // nodes consuming an offloaded activation are rewired to the copy brought back from host memory.
     if (graph.GetNodeArg(graph_utils::RecomputeName(node_to_duplicate->MutableOutputDefs()[0]->Name())) != nullptr) {
       continue;
     }
@@ -398,4 +408,94 @@ Status MemoryOptimizer::CreateRecomputeGraph(Graph& graph,
  ** Recompute related function implementation ends   **
  ******************************************************/
 
+Status MemoryOptimizer::CreateOffloadGraph(Graph& graph,
+                                           Node& node,
+                                           gsl::span<const size_t> activation_output_indices,
+                                           const InlinedHashMap<NodeIndex, ptrdiff_t>&
+                                               node_index_to_its_order_in_topological_sort_map,
+                                           ptrdiff_t boundary_op_order_in_topological_sort,
+                                           const logging::Logger& logger) const {
+  for (size_t output_index : activation_output_indices) {
+    NodeArg* activation_arg = node.MutableOutputDefs()[output_index];
+
+    std::vector<graph_utils::GraphEdge> backward_edges;
+    bool used_by_subgraph = false;
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      if (static_cast<size_t>(it->GetSrcArgIndex()) != output_index) {
+        continue;
+      }
+
+      // Subgraphs refer to their implicit inputs by name, which can't be rewired to the prefetched copy.
+      if (static_cast<size_t>(it->GetDstArgIndex()) >= it->GetNode().InputDefs().size()) {
+        used_by_subgraph = true;
+        break;
+      }
+
+      // Consumers newly added, e.g. recompute nodes, are not in the map, they are treated as backward ops.
+      auto tid = node_index_to_its_order_in_topological_sort_map.find(it->GetNode().Index());
+      if (tid == node_index_to_its_order_in_topological_sort_map.end() ||
+          !IsForwardPassOperator(tid->second, boundary_op_order_in_topological_sort)) {
+        backward_edges.push_back(graph_utils::GraphEdge::CreateGraphEdge(node, *it, false));
+      }
+    }
+
+    if (used_by_subgraph || backward_edges.empty()) {
+      continue;
+    }
+
+    NodeArg& host_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation_arg->Name() + "_offloaded"),
+                                                 activation_arg->TypeAsProto());
+    NodeArg& device_arg = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(activation_arg->Name() + "_prefetched"),
+                                                   activation_arg->TypeAsProto());
+
+    // The output of MemcpyToHost is allocated from the CPU output allocator of the GPU provider, which is pinned
+    // memory, so the copies are asynchronous to the host on the stream of the provider.
+    Node& to_host_node = graph.AddNode(graph.GenerateNodeName(activation_arg->Name() + "_offload"),
+                                       "MemcpyToHost",
+                                       "Offload of " + activation_arg->Name(),
+                                       {activation_arg},
+                                       {&host_arg});
+    Node& from_host_node = graph.AddNode(graph.GenerateNodeName(activation_arg->Name() + "_prefetch"),
+                                         "MemcpyFromHost",
+                                         "Prefetch of " + activation_arg->Name(),
+                                         {&host_arg},
+                                         {&device_arg});
+    // The offload runs right after the activation is produced, so the device buffer can be released after its last
+    // forward consumer. The prefetch runs as late as possible, right before its backward consumers need it.
+    to_host_node.SetPriority(static_cast<int>(ExecutionPriority::LOCAL_HIGH));
+    from_host_node.SetPriority(static_cast<int>(ExecutionPriority::LOCAL_LOW));
+    for (Node* copy_node : {&to_host_node, &from_host_node}) {
+      copy_node->SetExecutionProviderType(node.GetExecutionProviderType());
+      ORT_RETURN_IF_NOT(graph.SetOpSchemaFromRegistryForNode(*copy_node),
+                        "Failed to set op schema for added offload node.");
+    }
+
+    graph.AddEdge(node.Index(), to_host_node.Index(), static_cast<int>(output_index), 0);
+    graph.AddConsumerNode(activation_arg->Name(), &to_host_node);
+    graph.UpdateProducerNode(host_arg.Name(), to_host_node.Index());
+    graph.AddEdge(to_host_node.Index(), from_host_node.Index(), 0, 0);
+    graph.AddConsumerNode(host_arg.Name(), &from_host_node);
+    graph.UpdateProducerNode(device_arg.Name(), from_host_node.Index());
+
+    for (const auto& backward_edge : backward_edges) {
+      Node* consumer = graph.GetNode(backward_edge.dst_node);
+      graph.RemoveEdge(backward_edge.src_node,
+                       backward_edge.dst_node,
+                       backward_edge.src_arg_index,
+                       backward_edge.dst_arg_index);
+      graph.RemoveConsumerNode(activation_arg->Name(), consumer);
+
+      // This also updates the destination node's input node args.
+      graph.AddEdge(from_host_node.Index(), backward_edge.dst_node, 0, backward_edge.dst_arg_index);
+      graph.AddConsumerNode(device_arg.Name(), consumer);
+    }
+
+    LOGS(logger, VERBOSE) << "Offload " << activation_arg->Name() << " of Node " << node.Name() << "("
+                          << node.OpType() << ") to host memory for " << backward_edges.size()
+                          << " backward consumer(s).";
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
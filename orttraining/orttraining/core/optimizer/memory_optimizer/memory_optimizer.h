@@ -9,6 +9,7 @@
 #include "orttraining/core/optimizer/memory_optimizer/common.h"
 #include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
 #include "orttraining/core/optimizer/memory_optimizer/recompute_analysis.h"
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
 #include "orttraining/core/optimizer/memory_optimizer/memory_insight.h"
 
 namespace onnxruntime {
@@ -24,6 +25,11 @@ Find recompute subgraphs and enable them according to user configs. The way we c
   b. otherwise, stop collecting and return the subgraph (could be empty).
 3. Pick up the input node from the queue, and do 2 again. The process ends when the queue is empty or 2.b happens.
 4. Clone the recomputable subgraphs and insert them back to the original graph.
+
+When offload is enabled in the probe config, the stashed activations produced on GPU devices can instead be
+offloaded (in orttraining/orttraining/core/optimizer/memory_optimizer/offload_analysis.h): a MemcpyToHost node copies
+the activation to pinned host memory in the forward pass, and a MemcpyFromHost node copies it back for its backward
+consumers, so its device buffer can be released after its last forward consumer.
 */
 
 class MemoryOptimizer : public GraphTransformer {
@@ -101,6 +107,26 @@ class MemoryOptimizer : public GraphTransformer {
    ** Recompute-related function definition ends   **
    *************************************************/
 
+  /**
+   * @brief Insert the copies offloading the activations of the node to host memory and bringing them back, and
+   * connect the backward consumers of the activations to the copies brought back.
+   *
+   * @param graph Graph to iterate and modify.
+   * @param node The node producing the activations.
+   * @param activation_output_indices Output indices of the activations to offload.
+   * @param node_index_to_its_order_in_topological_sort_map The mapping of node index to its order in topological sort.
+   * @param boundary_op_order_in_topological_sort index of the boundary op between fw and bw.
+   * @param logger Logger.
+   * @return Status
+   */
+  Status CreateOffloadGraph(Graph& graph,
+                            Node& node,
+                            gsl::span<const size_t> activation_output_indices,
+                            const InlinedHashMap<NodeIndex, ptrdiff_t>&
+                                node_index_to_its_order_in_topological_sort_map,
+                            ptrdiff_t boundary_op_order_in_topological_sort,
+                            const logging::Logger& logger) const;
+
   // User-enabled map of the subgraph string representation to the alleviation type.
   InlinedHashMap<std::string, optimizer::memory_optimizer::UserConfig> pattern_subgraph_to_user_optimizer_config_map_;
   std::string optimizer_config_file_path_;
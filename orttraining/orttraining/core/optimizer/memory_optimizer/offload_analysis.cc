@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "orttraining/core/optimizer/memory_optimizer/common.h"
+#include "orttraining/core/optimizer/memory_optimizer/offload_analysis.h"
+#include "core/framework/data_types.h"
+#include "core/graph/constants.h"
+#include "core/graph/graph_utils.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+namespace {
+
+// Whether the output can be copied to host memory and back by MemcpyToHost and MemcpyFromHost.
+bool IsOffloadableOutput(const Node& node, size_t output_index) {
+  const ONNX_NAMESPACE::TypeProto* type_proto = node.OutputDefs()[output_index]->TypeAsProto();
+  return type_proto != nullptr && type_proto->has_tensor_type() &&
+         type_proto->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_UNDEFINED &&
+         type_proto->tensor_type().elem_type() != ONNX_NAMESPACE::TensorProto_DataType_STRING;
+}
+
+}  // namespace
+
+std::string NodeOffloadPlan::GetClusterId() const {
+  return node->OpType() + "+";
+}
+
+std::string NodeOffloadPlan::NormalizeForNodeClusterId() const {
+  std::ostringstream oss;
+  oss << "offload:" << node->OpType() << "-";
+  for (auto& output_index : GetActivationOutputIndices()) {
+    oss << output_index << ":" << GetActivationOutputDimParamString(output_index);
+    oss << ":" << node->OutputDefs()[output_index]->TypeAsProto()->tensor_type().elem_type() << "-";
+  }
+
+  return oss.str();
+}
+
+std::string NodeOffloadPlan::GetMemorySavingSymbolicString() const {
+  std::string saving_str;
+  for (auto output_index : GetActivationOutputIndices()) {
+    const auto& output_def = node->OutputDefs()[output_index];
+    MLDataType ml_data_type = DataTypeImpl::TypeFromProto(*output_def->TypeAsProto());
+    ORT_ENFORCE(ml_data_type->IsTensorType(), "ml_type must be a tensor type, but it is ",
+                DataTypeImpl::ToString(ml_data_type));
+    const auto byte_count_per_element = ml_data_type->AsTensorType()->GetElementType()->Size();
+
+    if (!saving_str.empty()) {
+      saving_str += " + ";
+    }
+
+    saving_str += "(" + GetActivationOutputDimParamString(output_index) + " * " +
+                  std::to_string(byte_count_per_element) + ")";
+  }
+
+  ORT_ENFORCE(!saving_str.empty(), "saving_str should not be empty for node: ", node->OpType(), " ", node->Name());
+  return "(" + saving_str + ")";
+}
+
+std::unique_ptr<NodeOffloadPlan> CheckNodeForOffload(const Node& node,
+                                                     const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                                         candidate_output_args_map,
+                                                     const logging::Logger& logger) {
+  const auto& provider_type = node.GetExecutionProviderType();
+  if (provider_type != kCudaExecutionProvider && provider_type != kRocmExecutionProvider) {
+    MO_LOG_DEBUG_INFO(logger, "Skip offload for Node " + node.Name() + "(" + node.OpType() +
+                                  ") since it is not assigned to a GPU execution provider.");
+    return nullptr;
+  }
+
+  // The ctx and rng state outputs of PythonOp are bound to the Python side, so they are kept where they are.
+  if (graph_utils::IsSupportedOptypeVersionAndDomain(node, "PythonOp", {1}, kMSDomain)) {
+    return nullptr;
+  }
+
+  InlinedVector<size_t> offloadable_output_indices;
+  for (auto output_index : candidate_output_args_map.at(&node)) {
+    if (IsOffloadableOutput(node, output_index)) {
+      offloadable_output_indices.push_back(output_index);
+    }
+  }
+
+  if (offloadable_output_indices.empty()) {
+    return nullptr;
+  }
+
+  MO_LOG_DEBUG_INFO(logger, "Node " + node.Name() + "(" + node.OpType() + ") has " +
+                                std::to_string(offloadable_output_indices.size()) + " offloadable activation(s).");
+  return std::make_unique<NodeOffloadPlan>(&node, offloadable_output_indices);
+}
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
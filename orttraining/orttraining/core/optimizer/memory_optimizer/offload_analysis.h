@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "orttraining/core/optimizer/memory_optimizer/common.h"
+#include "orttraining/core/optimizer/memory_optimizer/optimization_planner.h"
+
+namespace onnxruntime::optimizer::memory_optimizer {
+
+/**
+ * @brief A child class used for Offload optimization plan.
+ *
+ * The stashed activations of the node are copied to host memory right after the forward pass produces them, and
+ * copied back to device memory before the backward pass consumes them. So instead of being kept in device memory
+ * between the forward and backward pass, they only take pinned host memory.
+ */
+class NodeOffloadPlan : public NodeOptimizationPlanBase {
+ public:
+  NodeOffloadPlan(const Node* node,
+                  const InlinedVector<size_t>& activation_output_indices)
+      : NodeOptimizationPlanBase(node, activation_output_indices, 1.0f) {}
+
+  OptimizationType GetOptimizationType() const override {
+    return OptimizationType::Offload;
+  }
+
+  /**
+   * @brief Get the cluster id for this offload plan.
+   * Offload only involves the node itself, so the cluster id is the string representation of the single node
+   * subgraph, e.g. "Gelu+". It is told apart from a recompute plan of the same subgraph by the optimization type.
+   */
+  std::string GetClusterId() const override;
+
+  std::string NormalizeForNodeClusterId() const override;
+
+  std::string GetMemorySavingSymbolicString() const override;
+};
+
+/**
+ * @brief For the node producing stashed activations, check whether they can be offloaded to host memory or not.
+ * Only tensor activations produced by GPU execution providers are offloaded, whose copy to and from host memory can
+ * be done by the MemcpyToHost and MemcpyFromHost kernels of the provider.
+ *
+ * @param node The node producing stashed activations.
+ * @param candidate_output_args_map A map from node to its candidate activations.
+ * @param logger Logger.
+ * @return The offload plan, or nullptr if none of the activations can be offloaded.
+ */
+std::unique_ptr<NodeOffloadPlan> CheckNodeForOffload(const Node& node,
+                                                     const InlinedHashMap<const Node*, InlinedVector<size_t>>&
+                                                         candidate_output_args_map,
+                                                     const logging::Logger& logger);
+
+}  // namespace onnxruntime::optimizer::memory_optimizer
@@ -764,6 +764,7 @@ void NodesInTopoOrderToString(gsl::span<const Node* const> nodes_in_topological_
 
 Status ParseProbeConfigFromString(std::string_view recompute_probe_config, ProbeConfig& probe_config) {
   int transformer_layer_as_boundary = 0;
+  int offload = 0;
   if (!recompute_probe_config.empty()) {
     const auto probe_configs = utils::SplitString(recompute_probe_config, ":");
     ORT_ENFORCE(probe_configs.size() >= 1, "Probe config information is not complete.");
@@ -779,10 +780,16 @@ Status ParseProbeConfigFromString(std::string_view recompute_probe_config, Probe
                   "Invalid transformer_layer_as_boundary specified: ", probe_configs[1]);
     }
 
+    if (probe_configs.size() > 2) {
+      offload = ParseIntValueFromString(probe_configs[2]);
+      ORT_ENFORCE(offload == 0 || offload == 1, "Invalid offload specified: ", probe_configs[2]);
+    }
+
     probe_config.probe_level = static_cast<ProbeLevel>(probe_level_int);
   }
 
   probe_config.enable_transformer_layer_as_boundary = transformer_layer_as_boundary == 1;
+  probe_config.enable_offload = offload == 1;
 
   return Status::OK();
 }
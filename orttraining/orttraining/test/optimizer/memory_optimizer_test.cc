@@ -101,6 +101,85 @@ TEST(MemoryOptimizerTests, GeluRecompute) {
   ASSERT_EQ(recompute_gelu_node->MutableInputDefs()[0]->Name(), original_gelu_node->MutableInputDefs()[0]->Name());
 }
 
+TEST(MemoryOptimizerTests, GeluOffload) {
+  const logging::Logger* logger = &logging::LoggingManager::DefaultLogger();
+  auto model_uri = MODEL_FOLDER "recompute_gelu.onnx";
+  std::shared_ptr<Model> model;
+  ASSERT_STATUS_OK(Model::Load(model_uri, model, nullptr, *logger));
+  Graph& graph = model->MainGraph();
+
+  // Only the activations produced on GPU are offloaded.
+  Node* gelu_node{nullptr};
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType().compare("Gelu") == 0) {
+      gelu_node = &node;
+      node.SetExecutionProviderType(kCudaExecutionProvider);
+      break;
+    }
+  }
+  ASSERT_TRUE(gelu_node);
+  const std::string gelu_output_name = gelu_node->OutputDefs()[0]->Name();
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{1};
+
+  const std::string alleviation_config("Gelu+:3:-1");
+  onnxruntime::test::TemporaryDirectory tmp_dir{ORT_TSTR("memory_optimizer_test_tmp_dir")};
+  PathString config_path{ConcatPathComponent(tmp_dir.Path(),
+                                             ORT_TSTR("geluoffload.json"))};
+  const std::string config_path_str = ToUTF8String(config_path);
+  std::ofstream outfile(config_path_str);
+  outfile << "[\"" << alleviation_config << "\"]" << std::endl;
+  outfile.close();
+
+  const std::string probe_config("1:0:1");
+  ASSERT_STATUS_OK(graph_transformation_mgr.Register(
+      std::make_unique<MemoryOptimizer>(config_path_str, probe_config), TransformerLevel::Level3));
+
+  ASSERT_STATUS_OK(graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level3, *logger));
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_EQ(op_to_count["com.microsoft.Gelu"], 1);
+  ASSERT_EQ(op_to_count["MemcpyToHost"], 1);
+  ASSERT_EQ(op_to_count["MemcpyFromHost"], 1);
+
+  Node* to_host_node{nullptr};
+  Node* from_host_node{nullptr};
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType().compare("MemcpyToHost") == 0) {
+      to_host_node = &node;
+    } else if (node.OpType().compare("MemcpyFromHost") == 0) {
+      from_host_node = &node;
+    }
+  }
+  ASSERT_TRUE(to_host_node);
+  ASSERT_TRUE(from_host_node);
+  ASSERT_EQ(to_host_node->GetExecutionProviderType(), kCudaExecutionProvider);
+  ASSERT_EQ(to_host_node->InputDefs()[0]->Name(), gelu_output_name);
+  ASSERT_EQ(from_host_node->InputDefs()[0]->Name(), to_host_node->OutputDefs()[0]->Name());
+
+  // The offload is scheduled in forward pass, and the prefetch in backward pass.
+  GraphViewer graph_viewer(graph);
+  const auto& node_ids = graph_viewer.GetNodesInTopologicalOrder(ExecutionOrder::MEMORY_EFFICIENT);
+  std::map<const Node*, size_t> node_orders;
+  const Node* yield_node{nullptr};
+  for (size_t i = 0; i < node_ids.size(); ++i) {
+    const Node* node = graph.GetNode(node_ids[i]);
+    node_orders[node] = i;
+    if (node->OpType() == "YieldOp") {
+      yield_node = node;
+    }
+  }
+  ASSERT_TRUE(yield_node);
+  ASSERT_LT(node_orders[to_host_node], node_orders[yield_node]);
+  ASSERT_GT(node_orders[from_host_node], node_orders[yield_node]);
+
+  // Only the forward consumers keep the original activation, the backward consumers take the prefetched copy.
+  for (const Node* consumer : graph.GetConsumerNodes(gelu_output_name)) {
+    ASSERT_LT(node_orders[consumer], node_orders[yield_node]);
+  }
+  ASSERT_FALSE(graph.GetConsumerNodes(from_host_node->OutputDefs()[0]->Name()).empty());
+}
+
 TEST(MemoryOptimizerTests, TileRecompute) {
   const logging::Logger* logger = &logging::LoggingManager::DefaultLogger();
   auto model_uri = MODEL_FOLDER "recompute_tile.onnx";
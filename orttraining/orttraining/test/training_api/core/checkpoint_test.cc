@@ -471,6 +471,43 @@ TEST(CheckpointApiTest, LoadAndSaveNominalCheckpoint) {
   }
 }
 
+/**
+ * Loads a checkpoint, saves it in the background with its tensor data streamed to an external data file,
+ * then loads it again and compares the parameter values.
+ */
+TEST(CheckpointApiTest, SaveCheckpointAsync_WithExternalData_ThenLoad) {
+  CheckpointState checkpoint_state;
+  ASSERT_STATUS_OK(LoadCheckpoint(ORT_TSTR("testdata/training_api/checkpoint.ckpt"), checkpoint_state));
+  checkpoint_state.has_external_data = true;
+
+  // Remove the temporary directory if it already exists.
+  auto ckpt_test_root_dir = ORT_TSTR("checkpointing_api_test_dir");
+  TemporaryDirectory tmp_dir{ckpt_test_root_dir};
+  PathString checkpoint_path{
+      ConcatPathComponent(tmp_dir.Path(), ORT_TSTR("async_ckpt_save_cpu"))};
+  auto save_result = SaveCheckpointAsync(checkpoint_state, checkpoint_path, false);
+  ASSERT_STATUS_OK(save_result.get());
+  ASSERT_TRUE(std::filesystem::exists(ExternalCheckpointDataPath(checkpoint_path)));
+
+  CheckpointState checkpoint_state_to_load;
+  ASSERT_STATUS_OK(LoadCheckpoint(checkpoint_path, checkpoint_state_to_load));
+  ASSERT_TRUE(checkpoint_state_to_load.has_external_data);
+  const auto& expected_params = checkpoint_state.module_checkpoint_state.named_parameters;
+  const auto& restored_params = checkpoint_state_to_load.module_checkpoint_state.named_parameters;
+  ASSERT_EQ(restored_params.size(), expected_params.size());
+  for (const auto& [name, param] : expected_params) {
+    const auto restored_it = restored_params.find(name);
+    ASSERT_NE(restored_it, restored_params.end());
+    ASSERT_EQ(restored_it->second->RequiresGrad(), param->RequiresGrad());
+
+    const Tensor& expected_tensor = param->Data().Get<Tensor>();
+    const Tensor& restored_tensor = restored_it->second->Data().Get<Tensor>();
+    ASSERT_EQ(expected_tensor.DataType(), restored_tensor.DataType());
+    ASSERT_EQ(expected_tensor.SizeInBytes(), restored_tensor.SizeInBytes());
+    ASSERT_EQ(std::memcmp(expected_tensor.DataRaw(), restored_tensor.DataRaw(), expected_tensor.SizeInBytes()), 0);
+  }
+}
+
 /**
  * Load ONNX model from file path, save into ORT checkpoint files,
  * Then load it into ORT, compare with the initial parameter values.
@@ -8,6 +8,7 @@
 
 #include "test/util/include/asserts.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "orttraining/training_api/utils.h"
 #include "orttraining/training_api/module.h"
 #include "orttraining/training_api/optimizer.h"
@@ -312,6 +313,74 @@ TEST(TrainingApiTest, ModuleTrainStep) {
   }
 }
 
+TEST(TrainingApiTest, ModuleContiguousParameterBuffer) {
+  auto model_uri = MODEL_FOLDER "training_model.onnx";
+  auto checkpoint_to_load_path = MODEL_FOLDER "checkpoint.ckpt";
+  auto model_identifier = ModelIdentifiers(onnxruntime::ToUTF8String(model_uri),
+                                           std::nullopt,
+                                           std::nullopt);
+  std::unique_ptr<Environment> env;
+  ASSERT_STATUS_OK(Environment::Create(nullptr, env));
+
+  onnxruntime::training::api::CheckpointState state;
+  ASSERT_STATUS_OK(onnxruntime::training::api::LoadCheckpoint(checkpoint_to_load_path, state));
+  onnxruntime::SessionOptions session_option;
+  auto model = std::make_unique<onnxruntime::training::api::Module>(model_identifier,
+                                                                    &state, session_option,
+                                                                    *env, std::vector<std::shared_ptr<IExecutionProvider>>());
+
+  onnxruntime::training::api::CheckpointState contiguous_state;
+  ASSERT_STATUS_OK(onnxruntime::training::api::LoadCheckpoint(checkpoint_to_load_path, contiguous_state));
+  onnxruntime::SessionOptions contiguous_session_option;
+  ASSERT_STATUS_OK(contiguous_session_option.config_options.AddConfigEntry(
+      kOrtSessionOptionsConfigUseContiguousParameterBuffer, "1"));
+  auto contiguous_model = std::make_unique<onnxruntime::training::api::Module>(
+      model_identifier, &contiguous_state, contiguous_session_option,
+      *env, std::vector<std::shared_ptr<IExecutionProvider>>());
+
+  // The contiguous buffer is handed out without copying, with the layout of CopyParametersToBuffer.
+  const int64_t params_size = static_cast<int64_t>(model->GetParametersSize());
+  OrtValue expected_params;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), {params_size},
+                       onnxruntime::test::TestCPUExecutionProvider()->CreatePreferredAllocators()[0],
+                       expected_params);
+  ASSERT_STATUS_OK(model->CopyParametersToBuffer(expected_params));
+  OrtValue params;
+  ASSERT_STATUS_OK(contiguous_model->CopyParametersToBuffer(params));
+  ASSERT_EQ(params.Get<Tensor>().Shape().Size(), params_size);
+  std::vector<float> expected_params_vec, params_vec;
+  CpuOrtValueToVec(expected_params, expected_params_vec);
+  CpuOrtValueToVec(params, params_vec);
+  ASSERT_EQ(params_vec, expected_params_vec);
+
+  // The gradients accumulate in place in the contiguous gradient buffer.
+  OrtValue input, target;
+  GenerateRandomInput(std::array<int64_t, 2>{2, 784}, input);
+  target = onnxruntime::test::CreateInputOrtValueOnCPU<int32_t>(
+      std::array<int64_t, 1>{2}, std::vector<int32_t>(2, 1));
+  std::vector<OrtValue> fetches, contiguous_fetches;
+  ASSERT_STATUS_OK(model->TrainStep({input, target}, fetches));
+  ASSERT_STATUS_OK(contiguous_model->TrainStep({input, target}, contiguous_fetches));
+
+  OrtValue grads;
+  ASSERT_STATUS_OK(contiguous_model->GetContiguousGradients(grads));
+  const Tensor& grads_tensor = grads.Get<Tensor>();
+  ASSERT_EQ(grads_tensor.Shape().Size(), params_size);
+  const float* grads_begin = grads_tensor.Data<float>();
+  for (const auto& [param_name, param] : contiguous_model->NamedParameters()) {
+    if (!param->RequiresGrad()) {
+      continue;
+    }
+    const float* grad = param->Gradient().Get<Tensor>().Data<float>();
+    ASSERT_TRUE(grad >= grads_begin && grad < grads_begin + params_size);
+
+    std::vector<float> expected_grad_vec, grad_vec;
+    CpuOrtValueToVec(model->NamedParameters()[param_name]->Gradient(), expected_grad_vec);
+    CpuOrtValueToVec(param->Gradient(), grad_vec);
+    ASSERT_EQ(grad_vec, expected_grad_vec);
+  }
+}
+
 TEST(TrainingApiTest, OptimizerCreatedWithOptimizerCheckpointState) {
   std::vector<bool> run_cuda_list{false};
   // #ifdef USE_CUDA
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <fstream>
 
 #include "gtest/gtest.h"
@@ -361,6 +362,62 @@ TEST(AdamWTest, HFAdamWMultipleWeightsStrictTest_Loop10Steps) {
   HFAdamWMultipleWeightsTestLoop10Steps(true);
 }
 
+// The CPU kernel keeps float16 moments of float weights, on a weight of several chunks and on a weight of a few
+// elements. From zero moments the first step of adam_mode 0 is
+// w = w - w * lr * weight_decay - lr * g / (|g| + epsilon), m1 = (1 - alpha) * g, m2 = (1 - beta) * g * g.
+TEST(AdamWTest, Float16MomentumsFirstStep) {
+  constexpr float lr = 1e-3f;
+  constexpr float alpha = 0.9f;
+  constexpr float beta = 0.999f;
+  constexpr float epsilon = 1e-8f;
+  constexpr float weight_decay = 1e-2f;
+
+  OpTester test("AdamWOptimizer", 1, onnxruntime::kMSDomain);
+  test.AddAttribute("alpha", alpha);
+  test.AddAttribute("beta", beta);
+  test.AddAttribute("epsilon", epsilon);
+  test.AddAttribute("weight_decay", weight_decay);
+  test.AddAttribute("adam_mode", static_cast<int64_t>(0));
+  test.AddAttribute("correct_bias", static_cast<int64_t>(1));
+
+  SeqTensors<float> weights, gradients, updated_weights;
+  SeqTensors<MLFloat16> momentums, updated_momentums_1, updated_momentums_2;
+  for (const int64_t size : {10000, 3}) {
+    std::vector<float> weight(size), gradient(size), updated_weight(size);
+    std::vector<MLFloat16> momentum(size, MLFloat16(0.f)), updated_momentum_1(size), updated_momentum_2(size);
+    for (int64_t i = 0; i < size; ++i) {
+      weight[i] = 0.5f - static_cast<float>(i % 7) * 0.1f;
+      gradient[i] = static_cast<float>(i % 5) * 0.2f - 0.3f;
+      updated_weight[i] = weight[i] - weight[i] * lr * weight_decay -
+                          lr * gradient[i] / (std::abs(gradient[i]) + epsilon);
+      updated_momentum_1[i] = MLFloat16((1.f - alpha) * gradient[i]);
+      updated_momentum_2[i] = MLFloat16((1.f - beta) * gradient[i] * gradient[i]);
+    }
+    weights.AddTensor({size}, weight);
+    gradients.AddTensor({size}, gradient);
+    updated_weights.AddTensor({size}, updated_weight);
+    momentums.AddTensor({size}, momentum);
+    updated_momentums_1.AddTensor({size}, updated_momentum_1);
+    updated_momentums_2.AddTensor({size}, updated_momentum_2);
+  }
+
+  test.AddInput<float>("lr", {}, {lr});
+  test.AddInput<int64_t>("step", {}, {1});
+  test.AddSeqInput("weights", weights);
+  test.AddSeqInput("gradients", gradients);
+  test.AddSeqInput("momentums_1", momentums);
+  test.AddSeqInput("momentums_2", momentums);
+
+  test.AddOutput<bool>("updated_flag", {}, {1});
+  test.AddSeqOutput("updated_weights", updated_weights, 1e-4f, 1e-5f);
+  test.AddSeqOutput("updated_momentums_1", updated_momentums_1, 1e-3f, 1e-6f);
+  test.AddSeqOutput("updated_momentums_2", updated_momentums_2, 1e-3f, 1e-7f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace
 
 }  // namespace optimizer
@@ -8,6 +8,9 @@
 #include "core/framework/framework_common.h"
 #include "core/graph/graph_flatbuffers_utils.h"
 #include "core/framework/tensor_external_data_info.h"
+#include "core/platform/env.h"
+
+#include <cstring>
 
 namespace onnxruntime::training::api {
 
@@ -18,19 +21,18 @@ PathString ExternalCheckpointDataPath(const PathString& checkpoint_path) {
 namespace {
 
 /**
- * @brief Helper method to read data from an external file.
- * @param external_data_stream Stream that data will be read from.
+ * @brief Helper method to read data from the mapped external data file.
+ * @param external_data Contents of the external data file.
  * @param offset Offset in the external data file to begin reading from.
  * @param output_buffer Buffer to store the read data.
  * @return Status of the operation.
  */
-Status ReadFromExternalFileHelper(std::ifstream& external_data_stream,
+Status ReadFromExternalDataHelper(gsl::span<const uint8_t> external_data,
                                   uint64_t offset, gsl::span<uint8_t> output_buffer) {
-  external_data_stream.seekg(offset);
-  external_data_stream.read(reinterpret_cast<char*>(output_buffer.data()), output_buffer.size());
-
-  const auto [err, msg] = GetErrnoInfo();
-  ORT_RETURN_IF(external_data_stream.fail(), "Failed reading external checkpoint data. ", msg, " errno:", errno);
+  ORT_RETURN_IF(offset > external_data.size() || output_buffer.size() > external_data.size() - offset,
+                "Failed reading external checkpoint data. Range [", offset, ", ", offset + output_buffer.size(),
+                ") exceeds the ", external_data.size(), " bytes of the external data file.");
+  std::memcpy(output_buffer.data(), external_data.data() + offset, output_buffer.size());
 
   return Status::OK();
 }
@@ -605,23 +607,24 @@ Status FromCheckpointState(
 namespace load {
 
 /**
- * @brief Load checkpoint flatbuffer from file.
- * @param checkpoint_path Path to the checkpoint file.
- * @param checkpoint_bytes Contents of the checkpoint file in bytes.
- * @param checkpoint_span Checkpoint bytes represented as a span.
+ * @brief Map a checkpoint or external data file into memory.
+ *
+ * The tensors are then copied out of the page cache as they are deserialized, instead of reading the whole file into
+ * a buffer first, which doubled the memory of loading a checkpoint.
+ *
+ * @param file_path Path to the file.
+ * @param mapped_bytes Mapping of the file, to be kept alive while file_bytes is used.
+ * @param file_bytes Contents of the file.
  * @return Status of the operation.
  *
  */
-Status FromFile(const PathString& checkpoint_path, InlinedVector<uint8_t>& checkpoint_bytes) {
+Status FromFile(const PathString& file_path, Env::MappedMemoryPtr& mapped_bytes,
+                gsl::span<const uint8_t>& file_bytes) {
   size_t num_bytes = 0;
-  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(checkpoint_path.c_str(), num_bytes));
-  checkpoint_bytes.resize(num_bytes);
-
-  std::ifstream bytes_stream(checkpoint_path, std::ifstream::in | std::ifstream::binary);
-  bytes_stream.read(reinterpret_cast<char*>(checkpoint_bytes.data()), num_bytes);
-
-  ORT_RETURN_IF_NOT(bytes_stream, "Loading checkpoint from ", ToUTF8String(checkpoint_path), " failed. Only ",
-                    bytes_stream.gcount(), "/", num_bytes, " bytes could be read.");
+  ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(file_path.c_str(), num_bytes));
+  ORT_RETURN_IF(num_bytes == 0, "Loading checkpoint from ", ToUTF8String(file_path), " failed. The file is empty.");
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path.c_str(), 0, num_bytes, mapped_bytes));
+  file_bytes = gsl::make_span(reinterpret_cast<const uint8_t*>(mapped_bytes.get()), num_bytes);
 
   return Status::OK();
 }
@@ -806,16 +809,15 @@ Status ToModelProto(gsl::span<const uint8_t> checkpoint_bytes,
                 "Expected: Complete checkpoint. Actual: Nominal checkpoint.");
 
   fbs::utils::ExternalDataReader external_data_reader = nullptr;
-  std::optional<std::ifstream> external_data_stream;
+  Env::MappedMemoryPtr mapped_external_data;
+  gsl::span<const uint8_t> external_data;
 
   if (module_state->has_external_data()) {
     auto data_path = ExternalCheckpointDataPath(checkpoint_path);
-    external_data_stream = std::ifstream(data_path, std::ios::binary);
-    ORT_RETURN_IF(external_data_stream->fail(),
-                  "Failed to open checkpoint's external data file: ", ToUTF8String(data_path));
+    ORT_RETURN_IF_ERROR(FromFile(data_path, mapped_external_data, external_data));
 
-    external_data_reader = [&external_data_stream](uint64_t offset, gsl::span<uint8_t> output_buffer) {
-      return ReadFromExternalFileHelper(external_data_stream.value(), offset, output_buffer);
+    external_data_reader = [external_data](uint64_t offset, gsl::span<uint8_t> output_buffer) {
+      return ReadFromExternalDataHelper(external_data, offset, output_buffer);
     };
   }
 
@@ -876,7 +878,8 @@ Status ToCheckpointState(gsl::span<const uint8_t> checkpoint_bytes, CheckpointSt
   const auto* fbs_module_state = fbs_checkpoint->module_state();
 
   fbs::utils::ExternalDataReader external_data_reader = nullptr;
-  std::optional<std::ifstream> external_data_stream;
+  Env::MappedMemoryPtr mapped_external_data;
+  gsl::span<const uint8_t> external_data;
 
   state.has_external_data = false;
   if (nullptr != fbs_module_state && fbs_module_state->has_external_data()) {
@@ -884,17 +887,15 @@ Status ToCheckpointState(gsl::span<const uint8_t> checkpoint_bytes, CheckpointSt
     ORT_RETURN_IF_NOT(checkpoint_path.has_value(),
                       "External data is present in the checkpoint but the checkpoint path is not provided. External data with loading from buffer is not supported yet.");
     auto data_path = ExternalCheckpointDataPath(*checkpoint_path);
-    external_data_stream = std::ifstream(data_path, std::ios::binary);
-
-    if (external_data_stream.value().fail()) {
-      const auto [err, errmsg] = GetErrnoInfo();
+    const auto status = FromFile(data_path, mapped_external_data, external_data);
+    if (!status.IsOK()) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
                              "Failed to open checkpoint's external data file: ", ToUTF8String(data_path),
-                             " error:", errmsg, " errno:", err);
+                             " error:", status.ErrorMessage());
     }
 
-    external_data_reader = [&external_data_stream](uint64_t offset, gsl::span<uint8_t> output_buffer) {
-      return ReadFromExternalFileHelper(external_data_stream.value(), offset, output_buffer);
+    external_data_reader = [external_data](uint64_t offset, gsl::span<uint8_t> output_buffer) {
+      return ReadFromExternalDataHelper(external_data, offset, output_buffer);
     };
   }
 
@@ -954,11 +955,19 @@ Status SaveCheckpoint(const CheckpointState& states, const PathString& checkpoin
   return save::FromCheckpointState(states, checkpoint_path, include_optimizer_state);
 }
 
+std::future<Status> SaveCheckpointAsync(const CheckpointState& state, const PathString& checkpoint_path,
+                                        const bool include_optimizer_state) {
+  return std::async(std::launch::async, [&state, checkpoint_path, include_optimizer_state]() {
+    return SaveCheckpoint(state, checkpoint_path, include_optimizer_state);
+  });
+}
+
 Status LoadCheckpoint(const PathString& checkpoint_path, CheckpointState& checkpoint_states) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
-  InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
+  Env::MappedMemoryPtr mapped_checkpoint;
+  gsl::span<const uint8_t> checkpoint_bytes;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, mapped_checkpoint, checkpoint_bytes));
   return load::ToCheckpointState(checkpoint_bytes, checkpoint_states, checkpoint_path);
 }
 
@@ -973,8 +982,9 @@ Status LoadCheckpointToModel(const PathString& checkpoint_path,
                              ONNX_NAMESPACE::ModelProto& model_proto) {
   ORT_RETURN_IF_NOT(FLATBUFFERS_LITTLEENDIAN, "ORT training checkpoint format only supports little-endian machines");
 
-  InlinedVector<uint8_t> checkpoint_bytes;
-  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, checkpoint_bytes));
+  Env::MappedMemoryPtr mapped_checkpoint;
+  gsl::span<const uint8_t> checkpoint_bytes;
+  ORT_RETURN_IF_ERROR(load::FromFile(checkpoint_path, mapped_checkpoint, checkpoint_bytes));
   return load::ToModelProto(checkpoint_bytes, model_proto, checkpoint_path);
 }
 #endif
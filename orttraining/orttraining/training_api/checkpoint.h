@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <future>
+
 #include "core/platform/path_lib.h"
 #include "orttraining/training_api/checkpoint_property.h"
 #include "orttraining/training_api/module.h"
@@ -20,6 +22,7 @@
  *
  * The checkpoint file is a single flatbuffer file containing all the states highlighted above.
  * The flatbuffer schema is defined in onnxruntime/core/flatbuffers/schema/ort_training_checkpoint.fbs
+ * Loading maps the checkpoint file, and its external data file if any, into memory rather than reading them.
  *
  */
 
@@ -50,6 +53,21 @@ PathString ExternalCheckpointDataPath(const PathString& checkpoint_path);
 Status SaveCheckpoint(const CheckpointState& state, const PathString& checkpoint_path,
                       const bool include_optimizer_state);
 
+/**
+ * @brief Save training states as ORT checkpoint on a background thread, e.g. while the next TrainStep runs.
+ *
+ * The parameters and the optimizer states are serialized from the state in place, so they must not be modified
+ * (OptimizerStep, CopyBufferToParameters, UpdateParameter) until the returned future is ready. TrainStep and EvalStep
+ * only update the gradients and may run meanwhile. With state.has_external_data set, the tensor data is streamed to
+ * the external data file as it is serialized rather than built into the flatbuffer in memory.
+ *
+ * @param state parameter/optimizer and other user defined training states, to be kept alive until the save is done.
+ * @param checkpoint_path file where checkpoint is saved.
+ * @return future Status of the save
+ */
+std::future<Status> SaveCheckpointAsync(const CheckpointState& state, const PathString& checkpoint_path,
+                                        const bool include_optimizer_state);
+
 #if !defined(ORT_MINIMAL_BUILD)
 /**
  * @brief Save ONNX initializers as ORT checkpoint.
@@ -282,6 +282,9 @@ Module::Module(const ModelIdentifiers& model_identifiers,
                const std::vector<std::shared_ptr<IExecutionProvider>>& providers,
                [[maybe_unused]] gsl::span<OrtCustomOpDomain* const> op_domains)
     : state_{state} {
+  use_contiguous_parameter_buffer_ = session_options.config_options.GetConfigOrDefault(
+                                         kOrtSessionOptionsConfigUseContiguousParameterBuffer, "0") == "1";
+
   // Enforce weight prepacking is disabled
   // If the user explicitly enabled weight prepacking then return an error.
   // Default value is enabled. Therefore, explicitly disable it if the value is not set by the user.
@@ -364,6 +367,10 @@ Module::Module(const ModelIdentifiers& model_identifiers,
         gradients_[param_to_grad_index.at(param_name)] = params_iter->second->Gradient();
       }
     }
+
+    if (use_contiguous_parameter_buffer_) {
+      ORT_THROW_IF_ERROR(MoveTrainableParametersToContiguousBuffers());
+    }
   }
 
   if (model_identifiers.IsEvalModelAvailable()) {
@@ -476,9 +483,93 @@ std::unordered_map<std::string, std::shared_ptr<Parameter>> Module::NamedParamet
   return state_->module_checkpoint_state.named_parameters;
 }
 
+Status Module::MoveTrainableParametersToContiguousBuffers() {
+  auto& module_state = state_->module_checkpoint_state;
+  const auto param_to_grad_index = BuildParameterToGradInputIndexMap(train_input_names_.GradientInputNames());
+
+  InlinedVector<Parameter*> trainable_params;
+  SafeInt<int64_t> buffer_size = 0;
+  for (const auto& param_name : train_input_names_.WeightsInputNames()) {
+    Parameter& param = *module_state.named_parameters.at(param_name);
+    if (!param.RequiresGrad()) {
+      continue;
+    }
+    const Tensor& weight = param.Data().Get<Tensor>();
+    if (!trainable_params.empty()) {
+      const Tensor& first_weight = trainable_params.front()->Data().Get<Tensor>();
+      ORT_RETURN_IF_NOT(weight.DataType() == first_weight.DataType() &&
+                            weight.Location().device == first_weight.Location().device,
+                        "A contiguous parameter buffer requires all trainable parameters to be of the same type on "
+                        "the same device. Parameter ",
+                        param_name, " differs from parameter ", trainable_params.front()->Name());
+    }
+    trainable_params.push_back(&param);
+    buffer_size += weight.Shape().Size();
+  }
+  if (trainable_params.empty()) {
+    return Status::OK();
+  }
+
+  const Tensor& first_weight = trainable_params.front()->Data().Get<Tensor>();
+  const MLDataType element_type = first_weight.DataType();
+  AllocatorPtr allocator = train_sess_->GetSessionState().GetAllocator(first_weight.Location().device);
+  ORT_RETURN_IF_NOT(allocator, "No allocator for the device of the trainable parameters.");
+
+  const TensorShape buffer_shape({static_cast<int64_t>(buffer_size)});
+  // The buffers replace those of the checkpoint state only once the parameters are copied out of them.
+  Tensor::InitOrtValue(element_type, buffer_shape, allocator, contiguous_parameters_);
+  Tensor::InitOrtValue(element_type, buffer_shape, allocator, contiguous_gradients_);
+  Tensor& parameters_buffer = *contiguous_parameters_.GetMutable<Tensor>();
+  Tensor& gradients_buffer = *contiguous_gradients_.GetMutable<Tensor>();
+
+  const DataTransferManager& data_transfer_manager = train_sess_->GetDataTransferManager();
+  size_t offset = 0;
+  for (Parameter* param : trainable_params) {
+    const Tensor& weight = param->Data().Get<Tensor>();
+    const TensorShape shape = weight.Shape();
+    const size_t size_in_bytes = weight.SizeInBytes();
+
+    OrtValue weight_view;
+    Tensor::InitOrtValue(element_type, shape, static_cast<std::byte*>(parameters_buffer.MutableDataRaw()) + offset,
+                         parameters_buffer.Location(), weight_view);
+    ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(weight, *weight_view.GetMutable<Tensor>()));
+
+    OrtValue gradient_view;
+    Tensor::InitOrtValue(element_type, shape, static_cast<std::byte*>(gradients_buffer.MutableDataRaw()) + offset,
+                         gradients_buffer.Location(), gradient_view);
+    ORT_RETURN_IF_ERROR(data_transfer_manager.CopyTensor(param->Gradient().Get<Tensor>(),
+                                                         *gradient_view.GetMutable<Tensor>()));
+
+    param->Data() = weight_view;
+    ORT_RETURN_IF_ERROR(param->SetGrad(param->GradientName(), gradient_view));
+    gradients_[param_to_grad_index.at(param->Name())] = gradient_view;
+    offset += size_in_bytes;
+  }
+  module_state.contiguous_parameters = contiguous_parameters_;
+  module_state.contiguous_gradients = contiguous_gradients_;
+
+  weights_.clear();
+  for (const auto& param_name : train_input_names_.WeightsInputNames()) {
+    weights_.push_back(module_state.named_parameters.at(param_name)->Data());
+  }
+
+  return Status::OK();
+}
+
 Status Module::CopyParametersToBuffer(OrtValue& parameters_buffer, const bool trainable_only) {
   ORT_RETURN_IF(state_->module_checkpoint_state.is_nominal_state,
                 "Cannot copy parameters from a nominal checkpoint state. Please load the model parameters first.");
+  if (trainable_only && contiguous_parameters_.IsAllocated()) {
+    // The trainable parameters are views into the contiguous buffer, hand it out instead of copying it.
+    if (!parameters_buffer.IsAllocated()) {
+      parameters_buffer = contiguous_parameters_;
+      return Status::OK();
+    }
+    if (parameters_buffer.IsTensor() &&
+        parameters_buffer.Get<Tensor>().DataRaw() == contiguous_parameters_.Get<Tensor>().DataRaw()) {
+      return Status::OK();
+    }
+  }
   ORT_RETURN_IF_NOT(parameters_buffer.IsAllocated(), "Parameters buffer should be pre-allocated.");
   ORT_RETURN_IF_NOT(parameters_buffer.IsTensor(), "Parameters buffer should be of tensor type.");
   auto* init_tensor = parameters_buffer.GetMutable<Tensor>();
@@ -607,11 +698,23 @@ Status Module::CopyBufferToParameters(OrtValue& parameters_buffer, const bool tr
   if (state_->module_checkpoint_state.is_nominal_state) {
     // Once the parameters are loaded, the state is no longer a nominal state.
     state_->module_checkpoint_state.is_nominal_state = false;
+
+    if (use_contiguous_parameter_buffer_) {
+      ORT_RETURN_IF_ERROR(MoveTrainableParametersToContiguousBuffers());
+    }
   }
 
   return Status::OK();
 }
 
+Status Module::GetContiguousGradients(OrtValue& gradients_buffer) const {
+  ORT_RETURN_IF_NOT(contiguous_gradients_.IsAllocated(),
+                    "The module does not use a contiguous parameter buffer. Set ",
+                    kOrtSessionOptionsConfigUseContiguousParameterBuffer, " to 1 to use one.");
+  gradients_buffer = contiguous_gradients_;
+  return Status::OK();
+}
+
 Status Module::LazyResetGrad() {
   accumulate_gradient_ = false;
   return Status::OK();
@@ -54,6 +54,12 @@ struct ModuleCheckpointState {
   std::unordered_map<std::string, std::shared_ptr<Parameter>> named_parameters;
   const DataTransferManager* train_session_data_transfer_mgr;
   bool is_nominal_state = false;
+
+  // With kOrtSessionOptionsConfigUseContiguousParameterBuffer, the buffers holding all the trainable parameters and
+  // all their gradients in the order of the training model inputs. The data and the gradient of each trainable
+  // parameter are views into them, so the state keeps them alive.
+  OrtValue contiguous_parameters;
+  OrtValue contiguous_gradients;
 };
 
 struct CheckpointState;
@@ -128,10 +134,16 @@ struct Module {
   size_t GetParametersSize(const bool trainable_only = true) const;
 
   // Copy parameters onto contiguous buffer held by parameters_buffer
+  // If the trainable parameters are in a contiguous buffer already, parameters_buffer is set to it when it is not
+  // allocated, and nothing is copied when it is that buffer.
   // If the parameter state is not available; i.e. the module was created using the nominal checkpoint,
   // and the state has not been loaded yet, then this function will return an error.
   Status CopyParametersToBuffer(OrtValue& parameters_buffer, const bool trainable_only = true);
 
+  // Set gradients_buffer to the contiguous buffer holding the gradients of the trainable parameters, in the order
+  // of CopyParametersToBuffer. Returns an error if the module does not use a contiguous parameter buffer.
+  Status GetContiguousGradients(OrtValue& gradients_buffer) const;
+
   // Copy parameter values from contiguous buffer held by parameters_buffer onto parameters
   // This function is responsible for completing the nominal checkpoint state. The checkpoint
   // state will no longer be nominal after the successful completion of this function.
@@ -165,6 +177,9 @@ struct Module {
   std::pair<common::Status, const InputDefList*> GetEvalModelInputs() const noexcept;
 
  private:
+  // Move the trainable parameters and their gradients into the contiguous buffers of the checkpoint state.
+  Status MoveTrainableParametersToContiguousBuffers();
+
   std::unique_ptr<onnxruntime::InferenceSession> train_sess_{nullptr};
   std::unique_ptr<onnxruntime::InferenceSession> eval_sess_{nullptr};
 
@@ -197,6 +212,11 @@ struct Module {
   CheckpointState* state_;  // Non owning pointer to the state.
 
   bool accumulate_gradient_ = false;
+  bool use_contiguous_parameter_buffer_ = false;
+  // Keep the buffers that weights_ and gradients_ view alive, should another module of the checkpoint state replace
+  // those of the state.
+  OrtValue contiguous_parameters_;
+  OrtValue contiguous_gradients_;
   std::optional<std::string> eval_model_path_;
   size_t eval_user_input_count_{0U};
 };
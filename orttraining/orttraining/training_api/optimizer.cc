@@ -8,6 +8,7 @@
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
 #include "core/session/environment.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
 #include "orttraining/training_api/checkpoint.h"
 #include "orttraining/training_api/utils.h"
@@ -106,9 +107,13 @@ Status Optimizer::GenerateMomentumNamedStates(OptimizerCheckpointState& optimize
     if (pair.second->RequiresGrad()) {
       param_named_optimizer_states.insert({pair.first, ParameterOptimizerState()});
       ParameterOptimizerState& cur_param_optimizer_states = param_named_optimizer_states[pair.first];
+      // Only the CPU AdamWOptimizer kernel computes with moments of another type than the parameter.
+      const bool on_cpu = pair.second->Data().Get<Tensor>().Location().device.Type() == OrtDevice::CPU;
       for (auto& state_name : optimizer_algo_ptr_->momentum_keys) {
         OrtValue param_state;
-        ORT_ENFORCE(utils::CreateZeroValuedOrtValueLike(optim_sess_state, pair.second->Data(), param_state).IsOK(),
+        ORT_ENFORCE(utils::CreateZeroValuedOrtValueLike(optim_sess_state, pair.second->Data(), param_state,
+                                                        on_cpu ? optimizer_state_type_ : nullptr)
+                        .IsOK(),
                     "Error generating moment state for ", pair.first);
         cur_param_optimizer_states.insert({state_name, std::move(param_state)});
       }
@@ -187,6 +192,16 @@ Optimizer::Optimizer(const ModelIdentifiers& model_identifiers,
                      const std::vector<std::shared_ptr<IExecutionProvider>>& providers,
                      gsl::span<OrtCustomOpDomain* const> op_domains)
     : optim_sess_(std::make_unique<InferenceSession>(session_options, env)), state_(state) {
+  const std::string state_type =
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigOptimizerStateType, "float");
+  if (state_type == "float16") {
+    optimizer_state_type_ = DataTypeImpl::GetType<MLFloat16>();
+  } else if (state_type == "bfloat16") {
+    optimizer_state_type_ = DataTypeImpl::GetType<BFloat16>();
+  } else {
+    ORT_ENFORCE(state_type == "float", "Unsupported optimizer state type: ", state_type);
+  }
+
   Initialize(model_identifiers, providers, op_domains);
 
   ORT_ENFORCE(state != nullptr, "Checkpoint state cannot be null.");
@@ -167,6 +167,9 @@ struct Optimizer {
   int32_t group_count_{0};
 
   bool delay_optimizer_state_construction_{false};
+
+  // Element type of the moments of the parameters on the CPU, the type of the parameter if null.
+  MLDataType optimizer_state_type_{nullptr};
 };
 
 }  // namespace api
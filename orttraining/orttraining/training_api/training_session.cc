@@ -111,6 +111,10 @@ Status TrainingSession::CopyParametersToBuffer(OrtValue& parameters_buffer, cons
   return module_->CopyParametersToBuffer(parameters_buffer, trainable_only);
 }
 
+Status TrainingSession::GetContiguousGradients(OrtValue& gradients_buffer) const {
+  return module_->GetContiguousGradients(gradients_buffer);
+}
+
 Status TrainingSession::CopyBufferToParameters(OrtValue& parameters_buffer, const bool trainable_only) {
   const bool was_nominal_state = state_->module_checkpoint_state.is_nominal_state;
   ORT_RETURN_IF_ERROR(module_->CopyBufferToParameters(parameters_buffer, trainable_only));
@@ -68,6 +68,8 @@ class TrainingSession {
 
   Status CopyBufferToParameters(OrtValue& parameters_buffer, const bool trainable_only = true);
 
+  Status GetContiguousGradients(OrtValue& gradients_buffer) const;
+
 #if !defined(ORT_MINIMAL_BUILD)
   Status ExportModelForInferencing(const std::string& inference_model_path,
                                    gsl::span<const std::string> graph_output_names) const;
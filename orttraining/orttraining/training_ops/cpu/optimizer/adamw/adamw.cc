@@ -10,6 +10,8 @@
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/providers/cpu/tensor/utils.h"
 
+#include <type_traits>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -32,6 +34,9 @@ Status AdamWOptimizerBase::PrepareForCompute(OpKernelContext* ctx, AdamWOptimize
   ORT_RETURN_IF_NOT(num_of_gradients == num_of_momentums_1, "Number of gradients and momentums_1 mismatch.");
   ORT_RETURN_IF_NOT(num_of_momentums_1 == num_of_momentums_2, "Number of momentums_1 and momentums_2 mismatch.");
 
+  ORT_RETURN_IF_NOT(prepare.momentums_1->DataType() == prepare.momentums_2->DataType(),
+                    "Types of momentums_1 and momentums_2 mismatch.");
+
   prepare.grouped_tensor_sizes.resize(prepare.num_of_weights);
   prepare.grouped_tensor_pointers.resize(prepare.num_of_weights);
 
@@ -57,11 +62,12 @@ Status AdamWOptimizerBase::PrepareForCompute(OpKernelContext* ctx, AdamWOptimize
 
           prepare.grouped_tensor_sizes[i] = static_cast<int>(weight_tensor.Shape().Size());
 
+          // The moments may be stored in 16 bits, see AdamWOptimizer<T>::Compute.
           prepare.grouped_tensor_pointers[i] = {
               const_cast<float*>(weight_tensor.Data<float>()),
               const_cast<float*>(gradient_tensor.Data<float>()),
-              const_cast<float*>(momentum_1_tensor.Data<float>()),
-              const_cast<float*>(momentum_2_tensor.Data<float>())};
+              const_cast<void*>(momentum_1_tensor.DataRaw()),
+              const_cast<void*>(momentum_2_tensor.DataRaw())};
         }
       });
 
@@ -89,47 +95,122 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("S_MOMENT", DataTypeImpl::AllFixedSizeSequenceTensorTypes()),
     AdamWOptimizer<float>);
 
+namespace {
+
+// Elements of the weights updated per chunk, few enough for the moments converted to float to stay in the cache.
+constexpr std::ptrdiff_t kAdamWChunkSize = 4096;
+
+template <typename TM>
+void LoadMoments(const TM* moments, std::ptrdiff_t count, float* moments_float) {
+  for (std::ptrdiff_t i = 0; i < count; ++i) {
+    moments_float[i] = moments[i].ToFloat();
+  }
+}
+
+template <typename TM>
+void StoreMoments(const float* moments_float, std::ptrdiff_t count, TM* moments) {
+  for (std::ptrdiff_t i = 0; i < count; ++i) {
+    moments[i] = TM(moments_float[i]);
+  }
+}
+
+}  // namespace
+
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode0(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float alpha_correction, float beta_correction) const {
+void AdamWOptimizer<T>::AdamWComputeMode0(T* weight, const T* gradient, T* momentums_1, T* momentums_2,
+                                          std::ptrdiff_t count, float lr, float alpha_correction,
+                                          float beta_correction) const {
+  EigenVectorArrayMap<T> w(weight, count);
+  ConstEigenVectorArrayMap<T> g(gradient, count);
+  EigenVectorArrayMap<T> m1(momentums_1, count);
+  EigenVectorArrayMap<T> m2(momentums_2, count);
+
   // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (MakeEigenArrayMap<T>(weight) * lr * weight_decay_);
+  w = w - (w * lr * weight_decay_);
 
   // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
+  m1 = alpha_ * m1 + (1.f - alpha_) * g;
 
   // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
+  m2 = beta_ * m2 + (1.f - beta_) * g * g;
 
   // Compute the new weight.
-  auto denom = (MakeEigenArrayMap<T>(momentums_2) / beta_correction).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr * MakeEigenArrayMap<T>(momentums_1)) / (alpha_correction * denom);
-
-  return Status::OK();
+  auto denom = (m2 / beta_correction).sqrt() + epsilon_;
+  w = w - (lr * m1) / (alpha_correction * denom);
 }
 
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode1(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float lr_corrected) const {
+void AdamWOptimizer<T>::AdamWComputeMode1(T* weight, const T* gradient, T* momentums_1, T* momentums_2,
+                                          std::ptrdiff_t count, float lr, float lr_corrected) const {
+  EigenVectorArrayMap<T> w(weight, count);
+  ConstEigenVectorArrayMap<T> g(gradient, count);
+  EigenVectorArrayMap<T> m1(momentums_1, count);
+  EigenVectorArrayMap<T> m2(momentums_2, count);
+
   // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
+  m1 = alpha_ * m1 + (1.f - alpha_) * g;
 
   // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
+  m2 = beta_ * m2 + (1.f - beta_) * g * g;
 
-  auto denom = MakeEigenArrayMap<T>(momentums_2).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr_corrected * MakeEigenArrayMap<T>(momentums_1) / denom);
+  auto denom = m2.sqrt() + epsilon_;
+  w = w - (lr_corrected * m1 / denom);
 
   // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (lr * weight_decay_ * MakeEigenArrayMap<T>(weight));
+  w = w - (lr * weight_decay_ * w);
+}
 
-  return Status::OK();
+template <typename T>
+template <typename TM>
+void AdamWOptimizer<T>::UpdateWeights(const AdamWOptimizerBase::Prepare& prepare, concurrency::ThreadPool* tp,
+                                      float lr, float alpha_correction, float beta_correction,
+                                      float lr_corrected) const {
+  const std::vector<TensorChunk> chunks = SplitTensorsIntoChunks(prepare.grouped_tensor_sizes, kAdamWChunkSize);
+
+  // Each element loads the weight, the gradient and the moments, and stores the weight and the moments.
+  const TensorOpCost cost{static_cast<double>(kAdamWChunkSize * (2 * sizeof(T) + 2 * sizeof(TM))),
+                          static_cast<double>(kAdamWChunkSize * (sizeof(T) + 2 * sizeof(TM))),
+                          static_cast<double>(kAdamWChunkSize * 16)};
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(chunks.size()), cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        std::vector<T> moments_buffer;
+        if constexpr (!std::is_same_v<TM, T>) {
+          moments_buffer.resize(2 * kAdamWChunkSize);
+        }
+
+        for (std::ptrdiff_t chunk_index = first; chunk_index != last; ++chunk_index) {
+          const TensorChunk& chunk = chunks[chunk_index];
+          const auto& pointers = prepare.grouped_tensor_pointers[chunk.tensor_index];
+          const std::ptrdiff_t count = chunk.end - chunk.begin;
+          T* weight = static_cast<T*>(pointers[0]) + chunk.begin;
+          const T* gradient = static_cast<const T*>(pointers[1]) + chunk.begin;
+          TM* momentums_1 = static_cast<TM*>(pointers[2]) + chunk.begin;
+          TM* momentums_2 = static_cast<TM*>(pointers[3]) + chunk.begin;
+
+          T* m1;
+          T* m2;
+          if constexpr (std::is_same_v<TM, T>) {
+            m1 = momentums_1;
+            m2 = momentums_2;
+          } else {
+            m1 = moments_buffer.data();
+            m2 = m1 + kAdamWChunkSize;
+            LoadMoments(momentums_1, count, m1);
+            LoadMoments(momentums_2, count, m2);
+          }
+
+          if (adam_mode_ == 0) {
+            AdamWComputeMode0(weight, gradient, m1, m2, count, lr, alpha_correction, beta_correction);
+          } else {
+            AdamWComputeMode1(weight, gradient, m1, m2, count, lr, lr_corrected);
+          }
+
+          if constexpr (!std::is_same_v<TM, T>) {
+            StoreMoments(m1, count, momentums_1);
+            StoreMoments(m2, count, momentums_2);
+          }
+        }
+      });
 }
 
 template <typename T>
@@ -165,21 +246,17 @@ Status AdamWOptimizer<T>::Compute(OpKernelContext* ctx) const {
     //         bias correction is applied on learning rate, then use lr_corrected for subsequent computations.
     //         weight decay is applied after weight is updated.
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-      Tensor& momentums_1 = const_cast<Tensor&>(p.momentums_1->Get(weight_index));
-      Tensor& momentums_2 = const_cast<Tensor&>(p.momentums_2->Get(weight_index));
-
-      if (adam_mode_ == 0) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, lr, alpha_correction, beta_correction));
-      } else if (adam_mode_ == 1) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, lr, lr_corrected));
-      } else {
-        ORT_THROW("Unsupported Adamw optimizer mode.");
-      }
+    // The moments may be stored in float16 or bfloat16 to halve the memory of the optimizer state, they are still
+    // computed in float.
+    auto* tp = ctx->GetOperatorThreadPool();
+    const MLDataType moment_type = p.momentums_1->DataType();
+    if (moment_type == DataTypeImpl::GetType<MLFloat16>()) {
+      UpdateWeights<MLFloat16>(p, tp, lr, alpha_correction, beta_correction, lr_corrected);
+    } else if (moment_type == DataTypeImpl::GetType<BFloat16>()) {
+      UpdateWeights<BFloat16>(p, tp, lr, alpha_correction, beta_correction, lr_corrected);
+    } else {
+      ORT_RETURN_IF_NOT(moment_type == DataTypeImpl::GetType<T>(), "Unsupported type of the momentums.");
+      UpdateWeights<T>(p, tp, lr, alpha_correction, beta_correction, lr_corrected);
     }
 
     *updated_flag_ptr = true;
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/TensorSeq.h"
@@ -29,5 +31,15 @@ Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values,
   return Status::OK();
 }
 
+std::vector<TensorChunk> SplitTensorsIntoChunks(gsl::span<const int> tensor_sizes, std::ptrdiff_t max_chunk_size) {
+  std::vector<TensorChunk> chunks;
+  for (size_t i = 0; i < tensor_sizes.size(); ++i) {
+    for (std::ptrdiff_t begin = 0; begin < tensor_sizes[i]; begin += max_chunk_size) {
+      chunks.push_back({i, begin, std::min<std::ptrdiff_t>(begin + max_chunk_size, tensor_sizes[i])});
+    }
+  }
+  return chunks;
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -6,6 +6,8 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include <cmath>
+#include <vector>
+#include <gsl/gsl>
 
 namespace onnxruntime {
 namespace contrib {
@@ -22,5 +24,17 @@ TC compute_bias_correction_coefficient(const TC momentum_update_coefficient, con
 Status CopyIfNotSameCPUBuffer(OpKernelContext* ctx, size_t number_of_values, const TensorSeq* src_values,
                               TensorSeq* dest_values);
 
+// A range of the elements of one tensor of a sequence.
+struct TensorChunk {
+  size_t tensor_index;
+  std::ptrdiff_t begin;
+  std::ptrdiff_t end;
+};
+
+// Splits tensors of the given sizes into chunks of at most max_chunk_size elements. The optimizers update all the
+// chunks in one parallel loop, as if the tensors were one flattened buffer, so a step does not cost a dispatch per
+// tensor for models with many small parameters, and large parameters are spread over the threads.
+std::vector<TensorChunk> SplitTensorsIntoChunks(gsl::span<const int> tensor_sizes, std::ptrdiff_t max_chunk_size);
+
 }  // namespace contrib
 }  // namespace onnxruntime
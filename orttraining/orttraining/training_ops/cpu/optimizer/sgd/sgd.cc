@@ -5,12 +5,20 @@
 #include "orttraining/training_ops/cpu/optimizer/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/TensorSeq.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 
 namespace onnxruntime {
 namespace contrib {
 
+namespace {
+
+// Elements of the weights updated per chunk.
+constexpr std::ptrdiff_t kSGDChunkSize = 16384;
+
+}  // namespace
+
 Status SGDOptimizerV2Base::PrepareForCompute(OpKernelContext* ctx, SGDOptimizerV2Base::Prepare& prepare) const {
   prepare.learning_rate = ctx->Input<Tensor>(0);
   prepare.weights = ctx->Input<TensorSeq>(1);
@@ -64,14 +72,25 @@ Status SGDOptimizerV2<T>::Compute(OpKernelContext* ctx) const {
   if (update_signal == nullptr || *update_signal->template Data<bool>()) {
     const float lr = *p.learning_rate->template Data<float>();
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-
-      // new_weight = weight - lr * gradient
-      const auto& delta = -lr * MakeEigenArrayMap<T>(gradient);
-      MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) + delta;
-    }
+    // All the weights are updated in one parallel loop over chunks of them.
+    const std::vector<TensorChunk> chunks = SplitTensorsIntoChunks(p.grouped_tensor_sizes, kSGDChunkSize);
+    const TensorOpCost cost{static_cast<double>(kSGDChunkSize * 2 * sizeof(T)),
+                            static_cast<double>(kSGDChunkSize * sizeof(T)),
+                            static_cast<double>(kSGDChunkSize * 2)};
+    concurrency::ThreadPool::TryParallelFor(
+        ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(chunks.size()), cost,
+        [&p, &chunks, lr](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t chunk_index = first; chunk_index != last; ++chunk_index) {
+            const TensorChunk& chunk = chunks[chunk_index];
+            const auto& pointers = p.grouped_tensor_pointers[chunk.tensor_index];
+            const std::ptrdiff_t count = chunk.end - chunk.begin;
+            EigenVectorArrayMap<T> weight(static_cast<T*>(pointers[0]) + chunk.begin, count);
+            ConstEigenVectorArrayMap<T> gradient(static_cast<const T*>(pointers[1]) + chunk.begin, count);
+
+            // new_weight = weight - lr * gradient
+            weight = weight + (-lr * gradient);
+          }
+        });
 
     *updated_flag_ptr = true;
   } else {